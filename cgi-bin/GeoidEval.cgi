@@ -19,6 +19,15 @@ EXECDIR=../bin
 COMMAND="GeoidEval"
 VERSION=`$EXECDIR/$COMMAND --version | cut -f4 -d" "`
 export GEOGRAPHICLIB_DATA=..
+# Use a server, started with
+#   GEOGRAPHICLIB_DATA=.. ../bin/GeoidEval --serve ../persistent/GeoidEval.sock
+# if there is one; this keeps the geoids in memory between requests.
+SOCKET=../persistent/$COMMAND.sock
+if test -S $SOCKET; then
+    GEOIDEVAL="$EXECDIR/$COMMAND --connect $SOCKET"
+else
+    GEOIDEVAL="$EXECDIR/$COMMAND"
+fi
 F='<font color="blue">'
 G='</font>'
 POSITION1=
@@ -29,15 +38,15 @@ HEIGHT2008=
 set -o pipefail
 if test "$INPUT"; then
     HEIGHT96=`echo $INPUT |
-    $EXECDIR/$COMMAND -n egm96-5 | head -1`
+    $GEOIDEVAL -n egm96-5 | head -1`
     if test $? -eq 0; then
         POSITION1=`echo $INPUT | $EXECDIR/GeoConvert | head -1`
         POSITION1=`geohack $POSITION1 $POSITION1 Black`
         POSITION2=\(`echo $INPUT | $EXECDIR/GeoConvert -d -p -1 | head -1`\)
         HEIGHT2008=`echo $INPUT |
-        $EXECDIR/$COMMAND -n egm2008-1 | head -1`
+        $GEOIDEVAL -n egm2008-1 | head -1`
         HEIGHT84=`echo $INPUT |
-        $EXECDIR/$COMMAND -n egm84-15 | head -1`
+        $GEOIDEVAL -n egm84-15 | head -1`
     else
         POSITION1=`encodevalue "$HEIGHT96"`
         HEIGHT96=
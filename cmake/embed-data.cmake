@@ -0,0 +1,55 @@
+# Convert data files to C++ arrays to be compiled into the library.  This is
+# run in script mode with
+#
+#   cmake -DFILES="key1=file1|key2=file2|..." -DOUT=EmbeddedData.inc
+#     [-DBRACES=ON] -P embed-data.cmake
+#
+# Each file becomes a char array, aligned to 8 bytes so that the coefficients
+# of magnetic models can be used in place.  The array is written as a string
+# literal (which compilers handle much faster than an initializer list)
+# unless BRACES is set; Visual Studio limits the length of string literals,
+# so an initializer list is used for it.  The table embeddedfiles_ gives the
+# key, data, and size of each file; this is used by Utility::EmbeddedData.
+
+string (REPLACE "|" ";" FILES "${FILES}")
+set (TABLE)
+set (I 0)
+file (WRITE ${OUT} "// Generated by embed-data.cmake; do not edit\n\n")
+foreach (ENTRY ${FILES})
+  string (FIND "${ENTRY}" "=" POS)
+  string (SUBSTRING "${ENTRY}" 0 ${POS} KEY)
+  math (EXPR POS "${POS} + 1")
+  string (SUBSTRING "${ENTRY}" ${POS} -1 FILE)
+  file (READ ${FILE} HEX HEX)
+  string (LENGTH "${HEX}" SIZE)
+  math (EXPR SIZE "${SIZE} / 2")
+  if (SIZE EQUAL 0)
+    message (FATAL_ERROR "Cannot embed the empty file ${FILE}")
+  endif ()
+  # 32 bytes (64 hex digits) per line
+  set (LINE "................................")
+  string (REGEX REPLACE "(${LINE}${LINE})" "\\1\n" HEX "${HEX}")
+  if (BRACES)
+    string (REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," HEX "${HEX}")
+    file (APPEND ${OUT}
+      "alignas(8) static const unsigned char embedded${I}_[] = {\n"
+      "${HEX}\n};\n")
+  else ()
+    string (REGEX REPLACE "([0-9a-f][0-9a-f])" "\\\\x\\1" HEX "${HEX}")
+    string (REGEX REPLACE "\n$" "" HEX "${HEX}")
+    string (REPLACE "\n" "\"\n\"" HEX "${HEX}")
+    file (APPEND ${OUT}
+      "alignas(8) static const char embedded${I}_[] =\n\"${HEX}\";\n")
+  endif ()
+  set (TABLE "${TABLE}  { \"${KEY}\",
+    reinterpret_cast<const char*>(embedded${I}_), ${SIZE} },\n")
+  math (EXPR I "${I} + 1")
+endforeach ()
+file (APPEND ${OUT} "
+static const struct {
+  const char* name;
+  const char* data;
+  size_t size;
+} embeddedfiles_[] = {
+${TABLE}};
+")
@@ -0,0 +1,323 @@
+/**
+ * \file Benchmarks.cpp
+ *
+ * Time the principal classes of GeographicLib on random but realistic
+ * inputs.  This is built by the benchmarks target, which also runs it.
+ *
+ * Usage: Benchmarks [-n count] [-r repeat] [pattern]
+ *
+ * Each benchmark evaluates \e count (default 100000) points and is repeated
+ * \e repeat (default 5) times; the best time per call in ns is reported.
+ * Only the benchmarks whose names contain \e pattern are run.  Benchmarks
+ * which need data files (Geoid, GravityModel, MagneticModel) are skipped if
+ * the default data set is not installed.
+ *
+ * The NUMA benchmarks run on node 0 and read data placed on each node in
+ * turn (see MemoryPolicy) and then data replicated on every node; this
+ * shows the cost of remote memory on a multi-socket machine.
+ **********************************************************************/
+
+#include <chrono>               // for timing
+#include <random>               // for C++11 random numbers
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <GeographicLib/Geodesic.hpp>
+#include <GeographicLib/GeodesicLine.hpp>
+#include <GeographicLib/GeodesicExact.hpp>
+#include <GeographicLib/Rhumb.hpp>
+#include <GeographicLib/TransverseMercator.hpp>
+#include <GeographicLib/TransverseMercatorExact.hpp>
+#include <GeographicLib/UTMUPS.hpp>
+#include <GeographicLib/MGRS.hpp>
+#include <GeographicLib/Geoid.hpp>
+#include <GeographicLib/GravityModel.hpp>
+#include <GeographicLib/MagneticModel.hpp>
+#include <GeographicLib/MemoryPolicy.hpp>
+#include <GeographicLib/NearestNeighbor.hpp>
+#include <GeographicLib/PolygonArea.hpp>
+#include <GeographicLib/SphericalHarmonic.hpp>
+#include <GeographicLib/Utility.hpp>
+
+using namespace GeographicLib;
+using namespace std;
+
+typedef Math::real real;
+
+// Accumulate results here so that the compiler can't discard the work.
+static real sink = 0;
+
+class Bench {
+private:
+  int _n, _r;
+  string _pattern;
+public:
+  Bench(int n, int r, const string& pattern)
+    : _n(n), _r(r), _pattern(pattern) {}
+  // Call f(i) for i in [0, n) and report the best time per call.  n defaults
+  // to count; calls is the number of operations performed by each f(i).
+  template<class F> void Run(const string& name, F f, int n = 0,
+                             int calls = 1) const {
+    if (name.find(_pattern) == string::npos) return;
+    if (n <= 0) n = _n;
+    double best = numeric_limits<double>::max();
+    for (int r = 0; r < _r; ++r) {
+      auto t0 = chrono::steady_clock::now();
+      for (int i = 0; i < n; ++i) f(i);
+      auto t1 = chrono::steady_clock::now();
+      best = min(best, chrono::duration<double, nano>(t1 - t0).count());
+    }
+    cout << left << setw(40) << name << right << setw(12) << fixed
+         << setprecision(1) << best / (double(n) * calls) << " ns\n";
+  }
+  void Skip(const string& name, const string& why) const {
+    if (name.find(_pattern) == string::npos) return;
+    cout << left << setw(40) << name << " skipped: " << why << "\n";
+  }
+};
+
+struct geodpos {
+  real lat, lon;
+};
+
+class geoddist {
+public:
+  real operator()(const geodpos& a, const geodpos& b) const {
+    real d;
+    Geodesic::WGS84().Inverse(a.lat, a.lon, b.lat, b.lon, d);
+    return d;
+  }
+};
+
+int main(int argc, const char* const argv[]) {
+  try {
+    int n = 100000, r = 5;
+    string pattern;
+    for (int m = 1; m < argc; ++m) {
+      string arg(argv[m]);
+      if (arg == "-n" && m + 1 < argc)
+        n = Utility::val<int>(string(argv[++m]));
+      else if (arg == "-r" && m + 1 < argc)
+        r = Utility::val<int>(string(argv[++m]));
+      else if (arg.size() && arg[0] != '-')
+        pattern = arg;
+      else {
+        cerr << "Usage: " << argv[0] << " [-n count] [-r repeat] [pattern]\n";
+        return 1;
+      }
+    }
+    if (!(n > 0 && r > 0)) {
+      cerr << "count and repeat must be positive\n";
+      return 1;
+    }
+    Bench bench(n, r, pattern);
+
+    // Points uniformly distributed on the sphere; azimuths uniform; distances
+    // uniform up to half the circumference (global) or to 100 km (short).
+    mt19937 g(42);
+    uniform_real_distribution<double> U(0, 1);
+    vector<real> lat1(n), lon1(n), lat2(n), lon2(n), azi1(n), s12(n),
+      s12short(n), lat2short(n), lon2short(n),
+      tmlat(n), tmlon(n), x(n), y(n), tmx(n), tmy(n);
+    vector<int> zone(n);
+    vector<char> northp(n);
+    vector<string> mgrs(n);
+    const Geodesic& geod = Geodesic::WGS84();
+    for (int i = 0; i < n; ++i) {
+      lat1[i] = real(asin(2 * U(g) - 1) / Math::degree());
+      lon1[i] = real(360 * U(g) - 180);
+      lat2[i] = real(asin(2 * U(g) - 1) / Math::degree());
+      lon2[i] = real(360 * U(g) - 180);
+      azi1[i] = real(360 * U(g) - 180);
+      s12[i] = real(2.0e7 * U(g));
+      s12short[i] = real(1.0e5 * U(g));
+      geod.Direct(lat1[i], lon1[i], azi1[i], s12short[i],
+                  lat2short[i], lon2short[i]);
+      // Points within the width of a UTM zone of the central meridian
+      tmlat[i] = real(160 * U(g) - 80);
+      tmlon[i] = real(6 * U(g) - 3);
+      TransverseMercator::UTM().Forward(0, tmlat[i], tmlon[i],
+                                        tmx[i], tmy[i]);
+      bool north;
+      UTMUPS::Forward(lat1[i], lon1[i], zone[i], north, x[i], y[i]);
+      northp[i] = north;
+      MGRS::Forward(zone[i], north, x[i], y[i], 5, mgrs[i]);
+    }
+
+    {
+      real s, a1, a2;
+      bench.Run("Geodesic::Inverse", [&](int i) {
+        geod.Inverse(lat1[i], lon1[i], lat2[i], lon2[i], s, a1, a2);
+        sink += s + a1 + a2; });
+      bench.Run("Geodesic::Inverse (short)", [&](int i) {
+        geod.Inverse(lat1[i], lon1[i], lat2short[i], lon2short[i], s, a1, a2);
+        sink += s + a1 + a2; });
+      bench.Run("Geodesic::Direct", [&](int i) {
+        geod.Direct(lat1[i], lon1[i], azi1[i], s12[i], a1, a2);
+        sink += a1 + a2; });
+      GeodesicLine l = geod.Line(lat1[0], lon1[0], azi1[0]);
+      bench.Run("GeodesicLine::Position", [&](int i) {
+        l.Position(s12[i], a1, a2);
+        sink += a1 + a2; });
+    }
+    {
+      const GeodesicExact& geode = GeodesicExact::WGS84();
+      real s, a1, a2;
+      bench.Run("GeodesicExact::Inverse", [&](int i) {
+        geode.Inverse(lat1[i], lon1[i], lat2[i], lon2[i], s, a1, a2);
+        sink += s + a1 + a2; });
+      bench.Run("GeodesicExact::Direct", [&](int i) {
+        geode.Direct(lat1[i], lon1[i], azi1[i], s12[i], a1, a2);
+        sink += a1 + a2; });
+    }
+    {
+      const Rhumb& rhumb = Rhumb::WGS84();
+      real s, a;
+      bench.Run("Rhumb::Inverse", [&](int i) {
+        rhumb.Inverse(lat1[i], lon1[i], lat2[i], lon2[i], s, a);
+        sink += s + a; });
+      bench.Run("Rhumb::Direct", [&](int i) {
+        rhumb.Direct(lat1[i], lon1[i], azi1[i], s12short[i], s, a);
+        sink += s + a; });
+    }
+    {
+      real u, v;
+      const TransverseMercator& tm = TransverseMercator::UTM();
+      bench.Run("TransverseMercator::Forward", [&](int i) {
+        tm.Forward(0, tmlat[i], tmlon[i], u, v);
+        sink += u + v; });
+      bench.Run("TransverseMercator::Reverse", [&](int i) {
+        tm.Reverse(0, tmx[i], tmy[i], u, v);
+        sink += u + v; });
+      const TransverseMercatorExact& tme = TransverseMercatorExact::UTM();
+      bench.Run("TransverseMercatorExact::Forward", [&](int i) {
+        tme.Forward(0, tmlat[i], tmlon[i], u, v);
+        sink += u + v; });
+      bench.Run("TransverseMercatorExact::Reverse", [&](int i) {
+        tme.Reverse(0, tmx[i], tmy[i], u, v);
+        sink += u + v; });
+    }
+    {
+      real u, v;
+      int z, prec;
+      bool north;
+      bench.Run("UTMUPS::Forward", [&](int i) {
+        UTMUPS::Forward(lat1[i], lon1[i], z, north, u, v);
+        sink += u + v + z; });
+      bench.Run("UTMUPS::Reverse", [&](int i) {
+        UTMUPS::Reverse(zone[i], northp[i] != 0, x[i], y[i], u, v);
+        sink += u + v; });
+      string s;
+      bench.Run("MGRS::Forward", [&](int i) {
+        MGRS::Forward(zone[i], northp[i] != 0, x[i], y[i], 5, s);
+        sink += real(s.size()); });
+      bench.Run("MGRS::Reverse", [&](int i) {
+        MGRS::Reverse(mgrs[i], z, north, u, v, prec);
+        sink += u + v; });
+    }
+    try {
+      Geoid geoid(Geoid::DefaultGeoidName());
+      bench.Run("Geoid::operator()", [&](int i) {
+        sink += geoid(lat1[i], lon1[i]); });
+    }
+    catch (const GeographicErr& e) {
+      bench.Skip("Geoid::operator()", e.what());
+    }
+    try {
+      GravityModel grav(GravityModel::DefaultGravityName());
+      real gx, gy, gz;
+      // Spherical harmonic sums are slow; use fewer points
+      bench.Run("GravityModel::Gravity", [&](int i) {
+        sink += grav.Gravity(lat1[i], lon1[i], 0, gx, gy, gz); },
+        max(1, n / 100));
+    }
+    catch (const GeographicErr& e) {
+      bench.Skip("GravityModel::Gravity", e.what());
+    }
+    try {
+      MagneticModel mag(MagneticModel::DefaultMagneticName());
+      real bx, by, bz;
+      bench.Run("MagneticModel::operator()", [&](int i) {
+        mag(2025, lat1[i], lon1[i], 0, bx, by, bz);
+        sink += bx + by + bz; });
+    }
+    catch (const GeographicErr& e) {
+      bench.Skip("MagneticModel::operator()", e.what());
+    }
+    {
+      // The placement of large data on NUMA nodes.  The packed coefficients
+      // of a sum of degree 1000 (16 MB) and the default geoid are read from
+      // node 0 with the data on each node and then replicated.
+      MemoryPolicy::RunOnNode(0);
+      MemoryPolicy::SetPages(MemoryPolicy::HUGEPAGES);
+      int N = 1000, nodes = MemoryPolicy::Nodes();
+      vector<real> C(SphericalEngine::coeff::Csize(N, N)),
+        S(SphericalEngine::coeff::Ssize(N, N));
+      for (real& c : C) c = real(1e-6 * (U(g) - 0.5));
+      for (real& c : S) c = real(1e-6 * (U(g) - 0.5));
+      for (int k = 0; k <= nodes; ++k) {
+        // k == nodes means replicated
+        bool rep = k == nodes;
+        string where = rep ? "replicated" : "on node " + Utility::str(k);
+        MemoryPolicy::SetNode(rep ? -1 : k);
+        MemoryPolicy::SetReplicate(rep);
+        SphericalHarmonic harm(C, S, N, real(6.4e6));
+        harm.Pack();
+        bench.Run("NUMA packed sum, data " + where, [&](int i) {
+          sink += harm(tmx[i], tmy[i], real(6.4e6)); }, max(1, n / 1000));
+        try {
+          Geoid geoid(Geoid::DefaultGeoidName(), "", true, true);
+          bench.Run("NUMA Geoid, data " + where, [&](int i) {
+            sink += geoid(lat1[i], lon1[i]); });
+        }
+        catch (const GeographicErr& e) {
+          bench.Skip("NUMA Geoid, data " + where, e.what());
+        }
+      }
+      MemoryPolicy::SetNode(-1);
+      MemoryPolicy::SetReplicate(false);
+      MemoryPolicy::SetPages(MemoryPolicy::SMALLPAGES);
+    }
+    {
+      // 10000 random points; each search finds the 10 nearest neighbors of a
+      // random query point
+      typedef NearestNeighbor<real, geodpos, geoddist> NN;
+      int m = min(n, 10000);
+      vector<geodpos> pts(m);
+      for (int i = 0; i < m; ++i) {
+        pts[i].lat = lat2[i]; pts[i].lon = lon2[i];
+      }
+      geoddist dist;
+      bench.Run("NearestNeighbor::Initialize (10000)", [&](int) {
+        NN tree(pts, dist);
+        sink += real(tree.NumPoints()); }, 1);
+      NN tree(pts, dist);
+      vector<int> ind;
+      bench.Run("NearestNeighbor::Search (k = 10)", [&](int i) {
+        geodpos q = {lat1[i], lon1[i]};
+        sink += tree.Search(pts, dist, q, ind, 10); }, max(1, n / 100));
+    }
+    {
+      // Polygons with 100 vertices in a small region
+      const int k = 100;
+      PolygonArea poly(geod);
+      real perim, area;
+      bench.Run("PolygonArea (per vertex)", [&](int i) {
+        poly.Clear();
+        for (int j = 0; j < k; ++j) {
+          int l = (i + j) % n;
+          poly.AddPoint(lat1[i] / 2 + real(0.1) * tmlon[l],
+                        lon1[i] + real(0.1) * tmlon[(l + 1) % n]);
+        }
+        poly.Compute(false, true, perim, area);
+        sink += perim + area; }, max(1, n / k), k);
+    }
+    if (sink == 0) cout << "\n";
+    return 0;
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+}
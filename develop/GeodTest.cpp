@@ -25,7 +25,7 @@ using namespace GeographicLib;
 
 int usage(int retval) {
   ( retval ? cerr : cout ) <<
-"GeodTest [ -a | -c | -t0 | -t1 | -t2 | -t3 | -h ]\n\
+"GeodTest [ -a | -c | -t0 | -t1 | -t2 | -t3 | -t4 | -h ]\n\
 \n\
 Check GeographicLib::Geodesic class.\n\
 -a (default) accuracy test (reads test data on standard input)\n\
@@ -37,10 +37,12 @@ Check GeographicLib::Geodesic class.\n\
 -t1 time GeodecicLine with angles using synthetic data\n\
 -t2 time Geodecic::Direct using synthetic data\n\
 -t3 time Geodecic::Inverse with synthetic data\n\
+-t4 time Geodecic::Inverse with nearly antipodal synthetic data\n\
 -T0 time GeodecicLineExact with distances using synthetic data\n\
 -T1 time GeodecicLineExact with angles using synthetic data\n\
 -T2 time GeodecicExact::Direct using synthetic data\n\
 -T3 time GeodecicExact::Inverse with synthetic data\n\
+-T4 time GeodecicExact::Inverse with nearly antipodal synthetic data\n\
 \n\
 -c requires an instrumented version of Geodesic.\n";
   return retval;
@@ -189,7 +191,8 @@ int main(int argc, char* argv[]) {
   Math::real a = Constants::WGS84_a();
   Math::real f = Constants::WGS84_f();
   bool timing = false;
-  int timecase = 0; // 0 = line, 1 = line ang, 2 = direct, 3 = inverse
+  int timecase = 0; // 0 = line, 1 = line ang, 2 = direct, 3 = inverse,
+                    // 4 = inverse for nearly antipodal points
   bool accuracytest = true;
   bool coverage = false;
   bool exact = false;
@@ -243,6 +246,12 @@ int main(int argc, char* argv[]) {
       timing = true;
       timecase = 3;
       exact = false;
+    } else if (arg == "-t4") {
+      accuracytest = false;
+      coverage = false;
+      timing = true;
+      timecase = 4;
+      exact = false;
     } else if (arg == "-T0") {
       accuracytest = false;
       coverage = false;
@@ -267,6 +276,12 @@ int main(int argc, char* argv[]) {
       timing = true;
       timecase = 3;
       exact = true;
+    } else if (arg == "-T4") {
+      accuracytest = false;
+      coverage = false;
+      timing = true;
+      timecase = 4;
+      exact = true;
     } else
       return usage(arg == "-h" ? 0 : 1);
   } else if (argc > 2)
@@ -352,6 +367,24 @@ int main(int argc, char* argv[]) {
         }
         cout << cnt << " " << s << "\n";
         break;
+      case 4:
+        // Time Inverse for points within 10 deg of antipodal
+        for (int i = 1; i <= 179; i += 2) {
+          Math::real lat1 = i * Math::real(0.5);
+          for (int j = -50; j <= 50; ++j) {
+            Math::real lat2 = -lat1 + j * Math::real(0.2);
+            if (lat2 < -90) continue;
+            for (int k = 0; k < 50; ++k) {
+              Math::real lon2 = 180 - k * Math::real(0.2);
+              Math::real s12;
+              geod.Inverse(lat1, 0.0, lat2, lon2, s12);
+              ++cnt;
+              s += s12;
+            }
+          }
+        }
+        cout << cnt << " " << s << "\n";
+        break;
       }
     } else {
       const GeodesicExact& geod = GeodesicExact::WGS84();
@@ -432,6 +465,24 @@ int main(int argc, char* argv[]) {
         }
         cout << cnt << " " << s << "\n";
         break;
+      case 4:
+        // Time Inverse for points within 10 deg of antipodal
+        for (int i = 1; i <= 179; i += 2) {
+          Math::real lat1 = i * Math::real(0.5);
+          for (int j = -50; j <= 50; ++j) {
+            Math::real lat2 = -lat1 + j * Math::real(0.2);
+            if (lat2 < -90) continue;
+            for (int k = 0; k < 50; ++k) {
+              Math::real lon2 = 180 - k * Math::real(0.2);
+              Math::real s12;
+              geod.Inverse(lat1, 0.0, lat2, lon2, s12);
+              ++cnt;
+              s += s12;
+            }
+          }
+        }
+        cout << cnt << " " << s << "\n";
+        break;
       }
     }
   }
@@ -0,0 +1,360 @@
+/**
+ * \file ModelStartup.cpp
+ *
+ * Measure the cost of starting to use the models: the time to construct
+ * GravityModel, MagneticModel, Geoid, and NearestNeighbor objects (read
+ * into memory and memory mapped), the latency of the first query, and the
+ * increase in the peak resident set size.  Each trial is run in a fresh
+ * process, first with the data files evicted from the page cache (cold)
+ * and then with them cached (warm).  This is built by the startupbenchmarks
+ * target, which also runs it.
+ *
+ * Usage: ModelStartup [-g gravity] [-m magnetic] [-d geoid] [-n points]
+ *   [-r repeat]
+ *
+ * The models default to the default models of the classes; those which
+ * aren't installed are skipped.  The NearestNeighbor tree is built for \e
+ * points (default 200000) random points and saved with Save and SaveMapped
+ * to temporary files in the current directory; the mapped tree is loaded
+ * with \e check = false.  The best of \e repeat (default 3) trials is
+ * reported.
+ *
+ * The files are evicted with posix_fadvise, which is only a hint; it
+ * doesn't evict pages which are mapped by other processes and it's not
+ * available on all systems (e.g., macOS), in which case the cold times are
+ * really warm ones.  This program needs a POSIX system.
+ **********************************************************************/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+#include <GeographicLib/Geoid.hpp>
+#include <GeographicLib/GravityModel.hpp>
+#include <GeographicLib/MagneticModel.hpp>
+#include <GeographicLib/NearestNeighbor.hpp>
+#include <GeographicLib/SphericalEngine.hpp>
+#include <GeographicLib/Utility.hpp>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+using namespace GeographicLib;
+using namespace std;
+
+typedef Math::real real;
+
+#if defined(_WIN32)
+
+int main() {
+  cerr << "ModelStartup needs a POSIX system\n";
+  return 1;
+}
+
+#else
+
+// The results of a trial: the times (in ms) to construct the object and to
+// answer the first query and the increase in the peak RSS (in bytes).
+struct result {
+  double construct, query, rss;
+};
+
+typedef chrono::steady_clock::time_point timepoint;
+
+timepoint Now() { return chrono::steady_clock::now(); }
+
+double Ms(timepoint t0, timepoint t1) {
+  return chrono::duration<double, milli>(t1 - t0).count();
+}
+
+double PeakRSS() {
+  struct rusage u;
+  getrusage(RUSAGE_SELF, &u);
+#if defined(__APPLE__)
+  return double(u.ru_maxrss);           // bytes
+#else
+  return double(u.ru_maxrss) * 1024;    // kilobytes
+#endif
+}
+
+// Ask the kernel to drop the cached pages of a file.
+void Evict(const string& file) {
+#if defined(POSIX_FADV_DONTNEED)
+  int fd = open(file.c_str(), O_RDONLY);
+  if (fd < 0) return;
+  (void)posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+  close(fd);
+#else
+  (void)file;
+#endif
+}
+
+bool Exists(const string& file) {
+  ifstream f(file.c_str());
+  return f.good();
+}
+
+// Run f in a child process; f sets the construction and query times.
+// Return false if the child fails.
+bool Trial(const function<void(double&, double&)>& f, result& r) {
+  int fd[2];
+  if (pipe(fd) != 0) return false;
+  cout.flush();
+  pid_t pid = fork();
+  if (pid < 0) {
+    close(fd[0]); close(fd[1]);
+    return false;
+  }
+  if (pid == 0) {
+    close(fd[0]);
+    result c;
+    double rss0 = PeakRSS();
+    bool ok = true;
+    try {
+      f(c.construct, c.query);
+    }
+    catch (const exception& e) {
+      cerr << "Caught exception: " << e.what() << "\n";
+      ok = false;
+    }
+    c.rss = PeakRSS() - rss0;
+    if (ok && write(fd[1], &c, sizeof(c)) != ssize_t(sizeof(c)))
+      ok = false;
+    close(fd[1]);
+    _exit(ok ? 0 : 1);
+  }
+  close(fd[1]);
+  bool ok = read(fd[0], &r, sizeof(r)) == ssize_t(sizeof(r));
+  close(fd[0]);
+  int status;
+  waitpid(pid, &status, 0);
+  return ok && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+// Accumulate results here so that the compiler can't discard the work.
+static real sink = 0;
+
+class Startup {
+private:
+  int _r;
+public:
+  explicit Startup(int r) : _r(r) {}
+  // Report the best of the trials of f with the files evicted and then
+  // cached.
+  void Run(const string& name, const vector<string>& files,
+           const function<void(double&, double&)>& f) const {
+    for (int warm = 0; warm < 2; ++warm) {
+      result best = { numeric_limits<double>::max(),
+                      numeric_limits<double>::max(),
+                      numeric_limits<double>::max() };
+      bool ok = true;
+      for (int k = 0; ok && k < _r; ++k) {
+        if (!warm)
+          for (const string& file : files) Evict(file);
+        result r;
+        ok = Trial(f, r);
+        best.construct = min(best.construct, r.construct);
+        best.query = min(best.query, r.query);
+        best.rss = min(best.rss, r.rss);
+      }
+      cout << left << setw(40) << name << setw(5)
+           << (warm ? "warm" : "cold") << right;
+      if (ok)
+        cout << fixed << setprecision(2)
+             << setw(12) << best.construct << " ms"
+             << setw(10) << best.query << " ms"
+             << setw(10) << setprecision(1) << best.rss / 1048576 << " MB\n";
+      else
+        cout << " failed\n";
+    }
+  }
+  void Skip(const string& name, const string& why) const {
+    cout << left << setw(40) << name << " skipped: " << why << "\n";
+  }
+};
+
+struct pos {
+  real x, y, z;
+};
+
+class euclid {
+public:
+  real operator()(const pos& a, const pos& b) const {
+    return hypot(a.x - b.x, hypot(a.y - b.y, a.z - b.z));
+  }
+};
+
+int main(int argc, const char* const argv[]) {
+  try {
+    Utility::set_digits();
+    string
+      gravity = GravityModel::DefaultGravityName(),
+      magnetic = MagneticModel::DefaultMagneticName(),
+      geoid = Geoid::DefaultGeoidName();
+    int n = 200000, r = 3;
+    for (int m = 1; m < argc; ++m) {
+      string arg(argv[m]);
+      if (arg == "-g" && m + 1 < argc)
+        gravity = argv[++m];
+      else if (arg == "-m" && m + 1 < argc)
+        magnetic = argv[++m];
+      else if (arg == "-d" && m + 1 < argc)
+        geoid = argv[++m];
+      else if (arg == "-n" && m + 1 < argc)
+        n = Utility::val<int>(string(argv[++m]));
+      else if (arg == "-r" && m + 1 < argc)
+        r = Utility::val<int>(string(argv[++m]));
+      else {
+        cerr << "Usage: " << argv[0] << " [-g gravity] [-m magnetic]"
+             << " [-d geoid] [-n points] [-r repeat]\n";
+        return 1;
+      }
+    }
+    if (!(n > 0 && r > 0)) {
+      cerr << "points and repeat must be positive\n";
+      return 1;
+    }
+    Startup bench(r);
+    cout << left << setw(45) << "model" << right << setw(15) << "construct"
+         << setw(13) << "first query" << setw(12) << "peak RSS" << "\n";
+
+    // The first query for the models
+    const real lat = 42, lon = -75, h = 100, t = 2025;
+    {
+      string file = GravityModel::DefaultGravityPath() + "/" + gravity +
+        ".egm";
+      vector<string> files = {file, file + ".cof"};
+      for (int mapped = 0; mapped < 2; ++mapped) {
+        string name = "GravityModel " + gravity + (mapped ? " mapped" : "");
+        if (!Exists(file)) {
+          bench.Skip(name, "not installed");
+          continue;
+        }
+        bench.Run(name, files, [&](double& tc, double& tq) {
+          timepoint t0 = Now();
+          GravityModel g(gravity, "", -1, -1, mapped != 0);
+          timepoint t1 = Now();
+          real gx, gy, gz;
+          sink += g.Gravity(lat, lon, h, gx, gy, gz);
+          timepoint t2 = Now();
+          tc = Ms(t0, t1); tq = Ms(t1, t2);
+        });
+      }
+    }
+    {
+      string file = MagneticModel::DefaultMagneticPath() + "/" + magnetic +
+        ".wmm";
+      vector<string> files = {file, file + ".cof"};
+      for (int mapped = 0; mapped < 2; ++mapped) {
+        string name = "MagneticModel " + magnetic + (mapped ? " mapped" : "");
+        if (!Exists(file)) {
+          bench.Skip(name, "not installed");
+          continue;
+        }
+        bench.Run(name, files, [&](double& tc, double& tq) {
+          timepoint t0 = Now();
+          MagneticModel m(magnetic, "", Geocentric::WGS84(), -1, -1,
+                          mapped != 0);
+          timepoint t1 = Now();
+          real bx, by, bz;
+          m(t, lat, lon, h, bx, by, bz);
+          sink += bx + by + bz;
+          timepoint t2 = Now();
+          tc = Ms(t0, t1); tq = Ms(t1, t2);
+        });
+      }
+    }
+    {
+      string file = Geoid::DefaultGeoidPath() + "/" + geoid + ".pgm";
+      vector<string> files = {file};
+      // 0 = read on demand, 1 = CacheAll, 2 = mapped
+      const char* const modes[3] = {"", " + CacheAll", " mapped"};
+      for (int mode = 0; mode < 3; ++mode) {
+        string name = "Geoid " + geoid + modes[mode];
+        if (!Exists(file)) {
+          bench.Skip(name, "not installed");
+          continue;
+        }
+        bench.Run(name, files, [&](double& tc, double& tq) {
+          timepoint t0 = Now();
+          Geoid g(geoid, "", true, false, mode == 2);
+          if (mode == 1) g.CacheAll();
+          timepoint t1 = Now();
+          sink += g(lat, lon);
+          timepoint t2 = Now();
+          tc = Ms(t0, t1); tq = Ms(t1, t2);
+        });
+      }
+    }
+    {
+      // Random points on the unit sphere
+      mt19937 g(42);
+      normal_distribution<double> N(0, 1);
+      vector<pos> pts(n);
+      for (pos& p : pts) {
+        real x = real(N(g)), y = real(N(g)), z = real(N(g)),
+          d = hypot(x, hypot(y, z));
+        p.x = x / d; p.y = y / d; p.z = z / d;
+      }
+      const string
+        binfile = "ModelStartup-nn.bin", mapfile = "ModelStartup-nn.map";
+      {
+        NearestNeighbor<real, pos, euclid> tree(pts, euclid());
+        ofstream f(binfile.c_str(), ios::binary);
+        tree.Save(f);
+        ofstream m(mapfile.c_str(), ios::binary);
+        tree.SaveMapped(m);
+      }
+      pos q = {1, 0, 0};
+      vector<int> ind;
+      bench.Run("NearestNeighbor::Load", {binfile},
+                [&](double& tc, double& tq) {
+        timepoint t0 = Now();
+        NearestNeighbor<real, pos, euclid> nn;
+        ifstream f(binfile.c_str(), ios::binary);
+        nn.Load(f);
+        timepoint t1 = Now();
+        sink += nn.Search(pts, euclid(), q, ind, 10);
+        timepoint t2 = Now();
+        tc = Ms(t0, t1); tq = Ms(t1, t2);
+      });
+      bench.Run("NearestNeighbor::LoadMapped", {mapfile},
+                [&](double& tc, double& tq) {
+        timepoint t0 = Now();
+        SphericalEngine::mappedfile mf;
+        mf.map(mapfile);
+        NearestNeighbor<real, pos, euclid> nn;
+        nn.LoadMapped(mf.data(), mf.size(), false);
+        timepoint t1 = Now();
+        sink += nn.Search(pts, euclid(), q, ind, 10);
+        timepoint t2 = Now();
+        tc = Ms(t0, t1); tq = Ms(t1, t2);
+      });
+      remove(binfile.c_str());
+      remove(mapfile.c_str());
+    }
+    if (sink == 0) cout << "\n";
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+  catch (...) {
+    cerr << "Caught unknown exception\n";
+    return 1;
+  }
+  return 0;
+}
+
+#endif
@@ -0,0 +1,281 @@
+/**
+ * \file OrderSweep.cpp
+ *
+ * Measure the speed and the accuracy of the series approximations used by
+ * Geodesic, TransverseMercator, and Rhumb.  The orders of these series are
+ * set at compile time by GEOGRAPHICLIB_GEODESIC_ORDER,
+ * GEOGRAPHICLIB_TRANSVERSEMERCATOR_ORDER, and GEOGRAPHICLIB_RHUMBAREA_ORDER;
+ * the ordersweep target builds this program against copies of the library
+ * compiled with each of these set to 4, 5, 6, 7, and 8 and runs them.
+ *
+ * Usage: OrderSweep [-n count] [-r repeat] [-f GeodTest.dat]
+ *
+ * The WGS84 ellipsoid is used.  The errors are the maxima over \e count
+ * (default 20000) random problems of the differences from GeodesicExact,
+ * TransverseMercatorExact, and Rhumb with \e exact = true; the error in the
+ * rhumb area is found by integrating the area numerically.  With -f, the
+ * geodesic problems are the first \e count lines of the geodesic test data
+ * set read by GeodTest.cpp, and the errors are measured against the
+ * accurate results given there.  The times are the best of \e repeat
+ * (default 5) passes, in ns per call.
+ **********************************************************************/
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+#include <GeographicLib/Ellipsoid.hpp>
+#include <GeographicLib/Geodesic.hpp>
+#include <GeographicLib/GeodesicExact.hpp>
+#include <GeographicLib/Rhumb.hpp>
+#include <GeographicLib/TransverseMercator.hpp>
+#include <GeographicLib/TransverseMercatorExact.hpp>
+#include <GeographicLib/Utility.hpp>
+
+using namespace GeographicLib;
+using namespace std;
+
+typedef Math::real real;
+
+// Accumulate results here so that the compiler can't discard the work.
+static real sink = 0;
+
+// Call f(i) for i in [0, n) repeat times and return the best time per call
+// in ns.
+template<class F> double Time(int n, int repeat, F f) {
+  double best = numeric_limits<double>::max();
+  for (int r = 0; r < repeat; ++r) {
+    auto t0 = chrono::steady_clock::now();
+    for (int i = 0; i < n; ++i) f(i);
+    auto t1 = chrono::steady_clock::now();
+    best = min(best, chrono::duration<double, nano>(t1 - t0).count());
+  }
+  return best / n;
+}
+
+// Print a line of the results; a second line for the same function omits
+// the name and the time.
+void Report(const string& name, double ns, const string& quantity,
+            real err, const string& units) {
+  cout << left << setw(30) << name << right << setw(10);
+  if (name.empty())
+    cout << "" << "     ";
+  else
+    cout << fixed << setprecision(1) << ns << " ns  ";
+  cout << " " << left << setw(4) << quantity << " error " << right
+       << setw(10) << scientific << setprecision(2) << double(err) << " "
+       << units << "\n";
+}
+
+// The area between a rhumb line and the equator computed by integrating
+// sin(xi) with respect to the isometric latitude psi (where xi is the
+// authalic latitude) with 8-point Gauss-Legendre quadrature on 16
+// intervals.
+real RhumbArea(const Ellipsoid& ell, real lat1, real lon1,
+               real lat2, real lon2) {
+  static const double x[4] = {
+    0.1834346424956498, 0.5255324099163290,
+    0.7966664774136267, 0.9602898564975363 };
+  static const double w[4] = {
+    0.3626837833783620, 0.3137066458778873,
+    0.2223810344533745, 0.1012285362903763 };
+  const int nint = 16;
+  real
+    lon12 = Math::AngDiff(lon1, lon2),
+    psi1 = ell.IsometricLatitude(lat1),
+    psi2 = ell.IsometricLatitude(lat2),
+    h = (psi2 - psi1) / nint,
+    mean = 0;
+  auto sinxi = [&ell](real psi) -> real {
+    real phi = ell.InverseIsometricLatitude(psi);
+    return Math::sind(ell.AuthalicLatitude(phi));
+  };
+  if (h == 0)
+    mean = sinxi(psi1);
+  else {
+    for (int k = 0; k < nint; ++k) {
+      real c = psi1 + (k + real(0.5)) * h;
+      for (int j = 0; j < 4; ++j)
+        mean += real(w[j]) * (sinxi(c - real(x[j]) * h / 2) +
+                              sinxi(c + real(x[j]) * h / 2));
+    }
+    mean /= 2 * nint;
+  }
+  return ell.Area() / (2 * Math::td) * lon12 * mean;
+}
+
+int main(int argc, const char* const argv[]) {
+  try {
+    Utility::set_digits();
+    int n = 20000, repeat = 5;
+    string file;
+    for (int m = 1; m < argc; ++m) {
+      string arg(argv[m]);
+      if (arg == "-n" && m + 1 < argc)
+        n = Utility::val<int>(string(argv[++m]));
+      else if (arg == "-r" && m + 1 < argc)
+        repeat = Utility::val<int>(string(argv[++m]));
+      else if (arg == "-f" && m + 1 < argc)
+        file = argv[++m];
+      else {
+        cerr << "Usage: " << argv[0]
+             << " [-n count] [-r repeat] [-f GeodTest.dat]\n";
+        return 1;
+      }
+    }
+    if (!(n > 0 && repeat > 0)) {
+      cerr << "count and repeat must be positive\n";
+      return 1;
+    }
+
+    const real a = Constants::WGS84_a(), f = Constants::WGS84_f();
+    const Geodesic geod(a, f);
+    const GeodesicExact& geode = GeodesicExact::WGS84();
+    const TransverseMercator& tm = TransverseMercator::UTM();
+    const TransverseMercatorExact& tme = TransverseMercatorExact::UTM();
+    const Rhumb rhumb(a, f, false), rhumbe(a, f, true);
+    const Ellipsoid ell(a, f);
+
+    // The geodesic problems (and the accurate solutions) are given by lat1,
+    // lon1, azi1, lat2, lon2, azi2, s12, S12.
+    vector<real> lat1(n), lon1(n), azi1(n), lat2(n), lon2(n), azi2(n),
+      s12(n), S12(n);
+    mt19937 g(42);
+    uniform_real_distribution<double> U(0, 1);
+    if (!file.empty()) {
+      ifstream str(file.c_str());
+      if (!str.good()) {
+        cerr << "Cannot open " << file << "\n";
+        return 1;
+      }
+      real a12, m12;
+      int i = 0;
+      for (; i < n; ++i)
+        if (!(str >> lat1[i] >> lon1[i] >> azi1[i] >> lat2[i] >> lon2[i]
+              >> azi2[i] >> s12[i] >> a12 >> m12 >> S12[i]))
+          break;
+      if (i == 0) {
+        cerr << "No data in " << file << "\n";
+        return 1;
+      }
+      n = i;
+    } else {
+      // Lines shorter than the distance to the cut locus (at least pi b
+      // for an oblate ellipsoid) are shortest paths.
+      for (int i = 0; i < n; ++i) {
+        lat1[i] = real(asin(2 * U(g) - 1) / Math::degree());
+        lon1[i] = 0;
+        azi1[i] = real(180 * U(g));
+        s12[i] = real(1.99e7 * U(g));
+        real t;
+        geode.GenDirect(lat1[i], lon1[i], azi1[i], false, s12[i],
+                        Geodesic::STANDARD | Geodesic::AREA,
+                        lat2[i], lon2[i], azi2[i], t, t, t, t, S12[i]);
+      }
+    }
+    // Points within 30 degrees of the central meridian for the transverse
+    // Mercator projection (with the accurate projected coordinates) and
+    // rhumb lines (with the accurate distances and areas).
+    vector<real> tmlat(n), tmlon(n), x(n), y(n),
+      rlat1(n), rlon1(n), rlat2(n), rlon2(n), rs12(n), rS12(n);
+    for (int i = 0; i < n; ++i) {
+      tmlat[i] = real(170 * U(g) - 85);
+      tmlon[i] = real(60 * U(g) - 30);
+      tme.Forward(0, tmlat[i], tmlon[i], x[i], y[i]);
+      rlat1[i] = real(170 * U(g) - 85);
+      rlon1[i] = real(360 * U(g) - 180);
+      rlat2[i] = real(170 * U(g) - 85);
+      rlon2[i] = real(360 * U(g) - 180);
+      real t;
+      rhumbe.Inverse(rlat1[i], rlon1[i], rlat2[i], rlon2[i], rs12[i], t);
+      rS12[i] = RhumbArea(ell, rlat1[i], rlon1[i], rlat2[i], rlon2[i]);
+    }
+
+    cout << "Orders: Geodesic " << GEOGRAPHICLIB_GEODESIC_ORDER
+         << ", TransverseMercator " << GEOGRAPHICLIB_TRANSVERSEMERCATOR_ORDER
+         << ", Rhumb area " << GEOGRAPHICLIB_RHUMBAREA_ORDER
+         << " (" << n << " points, reference "
+         << (file.empty() ? string("GeodesicExact") : file) << ")\n";
+    const real nm = real(1e9);
+    {
+      vector<real> s(n), S(n), lat(n), lon(n);
+      double t = Time(n, repeat, [&](int i) {
+        real a1, a2, m, M1, M2;
+        geod.GenInverse(lat1[i], lon1[i], lat2[i], lon2[i],
+                        Geodesic::DISTANCE | Geodesic::AZIMUTH |
+                        Geodesic::AREA, s[i], a1, a2, m, M1, M2, S[i]);
+        sink += a1 + a2;
+      });
+      real es = 0, eS = 0;
+      for (int i = 0; i < n; ++i) {
+        es = max(es, real(fabs(s[i] - s12[i])));
+        eS = max(eS, real(fabs(S[i] - S12[i])));
+      }
+      Report("Geodesic::Inverse", t, "s12", es * nm, "nm");
+      Report("", t, "S12", eS, "m^2");
+      t = Time(n, repeat, [&](int i) {
+        real a2;
+        geod.Direct(lat1[i], lon1[i], azi1[i], s12[i], lat[i], lon[i], a2);
+        sink += a2;
+      });
+      real ep = 0;
+      for (int i = 0; i < n; ++i) {
+        real d;
+        geode.Inverse(lat2[i], lon2[i], lat[i], lon[i], d);
+        ep = max(ep, d);
+      }
+      Report("Geodesic::Direct", t, "pos", ep * nm, "nm");
+    }
+    {
+      vector<real> u(n), v(n);
+      double t = Time(n, repeat, [&](int i) {
+        tm.Forward(0, tmlat[i], tmlon[i], u[i], v[i]);
+      });
+      real ep = 0;
+      for (int i = 0; i < n; ++i)
+        ep = max(ep, real(hypot(u[i] - x[i], v[i] - y[i])));
+      Report("TransverseMercator::Forward", t, "pos", ep * nm, "nm");
+      t = Time(n, repeat, [&](int i) {
+        tm.Reverse(0, x[i], y[i], u[i], v[i]);
+      });
+      ep = 0;
+      for (int i = 0; i < n; ++i) {
+        real d;
+        geode.Inverse(tmlat[i], tmlon[i], u[i], v[i], d);
+        ep = max(ep, d);
+      }
+      Report("TransverseMercator::Reverse", t, "pos", ep * nm, "nm");
+    }
+    {
+      vector<real> s(n), S(n);
+      double t = Time(n, repeat, [&](int i) {
+        real a12;
+        rhumb.Inverse(rlat1[i], rlon1[i], rlat2[i], rlon2[i],
+                      s[i], a12, S[i]);
+        sink += a12;
+      });
+      real es = 0, eS = 0;
+      for (int i = 0; i < n; ++i) {
+        es = max(es, real(fabs(s[i] - rs12[i])));
+        eS = max(eS, real(fabs(S[i] - rS12[i])));
+      }
+      Report("Rhumb::Inverse", t, "s12", es * nm, "nm");
+      Report("", t, "S12", eS, "m^2");
+    }
+    if (sink == 0) cout << "\n";
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+  catch (...) {
+    cerr << "Caught unknown exception\n";
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,206 @@
+/**
+ * \file ThreadScaling.cpp
+ *
+ * Measure how the throughput of shared read-only objects scales with the
+ * number of threads.  Each thread makes the same number of calls on a
+ * single shared Geodesic, TransverseMercator, Geoid (constructed with \e
+ * threadsafe = true, so the data set is cached), or GravityModel object, so
+ * perfect scaling gives an efficiency of 100%; contention (false sharing of
+ * static tables, locks, or initialization guards) and memory bandwidth
+ * limits show up as lower efficiencies.  This is built by the
+ * scalingbenchmarks target, which also runs it.
+ *
+ * Usage: ThreadScaling [-n count] [-r repeat] [-t threads] [-g gravity]
+ *   [-d geoid] [pattern]
+ *
+ * Each thread makes \e count (default 200000) calls; the best of \e repeat
+ * (default 5) runs is reported.  The numbers of threads are 1, 2, 4, ...,
+ * up to \e threads (default std::thread::hardware_concurrency()).  Only the
+ * benchmarks whose names contain \e pattern are run.  The geoid and the
+ * gravity model default to the default models of the classes; they are
+ * skipped if they aren't installed.
+ **********************************************************************/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <GeographicLib/Geodesic.hpp>
+#include <GeographicLib/Geoid.hpp>
+#include <GeographicLib/GravityModel.hpp>
+#include <GeographicLib/TransverseMercator.hpp>
+#include <GeographicLib/Utility.hpp>
+
+using namespace GeographicLib;
+using namespace std;
+
+typedef Math::real real;
+
+// Accumulate results here so that the compiler can't discard the work.
+static real sink = 0;
+static mutex sinklock;
+
+class Scaling {
+private:
+  int _n, _r;
+  vector<unsigned> _threads;
+  string _pattern;
+  // Run f(i) for i in [0, n) on each of nt threads, which start together,
+  // and return the best elapsed time in s.  f returns a value which is
+  // accumulated locally in each thread.
+  template<class F> double Time(unsigned nt, int n, F f) const {
+    double best = numeric_limits<double>::max();
+    for (int r = 0; r < _r; ++r) {
+      atomic<unsigned> ready(0);
+      atomic<bool> go(false);
+      vector<thread> pool;
+      for (unsigned t = 0; t < nt; ++t)
+        pool.push_back(thread([&, t]() {
+          real s = 0;
+          ready.fetch_add(1);
+          while (!go.load()) this_thread::yield();
+          // Each thread starts at a different point in the data
+          int off = int(t * 7919u % unsigned(n));
+          for (int i = 0; i < n; ++i) {
+            int j = i + off;
+            s += f(j < n ? j : j - n);
+          }
+          lock_guard<mutex> lock(sinklock);
+          sink += s;
+        }));
+      while (ready.load() < nt) this_thread::yield();
+      auto t0 = chrono::steady_clock::now();
+      go.store(true);
+      for (thread& th : pool) th.join();
+      auto t1 = chrono::steady_clock::now();
+      best = min(best, chrono::duration<double>(t1 - t0).count());
+    }
+    return best;
+  }
+public:
+  Scaling(int n, int r, unsigned maxthreads, const string& pattern)
+    : _n(n), _r(r), _pattern(pattern) {
+    for (unsigned t = 1; t < maxthreads; t *= 2) _threads.push_back(t);
+    _threads.push_back(maxthreads);
+  }
+  // Report the throughput with each number of threads and the efficiency
+  // relative to the single-threaded throughput.  n defaults to count.
+  template<class F> void Run(const string& name, F f, int n = 0) const {
+    if (name.find(_pattern) == string::npos) return;
+    if (n <= 0) n = _n;
+    cout << name << "\n";
+    double rate1 = 0;
+    for (unsigned nt : _threads) {
+      double rate = double(nt) * n / Time(nt, n, f);
+      if (nt == 1) rate1 = rate;
+      cout << setw(8) << nt << " thread" << (nt == 1 ? " " : "s")
+           << fixed << setprecision(3) << setw(12) << rate / 1e6
+           << " Mcalls/s" << setprecision(1) << setw(8)
+           << 100 * rate / (nt * rate1) << "%\n";
+    }
+  }
+  void Skip(const string& name, const string& why) const {
+    if (name.find(_pattern) == string::npos) return;
+    cout << name << " skipped: " << why << "\n";
+  }
+};
+
+int main(int argc, const char* const argv[]) {
+  try {
+    Utility::set_digits();
+    int n = 200000, r = 5;
+    unsigned maxthreads = max(1u, thread::hardware_concurrency());
+    string pattern,
+      gravity = GravityModel::DefaultGravityName(),
+      geoidname = Geoid::DefaultGeoidName();
+    for (int m = 1; m < argc; ++m) {
+      string arg(argv[m]);
+      if (arg == "-n" && m + 1 < argc)
+        n = Utility::val<int>(string(argv[++m]));
+      else if (arg == "-r" && m + 1 < argc)
+        r = Utility::val<int>(string(argv[++m]));
+      else if (arg == "-t" && m + 1 < argc)
+        maxthreads = Utility::val<unsigned>(string(argv[++m]));
+      else if (arg == "-g" && m + 1 < argc)
+        gravity = argv[++m];
+      else if (arg == "-d" && m + 1 < argc)
+        geoidname = argv[++m];
+      else if (arg.size() && arg[0] != '-')
+        pattern = arg;
+      else {
+        cerr << "Usage: " << argv[0] << " [-n count] [-r repeat]"
+             << " [-t threads] [-g gravity] [-d geoid] [pattern]\n";
+        return 1;
+      }
+    }
+    if (!(n > 0 && r > 0 && maxthreads > 0)) {
+      cerr << "count, repeat, and threads must be positive\n";
+      return 1;
+    }
+    Scaling bench(n, r, maxthreads, pattern);
+
+    mt19937 g(42);
+    uniform_real_distribution<double> U(0, 1);
+    vector<real> lat1(n), lon1(n), lat2(n), lon2(n), tmlat(n), tmlon(n);
+    for (int i = 0; i < n; ++i) {
+      lat1[i] = real(asin(2 * U(g) - 1) / Math::degree());
+      lon1[i] = real(360 * U(g) - 180);
+      lat2[i] = real(asin(2 * U(g) - 1) / Math::degree());
+      lon2[i] = real(360 * U(g) - 180);
+      // Points within the width of a UTM zone of the central meridian
+      tmlat[i] = real(160 * U(g) - 80);
+      tmlon[i] = real(6 * U(g) - 3);
+    }
+
+    {
+      const Geodesic& geod = Geodesic::WGS84();
+      bench.Run("Geodesic::Inverse", [&](int i) -> real {
+        real s, a1, a2;
+        geod.Inverse(lat1[i], lon1[i], lat2[i], lon2[i], s, a1, a2);
+        return s + a1 + a2; });
+    }
+    {
+      const TransverseMercator& tm = TransverseMercator::UTM();
+      bench.Run("TransverseMercator::Forward", [&](int i) -> real {
+        real x, y;
+        tm.Forward(0, tmlat[i], tmlon[i], x, y);
+        return x + y; });
+    }
+    try {
+      const Geoid geoid(geoidname, "", true, true);
+      bench.Run("Geoid::operator() (cached)", [&](int i) -> real {
+        return geoid(lat1[i], lon1[i]); });
+    }
+    catch (const GeographicErr& e) {
+      bench.Skip("Geoid::operator() (cached)", e.what());
+    }
+    try {
+      const GravityModel grav(gravity);
+      // Spherical harmonic sums are slow; use fewer points
+      bench.Run("GravityModel::Gravity", [&](int i) -> real {
+        real gx, gy, gz;
+        return grav.Gravity(lat1[i], lon1[i], 0, gx, gy, gz); },
+        max(1, n / 100));
+    }
+    catch (const GeographicErr& e) {
+      bench.Skip("GravityModel::Gravity", e.what());
+    }
+    if (sink == 0) cout << "\n";
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+  catch (...) {
+    cerr << "Caught unknown exception\n";
+    return 1;
+  }
+  return 0;
+}
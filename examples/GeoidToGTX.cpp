@@ -2,6 +2,11 @@
 // 1' resolution this takes about 10 mins on a 8-processor Intel 3.0 GHz
 // machine using OpenMP.
 //
+// The Gravity utility does the same calculation (for an arbitrary region
+// and grid spacing) with
+//   Gravity -n egm2008 -H --grid -90 -180 90 179:59 1' 1' --gtx -j 0 \
+//     --output-file egm2008-1.gtx
+//
 // For the format of gtx files, see
 // https://vdatum.noaa.gov/docs/gtx_info.html#dev_gtx_binary
 //
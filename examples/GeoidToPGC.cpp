@@ -0,0 +1,212 @@
+// Convert a pgm geoid data file to the compressed pgc format which can be
+// read by the Geoid class.  The geoid heights vary smoothly so the data
+// compresses well; larger tiles give smaller files but the decoding of a tile
+// when it is first accessed takes longer.
+//
+// The pgc file consists of
+//   the header of the pgm file with the first line replaced by "P5C" and
+//     the tile width and height added after maxval (e.g., "65535 64 64");
+//     as in the pgm file, a single whitespace character follows;
+//   the tile index, ntiles + 1 big-endian 8-byte offsets of the tiles
+//     relative to the end of the index (the last entry is the total length
+//     of the tiles); the tiles are in row order starting at the NW corner;
+//   the tiles.
+// Each tile consists of a byte giving the Rice parameter k followed by a
+// big-endian bit stream of the residuals, in row order, of each pixel from
+// the median edge detector (MED) prediction based on its W, N, and NW
+// neighbors (the first pixel is predicted by 0, the rest of the first row
+// by the W neighbor, and the rest of the first column by the N neighbor).  A
+// residual r is mapped to u = 2*r (for r >= 0) or -2*r-1 (for r < 0) which
+// is coded as u>>k in unary (ones terminated by a zero) followed by the k low
+// bits of u; if u>>k >= 32, the code is 32 ones followed by u in 34 bits.
+// The bit stream is padded with zeros to a whole number of bytes.  k is
+// chosen to minimize the size of each tile.
+
+#include <vector>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <algorithm>
+#include <limits>
+
+#include <GeographicLib/Utility.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+namespace {
+
+  const int qmax = 32, nraw = 34, kmax = 32;
+
+  class BitWriter {
+    vector<unsigned char>& _buf;
+    unsigned long long _acc;
+    int _nacc;
+  public:
+    BitWriter(vector<unsigned char>& buf) : _buf(buf), _acc(0), _nacc(0) {}
+    // Write the nb (<= 34) low bits of x
+    void put(unsigned long long x, int nb) {
+      for (int i = nb; i--;) {
+        _acc = (_acc << 1) | ((x >> i) & 1ULL);
+        if (++_nacc == 8) {
+          _buf.push_back((unsigned char)(_acc));
+          _acc = 0; _nacc = 0;
+        }
+      }
+    }
+    void flush() { if (_nacc) put(0, 8 - _nacc); }
+  };
+
+  unsigned long long codelength(const vector<unsigned long long>& u, int k) {
+    unsigned long long n = 0;
+    for (size_t i = 0; i < u.size(); ++i) {
+      unsigned long long q = u[i] >> k;
+      n += q < (unsigned long long)(qmax) ? q + 1 + k : qmax + nraw;
+    }
+    return n;
+  }
+
+  // Encode the w x h tile v (in row order) appending the result to buf
+  void encodetile(const vector<unsigned>& v, int w, int h,
+                  vector<unsigned char>& buf) {
+    vector<unsigned long long> u(v.size());
+    for (int y = 0; y < h; ++y) {
+      for (int x = 0; x < w; ++x) {
+        long long pred;
+        if (y == 0)
+          pred = x == 0 ? 0 : v[x - 1];
+        else if (x == 0)
+          pred = v[(y - 1) * w];
+        else {
+          long long
+            a = v[y * w + x - 1],
+            b = v[(y - 1) * w + x],
+            c = v[(y - 1) * w + x - 1];
+          pred = c >= max(a, b) ? min(a, b) :
+            (c <= min(a, b) ? max(a, b) : a + b - c);
+        }
+        long long r = (long long)(v[y * w + x]) - pred;
+        u[y * w + x] = r >= 0 ? 2ULL * r : 2ULL * (-r) - 1;
+      }
+    }
+    int k = 0;
+    unsigned long long n = codelength(u, 0);
+    for (int k1 = 1; k1 <= kmax; ++k1) {
+      unsigned long long n1 = codelength(u, k1);
+      if (n1 < n) { n = n1; k = k1; }
+    }
+    buf.push_back((unsigned char)(k));
+    BitWriter out(buf);
+    for (size_t i = 0; i < u.size(); ++i) {
+      unsigned long long q = u[i] >> k;
+      if (q < (unsigned long long)(qmax)) {
+        for (; q; --q) out.put(1, 1);
+        out.put(0, 1);
+        if (k) out.put(u[i] & ((1ULL << k) - 1), k);
+      } else {
+        for (int j = 0; j < qmax; ++j) out.put(1, 1);
+        out.put(u[i], nraw);
+      }
+    }
+    out.flush();
+  }
+
+}
+
+int main(int argc, const char* const argv[]) {
+  // Hardwired for 2 or 3 args:
+  // 1 = the input pgm file (e.g., egm2008-1.pgm)
+  // 2 = the output pgc file (e.g., egm2008-1.pgc)
+  // 3 = the tile size in pixels (default 64)
+  if (argc != 3 && argc != 4) {
+    cerr << "Usage: " << argv[0] << " input.pgm output.pgc [tilesize]\n";
+    return 1;
+  }
+  try {
+    string infile(argv[1]), outfile(argv[2]);
+    int tile = argc == 4 ? Utility::val<int>(string(argv[3])) : 64;
+    if (tile <= 0)
+      throw GeographicErr("Tile size must be positive");
+    ifstream in(infile.c_str(), ios::binary);
+    if (!in.good())
+      throw GeographicErr("File not readable " + infile);
+    string s;
+    if (!(getline(in, s) && s == "P5"))
+      throw GeographicErr("File not in PGM format " + infile);
+    ostringstream header;
+    header << "P5C\n";
+    int width = 0, height = 0;
+    while (getline(in, s)) {
+      header << s << "\n";
+      if (s.empty() || s[0] == '#')
+        continue;
+      istringstream is(s);
+      if (!(is >> width >> height) || width <= 0 || height <= 0)
+        throw GeographicErr("Error reading raster size " + infile);
+      break;
+    }
+    if (width == 0)
+      throw GeographicErr("Error reading raster size " + infile);
+    unsigned long long maxval;
+    if (!(in >> maxval) || !(maxval == 0xffffULL || maxval == 0xffffffffULL))
+      throw GeographicErr("Error reading maxval " + infile);
+    in.get();                   // The whitespace after maxval
+    header << maxval << " " << tile << " " << tile << "\n";
+    const int psize = maxval == 0xffffULL ? 2 : 4;
+    int
+      ntx = (width + tile - 1) / tile,
+      nty = (height + tile - 1) / tile;
+    size_t ntiles = size_t(ntx) * size_t(nty);
+
+    ofstream out(outfile.c_str(), ios::binary);
+    if (!out.good())
+      throw GeographicErr("Cannot open " + outfile);
+    out << header.str();
+    streamoff indexstart = out.tellp();
+    // Write a dummy index for now
+    vector<unsigned long long> offsets(ntiles + 1, 0);
+    Utility::writearray<unsigned long long, unsigned long long, true>
+      (out, offsets);
+
+    // Process a row of tiles at a time
+    vector<unsigned> rows, v;
+    vector<unsigned char> buf;
+    unsigned long long total = 0;
+    for (int ty = 0; ty < nty; ++ty) {
+      int y0 = ty * tile, h = min(tile, height - y0);
+      rows.resize(size_t(h) * width);
+      if (psize == 2) {
+        vector<unsigned short> r(rows.size());
+        Utility::readarray<unsigned short, unsigned short, true>(in, r);
+        copy(r.begin(), r.end(), rows.begin());
+      } else
+        Utility::readarray<unsigned, unsigned, true>(in, rows);
+      for (int tx = 0; tx < ntx; ++tx) {
+        int x0 = tx * tile, w = min(tile, width - x0);
+        v.resize(size_t(w) * h);
+        for (int y = 0; y < h; ++y)
+          copy(rows.begin() + size_t(y) * width + x0,
+               rows.begin() + size_t(y) * width + x0 + w,
+               v.begin() + size_t(y) * w);
+        buf.clear();
+        encodetile(v, w, h, buf);
+        out.write(reinterpret_cast<const char*>(buf.data()),
+                  streamsize(buf.size()));
+        total += buf.size();
+        offsets[size_t(ty) * ntx + tx + 1] = total;
+      }
+    }
+    out.seekp(indexstart);
+    Utility::writearray<unsigned long long, unsigned long long, true>
+      (out, offsets);
+    out.close();
+    if (!out.good())
+      throw GeographicErr("Error writing " + outfile);
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
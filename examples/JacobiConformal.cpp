@@ -3,8 +3,8 @@
 #include <iostream>
 #include <iomanip>
 #include <exception>
+#include <GeographicLib/JacobiConformal.hpp>
 #include <GeographicLib/Utility.hpp>
-#include "JacobiConformal.hpp"
 
 using namespace std;
 using namespace GeographicLib;
@@ -8,14 +8,15 @@
 #include <iostream>
 #include <iomanip>
 #include <exception>
-#include "AuxLatitude.hpp"
+#include <GeographicLib/AuxLatitude.hpp>
 
 using namespace std;
+using namespace GeographicLib;
 
 int main() {
   try {
-    typedef GeographicLib::AuxLatitude<double> latitude;
-    typedef latitude::angle angle;
+    typedef AuxLatitude latitude;
+    typedef AuxAngle angle;
     double a = 2, b = 1;        // Equatorial radius and polar semi-axis
     latitude aux(a, b);
     bool series = false;        // Don't use series method
@@ -0,0 +1,35 @@
+// Example of using the GeographicLib::GeodesicBatchExecutor class
+
+#include <iostream>
+#include <exception>
+#include <vector>
+#include <GeographicLib/Geodesic.hpp>
+#include <GeographicLib/GeodesicBatchExecutor.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+int main() {
+  try {
+    const Geodesic& geod = Geodesic::WGS84();
+    // Use all the available threads
+    GeodesicBatchExecutor exec;
+    // Distances from JFK to a million points along the equator
+    size_t n = 1000000;
+    vector<double> lat1(n, 40.640), lon1(n, -73.779),
+      lat2(n, 0), lon2(n), s12(n);
+    for (size_t i = 0; i < n; ++i)
+      lon2[i] = -180 + 360 * (i + 0.5) / n;
+    exec.Inverse(geod, n, lat1.data(), lon1.data(), lat2.data(), lon2.data(),
+                 Geodesic::DISTANCE, nullptr, s12.data(), nullptr, nullptr,
+                 nullptr, nullptr, nullptr, nullptr);
+    double smax = 0;
+    for (size_t i = 0; i < n; ++i)
+      smax = max(smax, s12[i]);
+    cout << "Maximum distance " << smax / 1000 << " km\n";
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+}
@@ -0,0 +1,27 @@
+// Example of using the GeographicLib::GeoidGrid class
+// This requires that the egm96 gravity model be installed; see
+// https://geographiclib.sourceforge.io/C++/doc/gravity.html#gravityinst
+
+#include <iostream>
+#include <exception>
+#include <GeographicLib/GravityModel.hpp>
+#include <GeographicLib/GeoidGrid.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+int main() {
+  try {
+    GravityModel grav("egm96");
+    // A grid of geoid heights covering the UK accurate to 1 cm.  The grid is
+    // saved in uk-egm96.pgm and this file is reused on subsequent runs.
+    GeoidGrid geoid(grav, 49, -11, 61, 2, 0.01, "uk-egm96.pgm");
+    cout << geoid.Resolution() << " " << geoid.MaxError() << "\n";
+    double lat = 52.2, lon = 0.12; // Cambridge, UK
+    cout << geoid(lat, lon) << " " << grav.GeoidHeight(lat, lon) << "\n";
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+}
@@ -0,0 +1,30 @@
+// Example of using the GeographicLib::GridEvaluator class
+// This requires that the egm96 gravity model be installed; see
+// https://geographiclib.sourceforge.io/C++/doc/gravity.html#gravityinst
+
+#include <iostream>
+#include <exception>
+#include <vector>
+#include <GeographicLib/GravityModel.hpp>
+#include <GeographicLib/GridEvaluator.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+int main() {
+  try {
+    GravityModel grav("egm96");
+    // A 1 degree grid of geoid heights covering the UK, north to south.
+    GridEvaluator grid(61, -1, 13, -11, 1, 14);
+    vector<double> N(grid.Size());
+    grid.GeoidHeight(grav, N.data());
+    for (int i = 0; i < grid.NumRows(); ++i)
+      for (int j = 0; j < grid.NumColumns(); ++j)
+        cout << grid.Latitude(i) << " " << grid.Longitude(j) << " "
+             << N[i * grid.NumColumns() + j] << "\n";
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+}
@@ -0,0 +1,49 @@
+// Example of using the GeographicLib::Intersect class
+
+#include <iostream>
+#include <iomanip>
+#include <exception>
+#include <vector>
+#include <GeographicLib/Intersect.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+int main() {
+  try {
+    Intersect inter(Geodesic::WGS84());
+    {
+      // Intersection of the segments JFK-LHR and MAD-YUL (Montreal)
+      int segmode;
+      Intersect::Point p =
+        inter.Segment(40.6, -73.8, 51.6, -0.5, 40.5, -3.6, 45.5, -73.7,
+                      segmode);
+      cout << fixed << setprecision(3)
+           << p.first << " " << p.second << " " << segmode << "\n";
+    }
+    {
+      // All crossings between two sets of segments: a fan of routes out of
+      // Paris and a set of east-west routes
+      vector<double> latX1, lonX1, latX2, lonX2, latY1, lonY1, latY2, lonY2;
+      for (int i = 0; i < 8; ++i) {
+        latX1.push_back(48.9); lonX1.push_back(2.4);
+        latX2.push_back(40 + 2 * i); lonX2.push_back(20);
+        latY1.push_back(42 + 2 * i); lonY1.push_back(5);
+        latY2.push_back(43 + 2 * i); lonY2.push_back(25);
+      }
+      vector<Intersect::Crossing> crossings;
+      inter.AllSegments(latX1.size(),
+                        latX1.data(), lonX1.data(), latX2.data(), lonX2.data(),
+                        latY1.size(),
+                        latY1.data(), lonY1.data(), latY2.data(), lonY2.data(),
+                        crossings);
+      for (const auto& c : crossings)
+        cout << c.i << " " << c.j << " "
+             << fixed << setprecision(3) << c.x << " " << c.y << "\n";
+    }
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+}
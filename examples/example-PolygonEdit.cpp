@@ -0,0 +1,33 @@
+// Example of using the GeographicLib::PolygonEdit class
+
+#include <iostream>
+#include <exception>
+#include <GeographicLib/PolygonEdit.hpp>
+#include <GeographicLib/Geodesic.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+int main() {
+  try {
+    const Geodesic& geod = Geodesic::WGS84();
+    PolygonEdit poly(geod);
+    size_t london = poly.AddPoint( 52,  0);
+    poly.AddPoint( 41,-74);     // New York
+    size_t rio = poly.AddPoint(-23,-43);
+    poly.AddPoint(-26, 28);     // Johannesburg
+    double perimeter, area;
+    unsigned n = poly.Compute(false, true, perimeter, area);
+    cout << n << " " << perimeter << " " << area << "\n";
+    // Each of these solves at most 2 geodesic problems
+    poly.Insert(london, 48.9, 2.4); // Paris
+    poly.Move(rio, -34.6, -58.4);   // Buenos Aires
+    poly.Remove(london);
+    n = poly.Compute(false, true, perimeter, area);
+    cout << n << " " << perimeter << " " << area << "\n";
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+}
@@ -0,0 +1,51 @@
+// Example of using the GeographicLib::TriaxialGeodesic class
+
+#include <iostream>
+#include <iomanip>
+#include <exception>
+#include <GeographicLib/TriaxialGeodesic.hpp>
+#include <GeographicLib/TriaxialGeodesicLine.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+int main() {
+  try {
+    // A triaxial model of the earth (semi-axes in meters)
+    TriaxialGeodesic t(6378172, 6378102, 6356752);
+    {
+      // Sample direct calculation, travel 10000 km from bet = 40, omg = -75
+      // with azimuth 30
+      double bet1 = 40, omg1 = -75, alp1 = 30, s12 = 10000e3;
+      double bet2, omg2, alp2;
+      t.Direct(bet1, omg1, alp1, s12, bet2, omg2, alp2);
+      cout << fixed << setprecision(6)
+           << bet2 << " " << omg2 << " " << alp2 << "\n";
+    }
+    {
+      // Sample inverse calculation, JFK to LHR (using geographic coordinates
+      // as an approximation to the ellipsoidal ones)
+      double
+        bet1 = 40.6, omg1 = -73.8, // JFK Airport
+        bet2 = 51.6, omg2 = -0.5;  // LHR Airport
+      double s12, alp1, alp2;
+      t.Inverse(bet1, omg1, bet2, omg2, s12, alp1, alp2);
+      cout << fixed << setprecision(3)
+           << s12 << " " << alp1 << " " << alp2 << "\n";
+    }
+    {
+      // Waypoints every 1000 km along a geodesic
+      TriaxialGeodesicLine line = t.Line(0, 0, 45);
+      for (int i = 0; i <= 5; ++i) {
+        double bet, omg, alp;
+        line.Position(i * 1000e3, bet, omg, alp);
+        cout << fixed << setprecision(6)
+             << i << " " << bet << " " << omg << " " << alp << "\n";
+      }
+    }
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+}
@@ -11,6 +11,7 @@
 #define GEOGRAPHICLIB_ALBERSEQUALAREA_HPP 1
 
 #include <GeographicLib/Constants.hpp>
+#include <GeographicLib/AuxLatitude.hpp>
 
 namespace GeographicLib {
 
@@ -64,6 +65,10 @@ namespace GeographicLib {
     real _a, _f, _fm, _e2, _e, _e2m, _qZ, _qx;
     real _sign, _lat0, _k0;
     real _n0, _m02, _nrho0, _k2, _txi0, _scxi0, _sxi0;
+    // Fourier coefficients for converting authalic latitude to geographic
+    // latitude; these are used by tphif if _series is true.
+    real _cxi[AuxLatitude::Lmax];
+    bool _series;
     static const int numit_ = 5;   // Newton iterations in Reverse
     static const int numit0_ = 20; // Newton iterations in Init
     static real hyp(real x) {
@@ -257,6 +262,47 @@ namespace GeographicLib {
       Reverse(lon0, x, y, lat, lon, gamma, k);
     }
 
+    /**
+     * Forward projection of several points.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lon0 central meridian longitude (degrees).
+     * @param[in] lat array of latitudes (degrees).
+     * @param[in] lon array of longitudes (degrees).
+     * @param[out] x array of eastings (meters).
+     * @param[out] y array of northings (meters).
+     * @param[out] gamma (optional) array of meridian convergences
+     *   (degrees).
+     * @param[out] k (optional) array of azimuthal scales.
+     *
+     * This gives the same results as calling Forward for each point.  \e
+     * gamma and \e k may be nullptr if these quantities are not needed.  The
+     * output arrays may coincide with the input arrays.
+     **********************************************************************/
+    void ForwardBatch(size_t n, real lon0, const real lat[], const real lon[],
+                      real x[], real y[],
+                      real gamma[] = nullptr, real k[] = nullptr) const;
+
+    /**
+     * Reverse projection of several points.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lon0 central meridian longitude (degrees).
+     * @param[in] x array of eastings (meters).
+     * @param[in] y array of northings (meters).
+     * @param[out] lat array of latitudes (degrees).
+     * @param[out] lon array of longitudes (degrees).
+     * @param[out] gamma (optional) array of meridian convergences
+     *   (degrees).
+     * @param[out] k (optional) array of azimuthal scales.
+     *
+     * This gives the same results as calling Reverse for each point; see
+     * ForwardBatch.
+     **********************************************************************/
+    void ReverseBatch(size_t n, real lon0, const real x[], const real y[],
+                      real lat[], real lon[],
+                      real gamma[] = nullptr, real k[] = nullptr) const;
+
     /** \name Inspector functions
      **********************************************************************/
     ///@{
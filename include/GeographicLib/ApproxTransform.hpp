@@ -0,0 +1,157 @@
+/**
+ * \file ApproxTransform.hpp
+ * \brief Header for GeographicLib::ApproxTransform class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_APPROXTRANSFORM_HPP)
+#define GEOGRAPHICLIB_APPROXTRANSFORM_HPP 1
+
+#include <functional>
+#include <vector>
+#include <GeographicLib/Constants.hpp>
+
+#if defined(_MSC_VER)
+// Squelch warnings about dll vs vector
+#  pragma warning (push)
+#  pragma warning (disable: 4251)
+#endif
+
+namespace GeographicLib {
+
+  /**
+   * \brief Approximate a transformation over a raster with polynomials
+   *
+   * Reprojecting a raster requires the transformation of the center of
+   * every pixel of the output raster to the coordinates of the input raster.
+   * Because the transformation is smooth, it can be approximated by a low
+   * order polynomial over a block of pixels.  This class fits, for each
+   * block, a tensor product of Chebyshev polynomials of degree \e p in each
+   * coordinate by interpolating the transformation at (\e p + 1)<sup>2</sup>
+   * Chebyshev nodes.  The error of the fit is then measured at a lattice of
+   * (2\e p + 3)<sup>2</sup> points covering the block (including its
+   * corners and edges).  If the error at any of these points exceeds
+   * tol/2, the block is divided into quarters which are treated in the same
+   * way; blocks with fewer than 2(\e p + 1) pixels in either direction, or
+   * with no more pixels than the number of points needed for the fit, are
+   * transformed exactly.  The pixels of an accepted block are evaluated with
+   * the polynomial, which costs about 4\e p multiplications per pixel.
+   *
+   * The factor of 2 in the acceptance test is a safety margin; the
+   * interpolation error of a smooth function varies slowly over the block,
+   * so the maximum over the test lattice is a close estimate of the maximum
+   * over the block.  Points where the transformation returns NaNs (e.g.,
+   * outside the domain of a projection) cause the blocks containing them to
+   * be subdivided until they are transformed exactly; so the NaNs are
+   * reproduced.
+   *
+   * The transformation is supplied as a function which transforms arrays of
+   * points; so TransverseMercator::ForwardBatch and
+   * TransverseMercator::ReverseBatch can be used directly.  Other
+   * projections, such as LambertConformalConic and PolarStereographic, are
+   * supplied as a loop over the points.
+   *
+   * Example of use:
+   * \code
+   * // Geographic coordinates of the pixels of a UTM zone 33 raster
+   * const TransverseMercator& tm = TransverseMercator::UTM();
+   * ApproxTransform utm2geo(
+   *   [&tm](size_t n, const double x[], const double y[],
+   *         double lat[], double lon[]) -> void {
+   *     std::vector<double> x1(x, x + n);
+   *     for (double& t : x1) t -= 500000;
+   *     tm.ReverseBatch(n, 15, x1.data(), y, lat, lon);
+   *   }, 1e-9);
+   * std::vector<double> lat(1000 * 1000), lon(1000 * 1000);
+   * // 1000 x 1000 pixels of 10 m with the center of the first at
+   * // (400005, 5000005).
+   * utm2geo.Grid(400005, 5000005, 10, 10, 1000, 1000,
+   *              lat.data(), lon.data());
+   * \endcode
+   **********************************************************************/
+  class GEOGRAPHICLIB_EXPORT ApproxTransform {
+  public:
+    /**
+     * The type of the transformation.  This transforms \e n points given
+     * by the arrays \e x and \e y to the arrays \e u and \e v.
+     **********************************************************************/
+    typedef std::function<void(size_t n,
+                               const Math::real x[], const Math::real y[],
+                               Math::real u[], Math::real v[])> transform;
+  private:
+    typedef Math::real real;
+    static const int maxorder_ = 8;
+    transform _f;
+    real _tol;
+    int _order;
+    void Exact(real x0, real y0, real dx, real dy, int nx,
+               int i0, int i1, int j0, int j1, real u[], real v[],
+               std::vector<real>& xs, std::vector<real>& ys) const;
+    size_t Fill(real x0, real y0, real dx, real dy, int nx,
+                int i0, int i1, int j0, int j1, real u[], real v[],
+                std::vector<real>& xs, std::vector<real>& ys) const;
+    static real Clenshaw(const real c[], int n, real s);
+  public:
+
+    /**
+     * Constructor.
+     *
+     * @param[in] f the transformation.
+     * @param[in] tol the maximum error in the units of the output of \e f;
+     *   the error is measured as the distance between (\e u, \e v) and its
+     *   approximation.
+     * @param[in] order the degree \e p of the polynomials (default 3).
+     * @exception GeographicErr if \e tol is not positive or if \e order is
+     *   not in [1, 8].
+     **********************************************************************/
+    ApproxTransform(const transform& f, real tol, int order = 3);
+
+    /**
+     * Transform a raster.
+     *
+     * @param[in] x0 the \e x coordinate of the center of the first pixel.
+     * @param[in] y0 the \e y coordinate of the center of the first pixel.
+     * @param[in] dx the spacing of the pixels in \e x.
+     * @param[in] dy the spacing of the pixels in \e y.
+     * @param[in] nx the number of pixels in \e x.
+     * @param[in] ny the number of pixels in \e y.
+     * @param[out] u the array of \e u coordinates.
+     * @param[out] v the array of \e v coordinates.
+     * @return the number of points at which the transformation was evaluated
+     *   exactly.
+     *
+     * The pixel (\e i, \e j), for 0 &le; \e i < \e nx and 0 &le; \e j < \e
+     * ny, has center (\e x0 + \e i \e dx, \e y0 + \e j \e dy) and its
+     * transformation is stored in element \e j \e nx + \e i of \e u and \e
+     * v, which must have at least \e nx \e ny elements.  \e dx and \e dy may
+     * be negative.
+     **********************************************************************/
+    size_t Grid(real x0, real y0, real dx, real dy, int nx, int ny,
+                real u[], real v[]) const;
+
+    /** \name Inspector functions
+     **********************************************************************/
+    ///@{
+    /**
+     * @return the tolerance used in the constructor.
+     **********************************************************************/
+    Math::real Tolerance() const { return _tol; }
+
+    /**
+     * @return the degree of the polynomials used in the constructor.
+     **********************************************************************/
+    int Order() const { return _order; }
+    ///@}
+
+  };
+
+} // namespace GeographicLib
+
+#if defined(_MSC_VER)
+#  pragma warning (pop)
+#endif
+
+#endif  // GEOGRAPHICLIB_APPROXTRANSFORM_HPP
@@ -0,0 +1,203 @@
+/**
+ * \file AuxAngle.hpp
+ * \brief Header for the GeographicLib::AuxAngle class
+ *
+ * This file is an implementation of the methods described in
+ * - C. F. F. Karney,
+ *   On auxiliary latitudes,
+ *   Technical Report, SRI International, December 2022.
+ *   https://arxiv.org/abs/2212.05818
+ * .
+ * Copyright (c) Charles Karney (2022) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_AUXANGLE_HPP)
+#define GEOGRAPHICLIB_AUXANGLE_HPP 1
+
+#include <GeographicLib/Math.hpp>
+
+namespace GeographicLib {
+
+  /**
+   * \brief An accurate representation of angles.
+   *
+   * This class is an implementation of the methods described in
+   * - C. F. F. Karney,
+   *   On auxiliary latitudes,
+   *   Technical Report, SRI International, December 2022.
+   *   https://arxiv.org/abs/2212.05818
+   *
+   * An angle is represented be the \e y and \e x coordinates of a point in the
+   * 2d plane.  The two coordinates are proportional to the sine and cosine of
+   * the angle.  This allows angles close to the cardinal points to be
+   * represented accurately.  Only angles in [&minus;180&deg;, 180&deg;] can be
+   * represented.  (A possible extension would be to keep count of the number
+   * of turns.)
+   **********************************************************************/
+  class GEOGRAPHICLIB_EXPORT AuxAngle {
+  private:
+    typedef Math::real real;
+  public:
+    /**
+     * The constructor.
+     *
+     * @param[in] y the \e y coordinate.
+     * @param[in] x the \e x coordinate.
+     *
+     * \note the \e y coordinate is specified \e first.
+     * \warning either \e x or \e y can be infinite, but not both.
+     *
+     * The defaults (\e x = 1 and \e y = 0) are such that
+     * + no arguments gives an angle of 0;
+     * + 1 argument specifies the tangent of the angle.
+     **********************************************************************/
+    AuxAngle(real y = 0, real x = 1) : _y(y), _x(x) {}
+    /**
+     * @return the \e y component.  This is the sine of the angle if the
+     *   AuxAngle has been normalized.
+     **********************************************************************/
+    real y() const { return _y; }
+    /**
+     * @return the \e x component.  This is the cosine of the angle if the
+     *   AuxAngle has been normalized.
+     **********************************************************************/
+    real x() const { return _x; }
+    /**
+     * @return a reference to the \e y component.  This allows this component
+     *   to be altered.
+     **********************************************************************/
+    real& y() { return _y; }
+    /**
+     * @return a reference to the \e x component.  This allows this component
+     *   to be altered.
+     **********************************************************************/
+    real& x() { return _x; }
+    /**
+     * @return the AuxAngle converted to the conventional angle measured in
+     *   degrees.
+     **********************************************************************/
+    real degrees() const;
+    /**
+     * @return the AuxAngle converted to the conventional angle measured in
+     *   radians.
+     **********************************************************************/
+    real radians() const;
+    /**
+     * @return the tangent of the angle.
+     **********************************************************************/
+    real tan() const { return _y / _x; }
+    /**
+     * @return a new normalized AuxAngle with the point lying on the unit
+     *   circle and the \e y and \e x components are equal to the sine and
+     *   cosine of the angle.
+     **********************************************************************/
+    AuxAngle normalized() const;
+    /**
+     * Normalize the AuxAngle in place so that the \e y and \e x components are
+     *   equal to the sine and cosine of the angle.
+     **********************************************************************/
+    void normalize() { *this = normalized(); }
+    /**
+     * Set the quadrant for the AuxAngle.
+     *
+     * @param[in] p the AuxAngle from which the quadrant information is taken.
+     * @return the new AuxAngle in the same quadrant as \e p.
+     **********************************************************************/
+    AuxAngle copyquadrant(const AuxAngle& p) const;
+    /**
+     * Add an AuxAngle.
+     *
+     * @param[in] p the AuxAngle to be added.
+     * @return a reference to the new AuxAngle.
+     *
+     * The addition is done in place, altering the current AuxAngle.
+     *
+     * \warning Neither *this nor \e p should have an infinite component.  If
+     * necessary, invoke AuxAngle::normalize on these angles first.
+     **********************************************************************/
+    AuxAngle& operator+=(const AuxAngle& p);
+    /**
+     * Convert degrees to an AuxAngle.
+     *
+     * @param[in] d the angle measured in degrees.
+     * @return the corresponding AuxAngle.
+     *
+     * This allows a new AuxAngle to be initialized as an angle in degrees with
+     * @code
+     *   AuxAngle phi = AuxAngle::degrees(d);
+     * @endcode
+     * This is the so-called "named constructor" idiom.
+     **********************************************************************/
+    static AuxAngle degrees(real d);
+    /**
+     * Convert radians to an AuxAngle.
+     *
+     * @param[in] r the angle measured in radians.
+     * @return the corresponding AuxAngle.
+     *
+     * This allows a new AuxAngle to be initialized as an angle in radians with
+     * @code
+     *   AuxAngle phi = AuxAngle::radians(r);
+     * @endcode
+     * This is the so-called "named constructor" idiom.
+     **********************************************************************/
+    static AuxAngle radians(real r);
+    /**
+     * @return a "NaN" AuxAngle.
+     **********************************************************************/
+    static AuxAngle NaN();
+    /**
+     * Compute the absolute error in another angle.
+     *
+     * @param[in] p the other angle
+     * @return the absolute error between p and *this considered as angles in
+     *   radians.
+     **********************************************************************/
+    real AbsError(const AuxAngle& p) const;
+    /**
+     * Compute the relative error in another angle.
+     *
+     * @param[in] p the other angle
+     * @return the relative error between p.tan() and this->tan().
+     **********************************************************************/
+    real RelError(const AuxAngle& p) const;
+  private:
+    real _y, _x;
+  };
+
+  /// \cond SKIP
+  inline AuxAngle AuxAngle::degrees(real d) {
+    real y, x;
+    Math::sincosd(d, y, x);
+    return AuxAngle(y, x);
+  }
+
+  inline AuxAngle AuxAngle::radians(real r) {
+    using std::sin; using std::cos;
+    return AuxAngle(sin(r), cos(r));
+  }
+
+  inline Math::real AuxAngle::degrees() const {
+    return Math::atan2d(_y, _x);
+  }
+
+  inline Math::real AuxAngle::radians() const {
+    using std::atan2; return atan2(_y, _x);
+  }
+
+  inline Math::real AuxAngle::AbsError(const AuxAngle& p) const {
+    using std::fabs;
+    return fabs((AuxAngle(-p.y(), p.x()) += *this).radians());
+  }
+
+  inline Math::real AuxAngle::RelError(const AuxAngle& p) const {
+    using std::fabs;
+    return fabs((p.y() / p.x() - tan()) / tan());
+  }
+  /// \endcond
+
+} // namespace GeographicLib
+
+#endif  // GEOGRAPHICLIB_AUXANGLE_HPP
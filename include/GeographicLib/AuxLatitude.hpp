@@ -1,9 +1,6 @@
 /**
  * \file AuxLatitude.hpp
- * \brief Header for the GeographicLib::AuxLatitude and GeographicLib::AuxAngle
- * classes.
- *
- * \note This is just sample code.  It is not part of GeographicLib itself.
+ * \brief Header for the GeographicLib::AuxLatitude class
  *
  * This file is an implementation of the methods described in
  * - C. F. F. Karney,
@@ -16,10 +13,11 @@
  * https://geographiclib.sourceforge.io/
  **********************************************************************/
 
-#if !defined(AUXLATITUDE_HPP)
-#define AUXLATITUDE_HPP 1
+#if !defined(GEOGRAPHICLIB_AUXLATITUDE_HPP)
+#define GEOGRAPHICLIB_AUXLATITUDE_HPP 1
 
-#include <GeographicLib/Math.hpp>
+#include <GeographicLib/Constants.hpp>
+#include <GeographicLib/AuxAngle.hpp>
 
 #if !defined(GEOGRAPHICLIB_AUXLATITUDE_ORDER)
 /**
@@ -31,207 +29,9 @@
 
 namespace GeographicLib {
 
-  /**
-   * \brief An accurate representation of angles.
-   *
-   * \note This is just sample code.  It is not part of GeographicLib itself.
-   *
-   * This class is an implementation of the methods described in
-   * - C. F. F. Karney,
-   *   On auxiliary latitudes,
-   *   Technical Report, SRI International, December 2022.
-   *   https://arxiv.org/abs/2212.05818
-   *
-   * An angle is represented be the \e y and \e x coordinates of a point in the
-   * 2d plane.  The two coordinates are proportional to the sine and cosine of
-   * the angle.  This allows angles close to the cardinal points to be
-   * represented accurately.  Only angles in [&minus;180&deg;, 180&deg;] can be
-   * represented.  (A possible extension would be to keep count of the number
-   * of turns.)
-   *
-   * @tparam T the floating-point type to use for real numbers.
-   **********************************************************************/
-  template<typename T = double>
-  class AuxAngle {
-  public:
-    /**
-     * The floating-point type for real numbers.  This just connects to the
-     * template parameters for the class.
-     **********************************************************************/
-    typedef T real;
-    /**
-     * The constructor.
-     *
-     * @param[in] y the \e y coordinate.
-     * @param[in] x the \e x coordinate.
-     *
-     * \note the \e y coordinate is specified \e first.
-     * \warning either \e x or \e y can be infinite, but not both.
-     *
-     * The defaults (\e x = 1 and \e y = 0) are such that
-     * + no arguments gives an angle of 0;
-     * + 1 argument specifies the tangent of the angle.
-     **********************************************************************/
-    AuxAngle(real y = 0, real x = 1) : _y(y), _x(x) {}
-    /**
-     * @return the \e y component.  This is the sine of the angle if the
-     *   AuxAngle has been normalized.
-     **********************************************************************/
-    real y() const { return _y; }
-    /**
-     * @return the \e x component.  This is the cosine of the angle if the
-     *   AuxAngle has been normalized.
-     **********************************************************************/
-    real x() const { return _x; }
-    /**
-     * @return a reference to the \e y component.  This allows this component
-     *   to be altered.
-     **********************************************************************/
-    real& y() { return _y; }
-    /**
-     * @return a reference to the \e x component.  This allows this component
-     *   to be altered.
-     **********************************************************************/
-    real& x() { return _x; }
-    /**
-     * @return the AuxAngle converted to the conventional angle measured in
-     *   degrees.
-     **********************************************************************/
-    real degrees() const;
-    /**
-     * @return the AuxAngle converted to the conventional angle measured in
-     *   radians.
-     **********************************************************************/
-    real radians() const;
-    /**
-     * @return the tangent of the angle.
-     **********************************************************************/
-    real tan() const { return _y / _x; }
-    /**
-     * @return a new normalized AuxAngle with the point lying on the unit
-     *   circle and the \e y and \e x components are equal to the sine and
-     *   cosine of the angle.
-     **********************************************************************/
-    AuxAngle normalized() const;
-    /**
-     * Normalize the AuxAngle in place so that the \e y and \e x components are
-     *   equal to the sine and cosine of the angle.
-     **********************************************************************/
-    void normalize() { *this = normalized(); }
-    /**
-     * Set the quadrant for the AuxAngle.
-     *
-     * @param[in] p the AuxAngle from which the quadrant information is taken.
-     * @return the new AuxAngle in the same quadrant as \e p.
-     **********************************************************************/
-    AuxAngle copyquadrant(const AuxAngle& p) const;
-    /**
-     * Add an AuxAngle.
-     *
-     * @param[in] p the AuxAngle to be added.
-     * @return a reference to the new AuxAngle.
-     *
-     * The addition is done in place, altering the current AuxAngle.
-     *
-     * \warning Neither *this nor \e p should have an infinite component.  If
-     * necessary, invoke AuxAngle::normalize on these angles first.
-     **********************************************************************/
-    AuxAngle& operator+=(const AuxAngle& p);
-    /**
-     * Convert degrees to an AuxAngle.
-     *
-     * @param[in] d the angle measured in degrees.
-     * @return the corresponding AuxAngle.
-     *
-     * This allows a new AuxAngle to be initialized as an angle in degrees with
-     * @code
-     *   AuxAngle<real> phi = AuxAngle<real>::degrees(d);
-     * @endcode
-     * This is the so-called "named constructor" idiom.
-     **********************************************************************/
-    static AuxAngle degrees(real d);
-    /**
-     * Convert radians to an AuxAngle.
-     *
-     * @param[in] r the angle measured in radians.
-     * @return the corresponding AuxAngle.
-     *
-     * This allows a new AuxAngle to be initialized as an angle in radians with
-     * @code
-     *   AuxAngle<real> phi = AuxAngle<real>::radians(r);
-     * @endcode
-     * This is the so-called "named constructor" idiom.
-     **********************************************************************/
-    static AuxAngle radians(real r);
-    /**
-     * @return a "NaN" AuxAngle.
-     **********************************************************************/
-    static AuxAngle NaN();
-    /**
-     * Compute the absolute error in another angle.
-     *
-     * @tparam T1 the floating-point type of the other angle.
-     * @param[in] p the other angle
-     * @return the absolute error between p and *this considered as angles in
-     *   radians.
-     **********************************************************************/
-    template<typename T1>
-    real AbsError(const AuxAngle<T1>& p) const;
-    /**
-     * Compute the relative error in another angle.
-     *
-     * @tparam T1 the floating-point type of the other angle.
-     * @param[in] p the other angle
-     * @return the relative error between p.tan() and this->tan().
-     **********************************************************************/
-    template<typename T1>
-    real RelError(const AuxAngle<T1>& p) const;
-  private:
-    real _y, _x;
-  };
-
-  /// \cond SKIP
-  template<typename T>
-  inline AuxAngle<T> AuxAngle<T>::degrees(real d) {
-    real y, x;
-    Math::sincosd(d, y, x);
-    return AuxAngle(y, x);
-  }
-
-  template<typename T>
-  inline AuxAngle<T> AuxAngle<T>::radians(real r) {
-    using std::sin; using std::cos;
-    return AuxAngle(sin(r), cos(r));
-  }
-
-  template<typename T>
-  inline T AuxAngle<T>::degrees() const {
-    return Math::atan2d(_y, _x);
-  }
-
-  template<typename T>
-  inline T AuxAngle<T>::radians() const {
-    using std::atan2; return atan2(_y, _x);
-  }
-
-  template<typename T> template<typename T1>
-  inline T AuxAngle<T>::AbsError(const AuxAngle<T1>& p) const {
-    using std::fabs;
-    return fabs((AuxAngle(-T(p.y()), T(p.x())) += *this).radians());
-  }
-
-  template<typename T> template<typename T1>
-  inline T AuxAngle<T>::RelError(const AuxAngle<T1>& p) const {
-    using std::fabs;
-    return fabs((T(p.y()) / T(p.x()) - tan()) / tan());
-  }
-  /// \endcond
-
   /**
    * \brief Conversions between auxiliary latitudes.
    *
-   * \note This is just sample code.  It is not part of GeographicLib itself.
-   *
    * This class is an implementation of the methods described in
    * - C. F. F. Karney,
    *   On auxiliary latitudes,
@@ -260,25 +60,19 @@ namespace GeographicLib {
    * simple that the exact method should be used for such conversions and also
    * for conversions with with abs(\e f) &gt; 1/150.
    *
-   * @tparam T the floating-point type to use.
-   *
    * Example of use:
    * \include example-AuxLatitude.cpp
    *
    * For more information on this projection, see \ref auxlat.
    **********************************************************************/
-  template<typename T = double>
-  class AuxLatitude {
+  class GEOGRAPHICLIB_EXPORT AuxLatitude {
+  private:
+    typedef Math::real real;
   public:
-    /**
-     * The floating-point type for real numbers.  This just connects to the
-     * template parameters for the class.
-     **********************************************************************/
-    typedef T real;
     /**
      * The type used to represent angles.
      **********************************************************************/
-    typedef AuxAngle<real> angle;
+    typedef AuxAngle angle;
     /**
      * The different auxiliary latitudes.
      **********************************************************************/
@@ -340,9 +134,9 @@ namespace GeographicLib {
      * @param[in] f flattening of ellipsoid.  Setting \e f = 0 gives a sphere.
      *   Negative \e f gives a prolate ellipsoid.
      *
-     * \note the constructor does not precompute the coefficients for the
-     * Fourier series for the series conversions.  These are computed and saved
-     * when first needed.
+     * The constructor computes the coefficients of the Fourier series for
+     * all the series conversions; thereafter the object is immutable and may
+     * be shared between threads.
      **********************************************************************/
     AuxLatitude(real f);
     /**
@@ -351,9 +145,9 @@ namespace GeographicLib {
      * @param[in] a equatorial radius.
      * @param[in] b polar semi-axis.
      *
-     * \note the constructor does not precompute the coefficients for the
-     * Fourier series for the series conversions.  These are computed and saved
-     * when first needed.
+     * The constructor computes the coefficients of the Fourier series for
+     * all the series conversions; thereafter the object is immutable and may
+     * be shared between threads.
      **********************************************************************/
     AuxLatitude(real a, real b);
     /**
@@ -368,14 +162,33 @@ namespace GeographicLib {
      *   equations [default false].
      * @return the output auxiliary latitude \e eta.
      *
-     * With \e series = true, the Fourier coefficients for a specific \e auxin
-     * and \e auxout are computed and saved on the first call; the saved
-     * coefficients are used on subsequent calls.  The series method is
-     * accurate for abs(\e f) &le; 1/150; for other \e f, the exact method
-     * should be used
+     * With \e series = true, the Fourier series with coefficients computed
+     * by the constructor is summed.  The series method is accurate for
+     * abs(\e f) &le; 1/150; for other \e f, the exact method should be used
      **********************************************************************/
     angle Convert(int auxin, int auxout, const angle& zeta,
                   bool series = false) const;
+    /**
+     * Convert several latitudes between any two auxiliary latitudes.
+     *
+     * @param[in] auxin an AuxLatitude::aux indicating the type of
+     *   auxiliary latitude \e zeta.
+     * @param[in] auxout an AuxLatitude::aux indicating the type of
+     *   auxiliary latitude \e eta.
+     * @param[in] n the number of latitudes.
+     * @param[in] zeta array of input auxiliary latitudes (degrees).
+     * @param[out] eta array of output auxiliary latitudes (degrees).
+     * @param[in] series if true use the Taylor series instead of the exact
+     *   equations [default false].
+     *
+     * The arrays have (at least) \e n elements and \e eta may be the same
+     * array as \e zeta.  The results are identical to calling Convert in a
+     * loop with AuxAngle::degrees and AuxAngle::degrees() for the conversions
+     * to and from degrees.  With \e series = true, the series for the pair
+     * of latitudes is looked up once for all the latitudes.
+     **********************************************************************/
+    void Convert(int auxin, int auxout, size_t n,
+                 const real zeta[], real eta[], bool series = false) const;
     /**
      * Convert geographic latitude to an auxiliary latitude \e eta.
      *
@@ -415,6 +228,7 @@ namespace GeographicLib {
      **********************************************************************/
     static const int Lmax = GEOGRAPHICLIB_AUXLATITUDE_ORDER;
   private:
+    friend class AlbersEqualArea; // For access to _c and Clenshaw
     /**
      * Convert geographic latitude to parametric latitude
      *
@@ -465,8 +279,8 @@ namespace GeographicLib {
     real tol_, bmin_, bmax_;         // Static consts for Newton's method
     // Ellipsoid parameters
     real _f, _fm1, _e2, _e2m1, _e12, _e12p1, _n, _e, _e1, _n2, _q;
-    // To hold computed Fourier coefficients
-    mutable real _c[Lmax * AUXNUMBER * AUXNUMBER];
+    // The Fourier coefficients for all the conversions
+    real _c[Lmax * AUXNUMBER * AUXNUMBER];
     // 1d index into AUXNUMBER x AUXNUMBER data
     static int ind(int auxout, int auxin) {
       return (auxout >= 0 && auxout < AUXNUMBER &&
@@ -482,10 +296,6 @@ namespace GeographicLib {
       return isfinite(tphi) || isnan(tphi) ? tphi / sc(tphi) :
         copysign(real(1), tphi);
     }
-    // The symmetric elliptic integral RD
-    static real RD(real x, real y, real z);
-    // The symmetric elliptic integral RF
-    static real RF(real x, real y, real z);
     // the function atanh(e * sphi)/e; works for e^2 = 0 and e^2 < 0
     real atanhee(real tphi) const;
     // the function atanh(e * sphi)/e + sphi / (1 - (e * sphi)^2);
@@ -493,7 +303,7 @@ namespace GeographicLib {
     // The divided difference of (q(1) - q(sphi)) / (1 - sphi)
     real Dq(real tphi) const;
     // Populate [_c[Lmax * k], _c[Lmax * (k + 1)])
-    void fillcoeff(int auxin, int auxout, int k) const;
+    void fillcoeff(int auxin, int auxout, int k);
     // Clenshaw applied to sum(c[k] * sin( (2*k+2) * zeta), i, 0, K-1)
     // if alt, use the Reinsch optimizations
     static real Clenshaw(real szeta, real czeta, const real c[], int K,
@@ -502,4 +312,4 @@ namespace GeographicLib {
 
 } // namespace GeographicLib
 
-#endif  // AUXLATITUDE_HPP
+#endif  // GEOGRAPHICLIB_AUXLATITUDE_HPP
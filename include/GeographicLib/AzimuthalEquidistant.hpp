@@ -116,6 +116,57 @@ namespace GeographicLib {
       Reverse(lat0, lon0, x, y, lat, lon, azi, rk);
     }
 
+    /**
+     * Forward projection of several points about a common center.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lat0 latitude of center point of projection (degrees).
+     * @param[in] lon0 longitude of center point of projection (degrees).
+     * @param[in] lat array of latitudes (degrees).
+     * @param[in] lon array of longitudes (degrees).
+     * @param[out] x array of eastings (meters).
+     * @param[out] y array of northings (meters).
+     * @param[out] azi (optional) array of azimuths of the geodesics at the
+     *   points (degrees).
+     * @param[out] rk (optional) array of reciprocals of the azimuthal scale.
+     *
+     * This gives the same results as calling Forward for each point.  \e azi
+     * and \e rk may be nullptr if these quantities are not needed.  (The
+     * reduced length, needed for \e rk, is a by-product of the solution of
+     * the inverse problem, so omitting \e rk saves no work.)  The output
+     * arrays may coincide with the input arrays.
+     **********************************************************************/
+    void ForwardBatch(size_t n, real lat0, real lon0,
+                      const real lat[], const real lon[],
+                      real x[], real y[],
+                      real azi[] = nullptr, real rk[] = nullptr) const;
+
+    /**
+     * Reverse projection of several points about a common center.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lat0 latitude of center point of projection (degrees).
+     * @param[in] lon0 longitude of center point of projection (degrees).
+     * @param[in] x array of eastings (meters).
+     * @param[in] y array of northings (meters).
+     * @param[out] lat array of latitudes (degrees).
+     * @param[out] lon array of longitudes (degrees).
+     * @param[out] azi (optional) array of azimuths of the geodesics at the
+     *   points (degrees).
+     * @param[out] rk (optional) array of reciprocals of the azimuthal scale.
+     *
+     * This gives the same results as calling Reverse for each point; see
+     * ForwardBatch.  Each point needs its own geodesic from the center.  If
+     * the points lie on a few rays from the center with known azimuths (for
+     * example, the range bins of a radar sweep), it is faster to construct a
+     * GeodesicLine for each ray with Geodesic::Line and to call
+     * GeodesicLine::PositionBatch.
+     **********************************************************************/
+    void ReverseBatch(size_t n, real lat0, real lon0,
+                      const real x[], const real y[],
+                      real lat[], real lon[],
+                      real azi[] = nullptr, real rk[] = nullptr) const;
+
     /** \name Inspector functions
      **********************************************************************/
     ///@{
@@ -0,0 +1,170 @@
+/**
+ * \file CPUDispatch.hpp
+ * \brief Header for GeographicLib::CPUDispatch class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_CPUDISPATCH_HPP)
+#define GEOGRAPHICLIB_CPUDISPATCH_HPP 1
+
+#include <GeographicLib/Constants.hpp>
+#include <string>
+
+/**
+ * Whether the batch routines include versions for wider vector units which
+ * are selected at run time.  This is only supported for x86-64 with g++ or
+ * clang (which provide the \c target attribute) and for doubles or floats.
+ **********************************************************************/
+#if !defined(GEOGRAPHICLIB_CPU_DISPATCH)
+#  if defined(__x86_64__) && defined(__GNUC__) && \
+  !defined(__INTEL_COMPILER) && GEOGRAPHICLIB_PRECISION <= 2
+#    define GEOGRAPHICLIB_CPU_DISPATCH 1
+#  else
+#    define GEOGRAPHICLIB_CPU_DISPATCH 0
+#  endif
+#endif
+
+namespace GeographicLib {
+
+  /**
+   * \brief Select the instruction set used by the batch routines
+   *
+   * The batch routines TransverseMercator::ForwardBatch,
+   * TransverseMercator::ReverseBatch, TransverseMercator::TransferBatch,
+   * Geocentric::ForwardBatch, Geocentric::ReverseBatch, and
+   * SphericalEngine::ValueBatch (used by GravityModel and MagneticModel for
+   * many points) are written as loops over small batches of points which the
+   * compiler can vectorize.  The library is compiled for the baseline
+   * instruction set of the platform (SSE2 for x86-64), so that it runs on
+   * any machine.  When GEOGRAPHICLIB_CPU_DISPATCH is set, these routines are
+   * also compiled for AVX2 and AVX-512, which process 4 and 8 doubles at a
+   * time instead of 2, and the best version supported by the CPU is chosen
+   * at run time.
+   *
+   * The versions for the wider instruction sets don't use fused
+   * multiply-add instructions, so they give the same results as the
+   * baseline version.  With g++ this is arranged by an attribute; clang
+   * ignores the attribute, so the build scripts compile the library with
+   * -ffp-contract=off when using clang on x86-64.  (Compiling the library
+   * with clang by some other means requires adding this flag.)
+   *
+   * Select() overrides the choice (e.g., to compare the speeds of the
+   * versions).  The choice is global; it takes effect for the calls to the
+   * batch routines made after it's set.
+   *
+   * The geodesic batch routines, Geodesic::InverseBatch, etc., solve each
+   * problem in turn with the scalar algorithm (which has little scope for
+   * vectorization) and so aren't dispatched.
+   *
+   * Example of use:
+   * \code
+   * std::cout << CPUDispatch::Name(CPUDispatch::Selected()) << "\n";
+   * // Time the baseline version
+   * CPUDispatch::Select(CPUDispatch::BASELINE);
+   * \endcode
+   **********************************************************************/
+  class GEOGRAPHICLIB_EXPORT CPUDispatch {
+  public:
+    /**
+     * The instruction sets.
+     **********************************************************************/
+    enum isa {
+      /**
+       * The baseline instruction set for the platform (SSE2 for x86-64 and
+       * NEON for AArch64).
+       * @hideinitializer
+       **********************************************************************/
+      BASELINE = 0,
+      /**
+       * AVX2 (4 doubles per vector).
+       * @hideinitializer
+       **********************************************************************/
+      AVX2 = 1,
+      /**
+       * AVX-512 foundation instructions (8 doubles per vector).
+       * @hideinitializer
+       **********************************************************************/
+      AVX512 = 2,
+    };
+
+    /**
+     * @return the best instruction set which is supported by the CPU and
+     *   for which the batch routines have been compiled.
+     **********************************************************************/
+    static isa Detected();
+
+    /**
+     * @param[in] i an instruction set.
+     * @return whether the batch routines can use \e i.
+     **********************************************************************/
+    static bool Available(isa i);
+
+    /**
+     * Select the instruction set used by the batch routines.
+     *
+     * @param[in] i the instruction set.
+     * @exception GeographicErr if \e i isn't available.
+     *
+     * Initially the instruction set is Detected().
+     **********************************************************************/
+    static void Select(isa i);
+
+    /**
+     * @return the instruction set used by the batch routines.
+     **********************************************************************/
+    static isa Selected();
+
+    /**
+     * @param[in] i an instruction set.
+     * @return the name of \e i, "baseline", "avx2", or "avx512".
+     **********************************************************************/
+    static std::string Name(isa i);
+
+    /**
+     * Call a function compiled for the selected instruction set.
+     *
+     * @tparam F the type of the function object.
+     * @param[in] f the function object; it is called as \e f().
+     * @exception any exception thrown by \e f.
+     *
+     * \e f and the inline functions it calls (e.g., the kernel of a batch
+     * routine defined in the same file) are compiled for each instruction
+     * set.  Functions in other files are called in their baseline versions.
+     **********************************************************************/
+    template<class F> static void Run(const F& f) {
+#if GEOGRAPHICLIB_CPU_DISPATCH
+      switch (Selected()) {
+      case AVX512: RunAVX512(f); return;
+      case AVX2: RunAVX2(f); return;
+      default: break;
+      }
+#endif
+      f();
+    }
+
+  private:
+#if GEOGRAPHICLIB_CPU_DISPATCH
+    // flatten inlines the calls made by f (recursively) so that they are
+    // compiled with the target of the caller.  (A function which can't be
+    // inlined is called in its baseline version.)  AVX-512 includes fused
+    // multiply-add, so turn off contraction for g++ (clang ignores the
+    // optimize attribute; the build scripts give it -ffp-contract=off).
+    template<class F> __attribute__((target("avx2"), flatten))
+    static void RunAVX2(const F& f) { f(); }
+#  if defined(__clang__)
+    template<class F> __attribute__((target("avx512f"), flatten))
+#  else
+    template<class F>
+    __attribute__((target("avx512f"), optimize("fp-contract=off"), flatten))
+#  endif
+    static void RunAVX512(const F& f) { f(); }
+#endif
+    CPUDispatch();              // Disable constructor
+  };
+
+} // namespace GeographicLib
+
+#endif  // GEOGRAPHICLIB_CPUDISPATCH_HPP
@@ -73,6 +73,9 @@ namespace GeographicLib {
     GeodesicLine _meridian;
     real _sbet0, _cbet0;
     static const unsigned maxit_ = 10;
+    // Forward with the computation of rk optional
+    void Forward(real lat, real lon,
+                 real& x, real& y, real& azi, real& rk, bool scalep) const;
 
   public:
 
@@ -164,6 +167,51 @@ namespace GeographicLib {
       Reverse(x, y, lat, lon, azi, rk);
     }
 
+    /**
+     * Forward projection of several points.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lat array of latitudes (degrees).
+     * @param[in] lon array of longitudes (degrees).
+     * @param[out] x array of eastings (meters).
+     * @param[out] y array of northings (meters).
+     * @param[out] azi (optional) array of azimuths of the easting direction
+     *   (degrees).
+     * @param[out] rk (optional) array of reciprocals of the azimuthal
+     *   northing scale.
+     *
+     * This gives the same results as calling Forward for each point.  \e azi
+     * and \e rk may be nullptr if these quantities are not needed; if \e rk
+     * is nullptr, the geodesic scale along the perpendicular geodesic is not
+     * computed.  The output arrays may coincide with the input arrays.  The
+     * routine does nothing if the origin has not been set.
+     **********************************************************************/
+    void ForwardBatch(size_t n, const real lat[], const real lon[],
+                      real x[], real y[],
+                      real azi[] = nullptr, real rk[] = nullptr) const;
+
+    /**
+     * Reverse projection of several points.
+     *
+     * @param[in] n the number of points.
+     * @param[in] x array of eastings (meters).
+     * @param[in] y array of northings (meters).
+     * @param[out] lat array of latitudes (degrees).
+     * @param[out] lon array of longitudes (degrees).
+     * @param[out] azi (optional) array of azimuths of the easting direction
+     *   (degrees).
+     * @param[out] rk (optional) array of reciprocals of the azimuthal
+     *   northing scale.
+     *
+     * This gives the same results as calling Reverse for each point.  The
+     * point on the central meridian is computed once for each run of
+     * consecutive points with the same northing (e.g., a row of a grid).
+     * See ForwardBatch.
+     **********************************************************************/
+    void ReverseBatch(size_t n, const real x[], const real y[],
+                      real lat[], real lon[],
+                      real azi[] = nullptr, real rk[] = nullptr) const;
+
     /** \name Inspector functions
      **********************************************************************/
     ///@{
@@ -0,0 +1,158 @@
+/**
+ * \file CircleCache.hpp
+ * \brief Header for GeographicLib::CircleCache class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_CIRCLECACHE_HPP)
+#define GEOGRAPHICLIB_CIRCLECACHE_HPP 1
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <GeographicLib/Constants.hpp>
+
+namespace GeographicLib {
+
+  /**
+   * \brief A bounded cache of circles of latitude
+   *
+   * This is used by GravityModel and MagneticModel to hold GravityCircle and
+   * MagneticCircle objects keyed by the quantized latitude, height, and (for
+   * MagneticModel) time; see GravityModel::CacheCircles and
+   * MagneticModel::CacheCircles.  (It also holds the decoded epochs of a
+   * compressed MagneticModel; see MagneticModel::Compress.)  The least
+   * recently used circle is discarded when the capacity of the cache is
+   * reached.  Lookups are serialized with a mutex (but the circles are
+   * constructed without holding the lock); the circles are returned as
+   * shared pointers so that they remain valid even if they are discarded
+   * from the cache while in use on another thread.
+   *
+   * @tparam C the type of the circle.
+   **********************************************************************/
+  template<class C>
+  class CircleCache {
+  public:
+    /**
+     * The key for a circle: the quantized latitude, height, and time.
+     **********************************************************************/
+    struct key {
+      long long lat, h, t;
+      bool operator==(const key& k) const
+      { return lat == k.lat && h == k.h && t == k.t; }
+    };
+
+  private:
+    struct keyhash {
+      size_t operator()(const key& k) const {
+        std::hash<long long> hash;
+        size_t s = hash(k.lat);
+        s ^= hash(k.h) + 0x9e3779b9U + (s << 6) + (s >> 2);
+        s ^= hash(k.t) + 0x9e3779b9U + (s << 6) + (s >> 2);
+        return s;
+      }
+    };
+    typedef std::pair<key, std::shared_ptr<const C>> entry;
+    // The list is in order of use (most recent first)
+    std::list<entry> _circles;
+    std::unordered_map<key, typename std::list<entry>::iterator, keyhash>
+    _index;
+    std::mutex _mutex;
+    size_t _maxcircles;         // 0 means no caching
+    unsigned long long _hits, _misses;
+
+  public:
+    /**
+     * Construct an empty cache with zero capacity (so that caching is
+     * disabled).
+     **********************************************************************/
+    CircleCache() : _maxcircles(0), _hits(0), _misses(0) {}
+
+    /**
+     * Clear the cache, set its capacity, and reset the counts of hits and
+     * misses.
+     *
+     * @param[in] maxcircles the maximum number of circles to hold; 0 disables
+     *   caching.
+     **********************************************************************/
+    void Reset(size_t maxcircles) {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _index.clear();
+      _circles.clear();
+      _maxcircles = maxcircles;
+      _hits = _misses = 0;
+    }
+
+    /**
+     * Look up a circle, constructing it if it's not in the cache.
+     *
+     * @tparam F the type of \e make.
+     * @param[in] k the key for the circle.
+     * @param[in] make a function object returning the circle for \e k.
+     * @return a shared pointer to the circle.
+     **********************************************************************/
+    template<class F>
+    std::shared_ptr<const C> Get(const key& k, const F& make) {
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto p = _index.find(k);
+        if (p != _index.end()) {
+          ++_hits;
+          _circles.splice(_circles.begin(), _circles, p->second);
+          return _circles.front().second;
+        }
+        ++_misses;
+      }
+      std::shared_ptr<const C> c = std::make_shared<const C>(make());
+      std::lock_guard<std::mutex> lock(_mutex);
+      if (_maxcircles == 0 || _index.find(k) != _index.end())
+        // The cache was reset or another thread has made this circle
+        return c;
+      _circles.push_front(entry(k, c));
+      _index[k] = _circles.begin();
+      while (_circles.size() > _maxcircles) {
+        _index.erase(_circles.back().first);
+        _circles.pop_back();
+      }
+      return c;
+    }
+
+    /**
+     * @return the maximum number of circles held by the cache.
+     **********************************************************************/
+    size_t Capacity() const { return _maxcircles; }
+
+    /**
+     * @return the number of circles held by the cache.
+     **********************************************************************/
+    size_t Size() {
+      std::lock_guard<std::mutex> lock(_mutex);
+      return _circles.size();
+    }
+
+    /**
+     * @return the number of lookups satisfied by the cache.
+     **********************************************************************/
+    unsigned long long Hits() {
+      std::lock_guard<std::mutex> lock(_mutex);
+      return _hits;
+    }
+
+    /**
+     * @return the number of lookups which required a circle to be
+     *   constructed.
+     **********************************************************************/
+    unsigned long long Misses() {
+      std::lock_guard<std::mutex> lock(_mutex);
+      return _misses;
+    }
+  };
+
+} // namespace GeographicLib
+
+#endif  // GEOGRAPHICLIB_CIRCLECACHE_HPP
@@ -41,9 +41,10 @@ namespace GeographicLib {
    * SphericalHarmonic2::Circle to create instances of this class.
    *
    * CircularEngine stores the coefficients needed to allow the summation over
-   * order to be performed in 2 or 6 vectors of length \e M + 1 (depending on
-   * whether gradients are to be calculated).  For this reason the constructor
-   * may throw a std::bad_alloc exception.
+   * order to be performed in 2, 6, or 22 vectors of length \e M + 1
+   * (depending on whether gradients or second derivatives are to be
+   * calculated).  For this reason the constructor may throw a
+   * std::bad_alloc exception.
    *
    * Example of use:
    * \include example-CircularEngine.cpp
@@ -57,36 +58,34 @@ namespace GeographicLib {
       SCHMIDT = SphericalEngine::SCHMIDT,
     };
     int _mM;
-    bool _gradp;
+    bool _gradp, _hessp;
     unsigned _norm;
     real _a, _r, _u, _t;
     std::vector<real> _wc, _ws, _wrc, _wrs, _wtc, _wts;
+    // The sums for the second derivatives; see SphericalEngine::HessianSums
+    std::vector<real> _wh;
     real _q, _uq, _uq2;
 
     Math::real Value(bool gradp, real sl, real cl,
-                     real& gradx, real& grady, real& gradz) const;
+                     real& gradx, real& grady, real& gradz,
+                     real hess[] = nullptr) const;
 
     friend class SphericalEngine;
-    CircularEngine(int M, bool gradp, unsigned norm,
-                   real a, real r, real u, real t)
-      : _mM(M)
-      , _gradp(gradp)
-      , _norm(norm)
-      , _a(a)
-      , _r(r)
-      , _u(u)
-      , _t(t)
-      , _wc(std::vector<real>(_mM + 1, 0))
-      , _ws(std::vector<real>(_mM + 1, 0))
-      , _wrc(std::vector<real>(_gradp ? _mM + 1 : 0, 0))
-      , _wrs(std::vector<real>(_gradp ? _mM + 1 : 0, 0))
-      , _wtc(std::vector<real>(_gradp ? _mM + 1 : 0, 0))
-      , _wts(std::vector<real>(_gradp ? _mM + 1 : 0, 0))
-      {
-        _q = _a / _r;
-        _uq = _u * _q;
-        _uq2 = Math::sq(_uq);
-      }
+    // Set up the object for a new circle.  The vectors are resized with
+    // assign, so their storage is reused if it is big enough.
+    void Reset(int M, bool gradp, unsigned norm,
+               real a, real r, real u, real t, bool hessp = false) {
+      _mM = M; _gradp = gradp || hessp; _hessp = hessp; _norm = norm;
+      _a = a; _r = r; _u = u; _t = t;
+      size_t n = size_t(_mM + 1), ng = _gradp ? n : 0;
+      _wc.assign(n, 0); _ws.assign(n, 0);
+      _wrc.assign(ng, 0); _wrs.assign(ng, 0);
+      _wtc.assign(ng, 0); _wts.assign(ng, 0);
+      _wh.assign(_hessp ? 16 * n : 0, 0);
+      _q = _a / _r;
+      _uq = _u * _q;
+      _uq2 = Math::sq(_uq);
+    }
 
     void SetCoeff(int m, real wc, real ws)
     { _wc[m] = wc; _ws[m] = ws; }
@@ -110,6 +109,7 @@ namespace GeographicLib {
     CircularEngine()
       : _mM(-1)
       , _gradp(true)
+      , _hessp(false)
       , _u(0)
       , _t(1)
       {}
@@ -184,6 +184,113 @@ namespace GeographicLib {
       Math::sincosd(lon, sinlon, coslon);
       return (*this)(sinlon, coslon, gradx, grady, gradz);
     }
+
+    /**
+     * Evaluate the sum, its gradient, and its second derivatives for a
+     * particular longitude given in terms of its sine and cosine.
+     *
+     * @param[in] sinlon the sine of the longitude.
+     * @param[in] coslon the cosine of the longitude.
+     * @param[out] gradx \e x component of the gradient.
+     * @param[out] grady \e y component of the gradient.
+     * @param[out] gradz \e z component of the gradient.
+     * @param[out] hess an array of 9 elements giving the matrix of second
+     *   derivatives in row-major order (see SphericalEngine::Hessian).
+     * @return \e V the value of the sum.
+     *
+     * The second derivatives will only be computed if the CircularEngine
+     * object was created with this capability (e.g., via
+     * SphericalHarmonic::CircleHessian).  If not, \e hess will not be
+     * touched (and the gradient is computed as by the previous functions).
+     * The arguments must satisfy <i>sinlon</i><sup>2</sup> +
+     * <i>coslon</i><sup>2</sup> = 1.
+     **********************************************************************/
+    Math::real operator()(real sinlon, real coslon,
+                          real& gradx, real& grady, real& gradz,
+                          real hess[]) const {
+      return Value(true, sinlon, coslon, gradx, grady, gradz, hess);
+    }
+
+    /**
+     * Evaluate the sum, its gradient, and its second derivatives for a
+     * particular longitude.
+     *
+     * @param[in] lon the longitude (degrees).
+     * @param[out] gradx \e x component of the gradient.
+     * @param[out] grady \e y component of the gradient.
+     * @param[out] gradz \e z component of the gradient.
+     * @param[out] hess an array of 9 elements giving the matrix of second
+     *   derivatives in row-major order.
+     * @return \e V the value of the sum.
+     *
+     * The second derivatives will only be computed if the CircularEngine
+     * object was created with this capability.  If not, \e hess will not be
+     * touched.
+     **********************************************************************/
+    Math::real operator()(real lon,
+                          real& gradx, real& grady, real& gradz,
+                          real hess[]) const {
+      real sinlon, coslon;
+      Math::sincosd(lon, sinlon, coslon);
+      return (*this)(sinlon, coslon, gradx, grady, gradz, hess);
+    }
+
+    /**
+     * @return true if the object can compute second derivatives.
+     **********************************************************************/
+    bool HasHessian() const { return _hessp; }
+
+    /**
+     * @return the number of bytes of memory held by the object.
+     **********************************************************************/
+    size_t MemoryUsage() const {
+      return sizeof(*this) +
+        (_wc.capacity() + _ws.capacity() + _wrc.capacity() + _wrs.capacity() +
+         _wtc.capacity() + _wts.capacity() + _wh.capacity()) * sizeof(real);
+    }
+
+    /**
+     * @return the approximate number of floating point operations for a
+     *   call to operator()() (at a single longitude) which computes
+     *   everything the object is capable of, i.e., the gradient if the
+     *   object was created with this capability and the second derivatives
+     *   if HasHessian().
+     *
+     * This is the cost of the outer sum over order; the cost of setting up
+     * the object is given by SphericalEngine::CostEstimate.
+     **********************************************************************/
+    unsigned long long CostEstimate() const {
+      return _mM < 0 ? 0 :
+        20 + (unsigned long long)(_mM + 1) * (_hessp ? 120 : _gradp ? 45 : 20);
+    }
+
+    /**
+     * Evaluate the sum (and optionally its gradient) at equally spaced
+     * longitudes around the whole circle.
+     *
+     * @param[in] lon0 the first longitude (degrees).
+     * @param[in] n the number of longitudes.
+     * @param[out] v the values of the sum at longitudes \e lon0 + \e j
+     *   360&deg;/\e n, for \e j = 0, 1, ..., \e n &minus; 1.
+     * @param[out] gradx \e x components of the gradient (may be nullptr).
+     * @param[out] grady \e y components of the gradient (may be nullptr).
+     * @param[out] gradz \e z components of the gradient (may be nullptr).
+     * @exception std::bad_alloc if the memory for the temporary arrays can't
+     *   be allocated.
+     *
+     * The sum over order \e m is computed with a fast Fourier transform of
+     * size \e n, so the cost is O(\e M + \e n log \e n) instead of
+     * O(\e M \e n) for calling operator()() for each longitude.  (The
+     * transform is fastest if \e n has only small prime factors.)  The
+     * results agree with those of operator()() to within roundoff.  Terms
+     * with \e m &ge; \e n are folded into the transform correctly, so any
+     * positive \e n may be used.  As with operator()(), the gradients will
+     * only be computed if the CircularEngine object was created with this
+     * capability.
+     **********************************************************************/
+    void Values(real lon0, int n, real v[],
+                real gradx[] = nullptr, real grady[] = nullptr,
+                real gradz[] = nullptr) const;
   };
 
 } // namespace GeographicLib
@@ -0,0 +1,177 @@
+/**
+ * \file ClosestApproach.hpp
+ * \brief Header for GeographicLib::ClosestApproach class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_CLOSESTAPPROACH_HPP)
+#define GEOGRAPHICLIB_CLOSESTAPPROACH_HPP 1
+
+#include <vector>
+#include <GeographicLib/GeodesicLine.hpp>
+#include <GeographicLib/Geocentric.hpp>
+#include <GeographicLib/Constants.hpp>
+
+namespace GeographicLib {
+
+  /**
+   * \brief The closest approach of objects moving along geodesics
+   *
+   * Each object starts at a given position at time 0 and moves along a
+   * geodesic with a given initial azimuth at a constant speed (a track).
+   * This class finds the time at which two objects are closest and their
+   * distance then (Pair), and the close encounters among many objects
+   * (Tracks); the typical application is collision avoidance.  The units of
+   * time are arbitrary; the speeds are in meters per unit of time.
+   *
+   * The time of closest approach is found by Newton's method.  Let \e s be
+   * the distance between the objects and let &gamma;<sub>1</sub> and
+   * &gamma;<sub>2</sub> be the angles between their directions of motion
+   * and the geodesic joining them.  Then d(<i>s</i><sup>2</sup>/2)/d<i>t</i>
+   * = \e s (\e v<sub>2</sub> cos&gamma;<sub>2</sub> &minus; \e
+   * v<sub>1</sub> cos&gamma;<sub>1</sub>) and its derivative is found with
+   * the reduced length and the geodesic scales of the geodesic joining the
+   * objects.  In the planar limit, <i>s</i><sup>2</sup>/2 is quadratic in
+   * \e t and a single iteration suffices; on the ellipsoid, the convergence
+   * is quadratic.  The iteration starts at \e t = 0 and the solution is
+   * confined to [0, \e tmax], so the time of closest approach may be one of
+   * its ends.  Each iteration costs two calls to GeodesicLine::Position and
+   * one inverse geodesic calculation.  This is the method of the prototype
+   * in develop/ClosestApproach.cpp.
+   *
+   * Tracks avoids solving the problem for all pairs of objects.  Over the
+   * interval [0, \e tmax], an object stays within a distance \e v \e tmax /
+   * 2 of its position at \e tmax / 2.  So two objects can only come within a
+   * distance \e R of each other if the chord joining their positions at \e
+   * tmax / 2 is no longer than the sum of these distances plus \e R.  The
+   * positions at \e tmax / 2 are binned into cubes in geocentric
+   * coordinates whose side is the largest such sum; so only the objects in
+   * the same and adjacent cubes need to be checked against this bound, and
+   * the problem is solved only for the pairs which pass.  The candidate
+   * pairs are divided among several threads using GeodesicBatchExecutor.
+   *
+   * ClosestApproach objects are not altered once they have been
+   * constructed, so they can be shared by several threads.
+   *
+   * Example of use:
+   * \code
+   * // Planes leave Istanbul (42N 29E, heading 51W, 900 km/hr) and Reykjavik
+   * // (64N 22W, heading 154E, 800 km/hr) at the same time.
+   * ClosestApproach ca;
+   * double t, d = ca.Pair(42, 29, -51, 900e3, 64, -22, 154, 800e3, 10, t);
+   * // t = 2.72 hr, d = 1083 km
+   * \endcode
+   **********************************************************************/
+  class GEOGRAPHICLIB_EXPORT ClosestApproach {
+  private:
+    typedef Math::real real;
+    static const unsigned caps_ = Geodesic::LATITUDE | Geodesic::LONGITUDE |
+      Geodesic::AZIMUTH | Geodesic::DISTANCE_IN;
+    static const int numit_ = 50;
+    Geodesic _geod;
+    Geocentric _earth;
+    real _eps, _tol;
+  public:
+
+    /**
+     * A close encounter found by Tracks.
+     **********************************************************************/
+    struct Encounter {
+      /**
+       * The indices of the two objects, \e i < \e j.
+       **********************************************************************/
+      size_t i, j;
+      /**
+       * The time of closest approach.
+       **********************************************************************/
+      Math::real t;
+      /**
+       * The distance at closest approach (meters).
+       **********************************************************************/
+      Math::real d;
+    };
+
+    /**
+     * Constructor for ClosestApproach.
+     *
+     * @param[in] geod the Geodesic object to use for geodesic calculations.
+     *   By default this uses the WGS84 ellipsoid.
+     **********************************************************************/
+    explicit ClosestApproach(const Geodesic& geod = Geodesic::WGS84());
+
+    /**
+     * Find the closest approach of two objects.
+     *
+     * @param[in] lat1 the latitude of object 1 at time 0 (degrees).
+     * @param[in] lon1 the longitude of object 1 at time 0 (degrees).
+     * @param[in] azi1 the azimuth of the track of object 1 at time 0
+     *   (degrees).
+     * @param[in] v1 the speed of object 1 (meters per unit time).
+     * @param[in] lat2 the latitude of object 2 at time 0 (degrees).
+     * @param[in] lon2 the longitude of object 2 at time 0 (degrees).
+     * @param[in] azi2 the azimuth of the track of object 2 at time 0
+     *   (degrees).
+     * @param[in] v2 the speed of object 2 (meters per unit time).
+     * @param[in] tmax the end of the time interval.
+     * @param[out] t the time of closest approach in [0, \e tmax].
+     * @return the distance at closest approach (meters).
+     *
+     * The distance between the objects has a single minimum unless the
+     * objects travel a long way or are nearly antipodal; in these cases, a
+     * local minimum may be returned.
+     **********************************************************************/
+    real Pair(real lat1, real lon1, real azi1, real v1,
+              real lat2, real lon2, real azi2, real v2,
+              real tmax, real& t) const;
+
+    /**
+     * Find the close encounters among many objects.
+     *
+     * @param[in] n the number of objects.
+     * @param[in] lat array of latitudes of the objects at time 0 (degrees).
+     * @param[in] lon array of longitudes of the objects at time 0 (degrees).
+     * @param[in] azi array of azimuths of the tracks at time 0 (degrees).
+     * @param[in] v array of speeds (meters per unit time).
+     * @param[in] tmax the end of the time interval.
+     * @param[in] R the distance defining a close encounter (meters).
+     * @param[out] encounters the pairs of objects which come within a
+     *   distance \e R of each other in [0, \e tmax].
+     * @param[in] nthreads the number of threads to use; if this is 0 (the
+     *   default), use std::thread::hardware_concurrency().
+     * @exception GeographicErr if \e tmax or \e R is negative or not finite.
+     * @exception std::bad_alloc if the memory for the bins can't be
+     *   allocated.
+     *
+     * The encounters are ordered by \e i and then by \e j and their time
+     * and distance are those given by Pair; the results don't depend on \e
+     * nthreads.
+     **********************************************************************/
+    void Tracks(size_t n, const real lat[], const real lon[],
+                const real azi[], const real v[], real tmax, real R,
+                std::vector<Encounter>& encounters,
+                unsigned nthreads = 0) const;
+
+    /** \name Inspector functions
+     **********************************************************************/
+    ///@{
+    /**
+     * @return \e a the equatorial radius of the ellipsoid (meters).  This is
+     *   the value inherited from the Geodesic object used in the constructor.
+     **********************************************************************/
+    Math::real EquatorialRadius() const { return _geod.EquatorialRadius(); }
+
+    /**
+     * @return \e f the flattening of the ellipsoid.  This is the value
+     *   inherited from the Geodesic object used in the constructor.
+     **********************************************************************/
+    Math::real Flattening() const { return _geod.Flattening(); }
+    ///@}
+
+  };
+
+} // namespace GeographicLib
+
+#endif  // GEOGRAPHICLIB_CLOSESTAPPROACH_HPP
@@ -0,0 +1,178 @@
+/**
+ * \file ClosestPoint.hpp
+ * \brief Header for GeographicLib::ClosestPoint class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_CLOSESTPOINT_HPP)
+#define GEOGRAPHICLIB_CLOSESTPOINT_HPP 1
+
+#include <GeographicLib/Geodesic.hpp>
+#include <GeographicLib/GeodesicLine.hpp>
+#include <GeographicLib/Geocentric.hpp>
+#include <GeographicLib/Constants.hpp>
+
+namespace GeographicLib {
+
+  /**
+   * \brief The closest point on a geodesic segment or polyline
+   *
+   * Find the point on a geodesic segment closest to a given point \e Q
+   * (the interception problem), and the closest point on a polyline made
+   * up of geodesic segments; the typical application is matching GPS fixes
+   * to a road network.
+   *
+   * The closest point on a segment is found by Newton's method.  Let \e z
+   * be the distance from the point \e X, a distance \e x along the segment,
+   * to \e Q and let &gamma; be the angle at \e X between the segment and
+   * the geodesic \e XQ.  Then d(<i>z</i><sup>2</sup>/2)/d<i>x</i> =
+   * &minus;\e z cos&gamma; and its derivative is cos<sup>2</sup>&gamma; +
+   * (\e M \e z / \e m) sin<sup>2</sup>&gamma;, where \e m and \e M are the
+   * reduced length and the geodesic scale of \e XQ.  In the planar limit,
+   * \e z<sup>2</sup>/2 is quadratic in \e x and a single iteration
+   * suffices; on the ellipsoid, the convergence is quadratic.  The starting
+   * point is found by treating the triangle formed by the start of the
+   * segment and \e Q as planar.  Each iteration costs one call to
+   * GeodesicLine::Position and one inverse geodesic calculation.  The
+   * solution is confined to the segment, so the closest point may be one of
+   * its ends.
+   *
+   * Polyline finds the closest points on a polyline for many points.  As
+   * in Intersect::AllSegments, each segment is enclosed in a bounding cap
+   * given by GeodesicLine::BoundingCap.  The geodesic distance from \e Q to
+   * a segment is at least the length of the chord from \e Q to the center
+   * of its cap less the radius of the cap; this lower bound is computed
+   * cheaply with geocentric coordinates.  The segment with the smallest
+   * bound is solved first and the remaining segments are only solved if
+   * their bounds are less than the best distance found so far; so usually
+   * only a few segments are solved for each point.  The points are divided
+   * among several threads using GeodesicBatchExecutor.
+   *
+   * ClosestPoint objects are not altered once they have been constructed,
+   * so they can be shared by several threads.
+   **********************************************************************/
+  class GEOGRAPHICLIB_EXPORT ClosestPoint {
+  private:
+    typedef Math::real real;
+    static const unsigned caps_ = Geodesic::LATITUDE | Geodesic::LONGITUDE |
+      Geodesic::AZIMUTH | Geodesic::DISTANCE_IN;
+    static const int numit_ = 50;
+    Geodesic _geod;
+    Geocentric _earth;
+    real _eps, _tol;
+    // The endpoints of a geodesic segment and its bounding cap; the center
+    // of the cap is given in geocentric coordinates.
+    struct Cap {
+      real lat1, lon1, lat2, lon2;
+      real X, Y, Z, r;
+    };
+    void MakeCap(real lat1, real lon1, real lat2, real lon2, Cap& cap) const;
+  public:
+
+    /**
+     * Constructor for ClosestPoint.
+     *
+     * @param[in] geod the Geodesic object to use for geodesic calculations.
+     *   By default this uses the WGS84 ellipsoid.
+     **********************************************************************/
+    explicit ClosestPoint(const Geodesic& geod = Geodesic::WGS84());
+
+    /**
+     * Find the closest point on a geodesic segment.
+     *
+     * @param[in] lat the latitude of the point \e Q (degrees).
+     * @param[in] lon the longitude of the point \e Q (degrees).
+     * @param[in] lat1 the latitude of the start of the segment (degrees).
+     * @param[in] lon1 the longitude of the start of the segment (degrees).
+     * @param[in] lat2 the latitude of the end of the segment (degrees).
+     * @param[in] lon2 the longitude of the end of the segment (degrees).
+     * @param[out] x the displacement of the closest point along the segment
+     *   (meters).
+     * @return the distance from \e Q to the closest point (meters).
+     *
+     * The segment is the shortest geodesic between its endpoints.  The
+     * distance from \e Q to a point on the segment has a single minimum
+     * unless the segment is very long or \e Q is close to the antipodes of
+     * the segment; in these cases, a local minimum may be returned.
+     **********************************************************************/
+    real Segment(real lat, real lon,
+                 real lat1, real lon1, real lat2, real lon2, real& x) const;
+
+    /**
+     * Find the closest point on a geodesic segment using a GeodesicLine
+     * object.
+     *
+     * @param[in] lat the latitude of the point \e Q (degrees).
+     * @param[in] lon the longitude of the point \e Q (degrees).
+     * @param[in] line the segment.
+     * @param[out] x the displacement of the closest point along the segment
+     *   (meters).
+     * @return the distance from \e Q to the closest point (meters).
+     *
+     * The segment extends from the starting point of \e line to the
+     * distance given by GeodesicLine::Distance.  This line is typically
+     * constructed by Geodesic::InverseLine with \e caps = LineCaps() and by
+     * the same ellipsoid as this object.
+     **********************************************************************/
+    real Segment(real lat, real lon, const GeodesicLine& line, real& x) const;
+
+    /**
+     * Find the closest points on a polyline for many points.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lat array of latitudes of the points (degrees).
+     * @param[in] lon array of longitudes of the points (degrees).
+     * @param[in] m the number of vertices of the polyline.
+     * @param[in] latp array of latitudes of the vertices (degrees).
+     * @param[in] lonp array of longitudes of the vertices (degrees).
+     * @param[out] seg array of the indices of the closest segments.
+     * @param[out] x array of the displacements of the closest points along
+     *   the closest segments (meters).
+     * @param[out] d array of the distances to the closest points (meters).
+     * @param[in] nthreads the number of threads to use; if this is 0 (the
+     *   default), use std::thread::hardware_concurrency().
+     * @exception std::bad_alloc if the memory for the bounding caps can't be
+     *   allocated.
+     *
+     * The output arrays have (at least) \e n elements.  Segment \e j joins
+     * vertices \e j and \e j + 1; if \e m = 1, the polyline is a single
+     * point and \e seg = 0 and \e x = 0.  If \e m = 0, \e x and \e d are
+     * set to NaN.  If several segments are equally close, the one with the
+     * smallest bound (see the class description) is reported; this does not
+     * depend on \e nthreads.  The output arrays should not alias the input
+     * arrays.
+     **********************************************************************/
+    void Polyline(size_t n, const real lat[], const real lon[],
+                  size_t m, const real latp[], const real lonp[],
+                  size_t seg[], real x[], real d[],
+                  unsigned nthreads = 0) const;
+
+    /** \name Inspector functions
+     **********************************************************************/
+    ///@{
+    /**
+     * @return \e a the equatorial radius of the ellipsoid (meters).  This is
+     *   the value inherited from the Geodesic object used in the constructor.
+     **********************************************************************/
+    Math::real EquatorialRadius() const { return _geod.EquatorialRadius(); }
+
+    /**
+     * @return \e f the flattening of the ellipsoid.  This is the value
+     *   inherited from the Geodesic object used in the constructor.
+     **********************************************************************/
+    Math::real Flattening() const { return _geod.Flattening(); }
+
+    /**
+     * @return the \e caps needed by GeodesicLine objects passed to Segment.
+     **********************************************************************/
+    static unsigned LineCaps() { return caps_; }
+    ///@}
+
+  };
+
+} // namespace GeographicLib
+
+#endif  // GEOGRAPHICLIB_CLOSESTPOINT_HPP
@@ -0,0 +1,165 @@
+/**
+ * \file CoordinatePipeline.hpp
+ * \brief Header for GeographicLib::CoordinatePipeline class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_COORDINATEPIPELINE_HPP)
+#define GEOGRAPHICLIB_COORDINATEPIPELINE_HPP 1
+
+#include <GeographicLib/LocalCartesian.hpp>
+#include <GeographicLib/UTMUPS.hpp>
+
+namespace GeographicLib {
+
+  /**
+   * \brief Convert batches of points between several coordinate systems
+   *
+   * A common task is to convert the same points to several coordinate
+   * systems, e.g., geodetic coordinates from a GNSS receiver to geocentric
+   * coordinates, to local cartesian (east-north-up) coordinates about a
+   * reference point, and to UTM/UPS coordinates.  Calling
+   * Geocentric::ForwardBatch, LocalCartesian::ForwardBatch, and
+   * UTMUPS::ForwardBatch separately converts the points to geocentric
+   * coordinates twice and passes over the data three times.  This class
+   * does the conversions in one pass over blocks of points: each block is
+   * converted to geocentric coordinates once and these are rotated to the
+   * local frame while they are in the cache.  The stages are picked by the
+   * output arrays supplied; an output which isn't wanted is given as
+   * nullptr and the work for it is skipped.
+   *
+   * The results are identical to those obtained by calling the individual
+   * batch routines.
+   *
+   * Example of use:
+   * \code
+   * LocalCartesian local(lat0, lon0, h0);
+   * CoordinatePipeline pipe(local);
+   * // Convert n points to local cartesian and UTM coordinates
+   * pipe.Forward(n, lat, lon, h, nullptr, nullptr, nullptr, x, y, z,
+   *              zone, northp, easting, northing);
+   * \endcode
+   **********************************************************************/
+  class GEOGRAPHICLIB_EXPORT CoordinatePipeline {
+  private:
+    typedef Math::real real;
+    // The number of points converted together; this matches the blocks used
+    // by UTMUPS::ForwardBatch
+    static const int batchsize_ = 1024;
+    LocalCartesian _local;
+    int _setzone;
+    bool _mgrslimits;
+  public:
+
+    /**
+     * Constructor.
+     *
+     * @param[in] local the LocalCartesian object giving the ellipsoid and the
+     *   origin of the local cartesian coordinates; default
+     *   LocalCartesian(), which has its origin at (0&deg;, 0&deg;, 0) on the
+     *   WGS84 ellipsoid.
+     * @param[in] setzone the UTM zone override for the UTM/UPS coordinates
+     *   (see UTMUPS::Forward); default UTMUPS::STANDARD.
+     * @param[in] mgrslimits if true enforce the stricter MGRS limits on the
+     *   UTM/UPS coordinates (default = false).
+     *
+     * The UTM/UPS coordinates are always on the WGS84 ellipsoid (as for
+     * UTMUPS), whatever the ellipsoid of \e local.
+     **********************************************************************/
+    explicit CoordinatePipeline(const LocalCartesian& local = LocalCartesian(),
+                                int setzone = UTMUPS::STANDARD,
+                                bool mgrslimits = false)
+      : _local(local)
+      , _setzone(setzone)
+      , _mgrslimits(mgrslimits)
+    {}
+
+    /**
+     * Convert points from geodetic coordinates.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lat array of latitudes (degrees).
+     * @param[in] lon array of longitudes (degrees).
+     * @param[in] h array of heights above the ellipsoid (meters).
+     * @param[out] X array of geocentric coordinates (meters).
+     * @param[out] Y array of geocentric coordinates (meters).
+     * @param[out] Z array of geocentric coordinates (meters).
+     * @param[out] x array of local cartesian coordinates (meters).
+     * @param[out] y array of local cartesian coordinates (meters).
+     * @param[out] z array of local cartesian coordinates (meters).
+     * @param[out] zone array of UTM zones (zero means UPS).
+     * @param[out] northp array of hemispheres (true means north).
+     * @param[out] easting array of UTM/UPS eastings (meters).
+     * @param[out] northing array of UTM/UPS northings (meters).
+     * @exception GeographicErr if UTM/UPS coordinates are requested and any
+     *   point would cause UTMUPS::Forward to throw an exception; in this
+     *   case, the output arrays may have been partially filled.
+     * @exception std::bad_alloc if the memory for the temporary arrays can't
+     *   be allocated.
+     *
+     * Each group of outputs, (\e X, \e Y, \e Z), (\e x, \e y, \e z), and (\e
+     * zone, \e northp, \e easting, \e northing), is computed only if its
+     * first array isn't nullptr.  The output arrays must not coincide with
+     * the input arrays.
+     **********************************************************************/
+    void Forward(size_t n, const real lat[], const real lon[], const real h[],
+                 real X[], real Y[], real Z[], real x[], real y[], real z[],
+                 int zone[], bool northp[],
+                 real easting[], real northing[]) const;
+
+    /**
+     * Convert points from local cartesian coordinates.
+     *
+     * @param[in] n the number of points.
+     * @param[in] x array of local cartesian coordinates (meters).
+     * @param[in] y array of local cartesian coordinates (meters).
+     * @param[in] z array of local cartesian coordinates (meters).
+     * @param[out] lat array of latitudes (degrees).
+     * @param[out] lon array of longitudes (degrees).
+     * @param[out] h array of heights above the ellipsoid (meters).
+     * @param[out] X array of geocentric coordinates (meters).
+     * @param[out] Y array of geocentric coordinates (meters).
+     * @param[out] Z array of geocentric coordinates (meters).
+     * @param[out] zone array of UTM zones (zero means UPS).
+     * @param[out] northp array of hemispheres (true means north).
+     * @param[out] easting array of UTM/UPS eastings (meters).
+     * @param[out] northing array of UTM/UPS northings (meters).
+     * @exception GeographicErr if UTM/UPS coordinates are requested and any
+     *   point would cause UTMUPS::Forward to throw an exception; in this
+     *   case, the output arrays may have been partially filled.
+     * @exception std::bad_alloc if the memory for the temporary arrays can't
+     *   be allocated.
+     *
+     * Each group of outputs, (\e lat, \e lon, \e h), (\e X, \e Y, \e Z), and
+     * (\e zone, \e northp, \e easting, \e northing), is computed only if its
+     * first array isn't nullptr.  The geodetic coordinates are computed (in a
+     * temporary array) if the UTM/UPS coordinates are needed.  The output
+     * arrays must not coincide with the input arrays.
+     **********************************************************************/
+    void Reverse(size_t n, const real x[], const real y[], const real z[],
+                 real lat[], real lon[], real h[],
+                 real X[], real Y[], real Z[],
+                 int zone[], bool northp[],
+                 real easting[], real northing[]) const;
+
+    /** \name Inspector functions
+     **********************************************************************/
+    ///@{
+    /**
+     * @return the LocalCartesian object used by the pipeline.
+     **********************************************************************/
+    const LocalCartesian& Local() const { return _local; }
+
+    /**
+     * @return the UTM zone override.
+     **********************************************************************/
+    int SetZone() const { return _setzone; }
+    ///@}
+  };
+
+} // namespace GeographicLib
+
+#endif  // GEOGRAPHICLIB_COORDINATEPIPELINE_HPP
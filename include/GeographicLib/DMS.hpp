@@ -335,6 +335,29 @@ namespace GeographicLib {
     static std::string Encode(real angle, component trailing, unsigned prec,
                               flag ind = NONE, char dmssep = char(0));
 
+    /**
+     * Convert angle (in degrees) into a DMS string in a character array.
+     *
+     * @param[in] angle input angle (degrees)
+     * @param[in] trailing DMS::component value indicating the trailing units
+     *   of the string.
+     * @param[in] prec the number of digits after the decimal point for the
+     *   trailing component.
+     * @param[in] ind DMS::flag value indicating additional formatting.
+     * @param[in] dmssep if non-null, use as the DMS separator character.
+     * @param[out] s a char array to receive the null-terminated string.
+     * @param[in] n the size of \e s.
+     * @exception GeographicErr if \e s is too small.
+     * @return the length of the string.
+     *
+     * This gives the same string as the other version of Encode, but no
+     * memory is allocated (the numbers are formatted with the char array
+     * version of Utility::str).  A size of 32 + \e prec suffices for angles
+     * less than 1000&deg; in magnitude.
+     **********************************************************************/
+    static size_t Encode(real angle, component trailing, unsigned prec,
+                         flag ind, char dmssep, char s[], size_t n);
+
     /**
      * Convert angle into a DMS string (using d, ', and &quot;) selecting the
      * trailing component based on the precision.
@@ -362,6 +385,30 @@ namespace GeographicLib {
                ind, dmssep);
     }
 
+    /**
+     * Convert angle into a DMS string in a character array selecting the
+     * trailing component based on the precision.
+     *
+     * @param[in] angle input angle (degrees)
+     * @param[in] prec the precision relative to 1 degree.
+     * @param[in] ind DMS::flag value indicated additional formatting.
+     * @param[in] dmssep if non-null, use as the DMS separator character.
+     * @param[out] s a char array to receive the null-terminated string.
+     * @param[in] n the size of \e s.
+     * @exception GeographicErr if \e s is too small.
+     * @return the length of the string.
+     *
+     * This is the char array version of Encode(real, unsigned, flag, char).
+     **********************************************************************/
+    static size_t Encode(real angle, unsigned prec, flag ind, char dmssep,
+                         char s[], size_t n) {
+      return ind == NUMBER ? Utility::str(angle, int(prec), s, n) :
+        Encode(angle,
+               prec < 2 ? DEGREE : (prec < 4 ? MINUTE : SECOND),
+               prec < 2 ? prec : (prec < 4 ? prec - 2 : prec - 4),
+               ind, dmssep, s, n);
+    }
+
     /**
      * Split angle into degrees and minutes
      *
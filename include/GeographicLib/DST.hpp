@@ -13,12 +13,7 @@
 #include <GeographicLib/Constants.hpp>
 
 #include <functional>
-#include <memory>
-
-/// \cond SKIP
-template<typename scalar_t>
-class kissfft;
-/// \endcond
+#include <vector>
 
 namespace GeographicLib {
 
@@ -42,6 +37,12 @@ namespace GeographicLib {
    * \f$ and \f$ 1 \f$ otherwise.  \f$ F_l \f$ is a discrete sine transform of
    * type DST-III and may be conveniently computed using the fast Fourier
    * transform, FFT; this is implemented with the DST::transform method.
+   * The DST-III of size \f$ N \f$ is split recursively into a DST-III and
+   * a DST-IV of size \f$ \frac12 N \f$ and a DST-IV of even size \f$ N
+   * \f$ is computed with a complex FFT of size \f$ \frac12 N \f$; odd
+   * sizes are computed by direct summation.  Thus the transform is fastest
+   * if \f$ N \f$ is a power of 2 times a small odd number; this is the
+   * case for the sizes used by GeodesicExact.
    *
    * Having computed \f$ F_l \f$ based on \f$ N \f$ evaluations of \f$
    * f(\sigma) \f$ at \f$ \sigma_j = j\pi/(2N) \f$, it is possible to
@@ -49,7 +50,12 @@ namespace GeographicLib {
    * evaluating \f$ f(\sigma) \f$ at \f$ (j-\frac12)\pi/(2N) \f$; this is
    * implemented with the DST::refine method.
    *
-   * Here we compute FFTs using the kissfft package
+   * Functions which are odd about both \f$ \sigma = 0 \f$ and \f$ \sigma =
+   * \frac12\pi \f$ (period \f$ \pi \f$) include all the harmonics
+   * \f$ \sin(2l\sigma) \f$.  These can be fit with DST::sinefit and
+   * evaluated with DST::sineval.
+   *
+   * Here we compute the complex FFTs using the kissfft package
    * https://github.com/mborgerding/kissfft by Mark Borgerding.
    *
    * Example of use:
@@ -64,12 +70,17 @@ namespace GeographicLib {
   private:
     typedef Math::real real;
     int _N;
-    typedef kissfft<real> fft_t;
-    std::shared_ptr<fft_t> _fft;
-    // Implement DST-III (centerp = false) or DST-IV (centerp = true)
-    void fft_transform(real data[], real F[], bool centerp) const;
+    // The FFT plans and twiddle factors for the sizes N, N/2, N/4, ...; the
+    // plans are immutable and are shared by all DST objects of the same size
+    class plan;
+    const plan* _plan;
+    static const plan* Plan(int N);
+    // Implement DST-III (centerp = false) or DST-IV (centerp = true); temp
+    // holds 2*N reals of working storage
+    void GEOGRAPHICLIB_EXPORT fft_transform(real data[], real F[],
+                                            bool centerp, real temp[]) const;
     // Add another N terms to F
-    void fft_transform2(real data[], real F[]) const;
+    void fft_transform2(real data[], real F[], real temp[]) const;
   public:
     /**
      * Constructor specifying the number of points to use.
@@ -124,6 +135,86 @@ namespace GeographicLib {
     void GEOGRAPHICLIB_EXPORT refine(std::function<real(real)> f, real F[])
       const;
 
+    /**
+     * The size of the scratch array needed by the non-allocating transforms
+     *
+     * @param[in] M the number of functions for the batched transform; use the
+     *   default, 0, for transform and refine with a single function.
+     * @return the required number of elements of the scratch array.
+     **********************************************************************/
+    int scratchsize(int M = 0) const { return (4 + M) * _N; }
+
+    /**
+     * Determine first \e N terms in the Fourier series using caller-supplied
+     * storage
+     *
+     * @param[in] f the function used for evaluation.
+     * @param[out] F  the first \e N coefficients of the Fourier series.
+     * @param[out] scratch working storage of length at least scratchsize().
+     *
+     * This gives the same result as transform(f, F) but allocates no memory
+     * (provided that the construction of \e f doesn't; pass a functor
+     * wrapped with std::cref to ensure this).
+     **********************************************************************/
+    void GEOGRAPHICLIB_EXPORT transform(std::function<real(real)> f, real F[],
+                                        real scratch[]) const;
+
+    /**
+     * Determine first \e N terms in the Fourier series with a functor
+     *
+     * @tparam Fn the type of the functor.
+     * @param[in] f the function used for evaluation.
+     * @param[out] F  the first \e N coefficients of the Fourier series.
+     * @param[out] scratch working storage of length at least scratchsize().
+     *
+     * This is the same as the previous function but \e f is called directly
+     * instead of via std::function, so that it can be inlined.
+     **********************************************************************/
+    template<class Fn>
+    void transform(const Fn& f, real F[], real scratch[]) const {
+      real d = Math::pi()/(2 * _N);
+      for (int i = 1; i <= _N; ++i)
+        scratch[i] = f( i * d );
+      fft_transform(scratch, F, false, scratch + 2*_N);
+    }
+
+    /**
+     * Refine the Fourier series using caller-supplied storage
+     *
+     * @param[in] f the function used for evaluation.
+     * @param[inout] F on input the first \e N coefficents of the Fourier
+     *   series; on output the first 2\e N coefficents.
+     * @param[out] scratch working storage of length at least scratchsize().
+     *
+     * This gives the same result as refine(f, F) but allocates no memory.
+     **********************************************************************/
+    void GEOGRAPHICLIB_EXPORT refine(std::function<real(real)> f, real F[],
+                                     real scratch[]) const;
+
+    /**
+     * Determine first \e N terms in the Fourier series for several functions
+     *
+     * @param[in] M the number of functions.
+     * @param[in] f the functions used for evaluation; \e f(&sigma;, \e y)
+     *   should set \e y[\e m] = \e f<sub>\e m</sub>(&sigma;) for \e m
+     *   &isin; [0, \e M).
+     * @param[out] F the coefficients of the Fourier series; \e F[\e m \e N +
+     *   \e j] is the \e j th coefficient for the \e m th function.
+     * @param[out] scratch working storage of length at least
+     *   scratchsize(\e M).
+     *
+     * This is useful when the functions share much of their computation,
+     * e.g., when they depend on a common set of parameters; \e f is called
+     * just once per sample point and the samples for all the functions are
+     * stored interleaved in \e scratch.  The FFT plan and the working storage
+     * are shared among the transforms.  The results are the same as calling
+     * transform for each function in turn.  \e F should be an array of
+     * length at least \e M \e N.
+     **********************************************************************/
+    void GEOGRAPHICLIB_EXPORT transform(int M,
+                                        std::function<void(real, real[])> f,
+                                        real F[], real scratch[]) const;
+
     /**
      * Evaluate the Fourier sum given the sine and cosine of the angle
      *
@@ -170,6 +261,69 @@ namespace GeographicLib {
     static real GEOGRAPHICLIB_EXPORT integral(real sinx, real cosx,
                                               real siny, real cosy,
                                               const real F[], int N);
+
+    /**
+     * Fit a function with a sine series of all the even harmonics
+     *
+     * @param[in] f the function to fit.
+     * @param[out] F the Fourier coefficients; \e F[0] is unused.
+     * @param[in] maxN the maximum number of samples (default 256).
+     * @return whether the series converged.
+     *
+     * The function \f$ f(\sigma) \f$ must be odd about \f$ \sigma = 0 \f$
+     * and \f$ \sigma = \frac12\pi \f$ so that
+     * \f[
+     *   f(\sigma) = \sum_{l=1}^\infty F_l \sin(2l\sigma).
+     * \f]
+     * This is sampled at \f$ \sigma_j = j\pi/(2M) \f$ for \f$ 0 < j < M
+     * \f$ and the coefficients found with a DST-I.  \e M starts at 16 and is
+     * doubled (reusing the previous samples) until the upper half of the
+     * coefficients is negligible; the series is then truncated by dropping
+     * the negligible trailing coefficients.  If this doesn't happen with \e M
+     * &le; \e maxN, \e F is cleared and false is returned.  (The roundoff
+     * error in evaluating the series grows with the number of terms, so \e
+     * maxN shouldn't be made too large.)  The DST-I is computed by direct
+     * summation; so the cost is of order \e M<sup>2</sup>.
+     **********************************************************************/
+    static bool GEOGRAPHICLIB_EXPORT sinefit(std::function<real(real)> f,
+                                             std::vector<real>& F,
+                                             int maxN = 256);
+
+    /**
+     * Evaluate a sine series of even harmonics given the sine and cosine of
+     * the angle
+     *
+     * @param[in] sinx sin&sigma;.
+     * @param[in] cosx cos&sigma;.
+     * @param[in] F the array of Fourier coefficients; \e F[0] is unused.
+     * @param[in] N the number of Fourier coefficients.
+     * @return the value of \f$ \sum_{l=1}^N F_l \sin(2l\sigma) \f$.
+     **********************************************************************/
+    static real GEOGRAPHICLIB_EXPORT sineval(real sinx, real cosx,
+                                             const real F[], int N);
+
+    /**
+     * Fit a function with a cosine series of all the even harmonics
+     *
+     * @param[in] f the function to fit.
+     * @param[out] F the Fourier coefficients.
+     * @param[in] maxN the maximum number of samples (default 256).
+     * @return whether the series converged.
+     *
+     * The function \f$ f(\sigma) \f$ must be even about \f$ \sigma = 0 \f$
+     * and \f$ \sigma = \frac12\pi \f$ so that
+     * \f[
+     *   f(\sigma) = \sum_{l=0}^\infty F_l \cos(2l\sigma).
+     * \f]
+     * This is the counterpart of sinefit.  The function is sampled at \f$
+     * \sigma_j = j\pi/(2M) \f$ for \f$ 0 \le j \le M \f$ and the
+     * coefficients found with a DCT-I.  The convergence test is relative to
+     * the largest coefficient.  Integrating the series gives \f$ F_0\sigma
+     * \f$ plus a sine series which can be evaluated with sineval.
+     **********************************************************************/
+    static bool GEOGRAPHICLIB_EXPORT cosinefit(std::function<real(real)> f,
+                                               std::vector<real>& F,
+                                               int maxN = 256);
   };
 
 } // namespace GeographicLib
@@ -0,0 +1,118 @@
+/**
+ * \file Densifier.hpp
+ * \brief Header for GeographicLib::Densifier class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_DENSIFIER_HPP)
+#define GEOGRAPHICLIB_DENSIFIER_HPP 1
+
+#include <GeographicLib/Constants.hpp>
+#include <GeographicLib/Math.hpp>
+#include <vector>
+
+namespace GeographicLib {
+
+  /**
+   * \brief Adaptive densification of a path for plotting on a map
+   *
+   * A geodesic or a rhumb line is drawn on a map as a polyline, i.e., a
+   * sequence of vertices joined by straight lines in the projected
+   * coordinates.  Densifier::Path picks the vertices adaptively so that the
+   * polyline follows the projected path to within a given tolerance.  Short
+   * lines and portions of a path which are nearly straight in the projection
+   * need few vertices; this typically results in far fewer vertices than
+   * densifying at a fixed spacing.
+   *
+   * This is used by GeodesicLine::Densify and RhumbLine::Densify, which
+   * supply the function giving the position on the path.
+   **********************************************************************/
+  class Densifier {
+  private:
+    typedef Math::real real;
+    struct vertex { real t, lat, lon, x, y; };
+    template<class F, class P>
+    static vertex Point(const F& pos, const P& proj, real t) {
+      vertex v;
+      v.t = t;
+      pos(t, v.lat, v.lon);
+      proj(v.lat, v.lon, v.x, v.y);
+      return v;
+    }
+    // The distance of c from the chord a-b in the projected coordinates
+    static real Deviation(const vertex& a, const vertex& b, const vertex& c) {
+      using std::fmin; using std::fmax; using std::hypot;
+      real dx = b.x - a.x, dy = b.y - a.y,
+        ex = c.x - a.x, ey = c.y - a.y,
+        d2 = Math::sq(dx) + Math::sq(dy),
+        u = d2 > 0 ? (dx * ex + dy * ey) / d2 : 0;
+      u = fmin(real(1), fmax(real(0), u));
+      return hypot(ex - u * dx, ey - u * dy);
+    }
+    template<class F, class P>
+    static void Split(const F& pos, const P& proj, real tol, unsigned depth,
+                      const vertex& a, const vertex& d,
+                      std::vector<real>& lat, std::vector<real>& lon) {
+      // Test the points at 1/3 and 2/3 of the way along the segment (instead
+      // of the midpoint) so that a symmetric S-shaped segment is caught
+      real h = (d.t - a.t) / 3;
+      vertex b = Point(pos, proj, a.t + h), c = Point(pos, proj, d.t - h);
+      if (depth > 0 &&
+          (Deviation(a, d, b) > tol || Deviation(a, d, c) > tol)) {
+        Split(pos, proj, tol, depth - 1, a, b, lat, lon);
+        Split(pos, proj, tol, depth - 1, b, c, lat, lon);
+        Split(pos, proj, tol, depth - 1, c, d, lat, lon);
+      } else {
+        lat.push_back(d.lat); lon.push_back(d.lon);
+      }
+    }
+    Densifier() = delete;       // Disable constructor
+
+  public:
+
+    /**
+     * Densify a path adaptively.
+     *
+     * @tparam F the type of the function giving the position on the path.
+     * @tparam P the type of the projection.
+     * @param[in] pos the function giving the position on the path; pos(t,
+     *   lat, lon) sets \e lat and \e lon (degrees) to the position for the
+     *   parameter \e t.
+     * @param[in] proj the projection; proj(lat, lon, x, y) sets \e x and \e y
+     *   to the projected coordinates of (\e lat, \e lon).
+     * @param[in] t13 the value of the parameter at the end of the path (which
+     *   starts at \e t = 0).
+     * @param[in] tol the tolerance on the deviation of the polyline from the
+     *   projected path (in the units of \e x and \e y).
+     * @param[in] maxdepth the maximum number of times a segment is split.
+     * @param[out] lat the latitudes of the vertices (degrees).
+     * @param[out] lon the longitudes of the vertices (degrees).
+     *
+     * The first and last vertices are the ends of the path.  A segment of the
+     * polyline is accepted if the points on the path 1/3 and 2/3 of the way
+     * along it (in \e t) lie within \e tol of the segment in the projected
+     * coordinates; otherwise it is split into 3 equal parts which are treated
+     * in the same way.  Between the tested points, the deviation may exceed
+     * \e tol slightly (typically by less than 20%).  No segment is split
+     * more than \e maxdepth times, so there are at most 3<sup>\e
+     * maxdepth</sup> + 1 vertices.  A segment with points which the
+     * projection can't handle (so that \e x or \e y is a NaN) is accepted.
+     * The vectors \e lat and \e lon are cleared first.
+     **********************************************************************/
+    template<class F, class P>
+    static void Path(const F& pos, const P& proj, real t13, real tol,
+                     unsigned maxdepth,
+                     std::vector<real>& lat, std::vector<real>& lon) {
+      lat.clear(); lon.clear();
+      vertex a = Point(pos, proj, real(0)), d = Point(pos, proj, t13);
+      lat.push_back(a.lat); lon.push_back(a.lon);
+      Split(pos, proj, tol, maxdepth, a, d, lat, lon);
+    }
+  };
+
+} // namespace GeographicLib
+
+#endif  // GEOGRAPHICLIB_DENSIFIER_HPP
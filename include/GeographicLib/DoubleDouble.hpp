@@ -0,0 +1,465 @@
+/**
+ * \file DoubleDouble.hpp
+ * \brief Header for GeographicLib::DoubleDouble class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+// Constants.hpp includes Math.hpp which includes this file when
+// GEOGRAPHICLIB_PRECISION = 6.  Place this include outside the include guard
+// to enforce this ordering.
+#include <GeographicLib/Constants.hpp>
+
+#if !defined(GEOGRAPHICLIB_DOUBLEDOUBLE_HPP)
+#define GEOGRAPHICLIB_DOUBLEDOUBLE_HPP 1
+
+#include <cmath>
+#include <iosfwd>
+#include <limits>
+
+namespace GeographicLib {
+
+  /**
+   * \brief Double-double real numbers
+   *
+   * A DoubleDouble is the unevaluated sum of two doubles, \e hi + \e lo,
+   * with |\e lo| &le; ulp(\e hi)/2.  This gives 104 bits of precision (about
+   * 31 decimal digits) with the range of a double.  The arithmetic is
+   * carried out with the error-free transformations of the sum and product
+   * of two doubles, which use the hardware fused multiply-add if it's
+   * available (FP_FAST_FMA is defined, e.g., with g++ -mfma) and Dekker's
+   * splitting otherwise.  The operations are inline and branch-free (special
+   * values are handled with conditional moves) so that loops over arrays of
+   * DoubleDoubles can be vectorized.  This type is used for Math::real when
+   * GEOGRAPHICLIB_PRECISION = 6; it gives nearly the precision of the quad
+   * precision of GEOGRAPHICLIB_PRECISION = 4 with no additional libraries
+   * and at a much lower cost (Geodesic::Inverse is about 30 times slower
+   * than with doubles).
+   *
+   * The usual functions of &lt;cmath&gt; (sqrt, sin, atan2, exp, log, hypot,
+   * remainder, etc.) are provided as friend functions, found by
+   * argument-dependent lookup; so code of the form
+   * \code
+   * using std::sin; T y = sin(x);
+   * \endcode
+   * works with T = DoubleDouble.  The transcendental functions are evaluated
+   * with Taylor series or with one Newton iteration starting from the double
+   * result; their errors are a few units in the last place.  Signed zeros,
+   * infinities, and NaNs are treated as for doubles.  Conversion from the
+   * arithmetic types is implicit (and exact); conversion to them is
+   * explicit.
+   *
+   * The bits beyond double precision are ignored on conversion to double
+   * and by the binary I/O of Utility::readarray and Utility::writearray.
+   * Formatted I/O with the &lt;&lt; and &gt;&gt; operators respects the
+   * stream precision and the fixed and scientific flags.
+   *
+   * Example of use:
+   * \code
+   * DoubleDouble x = 2;
+   * std::cout << std::setprecision(31) << sqrt(x) << "\n";
+   * \endcode
+   **********************************************************************/
+  class GEOGRAPHICLIB_EXPORT DoubleDouble {
+  private:
+    double _hi, _lo;
+    static DoubleDouble make(double hi, double lo) {
+      DoubleDouble x; x._hi = hi; x._lo = lo; return x;
+    }
+    static bool finite(double x) { return x - x == 0; }
+    // s + e = a + b exactly
+    static double twosum(double a, double b, double& e) {
+      double s = a + b, c = s - a;
+      e = (a - (s - c)) + (b - c);
+      return s;
+    }
+    // s + e = a + b exactly, provided that |a| >= |b| or a = 0
+    static double fasttwosum(double a, double b, double& e) {
+      double s = a + b;
+      e = b - (s - a);
+      return s;
+    }
+    // p + e = a * b exactly (barring underflow)
+    static double twoprod(double a, double b, double& e) {
+      double p = a * b;
+#if defined(FP_FAST_FMA)
+      e = std::fma(a, b, -p);
+#else
+      // Dekker's algorithm, splitting the factors into 26-bit halves
+      const double split = 134217729; // 2^27 + 1
+      double t = split * a, ah = t - (t - a), al = a - ah;
+      t = split * b;
+      double bh = t - (t - b), bl = b - bh;
+      e = ((ah * bh - p) + ah * bl + al * bh) + al * bl;
+#endif
+      return p;
+    }
+    // The normalized sum s + e.  z is the result in double precision, which
+    // supplies the result if s + e overflows or is a NaN, and the sign of a
+    // zero result.
+    static DoubleDouble norm(double s, double e, double z) {
+      double t = fasttwosum(s, e, e);
+      return !finite(t) ? make(z, 0) :
+        (t != 0 ? make(t, e) : make(z == 0 ? z : 0, 0));
+    }
+    long long toll() const;
+    unsigned long long toull() const;
+
+  public:
+    /**
+     * Constructor for an uninitialized number (as for double).
+     **********************************************************************/
+    DoubleDouble() = default;
+    /**
+     * Constructors for the standard arithmetic types.
+     *
+     * @param[in] x the number.
+     *
+     * These are implicit so that expressions mixing DoubleDouble with these
+     * types work as they would for double.  The conversion is exact (except
+     * for integers with more than 106 significant bits).
+     **********************************************************************/
+    constexpr DoubleDouble(double x) : _hi(x), _lo(0) {}
+    /// \cond SKIP
+    constexpr DoubleDouble(float x) : _hi(x), _lo(0) {}
+    constexpr DoubleDouble(int x) : _hi(x), _lo(0) {}
+    constexpr DoubleDouble(unsigned x) : _hi(x), _lo(0) {}
+    DoubleDouble(long x) : DoubleDouble((long long)x) {}
+    DoubleDouble(unsigned long x) : DoubleDouble((unsigned long long)x) {}
+    DoubleDouble(long long x);
+    DoubleDouble(unsigned long long x);
+    DoubleDouble(long double x);
+    /// \endcond
+
+    /**
+     * @return the leading part of the number.
+     **********************************************************************/
+    double hi() const { return _hi; }
+    /**
+     * @return the trailing part of the number.
+     **********************************************************************/
+    double lo() const { return _lo; }
+
+    /**
+     * Conversions to the standard arithmetic types.
+     *
+     * @return the number rounded (for floating point types) or truncated
+     *   towards zero (for integer types).
+     **********************************************************************/
+    explicit operator double() const { return _hi + _lo; }
+    /// \cond SKIP
+    explicit operator float() const { return float(_hi + _lo); }
+    explicit operator long double() const
+    { return (long double)_hi + (long double)_lo; }
+    explicit operator bool() const { return _hi != 0; }
+    explicit operator int() const { return int(toll()); }
+    explicit operator long() const { return long(toll()); }
+    explicit operator long long() const { return toll(); }
+    explicit operator short() const { return short(toll()); }
+    explicit operator char() const { return char(toll()); }
+    explicit operator unsigned() const { return unsigned(toull()); }
+    explicit operator unsigned long() const { return (unsigned long)toull(); }
+    explicit operator unsigned long long() const { return toull(); }
+    explicit operator unsigned short() const
+    { return (unsigned short)toull(); }
+    explicit operator unsigned char() const { return (unsigned char)toull(); }
+    /// \endcond
+
+    /** \name Arithmetic
+     **********************************************************************/
+    ///@{
+    /// \cond SKIP
+    friend DoubleDouble operator+(const DoubleDouble& x)
+    { return x; }
+    friend DoubleDouble operator-(const DoubleDouble& x)
+    { return make(-x._hi, -x._lo); }
+    friend DoubleDouble operator+(const DoubleDouble& x,
+                                  const DoubleDouble& y) {
+      double e, f, s = twosum(x._hi, y._hi, e), t = twosum(x._lo, y._lo, f);
+      e += t;
+      s = fasttwosum(s, e, e);
+      e += f;
+      return norm(s, e, x._hi + y._hi);
+    }
+    friend DoubleDouble operator+(const DoubleDouble& x, double y) {
+      double e, s = twosum(x._hi, y, e);
+      e += x._lo;
+      return norm(s, e, x._hi + y);
+    }
+    friend DoubleDouble operator+(double x, const DoubleDouble& y)
+    { return y + x; }
+    friend DoubleDouble operator-(const DoubleDouble& x,
+                                  const DoubleDouble& y)
+    { return x + -y; }
+    friend DoubleDouble operator-(const DoubleDouble& x, double y)
+    { return x + -y; }
+    friend DoubleDouble operator-(double x, const DoubleDouble& y)
+    { return -y + x; }
+    friend DoubleDouble operator*(const DoubleDouble& x,
+                                  const DoubleDouble& y) {
+      double e, p = twoprod(x._hi, y._hi, e);
+      e += x._hi * y._lo + x._lo * y._hi;
+      return norm(p, e, p);
+    }
+    friend DoubleDouble operator*(const DoubleDouble& x, double y) {
+      double e, p = twoprod(x._hi, y, e);
+      e += x._lo * y;
+      return norm(p, e, p);
+    }
+    friend DoubleDouble operator*(double x, const DoubleDouble& y)
+    { return y * x; }
+    friend DoubleDouble operator/(const DoubleDouble& x,
+                                  const DoubleDouble& y) {
+      // Long division with three quotient digits
+      double q1 = x._hi / y._hi;
+      DoubleDouble r = x - y * q1;
+      double q2 = r._hi / y._hi;
+      r = r - y * q2;
+      double q3 = r._hi / y._hi, e, f;
+      q2 = fasttwosum(q1, q2, e);
+      q2 = twosum(q2, q3, f);
+      return norm(q2, e + f, q1);
+    }
+    /// \endcond
+    /**
+     * Compound assignment operators.
+     *
+     * @param[in] y the other operand.
+     * @return the result.
+     **********************************************************************/
+    DoubleDouble& operator+=(const DoubleDouble& y)
+    { return *this = *this + y; }
+    /// \cond SKIP
+    DoubleDouble& operator-=(const DoubleDouble& y)
+    { return *this = *this - y; }
+    DoubleDouble& operator*=(const DoubleDouble& y)
+    { return *this = *this * y; }
+    DoubleDouble& operator/=(const DoubleDouble& y)
+    { return *this = *this / y; }
+    DoubleDouble& operator+=(double y) { return *this = *this + y; }
+    DoubleDouble& operator-=(double y) { return *this = *this - y; }
+    DoubleDouble& operator*=(double y) { return *this = *this * y; }
+    DoubleDouble& operator++() { return *this += 1.0; }
+    DoubleDouble& operator--() { return *this -= 1.0; }
+    DoubleDouble operator++(int)
+    { DoubleDouble x = *this; ++*this; return x; }
+    DoubleDouble operator--(int)
+    { DoubleDouble x = *this; --*this; return x; }
+    /// \endcond
+    ///@}
+
+    /** \name Comparisons
+     **********************************************************************/
+    ///@{
+    /// \cond SKIP
+    friend bool operator==(const DoubleDouble& x, const DoubleDouble& y)
+    { return x._hi == y._hi && x._lo == y._lo; }
+    friend bool operator!=(const DoubleDouble& x, const DoubleDouble& y)
+    { return !(x == y); }
+    friend bool operator<(const DoubleDouble& x, const DoubleDouble& y)
+    { return x._hi < y._hi || (x._hi == y._hi && x._lo < y._lo); }
+    friend bool operator>(const DoubleDouble& x, const DoubleDouble& y)
+    { return y < x; }
+    friend bool operator<=(const DoubleDouble& x, const DoubleDouble& y)
+    { return x._hi < y._hi || (x._hi == y._hi && x._lo <= y._lo); }
+    friend bool operator>=(const DoubleDouble& x, const DoubleDouble& y)
+    { return y <= x; }
+    /// \endcond
+    ///@}
+
+    /** \name Functions of &lt;cmath&gt; which are computed inline
+     **********************************************************************/
+    ///@{
+    /// \cond SKIP
+    friend bool signbit(const DoubleDouble& x) { return std::signbit(x._hi); }
+    friend bool isnan(const DoubleDouble& x) { return std::isnan(x._hi); }
+    friend bool isinf(const DoubleDouble& x) { return std::isinf(x._hi); }
+    friend bool isfinite(const DoubleDouble& x) { return finite(x._hi); }
+    friend DoubleDouble fabs(const DoubleDouble& x)
+    { return std::signbit(x._hi) ? -x : x; }
+    friend DoubleDouble abs(const DoubleDouble& x) { return fabs(x); }
+    friend DoubleDouble copysign(const DoubleDouble& x, const DoubleDouble& y)
+    { return std::signbit(x._hi) != std::signbit(y._hi) ? -x : x; }
+    friend DoubleDouble fmax(const DoubleDouble& x, const DoubleDouble& y)
+    { return std::isnan(y._hi) || x > y ? x : y; }
+    friend DoubleDouble fmin(const DoubleDouble& x, const DoubleDouble& y)
+    { return std::isnan(y._hi) || x < y ? x : y; }
+    friend DoubleDouble ldexp(const DoubleDouble& x, int e)
+    { double hi = std::ldexp(x._hi, e);
+      return make(hi, finite(hi) ? std::ldexp(x._lo, e) : 0); }
+    friend DoubleDouble frexp(const DoubleDouble& x, int* e) {
+      double hi = std::frexp(x._hi, e), lo = std::ldexp(x._lo, -*e);
+      // Ensure the result is in [1/2, 1) when hi = 1/2 and lo < 0
+      if (std::fabs(hi) == 0.5 && lo * hi < 0) {
+        hi *= 2; lo *= 2; --*e;
+      }
+      return make(hi, lo);
+    }
+    friend DoubleDouble floor(const DoubleDouble& x) {
+      double hi = std::floor(x._hi), lo = 0;
+      if (hi == x._hi) lo = std::floor(x._lo);
+      return norm(hi, lo, hi);
+    }
+    friend DoubleDouble ceil(const DoubleDouble& x) {
+      double hi = std::ceil(x._hi), lo = 0;
+      if (hi == x._hi) lo = std::ceil(x._lo);
+      return norm(hi, lo, hi);
+    }
+    friend DoubleDouble trunc(const DoubleDouble& x)
+    { return std::signbit(x._hi) ? ceil(x) : floor(x); }
+    friend DoubleDouble fma(const DoubleDouble& x, const DoubleDouble& y,
+                            const DoubleDouble& z)
+    { return x * y + z; }
+    friend DoubleDouble sqrt(const DoubleDouble& x) {
+      double y = std::sqrt(x._hi);
+      if (!(x._hi > 0 && finite(x._hi))) return y;
+      // One Newton iteration: y + (x - y^2) / (2*y)
+      double e, p = twoprod(y, y, e),
+        d = (((x._hi - p) - e) + x._lo) * (0.5 / y);
+      y = fasttwosum(y, d, d);
+      return make(y, d);
+    }
+    /// \endcond
+    ///@}
+
+    /** \name Functions of &lt;cmath&gt; which are computed in the library
+     **********************************************************************/
+    ///@{
+    /// \cond SKIP
+    friend GEOGRAPHICLIB_EXPORT DoubleDouble round(const DoubleDouble& x);
+    friend GEOGRAPHICLIB_EXPORT long lround(const DoubleDouble& x);
+    friend GEOGRAPHICLIB_EXPORT DoubleDouble fmod(const DoubleDouble& x,
+                                                  const DoubleDouble& y);
+    friend GEOGRAPHICLIB_EXPORT DoubleDouble remainder(const DoubleDouble& x,
+                                                       const DoubleDouble& y);
+    friend GEOGRAPHICLIB_EXPORT DoubleDouble remquo(const DoubleDouble& x,
+                                                    const DoubleDouble& y,
+                                                    int* q);
+    friend GEOGRAPHICLIB_EXPORT DoubleDouble nextafter(const DoubleDouble& x,
+                                                       const DoubleDouble& y);
+    friend GEOGRAPHICLIB_EXPORT DoubleDouble hypot(const DoubleDouble& x,
+                                                   const DoubleDouble& y);
+    friend GEOGRAPHICLIB_EXPORT DoubleDouble cbrt(const DoubleDouble& x);
+    friend GEOGRAPHICLIB_EXPORT DoubleDouble exp(const DoubleDouble& x);
+    friend GEOGRAPHICLIB_EXPORT DoubleDouble expm1(const DoubleDouble& x);
+    friend GEOGRAPHICLIB_EXPORT DoubleDouble exp2(const DoubleDouble& x);
+    friend GEOGRAPHICLIB_EXPORT DoubleDouble log(const DoubleDouble& x);
+    friend GEOGRAPHICLIB_EXPORT DoubleDouble log1p(const DoubleDouble& x);
+    friend GEOGRAPHICLIB_EXPORT DoubleDouble log2(const DoubleDouble& x);
+    friend GEOGRAPHICLIB_EXPORT DoubleDouble log10(const DoubleDouble& x);
+    friend GEOGRAPHICLIB_EXPORT DoubleDouble pow(const DoubleDouble& x,
+                                                 const DoubleDouble& y);
+    friend GEOGRAPHICLIB_EXPORT DoubleDouble sin(const DoubleDouble& x);
+    friend GEOGRAPHICLIB_EXPORT DoubleDouble cos(const DoubleDouble& x);
+    friend GEOGRAPHICLIB_EXPORT DoubleDouble tan(const DoubleDouble& x);
+    friend GEOGRAPHICLIB_EXPORT DoubleDouble asin(const DoubleDouble& x);
+    friend GEOGRAPHICLIB_EXPORT DoubleDouble acos(const DoubleDouble& x);
+    friend GEOGRAPHICLIB_EXPORT DoubleDouble atan(const DoubleDouble& x);
+    friend GEOGRAPHICLIB_EXPORT DoubleDouble atan2(const DoubleDouble& y,
+                                                   const DoubleDouble& x);
+    friend GEOGRAPHICLIB_EXPORT DoubleDouble sinh(const DoubleDouble& x);
+    friend GEOGRAPHICLIB_EXPORT DoubleDouble cosh(const DoubleDouble& x);
+    friend GEOGRAPHICLIB_EXPORT DoubleDouble tanh(const DoubleDouble& x);
+    friend GEOGRAPHICLIB_EXPORT DoubleDouble asinh(const DoubleDouble& x);
+    friend GEOGRAPHICLIB_EXPORT DoubleDouble acosh(const DoubleDouble& x);
+    friend GEOGRAPHICLIB_EXPORT DoubleDouble atanh(const DoubleDouble& x);
+    /// \endcond
+    ///@}
+
+    /**
+     * Write a number to a stream.
+     *
+     * @param[in,out] os the stream.
+     * @param[in] x the number.
+     * @return \e os.
+     *
+     * The precision and the fixed and scientific flags of \e os are used as
+     * for a double; if neither flag is set, the shorter of the two formats
+     * is used.  The showpos and uppercase flags and the width are also
+     * respected.  Digits beyond the 31st are not significant.
+     **********************************************************************/
+    friend GEOGRAPHICLIB_EXPORT std::ostream&
+    operator<<(std::ostream& os, const DoubleDouble& x);
+
+    /**
+     * Read a number from a stream.
+     *
+     * @param[in,out] is the stream.
+     * @param[out] x the number.
+     * @return \e is.
+     *
+     * The number is an optional sign followed by digits with an optional
+     * decimal point and an optional exponent.  The failbit of \e is is set
+     * if no number can be read.
+     **********************************************************************/
+    friend GEOGRAPHICLIB_EXPORT std::istream&
+    operator>>(std::istream& is, DoubleDouble& x);
+  };
+
+} // namespace GeographicLib
+
+namespace std {
+
+  /**
+   * \brief The limits of DoubleDouble
+   *
+   * The precision is given as 104 bits (instead of 106 bits, the total
+   * length of the two significands) to allow for the errors in the
+   * arithmetic; so epsilon() = 2<sup>&minus;103</sup>.  The range is that
+   * of a double, except that min() is 2<sup>53</sup> times larger so that
+   * the trailing part of a normalized number isn't subnormal.
+   **********************************************************************/
+  template<> class numeric_limits<GeographicLib::DoubleDouble> {
+  private:
+    typedef GeographicLib::DoubleDouble T;
+  public:
+    /// \cond SKIP
+    static constexpr bool is_specialized = true;
+    static constexpr bool is_signed = true;
+    static constexpr bool is_integer = false;
+    static constexpr bool is_exact = false;
+    static constexpr bool has_infinity = true;
+    static constexpr bool has_quiet_NaN = true;
+    static constexpr bool has_signaling_NaN = true;
+    static constexpr float_denorm_style has_denorm = denorm_absent;
+    static constexpr bool has_denorm_loss = false;
+    static constexpr float_round_style round_style = round_to_nearest;
+    static constexpr bool is_iec559 = false;
+    static constexpr bool is_bounded = true;
+    static constexpr bool is_modulo = false;
+    static constexpr int digits = 104;
+    static constexpr int digits10 = 31;
+    static constexpr int max_digits10 = 33;
+    static constexpr int radix = 2;
+    static constexpr int min_exponent = numeric_limits<double>::min_exponent
+      + numeric_limits<double>::digits;
+    static constexpr int min_exponent10 = -291;
+    static constexpr int max_exponent = numeric_limits<double>::max_exponent;
+    static constexpr int max_exponent10 =
+      numeric_limits<double>::max_exponent10;
+    static constexpr bool traps = false;
+    static constexpr bool tinyness_before = false;
+    static constexpr T min() noexcept
+    { return T(2.0041683600089728e-292); } // 2^-969
+    static constexpr T max() noexcept
+    { return T(numeric_limits<double>::max()); }
+    static constexpr T lowest() noexcept
+    { return T(-numeric_limits<double>::max()); }
+    static constexpr T epsilon() noexcept
+    { return T(9.8607613152626476e-32); } // 2^-103
+    static constexpr T round_error() noexcept { return T(0.5); }
+    static constexpr T infinity() noexcept
+    { return T(numeric_limits<double>::infinity()); }
+    static constexpr T quiet_NaN() noexcept
+    { return T(numeric_limits<double>::quiet_NaN()); }
+    static constexpr T signaling_NaN() noexcept
+    { return T(numeric_limits<double>::signaling_NaN()); }
+    static constexpr T denorm_min() noexcept { return min(); }
+    /// \endcond
+  };
+
+} // namespace std
+
+#endif  // GEOGRAPHICLIB_DOUBLEDOUBLE_HPP
@@ -13,7 +13,7 @@
 #include <GeographicLib/Constants.hpp>
 #include <GeographicLib/TransverseMercator.hpp>
 #include <GeographicLib/EllipticFunction.hpp>
-#include <GeographicLib/AlbersEqualArea.hpp>
+#include <GeographicLib/AuxLatitude.hpp>
 
 namespace GeographicLib {
 
@@ -44,7 +44,7 @@ namespace GeographicLib {
     real _a, _f, _f1, _f12, _e2, _es, _e12, _n, _b;
     TransverseMercator _tm;
     EllipticFunction _ell;
-    AlbersEqualArea _au;
+    AuxLatitude _aux;
 
     // These are the alpha and beta coefficients in the Krueger series from
     // TransverseMercator.  Thy are used by RhumbSolve to compute
@@ -52,6 +52,11 @@ namespace GeographicLib {
     const Math::real* ConformalToRectifyingCoeffs() const { return _tm._alp; }
     const Math::real* RectifyingToConformalCoeffs() const { return _tm._bet; }
     friend class Rhumb; friend class RhumbLine;
+    // The batch versions use tabulated elliptic integrals for at least this
+    // many points
+    static const size_t tabmin_ = 256;
+    real Rectifying(const EllipticFunction& ell, real phi) const;
+    real InverseRectifying(const EllipticFunction& ell, real mu) const;
   public:
     /** \name Constructor
      **********************************************************************/
@@ -401,6 +406,92 @@ namespace GeographicLib {
     Math::real NormalCurvatureRadius(real phi, real azi) const;
     ///@}
 
+    /** \name Batch versions of the latitude conversions.
+     **********************************************************************/
+    ///@{
+
+    /**
+     * The auxiliary latitudes for LatitudeBatch and InverseLatitudeBatch.
+     **********************************************************************/
+    enum latitude {
+      /**
+       * Parametric latitude &beta;; see ParametricLatitude.
+       * @hideinitializer
+       **********************************************************************/
+      PARAMETRIC = 0,
+      /**
+       * Geocentric latitude &theta;; see GeocentricLatitude.
+       * @hideinitializer
+       **********************************************************************/
+      GEOCENTRIC = 1,
+      /**
+       * Rectifying latitude &mu;; see RectifyingLatitude.
+       * @hideinitializer
+       **********************************************************************/
+      RECTIFYING = 2,
+      /**
+       * Authalic latitude &xi;; see AuthalicLatitude.
+       * @hideinitializer
+       **********************************************************************/
+      AUTHALIC = 3,
+      /**
+       * Conformal latitude &chi;; see ConformalLatitude.
+       * @hideinitializer
+       **********************************************************************/
+      CONFORMAL = 4,
+      /**
+       * Isometric latitude &psi;; see IsometricLatitude.
+       * @hideinitializer
+       **********************************************************************/
+      ISOMETRIC = 5,
+    };
+
+    /**
+     * Convert several geographic latitudes to an auxiliary latitude.
+     *
+     * @param[in] type an Ellipsoid::latitude giving the auxiliary latitude.
+     * @param[in] n the number of latitudes.
+     * @param[in] phi array of geographic latitudes (degrees).
+     * @param[out] eta array of auxiliary latitudes (degrees).
+     *
+     * This is equivalent to calling ParametricLatitude, RectifyingLatitude,
+     * etc., in a loop.  The arrays have (at least) \e n elements and \e eta
+     * may be the same array as \e phi.  For \e type = RECTIFYING and large \e
+     * n, the elliptic integral is evaluated with a Fourier series (see
+     * EllipticFunction::Tabulate) and the results agree with the scalar
+     * versions to within a few ulps; otherwise the results are identical.
+     **********************************************************************/
+    void LatitudeBatch(int type, size_t n, const real phi[],
+                       real eta[]) const;
+
+    /**
+     * Convert several auxiliary latitudes to geographic latitudes.
+     *
+     * @param[in] type an Ellipsoid::latitude giving the auxiliary latitude.
+     * @param[in] n the number of latitudes.
+     * @param[in] eta array of auxiliary latitudes (degrees).
+     * @param[out] phi array of geographic latitudes (degrees).
+     *
+     * This is equivalent to calling InverseParametricLatitude,
+     * InverseRectifyingLatitude, etc., in a loop, with the same proviso on the
+     * accuracy for \e type = RECTIFYING as LatitudeBatch.
+     **********************************************************************/
+    void InverseLatitudeBatch(int type, size_t n, const real eta[],
+                              real phi[]) const;
+
+    /**
+     * Compute several meridian distances.
+     *
+     * @param[in] n the number of latitudes.
+     * @param[in] phi array of geographic latitudes (degrees).
+     * @param[out] s array of distances from the equator (meters).
+     *
+     * This is equivalent to calling MeridianDistance in a loop, with the same
+     * proviso on the accuracy as LatitudeBatch with \e type = RECTIFYING.
+     **********************************************************************/
+    void MeridianDistanceBatch(size_t n, const real phi[], real s[]) const;
+    ///@}
+
     /** \name Eccentricity conversions.
      **********************************************************************/
     ///@{
@@ -10,7 +10,11 @@
 #if !defined(GEOGRAPHICLIB_ELLIPTICFUNCTION_HPP)
 #define GEOGRAPHICLIB_ELLIPTICFUNCTION_HPP 1
 
+#include <vector>
 #include <GeographicLib/Constants.hpp>
+#if GEOGRAPHICLIB_INSTRUMENT
+#include <GeographicLib/Histogram.hpp>
+#endif
 
 namespace GeographicLib {
 
@@ -65,8 +69,22 @@ namespace GeographicLib {
     typedef Math::real real;
 
     enum { num_ = 13 }; // Max depth required for sncndn; probably 5 is enough.
+    // The number of arguments processed together by the batch functions
+    static const int batchsize_ = 8;
     real _k2, _kp2, _alpha2, _alphap2, _eps;
     real _kKc, _eEc, _dDc, _pPic, _gGc, _hHc;
+    // If _tab, Fourier coefficients for deltaF, deltaE, and deltaEinv (see
+    // DST::sinefit); each is empty if the fit failed.
+    bool _tab;
+    std::vector<real> _cF, _cE, _cEinv;
+#if GEOGRAPHICLIB_INSTRUMENT
+    mutable Histogram _einviterations;
+#endif
+    void Fit();
+    // The Landen transformation for sncndn, which depends only on _kp2
+    unsigned Landen(real m[], real n[], real& c, real& d) const;
+    // RF(x, y) and RG(x, y) with a single AGM iteration
+    static void RFG(real x, real y, real& rf, real& rg);
   public:
     /** \name Constructor
      **********************************************************************/
@@ -88,6 +106,7 @@ namespace GeographicLib {
      * D(&phi;, \e k).
      **********************************************************************/
     EllipticFunction(real k2 = 0, real alpha2 = 0)
+      : _tab(false)
       { Reset(k2, alpha2); }
 
     /**
@@ -110,6 +129,7 @@ namespace GeographicLib {
      * \e k is very close to unity.
      **********************************************************************/
     EllipticFunction(real k2, real alpha2, real kp2, real alphap2)
+      : _tab(false)
       { Reset(k2, alpha2, kp2, alphap2); }
 
     /**
@@ -147,11 +167,36 @@ namespace GeographicLib {
      **********************************************************************/
     void Reset(real k2, real alpha2, real kp2, real alphap2);
 
+    /**
+     * Tabulate the periodic parts of the integrals of the first and second
+     * kinds.
+     *
+     * @param[in] tabulate whether to tabulate (default true).
+     *
+     * With \e tabulate = true, the functions deltaF, deltaE, and deltaEinv
+     * are fit with Fourier series (using DST::sinefit) now and whenever the
+     * modulus is changed with Reset.  These series are then used to evaluate
+     * the delta functions and also F(&phi;), E(&phi;), and Einv(\e x); each
+     * evaluation is then a short Clenshaw sum instead of the iterative
+     * evaluation of an integral.  This is worthwhile if many evaluations are
+     * needed with a fixed modulus.  The fits cost about 500 evaluations of
+     * the integrals.  If a series doesn't converge with 256 terms (as happens
+     * for \e k<sup>2</sup> close to 1), the corresponding functions are
+     * evaluated directly.  The results agree with the direct evaluation to
+     * within a few ulps.
+     **********************************************************************/
+    void Tabulate(bool tabulate = true);
+
     ///@}
 
     /** \name Inspector functions.
      **********************************************************************/
     ///@{
+    /**
+     * @return whether the periodic functions are tabulated; see Tabulate.
+     **********************************************************************/
+    bool Tabulated() const { return _tab; }
+
     /**
      * @return the square of the modulus <i>k</i><sup>2</sup>.
      **********************************************************************/
@@ -709,6 +754,92 @@ namespace GeographicLib {
     static real RD(real x, real y, real z);
     ///@}
 
+    /** \name Batch versions of the elliptic functions and integrals.
+     *
+     * These give the same results as calling the corresponding functions for
+     * each argument.  The arguments are processed in batches with the
+     * iterations for the arguments in a batch done in lockstep; an argument
+     * which has converged is carried along unchanged until all the arguments
+     * in the batch have converged.  The arithmetic is arranged in loops over
+     * the batch which the compiler can vectorize.  The output arrays may
+     * coincide with the input arrays.
+     **********************************************************************/
+    ///@{
+    /**
+     * The Jacobi elliptic functions for several arguments.
+     *
+     * @param[in] n the number of arguments.
+     * @param[in] x array of arguments.
+     * @param[out] sn array of sn(\e x, \e k).
+     * @param[out] cn array of cn(\e x, \e k).
+     * @param[out] dn array of dn(\e x, \e k).
+     *
+     * The Landen transformation, which depends only on \e k, is carried out
+     * once for all the arguments.
+     **********************************************************************/
+    void sncndnBatch(size_t n, const real x[],
+                     real sn[], real cn[], real dn[]) const;
+
+    /**
+     * <i>R</i><sub><i>F</i></sub> for several arguments.
+     *
+     * @param[in] n the number of arguments.
+     * @param[in] x array of first arguments.
+     * @param[in] y array of second arguments.
+     * @param[in] z array of third arguments.
+     * @param[out] rf array of <i>R</i><sub><i>F</i></sub>(\e x, \e y, \e z).
+     **********************************************************************/
+    static void RFBatch(size_t n, const real x[], const real y[],
+                        const real z[], real rf[]);
+
+    /**
+     * <i>R</i><sub><i>D</i></sub> for several arguments.
+     *
+     * @param[in] n the number of arguments.
+     * @param[in] x array of first arguments.
+     * @param[in] y array of second arguments.
+     * @param[in] z array of third arguments.
+     * @param[out] rd array of <i>R</i><sub><i>D</i></sub>(\e x, \e y, \e z).
+     **********************************************************************/
+    static void RDBatch(size_t n, const real x[], const real y[],
+                        const real z[], real rd[]);
+
+    /**
+     * <i>R</i><sub><i>J</i></sub> for several arguments.
+     *
+     * @param[in] n the number of arguments.
+     * @param[in] x array of first arguments.
+     * @param[in] y array of second arguments.
+     * @param[in] z array of third arguments.
+     * @param[in] p array of fourth arguments.
+     * @param[out] rj array of <i>R</i><sub><i>J</i></sub>(\e x, \e y, \e z,
+     *   \e p).
+     *
+     * The evaluations of <i>R</i><sub><i>C</i></sub> needed at each step are
+     * done separately for each argument.
+     **********************************************************************/
+    static void RJBatch(size_t n, const real x[], const real y[],
+                        const real z[], const real p[], real rj[]);
+    ///@}
+
+#if GEOGRAPHICLIB_INSTRUMENT
+    /** \name Solver statistics (only if GEOGRAPHICLIB_INSTRUMENT = 1)
+     **********************************************************************/
+    ///@{
+    /**
+     * @return a histogram of the number of Newton iterations in the calls to
+     *   Einv() which don't use the tabulated Fourier series.
+     **********************************************************************/
+    const Histogram& EinvIterations() const { return _einviterations; }
+
+    /**
+     * Reset the statistics.  Turning on tabulation (which calls Einv() to make
+     * the fit) also resets them.
+     **********************************************************************/
+    void ResetStatistics() const { _einviterations.Reset(); }
+    ///@}
+#endif
+
   };
 
 } // namespace GeographicLib
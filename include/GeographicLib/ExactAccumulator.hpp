@@ -0,0 +1,211 @@
+/**
+ * \file ExactAccumulator.hpp
+ * \brief Header for GeographicLib::ExactAccumulator class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_EXACTACCUMULATOR_HPP)
+#define GEOGRAPHICLIB_EXACTACCUMULATOR_HPP 1
+
+#include <GeographicLib/Accumulator.hpp>
+#include <vector>
+
+namespace GeographicLib {
+
+  /**
+   * \brief An exact accumulator for sums
+   *
+   * This holds the sum of numbers of floating point type \e T exactly as a
+   * fixed-point number with 30-bit limbs held in 64-bit integers (a
+   * "superaccumulator").  The range of the limbs grows as needed, so this
+   * works for any floating point type (including the multi-precision
+   * types).  Because the sum is exact, it doesn't depend on the order in
+   * which the numbers are added; so partial sums computed on several threads
+   * can be combined with merge and the result is the same, bit for bit,
+   * however the work was divided.  In contrast, the result of Accumulator
+   * depends (in the last bits) on the order of the additions.
+   *
+   * The value is only rounded to \e T when it is read with operator()(),
+   * and this rounding depends only on the exact sum.  Infinities and NaNs
+   * are accumulated separately (in ordinary floating point arithmetic, which
+   * is also independent of the order).
+   *
+   * Adding a number costs a few integer additions per 30 bits of its
+   * precision, roughly twice the cost of Accumulator.
+   *
+   * Example of use:
+   * \code
+   * // Sum in parallel; the result doesn't depend on the number of threads
+   * ExactAccumulator<> total;
+   * std::mutex m;
+   * GeodesicBatchExecutor(nthreads).ForEach(n, [&](size_t i0, size_t i1) {
+   *   ExactAccumulator<> part;
+   *   part.Add(x + i0, i1 - i0);
+   *   std::lock_guard<std::mutex> lock(m);
+   *   total.merge(part);
+   * });
+   * double sum = total();
+   * \endcode
+   **********************************************************************/
+  template<typename T = Math::real>
+  class GEOGRAPHICLIB_EXPORT ExactAccumulator {
+  private:
+    typedef long long limb_t;
+    // The number of bits in a limb and the number of additions (each of less
+    // than 2^bits_ to a limb) allowed before the limbs must be normalized.
+    static const int bits_ = 30;
+    static const limb_t base_ = limb_t(1) << bits_;
+    static const limb_t maxadd_ = limb_t(1) << 31;
+    // The sum is sum(_d[i] * 2^(bits_ * (i + _k0))) + _special.
+    std::vector<limb_t> _d;
+    int _k0;
+    limb_t _nadd;
+    T _special;
+    // floor(e / bits_)
+    static int limbindex(int e) {
+      return e >= 0 ? e / bits_ : -((-e + bits_ - 1) / bits_);
+    }
+    // Extend _d to include limbs [k0, k1]
+    void extend(int k0, int k1) {
+      if (_d.empty()) {
+        _k0 = k0;
+        _d.assign(k1 - k0 + 1, 0);
+        return;
+      }
+      if (k0 < _k0) {
+        _d.insert(_d.begin(), _k0 - k0, 0);
+        _k0 = k0;
+      }
+      if (k1 >= _k0 + int(_d.size()))
+        _d.resize(k1 - _k0 + 1, 0);
+    }
+    // Propagate the carries so that all the limbs except the top one are in
+    // [0, 2^bits_) and the top one is in (-2^bits_, 2^bits_)
+    void normalize() {
+      for (size_t i = 0; i + 1 < _d.size(); ++i) {
+        limb_t r = _d[i] & (base_ - 1);
+        _d[i + 1] += (_d[i] - r) / base_;
+        _d[i] = r;
+      }
+      while (!_d.empty() && (_d.back() >= base_ || _d.back() <= -base_)) {
+        limb_t r = _d.back() & (base_ - 1), q = (_d.back() - r) / base_;
+        _d.back() = r;
+        _d.push_back(q);
+      }
+      _nadd = 0;
+    }
+    void Add(T y) {
+      using std::frexp; using std::ldexp; using std::trunc;
+      using std::isfinite;
+      if (y == 0) return;
+      if (!isfinite(y)) { _special += y; return; }
+      if (_nadd >= maxadd_) normalize();
+      ++_nadd;
+      int e;
+      frexp(y, &e);             // |y| < 2^e
+      // Peel off bits_ bits at a time starting at the most significant limb;
+      // each subtraction is exact.
+      int k = limbindex(e - 1);
+      for (; y != 0; --k) {
+        T c = trunc(ldexp(y, -bits_ * k));
+        y -= ldexp(c, bits_ * k);
+        if (c != 0) {
+          extend(k, k);
+          _d[k - _k0] += limb_t(c);
+        }
+      }
+    }
+  public:
+    /**
+     * Constructor from a \e T.
+     *
+     * @param[in] y set \e sum = \e y.
+     **********************************************************************/
+    ExactAccumulator(T y = T(0)) : _k0(0), _nadd(0), _special(0) {
+      static_assert(!std::numeric_limits<T>::is_integer,
+                    "ExactAccumulator type is not floating point");
+      Add(y);
+    }
+    /**
+     * @return the value of the \e sum rounded to \e T.
+     *
+     * The result depends only on the exact value of the \e sum.
+     **********************************************************************/
+    T operator()() const {
+      using std::ldexp;
+      if (_special != 0 || _special != _special) return _special;
+      ExactAccumulator a(*this);
+      a.normalize();
+      while (!a._d.empty() && a._d.back() == 0) a._d.pop_back();
+      if (a._d.empty()) return T(0);
+      bool neg = a._d.back() < 0;
+      if (neg) {
+        for (limb_t& d : a._d) d = -d;
+        a.normalize();
+      }
+      // The limbs are now all non-negative; add them starting at the least
+      // significant end.
+      Accumulator<T> s;
+      for (size_t i = 0; i < a._d.size(); ++i)
+        s += ldexp(T(a._d[i]), bits_ * (int(i) + a._k0));
+      return neg ? -s() : s();
+    }
+    /**
+     * Add a number to the accumulator.
+     *
+     * @param[in] y set \e sum += \e y.
+     **********************************************************************/
+    ExactAccumulator& operator+=(T y) { Add(y); return *this; }
+    /**
+     * Subtract a number from the accumulator.
+     *
+     * @param[in] y set \e sum -= \e y.
+     **********************************************************************/
+    ExactAccumulator& operator-=(T y) { Add(-y); return *this; }
+    /**
+     * Add an array of numbers to the accumulator.
+     *
+     * @param[in] y the array of numbers.
+     * @param[in] n the number of elements of \e y.
+     * @return a reference to the accumulator.
+     **********************************************************************/
+    ExactAccumulator& Add(const T y[], size_t n) {
+      for (size_t i = 0; i < n; ++i) Add(y[i]);
+      return *this;
+    }
+    /**
+     * Add another accumulator to this one.
+     *
+     * @param[in] a the other accumulator.
+     * @return a reference to this accumulator.
+     *
+     * The result is exact, so the partial sums of a parallel computation can
+     * be merged in any order.
+     **********************************************************************/
+    ExactAccumulator& merge(const ExactAccumulator& a) {
+      if (&a == this) {
+        ExactAccumulator b(a);
+        return merge(b);
+      }
+      _special += a._special;
+      if (a._d.empty()) return *this;
+      if (_nadd >= maxadd_) normalize();
+      if (a._nadd >= maxadd_) {
+        ExactAccumulator b(a);
+        b.normalize();
+        return merge(b);
+      }
+      extend(a._k0, a._k0 + int(a._d.size()) - 1);
+      for (size_t i = 0; i < a._d.size(); ++i)
+        _d[i + (a._k0 - _k0)] += a._d[i];
+      _nadd += a._nadd + 1;
+      return *this;
+    }
+  };
+
+} // namespace GeographicLib
+
+#endif  // GEOGRAPHICLIB_EXACTACCUMULATOR_HPP
@@ -12,6 +12,8 @@
 
 #include <GeographicLib/UTMUPS.hpp>
 #include <GeographicLib/Constants.hpp>
+#include <atomic>
+#include <thread>
 
 namespace GeographicLib {
 
@@ -32,6 +34,16 @@ namespace GeographicLib {
    * The mutable state consists of the UTM or UPS coordinates for a alternate
    * zone.  A method SetAltZone is provided to set the alternate UPS/UTM zone.
    *
+   * If the latitude and longitude are given (and the standard zone is used),
+   * the UTM/UPS coordinates, convergence, and scale are only computed when
+   * they are first needed; so converting between geographic representations
+   * costs little.  The alternate zone data is likewise copied on first
+   * access.  The deferred data is filled in by the first thread needing it
+   * (any other thread needing it waits), so a GeoCoords object may be
+   * queried concurrently by several threads.  However SetAltZone and
+   * SetAltZoneBatch change the object, so they must not be called while it
+   * is in use by another thread.
+   *
    * Methods are provided to return the geographic coordinates, the input UTM
    * or UPS coordinates (and associated meridian convergence and scale), or
    * alternate UTM or UPS coordinates (and their associated meridian
@@ -49,22 +61,72 @@ namespace GeographicLib {
   class GEOGRAPHICLIB_EXPORT GeoCoords {
   private:
     typedef Math::real real;
-    real _lat, _long, _easting, _northing, _gamma, _k;
+    real _lat, _long;
+    mutable real _easting, _northing, _gamma, _k;
     bool _northp;
     int _zone;                  // See UTMUPS::zonespec
+    // The states of the deferred data
+    enum { READY = 0, PENDING = 1, BUSY = 2 };
+    // _utmstate: whether _easting, _northing, _gamma, _k have been computed
+    // _altstate: PENDING means the alternate zone data is a copy of the
+    // primary data which hasn't been made yet
+    mutable std::atomic<int> _utmstate, _altstate;
     mutable real _alt_easting, _alt_northing, _alt_gamma, _alt_k;
     mutable int _alt_zone;
 
+    // Fill in deferred data by calling f, unless state is READY.  Only one
+    // thread calls f; any others wait until it's done.
+    template<class F>
+    static void Fill(std::atomic<int>& state, const F& f) {
+      while (true) {
+        int s = state.load(std::memory_order_acquire);
+        if (s == READY) return;
+        if (s == PENDING &&
+            state.compare_exchange_weak(s, BUSY, std::memory_order_acquire,
+                                        std::memory_order_relaxed)) {
+          try {
+            f();
+          }
+          catch (...) {
+            state.store(PENDING, std::memory_order_release);
+            throw;
+          }
+          state.store(READY, std::memory_order_release);
+          return;
+        }
+        std::this_thread::yield();
+      }
+    }
+    void Compute() const {
+      Fill(_utmstate, [this]() -> void {
+        int zone;
+        bool northp;
+        UTMUPS::Forward(_lat, _long, zone, northp,
+                        _easting, _northing, _gamma, _k, _zone);
+      });
+    }
     void CopyToAlt() const {
-      _alt_easting = _easting;
-      _alt_northing = _northing;
-      _alt_gamma = _gamma;
-      _alt_k = _k;
-      _alt_zone = _zone;
+      Fill(_altstate, [this]() -> void {
+        Compute();
+        _alt_easting = _easting;
+        _alt_northing = _northing;
+        _alt_gamma = _gamma;
+        _alt_k = _k;
+        _alt_zone = _zone;
+      });
+    }
+    // Set the states in a non-const member function (or one, like
+    // SetAltZone, documented as changing the object)
+    void SetStates(int utm, int alt) const {
+      _utmstate.store(utm, std::memory_order_relaxed);
+      _altstate.store(alt, std::memory_order_relaxed);
     }
     static void UTMUPSString(int zone, bool northp,
                              real easting, real northing,
                              int prec, bool abbrev, std::string& utm);
+    static size_t UTMUPSString(int zone, bool northp,
+                               real easting, real northing,
+                               int prec, bool abbrev, char utm[], size_t n);
     void FixHemisphere();
   public:
 
@@ -83,7 +145,53 @@ namespace GeographicLib {
       , _k(Math::NaN())
       , _northp(false)
       , _zone(UTMUPS::INVALID)
-    { CopyToAlt(); }
+      , _utmstate(READY)
+      , _altstate(PENDING)
+    {}
+
+    /**
+     * The copy constructor.
+     *
+     * @param[in] g the GeoCoords object to copy.
+     *
+     * Data which \e g hasn't computed yet is left to be computed by the copy.
+     **********************************************************************/
+    GeoCoords(const GeoCoords& g)
+      : _utmstate(PENDING)
+      , _altstate(PENDING)
+    { *this = g; }
+
+    /**
+     * The assignment operator.
+     *
+     * @param[in] g the GeoCoords object to copy.
+     * @return a reference to this object.
+     **********************************************************************/
+    GeoCoords& operator=(const GeoCoords& g) {
+      if (this == &g) return *this;
+      _lat = g._lat;
+      _long = g._long;
+      _northp = g._northp;
+      _zone = g._zone;
+      int utm = g._utmstate.load(std::memory_order_acquire),
+        alt = g._altstate.load(std::memory_order_acquire);
+      if (utm == READY) {
+        _easting = g._easting;
+        _northing = g._northing;
+        _gamma = g._gamma;
+        _k = g._k;
+      }
+      if (alt == READY) {
+        _alt_easting = g._alt_easting;
+        _alt_northing = g._alt_northing;
+        _alt_gamma = g._alt_gamma;
+        _alt_k = g._alt_k;
+        _alt_zone = g._alt_zone;
+      }
+      SetStates(utm == READY ? READY : PENDING,
+                alt == READY ? READY : PENDING);
+      return *this;
+    }
 
     /**
      * Construct from a string.
@@ -221,6 +329,27 @@ namespace GeographicLib {
      * @exception GeographicErr if the \e s is malformed.
      **********************************************************************/
     void Reset(const std::string& s,
+               bool centerp = true, bool longfirst = false) {
+      Reset(s.data(), s.size(), centerp, longfirst);
+    }
+
+    /**
+     * Reset the location from a string given as a character array.
+     *
+     * @param[in] s pointer to the characters of the 1-element, 2-element, or
+     *   3-element string representation of the position.
+     * @param[in] len the number of characters (the string need not be null
+     *   terminated).
+     * @param[in] centerp governs the interpretation of MGRS coordinates.
+     * @param[in] longfirst governs the interpretation of geographic
+     *   coordinates.
+     * @exception GeographicErr if the \e s is malformed.
+     *
+     * This is the same as Reset(const std::string&, bool, bool).  The string
+     * is split into its elements in place; an MGRS coordinate is then
+     * decoded without allocating memory.
+     **********************************************************************/
+    void Reset(const char* s, size_t len,
                bool centerp = true, bool longfirst = false);
 
     /**
@@ -235,14 +364,7 @@ namespace GeographicLib {
      *   90&deg;].
      * @exception GeographicErr if \e zone cannot be used for this location.
      **********************************************************************/
-    void Reset(real latitude, real longitude, int zone = UTMUPS::STANDARD) {
-      UTMUPS::Forward(latitude, longitude,
-                      _zone, _northp, _easting, _northing, _gamma, _k,
-                      zone);
-      _lat = latitude;
-      _long = Math::AngNormalize(longitude);
-      CopyToAlt();
-    }
+    void Reset(real latitude, real longitude, int zone = UTMUPS::STANDARD);
 
     /**
      * Reset the location in terms of UPS/UPS coordinates.  See
@@ -263,7 +385,7 @@ namespace GeographicLib {
       _easting = easting;
       _northing = northing;
       FixHemisphere();
-      CopyToAlt();
+      SetStates(READY, PENDING);
     }
     ///@}
 
@@ -283,22 +405,22 @@ namespace GeographicLib {
     /**
      * @return easting (meters)
      **********************************************************************/
-    Math::real Easting() const { return _easting; }
+    Math::real Easting() const { Compute(); return _easting; }
 
     /**
      * @return northing (meters)
      **********************************************************************/
-    Math::real Northing() const { return _northing; }
+    Math::real Northing() const { Compute(); return _northing; }
 
     /**
      * @return meridian convergence (degrees) for the UTM/UPS projection.
      **********************************************************************/
-    Math::real Convergence() const { return _gamma; }
+    Math::real Convergence() const { Compute(); return _gamma; }
 
     /**
      * @return scale for the UTM/UPS projection.
      **********************************************************************/
-    Math::real Scale() const { return _k; }
+    Math::real Scale() const { Compute(); return _k; }
 
     /**
      * @return hemisphere (false means south, true means north).
@@ -337,40 +459,66 @@ namespace GeographicLib {
         return;
       zone = UTMUPS::StandardZone(_lat, _long, zone);
       if (zone == _zone)
-        CopyToAlt();
-      else {
+        _altstate.store(PENDING, std::memory_order_relaxed);
+      else if (_altstate.load(std::memory_order_relaxed) != READY ||
+               zone != _alt_zone) {
         bool northp;
         UTMUPS::Forward(_lat, _long,
                         _alt_zone, northp,
                         _alt_easting, _alt_northing, _alt_gamma, _alt_k,
                         zone);
+        _altstate.store(READY, std::memory_order_relaxed);
       }
     }
 
+    /**
+     * Specify the alternate zone for several GeoCoords objects.
+     *
+     * @param[in] n the number of objects.
+     * @param[in] p array of GeoCoords objects.
+     * @param[in] zone zone number for the alternate representation.
+     * @exception std::bad_alloc if the memory for the temporary arrays can't
+     *   be allocated.
+     *
+     * This has the same effect as calling p[\e i].SetAltZone(\e zone) for
+     * each \e i and also computes the deferred UTM/UPS coordinates needed
+     * by the alternate representations.  The points are projected with
+     * UTMUPS::ForwardBatch, so this is faster than converting the objects
+     * one at a time; e.g., GeoConvert uses it for the lines read in blocks.
+     * An object for which SetAltZone would throw an exception is left
+     * unchanged; calling SetAltZone(\e zone) afterwards then throws the
+     * exception, while for the other objects it costs little.
+     **********************************************************************/
+    static void SetAltZoneBatch(size_t n, const GeoCoords p[],
+                                int zone = UTMUPS::STANDARD);
+
     /**
      * @return current alternate zone (return 0 for UPS).
      **********************************************************************/
-    int AltZone() const { return _alt_zone; }
+    int AltZone() const {
+      return _altstate.load(std::memory_order_acquire) == READY ?
+        _alt_zone : _zone;
+    }
 
     /**
      * @return easting (meters) for alternate zone.
      **********************************************************************/
-    Math::real AltEasting() const { return _alt_easting; }
+    Math::real AltEasting() const { CopyToAlt(); return _alt_easting; }
 
     /**
      * @return northing (meters) for alternate zone.
      **********************************************************************/
-    Math::real AltNorthing() const { return _alt_northing; }
+    Math::real AltNorthing() const { CopyToAlt(); return _alt_northing; }
 
     /**
      * @return meridian convergence (degrees) for alternate zone.
      **********************************************************************/
-    Math::real AltConvergence() const { return _alt_gamma; }
+    Math::real AltConvergence() const { CopyToAlt(); return _alt_gamma; }
 
     /**
      * @return scale for alternate zone.
      **********************************************************************/
-    Math::real AltScale() const { return _alt_k; }
+    Math::real AltScale() const { CopyToAlt(); return _alt_k; }
     ///@}
 
     /** \name String representations of the GeoCoords object
@@ -518,6 +666,131 @@ namespace GeographicLib {
                                         bool abbrev = true) const;
     ///@}
 
+    /** \name Representations in character arrays
+     *
+     * These are the same as the corresponding functions returning a
+     * std::string except that the result is written as a null-terminated
+     * string to the character array \e s of size \e n and the length of the
+     * string is returned.  The numbers are formatted with the char array
+     * versions of Utility::str and DMS::Encode (which use snprintf instead
+     * of an ostringstream), and no memory is allocated.  An exception is
+     * thrown if \e s is too small; a size of 64 suffices (unless
+     * GEOGRAPHICLIB_PRECISION is greater than 3, in which case the numbers
+     * are formatted as strings with Utility::str and copied into \e s).
+     **********************************************************************/
+    ///@{
+    /**
+     * See GeoRepresentation(int, bool) const.
+     *
+     * @param[in] prec precision (relative to about 1m).
+     * @param[in] longfirst if true give longitude first.
+     * @param[out] s the character array for the result.
+     * @param[in] n the size of \e s.
+     * @exception GeographicErr if \e s is too small.
+     * @return the length of the string.
+     **********************************************************************/
+    size_t GeoRepresentation(int prec, bool longfirst, char s[], size_t n)
+      const;
+
+    /**
+     * See DMSRepresentation(int, bool, char) const.
+     *
+     * @param[in] prec precision (relative to about 1m).
+     * @param[in] longfirst if true give longitude first.
+     * @param[in] dmssep if non-null, use as the DMS separator character.
+     * @param[out] s the character array for the result.
+     * @param[in] n the size of \e s.
+     * @exception GeographicErr if \e s is too small.
+     * @return the length of the string.
+     **********************************************************************/
+    size_t DMSRepresentation(int prec, bool longfirst, char dmssep,
+                             char s[], size_t n) const;
+
+    /**
+     * See MGRSRepresentation(int) const.
+     *
+     * @param[in] prec precision (relative to about 1m).
+     * @param[out] s the character array for the result.
+     * @param[in] n the size of \e s.
+     * @exception GeographicErr if \e s is too small.
+     * @return the length of the string.
+     **********************************************************************/
+    size_t MGRSRepresentation(int prec, char s[], size_t n) const;
+
+    /**
+     * See UTMUPSRepresentation(int, bool) const.
+     *
+     * @param[in] prec precision (relative to about 1m)
+     * @param[in] abbrev if true use abbreviated (n/s) notation for
+     *   hemisphere; otherwise spell out the hemisphere (north/south)
+     * @param[out] s the character array for the result.
+     * @param[in] n the size of \e s.
+     * @exception GeographicErr if \e s is too small.
+     * @return the length of the string.
+     **********************************************************************/
+    size_t UTMUPSRepresentation(int prec, bool abbrev, char s[], size_t n)
+      const;
+
+    /**
+     * See UTMUPSRepresentation(bool, int, bool) const.
+     *
+     * @param[in] northp hemisphere override
+     * @param[in] prec precision (relative to about 1m)
+     * @param[in] abbrev if true use abbreviated (n/s) notation for
+     *   hemisphere; otherwise spell out the hemisphere (north/south)
+     * @param[out] s the character array for the result.
+     * @param[in] n the size of \e s.
+     * @exception GeographicErr if the hemisphere override attempts to change
+     *   UPS N to UPS S or vice versa.
+     * @exception GeographicErr if \e s is too small.
+     * @return the length of the string.
+     **********************************************************************/
+    size_t UTMUPSRepresentation(bool northp, int prec, bool abbrev,
+                                char s[], size_t n) const;
+
+    /**
+     * See AltMGRSRepresentation(int) const.
+     *
+     * @param[in] prec precision (relative to about 1m).
+     * @param[out] s the character array for the result.
+     * @param[in] n the size of \e s.
+     * @exception GeographicErr if \e s is too small.
+     * @return the length of the string.
+     **********************************************************************/
+    size_t AltMGRSRepresentation(int prec, char s[], size_t n) const;
+
+    /**
+     * See AltUTMUPSRepresentation(int, bool) const.
+     *
+     * @param[in] prec precision (relative to about 1m)
+     * @param[in] abbrev if true use abbreviated (n/s) notation for
+     *   hemisphere; otherwise spell out the hemisphere (north/south)
+     * @param[out] s the character array for the result.
+     * @param[in] n the size of \e s.
+     * @exception GeographicErr if \e s is too small.
+     * @return the length of the string.
+     **********************************************************************/
+    size_t AltUTMUPSRepresentation(int prec, bool abbrev, char s[], size_t n)
+      const;
+
+    /**
+     * See AltUTMUPSRepresentation(bool, int, bool) const.
+     *
+     * @param[in] northp hemisphere override
+     * @param[in] prec precision (relative to about 1m)
+     * @param[in] abbrev if true use abbreviated (n/s) notation for
+     *   hemisphere; otherwise spell out the hemisphere (north/south)
+     * @param[out] s the character array for the result.
+     * @param[in] n the size of \e s.
+     * @exception GeographicErr if the hemisphere override attempts to change
+     *   UPS n to UPS s or vice verse.
+     * @exception GeographicErr if \e s is too small.
+     * @return the length of the string.
+     **********************************************************************/
+    size_t AltUTMUPSRepresentation(bool northp, int prec, bool abbrev,
+                                   char s[], size_t n) const;
+    ///@}
+
     /** \name Inspector functions
      **********************************************************************/
     ///@{
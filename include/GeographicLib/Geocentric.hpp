@@ -68,13 +68,27 @@ namespace GeographicLib {
   private:
     typedef Math::real real;
     friend class LocalCartesian;
+    friend class LocalCartesianSet; // LocalCartesianSet uses Rotation
     friend class MagneticCircle; // MagneticCircle uses Rotation
     friend class MagneticModel;  // MagneticModel uses IntForward
+    friend class MagneticSnapshot; // MagneticSnapshot uses IntForward
     friend class GravityCircle;  // GravityCircle uses Rotation
     friend class GravityModel;   // GravityModel uses IntForward
     friend class NormalGravity;  // NormalGravity uses IntForward
     static const size_t dim_ = 3;
     static const size_t dim2_ = dim_ * dim_;
+    // The number of points processed together by ForwardBatch and
+    // ReverseBatch
+    static const int batchsize_ = 8;
+    template<typename T>
+    void IntForwardBatch(size_t n, const T lat[], const T lon[], const T h[],
+                         T X[], T Y[], T Z[], real M[]) const;
+    template<typename U>
+    void IntReverseBatch(size_t n, const U X[], const U Y[], const U Z[],
+                         U lat[], U lon[], U h[], real M[]) const;
+    template<typename U>
+    void IntReverseFastBatch(size_t n, const U X[], const U Y[], const U Z[],
+                             U lat[], U lon[], U h[], real M[]) const;
     real _a, _f, _e2, _e2m, _e2a, _e4a, _maxrad;
     static void Rotation(real sphi, real cphi, real slam, real clam,
                          real M[dim2_]);
@@ -234,6 +248,173 @@ namespace GeographicLib {
         IntReverse(X, Y, Z, lat, lon, h, NULL);
     }
 
+    /**
+     * Convert several points from geodetic to geocentric coordinates.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lat array of latitudes (degrees).
+     * @param[in] lon array of longitudes (degrees).
+     * @param[in] h array of heights above the ellipsoid (meters).
+     * @param[out] X array of geocentric coordinates (meters).
+     * @param[out] Y array of geocentric coordinates (meters).
+     * @param[out] Z array of geocentric coordinates (meters).
+     * @param[out] M (optional) array of size 9\e n to receive the rotation
+     *   matrices in row-major order; the matrix for point \e i starts at \e
+     *   M + 9\e i.
+     *
+     * This gives the same results as calling Forward for each point.  The
+     * points are processed in batches with the arithmetic for the points in
+     * a batch arranged so that the compiler can vectorize it.  If \e M is
+     * omitted (or nullptr), the rotation matrices are not computed.  The
+     * output arrays may coincide with the input arrays.
+     **********************************************************************/
+    void ForwardBatch(size_t n, const real lat[], const real lon[],
+                      const real h[], real X[], real Y[], real Z[],
+                      real M[] = nullptr) const;
+
+    /**
+     * Convert several points from geocentric to geodetic coordinates.
+     *
+     * @param[in] n the number of points.
+     * @param[in] X array of geocentric coordinates (meters).
+     * @param[in] Y array of geocentric coordinates (meters).
+     * @param[in] Z array of geocentric coordinates (meters).
+     * @param[out] lat array of latitudes (degrees).
+     * @param[out] lon array of longitudes (degrees).
+     * @param[out] h array of heights above the ellipsoid (meters).
+     * @param[out] M (optional) array of size 9\e n to receive the rotation
+     *   matrices in row-major order; the matrix for point \e i starts at \e
+     *   M + 9\e i.
+     *
+     * This gives the same results as calling Reverse for each point; see
+     * ForwardBatch.  The closed-form solution is evaluated for the points in
+     * a batch together for all points except those very close to the center
+     * of the earth (or very far away) which are handled individually.
+     **********************************************************************/
+    void ReverseBatch(size_t n, const real X[], const real Y[],
+                      const real Z[], real lat[], real lon[], real h[],
+                      real M[] = nullptr) const;
+
+    /**
+     * Convert from geocentric to geodetic coordinates approximately.
+     *
+     * @param[in] X geocentric coordinate (meters).
+     * @param[in] Y geocentric coordinate (meters).
+     * @param[in] Z geocentric coordinate (meters).
+     * @param[out] lat latitude of point (degrees).
+     * @param[out] lon longitude of point (degrees).
+     * @param[out] h height of point above the ellipsoid (meters).
+     *
+     * This uses a single step of Bowring's method, starting with the
+     * improved estimate of the parametric latitude given in B. R. Bowring,
+     * <a href="https://doi.org/10.1179/sre.1985.28.218.202">The accuracy of
+     * geodetic latitude and height equations</a>, Survey Review 28,
+     * 202--206 (1985), and computes the height with Bowring's formula.  This
+     * involves only square roots and so is considerably faster than Reverse.
+     * For the WGS84 ellipsoid, the errors compared with Reverse are less
+     * than 2 &mu;m in the horizontal position and 10 nm in the height for
+     * |\e h| < 100 km, and the horizontal error grows to about 1 cm at \e h
+     * = &minus;5000 km; this is ample for data held in floats.  Points within
+     * \e a/2 of the center of the earth (or very far away) and all points for
+     * a prolate ellipsoid are handled by Reverse.
+     **********************************************************************/
+    void ReverseFast(real X, real Y, real Z, real& lat, real& lon, real& h)
+      const;
+
+    /**
+     * Convert several points from geocentric to geodetic coordinates
+     * approximately.
+     *
+     * @param[in] n the number of points.
+     * @param[in] X array of geocentric coordinates (meters).
+     * @param[in] Y array of geocentric coordinates (meters).
+     * @param[in] Z array of geocentric coordinates (meters).
+     * @param[out] lat array of latitudes (degrees).
+     * @param[out] lon array of longitudes (degrees).
+     * @param[out] h array of heights above the ellipsoid (meters).
+     * @param[out] M (optional) array of size 9\e n to receive the rotation
+     *   matrices in row-major order.
+     *
+     * This gives the same results as calling ReverseFast for each point; see
+     * ForwardBatch.  Only the conversions of the angles to degrees aren't
+     * vectorized.
+     **********************************************************************/
+    void ReverseFastBatch(size_t n, const real X[], const real Y[],
+                          const real Z[], real lat[], real lon[], real h[],
+                          real M[] = nullptr) const;
+
+#if GEOGRAPHICLIB_PRECISION != 1
+    /**
+     * Convert several points given as floats from geodetic to geocentric
+     * coordinates.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lat array of latitudes (degrees).
+     * @param[in] lon array of longitudes (degrees).
+     * @param[in] h array of heights above the ellipsoid (meters).
+     * @param[out] X array of geocentric coordinates (meters).
+     * @param[out] Y array of geocentric coordinates (meters).
+     * @param[out] Z array of geocentric coordinates (meters).
+     * @param[out] M (optional) array of size 9\e n to receive the rotation
+     *   matrices.
+     *
+     * This is the same as the other version of ForwardBatch except that the
+     * data is held in floats, which halves the memory traffic for large
+     * numbers of points.  The computations are carried out with reals and
+     * the results are rounded to floats; the results are the same as
+     * calling Forward with the inputs converted to reals and rounding the
+     * outputs.  A float carries about 7 significant digits, so the
+     * geocentric coordinates are only given to about 0.5 m.  This function
+     * is not available if the library is compiled with
+     * GEOGRAPHICLIB_PRECISION = 1 (since then real is float).
+     **********************************************************************/
+    void ForwardBatch(size_t n, const float lat[], const float lon[],
+                      const float h[], float X[], float Y[], float Z[],
+                      real M[] = nullptr) const;
+
+    /**
+     * Convert several points given as floats from geocentric to geodetic
+     * coordinates.
+     *
+     * @param[in] n the number of points.
+     * @param[in] X array of geocentric coordinates (meters).
+     * @param[in] Y array of geocentric coordinates (meters).
+     * @param[in] Z array of geocentric coordinates (meters).
+     * @param[out] lat array of latitudes (degrees).
+     * @param[out] lon array of longitudes (degrees).
+     * @param[out] h array of heights above the ellipsoid (meters).
+     * @param[out] M (optional) array of size 9\e n to receive the rotation
+     *   matrices.
+     *
+     * This is the same as the other version of ReverseBatch except that the
+     * data is held in floats; see the float version of ForwardBatch.
+     **********************************************************************/
+    void ReverseBatch(size_t n, const float X[], const float Y[],
+                      const float Z[], float lat[], float lon[], float h[],
+                      real M[] = nullptr) const;
+
+    /**
+     * Convert several points given as floats from geocentric to geodetic
+     * coordinates approximately.
+     *
+     * @param[in] n the number of points.
+     * @param[in] X array of geocentric coordinates (meters).
+     * @param[in] Y array of geocentric coordinates (meters).
+     * @param[in] Z array of geocentric coordinates (meters).
+     * @param[out] lat array of latitudes (degrees).
+     * @param[out] lon array of longitudes (degrees).
+     * @param[out] h array of heights above the ellipsoid (meters).
+     * @param[out] M (optional) array of size 9\e n to receive the rotation
+     *   matrices.
+     *
+     * This is the same as the other version of ReverseFastBatch except that
+     * the data is held in floats; see the float version of ForwardBatch.
+     **********************************************************************/
+    void ReverseFastBatch(size_t n, const float X[], const float Y[],
+                          const float Z[], float lat[], float lon[],
+                          float h[], real M[] = nullptr) const;
+#endif
+
     /** \name Inspector functions
      **********************************************************************/
     ///@{
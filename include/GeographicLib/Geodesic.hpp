@@ -11,11 +11,17 @@
 #define GEOGRAPHICLIB_GEODESIC_HPP 1
 
 #include <GeographicLib/Constants.hpp>
+#include <GeographicLib/StridedView.hpp>
+#if GEOGRAPHICLIB_INSTRUMENT
+#include <GeographicLib/Histogram.hpp>
+#endif
 
 #if !defined(GEOGRAPHICLIB_GEODESIC_ORDER)
 /**
- * The order of the expansions used by Geodesic.
- * GEOGRAPHICLIB_GEODESIC_ORDER can be set to any integer in [3, 8].
+ * The default order of the expansions used by Geodesic.
+ * GEOGRAPHICLIB_GEODESIC_ORDER can be set to any integer in [3, 8].  A
+ * different order can be selected at run time with the \e order argument to
+ * the Geodesic constructor.
  **********************************************************************/
 #  define GEOGRAPHICLIB_GEODESIC_ORDER \
   (GEOGRAPHICLIB_PRECISION == 2 ? 6 : \
@@ -26,6 +32,7 @@
 namespace GeographicLib {
 
   class GeodesicLine;
+  class GeodesicBatchExecutor;
 
   /**
    * \brief %Geodesic calculations
@@ -173,23 +180,34 @@ namespace GeographicLib {
   private:
     typedef Math::real real;
     friend class GeodesicLine;
-    static const int nA1_ = GEOGRAPHICLIB_GEODESIC_ORDER;
-    static const int nC1_ = GEOGRAPHICLIB_GEODESIC_ORDER;
-    static const int nC1p_ = GEOGRAPHICLIB_GEODESIC_ORDER;
-    static const int nA2_ = GEOGRAPHICLIB_GEODESIC_ORDER;
-    static const int nC2_ = GEOGRAPHICLIB_GEODESIC_ORDER;
-    static const int nA3_ = GEOGRAPHICLIB_GEODESIC_ORDER;
-    static const int nA3x_ = nA3_;
-    static const int nC3_ = GEOGRAPHICLIB_GEODESIC_ORDER;
-    static const int nC3x_ = (nC3_ * (nC3_ - 1)) / 2;
-    static const int nC4_ = GEOGRAPHICLIB_GEODESIC_ORDER;
-    static const int nC4x_ = (nC4_ * (nC4_ + 1)) / 2;
+    friend class GeodesicBatchExecutor;
+    // The order of the series, _order, is picked at run time from [3, nmax_];
+    // the coefficient arrays are sized for the largest order.
+    static const int nmax_ = 8;
+    static_assert(GEOGRAPHICLIB_GEODESIC_ORDER >= 3 &&
+                  GEOGRAPHICLIB_GEODESIC_ORDER <= nmax_,
+                  "Bad value for GEOGRAPHICLIB_GEODESIC_ORDER");
+    static const int nA3x_ = nmax_;
+    // Sizes for the coefficients of A1m1, A2m1 and C1, C1p, C2 (polynomials
+    // in eps^2, independent of n)
+    static const int nAx_ = nmax_ / 2 + 1;
+    static const int nCx_ = (nmax_ * nmax_ + 3 * nmax_ - 2 * (nmax_ / 2)) / 4;
+    static const int nC3x_ = (nmax_ * (nmax_ - 1)) / 2;
+    static const int nC4x_ = (nmax_ * (nmax_ + 1)) / 2;
     // Size for temporary array
-    // nC = max(max(nC1_, nC1p_, nC2_) + 1, max(nC3_, nC4_))
-    static const int nC_ = GEOGRAPHICLIB_GEODESIC_ORDER + 1;
+    static const int nC_ = nmax_ + 1;
     static const unsigned maxit1_ = 20;
     unsigned maxit2_;
     real tiny_, tol0_, tol1_, tol2_, tolb_, xthresh_;
+    // Relative accuracy of the fast tier
+    static real fasttol() { return real(1e-9); }
+    bool _fast;
+    real _tolv;               // Convergence criterion for the Newton iteration
+    int _order;
+#if GEOGRAPHICLIB_INSTRUMENT
+    mutable Histogram _inversepaths, _inverseiterations, _inversebisections,
+      _withinpaths;
+#endif
 
     enum captype {
       CAP_NONE = 0U,
@@ -210,6 +228,7 @@ namespace GeographicLib {
 
     real _a, _f, _f1, _e2, _ep2, _n, _b, _c2, _etol2;
     real _aA3x[nA3x_], _cC3x[nC3x_], _cC4x[nC4x_];
+    real _aA1m1x[nAx_], _cC1x[nCx_], _cC1px[nCx_], _aA2m1x[nAx_], _cC2x[nCx_];
 
     void Lengths(real eps, real sig12,
                  real ssig1, real csig1, real dn1,
@@ -222,7 +241,7 @@ namespace GeographicLib {
                       real lam12, real slam12, real clam12,
                       real& salp1, real& calp1,
                       real& salp2, real& calp2, real& dnm,
-                      real Ca[]) const;
+                      bool warm, real Ca[]) const;
     real Lambda12(real sbet1, real cbet1, real dn1,
                   real sbet2, real cbet2, real dn2,
                   real salp1, real calp1, real slam120, real clam120,
@@ -234,14 +253,65 @@ namespace GeographicLib {
                     unsigned outmask, real& s12,
                     real& salp1, real& calp1, real& salp2, real& calp2,
                     real& m12, real& M12, real& M21, real& S12) const;
+    // The data for an end point of an inverse problem which doesn't depend on
+    // the other end point: the rounded latitude, the longitude, the sine and
+    // cosine of the reduced latitude, and sqrt(1 + ep2 * sbet^2).
+    struct invpoint { real lat, lon, sbet, cbet, dn; };
+    invpoint InversePoint(real lat, real lon) const;
+    // If warm, salp1, calp1, salp2, calp2 hold a guess for the solution on
+    // input.
+    real GenInverse(const invpoint& P1, const invpoint& P2,
+                    unsigned outmask, real& s12,
+                    real& salp1, real& calp1, real& salp2, real& calp2,
+                    real& m12, real& M12, real& M21, real& S12,
+                    bool warm = false) const;
+    real GenInverse(const invpoint& P1, const invpoint& P2,
+                    unsigned outmask,
+                    real& s12, real& azi1, real& azi2,
+                    real& m12, real& M12, real& M21, real& S12) const;
+    // lat2 = lon2 = null signals the symmetric case; exec = null means don't
+    // use threads.
+    void IntDistanceMatrix(size_t n, const real lat1[], const real lon1[],
+                           size_t m, const real lat2[], const real lon2[],
+                           real s12[],
+                           const GeodesicBatchExecutor* exec) const;
+    // T is the type of the elements; CA and A are the types of the input and
+    // output arrays, pointers or StridedViews.
+    template<typename T, class CA, class A>
+    void IntDirectBatch(size_t n, CA lat1, CA lon1, CA azi1,
+                        bool arcmode, CA s12_a12, unsigned outmask,
+                        A a12, A lat2, A lon2, A azi2,
+                        A s12, A m12, A M12, A M21, A S12) const;
+    template<typename T, class CA, class A>
+    void IntInverseBatch(size_t n, CA lat1, CA lon1, CA lat2, CA lon2,
+                         unsigned outmask,
+                         A a12, A s12, A azi1, A azi2,
+                         A m12, A M12, A M21, A S12,
+                         // If not null, use this for point 1 (lat1 and lon1
+                         // are then not used)
+                         const invpoint* P1 = nullptr) const;
+    // exec = null means don't use threads.
+    void IntDirectFan(real lat1, real lon1,
+                      size_t na, const real azi1[],
+                      size_t nd, bool arcmode, const real s12_a12[],
+                      unsigned outmask,
+                      real a12[], real lat2[], real lon2[], real azi2[],
+                      real s12[], real m12[], real M12[], real M21[],
+                      real S12[], const GeodesicBatchExecutor* exec) const;
 
     // These are Maxima generated functions to provide series approximations to
-    // the integrals for the ellipsoidal geodesic.
-    static real A1m1f(real eps);
-    static void C1f(real eps, real c[]);
-    static void C1pf(real eps, real c[]);
-    static real A2m1f(real eps);
-    static void C2f(real eps, real c[]);
+    // the integrals for the ellipsoidal geodesic.  The coefficients for the
+    // order of the series are divided by their divisors in the constructor.
+    void A1m1coeff();
+    real A1m1f(real eps) const;
+    void C1coeff();
+    void C1f(real eps, real c[]) const;
+    void C1pcoeff();
+    void C1pf(real eps, real c[]) const;
+    void A2m1coeff();
+    real A2m1f(real eps) const;
+    void C2coeff();
+    void C2f(real eps, real c[]) const;
 
     void A3coeff();
     real A3f(real eps) const;
@@ -338,10 +408,45 @@ namespace GeographicLib {
      * @param[in] a equatorial radius (meters).
      * @param[in] f flattening of ellipsoid.  Setting \e f = 0 gives a sphere.
      *   Negative \e f gives a prolate ellipsoid.
+     * @param[in] fast if true, solve the inverse problem to a relative
+     *   accuracy of about 10<sup>&minus;9</sup> instead of to full precision
+     *   (default false).
+     * @param[in] order the order of the series expansions, an integer in [3,
+     *   8] (default GEOGRAPHICLIB_GEODESIC_ORDER).
      * @exception GeographicErr if \e a or (1 &minus; \e f) \e a is not
      *   positive.
+     * @exception GeographicErr if \e order is not in [3, 8].
+     *
+     * With \e fast = true, the inverse problem (and hence InverseLine and the
+     * polygon area calculations) is solved with
+     * - the closed-form auxiliary sphere solution used for very short lines
+     *   extended to arc lengths &sigma;<sub>12</sub> up to
+     *   (12&times;10<sup>&minus;9</sup>/|<i>f</i>|)<sup>1/3</sup> (about 95 km
+     *   for WGS84); the error in this solution grows as
+     *   &sigma;<sub>12</sub><sup>3</sup>;
+     * - a Newton iteration which stops once the longitude misfit is less
+     *   than 10<sup>&minus;9</sup> radians and omits the confirming
+     *   iteration.
+     * .
+     * For WGS84, the maximum errors are then about 7 mm in \e s12 and \e
+     * m12 and 10<sup>&minus;5</sup>&deg; in the azimuths; short lines (less
+     * than 95 km) are computed about 2.3 times faster and long lines about
+     * 1.3 times faster.  The error in the azimuths leads to errors of up to
+     * 10<sup>7</sup> m<sup>2</sup> in \e S12, so the fast tier should not be
+     * used for area calculations.  The direct problem is not affected.
+     *
+     * The series for the distance, the longitude, and the area are truncated
+     * at order \e order in the third flattening \e n.  For doubles, the
+     * default order is 6, which gives full accuracy for |\e f| &le; 1/150;
+     * higher orders reduce the errors for larger flattenings.  Lower orders
+     * are faster but less accurate: for WGS84, \e order = 3 gives errors
+     * of 8 &mu;m in \e s12 and 8000 m<sup>2</sup> in \e S12
+     * (and is about 10% faster), while \e order = 4 gives full accuracy in
+     * \e s12 and an error of 12 m<sup>2</sup> in \e S12.  GeodesicLine and
+     * PolygonArea objects built from this Geodesic use the same order.
      **********************************************************************/
-    Geodesic(real a, real f);
+    Geodesic(real a, real f, bool fast = false,
+             int order = GEOGRAPHICLIB_GEODESIC_ORDER);
     ///@}
 
     /** \name Direct geodesic problem specified in terms of distance.
@@ -637,6 +742,184 @@ namespace GeographicLib {
                          real& lat2, real& lon2, real& azi2,
                          real& s12, real& m12, real& M12, real& M21,
                          real& S12) const;
+
+    /**
+     * Solve several direct geodesic problems.
+     *
+     * @param[in] n the number of problems to solve.
+     * @param[in] lat1 array of latitudes of point 1 (degrees).
+     * @param[in] lon1 array of longitudes of point 1 (degrees).
+     * @param[in] azi1 array of azimuths at point 1 (degrees).
+     * @param[in] arcmode boolean flag determining the meaning of \e s12_a12.
+     * @param[in] s12_a12 array of distances (meters) between point 1 and point
+     *   2, if \e arcmode is false, or of arc lengths (degrees), if \e arcmode
+     *   is true.
+     * @param[in] outmask a bitor'ed combination of Geodesic::mask values
+     *   specifying which of the following arrays should be set.
+     * @param[out] a12 array of arc lengths from point 1 to point 2 (degrees).
+     * @param[out] lat2 array of latitudes of point 2 (degrees).
+     * @param[out] lon2 array of longitudes of point 2 (degrees).
+     * @param[out] azi2 array of (forward) azimuths at point 2 (degrees).
+     * @param[out] s12 array of distances from point 1 to point 2 (meters).
+     * @param[out] m12 array of reduced lengths of the geodesics (meters).
+     * @param[out] M12 array of geodesic scales of point 2 relative to point 1
+     *   (dimensionless).
+     * @param[out] M21 array of geodesic scales of point 1 relative to point 2
+     *   (dimensionless).
+     * @param[out] S12 array of areas under the geodesics (meters<sup>2</sup>).
+     *
+     * All the arrays have (at least) \e n elements.  Element \e i of the
+     * outputs is the result which Geodesic::GenDirect returns for element \e i
+     * of the inputs; so the results are identical to those obtained by calling
+     * Geodesic::GenDirect in a loop.  Any of the output arrays may be null, in
+     * which case the corresponding quantity is not computed.  \e a12 is always
+     * computed; it is stored if \e a12 is not null.  The output arrays should
+     * not alias the input arrays.
+     *
+     * To compute several points along a single geodesic, use
+     * GeodesicLine::PositionBatch instead.
+     **********************************************************************/
+    void DirectBatch(size_t n,
+                     const real lat1[], const real lon1[], const real azi1[],
+                     bool arcmode, const real s12_a12[], unsigned outmask,
+                     real a12[], real lat2[], real lon2[], real azi2[],
+                     real s12[], real m12[], real M12[], real M21[],
+                     real S12[]) const;
+
+#if GEOGRAPHICLIB_PRECISION != 1
+    /**
+     * Solve several direct geodesic problems with the data given as floats.
+     *
+     * @param[in] n the number of problems to solve.
+     * @param[in] lat1 array of latitudes of point 1 (degrees).
+     * @param[in] lon1 array of longitudes of point 1 (degrees).
+     * @param[in] azi1 array of azimuths at point 1 (degrees).
+     * @param[in] arcmode boolean flag determining the meaning of \e s12_a12.
+     * @param[in] s12_a12 array of distances or arc lengths.
+     * @param[in] outmask a bitor'ed combination of Geodesic::mask values
+     *   specifying which of the following arrays should be set.
+     * @param[out] a12 array of arc lengths from point 1 to point 2 (degrees).
+     * @param[out] lat2 array of latitudes of point 2 (degrees).
+     * @param[out] lon2 array of longitudes of point 2 (degrees).
+     * @param[out] azi2 array of (forward) azimuths at point 2 (degrees).
+     * @param[out] s12 array of distances from point 1 to point 2 (meters).
+     * @param[out] m12 array of reduced lengths of the geodesics (meters).
+     * @param[out] M12 array of geodesic scales of point 2 relative to point 1
+     *   (dimensionless).
+     * @param[out] M21 array of geodesic scales of point 1 relative to point 2
+     *   (dimensionless).
+     * @param[out] S12 array of areas under the geodesics (meters<sup>2</sup>).
+     *
+     * This is the same as the other version of DirectBatch except that the
+     * data is held in floats, which halves the memory traffic for large
+     * numbers of problems.  Each problem is solved with reals and the
+     * results are rounded to floats.  A float carries about 7 significant
+     * digits, so positions and distances are only given to about 1 m.  This
+     * function is not available if the library is compiled
+     * with GEOGRAPHICLIB_PRECISION = 1 (since then real is float).
+     **********************************************************************/
+    void DirectBatch(size_t n,
+                     const float lat1[], const float lon1[],
+                     const float azi1[],
+                     bool arcmode, const float s12_a12[], unsigned outmask,
+                     float a12[], float lat2[], float lon2[], float azi2[],
+                     float s12[], float m12[], float M12[], float M21[],
+                     float S12[]) const;
+#endif
+
+    /**
+     * Solve several direct geodesic problems with the data in strided
+     * arrays.
+     *
+     * @param[in] n the number of problems to solve.
+     * @param[in] lat1 view of the latitudes of point 1 (degrees).
+     * @param[in] lon1 view of the longitudes of point 1 (degrees).
+     * @param[in] azi1 view of the azimuths at point 1 (degrees).
+     * @param[in] arcmode boolean flag determining the meaning of \e s12_a12.
+     * @param[in] s12_a12 view of the distances or arc lengths.
+     * @param[in] outmask a bitor'ed combination of Geodesic::mask values
+     *   specifying which of the following arrays should be set.
+     * @param[out] a12 view of the arc lengths (degrees).
+     * @param[out] lat2 view of the latitudes of point 2 (degrees).
+     * @param[out] lon2 view of the longitudes of point 2 (degrees).
+     * @param[out] azi2 view of the (forward) azimuths at point 2 (degrees).
+     * @param[out] s12 view of the distances (meters).
+     * @param[out] m12 view of the reduced lengths (meters).
+     * @param[out] M12 view of the geodesic scales of point 2 relative to
+     *   point 1 (dimensionless).
+     * @param[out] M21 view of the geodesic scales of point 1 relative to
+     *   point 2 (dimensionless).
+     * @param[out] S12 view of the areas under the geodesics
+     *   (meters<sup>2</sup>).
+     *
+     * This is the same as the other version of DirectBatch except that the
+     * arrays are StridedView objects, so that, e.g., interleaved
+     * coordinates can be read and written in place.
+     **********************************************************************/
+    void DirectBatch(size_t n,
+                     StridedView<const real> lat1,
+                     StridedView<const real> lon1,
+                     StridedView<const real> azi1,
+                     bool arcmode, StridedView<const real> s12_a12,
+                     unsigned outmask,
+                     StridedView<real> a12, StridedView<real> lat2,
+                     StridedView<real> lon2, StridedView<real> azi2,
+                     StridedView<real> s12, StridedView<real> m12,
+                     StridedView<real> M12, StridedView<real> M21,
+                     StridedView<real> S12) const;
+
+    /**
+     * Solve the direct geodesic problems from a single point for all the
+     * combinations of several azimuths and several distances.
+     *
+     * @param[in] lat1 latitude of point 1 (degrees).
+     * @param[in] lon1 longitude of point 1 (degrees).
+     * @param[in] na the number of azimuths.
+     * @param[in] azi1 array of azimuths at point 1 (degrees).
+     * @param[in] nd the number of distances.
+     * @param[in] arcmode boolean flag determining the meaning of \e s12_a12.
+     * @param[in] s12_a12 array of distances (meters) between point 1 and point
+     *   2, if \e arcmode is false, or of arc lengths (degrees), if \e arcmode
+     *   is true.
+     * @param[in] outmask a bitor'ed combination of Geodesic::mask values
+     *   specifying which of the following arrays should be set.
+     * @param[out] a12 array of arc lengths from point 1 to point 2 (degrees).
+     * @param[out] lat2 array of latitudes of point 2 (degrees).
+     * @param[out] lon2 array of longitudes of point 2 (degrees).
+     * @param[out] azi2 array of (forward) azimuths at point 2 (degrees).
+     * @param[out] s12 array of distances from point 1 to point 2 (meters).
+     * @param[out] m12 array of reduced lengths of the geodesics (meters).
+     * @param[out] M12 array of geodesic scales of point 2 relative to point 1
+     *   (dimensionless).
+     * @param[out] M21 array of geodesic scales of point 1 relative to point 2
+     *   (dimensionless).
+     * @param[out] S12 array of areas under the geodesics (meters<sup>2</sup>).
+     *
+     * The output arrays have (at least) \e na &times; \e nd elements and
+     * element \e i * \e nd + \e j is the result which Geodesic::GenDirect
+     * returns for azimuth \e i and distance \e j; so the results are
+     * identical to those obtained by calling Geodesic::GenDirect in a double
+     * loop.  The treatment of the output arrays is the same as for
+     * DirectBatch.
+     *
+     * This is the efficient way to draw range rings (with the azimuths
+     * spanning the circle) or the spokes of an isochrone.  The reduced
+     * latitude of point 1 is computed once; a GeodesicLine is constructed
+     * for each azimuth and the points at all the distances along it are
+     * given by GeodesicLine::PositionBatch.  Use
+     * GeodesicBatchExecutor::DirectFan to divide the azimuths among several
+     * threads.
+     **********************************************************************/
+    void DirectFan(real lat1, real lon1,
+                   size_t na, const real azi1[],
+                   size_t nd, bool arcmode, const real s12_a12[],
+                   unsigned outmask,
+                   real a12[], real lat2[], real lon2[], real azi2[],
+                   real s12[], real m12[], real M12[], real M21[],
+                   real S12[]) const {
+      IntDirectFan(lat1, lon1, na, azi1, nd, arcmode, s12_a12, outmask,
+                   a12, lat2, lon2, azi2, s12, m12, M12, M21, S12, nullptr);
+    }
     ///@}
 
     /** \name Inverse geodesic problem.
@@ -798,6 +1081,372 @@ namespace GeographicLib {
                           unsigned outmask,
                           real& s12, real& azi1, real& azi2,
                           real& m12, real& M12, real& M21, real& S12) const;
+
+    /**
+     * The general inverse geodesic calculation starting from a guess.
+     *
+     * @param[in] lat1 latitude of point 1 (degrees).
+     * @param[in] lon1 longitude of point 1 (degrees).
+     * @param[in] lat2 latitude of point 2 (degrees).
+     * @param[in] lon2 longitude of point 2 (degrees).
+     * @param[in] outmask a bitor'ed combination of Geodesic::mask values
+     *   specifying which of the following parameters should be set.
+     * @param[out] s12 distance from point 1 to point 2 (meters).
+     * @param[in,out] azi1 on input, a guess for the azimuth at point 1; on
+     *   output, the azimuth at point 1 (degrees).
+     * @param[in,out] azi2 on input, a guess for the azimuth at point 2; on
+     *   output, the (forward) azimuth at point 2 (degrees).
+     * @param[out] m12 reduced length of geodesic (meters).
+     * @param[out] M12 geodesic scale of point 2 relative to point 1
+     *   (dimensionless).
+     * @param[out] M21 geodesic scale of point 1 relative to point 2
+     *   (dimensionless).
+     * @param[out] S12 area under the geodesic (meters<sup>2</sup>).
+     * @return \e a12 arc length from point 1 to point 2 (degrees).
+     *
+     * This is the same as GenInverse except that Newton's method starts from
+     * the guess for the azimuths instead of from an approximate solution
+     * (which, for nearly antipodal points, entails solving the astroid
+     * problem).  This is useful when solving a sequence of problems which
+     * differ only a little from one another, e.g., between consecutive
+     * positions of a vehicle and a fixed point; the azimuths from the
+     * previous solution are then a good guess.  \e azi1 and \e azi2 are
+     * always set (regardless of \e outmask), so they can be passed to the
+     * next call unchanged.  Both guesses are needed because the calculation
+     * may swap the end points; if a guess is nan (or a poor guess is
+     * given), the result is the same as for GenInverse.  Otherwise the result
+     * agrees with GenInverse to within roundoff.  The guess is not used for
+     * meridional, equatorial, or very short geodesics, for which Newton's
+     * method isn't needed.
+     **********************************************************************/
+    Math::real GenInverseWarm(real lat1, real lon1, real lat2, real lon2,
+                              unsigned outmask,
+                              real& s12, real& azi1, real& azi2,
+                              real& m12, real& M12, real& M21, real& S12)
+      const;
+
+    /**
+     * Solve the inverse geodesic problem starting from a guess.
+     *
+     * @param[in] lat1 latitude of point 1 (degrees).
+     * @param[in] lon1 longitude of point 1 (degrees).
+     * @param[in] lat2 latitude of point 2 (degrees).
+     * @param[in] lon2 longitude of point 2 (degrees).
+     * @param[out] s12 distance from point 1 to point 2 (meters).
+     * @param[in,out] azi1 on input, a guess for the azimuth at point 1; on
+     *   output, the azimuth at point 1 (degrees).
+     * @param[in,out] azi2 on input, a guess for the azimuth at point 2; on
+     *   output, the (forward) azimuth at point 2 (degrees).
+     * @return \e a12 arc length from point 1 to point 2 (degrees).
+     *
+     * See GenInverseWarm.
+     **********************************************************************/
+    Math::real InverseWarm(real lat1, real lon1, real lat2, real lon2,
+                           real& s12, real& azi1, real& azi2) const {
+      real t;
+      return GenInverseWarm(lat1, lon1, lat2, lon2, DISTANCE,
+                            s12, azi1, azi2, t, t, t, t);
+    }
+
+    /**
+     * Test whether two points are closer than a given distance.
+     *
+     * @param[in] lat1 latitude of point 1 (degrees).
+     * @param[in] lon1 longitude of point 1 (degrees).
+     * @param[in] lat2 latitude of point 2 (degrees).
+     * @param[in] lon2 longitude of point 2 (degrees).
+     * @param[in] R the distance (meters).
+     * @return whether the distance between the points is less than \e R.
+     *
+     * In terms of the reduced latitude and the longitude, the metric of the
+     * ellipsoid lies between those of spheres with radii \e a and \e b.  So
+     * the great circle distance on the auxiliary sphere, which is cheap to
+     * compute, gives lower and upper bounds on the distance.  Only if \e R
+     * lies between these bounds (i.e., the distance is within about |\e f| of
+     * \e R) is the full inverse problem solved.  This makes this function
+     * several times faster than Inverse for typical geofencing applications.
+     * The result is the same as comparing \e s12 returned by Inverse with \e
+     * R except, possibly, if they agree to within the accuracy of Inverse.
+     * If GEOGRAPHICLIB_INSTRUMENT = 1, WithinPaths() counts how often the
+     * bounds decide the result.
+     **********************************************************************/
+    bool WithinDistance(real lat1, real lon1, real lat2, real lon2, real R)
+      const;
+    ///@}
+
+    /** \name Batch version of inverse geodesic solution.
+     **********************************************************************/
+    ///@{
+    /**
+     * Solve several inverse geodesic problems.
+     *
+     * @param[in] n the number of problems to solve.
+     * @param[in] lat1 array of latitudes of point 1 (degrees).
+     * @param[in] lon1 array of longitudes of point 1 (degrees).
+     * @param[in] lat2 array of latitudes of point 2 (degrees).
+     * @param[in] lon2 array of longitudes of point 2 (degrees).
+     * @param[in] outmask a bitor'ed combination of Geodesic::mask values
+     *   specifying which of the following arrays should be set.
+     * @param[out] a12 array of arc lengths between point 1 and point 2
+     *   (degrees).
+     * @param[out] s12 array of distances between point 1 and point 2
+     *   (meters).
+     * @param[out] azi1 array of azimuths at point 1 (degrees).
+     * @param[out] azi2 array of (forward) azimuths at point 2 (degrees).
+     * @param[out] m12 array of reduced lengths of the geodesics (meters).
+     * @param[out] M12 array of geodesic scales of point 2 relative to point 1
+     *   (dimensionless).
+     * @param[out] M21 array of geodesic scales of point 1 relative to point 2
+     *   (dimensionless).
+     * @param[out] S12 array of areas under the geodesics
+     *   (meters<sup>2</sup>).
+     *
+     * All the arrays have (at least) \e n elements.  The input arrays are
+     * visited in order and element \e i of the outputs is the result which
+     * Geodesic::GenInverse returns for element \e i of the inputs; so the
+     * results are identical to those obtained by calling Geodesic::GenInverse
+     * in a loop.  Any of the output arrays may be null, in which case the
+     * corresponding quantity is not computed (as if its bit were removed
+     * from \e outmask).  \e a12 is always computed; it is stored if \e a12
+     * is not null.  The output arrays should not alias the input arrays.
+     **********************************************************************/
+    void InverseBatch(size_t n,
+                      const real lat1[], const real lon1[],
+                      const real lat2[], const real lon2[],
+                      unsigned outmask,
+                      real a12[], real s12[], real azi1[], real azi2[],
+                      real m12[], real M12[], real M21[], real S12[]) const;
+
+#if GEOGRAPHICLIB_PRECISION != 1
+    /**
+     * Solve several inverse geodesic problems with the data given as floats.
+     *
+     * @param[in] n the number of problems to solve.
+     * @param[in] lat1 array of latitudes of point 1 (degrees).
+     * @param[in] lon1 array of longitudes of point 1 (degrees).
+     * @param[in] lat2 array of latitudes of point 2 (degrees).
+     * @param[in] lon2 array of longitudes of point 2 (degrees).
+     * @param[in] outmask a bitor'ed combination of Geodesic::mask values
+     *   specifying which of the following arrays should be set.
+     * @param[out] a12 array of arc lengths between point 1 and point 2
+     *   (degrees).
+     * @param[out] s12 array of distances between point 1 and point 2
+     *   (meters).
+     * @param[out] azi1 array of azimuths at point 1 (degrees).
+     * @param[out] azi2 array of (forward) azimuths at point 2 (degrees).
+     * @param[out] m12 array of reduced lengths of the geodesics (meters).
+     * @param[out] M12 array of geodesic scales of point 2 relative to point 1
+     *   (dimensionless).
+     * @param[out] M21 array of geodesic scales of point 1 relative to point 2
+     *   (dimensionless).
+     * @param[out] S12 array of areas under the geodesics
+     *   (meters<sup>2</sup>).
+     *
+     * This is the same as the other version of InverseBatch except that the
+     * data is held in floats; see the float version of DirectBatch.
+     **********************************************************************/
+    void InverseBatch(size_t n,
+                      const float lat1[], const float lon1[],
+                      const float lat2[], const float lon2[],
+                      unsigned outmask,
+                      float a12[], float s12[], float azi1[], float azi2[],
+                      float m12[], float M12[], float M21[],
+                      float S12[]) const;
+#endif
+
+    /**
+     * Solve several inverse geodesic problems with the data in strided
+     * arrays.
+     *
+     * @param[in] n the number of problems to solve.
+     * @param[in] lat1 view of the latitudes of point 1 (degrees).
+     * @param[in] lon1 view of the longitudes of point 1 (degrees).
+     * @param[in] lat2 view of the latitudes of point 2 (degrees).
+     * @param[in] lon2 view of the longitudes of point 2 (degrees).
+     * @param[in] outmask a bitor'ed combination of Geodesic::mask values
+     *   specifying which of the following arrays should be set.
+     * @param[out] a12 view of the arc lengths (degrees).
+     * @param[out] s12 view of the distances (meters).
+     * @param[out] azi1 view of the azimuths at point 1 (degrees).
+     * @param[out] azi2 view of the (forward) azimuths at point 2 (degrees).
+     * @param[out] m12 view of the reduced lengths (meters).
+     * @param[out] M12 view of the geodesic scales of point 2 relative to
+     *   point 1 (dimensionless).
+     * @param[out] M21 view of the geodesic scales of point 1 relative to
+     *   point 2 (dimensionless).
+     * @param[out] S12 view of the areas under the geodesics
+     *   (meters<sup>2</sup>).
+     *
+     * This is the same as the other version of InverseBatch except that the
+     * arrays are StridedView objects, so that, e.g., interleaved
+     * coordinates can be read and written in place.
+     **********************************************************************/
+    void InverseBatch(size_t n,
+                      StridedView<const real> lat1,
+                      StridedView<const real> lon1,
+                      StridedView<const real> lat2,
+                      StridedView<const real> lon2,
+                      unsigned outmask,
+                      StridedView<real> a12, StridedView<real> s12,
+                      StridedView<real> azi1, StridedView<real> azi2,
+                      StridedView<real> m12, StridedView<real> M12,
+                      StridedView<real> M21, StridedView<real> S12) const;
+
+    /**
+     * Compute the distances between two sets of points.
+     *
+     * @param[in] n the number of points in the first set.
+     * @param[in] lat1 array of latitudes of the first set (degrees).
+     * @param[in] lon1 array of longitudes of the first set (degrees).
+     * @param[in] m the number of points in the second set.
+     * @param[in] lat2 array of latitudes of the second set (degrees).
+     * @param[in] lon2 array of longitudes of the second set (degrees).
+     * @param[out] s12 the \e n &times; \e m matrix of distances (meters);
+     *   s12[\e i * \e m + \e j] is the distance from point \e i of the
+     *   first set to point \e j of the second.
+     *
+     * The results are identical to those obtained by calling
+     * Geodesic::Inverse for each pair of points.  However this is faster
+     * because the reduced latitudes of the points are computed once for each
+     * point instead of once for each pair; the matrix is computed in square
+     * tiles so that the data for the points stays in the cache.  Use
+     * GeodesicBatchExecutor::DistanceMatrix to compute the matrix using
+     * several threads.  \e s12 should not alias the input arrays.
+     **********************************************************************/
+    void DistanceMatrix(size_t n, const real lat1[], const real lon1[],
+                        size_t m, const real lat2[], const real lon2[],
+                        real s12[]) const
+    { IntDistanceMatrix(n, lat1, lon1, m, lat2, lon2, s12, nullptr); }
+
+    /**
+     * Compute the distances between all the pairs of a set of points.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lat array of latitudes of the points (degrees).
+     * @param[in] lon array of longitudes of the points (degrees).
+     * @param[out] s12 the \e n &times; \e n matrix of distances (meters);
+     *   s12[\e i * \e n + \e j] is the distance from point \e i to point
+     *   \e j.
+     *
+     * This is the same as the other version of DistanceMatrix with both sets
+     * of points the same, except that only the upper triangle of the matrix is
+     * computed; the lower triangle is copied from it.  (Geodesic::Inverse
+     * gives the same distance for a pair of points in either order.)
+     **********************************************************************/
+    void DistanceMatrix(size_t n, const real lat[], const real lon[],
+                        real s12[]) const
+    { IntDistanceMatrix(n, lat, lon, n, nullptr, nullptr, s12, nullptr); }
+    ///@}
+
+    /** \name Inverse geodesic problems with a common first point.
+     **********************************************************************/
+    ///@{
+    /**
+     * \brief The first point of several inverse geodesic problems
+     *
+     * This is returned by Geodesic::InverseFrom.  It holds the quantities for
+     * point 1 which don't depend on point 2 (the reduced latitude and related
+     * terms), so that these are computed only once when solving the inverse
+     * problems from one point to many others.  The results are identical to
+     * those given by the corresponding functions of Geodesic.
+     *
+     * An InverseOrigin holds a pointer to the Geodesic object which created it
+     * and so it must not outlive that object.  It may be used concurrently by
+     * several threads.
+     **********************************************************************/
+    class GEOGRAPHICLIB_EXPORT InverseOrigin {
+    private:
+      friend class Geodesic;
+      const Geodesic* _g;
+      invpoint _p1;
+      InverseOrigin(const Geodesic& g, real lat1, real lon1)
+        : _g(&g)
+        , _p1(g.InversePoint(lat1, lon1))
+      {}
+    public:
+
+      /**
+       * The general inverse geodesic calculation from the first point.
+       *
+       * @param[in] lat2 latitude of point 2 (degrees).
+       * @param[in] lon2 longitude of point 2 (degrees).
+       *
+       * The remaining arguments and the returned value are the same as for
+       * Geodesic::GenInverse.
+       **********************************************************************/
+      Math::real GenInverse(real lat2, real lon2, unsigned outmask,
+                            real& s12, real& azi1, real& azi2,
+                            real& m12, real& M12, real& M21, real& S12)
+        const {
+        return _g->GenInverse(_p1, _g->InversePoint(lat2, lon2), outmask,
+                              s12, azi1, azi2, m12, M12, M21, S12);
+      }
+
+      /**
+       * Solve the inverse geodesic problem for the distance.
+       *
+       * @param[in] lat2 latitude of point 2 (degrees).
+       * @param[in] lon2 longitude of point 2 (degrees).
+       * @param[out] s12 distance between point 1 and point 2 (meters).
+       * @return \e a12 arc length between point 1 and point 2 (degrees).
+       **********************************************************************/
+      Math::real Inverse(real lat2, real lon2, real& s12) const {
+        real t;
+        return GenInverse(lat2, lon2, DISTANCE, s12, t, t, t, t, t, t);
+      }
+
+      /**
+       * Solve the inverse geodesic problem for the distance and azimuths.
+       *
+       * @param[in] lat2 latitude of point 2 (degrees).
+       * @param[in] lon2 longitude of point 2 (degrees).
+       * @param[out] s12 distance between point 1 and point 2 (meters).
+       * @param[out] azi1 azimuth at point 1 (degrees).
+       * @param[out] azi2 (forward) azimuth at point 2 (degrees).
+       * @return \e a12 arc length between point 1 and point 2 (degrees).
+       **********************************************************************/
+      Math::real Inverse(real lat2, real lon2,
+                         real& s12, real& azi1, real& azi2) const {
+        real t;
+        return GenInverse(lat2, lon2, DISTANCE | AZIMUTH,
+                          s12, azi1, azi2, t, t, t, t);
+      }
+
+      /**
+       * Solve several inverse geodesic problems from the first point.
+       *
+       * @param[in] n the number of problems to solve.
+       * @param[in] lat2 array of latitudes of point 2 (degrees).
+       * @param[in] lon2 array of longitudes of point 2 (degrees).
+       *
+       * The remaining arguments are the same as for Geodesic::InverseBatch.
+       **********************************************************************/
+      void InverseBatch(size_t n, const real lat2[], const real lon2[],
+                        unsigned outmask,
+                        real a12[], real s12[], real azi1[], real azi2[],
+                        real m12[], real M12[], real M21[], real S12[])
+        const;
+    };
+
+    /**
+     * Set up to solve several inverse geodesic problems with the same first
+     * point.
+     *
+     * @param[in] lat1 latitude of point 1 (degrees).
+     * @param[in] lon1 longitude of point 1 (degrees).
+     * @return an InverseOrigin object.
+     *
+     * This is useful for finding the distances from one point to many others,
+     * e.g., to find the nearest of a set of facilities.  Example:
+     * \code
+     * const Geodesic& geod = Geodesic::WGS84();
+     * Geodesic::InverseOrigin jfk = geod.InverseFrom(40.6, -73.8);
+     * double s12;
+     * jfk.Inverse(51.6, -0.5, s12);   // distance to LHR
+     * \endcode
+     **********************************************************************/
+    InverseOrigin InverseFrom(real lat1, real lon1) const
+    { return InverseOrigin(*this, lat1, lon1); }
     ///@}
 
     /** \name Interface to GeodesicLine.
@@ -954,6 +1603,18 @@ namespace GeographicLib {
      **********************************************************************/
     Math::real Flattening() const { return _f; }
 
+    /**
+     * @return whether the inverse problem is solved with the fast tier.  This
+     *   is the value used in the constructor.
+     **********************************************************************/
+    bool Fast() const { return _fast; }
+
+    /**
+     * @return the order of the series expansions.  This is the value used in
+     *   the constructor.
+     **********************************************************************/
+    int Order() const { return _order; }
+
     /**
      * @return total area of ellipsoid in meters<sup>2</sup>.  The area of a
      *   polygon encircling a pole can be found by adding
@@ -964,12 +1625,155 @@ namespace GeographicLib {
     { return 4 * Math::pi() * _c2; }
     ///@}
 
+#if GEOGRAPHICLIB_INSTRUMENT
+    /** \name Solver statistics (only if GEOGRAPHICLIB_INSTRUMENT = 1)
+     **********************************************************************/
+    ///@{
+
+    /**
+     * How GenInverse found the geodesic; these index the bins of
+     * InversePaths().
+     **********************************************************************/
+    enum inverse_path {
+      /**
+       * The geodesic runs along a meridian.
+       * @hideinitializer
+       **********************************************************************/
+      PATH_MERIDIONAL = 0,
+      /**
+       * The geodesic runs along the equator.
+       * @hideinitializer
+       **********************************************************************/
+      PATH_EQUATORIAL = 1,
+      /**
+       * A short line (or any line on a sphere) solved without iteration.
+       * @hideinitializer
+       **********************************************************************/
+      PATH_SHORTLINE = 2,
+      /**
+       * Newton's method starting from the spherical approximation.
+       * @hideinitializer
+       **********************************************************************/
+      PATH_SPHERICAL = 3,
+      /**
+       * Newton's method starting close to the cut for nearly antipodal
+       * points.
+       * @hideinitializer
+       **********************************************************************/
+      PATH_STRIP = 4,
+      /**
+       * Newton's method starting from the solution of the astroid problem
+       * for nearly antipodal points.
+       * @hideinitializer
+       **********************************************************************/
+      PATH_ASTROID = 5,
+      /**
+       * Newton's method starting from a guess supplied by the caller (see
+       * Geodesic::GenInverseWarm).
+       * @hideinitializer
+       **********************************************************************/
+      PATH_WARM = 6,
+    };
+
+    /**
+     * @return a histogram of the paths taken by the inverse calculations
+     *   (indexed by Geodesic::inverse_path).
+     **********************************************************************/
+    const Histogram& InversePaths() const { return _inversepaths; }
+
+    /**
+     * @return a histogram of the number of iterations for the inverse
+     *   calculations which use Newton's method.
+     *
+     * An iteration is either a Newton step or a bisection step.  For WGS84
+     * and random points, the mean is about 3; the maximum is maxit2_ (about
+     * 83 for doubles).
+     **********************************************************************/
+    const Histogram& InverseIterations() const { return _inverseiterations; }
+
+    /**
+     * @return a histogram of the number of bisection steps for the inverse
+     *   calculations which use Newton's method.
+     *
+     * Bisection is used when a Newton step fails and for all iterations after
+     * the first 20.  Nonzero counts are rare for the terrestrial ellipsoid;
+     * they are the slow cases.
+     **********************************************************************/
+    const Histogram& InverseBisections() const { return _inversebisections; }
+
+    /**
+     * How WithinDistance found its result; these index the bins of
+     * WithinPaths().
+     **********************************************************************/
+    enum within_path {
+      /**
+       * The upper bound on the distance is less than \e R.
+       * @hideinitializer
+       **********************************************************************/
+      WITHIN_ACCEPT = 0,
+      /**
+       * The lower bound on the distance is at least \e R.
+       * @hideinitializer
+       **********************************************************************/
+      WITHIN_REJECT = 1,
+      /**
+       * The inverse problem was solved.
+       * @hideinitializer
+       **********************************************************************/
+      WITHIN_INVERSE = 2,
+    };
+
+    /**
+     * @return a histogram of the paths taken by WithinDistance (indexed by
+     *   Geodesic::within_path).
+     *
+     * The fraction of calls decided by the bounds alone is 1 &minus;
+     * WithinPaths().Count(WITHIN_INVERSE) / WithinPaths().Total().
+     **********************************************************************/
+    const Histogram& WithinPaths() const { return _withinpaths; }
+
+    /**
+     * Reset the statistics.
+     **********************************************************************/
+    void ResetStatistics() const {
+      _inversepaths.Reset(); _inverseiterations.Reset();
+      _inversebisections.Reset(); _withinpaths.Reset();
+    }
+    ///@}
+#endif
+
     /**
      * A global instantiation of Geodesic with the parameters for the WGS84
      * ellipsoid.
+     *
+     * This is constructed when the library is loaded (except with
+     * GEOGRAPHICLIB_PRECISION = 5), so the first call is as fast as the
+     * others.
      **********************************************************************/
     static const Geodesic& WGS84();
 
+    /**
+     * A shared instance of Geodesic for a given ellipsoid.
+     *
+     * @param[in] a equatorial radius (meters).
+     * @param[in] f flattening of ellipsoid.
+     * @param[in] fast whether to use the fast tier of the inverse solution
+     *   (default false).
+     * @param[in] order the order of the series expansions (default
+     *   GEOGRAPHICLIB_GEODESIC_ORDER).
+     * @exception GeographicErr if the parameters are invalid (see the
+     *   constructor).
+     * @return a Geodesic object with these parameters.
+     *
+     * The first call with a given set of parameters constructs the object and
+     * later calls return the same object; see SharedInstances for the
+     * details.  Finding an existing object doesn't take a lock and costs
+     * much less than constructing it.  The object lives until the program
+     * exits.
+     **********************************************************************/
+    static const Geodesic& Get(real a, real f, bool fast = false,
+                               int order = GEOGRAPHICLIB_GEODESIC_ORDER);
+
   };
 
 } // namespace GeographicLib
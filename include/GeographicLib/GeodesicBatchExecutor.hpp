@@ -0,0 +1,512 @@
+/**
+ * \file GeodesicBatchExecutor.hpp
+ * \brief Header for GeographicLib::GeodesicBatchExecutor class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_GEODESICBATCHEXECUTOR_HPP)
+#define GEOGRAPHICLIB_GEODESICBATCHEXECUTOR_HPP 1
+
+#include <GeographicLib/Constants.hpp>
+#include <atomic>
+#include <chrono>
+#include <functional>
+
+#if defined(GEOGRAPHICLIB_USE_TBB) && GEOGRAPHICLIB_USE_TBB
+#  include <tbb/parallel_for.h>
+#  include <tbb/task_arena.h>
+#endif
+
+namespace GeographicLib {
+
+  class Geodesic;
+
+  /**
+   * \brief Solve many geodesic problems using several threads
+   *
+   * Geodesic, GeodesicExact, GeodesicLine, and GeodesicLineExact objects are
+   * not altered once they have been constructed, so they can be shared by
+   * several threads.  This class divides the arrays given to the batch
+   * routines Geodesic::InverseBatch, Geodesic::DirectBatch, and
+   * GeodesicLine::PositionBatch (and their exact counterparts) into chunks
+   * and solves the chunks on several threads.  The results are identical to
+   * those obtained by calling the batch routines directly.  Forward and
+   * Reverse do the same for the batch routines of the projections with a
+   * central meridian, e.g., TransverseMercator::ForwardBatch;
+   * DistanceMatrix hands out the tiles of Geodesic::DistanceMatrix; and
+   * DirectFan hands out the azimuths of Geodesic::DirectFan.
+   *
+   * ForEachLocal is a version of ForEach for queries at scattered points
+   * (e.g., looking up the geoid height or the nearest neighbor).  It sorts
+   * the points along a Hilbert curve (HilbertOrder) before dividing them
+   * into chunks, so that nearby points are handled together.
+   *
+   * The chunks are scheduled by work stealing: each thread starts with a
+   * contiguous block of chunks which it processes in order; a thread which
+   * runs out of work takes the second half of the largest block remaining
+   * with another thread.  This keeps all the threads busy even when the cost
+   * of the problems varies a lot (e.g., nearly antipodal inverse problems
+   * which need the bisection fallback are much slower than typical ones).
+   *
+   * By default, the threads are created on each call to ForEach (and hence
+   * to Inverse, Direct, Position, Forward, and Reverse) and joined before
+   * the call returns.  For arrays of more than a few thousand elements this
+   * overhead is negligible.  The calling thread does one share of the work.
+   *
+   * All the parallel features of the library (the batch routines, the
+   * polygon areas, the grid synthesis and analysis, the loading of the
+   * magnetic and gravity models, the construction of NearestNeighbor, etc.)
+   * run their workers through this class.  An application which has its own
+   * thread pool can hand these workers to its pool with SetScheduler, which
+   * avoids oversubscribing the CPUs.  Adapters are provided for OpenMP
+   * (OpenMPRun) and Intel's Threading Building Blocks (TBBRun).  For
+   * example, with TBB:
+   * \code
+   * #define GEOGRAPHICLIB_USE_TBB 1
+   * #include <GeographicLib/GeodesicBatchExecutor.hpp>
+   * ...
+   * GeodesicBatchExecutor::SetScheduler
+   *   (GeodesicBatchExecutor::TBBRun,
+   *    unsigned(tbb::this_task_arena::max_concurrency()));
+   * \endcode
+   *
+   * A server with a bound on its response time can give the executor a
+   * deadline (SetDeadline) or a cancellation flag (SetCancel).  These are
+   * checked before each chunk is started; once the deadline passes or the
+   * flag is set, no more chunks are started and ForEach (and Inverse,
+   * Direct, Position, Forward, and Reverse) return the number of leading
+   * elements which have been processed.  In this mode, the chunks are
+   * handed out in order (instead of by work stealing) so that the
+   * processed elements are nearly all at the front of the arrays.  The
+   * delay in stopping is the time to process one chunk, so the chunk size
+   * should be chosen with this in mind.
+   *
+   * If GEOGRAPHICLIB_PRECISION = 5, the precision of the mpreal numbers in the
+   * worker threads is set by Utility::set_digits() (i.e., using the
+   * environment variable GEOGRAPHICLIB_DIGITS).
+   *
+   * Example of use:
+   * \include example-GeodesicBatchExecutor.cpp
+   **********************************************************************/
+  class GEOGRAPHICLIB_EXPORT GeodesicBatchExecutor {
+  private:
+    typedef Math::real real;
+    unsigned _nthreads;
+    size_t _chunk;
+    std::chrono::steady_clock::time_point _deadline;
+    const std::atomic<bool>* _cancel;
+    static real* at(real* p, size_t i) { return p ? p + i : nullptr; }
+    bool Stoppable() const {
+      return _cancel ||
+        _deadline != std::chrono::steady_clock::time_point::max();
+    }
+    bool Stopped() const {
+      return (_cancel && _cancel->load(std::memory_order_relaxed)) ||
+        std::chrono::steady_clock::now() >= _deadline;
+    }
+    size_t StoppableForEach(size_t n,
+                            const std::function<void(size_t, size_t)>& f)
+      const;
+  public:
+
+    /**
+     * The type of a scheduler.  It is called as \e run(\e n, \e work) and
+     * must call \e work(\e k) once for each \e k in [0, \e n) and return
+     * when all these calls have returned.  The calls may be made in any
+     * order, concurrently or not, and on any threads (including the calling
+     * thread).  The workers don't wait for one another, so it's fine for a
+     * scheduler to run some or all of them in turn on a single thread (as a
+     * busy pool may do); the workers which start early take over the work of
+     * those which haven't started.  \e work doesn't throw exceptions.
+     **********************************************************************/
+    typedef std::function<void(unsigned,
+                               const std::function<void(unsigned)>&)>
+    scheduler;
+
+    /**
+     * Constructor.
+     *
+     * @param[in] nthreads the number of threads to use; if this is 0 (the
+     *   default), use Concurrency().
+     * @param[in] chunk the number of elements in the unit of work handed to
+     *   a thread; if this is 0 (the default), use 256.
+     **********************************************************************/
+    GeodesicBatchExecutor(unsigned nthreads = 0, size_t chunk = 0);
+
+    /**
+     * Call a function over a range of indices using several threads.
+     *
+     * @param[in] n the number of elements.
+     * @param[in] f the function to call; it is called as \e f(\e i0, \e i1)
+     *   to process elements [\e i0, \e i1).
+     * @exception any exception thrown by \e f.
+     * @return the number of elements processed, \e m; elements [0, \e m)
+     *   have been processed.  This is \e n unless the deadline has passed
+     *   or the cancellation flag has been set.
+     *
+     * The ranges passed to \e f are disjoint and cover [0, \e n).  If \e f
+     * throws an exception, the remaining chunks are abandoned and, after all
+     * the threads have finished, the first exception thrown is rethrown.  \e
+     * f must be safe to call concurrently from several threads.
+     *
+     * If the executor is stopped by SetDeadline or SetCancel, some ranges
+     * beyond the first \e m elements may also have been processed (by
+     * threads which were slower to stop).
+     **********************************************************************/
+    size_t ForEach(size_t n,
+                   const std::function<void(size_t, size_t)>& f) const;
+
+    /**
+     * Call a function over points taken in the order of a Hilbert curve
+     * using several threads.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lat array of the latitudes of the points (degrees).
+     * @param[in] lon array of the longitudes of the points (degrees).
+     * @param[in] f the function to call; it is called as \e f(\e m, \e idx)
+     *   to process the \e m points with indices \e idx[0] through \e
+     *   idx[\e m &minus; 1].
+     * @exception std::bad_alloc if the memory for the ordering can't be
+     *   allocated.
+     * @exception any exception thrown by \e f.
+     *
+     * The points are put in the order given by HilbertOrder and this order is
+     * divided into chunks as with ForEach.  So each call of \e f handles
+     * points which are close together, and the grid cells or tree nodes they
+     * need stay in the cache.  \e f should store the results for point \e
+     * idx[\e k] at position \e idx[\e k] of the output arrays, which then
+     * come out in the original order.  The deadline and cancellation flag
+     * are ignored (since the order of processing is scrambled).
+     **********************************************************************/
+    void ForEachLocal(size_t n, const real lat[], const real lon[],
+                      const std::function<void(size_t, const size_t[])>& f)
+      const;
+
+    /**
+     * Sort points along a Hilbert curve.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lat array of the latitudes of the points (degrees).
+     * @param[in] lon array of the longitudes of the points (degrees).
+     * @param[out] perm array of the indices of the points in sorted order.
+     * @exception std::bad_alloc if the memory for the sorting can't be
+     *   allocated.
+     *
+     * The Hilbert curve fills the rectangle of latitude and longitude on a
+     * 2<sup>16</sup> &times; 2<sup>16</sup> grid; points which are adjacent
+     * on the curve are close together.  The sort is stable and points with a
+     * NaN latitude or longitude come last.  The sort takes a time
+     * proportional to \e n; for a cheap evaluation (e.g., Geoid::HeightBatch
+     * with the data in memory) it only pays if the points are scattered over
+     * a grid which is much bigger than the cache.
+     **********************************************************************/
+    static void HilbertOrder(size_t n, const real lat[], const real lon[],
+                             size_t perm[]);
+
+    /**
+     * Solve several inverse geodesic problems in parallel.
+     *
+     * @tparam G the geodesic class, Geodesic or GeodesicExact.
+     * @param[in] g the geodesic object.
+     *
+     * The remaining arguments are the same as for Geodesic::InverseBatch.
+     * @return the number of problems solved; see ForEach.
+     **********************************************************************/
+    template<class G>
+    size_t Inverse(const G& g, size_t n,
+                 const real lat1[], const real lon1[],
+                 const real lat2[], const real lon2[],
+                 unsigned outmask,
+                 real a12[], real s12[], real azi1[], real azi2[],
+                 real m12[], real M12[], real M21[], real S12[]) const {
+      return ForEach(n, [&](size_t i0, size_t i1) -> void {
+        g.InverseBatch(i1 - i0,
+                       lat1 + i0, lon1 + i0, lat2 + i0, lon2 + i0, outmask,
+                       at(a12, i0), at(s12, i0), at(azi1, i0), at(azi2, i0),
+                       at(m12, i0), at(M12, i0), at(M21, i0), at(S12, i0));
+      });
+    }
+
+    /**
+     * Solve several direct geodesic problems in parallel.
+     *
+     * @tparam G the geodesic class, Geodesic or GeodesicExact.
+     * @param[in] g the geodesic object.
+     *
+     * The remaining arguments are the same as for Geodesic::DirectBatch.
+     * @return the number of problems solved; see ForEach.
+     **********************************************************************/
+    template<class G>
+    size_t Direct(const G& g, size_t n,
+                const real lat1[], const real lon1[], const real azi1[],
+                bool arcmode, const real s12_a12[], unsigned outmask,
+                real a12[], real lat2[], real lon2[], real azi2[],
+                real s12[], real m12[], real M12[], real M21[],
+                real S12[]) const {
+      return ForEach(n, [&](size_t i0, size_t i1) -> void {
+        g.DirectBatch(i1 - i0,
+                      lat1 + i0, lon1 + i0, azi1 + i0,
+                      arcmode, s12_a12 + i0, outmask,
+                      at(a12, i0), at(lat2, i0), at(lon2, i0), at(azi2, i0),
+                      at(s12, i0), at(m12, i0), at(M12, i0), at(M21, i0),
+                      at(S12, i0));
+      });
+    }
+
+    /**
+     * Solve the direct geodesic problems from a single point for several
+     * azimuths and distances in parallel.
+     *
+     * @param[in] g the geodesic object.
+     *
+     * The remaining arguments are the same as for Geodesic::DirectFan.  The
+     * azimuths are divided among the threads, with the chunk size scaled
+     * down by the number of distances.  There is no GeodesicExact version of
+     * this function.
+     **********************************************************************/
+    void DirectFan(const Geodesic& g, real lat1, real lon1,
+                   size_t na, const real azi1[],
+                   size_t nd, bool arcmode, const real s12_a12[],
+                   unsigned outmask,
+                   real a12[], real lat2[], real lon2[], real azi2[],
+                   real s12[], real m12[], real M12[], real M21[],
+                   real S12[]) const;
+
+    /**
+     * Compute the distances between two sets of points in parallel.
+     *
+     * @param[in] g the geodesic object.
+     *
+     * The remaining arguments are the same as for Geodesic::DistanceMatrix.
+     * The tiles of the matrix are the units of work handed to the threads;
+     * the chunk size is not used.  There is no GeodesicExact version of this
+     * function.
+     **********************************************************************/
+    void DistanceMatrix(const Geodesic& g,
+                        size_t n, const real lat1[], const real lon1[],
+                        size_t m, const real lat2[], const real lon2[],
+                        real s12[]) const;
+
+    /**
+     * Compute the distances between all the pairs of a set of points in
+     * parallel.
+     *
+     * @param[in] g the geodesic object.
+     *
+     * The remaining arguments are the same as for the symmetric version of
+     * Geodesic::DistanceMatrix.
+     **********************************************************************/
+    void DistanceMatrix(const Geodesic& g,
+                        size_t n, const real lat[], const real lon[],
+                        real s12[]) const;
+
+    /**
+     * Compute several points on a geodesic in parallel.
+     *
+     * @tparam L the geodesic line class, GeodesicLine or GeodesicLineExact.
+     * @param[in] l the geodesic line object.
+     *
+     * The remaining arguments are the same as for
+     * GeodesicLine::PositionBatch.
+     * @return the number of points computed; see ForEach.
+     **********************************************************************/
+    template<class L>
+    size_t Position(const L& l, size_t n,
+                  bool arcmode, const real s12_a12[], unsigned outmask,
+                  real a12[], real lat2[], real lon2[], real azi2[],
+                  real s12[], real m12[], real M12[], real M21[],
+                  real S12[]) const {
+      return ForEach(n, [&](size_t i0, size_t i1) -> void {
+        l.PositionBatch(i1 - i0, arcmode, s12_a12 + i0, outmask,
+                        at(a12, i0), at(lat2, i0), at(lon2, i0), at(azi2, i0),
+                        at(s12, i0), at(m12, i0), at(M12, i0), at(M21, i0),
+                        at(S12, i0));
+      });
+    }
+
+    /**
+     * Carry out the forward projection of several points in parallel.
+     *
+     * @tparam P the projection class, TransverseMercator,
+     *   TransverseMercatorExact, AlbersEqualArea, or LambertConformalConic.
+     * @param[in] p the projection object.
+     *
+     * The remaining arguments are the same as for
+     * TransverseMercator::ForwardBatch.  For example, to project points to
+     * UTM zone \e z, use TransverseMercator::UTM() with \e lon0 = 6\e z
+     * &minus; 183 (and add the false easting and northing).
+     * @return the number of points projected; see ForEach.
+     **********************************************************************/
+    template<class P>
+    size_t Forward(const P& p, size_t n, real lon0,
+                 const real lat[], const real lon[], real x[], real y[],
+                 real gamma[] = nullptr, real k[] = nullptr) const {
+      return ForEach(n, [&](size_t i0, size_t i1) -> void {
+        p.ForwardBatch(i1 - i0, lon0, lat + i0, lon + i0, x + i0, y + i0,
+                       at(gamma, i0), at(k, i0));
+      });
+    }
+
+    /**
+     * Carry out the reverse projection of several points in parallel.
+     *
+     * @tparam P the projection class, TransverseMercator,
+     *   TransverseMercatorExact, AlbersEqualArea, or LambertConformalConic.
+     * @param[in] p the projection object.
+     *
+     * The remaining arguments are the same as for
+     * TransverseMercator::ReverseBatch.
+     * @return the number of points projected; see ForEach.
+     **********************************************************************/
+    template<class P>
+    size_t Reverse(const P& p, size_t n, real lon0,
+                 const real x[], const real y[], real lat[], real lon[],
+                 real gamma[] = nullptr, real k[] = nullptr) const {
+      return ForEach(n, [&](size_t i0, size_t i1) -> void {
+        p.ReverseBatch(i1 - i0, lon0, x + i0, y + i0, lat + i0, lon + i0,
+                       at(gamma, i0), at(k, i0));
+      });
+    }
+
+    /** \name Deadlines and cancellation
+     **********************************************************************/
+    ///@{
+    /**
+     * Set a deadline for the calls to ForEach.
+     *
+     * @param[in] deadline the time after which no more chunks are started;
+     *   the default, std::chrono::steady_clock::time_point::max(), removes
+     *   the deadline.
+     *
+     * This applies to all later calls to ForEach, Inverse, Direct,
+     * Position, Forward, and Reverse with this executor.  Typically a
+     * server sets it to the time of arrival of a request plus the time
+     * allowed for the response (less the time needed to return the partial
+     * results).
+     **********************************************************************/
+    void SetDeadline(std::chrono::steady_clock::time_point deadline
+                     = std::chrono::steady_clock::time_point::max())
+    { _deadline = deadline; }
+
+    /**
+     * Set a cancellation flag for the calls to ForEach.
+     *
+     * @param[in] cancel a pointer to the flag; once \e *cancel is true, no
+     *   more chunks are started.  If this is nullptr (the default), the
+     *   calls can't be cancelled.
+     *
+     * The flag may be set by another thread while ForEach is running.  It
+     * must outlive the calls to ForEach; the executor doesn't reset it.
+     **********************************************************************/
+    void SetCancel(const std::atomic<bool>* cancel = nullptr)
+    { _cancel = cancel; }
+    ///@}
+
+    /** \name Schedulers
+     **********************************************************************/
+    ///@{
+    /**
+     * Set the scheduler used by all the parallel features of the library.
+     *
+     * @param[in] run the scheduler; if this is empty (the default), use
+     *   ThreadRun.
+     * @param[in] concurrency the number of threads used when 0 is given as
+     *   the number of threads; if this is 0 (the default), use
+     *   std::thread::hardware_concurrency().
+     *
+     * This affects the calls made after it returns; the calls in progress
+     * carry on with the previous scheduler.  Where the documentation of
+     * the library says that std::thread::hardware_concurrency() threads
+     * are used by default, \e concurrency threads are used instead if it is
+     * positive.
+     **********************************************************************/
+    static void SetScheduler(const scheduler& run = scheduler(),
+                             unsigned concurrency = 0);
+
+    /**
+     * @return the number of threads used when 0 is given as the number of
+     *   threads (at least 1).
+     **********************************************************************/
+    static unsigned Concurrency();
+
+    /**
+     * Run workers with the scheduler set by SetScheduler.
+     *
+     * @param[in] n the number of workers.
+     * @param[in] work the worker; it must not throw exceptions.
+     **********************************************************************/
+    static void Run(unsigned n, const std::function<void(unsigned)>& work);
+
+    /**
+     * The default scheduler.
+     *
+     * @param[in] n the number of workers.
+     * @param[in] work the worker.
+     *
+     * This runs \e work(0) on the calling thread and each of the other
+     * workers on a new std::thread.  If a thread can't be started, the
+     * workers without a thread are run in turn on the calling thread.
+     **********************************************************************/
+    static void ThreadRun(unsigned n,
+                          const std::function<void(unsigned)>& work);
+
+#if defined(_OPENMP) || defined(DOXYGEN)
+    /**
+     * A scheduler using OpenMP.
+     *
+     * @param[in] n the number of workers.
+     * @param[in] work the worker.
+     *
+     * The workers are handed out to the threads of an OpenMP parallel
+     * region.  This is only defined if the code including this header is
+     * compiled with OpenMP enabled.
+     **********************************************************************/
+    static void OpenMPRun(unsigned n,
+                          const std::function<void(unsigned)>& work) {
+      int m = int(n);
+#  pragma omp parallel for schedule(dynamic, 1)
+      for (int k = 0; k < m; ++k)
+        work(unsigned(k));
+    }
+#endif
+
+#if (defined(GEOGRAPHICLIB_USE_TBB) && GEOGRAPHICLIB_USE_TBB) || \
+  defined(DOXYGEN)
+    /**
+     * A scheduler using Intel's Threading Building Blocks.
+     *
+     * @param[in] n the number of workers.
+     * @param[in] work the worker.
+     *
+     * The workers become TBB tasks in the current task arena.  This is only
+     * defined if GEOGRAPHICLIB_USE_TBB is set to 1 before this header is
+     * included; the application must then link with the TBB library.
+     **********************************************************************/
+    static void TBBRun(unsigned n, const std::function<void(unsigned)>& work) {
+      tbb::parallel_for(0u, n, [&work](unsigned k) -> void { work(k); });
+    }
+#endif
+    ///@}
+
+    /** \name Inspector functions
+     **********************************************************************/
+    ///@{
+    /**
+     * @return the number of threads used.
+     **********************************************************************/
+    unsigned NumThreads() const { return _nthreads; }
+
+    /**
+     * @return the number of elements in a chunk.
+     **********************************************************************/
+    size_t ChunkSize() const { return _chunk; }
+    ///@}
+
+  };
+
+} // namespace GeographicLib
+
+#endif  // GEOGRAPHICLIB_GEODESICBATCHEXECUTOR_HPP
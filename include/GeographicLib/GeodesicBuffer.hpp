@@ -0,0 +1,169 @@
+/**
+ * \file GeodesicBuffer.hpp
+ * \brief Header for GeographicLib::GeodesicBuffer class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_GEODESICBUFFER_HPP)
+#define GEOGRAPHICLIB_GEODESICBUFFER_HPP 1
+
+#include <vector>
+#include <GeographicLib/Geodesic.hpp>
+#include <GeographicLib/Gnomonic.hpp>
+#include <GeographicLib/ClosestPoint.hpp>
+#include <GeographicLib/Constants.hpp>
+
+namespace GeographicLib {
+
+  /**
+   * \brief The buffer of a polyline or a polygon on the ellipsoid
+   *
+   * The buffer of radius \e R of a polyline is the set of points whose
+   * geodesic distance from the polyline is at most \e R; the buffer of a
+   * polygon also includes its interior.  This class computes the outline of
+   * the buffer as a polygon whose vertices lie at a distance \e R from the
+   * path and are spaced by at most \e ds.
+   *
+   * The path is traversed so that the buffer lies to its right: a polygon
+   * counter-clockwise and a polyline forwards and then backwards.  The raw
+   * outline is made of the points at a distance \e R along the geodesics
+   * perpendicular to each edge (found with GeodesicLine::PositionBatch), and
+   * circular arcs of radius \e R about the vertices where the path turns
+   * left (including a half circle at each end of a polyline).  The
+   * endpoints of all these geodesics are found with Geodesic::DirectBatch on
+   * several threads.  Where the path turns right, or where two parts of the
+   * path come within 2\e R of each other, the raw outline loops back on
+   * itself.  The vertices lying within \e R of the path (found with
+   * ClosestPoint::Polyline) are dropped and the outline is joined at the
+   * intersection of the edges on either side of the dropped vertices; this
+   * intersection is found in a Gnomonic projection centered on the join in
+   * which these short geodesics are nearly straight.
+   *
+   * The result is a single ring.  If the buffer encloses a hole (e.g., for
+   * a polyline which closes on itself), the hole is either omitted or
+   * joined to the outside by a cut.  The path should be less than half way
+   * round the ellipsoid and \e R should be small enough that the perpendicular
+   * geodesics don't cross (less than about a quarter meridian).
+   *
+   * GeodesicBuffer objects are not altered once they have been constructed,
+   * so they can be shared by several threads.
+   *
+   * Example of use:
+   * \code
+   * // The 1 km buffer of a road with vertices every 100 m
+   * GeodesicBuffer buffer;
+   * double lat[] = {51.50, 51.52, 51.53}, lon[] = {-0.12, -0.10, -0.13};
+   * std::vector<double> blat, blon;
+   * buffer.Polyline(3, lat, lon, 1e3, 100, blat, blon);
+   * \endcode
+   **********************************************************************/
+  class GEOGRAPHICLIB_EXPORT GeodesicBuffer {
+  private:
+    typedef Math::real real;
+    Geodesic _geod;
+    Gnomonic _gnom;
+    ClosestPoint _closest;
+    real _tol;
+    // Compute the outline for a path of n distinct vertices which is closed
+    // if ring.
+    void Outline(const std::vector<real>& lat, const std::vector<real>& lon,
+                 bool ring, real R, real ds,
+                 std::vector<real>& blat, std::vector<real>& blon,
+                 unsigned nthreads) const;
+    // The intersection of the geodesics AB and CD; return false if they
+    // don't intersect within the segments.
+    bool Join(real latA, real lonA, real latB, real lonB,
+              real latC, real lonC, real latD, real lonD,
+              real& lat, real& lon) const;
+  public:
+
+    /**
+     * Constructor for GeodesicBuffer.
+     *
+     * @param[in] geod the Geodesic object to use for geodesic calculations.
+     *   By default this uses the WGS84 ellipsoid.
+     **********************************************************************/
+    explicit GeodesicBuffer(const Geodesic& geod = Geodesic::WGS84());
+
+    /**
+     * The buffer of a polyline.
+     *
+     * @param[in] n the number of vertices of the polyline.
+     * @param[in] lat array of latitudes of the vertices (degrees).
+     * @param[in] lon array of longitudes of the vertices (degrees).
+     * @param[in] R the radius of the buffer (meters).
+     * @param[in] ds the maximum spacing of the vertices of the outline
+     *   (meters).
+     * @param[out] blat the latitudes of the vertices of the outline
+     *   (degrees).
+     * @param[out] blon the longitudes of the vertices of the outline
+     *   (degrees).
+     * @param[in] nthreads the number of threads to use; if this is 0 (the
+     *   default), use std::thread::hardware_concurrency().
+     * @exception GeographicErr if \e R or \e ds is not positive and finite.
+     * @exception std::bad_alloc if the memory for the outline can't be
+     *   allocated.
+     *
+     * The outline is a counter-clockwise ring; its last vertex is not a
+     * repeat of the first.  Repeated vertices of the polyline are ignored;
+     * if it has only one distinct vertex, the outline is a geodesic circle.
+     * If \e n = 0, the outline is empty.
+     **********************************************************************/
+    void Polyline(size_t n, const real lat[], const real lon[],
+                  real R, real ds,
+                  std::vector<real>& blat, std::vector<real>& blon,
+                  unsigned nthreads = 0) const;
+
+    /**
+     * The buffer of a polygon.
+     *
+     * @param[in] n the number of vertices of the polygon.
+     * @param[in] lat array of latitudes of the vertices (degrees).
+     * @param[in] lon array of longitudes of the vertices (degrees).
+     * @param[in] R the radius of the buffer (meters).
+     * @param[in] ds the maximum spacing of the vertices of the outline
+     *   (meters).
+     * @param[out] blat the latitudes of the vertices of the outline
+     *   (degrees).
+     * @param[out] blon the longitudes of the vertices of the outline
+     *   (degrees).
+     * @param[in] nthreads the number of threads to use; if this is 0 (the
+     *   default), use std::thread::hardware_concurrency().
+     * @exception GeographicErr if \e R or \e ds is not positive and finite.
+     * @exception std::bad_alloc if the memory for the outline can't be
+     *   allocated.
+     *
+     * The polygon may be given in either direction and a closing vertex
+     * which repeats the first is ignored.  The outline is a
+     * counter-clockwise ring which encloses the polygon.  A polygon with
+     * fewer than three distinct vertices is treated as a polyline.
+     **********************************************************************/
+    void Polygon(size_t n, const real lat[], const real lon[],
+                 real R, real ds,
+                 std::vector<real>& blat, std::vector<real>& blon,
+                 unsigned nthreads = 0) const;
+
+    /** \name Inspector functions
+     **********************************************************************/
+    ///@{
+    /**
+     * @return \e a the equatorial radius of the ellipsoid (meters).  This is
+     *   the value inherited from the Geodesic object used in the constructor.
+     **********************************************************************/
+    Math::real EquatorialRadius() const { return _geod.EquatorialRadius(); }
+
+    /**
+     * @return \e f the flattening of the ellipsoid.  This is the value
+     *   inherited from the Geodesic object used in the constructor.
+     **********************************************************************/
+    Math::real Flattening() const { return _geod.Flattening(); }
+    ///@}
+
+  };
+
+} // namespace GeographicLib
+
+#endif  // GEOGRAPHICLIB_GEODESICBUFFER_HPP
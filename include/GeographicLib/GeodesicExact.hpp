@@ -535,6 +535,49 @@ namespace GeographicLib {
                          real& lat2, real& lon2, real& azi2,
                          real& s12, real& m12, real& M12, real& M21,
                          real& S12) const;
+
+    /**
+     * Solve several direct geodesic problems.
+     *
+     * @param[in] n the number of problems to solve.
+     * @param[in] lat1 array of latitudes of point 1 (degrees).
+     * @param[in] lon1 array of longitudes of point 1 (degrees).
+     * @param[in] azi1 array of azimuths at point 1 (degrees).
+     * @param[in] arcmode boolean flag determining the meaning of \e s12_a12.
+     * @param[in] s12_a12 array of distances (meters) between point 1 and point
+     *   2, if \e arcmode is false, or of arc lengths (degrees), if \e arcmode
+     *   is true.
+     * @param[in] outmask a bitor'ed combination of GeodesicExact::mask values
+     *   specifying which of the following arrays should be set.
+     * @param[out] a12 array of arc lengths from point 1 to point 2 (degrees).
+     * @param[out] lat2 array of latitudes of point 2 (degrees).
+     * @param[out] lon2 array of longitudes of point 2 (degrees).
+     * @param[out] azi2 array of (forward) azimuths at point 2 (degrees).
+     * @param[out] s12 array of distances from point 1 to point 2 (meters).
+     * @param[out] m12 array of reduced lengths of the geodesics (meters).
+     * @param[out] M12 array of geodesic scales of point 2 relative to point 1
+     *   (dimensionless).
+     * @param[out] M21 array of geodesic scales of point 1 relative to point 2
+     *   (dimensionless).
+     * @param[out] S12 array of areas under the geodesics (meters<sup>2</sup>).
+     *
+     * All the arrays have (at least) \e n elements.  Element \e i of the
+     * outputs is the result which GeodesicExact::GenDirect returns for element
+     * \e i of the inputs; so the results are identical to those obtained by
+     * calling GeodesicExact::GenDirect in a loop.  Any of the output arrays
+     * may be null, in which case the corresponding quantity is not computed.
+     * \e a12 is always computed; it is stored if \e a12 is not null.  The
+     * output arrays should not alias the input arrays.
+     *
+     * To compute several points along a single geodesic, use
+     * GeodesicLineExact::PositionBatch instead.
+     **********************************************************************/
+    void DirectBatch(size_t n,
+                     const real lat1[], const real lon1[], const real azi1[],
+                     bool arcmode, const real s12_a12[], unsigned outmask,
+                     real a12[], real lat2[], real lon2[], real azi2[],
+                     real s12[], real m12[], real M12[], real M21[],
+                     real S12[]) const;
     ///@}
 
     /** \name Inverse geodesic problem.
@@ -694,6 +737,51 @@ namespace GeographicLib {
                           real& m12, real& M12, real& M21, real& S12) const;
     ///@}
 
+    /** \name Batch version of inverse geodesic solution.
+     **********************************************************************/
+    ///@{
+    /**
+     * Solve several inverse geodesic problems.
+     *
+     * @param[in] n the number of problems to solve.
+     * @param[in] lat1 array of latitudes of point 1 (degrees).
+     * @param[in] lon1 array of longitudes of point 1 (degrees).
+     * @param[in] lat2 array of latitudes of point 2 (degrees).
+     * @param[in] lon2 array of longitudes of point 2 (degrees).
+     * @param[in] outmask a bitor'ed combination of GeodesicExact::mask values
+     *   specifying which of the following arrays should be set.
+     * @param[out] a12 array of arc lengths between point 1 and point 2
+     *   (degrees).
+     * @param[out] s12 array of distances between point 1 and point 2
+     *   (meters).
+     * @param[out] azi1 array of azimuths at point 1 (degrees).
+     * @param[out] azi2 array of (forward) azimuths at point 2 (degrees).
+     * @param[out] m12 array of reduced lengths of the geodesics (meters).
+     * @param[out] M12 array of geodesic scales of point 2 relative to point 1
+     *   (dimensionless).
+     * @param[out] M21 array of geodesic scales of point 1 relative to point 2
+     *   (dimensionless).
+     * @param[out] S12 array of areas under the geodesics
+     *   (meters<sup>2</sup>).
+     *
+     * All the arrays have (at least) \e n elements.  The input arrays are
+     * visited in order and element \e i of the outputs is the result which
+     * GeodesicExact::GenInverse returns for element \e i of the inputs; so
+     * the results are identical to those obtained by calling
+     * GeodesicExact::GenInverse in a loop.  Any of the output arrays may be
+     * null, in which case the corresponding quantity is not computed (as if
+     * its bit were removed from \e outmask).  \e a12 is always computed; it
+     * is stored if \e a12 is not null.  The output arrays should not alias
+     * the input arrays.
+     **********************************************************************/
+    void InverseBatch(size_t n,
+                      const real lat1[], const real lon1[],
+                      const real lat2[], const real lon2[],
+                      unsigned outmask,
+                      real a12[], real s12[], real azi1[], real azi2[],
+                      real m12[], real M12[], real M21[], real S12[]) const;
+    ///@}
+
     /** \name Interface to GeodesicLineExact.
      **********************************************************************/
     ///@{
@@ -865,6 +953,23 @@ namespace GeographicLib {
      **********************************************************************/
     static const GeodesicExact& WGS84();
 
+    /**
+     * A shared instance of GeodesicExact for a given ellipsoid.
+     *
+     * @param[in] a equatorial radius (meters).
+     * @param[in] f flattening of ellipsoid.
+     * @exception GeographicErr if \e a or (1 &minus; \e f) \e a is not
+     *   positive.
+     * @return a GeodesicExact object with these parameters.
+     *
+     * The first call with a given set of parameters constructs the object and
+     * later calls return the same object; see SharedInstances for the
+     * details.  Finding an existing object doesn't take a lock and costs
+     * much less than constructing it.  The object lives until the program
+     * exits.
+     **********************************************************************/
+    static const GeodesicExact& Get(real a, real f);
+
   };
 
 } // namespace GeographicLib
@@ -12,6 +12,7 @@
 
 #include <GeographicLib/Constants.hpp>
 #include <GeographicLib/Geodesic.hpp>
+#include <GeographicLib/Densifier.hpp>
 
 namespace GeographicLib {
 
@@ -72,11 +73,8 @@ namespace GeographicLib {
   private:
     typedef Math::real real;
     friend class Geodesic;
-    static const int nC1_ = Geodesic::nC1_;
-    static const int nC1p_ = Geodesic::nC1p_;
-    static const int nC2_ = Geodesic::nC2_;
-    static const int nC3_ = Geodesic::nC3_;
-    static const int nC4_ = Geodesic::nC4_;
+    friend class GeodesicLineCompact;
+    static const int nC_ = Geodesic::nC_;
 
     real tiny_;
     real _lat1, _lon1, _azi1;
@@ -84,19 +82,40 @@ namespace GeographicLib {
       _salp1, _calp1, _ssig1, _csig1, _dn1, _stau1, _ctau1, _somg1, _comg1,
       _aA1m1, _aA2m1, _aA3c, _bB11, _bB21, _bB31, _aA4, _bB41;
     real _a13, _s13;
-    // index zero elements of _cC1a, _cC1pa, _cC2a, _cC3a are unused
-    real _cC1a[nC1_ + 1], _cC1pa[nC1p_ + 1], _cC2a[nC2_ + 1], _cC3a[nC3_],
-      _cC4a[nC4_];              // all the elements of _cC4a are used
+    // index zero elements of _cC1a, _cC1pa, _cC2a, _cC3a are unused; the
+    // first _order + 1 elements of _cC1a, _cC1pa, _cC2a and the first _order
+    // elements of _cC3a and _cC4a are set.
+    real _cC1a[nC_], _cC1pa[nC_], _cC2a[nC_], _cC3a[nC_], _cC4a[nC_];
+    int _order;                 // the series order of the Geodesic object
     unsigned _caps;
 
     void LineInit(const Geodesic& g,
                   real lat1, real lon1,
                   real azi1, real salp1, real calp1,
                   unsigned caps);
+    // As above with the reduced latitude of point 1, sbet1 and cbet1, and
+    // dn1 given; Geodesic::DirectFan computes these once for all its lines.
+    void LineInit(const Geodesic& g,
+                  real lat1, real lon1,
+                  real azi1, real salp1, real calp1,
+                  real sbet1, real cbet1, real dn1,
+                  unsigned caps);
     GeodesicLine(const Geodesic& g,
                  real lat1, real lon1,
                  real azi1, real salp1, real calp1,
                  unsigned caps, bool arcmode, real s13_a13);
+    // The two halves of GenPosition.  DistanceArc converts a distance to the
+    // arc length, given the sine and cosine of tau12; ArcPosition completes
+    // the calculation given the arc length.
+    void DistanceArc(real s12, real tau12, real s, real c,
+                     real& sig12, real& ssig12, real& csig12,
+                     real& B12) const;
+    Math::real ArcPosition(bool arcmode, real s12_a12,
+                           real sig12, real ssig12, real csig12,
+                           real B12, unsigned outmask,
+                           real& lat2, real& lon2, real& azi2,
+                           real& s12, real& m12, real& M12, real& M21,
+                           real& S12) const;
 
     enum captype {
       CAP_NONE = Geodesic::CAP_NONE,
@@ -544,6 +563,248 @@ namespace GeographicLib {
                            real& lat2, real& lon2, real& azi2,
                            real& s12, real& m12, real& M12, real& M21,
                            real& S12) const;
+
+    /**
+     * Compute the positions of several points on the geodesic.
+     *
+     * @param[in] n the number of points.
+     * @param[in] arcmode boolean flag determining the meaning of \e s12_a12;
+     *   if \e arcmode is false, then the GeodesicLine object must have been
+     *   constructed with \e caps |= GeodesicLine::DISTANCE_IN.
+     * @param[in] s12_a12 array of distances (meters) from point 1, if \e
+     *   arcmode is false, or of arc lengths (degrees), if \e arcmode is true.
+     * @param[in] outmask a bitor'ed combination of GeodesicLine::mask values
+     *   specifying which of the following arrays should be set.
+     * @param[out] a12 array of arc lengths from point 1 to point 2 (degrees).
+     * @param[out] lat2 array of latitudes of point 2 (degrees).
+     * @param[out] lon2 array of longitudes of point 2 (degrees).
+     * @param[out] azi2 array of (forward) azimuths at point 2 (degrees).
+     * @param[out] s12 array of distances from point 1 to point 2 (meters).
+     * @param[out] m12 array of reduced lengths of the geodesics (meters).
+     * @param[out] M12 array of geodesic scales of point 2 relative to point 1
+     *   (dimensionless).
+     * @param[out] M21 array of geodesic scales of point 1 relative to point 2
+     *   (dimensionless).
+     * @param[out] S12 array of areas under the geodesics (meters<sup>2</sup>).
+     *
+     * All the arrays have (at least) \e n elements.  Element \e i of the
+     * outputs is the result which GeodesicLine::GenPosition returns for
+     * element \e i of \e s12_a12.  The series coefficients computed when the
+     * GeodesicLine object was constructed are shared by all the points so this
+     * is the efficient way to compute many points along a track.  Quantities
+     * which the GeodesicLine object is not capable of computing are not
+     * stored.  Any of the output arrays may be null, in which case the
+     * corresponding quantity is not computed.  \e a12 is stored if \e a12 is
+     * not null.  The output arrays should not alias \e s12_a12.
+     **********************************************************************/
+    void PositionBatch(size_t n, bool arcmode, const real s12_a12[],
+                       unsigned outmask,
+                       real a12[], real lat2[], real lon2[], real azi2[],
+                       real s12[], real m12[], real M12[], real M21[],
+                       real S12[]) const;
+
+    /**
+     * Compute equally spaced points on the geodesic from point 1 to point 3.
+     *
+     * @param[in] n the number of points.
+     * @param[in] arcmode if true, the points are equally spaced in arc length;
+     *   otherwise they are equally spaced in distance and the GeodesicLine
+     *   object must have been constructed with \e caps |=
+     *   GeodesicLine::DISTANCE_IN.
+     * @param[in] outmask a bitor'ed combination of GeodesicLine::mask values
+     *   specifying which of the following arrays should be set.
+     * @param[out] a12 array of arc lengths from point 1 to point 2 (degrees).
+     * @param[out] lat2 array of latitudes of point 2 (degrees).
+     * @param[out] lon2 array of longitudes of point 2 (degrees).
+     * @param[out] azi2 array of (forward) azimuths at point 2 (degrees).
+     * @param[out] s12 array of distances from point 1 to point 2 (meters).
+     * @param[out] m12 array of reduced lengths of the geodesics (meters).
+     * @param[out] M12 array of geodesic scales of point 2 relative to point 1
+     *   (dimensionless).
+     * @param[out] M21 array of geodesic scales of point 1 relative to point 2
+     *   (dimensionless).
+     * @param[out] S12 array of areas under the geodesics (meters<sup>2</sup>).
+     *
+     * Point \e i, for \e i = 0, 1, ..., \e n &minus; 1, is at a distance (or
+     * arc length) \e i / (\e n &minus; 1) of the way from point 1 to point 3
+     * (see GeodesicLine::Distance); so the first and last points are points 1
+     * and 3.  If \e n = 1, point 1 is returned.  The treatment of the output
+     * arrays is the same as for PositionBatch.
+     *
+     * This is faster than PositionBatch because the sines and cosines of the
+     * equally spaced angles (the arc length or its counterpart for the
+     * distance) are found by a recurrence instead of being evaluated for
+     * each point.  The recurrence is restarted every 64 points to limit the
+     * buildup of roundoff errors; the results agree with those of
+     * PositionBatch to within the accuracy of GenPosition.
+     **********************************************************************/
+    void Waypoints(size_t n, bool arcmode, unsigned outmask,
+                   real a12[], real lat2[], real lon2[], real azi2[],
+                   real s12[], real m12[], real M12[], real M21[],
+                   real S12[]) const;
+
+    /**
+     * Densify the geodesic from point 1 to point 3 adaptively for plotting on
+     * a map.
+     *
+     * @tparam P the type of the projection.
+     * @param[in] proj the projection; proj(lat, lon, x, y) sets \e x and \e y
+     *   to the projected coordinates of (\e lat, \e lon).
+     * @param[in] tol the tolerance on the deviation of the polyline from the
+     *   projected geodesic (in the units of \e x and \e y).
+     * @param[out] lat the latitudes of the vertices of the polyline (degrees).
+     * @param[out] lon the longitudes of the vertices of the polyline
+     *   (degrees).
+     * @param[in] maxdepth the maximum number of times a segment is split
+     *   (default 12).
+     *
+     * The vertices are chosen by Densifier::Path with the parameter \e t
+     * being the arc length along the geodesic, so the position of point 3
+     * must have been set (see GeodesicLine::Arc).  The longitudes are
+     * unrolled, so that the polyline is continuous when it crosses the
+     * antimeridian.  For example, with a TransverseMercator object \e tm
+     * and a central meridian \e lon0, the projection could be given as
+     * \code
+     [&tm, lon0](real lat, real lon, real& x, real& y) -> void {
+       tm.Forward(lon0, lat, lon, x, y);
+     }
+     \endcode
+     * This typically gives many fewer vertices than a fixed spacing chosen
+     * so that the longest lines are rendered accurately.
+     **********************************************************************/
+    template<class P>
+    void Densify(const P& proj, real tol,
+                 std::vector<real>& lat, std::vector<real>& lon,
+                 unsigned maxdepth = 12) const {
+      Densifier::Path([this](real a12, real& lat2, real& lon2) -> void {
+                        real t;
+                        GenPosition(true, a12,
+                                    LATITUDE | LONGITUDE | LONG_UNROLL,
+                                    lat2, lon2, t, t, t, t, t, t);
+                      }, proj, Arc(), tol, maxdepth, lat, lon);
+    }
+    ///@}
+
+    /** \name Bounding regions for a portion of the geodesic
+     **********************************************************************/
+    ///@{
+
+    /**
+     * The latitude of the northern vertex of the geodesic.
+     *
+     * @return the maximum latitude (degrees) reached by the geodesic.
+     *
+     * The geodesic oscillates between latitudes &plusmn;\e lat0 where \e
+     * lat0 is found from its reduced latitude, &beta;<sub>0</sub> =
+     * cos<sup>&minus;1</sup> |sin&alpha;<sub>0</sub>|, where
+     * &alpha;<sub>0</sub> is the azimuth at the equator crossing.  No
+     * series evaluation is needed.
+     **********************************************************************/
+    Math::real VertexLatitude() const;
+
+    /**
+     * The general latitude-longitude bounding box of a portion of the
+     * geodesic.
+     *
+     * @param[in] arcmode boolean flag determining the meaning of \e s1_a1 and
+     *   \e s2_a2.
+     * @param[in] s1_a1 if \e arcmode is false, the distance from point 1 to
+     *   the start of the portion (meters); otherwise the arc length
+     *   (degrees).
+     * @param[in] s2_a2 likewise for the end of the portion.
+     * @param[out] latmin the minimum latitude (degrees).
+     * @param[out] latmax the maximum latitude (degrees).
+     * @param[out] lonmin the western edge of the box (degrees).
+     * @param[out] lonmax the eastern edge of the box (degrees).
+     *
+     * The latitude range is that of the endpoints extended to
+     * &plusmn;VertexLatitude() if the portion includes a vertex; the vertices
+     * are located from the spherical arc length so that the bound is tight.
+     * Because the longitude varies monotonically along a geodesic, the
+     * longitude range is that of the endpoints.  \e lonmin lies in
+     * [&minus;180&deg;, 180&deg;] and \e lonmax &minus; \e lonmin, the
+     * longitude extent, lies in [0&deg;, 360&deg;]; thus \e lonmax may
+     * exceed 180&deg; if the box straddles the antimeridian.  A box which
+     * covers all longitudes is returned with \e lonmin = &minus;180&deg;
+     * and \e lonmax = 180&deg;.  (A meridian passing over a pole gives a
+     * box 180&deg; wide.)
+     *
+     * The GeodesicLine object must have been constructed with \e caps |=
+     * GeodesicLine::LONGITUDE and, if \e arcmode is false, \e caps |=
+     * GeodesicLine::DISTANCE_IN; otherwise NaNs are returned.  The cost is
+     * that of two calls to GenPosition.
+     **********************************************************************/
+    void GenBoundingBox(bool arcmode, real s1_a1, real s2_a2,
+                        real& latmin, real& latmax,
+                        real& lonmin, real& lonmax) const;
+
+    /**
+     * The latitude-longitude bounding box of a portion of the geodesic.
+     *
+     * @param[in] s1 the distance from point 1 to the start of the portion
+     *   (meters).
+     * @param[in] s2 the distance from point 1 to the end of the portion
+     *   (meters).
+     * @param[out] latmin the minimum latitude (degrees).
+     * @param[out] latmax the maximum latitude (degrees).
+     * @param[out] lonmin the western edge of the box (degrees).
+     * @param[out] lonmax the eastern edge of the box (degrees).
+     *
+     * See GenBoundingBox.
+     **********************************************************************/
+    void BoundingBox(real s1, real s2,
+                     real& latmin, real& latmax,
+                     real& lonmin, real& lonmax) const {
+      GenBoundingBox(false, s1, s2, latmin, latmax, lonmin, lonmax);
+    }
+
+    /**
+     * The general bounding cap of a portion of the geodesic.
+     *
+     * @param[in] arcmode boolean flag determining the meaning of \e s1_a1 and
+     *   \e s2_a2.
+     * @param[in] s1_a1 if \e arcmode is false, the distance from point 1 to
+     *   the start of the portion (meters); otherwise the arc length
+     *   (degrees).
+     * @param[in] s2_a2 likewise for the end of the portion.
+     * @param[out] lat0 the latitude of the center of the cap (degrees).
+     * @param[out] lon0 the longitude of the center of the cap (degrees).
+     * @param[out] r the radius of the cap (meters).
+     *
+     * The center of the cap is the midpoint of the portion and its radius
+     * is half the length of the portion; thus every point of the portion
+     * lies within a geodesic distance \e r of the center.  Two portions of
+     * geodesics can only intersect if the distance between the centers of
+     * their caps is no more than the sum of their radii.  This distance is
+     * bounded below by the length of the chord between the centers which is
+     * cheap to compute (e.g., with Geocentric); thus this test avoids the
+     * inverse geodesic calculation for most distant pairs.
+     *
+     * The GeodesicLine object must have been constructed with \e caps |=
+     * GeodesicLine::LONGITUDE and, if \e arcmode is false, \e caps |=
+     * GeodesicLine::DISTANCE_IN, otherwise \e caps |=
+     * GeodesicLine::DISTANCE; otherwise NaNs are returned.
+     **********************************************************************/
+    void GenBoundingCap(bool arcmode, real s1_a1, real s2_a2,
+                        real& lat0, real& lon0, real& r) const;
+
+    /**
+     * The bounding cap of a portion of the geodesic.
+     *
+     * @param[in] s1 the distance from point 1 to the start of the portion
+     *   (meters).
+     * @param[in] s2 the distance from point 1 to the end of the portion
+     *   (meters).
+     * @param[out] lat0 the latitude of the center of the cap (degrees).
+     * @param[out] lon0 the longitude of the center of the cap (degrees).
+     * @param[out] r the radius of the cap (meters).
+     *
+     * See GenBoundingCap.
+     **********************************************************************/
+    void BoundingCap(real s1, real s2,
+                     real& lat0, real& lon0, real& r) const {
+      GenBoundingCap(false, s1, s2, lat0, lon0, r);
+    }
     ///@}
 
     /** \name Setting point 3
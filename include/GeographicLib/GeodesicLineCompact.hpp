@@ -0,0 +1,255 @@
+/**
+ * \file GeodesicLineCompact.hpp
+ * \brief Header for GeographicLib::GeodesicLineCompact class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_GEODESICLINECOMPACT_HPP)
+#define GEOGRAPHICLIB_GEODESICLINECOMPACT_HPP 1
+
+#include <GeographicLib/GeodesicLine.hpp>
+
+namespace GeographicLib {
+
+  /**
+   * \brief A geodesic line with a small memory footprint
+   *
+   * A GeodesicLine holds the coefficients of the series for the distance,
+   * longitude, and area along the geodesic, about 600 bytes.  This is
+   * wasteful for an application which holds many lines (e.g., the tracks of
+   * all the aircraft in flight) and only occasionally computes positions on
+   * each.  GeodesicLineCompact holds just the data needed to reconstruct the
+   * GeodesicLine: a pointer to the Geodesic object, the starting point, the
+   * azimuth and its sine and cosine, the distance and arc length to point 3,
+   * and the capabilities, 72 bytes in all (with doubles).
+   *
+   * The GeodesicLine is reconstructed (which costs about the same as a call
+   * to Geodesic::Direct) on each call to GenPosition and its variants and
+   * the results are identical to those of the original GeodesicLine.  When
+   * several points are needed on the same line, use PositionBatch or call
+   * Line() once and use the resulting GeodesicLine.
+   *
+   * A GeodesicLineCompact holds a pointer to the Geodesic object which
+   * created it and so it must not outlive that object.  The default copy
+   * constructor and assignment operators work with this class.
+   *
+   * Example of use:
+   * \code
+   * const Geodesic& geod = Geodesic::WGS84();
+   * std::vector<GeodesicLineCompact> flights;
+   * // JFK to LHR
+   * flights.push_back(GeodesicLineCompact(geod,
+   *                   geod.InverseLine(40.6, -73.8, 51.6, -0.5)));
+   * double lat, lon;
+   * // The position 1000 km along the track
+   * flights[0].Position(1000e3, lat, lon);
+   * \endcode
+   **********************************************************************/
+  class GEOGRAPHICLIB_EXPORT GeodesicLineCompact {
+  private:
+    typedef Math::real real;
+    const Geodesic* _g;
+    real _lat1, _lon1, _azi1, _salp1, _calp1, _a13, _s13;
+    unsigned _caps;
+  public:
+
+    /** \name Constructors
+     **********************************************************************/
+    ///@{
+
+    /**
+     * Constructor for a geodesic line starting at latitude \e lat1, longitude
+     * \e lon1, and azimuth \e azi1 (all in degrees).
+     *
+     * @param[in] g A Geodesic object used to compute the necessary
+     *   information about the GeodesicLine.
+     * @param[in] lat1 latitude of point 1 (degrees).
+     * @param[in] lon1 longitude of point 1 (degrees).
+     * @param[in] azi1 azimuth at point 1 (degrees).
+     * @param[in] caps bitor'ed combination of GeodesicLine::mask values
+     *   specifying the capabilities the GeodesicLine reconstructed from this
+     *   object should possess; the default is GeodesicLine::ALL.
+     *
+     * This is equivalent to the GeodesicLine constructor with the same
+     * arguments.
+     **********************************************************************/
+    GeodesicLineCompact(const Geodesic& g, real lat1, real lon1, real azi1,
+                        unsigned caps = GeodesicLine::ALL);
+
+    /**
+     * Constructor from a GeodesicLine.
+     *
+     * @param[in] g the Geodesic object used to create \e l.
+     * @param[in] l the GeodesicLine, e.g., the result of
+     *   Geodesic::InverseLine.
+     * @exception GeographicErr if \e l is initialized and \e g doesn't have
+     *   the same ellipsoid as \e l.
+     *
+     * The position of point 3 set for \e l is retained.
+     **********************************************************************/
+    GeodesicLineCompact(const Geodesic& g, const GeodesicLine& l);
+
+    /**
+     * A default constructor.  If GenPosition is called on the resulting
+     * object, it returns NaN (without doing any calculations).
+     **********************************************************************/
+    GeodesicLineCompact()
+      : _g(nullptr)
+      , _caps(0U)
+    {}
+    ///@}
+
+    /** \name Reconstructing the GeodesicLine
+     **********************************************************************/
+    ///@{
+    /**
+     * @return the GeodesicLine represented by this object (an uninitialized
+     *   GeodesicLine if this object is uninitialized).
+     **********************************************************************/
+    GeodesicLine Line() const;
+    ///@}
+
+    /** \name Computing positions
+     **********************************************************************/
+    ///@{
+    /**
+     * The general position function.
+     *
+     * The arguments and the returned value are the same as for
+     * GeodesicLine::GenPosition.
+     **********************************************************************/
+    Math::real GenPosition(bool arcmode, real s12_a12, unsigned outmask,
+                           real& lat2, real& lon2, real& azi2,
+                           real& s12, real& m12, real& M12, real& M21,
+                           real& S12) const
+    { return Line().GenPosition(arcmode, s12_a12, outmask, lat2, lon2, azi2,
+                                s12, m12, M12, M21, S12); }
+
+    /**
+     * Compute the position of point 2 which is a distance \e s12 (meters)
+     * from point 1.
+     *
+     * @param[in] s12 distance from point 1 to point 2 (meters); it can be
+     *   negative.
+     * @param[out] lat2 latitude of point 2 (degrees).
+     * @param[out] lon2 longitude of point 2 (degrees); requires that the
+     *   object was constructed with \e caps |= GeodesicLine::LONGITUDE.
+     * @return \e a12 arc length from point 1 to point 2 (degrees).
+     **********************************************************************/
+    Math::real Position(real s12, real& lat2, real& lon2) const {
+      real t;
+      return GenPosition(false, s12, GeodesicLine::LATITUDE |
+                         GeodesicLine::LONGITUDE,
+                         lat2, lon2, t, t, t, t, t, t);
+    }
+
+    /**
+     * Compute the position of point 2 which is a distance \e s12 (meters)
+     * from point 1.
+     *
+     * @param[in] s12 distance from point 1 to point 2 (meters); it can be
+     *   negative.
+     * @param[out] lat2 latitude of point 2 (degrees).
+     * @param[out] lon2 longitude of point 2 (degrees); requires that the
+     *   object was constructed with \e caps |= GeodesicLine::LONGITUDE.
+     * @param[out] azi2 (forward) azimuth at point 2 (degrees).
+     * @return \e a12 arc length from point 1 to point 2 (degrees).
+     **********************************************************************/
+    Math::real Position(real s12, real& lat2, real& lon2, real& azi2) const {
+      real t;
+      return GenPosition(false, s12, GeodesicLine::LATITUDE |
+                         GeodesicLine::LONGITUDE | GeodesicLine::AZIMUTH,
+                         lat2, lon2, azi2, t, t, t, t, t);
+    }
+
+    /**
+     * Compute the positions of several points on the geodesic.
+     *
+     * The arguments are the same as for GeodesicLine::PositionBatch.  The
+     * GeodesicLine is reconstructed once for all the points.
+     **********************************************************************/
+    void PositionBatch(size_t n, bool arcmode, const real s12_a12[],
+                       unsigned outmask,
+                       real a12[], real lat2[], real lon2[], real azi2[],
+                       real s12[], real m12[], real M12[], real M21[],
+                       real S12[]) const
+    { Line().PositionBatch(n, arcmode, s12_a12, outmask,
+                           a12, lat2, lon2, azi2, s12, m12, M12, M21, S12); }
+    ///@}
+
+    /** \name Setting point 3
+     **********************************************************************/
+    ///@{
+    /**
+     * Specify position of point 3 in terms of either distance or arc length.
+     *
+     * The arguments are the same as for GeodesicLine::GenSetDistance.
+     **********************************************************************/
+    void GenSetDistance(bool arcmode, real s13_a13);
+
+    /**
+     * Specify position of point 3 in terms of distance.
+     *
+     * @param[in] s13 the distance from point 1 to point 3 (meters).
+     **********************************************************************/
+    void SetDistance(real s13) { GenSetDistance(false, s13); }
+
+    /**
+     * Specify position of point 3 in terms of arc length.
+     *
+     * @param[in] a13 the arc length from point 1 to point 3 (degrees).
+     **********************************************************************/
+    void SetArc(real a13) { GenSetDistance(true, a13); }
+    ///@}
+
+    /** \name Inspector functions
+     **********************************************************************/
+    ///@{
+    /**
+     * @return true if the object has been initialized.
+     **********************************************************************/
+    bool Init() const { return _caps != 0U; }
+
+    /**
+     * @return \e lat1 the latitude of point 1 (degrees).
+     **********************************************************************/
+    Math::real Latitude() const
+    { return Init() ? _lat1 : Math::NaN(); }
+
+    /**
+     * @return \e lon1 the longitude of point 1 (degrees).
+     **********************************************************************/
+    Math::real Longitude() const
+    { return Init() ? _lon1 : Math::NaN(); }
+
+    /**
+     * @return \e azi1 the azimuth (degrees) of the geodesic line at point 1.
+     **********************************************************************/
+    Math::real Azimuth() const
+    { return Init() ? _azi1 : Math::NaN(); }
+
+    /**
+     * @return \e caps the computational capabilities of the reconstructed
+     *   GeodesicLine.
+     **********************************************************************/
+    unsigned Capabilities() const { return _caps; }
+
+    /**
+     * @return \e s13, the distance to point 3 (meters).
+     **********************************************************************/
+    Math::real Distance() const { return Init() ? _s13 : Math::NaN(); }
+
+    /**
+     * @return \e a13, the arc length to point 3 (degrees).
+     **********************************************************************/
+    Math::real Arc() const { return Init() ? _a13 : Math::NaN(); }
+    ///@}
+
+  };
+
+} // namespace GeographicLib
+
+#endif  // GEOGRAPHICLIB_GEODESICLINECOMPACT_HPP
@@ -518,6 +518,45 @@ namespace GeographicLib {
     GenPosition(bool arcmode, real s12_a12, unsigned outmask,
                 real& lat2, real& lon2, real& azi2,
                 real& s12, real& m12, real& M12, real& M21, real& S12) const;
+
+    /**
+     * Compute the positions of several points on the geodesic.
+     *
+     * @param[in] n the number of points.
+     * @param[in] arcmode boolean flag determining the meaning of \e s12_a12;
+     *   if \e arcmode is false, then the GeodesicLineExact object must have
+     *   been constructed with \e caps |= GeodesicLineExact::DISTANCE_IN.
+     * @param[in] s12_a12 array of distances (meters) from point 1, if \e
+     *   arcmode is false, or of arc lengths (degrees), if \e arcmode is true.
+     * @param[in] outmask a bitor'ed combination of GeodesicLineExact::mask
+     *   values specifying which of the following arrays should be set.
+     * @param[out] a12 array of arc lengths from point 1 to point 2 (degrees).
+     * @param[out] lat2 array of latitudes of point 2 (degrees).
+     * @param[out] lon2 array of longitudes of point 2 (degrees).
+     * @param[out] azi2 array of (forward) azimuths at point 2 (degrees).
+     * @param[out] s12 array of distances from point 1 to point 2 (meters).
+     * @param[out] m12 array of reduced lengths of the geodesics (meters).
+     * @param[out] M12 array of geodesic scales of point 2 relative to point 1
+     *   (dimensionless).
+     * @param[out] M21 array of geodesic scales of point 1 relative to point 2
+     *   (dimensionless).
+     * @param[out] S12 array of areas under the geodesics (meters<sup>2</sup>).
+     *
+     * All the arrays have (at least) \e n elements.  Element \e i of the
+     * outputs is the result which GeodesicLineExact::GenPosition returns for
+     * element \e i of \e s12_a12.  The series coefficients computed when the
+     * GeodesicLineExact object was constructed are shared by all the points so
+     * this is the efficient way to compute many points along a track.
+     * Quantities which the GeodesicLineExact object is not capable of
+     * computing are not stored.  Any of the output arrays may be null, in
+     * which case the corresponding quantity is not computed.  \e a12 is stored
+     * if \e a12 is not null.  The output arrays should not alias \e s12_a12.
+     **********************************************************************/
+    void PositionBatch(size_t n, bool arcmode, const real s12_a12[],
+                       unsigned outmask,
+                       real a12[], real lat2[], real lon2[], real azi2[],
+                       real s12[], real m12[], real M12[], real M21[],
+                       real S12[]) const;
     ///@}
 
     /** \name Setting point 3
@@ -0,0 +1,205 @@
+/**
+ * \file GeodesicRegion.hpp
+ * \brief Header for GeographicLib::GeodesicRegion class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_GEODESICREGION_HPP)
+#define GEOGRAPHICLIB_GEODESICREGION_HPP 1
+
+#include <string>
+#include <vector>
+#include <GeographicLib/Geodesic.hpp>
+#include <GeographicLib/Geocentric.hpp>
+#include <GeographicLib/Ellipsoid.hpp>
+#include <GeographicLib/ClosestPoint.hpp>
+#include <GeographicLib/PointInPolygon.hpp>
+#include <GeographicLib/Constants.hpp>
+
+#if defined(_MSC_VER)
+// Squelch warnings about dll vs vector
+#  pragma warning (push)
+#  pragma warning (disable: 4251)
+#endif
+
+namespace GeographicLib {
+
+  /**
+   * \brief A geodesic circle or polygon for covering with grid cells
+   *
+   * This describes a region of the ellipsoid, either a geodesic circle
+   * (the points within a given geodesic distance of a center) or a polygon
+   * whose edges are geodesics, and classifies boxes bounded by meridians
+   * and parallels as outside the region, inside it, or straddling its
+   * boundary.  It's used by Geohash::Cover, GARS::Cover, and Georef::Cover
+   * to find the cells of these grids which cover the region.  The cells are
+   * found by subdividing the grid hierarchically: cells outside the region
+   * are discarded, cells inside it are enumerated without further tests,
+   * and only the cells straddling the boundary are subdivided and tested
+   * again.
+   *
+   * The classification is conservative; a box is only reported as outside
+   * or inside the region if this is certain.  Let \e M be the center of the
+   * box.  The distance from \e M to any point of the box is at most \e R,
+   * the length of the path which follows the parallel through \e M and then
+   * a meridian.  For a circle, the box is outside if the distance from the
+   * center of the circle to \e M exceeds the radius by more than \e R and
+   * is inside if the distance plus \e R is less than the radius.  For a
+   * polygon, the box is outside or inside (according to whether \e M is
+   * inside the polygon) if the distance from \e M to each edge exceeds \e R;
+   * most edges are ruled out by the bounding caps used by
+   * ClosestPoint::Polyline and the remaining ones are checked with
+   * ClosestPoint::Segment.  As a result, a cover includes all the cells
+   * intersecting the region together with a few cells close to its
+   * boundary.
+   *
+   * GeodesicRegion objects are not altered once they have been constructed,
+   * so they can be shared by several threads.
+   *
+   * Example of use:
+   * \code
+   * // The geohashes of length 6 within 10 km of Paris
+   * GeodesicRegion paris(Geodesic::WGS84(), 48.857, 2.352, 10e3);
+   * std::vector<std::string> cells;
+   * Geohash::Cover(paris, 6, cells);
+   * \endcode
+   **********************************************************************/
+  class GEOGRAPHICLIB_EXPORT GeodesicRegion {
+  private:
+    typedef Math::real real;
+    friend class Geohash;
+    friend class GARS;
+    friend class Georef;
+    // The bounding cap of an edge of a polygon; the center is given in
+    // geocentric coordinates.
+    struct Cap {
+      real lat1, lon1, lat2, lon2;
+      real X, Y, Z, r;
+    };
+    // A level of a grid hierarchy; each cell of the previous level is
+    // divided into nlat x nlon cells.  If emit, these cells have codes with
+    // precision prec; otherwise the level only serves to speed up the
+    // subdivision.
+    struct Level {
+      int nlat, nlon, prec;
+      bool emit;
+    };
+    typedef void (*encoder)(real lat, real lon, int prec, std::string& code);
+    Geodesic _geod;
+    Ellipsoid _ell;
+    Geocentric _earth;
+    bool _polygon;
+    real _lat0, _lon0, _r;
+    std::vector<Cap> _caps;
+    PointInPolygon _pip;
+    ClosestPoint _closest;
+    void Descend(const Level levels[], int nlevels, int k,
+                 real lat1, real lon1, real dlat, real dlon, bool inside,
+                 encoder encode, bool compact,
+                 std::vector<std::string>& cells) const;
+    // Cover the globe divided by levels
+    void Cover(const Level levels[], int nlevels, encoder encode,
+               bool compact, std::vector<std::string>& cells) const;
+  public:
+
+    /**
+     * The results of Classify.
+     **********************************************************************/
+    enum classification {
+      /**
+       * The box lies outside the region.
+       * @hideinitializer
+       **********************************************************************/
+      OUTSIDE = 0,
+      /**
+       * The box may straddle the boundary of the region.
+       * @hideinitializer
+       **********************************************************************/
+      PARTIAL = 1,
+      /**
+       * The box lies inside the region.
+       * @hideinitializer
+       **********************************************************************/
+      INSIDE = 2,
+    };
+
+    /**
+     * Constructor for a geodesic circle.
+     *
+     * @param[in] geod the Geodesic object to use for geodesic calculations.
+     * @param[in] lat0 the latitude of the center (degrees).
+     * @param[in] lon0 the longitude of the center (degrees).
+     * @param[in] r the radius (meters).
+     *
+     * The region is the set of points whose geodesic distance from the
+     * center is at most \e r.
+     **********************************************************************/
+    GeodesicRegion(const Geodesic& geod, real lat0, real lon0, real r);
+
+    /**
+     * Constructor for a geodesic polygon.
+     *
+     * @param[in] geod the Geodesic object to use for geodesic calculations.
+     * @param[in] n the number of vertices of the polygon.
+     * @param[in] lat array of latitudes of the vertices (degrees).
+     * @param[in] lon array of longitudes of the vertices (degrees).
+     * @exception std::bad_alloc if the memory for the edges can't be
+     *   allocated.
+     *
+     * The polygon is closed by an edge from the last vertex to the first and
+     * its interior is defined as for PointInPolygon.  The distance from a
+     * point to an edge is found with ClosestPoint::Segment; so edges should
+     * be shorter than about a quarter of a meridian.
+     **********************************************************************/
+    GeodesicRegion(const Geodesic& geod, size_t n,
+                   const real lat[], const real lon[]);
+
+    /**
+     * Classify a box bounded by meridians and parallels.
+     *
+     * @param[in] lat1 the latitude of the southern edge (degrees).
+     * @param[in] lat2 the latitude of the northern edge (degrees).
+     * @param[in] lon1 the longitude of the western edge (degrees).
+     * @param[in] lon2 the longitude of the eastern edge (degrees).
+     * @return a GeodesicRegion::classification for the box.
+     *
+     * The box should satisfy &minus;90&deg; &le; \e lat1 &le; \e lat2 &le;
+     * 90&deg; and \e lon1 &le; \e lon2 &le; \e lon1 + 360&deg;.  The result
+     * is OUTSIDE or INSIDE only if the box certainly lies outside or inside
+     * the region (see the class description); otherwise it's PARTIAL.
+     **********************************************************************/
+    classification Classify(real lat1, real lat2, real lon1, real lon2) const;
+
+    /** \name Inspector functions
+     **********************************************************************/
+    ///@{
+    /**
+     * @return true if the region is a polygon, false if it is a circle.
+     **********************************************************************/
+    bool Polygon() const { return _polygon; }
+
+    /**
+     * @return \e a the equatorial radius of the ellipsoid (meters).  This is
+     *   the value inherited from the Geodesic object used in the constructor.
+     **********************************************************************/
+    Math::real EquatorialRadius() const { return _geod.EquatorialRadius(); }
+
+    /**
+     * @return \e f the flattening of the ellipsoid.  This is the value
+     *   inherited from the Geodesic object used in the constructor.
+     **********************************************************************/
+    Math::real Flattening() const { return _geod.Flattening(); }
+    ///@}
+
+  };
+
+} // namespace GeographicLib
+
+#if defined(_MSC_VER)
+#  pragma warning (pop)
+#endif
+
+#endif  // GEOGRAPHICLIB_GEODESICREGION_HPP
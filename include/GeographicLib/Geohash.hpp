@@ -10,6 +10,7 @@
 #if !defined(GEOGRAPHICLIB_GEOHASH_HPP)
 #define GEOGRAPHICLIB_GEOHASH_HPP 1
 
+#include <vector>
 #include <GeographicLib/Constants.hpp>
 
 #if defined(_MSC_VER)
@@ -20,6 +21,8 @@
 
 namespace GeographicLib {
 
+  class GeodesicRegion;
+
   /**
    * \brief Conversions for geohashes
    *
@@ -48,6 +51,13 @@ namespace GeographicLib {
 
   public:
 
+    /**
+     * The maximum length of a geohash (not counting the terminating null).
+     * A char array of size MAXLENGTH + 1 is large enough to hold any geohash
+     * produced by Forward (including "invalid").
+     **********************************************************************/
+    enum { MAXLENGTH = 18 };
+
     /**
      * Convert from geographic coordinates to a geohash.
      *
@@ -86,8 +96,113 @@ namespace GeographicLib {
      * similarly.)
      **********************************************************************/
     static void Reverse(const std::string& geohash, real& lat, real& lon,
+                        int& len, bool centerp = true) {
+      Reverse(geohash.data(), geohash.size(), lat, lon, len, centerp);
+    }
+
+    /**
+     * Convert from geographic coordinates to a geohash in a char array.
+     *
+     * @param[in] lat latitude of point (degrees).
+     * @param[in] lon longitude of point (degrees).
+     * @param[in] len the length of the resulting geohash.
+     * @param[out] geohash a char array of size at least MAXLENGTH + 1 to
+     *   receive the null-terminated geohash.
+     * @exception GeographicErr if \e lat is not in [&minus;90&deg;,
+     *   90&deg;].
+     * @return the length of the geohash.
+     *
+     * This gives the same result as the version of Forward which returns a
+     * std::string, but no memory is allocated (unless an exception is
+     * thrown).  If an exception is thrown, then \e geohash is unchanged.
+     **********************************************************************/
+    static int Forward(real lat, real lon, int len, char geohash[]);
+
+    /**
+     * Convert several geographic coordinates to geohashes.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lat array of latitudes (degrees).
+     * @param[in] lon array of longitudes (degrees).
+     * @param[in] len the length of the resulting geohashes.
+     * @param[out] geohash a char array of size at least \e n (MAXLENGTH + 1)
+     *   to receive the geohashes; the null-terminated geohash for point \e i
+     *   starts at \e geohash + \e i (MAXLENGTH + 1).
+     * @exception GeographicErr if any \e lat is not in [&minus;90&deg;,
+     *   90&deg;].
+     *
+     * This is equivalent to calling the char array version of Forward for
+     * each point.  If an exception is thrown, the geohashes for the points
+     * before the offending one have been written.
+     **********************************************************************/
+    static void ForwardBatch(size_t n, const real lat[], const real lon[],
+                             int len, char geohash[]);
+
+    /**
+     * Convert from a geohash given as a character array to geographic
+     * coordinates.
+     *
+     * @param[in] geohash pointer to the characters of the geohash.
+     * @param[in] n the number of characters (the string need not be null
+     *   terminated).
+     * @param[out] lat latitude of point (degrees).
+     * @param[out] lon longitude of point (degrees).
+     * @param[out] len the length of the geohash.
+     * @param[in] centerp if true (the default) return the center of the
+     *   geohash location, otherwise return the south-west corner.
+     * @exception GeographicErr if \e geohash contains illegal characters.
+     *
+     * This is the same as the version of Reverse taking a std::string, but
+     * no memory is allocated (unless an exception is thrown).
+     **********************************************************************/
+    static void Reverse(const char* geohash, size_t n, real& lat, real& lon,
                         int& len, bool centerp = true);
 
+    /**
+     * Convert several geohashes to geographic coordinates.
+     *
+     * @param[in] n the number of points.
+     * @param[in] geohash a char array holding the geohashes in the layout
+     *   produced by ForwardBatch; geohash \e i starts at \e geohash + \e i
+     *   (MAXLENGTH + 1) and is terminated by a null or by the end of its
+     *   MAXLENGTH + 1 characters.
+     * @param[out] lat array of latitudes (degrees).
+     * @param[out] lon array of longitudes (degrees).
+     * @param[out] len (optional) array of the lengths of the geohashes.
+     * @param[in] centerp if true (the default) return the centers of the
+     *   geohash locations, otherwise return the south-west corners.
+     * @exception GeographicErr if any of the geohashes contains illegal
+     *   characters.
+     *
+     * This is equivalent to calling Reverse for each point.  If an exception
+     * is thrown, the results for the points before the offending one have
+     * been written.
+     **********************************************************************/
+    static void ReverseBatch(size_t n, const char geohash[],
+                             real lat[], real lon[], int len[] = nullptr,
+                             bool centerp = true);
+
+    /**
+     * Find the geohashes covering a region.
+     *
+     * @param[in] region the GeodesicRegion to cover.
+     * @param[in] len the length of the geohashes.
+     * @param[out] cells the geohashes covering \e region.
+     * @param[in] compact if true, a coarser cell lying entirely inside \e
+     *   region is returned in place of its subcells (default false).
+     * @exception std::bad_alloc if the memory for \e cells can't be
+     *   allocated.
+     *
+     * Internally, \e len is first put in the range [0, 18].  The grid is
+     * subdivided hierarchically with GeodesicRegion::Classify; the cells
+     * returned include all those intersecting \e region together with a few
+     * cells close to its boundary.  If \e compact is false, all the cells have
+     * the same precision; if it's true, the cells inside the region may be
+     * larger.
+     **********************************************************************/
+    static void Cover(const GeodesicRegion& region, int len,
+                      std::vector<std::string>& cells, bool compact = false);
+
     /**
      * The latitude resolution of a geohash.
      *
@@ -12,7 +12,15 @@
 
 #include <vector>
 #include <fstream>
+#include <memory>
+#include <list>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
+#include <future>
 #include <GeographicLib/Constants.hpp>
+#include <GeographicLib/MemoryPolicy.hpp>
+#include <GeographicLib/StridedView.hpp>
 
 #if defined(_MSC_VER)
 // Squelch warnings about dll vs vector and constant conditional expressions
@@ -70,7 +78,14 @@ namespace GeographicLib {
    * threadsafe parameter to true in the constructor.  This causes the
    * constructor to read all the data into memory and to turn off the
    * single-cell caching which results in a Geoid object which \e is thread
-   * safe.
+   * safe.  A third possibility is to set the optional \e mapfile parameter to
+   * true in the constructor.  This memory maps the data file instead of
+   * reading it; the data is then shared with other processes (via the page
+   * cache) and read on demand, and the resulting Geoid object is also thread
+   * safe.  Finally, setting the optional \e concurrent parameter to true
+   * gives a thread safe object which reads the data file with positioned
+   * reads (e.g., pread) and keeps a separate single-cell cache for each
+   * thread; this needs no more memory than the default.
    *
    * Example of use:
    * \include example-Geoid.cpp
@@ -91,6 +106,9 @@ namespace GeographicLib {
     static const unsigned pixel_size_ = 4;
     static const unsigned pixel_max_ = 0xffffffffu;
 #endif
+    // The storage for the area cache; the rows are contiguous
+    typedef std::vector<pixel_t, MemoryPolicy::Allocator<pixel_t> >
+    cachearray;
     static const unsigned stencilsize_ = 12;
     static const unsigned nterms_ = ((3 + 1) * (3 + 2))/2; // for a cubic fit
     static const int c0_;
@@ -110,35 +128,128 @@ namespace GeographicLib {
     int _width, _height;
     unsigned long long _datastart, _swidth;
     bool _threadsafe;
-    // Area cache
-    mutable std::vector< std::vector<pixel_t> > _data;
+    // Memory mapped data file
+    const unsigned char* _map;
+    unsigned long long _mapsize;
+    void* _maphandle;           // The file mapping handle on Windows
+    unsigned long long _maplength; // The length of the file to map
+    bool _embedded;             // _map points to data in the library
+    // GTX and GeoTIFF grids are memory mapped and read in place.  _vsize is
+    // the size of a value in bytes (0 for the PGM format); row iy of the grid
+    // starts at byte _rowstart + iy * _rowstride of the file and column ix is
+    // column ix + _xshift (mod _width) of the file.
+    unsigned _vsize;
+    bool _vbigendian;
+    long long _rowstart, _rowstride;
+    int _xshift;
+    // Positioned reads and per-thread cell caches
+    bool _concurrent;
+    int _fd;                    // The file descriptor on POSIX systems
+    void* _filehandle;          // The file handle on Windows
+    unsigned long long _id;     // Identifies the object in the cell caches
+    // Area cache; this is shared by copies of the object until one of them
+    // changes its cache
+    mutable std::shared_ptr<cachearray> _data;
     mutable bool _cache;
     // NE corner and extent of cache
     mutable int _xoffset, _yoffset, _xsize, _ysize;
+    // The copies of the cache of a thread safe object for each NUMA node if
+    // MemoryPolicy::Replicate() (null for the node holding _data)
+    std::vector< std::shared_ptr<const cachearray> > _replicas;
+    // The fits for the cells of the area cache whose stencils lie in the
+    // cache (if _cachefits); these are shared in the same way as _data
+    mutable bool _cachefits;
+    mutable std::shared_ptr< const std::vector<real> > _fits;
+    // Tile cache; the list is in order of use (most recent first) and the
+    // map is keyed by the tile number
+    struct tile {
+      long long key;
+      int width;
+      std::vector<pixel_t> data;
+    };
+    mutable std::list<tile> _tiles;
+    mutable std::unordered_map<long long, std::list<tile>::iterator>
+    _tileindex;
+    mutable std::mutex _tilemutex; // Used if _concurrent
+    mutable int _tilew, _tileh;
+    mutable size_t _maxtiles;      // 0 means no tile cache
+    mutable std::atomic<unsigned long long> _tilehits, _tilemisses;
+    // Compressed data file; tile offsets are relative to _tilestart
+    bool _compressed;
+    std::vector<unsigned long long> _tileoffsets;
+    unsigned long long _tilestart;
+    // The default memory budget for the tiles of a compressed file
+    static const unsigned long long tilebudget_ = 1ULL << 22;
+    // HeightBatch reading directly from the file: the number of cells whose
+    // grid nodes are gathered together and the largest gap (in pixels)
+    // between nodes which is read through rather than starting a new read.
+    static const size_t batchcells_ = 256;
+    static const unsigned long long batchgap_ = 1024;
     // Cell cache
     mutable int _ix, _iy;
-    mutable real _v00, _v01, _v10, _v11;
-    mutable real _t[nterms_];
+    mutable real _t[nterms_];   // The first 4 elements for bilinear
+    // Asynchronous loading of the area cache.  An area loaded on another
+    // thread is held in _asyncarea until the next height computation
+    // installs it.  The requests are numbered so that an area is only
+    // installed if it's newer than the cache in use.
+    struct areacache {
+      std::shared_ptr<cachearray> data;
+      std::shared_ptr< const std::vector<real> > fits;
+      int xoffset, yoffset, xsize, ysize;
+      unsigned long long seq;
+    };
+    mutable std::mutex _asyncmutex;
+    mutable std::atomic<bool> _asyncready;
+    mutable areacache _asyncarea;
+    mutable std::vector< std::shared_future<void> > _asyncloads;
+    mutable unsigned long long _asyncseq, _cacheseq;
+    // The area most recently requested (used by Prefetch); _reqwidth is the
+    // extent in longitude
+    mutable real _reqsouth, _reqwest, _reqnorth, _reqwidth;
+    void installarea() const;
+    void requestarea(real south, real west, real north, real east) const;
+    bool requested(real lat, real lon) const;
     void filepos(int ix, int iy) const {
       _file.seekg(std::streamoff
                   (_datastart +
                    pixel_size_ * (unsigned(iy)*_swidth + unsigned(ix))));
     }
+    // The position of a node in the area cache (or -1 if it's not cached);
+    // ix is in [0, _width)
+    long long cacheindex(int ix, int iy) const {
+      return _cache && iy >= _yoffset && iy < _yoffset + _ysize &&
+        ((ix >= _xoffset && ix < _xoffset + _xsize) ||
+         (ix + _width >= _xoffset && ix + _width < _xoffset + _xsize)) ?
+        (long long)(iy - _yoffset) * _xsize +
+        (ix >= _xoffset ? ix - _xoffset : ix + _width - _xoffset) : -1;
+    }
     real rawval(int ix, int iy) const {
       if (ix < 0)
         ix += _width;
       else if (ix >= _width)
         ix -= _width;
-      if (_cache && iy >= _yoffset && iy < _yoffset + _ysize &&
-          ((ix >= _xoffset && ix < _xoffset + _xsize) ||
-           (ix + _width >= _xoffset && ix + _width < _xoffset + _xsize))) {
-        return real(_data[iy - _yoffset]
-                    [ix >= _xoffset ? ix - _xoffset : ix + _width - _xoffset]);
+      long long k = cacheindex(ix, iy);
+      if (k >= 0) {
+        return real((*_data)[size_t(k)]);
       } else {
         if (iy < 0 || iy >= _height) {
           iy = iy < 0 ? -iy : 2 * (_height - 1) - iy;
           ix += (ix < _width/2 ? 1 : -1) * _width/2;
         }
+        if (_map) {
+          if (_vsize)
+            return vendorval(ix, iy);
+          const unsigned char* p = _map + _datastart +
+            pixel_size_ * (unsigned(iy)*_swidth + unsigned(ix));
+          unsigned r = (unsigned(p[0]) << 8) | unsigned(p[1]);
+          if (pixel_size_ == 4)
+            r = (r << 16) | (unsigned(p[2]) << 8) | unsigned(p[3]);
+          return real(r);
+        }
+        if (_maxtiles)
+          return tileval(ix, iy);
+        if (_concurrent)
+          return preadval(ix, iy);
         try {
           filepos(ix, iy);
           // initial values to suppress warnings in case get fails
@@ -166,9 +277,52 @@ namespace GeographicLib {
         }
       }
     }
+    void cellpos(real lat, real lon,
+                 int& ix, int& iy, real& fx, real& fy) const;
+    void cellfit(int ix, int iy, real t[]) const;
+    template<class F> void cellfit(int ix, int iy, real t[], F val) const;
+    void fitarea() const;
+    const real* cachedfit(int ix, int iy) const;
+    real celleval(const real t[], real fx, real fy) const;
     real height(real lat, real lon) const;
-    Geoid(const Geoid&) = delete;            // copy constructor not allowed
+    real preadval(int ix, int iy) const;
+    void preadbytes(unsigned long long off, unsigned char p[], size_t n)
+      const;
+    void readrun(unsigned long long k, size_t n, pixel_t v[]) const;
+    unsigned long long nodeindex(int ix, int iy) const {
+      // The position of node (ix, iy) in the file; see rawval
+      if (ix < 0)
+        ix += _width;
+      else if (ix >= _width)
+        ix -= _width;
+      if (iy < 0 || iy >= _height) {
+        iy = iy < 0 ? -iy : 2 * (_height - 1) - iy;
+        ix += (ix < _width/2 ? 1 : -1) * _width/2;
+      }
+      return (unsigned long long)(iy) * _swidth + unsigned(ix);
+    }
+    // CA and A are the types of the input and output arrays, pointers or
+    // StridedViews.
+    template<class CA, class A>
+    void IntHeightBatch(size_t n, CA lat, CA lon, A h) const;
+    template<class A>
+    void gatherbatch(const std::vector< std::pair<long long, size_t> >& pts,
+                     const std::vector<real>& fxy, A h) const;
+    real tileval(int ix, int iy) const;
+    real vendorval(int ix, int iy) const;
+    void readgtx();
+    void readtiff();
+    void vendorgrid(real lat0, real lon0, real dlat, real dlon,
+                    int nrows, int ncols);
+    void tilebudget(unsigned long long maxbytes) const;
+    // Identifies the data in a cache snapshot
+    std::string snapidentity() const;
+    void mapdata();
+    void unmapdata();
+    void opendata();
+    void closedata();
     Geoid& operator=(const Geoid&) = delete; // copy assignment not allowed
+    friend class GeoidPyramid; // GeoidPyramid::Coarsen reads the raw data
   public:
 
     /**
@@ -204,20 +358,120 @@ namespace GeographicLib {
      *   true (the default) means cubic.
      * @param[in] threadsafe (optional), if true, construct a thread safe
      *   object.  The default is false
+     * @param[in] mapfile (optional), if true, memory map the data file; this
+     *   also results in a thread safe object.  The default is false.
+     * @param[in] concurrent (optional), if true, read the data file with
+     *   positioned reads and use a separate single-cell cache for each
+     *   thread; this also results in a thread safe object.  The default is
+     *   false.
      * @exception GeographicErr if the data file cannot be found, is
      *   unreadable, or is corrupt.
      * @exception GeographicErr if \e threadsafe is true but the memory
      *   necessary for caching the data can't be allocated.
+     * @exception GeographicErr if \e mapfile is true but the data file cannot
+     *   be memory mapped (this is always the case for a compressed file).
+     * @exception GeographicErr if \e concurrent is true but positioned reads
+     *   are not supported.
      *
-     * The data file is formed by appending ".pgm" to the name.  If \e path is
+     * The data file is formed by appending ".pgm" to the name; if this file
+     * doesn't exist, the compressed file given by appending ".pgc" to the name
+     * is used instead (see \ref geoidformat).  Failing that, a grid in the
+     * GTX format (".gtx") or an uncompressed GeoTIFF (".tif") is used; see
+     * below.  The data in a compressed file
+     * is always read via a tile cache of CacheTiles (with a default memory
+     * budget of 4 MB); the tile size is fixed by the file.  If \e path is
      * specified (and is non-empty), then the file is loaded from directory, \e
      * path.  Otherwise the path is given by DefaultGeoidPath().  If the \e
      * threadsafe parameter is true, the data set is read into memory, the data
      * file is closed, and single-cell caching is turned off; this results in a
-     * Geoid object which \e is thread safe.
+     * Geoid object which \e is thread safe.  If the \e mapfile parameter is
+     * true, the data file is memory mapped (read only) instead; the data is
+     * then paged in by the operating system as needed and is shared with
+     * other processes mapping the same file.  Single-cell caching is turned
+     * off and the resulting Geoid object is thread safe; \e threadsafe is
+     * ignored in this case.  Memory mapping is supported on POSIX systems and
+     * on Windows.
+     *
+     * If the \e concurrent parameter is true (and \e mapfile is false), the
+     * data not in the cache is read with positioned reads (pread on POSIX
+     * systems) which don't disturb a shared file position, and the
+     * single-cell cache is kept separately for each thread.  Thus several
+     * threads can compute heights at the same time without reading all the
+     * data into memory; \e threadsafe is ignored in this case.  CacheArea,
+     * CacheTiles, and CacheClear may be called on such an object, but not
+     * while other threads are computing heights.
+     *
+     * A GTX or GeoTIFF grid is always memory mapped (as if \e mapfile were
+     * true) and the values are read in place, so that these grids can be
+     * used without conversion.  The grid must be global with the grid
+     * points at the poles; the first longitude may be any multiple of the
+     * longitude spacing and a repeated column at 360&deg; is ignored.  A GTX
+     * file holds 4-byte big-endian floats with the rows running from south
+     * to north.  A GeoTIFF file must be a classic (not BigTIFF) file with a
+     * single band of 4- or 8-byte floats stored uncompressed in contiguous
+     * strips running from north to south, and it must give the grid
+     * position with the ModelTiepoint and ModelPixelScale tags; both
+     * PixelIsArea and PixelIsPoint rasters are supported.  Offset() and
+     * Scale() are 0 and 1 and the errors are unknown for such grids.
+     * Regional grids aren't supported.
+     *
+     * If \e path is empty and the (uncompressed) data file was compiled into
+     * the library (with the cmake option GEOGRAPHICLIB_EMBED_GEOIDS), the
+     * embedded copy is used in place, as though it were memory mapped; no
+     * file is read.  GeoidFile() then returns "embedded:geoids/" followed by
+     * the file name.
      **********************************************************************/
     explicit Geoid(const std::string& name, const std::string& path = "",
-                   bool cubic = true, bool threadsafe = false);
+                   bool cubic = true, bool threadsafe = false,
+                   bool mapfile = false, bool concurrent = false);
+
+    /**
+     * The destructor unmaps or closes the data file.
+     **********************************************************************/
+    ~Geoid();
+
+    /**
+     * Copy a geoid.
+     *
+     * @param[in] g the Geoid object to copy.
+     * @exception GeographicErr if the data file cannot be reopened or
+     *   remapped.
+     *
+     * The copy shares the data which \e g holds in memory (the cache set up
+     * by CacheArea or CacheAll, including the whole data set for a thread
+     * safe object), so copying is cheap even for a large geoid.  The copy
+     * opens (or memory maps) the data file afresh and has its own
+     * single-cell cache and tile cache (initially empty, with the same
+     * budget as \e g).  Thus a thread which can't share a Geoid object can
+     * use a copy of one instead; e.g., give each thread a copy of a Geoid on
+     * which CacheAll has been called, and the data set is held in memory
+     * just once.  Changing the cache of either object with CacheArea,
+     * CacheAll, or CacheClear doesn't affect the other.
+     **********************************************************************/
+    Geoid(const Geoid& g);
+
+    /**
+     * A shared thread safe instance of Geoid.
+     *
+     * @param[in] name the name of the geoid.
+     * @param[in] path (optional) directory for data file.
+     * @param[in] cubic (optional) interpolation method; false means bilinear,
+     *   true (the default) means cubic.
+     * @exception GeographicErr if the data file cannot be found, is
+     *   unreadable, or is corrupt, or if the memory necessary for caching
+     *   the data can't be allocated.
+     * @return a Geoid object constructed with \e threadsafe = true.
+     *
+     * The first call with a given \e name, directory, and \e cubic
+     * constructs the object, reading all the data into memory, and later
+     * calls (on any thread) return the same object; see SharedInstances for
+     * the details.  An empty \e path is the same as DefaultGeoidPath().  The
+     * object lives until the program exits.  Because the object is thread
+     * safe, it can't be used with CacheArea, CacheAll, or CacheClear.
+     **********************************************************************/
+    static const Geoid& Get(const std::string& name,
+                            const std::string& path = "",
+                            bool cubic = true);
 
     /**
      * Set up a cache.
@@ -232,13 +486,15 @@ namespace GeographicLib {
      *   can't be allocated (in this case, you will have no cache and can try
      *   again with a smaller area).
      * @exception GeographicErr if there's a problem reading the data.
-     * @exception GeographicErr if this is called on a threadsafe Geoid.
+     * @exception GeographicErr if this is called on a threadsafe Geoid
+     *   (including one with a memory mapped data file).
      *
      * Cache the data for the specified "rectangular" area bounded by the
      * parallels \e south and \e north and the meridians \e west and \e east.
      * \e east is always interpreted as being east of \e west, if necessary by
      * adding 360&deg; to its value.  \e south and \e north should be in
-     * the range [&minus;90&deg;, 90&deg;].
+     * the range [&minus;90&deg;, 90&deg;].  This replaces any cache (including
+     * a tile cache) previously set up.
      **********************************************************************/
     void CacheArea(real south, real west, real north, real east) const;
 
@@ -259,11 +515,174 @@ namespace GeographicLib {
                                       real( Math::qd), real(Math::td)); }
 
     /**
-     * Clear the cache.  This never throws an error.  (This does nothing with a
-     * thread safe Geoid.)
+     * Set up a cache, reading the data on another thread.
+     *
+     * @param[in] south latitude (degrees) of the south edge of the cached
+     *   area.
+     * @param[in] west longitude (degrees) of the west edge of the cached area.
+     * @param[in] north latitude (degrees) of the north edge of the cached
+     *   area.
+     * @param[in] east longitude (degrees) of the east edge of the cached area.
+     * @exception GeographicErr if this is called on a threadsafe Geoid
+     *   (including one constructed with \e concurrent = true).
+     * @exception GeographicErr if the data file cannot be reopened.
+     * @exception std::system_error if the thread can't be created.
+     * @return a future which becomes ready when the data has been read; its
+     *   get() member function rethrows any of the exceptions of CacheArea.
+     *
+     * This returns at once.  The area is read by a copy of this object (see
+     * Geoid(const Geoid&)) on a new thread, so that the heights can be
+     * computed in the meantime (using the existing cache).  Once the data
+     * has been read, the next computation of the heights installs it as
+     * the cache, giving the same results as CacheArea(\e south, \e west, \e
+     * north, \e east).  Installing the cache just replaces a pointer, so
+     * the heights never wait for the data to be read.  If there are several
+     * requests, only the most recent completed one is installed and a
+     * request made before a call to CacheArea, CacheAll, CacheTiles, or
+     * CacheClear is discarded.  The destructor waits for the outstanding
+     * requests to finish.
+     **********************************************************************/
+    std::shared_future<void> CacheAreaAsync(real south, real west,
+                                            real north, real east) const;
+
+    /**
+     * Prefetch the data ahead of a moving platform.
+     *
+     * @param[in] lat latitude of the platform (degrees).
+     * @param[in] lon longitude of the platform (degrees).
+     * @param[in] azi the heading of the platform (degrees).
+     * @param[in] distance the look-ahead distance (meters).
+     * @exception GeographicErr if \e distance isn't positive.
+     * @exception GeographicErr if this is called on a threadsafe Geoid
+     *   (including one constructed with \e concurrent = true).
+     * @exception std::system_error if the thread can't be created.
+     * @return the future returned by CacheAreaAsync if a request was made;
+     *   otherwise an invalid future.
+     *
+     * The track of the platform is taken to be the geodesic on the WGS84
+     * ellipsoid starting at (\e lat, \e lon) with azimuth \e azi.  If the
+     * first \e distance of the track doesn't lie in the area most recently
+     * requested (with CacheArea, CacheAll, CacheAreaAsync, or Prefetch),
+     * this calls CacheAreaAsync for the area covering the first 2 \e
+     * distance of the track with a margin of \e distance/2 on each side.
+     * Otherwise (the usual case), this does nothing; this check is cheap,
+     * so Prefetch can be called with each update of the position.  \e
+     * distance should be chosen so that the platform takes longer to travel
+     * \e distance than it takes to read the data.  Thus for an aircraft
+     * flying at 250 m/s, \e distance = 100 km gives 400 s for the data to
+     * be read; each request is then for an area about 300 km long and 100
+     * km wide.
+     **********************************************************************/
+    std::shared_future<void> Prefetch(real lat, real lon, real azi,
+                                      real distance) const;
+
+    /**
+     * Set up a cache of tiles.
+     *
+     * @param[in] maxbytes the memory budget for the tiles (bytes).
+     * @param[in] tilesize (optional) the size of the tiles (degrees); the
+     *   default is 1&deg;.
+     * @exception GeographicErr if this is called on a threadsafe Geoid
+     *   (except one constructed with \e concurrent = true).
+     * @exception GeographicErr if \e tilesize is not positive.  (\e tilesize
+     *   is ignored for a compressed data file.)
+     * @exception GeographicErr if there's a problem reading the data (when
+     *   the heights are computed).
+     *
+     * The grid is divided into tiles of approximately \e tilesize &times; \e
+     * tilesize.  When a height is computed, the tiles holding the necessary
+     * data are read into memory (if they are not already present).  If the
+     * total size of the tiles would exceed \e maxbytes, the least recently
+     * used tile is discarded; at least one tile is always kept.  Unlike
+     * CacheArea, this keeps the working set in memory as the points of
+     * interest move about the globe.  This replaces any cache previously set
+     * up.  With a Geoid constructed with \e concurrent = true, access to the
+     * tiles is serialized with a mutex.
+     **********************************************************************/
+    void CacheTiles(unsigned long long maxbytes, real tilesize = 1) const;
+
+    /**
+     * Precompute the fits for the cells of the area cache.
+     *
+     * @param[in] fits whether to precompute the fits (default true).
+     * @exception GeographicErr if this is called on a threadsafe Geoid.
+     * @exception GeographicErr if the memory for the fits can't be
+     *   allocated (in this case, the area cache is cleared).
+     *
+     * Computing a height at a point in a new cell requires fitting a
+     * polynomial to the surrounding grid points; for the cubic
+     * interpolation, this is a least-squares fit to 12 points which is the
+     * dominant cost of computing the height if the points are scattered
+     * randomly over the cached area.  If \e fits is true, the 10
+     * coefficients of the fit (4 for bilinear interpolation, where there's
+     * no benefit since the coefficients are the grid values) are computed
+     * for all the cells of the area cache, now and whenever the cache is
+     * set by CacheArea, CacheAll, or CacheAreaAsync, and the heights are
+     * found using these coefficients.  The results are unchanged.  This
+     * uses 80 bytes per cell (with doubles) for the cubic interpolation,
+     * i.e., 40 times the memory of the area cache itself; so this is only
+     * suitable for small areas (or coarse grids).  Clearing the cache
+     * releases the fits but leaves this setting in effect.  For a 10&deg;
+     * &times; 10&deg; area of a 5' grid with random points, the time per
+     * height is reduced by about 25%; there's no change for clustered
+     * points since the fit is then rarely recomputed.
+     **********************************************************************/
+    void CacheFits(bool fits = true) const;
+
+    /**
+     * Clear the cache (including a tile cache; for a compressed data file, the
+     * tile cache is reset with the default memory budget).  This never throws
+     * an error.  This also discards the areas being read by CacheAreaAsync.
+     * (This does nothing with a thread safe Geoid, except one constructed with
+     * \e concurrent = true.)
      **********************************************************************/
     void CacheClear() const;
 
+    /**
+     * Save the cache to a snapshot file.
+     *
+     * @param[in] filename the name of the snapshot file.
+     * @param[in] fits (optional) whether to include the fits for the cells
+     *   of the area cache if these have been computed (see CacheFits); the
+     *   default is true.
+     * @exception GeographicErr if the file can't be written.
+     *
+     * The snapshot holds the area cache (its bounds and data and,
+     * optionally, the fits) or, if there's no area cache, the tile cache
+     * (the tile size, the memory budget, and the tiles in order of use).
+     * The data is written as it is held in memory, so the snapshot can only
+     * be read by a Geoid on a machine with the same architecture and with
+     * the same precision and pixel size.  If there's no cache, the snapshot
+     * records this.
+     **********************************************************************/
+    void SaveCache(const std::string& filename, bool fits = true) const;
+
+    /**
+     * Install a cache from a snapshot file.
+     *
+     * @param[in] filename the name of the snapshot file written by SaveCache.
+     * @exception GeographicErr if this is called on a threadsafe Geoid.
+     * @exception GeographicErr if the file can't be read, is corrupt, or
+     *   was written for a different data file, interpolation method, or
+     *   architecture.
+     * @exception GeographicErr if the memory for the cache can't be
+     *   allocated.
+     *
+     * The snapshot is memory mapped (if possible) and the cache is copied
+     * from it in one pass, so that a process can resume with the cache
+     * which an earlier process warmed without reading the data file again.
+     * The Geoid must have been constructed with the same data file and
+     * interpolation method as the one which wrote the snapshot.  This
+     * replaces any cache previously set up, with the same effect as the
+     * CacheArea or CacheTiles calls which built the saved cache.  If the
+     * snapshot includes fits, these are installed if CacheFits is in
+     * effect (otherwise they are skipped); if it doesn't and CacheFits is
+     * in effect, the fits are computed.  If an exception is thrown, the
+     * cache is unchanged (except for a failure to compute the fits, in
+     * which case the cache is cleared).
+     **********************************************************************/
+    void LoadCache(const std::string& filename) const;
+
     ///@}
 
     /** \name Compute geoid heights
@@ -285,6 +704,58 @@ namespace GeographicLib {
       return height(lat, lon);
     }
 
+    /**
+     * Compute the geoid heights at several points.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lat array of latitudes of the points (degrees).
+     * @param[in] lon array of longitudes of the points (degrees).
+     * @param[out] h array of heights of the geoid above the ellipsoid
+     *   (meters).
+     * @exception GeographicErr if there's a problem reading the data; this
+     *   never happens if (\e lat, \e lon) are all within a successfully
+     *   cached area.
+     *
+     * The results are the same as calling operator()() for each point.
+     * However, unless all the data is in memory, the points are grouped by
+     * grid cell, so that the data for each cell is only fetched and fitted
+     * once (otherwise consecutive points in the same cell share the fit).
+     * This greatly reduces the cost of computing many heights in a limited
+     * region without a cache.  The single-cell cache is neither
+     * used nor altered, so this may be called concurrently on a thread safe
+     * Geoid.  A NaN latitude or longitude results in a NaN height.
+     *
+     * If the data is read directly from the file (no cache, tile cache, or
+     * memory mapping), the grid nodes needed by the cells are gathered in
+     * blocks of 256 cells, sorted by their position in the file, and merged
+     * into runs (reading through gaps of up to 1024 pixels); each run is
+     * then a single read (a positioned read for a concurrent Geoid).  This
+     * replaces the separate read of each node; the number of reads is at
+     * least halved and, for a dense batch, is reduced by several orders of
+     * magnitude, while needing only a modest buffer.
+     **********************************************************************/
+    void HeightBatch(size_t n, const real lat[], const real lon[],
+                     real h[]) const;
+
+    /**
+     * Compute the geoid heights at several points with the coordinates in
+     * strided arrays.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lat view of the latitudes (degrees).
+     * @param[in] lon view of the longitudes (degrees).
+     * @param[out] h view of the heights of the geoid above the ellipsoid
+     *   (meters).
+     * @exception GeographicErr if there's a problem reading the data.
+     *
+     * This is the same as the other version of HeightBatch except that the
+     * arrays are StridedView objects; e.g., the coordinates can be taken
+     * from an interleaved buffer.
+     **********************************************************************/
+    void HeightBatch(size_t n,
+                     StridedView<const real> lat, StridedView<const real> lon,
+                     StridedView<real> h) const;
+
     /**
      * Convert a height above the geoid to a height above the ellipsoid and
      * vice versa.
@@ -308,6 +779,39 @@ namespace GeographicLib {
 
     ///@}
 
+    /** \name Memory usage and cost
+     **********************************************************************/
+    ///@{
+    /**
+     * @return the number of bytes of memory held by the object.
+     *
+     * This includes the area cache (see CacheArea) with its copies for the
+     * NUMA nodes and its precomputed fits (see CacheFits), an area being
+     * read by CacheAreaAsync, the tile cache (see CacheTiles), and the
+     * offsets of the tiles of a compressed file.  The area cache and the
+     * fits are included even though they may be shared with copies of the
+     * object.  A memory mapped data file, data embedded in the library, and
+     * the per-thread single-cell caches of a concurrent object aren't
+     * included.  This should not be called while the cache is being changed
+     * on another thread.
+     **********************************************************************/
+    size_t MemoryUsage() const;
+
+    /**
+     * @return the approximate number of floating point operations needed to
+     *   compute the height at a point in a grid cell which hasn't been
+     *   fitted.
+     *
+     * This includes finding the cell, fitting the 4 (bilinear) or 12
+     * (cubic) grid values around the cell (unless the fits are cached, see
+     * CacheFits), and evaluating the fit.  Subsequent heights in the same
+     * cell need only about 24 (bilinear) or 34 (cubic) operations.  The cost
+     * of fetching the grid values, which may dominate if they aren't in
+     * memory, isn't included.
+     **********************************************************************/
+    unsigned long long CostEstimate() const;
+    ///@}
+
     /** \name Inspector functions
      **********************************************************************/
     ///@{
@@ -381,13 +885,62 @@ namespace GeographicLib {
     /**
      * @return true if the object is constructed to be thread safe.
      **********************************************************************/
-    bool ThreadSafe() const { return _threadsafe; }
+    bool ThreadSafe() const { return _threadsafe || _concurrent; }
+
+    /**
+     * @return true if the data file is memory mapped.
+     **********************************************************************/
+    bool MemoryMapped() const { return _map != nullptr; }
+
+    /**
+     * @return true if the object uses positioned reads and per-thread
+     *   single-cell caches.
+     **********************************************************************/
+    bool Concurrent() const { return _concurrent; }
+
+    /**
+     * @return true if the data file is in the compressed (pgc) format.
+     **********************************************************************/
+    bool Compressed() const { return _compressed; }
 
     /**
      * @return true if a data cache is active.
      **********************************************************************/
     bool Cache() const { return _cache; }
 
+    /**
+     * @return true if a tile cache is active.
+     **********************************************************************/
+    bool TileCache() const { return _maxtiles > 0; }
+
+    /**
+     * @return true if the fits for the cells of the area cache have been
+     *   precomputed (see CacheFits).
+     **********************************************************************/
+    bool FitCache() const { return bool(_fits); }
+
+    /**
+     * @return the maximum number of tiles held by the tile cache.
+     **********************************************************************/
+    size_t TileCacheCapacity() const { return _maxtiles; }
+
+    /**
+     * @return the number of tiles held by the tile cache.
+     **********************************************************************/
+    size_t TileCacheSize() const { return _tiles.size(); }
+
+    /**
+     * @return the number of lookups satisfied by the tiles in memory (since
+     *   the tile cache was set up).
+     **********************************************************************/
+    unsigned long long TileCacheHits() const { return _tilehits; }
+
+    /**
+     * @return the number of lookups which required a tile to be read (since
+     *   the tile cache was set up).
+     **********************************************************************/
+    unsigned long long TileCacheMisses() const { return _tilemisses; }
+
     /**
      * @return west edge of the cached area; the cache includes this edge.
      **********************************************************************/
@@ -0,0 +1,240 @@
+/**
+ * \file GeoidGrid.hpp
+ * \brief Header for GeographicLib::GeoidGrid class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_GEOIDGRID_HPP)
+#define GEOGRAPHICLIB_GEOIDGRID_HPP 1
+
+#include <vector>
+#include <string>
+#include <GeographicLib/Constants.hpp>
+
+#if defined(_MSC_VER)
+// Squelch warnings about dll vs vector
+#  pragma warning (push)
+#  pragma warning (disable: 4251)
+#endif
+
+namespace GeographicLib {
+
+  class GravityModel;
+
+  /**
+   * \brief A grid of geoid heights synthesized from a gravity model
+   *
+   * GravityModel::GeoidHeight is expensive, particularly for high degree
+   * models such as EGM2008.  If many geoid heights are needed over a fixed
+   * region, it is much faster to synthesize a grid of heights over the region
+   * once and to interpolate in this grid.  This class does this, choosing the
+   * resolution of the grid so that the interpolation error is less than a
+   * specified tolerance.
+   *
+   * The grid points are at latitudes and longitudes which are multiples of
+   * 1/\e ndeg degrees, where \e ndeg, the number of intervals per degree, is
+   * a power of 2 (or the maximum resolution, \e maxres).  Starting with \e
+   * ndeg = 1, the grid is synthesized (using GravityCircle objects for the
+   * rows, evaluated on several threads) and the error in bilinear
+   * interpolation is estimated.  If this exceeds the tolerance, \e ndeg is
+   * doubled.  The error is estimated by interpolating the grid points with
+   * odd indices from the subgrid with even indices; since the error in
+   * bilinear interpolation scales as the square of the grid spacing, this
+   * estimate is divided by 4.  This estimate is reliable once the grid
+   * resolves the features of the geoid.  The heights are stored as 2-byte
+   * unsigned integers with an offset and a scale chosen to cover the range of
+   * heights, and the resulting quantization error is included in the error
+   * estimate.
+   *
+   * The grid can be saved in a file in the PGM format used by Geoid.  If the
+   * grid covers the whole earth, the file can be read by Geoid (and so also
+   * be used by GeoidEval).  Otherwise the file includes a "Region" comment
+   * giving the position of the first grid point and \e ndeg; such files can
+   * be read only by GeoidGrid.  If a file name is given to the constructor
+   * and the file already holds a suitable grid (for the same model, covering
+   * the region, and accurate enough), the grid is read from the file instead
+   * of being synthesized; otherwise the grid is synthesized and saved to the
+   * file.
+   *
+   * The heights are those given by GravityModel::GeoidHeight.  This class is
+   * thread safe once it is constructed.
+   *
+   * Example of use:
+   * \include example-GeoidGrid.cpp
+   **********************************************************************/
+  class GEOGRAPHICLIB_EXPORT GeoidGrid {
+  private:
+    typedef Math::real real;
+    typedef unsigned short pixel_t;
+    static const unsigned pixel_max_ = 0xffffu;
+    std::string _model, _description;
+    // The first grid point is at (_ilat0/_ndeg, _ilon0/_ndeg); latitude
+    // decreases and longitude increases with the indices.
+    int _ndeg, _ilat0, _ilon0, _nlat, _nlon;
+    bool _wrap;                 // longitudes wrap around the globe
+    real _south, _west, _north, _east, _offset, _scale, _maxerror;
+    std::vector<pixel_t> _data;
+    bool _synthesized;
+    void Synthesize(const GravityModel& g, int maxres, unsigned nthreads);
+    void Load(const std::string& filename);
+    void SetEdges();
+    real rawval(int ix, int iy) const {
+      if (_wrap) {
+        ix %= _nlon; if (ix < 0) ix += _nlon;
+      }
+      return _offset + _scale * _data[size_t(iy) * _nlon + ix];
+    }
+  public:
+
+    /**
+     * Construct a grid of geoid heights from a gravity model.
+     *
+     * @param[in] g the gravity model.
+     * @param[in] south the southern edge of the region (degrees).
+     * @param[in] west the western edge of the region (degrees).
+     * @param[in] north the northern edge of the region (degrees).
+     * @param[in] east the eastern edge of the region (degrees).
+     * @param[in] tol the tolerance for the interpolated heights (meters).
+     * @param[in] filename (optional) the file for reusing the grid.
+     * @param[in] maxres (optional) the maximum number of intervals per
+     *   degree (default 60, i.e., a grid spacing of 1').
+     * @param[in] nthreads (optional) the number of threads to use when
+     *   synthesizing the grid; if this is 0 (the default), use
+     *   std::thread::hardware_concurrency().
+     * @exception GeographicErr if the region is invalid, if \e tol is not
+     *   positive, or if \e maxres is less than 1.
+     * @exception GeographicErr if the file cannot be written.
+     * @exception std::bad_alloc if the memory for the grid can't be
+     *   allocated.
+     *
+     * The region must satisfy &minus;90&deg; &le; \e south &lt; \e north
+     * &le; 90&deg; and \e west &lt; \e east.  If \e east &minus; \e west
+     * &ge; 360&deg;, the grid covers all longitudes.  The grid is extended
+     * to the nearest grid points enclosing the region.  If the tolerance
+     * can't be met with \e maxres intervals per degree, the grid at this
+     * resolution is used; MaxError() then exceeds \e tol.  If \e filename is
+     * non-empty, then the grid is read from this file if possible; otherwise
+     * it is synthesized and saved to this file.
+     **********************************************************************/
+    GeoidGrid(const GravityModel& g,
+              real south, real west, real north, real east,
+              real tol, const std::string& filename = "",
+              int maxres = 60, unsigned nthreads = 0);
+
+    /**
+     * Read a grid of geoid heights from a file.
+     *
+     * @param[in] filename the file written by Save() (or by Geoid for a
+     *   global grid).
+     * @exception GeographicErr if the file can't be read or is corrupt.
+     * @exception std::bad_alloc if the memory for the grid can't be
+     *   allocated.
+     *
+     * A global PGM file used by Geoid can be read in this way, provided that
+     * the number of intervals per degree is an integer.
+     **********************************************************************/
+    explicit GeoidGrid(const std::string& filename);
+
+    /**
+     * Save the grid to a file.
+     *
+     * @param[in] filename the name of the file.
+     * @exception GeographicErr if the file cannot be written.
+     **********************************************************************/
+    void Save(const std::string& filename) const;
+
+    /**
+     * Compute the geoid height at a point.
+     *
+     * @param[in] lat latitude of the point (degrees).
+     * @param[in] lon longitude of the point (degrees).
+     * @return the height of the geoid above the ellipsoid (meters).
+     *
+     * The height is found by bilinear interpolation.  NaN is returned if the
+     * point lies outside the grid.
+     **********************************************************************/
+    Math::real operator()(real lat, real lon) const;
+
+    /** \name Inspector functions
+     **********************************************************************/
+    ///@{
+    /**
+     * @return the name of the gravity model used to synthesize the grid.
+     **********************************************************************/
+    const std::string& GravityModelName() const { return _model; }
+
+    /**
+     * @return the description of the grid written in the file.
+     **********************************************************************/
+    const std::string& Description() const { return _description; }
+
+    /**
+     * @return the number of intervals per degree of the grid.
+     **********************************************************************/
+    int Resolution() const { return _ndeg; }
+
+    /**
+     * @return the estimated maximum error in the interpolated heights,
+     *   including the quantization error (meters).
+     **********************************************************************/
+    Math::real MaxError() const { return _maxerror; }
+
+    /**
+     * @return the latitude of the southern edge of the grid (degrees).
+     **********************************************************************/
+    Math::real South() const { return _south; }
+
+    /**
+     * @return the longitude of the western edge of the grid (degrees).
+     **********************************************************************/
+    Math::real West() const { return _west; }
+
+    /**
+     * @return the latitude of the northern edge of the grid (degrees).
+     **********************************************************************/
+    Math::real North() const { return _north; }
+
+    /**
+     * @return the longitude of the eastern edge of the grid (degrees); this
+     *   is \e West() + 360&deg; if the grid covers all longitudes.
+     **********************************************************************/
+    Math::real East() const { return _east; }
+
+    /**
+     * @return true if the grid covers the whole earth (and so can be saved
+     *   in a file readable by Geoid).
+     **********************************************************************/
+    bool Global() const { return _wrap && _north == Math::qd &&
+        _south == -Math::qd; }
+
+    /**
+     * @return true if the grid was synthesized from the gravity model (and
+     *   not read from a file).
+     **********************************************************************/
+    bool Synthesized() const { return _synthesized; }
+
+    /**
+     * @return the offset used to convert the heights to 2-byte integers
+     *   (meters).
+     **********************************************************************/
+    Math::real Offset() const { return _offset; }
+
+    /**
+     * @return the scale used to convert the heights to 2-byte integers
+     *   (meters).
+     **********************************************************************/
+    Math::real Scale() const { return _scale; }
+    ///@}
+
+  };
+
+} // namespace GeographicLib
+
+#if defined(_MSC_VER)
+#  pragma warning (pop)
+#endif
+
+#endif  // GEOGRAPHICLIB_GEOIDGRID_HPP
@@ -0,0 +1,167 @@
+/**
+ * \file GeoidPyramid.hpp
+ * \brief Header for GeographicLib::GeoidPyramid class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_GEOIDPYRAMID_HPP)
+#define GEOGRAPHICLIB_GEOIDPYRAMID_HPP 1
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <GeographicLib/Geoid.hpp>
+
+#if defined(_MSC_VER)
+// Squelch warnings about dll vs vector
+#  pragma warning (push)
+#  pragma warning (disable: 4251)
+#endif
+
+namespace GeographicLib {
+
+  /**
+   * \brief Geoid heights at several resolutions
+   *
+   * The geoid data sets are available at several resolutions, e.g.,
+   * egm2008-1, egm2008-2_5, and egm2008-5 at 1', 2.5', and 5'.  If only
+   * moderate accuracy is needed, a coarser grid is as good as the finest one
+   * and it uses less memory when cached and less I/O when not.  This class
+   * holds the grids for the same geoid model at several resolutions (the
+   * "levels" of the pyramid) and answers each query from the coarsest level
+   * whose estimated maximum error, Geoid::MaxError(), doesn't exceed the
+   * requested tolerance.  If no level is accurate enough (or the error of a
+   * level is unknown), the finest level is used.
+   *
+   * The levels are Geoid objects, which only read the header of the data file
+   * when they are constructed; so unused levels cost little.  Level() gives
+   * access to the Geoid for a tolerance so that, e.g., an area cache may be
+   * set up for that level alone.  As with Geoid, the heights are computed
+   * with the single-cell cache of each level, so this class is not thread
+   * safe; use a GeoidPyramid per thread.
+   *
+   * Coarsen() builds a coarser level by subsampling an existing grid, for
+   * resolutions which aren't distributed (e.g., 15' from egm2008-5).
+   *
+   * Example of use:
+   * \code
+   * GeoidPyramid egm({"egm2008-1", "egm2008-2_5", "egm2008-5"});
+   * // egm2008-5 is accurate enough for a tolerance of 1 m
+   * double N = egm(27.99, 86.93, 1.0);
+   * // Set up a cache for the level used for 1 m queries
+   * egm.Level(1.0).CacheArea(20, 80, 30, 90);
+   * \endcode
+   **********************************************************************/
+
+  class GEOGRAPHICLIB_EXPORT GeoidPyramid {
+  private:
+    typedef Math::real real;
+    // The levels from finest to coarsest
+    std::vector< std::shared_ptr<const Geoid> > _levels;
+
+  public:
+
+    /**
+     * Construct a pyramid from geoid data files.
+     *
+     * @param[in] names the names of the geoid data sets for the levels, in
+     *   any order.
+     * @param[in] path (optional) directory for the data files; see Geoid.
+     * @param[in] cubic (optional) interpolation method; false means bilinear,
+     *   true (the default) means cubic.
+     * @exception GeographicErr if \e names is empty or if a data file cannot
+     *   be found, is unreadable, or is corrupt.
+     *
+     * The levels should all be for the same geoid model.  They are ordered by
+     * resolution.
+     **********************************************************************/
+    explicit GeoidPyramid(const std::vector<std::string>& names,
+                          const std::string& path = "", bool cubic = true);
+
+    /**
+     * The level for a tolerance.
+     *
+     * @param[in] tol the tolerance for the geoid heights (meters).
+     * @return the Geoid for the coarsest level whose maximum error is at most
+     *   \e tol (or the finest level).
+     **********************************************************************/
+    const Geoid& Level(real tol) const;
+
+    /**
+     * Compute the geoid height at a point.
+     *
+     * @param[in] lat latitude of the point (degrees).
+     * @param[in] lon longitude of the point (degrees).
+     * @param[in] tol the tolerance for the height (meters).
+     * @exception GeographicErr if there's a problem reading the data.
+     * @return the height of the geoid above the ellipsoid (meters).
+     **********************************************************************/
+    Math::real operator()(real lat, real lon, real tol) const
+    { return Level(tol)(lat, lon); }
+
+    /**
+     * Compute the geoid heights at several points.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lat array of latitudes of the points (degrees).
+     * @param[in] lon array of longitudes of the points (degrees).
+     * @param[in] tol the tolerance for the heights (meters).
+     * @param[out] h array of heights of the geoid above the ellipsoid
+     *   (meters).
+     * @exception GeographicErr if there's a problem reading the data.
+     **********************************************************************/
+    void HeightBatch(size_t n, const real lat[], const real lon[], real tol,
+                     real h[]) const
+    { Level(tol).HeightBatch(n, lat, lon, h); }
+
+    /**
+     * Build a coarser geoid grid by subsampling.
+     *
+     * @param[in] name the name of the geoid data set to subsample.
+     * @param[in] newname the name of the new data set.
+     * @param[in] factor the ratio of the grid spacings.
+     * @param[in] path (optional) directory for the data files; see Geoid.
+     * @exception GeographicErr if \e factor < 2 or doesn't divide the number
+     *   of intervals in latitude and longitude of \e name or if the number
+     *   of intervals in latitude of the new grid would be odd.
+     * @exception GeographicErr if the data file for \e name can't be read or
+     *   the new file can't be written.
+     *
+     * Every \e factor'th grid point in latitude and longitude of \e name is
+     * written to \e newname.pgm in \e path, retaining the offset and scale.
+     * The maximum and RMS errors for bilinear and cubic interpolation in the
+     * new grid are estimated by comparing the interpolated heights with the
+     * values at all the grid points of \e name, so that the new file can be
+     * used as a level of a GeoidPyramid.  For example, for egm2008-5, \e
+     * factor = 3 gives a 15' grid.  This reads all the data for \e name,
+     * which for egm2008-1 takes a minute or so.
+     **********************************************************************/
+    static void Coarsen(const std::string& name, const std::string& newname,
+                        int factor, const std::string& path = "");
+
+    /** \name Inspector functions
+     **********************************************************************/
+    ///@{
+    /**
+     * @return the number of levels.
+     **********************************************************************/
+    int Levels() const { return int(_levels.size()); }
+
+    /**
+     * @param[in] i the index of the level, 0 for the finest.
+     * @return the Geoid for level \e i.
+     **********************************************************************/
+    const Geoid& LevelGeoid(int i) const { return *_levels[i]; }
+    ///@}
+  };
+
+} // namespace GeographicLib
+
+#if defined(_MSC_VER)
+#  pragma warning (pop)
+#endif
+
+#endif  // GEOGRAPHICLIB_GEOIDPYRAMID_HPP
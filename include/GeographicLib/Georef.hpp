@@ -10,6 +10,7 @@
 #if !defined(GEOGRAPHICLIB_GEOREF_HPP)
 #define GEOGRAPHICLIB_GEOREF_HPP 1
 
+#include <vector>
 #include <GeographicLib/Constants.hpp>
 
 #if defined(_MSC_VER)
@@ -20,6 +21,8 @@
 
 namespace GeographicLib {
 
+  class GeodesicRegion;
+
   /**
    * \brief Conversions for the World Geographic Reference System (georef)
    *
@@ -67,6 +70,14 @@ namespace GeographicLib {
 
   public:
 
+    /**
+     * The maximum length of a georef (not counting the terminating null),
+     * namely 4 letters and 2 &times; 11 digits at \e prec = 11.  A char
+     * array of size MAXLENGTH + 1 is large enough to hold any georef produced
+     * by Forward (including "INVALID").
+     **********************************************************************/
+    enum { MAXLENGTH = 26 };
+
     /**
      * Convert from geographic coordinates to georef.
      *
@@ -120,8 +131,112 @@ namespace GeographicLib {
      * are set to NaN and \e prec is unchanged.
      **********************************************************************/
     static void Reverse(const std::string& georef, real& lat, real& lon,
+                        int& prec, bool centerp = true) {
+      Reverse(georef.data(), georef.size(), lat, lon, prec, centerp);
+    }
+
+    /**
+     * Convert from geographic coordinates to a georef in a char array.
+     *
+     * @param[in] lat latitude of point (degrees).
+     * @param[in] lon longitude of point (degrees).
+     * @param[in] prec the precision of the resulting georef.
+     * @param[out] georef a char array of size at least MAXLENGTH + 1 to
+     *   receive the null-terminated georef.
+     * @exception GeographicErr if \e lat is not in [&minus;90&deg;,
+     *   90&deg;].
+     * @return the length of the georef.
+     *
+     * This gives the same result as the version of Forward which returns a
+     * std::string, but no memory is allocated (unless an exception is
+     * thrown).  If an exception is thrown, then \e georef is unchanged.
+     **********************************************************************/
+    static int Forward(real lat, real lon, int prec, char georef[]);
+
+    /**
+     * Convert several geographic coordinates to georefs.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lat array of latitudes (degrees).
+     * @param[in] lon array of longitudes (degrees).
+     * @param[in] prec the precision of the resulting georefs.
+     * @param[out] georef a char array of size at least \e n (MAXLENGTH + 1)
+     *   to receive the georefs; the null-terminated georef for point \e i
+     *   starts at \e georef + \e i (MAXLENGTH + 1).
+     * @exception GeographicErr if any \e lat is not in [&minus;90&deg;,
+     *   90&deg;].
+     *
+     * This is equivalent to calling the char array version of Forward for
+     * each point.  If an exception is thrown, the georefs for the points
+     * before the offending one have been written.
+     **********************************************************************/
+    static void ForwardBatch(size_t n, const real lat[], const real lon[],
+                             int prec, char georef[]);
+
+    /**
+     * Convert from a georef given as a character array to geographic
+     * coordinates.
+     *
+     * @param[in] georef pointer to the characters of the georef.
+     * @param[in] len the number of characters (the string need not be null
+     *   terminated).
+     * @param[out] lat latitude of point (degrees).
+     * @param[out] lon longitude of point (degrees).
+     * @param[out] prec the precision of \e georef.
+     * @param[in] centerp if true (the default) return the center of the
+     *   \e georef, otherwise return the south-west corner.
+     * @exception GeographicErr if \e georef is illegal.
+     *
+     * This is the same as the version of Reverse taking a std::string, but
+     * no memory is allocated (unless an exception is thrown).
+     **********************************************************************/
+    static void Reverse(const char* georef, size_t len, real& lat, real& lon,
                         int& prec, bool centerp = true);
 
+    /**
+     * Convert several georefs to geographic coordinates.
+     *
+     * @param[in] n the number of points.
+     * @param[in] georef a char array holding the georefs in the layout
+     *   produced by ForwardBatch; georef \e i starts at \e georef + \e i
+     *   (MAXLENGTH + 1) and is terminated by a null or by the end of its
+     *   MAXLENGTH + 1 characters.
+     * @param[out] lat array of latitudes (degrees).
+     * @param[out] lon array of longitudes (degrees).
+     * @param[out] prec (optional) array of the precisions of the georefs.
+     * @param[in] centerp if true (the default) return the centers of the
+     *   georefs, otherwise return the south-west corners.
+     * @exception GeographicErr if any of the georefs is illegal.
+     *
+     * This is equivalent to calling Reverse for each point.  If an exception
+     * is thrown, the results for the points before the offending one have
+     * been written.
+     **********************************************************************/
+    static void ReverseBatch(size_t n, const char georef[],
+                             real lat[], real lon[], int prec[] = nullptr,
+                             bool centerp = true);
+
+    /**
+     * Find the georefs covering a region.
+     *
+     * @param[in] region the GeodesicRegion to cover.
+     * @param[in] prec the precision of the georefs.
+     * @param[out] cells the georefs covering \e region.
+     * @param[in] compact if true, a coarser cell lying entirely inside \e
+     *   region is returned in place of its subcells (default false).
+     * @exception std::bad_alloc if the memory for \e cells can't be
+     *   allocated.
+     *
+     * Internally, \e prec is first put in the range [&minus;1, 11] (and \e
+     * prec = 1 is converted to \e prec = 2).  The grid is subdivided
+     * hierarchically with GeodesicRegion::Classify; the cells returned include
+     * all those intersecting \e region together with a few cells close to its
+     * boundary.  If \e compact is false, all the cells have the same
+     * precision; if it's true, the cells inside the region may be larger.
+     **********************************************************************/
+    static void Cover(const GeodesicRegion& region, int prec,
+                      std::vector<std::string>& cells, bool compact = false);
+
     /**
      * The angular resolution of a Georef.
      *
@@ -48,32 +48,35 @@ namespace GeographicLib {
       DISTURBING_POTENTIAL = GravityModel::DISTURBING_POTENTIAL,
       GEOID_HEIGHT         = GravityModel::GEOID_HEIGHT,
       SPHERICAL_ANOMALY    = GravityModel::SPHERICAL_ANOMALY,
+      GRAVITY_GRADIENT     = GravityModel::GRAVITY_GRADIENT,
+      DISTURBANCE_GRADIENT = GravityModel::DISTURBANCE_GRADIENT,
       ALL                  = GravityModel::ALL,
     };
 
     unsigned _caps;
     real _a, _f, _lat, _h, _zZ, _pPx, _invR, _cpsi, _spsi,
       _cphi, _sphi, _amodel, _gGMmodel, _dzonal0,
-      _corrmult, _gamma0, _gamma, _frot;
+      _corrmult, _gamma0, _gamma, _frot, _omega2;
     CircularEngine _gravitational, _disturbing, _correction;
 
-    GravityCircle(mask caps, real a, real f, real lat, real h,
-                  real Z, real P, real cphi, real sphi,
-                  real amodel, real GMmodel,
-                  real dzonal0, real corrmult,
-                  real gamma0, real gamma, real frot,
-                  const CircularEngine& gravitational,
-                  const CircularEngine& disturbing,
-                  const CircularEngine& correction);
+    // Set the parameters other than the CircularEngine objects; these are
+    // set in place by GravityModel::Circle.
+    void Reset(mask caps, real a, real f, real lat, real h,
+               real Z, real P, real cphi, real sphi,
+               real amodel, real GMmodel,
+               real dzonal0, real corrmult,
+               real gamma0, real gamma, real frot, real omega2);
 
-    friend class GravityModel; // GravityModel calls the private constructor
+    friend class GravityModel; // GravityModel calls Reset
+    // If the last argument is not null, also compute the second derivatives
     Math::real W(real slam, real clam,
-                 real& gX, real& gY, real& gZ) const;
+                 real& gX, real& gY, real& gZ, real Wij[] = nullptr) const;
     Math::real V(real slam, real clam,
-                 real& gX, real& gY, real& gZ) const;
+                 real& gX, real& gY, real& gZ, real Vij[] = nullptr) const;
     Math::real InternalT(real slam, real clam,
                          real& deltaX, real& deltaY, real& deltaZ,
-                         bool gradp, bool correct) const;
+                         bool gradp, bool correct,
+                         real Tij[] = nullptr) const;
   public:
     /**
      * A default constructor for the normal gravity.  This sets up an
@@ -223,6 +226,82 @@ namespace GeographicLib {
       return InternalT(slam, clam, dummy, dummy, dummy, false, true);
     }
 
+    /**
+     * Evaluate the components of the acceleration due to gravity and the
+     * centrifugal acceleration and the gravity gradient tensor in geocentric
+     * coordinates.
+     *
+     * @param[in] lon the geographic longitude (degrees).
+     * @param[out] gX the \e X component of the acceleration
+     *   (m s<sup>&minus;2</sup>).
+     * @param[out] gY the \e Y component of the acceleration
+     *   (m s<sup>&minus;2</sup>).
+     * @param[out] gZ the \e Z component of the acceleration
+     *   (m s<sup>&minus;2</sup>).
+     * @param[out] Wij an array of 9 elements giving the second derivatives
+     *   of \e W in row-major order (s<sup>&minus;2</sup>); see
+     *   GravityModel::W.
+     * @return \e W = \e V + &Phi; the sum of the gravitational and
+     *   centrifugal potentials (m<sup>2</sup> s<sup>&minus;2</sup>).
+     *
+     * This requires the GravityModel::GRAVITY_GRADIENT capability.
+     **********************************************************************/
+    Math::real W(real lon, real& gX, real& gY, real& gZ, real Wij[]) const {
+      real slam, clam;
+      Math::sincosd(lon, slam, clam);
+      return W(slam, clam, gX, gY, gZ, Wij);
+    }
+
+    /**
+     * Evaluate the components of the acceleration due to gravity and the
+     * gravity gradient tensor (excluding the centrifugal terms) in
+     * geocentric coordinates.
+     *
+     * @param[in] lon the geographic longitude (degrees).
+     * @param[out] GX the \e X component of the acceleration
+     *   (m s<sup>&minus;2</sup>).
+     * @param[out] GY the \e Y component of the acceleration
+     *   (m s<sup>&minus;2</sup>).
+     * @param[out] GZ the \e Z component of the acceleration
+     *   (m s<sup>&minus;2</sup>).
+     * @param[out] Vij an array of 9 elements giving the second derivatives
+     *   of \e V in row-major order (s<sup>&minus;2</sup>).
+     * @return \e V = \e W - &Phi; the gravitational potential
+     *   (m<sup>2</sup> s<sup>&minus;2</sup>).
+     *
+     * This requires the GravityModel::GRAVITY_GRADIENT capability.
+     **********************************************************************/
+    Math::real V(real lon, real& GX, real& GY, real& GZ, real Vij[]) const {
+      real slam, clam;
+      Math::sincosd(lon, slam, clam);
+      return V(slam, clam, GX, GY, GZ, Vij);
+    }
+
+    /**
+     * Evaluate the components of the gravity disturbance and the gradient
+     * tensor of the disturbing potential in geocentric coordinates.
+     *
+     * @param[in] lon the geographic longitude (degrees).
+     * @param[out] deltaX the \e X component of the gravity disturbance
+     *   (m s<sup>&minus;2</sup>).
+     * @param[out] deltaY the \e Y component of the gravity disturbance
+     *   (m s<sup>&minus;2</sup>).
+     * @param[out] deltaZ the \e Z component of the gravity disturbance
+     *   (m s<sup>&minus;2</sup>).
+     * @param[out] Tij an array of 9 elements giving the second derivatives
+     *   of \e T in row-major order (s<sup>&minus;2</sup>).
+     * @return \e T = \e W - \e U the disturbing potential (also called the
+     *   anomalous potential) (m<sup>2</sup> s<sup>&minus;2</sup>).
+     *
+     * This requires the GravityModel::DISTURBANCE_GRADIENT capability.
+     **********************************************************************/
+    Math::real T(real lon, real& deltaX, real& deltaY, real& deltaZ,
+                 real Tij[]) const {
+      real slam, clam;
+      Math::sincosd(lon, slam, clam);
+      return InternalT(slam, clam, deltaX, deltaY, deltaZ, true, true, Tij);
+    }
+
     ///@}
 
     /** \name Inspector functions
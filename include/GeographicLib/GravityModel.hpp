@@ -14,6 +14,7 @@
 #include <GeographicLib/NormalGravity.hpp>
 #include <GeographicLib/SphericalHarmonic.hpp>
 #include <GeographicLib/SphericalHarmonic1.hpp>
+#include <GeographicLib/CircleCache.hpp>
 
 #if defined(_MSC_VER)
 // Squelch warnings about dll vs vector
@@ -90,17 +91,60 @@ namespace GeographicLib {
     int _nmx, _mmx;
     SphericalHarmonic::normalization _norm;
     NormalGravity _earth;
-    std::vector<real> _cCx, _sSx, _cCC, _cCS, _zonal;
+    // The coefficients read from the file (or the mapped file); these are
+    // shared by copies of the object and by truncated views.
+    struct coeffstore {
+      std::vector<real> cCx, sSx, cCC, cCS;
+      SphericalEngine::mappedfile cofmap;
+    };
+    std::shared_ptr<coeffstore> _coeffs;
+    std::vector<real> _zonal;
     real _dzonal0;              // A left over contribution to _zonal.
     SphericalHarmonic _gravitational;
     SphericalHarmonic1 _disturbing;
     SphericalHarmonic _correction;
+    // The cache of circles of latitude
+    mutable CircleCache<GravityCircle> _circles;
+    mutable real _circledlat, _circledh;
+    // The tolerance for truncating the sums and the bounds on the terms
+    mutable real _trunctol;
+    mutable std::vector<real> _truncbound;
     void ReadMetadata(const std::string& name);
+    void SetupSums();
+    std::shared_ptr<const GravityCircle> CachedCircle(real lat, real h) const;
+    // The estimated size of a GravityCircle in the cache
+    unsigned long long CircleBytes() const;
+    int TruncatedDegree(real X, real Y, real Z) const;
+    // If Tij is not null, also compute the second derivatives (gradp and
+    // correct should then be true)
     Math::real InternalT(real X, real Y, real Z,
                          real& deltaX, real& deltaY, real& deltaZ,
-                         bool gradp, bool correct) const;
-    GravityModel(const GravityModel&) = delete; // copy constructor not allowed
-    // nor copy assignment
+                         bool gradp, bool correct,
+                         real Tij[] = nullptr) const;
+    // Convert the disturbing sum and its gradient to T and delta
+    Math::real ScaleT(real X, real Y, real Z, real T,
+                      real& deltaX, real& deltaY, real& deltaZ,
+                      bool gradp, bool correct) const;
+    void Anomaly(real X, real Y, real Z, const real M[],
+                 real T, real deltax, real deltay, real deltaz,
+                 real& Dg01, real& xi, real& eta) const;
+    Math::real Geoid(real lat, real X, real Y, real Z, real T) const;
+    // The batch functions use a GravityCircle for each run of at least
+    // circlemin_ points with the same latitude and height; the other points
+    // are handed to the threads batchchunk_ at a time.
+    static const size_t circlemin_ = 4;
+    static const size_t batchchunk_ = 64;
+    enum batchtype {
+      BATCH_GRAVITY,
+      BATCH_DISTURBANCE,
+      BATCH_GEOID,
+      BATCH_ANOMALY,
+    };
+    void Batch(batchtype type, size_t n,
+               const real lat[], const real lon[], const real h[],
+               real r0[], real r1[], real r2[], real r3[],
+               unsigned nthreads) const;
+    // copy assignment not allowed
     GravityModel& operator=(const GravityModel&) = delete;
 
     enum captype {
@@ -111,6 +155,7 @@ namespace GeographicLib {
       CAP_C      = 1U<<3,
       CAP_GAMMA0 = 1U<<4,
       CAP_GAMMA  = 1U<<5,
+      CAP_HESS   = 1U<<6,       // second derivatives; not in CAP_ALL
       CAP_ALL    = 0x3FU,
     };
 
@@ -154,7 +199,22 @@ namespace GeographicLib {
        **********************************************************************/
       GEOID_HEIGHT = CAP_T | CAP_C | CAP_GAMMA0,
       /**
-       * All capabilities.
+       * Allow calls to the versions of GravityCircle::W and GravityCircle::V
+       * which return the gravity gradient tensor (and to the functions
+       * allowed by GravityModel::GRAVITY).
+       * @hideinitializer
+       **********************************************************************/
+      GRAVITY_GRADIENT = CAP_G | CAP_HESS,
+      /**
+       * Allow calls to the version of GravityCircle::T which returns the
+       * gradient tensor of the disturbing potential (and to the functions
+       * allowed by GravityModel::DISTURBANCE).
+       * @hideinitializer
+       **********************************************************************/
+      DISTURBANCE_GRADIENT = CAP_DELTA | CAP_HESS,
+      /**
+       * All capabilities except GravityModel::GRAVITY_GRADIENT and
+       * GravityModel::DISTURBANCE_GRADIENT.
        * @hideinitializer
        **********************************************************************/
       ALL = CAP_ALL,
@@ -171,8 +231,12 @@ namespace GeographicLib {
      *   model this value.
      * @param[in] Mmax (optional) if non-negative, truncate the order of the
      *   model this value.
+     * @param[in] mapfile (optional) if true, memory map the coefficient file
+     *   instead of reading it.
      * @exception GeographicErr if the data file cannot be found, is
      *   unreadable, or is corrupt, or if \e Mmax > \e Nmax.
+     * @exception GeographicErr if \e mapfile is true but the coefficient
+     *   file cannot be mapped.
      * @exception std::bad_alloc if the memory necessary for storing the model
      *   can't be allocated.
      *
@@ -189,10 +253,77 @@ namespace GeographicLib {
      * If \e Nmax &ge; 0 and \e Mmax < 0, then \e Mmax is set to \e Nmax.
      * After the model is loaded, the maximum degree and order of the model can
      * be found by the Degree() and Order() methods.
+     *
+     * If \e mapfile is true, the coefficient file is memory mapped
+     * copy-on-write and the sums refer directly to the mapped data.  The
+     * constructor then takes negligible time and several processes using the
+     * same model share a single copy of the coefficients (about 38 MB for
+     * EGM2008).  Only the page holding the first coefficient is copied (in
+     * order to include the 1/\e r term in the sum).  This requires that
+     * GEOGRAPHICLIB_PRECISION = 2 and that the machine be little-endian.
+     * The results are identical to those with \e mapfile = false.
      **********************************************************************/
     explicit GravityModel(const std::string& name,
                           const std::string& path = "",
-                          int Nmax = -1, int Mmax = -1);
+                          int Nmax = -1, int Mmax = -1,
+                          bool mapfile = false);
+
+    /**
+     * A shared instance of GravityModel.
+     *
+     * @param[in] name the name of the model.
+     * @param[in] path (optional) directory for data file.
+     * @exception GeographicErr if the data file cannot be found, is
+     *   unreadable, or is corrupt.
+     * @exception std::bad_alloc if the memory necessary for storing the model
+     *   can't be allocated.
+     * @return a GravityModel object for the complete model.
+     *
+     * The first call with a given \e name and directory constructs the
+     * object and later calls (on any thread) return the same object; see
+     * SharedInstances for the details.  An empty \e path is the same as
+     * DefaultGravityPath().  The object lives until the program exits.  Its
+     * const member functions may be called concurrently (but not
+     * CacheCircles, CircleCacheClear, or SetTruncationTolerance).
+     **********************************************************************/
+    static const GravityModel& Get(const std::string& name,
+                                   const std::string& path = "");
+
+    /**
+     * Copy a gravity model.
+     *
+     * @param[in] model the gravity model.
+     *
+     * The copy shares the coefficients of \e model (which are reference
+     * counted), so copying is cheap even for a large model, and \e model
+     * may be destroyed while the copy is in use.  Packed coefficients (see
+     * PackCoefficients) and the truncation tolerance are inherited.  The
+     * copy has its own cache of circles, initially empty and with the same
+     * capacity as that of \e model.
+     **********************************************************************/
+    GravityModel(const GravityModel& model);
+
+    /**
+     * Construct a truncated view of a gravity model.
+     *
+     * @param[in] model the gravity model.
+     * @param[in] Nmax if non-negative, truncate the degree of the model this
+     *   value.
+     * @param[in] Mmax (optional) if non-negative, truncate the order of the
+     *   model this value.
+     * @exception GeographicErr if \e Mmax > \e Nmax.
+     *
+     * The resulting object shares the coefficients of \e model instead of
+     * copying them, so constructing it is cheap; \e model may be destroyed
+     * while this object is in use.  This allows low-degree evaluations (for
+     * speed) and full-degree evaluations (for accuracy) to be made without
+     * loading the coefficients twice.  The
+     * results are the same as for a model constructed with truncation,
+     * GravityModel(name, path, \e Nmax, \e Mmax).  If \e Nmax &ge; 0 and
+     * \e Mmax < 0, then \e Mmax is set to \e Nmax; if \e Nmax < 0, the
+     * model is not truncated.
+     **********************************************************************/
+    GravityModel(const GravityModel& model, int Nmax, int Mmax = -1);
     ///@}
 
     /** \name Compute gravity in geodetic coordinates
@@ -219,6 +350,44 @@ namespace GeographicLib {
     Math::real Gravity(real lat, real lon, real h,
                        real& gx, real& gy, real& gz) const;
 
+    /**
+     * Evaluate the gravity at several points.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lat array of geographic latitudes (degrees).
+     * @param[in] lon array of geographic longitudes (degrees).
+     * @param[in] h array of heights above the ellipsoid (meters).
+     * @param[out] W array of the sums of the gravitational and centrifugal
+     *   potentials (m<sup>2</sup> s<sup>&minus;2</sup>).
+     * @param[out] gx array of the easterly components of the acceleration
+     *   (m s<sup>&minus;2</sup>).
+     * @param[out] gy array of the northerly components of the acceleration
+     *   (m s<sup>&minus;2</sup>).
+     * @param[out] gz array of the upward components of the acceleration
+     *   (m s<sup>&minus;2</sup>).
+     * @param[in] nthreads the number of threads to use; if this is 0, use
+     *   std::thread::hardware_concurrency() (default 1).
+     * @exception std::bad_alloc if the memory for the temporary arrays can't
+     *   be allocated.
+     * @exception std::system_error if the threads can't be created.
+     *
+     * This gives the same results as calling Gravity for each point (to
+     * within roundoff), but is much faster for a high degree model.  The
+     * points are sorted by latitude and height.  Each group of several
+     * points (currently 4 or more) with the same latitude and height is
+     * evaluated with a GravityCircle (as if Circle had been called for the
+     * group).  The spherical harmonic sums for the remaining points are
+     * evaluated with SphericalHarmonic::ValueBatch.  The groups and the
+     * remaining points are divided among \e nthreads threads with
+     * GeodesicBatchExecutor.  As with Circle, the sums are not truncated
+     * (see SetTruncationTolerance) and the cache of circles (see
+     * CacheCircles) isn't used.
+     **********************************************************************/
+    void GravityBatch(size_t n, const real lat[], const real lon[],
+                      const real h[], real W[],
+                      real gx[], real gy[], real gz[],
+                      unsigned nthreads = 1) const;
+
     /**
      * Evaluate the gravity disturbance vector at an arbitrary point above (or
      * below) the ellipsoid.
@@ -239,6 +408,36 @@ namespace GeographicLib {
                            real& deltax, real& deltay, real& deltaz)
       const;
 
+    /**
+     * Evaluate the gravity disturbance vector at several points.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lat array of geographic latitudes (degrees).
+     * @param[in] lon array of geographic longitudes (degrees).
+     * @param[in] h array of heights above the ellipsoid (meters).
+     * @param[out] T array of the disturbing potentials
+     *   (m<sup>2</sup> s<sup>&minus;2</sup>).
+     * @param[out] deltax array of the easterly components of the
+     *   disturbance vector (m s<sup>&minus;2</sup>).
+     * @param[out] deltay array of the northerly components of the
+     *   disturbance vector (m s<sup>&minus;2</sup>).
+     * @param[out] deltaz array of the upward components of the disturbance
+     *   vector (m s<sup>&minus;2</sup>).
+     * @param[in] nthreads the number of threads to use; if this is 0, use
+     *   std::thread::hardware_concurrency() (default 1).
+     * @exception std::bad_alloc if the memory for the temporary arrays can't
+     *   be allocated.
+     * @exception std::system_error if the threads can't be created.
+     *
+     * This gives the same results as calling Disturbance for each point (to
+     * within roundoff); the points are processed as described for
+     * GravityBatch.
+     **********************************************************************/
+    void DisturbanceBatch(size_t n, const real lat[], const real lon[],
+                          const real h[], real T[],
+                          real deltax[], real deltay[], real deltaz[],
+                          unsigned nthreads = 1) const;
+
     /**
      * Evaluate the geoid height.
      *
@@ -254,6 +453,29 @@ namespace GeographicLib {
      **********************************************************************/
     Math::real GeoidHeight(real lat, real lon) const;
 
+    /**
+     * Evaluate the geoid height at several points.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lat array of geographic latitudes (degrees).
+     * @param[in] lon array of geographic longitudes (degrees).
+     * @param[out] N array of the heights of the geoid above the
+     *   ReferenceEllipsoid() (meters).
+     * @param[in] nthreads the number of threads to use; if this is 0, use
+     *   std::thread::hardware_concurrency() (default 1).
+     * @exception std::bad_alloc if the memory for the temporary arrays can't
+     *   be allocated.
+     * @exception std::system_error if the threads can't be created.
+     *
+     * This gives the same results as calling GeoidHeight for each point (to
+     * within roundoff); the points are processed as described for
+     * GravityBatch.  This is the efficient way to compute the geoid height
+     * on a grid, since all the points in a row of the grid are evaluated
+     * with a single GravityCircle.
+     **********************************************************************/
+    void GeoidHeightBatch(size_t n, const real lat[], const real lon[],
+                          real N[], unsigned nthreads = 1) const;
+
     /**
      * Evaluate the components of the gravity anomaly vector using the
      * spherical approximation.
@@ -273,6 +495,35 @@ namespace GeographicLib {
      **********************************************************************/
     void SphericalAnomaly(real lat, real lon, real h,
                           real& Dg01, real& xi, real& eta) const;
+
+    /**
+     * Evaluate the components of the gravity anomaly vector using the
+     * spherical approximation at several points.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lat array of geographic latitudes (degrees).
+     * @param[in] lon array of geographic longitudes (degrees).
+     * @param[in] h array of heights above the ellipsoid (meters).
+     * @param[out] Dg01 array of the gravity anomalies
+     *   (m s<sup>&minus;2</sup>).
+     * @param[out] xi array of the northerly components of the deflection of
+     *   the vertical (degrees).
+     * @param[out] eta array of the easterly components of the deflection of
+     *   the vertical (degrees).
+     * @param[in] nthreads the number of threads to use; if this is 0, use
+     *   std::thread::hardware_concurrency() (default 1).
+     * @exception std::bad_alloc if the memory for the temporary arrays can't
+     *   be allocated.
+     * @exception std::system_error if the threads can't be created.
+     *
+     * This gives the same results as calling SphericalAnomaly for each point
+     * (to within roundoff); the points are processed as described for
+     * GravityBatch.
+     **********************************************************************/
+    void SphericalAnomalyBatch(size_t n, const real lat[], const real lon[],
+                               const real h[], real Dg01[],
+                               real xi[], real eta[],
+                               unsigned nthreads = 1) const;
     ///@}
 
     /** \name Compute gravity in geocentric coordinates
@@ -352,6 +603,87 @@ namespace GeographicLib {
       return InternalT(X, Y, Z, dummy, dummy, dummy, false, true);
     }
 
+    /**
+     * Evaluate the components of the acceleration due to gravity and the
+     * centrifugal acceleration and the gravity gradient tensor in geocentric
+     * coordinates.
+     *
+     * @param[in] X geocentric coordinate of point (meters).
+     * @param[in] Y geocentric coordinate of point (meters).
+     * @param[in] Z geocentric coordinate of point (meters).
+     * @param[out] gX the \e X component of the acceleration
+     *   (m s<sup>&minus;2</sup>).
+     * @param[out] gY the \e Y component of the acceleration
+     *   (m s<sup>&minus;2</sup>).
+     * @param[out] gZ the \e Z component of the acceleration
+     *   (m s<sup>&minus;2</sup>).
+     * @param[out] Wij an array of 9 elements giving the second derivatives
+     *   of \e W in row-major order, i.e., \e Wij[3\e i + \e j] =
+     *   &part;<sup>2</sup><i>W</i>/&part;<i>X<sub>i</sub></i>
+     *   &part;<i>X<sub>j</sub></i> where (<i>X</i><sub>0</sub>,
+     *   <i>X</i><sub>1</sub>, <i>X</i><sub>2</sub>) = (\e X, \e Y, \e Z)
+     *   (s<sup>&minus;2</sup>).
+     * @exception std::bad_alloc if the memory for the temporary array can't
+     *   be allocated.
+     * @return \e W = \e V + &Phi; the sum of the gravitational and
+     *   centrifugal potentials (m<sup>2</sup> s<sup>&minus;2</sup>).
+     *
+     * The tensor is computed in the same pass through the coefficients as the
+     * potential; see SphericalEngine::Hessian.  This takes about twice as
+     * long as the version of W without \e Wij.
+     **********************************************************************/
+    Math::real W(real X, real Y, real Z,
+                 real& gX, real& gY, real& gZ, real Wij[]) const;
+
+    /**
+     * Evaluate the components of the acceleration due to gravity and the
+     * gravity gradient tensor (excluding the centrifugal terms) in
+     * geocentric coordinates.
+     *
+     * @param[in] X geocentric coordinate of point (meters).
+     * @param[in] Y geocentric coordinate of point (meters).
+     * @param[in] Z geocentric coordinate of point (meters).
+     * @param[out] GX the \e X component of the acceleration
+     *   (m s<sup>&minus;2</sup>).
+     * @param[out] GY the \e Y component of the acceleration
+     *   (m s<sup>&minus;2</sup>).
+     * @param[out] GZ the \e Z component of the acceleration
+     *   (m s<sup>&minus;2</sup>).
+     * @param[out] Vij an array of 9 elements giving the second derivatives
+     *   of \e V in row-major order (s<sup>&minus;2</sup>).
+     * @exception std::bad_alloc if the memory for the temporary array can't
+     *   be allocated.
+     * @return \e V = \e W - &Phi; the gravitational potential
+     *   (m<sup>2</sup> s<sup>&minus;2</sup>).
+     *
+     * Outside the masses, the trace of \e Vij vanishes.
+     **********************************************************************/
+    Math::real V(real X, real Y, real Z,
+                 real& GX, real& GY, real& GZ, real Vij[]) const;
+
+    /**
+     * Evaluate the components of the gravity disturbance and the gradient
+     * tensor of the disturbing potential in geocentric coordinates.
+     *
+     * @param[in] X geocentric coordinate of point (meters).
+     * @param[in] Y geocentric coordinate of point (meters).
+     * @param[in] Z geocentric coordinate of point (meters).
+     * @param[out] deltaX the \e X component of the gravity disturbance
+     *   (m s<sup>&minus;2</sup>).
+     * @param[out] deltaY the \e Y component of the gravity disturbance
+     *   (m s<sup>&minus;2</sup>).
+     * @param[out] deltaZ the \e Z component of the gravity disturbance
+     *   (m s<sup>&minus;2</sup>).
+     * @param[out] Tij an array of 9 elements giving the second derivatives
+     *   of \e T in row-major order (s<sup>&minus;2</sup>).
+     * @exception std::bad_alloc if the memory for the temporary array can't
+     *   be allocated.
+     * @return \e T = \e W - \e U the disturbing potential (also called the
+     *   anomalous potential) (m<sup>2</sup> s<sup>&minus;2</sup>).
+     **********************************************************************/
+    Math::real T(real X, real Y, real Z,
+                 real& deltaX, real& deltaY, real& deltaZ, real Tij[]) const;
+
     /**
      * Evaluate the components of the acceleration due to normal gravity and
      * the centrifugal acceleration in geocentric coordinates.
@@ -405,8 +737,12 @@ namespace GeographicLib {
      * @param[in] h the height of the point above the ellipsoid (meters).
      * @param[in] caps bitor'ed combination of GravityModel::mask values
      *   specifying the capabilities of the resulting GravityCircle object.
+     * @param[in] nthreads the number of threads to use to set up the
+     *   CircularEngine objects held by the GravityCircle; 0 means use
+     *   std::thread::hardware_concurrency() (default 1).
      * @exception std::bad_alloc if the memory necessary for creating a
      *   GravityCircle can't be allocated.
+     * @exception std::system_error if the threads can't be created.
      * @return a GravityCircle object whose member functions computes the
      *   gravitational field at a particular values of \e lon.
      *
@@ -416,19 +752,226 @@ namespace GeographicLib {
      * - \e caps |= GravityModel::DISTURBING_POTENTIAL
      * - \e caps |= GravityModel::SPHERICAL_ANOMALY
      * - \e caps |= GravityModel::GEOID_HEIGHT
+     * - \e caps |= GravityModel::GRAVITY_GRADIENT
+     * - \e caps |= GravityModel::DISTURBANCE_GRADIENT
      * .
      * The default value of \e caps is GravityModel::ALL which turns on all the
-     * capabilities.  If an unsupported function is invoked, it will return
-     * NaNs.  Note that GravityModel::GEOID_HEIGHT will only be honored if \e h
-     * = 0.
+     * capabilities except for the gradient tensors (which roughly double the
+     * time to set up the GravityCircle).  If an unsupported function is
+     * invoked, it will return NaNs.  Note that GravityModel::GEOID_HEIGHT
+     * will only be honored if \e h = 0.
      *
      * If the field at several points on a circle of latitude need to be
      * calculated then creating a GravityCircle object and using its member
      * functions will be substantially faster, especially for high-degree
      * models.  See \ref gravityparallel for an example of using GravityCircle
      * (together with OpenMP) to speed up the computation of geoid heights.
+     *
+     * Setting up a GravityCircle for a high-degree model involves a sum over
+     * the coefficients for each of up to three CircularEngine objects (for
+     * the gravitational potential, the disturbing potential, and the
+     * correction to the geoid height).  These sums are independent; with \e
+     * nthreads &ne; 1, they are carried out concurrently, reducing the time
+     * to set up the GravityCircle by up to a factor of three.
+     **********************************************************************/
+    GravityCircle Circle(real lat, real h, unsigned caps = ALL,
+                         unsigned nthreads = 1) const;
+
+    /**
+     * Set up an existing GravityCircle object for a new circle of latitude.
+     *
+     * @param[in] lat latitude of the point (degrees).
+     * @param[in] h the height of the point above the ellipsoid (meters).
+     * @param[in] caps bitor'ed combination of GravityModel::mask values
+     *   specifying the capabilities of the resulting GravityCircle object.
+     * @param[in,out] circ the GravityCircle object.
+     * @param[in] nthreads the number of threads to use (default 1).
+     * @exception std::bad_alloc if the memory necessary for \e circ can't be
+     *   allocated.
+     * @exception std::system_error if the threads can't be created.
+     *
+     * This sets \e circ to the object returned by the other version of
+     * Circle; however, the storage for the coefficients held by \e circ is
+     * reused.  When a high-degree model is evaluated on many circles of
+     * latitude (e.g., for each row of a grid), reusing a single GravityCircle
+     * avoids allocating and freeing this storage for each circle.
+     **********************************************************************/
+    void Circle(real lat, real h, unsigned caps, GravityCircle& circ,
+                unsigned nthreads = 1) const;
+    ///@}
+
+    /** \name Caching circles of latitude
+     **********************************************************************/
+    ///@{
+    /**
+     * Set up a cache of circles of latitude.
+     *
+     * @param[in] dlat the quantum for the latitudes (degrees).
+     * @param[in] dh the quantum for the heights (meters).
+     * @param[in] maxbytes (optional) the memory budget for the circles
+     *   (bytes); the default is 16 MB.
+     * @exception GeographicErr if \e dlat or \e dh is not positive.
+     *
+     * Once this is called, Gravity, Disturbance, GeoidHeight, and
+     * SphericalAnomaly round \e lat and \e h to the nearest multiples of \e
+     * dlat and \e dh and evaluate the model using a GravityCircle for the
+     * rounded latitude and height.  The circles are held in a cache with
+     * least-recently-used eviction, so repeated queries at nearly constant
+     * latitude and height (e.g., by a tracking program) are computed
+     * efficiently.  The error incurred by rounding is bounded by the
+     * changes in the quantities over \e dlat/2 and \e dh/2; so these should
+     * be chosen to give sufficient accuracy.  GeoidHeight is computed at \e
+     * h = 0, which is always a multiple of \e dh.  The number of circles
+     * held is \e maxbytes divided by an estimate of the size of a circle
+     * (about 144 (\e Mmax + 1) bytes for double precision); at least one
+     * circle is always kept.  The lookups are serialized with a mutex, so
+     * the model can still be used on several threads; however, this function
+     * and CircleCacheClear should not be called while the model is being
+     * used on other threads.  This replaces any cache previously set up.
+     **********************************************************************/
+    void CacheCircles(real dlat, real dh,
+                      unsigned long long maxbytes = 1ULL << 24) const;
+
+    /**
+     * Clear the cache of circles and stop caching.  This never throws an
+     * error.
+     **********************************************************************/
+    void CircleCacheClear() const;
+
+    /**
+     * @return true if circles of latitude are being cached.
+     **********************************************************************/
+    bool CachingCircles() const { return _circles.Capacity() > 0; }
+
+    /**
+     * @return the maximum number of circles held by the cache.
+     **********************************************************************/
+    size_t CircleCacheCapacity() const { return _circles.Capacity(); }
+
+    /**
+     * @return the number of circles held by the cache.
+     **********************************************************************/
+    size_t CircleCacheSize() const { return _circles.Size(); }
+
+    /**
+     * @return the number of lookups satisfied by the cache (since the cache
+     *   was set up).
+     **********************************************************************/
+    unsigned long long CircleCacheHits() const { return _circles.Hits(); }
+
+    /**
+     * @return the number of lookups which required a circle to be
+     *   constructed (since the cache was set up).
+     **********************************************************************/
+    unsigned long long CircleCacheMisses() const { return _circles.Misses(); }
+    ///@}
+
+    /** \name Repacking the coefficients
+     **********************************************************************/
+    ///@{
+    /**
+     * Repack the coefficients of the gravitational sum for faster
+     * evaluation.
+     *
+     * @param[in] nsingle the coefficients for degrees above this are held in
+     *   single precision; if this is negative (the default), they are all
+     *   held in \e real.
+     * @exception std::bad_alloc if the memory for the packed coefficients
+     *   can't be allocated.
+     *
+     * This calls SphericalHarmonic::Pack for the sum for the gravitational
+     * potential, so that the coefficients and the factors for the Clenshaw
+     * recurrence are read from memory as a single sequential stream.  It
+     * speeds up Gravity, W, and V (and their geocentric versions) for high
+     * degree models such as egm2008, whose coefficients don't fit in the
+     * cache, at the cost of about twice the memory for these coefficients.
+     * The results are the same to within roundoff.  Call this before the
+     * model is used on several threads.
+     *
+     * Holding the high degree terms in single precision, e.g., with \e
+     * nsingle = 360 for egm2008, nearly halves the memory needed for the
+     * packed coefficients (and the memory traffic).  The sums are still
+     * accumulated in \e real and the relative error is about 6 &times;
+     * 10<sup>&minus;8</sup> of the contribution of the terms above \e
+     * nsingle, i.e., a few parts in 10<sup>12</sup> of the gravity.  This
+     * is far below the errors in the high degree coefficients themselves.
+     **********************************************************************/
+    void PackCoefficients(int nsingle = -1);
+
+    /**
+     * @return true if PackCoefficients has been called.
+     **********************************************************************/
+    bool PackedCoefficients() const
+    { return bool(_gravitational.Packed()); }
+    ///@}
+
+    /** \name Truncating the sums with height
      **********************************************************************/
-    GravityCircle Circle(real lat, real h, unsigned caps = ALL) const;
+    ///@{
+    /**
+     * Truncate the spherical harmonic sums according to the distance from
+     * the center of the earth.
+     *
+     * @param[in] tol the tolerance for the gravitational acceleration (m
+     *   s<sup>&minus;2</sup>); 0 turns off the truncation.
+     * @exception GeographicErr if \e tol is negative or NaN.
+     * @exception std::bad_alloc if the memory for the bounds on the terms
+     *   can't be allocated.
+     *
+     * The terms of degree \e n in the sums are attenuated by the factor
+     * (<i>a</i>/<i>r</i>)<sup>\e n + 1</sup>, so, far from the earth (e.g.,
+     * at the altitudes of satellites), most of the terms of a high degree
+     * model are negligible.  If \e tol > 0, the gravitational and disturbing
+     * sums are truncated at the smallest degree for which a rigorous bound
+     * on the gradient of the neglected terms (found by
+     * SphericalEngine::TruncatedDegree) is less than \e tol.  This applies
+     * to Gravity, Disturbance, GeoidHeight, SphericalAnomaly, W, V, T, and
+     * the geocentric versions of these functions; the errors in the
+     * potentials are less than \e tol \e r.  It doesn't apply to the
+     * batch functions or to GravityCircle objects.  The bounds are
+     * computed on the first call with \e tol > 0, in a time proportional to
+     * the number of coefficients.  Because the bound applies to the worst
+     * case, the actual errors are usually much less than \e tol.  This
+     * function should not be called while the model is being used on other
+     * threads.
+     **********************************************************************/
+    void SetTruncationTolerance(real tol) const;
+
+    /**
+     * @return the tolerance set by SetTruncationTolerance (0 if the sums
+     *   aren't truncated).
+     **********************************************************************/
+    Math::real TruncationTolerance() const { return _trunctol; }
+    ///@}
+
+    /** \name Memory usage and cost
+     **********************************************************************/
+    ///@{
+    /**
+     * @return the number of bytes of memory held by the object.
+     *
+     * This includes the coefficients (even though these are shared with
+     * copies of the object), the packed coefficients (see
+     * PackCoefficients), the cache of circles (see CacheCircles), and the
+     * bounds used to truncate the sums.  It doesn't include a memory mapped
+     * coefficient file or the table of square roots shared by all models
+     * (see SphericalEngine::RootTableMemoryUsage).  The size of the circles
+     * is estimated as in CacheCircles.
+     **********************************************************************/
+    size_t MemoryUsage() const;
+
+    /**
+     * @return the approximate number of floating point operations needed to
+     *   compute the gravity with Gravity or Disturbance at the full degree
+     *   and order of the model.
+     *
+     * This is dominated by the cost of the spherical harmonic sum; see
+     * SphericalEngine::CostEstimate.  The cost of evaluating the field on a
+     * GravityCircle at a single longitude is much smaller (see
+     * CircularEngine::CostEstimate).  Truncating the sums (see
+     * SetTruncationTolerance) reduces the cost above the earth's surface.
+     **********************************************************************/
+    unsigned long long CostEstimate() const;
     ///@}
 
     /** \name Inspector functions
@@ -508,6 +1051,12 @@ namespace GeographicLib {
      * @return \e Mmax the maximum order of the components of the model.
      **********************************************************************/
     int Order() const { return _mmx; }
+
+    /**
+     * @return true if the coefficient file is memory mapped.
+     **********************************************************************/
+    bool MemoryMapped() const
+    { return _coeffs && _coeffs->cofmap.data() != nullptr; }
     ///@}
 
     /**
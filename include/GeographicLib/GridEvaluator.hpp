@@ -0,0 +1,230 @@
+/**
+ * \file GridEvaluator.hpp
+ * \brief Header for GeographicLib::GridEvaluator class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_GRIDEVALUATOR_HPP)
+#define GEOGRAPHICLIB_GRIDEVALUATOR_HPP 1
+
+#include <GeographicLib/Constants.hpp>
+#include <functional>
+
+namespace GeographicLib {
+
+  class GravityModel;
+  class MagneticModel;
+
+  /**
+   * \brief Evaluate gravity and magnetic models on a latitude-longitude grid
+   *
+   * The grid consists of \e nlat rows at latitudes \e lat0 + \e i \e dlat,
+   * for \e i = 0, 1, ..., \e nlat &minus; 1, and \e nlon columns at
+   * longitudes \e lon0 + \e j \e dlon, for \e j = 0, 1, ..., \e nlon
+   * &minus; 1.  The results are stored in row-major order, so that the value
+   * for row \e i and column \e j is element \e i \e nlon + \e j of the
+   * output arrays.  If \e dlat is negative, the first row is the northern
+   * most one and the arrays have the layout of a north-up raster (e.g., a
+   * GeoTIFF image); GeoTransform returns the corresponding affine transform.
+   *
+   * For each row, a GravityCircle or MagneticCircle is constructed and this
+   * is used to evaluate the model at all the longitudes in the row.  This is
+   * much faster than evaluating the model at each point separately (see
+   * \ref gravityparallel).  The rows are processed on several threads; the
+   * results are identical to those obtained by evaluating the circles
+   * sequentially.
+   *
+   * The output arrays may be nullptr for quantities which are not needed.
+   *
+   * Example of use:
+   * \include example-GridEvaluator.cpp
+   **********************************************************************/
+  class GEOGRAPHICLIB_EXPORT GridEvaluator {
+  private:
+    typedef Math::real real;
+    real _lat0, _dlat, _lon0, _dlon;
+    int _nlat, _nlon;
+    unsigned _nthreads;
+    void Rows(const std::function<void(int, real)>& f) const;
+  public:
+
+    /**
+     * Constructor.
+     *
+     * @param[in] lat0 the latitude of the first row (degrees).
+     * @param[in] dlat the latitude spacing (degrees).
+     * @param[in] nlat the number of rows.
+     * @param[in] lon0 the longitude of the first column (degrees).
+     * @param[in] dlon the longitude spacing (degrees).
+     * @param[in] nlon the number of columns.
+     * @param[in] nthreads the number of threads to use; if this is 0 (the
+     *   default), use std::thread::hardware_concurrency().
+     * @exception GeographicErr if \e nlat or \e nlon is negative or if the
+     *   latitudes of the first or last rows are not in [&minus;90&deg;,
+     *   90&deg;].
+     **********************************************************************/
+    GridEvaluator(real lat0, real dlat, int nlat,
+                  real lon0, real dlon, int nlon,
+                  unsigned nthreads = 0);
+
+    /** \name Evaluating a gravity model on the grid
+     **********************************************************************/
+    ///@{
+    /**
+     * Evaluate the gravity on the grid.
+     *
+     * @param[in] g the gravity model.
+     * @param[in] h the height above the ellipsoid (meters).
+     * @param[out] W the sum of the gravitational and centrifugal potentials
+     *   (m<sup>2</sup> s<sup>&minus;2</sup>).
+     * @param[out] gx the easterly component of the acceleration
+     *   (m s<sup>&minus;2</sup>).
+     * @param[out] gy the northerly component of the acceleration
+     *   (m s<sup>&minus;2</sup>).
+     * @param[out] gz the upward component of the acceleration
+     *   (m s<sup>&minus;2</sup>); this is usually negative.
+     *
+     * The values are those given by GravityCircle::Gravity.
+     **********************************************************************/
+    void Gravity(const GravityModel& g, real h,
+                 real W[], real gx[], real gy[], real gz[]) const;
+
+    /**
+     * Evaluate the gravity disturbance vector on the grid.
+     *
+     * @param[in] g the gravity model.
+     * @param[in] h the height above the ellipsoid (meters).
+     * @param[out] T the corresponding disturbing potential
+     *   (m<sup>2</sup> s<sup>&minus;2</sup>).
+     * @param[out] deltax the easterly component of the disturbance vector
+     *   (m s<sup>&minus;2</sup>).
+     * @param[out] deltay the northerly component of the disturbance vector
+     *   (m s<sup>&minus;2</sup>).
+     * @param[out] deltaz the upward component of the disturbance vector
+     *   (m s<sup>&minus;2</sup>).
+     *
+     * The values are those given by GravityCircle::Disturbance.
+     **********************************************************************/
+    void Disturbance(const GravityModel& g, real h,
+                     real T[], real deltax[], real deltay[], real deltaz[])
+      const;
+
+    /**
+     * Evaluate the geoid height on the grid.
+     *
+     * @param[in] g the gravity model.
+     * @param[out] N the height of the geoid above the ellipsoid (meters).
+     *
+     * The values are those given by GravityCircle::GeoidHeight.
+     **********************************************************************/
+    void GeoidHeight(const GravityModel& g, real N[]) const;
+
+    /**
+     * Evaluate the components of the gravity anomaly vector on the grid
+     * using the spherical approximation.
+     *
+     * @param[in] g the gravity model.
+     * @param[in] h the height above the ellipsoid (meters).
+     * @param[out] Dg01 the gravity anomaly (m s<sup>&minus;2</sup>).
+     * @param[out] xi the northerly component of the deflection of the
+     *   vertical (degrees).
+     * @param[out] eta the easterly component of the deflection of the
+     *   vertical (degrees).
+     *
+     * The values are those given by GravityCircle::SphericalAnomaly.
+     **********************************************************************/
+    void SphericalAnomaly(const GravityModel& g, real h,
+                          real Dg01[], real xi[], real eta[]) const;
+    ///@}
+
+    /** \name Evaluating a magnetic model on the grid
+     **********************************************************************/
+    ///@{
+    /**
+     * Evaluate the magnetic field (and optionally its rate of change) on the
+     * grid.
+     *
+     * @param[in] m the magnetic model.
+     * @param[in] t the time (years).
+     * @param[in] h the height above the ellipsoid (meters).
+     * @param[out] Bx the easterly component of the magnetic field
+     *   (nanotesla).
+     * @param[out] By the northerly component of the magnetic field
+     *   (nanotesla).
+     * @param[out] Bz the vertical (up) component of the magnetic field
+     *   (nanotesla).
+     * @param[out] Bxt the rate of change of \e Bx (nT/yr).
+     * @param[out] Byt the rate of change of \e By (nT/yr).
+     * @param[out] Bzt the rate of change of \e Bz (nT/yr).
+     *
+     * The values are those given by MagneticCircle::operator()().  The
+     * rates of change are only computed if at least one of \e Bxt, \e Byt,
+     * and \e Bzt is not nullptr.
+     **********************************************************************/
+    void Field(const MagneticModel& m, real t, real h,
+               real Bx[], real By[], real Bz[],
+               real Bxt[] = nullptr, real Byt[] = nullptr,
+               real Bzt[] = nullptr) const;
+    ///@}
+
+    /** \name Inspector functions
+     **********************************************************************/
+    ///@{
+    /**
+     * @return the number of rows in the grid.
+     **********************************************************************/
+    int NumRows() const { return _nlat; }
+
+    /**
+     * @return the number of columns in the grid.
+     **********************************************************************/
+    int NumColumns() const { return _nlon; }
+
+    /**
+     * @return the number of elements in the grid (and thus the required size
+     *   of the output arrays).
+     **********************************************************************/
+    size_t Size() const { return size_t(_nlat) * size_t(_nlon); }
+
+    /**
+     * @param[in] i the row index.
+     * @return the latitude of row \e i (degrees).
+     **********************************************************************/
+    Math::real Latitude(int i) const { return _lat0 + i * _dlat; }
+
+    /**
+     * @param[in] j the column index.
+     * @return the longitude of column \e j (degrees).
+     **********************************************************************/
+    Math::real Longitude(int j) const { return _lon0 + j * _dlon; }
+
+    /**
+     * Return the affine transform for the raster.
+     *
+     * @param[out] gt an array of 6 elements.
+     *
+     * The transform maps the pixel coordinates (\e col, \e row) to (\e lon,
+     * \e lat) = (\e gt[0] + \e col \e gt[1] + \e row \e gt[2], \e gt[3] +
+     * \e col \e gt[4] + \e row \e gt[5]), where (0, 0) is the outer corner
+     * of the first pixel and the grid points are at the pixel centers.  This
+     * is the convention used by GDAL for GeoTIFF images.
+     **********************************************************************/
+    void GeoTransform(real gt[6]) const {
+      gt[0] = _lon0 - _dlon/2; gt[1] = _dlon; gt[2] = 0;
+      gt[3] = _lat0 - _dlat/2; gt[4] = 0; gt[5] = _dlat;
+    }
+
+    /**
+     * @return the number of threads used.
+     **********************************************************************/
+    unsigned NumThreads() const { return _nthreads; }
+    ///@}
+
+  };
+
+} // namespace GeographicLib
+
+#endif  // GEOGRAPHICLIB_GRIDEVALUATOR_HPP
@@ -0,0 +1,213 @@
+/**
+ * \file GridLines.hpp
+ * \brief Header for GeographicLib::GridLines class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_GRIDLINES_HPP)
+#define GEOGRAPHICLIB_GRIDLINES_HPP 1
+
+#include <functional>
+#include <vector>
+#include <GeographicLib/Constants.hpp>
+
+#if defined(_MSC_VER)
+// Squelch warnings about dll vs vector
+#  pragma warning (push)
+#  pragma warning (disable: 4251)
+#endif
+
+namespace GeographicLib {
+
+  /**
+   * \brief Generate graticules and UTM/MGRS grids for drawing maps
+   *
+   * This generates the polylines for drawing a graticule (lines of constant
+   * latitude and longitude) and the UTM grid (lines of constant easting and
+   * northing, which also bound the MGRS squares) over a viewport given as a
+   * range of latitudes and longitudes.  The lines are returned both as
+   * geographic coordinates and as coordinates in a target projection
+   * supplied by the caller.
+   *
+   * Each line is first sampled at a fixed number of points.  The portions of
+   * the line lying inside the viewport (and, for the UTM grid, inside the
+   * UTM zone as given by UTMUPS::StandardZone, which includes the Norway
+   * and Svalbard exceptions, and between 80&deg;S and 84&deg;N) are found
+   * and their ends are located by bisection.  Each portion is then densified
+   * adaptively: a segment is split if the projection of its midpoint lies
+   * further than a tolerance from the projected segment.  All the points at
+   * each stage are projected together so that the batch routines
+   * TransverseMercator::ReverseBatch and the caller's batch projection are
+   * used.
+   *
+   * The longitudes along each line are continuous (they're not reduced to
+   * [&minus;180&deg;, 180&deg;]); this avoids breaks at the antimeridian.
+   * The UPS grid for the polar regions is not generated.
+   *
+   * Example of use:
+   * \code
+   * // Draw the 10 km UTM grid over southern England in Web Mercator
+   * GridLines::projection webmerc =
+   *   [](size_t n, const double lat[], const double lon[],
+   *      double x[], double y[]) -> void {
+   *     for (size_t i = 0; i < n; ++i) {
+   *       x[i] = 6378137 * lon[i] * Math::degree();
+   *       y[i] = 6378137 * Math::asinh(Math::tand(lat[i]));
+   *     }
+   *   };
+   * GridLines grid(50, 52, -6, 2, webmerc, 10.0);
+   * std::vector<GridLines::Line> lines;
+   * grid.UTM(10000, lines);
+   * \endcode
+   **********************************************************************/
+  class GEOGRAPHICLIB_EXPORT GridLines {
+  public:
+    /**
+     * The type of the target projection.  This projects \e n points given
+     * by the arrays \e lat and \e lon to the arrays \e x and \e y.
+     **********************************************************************/
+    typedef std::function<void(size_t n, const Math::real lat[],
+                               const Math::real lon[],
+                               Math::real x[], Math::real y[])> projection;
+    /**
+     * The types of the lines.
+     **********************************************************************/
+    enum linetype {
+      /**
+       * A meridian; \e value is the longitude (degrees).
+       * @hideinitializer
+       **********************************************************************/
+      MERIDIAN = 0,
+      /**
+       * A parallel; \e value is the latitude (degrees).
+       * @hideinitializer
+       **********************************************************************/
+      PARALLEL = 1,
+      /**
+       * A line of constant UTM easting; \e value is the easting (meters).
+       * @hideinitializer
+       **********************************************************************/
+      EASTING = 2,
+      /**
+       * A line of constant UTM northing; \e value is the northing (meters)
+       * in the hemisphere given by \e northp.
+       * @hideinitializer
+       **********************************************************************/
+      NORTHING = 3,
+    };
+    /**
+     * A polyline.
+     **********************************************************************/
+    struct Line {
+      /**
+       * The GridLines::linetype of the line.
+       **********************************************************************/
+      int type;
+      /**
+       * The UTM zone (0 for the graticule).
+       **********************************************************************/
+      int zone;
+      /**
+       * The hemisphere of a NORTHING line.
+       **********************************************************************/
+      bool northp;
+      /**
+       * The longitude, latitude, easting, or northing of the line.
+       **********************************************************************/
+      Math::real value;
+      /**
+       * The geographic coordinates of the points (degrees).
+       **********************************************************************/
+      std::vector<Math::real> lat, lon;
+      /**
+       * The projected coordinates of the points.
+       **********************************************************************/
+      std::vector<Math::real> x, y;
+    };
+  private:
+    typedef Math::real real;
+    // The number of points at which a line is first sampled
+    static const int nsample_ = 32;
+    // The maximum number of passes of the densification
+    static const int maxpass_ = 20;
+    // The number of bisections to locate the ends of the portions
+    static const int numit_ = 40;
+    real _lat1, _lat2, _lon1, _lon2, _tol;
+    projection _proj;
+    // A curve: find lat and lon for n values of the parameter t
+    typedef std::function<void(size_t n, const real t[],
+                               real lat[], real lon[])> curve;
+    // A test for whether a point is on the wanted portion of a curve
+    typedef std::function<bool(real lat, real lon)> predicate;
+    bool InView(real lat, real lon) const;
+    void Project(size_t n, const real lat[], const real lon[],
+                 real x[], real y[]) const;
+    void Trace(const curve& f, const predicate& inside, real t0, real t1,
+               Line& line, std::vector<Line>& lines) const;
+  public:
+
+    /**
+     * Constructor.
+     *
+     * @param[in] lat1 the southern latitude of the viewport (degrees).
+     * @param[in] lat2 the northern latitude of the viewport (degrees).
+     * @param[in] lon1 the western longitude of the viewport (degrees).
+     * @param[in] lon2 the eastern longitude of the viewport (degrees).
+     * @param[in] proj the target projection; if this is empty (the
+     *   default), \e x = \e lon and \e y = \e lat.
+     * @param[in] tol the tolerance for the densification in the units of
+     *   the target projection (default 0.01, suitable for degrees if \e
+     *   proj is empty).
+     * @exception GeographicErr if \e lat1 or \e lat2 is not in
+     *   [&minus;90&deg;, 90&deg;] or if \e lat1 > \e lat2 or if \e tol is
+     *   not positive.
+     *
+     * The viewport extends east from \e lon1 to \e lon2; so if \e lon2 is
+     * west of \e lon1, it spans the antimeridian.  If \e lon2 = \e lon1 +
+     * 360&deg;, it covers all longitudes.
+     **********************************************************************/
+    GridLines(real lat1, real lat2, real lon1, real lon2,
+              const projection& proj = projection(), real tol = real(0.01));
+
+    /**
+     * Generate a graticule.
+     *
+     * @param[in] dlat the spacing of the parallels (degrees).
+     * @param[in] dlon the spacing of the meridians (degrees).
+     * @param[out] lines the polylines for the meridians and parallels.
+     * @exception GeographicErr if \e dlat or \e dlon is not positive.
+     *
+     * The meridians and parallels are at multiples of \e dlon and \e dlat
+     * and they are clipped to the viewport.  The poles are omitted.
+     **********************************************************************/
+    void Graticule(real dlat, real dlon, std::vector<Line>& lines) const;
+
+    /**
+     * Generate a UTM grid.
+     *
+     * @param[in] spacing the spacing of the grid lines (meters).
+     * @param[out] lines the polylines for the lines of constant easting and
+     *   northing.
+     * @exception GeographicErr if \e spacing is not positive.
+     *
+     * The lines of constant easting and northing are at multiples of \e
+     * spacing and are clipped to the viewport and to their UTM zones.  With
+     * \e spacing = 100 km, the lines bound the MGRS 100 km squares (for zones
+     * where these are not truncated); with \e spacing = 1 km, they bound the
+     * 1 km squares.  The lines of constant easting cross the equator; the
+     * lines of constant northing are given separately for each hemisphere.
+     **********************************************************************/
+    void UTM(real spacing, std::vector<Line>& lines) const;
+
+  };
+
+} // namespace GeographicLib
+
+#if defined(_MSC_VER)
+#  pragma warning (pop)
+#endif
+
+#endif  // GEOGRAPHICLIB_GRIDLINES_HPP
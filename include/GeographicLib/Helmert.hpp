@@ -0,0 +1,302 @@
+/**
+ * \file Helmert.hpp
+ * \brief Header for GeographicLib::Helmert class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_HELMERT_HPP)
+#define GEOGRAPHICLIB_HELMERT_HPP 1
+
+#include <GeographicLib/Geocentric.hpp>
+
+namespace GeographicLib {
+
+  /**
+   * \brief Helmert transformations between datums
+   *
+   * A Helmert (or similarity) transformation converts geocentric coordinates
+   * between two datums.  It's specified by a translation (\e tx, \e ty, \e
+   * tz), a scale change \e s, and small rotations (\e rx, \e ry, \e rz) about
+   * the three axes:
+   * \f[
+   * \begin{bmatrix} X' \\ Y' \\ Z' \end{bmatrix} =
+   * \begin{bmatrix} t_x \\ t_y \\ t_z \end{bmatrix} + (1 + s)
+   * \begin{bmatrix}
+   *   1 & -r_z & r_y \\
+   *   r_z & 1 & -r_x \\
+   *   -r_y & r_x & 1
+   * \end{bmatrix}
+   * \begin{bmatrix} X \\ Y \\ Z \end{bmatrix}.
+   * \f]
+   * This is the "position vector" convention used by the IERS for the
+   * transformations between realizations of the ITRF; the "coordinate frame"
+   * convention (used, e.g., by EPSG method 9607) reverses the signs of the
+   * rotations; this convention is selected with the \e coordframe argument
+   * to the constructor.
+   *
+   * The 14-parameter (time-dependent) transformation adds the rates of
+   * change of the 7 parameters and a reference epoch \e t0.  AtEpoch
+   * returns the 7-parameter transformation at a particular epoch.
+   *
+   * The translations are in meters, the scale change in parts per million
+   * (ppm), and the rotations in arcseconds.  The rates of change are in the
+   * same units per year and the epochs are in years.
+   *
+   * The reverse transformation is computed by inverting the matrix exactly,
+   * so Reverse undoes Forward to within roundoff (unlike the common
+   * approximation of changing the signs of the parameters).
+   *
+   * ForwardBatch and ReverseBatch transform arrays of geocentric
+   * coordinates.  ForwardGeodeticBatch and ReverseGeodeticBatch transform
+   * arrays of geodetic coordinates; the points are converted to geocentric
+   * coordinates with Geocentric::ForwardBatch, transformed, and converted
+   * back with Geocentric::ReverseBatch, a block of points at a time, so
+   * that the intermediate geocentric coordinates stay in the cache.
+   *
+   * Example of use:
+   * \code
+   * // ITRF2014 to ITRF2008 at epoch 2020.0
+   * Helmert h(1.6e-3, 1.9e-3, 2.4e-3, -0.02e-3, 0, 0, 0,
+   *           0, 0, -0.1e-3, 0.03e-3, 0, 0, 0, 2010);
+   * Helmert h2020 = h.AtEpoch(2020);
+   * h2020.ForwardGeodeticBatch(n, Geocentric::WGS84(), lat, lon, ht,
+   *                            Geocentric::WGS84(), lat1, lon1, ht1);
+   * \endcode
+   **********************************************************************/
+
+  class GEOGRAPHICLIB_EXPORT Helmert {
+  private:
+    typedef Math::real real;
+    static const size_t dim_ = 3;
+    static const size_t dim2_ = dim_ * dim_;
+    // The number of points transformed together by ForwardGeodeticBatch and
+    // ReverseGeodeticBatch
+    static const int batchsize_ = 64;
+    // The parameters in the order tx, ty, tz, s, rx, ry, rz
+    real _p[7], _dp[7], _t0;
+    bool _coordframe;
+    // The translations and the matrices (row-major) of the forward and
+    // reverse transformations
+    real _t[dim_], _m[dim2_], _ti[dim_], _mi[dim2_];
+    void Init();
+    static void Apply(const real t[], const real m[],
+                      real X, real Y, real Z, real& X1, real& Y1, real& Z1) {
+      X1 = t[0] + m[0] * X + m[1] * Y + m[2] * Z;
+      Y1 = t[1] + m[3] * X + m[4] * Y + m[5] * Z;
+      Z1 = t[2] + m[6] * X + m[7] * Y + m[8] * Z;
+    }
+    static void ApplyBatch(const real t[], const real m[], size_t n,
+                           const real X[], const real Y[], const real Z[],
+                           real X1[], real Y1[], real Z1[]);
+  public:
+
+    /**
+     * Constructor for the identity transformation.
+     **********************************************************************/
+    Helmert();
+
+    /**
+     * Constructor for a 7-parameter transformation.
+     *
+     * @param[in] tx the translation in \e X (meters).
+     * @param[in] ty the translation in \e Y (meters).
+     * @param[in] tz the translation in \e Z (meters).
+     * @param[in] s the scale change (ppm).
+     * @param[in] rx the rotation about the \e X axis (arcseconds).
+     * @param[in] ry the rotation about the \e Y axis (arcseconds).
+     * @param[in] rz the rotation about the \e Z axis (arcseconds).
+     * @param[in] coordframe if true use the coordinate frame convention for
+     *   the rotations (default = false, i.e., the position vector
+     *   convention).
+     **********************************************************************/
+    Helmert(real tx, real ty, real tz, real s, real rx, real ry, real rz,
+            bool coordframe = false);
+
+    /**
+     * Constructor for a 14-parameter (time-dependent) transformation.
+     *
+     * @param[in] tx the translation in \e X at the reference epoch (meters).
+     * @param[in] ty the translation in \e Y at the reference epoch (meters).
+     * @param[in] tz the translation in \e Z at the reference epoch (meters).
+     * @param[in] s the scale change at the reference epoch (ppm).
+     * @param[in] rx the rotation about the \e X axis at the reference epoch
+     *   (arcseconds).
+     * @param[in] ry the rotation about the \e Y axis at the reference epoch
+     *   (arcseconds).
+     * @param[in] rz the rotation about the \e Z axis at the reference epoch
+     *   (arcseconds).
+     * @param[in] dtx the rate of change of \e tx (meters/year).
+     * @param[in] dty the rate of change of \e ty (meters/year).
+     * @param[in] dtz the rate of change of \e tz (meters/year).
+     * @param[in] ds the rate of change of \e s (ppm/year).
+     * @param[in] drx the rate of change of \e rx (arcseconds/year).
+     * @param[in] dry the rate of change of \e ry (arcseconds/year).
+     * @param[in] drz the rate of change of \e rz (arcseconds/year).
+     * @param[in] t0 the reference epoch (years).
+     * @param[in] coordframe if true use the coordinate frame convention for
+     *   the rotations (default = false, i.e., the position vector
+     *   convention).
+     *
+     * The object transforms points at the reference epoch; use AtEpoch to
+     * obtain the transformation at another epoch.
+     **********************************************************************/
+    Helmert(real tx, real ty, real tz, real s, real rx, real ry, real rz,
+            real dtx, real dty, real dtz, real ds,
+            real drx, real dry, real drz, real t0, bool coordframe = false);
+
+    /**
+     * The transformation at a particular epoch.
+     *
+     * @param[in] t the epoch (years).
+     * @return the Helmert object for epoch \e t.
+     *
+     * The returned object has the same rates of change with its reference
+     * epoch set to \e t.
+     **********************************************************************/
+    Helmert AtEpoch(real t) const;
+
+    /**
+     * Transform a point.
+     *
+     * @param[in] X geocentric coordinate in the first datum (meters).
+     * @param[in] Y geocentric coordinate in the first datum (meters).
+     * @param[in] Z geocentric coordinate in the first datum (meters).
+     * @param[out] X1 geocentric coordinate in the second datum (meters).
+     * @param[out] Y1 geocentric coordinate in the second datum (meters).
+     * @param[out] Z1 geocentric coordinate in the second datum (meters).
+     **********************************************************************/
+    void Forward(real X, real Y, real Z, real& X1, real& Y1, real& Z1)
+      const { Apply(_t, _m, X, Y, Z, X1, Y1, Z1); }
+
+    /**
+     * Transform a point in the reverse direction.
+     *
+     * @param[in] X1 geocentric coordinate in the second datum (meters).
+     * @param[in] Y1 geocentric coordinate in the second datum (meters).
+     * @param[in] Z1 geocentric coordinate in the second datum (meters).
+     * @param[out] X geocentric coordinate in the first datum (meters).
+     * @param[out] Y geocentric coordinate in the first datum (meters).
+     * @param[out] Z geocentric coordinate in the first datum (meters).
+     **********************************************************************/
+    void Reverse(real X1, real Y1, real Z1, real& X, real& Y, real& Z)
+      const { Apply(_ti, _mi, X1, Y1, Z1, X, Y, Z); }
+
+    /**
+     * Transform several points.
+     *
+     * @param[in] n the number of points.
+     * @param[in] X array of geocentric coordinates in the first datum
+     *   (meters).
+     * @param[in] Y array of geocentric coordinates in the first datum
+     *   (meters).
+     * @param[in] Z array of geocentric coordinates in the first datum
+     *   (meters).
+     * @param[out] X1 array of geocentric coordinates in the second datum
+     *   (meters).
+     * @param[out] Y1 array of geocentric coordinates in the second datum
+     *   (meters).
+     * @param[out] Z1 array of geocentric coordinates in the second datum
+     *   (meters).
+     *
+     * This gives the same results as calling Forward for each point.  The
+     * output arrays may coincide with the input arrays.
+     **********************************************************************/
+    void ForwardBatch(size_t n, const real X[], const real Y[],
+                      const real Z[], real X1[], real Y1[], real Z1[]) const
+    { ApplyBatch(_t, _m, n, X, Y, Z, X1, Y1, Z1); }
+
+    /**
+     * Transform several points in the reverse direction.
+     *
+     * @param[in] n the number of points.
+     * @param[in] X1 array of geocentric coordinates in the second datum
+     *   (meters).
+     * @param[in] Y1 array of geocentric coordinates in the second datum
+     *   (meters).
+     * @param[in] Z1 array of geocentric coordinates in the second datum
+     *   (meters).
+     * @param[out] X array of geocentric coordinates in the first datum
+     *   (meters).
+     * @param[out] Y array of geocentric coordinates in the first datum
+     *   (meters).
+     * @param[out] Z array of geocentric coordinates in the first datum
+     *   (meters).
+     *
+     * This gives the same results as calling Reverse for each point.  The
+     * output arrays may coincide with the input arrays.
+     **********************************************************************/
+    void ReverseBatch(size_t n, const real X1[], const real Y1[],
+                      const real Z1[], real X[], real Y[], real Z[]) const
+    { ApplyBatch(_ti, _mi, n, X1, Y1, Z1, X, Y, Z); }
+
+    /**
+     * Transform several points given in geodetic coordinates.
+     *
+     * @param[in] n the number of points.
+     * @param[in] earth the Geocentric object for the ellipsoid of the first
+     *   datum.
+     * @param[in] lat array of latitudes in the first datum (degrees).
+     * @param[in] lon array of longitudes in the first datum (degrees).
+     * @param[in] h array of heights in the first datum (meters).
+     * @param[in] earth1 the Geocentric object for the ellipsoid of the
+     *   second datum.
+     * @param[out] lat1 array of latitudes in the second datum (degrees).
+     * @param[out] lon1 array of longitudes in the second datum (degrees).
+     * @param[out] h1 array of heights in the second datum (meters).
+     *
+     * This gives the same results as calling \e earth.ForwardBatch,
+     * ForwardBatch, and \e earth1.ReverseBatch in turn.  The output arrays
+     * may coincide with the input arrays.
+     **********************************************************************/
+    void ForwardGeodeticBatch(size_t n, const Geocentric& earth,
+                              const real lat[], const real lon[],
+                              const real h[], const Geocentric& earth1,
+                              real lat1[], real lon1[], real h1[]) const;
+
+    /**
+     * Transform several points given in geodetic coordinates in the reverse
+     * direction.
+     *
+     * @param[in] n the number of points.
+     * @param[in] earth1 the Geocentric object for the ellipsoid of the
+     *   second datum.
+     * @param[in] lat1 array of latitudes in the second datum (degrees).
+     * @param[in] lon1 array of longitudes in the second datum (degrees).
+     * @param[in] h1 array of heights in the second datum (meters).
+     * @param[in] earth the Geocentric object for the ellipsoid of the first
+     *   datum.
+     * @param[out] lat array of latitudes in the first datum (degrees).
+     * @param[out] lon array of longitudes in the first datum (degrees).
+     * @param[out] h array of heights in the first datum (meters).
+     *
+     * This gives the same results as calling \e earth1.ForwardBatch,
+     * ReverseBatch, and \e earth.ReverseBatch in turn.  The output arrays
+     * may coincide with the input arrays.
+     **********************************************************************/
+    void ReverseGeodeticBatch(size_t n, const Geocentric& earth1,
+                              const real lat1[], const real lon1[],
+                              const real h1[], const Geocentric& earth,
+                              real lat[], real lon[], real h[]) const;
+
+    /** \name Inspector functions
+     **********************************************************************/
+    ///@{
+    /**
+     * @return the reference epoch (years).
+     **********************************************************************/
+    Math::real Epoch() const { return _t0; }
+
+    /**
+     * @return whether the coordinate frame convention is used for the
+     *   rotations.
+     **********************************************************************/
+    bool CoordinateFrame() const { return _coordframe; }
+    ///@}
+  };
+
+} // namespace GeographicLib
+
+#endif  // GEOGRAPHICLIB_HELMERT_HPP
@@ -0,0 +1,142 @@
+/**
+ * \file Histogram.hpp
+ * \brief Header for GeographicLib::Histogram class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_HISTOGRAM_HPP)
+#define GEOGRAPHICLIB_HISTOGRAM_HPP 1
+
+#include <GeographicLib/Constants.hpp>
+#include <atomic>
+#include <vector>
+
+namespace GeographicLib {
+
+  /**
+   * \brief A histogram of small non-negative integers
+   *
+   * This is used to record the behavior of the iterative solvers when the
+   * library is configured with GEOGRAPHICLIB_INSTRUMENT = 1 (the cmake
+   * option of the same name).  In this case Geodesic,
+   * TransverseMercatorExact, EllipticFunction, and NearestNeighbor keep
+   * histograms of, e.g., the number of Newton iterations, which can be
+   * retrieved with their accessors and exported with Bins().  With the
+   * default setting GEOGRAPHICLIB_INSTRUMENT = 0, nothing is recorded and the
+   * accessors are absent.
+   *
+   * The bins are atomic counters which are incremented with relaxed memory
+   * ordering, so a histogram can be updated concurrently by several threads
+   * (e.g., by a GeodesicBatchExecutor); however, the contention for the
+   * counters makes this slower than an uninstrumented build.  Values outside
+   * [0, \e nbins) are counted in the first or last bin.
+   **********************************************************************/
+  class Histogram {
+  public:
+    /**
+     * The number of bins.
+     **********************************************************************/
+    static const int nbins = 64;
+
+    /**
+     * Constructor for an empty histogram.
+     **********************************************************************/
+    Histogram() { Reset(); }
+
+    /**
+     * Copy constructor; this takes a snapshot of \e h.
+     **********************************************************************/
+    Histogram(const Histogram& h) { *this = h; }
+
+    /**
+     * Assignment; this takes a snapshot of \e h.
+     **********************************************************************/
+    Histogram& operator=(const Histogram& h) {
+      for (int k = 0; k < nbins; ++k)
+        _bins[k].store(h.Count(k), std::memory_order_relaxed);
+      return *this;
+    }
+
+    /**
+     * Record a value.
+     *
+     * @param[in] k the value.
+     **********************************************************************/
+    void Add(int k) {
+      _bins[k < 0 ? 0 : (k < nbins ? k : nbins - 1)]
+        .fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * Reset all the bins to zero.
+     **********************************************************************/
+    void Reset() {
+      for (int k = 0; k < nbins; ++k)
+        _bins[k].store(0, std::memory_order_relaxed);
+    }
+
+    /**
+     * @param[in] k the bin.
+     * @return the number of times \e k has been recorded.
+     **********************************************************************/
+    unsigned long long Count(int k) const {
+      return k >= 0 && k < nbins ? _bins[k].load(std::memory_order_relaxed) :
+        0;
+    }
+
+    /**
+     * @return the total number of values recorded.
+     **********************************************************************/
+    unsigned long long Total() const {
+      unsigned long long t = 0;
+      for (int k = 0; k < nbins; ++k) t += Count(k);
+      return t;
+    }
+
+    /**
+     * @return the mean of the values recorded (NaN if there are none).
+     **********************************************************************/
+    double Mean() const {
+      unsigned long long t = 0, s = 0;
+      for (int k = 0; k < nbins; ++k) {
+        unsigned long long c = Count(k);
+        t += c; s += c * k;
+      }
+      return t ? double(s) / double(t) : Math::NaN<double>();
+    }
+
+    /**
+     * @return the counts in the bins with the trailing empty bins removed;
+     *   element \e k is Count(\e k).
+     **********************************************************************/
+    std::vector<unsigned long long> Bins() const {
+      std::vector<unsigned long long> b(nbins);
+      int n = 0;
+      for (int k = 0; k < nbins; ++k)
+        if ((b[k] = Count(k)) != 0) n = k + 1;
+      b.resize(n);
+      return b;
+    }
+
+    /**
+     * @param[in] c a non-negative integer.
+     * @return the number of bits needed to represent \e c, i.e., 0 for \e c =
+     *   0 and floor(log<sub>2</sub>\e c) + 1 otherwise.  Passing this to
+     *   Add() gives logarithmic bins for quantities with a wide range.
+     **********************************************************************/
+    static int Log2Bin(unsigned long long c) {
+      int k = 0;
+      for (; c; c >>= 1) ++k;
+      return k;
+    }
+
+  private:
+    std::atomic<unsigned long long> _bins[nbins];
+  };
+
+} // namespace GeographicLib
+
+#endif  // GEOGRAPHICLIB_HISTOGRAM_HPP
@@ -0,0 +1,304 @@
+/**
+ * \file Intersect.hpp
+ * \brief Header for GeographicLib::Intersect class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_INTERSECT_HPP)
+#define GEOGRAPHICLIB_INTERSECT_HPP 1
+
+#include <utility>
+#include <vector>
+#include <GeographicLib/Geodesic.hpp>
+#include <GeographicLib/GeodesicLine.hpp>
+#include <GeographicLib/Geocentric.hpp>
+#include <GeographicLib/Constants.hpp>
+
+namespace GeographicLib {
+
+  /**
+   * \brief Geodesic intersections
+   *
+   * Find the intersections of two geodesics \e X and \e Y.  The positions of
+   * an intersection are given by the displacements \e x and \e y of the
+   * intersection along \e X and \e Y from their starting points (in meters).
+   * A pair (\e x, \e y) is represented by a Point.
+   *
+   * The intersection is found by an iteration which is essentially Newton's
+   * method.  Given trial points on \e X and \e Y, the geodesic joining them
+   * and the azimuths of \e X and \e Y at these points define a triangle.
+   * This is solved as a spherical triangle on a sphere whose radius is the
+   * mean radius of the ellipsoid, giving corrections to \e x and \e y.
+   * Because short geodesic triangles on the ellipsoid and on the sphere
+   * differ at second order, the convergence is quadratic; typically 2 or 3
+   * iterations suffice for segments a few hundred kilometers long.  Each
+   * iteration costs two calls to GeodesicLine::Position and one inverse
+   * geodesic calculation.
+   *
+   * Segment finds the intersection of two geodesic segments.  The starting
+   * point for the iteration is obtained from the gnomonic projection of the
+   * auxiliary sphere (on which the parametric latitudes of the endpoints are
+   * used as spherical latitudes); in this projection great circles are
+   * straight lines, so the intersection is found with a few cross products.
+   * This is very cheap and for short segments is accurate to a small
+   * fraction of the flattening times the segment length, which usually saves
+   * an iteration compared with starting at the midpoints.  (The ellipsoidal
+   * Gnomonic projection would give a slightly better starting point, but
+   * projecting the four endpoints costs four inverse geodesic calculations,
+   * more than the iteration it saves.)
+   *
+   * AllSegments finds all the intersections between two sets of segments.
+   * Each segment is enclosed in a bounding cap given by
+   * GeodesicLine::BoundingCap: its center is the midpoint of the segment
+   * and its radius is half the length of the segment.  Two
+   * segments can only intersect if the geodesic distance between the centers
+   * of their caps is no more than the sum of the radii.  Since the geodesic
+   * distance between two points is at least the length of the chord joining
+   * them, this condition can be tested cheaply and rigorously using
+   * geocentric coordinates.  In addition, the caps for the second set are
+   * sorted by their geocentric \e Z coordinate so that only those with
+   * overlapping \e Z ranges are examined.  The surviving pairs are handed
+   * to Segment, and the work is divided among several threads using
+   * GeodesicBatchExecutor.
+   *
+   * Coincident geodesics are detected; in this case the midpoint of the
+   * trial points is returned and the coincidence indicator \e c is set to
+   * +1 if the geodesics are parallel and &minus;1 if they are antiparallel.
+   * Otherwise, \e c = 0.
+   *
+   * Intersect objects are not altered once they have been constructed, so
+   * they can be shared by several threads.
+   *
+   * Example of use:
+   * \include example-Intersect.cpp
+   **********************************************************************/
+  class GEOGRAPHICLIB_EXPORT Intersect {
+  private:
+    typedef Math::real real;
+    static const unsigned caps_ = Geodesic::LATITUDE | Geodesic::LONGITUDE |
+      Geodesic::AZIMUTH | Geodesic::DISTANCE_IN;
+    static const int numit_ = 50;
+    Geodesic _geod;
+    Geocentric _earth;
+    real _r, _eps, _tol, _angtol;
+    // The endpoints of a geodesic segment and its bounding cap; the center
+    // of the cap is given in geocentric coordinates.
+    struct Cap {
+      real lat1, lon1, lat2, lon2;
+      real X, Y, Z, r;
+    };
+    void MakeCap(real lat1, real lon1, real lat2, real lon2, Cap& cap) const;
+    std::pair<real, real> Start(const Cap& cx, const Cap& cy,
+                                real sx, real sy) const;
+    std::pair<real, real> Segment(const GeodesicLine& lineX,
+                                  const GeodesicLine& lineY,
+                                  const Cap& cx, const Cap& cy,
+                                  int& segmode, int* c) const;
+  public:
+
+    /**
+     * The type used to hold the displacements along the two geodesics.
+     **********************************************************************/
+    typedef std::pair<real, real> Point;
+
+    /**
+     * An intersection found by AllSegments.
+     **********************************************************************/
+    struct Crossing {
+      /**
+       * The index of the segment in the first set.
+       **********************************************************************/
+      size_t i;
+      /**
+       * The index of the segment in the second set.
+       **********************************************************************/
+      size_t j;
+      /**
+       * The displacement of the intersection along segment \e i (meters).
+       **********************************************************************/
+      real x;
+      /**
+       * The displacement of the intersection along segment \e j (meters).
+       **********************************************************************/
+      real y;
+      /**
+       * The coincidence indicator.
+       **********************************************************************/
+      int c;
+    };
+
+    /**
+     * Constructor for Intersect.
+     *
+     * @param[in] geod the Geodesic object to use for geodesic calculations.
+     *   By default this uses the WGS84 ellipsoid.
+     **********************************************************************/
+    explicit Intersect(const Geodesic& geod = Geodesic::WGS84());
+
+    /**
+     * Find the intersection of two geodesics closest to a given point.
+     *
+     * @param[in] latX latitude of starting point of geodesic \e X (degrees).
+     * @param[in] lonX longitude of starting point of geodesic \e X (degrees).
+     * @param[in] aziX azimuth at starting point of geodesic \e X (degrees).
+     * @param[in] latY latitude of starting point of geodesic \e Y (degrees).
+     * @param[in] lonY longitude of starting point of geodesic \e Y (degrees).
+     * @param[in] aziY azimuth at starting point of geodesic \e Y (degrees).
+     * @param[in] p0 the starting guess for the displacements (meters); by
+     *   default (0, 0).
+     * @param[out] c (optional) the coincidence indicator.
+     * @return the displacements (\e x, \e y) of the intersection along the
+     *   two geodesics (meters).
+     *
+     * The iteration converges to an intersection close to \e p0; however,
+     * if \e p0 is far (more than about a quarter meridian) from an
+     * intersection, it is not guaranteed that the closest intersection is
+     * found.
+     **********************************************************************/
+    Point Closest(real latX, real lonX, real aziX,
+                  real latY, real lonY, real aziY,
+                  const Point& p0 = Point(0, 0), int* c = nullptr) const;
+
+    /**
+     * Find the intersection of two geodesics closest to a given point using
+     * GeodesicLine objects.
+     *
+     * @param[in] lineX the geodesic \e X.
+     * @param[in] lineY the geodesic \e Y.
+     * @param[in] p0 the starting guess for the displacements (meters); by
+     *   default (0, 0).
+     * @param[out] c (optional) the coincidence indicator.
+     * @return the displacements (\e x, \e y) of the intersection along the
+     *   two geodesics (meters).
+     *
+     * \e lineX and \e lineY should have been constructed with \e caps
+     * including Geodesic::LATITUDE, Geodesic::LONGITUDE, Geodesic::AZIMUTH,
+     * and Geodesic::DISTANCE_IN and by the same ellipsoid as this object.
+     **********************************************************************/
+    Point Closest(const GeodesicLine& lineX, const GeodesicLine& lineY,
+                  const Point& p0 = Point(0, 0), int* c = nullptr) const;
+
+    /**
+     * Find the intersection of two geodesic segments.
+     *
+     * @param[in] latX1 latitude of starting point of segment \e X (degrees).
+     * @param[in] lonX1 longitude of starting point of segment \e X (degrees).
+     * @param[in] latX2 latitude of ending point of segment \e X (degrees).
+     * @param[in] lonX2 longitude of ending point of segment \e X (degrees).
+     * @param[in] latY1 latitude of starting point of segment \e Y (degrees).
+     * @param[in] lonY1 longitude of starting point of segment \e Y (degrees).
+     * @param[in] latY2 latitude of ending point of segment \e Y (degrees).
+     * @param[in] lonY2 longitude of ending point of segment \e Y (degrees).
+     * @param[out] segmode an indicator of where the intersection lies
+     *   relative to the segments.
+     * @param[out] c (optional) the coincidence indicator.
+     * @return the displacements (\e x, \e y) of the intersection along the
+     *   two segments (meters).
+     *
+     * The segments are the shortest geodesics between the endpoints.  The
+     * intersection returned is the one closest to the segments.  \e segmode
+     * = 3 \e kx + \e ky, where \e kx = &minus;1, 0, or 1 according as \e x
+     * is before, within, or after segment \e X and similarly for \e ky.
+     * Thus the segments intersect if \e segmode = 0.
+     **********************************************************************/
+    Point Segment(real latX1, real lonX1, real latX2, real lonX2,
+                  real latY1, real lonY1, real latY2, real lonY2,
+                  int& segmode, int* c = nullptr) const;
+
+    /**
+     * Find the intersection of two geodesic segments using GeodesicLine
+     * objects.
+     *
+     * @param[in] lineX the segment \e X.
+     * @param[in] lineY the segment \e Y.
+     * @param[out] segmode an indicator of where the intersection lies
+     *   relative to the segments.
+     * @param[out] c (optional) the coincidence indicator.
+     * @return the displacements (\e x, \e y) of the intersection along the
+     *   two segments (meters).
+     *
+     * The segments extend from the starting points of \e lineX and \e lineY
+     * to the distances given by GeodesicLine::Distance.  These lines are
+     * typically constructed by Geodesic::InverseLine with \e caps as for
+     * Closest.
+     **********************************************************************/
+    Point Segment(const GeodesicLine& lineX, const GeodesicLine& lineY,
+                  int& segmode, int* c = nullptr) const;
+
+    /**
+     * Find all the intersections between two sets of geodesic segments.
+     *
+     * @param[in] nx the number of segments in the first set.
+     * @param[in] latX1 array of latitudes of the starting points of the first
+     *   set (degrees).
+     * @param[in] lonX1 array of longitudes of the starting points of the
+     *   first set (degrees).
+     * @param[in] latX2 array of latitudes of the ending points of the first
+     *   set (degrees).
+     * @param[in] lonX2 array of longitudes of the ending points of the first
+     *   set (degrees).
+     * @param[in] ny the number of segments in the second set.
+     * @param[in] latY1 array of latitudes of the starting points of the
+     *   second set (degrees).
+     * @param[in] lonY1 array of longitudes of the starting points of the
+     *   second set (degrees).
+     * @param[in] latY2 array of latitudes of the ending points of the second
+     *   set (degrees).
+     * @param[in] lonY2 array of longitudes of the ending points of the
+     *   second set (degrees).
+     * @param[out] crossings the intersections found.
+     * @param[in] nthreads the number of threads to use; if this is 0 (the
+     *   default), use std::thread::hardware_concurrency().
+     * @exception std::bad_alloc if the memory for the bounding caps can't be
+     *   allocated.
+     *
+     * A Crossing is recorded for each pair of segments \e i and \e j which
+     * intersect (i.e., Segment returns \e segmode = 0).  \e crossings is
+     * sorted by \e i and then by \e j, so the result does not depend on \e
+     * nthreads.  If the two sets are the same, each intersection is reported
+     * twice, once as (\e i, \e j) and once as (\e j, \e i), and each segment
+     * is reported as coinciding with itself.
+     *
+     * The pruning is most effective when the segments are short compared to
+     * their spread in \e Z; a few very long segments in the second set
+     * reduce its efficiency for all the segments in the first set.
+     **********************************************************************/
+    void AllSegments(size_t nx,
+                     const real latX1[], const real lonX1[],
+                     const real latX2[], const real lonX2[],
+                     size_t ny,
+                     const real latY1[], const real lonY1[],
+                     const real latY2[], const real lonY2[],
+                     std::vector<Crossing>& crossings,
+                     unsigned nthreads = 0) const;
+
+    /** \name Inspector functions
+     **********************************************************************/
+    ///@{
+    /**
+     * @return \e a the equatorial radius of the ellipsoid (meters).  This is
+     *   the value inherited from the Geodesic object used in the constructor.
+     **********************************************************************/
+    Math::real EquatorialRadius() const { return _geod.EquatorialRadius(); }
+
+    /**
+     * @return \e f the flattening of the ellipsoid.  This is the value
+     *   inherited from the Geodesic object used in the constructor.
+     **********************************************************************/
+    Math::real Flattening() const { return _geod.Flattening(); }
+
+    /**
+     * @return the \e caps needed by GeodesicLine objects passed to Closest
+     *   and Segment.
+     **********************************************************************/
+    static unsigned LineCaps() { return caps_; }
+    ///@}
+
+  };
+
+} // namespace GeographicLib
+
+#endif  // GEOGRAPHICLIB_INTERSECT_HPP
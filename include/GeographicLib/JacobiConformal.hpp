@@ -0,0 +1,276 @@
+/**
+ * \file JacobiConformal.hpp
+ * \brief Header for GeographicLib::JacobiConformal class
+ *
+ * Copyright (c) Charles Karney (2014-2026) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_JACOBICONFORMAL_HPP)
+#define GEOGRAPHICLIB_JACOBICONFORMAL_HPP 1
+
+#include <vector>
+#include <GeographicLib/EllipticFunction.hpp>
+
+#if defined(_MSC_VER)
+// Squelch warnings about dll vs vector
+#  pragma warning (push)
+#  pragma warning (disable: 4251)
+#endif
+
+namespace GeographicLib {
+
+  /**
+   * \brief Jacobi's conformal projection of a triaxial ellipsoid
+   *
+   * This is a conformal projection of the ellipsoid to a plane in which
+   * the grid lines are straight; see Jacobi,
+   * <a href="https://books.google.com/books?id=ryEOAAAAQAAJ&pg=PA212">
+   * Vorlesungen &uuml;ber Dynamik, &sect;28</a>.  The constructor takes the
+   * semi-axes of the ellipsoid (which must be in order).  Member functions map
+   * the ellipsoidal coordinates &omega; and &beta; separately to \e x and \e
+   * y.  Jacobi's coordinates have been multiplied by
+   * (<i>a</i><sup>2</sup>&minus;<i>c</i><sup>2</sup>)<sup>1/2</sup> /
+   * (2<i>b</i>) so that the customary results are returned in the cases of
+   * a sphere or an ellipsoid of revolution.
+   *
+   * The ellipsoid is oriented so that the large principal ellipse, \f$Z=0\f$,
+   * is the equator, \f$\beta=0\f$, while the small principal ellipse,
+   * \f$Y=0\f$, is the prime meridian, \f$\omega=0\f$.  The four umbilic
+   * points, \f$\left|\omega\right| = \left|\beta\right| = \frac12\pi\f$, lie
+   * on middle principal ellipse in the plane \f$X=0\f$.
+   *
+   * Because \e x depends only on &omega; and \e y only on &beta;, each is
+   * the integral of a smooth periodic function of one angle.  The
+   * constructor expands these functions as Fourier series (with
+   * DST::cosinefit) so that the projection and its inverse can be
+   * evaluated with Clenshaw summation instead of elliptic integrals.
+   * The inverse maps are likewise expanded as Fourier series.  ForwardBatch
+   * and ReverseBatch sum the series for a batch of points together so that
+   * the compiler can vectorize the sums.  If the ellipsoid is close to an
+   * ellipsoid of revolution, the series for one of the coordinates needs
+   * many terms (because the umbilic points approach the poles of the
+   * ellipsoidal coordinates); in the limit that coordinate is computed
+   * with EllipticFunction::Pi and inverted with Newton's method.
+   *
+   * JacobiConformal objects are not altered once they have been
+   * constructed, so they can be shared by several threads.
+   *
+   * For more information on this projection, see \ref jacobi.
+   *
+   * Example of use:
+   * \include JacobiConformal.cpp
+   **********************************************************************/
+  class GEOGRAPHICLIB_EXPORT JacobiConformal {
+  private:
+    typedef Math::real real;
+    // The number of points processed together by ForwardBatch and
+    // ReverseBatch
+    static const int batchsize_ = 16;
+    // One of the coordinates, v = s * Pi(phi', alpha2, k2) where
+    // tan(phi') = (p/q) * tan(ang); the Fourier series are of dv/dang,
+    // sum(d[j] * cos(2*j*ang), j, 0, n), of v - d[0] * ang,
+    // sum(c[j] * sin(2*j*ang), j, 1, n), and of the inverse, ang - t where t
+    // = v/d[0], sum(e[j] * sin(2*j*t), j, 1, m).  If the series didn't
+    // converge, d, c, and e are empty; if just the last one didn't converge,
+    // e is empty.
+    class coord {
+    private:
+      real _s, _p, _q;
+      EllipticFunction _e;
+      std::vector<real> _d, _c, _ie;
+      real _bnd;                // sum(|c[j]|)
+      real direct(real sang, real cang) const;
+      real deriv(real sang, real cang) const;
+      void eval(real ang, real sang, real cang, real& v, real& vp) const;
+      real newton(real v) const;
+      // Set y[j] = sum(F[l] * sin(2*l*x[j]), l, 1, N) given s[j] = sin(x[j])
+      // and c[j] = cos(x[j]) for j in [0, n), matching DST::sineval.
+      static void sinebatch(int n, const real s[], const real c[],
+                            const real F[], int N, real y[]);
+    public:
+      coord(real s, real p, real q, const EllipticFunction& e)
+        : _s(s), _p(p), _q(q), _e(e), _bnd(0) {}
+      void fit();
+      bool Fitted() const { return !_d.empty(); }
+      int NTerms() const { return int(_d.size()); }
+      real Quadrant() const { return _s * _e.Pi(); }
+      real operator()(real ang, real sang, real cang) const;
+      real inv(real v) const;
+      // Evaluate and invert for n <= batchsize_ points in degrees
+      void EvalBatch(int n, const real ang[], real v[]) const;
+      void InvBatch(int n, const real v[], real ang[]) const;
+    };
+    real _a, _b, _c, _ab2, _bc2, _ac2;
+    coord _x, _y;
+    static void norm(real& x, real& y) {
+      using std::hypot;
+      real z = hypot(x, y); x /= z; y /= z;
+    }
+  public:
+    /**
+     * Constructor for a triaxial ellipsoid with semi-axes.
+     *
+     * @param[in] a the largest semi-axis.
+     * @param[in] b the middle semi-axis.
+     * @param[in] c the smallest semi-axis.
+     * @exception GeographicErr if the axes are not in order or if \e a =
+     *   \e c.
+     *
+     * The semi-axes must satisfy \e a &ge; \e b &ge; \e c > 0 and \e a >
+     * \e c.  This form of the constructor cannot be used to specify a
+     * sphere (use the next constructor).
+     **********************************************************************/
+    JacobiConformal(real a, real b, real c);
+
+    /**
+     * Alternate constructor for a triaxial ellipsoid.
+     *
+     * @param[in] a the largest semi-axis.
+     * @param[in] b the middle semi-axis.
+     * @param[in] c the smallest semi-axis.
+     * @param[in] ab the relative magnitude of \e a &minus; \e b.
+     * @param[in] bc the relative magnitude of \e b &minus; \e c.
+     * @exception GeographicErr if the axes are not in order or if \e ab +
+     *   \e bc is not positive.
+     *
+     * This form can be used to specify a sphere.  The semi-axes must
+     * satisfy \e a &ge; \e b &ge; c > 0.  The ratio \e ab : \e bc must equal
+     * (<i>a</i>&minus;<i>b</i>) : (<i>b</i>&minus;<i>c</i>) with \e ab
+     * &ge; 0, \e bc &ge; 0, and \e ab + \e bc > 0.
+     **********************************************************************/
+    JacobiConformal(real a, real b, real c, real ab, real bc);
+
+    /**
+     * @return the quadrant length in the \e x direction.
+     **********************************************************************/
+    Math::real x() const { return _x.Quadrant(); }
+
+    /**
+     * The \e x projection.
+     *
+     * @param[in] somg sin(&omega;).
+     * @param[in] comg cos(&omega;).
+     * @return \e x.
+     **********************************************************************/
+    Math::real x(real somg, real comg) const;
+
+    /**
+     * The \e x projection.
+     *
+     * @param[in] omg &omega; (in degrees).
+     * @return \e x (in degrees).
+     *
+     * &omega; must be in [&minus;180&deg;, 180&deg;].
+     **********************************************************************/
+    Math::real x(real omg) const;
+
+    /**
+     * @return the quadrant length in the \e y direction.
+     **********************************************************************/
+    Math::real y() const { return _y.Quadrant(); }
+
+    /**
+     * The \e y projection.
+     *
+     * @param[in] sbet sin(&beta;).
+     * @param[in] cbet cos(&beta;).
+     * @return \e y.
+     **********************************************************************/
+    Math::real y(real sbet, real cbet) const;
+
+    /**
+     * The \e y projection.
+     *
+     * @param[in] bet &beta; (in degrees).
+     * @return \e y (in degrees).
+     *
+     * &beta; must be in (&minus;180&deg;, 180&deg;].
+     **********************************************************************/
+    Math::real y(real bet) const;
+
+    /**
+     * Forward projection.
+     *
+     * @param[in] bet the ellipsoidal latitude &beta; (degrees).
+     * @param[in] omg the ellipsoidal longitude &omega; (degrees).
+     * @param[out] x the \e x coordinate (degrees).
+     * @param[out] y the \e y coordinate (degrees).
+     *
+     * This is equivalent to \e x = x(\e omg) and \e y = y(\e bet).
+     **********************************************************************/
+    void Forward(real bet, real omg, real& x, real& y) const {
+      x = this->x(omg); y = this->y(bet);
+    }
+
+    /**
+     * Reverse projection.
+     *
+     * @param[in] x the \e x coordinate (degrees).
+     * @param[in] y the \e y coordinate (degrees).
+     * @param[out] bet the ellipsoidal latitude &beta; (degrees).
+     * @param[out] omg the ellipsoidal longitude &omega; (degrees).
+     *
+     * This inverts the two projections separately; \e x should be in
+     * [&minus;2<i>X</i>, 2<i>X</i>] and \e y in (&minus;2<i>Y</i>,
+     * 2<i>Y</i>] where \e X = x() and \e Y = y() are the quadrant lengths
+     * expressed in degrees, in which case \e omg is in [&minus;180&deg;,
+     * 180&deg;] and \e bet is in (&minus;180&deg;, 180&deg;].
+     **********************************************************************/
+    void Reverse(real x, real y, real& bet, real& omg) const;
+
+    /**
+     * Forward projection of several points.
+     *
+     * @param[in] n the number of points.
+     * @param[in] bet array of ellipsoidal latitudes (degrees).
+     * @param[in] omg array of ellipsoidal longitudes (degrees).
+     * @param[out] x array of \e x coordinates (degrees).
+     * @param[out] y array of \e y coordinates (degrees).
+     *
+     * This gives the same results as calling Forward for each point.  \e x
+     * may coincide with \e omg and \e y with \e bet.
+     **********************************************************************/
+    void ForwardBatch(size_t n, const real bet[], const real omg[],
+                      real x[], real y[]) const;
+
+    /**
+     * Reverse projection of several points.
+     *
+     * @param[in] n the number of points.
+     * @param[in] x array of \e x coordinates (degrees).
+     * @param[in] y array of \e y coordinates (degrees).
+     * @param[out] bet array of ellipsoidal latitudes (degrees).
+     * @param[out] omg array of ellipsoidal longitudes (degrees).
+     *
+     * This gives the same results as calling Reverse for each point.  \e
+     * omg may coincide with \e x and \e bet with \e y.
+     **********************************************************************/
+    void ReverseBatch(size_t n, const real x[], const real y[],
+                      real bet[], real omg[]) const;
+
+    /** \name Inspector functions
+     **********************************************************************/
+    ///@{
+    /**
+     * @return the number of terms in the Fourier series for the derivative
+     *   of \e x; 0 means that \e x is computed with elliptic integrals.
+     **********************************************************************/
+    int XTerms() const { return _x.NTerms(); }
+
+    /**
+     * @return the number of terms in the Fourier series for the derivative
+     *   of \e y; 0 means that \e y is computed with elliptic integrals.
+     **********************************************************************/
+    int YTerms() const { return _y.NTerms(); }
+    ///@}
+  };
+
+} // namespace GeographicLib
+
+#if defined(_MSC_VER)
+#  pragma warning (pop)
+#endif
+
+#endif  // GEOGRAPHICLIB_JACOBICONFORMAL_HPP
@@ -140,6 +140,12 @@ namespace GeographicLib {
       return t != 0 ? Math::eatanhe(t / d, _es) / t : _e2 / d;
     }
     void Init(real sphi1, real cphi1, real sphi2, real cphi2, real k1);
+    // Forward and Reverse with the computation of k optional
+    void Forward(real lon0, real lat, real lon,
+                 real& x, real& y, real& gamma, real& k, bool scalep) const;
+    void Reverse(real lon0, real x, real y,
+                 real& lat, real& lon, real& gamma, real& k, bool scalep)
+      const;
   public:
 
     /**
@@ -280,6 +286,50 @@ namespace GeographicLib {
       Reverse(lon0, x, y, lat, lon, gamma, k);
     }
 
+    /**
+     * Forward projection of several points.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lon0 central meridian longitude (degrees).
+     * @param[in] lat array of latitudes (degrees).
+     * @param[in] lon array of longitudes (degrees).
+     * @param[out] x array of eastings (meters).
+     * @param[out] y array of northings (meters).
+     * @param[out] gamma (optional) array of meridian convergences
+     *   (degrees).
+     * @param[out] k (optional) array of scales.
+     *
+     * This gives the same results as calling Forward for each point.  The
+     * constants of the projection are shared by all the points; the
+     * computation of the scale, which needs an additional exponential, is
+     * skipped if \e k is nullptr.  \e gamma may also be nullptr if the
+     * convergence is not needed.  The output arrays may coincide with the
+     * input arrays.
+     **********************************************************************/
+    void ForwardBatch(size_t n, real lon0, const real lat[], const real lon[],
+                      real x[], real y[],
+                      real gamma[] = nullptr, real k[] = nullptr) const;
+
+    /**
+     * Reverse projection of several points.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lon0 central meridian longitude (degrees).
+     * @param[in] x array of eastings (meters).
+     * @param[in] y array of northings (meters).
+     * @param[out] lat array of latitudes (degrees).
+     * @param[out] lon array of longitudes (degrees).
+     * @param[out] gamma (optional) array of meridian convergences
+     *   (degrees).
+     * @param[out] k (optional) array of scales.
+     *
+     * This gives the same results as calling Reverse for each point; see
+     * ForwardBatch.
+     **********************************************************************/
+    void ReverseBatch(size_t n, real lon0, const real x[], const real y[],
+                      real lat[], real lon[],
+                      real gamma[] = nullptr, real k[] = nullptr) const;
+
     /** \name Inspector functions
      **********************************************************************/
     ///@{
@@ -38,6 +38,7 @@ namespace GeographicLib {
   class GEOGRAPHICLIB_EXPORT LocalCartesian {
   private:
     typedef Math::real real;
+    friend class CoordinatePipeline; // CoordinatePipeline uses the rotation
     static const size_t dim_ = 3;
     static const size_t dim2_ = dim_ * dim_;
     Geocentric _earth;
@@ -48,6 +49,15 @@ namespace GeographicLib {
     void IntReverse(real x, real y, real z, real& lat, real& lon, real& h,
                     real M[dim2_]) const;
     void MatrixMultiply(real M[dim2_]) const;
+    // The number of points transformed together by ForwardBatch and
+    // ReverseBatch
+    static const int batchsize_ = 64;
+    template<typename T>
+    void IntForwardBatch(size_t n, const real lat[], const real lon[],
+                         const real h[], T x[], T y[], T z[], real M[]) const;
+    template<typename T>
+    void IntReverseBatch(size_t n, const T x[], const T y[], const T z[],
+                         real lat[], real lon[], real h[], real M[]) const;
   public:
 
     /**
@@ -199,6 +209,105 @@ namespace GeographicLib {
         IntReverse(x, y, z, lat, lon, h, NULL);
     }
 
+    /**
+     * Convert several points from geodetic to local cartesian coordinates.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lat array of latitudes (degrees).
+     * @param[in] lon array of longitudes (degrees).
+     * @param[in] h array of heights above the ellipsoid (meters).
+     * @param[out] x array of local cartesian coordinates (meters).
+     * @param[out] y array of local cartesian coordinates (meters).
+     * @param[out] z array of local cartesian coordinates (meters).
+     * @param[out] M (optional) array of size 9\e n to receive the rotation
+     *   matrices in row-major order; the matrix for point \e i starts at \e
+     *   M + 9\e i.
+     *
+     * This gives the same results as calling Forward for each point.  The
+     * points are converted to geocentric coordinates with
+     * Geocentric::ForwardBatch and the rotation to the local frame is
+     * applied to each batch of points together.  If \e M is omitted (or
+     * nullptr), the rotation matrices are not computed.  The output arrays
+     * may coincide with the input arrays.
+     **********************************************************************/
+    void ForwardBatch(size_t n, const real lat[], const real lon[],
+                      const real h[], real x[], real y[], real z[],
+                      real M[] = nullptr) const;
+
+    /**
+     * Convert several points from local cartesian to geodetic coordinates.
+     *
+     * @param[in] n the number of points.
+     * @param[in] x array of local cartesian coordinates (meters).
+     * @param[in] y array of local cartesian coordinates (meters).
+     * @param[in] z array of local cartesian coordinates (meters).
+     * @param[out] lat array of latitudes (degrees).
+     * @param[out] lon array of longitudes (degrees).
+     * @param[out] h array of heights above the ellipsoid (meters).
+     * @param[out] M (optional) array of size 9\e n to receive the rotation
+     *   matrices in row-major order; the matrix for point \e i starts at \e
+     *   M + 9\e i.
+     *
+     * This gives the same results as calling Reverse for each point; see
+     * ForwardBatch.
+     **********************************************************************/
+    void ReverseBatch(size_t n, const real x[], const real y[],
+                      const real z[], real lat[], real lon[], real h[],
+                      real M[] = nullptr) const;
+
+#if GEOGRAPHICLIB_PRECISION != 1
+    /**
+     * Convert several points from geodetic to local cartesian coordinates
+     * given as floats.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lat array of latitudes (degrees).
+     * @param[in] lon array of longitudes (degrees).
+     * @param[in] h array of heights above the ellipsoid (meters).
+     * @param[out] x array of local cartesian coordinates (meters).
+     * @param[out] y array of local cartesian coordinates (meters).
+     * @param[out] z array of local cartesian coordinates (meters).
+     * @param[out] M (optional) array of size 9\e n to receive the rotation
+     *   matrices.
+     *
+     * This is the same as the other version of ForwardBatch except that the
+     * local cartesian coordinates are rounded to floats.  This is intended
+     * for sensor data where the points lie close to the origin: a float
+     * carries about 7 significant digits, so the resulting precision is
+     * about 0.1 mm at 1 km from the origin.  The computations are carried
+     * out with reals (because the geocentric coordinates need their full
+     * precision); with floats the data for a given number of points occupies
+     * half the memory.  This function is not available if the library is
+     * compiled with GEOGRAPHICLIB_PRECISION = 1 (since then real is float).
+     **********************************************************************/
+    void ForwardBatch(size_t n, const real lat[], const real lon[],
+                      const real h[], float x[], float y[], float z[],
+                      real M[] = nullptr) const;
+
+    /**
+     * Convert several points from local cartesian coordinates given as floats
+     * to geodetic coordinates.
+     *
+     * @param[in] n the number of points.
+     * @param[in] x array of local cartesian coordinates (meters).
+     * @param[in] y array of local cartesian coordinates (meters).
+     * @param[in] z array of local cartesian coordinates (meters).
+     * @param[out] lat array of latitudes (degrees).
+     * @param[out] lon array of longitudes (degrees).
+     * @param[out] h array of heights above the ellipsoid (meters).
+     * @param[out] M (optional) array of size 9\e n to receive the rotation
+     *   matrices.
+     *
+     * This is the same as the other version of ReverseBatch except that the
+     * local cartesian coordinates are given as floats; see the float
+     * version of ForwardBatch.  The results are the same as calling Reverse
+     * with the floats converted to reals.
+     **********************************************************************/
+    void ReverseBatch(size_t n, const float x[], const float y[],
+                      const float z[], real lat[], real lon[], real h[],
+                      real M[] = nullptr) const;
+#endif
+
     /** \name Inspector functions
      **********************************************************************/
     ///@{
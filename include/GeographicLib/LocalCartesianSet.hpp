@@ -0,0 +1,321 @@
+/**
+ * \file LocalCartesianSet.hpp
+ * \brief Header for GeographicLib::LocalCartesianSet class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_LOCALCARTESIANSET_HPP)
+#define GEOGRAPHICLIB_LOCALCARTESIANSET_HPP 1
+
+#include <vector>
+#include <GeographicLib/Geocentric.hpp>
+#include <GeographicLib/Constants.hpp>
+
+#if defined(_MSC_VER)
+// Squelch warnings about dll vs vector
+#  pragma warning (push)
+#  pragma warning (disable: 4251)
+#endif
+
+namespace GeographicLib {
+
+  /**
+   * \brief Local cartesian coordinates for many origins
+   *
+   * This holds many local cartesian coordinate systems, e.g., one for each
+   * vehicle in a fleet, and converts points in any of them.  Each origin is
+   * identified by the index returned by Add, and the conversions are the
+   * same as those performed by a LocalCartesian object with that origin.
+   * The geocentric coordinates and the rotation matrix of each origin are
+   * computed once (by Add or Reset) and are stored in separate arrays (a
+   * "structure of arrays").
+   *
+   * ForwardBatch and ReverseBatch convert arrays of points, each tagged with
+   * the index of its origin.  For each batch of points, the parameters of
+   * the origins are gathered from the arrays and the rotations are applied
+   * to the points in the batch together (so that they can be vectorized)
+   * with the geocentric conversions done by Geocentric::ForwardBatch and
+   * Geocentric::ReverseBatch.  The points for different origins may be
+   * given in any order.
+   *
+   * The conversions are const and so can be carried out by several threads
+   * at once; Add and Reset must not be called at the same time as other
+   * operations.
+   *
+   * Example of use:
+   * \code
+   * LocalCartesianSet fleet;
+   * int a = fleet.Add(40.5, -74.2, 10), b = fleet.Add(51.5, -0.1);
+   * std::vector<int> id = {a, b, a};
+   * std::vector<double> lat = {40.6, 51.4, 40.4}, lon = {-74.1, 0.1, -74.3},
+   *   h = {20, 5, 0}, x(3), y(3), z(3);
+   * fleet.ForwardBatch(3, id.data(), lat.data(), lon.data(), h.data(),
+   *                    x.data(), y.data(), z.data());
+   * \endcode
+   **********************************************************************/
+
+  class GEOGRAPHICLIB_EXPORT LocalCartesianSet {
+  private:
+    typedef Math::real real;
+    static const size_t dim_ = 3;
+    static const size_t dim2_ = dim_ * dim_;
+    // The number of points transformed together by ForwardBatch and
+    // ReverseBatch
+    static const int batchsize_ = 64;
+    Geocentric _earth;
+    std::vector<real> _lat0, _lon0, _h0, _x0, _y0, _z0;
+    // The elements of the rotation matrices; _r[k][i] is element k of the
+    // matrix for origin i.
+    std::vector<real> _r[dim2_];
+    void Check(int id) const;
+    void MatrixMultiply(int id, real M[dim2_]) const;
+    template<typename T>
+    void IntForwardBatch(size_t n, const int id[], const real lat[],
+                         const real lon[], const real h[],
+                         T x[], T y[], T z[], real M[]) const;
+    template<typename T>
+    void IntReverseBatch(size_t n, const int id[],
+                         const T x[], const T y[], const T z[],
+                         real lat[], real lon[], real h[], real M[]) const;
+  public:
+
+    /**
+     * Constructor.
+     *
+     * @param[in] earth Geocentric object for the transformation; default
+     *   Geocentric::WGS84().
+     *
+     * The set of origins is empty.
+     **********************************************************************/
+    explicit LocalCartesianSet(const Geocentric& earth = Geocentric::WGS84())
+      : _earth(earth) {}
+
+    /**
+     * Add an origin.
+     *
+     * @param[in] lat0 latitude at origin (degrees).
+     * @param[in] lon0 longitude at origin (degrees).
+     * @param[in] h0 height above ellipsoid at origin (meters); default 0.
+     * @return the index of the origin; the origins are numbered 0, 1, 2,
+     *   ..., in the order in which they are added.
+     *
+     * \e lat0 should be in the range [&minus;90&deg;, 90&deg;].
+     **********************************************************************/
+    int Add(real lat0, real lon0, real h0 = 0);
+
+    /**
+     * Reset an origin.
+     *
+     * @param[in] id the index of the origin.
+     * @param[in] lat0 latitude at origin (degrees).
+     * @param[in] lon0 longitude at origin (degrees).
+     * @param[in] h0 height above ellipsoid at origin (meters); default 0.
+     * @exception GeographicErr if \e id is not the index of an origin.
+     *
+     * This is cheaper than making a new LocalCartesian object; only the
+     * data for origin \e id is recomputed.
+     **********************************************************************/
+    void Reset(int id, real lat0, real lon0, real h0 = 0);
+
+    /**
+     * Remove all the origins.
+     **********************************************************************/
+    void Clear();
+
+    /**
+     * Convert from geodetic to local cartesian coordinates.
+     *
+     * @param[in] id the index of the origin.
+     * @param[in] lat latitude of point (degrees).
+     * @param[in] lon longitude of point (degrees).
+     * @param[in] h height of point above the ellipsoid (meters).
+     * @param[out] x local cartesian coordinate (meters).
+     * @param[out] y local cartesian coordinate (meters).
+     * @param[out] z local cartesian coordinate (meters).
+     * @exception GeographicErr if \e id is not the index of an origin.
+     *
+     * This gives the same results as LocalCartesian::Forward.
+     **********************************************************************/
+    void Forward(int id, real lat, real lon, real h,
+                 real& x, real& y, real& z) const
+    { ForwardBatch(1, &id, &lat, &lon, &h, &x, &y, &z); }
+
+    /**
+     * Convert from local cartesian to geodetic coordinates.
+     *
+     * @param[in] id the index of the origin.
+     * @param[in] x local cartesian coordinate (meters).
+     * @param[in] y local cartesian coordinate (meters).
+     * @param[in] z local cartesian coordinate (meters).
+     * @param[out] lat latitude of point (degrees).
+     * @param[out] lon longitude of point (degrees).
+     * @param[out] h height of point above the ellipsoid (meters).
+     * @exception GeographicErr if \e id is not the index of an origin.
+     *
+     * This gives the same results as LocalCartesian::Reverse.
+     **********************************************************************/
+    void Reverse(int id, real x, real y, real z,
+                 real& lat, real& lon, real& h) const
+    { ReverseBatch(1, &id, &x, &y, &z, &lat, &lon, &h); }
+
+    /**
+     * Convert several points from geodetic to local cartesian coordinates.
+     *
+     * @param[in] n the number of points.
+     * @param[in] id array of the indices of the origins.
+     * @param[in] lat array of latitudes (degrees).
+     * @param[in] lon array of longitudes (degrees).
+     * @param[in] h array of heights above the ellipsoid (meters).
+     * @param[out] x array of local cartesian coordinates (meters).
+     * @param[out] y array of local cartesian coordinates (meters).
+     * @param[out] z array of local cartesian coordinates (meters).
+     * @param[out] M (optional) array of size 9\e n to receive the rotation
+     *   matrices in row-major order; the matrix for point \e i starts at \e
+     *   M + 9\e i.
+     * @exception GeographicErr if any element of \e id is not the index of
+     *   an origin; in this case, no output is produced.
+     *
+     * Point \e i is converted to the local cartesian coordinates for origin
+     * \e id[\e i].  This gives the same results as calling
+     * LocalCartesian::Forward for each point; see
+     * LocalCartesian::ForwardBatch.
+     **********************************************************************/
+    void ForwardBatch(size_t n, const int id[], const real lat[],
+                      const real lon[], const real h[],
+                      real x[], real y[], real z[],
+                      real M[] = nullptr) const;
+
+    /**
+     * Convert several points from local cartesian to geodetic coordinates.
+     *
+     * @param[in] n the number of points.
+     * @param[in] id array of the indices of the origins.
+     * @param[in] x array of local cartesian coordinates (meters).
+     * @param[in] y array of local cartesian coordinates (meters).
+     * @param[in] z array of local cartesian coordinates (meters).
+     * @param[out] lat array of latitudes (degrees).
+     * @param[out] lon array of longitudes (degrees).
+     * @param[out] h array of heights above the ellipsoid (meters).
+     * @param[out] M (optional) array of size 9\e n to receive the rotation
+     *   matrices in row-major order.
+     * @exception GeographicErr if any element of \e id is not the index of
+     *   an origin; in this case, no output is produced.
+     *
+     * Point \e i is given in the local cartesian coordinates for origin \e
+     * id[\e i].  This gives the same results as calling
+     * LocalCartesian::Reverse for each point.
+     **********************************************************************/
+    void ReverseBatch(size_t n, const int id[], const real x[],
+                      const real y[], const real z[],
+                      real lat[], real lon[], real h[],
+                      real M[] = nullptr) const;
+
+#if GEOGRAPHICLIB_PRECISION != 1
+    /**
+     * Convert several points from geodetic to local cartesian coordinates
+     * given as floats.
+     *
+     * @param[in] n the number of points.
+     * @param[in] id array of the indices of the origins.
+     * @param[in] lat array of latitudes (degrees).
+     * @param[in] lon array of longitudes (degrees).
+     * @param[in] h array of heights above the ellipsoid (meters).
+     * @param[out] x array of local cartesian coordinates (meters).
+     * @param[out] y array of local cartesian coordinates (meters).
+     * @param[out] z array of local cartesian coordinates (meters).
+     * @param[out] M (optional) array of size 9\e n to receive the rotation
+     *   matrices.
+     * @exception GeographicErr if any element of \e id is not the index of
+     *   an origin.
+     *
+     * This is the same as the other version of ForwardBatch except that the
+     * local cartesian coordinates are rounded to floats; see the float
+     * version of LocalCartesian::ForwardBatch.  This function is not
+     * available if the library is compiled with GEOGRAPHICLIB_PRECISION = 1.
+     **********************************************************************/
+    void ForwardBatch(size_t n, const int id[], const real lat[],
+                      const real lon[], const real h[],
+                      float x[], float y[], float z[],
+                      real M[] = nullptr) const;
+
+    /**
+     * Convert several points from local cartesian coordinates given as floats
+     * to geodetic coordinates.
+     *
+     * @param[in] n the number of points.
+     * @param[in] id array of the indices of the origins.
+     * @param[in] x array of local cartesian coordinates (meters).
+     * @param[in] y array of local cartesian coordinates (meters).
+     * @param[in] z array of local cartesian coordinates (meters).
+     * @param[out] lat array of latitudes (degrees).
+     * @param[out] lon array of longitudes (degrees).
+     * @param[out] h array of heights above the ellipsoid (meters).
+     * @param[out] M (optional) array of size 9\e n to receive the rotation
+     *   matrices.
+     * @exception GeographicErr if any element of \e id is not the index of
+     *   an origin.
+     *
+     * This is the same as the other version of ReverseBatch except that the
+     * local cartesian coordinates are given as floats.
+     **********************************************************************/
+    void ReverseBatch(size_t n, const int id[], const float x[],
+                      const float y[], const float z[],
+                      real lat[], real lon[], real h[],
+                      real M[] = nullptr) const;
+#endif
+
+    /** \name Inspector functions
+     **********************************************************************/
+    ///@{
+    /**
+     * @return the number of origins.
+     **********************************************************************/
+    int NumOrigins() const { return int(_lat0.size()); }
+
+    /**
+     * @param[in] id the index of the origin.
+     * @return latitude of the origin (degrees).
+     * @exception GeographicErr if \e id is not the index of an origin.
+     **********************************************************************/
+    Math::real LatitudeOrigin(int id) const { Check(id); return _lat0[id]; }
+
+    /**
+     * @param[in] id the index of the origin.
+     * @return longitude of the origin (degrees).
+     * @exception GeographicErr if \e id is not the index of an origin.
+     **********************************************************************/
+    Math::real LongitudeOrigin(int id) const { Check(id); return _lon0[id]; }
+
+    /**
+     * @param[in] id the index of the origin.
+     * @return height of the origin (meters).
+     * @exception GeographicErr if \e id is not the index of an origin.
+     **********************************************************************/
+    Math::real HeightOrigin(int id) const { Check(id); return _h0[id]; }
+
+    /**
+     * @return \e a the equatorial radius of the ellipsoid (meters).  This is
+     *   the value of \e a inherited from the Geocentric object used in the
+     *   constructor.
+     **********************************************************************/
+    Math::real EquatorialRadius() const { return _earth.EquatorialRadius(); }
+
+    /**
+     * @return \e f the flattening of the ellipsoid.  This is the value
+     *   inherited from the Geocentric object used in the constructor.
+     **********************************************************************/
+    Math::real Flattening() const { return _earth.Flattening(); }
+    ///@}
+
+  };
+
+} // namespace GeographicLib
+
+#if defined(_MSC_VER)
+#  pragma warning (pop)
+#endif
+
+#endif  // GEOGRAPHICLIB_LOCALCARTESIANSET_HPP
@@ -115,6 +115,9 @@ namespace GeographicLib {
 #endif
     static void CheckCoords(bool utmp, bool& northp, real& x, real& y);
     static int UTMRow(int iband, int icol, int irow);
+    // A latitude sufficiently accurate to determine the latitude band for
+    // Forward without lat.
+    static real ForwardLatitude(int zone, bool northp, real x, real y);
 
     friend class UTMUPS;        // UTMUPS::StandardZone calls LatitudeBand
     // Return latitude band number [-10, 10) for the given latitude (degrees).
@@ -183,6 +186,15 @@ namespace GeographicLib {
 
   public:
 
+    /**
+     * The maximum length of an MGRS string (not counting the terminating
+     * null), namely 2 (zone) + 3 (band and block letters) + 2 &times; 11
+     * (easting and northing digits at \e prec = 11).  A char array of size
+     * MAXLENGTH + 1 is large enough to hold any MGRS string produced by
+     * Forward.
+     **********************************************************************/
+    enum { MAXLENGTH = 2 + 3 + 2 * 11 };
+
     /**
      * Convert UTM or UPS coordinate to an MGRS coordinate.
      *
@@ -291,6 +303,75 @@ namespace GeographicLib {
     static void Forward(int zone, bool northp, real x, real y, real lat,
                         int prec, std::string& mgrs);
 
+    /**
+     * Convert UTM or UPS coordinate to an MGRS coordinate in a char array.
+     *
+     * @param[in] zone UTM zone (zero means UPS).
+     * @param[in] northp hemisphere (true means north, false means south).
+     * @param[in] x easting of point (meters).
+     * @param[in] y northing of point (meters).
+     * @param[in] prec precision relative to 100 km.
+     * @param[out] mgrs a char array of size at least MAXLENGTH + 1 to receive
+     *   the null-terminated MGRS string.
+     * @exception GeographicErr if \e zone, \e x, or \e y is outside its
+     *   allowed range.
+     * @return the length of the MGRS string.
+     *
+     * This gives the same result as the version of Forward which returns a
+     * std::string, but no memory is allocated (unless an exception is
+     * thrown).  If an exception is thrown, then \e mgrs is unchanged.
+     **********************************************************************/
+    static int Forward(int zone, bool northp, real x, real y,
+                       int prec, char mgrs[]);
+
+    /**
+     * Convert UTM or UPS coordinate to an MGRS coordinate in a char array
+     * when the latitude is known.
+     *
+     * @param[in] zone UTM zone (zero means UPS).
+     * @param[in] northp hemisphere (true means north, false means south).
+     * @param[in] x easting of point (meters).
+     * @param[in] y northing of point (meters).
+     * @param[in] lat latitude (degrees).
+     * @param[in] prec precision relative to 100 km.
+     * @param[out] mgrs a char array of size at least MAXLENGTH + 1 to receive
+     *   the null-terminated MGRS string.
+     * @exception GeographicErr if \e zone, \e x, or \e y is outside its
+     *   allowed range.
+     * @exception GeographicErr if \e lat is inconsistent with the given UTM
+     *   coordinates.
+     * @return the length of the MGRS string.
+     **********************************************************************/
+    static int Forward(int zone, bool northp, real x, real y, real lat,
+                       int prec, char mgrs[]);
+
+    /**
+     * Convert several UTM or UPS coordinates to MGRS coordinates.
+     *
+     * @param[in] n the number of points.
+     * @param[in] zone array of UTM zones (zero means UPS).
+     * @param[in] northp array of hemispheres (true means north, false means
+     *   south).
+     * @param[in] x array of eastings (meters).
+     * @param[in] y array of northings (meters).
+     * @param[in] prec precision relative to 100 km.
+     * @param[out] mgrs a char array of size at least \e n (MAXLENGTH + 1) to
+     *   receive the MGRS strings; the null-terminated string for point \e i
+     *   starts at \e mgrs + \e i (MAXLENGTH + 1).
+     * @param[in] lat (optional) array of latitudes (degrees).
+     * @exception GeographicErr if any \e zone, \e x, or \e y is outside its
+     *   allowed range or if any \e lat is inconsistent with the given UTM
+     *   coordinates.
+     *
+     * This is equivalent to calling the char array versions of Forward for
+     * each point (with or without the latitude according to whether \e lat
+     * is given).  If an exception is thrown, the strings for the points
+     * before the offending one have been written.
+     **********************************************************************/
+    static void ForwardBatch(size_t n, const int zone[], const bool northp[],
+                             const real x[], const real y[], int prec,
+                             char mgrs[], const real lat[] = nullptr);
+
     /**
      * Convert a MGRS coordinate to UTM or UPS coordinates.
      *
@@ -337,9 +418,60 @@ namespace GeographicLib {
      * If an exception is thrown, then the arguments are unchanged.
      **********************************************************************/
     static void Reverse(const std::string& mgrs,
+                        int& zone, bool& northp, real& x, real& y,
+                        int& prec, bool centerp = true) {
+      Reverse(mgrs.data(), mgrs.size(), zone, northp, x, y, prec, centerp);
+    }
+
+    /**
+     * Convert a MGRS coordinate given as a character array to UTM or UPS
+     * coordinates.
+     *
+     * @param[in] mgrs pointer to the characters of the MGRS string.
+     * @param[in] len the number of characters (the string need not be null
+     *   terminated).
+     * @param[out] zone UTM zone (zero means UPS).
+     * @param[out] northp hemisphere (true means north, false means south).
+     * @param[out] x easting of point (meters).
+     * @param[out] y northing of point (meters).
+     * @param[out] prec precision relative to 100 km.
+     * @param[in] centerp if true (default), return center of the MGRS square,
+     *   else return SW (lower left) corner.
+     * @exception GeographicErr if \e mgrs is illegal.
+     *
+     * This is the same as the version of Reverse taking a std::string, but
+     * no memory is allocated (unless an exception is thrown).
+     **********************************************************************/
+    static void Reverse(const char* mgrs, size_t len,
                         int& zone, bool& northp, real& x, real& y,
                         int& prec, bool centerp = true);
 
+    /**
+     * Convert several MGRS coordinates to UTM or UPS coordinates.
+     *
+     * @param[in] n the number of points.
+     * @param[in] mgrs a char array holding the MGRS strings in the layout
+     *   produced by ForwardBatch; string \e i starts at \e mgrs + \e i
+     *   (MAXLENGTH + 1) and is terminated by a null or by the end of its
+     *   MAXLENGTH + 1 characters.
+     * @param[out] zone array of UTM zones (zero means UPS).
+     * @param[out] northp array of hemispheres (true means north, false means
+     *   south).
+     * @param[out] x array of eastings (meters).
+     * @param[out] y array of northings (meters).
+     * @param[out] prec (optional) array of precisions relative to 100 km.
+     * @param[in] centerp if true (default), return centers of the MGRS
+     *   squares, else return SW (lower left) corners.
+     * @exception GeographicErr if any of the MGRS strings is illegal.
+     *
+     * This is equivalent to calling Reverse for each point.  If an exception
+     * is thrown, the results for the points before the offending one have
+     * been written.
+     **********************************************************************/
+    static void ReverseBatch(size_t n, const char mgrs[],
+                             int zone[], bool northp[], real x[], real y[],
+                             int prec[] = nullptr, bool centerp = true);
+
     /**
      * Split a MGRS grid reference into its components.
      *
@@ -42,45 +42,23 @@ namespace GeographicLib {
     bool _interpolate, _constterm;
     CircularEngine _circ0, _circ1, _circ2;
 
-    MagneticCircle(real a, real f, real lat, real h, real t,
-                   real cphi, real sphi, real t1, real dt0,
-                   bool interpolate,
-                   const CircularEngine& circ0, const CircularEngine& circ1)
-      : _a(a)
-      , _f(f)
-      , _lat(Math::LatFix(lat))
-      , _h(h)
-      , _t(t)
-      , _cphi(cphi)
-      , _sphi(sphi)
-      , _t1(t1)
-      , _dt0(dt0)
-      , _interpolate(interpolate)
-      , _constterm(false)
-      , _circ0(circ0)
-      , _circ1(circ1)
-    {}
-
-    MagneticCircle(real a, real f, real lat, real h, real t,
-                   real cphi, real sphi, real t1, real dt0,
-                   bool interpolate,
-                   const CircularEngine& circ0, const CircularEngine& circ1,
-                   const CircularEngine& circ2)
-      : _a(a)
-      , _f(f)
-      , _lat(lat)
-      , _h(h)
-      , _t(t)
-      , _cphi(cphi)
-      , _sphi(sphi)
-      , _t1(t1)
-      , _dt0(dt0)
-      , _interpolate(interpolate)
-      , _constterm(true)
-      , _circ0(circ0)
-      , _circ1(circ1)
-      , _circ2(circ2)
-    {}
+    // Set the parameters other than the CircularEngine objects; these are
+    // set in place by MagneticModel::Circle.
+    void Reset(real a, real f, real lat, real h, real t,
+               real cphi, real sphi, real t1, real dt0,
+               bool interpolate, bool constterm) {
+      _a = a;
+      _f = f;
+      _lat = Math::LatFix(lat);
+      _h = h;
+      _t = t;
+      _cphi = cphi;
+      _sphi = sphi;
+      _t1 = t1;
+      _dt0 = dt0;
+      _interpolate = interpolate;
+      _constterm = constterm;
+    }
 
     void Field(real lon, bool diffp,
                real& Bx, real& By, real& Bz,
@@ -90,7 +68,7 @@ namespace GeographicLib {
                          real& BX, real& BY, real& BZ,
                          real& BXt, real& BYt, real& BZt) const;
 
-    friend class MagneticModel; // MagneticModel calls the private constructor
+    friend class MagneticModel; // MagneticModel calls Reset
 
   public:
 
@@ -13,6 +13,7 @@
 #include <GeographicLib/Constants.hpp>
 #include <GeographicLib/Geocentric.hpp>
 #include <GeographicLib/SphericalHarmonic.hpp>
+#include <GeographicLib/CircleCache.hpp>
 
 #if defined(_MSC_VER)
 // Squelch warnings about dll vs vector
@@ -23,6 +24,7 @@
 namespace GeographicLib {
 
   class MagneticCircle;
+  class MagneticSnapshot;
 
   /**
    * \brief Model of the earth's magnetic field
@@ -81,16 +83,50 @@ namespace GeographicLib {
     int _nNmodels, _nNconstants, _nmx, _mmx;
     SphericalHarmonic::normalization _norm;
     Geocentric _earth;
-    std::vector< std::vector<real> > _gG;
-    std::vector< std::vector<real> > _hH;
+    // The coefficients read from the file (or the mapped file); these are
+    // shared by copies of the object.
+    struct coeffstore {
+      std::vector< std::vector<real> > gG;
+      std::vector< std::vector<real> > hH;
+      SphericalEngine::mappedfile cofmap;
+      // For a compressed model, the quantum, the degree and order giving the
+      // layout of the epochs, the degree and order of each epoch, and the
+      // quantized differences between successive epochs.
+      real quantum;
+      int nN, mM;
+      std::vector<int> nmx, mmx;
+      std::vector<unsigned char> deltas;
+      coeffstore() : quantum(0), nN(-1), mM(-1) {}
+    };
+    std::shared_ptr<coeffstore> _coeffs;
     std::vector<SphericalHarmonic> _harm;
+    // A pair of successive epochs decoded from a compressed model.  (Moving
+    // the vectors leaves the pointers held by harm valid.)
+    struct epochpair {
+      std::vector<real> C[2], S[2];
+      SphericalHarmonic harm[2];
+    };
+    mutable CircleCache<epochpair> _epochs;
+    // The cache of circles of latitude
+    mutable CircleCache<MagneticCircle> _circles;
+    mutable real _circledlat, _circledh, _circledt;
+    // The tolerance for truncating the sums and the bounds on the terms
+    mutable real _trunctol;
+    mutable std::vector< std::vector<real> > _truncbound;
     void Field(real t, real lat, real lon, real h, bool diffp,
                real& Bx, real& By, real& Bz,
                real& Bxt, real& Byt, real& Bzt) const;
-    void ReadMetadata(const std::string& name);
-    // copy constructor not allowed
-    MagneticModel(const MagneticModel&) = delete;
-    // nor copy assignment
+    void ReadMetadata(const std::string& name,
+                      const char* edata, size_t esize);
+    std::shared_ptr<const MagneticCircle> CachedCircle(real t, real lat,
+                                                       real h) const;
+    // The estimated size of a MagneticCircle in the cache
+    unsigned long long CircleBytes() const;
+    epochpair DecodeEpochs(int n) const;
+    std::shared_ptr<const epochpair>
+    Epochs(int n, const SphericalHarmonic*& h0,
+           const SphericalHarmonic*& h1) const;
+    // copy assignment not allowed
     MagneticModel& operator=(const MagneticModel&) = delete;
   public:
 
@@ -108,8 +144,12 @@ namespace GeographicLib {
      *   model this value.
      * @param[in] Mmax (optional) if non-negative, truncate the order of the
      *   model this value.
+     * @param[in] mapfile (optional) if true, memory map the coefficient file
+     *   instead of reading it.
      * @exception GeographicErr if the data file cannot be found, is
      *   unreadable, or is corrupt, or if \e Mmax > \e Nmax.
+     * @exception GeographicErr if \e mapfile is true but the coefficient
+     *   file cannot be mapped.
      * @exception std::bad_alloc if the memory necessary for storing the model
      *   can't be allocated.
      *
@@ -131,11 +171,58 @@ namespace GeographicLib {
      * If \e Nmax &ge; 0 and \e Mmax < 0, then \e Mmax is set to \e Nmax.
      * After the model is loaded, the maximum degree and order of the model can
      * be found by the Degree() and Order() methods.
+     *
+     * If \e mapfile is true, the coefficient file is memory mapped and the
+     * sums refer directly to the mapped data, as with the corresponding
+     * argument to the GravityModel constructor.
+     *
+     * If \e path is empty and the model was compiled into the library (with
+     * the cmake option GEOGRAPHICLIB_EMBED_MAGNETIC), the embedded copy is
+     * used; no file is read and the sums refer directly to the coefficients
+     * in the library (as with \e mapfile).  Embedded coefficients require
+     * little-endian IEEE doubles.
      **********************************************************************/
     explicit MagneticModel(const std::string& name,
                            const std::string& path = "",
                            const Geocentric& earth = Geocentric::WGS84(),
-                           int Nmax = -1, int Mmax = -1);
+                           int Nmax = -1, int Mmax = -1,
+                           bool mapfile = false);
+
+    /**
+     * Copy a magnetic model.
+     *
+     * @param[in] model the magnetic model.
+     *
+     * The copy shares the coefficients of \e model (which are reference
+     * counted), so copying is cheap, and \e model may be destroyed while
+     * the copy is in use.  The truncation tolerance is inherited.  The copy
+     * has its own cache of circles, initially empty and with the same
+     * capacity as that of \e model.
+     **********************************************************************/
+    MagneticModel(const MagneticModel& model);
+
+    /**
+     * A shared instance of MagneticModel.
+     *
+     * @param[in] name the name of the model.
+     * @param[in] path (optional) directory for data file.
+     * @exception GeographicErr if the data file cannot be found, is
+     *   unreadable, or is corrupt.
+     * @exception std::bad_alloc if the memory necessary for storing the model
+     *   can't be allocated.
+     * @return a MagneticModel object for the complete model using
+     *   Geocentric::WGS84().
+     *
+     * The first call with a given \e name and directory constructs the
+     * object and later calls (on any thread) return the same object; see
+     * SharedInstances for the details.  An empty \e path selects the
+     * embedded model, if any, and otherwise DefaultMagneticPath().  The
+     * object lives until the program exits.  Its const member functions may
+     * be called concurrently (but not CacheCircles, CircleCacheClear, or
+     * SetTruncationTolerance).
+     **********************************************************************/
+    static const MagneticModel& Get(const std::string& name,
+                                    const std::string& path = "");
     ///@}
 
     /** \name Compute the magnetic field
@@ -189,6 +276,41 @@ namespace GeographicLib {
       Field(t, lat, lon, h, true, Bx, By, Bz, Bxt, Byt, Bzt);
     }
 
+    /**
+     * Evaluate the components of the geomagnetic field (and optionally their
+     * time derivatives) at several points.
+     *
+     * @param[in] n the number of points.
+     * @param[in] t array of times (fractional years).
+     * @param[in] lat array of latitudes (degrees).
+     * @param[in] lon array of longitudes (degrees).
+     * @param[in] h array of heights above the ellipsoid (meters).
+     * @param[out] Bx array of easterly components of the magnetic field
+     *   (nanotesla).
+     * @param[out] By array of northerly components of the magnetic field
+     *   (nanotesla).
+     * @param[out] Bz array of vertical (up) components of the magnetic field
+     *   (nanotesla).
+     * @param[out] Bxt (optional) array of rates of change of \e Bx (nT/yr).
+     * @param[out] Byt (optional) array of rates of change of \e By (nT/yr).
+     * @param[out] Bzt (optional) array of rates of change of \e Bz (nT/yr).
+     * @exception std::bad_alloc if the memory for the temporary arrays can't
+     *   be allocated.
+     *
+     * This gives the same results as calling operator()() for each point, but
+     * is faster for a trajectory with many points.  The points are grouped by
+     * the interval between the epochs of the model in which \e t lies and,
+     * for each group, the spherical harmonic sums for the two bracketing
+     * epochs are evaluated with SphericalHarmonic::ValueBatch; the field is
+     * then interpolated to the time of each point.  The rates of change are
+     * only returned for arrays which are not nullptr.
+     **********************************************************************/
+    void FieldBatch(size_t n, const real t[], const real lat[],
+                    const real lon[], const real h[],
+                    real Bx[], real By[], real Bz[],
+                    real Bxt[] = nullptr, real Byt[] = nullptr,
+                    real Bzt[] = nullptr) const;
+
     /**
      * Create a MagneticCircle object to allow the geomagnetic field at many
      * points with constant \e lat, \e h, and \e t and varying \e lon to be
@@ -197,8 +319,12 @@ namespace GeographicLib {
      * @param[in] t the time (fractional years).
      * @param[in] lat latitude of the point (degrees).
      * @param[in] h the height of the point above the ellipsoid (meters).
+     * @param[in] nthreads the number of threads to use to set up the
+     *   CircularEngine objects held by the MagneticCircle; 0 means use
+     *   std::thread::hardware_concurrency() (default 1).
      * @exception std::bad_alloc if the memory necessary for creating a
      *   MagneticCircle can't be allocated.
+     * @exception std::system_error if the threads can't be created.
      * @return a MagneticCircle object whose MagneticCircle::operator()(real
      *   lon) member function computes the field at particular values of \e
      *   lon.
@@ -209,8 +335,60 @@ namespace GeographicLib {
      *
      * Use Utility::fractionalyear to convert a date of the form yyyy-mm or
      * yyyy-mm-dd into a fractional year.
+     *
+     * A MagneticCircle holds a CircularEngine object for each of the two
+     * epochs used for the interpolation in time (and one for the constant
+     * terms, if the model has them).  These are independent; with \e
+     * nthreads &ne; 1, they are set up concurrently.
      **********************************************************************/
-    MagneticCircle Circle(real t, real lat, real h) const;
+    MagneticCircle Circle(real t, real lat, real h,
+                          unsigned nthreads = 1) const;
+
+    /**
+     * Set up an existing MagneticCircle object for a new circle of latitude.
+     *
+     * @param[in] t the time (fractional years).
+     * @param[in] lat latitude of the point (degrees).
+     * @param[in] h the height of the point above the ellipsoid (meters).
+     * @param[in,out] circ the MagneticCircle object.
+     * @param[in] nthreads the number of threads to use (default 1).
+     * @exception std::bad_alloc if the memory necessary for \e circ can't be
+     *   allocated.
+     * @exception std::system_error if the threads can't be created.
+     *
+     * This sets \e circ to the object returned by the other version of
+     * Circle, reusing the storage for the coefficients which \e circ already
+     * holds.
+     **********************************************************************/
+    void Circle(real t, real lat, real h, MagneticCircle& circ,
+                unsigned nthreads = 1) const;
+
+    /**
+     * Create a MagneticSnapshot object to allow the geomagnetic field at
+     * many points at a fixed time to be computed efficiently.
+     *
+     * @param[in] t the time (fractional years).
+     * @param[in] Nmax (optional) if non-negative, truncate the degree of the
+     *   snapshot to this value.
+     * @param[in] Mmax (optional) if non-negative, truncate the order of the
+     *   snapshot to this value.
+     * @exception GeographicErr if \e Mmax > \e Nmax.
+     * @exception std::bad_alloc if the memory necessary for the snapshot
+     *   can't be allocated.
+     * @return a MagneticSnapshot object whose MagneticSnapshot::operator()()
+     *   member functions give the field at time \e t.
+     *
+     * The coefficients of the sums for the two epochs bracketing \e t and
+     * of the constant terms are combined into the coefficients of a single
+     * sum for the field and another for its rate of change.  The snapshot
+     * then gives the same results as operator()() with time \e t (to within
+     * roundoff), at about the cost of a single spherical harmonic sum.  The
+     * snapshot doesn't use the cache of circles or the truncation set by
+     * SetTruncationTolerance; instead, \e Nmax and \e Mmax, which have the
+     * same meaning as the corresponding arguments of the constructor, may be
+     * used to truncate it.
+     **********************************************************************/
+    MagneticSnapshot AtTime(real t, int Nmax = -1, int Mmax = -1) const;
 
     /**
      * Compute the magnetic field in geocentric coordinate.
@@ -280,6 +458,200 @@ namespace GeographicLib {
                                 real& Ht, real& Ft, real& Dt, real& It);
     ///@}
 
+    /** \name Caching circles of latitude
+     **********************************************************************/
+    ///@{
+    /**
+     * Set up a cache of circles of latitude.
+     *
+     * @param[in] dlat the quantum for the latitudes (degrees).
+     * @param[in] dh the quantum for the heights (meters).
+     * @param[in] dt the quantum for the times (years).
+     * @param[in] maxbytes (optional) the memory budget for the circles
+     *   (bytes); the default is 16 MB.
+     * @exception GeographicErr if \e dlat, \e dh, or \e dt is not positive.
+     *
+     * Once this is called, operator()() rounds \e t, \e lat, and \e h to
+     * the nearest multiples of \e dt, \e dlat, and \e dh and evaluates the
+     * field using a MagneticCircle for the rounded time, latitude, and
+     * height.  The circles are held in a cache with least-recently-used
+     * eviction, so repeated queries at nearly constant latitude, height, and
+     * time (e.g., by a tracking program) are computed efficiently.  The error
+     * incurred by rounding is bounded by the changes in the field over \e
+     * dlat/2, \e dh/2, and \e dt/2; so these should be chosen to give
+     * sufficient accuracy.  The number of circles held is \e maxbytes
+     * divided by an estimate of the size of a circle (about 144 (\e Mmax +
+     * 1) bytes for double precision); at least one circle is always kept.
+     * The lookups are serialized with a mutex, so the model can still be used
+     * on several threads; however, this function and CircleCacheClear should
+     * not be called while the model is being used on other threads.  This
+     * replaces any cache previously set up.  FieldGeocentric and FieldBatch
+     * do not use the cache.
+     **********************************************************************/
+    void CacheCircles(real dlat, real dh, real dt,
+                      unsigned long long maxbytes = 1ULL << 24) const;
+
+    /**
+     * Clear the cache of circles and stop caching.  This never throws an
+     * error.
+     **********************************************************************/
+    void CircleCacheClear() const;
+
+    /**
+     * @return true if circles of latitude are being cached.
+     **********************************************************************/
+    bool CachingCircles() const { return _circles.Capacity() > 0; }
+
+    /**
+     * @return the maximum number of circles held by the cache.
+     **********************************************************************/
+    size_t CircleCacheCapacity() const { return _circles.Capacity(); }
+
+    /**
+     * @return the number of circles held by the cache.
+     **********************************************************************/
+    size_t CircleCacheSize() const { return _circles.Size(); }
+
+    /**
+     * @return the number of lookups satisfied by the cache (since the cache
+     *   was set up).
+     **********************************************************************/
+    unsigned long long CircleCacheHits() const { return _circles.Hits(); }
+
+    /**
+     * @return the number of lookups which required a circle to be
+     *   constructed (since the cache was set up).
+     **********************************************************************/
+    unsigned long long CircleCacheMisses() const { return _circles.Misses(); }
+    ///@}
+
+    /** \name Truncating the sums with height
+     **********************************************************************/
+    ///@{
+    /**
+     * Truncate the spherical harmonic sums according to the distance from
+     * the center of the earth.
+     *
+     * @param[in] tol the tolerance for the magnetic field (nanotesla); 0
+     *   turns off the truncation.
+     * @exception GeographicErr if \e tol is negative or NaN.
+     * @exception std::bad_alloc if the memory for the bounds on the terms
+     *   can't be allocated.
+     *
+     * The terms of degree \e n in the sums are attenuated by the factor
+     * (<i>a</i>/<i>r</i>)<sup>\e n + 2</sup>, so, far from the earth, the
+     * terms of high degree are negligible.  If \e tol > 0, each of the sums
+     * contributing to the field is truncated at the smallest degree for
+     * which a rigorous bound on the neglected terms (found by
+     * SphericalEngine::TruncatedDegree) is less than its share of \e tol.
+     * This applies to operator()() (without a cache of circles) and
+     * FieldGeocentric; the rates of change of the field are computed with
+     * the truncated sums but their errors aren't controlled.  It doesn't
+     * apply to FieldBatch, MagneticCircle objects, or MagneticSnapshot
+     * objects.  The bounds are computed on the first call with \e tol > 0.
+     * This function should not be called while the model is being used on
+     * other threads.
+     **********************************************************************/
+    void SetTruncationTolerance(real tol) const;
+
+    /**
+     * @return the tolerance set by SetTruncationTolerance (0 if the sums
+     *   aren't truncated).
+     **********************************************************************/
+    Math::real TruncationTolerance() const { return _trunctol; }
+    ///@}
+
+    /** \name Compact storage of the epochs
+     **********************************************************************/
+    ///@{
+    /**
+     * Hold the coefficients for the epochs of the model in a compact form.
+     *
+     * @param[in] quantum the quantum for the coefficients (nanotesla).
+     * @param[in] maxpairs (optional) the number of pairs of decoded epochs
+     *   to cache; the default is 4.
+     * @exception GeographicErr if \e quantum is not positive or if it is so
+     *   small that the coefficients divided by \e quantum can't be
+     *   represented exactly.
+     * @exception GeographicErr if the model is already compressed.
+     * @exception std::bad_alloc if the memory for the compressed
+     *   coefficients can't be allocated.
+     *
+     * Models such as IGRF give the field at many epochs, typically 5 years
+     * apart, and the coefficients for successive epochs differ only
+     * slightly.  This replaces the coefficients for all but the first epoch
+     * by the differences between successive epochs, rounded to multiples of
+     * \e quantum and encoded with a variable number of bytes (usually 1 or
+     * 2) per coefficient.  The coefficients for the first epoch, the rate of
+     * change after the last epoch, and the constant terms are kept in full.
+     * When the field is required at a time \e t, the two epochs bracketing
+     * \e t are decoded and held in a cache with least-recently-used
+     * eviction.  For a model such as IGRF, this typically reduces the
+     * memory needed for the coefficients by a factor of 3 or more.
+     *
+     * The coefficients of the models distributed by NOAA and IAGA are given
+     * to a fixed number of decimal places; if \e quantum is the resolution
+     * of the coefficients (e.g., 0.01 nT for IGRF), the decoded coefficients
+     * match the original ones to within roundoff.  Otherwise, the error in
+     * the decoded coefficients is at most \e quantum/2.  If the model is
+     * memory mapped or embedded in the library, the coefficients which are
+     * kept are copied into memory and the file is no longer used.  This has
+     * no effect if the model has only a single epoch.  This function should
+     * not be called while the model is being used on other threads.  Copies
+     * of a compressed model share the compressed coefficients.
+     **********************************************************************/
+    void Compress(real quantum, size_t maxpairs = 4);
+
+    /**
+     * @return true if the coefficients are compressed.
+     **********************************************************************/
+    bool Compressed() const { return _coeffs && _coeffs->quantum > 0; }
+
+    /**
+     * @return the quantum used to compress the coefficients (0 if they
+     *   aren't compressed).
+     **********************************************************************/
+    Math::real CompressionQuantum() const
+    { return _coeffs ? _coeffs->quantum : 0; }
+
+    /**
+     * @return the number of bytes used to hold the coefficients (not
+     *   counting a memory mapped file, coefficients embedded in the
+     *   library, or the cache of decoded epochs for a compressed model).
+     **********************************************************************/
+    size_t CoefficientBytes() const;
+    ///@}
+
+    /** \name Memory usage and cost
+     **********************************************************************/
+    ///@{
+    /**
+     * @return the number of bytes of memory held by the object.
+     *
+     * This includes the coefficients (see CoefficientBytes), the cache of
+     * decoded epochs of a compressed model (see Compress), the cache of
+     * circles (see CacheCircles), and the bounds used to truncate the sums.
+     * It doesn't include a memory mapped coefficient file or the table of
+     * square roots shared by all models (see
+     * SphericalEngine::RootTableMemoryUsage).  The size of the circles is
+     * estimated as in CacheCircles.
+     **********************************************************************/
+    size_t MemoryUsage() const;
+
+    /**
+     * @return the approximate number of floating point operations needed to
+     *   compute the field and its rate of change with operator()() (without
+     *   a cache of circles) or FieldGeocentric at the full degree and order
+     *   of the model.
+     *
+     * This is dominated by the cost of the 2 or 3 spherical harmonic sums
+     * which are evaluated together; see SphericalEngine::CostEstimate.  The
+     * cost of decoding the epochs of a compressed model, which is incurred
+     * only when they are not in the cache, isn't included.
+     **********************************************************************/
+    unsigned long long CostEstimate() const;
+    ///@}
+
     /** \name Inspector functions
      **********************************************************************/
     ///@{
@@ -377,6 +749,12 @@ namespace GeographicLib {
      * @return \e Mmax the maximum order of the components of the model.
      **********************************************************************/
     int Order() const { return _mmx; }
+
+    /**
+     * @return true if the coefficient file is memory mapped.
+     **********************************************************************/
+    bool MemoryMapped() const
+    { return _coeffs && _coeffs->cofmap.data() != nullptr; }
     ///@}
 
     /**
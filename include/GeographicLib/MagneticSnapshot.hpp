@@ -0,0 +1,181 @@
+/**
+ * \file MagneticSnapshot.hpp
+ * \brief Header for GeographicLib::MagneticSnapshot class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_MAGNETICSNAPSHOT_HPP)
+#define GEOGRAPHICLIB_MAGNETICSNAPSHOT_HPP 1
+
+#include <memory>
+#include <vector>
+#include <GeographicLib/Constants.hpp>
+#include <GeographicLib/Geocentric.hpp>
+#include <GeographicLib/SphericalHarmonic.hpp>
+
+#if defined(_MSC_VER)
+// Squelch warnings about dll vs vector
+#  pragma warning (push)
+#  pragma warning (disable: 4251)
+#endif
+
+namespace GeographicLib {
+
+  /**
+   * \brief Geomagnetic field at a fixed time
+   *
+   * Evaluate the earth's magnetic field at a particular time.  MagneticModel
+   * interpolates the field between the epochs of the model (and adds the
+   * constant terms) on every call; this class holds the coefficients
+   * combined for a single time, so that each evaluation is a single
+   * spherical harmonic sum (together with the sum for the rate of change of
+   * the field, if this is requested).  This is useful for applications
+   * which query the field many times at the same time, e.g., "now".
+   *
+   * Use MagneticModel::AtTime to create a MagneticSnapshot object.  (The
+   * constructor for this class is private.)  The object is immutable and
+   * doesn't refer to the MagneticModel which created it; the coefficients
+   * are shared by copies of the object, so it is cheap to copy and may be
+   * used concurrently on several threads.
+   *
+   * Example of use:
+   * \code
+   * MagneticModel mag("wmm2020");
+   * MagneticSnapshot now = mag.AtTime(2024.5);
+   * double Bx, By, Bz;
+   * now(27.99, 86.93, 8820, Bx, By, Bz);
+   * \endcode
+   **********************************************************************/
+
+  class GEOGRAPHICLIB_EXPORT MagneticSnapshot {
+  private:
+    typedef Math::real real;
+
+    real _a, _t;
+    Geocentric _earth;
+    // The combined coefficients for the field and its rate of change; the
+    // SphericalHarmonic objects refer to this storage.
+    std::shared_ptr<const std::vector<real> > _coeffs;
+    SphericalHarmonic _harm[2];
+
+    MagneticSnapshot(real a, real t, const Geocentric& earth,
+                     SphericalHarmonic::normalization norm, int N, int M,
+                     const std::shared_ptr<const std::vector<real> >& coeffs);
+
+    void Field(real lat, real lon, real h, bool diffp,
+               real& Bx, real& By, real& Bz,
+               real& Bxt, real& Byt, real& Bzt) const;
+
+    friend class MagneticModel; // MagneticModel calls the constructor
+
+  public:
+
+    /**
+     * A default constructor.  This sets up an uninitialized object which can
+     * be later replaced by MagneticModel::AtTime.
+     **********************************************************************/
+    MagneticSnapshot() : _a(-1), _t(Math::NaN()) {}
+
+    /** \name Compute the magnetic field
+     **********************************************************************/
+    ///@{
+    /**
+     * Evaluate the components of the geomagnetic field.
+     *
+     * @param[in] lat latitude of the point (degrees).
+     * @param[in] lon longitude of the point (degrees).
+     * @param[in] h the height of the point above the ellipsoid (meters).
+     * @param[out] Bx the easterly component of the magnetic field (nanotesla).
+     * @param[out] By the northerly component of the magnetic field
+     *   (nanotesla).
+     * @param[out] Bz the vertical (up) component of the magnetic field
+     *   (nanotesla).
+     **********************************************************************/
+    void operator()(real lat, real lon, real h,
+                    real& Bx, real& By, real& Bz) const {
+      real dummy;
+      Field(lat, lon, h, false, Bx, By, Bz, dummy, dummy, dummy);
+    }
+
+    /**
+     * Evaluate the components of the geomagnetic field and their time
+     * derivatives.
+     *
+     * @param[in] lat latitude of the point (degrees).
+     * @param[in] lon longitude of the point (degrees).
+     * @param[in] h the height of the point above the ellipsoid (meters).
+     * @param[out] Bx the easterly component of the magnetic field (nanotesla).
+     * @param[out] By the northerly component of the magnetic field
+     *   (nanotesla).
+     * @param[out] Bz the vertical (up) component of the magnetic field
+     *   (nanotesla).
+     * @param[out] Bxt the rate of change of \e Bx (nT/yr).
+     * @param[out] Byt the rate of change of \e By (nT/yr).
+     * @param[out] Bzt the rate of change of \e Bz (nT/yr).
+     **********************************************************************/
+    void operator()(real lat, real lon, real h,
+                    real& Bx, real& By, real& Bz,
+                    real& Bxt, real& Byt, real& Bzt) const {
+      Field(lat, lon, h, true, Bx, By, Bz, Bxt, Byt, Bzt);
+    }
+
+    /**
+     * Evaluate the components of the geomagnetic field and their time
+     * derivatives in geocentric coordinates.
+     *
+     * @param[in] X geocentric coordinate (meters).
+     * @param[in] Y geocentric coordinate (meters).
+     * @param[in] Z geocentric coordinate (meters).
+     * @param[out] BX the \e X component of the magnetic field (nT).
+     * @param[out] BY the \e Y component of the magnetic field (nT).
+     * @param[out] BZ the \e Z component of the magnetic field (nT).
+     * @param[out] BXt the rate of change of \e BX (nT/yr).
+     * @param[out] BYt the rate of change of \e BY (nT/yr).
+     * @param[out] BZt the rate of change of \e BZ (nT/yr).
+     **********************************************************************/
+    void FieldGeocentric(real X, real Y, real Z,
+                         real& BX, real& BY, real& BZ,
+                         real& BXt, real& BYt, real& BZt) const;
+    ///@}
+
+    /** \name Inspector functions
+     **********************************************************************/
+    ///@{
+    /**
+     * @return true if the object has been initialized.
+     **********************************************************************/
+    bool Init() const { return _a > 0; }
+
+    /**
+     * @return the time of the snapshot (fractional years).
+     **********************************************************************/
+    Math::real Time() const { return Init() ? _t : Math::NaN(); }
+
+    /**
+     * @return \e a the reference radius of the model (meters).
+     **********************************************************************/
+    Math::real ReferenceRadius() const
+    { return Init() ? _a : Math::NaN(); }
+
+    /**
+     * @return \e Nmax the maximum degree of the combined sums.
+     **********************************************************************/
+    int Degree() const { return Init() ? _harm[0].Coefficients().nmx() : -1; }
+
+    /**
+     * @return \e Mmax the maximum order of the combined sums.
+     **********************************************************************/
+    int Order() const { return Init() ? _harm[0].Coefficients().mmx() : -1; }
+    ///@}
+  };
+
+} // namespace GeographicLib
+
+#if defined(_MSC_VER)
+#  pragma warning (pop)
+#endif
+
+#endif  // GEOGRAPHICLIB_MAGNETICSNAPSHOT_HPP
@@ -26,18 +26,46 @@
 /**
  * The precision of floating point numbers used in %GeographicLib.  1 means
  * float (single precision); 2 (the default) means double; 3 means long double;
- * 4 is reserved for quadruple precision.  Nearly all the testing has been
- * carried out with doubles and that's the recommended configuration.  In order
- * for long double to be used, GEOGRAPHICLIB_HAVE_LONG_DOUBLE needs to be
- * defined.  Note that with Microsoft Visual Studio, long double is the same as
- * double.
+ * 4 is reserved for quadruple precision; 5 means variable precision (using
+ * mpreal); 6 means double-double precision (using DoubleDouble).  Nearly all
+ * the testing has been carried out with doubles and that's the recommended
+ * configuration.  In order for long double to be used,
+ * GEOGRAPHICLIB_HAVE_LONG_DOUBLE needs to be defined.  Note that with
+ * Microsoft Visual Studio, long double is the same as double.
  **********************************************************************/
 #  define GEOGRAPHICLIB_PRECISION 2
 #endif
 
+#if !defined(GEOGRAPHICLIB_INSTRUMENT)
+/**
+ * Whether the iterative solvers record their behavior in Histogram objects
+ * (1) or not (0, the default).  This changes the layout of Geodesic,
+ * TransverseMercatorExact, EllipticFunction, and NearestNeighbor, so the
+ * library and the code using it must be compiled with the same value.
+ **********************************************************************/
+#  define GEOGRAPHICLIB_INSTRUMENT 0
+#endif
+
+#if !defined(GEOGRAPHICLIB_INLINE_MATH)
+/**
+ * Whether the definitions of the frequently called functions of Math (sum,
+ * AngNormalize, AngDiff, AngRound, sincosd, sincosde, sind, cosd, tand,
+ * atan2d, atand, eatanhe, and taupf) are visible to the calling code (1) or
+ * not (0, the default).  With 1, the compiler can inline these functions in
+ * the calling code instead of calling the library.  The library and the
+ * calling code may be compiled with different values.  The calling code
+ * should not be compiled with -ffast-math (or the equivalent) since this
+ * breaks Math::sum.
+ **********************************************************************/
+#  define GEOGRAPHICLIB_INLINE_MATH 0
+#endif
+
 #include <cmath>
 #include <algorithm>
 #include <limits>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
 
 #if GEOGRAPHICLIB_PRECISION == 4
 #include <boost/version.hpp>
@@ -45,6 +73,8 @@
 #include <boost/math/special_functions.hpp>
 #elif GEOGRAPHICLIB_PRECISION == 5
 #include <mpreal.h>
+#elif GEOGRAPHICLIB_PRECISION == 6
+#include <GeographicLib/DoubleDouble.hpp>
 #endif
 
 #if GEOGRAPHICLIB_PRECISION > 3
@@ -77,6 +107,30 @@ namespace GeographicLib {
   private:
     void dummy();               // Static check for GEOGRAPHICLIB_PRECISION
     Math() = delete;            // Disable constructor
+    // Implementations of swab; if T has the same size as an unsigned integer
+    // type U, the swap is done with shifts on U which compilers turn into a
+    // byte swap instruction (and which can be vectorized in a loop over an
+    // array); otherwise the bytes are swapped one at a time.
+    template<typename T, typename U> static T swabimpl(T x, U*) {
+      U u, v = 0;
+      std::memcpy(&u, &x, sizeof(T));
+      for (size_t i = 0; i < sizeof(U); ++i) {
+        v = U(v << 8) | U(u & 0xffu);
+        u = U(u >> 8);
+      }
+      std::memcpy(&x, &v, sizeof(T));
+      return x;
+    }
+    template<typename T> static T swabimpl(T x, void*) {
+      union {
+        T r;
+        unsigned char c[sizeof(T)];
+      } b;
+      b.r = x;
+      for (int i = sizeof(T)/2; i--; )
+        std::swap(b.c[i], b.c[sizeof(T) - 1 - i]);
+      return b.r;
+    }
   public:
 
 #if GEOGRAPHICLIB_HAVE_LONG_DOUBLE
@@ -105,6 +159,8 @@ namespace GeographicLib {
     typedef boost::multiprecision::float128 real;
 #elif GEOGRAPHICLIB_PRECISION == 5
     typedef mpfr::mpreal real;
+#elif GEOGRAPHICLIB_PRECISION == 6
+    typedef DoubleDouble real;
 #else
     typedef double real;
 #endif
@@ -439,6 +495,169 @@ namespace GeographicLib {
      **********************************************************************/
     template<typename T> static T atand(T x);
 
+    /**
+     * Reduce an angle exactly to the range [&minus;45&deg;, 45&deg;].
+     *
+     * @tparam T the type of the argument and returned value.
+     * @param[in] x the angle in degrees.
+     * @param[out] q the quadrant; \e x = \e r + 90&deg; \e q.
+     * @return \e r the reduced angle.
+     *
+     * This returns the same \e r as remquo(\e x, 90, &\e q), including the
+     * sign of zero and the rounding of ties to even \e q.  Only the bottom 2
+     * bits of \e q are guaranteed to agree with remquo.  The subtraction is
+     * exact provided that |\e x| &le; 2<sup>20</sup>&deg; and it is carried
+     * out inline, avoiding the slow library call to remquo, in this case;
+     * otherwise (and for non-finite \e x) remquo is called.
+     **********************************************************************/
+    template<typename T> static T AngReduce(T x, int& q) {
+      using std::fabs; using std::copysign; using std::remquo;
+      if (!(fabs(x) <= T(1048576))) return remquo(x, T(qd), &q);
+      T y = x / T(qd);
+      // The rounding errors in y and in the conversion can only give the
+      // wrong q when x is close to an odd multiple of 45; the adjustments
+      // below fix this.
+      q = int(y + copysign(T(1)/2, y));
+      T r = x - T(qd) * T(q);   // exact
+      if (r > T(qd)/2) { r -= T(qd); ++q; }
+      else if (r < -T(qd)/2) { r += T(qd); --q; }
+      else if (fabs(r) == T(qd)/2 && (q & 1)) {
+        // Ties go to even q
+        q += r > 0 ? 1 : -1; r = -r;
+      }
+      return r == 0 ? copysign(r, x) : r;
+    }
+
+    /**
+     * An inline version of Math::AngNormalize.
+     *
+     * @tparam T the type of the argument and returned value.
+     * @param[in] x the angle in degrees.
+     * @return the angle reduced to the range [&minus;180&deg;, 180&deg;].
+     *
+     * The result is identical to Math::AngNormalize.  Arguments already in
+     * [&minus;180&deg;, 180&deg;] are returned unchanged and the reduction of
+     * other arguments with magnitudes up to 2<sup>20</sup>&deg; is done
+     * without calling remainder.
+     **********************************************************************/
+    template<typename T> static T AngNormalizeInline(T x) {
+      using std::fabs; using std::copysign; using std::remainder;
+      if (fabs(x) <= T(hd)) return x;
+      T y;
+      if (fabs(x) <= T(1048576)) {
+        int q = int(x / T(td) + copysign(T(1)/2, x));
+        y = x - T(td) * T(q); // exact
+        if (y > T(hd)) y -= T(td);
+        else if (y < -T(hd)) y += T(td);
+        if (y == 0) y = copysign(y, x);
+      } else {
+        y = remainder(x, T(td));
+#if GEOGRAPHICLIB_PRECISION == 4
+        // See AngNormalize
+        if (y == 0) y = copysign(y, x);
+#endif
+      }
+      return fabs(y) == T(hd) ? copysign(T(hd), x) : y;
+    }
+
+    /**
+     * An inline version of Math::sincosd.
+     *
+     * @tparam T the type of the arguments.
+     * @param[in] x in degrees.
+     * @param[out] sinx sin(<i>x</i>).
+     * @param[out] cosx cos(<i>x</i>).
+     *
+     * The results are identical to Math::sincosd.
+     **********************************************************************/
+    template<typename T> static void sincosdInline(T x, T& sinx, T& cosx) {
+      using std::sin; using std::cos; using std::copysign;
+      int q = 0;
+      T r = AngReduce(x, q) * degree<T>(); // now abs(r) <= pi/4
+      // g++ -O turns these two function calls into a call to sincos
+      T s = sin(r), c = cos(r);
+      switch (unsigned(q) & 3U) {
+      case 0U: sinx =  s; cosx =  c; break;
+      case 1U: sinx =  c; cosx = -s; break;
+      case 2U: sinx = -s; cosx = -c; break;
+      default: sinx = -c; cosx =  s; break; // case 3U
+      }
+      // mpreal needs T(0) here
+      cosx += T(0);                            // special values from F.10.1.12
+      if (sinx == 0) sinx = copysign(sinx, x); // special values from F.10.1.13
+    }
+
+    /**
+     * An inline version of Math::atan2d.
+     *
+     * @tparam T the type of the arguments and the returned value.
+     * @param[in] y
+     * @param[in] x
+     * @return atan2(<i>y</i>, <i>x</i>) in degrees.
+     *
+     * The result is identical to Math::atan2d.
+     **********************************************************************/
+    template<typename T> static T atan2dInline(T y, T x) {
+      using std::fabs; using std::signbit; using std::atan2;
+      using std::copysign; using std::swap;
+      int q = 0;
+      if (fabs(y) > fabs(x)) { swap(x, y); q = 2; }
+      if (signbit(x)) { x = -x; ++q; }
+      // here x >= 0 and x >= abs(y), so angle is in [-pi/4, pi/4]
+      T ang = atan2(y, x) / degree<T>();
+      switch (q) {
+      case 1: ang = copysign(T(hd), y) - ang; break;
+      case 2: ang =            qd      - ang; break;
+      case 3: ang =           -qd      + ang; break;
+      default: break;
+      }
+      return ang;
+    }
+
+    /**
+     * Normalize an array of angles.
+     *
+     * @tparam T the type of the arguments.
+     * @param[in] n the number of angles.
+     * @param[in] x the array of angles in degrees.
+     * @param[out] y the array of results; this may be the same as \e x.
+     *
+     * The results are identical to Math::AngNormalize.
+     **********************************************************************/
+    template<typename T> static void AngNormalizeBatch(size_t n, const T x[],
+                                                       T y[]);
+
+    /**
+     * Evaluate the sine and cosine for an array of angles in degrees.
+     *
+     * @tparam T the type of the arguments.
+     * @param[in] n the number of angles.
+     * @param[in] x the array of angles in degrees.
+     * @param[out] sinx the array of sines.
+     * @param[out] cosx the array of cosines.
+     *
+     * The results are identical to Math::sincosd.  Either output array may
+     * be the same as \e x.
+     **********************************************************************/
+    template<typename T> static void sincosdBatch(size_t n, const T x[],
+                                                  T sinx[], T cosx[]);
+
+    /**
+     * Evaluate the atan2 function for arrays of arguments with the results in
+     * degrees.
+     *
+     * @tparam T the type of the arguments.
+     * @param[in] n the number of arguments.
+     * @param[in] y the array of <i>y</i> values.
+     * @param[in] x the array of <i>x</i> values.
+     * @param[out] ang the array of results; this may be the same as \e y or
+     *   \e x.
+     *
+     * The results are identical to Math::atan2d.
+     **********************************************************************/
+    template<typename T> static void atan2dBatch(size_t n, const T y[],
+                                                 const T x[], T ang[]);
+
     /**
      * Evaluate <i>e</i> atanh(<i>e x</i>)
      *
@@ -491,6 +710,36 @@ namespace GeographicLib {
      **********************************************************************/
     template<typename T> static T tauf(T taup, T es);
 
+    /**
+     * tan&chi; in terms of tan&phi; for an array of arguments
+     *
+     * @tparam T the type of the arguments.
+     * @param[in] n the number of arguments.
+     * @param[in] tau the array of values of &tau; = tan&phi;.
+     * @param[in] es the signed eccentricity.
+     * @param[out] taup the array of results &tau;&prime; = tan&chi;; this
+     *   may be the same as \e tau.
+     *
+     * The results are identical to Math::taupf.
+     **********************************************************************/
+    template<typename T> static void taupfBatch(size_t n, const T tau[], T es,
+                                                T taup[]);
+
+    /**
+     * tan&phi; in terms of tan&chi; for an array of arguments
+     *
+     * @tparam T the type of the arguments.
+     * @param[in] n the number of arguments.
+     * @param[in] taup the array of values of &tau;&prime; = tan&chi;.
+     * @param[in] es the signed eccentricity.
+     * @param[out] tau the array of results &tau; = tan&phi;; this may be the
+     *   same as \e taup.
+     *
+     * The results are identical to Math::tauf.
+     **********************************************************************/
+    template<typename T> static void taufBatch(size_t n, const T taup[], T es,
+                                               T tau[]);
+
     /**
      * The NaN (not a number)
      *
@@ -515,18 +764,21 @@ namespace GeographicLib {
      * @return x with its bytes swapped.
      **********************************************************************/
     template<typename T> static T swab(T x) {
-      union {
-        T r;
-        unsigned char c[sizeof(T)];
-      } b;
-      b.r = x;
-      for (int i = sizeof(T)/2; i--; )
-        std::swap(b.c[i], b.c[sizeof(T) - 1 - i]);
-      return b.r;
+      typedef typename std::conditional
+        <sizeof(T) == 2, std::uint16_t,
+         typename std::conditional
+         <sizeof(T) == 4, std::uint32_t,
+          typename std::conditional
+          <sizeof(T) == 8, std::uint64_t, void>::type>::type>::type U;
+      return swabimpl<T>(x, static_cast<U*>(nullptr));
     }
 
   };
 
 } // namespace GeographicLib
 
+#if GEOGRAPHICLIB_INLINE_MATH
+#  include <GeographicLib/MathInline.hpp>
+#endif
+
 #endif  // GEOGRAPHICLIB_MATH_HPP
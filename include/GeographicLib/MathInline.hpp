@@ -0,0 +1,172 @@
+/**
+ * \file MathInline.hpp
+ * \brief Definitions of the hot functions of GeographicLib::Math
+ *
+ * Copyright (c) Charles Karney (2015-2026) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_MATHINLINE_HPP)
+#define GEOGRAPHICLIB_MATHINLINE_HPP 1
+
+// This is included by Math.cpp, where these functions are instantiated for
+// the library, and by Math.hpp if GEOGRAPHICLIB_INLINE_MATH is nonzero, so
+// that the compiler can inline them in the calling code.  It should not be
+// included directly.
+
+#include <GeographicLib/Math.hpp>
+
+namespace GeographicLib {
+
+  template<typename T> T Math::sum(T u, T v, T& t) {
+#if GEOGRAPHICLIB_PRECISION == 6
+    using std::fabs; using std::swap;
+    // Double-double addition isn't exact, so t depends on the order of u and
+    // v; put the larger first so that sum(u, v) = sum(v, u).
+    if (fabs(u) < fabs(v)) swap(u, v);
+#endif
+    GEOGRAPHICLIB_VOLATILE T s = u + v;
+    GEOGRAPHICLIB_VOLATILE T up = s - v;
+    GEOGRAPHICLIB_VOLATILE T vpp = s - up;
+    up -= u;
+    vpp -= v;
+    // if s = 0, then t = 0 and give t the same sign as s
+    // mpreal needs T(0) here
+    t = s != 0 ? T(0) - (up + vpp) : s;
+    // u + v =       s      + t
+    //       = round(u + v) + t
+    return s;
+  }
+
+  template<typename T> T Math::AngNormalize(T x)
+  { return AngNormalizeInline(x); }
+
+  template<typename T> T Math::AngDiff(T x, T y, T& e) {
+    using std::fabs; using std::remainder; using std::copysign;
+    // Use remainder instead of AngNormalize, since we treat boundary cases
+    // later taking account of the error.  remainder(x, td) = x for abs(x) <=
+    // hd (even at the ties), so skip the library call in this common case.
+    T
+      xr = fabs(x) <= T(hd) ? -x : remainder(-x, T(td)),
+      yr = fabs(y) <= T(hd) ?  y : remainder( y, T(td)),
+      d = sum(xr, yr, e);
+    // This second sum can only change d if abs(d) < 128, so don't need to
+    // apply remainder yet again.
+    d = sum(fabs(d) <= T(hd) ? d : remainder(d, T(td)), e, e);
+    // Fix the sign if d = -180, 0, 180.
+    if (d == 0 || fabs(d) == hd)
+      // If e == 0, take sign from y - x
+      // else (e != 0, implies d = +/-180), d and e must have opposite signs
+      d = copysign(d, e == 0 ? y - x : -e);
+    return d;
+  }
+
+  template<typename T> T Math::AngRound(T x) {
+    using std::fabs; using std::copysign;
+    static const T z = T(1)/T(16);
+    GEOGRAPHICLIB_VOLATILE T y = fabs(x);
+    GEOGRAPHICLIB_VOLATILE T w = z - y;
+    // The compiler mustn't "simplify" z - (z - y) to y
+    y = w > 0 ? z - w : y;
+    return copysign(y, x);
+  }
+
+  template<typename T> void Math::sincosd(T x, T& sinx, T& cosx) {
+    // In order to minimize round-off errors, this function exactly reduces
+    // the argument to the range [-45, 45] before converting it to radians.
+    // The work is done by the inline version.
+    sincosdInline(x, sinx, cosx);
+  }
+
+  template<typename T> void Math::sincosde(T x, T t, T& sinx, T& cosx) {
+    using std::sin; using std::cos; using std::copysign;
+    // In order to minimize round-off errors, this function exactly reduces
+    // the argument to the range [-45, 45] before converting it to radians.
+    // This implementation allows x outside [-180, 180], but implementations in
+    // other languages may not.
+    T r; int q = 0;
+    r = AngRound(AngReduce(x, q) + t); // now abs(r) <= 45
+    r *= degree<T>();
+    // g++ -O turns these two function calls into a call to sincos
+    T s = sin(r), c = cos(r);
+    switch (unsigned(q) & 3U) {
+    case 0U: sinx =  s; cosx =  c; break;
+    case 1U: sinx =  c; cosx = -s; break;
+    case 2U: sinx = -s; cosx = -c; break;
+    default: sinx = -c; cosx =  s; break; // case 3U
+    }
+    // http://www.open-std.org/jtc1/sc22/wg14/www/docs/n1950.pdf
+    // mpreal needs T(0) here
+    cosx += T(0);                            // special values from F.10.1.12
+    if (sinx == 0) sinx = copysign(sinx, x); // special values from F.10.1.13
+  }
+
+  template<typename T> T Math::sind(T x) {
+    using std::sin; using std::cos; using std::copysign;
+    // See sincosd
+    T r; int q = 0;
+    r = AngReduce(x, q); // now abs(r) <= 45
+    r *= degree<T>();
+    unsigned p = unsigned(q);
+    r = p & 1U ? cos(r) : sin(r);
+    if (p & 2U) r = -r;
+    if (r == 0) r = copysign(r, x);
+    return r;
+  }
+
+  template<typename T> T Math::cosd(T x) {
+    using std::sin; using std::cos;
+    // See sincosd
+    T r; int q = 0;
+    r = AngReduce(x, q); // now abs(r) <= 45
+    r *= degree<T>();
+    unsigned p = unsigned(q + 1);
+    r = p & 1U ? cos(r) : sin(r);
+    if (p & 2U) r = -r;
+    // mpreal needs T(0) here
+    return T(0) + r;
+  }
+
+  template<typename T> T Math::tand(T x) {
+    using std::min; using std::max;
+    static const T overflow = 1 / sq(std::numeric_limits<T>::epsilon());
+    T s, c;
+    sincosd(x, s, c);
+    // http://www.open-std.org/jtc1/sc22/wg14/www/docs/n1950.pdf
+    T r = s / c;  // special values from F.10.1.14
+    // With C++17 this becomes clamp(s / c, -overflow, overflow);
+    // Use max/min here (instead of fmax/fmin) to preserve NaN
+    return min(max(r, -overflow), overflow);
+  }
+
+  template<typename T> T Math::atan2d(T y, T x) {
+    // In order to minimize round-off errors, this function rearranges the
+    // arguments so that result of atan2 is in the range [-pi/4, pi/4] before
+    // converting it to degrees and mapping the result to the correct
+    // quadrant.  The work is done by the inline version.
+    return atan2dInline(y, x);
+  }
+
+  template<typename T> T Math::atand(T x)
+  { return atan2d(x, T(1)); }
+
+  template<typename T> T Math::eatanhe(T x, T es)  {
+    using std::atanh; using std::atan;
+    return es > 0 ? es * atanh(es * x) : -es * atan(es * x);
+  }
+
+  template<typename T> T Math::taupf(T tau, T es) {
+    using std::isfinite; using std::hypot; using std::sinh;
+    // Need this test, otherwise tau = +/-inf gives taup = nan.
+    if (isfinite(tau)) {
+      T tau1 = hypot(T(1), tau),
+        sig = sinh( eatanhe(tau / tau1, es ) );
+      return hypot(T(1), sig) * tau - sig * tau1;
+    } else
+      return tau;
+  }
+
+} // namespace GeographicLib
+
+#endif  // GEOGRAPHICLIB_MATHINLINE_HPP
@@ -0,0 +1,258 @@
+/**
+ * \file MemoryPolicy.hpp
+ * \brief Header for GeographicLib::MemoryPolicy class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_MEMORYPOLICY_HPP)
+#define GEOGRAPHICLIB_MEMORYPOLICY_HPP 1
+
+#include <GeographicLib/Constants.hpp>
+#include <cstddef>
+#include <vector>
+
+namespace GeographicLib {
+
+  /**
+   * \brief The placement of the large data held by the library
+   *
+   * A cached geoid grid (e.g., egm2008-1 with Geoid::CacheAll, 467 MB) or
+   * the packed coefficients of a high degree spherical harmonic sum (see
+   * SphericalHarmonic::Pack, 77 MB for EGM2008) are read at random, so
+   * lookups are dominated by TLB misses and, on a multi-socket machine, by
+   * the latency of the memory of another NUMA node.  This class sets the
+   * policy for allocating these blocks:
+   * - SetPages(HUGEPAGES) backs them with transparent huge pages (2 MB
+   *   pages on x86-64), which cuts the TLB misses;
+   * - SetPages(HUGETLB) uses the reserved pool of huge pages (see
+   *   /proc/sys/vm/nr_hugepages), falling back to transparent huge pages if
+   *   the pool is exhausted;
+   * - SetNode(\e node) places them on a particular NUMA node;
+   * - SetReplicate(true) gives each NUMA node its own copy; a lookup then
+   *   reads the copy for the node of the calling thread.
+   *
+   * The policy applies to the blocks allocated after it is set: the cache
+   * of a Geoid (which is replicated if the Geoid is thread safe) and the
+   * packed coefficients of a SphericalHarmonic (see
+   * GravityModel::PackCoefficients); the coefficient vectors read by
+   * GravityModel and MagneticModel are only given huge pages.  The default
+   * policy is SMALLPAGES with no node and no replication which leaves the
+   * placement to the operating system (which usually puts the memory on
+   * the node of the thread which first writes it).
+   *
+   * Huge pages, nodes, and replication are only supported on Linux; on
+   * other systems, the policy is accepted but has no effect and Nodes()
+   * returns 1.  Blocks smaller than 2 MB are allocated normally.
+   *
+   * Example of use:
+   * \code
+   * // Replicate the geoid on each node of a multi-socket server
+   * MemoryPolicy::SetPages(MemoryPolicy::HUGEPAGES);
+   * MemoryPolicy::SetReplicate(true);
+   * Geoid egm("egm2008-1", "", true, true); // thread safe
+   * \endcode
+   **********************************************************************/
+  class GEOGRAPHICLIB_EXPORT MemoryPolicy {
+  public:
+    /**
+     * The page sizes.
+     **********************************************************************/
+    enum pages {
+      /**
+       * Normal pages.
+       * @hideinitializer
+       **********************************************************************/
+      SMALLPAGES = 0,
+      /**
+       * Transparent huge pages (with madvise).
+       * @hideinitializer
+       **********************************************************************/
+      HUGEPAGES = 1,
+      /**
+       * Huge pages from the reserved pool (with mmap and MAP_HUGETLB).
+       * @hideinitializer
+       **********************************************************************/
+      HUGETLB = 2,
+    };
+
+    /**
+     * Set the page size for large blocks.
+     *
+     * @param[in] p the page size.
+     **********************************************************************/
+    static void SetPages(pages p);
+
+    /**
+     * @return the page size for large blocks.
+     **********************************************************************/
+    static pages Pages();
+
+    /**
+     * Set the NUMA node for large blocks.
+     *
+     * @param[in] node the node; a negative value (the default) leaves the
+     *   placement to the operating system.
+     **********************************************************************/
+    static void SetNode(int node);
+
+    /**
+     * @return the NUMA node for large blocks (negative if unset).
+     **********************************************************************/
+    static int Node();
+
+    /**
+     * Set whether read-only data is replicated on each NUMA node.
+     *
+     * @param[in] replicate whether to replicate the data.
+     *
+     * Replication takes effect only if Nodes() > 1.  It multiplies the
+     * memory used by the data by the number of nodes.
+     **********************************************************************/
+    static void SetReplicate(bool replicate);
+
+    /**
+     * @return whether read-only data is replicated on each NUMA node.
+     **********************************************************************/
+    static bool Replicate();
+
+    /**
+     * @return the number of NUMA nodes (one more than the largest node
+     *   number).
+     **********************************************************************/
+    static int Nodes();
+
+    /**
+     * @return the NUMA node of the CPU running the calling thread, in [0,
+     *   Nodes()).
+     *
+     * This is cheap (a few ns) on Linux, where it's computed from the CPU
+     * number returned by sched_getcpu.  Of course, the thread may be moved
+     * to another node afterwards.
+     **********************************************************************/
+    static int CurrentNode();
+
+    /**
+     * Restrict the calling thread to the CPUs of a NUMA node.
+     *
+     * @param[in] node the node.
+     * @return whether the thread was restricted.
+     *
+     * This is a convenience for benchmarks and for applications which set
+     * up a pool of threads per node.
+     **********************************************************************/
+    static bool RunOnNode(int node);
+
+    /**
+     * Allocate a block of memory with the policy.
+     *
+     * @param[in] n the size of the block (bytes).
+     * @param[in] node the NUMA node; a negative value means Node().
+     * @exception std::bad_alloc if the memory can't be allocated.
+     * @return the block, aligned on at least a 16-byte boundary.
+     *
+     * A block of at least 2 MB is mapped separately with the page size and
+     * node given by the policy; a smaller one is allocated with operator
+     * new.
+     **********************************************************************/
+    static void* Allocate(size_t n, int node = -1);
+
+    /**
+     * Free a block of memory.
+     *
+     * @param[in] p the block returned by Allocate.
+     * @param[in] n the size of the block (bytes) as passed to Allocate.
+     **********************************************************************/
+    static void Deallocate(void* p, size_t n) noexcept;
+
+    /**
+     * Ask for huge pages for the storage of a vector.
+     *
+     * @tparam T the type of the elements.
+     * @param[in,out] v the vector, which should be empty.
+     * @param[in] n the number of elements to reserve.
+     *
+     * This reserves storage for \e n elements and, if Pages() isn't
+     * SMALLPAGES, advises the operating system to back it with huge pages;
+     * because the storage hasn't been written yet, the pages are huge when
+     * they are first touched.  This is used for vectors whose type is part
+     * of the public interface, so that Allocator can't be used.
+     **********************************************************************/
+    template<typename T>
+    static void Reserve(std::vector<T>& v, size_t n) {
+      v.reserve(n);
+      if (n > 0) Advise(v.data(), n * sizeof(T));
+    }
+
+    /**
+     * \brief An allocator using MemoryPolicy
+     *
+     * This is a standard allocator which allocates with
+     * MemoryPolicy::Allocate for a particular node (or for the node given
+     * by the policy).  Memory allocated by one Allocator can be freed by
+     * any other.
+     **********************************************************************/
+    template<typename T>
+    class Allocator {
+    private:
+      int _node;
+    public:
+      /**
+       * The type of the elements.
+       **********************************************************************/
+      typedef T value_type;
+      /**
+       * Constructor.
+       *
+       * @param[in] node the NUMA node; a negative value (the default) means
+       *   MemoryPolicy::Node() at the time of allocation.
+       **********************************************************************/
+      Allocator(int node = -1) noexcept : _node(node) {}
+      /**
+       * Convert from an allocator for another type.
+       *
+       * @param[in] a the allocator.
+       **********************************************************************/
+      template<typename U>
+      Allocator(const Allocator<U>& a) noexcept : _node(a.node()) {}
+      /**
+       * @return the NUMA node.
+       **********************************************************************/
+      int node() const { return _node; }
+      /**
+       * Allocate storage.
+       *
+       * @param[in] n the number of elements.
+       * @return the storage.
+       **********************************************************************/
+      T* allocate(size_t n)
+      { return static_cast<T*>(Allocate(n * sizeof(T), _node)); }
+      /**
+       * Free storage.
+       *
+       * @param[in] p the storage.
+       * @param[in] n the number of elements.
+       **********************************************************************/
+      void deallocate(T* p, size_t n) noexcept
+      { Deallocate(p, n * sizeof(T)); }
+      /**
+       * @return true; all allocators are interchangeable.
+       **********************************************************************/
+      template<typename U>
+      bool operator==(const Allocator<U>&) const { return true; }
+      /**
+       * @return false; all allocators are interchangeable.
+       **********************************************************************/
+      template<typename U>
+      bool operator!=(const Allocator<U>&) const { return false; }
+    };
+
+  private:
+    static void Advise(void* p, size_t n);
+  };
+
+} // namespace GeographicLib
+
+#endif  // GEOGRAPHICLIB_MEMORYPOLICY_HPP
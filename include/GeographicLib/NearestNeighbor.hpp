@@ -10,17 +10,26 @@
 #if !defined(GEOGRAPHICLIB_NEARESTNEIGHBOR_HPP)
 #define GEOGRAPHICLIB_NEARESTNEIGHBOR_HPP 1
 
-#include <algorithm>            // for nth_element, max_element, etc.
+#include <algorithm>            // for nth_element, push_heap, etc.
 #include <vector>
-#include <queue>                // for priority_queue
 #include <utility>              // for swap + pair
 #include <cstring>
+#include <cstdint>
 #include <limits>
 #include <cmath>
 #include <iostream>
 #include <sstream>
+#include <atomic>
+#include <mutex>
+#include <exception>
+#include <type_traits>
 // Only for GeographicLib::GeographicErr
 #include <GeographicLib/Constants.hpp>
+// Only for GeographicLib::GeodesicBatchExecutor::Run
+#include <GeographicLib/GeodesicBatchExecutor.hpp>
+#if GEOGRAPHICLIB_INSTRUMENT
+#include <GeographicLib/Histogram.hpp>
+#endif
 
 #if defined(GEOGRAPHICLIB_HAVE_BOOST_SERIALIZATION) && \
   GEOGRAPHICLIB_HAVE_BOOST_SERIALIZATION
@@ -85,9 +94,74 @@ namespace GeographicLib {
    * it's necessary to supply the same vector of points and the same distance
    * function.
    *
-   * There's no capability in this implementation to add or remove points from
-   * the set.  Instead Initialize() should be called to re-initialize the
-   * object with the modified vector of points.
+   * Most of the cost of a search is in the calls to the distance function
+   * for the points in the leaves of the tree.  This can be reduced if \e
+   * distfun_t provides either or both of the following optional member
+   * functions (which Search() and SearchBatch() use if they are present):
+   * - <code>dist_t LowerBound(const pos_t& a, const pos_t& b) const</code>
+   *   returns a cheap lower bound on the distance between \e a and \e b.
+   *   The points of a leaf whose lower bound exceeds the distance to the
+   *   <i>k</i>th closest point found so far are rejected without computing
+   *   their distances.
+   * - <code>void Batch(const std::vector<pos_t>& pts, const int index[], int
+   *   n, const pos_t& query, dist_t d[]) const</code> sets
+   *   <i>d</i><sub><i>i</i></sub> to the distance between
+   *   <i>pts</i>[<i>index</i><sub><i>i</i></sub>] and \e query for \e i in
+   *   [0, \e n).  This is called once for the points in each leaf which
+   *   aren't rejected by LowerBound (instead of calling the distance
+   *   function for each point), so that the distances can be computed
+   *   together, e.g., with Geodesic::InverseBatch.
+   * .
+   * The results of the searches are the same whether or not these are
+   * provided (provided that LowerBound does return a lower bound and Batch
+   * returns the same distances as the distance function).  The cost of a
+   * search counts the distances computed; LowerBound isn't counted.  For
+   * geodesic distances, a suitable lower bound is \e b &psi;, where \e b
+   * is the polar semi-axis and &psi; is the angle between the geocentric
+   * position vectors of the points.  (The radial projection of a geodesic
+   * onto the sphere of radius \e b doesn't increase its length and the
+   * distance between the points on this sphere is \e b &psi;.)  E.g.,
+   * \code
+   * // pos_t holds the geographic coordinates and the geocentric unit vector
+   * struct pos { double lat, lon, u[3]; };
+   * class dist {
+   *   const Geodesic& g;
+   * public:
+   *   explicit dist(const Geodesic& g) : g(g) {}
+   *   double operator()(const pos& a, const pos& b) const {
+   *     double s12; g.Inverse(a.lat, a.lon, b.lat, b.lon, s12); return s12;
+   *   }
+   *   double LowerBound(const pos& a, const pos& b) const {
+   *     double c[3] = { a.u[1] * b.u[2] - a.u[2] * b.u[1],
+   *                     a.u[2] * b.u[0] - a.u[0] * b.u[2],
+   *                     a.u[0] * b.u[1] - a.u[1] * b.u[0] };
+   *     double psi = atan2(hypot(hypot(c[0], c[1]), c[2]),
+   *                        a.u[0] * b.u[0] + a.u[1] * b.u[1] +
+   *                        a.u[2] * b.u[2]);
+   *     // Allow for roundoff
+   *     return (1 - 1e-12) * g.EquatorialRadius() * (1 - g.Flattening()) *
+   *       psi;
+   *   }
+   *   void Batch(const std::vector<pos>& pts, const int index[], int n,
+   *              const pos& q, double d[]) const {
+   *     double lat1[10], lon1[10], lat2[10], lon2[10];
+   *     for (int i = 0; i < n; ++i) {
+   *       lat1[i] = pts[index[i]].lat; lon1[i] = pts[index[i]].lon;
+   *       lat2[i] = q.lat; lon2[i] = q.lon;
+   *     }
+   *     g.InverseBatch(n, lat1, lon1, lat2, lon2, Geodesic::DISTANCE,
+   *                    nullptr, d, nullptr, nullptr,
+   *                    nullptr, nullptr, nullptr, nullptr);
+   *   }
+   * };
+   * \endcode
+   * Here \e n is at most the \e bucket size given to the constructor
+   * (which is at most 10 for doubles).
+   *
+   * Points can be added to the set with Insert() and removed with Remove().
+   * These update the tree in place, rebuilding only the subtrees which become
+   * unbalanced, so that the cost of a search stays close to that for a tree
+   * constructed from scratch by Initialize().
    *
    * Because of the overhead in constructing a NearestNeighbor object for a
    * large set of points, functions Save() and Load() are provided to save the
@@ -103,6 +177,8 @@ namespace GeographicLib {
   class NearestNeighbor {
     // For tracking changes to the I/O format
     static const int version = 1;
+    // The size of the header for SaveMapped; the nodes follow this
+    static const int mapheader = 64;
     // This is what we get "free"; but if sizeof(dist_t) = 1 (unlikely), allow
     // 4 slots (and this accommodates the default value bucket = 4).
     static const int maxbucket =
@@ -115,7 +191,9 @@ namespace GeographicLib {
      *
      * This is equivalent to specifying an empty set of points.
      **********************************************************************/
-    NearestNeighbor() : _numpoints(0), _bucket(0), _cost(0) {}
+    NearestNeighbor()
+      : _numpoints(0), _bucket(0), _cost(0), _view(nullptr), _nview(0)
+      , _garbage(0) {}
 
     /**
      * Constructor for NearestNeighbor.
@@ -124,6 +202,8 @@ namespace GeographicLib {
      * @param[in] dist the distance function object.
      * @param[in] bucket the size of the buckets at the leaf nodes; this must
      *   lie in [0, 2 + 4*sizeof(dist_t)/sizeof(int)] (default 4).
+     * @param[in] nthreads the number of threads to use to construct the tree
+     *   (default 1); if this is 0, use std::thread::hardware_concurrency().
      * @exception GeographicErr if the value of \e bucket is out of bounds or
      *   the size of \e pts is too big for an int.
      * @exception std::bad_alloc if memory for the tree can't be allocated.
@@ -143,12 +223,19 @@ namespace GeographicLib {
      * in \e pts nor the query points should contain NaNs or infinities because
      * such data violates the metric conditions.
      *
+     * With \e nthreads &gt; 1, the two subtrees of the nodes near the root
+     * of the tree are constructed concurrently and the distances from the
+     * vantage points of these nodes are computed in parallel.  In this case,
+     * \e dist must be safe to call concurrently from several threads (as is
+     * the case for Geodesic::Inverse).  The resulting tree is the same for
+     * any value of \e nthreads.
+     *
      * \warning The same arguments \e pts and \e dist must be provided
      * to the Search() function.
      **********************************************************************/
     NearestNeighbor(const std::vector<pos_t>& pts, const distfun_t& dist,
-                    int bucket = 4) {
-      Initialize(pts, dist, bucket);
+                    int bucket = 4, unsigned nthreads = 1) {
+      Initialize(pts, dist, bucket, nthreads);
     }
 
     /**
@@ -158,6 +245,8 @@ namespace GeographicLib {
      * @param[in] dist the distance function object.
      * @param[in] bucket the size of the buckets at the leaf nodes; this must
      *   lie in [0, 2 + 4*sizeof(dist_t)/sizeof(int)] (default 4).
+     * @param[in] nthreads the number of threads to use to construct the tree
+     *   (default 1); if this is 0, use std::thread::hardware_concurrency().
      * @exception GeographicErr if the value of \e bucket is out of bounds or
      *   the size of \e pts is too big for an int.
      * @exception std::bad_alloc if memory for the tree can't be allocated.
@@ -168,7 +257,7 @@ namespace GeographicLib {
      * unchanged.
      **********************************************************************/
     void Initialize(const std::vector<pos_t>& pts, const distfun_t& dist,
-                    int bucket = 4) {
+                    int bucket = 4, unsigned nthreads = 1) {
       static_assert(std::numeric_limits<dist_t>::is_signed,
                     "dist_t must be a signed type");
       if (!( 0 <= bucket && bucket <= maxbucket ))
@@ -180,16 +269,22 @@ namespace GeographicLib {
       std::vector<item> ids(pts.size());
       for (int k = int(ids.size()); k--;)
         ids[k] = std::make_pair(dist_t(0), k);
-      int cost = 0;
-      std::vector<Node> tree;
-      init(pts, dist, bucket, tree, ids, cost,
-           0, int(ids.size()), int(ids.size()/2));
+      if (nthreads == 0)
+        nthreads = GeographicLib::GeodesicBatchExecutor::Concurrency();
+      // The nodes are stored in post-order; the position of every node is
+      // determined by the sizes of the subtrees, which allows the subtrees to
+      // be filled in concurrently.
+      std::vector<Node> tree(nodecount(int(ids.size()), bucket));
+      int cost = init(pts, dist, bucket, tree, ids,
+                      0, int(ids.size()), int(ids.size()/2), 0, nthreads);
+      preorder(tree);
       _tree.swap(tree);
+      _view = nullptr; _nview = 0;
       _numpoints = int(pts.size());
       _bucket = bucket;
-      _mc = _sc = 0;
-      _cost = cost; _c1 = _k = _cmax = 0;
-      _cmin = std::numeric_limits<int>::max();
+      _cost = cost;
+      clearindex();
+      ResetStatistics();
     }
 
     /**
@@ -247,6 +342,9 @@ namespace GeographicLib {
      * The distances to other points (indexed by <i>ind</i><sub><i>j</i></sub>
      * for \e j > 0) can be found by invoking \e dist again.
      *
+     * Search() may be called concurrently from several threads provided
+     * that \e dist is safe to call concurrently.
+     *
      * \warning The arguments \e pts and \e dist must be identical to those
      * used to initialize the NearestNeighbor; if not, this function will
      * return some meaningless result (however, if the size of \e pts is wrong,
@@ -265,88 +363,260 @@ namespace GeographicLib {
                   dist_t tol = 0) const {
       if (_numpoints != int(pts.size()))
           throw GeographicLib::GeographicErr("pts array has wrong size");
-      std::priority_queue<item> results;
-      if (_numpoints > 0 && k > 0 && maxdist > mindist) {
-        // distance to the kth closest point so far
-        dist_t tau = maxdist;
-        // first is negative of how far query is outside boundary of node
-        // +1 if on boundary or inside
-        // second is node index
-        std::priority_queue<item> todo;
-        todo.push(std::make_pair(dist_t(1), int(_tree.size()) - 1));
-        int c = 0;
-        while (!todo.empty()) {
-          int n = todo.top().second;
-          dist_t d = -todo.top().first;
-          todo.pop();
-          dist_t tau1 = tau - tol;
-          // compare tau and d again since tau may have become smaller.
-          if (!( n >= 0 && tau1 >= d )) continue;
-          const Node& current = _tree[n];
-          dist_t dst = 0;   // to suppress warning about uninitialized variable
-          bool exitflag = false, leaf = current.index < 0;
-          for (int i = 0; i < (leaf ? _bucket : 1); ++i) {
-            int index = leaf ? current.leaves[i] : current.index;
-            if (index < 0) break;
-            dst = dist(pts[index], query);
-            ++c;
+      stats st;
+      dist_t d = search(pts, dist, query, ind, k, maxdist, mindist,
+                        exhaustive, tol, st);
+      std::lock_guard<std::mutex> lock(_statslock.m);
+      _stats.add(st);
+      return d;
+    }
 
-            if (dst > mindist && dst <= tau) {
-              if (int(results.size()) == k) results.pop();
-              results.push(std::make_pair(dst, index));
-              if (int(results.size()) == k) {
-                if (exhaustive)
-                  tau = results.top().first;
-                else {
-                  exitflag = true;
-                  break;
-                }
-                if (tau <= tol) {
-                  exitflag = true;
-                  break;
-                }
-              }
-            }
-          }
-          if (exitflag) break;
+    /**
+     * Search the NearestNeighbor for many query points.
+     *
+     * @param[in] pts the vector of points used for initialization.
+     * @param[in] dist the distance function object used for initialization.
+     * @param[in] queries the query points.
+     * @param[out] ind a vector of vectors of indices;
+     *   <i>ind</i><sub><i>j</i></sub> holds the indices of the closest points
+     *   to <i>queries</i><sub><i>j</i></sub>.
+     * @param[out] d a vector of the closest distances;
+     *   <i>d</i><sub><i>j</i></sub> is the value returned by Search() for
+     *   <i>queries</i><sub><i>j</i></sub>.
+     * @param[in] k search for the \e k closest points to each query point.
+     * @param[in] maxdist only return points with distances of \e maxdist or
+     *   less from the query point.
+     * @param[in] mindist only return points with distances of more than
+     *   \e mindist from the query point.
+     * @param[in] exhaustive whether to do an exhaustive search (default true).
+     * @param[in] tol the tolerance on the results (default 0).
+     * @param[in] nthreads the number of threads to use (default 1); if this is
+     *   0, use std::thread::hardware_concurrency().
+     * @exception GeographicErr if \e pts has a size different from that used
+     *   to construct the object.
+     * @exception std::bad_alloc if memory for the results can't be allocated.
+     *
+     * This is equivalent to calling Search() for each query point in turn,
+     * with the arguments \e k, \e maxdist, \e mindist, \e exhaustive, and
+     * \e tol applying to all the queries.  The queries are handed out to the
+     * threads in small blocks of consecutive query points; so if nearby query
+     * points are adjacent in \e queries, each thread searches the same parts
+     * of the tree repeatedly.  (For points on the earth, the queries can be
+     * arranged in this way with GeodesicBatchExecutor::HilbertOrder.)  The
+     * search statistics are accumulated separately by each thread and
+     * combined at the end.  \e dist must be safe to call concurrently from
+     * several threads.  An exception thrown by \e dist is rethrown on the
+     * calling thread.
+     **********************************************************************/
+    void SearchBatch(const std::vector<pos_t>& pts, const distfun_t& dist,
+                     const std::vector<pos_t>& queries,
+                     std::vector<std::vector<int>>& ind,
+                     std::vector<dist_t>& d,
+                     int k = 1,
+                     dist_t maxdist = std::numeric_limits<dist_t>::max(),
+                     dist_t mindist = -1,
+                     bool exhaustive = true,
+                     dist_t tol = 0,
+                     unsigned nthreads = 1) const {
+      if (_numpoints != int(pts.size()))
+          throw GeographicLib::GeographicErr("pts array has wrong size");
+      int n = int(queries.size());
+      ind.resize(n);
+      d.resize(n);
+      if (nthreads == 0)
+        nthreads = GeographicLib::GeodesicBatchExecutor::Concurrency();
+      nthreads = unsigned(std::max(1, std::min(int(nthreads),
+                                               (n + batchblock - 1) /
+                                               batchblock)));
+      std::vector<stats> st(nthreads);
+      std::atomic<int> next(0);
+      parallel(nthreads,
+               [this, &pts, &dist, &queries, &ind, &d, &st, &next, n,
+                k, maxdist, mindist, exhaustive, tol]
+               (unsigned t) -> void {
+                 for (int j0; (j0 = next.fetch_add(batchblock)) < n;) {
+                   int j1 = std::min(n, j0 + batchblock);
+                   for (int j = j0; j < j1; ++j)
+                     d[j] = search(pts, dist, queries[j], ind[j], k, maxdist,
+                                   mindist, exhaustive, tol, st[t]);
+                 }
+               });
+      std::lock_guard<std::mutex> lock(_statslock.m);
+      for (unsigned t = 0; t < nthreads; ++t)
+        _stats.add(st[t]);
+    }
 
-          if (current.index < 0) continue;
-          tau1 = tau - tol;
-          for (int l = 0; l < 2; ++l) {
-            if (current.data.child[l] >= 0 &&
-                dst + current.data.upper[l] >= mindist) {
-              if (dst < current.data.lower[l]) {
-                d = current.data.lower[l] - dst;
-                if (tau1 >= d)
-                  todo.push(std::make_pair(-d, current.data.child[l]));
-              } else if (dst > current.data.upper[l]) {
-                d = dst - current.data.upper[l];
-                if (tau1 >= d)
-                  todo.push(std::make_pair(-d, current.data.child[l]));
-              } else
-                todo.push(std::make_pair(dist_t(1), current.data.child[l]));
+    /**
+     * Visit the points within a given distance of a query point.
+     *
+     * @tparam visitor_t the type of a function object which is called with
+     *   the index of a point and its distance (type \e dist_t) from the
+     *   query point and which returns a bool.
+     * @param[in] pts the vector of points used for initialization.
+     * @param[in] dist the distance function object used for initialization.
+     * @param[in] query the query point.
+     * @param[in] visit the function object.
+     * @param[in] maxdist only visit points with distances of \e maxdist or
+     *   less from \e query.
+     * @param[in] mindist only visit points with distances of more than
+     *   \e mindist from \e query (default = &minus;1).
+     * @exception GeographicErr if \e pts has a different size from that used
+     *   to construct the object.
+     * @exception any exception thrown by \e visit.
+     * @return the number of points visited.
+     *
+     * <i>visit</i>(<i>i</i>, <i>d</i>) is called for each point
+     * <i>pts</i>[<i>i</i>] whose distance \e d from \e query is in (\e
+     * mindist, \e maxdist] as it is found; the points are not visited in
+     * order of distance.  If \e visit returns false, the search stops.
+     * This finds the same points as Search() with \e k =
+     * <i>pts</i>.size() and the same \e maxdist and \e mindist; but it
+     * doesn't store and sort the results, which is faster when there are
+     * many points within \e maxdist.  The tree is traversed depth first and
+     * the search statistics count this as a search.
+     *
+     * Visit() may be called concurrently from several threads provided that
+     * \e dist is safe to call concurrently.  \e visit may call Search() or
+     * Visit().
+     **********************************************************************/
+    template<class visitor_t>
+    int Visit(const std::vector<pos_t>& pts, const distfun_t& dist,
+              const pos_t& query, const visitor_t& visit,
+              dist_t maxdist, dist_t mindist = -1) const {
+      if (_numpoints != int(pts.size()))
+          throw GeographicLib::GeographicErr("pts array has wrong size");
+      const Node* tree = nodes();
+      if (!(treesize() > 0 && maxdist > mindist)) return 0;
+      // The stack of nodes to visit (the first member is unused).
+      scratch work;
+      std::vector<item>& todo = work.todo;
+      todo.push_back(std::make_pair(dist_t(0), 0)); // the root
+      int c = 0, num = 0;
+      bool stop = false;
+      while (!todo.empty() && !stop) {
+        const Node& current = tree[todo.back().second];
+        todo.pop_back();
+        int cand[maxbucket];
+        dist_t dcand[maxbucket], dst = 0;
+        int m = candidates(pts, dist, current, query, maxdist, cand, dcand);
+        for (int i = 0; i < m; ++i) {
+          dst = hasbatch::value ? dcand[i] : dist(pts[cand[i]], query);
+          ++c;
+          if (dst > mindist && dst <= maxdist) {
+            ++num;
+            if (!visit(cand[i], dst)) {
+              stop = true;
+              break;
             }
           }
         }
-        ++_k;
-        _c1 += c;
-        double omc = _mc;
-        _mc += (c - omc) / _k;
-        _sc += (c - omc) * (c - _mc);
-        if (c > _cmax) _cmax = c;
-        if (c < _cmin) _cmin = c;
+        if (stop || current.index < 0) continue;
+        for (int l = 0; l < 2; ++l) {
+          if (current.data.child[l] >= 0 &&
+              dst + current.data.upper[l] >= mindist &&
+              current.data.lower[l] - dst <= maxdist &&
+              dst - current.data.upper[l] <= maxdist)
+            todo.push_back(std::make_pair(dist_t(0), current.data.child[l]));
+        }
       }
+      {
+        std::lock_guard<std::mutex> lock(_statslock.m);
+        _stats.add(c);
+      }
+#if GEOGRAPHICLIB_INSTRUMENT
+      _costs.Add(Histogram::Log2Bin(c));
+#endif
+      return num;
+    }
 
-      dist_t d = -1;
-      ind.resize(results.size());
-
-      for (int i = int(ind.size()); i--;) {
-        ind[i] = int(results.top().second);
-        if (i == 0) d = results.top().first;
-        results.pop();
+    /**
+     * Add points to the NearestNeighbor.
+     *
+     * @param[in] pts the vector of points used for initialization with new
+     *   points appended to it.
+     * @param[in] dist the distance function object used for initialization.
+     * @exception GeographicErr if \e pts is smaller than the vector used
+     *   previously or is too big.
+     * @exception std::bad_alloc if memory for the tree can't be allocated.
+     *
+     * The points with indices from the number of points previously used up to
+     * <i>pts</i>.size() &minus; 1 are added to the tree.  Each point is put
+     * in a leaf of the tree, splitting the leaf if it is full.  If this leaves
+     * a subtree unbalanced (one of the children of a node holds more than
+     * three quarters of its points), that subtree is rebuilt.  The amortized
+     * cost of an insertion is proportional to log(<i>pts</i>.size()).  The
+     * cost of inserting the points is added to the setup cost reported by
+     * Statistics().
+     *
+     * Subsequently, this extended vector of points must be provided to the
+     * Search() function.
+     *
+     * \warning This may not be called concurrently with Search().
+     **********************************************************************/
+    void Insert(const std::vector<pos_t>& pts, const distfun_t& dist) {
+      if (pts.size() < size_t(_numpoints))
+        throw GeographicLib::GeographicErr("pts array is too small");
+      if (pts.size() > size_t(std::numeric_limits<int>::max()))
+        throw GeographicLib::GeographicErr("pts array too big");
+      own();
+      buildindex();
+      int num = int(pts.size());
+      _where.resize(num, -1);
+      for (int i = _numpoints; i < num; ++i) {
+        _numpoints = i + 1;
+        insert(pts, dist, i);
       }
-      return d;
+      compact();
+    }
 
+    /**
+     * Remove a point from the NearestNeighbor.
+     *
+     * @param[in] pts the vector of points used for initialization.
+     * @param[in] dist the distance function object used for initialization.
+     * @param[in] i the index of the point to remove.
+     * @exception GeographicErr if \e pts has a size different from that used
+     *   to construct the object or if point \e i is not in the tree.
+     * @exception std::bad_alloc if memory for the tree can't be allocated.
+     *
+     * A point in a leaf of the tree is simply removed from it.  Removing a
+     * vantage point requires the subtree below it to be rebuilt; this is
+     * usually a small subtree.  Subtrees which become unbalanced are also
+     * rebuilt.  The indices of the other points are unchanged; so
+     * <i>pts</i><sub><i>i</i></sub> must be kept in \e pts (its value is no
+     * longer used).  Search() will no longer return \e i.  The cost of
+     * removing the point is added to the setup cost reported by Statistics().
+     *
+     * \warning This may not be called concurrently with Search().
+     **********************************************************************/
+    void Remove(const std::vector<pos_t>& pts, const distfun_t& dist, int i) {
+      if (_numpoints != int(pts.size()))
+          throw GeographicLib::GeographicErr("pts array has wrong size");
+      own();
+      buildindex();
+      if (!( 0 <= i && i < _numpoints && _where[i] >= 0 ))
+        throw GeographicLib::GeographicErr("Point is not in the tree");
+      int n = _where[i];
+      Node& node = _tree[n];
+      if (node.index < 0 && ownpoints(node) > 1) {
+        // Remove the point from the leaf, keeping the others at the start
+        int j = 0;
+        while (node.leaves[j] != i) ++j;
+        for (; j < _bucket - 1; ++j)
+          node.leaves[j] = node.leaves[j + 1];
+        node.leaves[_bucket - 1] = -1;
+        _where[i] = -1;
+        for (int m = n; m >= 0; m = _parent[m])
+          --_size[m];
+        rebalance(pts, dist, n);
+      } else {
+        // Rebuild the subtree without the point
+        int p = _parent[n];
+        rebuild(pts, dist, n, -1, i);
+        _where[i] = -1;
+        if (p >= 0) rebalance(pts, dist, p);
+      }
+      compact();
     }
 
     /**
@@ -354,6 +624,21 @@ namespace GeographicLib {
      **********************************************************************/
     int NumPoints() const { return _numpoints; }
 
+    /**
+     * @return the number of bytes of memory held by the object.
+     *
+     * This is the tree and the indices used by Insert and Remove.  It doesn't
+     * include the points (which are held by the caller) or the nodes
+     * supplied to LoadMapped.  The cost of a search depends on the
+     * distribution of the points and the queries; it is measured by
+     * Statistics.
+     **********************************************************************/
+    size_t MemoryUsage() const {
+      return sizeof(*this) + _tree.capacity() * sizeof(Node) +
+        (_parent.capacity() + _size.capacity() + _where.capacity()) *
+        sizeof(int);
+    }
+
     /**
      * Write the object to an I/O stream.
      *
@@ -374,6 +659,8 @@ namespace GeographicLib {
     void Save(std::ostream& os, bool bin = true) const {
       int realspec = std::numeric_limits<dist_t>::digits *
         (std::numeric_limits<dist_t>::is_integer ? -1 : 1);
+      // The nodes are saved in post-order (the root is last)
+      std::vector<Node> tree(postorder());
       if (bin) {
         char id[] = "NearestNeighbor_";
         os.write(id, 16);
@@ -382,11 +669,11 @@ namespace GeographicLib {
         buf[1] = realspec;
         buf[2] = _bucket;
         buf[3] = _numpoints;
-        buf[4] = int(_tree.size());
+        buf[4] = int(tree.size());
         buf[5] = _cost;
         os.write(reinterpret_cast<const char *>(buf), 6 * sizeof(int));
-        for (int i = 0; i < int(_tree.size()); ++i) {
-          const Node& node = _tree[i];
+        for (int i = 0; i < int(tree.size()); ++i) {
+          const Node& node = tree[i];
           os.write(reinterpret_cast<const char *>(&node.index), sizeof(int));
           if (node.index >= 0) {
             os.write(reinterpret_cast<const char *>(node.data.lower),
@@ -411,9 +698,9 @@ namespace GeographicLib {
           ostring.precision(prec);
         }
         ostring << version << " " << realspec << " " << _bucket << " "
-                << _numpoints << " " << _tree.size() << " " << _cost;
-        for (int i = 0; i < int(_tree.size()); ++i) {
-          const Node& node = _tree[i];
+                << _numpoints << " " << tree.size() << " " << _cost;
+        for (int i = 0; i < int(tree.size()); ++i) {
+          const Node& node = tree[i];
           ostring << "\n" << node.index;
           if (node.index >= 0) {
             for (int l = 0; l < 2; ++l)
@@ -522,12 +809,123 @@ namespace GeographicLib {
         node.Check(numpoints, treesize, bucket);
         tree.push_back(node);
       }
+      preorder(tree);
       _tree.swap(tree);
+      _view = nullptr; _nview = 0;
       _numpoints = numpoints;
       _bucket = bucket;
-      _mc = _sc = 0;
-      _cost = cost; _c1 = _k = _cmax = 0;
-      _cmin = std::numeric_limits<int>::max();
+      _cost = cost;
+      clearindex();
+      ResetStatistics();
+    }
+
+    /**
+     * Write the object to an I/O stream in a format which can be searched in
+     * place.
+     *
+     * @param[in,out] os the stream to write to.
+     * @exception std::bad_alloc if memory for the tree can't be allocated.
+     *
+     * This writes a 64-byte header followed by the nodes of the tree exactly
+     * as they are laid out in memory.  The resulting file can be mapped into
+     * memory (with mmap on POSIX systems or MapViewOfFile on Windows) and
+     * passed to LoadMapped(), which searches the tree without copying it.  The
+     * data can only be used on a machine with the same architecture.
+     **********************************************************************/
+    void SaveMapped(std::ostream& os) const {
+      std::vector<Node> tree;
+      const Node* t = nodes();
+      int n = treesize();
+      if (_garbage > 0) {
+        // Drop the nodes orphaned by Insert and Remove
+        tree = postorder();
+        preorder(tree);
+        t = tree.data(); n = int(tree.size());
+      }
+      char head[mapheader];
+      std::memset(head, 0, mapheader);
+      std::memcpy(head, "NearestNeighborM", 16);
+      int buf[8];
+      buf[0] = version;
+      buf[1] = std::numeric_limits<dist_t>::digits *
+        (std::numeric_limits<dist_t>::is_integer ? -1 : 1);
+      buf[2] = _bucket;
+      buf[3] = _numpoints;
+      buf[4] = n;
+      buf[5] = _cost;
+      buf[6] = int(sizeof(Node));
+      buf[7] = byteorder;
+      std::memcpy(head + 16, buf, sizeof(buf));
+      os.write(head, mapheader);
+      os.write(reinterpret_cast<const char *>(t), n * sizeof(Node));
+    }
+
+    /**
+     * Use data written by SaveMapped() in place.
+     *
+     * @param[in] data a pointer to the data.
+     * @param[in] size the size of the data in bytes.
+     * @param[in] check whether to check the nodes of the tree (default true).
+     * @exception GeographicErr if the data is illegal or \e data is not
+     *   suitably aligned.
+     *
+     * Typically \e data is the start of a memory mapping of a file written by
+     * SaveMapped(); e.g., SphericalEngine::mappedfile can be used to map the
+     * file.  The tree is not copied, so Search() reads the nodes directly from
+     * the mapped memory.  Only the pages which are visited are read from the
+     * file and these are shared by all the processes mapping the file.  The
+     * memory must remain valid, and unchanged, while the NearestNeighbor (or
+     * a copy of it) uses it.  If Insert() or Remove() is called, the nodes
+     * are first copied into the NearestNeighbor.
+     *
+     * If \e check is true, all the nodes are checked, which reads the whole
+     * file; a file which is known to be valid can be used without reading it
+     * by setting \e check = false.  The counters tracking the statistics of
+     * searches are reset by this operation.  If an exception is thrown, the
+     * state of the NearestNeighbor is unchanged.
+     **********************************************************************/
+    void LoadMapped(const char* data, size_t size, bool check = true) {
+      if (!( size >= size_t(mapheader) &&
+             std::memcmp(data, "NearestNeighborM", 16) == 0 ))
+        throw GeographicLib::GeographicErr("Bad ID");
+      if (reinterpret_cast<std::uintptr_t>(data) % alignof(Node) != 0)
+        throw GeographicLib::GeographicErr("Data is not aligned");
+      int buf[8];
+      std::memcpy(buf, data + 16, sizeof(buf));
+      int version1 = buf[0], realspec = buf[1], bucket = buf[2],
+        numpoints = buf[3], treesize = buf[4], cost = buf[5];
+      if (!( version1 == version && buf[6] == int(sizeof(Node)) &&
+             buf[7] == byteorder ))
+        throw GeographicLib::GeographicErr("Incompatible version");
+      if (!( realspec == std::numeric_limits<dist_t>::digits *
+             (std::numeric_limits<dist_t>::is_integer ? -1 : 1) ))
+        throw GeographicLib::GeographicErr("Different dist_t types");
+      if (!( 0 <= bucket && bucket <= maxbucket ))
+        throw GeographicLib::GeographicErr("Bad bucket size");
+      if (!( 0 <= treesize && treesize <= numpoints &&
+             size - mapheader == size_t(treesize) * sizeof(Node) ))
+        throw
+          GeographicLib::GeographicErr("Bad number of points or tree size");
+      if (!( 0 <= cost ))
+        throw GeographicLib::GeographicErr("Bad value for cost");
+      const Node* tree = reinterpret_cast<const Node*>(data + mapheader);
+      if (check) {
+        for (int i = 0; i < treesize; ++i) {
+          tree[i].Check(numpoints, treesize, bucket);
+          // In pre-order, children follow their parents
+          if (tree[i].index >= 0)
+            for (int l = 0; l < 2; ++l)
+              if (!( tree[i].data.child[l] < 0 || tree[i].data.child[l] > i ))
+                throw GeographicLib::GeographicErr("Bad tree structure");
+        }
+      }
+      _tree.clear();
+      _view = tree; _nview = treesize;
+      _numpoints = numpoints;
+      _bucket = bucket;
+      _cost = cost;
+      clearindex();
+      ResetStatistics();
     }
 
     /**
@@ -562,12 +960,16 @@ namespace GeographicLib {
       std::swap(_bucket, t._bucket);
       std::swap(_cost, t._cost);
       _tree.swap(t._tree);
-      std::swap(_mc, t._mc);
-      std::swap(_sc, t._sc);
-      std::swap(_c1, t._c1);
-      std::swap(_k, t._k);
-      std::swap(_cmin, t._cmin);
-      std::swap(_cmax, t._cmax);
+      std::swap(_view, t._view);
+      std::swap(_nview, t._nview);
+      std::swap(_stats, t._stats);
+#if GEOGRAPHICLIB_INSTRUMENT
+      std::swap(_costs, t._costs);
+#endif
+      _parent.swap(t._parent);
+      _size.swap(t._size);
+      _where.swap(t._where);
+      std::swap(_garbage, t._garbage);
     }
 
     /**
@@ -581,15 +983,17 @@ namespace GeographicLib {
      * @param[out] mean the mean cost of a Search().
      * @param[out] sd the standard deviation in the cost of a Search().
      *
-     * Here "cost" measures the number of distance calculations needed.  Note
-     * that the accumulation of statistics is \e not thread safe.
+     * Here "cost" measures the number of distance calculations needed.  The
+     * statistics are accumulated by Search() and SearchBatch() under a lock,
+     * so these may be called concurrently from several threads.
      **********************************************************************/
     void Statistics(int& setupcost, int& numsearches, int& searchcost,
                     int& mincost, int& maxcost,
                     double& mean, double& sd) const {
-      setupcost = _cost; numsearches = _k; searchcost = _c1;
-      mincost = _cmin; maxcost = _cmax;
-      mean = _mc; sd = std::sqrt(_sc / (_k - 1));
+      std::lock_guard<std::mutex> lock(_statslock.m);
+      setupcost = _cost; numsearches = _stats.k; searchcost = _stats.c1;
+      mincost = _stats.cmin; maxcost = _stats.cmax;
+      mean = _stats.mc; sd = std::sqrt(_stats.sc / (_stats.k - 1));
     }
 
     /**
@@ -597,15 +1001,61 @@ namespace GeographicLib {
      * far.
      **********************************************************************/
     void ResetStatistics() const {
-      _mc = _sc = 0;
-      _c1 = _k = _cmax = 0;
-      _cmin = std::numeric_limits<int>::max();
+      std::lock_guard<std::mutex> lock(_statslock.m);
+      _stats = stats();
+#if GEOGRAPHICLIB_INSTRUMENT
+      _costs.Reset();
+#endif
     }
 
+#if GEOGRAPHICLIB_INSTRUMENT
+    /**
+     * @return a histogram of the costs of the searches (only if
+     *   GEOGRAPHICLIB_INSTRUMENT = 1).
+     *
+     * The bins are logarithmic: bin \e k counts the searches with costs in
+     * [2<sup>\e k&minus;1</sup>, 2<sup>\e k</sup>); see
+     * Histogram::Log2Bin.  This is reset by ResetStatistics().
+     **********************************************************************/
+    const Histogram& SearchCosts() const { return _costs; }
+#endif
+
   private:
     // Package up a dist_t and an int.  We will want to sort on the dist_t so
     // put it first.
     typedef std::pair<dist_t, int> item;
+
+    // Detect the optional members LowerBound and Batch of distfun_t.
+    template<class F> static auto lowerboundtest(int)
+      -> decltype(std::declval<const F&>().LowerBound
+                  (std::declval<const pos_t&>(), std::declval<const pos_t&>()),
+                  std::true_type());
+    template<class F> static std::false_type lowerboundtest(...);
+    template<class F> static auto batchtest(int)
+      -> decltype(std::declval<const F&>().Batch
+                  (std::declval<const std::vector<pos_t>&>(),
+                   std::declval<const int*>(), 0,
+                   std::declval<const pos_t&>(), std::declval<dist_t*>()),
+                  std::true_type());
+    template<class F> static std::false_type batchtest(...);
+    typedef decltype(lowerboundtest<distfun_t>(0)) haslowerbound;
+    typedef decltype(batchtest<distfun_t>(0)) hasbatch;
+    // Whether p can be rejected because it's farther than tau from query
+    static bool reject(const distfun_t& dist, const pos_t& p,
+                       const pos_t& query, dist_t tau, std::true_type)
+    { return dist.LowerBound(p, query) > tau; }
+    static bool reject(const distfun_t&, const pos_t&, const pos_t&, dist_t,
+                       std::false_type)
+    { return false; }
+    // Set d[i] to the distance between pts[index[i]] and query
+    static void batch(const std::vector<pos_t>& pts, const distfun_t& dist,
+                      const int index[], int n, const pos_t& query,
+                      dist_t d[], std::true_type)
+    { if (n > 0) dist.Batch(pts, index, n, query, d); }
+    static void batch(const std::vector<pos_t>&, const distfun_t&,
+                      const int[], int, const pos_t&, dist_t[],
+                      std::false_type)
+    {}
     // \cond SKIP
     class Node {
     public:
@@ -700,8 +1150,9 @@ namespace GeographicLib {
         & boost::serialization::make_nvp("realspec", realspec)
         & boost::serialization::make_nvp("bucket", _bucket)
         & boost::serialization::make_nvp("numpoints", _numpoints)
-        & boost::serialization::make_nvp("cost", _cost)
-        & boost::serialization::make_nvp("tree", _tree);
+        & boost::serialization::make_nvp("cost", _cost);
+      std::vector<Node> tree(postorder());
+      ar & boost::serialization::make_nvp("tree", tree);
     }
     template<class Archive> void load(Archive& ar, const unsigned) {
       int version1, realspec, bucket, numpoints, cost;
@@ -724,12 +1175,14 @@ namespace GeographicLib {
           GeographicLib::GeographicErr("Bad number of points or tree size");
       for (int i = 0; i < int(tree.size()); ++i)
         tree[i].Check(numpoints, int(tree.size()), bucket);
+      preorder(tree);
       _tree.swap(tree);
+      _view = nullptr; _nview = 0;
       _numpoints = numpoints;
       _bucket = bucket;
-      _mc = _sc = 0;
-      _cost = cost; _c1 = _k = _cmax = 0;
-      _cmin = std::numeric_limits<int>::max();
+      _cost = cost;
+      clearindex();
+      ResetStatistics();
     }
     template<class Archive>
     void serialize(Archive& ar, const unsigned int file_version)
@@ -737,18 +1190,334 @@ namespace GeographicLib {
 #endif
 
     int _numpoints, _bucket, _cost;
+    // The nodes in pre-order, i.e., each node is followed by its first
+    // subtree and then its second subtree.  A search descends from the root
+    // (the first node) so this keeps the nodes that it visits close together
+    // in memory.
     std::vector<Node> _tree;
-    // Counters to track stastistics on the cost of searches
-    mutable double _mc, _sc;
-    mutable int _c1, _k, _cmin, _cmax;
+    // If non-null, the nodes are instead the _nview nodes at _view in memory
+    // supplied to LoadMapped.
+    const Node* _view;
+    int _nview;
+
+    const Node* nodes() const { return _view ? _view : _tree.data(); }
+    int treesize() const { return _view ? _nview : int(_tree.size()); }
+    // Copy the nodes of a view so that the tree can be modified
+    void own() {
+      if (!_view) return;
+      _tree.assign(_view, _view + _nview);
+      _view = nullptr; _nview = 0;
+    }
+    // Statistics on the cost of searches
+    struct stats {
+      double mc, sc;            // mean and sum of squared deviations
+      int c1, k, cmin, cmax;    // total cost, count, min and max costs
+      stats()
+        : mc(0), sc(0), c1(0), k(0)
+        , cmin(std::numeric_limits<int>::max()), cmax(0) {}
+      // Add the cost of one search
+      void add(int c) {
+        ++k;
+        c1 += c;
+        double omc = mc;
+        mc += (c - omc) / k;
+        sc += (c - omc) * (c - mc);
+        if (c > cmax) cmax = c;
+        if (c < cmin) cmin = c;
+      }
+      // Combine with the statistics from another set of searches
+      void add(const stats& t) {
+        if (t.k == 0) return;
+        if (k == 0) { *this = t; return; }
+        int n = k + t.k;
+        double delta = t.mc - mc;
+        mc += delta * t.k / n;
+        sc += t.sc + delta * delta * (double(k) * t.k / n);
+        k = n;
+        c1 += t.c1;
+        cmin = std::min(cmin, t.cmin);
+        cmax = std::max(cmax, t.cmax);
+      }
+    };
+    // A mutex guarding _stats; copying a NearestNeighbor gives it a fresh
+    // mutex.
+    struct statsmutex {
+      std::mutex m;
+      statsmutex() {}
+      statsmutex(const statsmutex&) {}
+      statsmutex& operator=(const statsmutex&) { return *this; }
+    };
+    mutable stats _stats;
+    mutable statsmutex _statslock;
+#if GEOGRAPHICLIB_INSTRUMENT
+    mutable Histogram _costs;
+#endif
+    // Used by Insert and Remove; see buildindex
+    std::vector<int> _parent, _size, _where;
+    int _garbage;
+
+    // A marker for the byte order used by SaveMapped
+    static const int byteorder = 0x01020304;
+
+    // Heap operations on a vector; these match those of std::priority_queue.
+    static void push(std::vector<item>& heap, const item& x) {
+      heap.push_back(x);
+      std::push_heap(heap.begin(), heap.end());
+    }
+    static void pop(std::vector<item>& heap) {
+      std::pop_heap(heap.begin(), heap.end());
+      heap.pop_back();
+    }
+
+    // Scratch space for Search.  The vectors for the thread are reused,
+    // unless they are in use (because dist calls Search recursively); in
+    // that case fresh vectors are used.
+    class scratch {
+    private:
+      struct buffers {
+        std::vector<item> todo, results;
+        bool busy;
+        buffers() : busy(false) {}
+      };
+      static buffers& local() {
+        static thread_local buffers b;
+        return b;
+      }
+      std::vector<item> _todo, _results;
+      bool _reuse;
+    public:
+      std::vector<item>& todo;
+      std::vector<item>& results;
+      scratch()
+        : _reuse(!local().busy)
+        , todo(_reuse ? local().todo : _todo)
+        , results(_reuse ? local().results : _results) {
+        if (_reuse) {
+          local().busy = true;
+          todo.clear(); results.clear();
+        }
+      }
+      ~scratch() { if (_reuse) local().busy = false; }
+    };
+
+    // Renumber the nodes of tree, which are in post-order, in pre-order.
+    static void preorder(std::vector<Node>& tree) {
+      int n = int(tree.size());
+      if (n == 0) return;
+      std::vector<int> order, newind(n, -1), stack(1, n - 1);
+      order.reserve(n);
+      while (!stack.empty()) {
+        int i = stack.back();
+        stack.pop_back();
+        if (newind[i] >= 0)
+          throw GeographicLib::GeographicErr("Bad tree structure");
+        newind[i] = int(order.size());
+        order.push_back(i);
+        const Node& node = tree[i];
+        if (node.index < 0) continue;
+        for (int l = 2; l--;)
+          if (node.data.child[l] >= 0) stack.push_back(node.data.child[l]);
+      }
+      if (int(order.size()) != n)
+        throw GeographicLib::GeographicErr("Bad tree structure");
+      std::vector<Node> t(n);
+      for (int i = 0; i < n; ++i) {
+        t[i] = tree[order[i]];
+        if (t[i].index >= 0)
+          for (int l = 0; l < 2; ++l)
+            if (t[i].data.child[l] >= 0)
+              t[i].data.child[l] = newind[t[i].data.child[l]];
+      }
+      tree.swap(t);
+    }
+
+    // Return the nodes reachable from the root in post-order, the inverse of
+    // preorder.
+    std::vector<Node> postorder() const {
+      const Node* tree = nodes();
+      int n = treesize();
+      std::vector<Node> t;
+      t.reserve(n);
+      if (n == 0) return t;
+      std::vector<int> newind(n);
+      // The stack holds node indices and the number of children visited
+      std::vector<std::pair<int, int>> stack(1, std::make_pair(0, 0));
+      while (!stack.empty()) {
+        std::pair<int, int>& top = stack.back();
+        const Node& node = tree[top.first];
+        if (node.index >= 0 && top.second < 2) {
+          int c = node.data.child[top.second++];
+          if (c >= 0) stack.push_back(std::make_pair(c, 0));
+        } else {
+          newind[top.first] = int(t.size());
+          t.push_back(node);
+          stack.pop_back();
+        }
+      }
+      for (int i = 0; i < int(t.size()); ++i)
+        if (t[i].index >= 0)
+          for (int l = 0; l < 2; ++l)
+            if (t[i].data.child[l] >= 0)
+              t[i].data.child[l] = newind[t[i].data.child[l]];
+      return t;
+    }
+
+    // The body of Search, accumulating the statistics in st.
+    dist_t search(const std::vector<pos_t>& pts, const distfun_t& dist,
+                  const pos_t& query, std::vector<int>& ind, int k,
+                  dist_t maxdist, dist_t mindist, bool exhaustive, dist_t tol,
+                  stats& st) const {
+      // The heaps are maintained with std::push_heap and std::pop_heap in
+      // per-thread scratch vectors so that searches don't allocate memory.
+      scratch work;
+      std::vector<item>& results = work.results;
+      const Node* tree = nodes();
+      if (treesize() > 0 && k > 0 && maxdist > mindist) {
+        // distance to the kth closest point so far
+        dist_t tau = maxdist;
+        // first is negative of how far query is outside boundary of node
+        // +1 if on boundary or inside
+        // second is node index
+        std::vector<item>& todo = work.todo;
+        push(todo, std::make_pair(dist_t(1), 0)); // the root
+        int c = 0;
+        while (!todo.empty()) {
+          int n = todo.front().second;
+          dist_t d = -todo.front().first;
+          pop(todo);
+          dist_t tau1 = tau - tol;
+          // compare tau and d again since tau may have become smaller.
+          if (!( n >= 0 && tau1 >= d )) continue;
+          const Node& current = tree[n];
+          dist_t dst = 0;   // to suppress warning about uninitialized variable
+          bool exitflag = false;
+          int cand[maxbucket];
+          dist_t dcand[maxbucket];
+          int m = candidates(pts, dist, current, query, tau, cand, dcand);
+          if (hasbatch::value) c += m;
+          for (int i = 0; i < m; ++i) {
+            int index = cand[i];
+            if (hasbatch::value)
+              dst = dcand[i];
+            else {
+              dst = dist(pts[index], query);
+              ++c;
+            }
+
+            if (dst > mindist && dst <= tau) {
+              if (int(results.size()) == k) pop(results);
+              push(results, std::make_pair(dst, index));
+              if (int(results.size()) == k) {
+                if (exhaustive)
+                  tau = results.front().first;
+                else {
+                  exitflag = true;
+                  break;
+                }
+                if (tau <= tol) {
+                  exitflag = true;
+                  break;
+                }
+              }
+            }
+          }
+          if (exitflag) break;
+
+          if (current.index < 0) continue;
+          tau1 = tau - tol;
+          for (int l = 0; l < 2; ++l) {
+            if (current.data.child[l] >= 0 &&
+                dst + current.data.upper[l] >= mindist) {
+              if (dst < current.data.lower[l]) {
+                d = current.data.lower[l] - dst;
+                if (tau1 >= d)
+                  push(todo, std::make_pair(-d, current.data.child[l]));
+              } else if (dst > current.data.upper[l]) {
+                d = dst - current.data.upper[l];
+                if (tau1 >= d)
+                  push(todo, std::make_pair(-d, current.data.child[l]));
+              } else
+                push(todo, std::make_pair(dist_t(1), current.data.child[l]));
+            }
+          }
+        }
+        st.add(c);
+#if GEOGRAPHICLIB_INSTRUMENT
+        _costs.Add(Histogram::Log2Bin(c));
+#endif
+      }
 
+      dist_t d = -1;
+      ind.resize(results.size());
+
+      for (int i = int(ind.size()); i--;) {
+        ind[i] = int(results.front().second);
+        if (i == 0) d = results.front().first;
+        pop(results);
+      }
+      return d;
+    }
+
+    // Put the points of node which are candidates for being within tau of
+    // query into cand and return their number; the points of a leaf are
+    // rejected if their lower bounds exceed tau.  (The vantage point of a
+    // node is always needed, because its distance determines which subtrees
+    // to search.)  If distfun_t has a Batch member, put the distances into
+    // dcand.
+    int candidates(const std::vector<pos_t>& pts, const distfun_t& dist,
+                   const Node& node, const pos_t& query, dist_t tau,
+                   int cand[], dist_t dcand[]) const {
+      bool leaf = node.index < 0;
+      int m = 0;
+      for (int i = 0; i < (leaf ? _bucket : 1); ++i) {
+        int index = leaf ? node.leaves[i] : node.index;
+        if (index < 0) break;
+        if (!(leaf && reject(dist, pts[index], query, tau, haslowerbound())))
+          cand[m++] = index;
+      }
+      batch(pts, dist, cand, m, query, dcand, hasbatch());
+      return m;
+    }
+
+    // Don't use threads for fewer points than this
+    static const int minparallel = 1024;
+    // The number of queries handed to a thread at a time by SearchBatch
+    static const int batchblock = 16;
+    // Don't check subtrees with fewer points than this for balance
+    static const int minrebalance = 32;
+
+    // The number of nodes in the tree for n points
+    static int nodecount(int n, int bucket) {
+      return n == 0 ? 0 : (n <= (bucket == 0 ? 1 : bucket) ? 1 :
+                           1 + nodecount((n + 1) / 2 - 1, bucket) +
+                           nodecount(n / 2, bucket));
+    }
+
+    // Call f(k) for k in [0, nthreads) with the scheduler set by
+    // GeodesicBatchExecutor::SetScheduler.  Rethrow the first exception
+    // thrown by f.
+    template<class F>
+    static void parallel(unsigned nthreads, const F& f) {
+      std::vector<std::exception_ptr> errs(nthreads);
+      GeographicLib::GeodesicBatchExecutor::Run
+        (nthreads, [&f, &errs](unsigned k) -> void {
+          try { f(k); } catch (...) { errs[k] = std::current_exception(); }
+        });
+      for (auto& e : errs)
+        if (e) std::rethrow_exception(e);
+    }
+
+    // Build the subtree for ids[l, u) with vantage point ids[vp] storing its
+    // nodes in tree[base, base + nodecount(u - l, bucket)).  Return the
+    // cost.
     int init(const std::vector<pos_t>& pts, const distfun_t& dist, int bucket,
-             std::vector<Node>& tree, std::vector<item>& ids, int& cost,
-             int l, int u, int vp) {
+             std::vector<Node>& tree, std::vector<item>& ids,
+             int l, int u, int vp, int base, unsigned nthreads) {
 
       if (u == l)
-        return -1;
+        return 0;
       Node node;
+      int cost = 0, pos = base;
 
       if (u - l > (bucket == 0 ? 1 : bucket)) {
 
@@ -758,33 +1527,73 @@ namespace GeographicLib {
 
         int m = (u + l + 1) / 2;
 
-        for (int k = l + 1; k < u; ++k) {
-          ids[k].first = dist(pts[ids[l].second], pts[ids[k].second]);
-          ++cost;
+        if (nthreads > 1 && u - l >= minparallel) {
+          // Split the distance calculations into nthreads chunks
+          const pos_t& p = pts[ids[l].second];
+          int n = u - l - 1;
+          parallel(nthreads,
+                   [&pts, &dist, &ids, &p, l, n, nthreads]
+                   (unsigned k) -> void {
+                     int
+                       k0 = l + 1 + int((long long)(n) * k / nthreads),
+                       k1 = l + 1 + int((long long)(n) * (k + 1) / nthreads);
+                     for (int j = k0; j < k1; ++j)
+                       ids[j].first = dist(p, pts[ids[j].second]);
+                   });
+          cost += n;
+        } else {
+          for (int k = l + 1; k < u; ++k) {
+            ids[k].first = dist(pts[ids[l].second], pts[ids[k].second]);
+            ++cost;
+          }
         }
         // partition around the median distance
         std::nth_element(ids.begin() + l + 1,
                          ids.begin() + m,
                          ids.begin() + u);
         node.index = ids[l].second;
+        // Use point with max distance as vantage point for the children;
+        // this point act as a "corner" point and leads to a good partition.
+        int vp0 = -1, base1 = base + nodecount(m - l - 1, bucket);
         if (m > l + 1) {        // node.child[0] is possibly empty
           typename std::vector<item>::iterator
             t = std::min_element(ids.begin() + l + 1, ids.begin() + m);
           node.data.lower[0] = t->first;
           t = std::max_element(ids.begin() + l + 1, ids.begin() + m);
           node.data.upper[0] = t->first;
-          // Use point with max distance as vantage point; this point act as a
-          // "corner" point and leads to a good partition.
-          node.data.child[0] = init(pts, dist, bucket, tree, ids, cost,
-                                    l + 1, m, int(t - ids.begin()));
+          node.data.child[0] = base1 - 1;
+          vp0 = int(t - ids.begin());
         }
         typename std::vector<item>::iterator
           t = std::max_element(ids.begin() + m, ids.begin() + u);
         node.data.lower[1] = ids[m].first;
         node.data.upper[1] = t->first;
-        // Use point with max distance as vantage point here too
-        node.data.child[1] = init(pts, dist, bucket, tree, ids, cost,
-                                  m, u, int(t - ids.begin()));
+        int vp1 = int(t - ids.begin());
+        node.data.child[1] = base1 + nodecount(u - m, bucket) - 1;
+        pos = node.data.child[1] + 1;
+        if (nthreads > 1 && m - l - 1 >= minparallel) {
+          // Build the subtrees concurrently, dividing up the threads
+          unsigned nthreads0 = nthreads / 2;
+          int cost0 = 0, cost1 = 0;
+          parallel(2,
+                   [this, &pts, &dist, bucket, &tree, &ids, l, m, u,
+                    vp0, vp1, base, base1, nthreads, nthreads0,
+                    &cost0, &cost1]
+                   (unsigned k) -> void {
+                     if (k)
+                       cost0 = init(pts, dist, bucket, tree, ids,
+                                    l + 1, m, vp0, base, nthreads0);
+                     else
+                       cost1 = init(pts, dist, bucket, tree, ids,
+                                    m, u, vp1, base1, nthreads - nthreads0);
+                   });
+          cost += cost0 + cost1;
+        } else {
+          if (m > l + 1)
+            cost += init(pts, dist, bucket, tree, ids,
+                         l + 1, m, vp0, base, 1);
+          cost += init(pts, dist, bucket, tree, ids, m, u, vp1, base1, 1);
+        }
       } else {
         if (bucket == 0)
           node.index = ids[l].second;
@@ -802,8 +1611,234 @@ namespace GeographicLib {
         }
       }
 
-      tree.push_back(node);
-      return int(tree.size()) - 1;
+      tree[pos] = node;
+      return cost;
+    }
+
+    // The following support Insert and Remove.  _parent and _size give the
+    // parent of each node and the number of points in the subtree rooted at
+    // it; _where gives the node holding each point (or -1 if the point has
+    // been removed).  These are only built when needed.  Nodes orphaned by
+    // rebuilding subtrees are counted in _garbage.
+
+    void clearindex() {
+      _parent.clear(); _size.clear(); _where.clear();
+      _garbage = 0;
+    }
+
+    void buildindex() {
+      if (_where.size() == size_t(_numpoints) &&
+          _parent.size() == _tree.size())
+        return;
+      int n = int(_tree.size());
+      _parent.assign(n, -1);
+      _size.assign(n, 0);
+      _where.assign(_numpoints, -1);
+      _garbage = 0;
+      // Pre-order, so children follow their parents
+      for (int j = 0; j < n; ++j) {
+        const Node& node = _tree[j];
+        if (node.index >= 0) {
+          _where[node.index] = j;
+          for (int l = 0; l < 2; ++l)
+            if (node.data.child[l] >= 0) _parent[node.data.child[l]] = j;
+        } else
+          for (int l = 0; l < _bucket && node.leaves[l] >= 0; ++l)
+            _where[node.leaves[l]] = j;
+      }
+      for (int j = n; j--;) {
+        _size[j] += ownpoints(_tree[j]);
+        if (_parent[j] >= 0) _size[_parent[j]] += _size[j];
+      }
+    }
+
+    // The number of points held by the node itself
+    int ownpoints(const Node& node) const {
+      if (node.index >= 0) return 1;
+      int c = 0;
+      while (c < _bucket && node.leaves[c] >= 0) ++c;
+      return c;
+    }
+
+    // Insert point i
+    void insert(const std::vector<pos_t>& pts, const distfun_t& dist, int i) {
+      if (_tree.empty()) {
+        Node node;
+        if (_bucket == 0)
+          node.index = i;
+        else {
+          node.leaves[0] = i;
+          for (int l = 1; l < _bucket; ++l) node.leaves[l] = -1;
+          for (int l = _bucket; l < maxbucket; ++l) node.leaves[l] = 0;
+        }
+        _tree.push_back(node);
+        _parent.push_back(-1);
+        _size.push_back(1);
+        _where[i] = 0;
+        return;
+      }
+      int n = 0;
+      while (_tree[n].index >= 0) {
+        Node& node = _tree[n];
+        dist_t dst = dist(pts[node.index], pts[i]);
+        ++_cost;
+        ++_size[n];
+        // Choose the child whose bounds are nearest dst, maintaining
+        // upper[0] <= lower[1].  The bounds for an empty child 0 are 0 and
+        // those for an empty child 1 are upper[0].
+        bool c0 = node.data.child[0] >= 0, c1 = node.data.child[1] >= 0;
+        int l;
+        if (c0 && dst <= node.data.upper[0])
+          l = 0;
+        else if (c1 && dst >= node.data.lower[1])
+          l = 1;
+        else if (!c1)
+          l = 1;
+        else if (!c0)
+          l = 0;
+        else
+          l = dst - node.data.upper[0] <= node.data.lower[1] - dst ? 0 : 1;
+        if (node.data.child[l] < 0) {
+          node.data.lower[l] = node.data.upper[l] = dst;
+          Node leaf;
+          if (_bucket == 0)
+            leaf.index = i;
+          else {
+            leaf.leaves[0] = i;
+            for (int j = 1; j < _bucket; ++j) leaf.leaves[j] = -1;
+            for (int j = _bucket; j < maxbucket; ++j) leaf.leaves[j] = 0;
+          }
+          node.data.child[l] = int(_tree.size());
+          _where[i] = int(_tree.size());
+          _tree.push_back(leaf);
+          _parent.push_back(n);
+          _size.push_back(1);
+          rebalance(pts, dist, n);
+          return;
+        }
+        node.data.lower[l] = std::min(node.data.lower[l], dst);
+        node.data.upper[l] = std::max(node.data.upper[l], dst);
+        n = node.data.child[l];
+      }
+      Node& node = _tree[n];
+      int c = ownpoints(node);
+      if (c < _bucket) {
+        node.leaves[c] = i;
+        ++_size[n];
+        _where[i] = n;
+        rebalance(pts, dist, n);
+      } else {
+        // Split a full leaf
+        int p = _parent[n];
+        rebuild(pts, dist, n, i, -1);
+        if (p >= 0) rebalance(pts, dist, p);
+      }
+    }
+
+    // Rebuild the highest unbalanced subtree on the path from node n to the
+    // root.  Small subtrees are not checked.
+    void rebalance(const std::vector<pos_t>& pts, const distfun_t& dist,
+                   int n) {
+      int bad = -1;
+      for (; n >= 0; n = _parent[n]) {
+        const Node& node = _tree[n];
+        if (node.index < 0 || _size[n] < minrebalance) continue;
+        for (int l = 0; l < 2; ++l) {
+          int c = node.data.child[l], s = c >= 0 ? _size[c] : 0;
+          if (4 * s > 3 * _size[n]) bad = n;
+        }
+      }
+      if (bad >= 0) rebuild(pts, dist, bad, -1, -1);
+    }
+
+    // Rebuild the subtree rooted at node n adding point add and dropping
+    // point drop (either may be -1).  The new root replaces node n; the other
+    // nodes are appended to _tree.
+    void rebuild(const std::vector<pos_t>& pts, const distfun_t& dist,
+                 int n, int add, int drop) {
+      std::vector<item> ids;
+      int oldnodes = 0;
+      std::vector<int> stack(1, n);
+      while (!stack.empty()) {
+        const Node& node = _tree[stack.back()];
+        stack.pop_back();
+        ++oldnodes;
+        if (node.index >= 0) {
+          if (node.index != drop) ids.push_back(std::make_pair(dist_t(0),
+                                                               node.index));
+          for (int l = 0; l < 2; ++l)
+            if (node.data.child[l] >= 0) stack.push_back(node.data.child[l]);
+        } else
+          for (int l = 0; l < _bucket && node.leaves[l] >= 0; ++l)
+            if (node.leaves[l] != drop)
+              ids.push_back(std::make_pair(dist_t(0), node.leaves[l]));
+      }
+      if (add >= 0) ids.push_back(std::make_pair(dist_t(0), add));
+      int delta = int(ids.size()) - _size[n], p = _parent[n];
+      for (int m = p; m >= 0; m = _parent[m])
+        _size[m] += delta;
+      if (ids.empty()) {
+        // The subtree is now empty; detach it from its parent
+        _garbage += oldnodes;
+        if (p < 0) {
+          _tree.clear(); _parent.clear(); _size.clear();
+          _garbage = 0;
+        } else {
+          Node& parent = _tree[p];
+          int l = parent.data.child[0] == n ? 0 : 1;
+          parent.data.child[l] = -1;
+          if (l == 0)
+            parent.data.lower[0] = parent.data.upper[0] = 0;
+          else
+            parent.data.lower[1] = parent.data.upper[1] = parent.data.upper[0];
+        }
+        return;
+      }
+      std::vector<Node> tree(nodecount(int(ids.size()), _bucket));
+      _cost += init(pts, dist, _bucket, tree, ids,
+                    0, int(ids.size()), int(ids.size()/2), 0, 1);
+      preorder(tree);
+      // tree[0] goes to position n and tree[j] to base + j - 1
+      int base = int(_tree.size()), m = int(tree.size());
+      _garbage += oldnodes - 1;
+      _tree.resize(base + m - 1);
+      _parent.resize(base + m - 1);
+      _size.resize(base + m - 1);
+      for (int j = 0; j < m; ++j) {
+        Node& node = tree[j];
+        int pos = j == 0 ? n : base + j - 1;
+        if (node.index >= 0) {
+          for (int l = 0; l < 2; ++l)
+            if (node.data.child[l] >= 0)
+              node.data.child[l] += base - 1;
+          _where[node.index] = pos;
+        } else
+          for (int l = 0; l < _bucket && node.leaves[l] >= 0; ++l)
+            _where[node.leaves[l]] = pos;
+        _tree[pos] = node;
+        _size[pos] = ownpoints(node);
+        if (j > 0) _parent[pos] = -1;
+      }
+      for (int j = m; j--;) {
+        const Node& node = _tree[j == 0 ? n : base + j - 1];
+        if (node.index >= 0)
+          for (int l = 0; l < 2; ++l)
+            if (node.data.child[l] >= 0)
+              _parent[node.data.child[l]] = j == 0 ? n : base + j - 1;
+      }
+      for (int j = m; j-- > 1;)
+        _size[_parent[base + j - 1]] += _size[base + j - 1];
+    }
+
+    // Drop orphaned nodes and restore the pre-order layout once they make up
+    // half of the tree.
+    void compact() {
+      if (2 * _garbage <= int(_tree.size())) return;
+      std::vector<Node> tree(postorder());
+      preorder(tree);
+      _tree.swap(tree);
+      clearindex();
+      buildindex();
     }
 
   };
@@ -80,10 +80,12 @@ namespace GeographicLib {
   class GEOGRAPHICLIB_EXPORT NormalGravity {
   private:
     static const int maxit_ = 20;
+    // The largest |h| (meters) for which GravityBatch uses GravityNearSurface
+    static const int nearsurfacemax_ = 10000;
     typedef Math::real real;
     friend class GravityModel;
     real _a, _gGM, _omega, _f, _jJ2, _omega2, _aomega2;
-    real _e2, _ep2, _b, _eE, _uU0, _gammae, _gammap, _qQ0, _k, _fstar;
+    real _e2, _ep2, _b, _eE, _uU0, _gammae, _gammap, _qQ0, _k, _fstar, _m;
     Geocentric _earth;
     static real atanzz(real x, bool alt) {
       // This routine obeys the identity
@@ -191,6 +193,69 @@ namespace GeographicLib {
     Math::real Gravity(real lat, real h, real& gammay, real& gammaz)
       const;
 
+    /**
+     * Evaluate the gravity near the surface of the ellipsoid using a series
+     * in the height.
+     *
+     * @param[in] lat the geographic latitude (degrees).
+     * @param[in] h the height above the ellipsoid (meters).
+     * @param[out] gammay the northerly component of the acceleration
+     *   (m s<sup>&minus;2</sup>).
+     * @param[out] gammaz the upward component of the acceleration
+     *   (m s<sup>&minus;2</sup>); this is usually negative.
+     * @return \e U the corresponding normal potential
+     *   (m<sup>2</sup> s<sup>&minus;2</sup>).
+     *
+     * This approximates Gravity, avoiding the conversion to geocentric
+     * coordinates and the evaluation of the potential of the ellipsoid.
+     * The surface gravity &gamma;<sub>0</sub> is given by SurfaceGravity and
+     * - \e gammaz = &minus;&gamma;<sub>0</sub> [1 &minus; 2(1 + \e f + \e m
+     *   &minus; 2\e f sin<sup>2</sup>&phi;) \e h/\e a + 3
+     *   <i>h</i><sup>2</sup>/<i>a</i><sup>2</sup>], where \e m =
+     *   &omega;<sup>2</sup><i>a</i><sup>2</sup><i>b</i>/\e GM (H+M, Eq
+     *   2-124);
+     * - \e gammay = &minus;\e h (d&gamma;<sub>0</sub>/d&phi;) / &rho;, where
+     *   &rho; is the meridional radius of curvature (this follows because the
+     *   gravity field is irrotational);
+     * - \e U is found by integrating \e gammaz from the surface, where \e U
+     *   = <i>U</i><sub>0</sub>.
+     * .
+     * For WGS84 and 0 &le; \e h &le; 10 km, the errors are less than 7
+     * &times; 10<sup>&minus;7</sup> m s<sup>&minus;2</sup> in \e gammaz, 1
+     * &times; 10<sup>&minus;7</sup> m s<sup>&minus;2</sup> in \e gammay,
+     * and 4 &times; 10<sup>&minus;3</sup> m<sup>2</sup> s<sup>&minus;2</sup>
+     * in \e U; the errors in \e gammaz and \e U are about twice as large
+     * for &minus;10 km &le; \e h < 0 (1.8 &times; 10<sup>&minus;6</sup> and
+     * 8 &times; 10<sup>&minus;3</sup>).  For |\e h| &le; 1 km, the errors
+     * are less than 1.2 &times; 10<sup>&minus;7</sup>, 1 &times;
+     * 10<sup>&minus;9</sup>, and 6 &times; 10<sup>&minus;5</sup>.  This is
+     * about 7 times faster than Gravity.
+     **********************************************************************/
+    Math::real GravityNearSurface(real lat, real h,
+                                  real& gammay, real& gammaz) const;
+
+    /**
+     * Evaluate the gravity at several points.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lat array of geographic latitudes (degrees).
+     * @param[in] h array of heights above the ellipsoid (meters).
+     * @param[out] U array of normal potentials
+     *   (m<sup>2</sup> s<sup>&minus;2</sup>).
+     * @param[out] gammay array of the northerly components of the
+     *   acceleration (m s<sup>&minus;2</sup>).
+     * @param[out] gammaz array of the upward components of the acceleration
+     *   (m s<sup>&minus;2</sup>).
+     * @param[in] nearsurface if true, use GravityNearSurface for the points
+     *   with |\e h| &le; 10 km (default false).
+     *
+     * Otherwise, this gives the same results as calling Gravity for each
+     * point.
+     **********************************************************************/
+    void GravityBatch(size_t n, const real lat[], const real h[],
+                      real U[], real gammay[], real gammaz[],
+                      bool nearsurface = false) const;
+
     /**
      * Evaluate the components of the acceleration due to gravity and the
      * centrifugal acceleration in geocentric coordinates.
@@ -214,6 +279,28 @@ namespace GeographicLib {
     Math::real U(real X, real Y, real Z,
                  real& gammaX, real& gammaY, real& gammaZ) const;
 
+    /**
+     * Evaluate the acceleration due to gravity and the centrifugal
+     * acceleration in geocentric coordinates at several points.
+     *
+     * @param[in] n the number of points.
+     * @param[in] X array of geocentric coordinates of the points (meters).
+     * @param[in] Y array of geocentric coordinates of the points (meters).
+     * @param[in] Z array of geocentric coordinates of the points (meters).
+     * @param[out] U array of the sums of the gravitational and centrifugal
+     *   potentials (m<sup>2</sup> s<sup>&minus;2</sup>).
+     * @param[out] gammaX array of the \e X components of the acceleration
+     *   (m s<sup>&minus;2</sup>).
+     * @param[out] gammaY array of the \e Y components of the acceleration
+     *   (m s<sup>&minus;2</sup>).
+     * @param[out] gammaZ array of the \e Z components of the acceleration
+     *   (m s<sup>&minus;2</sup>).
+     *
+     * This gives the same results as calling U for each point.
+     **********************************************************************/
+    void UBatch(size_t n, const real X[], const real Y[], const real Z[],
+                real U[], real gammaX[], real gammaY[], real gammaZ[]) const;
+
     /**
      * Evaluate the components of the acceleration due to the gravitational
      * force in geocentric coordinates.
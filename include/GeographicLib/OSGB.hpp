@@ -78,6 +78,14 @@ namespace GeographicLib {
     OSGB() = delete;            // Disable constructor
   public:
 
+    /**
+     * The maximum length of a grid reference (not counting the terminating
+     * null), namely 2 (letters) + 2 &times; 11 (easting and northing digits
+     * at \e prec = 11).  A char array of size MAXLENGTH + 1 is large enough
+     * to hold any grid reference produced by GridReference.
+     **********************************************************************/
+    enum { MAXLENGTH = 2 + 2 * 11 };
+
     /**
      * Forward projection, from geographic to OSGB coordinates.
      *
@@ -134,6 +142,48 @@ namespace GeographicLib {
       Reverse(x, y, lat, lon, gamma, k);
     }
 
+    /**
+     * Forward projection of several points.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lat array of latitudes (degrees).
+     * @param[in] lon array of longitudes (degrees).
+     * @param[out] x array of eastings (meters).
+     * @param[out] y array of northings (meters).
+     * @param[out] gamma (optional) array of meridian convergences
+     *   (degrees).
+     * @param[out] k (optional) array of scales.
+     *
+     * This gives the same results as calling Forward for each point; the
+     * projection is done by TransverseMercator::ForwardBatch.  \e gamma and
+     * \e k may be nullptr if these quantities are not needed.  The output
+     * arrays may coincide with the input arrays.
+     **********************************************************************/
+    static void ForwardBatch(size_t n, const real lat[], const real lon[],
+                             real x[], real y[],
+                             real gamma[] = nullptr, real k[] = nullptr);
+
+    /**
+     * Reverse projection of several points.
+     *
+     * @param[in] n the number of points.
+     * @param[in] x array of eastings (meters).
+     * @param[in] y array of northings (meters).
+     * @param[out] lat array of latitudes (degrees).
+     * @param[out] lon array of longitudes (degrees).
+     * @param[out] gamma (optional) array of meridian convergences
+     *   (degrees).
+     * @param[out] k (optional) array of scales.
+     *
+     * This gives the same results as calling Reverse for each point; the
+     * projection is done by TransverseMercator::ReverseBatch.  \e gamma and
+     * \e k may be nullptr if these quantities are not needed.  \e lat and \e
+     * lon may coincide with \e x and \e y (in that order).
+     **********************************************************************/
+    static void ReverseBatch(size_t n, const real x[], const real y[],
+                             real lat[], real lon[],
+                             real gamma[] = nullptr, real k[] = nullptr);
+
     /**
      * Convert OSGB coordinates to a grid reference.
      *
@@ -165,6 +215,45 @@ namespace GeographicLib {
      **********************************************************************/
     static void GridReference(real x, real y, int prec, std::string& gridref);
 
+    /**
+     * Convert OSGB coordinates to a grid reference in a char array.
+     *
+     * @param[in] x easting of point (meters).
+     * @param[in] y northing of point (meters).
+     * @param[in] prec precision relative to 100 km.
+     * @param[out] gridref a char array of size at least MAXLENGTH + 1 to
+     *   receive the null-terminated grid reference.
+     * @exception GeographicErr if \e prec, \e x, or \e y is outside its
+     *   allowed range.
+     * @return the length of the grid reference.
+     *
+     * This is the same as the version of GridReference taking a
+     * std::string, but no memory is allocated (unless an exception is
+     * thrown).
+     **********************************************************************/
+    static int GridReference(real x, real y, int prec, char gridref[]);
+
+    /**
+     * Convert several OSGB coordinates to grid references.
+     *
+     * @param[in] n the number of points.
+     * @param[in] x array of eastings (meters).
+     * @param[in] y array of northings (meters).
+     * @param[in] prec precision relative to 100 km.
+     * @param[out] gridref a char array of size at least \e n (MAXLENGTH +
+     *   1) to receive the grid references; the null-terminated grid
+     *   reference for point \e i starts at \e gridref + \e i (MAXLENGTH +
+     *   1).
+     * @exception GeographicErr if \e prec or any \e x or \e y is outside
+     *   its allowed range.
+     *
+     * This is equivalent to calling the char array version of GridReference
+     * for each point.  If an exception is thrown, the grid references for
+     * the points before the offending one have been written.
+     **********************************************************************/
+    static void GridReferenceBatch(size_t n, const real x[], const real y[],
+                                   int prec, char gridref[]);
+
     /**
      * Convert OSGB grid reference to coordinates.
      *
@@ -183,9 +272,56 @@ namespace GeographicLib {
      * set to NaN and \e prec is set to &minus;2.
      **********************************************************************/
     static void GridReference(const std::string& gridref,
+                              real& x, real& y, int& prec,
+                              bool centerp = true) {
+      GridReference(gridref.data(), gridref.size(), x, y, prec, centerp);
+    }
+
+    /**
+     * Convert an OSGB grid reference given as a character array to
+     * coordinates.
+     *
+     * @param[in] gridref pointer to the characters of the grid reference.
+     * @param[in] len the number of characters (the string need not be null
+     *   terminated).
+     * @param[out] x easting of point (meters).
+     * @param[out] y northing of point (meters).
+     * @param[out] prec precision relative to 100 km.
+     * @param[in] centerp if true (default), return center of the grid square,
+     *   else return SW (lower left) corner.
+     * @exception GeographicErr if \e gridref is illegal.
+     *
+     * This is the same as the version of GridReference taking a
+     * std::string, but no memory is allocated (unless an exception is
+     * thrown).
+     **********************************************************************/
+    static void GridReference(const char* gridref, size_t len,
                               real& x, real& y, int& prec,
                               bool centerp = true);
 
+    /**
+     * Convert several OSGB grid references to coordinates.
+     *
+     * @param[in] n the number of points.
+     * @param[in] gridref a char array holding the grid references in the
+     *   layout produced by GridReferenceBatch; grid reference \e i starts at
+     *   \e gridref + \e i (MAXLENGTH + 1) and is terminated by a null or by
+     *   the end of its MAXLENGTH + 1 characters.
+     * @param[out] x array of eastings (meters).
+     * @param[out] y array of northings (meters).
+     * @param[out] prec (optional) array of precisions relative to 100 km.
+     * @param[in] centerp if true (default), return centers of the grid
+     *   squares, else return SW (lower left) corners.
+     * @exception GeographicErr if any of the grid references is illegal.
+     *
+     * This is equivalent to calling GridReference for each point.  If an
+     * exception is thrown, the results for the points before the offending
+     * one have been written.
+     **********************************************************************/
+    static void GridReferenceBatch(size_t n, const char gridref[],
+                                   real x[], real y[], int prec[] = nullptr,
+                                   bool centerp = true);
+
     /** \name Inspector functions
      **********************************************************************/
     ///@{
@@ -0,0 +1,168 @@
+/**
+ * \file PointInPolygon.hpp
+ * \brief Header for GeographicLib::PointInPolygon class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_POINTINPOLYGON_HPP)
+#define GEOGRAPHICLIB_POINTINPOLYGON_HPP 1
+
+#include <vector>
+#include <GeographicLib/Geodesic.hpp>
+#include <GeographicLib/Constants.hpp>
+
+namespace GeographicLib {
+
+  /**
+   * \brief Point-in-polygon test for geodesic polygons
+   *
+   * Determine whether points lie inside a polygon whose edges are geodesics.
+   * A point \e Q is inside the polygon if the meridian running north from
+   * \e Q to the pole crosses the edges an odd number of times, with this
+   * parity reversed if the polygon encircles the north pole.  The test for
+   * whether an edge crosses the meridian of \e Q uses the same half-open
+   * longitude intervals as PolygonArea (so that an edge ending on the
+   * meridian is counted once).  Whether the crossing lies north of \e Q is
+   * usually settled by the latitude range of the edge, given by
+   * GeodesicLine::GenBoundingBox; otherwise, the side of the edge on which
+   * \e Q lies is found from the azimuth of the geodesic from the start of
+   * the edge to \e Q, at the cost of an inverse geodesic calculation.
+   *
+   * A polygon which doesn't encircle a pole contains the region it bounds,
+   * whatever its orientation.  A polygon which does encircle a pole divides
+   * the ellipsoid into two regions, each containing a pole; the interior is
+   * taken to be on the left of the edges, as for PolygonArea (so a polygon
+   * traversed eastwards around the north pole contains the north pole).
+   *
+   * The constructor builds an index so that the cost of a query does not
+   * depend on the total number of edges.  The circle of longitude is divided
+   * into slabs with (nearly) the same number of vertices in each and the
+   * edges overlapping each slab are listed.  A query finds its slab by a
+   * binary search and examines only the edges listed for the slab.  This
+   * list includes the edges passing through the slab, so the cost is
+   * proportional to the number of times the meridian of \e Q crosses the
+   * polygon (most of which are settled by the latitude test) plus a small
+   * constant.
+   *
+   * PointInPolygon objects are not altered once they have been constructed,
+   * so they can be shared by several threads.
+   **********************************************************************/
+  class GEOGRAPHICLIB_EXPORT PointInPolygon {
+  private:
+    typedef Math::real real;
+    // The number of vertices in a slab
+    static const size_t slabsize_ = 4;
+    struct Edge {
+      real lat1, lon1, dlon, azi1, latmin, latmax;
+    };
+    Geodesic _geod;
+    std::vector<Edge> _edges;
+    // The western edges of the slabs and the edges overlapping each slab
+    // (slab k has _slabedges[_slabstart[k]] through
+    // _slabedges[_slabstart[k+1]-1]).
+    std::vector<real> _slabwest;
+    std::vector<size_t> _slabstart, _slabedges;
+    bool _northpole;
+    size_t Slab(real lon) const;
+  public:
+
+    /**
+     * Constructor for PointInPolygon.
+     *
+     * @param[in] geod the Geodesic object to use for geodesic calculations.
+     * @param[in] n the number of vertices of the polygon.
+     * @param[in] lat array of latitudes of the vertices (degrees).
+     * @param[in] lon array of longitudes of the vertices (degrees).
+     * @param[in] nthreads the number of threads to use to build the index;
+     *   if this is 0 (the default), use std::thread::hardware_concurrency().
+     * @exception std::bad_alloc if the memory for the index can't be
+     *   allocated.
+     *
+     * The polygon is closed by an edge from the last vertex to the first
+     * (as for PolygonArea, the first vertex should not be repeated).  The
+     * edges are the shortest geodesics between the vertices; an edge
+     * spanning 180&deg; of longitude is ambiguous and should be avoided.
+     * If \e n < 3, no points are inside the polygon.
+     **********************************************************************/
+    PointInPolygon(const Geodesic& geod, size_t n,
+                   const real lat[], const real lon[],
+                   unsigned nthreads = 0);
+
+    /**
+     * Test whether a point is inside the polygon.
+     *
+     * @param[in] lat the latitude of the point (degrees).
+     * @param[in] lon the longitude of the point (degrees).
+     * @return whether the point is inside the polygon.
+     *
+     * Points on the boundary may be reported as inside or outside.
+     **********************************************************************/
+    bool Contains(real lat, real lon) const;
+
+    /**
+     * Test whether many points are inside the polygon.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lat array of latitudes of the points (degrees).
+     * @param[in] lon array of longitudes of the points (degrees).
+     * @param[out] inside array of the results of Contains for the points.
+     * @param[in] nthreads the number of threads to use; if this is 0 (the
+     *   default), use std::thread::hardware_concurrency().
+     *
+     * The arrays have (at least) \e n elements and the work is divided
+     * among several threads using GeodesicBatchExecutor.
+     **********************************************************************/
+    void ContainsBatch(size_t n, const real lat[], const real lon[],
+                       bool inside[], unsigned nthreads = 0) const;
+
+    /**
+     * The latitude-longitude bounding box of the polygon.
+     *
+     * @param[out] latmin the minimum latitude (degrees).
+     * @param[out] latmax the maximum latitude (degrees).
+     * @param[out] lonmin the western edge of the box (degrees).
+     * @param[out] lonmax the eastern edge of the box (degrees).
+     *
+     * The box encloses the edges and the interior of the polygon.  The
+     * longitude range follows the conventions of
+     * GeodesicLine::GenBoundingBox; a polygon which encircles a pole gives a
+     * box which covers all longitudes and extends to the pole which it
+     * contains.  If \e n < 3 in the constructor, NaNs are returned.
+     **********************************************************************/
+    void BoundingBox(real& latmin, real& latmax,
+                     real& lonmin, real& lonmax) const;
+
+    /** \name Inspector functions
+     **********************************************************************/
+    ///@{
+    /**
+     * @return the number of edges of the polygon.
+     **********************************************************************/
+    size_t NumEdges() const { return _edges.size(); }
+
+    /**
+     * @return the number of slabs in the index.
+     **********************************************************************/
+    size_t NumSlabs() const { return _slabwest.size(); }
+
+    /**
+     * @return \e a the equatorial radius of the ellipsoid (meters).  This is
+     *   the value inherited from the Geodesic object used in the constructor.
+     **********************************************************************/
+    Math::real EquatorialRadius() const { return _geod.EquatorialRadius(); }
+
+    /**
+     * @return \e f the flattening of the ellipsoid.  This is the value
+     *   inherited from the Geodesic object used in the constructor.
+     **********************************************************************/
+    Math::real Flattening() const { return _geod.Flattening(); }
+    ///@}
+
+  };
+
+} // namespace GeographicLib
+
+#endif  // GEOGRAPHICLIB_POINTINPOLYGON_HPP
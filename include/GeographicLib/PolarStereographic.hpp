@@ -38,6 +38,16 @@ namespace GeographicLib {
     typedef Math::real real;
     real _a, _f, _e2, _es, _e2m, _c;
     real _k0;
+    // The number of points processed together by ForwardBatch and
+    // ReverseBatch
+    static const int batchsize_ = 64;
+    // The parts of Forward and Reverse which follow the calls to taupf and
+    // tauf; ReverseStart precedes the call to tauf.
+    void ForwardFinish(bool northp, real lat, real lon, real tau, real taup,
+                       real& x, real& y, real& gamma, real& k) const;
+    void ReverseStart(real x, real y, real& rho, real& taup) const;
+    void ReverseFinish(bool northp, real x, real y, real rho, real tau,
+                       real& lat, real& lon, real& gamma, real& k) const;
   public:
 
     /**
@@ -118,6 +128,54 @@ namespace GeographicLib {
       Reverse(northp, x, y, lat, lon, gamma, k);
     }
 
+    /**
+     * Forward projection of several points.
+     *
+     * @param[in] n the number of points.
+     * @param[in] northp the pole which is the center of projection (true means
+     *   north, false means south).
+     * @param[in] lat array of latitudes (degrees).
+     * @param[in] lon array of longitudes (degrees).
+     * @param[out] x array of eastings (meters).
+     * @param[out] y array of northings (meters).
+     * @param[out] gamma (optional) array of meridian convergences
+     *   (degrees).
+     * @param[out] k (optional) array of scales.
+     *
+     * This gives the same results as calling Forward for each point.  The
+     * points are processed in blocks with the conformal latitudes for each
+     * block evaluated by Math::taupfBatch.  \e gamma and \e k may be nullptr
+     * if these quantities are not needed.  The output arrays may coincide
+     * with the input arrays.
+     **********************************************************************/
+    void ForwardBatch(size_t n, bool northp,
+                      const real lat[], const real lon[],
+                      real x[], real y[],
+                      real gamma[] = nullptr, real k[] = nullptr) const;
+
+    /**
+     * Reverse projection of several points.
+     *
+     * @param[in] n the number of points.
+     * @param[in] northp the pole which is the center of projection (true means
+     *   north, false means south).
+     * @param[in] x array of eastings (meters).
+     * @param[in] y array of northings (meters).
+     * @param[out] lat array of latitudes (degrees).
+     * @param[out] lon array of longitudes (degrees).
+     * @param[out] gamma (optional) array of meridian convergences
+     *   (degrees).
+     * @param[out] k (optional) array of scales.
+     *
+     * This gives the same results as calling Reverse for each point; the
+     * geographic latitudes are found with Math::taufBatch.  See
+     * ForwardBatch.
+     **********************************************************************/
+    void ReverseBatch(size_t n, bool northp,
+                      const real x[], const real y[],
+                      real lat[], real lon[],
+                      real gamma[] = nullptr, real k[] = nullptr) const;
+
     /** \name Inspector functions
      **********************************************************************/
     ///@{
@@ -14,6 +14,8 @@
 #include <GeographicLib/GeodesicExact.hpp>
 #include <GeographicLib/Rhumb.hpp>
 #include <GeographicLib/Accumulator.hpp>
+#include <GeographicLib/StridedView.hpp>
+#include <vector>
 
 namespace GeographicLib {
 
@@ -105,6 +107,7 @@ namespace GeographicLib {
     int _crossings;
     Accumulator<> _areasum, _perimetersum;
     real _lat0, _lon0, _lat1, _lon1;
+    template<class T> friend class PolygonEditT;
     static int transit(real lon1, real lon2);
     // an alternate version of transit to deal with longitudes in the direct
     // problem.
@@ -116,6 +119,23 @@ namespace GeographicLib {
     }
     template<typename T>
     void AreaReduce(T& area, int crossings, bool reverse, bool sign) const;
+    void InverseEdges(size_t k, const real lat1[], const real lon1[],
+                      const real lat2[], const real lon2[],
+                      real s12[], real S12[]) const;
+    // CA is the type of the input arrays, a pointer or a StridedView.
+    template<class CA>
+    void RingCompute(size_t m, CA lat, CA lon,
+                     bool reverse, bool sign, std::vector<real>& work,
+                     real& perimeter, real& area) const;
+    template<class CA, class A>
+    void IntComputeBatch(size_t nrings, const size_t offsets[],
+                         CA lat, CA lon, bool reverse, bool sign,
+                         A perimeter, A area, unsigned nthreads) const;
+    template<class CA, class A>
+    void IntComputeBatch(size_t npolygons, const size_t polyoffsets[],
+                         const size_t ringoffsets[],
+                         CA lat, CA lon, bool reverse, bool sign,
+                         A perimeter, A area, unsigned nthreads) const;
   public:
 
     /**
@@ -155,6 +175,31 @@ namespace GeographicLib {
      **********************************************************************/
     void AddPoint(real lat, real lon);
 
+    /**
+     * Add several points to the polygon or polyline using several threads.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lat array of the latitudes of the points (degrees).
+     * @param[in] lon array of the longitudes of the points (degrees).
+     * @param[in] nthreads the number of threads to use; if this is 0 (the
+     *   default), use std::thread::hardware_concurrency().
+     *
+     * This is equivalent to calling AddPoint for each point in turn.  The
+     * geodesic problems for the new edges are solved in parallel using
+     * GeodesicBatchExecutor, each thread calling the InverseBatch function
+     * of \e GeodType for blocks of consecutive edges, and the perimeter and
+     * area of the edges are summed on the same threads with
+     * ExactAccumulator.  Because these sums are exact, the results are
+     * identical for any number of threads.  AddPoint instead adds each edge
+     * to a double-length Accumulator, so the results are not guaranteed to
+     * be bit-identical; however both give faithfully rounded results, so
+     * the perimeter and area returned by Compute differ by at most one unit
+     * in the last place (this also holds for a polygon built with a mixture
+     * of AddPoint and AddPoints).
+     **********************************************************************/
+    void AddPoints(size_t n, const real lat[], const real lon[],
+                   unsigned nthreads = 0);
+
     /**
      * Add an edge to the polygon or polyline.
      *
@@ -239,6 +284,146 @@ namespace GeographicLib {
     unsigned TestEdge(real azi, real s, bool reverse, bool sign,
                       real& perimeter, real& area) const;
 
+    /**
+     * Compute the perimeters and areas of many polygons (or polylines).
+     *
+     * @param[in] nrings the number of polygons.
+     * @param[in] offsets array of \e nrings + 1 offsets into \e lat and \e
+     *   lon; the vertices of polygon \e i are [\e offsets[\e i], \e
+     *   offsets[\e i + 1]).
+     * @param[in] lat array of the latitudes of the vertices (degrees).
+     * @param[in] lon array of the longitudes of the vertices (degrees).
+     * @param[in] reverse if true then clockwise (instead of counter-clockwise)
+     *   traversal counts as a positive area.
+     * @param[in] sign if true then return a signed result for the area if
+     *   the polygon is traversed in the "wrong" direction instead of returning
+     *   the area for the rest of the earth.
+     * @param[out] perimeter array of the perimeters of the polygons or lengths
+     *   of the polylines (meters).
+     * @param[out] area array of the areas of the polygons
+     *   (meters<sup>2</sup>); this may be null and it is not used if \e
+     *   polyline is true in the constructor.
+     * @param[in] nthreads the number of threads to use; if this is 0 (the
+     *   default), use std::thread::hardware_concurrency().
+     *
+     * The vertices are given in a flat buffer with the polygons delimited by
+     * offsets (as in the GeoArrow format); a closing vertex which repeats the
+     * first vertex is allowed (it adds an edge of zero length).  The results
+     * for each polygon are identical to those given by adding its vertices
+     * with AddPoint to a PolygonAreaT constructed with the same parameters
+     * as this one and calling Compute.  The state of this object is not
+     * used or altered.  The edges of each polygon are solved with a single
+     * call to the InverseBatch function of \e GeodType and the polygons are
+     * processed in parallel using GeodesicBatchExecutor.
+     **********************************************************************/
+    void ComputeBatch(size_t nrings, const size_t offsets[],
+                      const real lat[], const real lon[],
+                      bool reverse, bool sign,
+                      real perimeter[], real area[],
+                      unsigned nthreads = 0) const;
+
+    /**
+     * Compute the perimeters and areas of many polygons with holes.
+     *
+     * @param[in] npolygons the number of polygons.
+     * @param[in] polyoffsets array of \e npolygons + 1 offsets into \e
+     *   ringoffsets; the rings of polygon \e j are [\e polyoffsets[\e j],
+     *   \e polyoffsets[\e j + 1]).
+     * @param[in] ringoffsets array of offsets into \e lat and \e lon; the
+     *   vertices of ring \e i are [\e ringoffsets[\e i], \e
+     *   ringoffsets[\e i + 1]).
+     * @param[in] lat array of the latitudes of the vertices (degrees).
+     * @param[in] lon array of the longitudes of the vertices (degrees).
+     * @param[in] reverse if true then clockwise (instead of counter-clockwise)
+     *   traversal counts as a positive area.
+     * @param[in] sign if false then a negative total area is converted to a
+     *   positive area by adding the area of the ellipsoid.
+     * @param[out] perimeter array of the total perimeters of the polygons (the
+     *   sums of the perimeters of their rings) (meters).
+     * @param[out] area array of the areas of the polygons
+     *   (meters<sup>2</sup>); this may be null and it is not used if \e
+     *   polyline is true in the constructor.
+     * @param[in] nthreads the number of threads to use; if this is 0 (the
+     *   default), use std::thread::hardware_concurrency().
+     *
+     * This uses the layout of the GeoArrow (and GeoJSON) multipolygons.  The
+     * area of a polygon is the sum of the signed areas of its rings (found by
+     * ComputeBatch with \e sign = true), so holes, which are traversed in the
+     * opposite sense to the outer ring, are subtracted from its area.  For
+     * example, with \e reverse = false, the outer rings should be
+     * counter-clockwise and the holes clockwise (as in GeoJSON).
+     **********************************************************************/
+    void ComputeBatch(size_t npolygons, const size_t polyoffsets[],
+                      const size_t ringoffsets[],
+                      const real lat[], const real lon[],
+                      bool reverse, bool sign,
+                      real perimeter[], real area[],
+                      unsigned nthreads = 0) const;
+
+    /**
+     * Compute the perimeters and areas of many polygons with the vertices in
+     * strided arrays.
+     *
+     * @param[in] nrings the number of polygons (or polylines).
+     * @param[in] offsets array of \e nrings + 1 offsets into \e lat and \e
+     *   lon.
+     * @param[in] lat view of the latitudes of the vertices (degrees).
+     * @param[in] lon view of the longitudes of the vertices (degrees).
+     * @param[in] reverse if true then clockwise (instead of counter-clockwise)
+     *   traversal counts as a positive area.
+     * @param[in] sign if true then return a signed result for the area if
+     *   the polygon is traversed in the "wrong" direction.
+     * @param[out] perimeter view of the perimeters (meters).
+     * @param[out] area view of the areas (meters<sup>2</sup>); this may be a
+     *   view of nullptr.
+     * @param[in] nthreads the number of threads to use; if this is 0 (the
+     *   default), use std::thread::hardware_concurrency().
+     *
+     * This is the same as the version of ComputeBatch for arrays except that
+     * the arrays of coordinates and results are StridedView objects; e.g.,
+     * the vertices can be taken from a GeoArrow interleaved buffer.  (Each
+     * ring is copied to a small work array, as it is for contiguous
+     * arrays.)
+     **********************************************************************/
+    void ComputeBatch(size_t nrings, const size_t offsets[],
+                      StridedView<const real> lat,
+                      StridedView<const real> lon,
+                      bool reverse, bool sign,
+                      StridedView<real> perimeter, StridedView<real> area,
+                      unsigned nthreads = 0) const;
+
+    /**
+     * Compute the perimeters and areas of many polygons with holes with the
+     * vertices in strided arrays.
+     *
+     * @param[in] npolygons the number of polygons.
+     * @param[in] polyoffsets array of \e npolygons + 1 offsets into \e
+     *   ringoffsets.
+     * @param[in] ringoffsets array of offsets into \e lat and \e lon.
+     * @param[in] lat view of the latitudes of the vertices (degrees).
+     * @param[in] lon view of the longitudes of the vertices (degrees).
+     * @param[in] reverse if true then clockwise (instead of counter-clockwise)
+     *   traversal counts as a positive area.
+     * @param[in] sign if false then a negative total area is converted to a
+     *   positive area by adding the area of the ellipsoid.
+     * @param[out] perimeter view of the total perimeters (meters).
+     * @param[out] area view of the areas (meters<sup>2</sup>); this may be a
+     *   view of nullptr.
+     * @param[in] nthreads the number of threads to use; if this is 0 (the
+     *   default), use std::thread::hardware_concurrency().
+     *
+     * This is the same as the version of ComputeBatch for arrays of
+     * multipolygons except that the arrays of coordinates and results are
+     * StridedView objects.
+     **********************************************************************/
+    void ComputeBatch(size_t npolygons, const size_t polyoffsets[],
+                      const size_t ringoffsets[],
+                      StridedView<const real> lat,
+                      StridedView<const real> lon,
+                      bool reverse, bool sign,
+                      StridedView<real> perimeter, StridedView<real> area,
+                      unsigned nthreads = 0) const;
+
     /** \name Inspector functions
      **********************************************************************/
     ///@{
@@ -0,0 +1,280 @@
+/**
+ * \file PolygonEdit.hpp
+ * \brief Header for GeographicLib::PolygonEditT class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_POLYGONEDIT_HPP)
+#define GEOGRAPHICLIB_POLYGONEDIT_HPP 1
+
+#include <vector>
+#include <GeographicLib/PolygonArea.hpp>
+
+#if defined(_MSC_VER)
+// Squelch warnings about dll vs vector
+#  pragma warning (push)
+#  pragma warning (disable: 4251)
+#endif
+
+namespace GeographicLib {
+
+  /**
+   * \brief Editable polygons
+   *
+   * This computes the perimeter and area of a polygon in the same way as
+   * PolygonAreaT.  However, in addition to adding vertices at the end of the
+   * polygon, vertices can be inserted, moved, and removed anywhere in the
+   * polygon.  This is intended for interactive editing of polygons with many
+   * vertices.
+   *
+   * The contribution of each edge to the perimeter and area is cached, so
+   * that adding, inserting, moving, or removing a vertex entails solving at
+   * most 2 geodesic problems (for the edges adjacent to the vertex).  The
+   * contributions are summed in a binary tree so that the totals are updated
+   * with \e O(log \e n) operations (where \e n is the number of vertices);
+   * the perimeter and area are then available without any further geodesic
+   * calculations.  The sums in the tree are carried out at two times the
+   * standard floating point precision and the totals depend only on the
+   * current edges (and not on the history of the edits), so the accuracy is
+   * comparable to that of PolygonAreaT.  However, the results are not
+   * bit-for-bit identical with PolygonAreaT, because the contributions are
+   * summed in a different order.
+   *
+   * The vertices are identified by handles returned when they are added.  A
+   * handle remains valid until its vertex is removed; the handles of
+   * removed vertices are reused.  The vertices form a cycle (the last vertex
+   * is followed by the first) which can be traversed with First(), Next(),
+   * and Previous().  If the object is constructed with \e polyline = true,
+   * the edge from the last vertex to the first is omitted.
+   *
+   * @tparam GeodType the geodesic class to use.
+   *
+   * Example of use:
+   * \include example-PolygonEdit.cpp
+   **********************************************************************/
+
+  template<class GeodType = Geodesic>
+  class PolygonEditT {
+  private:
+    typedef Math::real real;
+    struct vertex {
+      real lat, lon;
+      size_t prev, next;        // prev == NONE means the slot is free
+    };
+    // The contributions of an edge (or an aggregate of edges) with the
+    // perimeter and area as double-double sums.
+    struct edgesum {
+      real s, st, a, at;
+      int crossings;
+      edgesum() : s(0), st(0), a(0), at(0), crossings(0) {}
+    };
+    GeodType _earth;
+    real _area0;                // Full ellipsoid area
+    bool _polyline;             // Assume polyline (don't close and skip area)
+    unsigned _mask;
+    unsigned _num;
+    size_t _first, _free;       // The first vertex and the free list
+    std::vector<vertex> _vertices;
+    // A complete binary tree of edgesums; leaf _leaves + k is the edge from
+    // vertex k to its successor, _tree[1] is the total.
+    size_t _leaves;
+    std::vector<edgesum> _tree;
+    static edgesum merge(const edgesum& x, const edgesum& y);
+    void SetEdge(size_t k);
+    void Update(size_t k, const edgesum& e);
+    size_t Allocate(real lat, real lon);
+    void Check(size_t k) const;
+  public:
+    /**
+     * A value returned by First() and Last() for an empty polygon.
+     **********************************************************************/
+    static const size_t NONE = size_t(-1);
+
+    /**
+     * Constructor for PolygonEditT.
+     *
+     * @param[in] earth the Geodesic object to use for geodesic calculations.
+     * @param[in] polyline if true that treat the points as defining a polyline
+     *   instead of a polygon (default = false).
+     **********************************************************************/
+    PolygonEditT(const GeodType& earth, bool polyline = false)
+      : _earth(earth)
+      , _area0(_earth.EllipsoidArea())
+      , _polyline(polyline)
+      , _mask(GeodType::LATITUDE | GeodType::LONGITUDE | GeodType::DISTANCE |
+              (_polyline ? GeodType::NONE :
+               GeodType::AREA | GeodType::LONG_UNROLL))
+    { Clear(); }
+
+    /**
+     * Clear PolygonEditT, allowing a new polygon to be started.
+     **********************************************************************/
+    void Clear();
+
+    /**
+     * Add a point at the end of the polygon.
+     *
+     * @param[in] lat the latitude of the point (degrees).
+     * @param[in] lon the longitude of the point (degrees).
+     * @return the handle for the new vertex.
+     *
+     * \e lat should be in the range [&minus;90&deg;, 90&deg;].  The new
+     * vertex follows the last vertex (and, for a polygon, precedes the first
+     * vertex).
+     **********************************************************************/
+    size_t AddPoint(real lat, real lon);
+
+    /**
+     * Insert a point after a vertex.
+     *
+     * @param[in] k the handle for the vertex.
+     * @param[in] lat the latitude of the point (degrees).
+     * @param[in] lon the longitude of the point (degrees).
+     * @exception GeographicErr if \e k is not the handle for a vertex.
+     * @return the handle for the new vertex.
+     *
+     * If \e k is the last vertex, this is equivalent to AddPoint().
+     **********************************************************************/
+    size_t Insert(size_t k, real lat, real lon);
+
+    /**
+     * Move a vertex.
+     *
+     * @param[in] k the handle for the vertex.
+     * @param[in] lat the new latitude of the vertex (degrees).
+     * @param[in] lon the new longitude of the vertex (degrees).
+     * @exception GeographicErr if \e k is not the handle for a vertex.
+     **********************************************************************/
+    void Move(size_t k, real lat, real lon);
+
+    /**
+     * Remove a vertex.
+     *
+     * @param[in] k the handle for the vertex.
+     * @exception GeographicErr if \e k is not the handle for a vertex.
+     *
+     * If the first vertex is removed, its successor becomes the first vertex.
+     * The handle \e k is no longer valid after this call.
+     **********************************************************************/
+    void Remove(size_t k);
+
+    /**
+     * Return the results for the polygon.
+     *
+     * @param[in] reverse if true then clockwise (instead of counter-clockwise)
+     *   traversal counts as a positive area.
+     * @param[in] sign if true then return a signed result for the area if
+     *   the polygon is traversed in the "wrong" direction instead of returning
+     *   the area for the rest of the earth.
+     * @param[out] perimeter the perimeter of the polygon or length of the
+     *   polyline (meters).
+     * @param[out] area the area of the polygon (meters<sup>2</sup>); only set
+     *   if \e polyline is false in the constructor.
+     * @return the number of points.
+     *
+     * The arguments have the same meaning as for PolygonAreaT::Compute.  No
+     * geodesic problems are solved by this function.
+     **********************************************************************/
+    unsigned Compute(bool reverse, bool sign,
+                     real& perimeter, real& area) const;
+
+    /** \name Traversing the vertices
+     **********************************************************************/
+    ///@{
+    /**
+     * @return the handle for the first vertex or PolygonEditT::NONE if the
+     *   polygon has no vertices.
+     **********************************************************************/
+    size_t First() const { return _first; }
+
+    /**
+     * @param[in] k the handle for a vertex.
+     * @exception GeographicErr if \e k is not the handle for a vertex.
+     * @return the handle for the following vertex (the first vertex follows
+     *   the last).
+     **********************************************************************/
+    size_t Next(size_t k) const { Check(k); return _vertices[k].next; }
+
+    /**
+     * @param[in] k the handle for a vertex.
+     * @exception GeographicErr if \e k is not the handle for a vertex.
+     * @return the handle for the preceding vertex (the last vertex precedes
+     *   the first).
+     **********************************************************************/
+    size_t Previous(size_t k) const { Check(k); return _vertices[k].prev; }
+
+    /**
+     * @return the handle for the last vertex or PolygonEditT::NONE if the
+     *   polygon has no vertices.
+     **********************************************************************/
+    size_t Last() const
+    { return _first == NONE ? NONE : _vertices[_first].prev; }
+
+    /**
+     * @param[in] k the handle for a vertex.
+     * @param[out] lat the latitude of the vertex (degrees).
+     * @param[out] lon the longitude of the vertex (degrees).
+     * @exception GeographicErr if \e k is not the handle for a vertex.
+     **********************************************************************/
+    void Vertex(size_t k, real& lat, real& lon) const {
+      Check(k); lat = _vertices[k].lat; lon = _vertices[k].lon;
+    }
+
+    ///@}
+
+    /** \name Inspector functions
+     **********************************************************************/
+    ///@{
+    /**
+     * @return the number of vertices.
+     **********************************************************************/
+    unsigned NumberPoints() const { return _num; }
+
+    /**
+     * @return \e a the equatorial radius of the ellipsoid (meters).  This is
+     *   the value inherited from the Geodesic object used in the constructor.
+     **********************************************************************/
+    Math::real EquatorialRadius() const { return _earth.EquatorialRadius(); }
+
+    /**
+     * @return \e f the flattening of the ellipsoid.  This is the value
+     *   inherited from the Geodesic object used in the constructor.
+     **********************************************************************/
+    Math::real Flattening() const { return _earth.Flattening(); }
+    ///@}
+
+  };
+
+  template<class GeodType> const size_t PolygonEditT<GeodType>::NONE;
+
+  /**
+   * @relates PolygonEditT
+   *
+   * Editable polygons using Geodesic.
+   **********************************************************************/
+  typedef PolygonEditT<Geodesic> PolygonEdit;
+
+  /**
+   * @relates PolygonEditT
+   *
+   * Editable polygons using GeodesicExact.
+   **********************************************************************/
+  typedef PolygonEditT<GeodesicExact> PolygonEditExact;
+
+  /**
+   * @relates PolygonEditT
+   *
+   * Editable polygons using Rhumb.
+   **********************************************************************/
+  typedef PolygonEditT<Rhumb> PolygonEditRhumb;
+
+} // namespace GeographicLib
+
+#if defined(_MSC_VER)
+#  pragma warning (pop)
+#endif
+
+#endif  // GEOGRAPHICLIB_POLYGONEDIT_HPP
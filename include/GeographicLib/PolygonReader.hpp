@@ -0,0 +1,163 @@
+/**
+ * \file PolygonReader.hpp
+ * \brief Header for GeographicLib::PolygonReader class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_POLYGONREADER_HPP)
+#define GEOGRAPHICLIB_POLYGONREADER_HPP 1
+
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <vector>
+#include <GeographicLib/Constants.hpp>
+
+#if defined(_MSC_VER)
+// Squelch warnings about dll vs string
+#  pragma warning (push)
+#  pragma warning (disable: 4251)
+#endif
+
+namespace GeographicLib {
+
+  /**
+   * \brief Read polygons from GeoJSON or WKB
+   *
+   * This reads the features in a stream of GeoJSON or WKB (well-known
+   * binary) one at a time and appends their rings to flat buffers with the
+   * layout used by PolygonAreaT::ComputeBatch for polygons with holes.  The
+   * input is parsed as it is read, so the stream may hold any number of
+   * features without being held in memory.
+   *
+   * GeoJSON input may be a FeatureCollection, a Feature, or a geometry, or
+   * a sequence of these (as in newline-delimited GeoJSON or GeoJSON text
+   * sequences).  Each Feature of a FeatureCollection is a separate feature.
+   * WKB input is a sequence of geometries, either as binary (as written by
+   * most libraries) or as hexadecimal text (as written by PostGIS); the
+   * extended WKB of PostGIS and the Z and M coordinates of ISO WKB are
+   * accepted.  The hexadecimal form is detected by the first character.
+   *
+   * The rings of Polygon, MultiPolygon, LineString, and MultiLineString
+   * geometries and of GeometryCollections of these are returned; so a
+   * MultiPolygon with holes gives a single feature with all the outer rings
+   * and holes.  Point and MultiPoint geometries contribute no rings.  The
+   * longitude and latitude are the first two coordinates of each position
+   * and any further coordinates are ignored.  A closing vertex which repeats
+   * the first vertex of a ring is dropped.  GeoJSON specifies that the outer
+   * rings are counter-clockwise and the holes clockwise, which is the
+   * convention of PolygonAreaT::ComputeBatch with \e reverse = false.
+   *
+   * Malformed input results in a GeographicErr exception.
+   *
+   * Example of use:
+   * \code
+   * std::ifstream in("parcels.geojson");
+   * PolygonReader reader(in, PolygonReader::GEOJSON);
+   * std::vector<size_t> polyoffsets(1, 0), ringoffsets(1, 0);
+   * std::vector<double> lat, lon;
+   * while (reader.Next(ringoffsets, lat, lon))
+   *   polyoffsets.push_back(ringoffsets.size() - 1);
+   * size_t n = polyoffsets.size() - 1;
+   * std::vector<double> perimeter(n), area(n);
+   * PolygonArea poly(Geodesic::WGS84());
+   * poly.ComputeBatch(n, polyoffsets.data(), ringoffsets.data(),
+   *                   lat.data(), lon.data(), false, true,
+   *                   perimeter.data(), area.data());
+   * \endcode
+   **********************************************************************/
+  class GEOGRAPHICLIB_EXPORT PolygonReader {
+  public:
+    /**
+     * The input formats.
+     **********************************************************************/
+    enum format {
+      /**
+       * GeoJSON (RFC 7946).
+       * @hideinitializer
+       **********************************************************************/
+      GEOJSON = 0,
+      /**
+       * Well-known binary, binary or hexadecimal.
+       * @hideinitializer
+       **********************************************************************/
+      WKB = 1,
+    };
+  private:
+    typedef Math::real real;
+    std::streambuf* _buf;
+    format _fmt;
+    bool _incollection, _first, _hex, _started, _little;
+    size_t _count;
+    std::string _tok;
+    int peek() { return _buf->sgetc(); }
+    int get() { return _buf->sbumpc(); }
+    [[noreturn]] void error(const std::string& msg) const;
+    // GeoJSON
+    void skipws();
+    void expect(char c);
+    void String(std::string& s);
+    real Number();
+    void Skip();
+    void FinishObject();
+    int Coordinates(std::vector<size_t>& ringoffsets,
+                    std::vector<real>& lat, std::vector<real>& lon);
+    bool Object(bool top, std::vector<size_t>& ringoffsets,
+                std::vector<real>& lat, std::vector<real>& lon);
+    // WKB
+    unsigned char Byte();
+    std::uint32_t U32(bool little);
+    double F64(bool little);
+    void Geometry(int depth, std::vector<size_t>& ringoffsets,
+                  std::vector<real>& lat, std::vector<real>& lon);
+    // Close a ring starting at vertex start
+    static void Ring(size_t start, std::vector<size_t>& ringoffsets,
+                     std::vector<real>& lat, std::vector<real>& lon);
+  public:
+
+    /**
+     * Constructor.
+     *
+     * @param[in] in the input stream; it should be opened in binary mode for
+     *   binary WKB.
+     * @param[in] fmt the format of the input.
+     **********************************************************************/
+    PolygonReader(std::istream& in, format fmt);
+
+    /**
+     * Read the next feature.
+     *
+     * @param[in,out] ringoffsets the offsets of the ends of the rings are
+     *   appended to this; it must be nonempty and its last element must be
+     *   lat.size().
+     * @param[in,out] lat the latitudes of the vertices (degrees) are
+     *   appended to this.
+     * @param[in,out] lon the longitudes of the vertices (degrees) are
+     *   appended to this.
+     * @exception GeographicErr if the input is malformed.
+     * @return false if the end of the input has been reached.
+     *
+     * After a successful call, append ringoffsets.size() &minus; 1 to the
+     * array of polygon offsets to delimit the rings of this feature.  A
+     * feature may have no rings.
+     **********************************************************************/
+    bool Next(std::vector<size_t>& ringoffsets,
+              std::vector<real>& lat, std::vector<real>& lon);
+
+    /**
+     * @return the number of features read so far.
+     **********************************************************************/
+    size_t Count() const { return _count; }
+
+  };
+
+} // namespace GeographicLib
+
+#if defined(_MSC_VER)
+#  pragma warning (pop)
+#endif
+
+#endif  // GEOGRAPHICLIB_POLYGONREADER_HPP
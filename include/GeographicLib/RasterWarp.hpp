@@ -0,0 +1,187 @@
+/**
+ * \file RasterWarp.hpp
+ * \brief Header for GeographicLib::RasterWarp class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_RASTERWARP_HPP)
+#define GEOGRAPHICLIB_RASTERWARP_HPP 1
+
+#include <GeographicLib/ApproxTransform.hpp>
+
+namespace GeographicLib {
+
+  /**
+   * \brief Warp a raster from one projection to another
+   *
+   * This resamples a raster defined on a regular grid in one projection (the
+   * source) onto a regular grid in another projection (the destination).
+   * The caller supplies the transformation from the destination coordinates
+   * to the source coordinates as a function which transforms arrays of
+   * points, typically the reverse projection for the destination followed
+   * by the forward projection for the source.  For each destination pixel,
+   * the source coordinates are found with ApproxTransform (with a default
+   * tolerance of 1/8 of a source pixel) and the source raster is then
+   * sampled at this point by one of three methods:
+   * - NEAREST takes the value of the nearest source pixel;
+   * - BILINEAR interpolates the 2 &times; 2 surrounding source pixels
+   *   linearly;
+   * - CUBIC interpolates the 4 &times; 4 surrounding source pixels with the
+   *   cubic convolution kernel of Keys (with \e a = &minus;1/2).
+   *
+   * A destination pixel is set to a \e nodata value if the transformation
+   * gives NaNs or if the point falls outside the footprint of the source
+   * raster.  Pixel indices outside the source raster needed by BILINEAR and
+   * CUBIC near its edges are clamped to the edge.  NaNs in the source raster
+   * propagate to the destination pixels which depend on them.
+   *
+   * The rows of the destination raster are split into bands which are
+   * processed on several threads using GeodesicBatchExecutor::ForEach; so
+   * the transformation must be safe to call from several threads at once
+   * (the projection classes are).  The results don't depend on the number
+   * of threads.
+   *
+   * Example of use:
+   * \code
+   * // Warp a raster in UTM zone 32 to Lambert conformal conic
+   * LambertConformalConic lcc(Constants::WGS84_a(), Constants::WGS84_f(),
+   *                           45, 55, 1);
+   * const TransverseMercator& tm = TransverseMercator::UTM();
+   * RasterWarp::transform f =
+   *   [&lcc, &tm](size_t n, const double x[], const double y[],
+   *               double u[], double v[]) -> void {
+   *     for (size_t i = 0; i < n; ++i) {
+   *       double lat, lon;
+   *       lcc.Reverse(10, x[i], y[i], lat, lon);
+   *       tm.Forward(9, lat, lon, u[i], v[i]);
+   *       u[i] += 500000;
+   *     }
+   *   };
+   * RasterWarp::Grid src = {400005, 5400005, 10, 10, 5000, 4000},
+   *   dst = {-40000, 80000, 20, 20, 2000, 2000};
+   * RasterWarp warp(src, dst, f);
+   * warp.Warp(srcdata, dstdata);
+   * \endcode
+   **********************************************************************/
+  class GEOGRAPHICLIB_EXPORT RasterWarp {
+  public:
+    /**
+     * The type of the transformation from destination to source coordinates.
+     **********************************************************************/
+    typedef ApproxTransform::transform transform;
+    /**
+     * The definition of a raster.  The pixel (\e i, \e j), for 0 &le; \e i
+     * < \e nx and 0 &le; \e j < \e ny, has center (\e x0 + \e i \e dx, \e y0
+     * + \e j \e dy) and is stored in element \e j \e nx + \e i of the data.
+     * \e dx and \e dy may be negative.
+     **********************************************************************/
+    struct Grid {
+      Math::real x0, y0, dx, dy;
+      int nx, ny;
+    };
+    /**
+     * The resampling methods.
+     **********************************************************************/
+    enum resampling {
+      /**
+       * Nearest neighbor.
+       * @hideinitializer
+       **********************************************************************/
+      NEAREST = 0,
+      /**
+       * Bilinear interpolation.
+       * @hideinitializer
+       **********************************************************************/
+      BILINEAR = 1,
+      /**
+       * Cubic convolution.
+       * @hideinitializer
+       **********************************************************************/
+      CUBIC = 2,
+    };
+  private:
+    typedef Math::real real;
+    // The number of rows in the unit of work
+    static const int rows_ = 64;
+    Grid _src, _dst;
+    ApproxTransform _approx;
+    resampling _method;
+    unsigned _nthreads;
+    // Check the grids and convert tol to the units of the source
+    static real SourceTolerance(const Grid& src, const Grid& dst, real tol);
+    template<typename T>
+    void WarpT(const T src[], T dst[], T nodata) const;
+  public:
+
+    /**
+     * Constructor.
+     *
+     * @param[in] src the definition of the source raster.
+     * @param[in] dst the definition of the destination raster.
+     * @param[in] f the transformation from destination to source
+     *   coordinates.
+     * @param[in] method the resampling method (default BILINEAR).
+     * @param[in] tol the tolerance for the transformation in units of the
+     *   source pixels (default 1/8).
+     * @param[in] nthreads the number of threads; 0 (the default) means use
+     *   std::thread::hardware_concurrency().
+     * @exception GeographicErr if \e src or \e dst has non-positive
+     *   dimensions or zero spacings, if \e method is invalid, or if \e tol is
+     *   not positive.
+     **********************************************************************/
+    RasterWarp(const Grid& src, const Grid& dst, const transform& f,
+               resampling method = BILINEAR, real tol = real(0.125),
+               unsigned nthreads = 0);
+
+    /**
+     * Warp a raster of floats.
+     *
+     * @param[in] src the source data with \e src.nx \e src.ny elements.
+     * @param[out] dst the destination data with \e dst.nx \e dst.ny
+     *   elements.
+     * @param[in] nodata the value for destination pixels which lie outside
+     *   the source raster (default NaN).
+     **********************************************************************/
+    void Warp(const float src[], float dst[],
+              float nodata = std::numeric_limits<float>::quiet_NaN()) const;
+
+    /**
+     * Warp a raster of doubles.
+     *
+     * @param[in] src the source data with \e src.nx \e src.ny elements.
+     * @param[out] dst the destination data with \e dst.nx \e dst.ny
+     *   elements.
+     * @param[in] nodata the value for destination pixels which lie outside
+     *   the source raster (default NaN).
+     **********************************************************************/
+    void Warp(const double src[], double dst[],
+              double nodata = std::numeric_limits<double>::quiet_NaN())
+      const;
+
+    /** \name Inspector functions
+     **********************************************************************/
+    ///@{
+    /**
+     * @return the definition of the source raster.
+     **********************************************************************/
+    const Grid& Source() const { return _src; }
+
+    /**
+     * @return the definition of the destination raster.
+     **********************************************************************/
+    const Grid& Destination() const { return _dst; }
+
+    /**
+     * @return the resampling method.
+     **********************************************************************/
+    resampling Method() const { return _method; }
+    ///@}
+
+  };
+
+} // namespace GeographicLib
+
+#endif  // GEOGRAPHICLIB_RASTERWARP_HPP
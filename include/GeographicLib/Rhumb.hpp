@@ -10,8 +10,10 @@
 #if !defined(GEOGRAPHICLIB_RHUMB_HPP)
 #define GEOGRAPHICLIB_RHUMB_HPP 1
 
+#include <vector>
 #include <GeographicLib/Constants.hpp>
 #include <GeographicLib/Ellipsoid.hpp>
+#include <GeographicLib/Densifier.hpp>
 
 #if !defined(GEOGRAPHICLIB_RHUMBAREA_ORDER)
 /**
@@ -68,6 +70,7 @@ namespace GeographicLib {
     typedef Math::real real;
     friend class RhumbLine;
     template<class T> friend class PolygonAreaT;
+    template<class T> friend class PolygonEditT;
     Ellipsoid _ell;
     bool _exact;
     real _c2;
@@ -75,6 +78,13 @@ namespace GeographicLib {
     static const int maxpow_ = GEOGRAPHICLIB_RHUMBAREA_ORDER;
     // _rR[0] unused
     real _rR[maxpow_ + 1];
+    // In exact mode, the Fourier coefficients for the rectifying latitude mu
+    // in terms of the conformal latitude chi, mu = chi + sum(_cR[j] *
+    // sin(2*j*chi), j = 1..n), and vice versa, chi = mu + sum(_rC[j] *
+    // sin(2*j*mu)); these are computed by the constructor.  _cR[0] and
+    // _rC[0] are unused.  Both are empty if too many terms are needed, in
+    // which case elliptic integrals are used instead.
+    std::vector<real> _cR, _rC;
     static real gd(real x)
     { using std::atan; using std::sinh; return atan(sinh(x)); }
 
@@ -172,13 +182,39 @@ namespace GeographicLib {
     // (chix - chiy) / (mux - muy) using Krueger's series
     real DRectifyingToConformal(real mux, real muy) const;
 
+    // mu and its inverse (in degrees) using _cR and _rC if available
+    real RectifyingLatitude(real lat) const;
+    real InverseRectifyingLatitude(real mu) const;
+
+    // The quantities for an end point of an inverse problem which don't
+    // depend on the other end: the isometric latitude psi (in degrees), psir
+    // = psi in radians, gd(psir), sinh(psir), cosh(psir) (only if the area
+    // is needed), and the latitude recovered from psi (only if it's needed
+    // for the distance).
+    struct invpoint {
+      real psi, psir, gdr, shr, chr, lat;
+    };
+    invpoint InversePoint(real lat, unsigned outmask) const;
+    void GenInverse(real lon1, const invpoint& p1,
+                    real lon2, const invpoint& p2, unsigned outmask,
+                    real& s12, real& azi12, real& S12) const;
+    // The quantities for a point on a rhumb line: the rectifying latitude
+    // mur (in radians), the latitude, and the tangent of the conformal
+    // latitude.
+    struct dirpoint {
+      real mur, lat, t;
+    };
+    // mu is in degrees and should be in [-90, 90]
+    dirpoint DirectPoint(real mu) const;
+
     // (mux - muy) / (psix - psiy)
-    // N.B., psix and psiy are in degrees
-    real DIsometricToRectifying(real psix, real psiy) const;
+    real DIsometricToRectifying(const invpoint& x, const invpoint& y) const;
     // (psix - psiy) / (mux - muy)
-    real DRectifyingToIsometric(real mux, real muy) const;
+    real DRectifyingToIsometric(const dirpoint& x, const dirpoint& y) const;
 
+    // N.B., psi1 and psi2 are in radians
     real MeanSinXi(real psi1, real psi2) const;
+    real MeanSinXi(const invpoint& x, const invpoint& y) const;
 
     // The following two functions (with lots of ignored arguments) mimic the
     // interface to the corresponding Geodesic function.  These are needed by
@@ -250,13 +286,26 @@ namespace GeographicLib {
      * @param[in] a equatorial radius (meters).
      * @param[in] f flattening of ellipsoid.  Setting \e f = 0 gives a sphere.
      *   Negative \e f gives a prolate ellipsoid.
-     * @param[in] exact if true (the default) use an addition theorem for
-     *   elliptic integrals to compute divided differences; otherwise use
-     *   series expansion (accurate for |<i>f</i>| < 0.01).
+     * @param[in] exact if true (the default) use an accurate Fourier series
+     *   for conversions between the conformal and rectifying latitudes (or,
+     *   for very large flattenings, an addition theorem for elliptic
+     *   integrals) to compute divided differences; otherwise use series
+     *   expansion (accurate for |<i>f</i>| < 0.01).
      * @exception GeographicErr if \e a or (1 &minus; \e f) \e a is not
      *   positive.
      *
      * See \ref rhumb, for a detailed description of the \e exact parameter.
+     *
+     * With \e exact = true, the constructor computes the Fourier series for
+     * the conversions between the conformal and rectifying latitudes (with as
+     * many terms as needed for full accuracy) by sampling these conversions,
+     * which are given in terms of elliptic integrals.  The divided
+     * differences are then evaluated with this series in the same way as
+     * with \e exact = false, so that the cost of solving rhumb problems is
+     * close to that for \e exact = false.  If more than 255 terms would be
+     * needed (roughly, <i>f</i> &gt; 0.6 or <i>f</i> &lt; &minus;1), the
+     * accumulation of roundoff errors in the series would be excessive and
+     * the addition theorem for elliptic integrals is used instead.
      **********************************************************************/
     Rhumb(real a, real f, bool exact = true);
 
@@ -327,6 +376,37 @@ namespace GeographicLib {
     void GenDirect(real lat1, real lon1, real azi12, real s12,
                    unsigned outmask, real& lat2, real& lon2, real& S12) const;
 
+    /**
+     * Solve several direct rhumb problems.
+     *
+     * @param[in] n the number of problems to solve.
+     * @param[in] lat1 array of latitudes of point 1 (degrees).
+     * @param[in] lon1 array of longitudes of point 1 (degrees).
+     * @param[in] azi12 array of azimuths of the rhumb lines (degrees).
+     * @param[in] s12 array of distances between point 1 and point 2
+     *   (meters).
+     * @param[in] outmask a bitor'ed combination of Rhumb::mask values
+     *   specifying which of the following arrays should be set.
+     * @param[out] lat2 array of latitudes of point 2 (degrees).
+     * @param[out] lon2 array of longitudes of point 2 (degrees).
+     * @param[out] S12 array of areas under the rhumb lines
+     *   (meters<sup>2</sup>).
+     *
+     * All the arrays have (at least) \e n elements.  Element \e i of the
+     * outputs is the result which Rhumb::GenDirect returns for element \e i
+     * of the inputs; so the results are identical to those obtained by
+     * calling Rhumb::GenDirect in a loop.  Any of the output arrays may be
+     * null, in which case the corresponding quantity is not computed.  The
+     * output arrays should not alias the input arrays.
+     *
+     * To compute several points along a single rhumb line, use
+     * RhumbLine::PositionBatch instead.
+     **********************************************************************/
+    void DirectBatch(size_t n,
+                     const real lat1[], const real lon1[], const real azi12[],
+                     const real s12[], unsigned outmask,
+                     real lat2[], real lon2[], real S12[]) const;
+
     /**
      * Solve the inverse rhumb problem returning also the area.
      *
@@ -388,6 +468,137 @@ namespace GeographicLib {
                     unsigned outmask,
                     real& s12, real& azi12, real& S12) const;
 
+    /**
+     * Solve several inverse rhumb problems.
+     *
+     * @param[in] n the number of problems to solve.
+     * @param[in] lat1 array of latitudes of point 1 (degrees).
+     * @param[in] lon1 array of longitudes of point 1 (degrees).
+     * @param[in] lat2 array of latitudes of point 2 (degrees).
+     * @param[in] lon2 array of longitudes of point 2 (degrees).
+     * @param[in] outmask a bitor'ed combination of Rhumb::mask values
+     *   specifying which of the following arrays should be set.
+     * @param[out] s12 array of rhumb distances between point 1 and point 2
+     *   (meters).
+     * @param[out] azi12 array of azimuths of the rhumb lines (degrees).
+     * @param[out] S12 array of areas under the rhumb lines
+     *   (meters<sup>2</sup>).
+     *
+     * All the arrays have (at least) \e n elements.  Element \e i of the
+     * outputs is the result which Rhumb::GenInverse returns for element \e i
+     * of the inputs; so the results are identical to those obtained by
+     * calling Rhumb::GenInverse in a loop.  Any of the output arrays may be
+     * null, in which case the corresponding quantity is not computed.  The
+     * output arrays should not alias the input arrays.
+     *
+     * If \e lat1[\e i] equals \e lat2[\e i &minus; 1], as happens when the
+     * problems are the successive edges of a polyline, the quantities
+     * depending on this latitude are computed once for both problems.
+     **********************************************************************/
+    void InverseBatch(size_t n,
+                      const real lat1[], const real lon1[],
+                      const real lat2[], const real lon2[],
+                      unsigned outmask,
+                      real s12[], real azi12[], real S12[]) const;
+
+    /**
+     * \brief The first point of several inverse rhumb problems
+     *
+     * This is returned by Rhumb::InverseFrom.  It holds the quantities for
+     * point 1 which don't depend on point 2 (the isometric latitude and the
+     * hyperbolic functions of it which enter the rectifying latitude and
+     * area series), so that these are computed only once when solving the
+     * inverse problems from one point to many others.  The results are
+     * identical to those given by the corresponding functions of Rhumb.
+     *
+     * An InverseOrigin holds a pointer to the Rhumb object which created it
+     * and so it must not outlive that object.  It may be used concurrently by
+     * several threads.
+     **********************************************************************/
+    class GEOGRAPHICLIB_EXPORT InverseOrigin {
+    private:
+      friend class Rhumb;
+      const Rhumb* _rh;
+      real _lon1;
+      invpoint _p1;
+      InverseOrigin(const Rhumb& rh, real lat1, real lon1)
+        : _rh(&rh)
+        , _lon1(lon1)
+        , _p1(rh.InversePoint(lat1, ALL))
+      {}
+    public:
+
+      /**
+       * The general inverse rhumb calculation from the first point.
+       *
+       * @param[in] lat2 latitude of point 2 (degrees).
+       * @param[in] lon2 longitude of point 2 (degrees).
+       *
+       * The remaining arguments are the same as for Rhumb::GenInverse.
+       **********************************************************************/
+      void GenInverse(real lat2, real lon2, unsigned outmask,
+                      real& s12, real& azi12, real& S12) const {
+        _rh->GenInverse(_lon1, _p1, lon2, _rh->InversePoint(lat2, outmask),
+                        outmask, s12, azi12, S12);
+      }
+
+      /**
+       * Solve the inverse rhumb problem from the first point.
+       *
+       * @param[in] lat2 latitude of point 2 (degrees).
+       * @param[in] lon2 longitude of point 2 (degrees).
+       * @param[out] s12 rhumb distance between point 1 and point 2 (meters).
+       * @param[out] azi12 azimuth of the rhumb line (degrees).
+       * @param[out] S12 area under the rhumb line (meters<sup>2</sup>).
+       **********************************************************************/
+      void Inverse(real lat2, real lon2,
+                   real& s12, real& azi12, real& S12) const {
+        GenInverse(lat2, lon2, DISTANCE | AZIMUTH | AREA, s12, azi12, S12);
+      }
+
+      /**
+       * Solve the inverse rhumb problem from the first point without the
+       * area.
+       **********************************************************************/
+      void Inverse(real lat2, real lon2, real& s12, real& azi12) const {
+        real t;
+        GenInverse(lat2, lon2, DISTANCE | AZIMUTH, s12, azi12, t);
+      }
+
+      /**
+       * Solve several inverse rhumb problems from the first point.
+       *
+       * @param[in] n the number of problems to solve.
+       * @param[in] lat2 array of latitudes of point 2 (degrees).
+       * @param[in] lon2 array of longitudes of point 2 (degrees).
+       *
+       * The remaining arguments are the same as for Rhumb::InverseBatch.
+       **********************************************************************/
+      void InverseBatch(size_t n, const real lat2[], const real lon2[],
+                        unsigned outmask,
+                        real s12[], real azi12[], real S12[]) const;
+    };
+
+    /**
+     * Set up to solve several inverse rhumb problems with the same first
+     * point.
+     *
+     * @param[in] lat1 latitude of point 1 (degrees).
+     * @param[in] lon1 longitude of point 1 (degrees).
+     * @return an InverseOrigin object.
+     *
+     * This is useful for finding the rhumb distances from one point to many
+     * others, e.g., from a port to a set of waypoints.  Example:
+     * \code
+     * const Rhumb& rhumb = Rhumb::WGS84();
+     * Rhumb::InverseOrigin jfk = rhumb.InverseFrom(40.6, -73.8);
+     * double s12, azi12;
+     * jfk.Inverse(51.6, -0.5, s12, azi12);   // rhumb line to LHR
+     * \endcode
+     **********************************************************************/
+    InverseOrigin InverseFrom(real lat1, real lon1) const
+    { return InverseOrigin(*this, lat1, lon1); }
+
     /**
      * Set up to compute several points on a single rhumb line.
      *
@@ -432,9 +643,29 @@ namespace GeographicLib {
 
     /**
      * A global instantiation of Rhumb with the parameters for the WGS84
-     * ellipsoid.
+     * ellipsoid.  This is constructed when the library is loaded (see
+     * Geodesic::WGS84()).
      **********************************************************************/
     static const Rhumb& WGS84();
+
+    /**
+     * A shared instance of Rhumb for a given ellipsoid.
+     *
+     * @param[in] a equatorial radius (meters).
+     * @param[in] f flattening of ellipsoid.
+     * @param[in] exact whether to use the accurate Fourier series (see the
+     *   constructor; default true).
+     * @exception GeographicErr if \e a or (1 &minus; \e f) \e a is not
+     *   positive.
+     * @return a Rhumb object with these parameters.
+     *
+     * The first call with a given set of parameters constructs the object and
+     * later calls return the same object; see SharedInstances for the
+     * details.  Finding an existing object doesn't take a lock and costs
+     * much less than constructing it.  The object lives until the program
+     * exits.
+     **********************************************************************/
+    static const Rhumb& Get(real a, real f, bool exact = true);
   };
 
   /**
@@ -461,6 +692,7 @@ namespace GeographicLib {
     friend class Rhumb;
     const Rhumb& _rh;
     real _lat1, _lon1, _azi12, _salp, _calp, _mu1, _psi1, _r1;
+    Rhumb::dirpoint _p1;
     // copy assignment not allowed
     RhumbLine& operator=(const RhumbLine&) = delete;
     RhumbLine(const Rhumb& rh, real lat1, real lon1, real azi12);
@@ -576,6 +808,63 @@ namespace GeographicLib {
     void GenPosition(real s12, unsigned outmask,
                      real& lat2, real& lon2, real& S12) const;
 
+    /**
+     * Compute several points on the rhumb line.
+     *
+     * @param[in] n the number of points.
+     * @param[in] s12 array of distances between point 1 and point 2
+     *   (meters).
+     * @param[in] outmask a bitor'ed combination of RhumbLine::mask values
+     *   specifying which of the following arrays should be set.
+     * @param[out] lat2 array of latitudes of point 2 (degrees).
+     * @param[out] lon2 array of longitudes of point 2 (degrees).
+     * @param[out] S12 array of areas under the rhumb line
+     *   (meters<sup>2</sup>).
+     *
+     * All the arrays have (at least) \e n elements.  Element \e i of the
+     * outputs is the result which RhumbLine::GenPosition returns for element
+     * \e i of \e s12.  The quantities depending only on point 1 and the
+     * azimuth, which are computed when the RhumbLine object is constructed,
+     * are shared by all the points, so this is the efficient way to compute
+     * many points along a track.  Any of the output arrays may be null, in
+     * which case the corresponding quantity is not computed.  The output
+     * arrays should not alias \e s12.
+     **********************************************************************/
+    void PositionBatch(size_t n, const real s12[], unsigned outmask,
+                       real lat2[], real lon2[], real S12[]) const;
+
+    /**
+     * Densify the rhumb line adaptively for plotting on a map.
+     *
+     * @tparam P the type of the projection.
+     * @param[in] s13 the distance from point 1 to the end of the rhumb line
+     *   (meters).
+     * @param[in] proj the projection; proj(lat, lon, x, y) sets \e x and \e y
+     *   to the projected coordinates of (\e lat, \e lon).
+     * @param[in] tol the tolerance on the deviation of the polyline from the
+     *   projected rhumb line (in the units of \e x and \e y).
+     * @param[out] lat the latitudes of the vertices of the polyline (degrees).
+     * @param[out] lon the longitudes of the vertices of the polyline
+     *   (degrees).
+     * @param[in] maxdepth the maximum number of times a segment is split
+     *   (default 12).
+     *
+     * The vertices are chosen by Densifier::Path with the parameter \e t
+     * being the distance along the rhumb line.  The longitudes are unrolled.
+     * A rhumb line is straight in the Mercator projection, so in this case
+     * only the end points are returned.
+     **********************************************************************/
+    template<class P>
+    void Densify(real s13, const P& proj, real tol,
+                 std::vector<real>& lat, std::vector<real>& lon,
+                 unsigned maxdepth = 12) const {
+      Densifier::Path([this](real s12, real& lat2, real& lon2) -> void {
+                        real t;
+                        GenPosition(s12, LATITUDE | LONGITUDE | LONG_UNROLL,
+                                    lat2, lon2, t);
+                      }, proj, s13, tol, maxdepth, lat, lon);
+    }
+
     /** \name Inspector functions
      **********************************************************************/
     ///@{
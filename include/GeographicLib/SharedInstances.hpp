@@ -0,0 +1,128 @@
+/**
+ * \file SharedInstances.hpp
+ * \brief Header for GeographicLib::SharedInstances class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_SHAREDINSTANCES_HPP)
+#define GEOGRAPHICLIB_SHAREDINSTANCES_HPP 1
+
+#include <GeographicLib/Constants.hpp>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <utility>
+
+namespace GeographicLib {
+
+  /**
+   * \brief A registry of shared immutable objects keyed by their parameters
+   *
+   * This is used by Geodesic::Get, GeodesicExact::Get, Rhumb::Get, and
+   * TransverseMercator::Get to return a single instance for each set of
+   * parameters (e.g., the equatorial radius and the flattening), so that a
+   * program which receives the ellipsoid with each request doesn't pay for
+   * constructing the objects (which involves computing series coefficients)
+   * each time.  It is also used by Geoid::Get, GravityModel::Get, and
+   * MagneticModel::Get, with keys given by the name and the directory of
+   * the model, so that the data for a model is read only once however many
+   * threads use it.
+   *
+   * The instances are held in a singly linked list whose head is an atomic
+   * pointer.  A node is fully constructed before it is added to the front
+   * of the list and nodes are never removed or altered; so a lookup of an
+   * existing instance just walks the list without taking a lock.  Adding an
+   * instance takes a mutex (so that each instance is only constructed once).
+   * The instances live until the registry is destroyed, normally at program
+   * exit.  The lookup is linear in the number of instances, which is
+   * assumed to be small (a handful of ellipsoids or models).
+   *
+   * @tparam T the type of the objects.
+   * @tparam K the type of the key; this must support operator==.  The
+   *   default is an array of 4 reals.
+   **********************************************************************/
+  template<class T, class K = std::array<Math::real, 4> >
+  class SharedInstances {
+  public:
+    /**
+     * The type of the key identifying an instance; for the default type,
+     * unused elements should be set to 0.
+     **********************************************************************/
+    typedef K key_type;
+
+  private:
+    struct Node {
+      key_type key;
+      const Node* next;
+      T obj;
+      template<class... Args>
+      Node(const key_type& k, const Node* n, Args&&... args)
+        : key(k)
+        , next(n)
+        , obj(std::forward<Args>(args)...)
+      {}
+    };
+    std::atomic<const Node*> _head;
+    std::mutex _mutex;
+    static const Node* Find(const Node* p, const key_type& key) {
+      for (; p; p = p->next)
+        if (p->key == key) return p;
+      return nullptr;
+    }
+    SharedInstances(const SharedInstances&) = delete;
+    SharedInstances& operator=(const SharedInstances&) = delete;
+
+  public:
+    SharedInstances() : _head(nullptr) {}
+
+    ~SharedInstances() {
+      const Node* p = _head.load();
+      while (p) {
+        const Node* q = p->next;
+        delete p;
+        p = q;
+      }
+    }
+
+    /**
+     * Return the instance for a key, constructing it if necessary.
+     *
+     * @tparam Args the types of the arguments of T's constructor.
+     * @param[in] key the key.
+     * @param[in] args the arguments of T's constructor; these are only used
+     *   if there's no instance for \e key.
+     * @exception any exception thrown by T's constructor; in this case, no
+     *   instance is added.
+     * @return a reference to the instance.
+     **********************************************************************/
+    template<class... Args>
+    const T& Get(const key_type& key, Args&&... args) {
+      const Node* p = Find(_head.load(std::memory_order_acquire), key);
+      if (p) return p->obj;
+      std::lock_guard<std::mutex> lock(_mutex);
+      const Node* head = _head.load(std::memory_order_relaxed);
+      p = Find(head, key);
+      if (p) return p->obj;
+      p = new Node(key, head, std::forward<Args>(args)...);
+      _head.store(p, std::memory_order_release);
+      return p->obj;
+    }
+
+    /**
+     * @return the number of instances.
+     **********************************************************************/
+    size_t Size() const {
+      size_t n = 0;
+      for (const Node* p = _head.load(std::memory_order_acquire); p;
+           p = p->next)
+        ++n;
+      return n;
+    }
+  };
+
+} // namespace GeographicLib
+
+#endif  // GEOGRAPHICLIB_SHAREDINSTANCES_HPP
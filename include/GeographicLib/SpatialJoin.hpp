@@ -0,0 +1,185 @@
+/**
+ * \file SpatialJoin.hpp
+ * \brief Header for GeographicLib::SpatialJoin class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_SPATIALJOIN_HPP)
+#define GEOGRAPHICLIB_SPATIALJOIN_HPP 1
+
+#include <memory>
+#include <vector>
+#include <GeographicLib/PointInPolygon.hpp>
+#include <GeographicLib/Constants.hpp>
+
+#if defined(_MSC_VER)
+// Squelch warnings about dll vs vector
+#  pragma warning (push)
+#  pragma warning (disable: 4251)
+#endif
+
+namespace GeographicLib {
+
+  /**
+   * \brief Assign points to the polygons containing them
+   *
+   * This finds which of many polygons (e.g., administrative regions)
+   * contains each of many points.  The polygons may have holes and are
+   * given in the layout used by PolygonAreaT::ComputeBatch and
+   * PolygonReader; a point lies inside a polygon if it lies inside an odd
+   * number of its rings (tested with PointInPolygon).
+   *
+   * The constructor finds the latitude-longitude bounding box of each
+   * polygon (PointInPolygon::BoundingBox) and lists the polygons whose
+   * boxes overlap each cell of a grid which divides latitude and longitude
+   * uniformly.  The size of the cells is the median size of the boxes
+   * (subject to a limit on the number of cells), so that a typical box
+   * overlaps a few cells.  A query finds the cell containing the point,
+   * checks the boxes of the polygons listed for the cell, and tests the
+   * point against the rings of the polygons whose boxes contain it.
+   *
+   * FindBatch sorts the points by cell before the queries so that the
+   * points tested against the same polygons are handled together (which
+   * keeps the data for these polygons in the cache), and divides the sorted
+   * points among several threads with GeodesicBatchExecutor.  For very
+   * large numbers of points, call FindBatch on blocks of a few million
+   * points at a time to limit the memory used for the sorting.
+   *
+   * SpatialJoin objects are not altered once they have been constructed, so
+   * they can be shared by several threads.
+   *
+   * Example of use:
+   * \code
+   * std::ifstream in("regions.geojson");
+   * PolygonReader reader(in, PolygonReader::GEOJSON);
+   * std::vector<size_t> polyoffsets(1, 0), ringoffsets(1, 0);
+   * std::vector<double> lat, lon;
+   * while (reader.Next(ringoffsets, lat, lon))
+   *   polyoffsets.push_back(ringoffsets.size() - 1);
+   * SpatialJoin join(Geodesic::WGS84(), polyoffsets.size() - 1,
+   *                  polyoffsets.data(), ringoffsets.data(),
+   *                  lat.data(), lon.data());
+   * // plat, plon hold n points; id[i] = the polygon containing point i
+   * std::vector<size_t> id(n);
+   * join.FindBatch(n, plat.data(), plon.data(), id.data());
+   * \endcode
+   **********************************************************************/
+  class GEOGRAPHICLIB_EXPORT SpatialJoin {
+  private:
+    typedef Math::real real;
+    // The bounding box of a polygon and its rings [ring0, ring1)
+    struct Box {
+      real latmin, latmax, lonmin, dlon;
+      size_t ring0, ring1;
+    };
+    std::vector< std::shared_ptr<const PointInPolygon> > _rings;
+    std::vector<Box> _boxes;
+    int _nlat, _nlon;
+    real _dlat, _dlon;
+    // The polygons overlapping cell k are _cellpolys[_cellstart[k]] through
+    // _cellpolys[_cellstart[k+1]-1].
+    std::vector<size_t> _cellstart, _cellpolys;
+    int LatIndex(real lat) const;
+    int LonIndex(real lon) const;
+    size_t Cell(real lat, real lon) const
+    { return size_t(LatIndex(lat)) * size_t(_nlon) + size_t(LonIndex(lon)); }
+    size_t FindInCell(size_t k, real lat, real lon) const;
+  public:
+
+    /**
+     * The value returned for a point which isn't in any polygon.
+     **********************************************************************/
+    static const size_t npos = size_t(-1);
+
+    /**
+     * Constructor for SpatialJoin.
+     *
+     * @param[in] geod the Geodesic object to use for geodesic calculations.
+     * @param[in] npolygons the number of polygons.
+     * @param[in] polyoffsets array of \e npolygons + 1 offsets into \e
+     *   ringoffsets; the rings of polygon \e j are [\e polyoffsets[\e j],
+     *   \e polyoffsets[\e j + 1]).
+     * @param[in] ringoffsets array of offsets into \e lat and \e lon; the
+     *   vertices of ring \e i are [\e ringoffsets[\e i], \e
+     *   ringoffsets[\e i + 1]).
+     * @param[in] lat array of the latitudes of the vertices (degrees).
+     * @param[in] lon array of the longitudes of the vertices (degrees).
+     * @param[in] nthreads the number of threads to use to build the index;
+     *   if this is 0 (the default), use std::thread::hardware_concurrency().
+     * @exception std::bad_alloc if the memory for the index can't be
+     *   allocated.
+     *
+     * The conventions for the rings are those of the PointInPolygon
+     * constructor; in particular, the first vertex of a ring should not be
+     * repeated at its end.  The orientation of the rings doesn't matter
+     * (unless they encircle a pole).
+     **********************************************************************/
+    SpatialJoin(const Geodesic& geod, size_t npolygons,
+                const size_t polyoffsets[], const size_t ringoffsets[],
+                const real lat[], const real lon[],
+                unsigned nthreads = 0);
+
+    /**
+     * Find the polygon containing a point.
+     *
+     * @param[in] lat the latitude of the point (degrees).
+     * @param[in] lon the longitude of the point (degrees).
+     * @return the index of the polygon containing the point, or npos if no
+     *   polygon contains it.
+     *
+     * If several polygons contain the point, the one with the smallest
+     * index is returned.  Points on the boundary of a polygon may be
+     * reported as inside or outside it.
+     **********************************************************************/
+    size_t Find(real lat, real lon) const
+    { return FindInCell(Cell(lat, lon), lat, lon); }
+
+    /**
+     * Find the polygons containing many points.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lat array of latitudes of the points (degrees).
+     * @param[in] lon array of longitudes of the points (degrees).
+     * @param[out] id array of the results of Find for the points.
+     * @param[in] nthreads the number of threads to use; if this is 0 (the
+     *   default), use std::thread::hardware_concurrency().
+     * @exception std::bad_alloc if the memory for the sorting can't be
+     *   allocated.
+     *
+     * The arrays have (at least) \e n elements.  The results don't depend
+     * on \e nthreads.
+     **********************************************************************/
+    void FindBatch(size_t n, const real lat[], const real lon[], size_t id[],
+                   unsigned nthreads = 0) const;
+
+    /** \name Inspector functions
+     **********************************************************************/
+    ///@{
+    /**
+     * @return the number of polygons.
+     **********************************************************************/
+    size_t NumPolygons() const { return _boxes.size(); }
+
+    /**
+     * @return the number of rings.
+     **********************************************************************/
+    size_t NumRings() const { return _rings.size(); }
+
+    /**
+     * @return the number of cells in the grid.
+     **********************************************************************/
+    size_t NumCells() const { return size_t(_nlat) * size_t(_nlon); }
+    ///@}
+
+  };
+
+} // namespace GeographicLib
+
+#if defined(_MSC_VER)
+#  pragma warning (pop)
+#endif
+
+#endif  // GEOGRAPHICLIB_SPATIALJOIN_HPP
@@ -0,0 +1,150 @@
+/**
+ * \file SphericalAnalysis.hpp
+ * \brief Header for GeographicLib::SphericalAnalysis class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_SPHERICALANALYSIS_HPP)
+#define GEOGRAPHICLIB_SPHERICALANALYSIS_HPP 1
+
+#include <vector>
+#include <GeographicLib/Constants.hpp>
+#include <GeographicLib/SphericalHarmonic.hpp>
+
+namespace GeographicLib {
+
+  /**
+   * \brief Spherical harmonic analysis of gridded data
+   *
+   * This is the inverse of the synthesis carried out by SphericalHarmonic
+   * on the unit sphere (\e r = \e a).  Given the values of a function on a
+   * grid of latitudes and longitudes, it finds the coefficients
+   * <i>C</i><sub><i>nm</i></sub> and <i>S</i><sub><i>nm</i></sub> such that
+   * the sum evaluated by SphericalHarmonic reproduces the function.  The
+   * coefficients are returned in the layout expected by the constructors
+   * for SphericalHarmonic.
+   *
+   * The grid consists of \e nlat rows of \e nlon equally spaced points in
+   * longitude.  Two sets of latitudes are supported:
+   * - SphericalAnalysis::EQUIANGULAR, the colatitudes (<i>i</i> + 1/2)
+   *   180&deg;/\e nlat for \e i = 0 .. \e nlat &minus; 1, with the weights
+   *   of Fej&eacute;r's first quadrature rule; a function of degree up to
+   *   (\e nlat &minus; 1)/2 is analyzed exactly.
+   * - SphericalAnalysis::GAUSS, the latitudes whose sines are the nodes of
+   *   Gauss-Legendre quadrature; a function of degree up to \e nlat
+   *   &minus; 1 is analyzed exactly.
+   * .
+   * In both cases, the maximum order must be less than \e nlon / 2.
+   *
+   * The Fourier coefficients of each row are found with an FFT and the
+   * integrals over latitude are carried out with the quadrature weights.
+   * The associated Legendre functions are computed with the standard
+   * recursions; the sectoral values, which underflow near the poles for
+   * large orders, carry a separate binary exponent.  The FFTs are spread
+   * over several threads by rows and the Legendre sums by order, using
+   * GeodesicBatchExecutor.  The cost is proportional to \e nlat \e N
+   * \e M.
+   *
+   * Example of use:
+   * \code
+   * int N = 360, nlat = N + 1, nlon = 2 * N + 2;
+   * std::vector<double> lat, w, f(nlat * nlon), C, S;
+   * SphericalAnalysis::Latitudes(SphericalAnalysis::GAUSS, nlat, lat, w);
+   * // ... fill in f[i * nlon + j] at lat[i], j * 360.0 / nlon
+   * SphericalAnalysis::Analyze(SphericalAnalysis::GAUSS, nlat, nlon, 0,
+   *                            f.data(), N, N, C, S);
+   * SphericalHarmonic h(C, S, N, 1.0);
+   * \endcode
+   **********************************************************************/
+  class GEOGRAPHICLIB_EXPORT SphericalAnalysis {
+  private:
+    typedef Math::real real;
+    SphericalAnalysis() = delete; // Disable constructor
+
+  public:
+    /**
+     * Supported sets of latitudes for the grid.
+     **********************************************************************/
+    enum grid {
+      /**
+       * Equally spaced latitudes, excluding the poles.
+       * @hideinitializer
+       **********************************************************************/
+      EQUIANGULAR = 0,
+      /**
+       * The Gauss-Legendre latitudes.
+       * @hideinitializer
+       **********************************************************************/
+      GAUSS = 1,
+    };
+
+    /**
+     * The latitudes of the grid and the corresponding quadrature weights.
+     *
+     * @param[in] g the type of grid.
+     * @param[in] nlat the number of latitudes.
+     * @param[out] lat the latitudes of the rows of the grid (degrees),
+     *   from north to south.
+     * @param[out] w the quadrature weights for the rows of the grid; these
+     *   sum to 2, the integral of 1 over the sine of the latitude.
+     * @exception GeographicErr if \e nlat < 1.
+     **********************************************************************/
+    static void Latitudes(grid g, int nlat,
+                          std::vector<real>& lat, std::vector<real>& w);
+
+    /**
+     * The maximum degree which can be found from a grid.
+     *
+     * @param[in] g the type of grid.
+     * @param[in] nlat the number of latitudes.
+     * @return the maximum degree of a function which is analyzed exactly.
+     **********************************************************************/
+    static int MaxDegree(grid g, int nlat)
+    { return g == GAUSS ? nlat - 1 : (nlat - 1) / 2; }
+
+    /**
+     * Find the coefficients of a spherical harmonic sum from gridded data.
+     *
+     * @param[in] g the type of grid.
+     * @param[in] nlat the number of latitudes.
+     * @param[in] nlon the number of longitudes.
+     * @param[in] lon0 the longitude of the first column of the grid
+     *   (degrees).
+     * @param[in] f the values on the grid; \e f[\e i \e nlon + \e j] is the
+     *   value at latitude \e lat[\e i], as given by Latitudes, and longitude
+     *   \e lon0 + \e j 360&deg;/\e nlon.
+     * @param[in] N the maximum degree of the sum.
+     * @param[in] M the maximum order of the sum.
+     * @param[out] C the coefficients <i>C</i><sub><i>nm</i></sub>.
+     * @param[out] S the coefficients <i>S</i><sub><i>nm</i></sub>.
+     * @param[in] norm the normalization for the associated Legendre
+     *   polynomials, either SphericalHarmonic::FULL (the default) or
+     *   SphericalHarmonic::SCHMIDT.
+     * @param[in] nthreads the number of threads to use; if this is 0 (the
+     *   default), use std::thread::hardware_concurrency().
+     * @exception GeographicErr if \e N and \e M don't satisfy \e N &ge; \e M
+     *   &ge; 0, if \e N > MaxDegree(\e g, \e nlat), or if 2\e M &ge; \e
+     *   nlon.
+     * @exception std::bad_alloc if the memory for the intermediate results
+     *   can't be allocated.
+     *
+     * \e C and \e S are stored in column-major order as described for
+     * SphericalHarmonic and may be passed directly to its constructor, e.g.,
+     * SphericalHarmonic(\e C, \e S, \e N, \e N, \e M, \e a, \e norm).  The
+     * function is then reproduced on a sphere of radius \e a.  If the data
+     * include components above degree \e N, these are aliased into the
+     * results (as with any analysis on a finite grid).
+     **********************************************************************/
+    static void Analyze(grid g, int nlat, int nlon, real lon0,
+                        const real f[], int N, int M,
+                        std::vector<real>& C, std::vector<real>& S,
+                        unsigned norm = SphericalHarmonic::FULL,
+                        unsigned nthreads = 0);
+  };
+
+} // namespace GeographicLib
+
+#endif  // GEOGRAPHICLIB_SPHERICALANALYSIS_HPP
@@ -12,7 +12,10 @@
 
 #include <vector>
 #include <istream>
+#include <memory>
+#include <string>
 #include <GeographicLib/Constants.hpp>
+#include <GeographicLib/MemoryPolicy.hpp>
 
 #if defined(_MSC_VER)
 // Squelch warnings about dll vs vector
@@ -43,7 +46,7 @@ namespace GeographicLib {
     // CircularEngine needs access to sqrttable, scale
     friend class CircularEngine;
     // Return the table of the square roots of integers
-    static std::vector<real>& sqrttable();
+    static const real* sqrttable();
     // An internal scaling of the coefficients to avoid overflow in
     // intermediate calculations.
     static real scale() {
@@ -62,6 +65,8 @@ namespace GeographicLib {
       return std::numeric_limits<real>::epsilon() *
         sqrt(std::numeric_limits<real>::epsilon());
     }
+    // The number of points processed together by ValueBatch
+    static const int batchsize_ = 8;
     SphericalEngine();          // Disable constructor
   public:
     /**
@@ -99,8 +104,8 @@ namespace GeographicLib {
     class GEOGRAPHICLIB_EXPORT coeff {
     private:
       int _nNx, _nmx, _mmx;
-      std::vector<real>::const_iterator _cCnm;
-      std::vector<real>::const_iterator _sSnm;
+      const real* _cCnm;
+      const real* _sSnm;
     public:
       /**
        * A default constructor
@@ -127,8 +132,8 @@ namespace GeographicLib {
         : _nNx(N)
         , _nmx(nmx)
         , _mmx(mmx)
-        , _cCnm(C.begin())
-        , _sSnm(S.begin())
+        , _cCnm(C.data())
+        , _sSnm(S.data())
       {
         if (!((_nNx >= _nmx && _nmx >= _mmx && _mmx >= 0) ||
               // If mmx = -1 then the sums are empty so require nmx = -1 also.
@@ -139,6 +144,57 @@ namespace GeographicLib {
           throw GeographicErr("Arrays too small in coeff");
         SphericalEngine::RootTable(_nmx);
       }
+      /**
+       * A constructor using pointers to the coefficients.
+       *
+       * @param[in] C a pointer to the first coefficient
+       *   <i>C</i><sub>00</sub>.
+       * @param[in] S a pointer to the first coefficient
+       *   <i>S</i><sub>11</sub>.
+       * @param[in] N the degree giving storage layout for \e C and \e S.
+       * @param[in] nmx the maximum degree to be used.
+       * @param[in] mmx the maximum order to be used.
+       * @exception GeographicErr if \e N, \e nmx, and \e mmx do not satisfy
+       *   \e N &ge; \e nmx &ge; \e mmx &ge; &minus;1.
+       *
+       * This is the same as the previous constructor except that the sizes
+       * of the arrays can't be checked.  This allows the coefficients to be
+       * held in storage which isn't a std::vector, e.g., a memory mapped
+       * file.
+       **********************************************************************/
+      coeff(const real* C, const real* S, int N, int nmx, int mmx)
+        : _nNx(N)
+        , _nmx(nmx)
+        , _mmx(mmx)
+        , _cCnm(C)
+        , _sSnm(S)
+      {
+        if (!((_nNx >= _nmx && _nmx >= _mmx && _mmx >= 0) ||
+              (_nmx == -1 && _mmx == -1)))
+          throw GeographicErr("Bad indices for coeff");
+        SphericalEngine::RootTable(_nmx);
+      }
+      /**
+       * A constructor for a truncated view of another coeff object.
+       *
+       * @param[in] c the coeff object.
+       * @param[in] nmx the maximum degree to be used.
+       * @param[in] mmx the maximum order to be used.
+       *
+       * The result refers to the same coefficients as \e c but the sums are
+       * truncated at degree min(\e nmx, \e c.nmx()) and order min(\e mmx, \e
+       * c.mmx(), \e nmx).  No coefficients are copied.  Negative values of
+       * \e nmx or \e mmx give vanishing sums.
+       **********************************************************************/
+      coeff(const coeff& c, int nmx, int mmx)
+        : _nNx(c._nNx)
+        , _nmx(std::min(nmx, c._nmx))
+        , _mmx(std::min(std::min(mmx, c._mmx), _nmx))
+        , _cCnm(c._cCnm)
+        , _sSnm(c._sSnm)
+      {
+        if (_mmx < 0) _nmx = _mmx = -1;
+      }
       /**
        * The constructor for full coefficient vectors.
        *
@@ -157,8 +213,8 @@ namespace GeographicLib {
         : _nNx(N)
         , _nmx(N)
         , _mmx(N)
-        , _cCnm(C.begin())
-        , _sSnm(S.begin())
+        , _cCnm(C.data())
+        , _sSnm(S.data())
       {
         if (!(_nNx >= -1))
           throw GeographicErr("Bad indices for coeff");
@@ -277,6 +333,247 @@ namespace GeographicLib {
       static void readcoeffs(std::istream& stream, int& N, int& M,
                              std::vector<real>& C, std::vector<real>& S,
                              bool truncate = false);
+
+      /**
+       * Load several sets of coefficients from a binary file in parallel.
+       *
+       * @param[in] filename the name of the file.
+       * @param[in] pos the offset in the file of the first set.
+       * @param[in] k the number of sets of coefficients, which follow one
+       *   another in the file.
+       * @param[in,out] N array of \e k maximum degrees.
+       * @param[in,out] M array of \e k maximum orders.
+       * @param[out] C array of \e k vectors of cosine coefficients.
+       * @param[out] S array of \e k vectors of sine coefficients.
+       * @param[in] truncate if true, the input values of \e N and \e M are
+       *   used to truncate the coefficients (as with the other version of
+       *   readcoeffs).
+       * @param[in] nthreads the number of threads to use; 0 (the default)
+       *   means use std::thread::hardware_concurrency().
+       * @exception GeographicErr if the file can't be read or if the
+       *   degrees and orders are invalid.
+       * @exception std::bad_alloc if the memory for \e C or \e S can't be
+       *   allocated.
+       * @exception std::system_error if the threads can't be created.
+       * @return the offset in the file just after the last set.
+       *
+       * This gives the same results as calling the other version of
+       * readcoeffs \e k times on a stream positioned at \e pos.  Since the
+       * size of each set is given by its header, a table of the offsets of
+       * the columns of coefficients is built by reading just the headers.
+       * The coefficients are then read (and converted from little-endian
+       * order, if necessary) in pieces, using several threads each with its
+       * own stream; this shortens the time to load a high degree model or one
+       * with many epochs.  Small files are read by a single thread.
+       **********************************************************************/
+      static std::streamoff readcoeffs(const std::string& filename,
+                                       std::streamoff pos, int k,
+                                       int N[], int M[],
+                                       std::vector<real> C[],
+                                       std::vector<real> S[],
+                                       bool truncate = false,
+                                       unsigned nthreads = 0);
+
+      /**
+       * Set up coefficients stored in a memory mapped file.
+       *
+       * @param[in,out] data on input, the location of the coefficients in the
+       *   mapped file; on output, the location just after the coefficients.
+       * @param[in] end the end of the mapped file.
+       * @param[in,out] N The maximum degree of the coefficients.
+       * @param[in,out] M The maximum order of the coefficients.
+       * @param[out] C a pointer to the cosine coefficients in the mapped
+       *   file.
+       * @param[in] truncate if false (the default) then \e N and \e M are
+       *   determined by the values in the file; otherwise, the input values of
+       *   \e N and \e M are used to truncate the sums at the given degree and
+       *   order.
+       * @exception GeographicErr if \e N and \e M do not satisfy \e N &ge;
+       *   \e M &ge; &minus;1.
+       * @exception GeographicErr if the data is truncated or misaligned or if
+       *   the machine's representation of real numbers doesn't match that of
+       *   the file.
+       * @return a coeff object referring directly to the data in the file.
+       *
+       * The layout of the data is the same as for readcoeffs.  However,
+       * instead of copying the coefficients into vectors, the returned object
+       * points into the mapped file.  If the coefficients are truncated, the
+       * original layout is retained and the coeff object is constructed with
+       * \e nmx = \e N and \e mmx = \e M.  This requires that \e real be an
+       * 8-byte IEEE double and that the machine be little-endian.  \e C is
+       * returned so that the caller can alter individual coefficients (as
+       * GravityModel does) in a copy-on-write mapping.
+       **********************************************************************/
+      static coeff mapcoeffs(char*& data, const char* end, int& N, int& M,
+                             real*& C, bool truncate = false);
+    };
+
+    /**
+     * \brief Repacked coefficients for faster evaluation of large sums
+     *
+     * This holds the coefficients of a sum together with the factors
+     * independent of position in the Clenshaw recurrence.  For each (\e n,
+     * \e m), a record of 4 reals holds <i>C</i><sub><i>nm</i></sub>,
+     * <i>S</i><sub><i>nm</i></sub> (both multiplied by the internal scale
+     * factor), and the factors \e a<sub><i>nm</i></sub> and \e
+     * b<sub><i>nm</i></sub> which give the recurrence coefficients as &alpha;
+     * = \e t \e q \e a<sub><i>nm</i></sub> and &beta; = &minus;\e
+     * q<sup>2</sup> \e b<sub><i>nm</i></sub>.  The records for each order \e
+     * m are contiguous and each such column starts on a 64-byte boundary.
+     * Thus the inner loop of ValuePacked reads a single sequential stream of
+     * memory and does no divisions.  The price is that twice as much memory
+     * is used as for the coefficients themselves.
+     *
+     * Optionally, the records for degrees \e n above some \e nsingle can be
+     * held in single precision (with the sums still accumulated in \e real
+     * and without the scale factor applied to the coefficients).
+     * This halves the memory (and the memory traffic) for these degrees.
+     * The factors &alpha; and &beta; for these degrees only multiply partial
+     * sums of terms with degree greater than \e nsingle; so the relative
+     * error introduced is about 6 &times; 10<sup>&minus;8</sup> of the
+     * contribution of these terms (and not of the whole sum).  For a high
+     * degree gravity model such as EGM2008 with \e nsingle = 360, the terms
+     * above \e nsingle contribute less than 10<sup>&minus;4</sup> of the
+     * gravity; so the error is a few parts in 10<sup>12</sup>, far below the
+     * uncertainty in the coefficients themselves.
+     *
+     * A packedcoeff object can't be copied; SphericalHarmonic holds it
+     * through a std::shared_ptr.
+     *
+     * The records are allocated with MemoryPolicy.  If
+     * MemoryPolicy::Replicate() is true when the object is constructed, a
+     * copy of the records is made for each NUMA node; local() returns the
+     * object holding the copy for the node of the calling thread.
+     **********************************************************************/
+    class GEOGRAPHICLIB_EXPORT packedcoeff {
+    private:
+      int _nmx, _mmx, _nsingle;
+      // over-allocated to allow for alignment
+      std::vector<real, MemoryPolicy::Allocator<real> > _data;
+      std::vector<size_t> _col; // the start of each column in _data
+      // the records for n > _nsingle
+      std::vector<float, MemoryPolicy::Allocator<float> > _fdata;
+      std::vector<size_t> _fcol; // the start of each column in _fdata
+      // The copies for the other NUMA nodes (null for the node holding this
+      // object)
+      std::vector< std::unique_ptr<const packedcoeff> > _replicas;
+      packedcoeff(const packedcoeff& c, int node);
+      packedcoeff(const packedcoeff&) = delete;
+      packedcoeff& operator=(const packedcoeff&) = delete;
+    public:
+      /**
+       * Constructor.
+       *
+       * @param[in] c the coeff object.
+       * @param[in] norm the normalization for the associated Legendre
+       *   polynomials.
+       * @param[in] nsingle the records for degrees above this are held in
+       *   single precision; if this is negative (the default), all the
+       *   records are held in \e real.
+       * @exception std::bad_alloc if the memory for the records can't be
+       *   allocated.
+       *
+       * Unlike coeff, this doesn't refer to the coefficients of \e c after
+       * it is constructed.
+       **********************************************************************/
+      packedcoeff(const coeff& c, normalization norm, int nsingle = -1);
+      /**
+       * @return \e nmx the maximum degree.
+       **********************************************************************/
+      int nmx() const { return _nmx; }
+      /**
+       * @return \e mmx the maximum order.
+       **********************************************************************/
+      int mmx() const { return _mmx; }
+      /**
+       * The records for an order.
+       *
+       * @param[in] m the order.
+       * @return a pointer to the record for (\e m, \e m); the record for (\e
+       *   n, \e m) is 4 (\e n &minus; \e m) reals further on.
+       *
+       * Only the records with \e n &le; nsingle() are held here.
+       **********************************************************************/
+      const real* column(int m) const { return _data.data() + _col[m]; }
+      /**
+       * @return the maximum degree of the records held in \e real; this is
+       *   \e nmx if no records are held in single precision.
+       **********************************************************************/
+      int nsingle() const { return _nsingle; }
+      /**
+       * The single precision records for an order.
+       *
+       * @param[in] m the order.
+       * @return a pointer to the record for (\e n<sub>0</sub>, \e m) where
+       *   \e n<sub>0</sub> = max(\e m, nsingle() + 1); the record for (\e
+       *   n, \e m) is 4 (\e n &minus; \e n<sub>0</sub>) floats further on.
+       **********************************************************************/
+      const float* fcolumn(int m) const { return _fdata.data() + _fcol[m]; }
+      /**
+       * @return the object holding the records on the NUMA node of the
+       *   calling thread; this is *this unless the records are replicated.
+       **********************************************************************/
+      const packedcoeff& local() const {
+        if (_replicas.empty()) return *this;
+        const packedcoeff* c = _replicas[MemoryPolicy::CurrentNode()].get();
+        return c ? *c : *this;
+      }
+      /**
+       * @return the number of bytes of memory held by the object, including
+       *   the copies for the other NUMA nodes.
+       **********************************************************************/
+      size_t MemoryUsage() const;
+    };
+
+    /**
+     * \brief A memory mapping of a file of coefficients
+     *
+     * The file is mapped copy-on-write: the pages are shared by all the
+     * processes mapping the file until they are altered.  This is used by
+     * GravityModel and MagneticModel when they are constructed with \e
+     * mapfile = true.  Memory mapping is supported on POSIX systems and on
+     * Windows.
+     **********************************************************************/
+    class GEOGRAPHICLIB_EXPORT mappedfile {
+    private:
+      char* _data;
+      size_t _size;
+      void* _handle;
+      mappedfile(const mappedfile&) = delete; // copy constructor not allowed
+      // nor copy assignment
+      mappedfile& operator=(const mappedfile&) = delete;
+    public:
+      /**
+       * The default constructor; no file is mapped.
+       **********************************************************************/
+      mappedfile() : _data(nullptr), _size(0), _handle(nullptr) {}
+      /**
+       * The destructor unmaps the file.
+       **********************************************************************/
+      ~mappedfile() { unmap(); }
+      /**
+       * Map a file.
+       *
+       * @param[in] filename the name of the file.
+       * @exception GeographicErr if the file cannot be opened or mapped or if
+       *   memory mapping is not supported on this system.
+       *
+       * Any file previously mapped is unmapped first.
+       **********************************************************************/
+      void map(const std::string& filename);
+      /**
+       * Unmap the file.
+       **********************************************************************/
+      void unmap();
+      /**
+       * @return a pointer to the start of the mapped file (nullptr if no file
+       *   is mapped).
+       **********************************************************************/
+      char* data() const { return _data; }
+      /**
+       * @return the size of the mapped file.
+       **********************************************************************/
+      size_t size() const { return _size; }
     };
 
     /**
@@ -313,6 +610,182 @@ namespace GeographicLib {
                               real x, real y, real z, real a,
                               real& gradx, real& grady, real& gradz);
 
+    /**
+     * Evaluate a spherical harmonic sum, its gradient, and its second
+     * derivatives.
+     *
+     * @tparam norm the normalization for the associated Legendre polynomials.
+     * @tparam L the number of terms in the coefficients.
+     * @param[in] c an array of coeff objects.
+     * @param[in] f array of coefficient multipliers.  f[0] should be 1.
+     * @param[in] x the \e x component of the cartesian position.
+     * @param[in] y the \e y component of the cartesian position.
+     * @param[in] z the \e z component of the cartesian position.
+     * @param[in] a the normalizing radius.
+     * @param[out] gradx the \e x component of the gradient.
+     * @param[out] grady the \e y component of the gradient.
+     * @param[out] gradz the \e z component of the gradient.
+     * @param[out] hess an array of 9 elements giving the matrix of second
+     *   derivatives (the Hessian) in row-major order, i.e., \e hess[3\e i +
+     *   \e j] = &part;<sup>2</sup><i>V</i>/&part;<i>x<sub>i</sub></i>
+     *   &part;<i>x<sub>j</sub></i> where (<i>x</i><sub>0</sub>,
+     *   <i>x</i><sub>1</sub>, <i>x</i><sub>2</sub>) = (\e x, \e y, \e z).
+     * @exception std::bad_alloc if the memory for the temporary array can't
+     *   be allocated.
+     * @result the spherical harmonic sum.
+     *
+     * The second derivatives are found by differentiating the Clenshaw
+     * recursions for the inner sums twice with respect to \e r and cos
+     * &theta;, so that they are computed in the same pass through the
+     * coefficients as the sum and its gradient; this takes about twice as
+     * long as Value.  The terms in the derivatives with respect to &theta;
+     * and &lambda; which are singular at the poles are cancelled
+     * analytically, so that the results are accurate there too.  The sums
+     * over degree for each order are held in an array of size 16 (\e M +
+     * 1) before the sum over order is done.
+     **********************************************************************/
+    template<normalization norm, int L>
+      static Math::real Hessian(const coeff c[], const real f[],
+                                real x, real y, real z, real a,
+                                real& gradx, real& grady, real& gradz,
+                                real hess[]);
+
+    /**
+     * Evaluate a spherical harmonic sum and its gradient using packed
+     * coefficients.
+     *
+     * @tparam gradp should the gradient be calculated.
+     * @tparam norm the normalization for the associated Legendre polynomials;
+     *   this should match the one used to construct \e c.
+     * @param[in] c a packedcoeff object.
+     * @param[in] N the maximum degree to include; this is reduced to
+     *   c.nmx() if necessary.
+     * @param[in] x the \e x component of the cartesian position.
+     * @param[in] y the \e y component of the cartesian position.
+     * @param[in] z the \e z component of the cartesian position.
+     * @param[in] a the normalizing radius.
+     * @param[out] gradx the \e x component of the gradient.
+     * @param[out] grady the \e y component of the gradient.
+     * @param[out] gradz the \e z component of the gradient.
+     * @result the spherical harmonic sum.
+     *
+     * This gives the same result as Value with \e L = 1 (to within
+     * roundoff), with the sum truncated at degree and order \e N.  The
+     * inner loop reads the records of \e c sequentially (with software
+     * prefetching where the compiler supports it) and doesn't consult the
+     * table of square roots; this is faster for sums of high degree, where
+     * the coefficients don't fit in the cache.  The records are read from
+     * c.local().  This function never throws an exception.
+     **********************************************************************/
+    template<bool gradp, normalization norm>
+      static Math::real ValuePacked(const packedcoeff& c, int N,
+                                    real x, real y, real z, real a,
+                                    real& gradx, real& grady, real& gradz);
+
+    /**
+     * Evaluate several spherical harmonic sums and their gradients at a
+     * point.
+     *
+     * @tparam gradp should the gradients be calculated.
+     * @tparam norm the normalization for the associated Legendre polynomials.
+     * @tparam K the number of sums.
+     * @param[in] c an array of \e K coeff objects, one for each sum.
+     * @param[in] x the \e x component of the cartesian position.
+     * @param[in] y the \e y component of the cartesian position.
+     * @param[in] z the \e z component of the cartesian position.
+     * @param[in] a the normalizing radius.
+     * @param[out] v array of the \e K spherical harmonic sums.
+     * @param[out] gradx array of the \e x components of the gradients.
+     * @param[out] grady array of the \e y components of the gradients.
+     * @param[out] gradz array of the \e z components of the gradients.
+     *
+     * This gives the same results as calling Value (with \e L = 1) for each
+     * of the coeff objects.  However, the Clenshaw summations for all the
+     * sums are carried out together so that the recursion coefficients,
+     * which depend only on the position, the degree, and the order, are
+     * computed once for all the sums.  The degree and order of the sums
+     * needn't be the same; the upper limits are the maximum values of
+     * c[i].nmx() and c[i].mmx().  This is useful, for example, for a
+     * magnetic model where the field is interpolated between the sums for
+     * two epochs.  If \e gradp is false, \e gradx, \e grady, and \e gradz
+     * are not referenced (and may be null).  This function never throws an
+     * exception.
+     **********************************************************************/
+    template<bool gradp, normalization norm, int K>
+      static void ValueMulti(const coeff c[], real x, real y, real z, real a,
+                             real v[],
+                             real gradx[], real grady[], real gradz[]);
+
+    /**
+     * Evaluate a spherical harmonic sum and its gradient at several points.
+     *
+     * @tparam gradp should the gradient be calculated.
+     * @tparam norm the normalization for the associated Legendre polynomials.
+     * @tparam L the number of terms in the coefficients.
+     * @param[in] c an array of coeff objects.
+     * @param[in] f array of coefficient multipliers.  f[0] should be 1.
+     * @param[in] n the number of points.
+     * @param[in] x array of the \e x components of the cartesian positions.
+     * @param[in] y array of the \e y components of the cartesian positions.
+     * @param[in] z array of the \e z components of the cartesian positions.
+     * @param[in] a the normalizing radius.
+     * @param[out] v array of the spherical harmonic sums.
+     * @param[out] gradx array of the \e x components of the gradients.
+     * @param[out] grady array of the \e y components of the gradients.
+     * @param[out] gradz array of the \e z components of the gradients.
+     *
+     * This gives the same results as calling Value for each point.  However,
+     * the Clenshaw summations for several (currently 8) points are carried
+     * out together, so that the coefficients are fetched from memory once for
+     * all these points; the loops over the points are also amenable to
+     * vectorization by the compiler.  This is substantially faster than
+     * calling Value repeatedly for high degree sums.  If \e gradp is false,
+     * \e gradx, \e grady, and \e gradz are not referenced (and may be null).
+     * This function never throws an exception.
+     **********************************************************************/
+    template<bool gradp, normalization norm, int L>
+      static void ValueBatch(const coeff c[], const real f[], size_t n,
+                             const real x[], const real y[], const real z[],
+                             real a, real v[],
+                             real gradx[], real grady[], real gradz[]);
+
+    /**
+     * Evaluate a spherical harmonic sum and its gradient using several
+     * threads.
+     *
+     * @tparam gradp should the gradient be calculated.
+     * @tparam norm the normalization for the associated Legendre polynomials.
+     * @tparam L the number of terms in the coefficients.
+     * @param[in] c an array of coeff objects.
+     * @param[in] f array of coefficient multipliers.  f[0] should be 1.
+     * @param[in] x the \e x component of the cartesian position.
+     * @param[in] y the \e y component of the cartesian position.
+     * @param[in] z the \e z component of the cartesian position.
+     * @param[in] a the normalizing radius.
+     * @param[out] gradx the \e x component of the gradient.
+     * @param[out] grady the \e y component of the gradient.
+     * @param[out] gradz the \e z component of the gradient.
+     * @param[in] nthreads the number of threads to use; 0 means use
+     *   std::thread::hardware_concurrency().
+     * @exception std::bad_alloc if the memory for the temporary array can't
+     *   be allocated.
+     * @exception std::system_error if the threads can't be created.
+     * @result the spherical harmonic sum.
+     *
+     * This gives the same result as Value.  The inner sums over degree \e n
+     * for each order \e m, which account for nearly all the work, are
+     * independent of one another; these are distributed over the threads
+     * (using GeodesicBatchExecutor::ForEach) and saved.  The outer sum over
+     * \e m is then carried out by the calling thread.  Because of the
+     * overhead of creating the threads, this is only worthwhile for sums of
+     * high degree (e.g., several hundred).
+     **********************************************************************/
+    template<bool gradp, normalization norm, int L>
+      static Math::real ValueParallel(const coeff c[], const real f[],
+                                      real x, real y, real z, real a,
+                                      real& gradx, real& grady, real& gradz,
+                                      unsigned nthreads);
+
     /**
      * Create a CircularEngine object
      *
@@ -339,6 +812,148 @@ namespace GeographicLib {
     template<bool gradp, normalization norm, int L>
       static CircularEngine Circle(const coeff c[], const real f[],
                                    real p, real z, real a);
+
+    /**
+     * Set up an existing CircularEngine object for a new circle.
+     *
+     * @tparam gradp should the gradient be calculated.
+     * @tparam norm the normalization for the associated Legendre polynomials.
+     * @tparam L the number of terms in the coefficients.
+     * @param[in] c an array of coeff objects.
+     * @param[in] f array of coefficient multipliers.  f[0] should be 1.
+     * @param[in] p the radius of the circle = sqrt(<i>x</i><sup>2</sup> +
+     *   <i>y</i><sup>2</sup>).
+     * @param[in] z the height of the circle.
+     * @param[in] a the normalizing radius.
+     * @param[in,out] circ the CircularEngine object.
+     * @exception std::bad_alloc if the memory for the CircularEngine can't be
+     *   allocated.
+     *
+     * This sets \e circ to the result that Circle would return.  The storage
+     * for the sums already held by \e circ is reused, so that sweeping
+     * through many circles with the same object doesn't allocate memory
+     * after the first circle.
+     **********************************************************************/
+    template<bool gradp, normalization norm, int L>
+      static void Circle(const coeff c[], const real f[],
+                         real p, real z, real a, CircularEngine& circ);
+
+    /**
+     * Set up an existing CircularEngine object for a new circle so that it
+     * can compute second derivatives.
+     *
+     * @tparam norm the normalization for the associated Legendre polynomials.
+     * @tparam L the number of terms in the coefficients.
+     * @param[in] c an array of coeff objects.
+     * @param[in] f array of coefficient multipliers.  f[0] should be 1.
+     * @param[in] p the radius of the circle = sqrt(<i>x</i><sup>2</sup> +
+     *   <i>y</i><sup>2</sup>).
+     * @param[in] z the height of the circle.
+     * @param[in] a the normalizing radius.
+     * @param[in,out] circ the CircularEngine object.
+     * @exception std::bad_alloc if the memory for the CircularEngine can't be
+     *   allocated.
+     *
+     * This is the same as Circle with \e gradp = true, except that \e circ
+     * also holds the sums needed by the version of
+     * CircularEngine::operator()() which returns the second derivatives (as
+     * computed by Hessian).  This takes about twice as long as Circle.
+     **********************************************************************/
+    template<normalization norm, int L>
+      static void CircleHessian(const coeff c[], const real f[],
+                                real p, real z, real a, CircularEngine& circ);
+
+    /**
+     * Create a CircularEngine object using several threads.
+     *
+     * @tparam gradp should the gradient be calculated.
+     * @tparam norm the normalization for the associated Legendre polynomials.
+     * @tparam L the number of terms in the coefficients.
+     * @param[in] c an array of coeff objects.
+     * @param[in] f array of coefficient multipliers.  f[0] should be 1.
+     * @param[in] p the radius of the circle = sqrt(<i>x</i><sup>2</sup> +
+     *   <i>y</i><sup>2</sup>).
+     * @param[in] z the height of the circle.
+     * @param[in] a the normalizing radius.
+     * @param[in] nthreads the number of threads to use; 0 means use
+     *   std::thread::hardware_concurrency().
+     * @exception std::bad_alloc if the memory for the CircularEngine can't be
+     *   allocated.
+     * @exception std::system_error if the threads can't be created.
+     * @result the CircularEngine object.
+     *
+     * This gives the same result as Circle; the sums for the orders \e m are
+     * distributed over the threads as in ValueParallel.
+     **********************************************************************/
+    template<bool gradp, normalization norm, int L>
+      static CircularEngine CircleParallel(const coeff c[], const real f[],
+                                           real p, real z, real a,
+                                           unsigned nthreads);
+    /**
+     * Bounds on the gradients of the terms of each degree of a spherical
+     * harmonic sum.
+     *
+     * @param[in] c a coeff object.
+     * @param[in] norm the normalization for the associated Legendre
+     *   polynomials.
+     * @exception std::bad_alloc if the memory for the result can't be
+     *   allocated.
+     * @return an array \e b with c.nmx() + 1 elements.
+     *
+     * The gradient of the terms of degree \e n of the sum, evaluated at
+     * radius \e r, is bounded in magnitude by \e b[\e n] <i>q</i><sup>\e n
+     * + 1</sup> / \e r, where \e q = \e a / \e r.  This follows from the
+     * Cauchy-Schwarz inequality and the addition theorem for spherical
+     * harmonics; with &sigma;<sub>\e n</sub> the root sum square of the
+     * coefficients of degree \e n, \e b[\e n] = &sigma;<sub>\e n</sub> (2\e n
+     * + 1) sqrt(\e n + 1) for FULL normalization and &sigma;<sub>\e n</sub>
+     * sqrt((2\e n + 1) (\e n + 1)) for SCHMIDT normalization.
+     **********************************************************************/
+    static std::vector<real> GradientBounds(const coeff& c,
+                                            normalization norm);
+
+    /**
+     * Find the degree at which a spherical harmonic sum can be truncated.
+     *
+     * @param[in] b the bounds returned by GradientBounds.
+     * @param[in] q the ratio \e a / \e r.
+     * @param[in] tol the tolerance for the gradient times \e r.
+     * @return the smallest degree \e N such that the sum over \e n > \e N
+     *   of \e b[\e n] <i>q</i><sup>\e n + 1</sup> does not exceed \e tol.
+     *
+     * The time taken is proportional to the number of elements in \e b.
+     **********************************************************************/
+    static int TruncatedDegree(const std::vector<real>& b, real q, real tol);
+
+    /**
+     * Estimate the cost of evaluating spherical harmonic sums.
+     *
+     * @param[in] N the maximum degree.
+     * @param[in] M the maximum order.
+     * @param[in] L the number of sets of coefficients combined into each
+     *   sum (as in Value).
+     * @param[in] deriv 0 for just the value of the sum, 1 to include the
+     *   gradient (as in Value with \e gradp = true), or 2 to include the
+     *   second derivatives (as in Hessian).
+     * @param[in] K the number of sums evaluated together (as in ValueMulti).
+     * @return the approximate number of floating point operations.
+     *
+     * This counts the multiplications, divisions, and additions in the
+     * Clenshaw summations; the cost of fetching the coefficients from
+     * memory, which may dominate for models of high degree, isn't included.
+     * For large \e N, the cost per coefficient is about 5 + 6\e K, 5 +
+     * 16\e K, or 5 + 34\e K operations (with \e L = 1) for \e deriv = 0,
+     * 1, or 2.
+     **********************************************************************/
+    static unsigned long long CostEstimate(int N, int M, int L = 1,
+                                           int deriv = 0, int K = 1);
+
+    /**
+     * @return the number of bytes of memory held by the static table of
+     *   square roots (including the smaller copies retained by RootTable).
+     **********************************************************************/
+    static size_t RootTableMemoryUsage();
+
     /**
      * Check that the static table of square roots is big enough and enlarge it
      * if necessary.
@@ -348,15 +963,16 @@ namespace GeographicLib {
      *   be allocated.
      *
      * Typically, there's no need for an end-user to call this routine, because
-     * the constructors for SphericalEngine::coeff do so.  However, since this
-     * updates a static table, there's a possible race condition in a
-     * multi-threaded environment.  Because this routine does nothing if the
-     * table is already large enough, one way to avoid race conditions is to
-     * call this routine at program start up (when it's still single threaded),
-     * supplying the largest degree that your program will use.  E.g., \code
+     * the constructors for SphericalEngine::coeff do so.  This routine is
+     * thread safe: the table is only ever replaced by a larger immutable copy
+     * and the old copies are retained, so models can be constructed and
+     * evaluated concurrently on several threads.  If the table is already
+     * large enough, this routine returns without locking.  Calling this
+     * routine at program start up, e.g., \code
      GeographicLib::SphericalEngine::RootTable(2190);
      \endcode
-     * suffices to accommodate extant magnetic and gravity models.
+     * (which suffices to accommodate extant magnetic and gravity models)
+     * avoids growing the table later.
      **********************************************************************/
     static void RootTable(int N);
 
@@ -369,10 +985,37 @@ namespace GeographicLib {
      * \warning It's safest not to call this routine at all.  (The space used
      * by the table is modest.)
      **********************************************************************/
-    static void ClearRootTable() {
-      std::vector<real> temp(0);
-      sqrttable().swap(temp);
-    }
+    static void ClearRootTable();
+
+  private:
+    // The inner sums over degree for orders [m0, m1) and for all orders using
+    // several threads
+    template<bool gradp, normalization norm, int L>
+      static void InnerSums(const coeff c[], const real f[],
+                            real t, real u, real q, int m0, int m1,
+                            real ww[]);
+    template<bool gradp, normalization norm, int L>
+      static void ParallelSums(const coeff c[], const real f[],
+                               real t, real u, real q,
+                               unsigned nthreads, std::vector<real>& ww);
+    // The sums over degree needed by Hessian and CircleHessian for orders
+    // [m0, m1), stored in ww[16*m + i].
+    template<normalization norm, int L>
+      static void HessianSums(const coeff c[], const real f[],
+                              real t, real u, real q, int m0, int m1,
+                              real ww[]);
+    // The sum over order for Hessian and CircularEngine given the sums
+    // computed by HessianSums.
+    static real HessianSum(unsigned norm, int M, real r, real q,
+                           real t, real u, real cl, real sl, const real ww[],
+                           real& gradx, real& grady, real& gradz,
+                           real hess[]);
+    // The body of ValueBatch
+    template<bool gradp, normalization norm, int L>
+      static void IntValueBatch(const coeff c[], const real f[], size_t n,
+                                const real x[], const real y[],
+                                const real z[], real a, real v[],
+                                real gradx[], real grady[], real gradz[]);
   };
 
 } // namespace GeographicLib
@@ -10,6 +10,7 @@
 #if !defined(GEOGRAPHICLIB_SPHERICALHARMONIC_HPP)
 #define GEOGRAPHICLIB_SPHERICALHARMONIC_HPP 1
 
+#include <memory>
 #include <vector>
 #include <GeographicLib/Constants.hpp>
 #include <GeographicLib/SphericalEngine.hpp>
@@ -125,6 +126,7 @@ namespace GeographicLib {
     SphericalEngine::coeff _c[1];
     real _a;
     unsigned _norm;
+    std::shared_ptr<const SphericalEngine::packedcoeff> _packed;
 
   public:
     /**
@@ -205,6 +207,28 @@ namespace GeographicLib {
       , _norm(norm)
     { _c[0] = SphericalEngine::coeff(C, S, N, nmx, mmx); }
 
+    /**
+     * Constructor with the coefficients given by a SphericalEngine::coeff
+     * object.
+     *
+     * @param[in] c the coefficients.
+     * @param[in] a the reference radius appearing in the definition of the
+     *   sum.
+     * @param[in] norm the normalization for the associated Legendre
+     *   polynomials, either SphericalHarmonic::FULL (the default) or
+     *   SphericalHarmonic::SCHMIDT.
+     *
+     * This allows the coefficients to be stored other than in vectors, e.g.,
+     * in a memory mapped file; see SphericalEngine::coeff::mapcoeffs.  The
+     * storage referred to by \e c should not be altered or destroyed during
+     * the lifetime of a SphericalHarmonic object.
+     **********************************************************************/
+    SphericalHarmonic(const SphericalEngine::coeff& c,
+                      real a, unsigned norm = FULL)
+      : _a(a)
+      , _norm(norm)
+    { _c[0] = c; }
+
     /**
      * A default constructor so that the object can be created when the
      * constructor for another object is initialized.  This default object can
@@ -229,12 +253,18 @@ namespace GeographicLib {
       real dummy;
       switch (_norm) {
       case FULL:
-        v = SphericalEngine::Value<false, SphericalEngine::FULL, 1>
+        v = _packed ?
+          SphericalEngine::ValuePacked<false, SphericalEngine::FULL>
+          (*_packed, _packed->nmx(), x, y, z, _a, dummy, dummy, dummy) :
+          SphericalEngine::Value<false, SphericalEngine::FULL, 1>
           (_c, f, x, y, z, _a, dummy, dummy, dummy);
         break;
       case SCHMIDT:
       default:                  // To avoid compiler warnings
-        v = SphericalEngine::Value<false, SphericalEngine::SCHMIDT, 1>
+        v = _packed ?
+          SphericalEngine::ValuePacked<false, SphericalEngine::SCHMIDT>
+          (*_packed, _packed->nmx(), x, y, z, _a, dummy, dummy, dummy) :
+          SphericalEngine::Value<false, SphericalEngine::SCHMIDT, 1>
           (_c, f, x, y, z, _a, dummy, dummy, dummy);
         break;
       }
@@ -263,18 +293,186 @@ namespace GeographicLib {
       real v = 0;
       switch (_norm) {
       case FULL:
-        v = SphericalEngine::Value<true, SphericalEngine::FULL, 1>
+        v = _packed ?
+          SphericalEngine::ValuePacked<true, SphericalEngine::FULL>
+          (*_packed, _packed->nmx(), x, y, z, _a, gradx, grady, gradz) :
+          SphericalEngine::Value<true, SphericalEngine::FULL, 1>
           (_c, f, x, y, z, _a, gradx, grady, gradz);
         break;
       case SCHMIDT:
       default:                  // To avoid compiler warnings
-        v = SphericalEngine::Value<true, SphericalEngine::SCHMIDT, 1>
+        v = _packed ?
+          SphericalEngine::ValuePacked<true, SphericalEngine::SCHMIDT>
+          (*_packed, _packed->nmx(), x, y, z, _a, gradx, grady, gradz) :
+          SphericalEngine::Value<true, SphericalEngine::SCHMIDT, 1>
           (_c, f, x, y, z, _a, gradx, grady, gradz);
         break;
       }
       return v;
     }
 
+    /**
+     * Compute a spherical harmonic sum, its gradient, and its second
+     * derivatives.
+     *
+     * @param[in] x cartesian coordinate.
+     * @param[in] y cartesian coordinate.
+     * @param[in] z cartesian coordinate.
+     * @param[out] gradx \e x component of the gradient
+     * @param[out] grady \e y component of the gradient
+     * @param[out] gradz \e z component of the gradient
+     * @param[out] hess an array of 9 elements giving the matrix of second
+     *   derivatives in row-major order; e.g., \e hess[1] =
+     *   &part;<sup>2</sup><i>V</i>/&part;<i>x</i>&part;<i>y</i>.
+     * @exception std::bad_alloc if the memory for the temporary array can't
+     *   be allocated.
+     * @return \e V the spherical harmonic sum.
+     *
+     * The second derivatives are computed in the same pass through the
+     * coefficients as the sum; see SphericalEngine::Hessian.  The packed
+     * coefficients, if any, are not used.
+     **********************************************************************/
+    Math::real Hessian(real x, real y, real z,
+                       real& gradx, real& grady, real& gradz,
+                       real hess[]) const {
+      real f[] = {1};
+      real v = 0;
+      switch (_norm) {
+      case FULL:
+        v = SphericalEngine::Hessian<SphericalEngine::FULL, 1>
+          (_c, f, x, y, z, _a, gradx, grady, gradz, hess);
+        break;
+      case SCHMIDT:
+      default:                  // To avoid compiler warnings
+        v = SphericalEngine::Hessian<SphericalEngine::SCHMIDT, 1>
+          (_c, f, x, y, z, _a, gradx, grady, gradz, hess);
+        break;
+      }
+      return v;
+    }
+
+    /**
+     * Compute the spherical harmonic sum using several threads.
+     *
+     * @param[in] x cartesian coordinate.
+     * @param[in] y cartesian coordinate.
+     * @param[in] z cartesian coordinate.
+     * @param[in] nthreads the number of threads to use; 0 means use
+     *   std::thread::hardware_concurrency().
+     * @exception std::bad_alloc if the memory for the temporary array can't
+     *   be allocated.
+     * @exception std::system_error if the threads can't be created.
+     * @return \e V the spherical harmonic sum.
+     *
+     * This gives the same result as operator()() but reduces the time taken
+     * by a single evaluation of a high degree sum by distributing the sums
+     * for the different orders over several threads; see
+     * SphericalEngine::ValueParallel.
+     **********************************************************************/
+    Math::real ValueParallel(real x, real y, real z, unsigned nthreads) const {
+      real f[] = {1};
+      real v = 0;
+      real dummy;
+      switch (_norm) {
+      case FULL:
+        v = SphericalEngine::ValueParallel<false, SphericalEngine::FULL, 1>
+          (_c, f, x, y, z, _a, dummy, dummy, dummy, nthreads);
+        break;
+      case SCHMIDT:
+      default:                  // To avoid compiler warnings
+        v = SphericalEngine::ValueParallel<false, SphericalEngine::SCHMIDT, 1>
+          (_c, f, x, y, z, _a, dummy, dummy, dummy, nthreads);
+        break;
+      }
+      return v;
+    }
+
+    /**
+     * Compute a spherical harmonic sum and its gradient using several
+     * threads.
+     *
+     * @param[in] x cartesian coordinate.
+     * @param[in] y cartesian coordinate.
+     * @param[in] z cartesian coordinate.
+     * @param[out] gradx \e x component of the gradient
+     * @param[out] grady \e y component of the gradient
+     * @param[out] gradz \e z component of the gradient
+     * @param[in] nthreads the number of threads to use; 0 means use
+     *   std::thread::hardware_concurrency().
+     * @exception std::bad_alloc if the memory for the temporary array can't
+     *   be allocated.
+     * @exception std::system_error if the threads can't be created.
+     * @return \e V the spherical harmonic sum.
+     *
+     * This is the same as the previous function, except that the components
+     * of the gradients of the sum in the \e x, \e y, and \e z directions
+     * are computed.
+     **********************************************************************/
+    Math::real ValueParallel(real x, real y, real z,
+                             real& gradx, real& grady, real& gradz,
+                             unsigned nthreads) const {
+      real f[] = {1};
+      real v = 0;
+      switch (_norm) {
+      case FULL:
+        v = SphericalEngine::ValueParallel<true, SphericalEngine::FULL, 1>
+          (_c, f, x, y, z, _a, gradx, grady, gradz, nthreads);
+        break;
+      case SCHMIDT:
+      default:                  // To avoid compiler warnings
+        v = SphericalEngine::ValueParallel<true, SphericalEngine::SCHMIDT, 1>
+          (_c, f, x, y, z, _a, gradx, grady, gradz, nthreads);
+        break;
+      }
+      return v;
+    }
+
+    /**
+     * Compute a spherical harmonic sum (and optionally its gradient) at
+     * several points.
+     *
+     * @param[in] n the number of points.
+     * @param[in] x array of cartesian coordinates.
+     * @param[in] y array of cartesian coordinates.
+     * @param[in] z array of cartesian coordinates.
+     * @param[out] v array of spherical harmonic sums.
+     * @param[out] gradx (optional) array of \e x components of the gradients.
+     * @param[out] grady (optional) array of \e y components of the gradients.
+     * @param[out] gradz (optional) array of \e z components of the gradients.
+     *
+     * This gives the same results as calling operator()() for each point, but
+     * is faster because the points are processed in batches with a single
+     * pass through the coefficients for each batch; see
+     * SphericalEngine::ValueBatch.  The gradients are only computed if \e
+     * gradx, \e grady, and \e gradz are all non-null.  This routine requires
+     * constant memory and thus never throws an exception.
+     **********************************************************************/
+    void ValueBatch(size_t n, const real x[], const real y[], const real z[],
+                    real v[], real gradx[] = nullptr, real grady[] = nullptr,
+                    real gradz[] = nullptr) const {
+      real f[] = {1};
+      bool gradp = gradx && grady && gradz;
+      switch (_norm) {
+      case FULL:
+        if (gradp)
+          SphericalEngine::ValueBatch<true, SphericalEngine::FULL, 1>
+            (_c, f, n, x, y, z, _a, v, gradx, grady, gradz);
+        else
+          SphericalEngine::ValueBatch<false, SphericalEngine::FULL, 1>
+            (_c, f, n, x, y, z, _a, v, nullptr, nullptr, nullptr);
+        break;
+      case SCHMIDT:
+      default:                  // To avoid compiler warnings
+        if (gradp)
+          SphericalEngine::ValueBatch<true, SphericalEngine::SCHMIDT, 1>
+            (_c, f, n, x, y, z, _a, v, gradx, grady, gradz);
+        else
+          SphericalEngine::ValueBatch<false, SphericalEngine::SCHMIDT, 1>
+            (_c, f, n, x, y, z, _a, v, nullptr, nullptr, nullptr);
+        break;
+      }
+    }
+
     /**
      * Create a CircularEngine to allow the efficient evaluation of several
      * points on a circle of latitude.
@@ -326,26 +524,199 @@ namespace GeographicLib {
      \endcode
      **********************************************************************/
     CircularEngine Circle(real p, real z, bool gradp) const {
+      CircularEngine circ;
+      Circle(p, z, gradp, circ);
+      return circ;
+    }
+
+    /**
+     * Set up an existing CircularEngine object for a new circle of latitude.
+     *
+     * @param[in] p the radius of the circle.
+     * @param[in] z the height of the circle above the equatorial plane.
+     * @param[in] gradp if true the returned object will be able to compute
+     *   the gradient of the sum.
+     * @param[in,out] circ the CircularEngine object.
+     * @exception std::bad_alloc if the memory for the CircularEngine can't be
+     *   allocated.
+     *
+     * This sets \e circ to the object that the other version of Circle
+     * returns, reusing the storage that \e circ already holds; so a loop over
+     * many circles of latitude doesn't allocate memory once \e circ has
+     * grown to the needed size.
+     **********************************************************************/
+    void Circle(real p, real z, bool gradp,
+                CircularEngine& circ) const {
       real f[] = {1};
       switch (_norm) {
       case FULL:
-        return gradp ?
+        if (gradp)
           SphericalEngine::Circle<true, SphericalEngine::FULL, 1>
-          (_c, f, p, z, _a) :
+            (_c, f, p, z, _a, circ);
+        else
           SphericalEngine::Circle<false, SphericalEngine::FULL, 1>
-          (_c, f, p, z, _a);
+            (_c, f, p, z, _a, circ);
         break;
       case SCHMIDT:
       default:                  // To avoid compiler warnings
-        return gradp ?
+        if (gradp)
           SphericalEngine::Circle<true, SphericalEngine::SCHMIDT, 1>
-          (_c, f, p, z, _a) :
+            (_c, f, p, z, _a, circ);
+        else
           SphericalEngine::Circle<false, SphericalEngine::SCHMIDT, 1>
-          (_c, f, p, z, _a);
+            (_c, f, p, z, _a, circ);
         break;
       }
     }
 
+    /**
+     * Set up a CircularEngine object which can compute the second derivatives
+     * of the sum on a circle of latitude.
+     *
+     * @param[in] p the radius of the circle.
+     * @param[in] z the height of the circle above the equatorial plane.
+     * @param[in,out] circ the CircularEngine object.
+     * @exception std::bad_alloc if the memory for the CircularEngine can't be
+     *   allocated.
+     *
+     * This is like Circle with \e gradp = true, except that the version of
+     * CircularEngine::operator()() with the \e hess argument can then be
+     * used to give the second derivatives of the sum.
+     **********************************************************************/
+    void CircleHessian(real p, real z, CircularEngine& circ) const {
+      real f[] = {1};
+      switch (_norm) {
+      case FULL:
+        SphericalEngine::CircleHessian<SphericalEngine::FULL, 1>
+          (_c, f, p, z, _a, circ);
+        break;
+      case SCHMIDT:
+      default:                  // To avoid compiler warnings
+        SphericalEngine::CircleHessian<SphericalEngine::SCHMIDT, 1>
+          (_c, f, p, z, _a, circ);
+        break;
+      }
+    }
+    /**
+     * Create a CircularEngine to allow the efficient evaluation of several
+     * points on a circle of latitude using several threads to set it up.
+     *
+     * @param[in] p the radius of the circle.
+     * @param[in] z the height of the circle above the equatorial plane.
+     * @param[in] gradp if true the returned object will be able to compute
+     *   the gradient of the sum.
+     * @param[in] nthreads the number of threads to use; 0 means use
+     *   std::thread::hardware_concurrency().
+     * @exception std::bad_alloc if the memory for the CircularEngine can't be
+     *   allocated.
+     * @exception std::system_error if the threads can't be created.
+     * @return the CircularEngine object.
+     *
+     * The result is identical to that returned by Circle(); see
+     * SphericalEngine::CircleParallel.
+     **********************************************************************/
+    CircularEngine CircleParallel(real p, real z, bool gradp,
+                                  unsigned nthreads) const {
+      real f[] = {1};
+      switch (_norm) {
+      case FULL:
+        return gradp ?
+          SphericalEngine::CircleParallel<true, SphericalEngine::FULL, 1>
+          (_c, f, p, z, _a, nthreads) :
+          SphericalEngine::CircleParallel<false, SphericalEngine::FULL, 1>
+          (_c, f, p, z, _a, nthreads);
+        break;
+      case SCHMIDT:
+      default:                  // To avoid compiler warnings
+        return gradp ?
+          SphericalEngine::CircleParallel<true, SphericalEngine::SCHMIDT, 1>
+          (_c, f, p, z, _a, nthreads) :
+          SphericalEngine::CircleParallel<false, SphericalEngine::SCHMIDT, 1>
+          (_c, f, p, z, _a, nthreads);
+        break;
+      }
+    }
+
+    /**
+     * Compute several spherical harmonic sums and their gradients at a point.
+     *
+     * @tparam K the number of sums (2 or 3).
+     * @param[in] h an array of pointers to \e K SphericalHarmonic objects.
+     * @param[in] x cartesian coordinate.
+     * @param[in] y cartesian coordinate.
+     * @param[in] z cartesian coordinate.
+     * @param[out] v array of the \e K spherical harmonic sums.
+     * @param[out] gradx array of the \e x components of the gradients.
+     * @param[out] grady array of the \e y components of the gradients.
+     * @param[out] gradz array of the \e z components of the gradients.
+     * @exception GeographicErr if the objects have different reference radii
+     *   or normalizations.
+     *
+     * This gives the same results as calling operator()() for each object;
+     * however the sums are evaluated together using
+     * SphericalEngine::ValueMulti, so that the work of evaluating the
+     * recursion for the associated Legendre functions is shared.  The
+     * objects may have different degrees and orders.
+     **********************************************************************/
+    template<int K>
+    static void GradientMulti(const SphericalHarmonic* const h[],
+                              real x, real y, real z, real v[],
+                              real gradx[], real grady[], real gradz[]) {
+      SphericalEngine::coeff c[K];
+      for (int j = 0; j < K; ++j) {
+        if (h[j]->_a != h[0]->_a || h[j]->_norm != h[0]->_norm)
+          throw GeographicErr("Incompatible spherical harmonic sums");
+        c[j] = h[j]->_c[0];
+      }
+      switch (h[0]->_norm) {
+      case FULL:
+        SphericalEngine::ValueMulti<true, SphericalEngine::FULL, K>
+          (c, x, y, z, h[0]->_a, v, gradx, grady, gradz);
+        break;
+      case SCHMIDT:
+      default:                  // To avoid compiler warnings
+        SphericalEngine::ValueMulti<true, SphericalEngine::SCHMIDT, K>
+          (c, x, y, z, h[0]->_a, v, gradx, grady, gradz);
+        break;
+      }
+    }
+
+    /**
+     * Repack the coefficients for faster evaluation of a single point.
+     *
+     * @param[in] nsingle the coefficients for degrees above this are held in
+     *   single precision; if this is negative (the default), they are all
+     *   held in \e real.
+     * @exception std::bad_alloc if the memory for the packed coefficients
+     *   can't be allocated.
+     *
+     * This sets up a SphericalEngine::packedcoeff object which operator()()
+     * then uses instead of the coefficients (the other functions are
+     * unaffected).  This takes about twice as much memory as the
+     * coefficients; it is worthwhile for sums of high degree (e.g., over
+     * 500), which are limited by the speed of memory.  The results are the
+     * same to within roundoff.  The packed coefficients are shared by copies
+     * of this object; they reflect the coefficients when this is called, so
+     * Pack should be called again if the coefficients are changed.
+     *
+     * With \e nsingle &ge; 0, the records for the higher degrees take half
+     * the memory and the sums are still accumulated in \e real; the
+     * relative error in the contribution of the terms above \e nsingle is
+     * then about 6 &times; 10<sup>&minus;8</sup> (see
+     * SphericalEngine::packedcoeff).
+     **********************************************************************/
+    void Pack(int nsingle = -1) {
+      _packed = std::make_shared<const SphericalEngine::packedcoeff>
+        (_c[0], SphericalEngine::normalization(_norm), nsingle);
+    }
+
+    /**
+     * @return the packed coefficients (a null pointer if Pack hasn't been
+     *   called).
+     **********************************************************************/
+    const std::shared_ptr<const SphericalEngine::packedcoeff>& Packed() const
+    { return _packed; }
+
     /**
      * @return the zeroth SphericalEngine::coeff object.
      **********************************************************************/
@@ -148,6 +148,38 @@ namespace GeographicLib {
       _c[1] = SphericalEngine::coeff(C1, S1, N1, nmx1, mmx1);
     }
 
+    /**
+     * Constructor with the coefficients given by SphericalEngine::coeff
+     * objects.
+     *
+     * @param[in] c the coefficients <i>C</i><sub><i>nm</i></sub> and
+     *   <i>S</i><sub><i>nm</i></sub>.
+     * @param[in] c1 the coefficients <i>C'</i><sub><i>nm</i></sub> and
+     *   <i>S'</i><sub><i>nm</i></sub>.
+     * @param[in] a the reference radius appearing in the definition of the
+     *   sum.
+     * @param[in] norm the normalization for the associated Legendre
+     *   polynomials, either SphericalHarmonic1::FULL (the default) or
+     *   SphericalHarmonic1::SCHMIDT.
+     * @exception GeographicErr if \e c1.nmx() &gt; \e c.nmx() or \e
+     *   c1.mmx() &gt; \e c.mmx().
+     *
+     * The storage referred to by \e c and \e c1 should not be altered or
+     * destroyed during the lifetime of a SphericalHarmonic1 object.
+     **********************************************************************/
+    SphericalHarmonic1(const SphericalEngine::coeff& c,
+                       const SphericalEngine::coeff& c1,
+                       real a, unsigned norm = FULL)
+      : _a(a)
+      , _norm(norm) {
+      if (!(c1.nmx() <= c.nmx()))
+        throw GeographicErr("nmx1 cannot be larger that nmx");
+      if (!(c1.mmx() <= c.mmx()))
+        throw GeographicErr("mmx1 cannot be larger that mmx");
+      _c[0] = c;
+      _c[1] = c1;
+    }
+
     /**
      * A default constructor so that the object can be created when the
      * constructor for another object is initialized.  This default object can
@@ -221,6 +253,91 @@ namespace GeographicLib {
       return v;
     }
 
+    /**
+     * Compute a spherical harmonic sum with a correction term, its gradient,
+     * and its second derivatives.
+     *
+     * @param[in] tau multiplier for correction coefficients \e C' and \e S'.
+     * @param[in] x cartesian coordinate.
+     * @param[in] y cartesian coordinate.
+     * @param[in] z cartesian coordinate.
+     * @param[out] gradx \e x component of the gradient
+     * @param[out] grady \e y component of the gradient
+     * @param[out] gradz \e z component of the gradient
+     * @param[out] hess an array of 9 elements giving the matrix of second
+     *   derivatives in row-major order.
+     * @exception std::bad_alloc if the memory for the temporary array can't
+     *   be allocated.
+     * @return \e V the spherical harmonic sum.
+     *
+     * See SphericalHarmonic::Hessian.
+     **********************************************************************/
+    Math::real Hessian(real tau, real x, real y, real z,
+                       real& gradx, real& grady, real& gradz,
+                       real hess[]) const {
+      real f[] = {1, tau};
+      real v = 0;
+      switch (_norm) {
+      case FULL:
+        v = SphericalEngine::Hessian<SphericalEngine::FULL, 2>
+          (_c, f, x, y, z, _a, gradx, grady, gradz, hess);
+        break;
+      case SCHMIDT:
+      default:                  // To avoid compiler warnings
+        v = SphericalEngine::Hessian<SphericalEngine::SCHMIDT, 2>
+          (_c, f, x, y, z, _a, gradx, grady, gradz, hess);
+        break;
+      }
+      return v;
+    }
+
+    /**
+     * Compute a spherical harmonic sum with a correction term (and optionally
+     * its gradient) at several points.
+     *
+     * @param[in] tau multiplier for correction coefficients \e C' and \e S'.
+     * @param[in] n the number of points.
+     * @param[in] x array of cartesian coordinates.
+     * @param[in] y array of cartesian coordinates.
+     * @param[in] z array of cartesian coordinates.
+     * @param[out] v array of spherical harmonic sums.
+     * @param[out] gradx (optional) array of \e x components of the gradients.
+     * @param[out] grady (optional) array of \e y components of the gradients.
+     * @param[out] gradz (optional) array of \e z components of the gradients.
+     *
+     * This is the counterpart of SphericalHarmonic::ValueBatch; it gives the
+     * same results as calling operator()() for each point.  The gradients are
+     * only computed if \e gradx, \e grady, and \e gradz are all non-null.
+     * This routine requires constant memory and thus never throws an
+     * exception.
+     **********************************************************************/
+    void ValueBatch(real tau, size_t n,
+                    const real x[], const real y[], const real z[],
+                    real v[], real gradx[] = nullptr, real grady[] = nullptr,
+                    real gradz[] = nullptr) const {
+      real f[] = {1, tau};
+      bool gradp = gradx && grady && gradz;
+      switch (_norm) {
+      case FULL:
+        if (gradp)
+          SphericalEngine::ValueBatch<true, SphericalEngine::FULL, 2>
+            (_c, f, n, x, y, z, _a, v, gradx, grady, gradz);
+        else
+          SphericalEngine::ValueBatch<false, SphericalEngine::FULL, 2>
+            (_c, f, n, x, y, z, _a, v, nullptr, nullptr, nullptr);
+        break;
+      case SCHMIDT:
+      default:                  // To avoid compiler warnings
+        if (gradp)
+          SphericalEngine::ValueBatch<true, SphericalEngine::SCHMIDT, 2>
+            (_c, f, n, x, y, z, _a, v, gradx, grady, gradz);
+        else
+          SphericalEngine::ValueBatch<false, SphericalEngine::SCHMIDT, 2>
+            (_c, f, n, x, y, z, _a, v, nullptr, nullptr, nullptr);
+        break;
+      }
+    }
+
     /**
      * Create a CircularEngine to allow the efficient evaluation of several
      * points on a circle of latitude at a fixed value of \e tau.
@@ -246,22 +363,76 @@ namespace GeographicLib {
      * See SphericalHarmonic::Circle for an example of its use.
      **********************************************************************/
     CircularEngine Circle(real tau, real p, real z, bool gradp) const {
+      CircularEngine circ;
+      Circle(tau, p, z, gradp, circ);
+      return circ;
+    }
+
+    /**
+     * Set up an existing CircularEngine object for a new circle of latitude.
+     *
+     * @param[in] tau multiplier for correction coefficients \e C' and \e S'.
+     * @param[in] p the radius of the circle.
+     * @param[in] z the height of the circle above the equatorial plane.
+     * @param[in] gradp if true the returned object will be able to compute
+     *   the gradient of the sum.
+     * @param[in,out] circ the CircularEngine object.
+     * @exception std::bad_alloc if the memory for the CircularEngine can't be
+     *   allocated.
+     *
+     * This sets \e circ to the object that the other version of Circle
+     * returns, reusing the storage that \e circ already holds; so a loop over
+     * many circles of latitude doesn't allocate memory once \e circ has
+     * grown to the needed size.
+     **********************************************************************/
+    void Circle(real tau, real p, real z, bool gradp,
+                CircularEngine& circ) const {
       real f[] = {1, tau};
       switch (_norm) {
       case FULL:
-        return gradp ?
+        if (gradp)
           SphericalEngine::Circle<true, SphericalEngine::FULL, 2>
-          (_c, f, p, z, _a) :
+            (_c, f, p, z, _a, circ);
+        else
           SphericalEngine::Circle<false, SphericalEngine::FULL, 2>
-          (_c, f, p, z, _a);
+            (_c, f, p, z, _a, circ);
         break;
       case SCHMIDT:
       default:                  // To avoid compiler warnings
-        return gradp ?
+        if (gradp)
           SphericalEngine::Circle<true, SphericalEngine::SCHMIDT, 2>
-          (_c, f, p, z, _a) :
+            (_c, f, p, z, _a, circ);
+        else
           SphericalEngine::Circle<false, SphericalEngine::SCHMIDT, 2>
-          (_c, f, p, z, _a);
+            (_c, f, p, z, _a, circ);
+        break;
+      }
+    }
+
+    /**
+     * Set up a CircularEngine object which can compute the second derivatives
+     * of the sum on a circle of latitude.
+     *
+     * @param[in] tau multiplier for correction coefficients \e C' and \e S'.
+     * @param[in] p the radius of the circle.
+     * @param[in] z the height of the circle above the equatorial plane.
+     * @param[in,out] circ the CircularEngine object.
+     * @exception std::bad_alloc if the memory for the CircularEngine can't be
+     *   allocated.
+     *
+     * See SphericalHarmonic::CircleHessian.
+     **********************************************************************/
+    void CircleHessian(real tau, real p, real z, CircularEngine& circ) const {
+      real f[] = {1, tau};
+      switch (_norm) {
+      case FULL:
+        SphericalEngine::CircleHessian<SphericalEngine::FULL, 2>
+          (_c, f, p, z, _a, circ);
+        break;
+      case SCHMIDT:
+      default:                  // To avoid compiler warnings
+        SphericalEngine::CircleHessian<SphericalEngine::SCHMIDT, 2>
+          (_c, f, p, z, _a, circ);
         break;
       }
     }
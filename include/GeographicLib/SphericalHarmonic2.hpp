@@ -278,22 +278,50 @@ namespace GeographicLib {
      **********************************************************************/
     CircularEngine Circle(real tau1, real tau2, real p, real z, bool gradp)
       const {
+      CircularEngine circ;
+      Circle(tau1, tau2, p, z, gradp, circ);
+      return circ;
+    }
+
+    /**
+     * Set up an existing CircularEngine object for a new circle of latitude.
+     *
+     * @param[in] tau1 multiplier for correction coefficients \e C' and \e S'.
+     * @param[in] tau2 multiplier for correction coefficients \e C'' and
+     *   \e S''.
+     * @param[in] p the radius of the circle.
+     * @param[in] z the height of the circle above the equatorial plane.
+     * @param[in] gradp if true the returned object will be able to compute
+     *   the gradient of the sum.
+     * @param[in,out] circ the CircularEngine object.
+     * @exception std::bad_alloc if the memory for the CircularEngine can't be
+     *   allocated.
+     *
+     * This sets \e circ to the object that the other version of Circle
+     * returns, reusing the storage that \e circ already holds; so a loop over
+     * many circles of latitude doesn't allocate memory once \e circ has
+     * grown to the needed size.
+     **********************************************************************/
+    void Circle(real tau1, real tau2, real p, real z, bool gradp,
+                CircularEngine& circ) const {
       real f[] = {1, tau1, tau2};
       switch (_norm) {
       case FULL:
-        return gradp ?
+        if (gradp)
           SphericalEngine::Circle<true, SphericalEngine::FULL, 3>
-          (_c, f, p, z, _a) :
+            (_c, f, p, z, _a, circ);
+        else
           SphericalEngine::Circle<false, SphericalEngine::FULL, 3>
-          (_c, f, p, z, _a);
+            (_c, f, p, z, _a, circ);
         break;
       case SCHMIDT:
       default:                  // To avoid compiler warnings
-        return gradp ?
+        if (gradp)
           SphericalEngine::Circle<true, SphericalEngine::SCHMIDT, 3>
-          (_c, f, p, z, _a) :
+            (_c, f, p, z, _a, circ);
+        else
           SphericalEngine::Circle<false, SphericalEngine::SCHMIDT, 3>
-          (_c, f, p, z, _a);
+            (_c, f, p, z, _a, circ);
         break;
       }
     }
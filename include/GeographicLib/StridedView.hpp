@@ -0,0 +1,134 @@
+/**
+ * \file StridedView.hpp
+ * \brief Header for GeographicLib::StridedView class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_STRIDEDVIEW_HPP)
+#define GEOGRAPHICLIB_STRIDEDVIEW_HPP 1
+
+#include <GeographicLib/Constants.hpp>
+#include <cstddef>
+
+namespace GeographicLib {
+
+  /**
+   * \brief A view of an array with a stride
+   *
+   * This lets the batch routines read and write coordinates in place in
+   * buffers where they aren't contiguous, avoiding copies into temporary
+   * arrays.  Element \e i of the view is \e p[\e i * \e stride].  The common
+   * cases are
+   * - an interleaved buffer, e.g., the GeoArrow interleaved point layout
+   *   (\e x, \e y, \e x, \e y, ...) where \e x is the longitude and \e y the
+   *   latitude; the latitudes are StridedView<const double>(p + 1, 2) and
+   *   the longitudes are StridedView<const double>(p, 2).  Interleaved
+   *   builds these views.
+   * - a column of a row-major table or a strided numpy array; the stride is
+   *   in elements (so the numpy stride in bytes must be divided by the item
+   *   size).  The stride may be negative.
+   *
+   * (The GeoArrow separated layout is a pair of contiguous arrays and can be
+   * passed to the batch routines directly.)  A view converts implicitly from
+   * a pointer (with a stride of 1) and from a view of non-const elements to
+   * a view of const elements.  A view of a null pointer stands for an
+   * omitted array.
+   *
+   * The batch routines which accept views are Geodesic::InverseBatch,
+   * Geodesic::DirectBatch, UTMUPS::ForwardBatch, PolygonAreaT::ComputeBatch,
+   * and Geoid::HeightBatch.  Their results are identical to those of the
+   * versions which take pointers.
+   *
+   * Example of use:
+   * \code
+   * // Distances between the consecutive points of a GeoArrow interleaved
+   * // linestring with n vertices
+   * const double* xy = ...;
+   * std::vector<double> s12(n - 1);
+   * typedef StridedView<const double> view;
+   * Geodesic::WGS84().InverseBatch
+   *   (n - 1, view::Interleaved(xy, 2, 1), view::Interleaved(xy, 2, 0),
+   *    view::Interleaved(xy + 2, 2, 1), view::Interleaved(xy + 2, 2, 0),
+   *    Geodesic::DISTANCE, nullptr, s12.data(), nullptr, nullptr,
+   *    nullptr, nullptr, nullptr, nullptr);
+   * \endcode
+   *
+   * @tparam T the type of the elements (const for an input array).
+   **********************************************************************/
+  template<typename T>
+  class StridedView {
+  private:
+    T* _p;
+    std::ptrdiff_t _stride;
+  public:
+    /**
+     * Constructor.
+     *
+     * @param[in] p a pointer to element 0 (default nullptr).
+     * @param[in] stride the distance between consecutive elements in units
+     *   of T (default 1).
+     **********************************************************************/
+    StridedView(T* p = nullptr, std::ptrdiff_t stride = 1)
+      : _p(p), _stride(stride) {}
+
+    /**
+     * Convert a view of non-const elements to a view of const elements.
+     *
+     * @tparam U the type of the elements of \e v.
+     * @param[in] v the view.
+     **********************************************************************/
+    template<typename U>
+    StridedView(const StridedView<U>& v)
+      : _p(v.data()), _stride(v.stride()) {}
+
+    /**
+     * A view of one component of an interleaved buffer.
+     *
+     * @param[in] p a pointer to the buffer.
+     * @param[in] ncomp the number of components of each element.
+     * @param[in] comp the component (in [0, \e ncomp)).
+     * @return the view of component \e comp.
+     **********************************************************************/
+    static StridedView Interleaved(T* p, unsigned ncomp, unsigned comp)
+    { return StridedView(p + comp, std::ptrdiff_t(ncomp)); }
+
+    /**
+     * @param[in] i the index.
+     * @return a reference to element \e i.
+     **********************************************************************/
+    T& operator[](size_t i) const
+    { return _p[std::ptrdiff_t(i) * _stride]; }
+
+    /**
+     * @param[in] i the index.
+     * @return the view starting at element \e i.
+     **********************************************************************/
+    StridedView operator+(size_t i) const
+    { return StridedView(_p + std::ptrdiff_t(i) * _stride, _stride); }
+
+    /**
+     * @return whether the view is of a non-null pointer.
+     **********************************************************************/
+    explicit operator bool() const { return _p != nullptr; }
+
+    /** \name Inspector functions
+     **********************************************************************/
+    ///@{
+    /**
+     * @return the pointer to element 0.
+     **********************************************************************/
+    T* data() const { return _p; }
+
+    /**
+     * @return the stride.
+     **********************************************************************/
+    std::ptrdiff_t stride() const { return _stride; }
+    ///@}
+  };
+
+} // namespace GeographicLib
+
+#endif  // GEOGRAPHICLIB_STRIDEDVIEW_HPP
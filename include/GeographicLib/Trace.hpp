@@ -0,0 +1,159 @@
+/**
+ * \file Trace.hpp
+ * \brief Header for GeographicLib::Trace class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_TRACE_HPP)
+#define GEOGRAPHICLIB_TRACE_HPP 1
+
+#include <GeographicLib/Constants.hpp>
+#include <iosfwd>
+#include <string>
+
+#if GEOGRAPHICLIB_INSTRUMENT
+/**
+ * Mark the rest of the enclosing scope as a span with the given name (a
+ * string literal) for Trace.  This expands to nothing unless
+ * GEOGRAPHICLIB_INSTRUMENT = 1.
+ **********************************************************************/
+#  define GEOGRAPHICLIB_TRACE_SPAN(name) \
+  GeographicLib::Trace::Span geographiclib_trace_span(name)
+#else
+#  define GEOGRAPHICLIB_TRACE_SPAN(name) ((void)0)
+#endif
+
+namespace GeographicLib {
+
+  /**
+   * \brief Timed spans for finding where the time goes
+   *
+   * When the library is configured with GEOGRAPHICLIB_INSTRUMENT = 1 (see
+   * Histogram), the operations which dominate cold starts and tail latency
+   * are marked as spans: the constructors of Geoid, GravityModel, and
+   * MagneticModel (which read the data files), Geoid::CacheArea,
+   * Geoid::CacheTiles, and SphericalEngine::Value (every spherical harmonic
+   * sum).  The GeoidEval, Gravity, and MagneticField utilities also mark
+   * their stages.
+   *
+   * Nothing is recorded until Enable(true) is called (or a handler is
+   * installed).  The recorded spans can be written with WriteJSON in the
+   * Chrome trace event format, which can be loaded into Perfetto
+   * (https://ui.perfetto.dev) or chrome://tracing.  Alternatively,
+   * SetHandler installs a function which is called at the beginning and end
+   * of each span on the thread executing it; this can pass the spans on to,
+   * e.g., the Perfetto SDK (TRACE_EVENT_BEGIN and TRACE_EVENT_END) or Intel
+   * ITT (__itt_task_begin and __itt_task_end).
+   *
+   * With GEOGRAPHICLIB_INSTRUMENT = 0, no spans are marked and tracing costs
+   * nothing.  Even when instrumented, a span costs only a relaxed atomic
+   * load when tracing is off.  The functions may be called from several
+   * threads.
+   **********************************************************************/
+  class GEOGRAPHICLIB_EXPORT Trace {
+  public:
+    /**
+     * The type of a handler: it is called with the name of the span and with
+     * \e begin = true at its start and false at its end.
+     **********************************************************************/
+    typedef void (*handler)(const char* name, bool begin);
+
+    /**
+     * Turn the recording of spans on or off.
+     *
+     * @param[in] on whether to record the spans.
+     **********************************************************************/
+    static void Enable(bool on);
+
+    /**
+     * @return whether the spans are being recorded.
+     **********************************************************************/
+    static bool Enabled();
+
+    /**
+     * Install a handler for the spans.
+     *
+     * @param[in] h the handler; nullptr removes the handler.
+     **********************************************************************/
+    static void SetHandler(handler h);
+
+    /**
+     * Discard the recorded spans.
+     **********************************************************************/
+    static void Clear();
+
+    /**
+     * @return the number of recorded spans.
+     **********************************************************************/
+    static size_t Size();
+
+    /**
+     * Write the recorded spans in the Chrome trace event format.
+     *
+     * @param[in,out] os the output stream.
+     *
+     * The times are measured in microseconds from the first use of Trace.
+     * The threads are numbered consecutively in the order in which they
+     * first recorded a span.
+     **********************************************************************/
+    static void WriteJSON(std::ostream& os);
+
+    /**
+     * \brief A span
+     *
+     * The span begins when the object is constructed and ends when it is
+     * destroyed.  Usually, this is created with GEOGRAPHICLIB_TRACE_SPAN.
+     **********************************************************************/
+    class GEOGRAPHICLIB_EXPORT Span {
+    private:
+      const char* _name;
+      long long _start;
+      handler _h;
+      bool _rec;
+    public:
+      /**
+       * Begin a span.
+       *
+       * @param[in] name the name of the span; this must be a string with
+       *   static storage duration, e.g., a string literal.
+       **********************************************************************/
+      explicit Span(const char* name);
+      /**
+       * End the span.
+       **********************************************************************/
+      ~Span();
+      Span(const Span&) = delete;
+      Span& operator=(const Span&) = delete;
+    };
+
+    /**
+     * \brief Trace a whole program
+     *
+     * If the environment variable GEOGRAPHICLIB_TRACE is set to a file name,
+     * the constructor turns on recording and the destructor writes the spans
+     * to that file with WriteJSON.  This is used by the utility programs.
+     * With GEOGRAPHICLIB_INSTRUMENT = 0 this does nothing.
+     **********************************************************************/
+    class GEOGRAPHICLIB_EXPORT Session {
+    private:
+      std::string _file;
+    public:
+      /**
+       * Start the session.
+       **********************************************************************/
+      Session();
+      /**
+       * End the session and write the trace.
+       **********************************************************************/
+      ~Session();
+      Session(const Session&) = delete;
+      Session& operator=(const Session&) = delete;
+    };
+  };
+
+} // namespace GeographicLib
+
+#endif  // GEOGRAPHICLIB_TRACE_HPP
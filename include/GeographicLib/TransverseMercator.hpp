@@ -78,6 +78,16 @@ namespace GeographicLib {
    * The meridian convergence is the bearing of grid north (the \e y axis)
    * measured clockwise from true north.
    *
+   * The series coefficients are computed once in the constructor and the
+   * order of the series, GEOGRAPHICLIB_TRANSVERSEMERCATOR_ORDER, is a
+   * compile-time constant, so that the compiler can unroll the Clenshaw
+   * summations.  The rest of the projection consists of the evaluation of
+   * several elementary transcendental functions which don't depend on the
+   * ellipsoid.  So, rather than specializing the class for a particular
+   * ellipsoid, reuse a single object (e.g., the one returned by
+   * TransverseMercator::UTM()) and use ForwardBatch and ReverseBatch to
+   * project many points.
+   *
    * See TransverseMercator.cpp for more information on the implementation.
    *
    * See \ref transversemercator for a discussion of this projection.
@@ -99,6 +109,31 @@ namespace GeographicLib {
     // _alp[0] and _bet[0] unused
     real _a1, _b1, _alp[maxpow_ + 1], _bet[maxpow_ + 1];
     friend class Ellipsoid;           // For access to taupf, tauf.
+    // The number of points processed together by ForwardBatch and
+    // ReverseBatch
+    static const int batchsize_ = 8;
+    // The steps before and after the Clenshaw summations in Forward and
+    // Reverse
+    void ForwardStart(real lon0, real lat, real lon,
+                      real& xip, real& etap, real& gamma, real& k,
+                      int& latsign, int& lonsign, bool& backside) const;
+    void ForwardFinish(real xi, real eta, int latsign, int lonsign,
+                       bool backside,
+                       real& x, real& y, real& gamma, real& k) const;
+    void ReverseStart(real x, real y, real& xi, real& eta,
+                      int& xisign, int& etasign, bool& backside) const;
+    void ReverseFinish(real lon0, real xip, real etap, int xisign,
+                       int etasign, bool backside,
+                       real& lat, real& lon, real& gamma, real& k) const;
+    template<typename T>
+    void IntForwardBatch(size_t n, real lon0, const T lat[], const T lon[],
+                         T x[], T y[], T gamma[], T k[]) const;
+    template<typename T>
+    void IntReverseBatch(size_t n, real lon0, const T x[], const T y[],
+                         T lat[], T lon[], T gamma[], T k[]) const;
+    void IntTransferBatch(size_t n, real lon0in, const real xin[],
+                          const real yin[], real lon0out,
+                          real xout[], real yout[], real lon[]) const;
   public:
 
     /**
@@ -165,6 +200,132 @@ namespace GeographicLib {
       Reverse(lon0, x, y, lat, lon, gamma, k);
     }
 
+    /**
+     * Forward projection of several points.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lon0 central meridian of the projection (degrees).
+     * @param[in] lat array of latitudes (degrees).
+     * @param[in] lon array of longitudes (degrees).
+     * @param[out] x array of eastings (meters).
+     * @param[out] y array of northings (meters).
+     * @param[out] gamma (optional) array of meridian convergences
+     *   (degrees).
+     * @param[out] k (optional) array of scales.
+     *
+     * This gives the same results as calling Forward for each point.  The
+     * arrays are separate (a "structure of arrays" layout) and the points are
+     * processed in batches so that the Clenshaw summations of the Kr&uuml;ger
+     * series are evaluated for all the points in a batch together, allowing
+     * the compiler to vectorize them.  \e gamma and \e k may be nullptr if
+     * these quantities are not needed.  The output arrays may coincide with
+     * the input arrays.
+     **********************************************************************/
+    void ForwardBatch(size_t n, real lon0, const real lat[], const real lon[],
+                      real x[], real y[],
+                      real gamma[] = nullptr, real k[] = nullptr) const;
+
+    /**
+     * Reverse projection of several points.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lon0 central meridian of the projection (degrees).
+     * @param[in] x array of eastings (meters).
+     * @param[in] y array of northings (meters).
+     * @param[out] lat array of latitudes (degrees).
+     * @param[out] lon array of longitudes (degrees).
+     * @param[out] gamma (optional) array of meridian convergences
+     *   (degrees).
+     * @param[out] k (optional) array of scales.
+     *
+     * This gives the same results as calling Reverse for each point; see
+     * ForwardBatch.  (The results may differ for points so far from the
+     * central meridian that intermediate quantities overflow; both
+     * functions then return nonsensical values.)
+     **********************************************************************/
+    void ReverseBatch(size_t n, real lon0, const real x[], const real y[],
+                      real lat[], real lon[],
+                      real gamma[] = nullptr, real k[] = nullptr) const;
+
+    /**
+     * Transfer several points from one central meridian to another.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lon0in central meridian of the input projection (degrees).
+     * @param[in] xin array of eastings (meters) for \e lon0in.
+     * @param[in] yin array of northings (meters) for \e lon0in.
+     * @param[in] lon0out central meridian of the output projection
+     *   (degrees).
+     * @param[out] xout array of eastings (meters) for \e lon0out.
+     * @param[out] yout array of northings (meters) for \e lon0out.
+     * @param[out] lon (optional) array of longitudes (degrees).
+     *
+     * This is equivalent to calling ReverseBatch with \e lon0in followed by
+     * ForwardBatch with \e lon0out; however the two projections are fused.
+     * The conformal latitude found by the reverse projection is the same for
+     * both projections; so it's used directly by the forward projection and
+     * neither the latitude nor its trigonometric functions are computed.  This
+     * skips the most expensive steps (the solution for the latitude by
+     * Newton's method in the reverse projection and its inverse in the
+     * forward projection) and avoids the roundoff they introduce; the results
+     * agree with the separate projections to within a few nanometers.  \e
+     * lon may be nullptr if the longitudes are not needed.  The output arrays
+     * may coincide with the input arrays.
+     **********************************************************************/
+    void TransferBatch(size_t n, real lon0in, const real xin[],
+                       const real yin[], real lon0out,
+                       real xout[], real yout[], real lon[] = nullptr) const;
+
+#if GEOGRAPHICLIB_PRECISION != 1
+    /**
+     * Forward projection of several points given as floats.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lon0 central meridian of the projection (degrees).
+     * @param[in] lat array of latitudes (degrees).
+     * @param[in] lon array of longitudes (degrees).
+     * @param[out] x array of eastings (meters).
+     * @param[out] y array of northings (meters).
+     * @param[out] gamma (optional) array of meridian convergences
+     *   (degrees).
+     * @param[out] k (optional) array of scales.
+     *
+     * This is the same as the other version of ForwardBatch except that the
+     * data is held in floats, which halves the memory traffic for large
+     * numbers of points.  The computations are carried out with reals and
+     * the results are rounded to floats.  A float carries about 7
+     * significant digits, so northings are only given to about 0.5 m and
+     * latitudes and longitudes to about 10<sup>&minus;5</sup>&deg;.  This
+     * function is not available if the library is compiled with
+     * GEOGRAPHICLIB_PRECISION = 1 (since then real is float).
+     **********************************************************************/
+    void ForwardBatch(size_t n, real lon0,
+                      const float lat[], const float lon[],
+                      float x[], float y[],
+                      float gamma[] = nullptr, float k[] = nullptr) const;
+
+    /**
+     * Reverse projection of several points given as floats.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lon0 central meridian of the projection (degrees).
+     * @param[in] x array of eastings (meters).
+     * @param[in] y array of northings (meters).
+     * @param[out] lat array of latitudes (degrees).
+     * @param[out] lon array of longitudes (degrees).
+     * @param[out] gamma (optional) array of meridian convergences
+     *   (degrees).
+     * @param[out] k (optional) array of scales.
+     *
+     * This is the same as the other version of ReverseBatch except that the
+     * data is held in floats; see the float version of ForwardBatch.
+     **********************************************************************/
+    void ReverseBatch(size_t n, real lon0,
+                      const float x[], const float y[],
+                      float lat[], float lon[],
+                      float gamma[] = nullptr, float k[] = nullptr) const;
+#endif
+
     /** \name Inspector functions
      **********************************************************************/
     ///@{
@@ -190,9 +351,29 @@ namespace GeographicLib {
     /**
      * A global instantiation of TransverseMercator with the WGS84 ellipsoid
      * and the UTM scale factor.  However, unlike UTM, no false easting or
-     * northing is added.
+     * northing is added.  This is constructed when the library is loaded
+     * (see Geodesic::WGS84()).
      **********************************************************************/
     static const TransverseMercator& UTM();
+
+    /**
+     * A shared instance of TransverseMercator for a given ellipsoid and
+     * central scale.
+     *
+     * @param[in] a equatorial radius (meters).
+     * @param[in] f flattening of ellipsoid.
+     * @param[in] k0 central scale factor.
+     * @exception GeographicErr if \e a, (1 &minus; \e f) \e a, or \e k0 is
+     *   not positive.
+     * @return a TransverseMercator object with these parameters.
+     *
+     * The first call with a given set of parameters constructs the object and
+     * later calls return the same object; see SharedInstances for the
+     * details.  Finding an existing object doesn't take a lock and costs
+     * much less than constructing it.  The object lives until the program
+     * exits.
+     **********************************************************************/
+    static const TransverseMercator& Get(real a, real f, real k0);
   };
 
 } // namespace GeographicLib
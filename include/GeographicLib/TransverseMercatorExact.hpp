@@ -10,8 +10,18 @@
 #if !defined(GEOGRAPHICLIB_TRANSVERSEMERCATOREXACT_HPP)
 #define GEOGRAPHICLIB_TRANSVERSEMERCATOREXACT_HPP 1
 
+#include <vector>
 #include <GeographicLib/Constants.hpp>
 #include <GeographicLib/EllipticFunction.hpp>
+#if GEOGRAPHICLIB_INSTRUMENT
+#include <GeographicLib/Histogram.hpp>
+#endif
+
+#if defined(_MSC_VER)
+// Squelch warnings about dll vs vector
+#  pragma warning (push)
+#  pragma warning (disable: 4251)
+#endif
 
 namespace GeographicLib {
 
@@ -88,8 +98,21 @@ namespace GeographicLib {
     static const int numit_ = 10;
     real tol_, tol2_, taytol_;
     real _a, _f, _k0, _mu, _mv, _e;
-    bool _extendp;
+    bool _extendp, _seedp;
     EllipticFunction _eEu, _eEv;
+    // The seed tables for zetainv and sigmainv: the differences between the
+    // solutions and the starting guesses given by zetainv0 and sigmainv0 on
+    // grids in (psi, lam) and (xi, eta).  The entries are interleaved (du,
+    // dv) pairs; consecutive nodes in the second coordinate are adjacent.
+    static const int zetanx_ = 187, zetany_ = 49, sigmanx_ = 49, sigmany_ = 49;
+    real _zetah, _sigmahx, _sigmahy;
+    std::vector<real> _zetatab, _sigmatab;
+#if GEOGRAPHICLIB_INSTRUMENT
+    mutable Histogram _zetainvit, _sigmainvit;
+#endif
+    void SeedTables();
+    static void seedinterp(const real tab[], int nx, int ny, real x, real y,
+                           real& du, real& dv);
 
     void zeta(real u, real snu, real cnu, real dnu,
               real v, real snv, real cnv, real dnv,
@@ -118,6 +141,10 @@ namespace GeographicLib {
                real snv, real cnv, real dnv,
                real& gamma, real& k) const;
 
+    // Forward with the computation of gamma and k optional
+    void Forward(real lon0, real lat, real lon,
+                 real& x, real& y, real& gamma, real& k, bool scalep) const;
+
   public:
 
     /**
@@ -127,7 +154,11 @@ namespace GeographicLib {
      * @param[in] f flattening of ellipsoid.
      * @param[in] k0 central scale factor.
      * @param[in] extendp use extended domain.
+     * @param[in] seedtable precompute tables of starting guesses for the
+     *   iterative solutions in Forward and Reverse (default false).
      * @exception GeographicErr if \e a, \e f, or \e k0 is not positive.
+     * @exception std::bad_alloc if the memory for the tables can't be
+     *   allocated.
      *
      * The transverse Mercator projection has a branch point singularity at \e
      * lat = 0 and \e lon &minus; \e lon0 = 90 (1 &minus; \e e) or (for
@@ -168,8 +199,23 @@ namespace GeographicLib {
      * limit, and in practice, \e f should be larger than about
      * numeric_limits<real>::epsilon().  However, TransverseMercator treats the
      * sphere exactly.
+     *
+     * Forward and Reverse find the Thompson coordinates of a point by solving
+     * for the roots of an equation involving elliptic functions with Newton's
+     * method; this dominates the cost.  With \e seedtable = true, the
+     * constructor tabulates the corrections to the starting guesses for
+     * Newton's method over grids covering |<i>lon</i> &minus; <i>lon0</i>|
+     * &le; 60&deg; and |\e lat| &le; 88&deg; (for Forward) and
+     * |<i>x</i>|/(\e k0 \e a) &le; 1.3 (for Reverse); for points in these
+     * regions, the starting guess is then interpolated from the tables
+     * (taking about 20 ms and 190 kB).  This reduces the number of
+     * iterations from about 4 to 2 and makes Forward and Reverse about 25%
+     * faster.
+     * Newton's method is still iterated to convergence, so the results differ
+     * from those with \e seedtable = false only because of roundoff.
      **********************************************************************/
-    TransverseMercatorExact(real a, real f, real k0, bool extendp = false);
+    TransverseMercatorExact(real a, real f, real k0, bool extendp = false,
+                            bool seedtable = false);
 
     /**
      * Forward projection, from geographic to transverse Mercator.
@@ -186,7 +232,9 @@ namespace GeographicLib {
      * [&minus;90&deg;, 90&deg;].
      **********************************************************************/
     void Forward(real lon0, real lat, real lon,
-                 real& x, real& y, real& gamma, real& k) const;
+                 real& x, real& y, real& gamma, real& k) const {
+      Forward(lon0, lat, lon, x, y, gamma, k, true);
+    }
 
     /**
      * Reverse projection, from transverse Mercator to geographic.
@@ -207,12 +255,13 @@ namespace GeographicLib {
 
     /**
      * TransverseMercatorExact::Forward without returning the convergence and
-     * scale.
+     * scale.  This is faster because the convergence and scale are not
+     * computed.
      **********************************************************************/
     void Forward(real lon0, real lat, real lon,
                  real& x, real& y) const {
       real gamma, k;
-      Forward(lon0, lat, lon, x, y, gamma, k);
+      Forward(lon0, lat, lon, x, y, gamma, k, false);
     }
 
     /**
@@ -225,6 +274,52 @@ namespace GeographicLib {
       Reverse(lon0, x, y, lat, lon, gamma, k);
     }
 
+    /**
+     * Forward projection of several points.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lon0 central meridian of the projection (degrees).
+     * @param[in] lat array of latitudes (degrees).
+     * @param[in] lon array of longitudes (degrees).
+     * @param[out] x array of eastings (meters).
+     * @param[out] y array of northings (meters).
+     * @param[out] gamma (optional) array of meridian convergences
+     *   (degrees).
+     * @param[out] k (optional) array of scales.
+     *
+     * This is equivalent to calling Forward for each point and is provided
+     * for compatibility with TransverseMercator::ForwardBatch.  The arrays
+     * \e gamma and \e k may be omitted (or set to nullptr) if these
+     * quantities are not needed.  The output arrays may coincide with the
+     * input arrays.  Because the number of iterations needed by Forward
+     * varies from point to point, there's no advantage in processing the
+     * points in lockstep; the principal way of speeding up many projections
+     * is to construct the object with \e seedtable = true.
+     **********************************************************************/
+    void ForwardBatch(size_t n, real lon0, const real lat[], const real lon[],
+                      real x[], real y[],
+                      real gamma[] = nullptr, real k[] = nullptr) const;
+
+    /**
+     * Reverse projection of several points.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lon0 central meridian of the projection (degrees).
+     * @param[in] x array of eastings (meters).
+     * @param[in] y array of northings (meters).
+     * @param[out] lat array of latitudes (degrees).
+     * @param[out] lon array of longitudes (degrees).
+     * @param[out] gamma (optional) array of meridian convergences
+     *   (degrees).
+     * @param[out] k (optional) array of scales.
+     *
+     * This is equivalent to calling Reverse for each point; see
+     * ForwardBatch.
+     **********************************************************************/
+    void ReverseBatch(size_t n, real lon0, const real x[], const real y[],
+                      real lat[], real lon[],
+                      real gamma[] = nullptr, real k[] = nullptr) const;
+
     /** \name Inspector functions
      **********************************************************************/
     ///@{
@@ -245,8 +340,42 @@ namespace GeographicLib {
      *   k0 used in the constructor and is the scale on the central meridian.
      **********************************************************************/
     Math::real CentralScale() const { return _k0; }
+
+    /**
+     * @return true if the object was constructed with \e seedtable = true.
+     **********************************************************************/
+    bool SeedTable() const { return _seedp; }
     ///@}
 
+#if GEOGRAPHICLIB_INSTRUMENT
+    /** \name Solver statistics (only if GEOGRAPHICLIB_INSTRUMENT = 1)
+     **********************************************************************/
+    ///@{
+    /**
+     * @return a histogram of the number of Newton iterations needed to invert
+     *   the conformal map in Forward(); 0 means that the starting guess was
+     *   exact (e.g., on the central meridian).
+     **********************************************************************/
+    const Histogram& ForwardIterations() const { return _zetainvit; }
+
+    /**
+     * @return a histogram of the number of Newton iterations needed to invert
+     *   the projection in Reverse(); 0 means that the starting guess was
+     *   exact.
+     **********************************************************************/
+    const Histogram& ReverseIterations() const { return _sigmainvit; }
+
+    /**
+     * Reset the statistics.  The constructor calls this after building the
+     * seed tables.
+     **********************************************************************/
+    void ResetStatistics() const {
+      _zetainvit.Reset(); _sigmainvit.Reset();
+      _eEu.ResetStatistics(); _eEv.ResetStatistics();
+    }
+    ///@}
+#endif
+
     /**
      * A global instantiation of TransverseMercatorExact with the WGS84
      * ellipsoid and the UTM scale factor.  However, unlike UTM, no false
@@ -257,4 +386,8 @@ namespace GeographicLib {
 
 } // namespace GeographicLib
 
+#if defined(_MSC_VER)
+#  pragma warning (pop)
+#endif
+
 #endif  // GEOGRAPHICLIB_TRANSVERSEMERCATOREXACT_HPP
@@ -0,0 +1,250 @@
+/**
+ * \file TriaxialGeodesic.hpp
+ * \brief Header for GeographicLib::TriaxialGeodesic class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_TRIAXIALGEODESIC_HPP)
+#define GEOGRAPHICLIB_TRIAXIALGEODESIC_HPP 1
+
+#include <GeographicLib/Constants.hpp>
+
+namespace GeographicLib {
+
+  class TriaxialGeodesicLine;
+
+  /**
+   * \brief Geodesics on a triaxial ellipsoid
+   *
+   * This solves the direct and inverse geodesic problems on a triaxial
+   * ellipsoid with semi-axes \e a &gt; \e b &gt; \e c &gt; 0,
+   * \f[
+   *   \frac{X^2}{a^2} + \frac{Y^2}{b^2} + \frac{Z^2}{c^2} = 1.
+   * \f]
+   * Points are given in terms of the ellipsoidal latitude &beta; and
+   * longitude &omega; with
+   * \f[
+   *   \begin{aligned}
+   *   X &= a \cos\omega \sqrt{k^2\cos^2\beta + k'^2}, \\
+   *   Y &= b \cos\beta \sin\omega, \\
+   *   Z &= c \sin\beta \sqrt{k^2 + k'^2\sin^2\omega},
+   *   \end{aligned}
+   * \f]
+   * where \f$ k^2 = (b^2 - c^2)/(a^2 - c^2) \f$ and \f$ k'^2 = (a^2 -
+   * b^2)/(a^2 - c^2) \f$.  The equator &beta; = 0 is the principal ellipse
+   * \e Z = 0 and the four umbilical points are at &beta; = &plusmn;90&deg;,
+   * &omega; = 0&deg; or 180&deg;.  Points with |&beta;| = 90&deg; and
+   * longitudes &plusmn;&omega; coincide.  The azimuth &alpha; is measured
+   * clockwise from the direction of increasing &beta; (i.e., it is 90&deg;
+   * in the direction of increasing &omega;).
+   *
+   * The solution follows Jacobi: the metric separates in (&beta;, &omega;)
+   * and a geodesic has the constant of the motion
+   * \f[
+   *   \gamma = k^2 \cos^2\beta \sin^2\alpha - k'^2 \sin^2\omega
+   *   \cos^2\alpha.
+   * \f]
+   * For &gamma; &gt; 0 the geodesic circles the \e Z axis with &beta;
+   * oscillating; for &gamma; &lt; 0 it circles the \e X axis with &omega;
+   * oscillating; the two cases are related by swapping \e a and \e c.  The
+   * quadratures relating &beta; and &omega; to each other and to the
+   * distance are made regular by substituting Jacobi elliptic functions
+   * (using EllipticFunction) and the resulting periodic integrands are fit
+   * with Fourier series (using DST::cosinefit).  This work is done once in
+   * the constructor of TriaxialGeodesicLine; subsequent positions along the
+   * line are found by solving the Fourier series with Newton's method.
+   *
+   * The inverse problem is solved by Newton's method on the starting
+   * azimuth and the distance, starting from the chord between the points.
+   * If the result is shorter than &pi;<i>bc</i>/<i>a</i> (a lower bound on
+   * the injectivity radius of the ellipsoid), it is necessarily the shortest
+   * geodesic.  Otherwise a search over starting azimuths is carried out to
+   * find the shortest of the geodesics connecting the points; this is
+   * several times slower.
+   *
+   * Geodesics passing very close to an umbilical point (&gamma; &asymp; 0)
+   * need long Fourier series.  If &gamma; is exactly 0, a tiny positive
+   * value is substituted.  The results are undefined if the starting point
+   * is an umbilical point (where the azimuth is undefined).
+   *
+   * The ellipsoid must be strictly triaxial; use Geodesic or GeodesicExact
+   * for an ellipsoid of revolution.
+   *
+   * Example of use:
+   * \include example-TriaxialGeodesic.cpp
+   **********************************************************************/
+
+  class GEOGRAPHICLIB_EXPORT TriaxialGeodesic {
+  private:
+    typedef Math::real real;
+    friend class TriaxialGeodesicLine;
+    real _a, _b, _c, _k2, _kp2;
+    void cart(real sbet, real cbet, real somg, real comg, real r[]) const;
+    void tangents(real sbet, real cbet, real somg, real comg,
+                  real ebet[], real eomg[]) const;
+    bool Newton(real bet1, real omg1, const real r2[],
+                real& s12, real& alp1) const;
+    bool Search(real bet1, real omg1, const real r2[],
+                bool have, real& s12, real& alp1) const;
+  public:
+
+    /**
+     * Constructor for a triaxial ellipsoid.
+     *
+     * @param[in] a the largest semi-axis (meters).
+     * @param[in] b the middle semi-axis (meters).
+     * @param[in] c the smallest semi-axis (meters).
+     * @exception GeographicErr unless \e a &gt; \e b &gt; \e c &gt; 0.
+     **********************************************************************/
+    TriaxialGeodesic(real a, real b, real c);
+
+    /**
+     * Solve the direct geodesic problem.
+     *
+     * @param[in] bet1 ellipsoidal latitude of point 1 (degrees).
+     * @param[in] omg1 ellipsoidal longitude of point 1 (degrees).
+     * @param[in] alp1 azimuth at point 1 (degrees).
+     * @param[in] s12 distance from point 1 to point 2 (meters); it can be
+     *   negative.
+     * @param[out] bet2 ellipsoidal latitude of point 2 (degrees).
+     * @param[out] omg2 ellipsoidal longitude of point 2 (degrees).
+     * @param[out] alp2 (forward) azimuth at point 2 (degrees).
+     *
+     * \e bet2 is in [&minus;90&deg;, 90&deg;] and \e omg2 and \e alp2 are in
+     * [&minus;180&deg;, 180&deg;].  To compute many points along a single
+     * geodesic, use Line and TriaxialGeodesicLine::Position.
+     **********************************************************************/
+    void Direct(real bet1, real omg1, real alp1, real s12,
+                real& bet2, real& omg2, real& alp2) const;
+
+    /**
+     * Solve the inverse geodesic problem.
+     *
+     * @param[in] bet1 ellipsoidal latitude of point 1 (degrees).
+     * @param[in] omg1 ellipsoidal longitude of point 1 (degrees).
+     * @param[in] bet2 ellipsoidal latitude of point 2 (degrees).
+     * @param[in] omg2 ellipsoidal longitude of point 2 (degrees).
+     * @param[out] s12 distance from point 1 to point 2 (meters).
+     * @param[out] alp1 azimuth at point 1 (degrees).
+     * @param[out] alp2 (forward) azimuth at point 2 (degrees).
+     * @exception GeographicErr if no solution was found.
+     **********************************************************************/
+    void Inverse(real bet1, real omg1, real bet2, real omg2,
+                 real& s12, real& alp1, real& alp2) const;
+
+    /**
+     * Solve several direct geodesic problems.
+     *
+     * @param[in] n the number of problems.
+     * @param[in] bet1 array of latitudes of point 1 (degrees).
+     * @param[in] omg1 array of longitudes of point 1 (degrees).
+     * @param[in] alp1 array of azimuths at point 1 (degrees).
+     * @param[in] s12 array of distances (meters).
+     * @param[out] bet2 array of latitudes of point 2 (degrees).
+     * @param[out] omg2 array of longitudes of point 2 (degrees).
+     * @param[out] alp2 array of azimuths at point 2 (degrees).
+     *
+     * All the arrays have (at least) \e n elements and the results are
+     * identical to calling Direct in a loop.  \e alp2 may be null.  Use
+     * GeodesicBatchExecutor::ForEach to spread the work over several threads.
+     **********************************************************************/
+    void DirectBatch(size_t n, const real bet1[], const real omg1[],
+                     const real alp1[], const real s12[],
+                     real bet2[], real omg2[], real alp2[]) const;
+
+    /**
+     * Solve several inverse geodesic problems.
+     *
+     * @param[in] n the number of problems.
+     * @param[in] bet1 array of latitudes of point 1 (degrees).
+     * @param[in] omg1 array of longitudes of point 1 (degrees).
+     * @param[in] bet2 array of latitudes of point 2 (degrees).
+     * @param[in] omg2 array of longitudes of point 2 (degrees).
+     * @param[out] s12 array of distances (meters).
+     * @param[out] alp1 array of azimuths at point 1 (degrees).
+     * @param[out] alp2 array of azimuths at point 2 (degrees).
+     * @exception GeographicErr if no solution was found for some problem.
+     *
+     * All the arrays have (at least) \e n elements and the results are
+     * identical to calling Inverse in a loop.  \e alp1 and \e alp2 may be
+     * null.
+     **********************************************************************/
+    void InverseBatch(size_t n, const real bet1[], const real omg1[],
+                      const real bet2[], const real omg2[],
+                      real s12[], real alp1[], real alp2[]) const;
+
+    /**
+     * Set up to compute several points on a single geodesic.
+     *
+     * @param[in] bet1 ellipsoidal latitude of point 1 (degrees).
+     * @param[in] omg1 ellipsoidal longitude of point 1 (degrees).
+     * @param[in] alp1 azimuth at point 1 (degrees).
+     * @return a TriaxialGeodesicLine object.
+     **********************************************************************/
+    TriaxialGeodesicLine Line(real bet1, real omg1, real alp1) const;
+
+    /**
+     * Convert ellipsoidal coordinates to cartesian.
+     *
+     * @param[in] bet ellipsoidal latitude (degrees).
+     * @param[in] omg ellipsoidal longitude (degrees).
+     * @param[out] X the \e X coordinate (meters).
+     * @param[out] Y the \e Y coordinate (meters).
+     * @param[out] Z the \e Z coordinate (meters).
+     **********************************************************************/
+    void ToCartesian(real bet, real omg, real& X, real& Y, real& Z) const;
+
+    /**
+     * Convert cartesian coordinates to ellipsoidal.
+     *
+     * @param[in] X the \e X coordinate (meters).
+     * @param[in] Y the \e Y coordinate (meters).
+     * @param[in] Z the \e Z coordinate (meters).
+     * @param[out] bet ellipsoidal latitude (degrees).
+     * @param[out] omg ellipsoidal longitude (degrees).
+     *
+     * The point should lie on the ellipsoid.  If \e Y = 0 and |&beta;| =
+     * 90&deg;, &omega; is returned in [0&deg;, 180&deg;].
+     **********************************************************************/
+    void FromCartesian(real X, real Y, real Z, real& bet, real& omg) const;
+
+    /** \name Inspector functions
+     **********************************************************************/
+    ///@{
+    /**
+     * @return \e a the largest semi-axis (meters).
+     **********************************************************************/
+    Math::real a() const { return _a; }
+
+    /**
+     * @return \e b the middle semi-axis (meters).
+     **********************************************************************/
+    Math::real b() const { return _b; }
+
+    /**
+     * @return \e c the smallest semi-axis (meters).
+     **********************************************************************/
+    Math::real c() const { return _c; }
+
+    /**
+     * @return \e k<sup>2</sup> = (<i>b</i><sup>2</sup> &minus;
+     *   <i>c</i><sup>2</sup>) / (<i>a</i><sup>2</sup> &minus;
+     *   <i>c</i><sup>2</sup>).
+     **********************************************************************/
+    Math::real k2() const { return _k2; }
+
+    /**
+     * @return \e k'<sup>2</sup> = (<i>a</i><sup>2</sup> &minus;
+     *   <i>b</i><sup>2</sup>) / (<i>a</i><sup>2</sup> &minus;
+     *   <i>c</i><sup>2</sup>).
+     **********************************************************************/
+    Math::real kp2() const { return _kp2; }
+    ///@}
+  };
+
+} // namespace GeographicLib
+
+#endif  // GEOGRAPHICLIB_TRIAXIALGEODESIC_HPP
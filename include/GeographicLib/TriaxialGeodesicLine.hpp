@@ -0,0 +1,140 @@
+/**
+ * \file TriaxialGeodesicLine.hpp
+ * \brief Header for GeographicLib::TriaxialGeodesicLine class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_TRIAXIALGEODESICLINE_HPP)
+#define GEOGRAPHICLIB_TRIAXIALGEODESICLINE_HPP 1
+
+#include <GeographicLib/Constants.hpp>
+#include <GeographicLib/EllipticFunction.hpp>
+#include <GeographicLib/TriaxialGeodesic.hpp>
+
+#include <functional>
+#include <vector>
+
+namespace GeographicLib {
+
+  /**
+   * \brief A geodesic line on a triaxial ellipsoid
+   *
+   * TriaxialGeodesicLine facilitates the determination of a series of points
+   * on a single geodesic.  This is a companion to the TriaxialGeodesic class.
+   * The constructor fits the Fourier series describing the geodesic (see
+   * TriaxialGeodesic); this is several times more expensive than a call to
+   * Position.
+   *
+   * Example of use:
+   * \include example-TriaxialGeodesic.cpp
+   **********************************************************************/
+
+  class GEOGRAPHICLIB_EXPORT TriaxialGeodesicLine {
+  private:
+    typedef Math::real real;
+    friend class TriaxialGeodesic;
+
+    // The integral of a positive even function with period pi, fit with a
+    // cosine series: a0 * x + sum(c[j] * sin(2*j*x), j, 1, n).
+    class fseries {
+    private:
+      std::vector<real> _d, _c;  // the integrand and integral coefficients
+      real _bnd;                 // a bound on the periodic part
+    public:
+      void fit(std::function<real(real)> f);
+      real a0() const { return _d[0]; }
+      real bound() const { return _bnd; }
+      const std::vector<real>& coeffs() const { return _c; }
+      // value and derivative
+      real operator()(real x) const;
+      real deriv(real x) const;
+      void eval(real x, real& f, real& fp) const;
+      // the solution of operator()(x) = y
+      real inv(real y) const;
+    };
+
+    real _a, _b, _c, _k2, _kp2;  // for the working orientation
+    real _bet1, _omg1, _alp1, _gam;
+    bool _swap;
+    real _sig, _sqm, _sqg, _kb, _ko, _kK4b, _kK4o;
+    EllipticFunction _eb, _eo;
+    fseries _tb, _sb, _to, _so;
+    real _tb1, _sb1, _to1, _so1, _wbar, _bnd;
+
+    void GenPosition(real s12, real& sbet2, real& cbet2,
+                     real& somg2, real& comg2,
+                     real& salp2, real& calp2) const;
+  public:
+
+    /**
+     * Constructor for a geodesic line starting at point 1.
+     *
+     * @param[in] t the TriaxialGeodesic object to use.
+     * @param[in] bet1 ellipsoidal latitude of point 1 (degrees).
+     * @param[in] omg1 ellipsoidal longitude of point 1 (degrees).
+     * @param[in] alp1 azimuth at point 1 (degrees).
+     * @exception GeographicErr if the Fourier series for the geodesic don't
+     *   converge (this can only happen extremely close to an umbilical
+     *   geodesic).
+     **********************************************************************/
+    TriaxialGeodesicLine(const TriaxialGeodesic& t,
+                         real bet1, real omg1, real alp1);
+
+    /**
+     * Compute the position of point 2 which is a distance \e s12 from point
+     * 1.
+     *
+     * @param[in] s12 distance from point 1 to point 2 (meters); it can be
+     *   negative.
+     * @param[out] bet2 ellipsoidal latitude of point 2 (degrees).
+     * @param[out] omg2 ellipsoidal longitude of point 2 (degrees).
+     * @param[out] alp2 (forward) azimuth at point 2 (degrees).
+     **********************************************************************/
+    void Position(real s12, real& bet2, real& omg2, real& alp2) const;
+
+    /**
+     * Compute several positions along the geodesic.
+     *
+     * @param[in] n the number of positions.
+     * @param[in] s12 array of distances from point 1 (meters).
+     * @param[out] bet2 array of latitudes of the points (degrees).
+     * @param[out] omg2 array of longitudes of the points (degrees).
+     * @param[out] alp2 array of azimuths at the points (degrees).
+     *
+     * All the arrays have (at least) \e n elements and the results are
+     * identical to calling Position in a loop.  \e alp2 may be null.
+     **********************************************************************/
+    void PositionBatch(size_t n, const real s12[],
+                       real bet2[], real omg2[], real alp2[]) const;
+
+    /** \name Inspector functions
+     **********************************************************************/
+    ///@{
+    /**
+     * @return \e bet1 the latitude of point 1 (degrees).
+     **********************************************************************/
+    Math::real Latitude() const { return _bet1; }
+
+    /**
+     * @return \e omg1 the longitude of point 1 (degrees).
+     **********************************************************************/
+    Math::real Longitude() const { return _omg1; }
+
+    /**
+     * @return \e alp1 the azimuth at point 1 (degrees).
+     **********************************************************************/
+    Math::real Azimuth() const { return _alp1; }
+
+    /**
+     * @return &gamma; the constant of the motion for the geodesic.
+     **********************************************************************/
+    Math::real Gamma() const { return _gam; }
+    ///@}
+  };
+
+} // namespace GeographicLib
+
+#endif  // GEOGRAPHICLIB_TRIAXIALGEODESICLINE_HPP
@@ -11,6 +11,7 @@
 #define GEOGRAPHICLIB_UTMUPS_HPP 1
 
 #include <GeographicLib/Constants.hpp>
+#include <GeographicLib/StridedView.hpp>
 
 namespace GeographicLib {
 
@@ -93,6 +94,12 @@ namespace GeographicLib {
     // throwp = false, return bool instead.
     static bool CheckCoords(bool utmp, bool northp, real x, real y,
                             bool msgrlimits = false, bool throwp = true);
+    // CA and A are the types of the input and output arrays, pointers or
+    // StridedViews.
+    template<class CA, class A>
+    static void IntForwardBatch(size_t n, CA lat, CA lon,
+                                int zone[], bool northp[], A x, A y,
+                                A gamma, A k, int setzone, bool mgrslimits);
     UTMUPS() = delete;          // Disable constructor
 
   public:
@@ -263,6 +270,77 @@ namespace GeographicLib {
                         real& lat, real& lon, real& gamma, real& k,
                         bool mgrslimits = false);
 
+    /**
+     * Forward projection of several points.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lat array of latitudes (degrees).
+     * @param[in] lon array of longitudes (degrees).
+     * @param[out] zone array of UTM zones (zero means UPS).
+     * @param[out] northp array of hemispheres (true means north, false means
+     *   south).
+     * @param[out] x array of eastings (meters).
+     * @param[out] y array of northings (meters).
+     * @param[out] gamma (optional) array of meridian convergences (degrees).
+     * @param[out] k (optional) array of scales.
+     * @param[in] setzone zone override (optional).
+     * @param[in] mgrslimits if true enforce the stricter MGRS limits on the
+     *   coordinates (default = false).
+     * @exception GeographicErr if any point would cause Forward to throw an
+     *   exception; in this case, the output arrays may have been partially
+     *   filled.
+     * @exception std::bad_alloc if the memory for the temporary arrays can't
+     *   be allocated.
+     *
+     * This gives the same results as calling Forward for each point.  The
+     * points are processed in blocks of 1024; within each block, the points
+     * are grouped by zone and the points in each UTM zone are projected with
+     * TransverseMercator::ForwardBatch.  \e gamma and \e k
+     * may be nullptr if these quantities are not needed.  The output arrays
+     * may coincide with the input arrays.
+     **********************************************************************/
+    static void ForwardBatch(size_t n, const real lat[], const real lon[],
+                             int zone[], bool northp[], real x[], real y[],
+                             real gamma[] = nullptr, real k[] = nullptr,
+                             int setzone = STANDARD, bool mgrslimits = false);
+
+    /**
+     * Forward projection of several points with the coordinates in strided
+     * arrays.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lat view of the latitudes (degrees).
+     * @param[in] lon view of the longitudes (degrees).
+     * @param[out] zone array of UTM zones (zero means UPS).
+     * @param[out] northp array of hemispheres (true means north, false means
+     *   south).
+     * @param[out] x view of the eastings (meters).
+     * @param[out] y view of the northings (meters).
+     * @param[out] gamma (optional) view of the meridian convergences
+     *   (degrees).
+     * @param[out] k (optional) view of the scales.
+     * @param[in] setzone zone override (optional).
+     * @param[in] mgrslimits if true enforce the stricter MGRS limits on the
+     *   coordinates (default = false).
+     * @exception GeographicErr if any point would cause Forward to throw an
+     *   exception.
+     * @exception std::bad_alloc if the memory for the temporary arrays can't
+     *   be allocated.
+     *
+     * This is the same as the other version of ForwardBatch except that the
+     * coordinates are StridedView objects; e.g., \e lat and \e lon can be
+     * read from an interleaved buffer and \e x and \e y written back to
+     * the same buffer.
+     **********************************************************************/
+    static void ForwardBatch(size_t n,
+                             StridedView<const real> lat,
+                             StridedView<const real> lon,
+                             int zone[], bool northp[],
+                             StridedView<real> x, StridedView<real> y,
+                             StridedView<real> gamma = StridedView<real>(),
+                             StridedView<real> k = StridedView<real>(),
+                             int setzone = STANDARD, bool mgrslimits = false);
+
     /**
      * UTMUPS::Forward without returning convergence and scale.
      **********************************************************************/
@@ -319,6 +397,45 @@ namespace GeographicLib {
                          int zoneout, bool northpout, real& xout, real& yout,
                          int& zone);
 
+    /**
+     * Transfer several UTM/UPS coordinates to a zone.
+     *
+     * @param[in] n the number of points.
+     * @param[in] zonein array of UTM zones for \e xin and \e yin (zero means
+     *   UPS).
+     * @param[in] northpin array of hemispheres for \e xin and \e yin (true
+     *   means north, false means south).
+     * @param[in] xin array of eastings (meters) in \e zonein.
+     * @param[in] yin array of northings (meters) in \e zonein.
+     * @param[in] zoneout the requested UTM zone for \e xout and \e yout (or
+     *   zero for UPS).
+     * @param[in] northpout hemisphere for \e xout output and \e yout.
+     * @param[out] xout array of eastings (meters) in \e zoneout.
+     * @param[out] yout array of northings (meters) in \e zoneout.
+     * @param[out] zone array of the actual UTM zones for \e xout and \e yout
+     *   (zero means UPS).
+     * @exception GeographicErr if Transfer would throw an exception for any
+     *   point; in this case, the output arrays may have been partially
+     *   filled.
+     * @exception std::bad_alloc if the memory for the temporary arrays can't
+     *   be allocated.
+     *
+     * This is equivalent to calling Transfer for each point.  If \e zoneout
+     * is a UTM zone, the points in the other UTM zones are processed in
+     * blocks of 1024; within each block, the points are grouped by input
+     * zone and the points in each group are transferred with
+     * TransverseMercator::TransferBatch, which fuses the reverse and forward
+     * projections.  The results then agree with Transfer to within a few
+     * nanometers.  The other points (and all the points if \e zoneout isn't
+     * a UTM zone) are transferred with Transfer.  The output arrays may
+     * coincide with the input arrays.
+     **********************************************************************/
+    static void TransferBatch(size_t n, const int zonein[],
+                              const bool northpin[],
+                              const real xin[], const real yin[],
+                              int zoneout, bool northpout,
+                              real xout[], real yout[], int zone[]);
+
     /**
      * Decode a UTM/UPS zone string.
      *
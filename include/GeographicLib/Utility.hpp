@@ -46,6 +46,21 @@ namespace GeographicLib {
     static bool gregorian(int s) {
       return s >= 639799;       // 1752-09-14
     }
+    // Read a plain number from [s, end) with strtod, etc., without a
+    // stream.  Return false if [s, end) is not of the form [+-]ddd.ddde[+-]dd
+    // (or [+-]ddd for integers) or if the result might differ from that
+    // given by a stream (e.g., on overflow); the caller should then fall
+    // back to the stream.  The generic version always returns false.
+    template<typename T>
+    static bool fastval(const char*, const char*, T&) { return false; }
+    static bool fastval(const char* s, const char* end, float& x);
+    static bool fastval(const char* s, const char* end, double& x);
+    static bool fastval(const char* s, const char* end, long double& x);
+    static bool fastval(const char* s, const char* end, int& x);
+    static bool fastval(const char* s, const char* end, long& x);
+    static bool fastval(const char* s, const char* end, long long& x);
+    // Does [s, s + len) match the upper case string t ignoring case?
+    static bool upmatch(const char* s, size_t len, const char* t);
   public:
 
     /**
@@ -164,6 +179,24 @@ namespace GeographicLib {
       s << std::boolalpha << x; return s.str();
     }
 
+    /**
+     * Convert a Math::real to a string in a character array.
+     *
+     * @param[in] x the value to be converted.
+     * @param[in] p the precision used.
+     * @param[out] s a char array to receive the null-terminated string.
+     * @param[in] n the size of \e s.
+     * @exception GeographicErr if \e s is too small.
+     * @return the length of the string.
+     *
+     * This gives the same string as str(x, p).  If \e p &ge; 0 and real is
+     * float, double, or long double, the number is formatted with snprintf;
+     * this is several times faster than str(x, p) which allocates an
+     * ostringstream and the string.  (std::to_chars would be faster still,
+     * but it requires C++17.)
+     **********************************************************************/
+    static size_t str(Math::real x, int p, char s[], size_t n);
+
     /**
      * Trim the white space from the beginning and end of a string.
      *
@@ -226,6 +259,9 @@ namespace GeographicLib {
       // If T is bool, then the specialization val<bool>() defined below is
       // used.
       T x;
+      if (val<T>(s.data(), s.size(), x))
+        return x;
+      // Repeat the conversion to get the error message
       std::string errmsg, t(trim(s));
       do {                     // Executed once (provides the ability to break)
         std::istringstream is(t);
@@ -240,10 +276,48 @@ namespace GeographicLib {
         }
         return x;
       } while (false);
-      x = std::numeric_limits<T>::is_integer ? 0 : nummatch<T>(t);
-      if (x == 0)
-        throw GeographicErr(errmsg);
-      return x;
+      throw GeographicErr(errmsg);
+    }
+
+    /**
+     * Convert a char array to type T without throwing an exception.
+     *
+     * @tparam T the type of the result (this should be an arithmetic type).
+     * @param[in] s the characters to be converted.
+     * @param[in] len the number of characters.
+     * @param[out] x the result.
+     * @return whether the conversion succeeded.
+     *
+     * This is the same as val<T>(std::string(s, len)) except that failure is
+     * signaled by the return value instead of an exception (and \e x is then
+     * unchanged).  Plain numbers, e.g., -12.5e3, are read with strtod (or
+     * strtof, strtold, or strtoll) which avoids the allocations of a string
+     * and a stream; other strings are read with a stream as by val<T>().
+     **********************************************************************/
+    template<typename T>
+    static bool val(const char* s, size_t len, T& x) {
+      const char* end = s + len;
+      while (s < end && std::isspace(static_cast<unsigned char>(*s))) ++s;
+      while (s < end && std::isspace(static_cast<unsigned char>(end[-1])))
+        --end;
+      if (fastval(s, end, x))
+        return true;
+      T y;
+      std::istringstream is(std::string(s, end));
+      if (is >> y) {
+        int pos = int(is.tellg()); // Returns -1 at end of string?
+        if (pos < 0 || pos == int(end - s)) {
+          x = y;
+          return true;
+        }
+      }
+      if (std::numeric_limits<T>::is_integer)
+        return false;
+      y = nummatch<T>(s, size_t(end - s));
+      if (y == 0)
+        return false;
+      x = y;
+      return true;
     }
 
     /**
@@ -257,25 +331,38 @@ namespace GeographicLib {
      *
      * White space is not allowed at the beginning or end of \e s.
      **********************************************************************/
-    template<typename T> static T nummatch(const std::string& s) {
-      if (s.length() < 3)
+    template<typename T> static T nummatch(const std::string& s)
+    { return nummatch<T>(s.data(), s.size()); }
+
+    /**
+     * Match "nan" and "inf" (and variants thereof) in a char array.
+     *
+     * @tparam T the type of the return value (this should be a floating point
+     *   type).
+     * @param[in] s the characters to be matched.
+     * @param[in] len the number of characters.
+     * @return appropriate special value (&plusmn;&infin;, nan) or 0 if none is
+     *   found.
+     *
+     * This is the same as nummatch<T>(std::string(s, len)) but it doesn't
+     * allocate memory.
+     **********************************************************************/
+    template<typename T> static T nummatch(const char* s, size_t len) {
+      if (len < 3)
         return 0;
-      std::string t(s);
-      for (std::string::iterator p = t.begin(); p != t.end(); ++p)
-        *p = char(std::toupper(*p));
-      for (size_t i = s.length(); i--;)
-        t[i] = char(std::toupper(s[i]));
-      int sign = t[0] == '-' ? -1 : 1;
-      std::string::size_type p0 = t[0] == '-' || t[0] == '+' ? 1 : 0;
-      std::string::size_type p1 = t.find_last_not_of('0');
-      if (p1 == std::string::npos || p1 + 1 < p0 + 3)
+      int sign = s[0] == '-' ? -1 : 1;
+      size_t p0 = s[0] == '-' || s[0] == '+' ? 1 : 0, p1 = len;
+      while (p1 > 0 && s[p1 - 1] == '0') --p1;
+      if (p1 < p0 + 3)
         return 0;
       // Strip off sign and trailing 0s
-      t = t.substr(p0, p1 + 1 - p0);  // Length at least 3
-      if (t == "NAN" || t == "1.#QNAN" || t == "1.#SNAN" || t == "1.#IND" ||
-          t == "1.#R")
+      s += p0; len = p1 - p0;   // Length at least 3
+      if (upmatch(s, len, "NAN") || upmatch(s, len, "1.#QNAN") ||
+          upmatch(s, len, "1.#SNAN") || upmatch(s, len, "1.#IND") ||
+          upmatch(s, len, "1.#R"))
         return Math::NaN<T>();
-      else if (t == "INF" || t == "1.#INF" || t == "INFINITY")
+      else if (upmatch(s, len, "INF") || upmatch(s, len, "1.#INF") ||
+               upmatch(s, len, "INFINITY"))
         return sign * Math::infinity<T>();
       return 0;
     }
@@ -325,12 +412,22 @@ namespace GeographicLib {
           std::numeric_limits<ExtT>::is_integer)
         {
           // Data is compatible (aside from the issue of endian-ness).
-          str.read(reinterpret_cast<char*>(array), num * sizeof(ExtT));
-          if (!str.good())
-            throw GeographicErr("Failure reading data");
-          if (bigendp != Math::bigendian) { // endian mismatch -> swap bytes
-            for (size_t i = num; i--;)
-              array[i] = Math::swab<IntT>(array[i]);
+          if (bigendp == Math::bigendian) {
+            str.read(reinterpret_cast<char*>(array), num * sizeof(ExtT));
+            if (!str.good())
+              throw GeographicErr("Failure reading data");
+          } else {
+            // Endian mismatch -> swap bytes.  Read in pieces which fit in
+            // the cache and swap each piece in place.
+            const size_t bufsize = size_t(1) << 16;
+            for (size_t i = 0; i < num; i += bufsize) {
+              size_t n = (std::min)(num - i, bufsize);
+              str.read(reinterpret_cast<char*>(array + i), n * sizeof(ExtT));
+              if (!str.good())
+                throw GeographicErr("Failure reading data");
+              for (size_t j = i; j < i + n; ++j)
+                array[j] = Math::swab<IntT>(array[j]);
+            }
           }
         }
       else
@@ -465,6 +562,29 @@ namespace GeographicLib {
                           std::string& key, std::string& value,
                           char equals = '\0', char comment = '#');
 
+    /**
+     * Look up a data file compiled into the library.
+     *
+     * @param[in] name the name of the file, e.g., "geoids/egm96-5.pgm" or
+     *   "magnetic/wmm2020.wmm".
+     * @param[out] data the contents of the file (unchanged if the file isn't
+     *   present).
+     * @param[out] size the length of the file (unchanged if the file isn't
+     *   present).
+     * @return whether the file is present.
+     *
+     * Data files are compiled into the library if the cmake variables
+     * GEOGRAPHICLIB_EMBED_GEOIDS and GEOGRAPHICLIB_EMBED_MAGNETIC list them;
+     * the names are then formed from the subdirectory ("geoids" or
+     * "magnetic") and the file name.  The data is aligned on an 8-byte
+     * boundary.  Geoid and MagneticModel use these files in place of the
+     * ones in the file system, if no directory is given when they are
+     * constructed; this allows them to be used on systems without a file
+     * system, with no file I/O.
+     **********************************************************************/
+    static bool EmbeddedData(const std::string& name,
+                             const char*& data, size_t& size);
+
     /**
      * Set the binary precision of a real number.
      *
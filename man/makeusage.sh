@@ -7,9 +7,10 @@ VERSION=$2
 
 (
 cat<<EOF
-int usage(int retval, bool brief) {
+int usage(int retval, bool brief,
+          std::ostream& out = std::cout, std::ostream& err = std::cerr) {
   if (brief)
-    ( retval ? std::cerr : std::cout ) << "Usage:\n\\
+    ( retval ? err : out ) << "Usage:\n\\
 EOF
 
 $POD2MAN $SOURCE | nroff -c -man 2>/dev/null | $COL -b -x |
@@ -22,7 +23,7 @@ For full documentation type:\n\\
 or visit:\n\\
     https://geographiclib.sourceforge.io/C++/$VERSION/$NAME.1.html\n";
   else
-    ( retval ? std::cerr : std::cout ) << "Man page:\n\\
+    ( retval ? err : out ) << "Man page:\n\\
 EOF
 
 $POD2MAN $SOURCE | nroff -c -man 2>/dev/null | $COL -b -x | head --lines -4 |
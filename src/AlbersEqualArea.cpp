@@ -281,6 +281,17 @@ namespace GeographicLib {
     _k0 = sqrt(tphi1 == tphi2 ? 1 : C / (_m02 + _n0 * _qZ * _sxi0)) * k1;
     _k2 = Math::sq(_k0);
     _lat0 = _sign * atan(tphi0)/Math::degree();
+    // For abs(f) <= 1/150, the Fourier series for the conversion from
+    // authalic latitude to geographic latitude is accurate to double
+    // precision; this replaces Newton's method in tphif.
+    _series = fabs(_f) <= 1/real(150);
+    fill(_cxi, _cxi + AuxLatitude::Lmax, real(0));
+    if (_series) {
+      AuxLatitude aux(_f);
+      const real* c = aux._c + AuxLatitude::Lmax *
+        AuxLatitude::ind(AuxLatitude::GEOGRAPHIC, AuxLatitude::AUTHALIC);
+      copy(c, c + AuxLatitude::Lmax, _cxi);
+    }
   }
 
   const AlbersEqualArea& AlbersEqualArea::CylindricalEqualArea() {
@@ -334,6 +345,19 @@ namespace GeographicLib {
     real
       tphi = txi,
       stol = tol_ * fmax(real(1), fabs(txi));
+    if (_series) {
+      // Add the Fourier series for phi - xi to xi.
+      real
+        cxi = 1 / hyp(txi), sxi = txi * cxi,
+        d = AuxLatitude::Clenshaw(sxi, cxi, _cxi, AuxLatitude::Lmax),
+        sd = sin(d), cd = cos(d),
+        den = cxi * cd - sxi * sd;
+      if (den != 0) tphi = (sxi * cd + cxi * sd) / den;
+      // The result is accurate to double precision; higher precisions need
+      // a Newton step to polish it.
+      if (numeric_limits<real>::digits <= numeric_limits<double>::digits)
+        return tphi;
+    }
     // CHECK: min iterations = 1, max iterations = 2; mean = 1.99
     for (int i = 0; i < numit_ || GEOGRAPHICLIB_PANIC; ++i) {
       // dtxi/dtphi = (scxi/scphi)^3 * 2*(1-e^2)/(qZ*(1-e^2*sphi^2)^2)
@@ -497,7 +521,7 @@ namespace GeographicLib {
     lon = Math::AngDiff(lon0, lon);
     lat *= _sign;
     real sphi, cphi;
-    Math::sincosd(Math::LatFix(lat) * _sign, sphi, cphi);
+    Math::sincosdInline(Math::LatFix(lat) * _sign, sphi, cphi);
     cphi = fmax(epsx_, cphi);
     real
       lam = lon * Math::degree(),
@@ -533,12 +557,38 @@ namespace GeographicLib {
       theta = atan2(nx, y1),
       lam = _n0 != 0 ? theta / (_k2 * _n0) : x / (y1 * _k0);
     gamma = _sign * theta / Math::degree();
-    lat = Math::atand(_sign * tphi);
+    lat = Math::atan2dInline(_sign * tphi, real(1));
     lon = lam / Math::degree();
-    lon = Math::AngNormalize(lon + Math::AngNormalize(lon0));
+    lon = Math::AngNormalizeInline(lon + Math::AngNormalizeInline(lon0));
     k = _k0 * (den != 0 ? (_nrho0 + _n0 * drho) * hyp(_fm * tphi) / _a : 1);
   }
 
+  void AlbersEqualArea::ForwardBatch(size_t n, real lon0,
+                                     const real lat[], const real lon[],
+                                     real x[], real y[],
+                                     real gamma[], real k[]) const {
+    for (size_t i = 0; i < n; ++i) {
+      real xi, yi, gi, ki;
+      Forward(lon0, lat[i], lon[i], xi, yi, gi, ki);
+      x[i] = xi; y[i] = yi;
+      if (gamma) gamma[i] = gi;
+      if (k) k[i] = ki;
+    }
+  }
+
+  void AlbersEqualArea::ReverseBatch(size_t n, real lon0,
+                                     const real x[], const real y[],
+                                     real lat[], real lon[],
+                                     real gamma[], real k[]) const {
+    for (size_t i = 0; i < n; ++i) {
+      real lati, loni, gi, ki;
+      Reverse(lon0, x[i], y[i], lati, loni, gi, ki);
+      lat[i] = lati; lon[i] = loni;
+      if (gamma) gamma[i] = gi;
+      if (k) k[i] = ki;
+    }
+  }
+
   void AlbersEqualArea::SetScale(real lat, real k) {
     if (!(isfinite(k) && k > 0))
       throw GeographicErr("Scale is not positive");
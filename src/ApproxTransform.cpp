@@ -0,0 +1,148 @@
+/**
+ * \file ApproxTransform.cpp
+ * \brief Implementation for GeographicLib::ApproxTransform class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#include <GeographicLib/ApproxTransform.hpp>
+#include <GeographicLib/Utility.hpp>
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  ApproxTransform::ApproxTransform(const transform& f, real tol, int order)
+    : _f(f)
+    , _tol(tol)
+    , _order(order)
+  {
+    if (!(tol > 0))
+      throw GeographicErr("Tolerance " + Utility::str(tol)
+                          + " not positive");
+    if (!(order >= 1 && order <= maxorder_))
+      throw GeographicErr("Order " + Utility::str(order) + " not in [1, "
+                          + Utility::str(int(maxorder_)) + "]");
+  }
+
+  Math::real ApproxTransform::Clenshaw(const real c[], int n, real s) {
+    // sum(c[k] * T_k(s), k = 0..n-1)
+    real b1 = 0, b2 = 0;
+    for (int k = n - 1; k > 0; --k) {
+      real b0 = c[k] + 2 * s * b1 - b2;
+      b2 = b1; b1 = b0;
+    }
+    return c[0] + s * b1 - b2;
+  }
+
+  void ApproxTransform::Exact(real x0, real y0, real dx, real dy, int nx,
+                              int i0, int i1, int j0, int j1,
+                              real u[], real v[],
+                              vector<real>& xs, vector<real>& ys) const {
+    int mx = i1 - i0;
+    xs.resize(mx); ys.resize(mx);
+    for (int i = i0; i < i1; ++i)
+      xs[i - i0] = x0 + i * dx;
+    for (int j = j0; j < j1; ++j) {
+      fill(ys.begin(), ys.end(), y0 + j * dy);
+      size_t k = size_t(j) * nx + i0;
+      _f(mx, xs.data(), ys.data(), u + k, v + k);
+    }
+  }
+
+  size_t ApproxTransform::Fill(real x0, real y0, real dx, real dy, int nx,
+                               int i0, int i1, int j0, int j1,
+                               real u[], real v[],
+                               vector<real>& xs, vector<real>& ys) const {
+    const int m = _order + 1, q = 2 * m + 1, np = m * m + q * q;
+    int mx = i1 - i0, my = j1 - j0;
+    // Transform small blocks exactly; the fit would cost more than it saves.
+    if (mx < 2 * m || my < 2 * m || size_t(mx) * my <= size_t(np)) {
+      Exact(x0, y0, dx, dy, nx, i0, i1, j0, j1, u, v, xs, ys);
+      return size_t(mx) * my;
+    }
+    // The block spans s, t in [-1, 1]
+    real
+      xc = x0 + (i0 + i1 - 1) * dx / 2, xh = (mx - 1) * dx / 2,
+      yc = y0 + (j0 + j1 - 1) * dy / 2, yh = (my - 1) * dy / 2;
+    // The Chebyshev nodes followed by the test lattice
+    vector<real> nodes(m);
+    for (int k = 0; k < m; ++k)
+      nodes[k] = cos(Math::pi() * (k + real(0.5)) / m);
+    vector<real> px(np), py(np), pu(np), pv(np);
+    for (int l = 0; l < m; ++l)
+      for (int k = 0; k < m; ++k) {
+        px[l * m + k] = xc + xh * nodes[k];
+        py[l * m + k] = yc + yh * nodes[l];
+      }
+    for (int l = 0; l < q; ++l)
+      for (int k = 0; k < q; ++k) {
+        px[m * m + l * q + k] = xc + xh * (2 * k - (q - 1)) / (q - 1);
+        py[m * m + l * q + k] = yc + yh * (2 * l - (q - 1)) / (q - 1);
+      }
+    _f(np, px.data(), py.data(), pu.data(), pv.data());
+    // The coefficients a[k * m + l] of T_k(s) T_l(t)
+    vector<real> au(m * m, 0), av(m * m, 0), tk(m * m);
+    for (int k = 0; k < m; ++k)
+      for (int i = 0; i < m; ++i)
+        tk[k * m + i] = cos(Math::pi() * k * (i + real(0.5)) / m);
+    for (int k = 0; k < m; ++k)
+      for (int l = 0; l < m; ++l) {
+        real su = 0, sv = 0;
+        for (int j = 0; j < m; ++j)
+          for (int i = 0; i < m; ++i) {
+            real w = tk[k * m + i] * tk[l * m + j];
+            su += w * pu[j * m + i]; sv += w * pv[j * m + i];
+          }
+        real c = (k ? 2 : 1) * (l ? 2 : 1) / real(m * m);
+        au[k * m + l] = c * su; av[k * m + l] = c * sv;
+      }
+    // Evaluate the polynomials at (s, t); the coefficients of T_k(s) for
+    // the current t are in bu, bv.
+    vector<real> bu(m), bv(m);
+    auto row = [m, &au, &av, &bu, &bv](real t) -> void {
+      for (int k = 0; k < m; ++k) {
+        bu[k] = Clenshaw(au.data() + k * m, m, t);
+        bv[k] = Clenshaw(av.data() + k * m, m, t);
+      }
+    };
+    bool ok = true;
+    for (int l = 0; l < q && ok; ++l) {
+      row(real(2 * l - (q - 1)) / (q - 1));
+      for (int k = 0; k < q && ok; ++k) {
+        real s = real(2 * k - (q - 1)) / (q - 1);
+        int i = m * m + l * q + k;
+        ok = hypot(Clenshaw(bu.data(), m, s) - pu[i],
+                   Clenshaw(bv.data(), m, s) - pv[i]) <= _tol / 2;
+      }
+    }
+    if (!ok) {
+      int im = i0 + mx / 2, jm = j0 + my / 2;
+      return
+        Fill(x0, y0, dx, dy, nx, i0, im, j0, jm, u, v, xs, ys) +
+        Fill(x0, y0, dx, dy, nx, im, i1, j0, jm, u, v, xs, ys) +
+        Fill(x0, y0, dx, dy, nx, i0, im, jm, j1, u, v, xs, ys) +
+        Fill(x0, y0, dx, dy, nx, im, i1, jm, j1, u, v, xs, ys);
+    }
+    for (int j = j0; j < j1; ++j) {
+      row(real(2 * (j - j0) - (my - 1)) / (my - 1));
+      size_t k0 = size_t(j) * nx;
+      for (int i = i0; i < i1; ++i) {
+        real s = real(2 * (i - i0) - (mx - 1)) / (mx - 1);
+        u[k0 + i] = Clenshaw(bu.data(), m, s);
+        v[k0 + i] = Clenshaw(bv.data(), m, s);
+      }
+    }
+    return size_t(np);
+  }
+
+  size_t ApproxTransform::Grid(real x0, real y0, real dx, real dy,
+                               int nx, int ny, real u[], real v[]) const {
+    if (nx <= 0 || ny <= 0) return 0;
+    vector<real> xs, ys;
+    return Fill(x0, y0, dx, dy, nx, 0, nx, 0, ny, u, v, xs, ys);
+  }
+
+} // namespace GeographicLib
@@ -0,0 +1,56 @@
+/**
+ * \file AuxAngle.cpp
+ * \brief Implementation for the GeographicLib::AuxAngle class.
+ *
+ * This file is an implementation of the methods described in
+ * - C. F. F. Karney,
+ *   On auxiliary latitudes,
+ *   Technical Report, SRI International, December 2022.
+ *   https://arxiv.org/abs/2212.05818
+ * .
+ * Copyright (c) Charles Karney (2022) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#include <GeographicLib/AuxAngle.hpp>
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  AuxAngle AuxAngle::NaN() {
+    return AuxAngle(numeric_limits<real>::quiet_NaN(),
+                    numeric_limits<real>::quiet_NaN());
+  }
+
+  AuxAngle AuxAngle::normalized() const {
+    if ( isnan( tan() ) ||
+         (fabs(_y) > numeric_limits<real>::max()/2 &&
+          fabs(_x) > numeric_limits<real>::max()/2) )
+      // deal with
+      // (0,0), (inf,inf), (nan,nan), (nan,x), (y,nan), (toobig,toobig)
+      return NaN();
+    real r = hypot(_y, _x),
+      y = _y/r, x = _x/r;
+    // deal with r = inf, then one of y,x
+    if (isnan(y)) y = copysign(real(1), _y);
+    if (isnan(x)) x = copysign(real(1), _x);
+    return AuxAngle(y, x);
+  }
+
+  AuxAngle AuxAngle::copyquadrant(const AuxAngle& p) const {
+    return AuxAngle(copysign(y(), p.y()), copysign(x(), p.x()));
+  }
+
+  AuxAngle& AuxAngle::operator+=(const AuxAngle& p) {
+    // Do nothing if p.tan() == 0 to preserve signs of y() and x()
+    if (p.tan() != 0) {
+      real x = _x * p._x - _y * p._y;
+      _y = _y * p._x + _x * p._y;
+      _x = x;
+    }
+    return *this;
+  }
+
+} // namespace GeographicLib
@@ -1,9 +1,6 @@
 /**
  * \file AuxLatitude.cpp
- * \brief Implementation for the GeographicLib::AuxLatitude and
- * GeographicLib::AuxAngle classes.
- *
- * \note This is just sample code.  It is not part of GeographicLib itself.
+ * \brief Implementation for the GeographicLib::AuxLatitude class.
  *
  * This file is an implementation of the methods described in
  * - C. F. F. Karney,
@@ -16,28 +13,8 @@
  * https://geographiclib.sourceforge.io/
  **********************************************************************/
 
-#include "AuxLatitude.hpp"
-
-/// \cond SKIP
-
-#if !defined(AUXLATITUDE_UNOPT)
-// If 1 use the unoptimized formulas in the paper.  Otherwise use the
-// optimizations to improve roundoff for high eccentricity.
-#define AUXLATITUDE_UNOPT 0
-#endif
-
-#if !defined(AUXLATITUDE_NATIVE_ELLIPTIC)
-// If 1 use the templated implementation of RD and RF in this file.  Otherwise
-// use the non-templated versions in the EllipticFunction class.
-#define AUXLATITUDE_NATIVE_ELLIPTIC 1
-#endif
-
-/// \endcond
-
-#if !AUXLATITUDE_NATIVE_ELLIPTIC
-// Use GeographicLib::EllipticFunction class
+#include <GeographicLib/AuxLatitude.hpp>
 #include <GeographicLib/EllipticFunction.hpp>
-#endif
 
 #if defined(_MSC_VER)
 // Squelch warnings about constant conditional expressions
@@ -48,54 +25,10 @@ namespace GeographicLib {
 
   using namespace std;
 
-  template<typename T>
-  AuxAngle<T> AuxAngle<T>::NaN() {
-    return AuxAngle(std::numeric_limits<real>::quiet_NaN(),
-                    std::numeric_limits<real>::quiet_NaN());
-  }
-
-  template<typename T>
-  AuxAngle<T> AuxAngle<T>::normalized() const {
-    if ( isnan( tan() ) ||
-         (fabs(_y) > std::numeric_limits<real>::max()/2 &&
-          fabs(_x) > std::numeric_limits<real>::max()/2) )
-      // deal with
-      // (0,0), (inf,inf), (nan,nan), (nan,x), (y,nan), (toobig,toobig)
-      return NaN();
-    real r = hypot(_y, _x),
-      y = _y/r, x = _x/r;
-    // deal with r = inf, then one of y,x
-    if (isnan(y)) y = copysign(real(1), _y);
-    if (isnan(x)) x = copysign(real(1), _x);
-    return AuxAngle(y, x);
-  }
-
-  template<typename T>
-  AuxAngle<T> AuxAngle<T>::copyquadrant(const AuxAngle& p) const {
-    return AuxAngle(copysign(y(), p.y()), copysign(x(), p.x()));
-  }
-
-  template<typename T>
-  AuxAngle<T>& AuxAngle<T>::operator+=(const AuxAngle& p) {
-    // Do nothing if p.tan() == 0 to preserve signs of y() and x()
-    if (p.tan() != 0) {
-      real x = _x * p._x - _y * p._y;
-      _y = _y * p._x + _x * p._y;
-      _x = x;
-    }
-    return *this;
-  }
-
-  template<typename T>
-  AuxLatitude<T>::AuxLatitude(real f)
+  AuxLatitude::AuxLatitude(real f)
     : tol_( sqrt(numeric_limits<real>::epsilon()) )
-#if AUXLATITUDE_UNOPT
-    , bmin_( numeric_limits<real>::min() )
-    , bmax_( numeric_limits<real>::max() )
-#else
     , bmin_( log2(numeric_limits<real>::min()) )
     , bmax_( log2(numeric_limits<real>::max()) )
-#endif
     , _f( f )
     , _fm1( 1 - _f )
     , _e2( _f * (2 - _f) )
@@ -106,29 +39,20 @@ namespace GeographicLib {
     , _e( sqrt(fabs(_e2)) )
     , _e1( sqrt(fabs(_e12)) )
     , _n2( _n * _n )
-#if AUXLATITUDE_UNOPT
-    , _q( _e12p1 + (_f == 0 ? 1 : (_f > 0 ? asinh(_e1) : atan(_e)) / _e) )
-#else
     , _q( _e12p1 + (_f == 0 ? 1 : (_f > 0 ? atanh(_e) : atan(_e)) / _e) )
-#endif
   {
     if (!(isfinite(_f) && _f < 1 &&
           isfinite(_n) && fabs(_n) < 1))
       throw GeographicErr("Bad ellipsoid parameters");
-    fill(_c, _c + Lmax * AUXNUMBER * AUXNUMBER,
-         numeric_limits<real>::quiet_NaN());
+    for (int auxout = 0; auxout < AUXNUMBER; ++auxout)
+      for (int auxin = 0; auxin < AUXNUMBER; ++auxin)
+        fillcoeff(auxin, auxout, ind(auxout, auxin));
   }
 
-  template<typename T>
-  AuxLatitude<T>::AuxLatitude(real a, real b)
+  AuxLatitude::AuxLatitude(real a, real b)
     : tol_( sqrt(numeric_limits<real>::epsilon()) )
-#if AUXLATITUDE_UNOPT
-    , bmin_( numeric_limits<real>::min() )
-    , bmax_( numeric_limits<real>::max() )
-#else
     , bmin_( log2(numeric_limits<real>::min()) )
     , bmax_( log2(numeric_limits<real>::max()) )
-#endif
     , _f( (a - b) / a )
     , _fm1( b / a )
     , _e2( ((a - b) * (a + b)) / (a * a) )
@@ -139,33 +63,27 @@ namespace GeographicLib {
     , _e( sqrt(fabs(a - b) * (a + b)) / a )
     , _e1( sqrt(fabs(a - b) * (a + b)) / b )
     , _n2( _n * _n )
-#if AUXLATITUDE_UNOPT
-    , _q( _e12p1 + (_f == 0 ? 1 : (_f > 0 ? asinh(_e1) : atan(_e)) / _e) )
-#else
     , _q( _e12p1 + (_f == 0 ? 1 : (_f > 0 ? atanh(_e) : atan(_e)) / _e) )
-#endif
   {
     if (!(isfinite(_f) && _f < 1 &&
           isfinite(_n) && fabs(_n) < 1))
       throw GeographicErr("Bad ellipsoid parameters");
-    fill(_c, _c + Lmax * AUXNUMBER * AUXNUMBER,
-         numeric_limits<real>::quiet_NaN());
+    for (int auxout = 0; auxout < AUXNUMBER; ++auxout)
+      for (int auxin = 0; auxin < AUXNUMBER; ++auxin)
+        fillcoeff(auxin, auxout, ind(auxout, auxin));
   }
 
-  template<typename T>
-  AuxAngle<T> AuxLatitude<T>::Parametric(const angle& phi, real* diff) const {
+  AuxAngle AuxLatitude::Parametric(const angle& phi, real* diff) const {
     if (diff) *diff = _fm1;
     return angle(phi.y() * _fm1, phi.x());
   }
 
-  template<typename T>
-  AuxAngle<T> AuxLatitude<T>::Geocentric(const angle& phi, real* diff) const {
+  AuxAngle AuxLatitude::Geocentric(const angle& phi, real* diff) const {
     if (diff) *diff = _e2m1;
     return angle(phi.y() * _e2m1, phi.x());
   }
 
-  template<typename T>
-  AuxAngle<T> AuxLatitude<T>::Rectifying(const angle& phi, real* diff) const {
+  AuxAngle AuxLatitude::Rectifying(const angle& phi, real* diff) const {
     angle beta(Parametric(phi).normalized());
     real sbeta = fabs(beta.y()), cbeta = fabs(beta.x());
     real a = 1, b = _fm1, ka = _e2, kb = -_e12, ka1 = _e2m1, kb1 = _e12p1,
@@ -185,14 +103,16 @@ namespace GeographicLib {
       db2 = 1 - kb * sb2,
       da2 = ka1 + ka * sb2,
       // DLMF Eq. 19.25.9
-      sa = b * sbeta * ( RF(cb2, db2, 1) - kb * sb2 * RD(cb2, db2, 1) / 3 ),
+      sa = b * sbeta * ( EllipticFunction::RF(cb2, db2, 1)
+                         - kb * sb2 * EllipticFunction::RD(cb2, db2, 1) / 3 ),
       // DLMF Eq. 19.25.10 with complementary angles
-      sb = a * cbeta * ( ka1 * RF(sb2, da2, 1)
-                         + ka * ka1 * cb2 * RD(sb2, 1, da2) / 3
+      sb = a * cbeta * ( ka1 * EllipticFunction::RF(sb2, da2, 1)
+                         + ka * ka1 * cb2 *
+                         EllipticFunction::RD(sb2, 1, da2) / 3
                          + ka * sbeta / sqrt(da2) );
     // sa + sb  = 2*EllipticFunction::RG(a*a, b*b) = a*E(e) = b*E(i*e')
     // mr = a*E(e)*(2/pi) = b*E(i*e')*(2/pi)
-    mr = (2 * (sa + sb)) / Math::pi<real>();
+    mr = (2 * (sa + sb)) / Math::pi();
     smu = sin(sa / mr);
     cmu = sin(sb / mr);
     if (_f < 0) { swap(smu, cmu); swap(a, b); }
@@ -209,16 +129,12 @@ namespace GeographicLib {
     return mu;
   }
 
-  template<typename T>
-  AuxAngle<T> AuxLatitude<T>::Conformal(const angle& phi, real* diff) const {
+  AuxAngle AuxLatitude::Conformal(const angle& phi, real* diff) const {
     real tphi = fabs(phi.tan()), tchi = tphi;
     if ( !( !isfinite(tphi) || tphi == 0 || _f == 0 ) ) {
       real scphi = sc(tphi),
         sig = sinh(_e2 * atanhee(tphi) ),
         scsig = sc(sig);
-#if AUXLATITUDE_UNOPT
-        tchi = tphi * scsig - sig * scphi;
-#else
       if (_f <= 0) {
         tchi = tphi * scsig - sig * scphi;
       } else {
@@ -255,7 +171,6 @@ namespace GeographicLib {
         }
         tchi = tphimsig * (1 + sigtphi) / (scsig + sigtphi * scphi);
       }
-#endif
     }
     angle chi(angle(tchi).copyquadrant(phi));
     if (diff) {
@@ -265,20 +180,14 @@ namespace GeographicLib {
           cbeta = Parametric(phi).normalized().x();
         *diff = _e2m1 * (cbeta / cchi) * (cbeta / cphi);
       } else {
-#if AUXLATITUDE_UNOPT
-        real ss = _f > 0 ? sinh(_e * asinh(_e1)) : sinh(-_e * atan(_e));
-        *diff = _f > 0 ? 1/( sc(ss) + ss ) : sc(ss) - ss;
-#else
         real ss = _f > 0 ? sinh(_e * atanh(_e)) : sinh(-_e * atan(_e));
         *diff = sc(ss) - ss;
-#endif
       }
     }
     return chi;
   }
 
-  template<typename T>
-  AuxAngle<T> AuxLatitude<T>::Authalic(const angle& phi, real* diff) const {
+  AuxAngle AuxLatitude::Authalic(const angle& phi, real* diff) const {
     real tphi = fabs(phi.tan());
     angle xi(phi), phin(phi.normalized());
     if ( !( !isfinite(tphi) || tphi == 0 || _f == 0 ) ) {
@@ -300,8 +209,7 @@ namespace GeographicLib {
     return xi;
   }
 
-  template<typename T>
-  AuxAngle<T> AuxLatitude<T>::ToAuxiliary(int auxout, const angle& phi,
+  AuxAngle AuxLatitude::ToAuxiliary(int auxout, const angle& phi,
                                           real* diff) const {
     switch (auxout) {
     case GEOGRAPHIC: if (diff) *diff = 1; return phi; break;
@@ -317,8 +225,7 @@ namespace GeographicLib {
     }
   }
 
-  template<typename T>
-  AuxAngle<T> AuxLatitude<T>::FromAuxiliary(int auxin, const angle& zeta,
+  AuxAngle AuxLatitude::FromAuxiliary(int auxin, const angle& zeta,
                                             int* niter) const {
     int n = 0; if (niter) *niter = n;
     real tphi = _fm1;
@@ -335,38 +242,6 @@ namespace GeographicLib {
     }
 
     // Drop through to solution by Newton's method
-#if AUXLATITUDE_UNOPT
-    real tzeta = fabs(zeta.tan());
-    if (!isfinite(tzeta)) return zeta;
-    tphi = tzeta / tphi;
-    real bmin = fmin(tphi, bmin_), bmax = fmax(tphi, bmax_);
-    for (int sign = 0, osign = 0, ntrip = 0; n < numit_;) {
-      ++n;
-      real diff;
-      angle zeta1(ToAuxiliary(auxin, angle(tphi), &diff));
-      real tzeta1 = zeta1.tan();
-      osign = sign;
-      if (tzeta1 == tzeta)
-        break;
-      else if (tzeta1 > tzeta) {
-        sign = 1;
-        bmax = tphi;
-      } else {
-        sign = -1;
-        bmin = tphi;
-      }
-      real dtphi = -(tzeta1 - tzeta) / diff;
-      tphi += dtphi;
-      if (!(fabs(dtphi) >= tol_ * tphi))
-        break;
-      // Skip the Newton guards if UNOPT
-      if (false && ((sign * osign < 0 && n - ntrip > 2) ||
-                    tphi >= bmax || tphi <= bmin)) {
-        sign = 0; ntrip = n;
-        tphi = sqrt(bmin * bmax);
-      }
-    }
-#else
     real tzeta = fabs(zeta.tan()), ltzeta = log2(tzeta);
     if (!isfinite(ltzeta)) return zeta;
     tphi = tzeta / tphi;
@@ -407,19 +282,16 @@ namespace GeographicLib {
         tphi = exp2(ltphi);
       }
     }
-#endif
     if (niter) *niter = n;
     return angle(tphi).copyquadrant(zeta);
   }
 
-  template<typename T>
-  AuxAngle<T> AuxLatitude<T>::Convert(int auxin, int auxout, const angle& zeta,
+  AuxAngle AuxLatitude::Convert(int auxin, int auxout, const angle& zeta,
                                       bool series) const {
     int k = ind(auxout, auxin);
     if (k < 0) return angle::NaN();
     if (auxin == auxout) return zeta;
     if (series) {
-      if ( isnan(_c[Lmax * k]) ) fillcoeff(auxin, auxout, k);
       angle zetan(zeta.normalized());
       real d = Clenshaw(zetan.y(), zetan.x(), _c + Lmax * k, Lmax);
       zetan += angle::radians(d);
@@ -432,139 +304,40 @@ namespace GeographicLib {
     }
   }
 
-  template<typename T>
-  typename AuxLatitude<T>::real AuxLatitude<T>::RD(real x, real y, real z) {
-#if AUXLATITUDE_NATIVE_ELLIPTIC
-    // Carlson, eqs 2.28 - 2.34
-    static const real
-      tolRD = pow(real(0.2) * (numeric_limits<real>::epsilon() * real(0.01)),
-                  1/real(8));
-    real
-      A0 = (x + y + 3*z)/5,
-      An = A0,
-      Q = fmax(fmax(fabs(A0-x), fabs(A0-y)), fabs(A0-z)) / tolRD,
-      x0 = x,
-      y0 = y,
-      z0 = z,
-      mul = 1,
-      s = 0;
-    while (Q >= mul * fabs(An)) {
-      // Max 7 trips
-      real lam = sqrt(x0)*sqrt(y0) + sqrt(y0)*sqrt(z0) + sqrt(z0)*sqrt(x0);
-      s += 1/(mul * sqrt(z0) * (z0 + lam));
-      An = (An + lam)/4;
-      x0 = (x0 + lam)/4;
-      y0 = (y0 + lam)/4;
-      z0 = (z0 + lam)/4;
-      mul *= 4;
-    }
-    real
-      X = (A0 - x) / (mul * An),
-      Y = (A0 - y) / (mul * An),
-      Z = -(X + Y) / 3,
-      E2 = X*Y - 6*Z*Z,
-      E3 = (3*X*Y - 8*Z*Z)*Z,
-      E4 = 3 * (X*Y - Z*Z) * Z*Z,
-      E5 = X*Y*Z*Z*Z;
-    // https://dlmf.nist.gov/19.36.E2
-    // Polynomial is
-    // (1 - 3*E2/14 + E3/6 + 9*E2^2/88 - 3*E4/22 - 9*E2*E3/52 + 3*E5/26
-    //    - E2^3/16 + 3*E3^2/40 + 3*E2*E4/20 + 45*E2^2*E3/272
-    //    - 9*(E3*E4+E2*E5)/68)
-    return ((471240 - 540540 * E2) * E5 +
-            (612612 * E2 - 540540 * E3 - 556920) * E4 +
-            E3 * (306306 * E3 + E2 * (675675 * E2 - 706860) + 680680) +
-            E2 * ((417690 - 255255 * E2) * E2 - 875160) + 4084080) /
-      (4084080 * mul * An * sqrt(An)) + 3 * s;
-#else
-    return real(EllipticFunction::RD(Math::real(x), Math::real(y),
-                                     Math::real(z)));
-#endif
-  }
-
-  template<typename T>
-  typename AuxLatitude<T>::real AuxLatitude<T>::RF(real x, real y, real z) {
-#if AUXLATITUDE_NATIVE_ELLIPTIC
-    // Carlson, eqs 2.2 - 2.7
-    static const real tolRF =
-      pow(3 * numeric_limits<real>::epsilon() * real(0.01), 1/real(8));
-    real
-      A0 = (x + y + z)/3,
-      An = A0,
-      Q = fmax(fmax(fabs(A0-x), fabs(A0-y)), fabs(A0-z)) / tolRF,
-      x0 = x,
-      y0 = y,
-      z0 = z,
-      mul = 1;
-    while (Q >= mul * fabs(An)) {
-      // Max 6 trips
-      real lam = sqrt(x0)*sqrt(y0) + sqrt(y0)*sqrt(z0) + sqrt(z0)*sqrt(x0);
-      An = (An + lam)/4;
-      x0 = (x0 + lam)/4;
-      y0 = (y0 + lam)/4;
-      z0 = (z0 + lam)/4;
-      mul *= 4;
+  void AuxLatitude::Convert(int auxin, int auxout, size_t n,
+                            const real zeta[], real eta[], bool series) const {
+    int k = ind(auxout, auxin);
+    if (k < 0) {
+      for (size_t i = 0; i < n; ++i)
+        eta[i] = numeric_limits<real>::quiet_NaN();
+    } else if (series && auxin != auxout) {
+      // Hoist the dispatch and the coefficient lookup out of the loop
+      const real* c = _c + Lmax * k;
+      for (size_t i = 0; i < n; ++i) {
+        angle zetan(angle::degrees(zeta[i]).normalized());
+        zetan += angle::radians(Clenshaw(zetan.y(), zetan.x(), c, Lmax));
+        eta[i] = zetan.degrees();
+      }
+    } else {
+      for (size_t i = 0; i < n; ++i)
+        eta[i] = Convert(auxin, auxout, angle::degrees(zeta[i]),
+                         series).degrees();
     }
-    real
-      X = (A0 - x) / (mul * An),
-      Y = (A0 - y) / (mul * An),
-      Z = - (X + Y),
-      E2 = X*Y - Z*Z,
-      E3 = X*Y*Z;
-    // https://dlmf.nist.gov/19.36.E1
-    // Polynomial is
-    // (1 - E2/10 + E3/14 + E2^2/24 - 3*E2*E3/44
-    //    - 5*E2^3/208 + 3*E3^2/104 + E2^2*E3/16)
-    // convert to Horner form...
-    return (E3 * (6930 * E3 + E2 * (15015 * E2 - 16380) + 17160) +
-            E2 * ((10010 - 5775 * E2) * E2 - 24024) + 240240) /
-      (240240 * sqrt(An));
-#else
-    return real(EllipticFunction::RF(Math::real(x), Math::real(y),
-                                     Math::real(z)));
-#endif
   }
 
-  template<typename T>
-  typename AuxLatitude<T>::real AuxLatitude<T>::atanhee(real tphi) const {
-#if AUXLATITUDE_UNOPT
-    real sphi = sn(tphi);
-    return _f == 0 ? sphi :
-      (_f < 0 ? atan( _e * sphi ) : atanh( _e * sphi )) / _e;
-#else
+  Math::real AuxLatitude::atanhee(real tphi) const {
     real s = _f <= 0 ? sn(tphi) : sn(_fm1 * tphi);
     return _f == 0 ? s :
       // atanh(e * sphi) = asinh(e' * sbeta)
       (_f < 0 ? atan( _e * s ) : asinh( _e1 * s )) / _e;
-#endif
   }
 
-  template<typename T>
-  typename AuxLatitude<T>::real AuxLatitude<T>::q(real tphi) const {
-#if AUXLATITUDE_UNOPT
-    real sphi = sn(tphi);
-    return atanhee(tphi) + sphi / (1 - _e2 * sphi*sphi);
-#else
+  Math::real AuxLatitude::q(real tphi) const {
     real scbeta = sc(_fm1 * tphi);
     return atanhee(tphi) + (tphi / scbeta) * (sc(tphi) / scbeta);
-#endif
   }
 
-  template<typename T>
-  typename AuxLatitude<T>::real AuxLatitude<T>::Dq(real tphi) const {
-#if AUXLATITUDE_UNOPT
-    real sphi = sn(tphi), d = 1 - sphi;
-    if (tphi <= 0)
-      // This branch is not reached; this case is open-coded in Authalic.
-      return (_q - q(tphi)) / d;
-    else if (d == 0)
-      return 2 / Math::sq(_e2m1);
-    else
-      return (_f == 0 ? 1 / (1 - _e2 * sphi) :
-              (_f < 0 ? atan(_e * d / (1 - _e2 * sphi)) / (_e * d) :
-               atanh(_e * d / (1 - _e2 * sphi)) / (_e * d) )) +
-        (1 + _e2 * sphi) / ((1 - _e2 * sphi*sphi) * _e2m1);
-#else
+  Math::real AuxLatitude::Dq(real tphi) const {
     real scphi = sc(tphi), sphi = sn(tphi),
       // d = (1 - sphi) can underflow to zero for large tphi
       d = tphi > 0 ? 1 / (scphi * scphi * (1 + sphi)) : 1 - sphi;
@@ -588,11 +361,9 @@ namespace GeographicLib {
          ((scphi + _e2 * tphi) / (_e2m1 * scbeta)) * (scphi / scbeta) :
         (1 + _e2 * sphi) / ((1 - _e2 * sphi*sphi) * _e2m1) );
     }
-#endif
   }
 
-  template<typename T>
-  void AuxLatitude<T>::fillcoeff(int auxin, int auxout, int k) const {
+  void AuxLatitude::fillcoeff(int auxin, int auxout, int k) {
 #if GEOGRAPHICLIB_AUXLATITUDE_ORDER == 4
     static const real coeffs[] = {
       // C[phi,phi] skipped
@@ -1476,9 +1247,8 @@ namespace GeographicLib {
     }
   }
 
-  template<typename T>
-  typename AuxLatitude<T>::real
-  AuxLatitude<T>::Clenshaw(real szeta, real czeta,
+  Math::real
+  AuxLatitude::Clenshaw(real szeta, real czeta,
                            const real c[], int K, bool alt) {
     // Evaluate
     // y = sum(c[k] * sin( (2*k+2) * zeta), i, 0, K-1)
@@ -1511,11 +1281,4 @@ namespace GeographicLib {
     return 2 * szeta * czeta * u0; // sin(2*zeta) * u0
   }
 
-  template class AuxAngle<Math::real>;
-  template class AuxLatitude<Math::real>;
-#if GEOGRAPHICLIB_PRECISION != 2
-  template class AuxAngle<double>;
-  template class AuxLatitude<double>;
-#endif
-
 } // namespace GeographicLib
@@ -22,7 +22,7 @@ namespace GeographicLib {
                                      real& azi, real& rk) const {
     real sig, s, azi0, m;
     sig = _earth.Inverse(lat0, lon0, lat, lon, s, azi0, azi, m);
-    Math::sincosd(azi0, x, y);
+    Math::sincosdInline(azi0, x, y);
     x *= s; y *= s;
     rk = !(sig <= eps_) ? m / s : 1;
   }
@@ -31,11 +31,37 @@ namespace GeographicLib {
                                      real& lat, real& lon,
                                      real& azi, real& rk) const {
     real
-      azi0 = Math::atan2d(x, y),
+      azi0 = Math::atan2dInline(x, y),
       s = hypot(x, y);
     real sig, m;
     sig = _earth.Direct(lat0, lon0, azi0, s, lat, lon, azi, m);
     rk = !(sig <= eps_) ? m / s : 1;
   }
 
+  void AzimuthalEquidistant::ForwardBatch(size_t n, real lat0, real lon0,
+                                          const real lat[], const real lon[],
+                                          real x[], real y[],
+                                          real azi[], real rk[]) const {
+    for (size_t i = 0; i < n; ++i) {
+      real xi, yi, azii, rki;
+      Forward(lat0, lon0, lat[i], lon[i], xi, yi, azii, rki);
+      x[i] = xi; y[i] = yi;
+      if (azi) azi[i] = azii;
+      if (rk) rk[i] = rki;
+    }
+  }
+
+  void AzimuthalEquidistant::ReverseBatch(size_t n, real lat0, real lon0,
+                                          const real x[], const real y[],
+                                          real lat[], real lon[],
+                                          real azi[], real rk[]) const {
+    for (size_t i = 0; i < n; ++i) {
+      real lati, loni, azii, rki;
+      Reverse(lat0, lon0, x[i], y[i], lati, loni, azii, rki);
+      lat[i] = lati; lon[i] = loni;
+      if (azi) azi[i] = azii;
+      if (rk) rk[i] = rki;
+    }
+  }
+
 } // namespace GeographicLib
@@ -0,0 +1,59 @@
+/**
+ * \file CPUDispatch.cpp
+ * \brief Implementation for GeographicLib::CPUDispatch class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#include <GeographicLib/CPUDispatch.hpp>
+#include <atomic>
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  namespace {
+
+    CPUDispatch::isa detect() {
+#if GEOGRAPHICLIB_CPU_DISPATCH
+      // __builtin_cpu_supports also checks that the operating system saves
+      // the vector registers.
+      __builtin_cpu_init();
+      if (__builtin_cpu_supports("avx512f")) return CPUDispatch::AVX512;
+      if (__builtin_cpu_supports("avx2")) return CPUDispatch::AVX2;
+#endif
+      return CPUDispatch::BASELINE;
+    }
+
+    const CPUDispatch::isa detected_ = detect();
+    atomic<int> selected_(detected_);
+
+  } // namespace
+
+  CPUDispatch::isa CPUDispatch::Detected() { return detected_; }
+
+  bool CPUDispatch::Available(isa i) {
+    return i >= BASELINE && i <= detected_;
+  }
+
+  void CPUDispatch::Select(isa i) {
+    if (!Available(i))
+      throw GeographicErr("Instruction set " + Name(i) + " not available");
+    selected_.store(i, memory_order_relaxed);
+  }
+
+  CPUDispatch::isa CPUDispatch::Selected()
+  { return isa(selected_.load(memory_order_relaxed)); }
+
+  string CPUDispatch::Name(isa i) {
+    switch (i) {
+    case BASELINE: return "baseline";
+    case AVX2: return "avx2";
+    case AVX512: return "avx512";
+    default: return "unknown";
+    }
+  }
+
+} // namespace GeographicLib
@@ -38,6 +38,11 @@ namespace GeographicLib {
 
   void CassiniSoldner::Forward(real lat, real lon, real& x, real& y,
                                real& azi, real& rk) const {
+    Forward(lat, lon, x, y, azi, rk, true);
+  }
+
+  void CassiniSoldner::Forward(real lat, real lon, real& x, real& y,
+                               real& azi, real& rk, bool scalep) const {
     if (!Init())
       return;
     real dlon = Math::AngDiff(LongitudeOrigin(), lon);
@@ -61,15 +66,19 @@ namespace GeographicLib {
       sig12 = -sig12;
     }
     x = s12;
-    azi = Math::AngNormalize(azi2);
-    GeodesicLine perp(_earth.Line(lat, dlon, azi, Geodesic::GEODESICSCALE));
+    azi = Math::AngNormalizeInline(azi2);
+    // Only the equatorial azimuth of perp is needed if rk isn't
+    GeodesicLine perp(_earth.Line(lat, dlon, azi,
+                                  scalep ? Geodesic::GEODESICSCALE :
+                                  Geodesic::NONE));
     real t;
-    perp.GenPosition(true, -sig12,
-                     Geodesic::GEODESICSCALE,
-                     t, t, t, t, t, t, rk, t);
+    if (scalep)
+      perp.GenPosition(true, -sig12,
+                       Geodesic::GEODESICSCALE,
+                       t, t, t, t, t, t, rk, t);
 
     real salp0, calp0;
-    Math::sincosd(perp.EquatorialAzimuth(), salp0, calp0);
+    Math::sincosdInline(perp.EquatorialAzimuth(), salp0, calp0);
     real
       sbet1 = lat >=0 ? calp0 : -calp0,
       cbet1 = fabs(dlon) <= Math::qd ? fabs(salp0) : -fabs(salp0),
@@ -91,4 +100,47 @@ namespace GeographicLib {
     _earth.Direct(lat1, lon1, azi0 + Math::qd, x, lat, lon, azi, rk, t);
   }
 
+  void CassiniSoldner::ForwardBatch(size_t n,
+                                    const real lat[], const real lon[],
+                                    real x[], real y[],
+                                    real azi[], real rk[]) const {
+    if (!Init())
+      return;
+    // Skip the computation of rk if it's not needed
+    bool scalep = rk != nullptr;
+    for (size_t i = 0; i < n; ++i) {
+      real xi, yi, azii, rki;
+      Forward(lat[i], lon[i], xi, yi, azii, rki, scalep);
+      x[i] = xi; y[i] = yi;
+      if (azi) azi[i] = azii;
+      if (rk) rk[i] = rki;
+    }
+  }
+
+  void CassiniSoldner::ReverseBatch(size_t n,
+                                    const real x[], const real y[],
+                                    real lat[], real lon[],
+                                    real azi[], real rk[]) const {
+    if (!Init())
+      return;
+    real lat1 = 0, lon1 = 0, azi0 = 0, y1 = Math::NaN(), t;
+    for (size_t i = 0; i < n; ++i) {
+      real xi = x[i], yi = y[i];
+      // Reuse the point on the central meridian if y is unchanged
+      if (!(yi == y1 && signbit(yi) == signbit(y1))) {
+        _meridian.Position(yi, lat1, lon1, azi0);
+        y1 = yi;
+      }
+      real lati, loni, azii, rki;
+      if (rk)
+        _earth.Direct(lat1, lon1, azi0 + Math::qd, xi,
+                      lati, loni, azii, rki, t);
+      else
+        _earth.Direct(lat1, lon1, azi0 + Math::qd, xi, lati, loni, azii);
+      lat[i] = lati; lon[i] = loni;
+      if (azi) azi[i] = azii;
+      if (rk) rk[i] = rki;
+    }
+  }
+
 } // namespace GeographicLib
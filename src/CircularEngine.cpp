@@ -8,16 +8,22 @@
  **********************************************************************/
 
 #include <GeographicLib/CircularEngine.hpp>
+#include "kissfft.hh"
 
 namespace GeographicLib {
 
   using namespace std;
 
   Math::real CircularEngine::Value(bool gradp, real sl, real cl,
-                                   real& gradx, real& grady, real& gradz) const
+                                   real& gradx, real& grady, real& gradz,
+                                   real hess[]) const
   {
+    if (hess && _hessp && _mM >= 0)
+      return SphericalEngine::HessianSum(_norm, _mM, _r, _q, _t, _u, cl, sl,
+                                         _wh.data(), gradx, grady, gradz,
+                                         hess);
     gradp = _gradp && gradp;
-    const vector<real>& root( SphericalEngine::sqrttable() );
+    const real* root( SphericalEngine::sqrttable() );
 
     // Initialize outer sum
     real vc  = 0, vc2  = 0, vs  = 0, vs2  = 0;   // v [N + 1], v [N + 2]
@@ -93,4 +99,69 @@ namespace GeographicLib {
     return vc;
   }
 
+  void CircularEngine::Values(real lon0, int n, real v[],
+                              real gradx[], real grady[], real gradz[])
+    const {
+    if (n <= 0) return;
+    bool gradp = _gradp && (gradx || grady || gradz);
+    const real* root( SphericalEngine::sqrttable() );
+    typedef complex<real> cpx;
+    // The Clenshaw summation in Value evaluates
+    //
+    //   sum(F[m] * (wc[m] * cos(m*lam) + ws[m] * sin(m*lam)), m = 0..M)
+    //
+    // where F[0] = 1 and F[m+1]/F[m] = alpha[m]/(2*cl).  Here F[m] is
+    // computed explicitly (it decreases monotonically, underflowing
+    // gracefully near the poles) and the sum over m is written as an inverse
+    // discrete Fourier transform over the n longitudes.  Term m contributes
+    // to frequency m mod n.
+    size_t nn = size_t(n);
+    int nsum = gradp ? 4 : 1;
+    vector<cpx> X(nsum * nn, cpx(0)), Y(nn);
+    real f = 1;                 // F[m]
+    for (int m = 0; m <= _mM; ++m) {
+      if (m == 1)
+        f = (_norm == FULL ? root[3] : 1) * _uq;
+      else if (m > 1)
+        f *= (_norm == FULL ?
+              root[2] * root[2 * m + 1] / root[m] :
+              root[2] * root[2 * m - 1] / root[m]) * _uq / 2;
+      if (f == 0) break;        // All remaining terms vanish
+      real sl, cl;
+      Math::sincosd(Math::AngNormalize(m * lon0), sl, cl);
+      cpx e(f * cl, f * sl);    // F[m] * exp(i*m*lon0)
+      size_t k = size_t(m) % nn;
+      // Re((a - i*b) * exp(i*m*lam)) = a * cos(m*lam) + b * sin(m*lam)
+      X[k] += e * cpx(_wc[m], -_ws[m]);
+      if (gradp) {
+        X[    nn + k] += e * cpx(_wrc[m], -_wrs[m]);
+        X[2 * nn + k] += e * cpx(_wtc[m], -_wts[m]);
+        X[3 * nn + k] += e * cpx(m * _ws[m], m * _wc[m]);
+      }
+    }
+    kissfft<real> fft(nn, true);
+    real qs = _q / SphericalEngine::scale();
+    fft.transform(X.data(), Y.data());
+    for (size_t j = 0; j < nn; ++j)
+      v[j] = qs * Y[j].real();
+    if (!gradp) return;
+    // Reuse the storage for the first sum to hold vr, vt, vl
+    qs /= _r;
+    for (int s = 1; s < 4; ++s) {
+      fft.transform(X.data() + s * nn, Y.data());
+      real mult = s == 1 ? -qs : (s == 2 ? qs : qs / _u);
+      for (size_t j = 0; j < nn; ++j)
+        X[(s - 1) * nn + j] = cpx(mult * Y[j].real(), 0);
+    }
+    for (size_t j = 0; j < nn; ++j) {
+      real sl, cl, vr = X[j].real(), vt = X[nn + j].real(),
+        vl = X[2 * nn + j].real();
+      Math::sincosd(lon0 + j * (real(Math::td) / n), sl, cl);
+      // Rotate into cartesian (geocentric) coordinates
+      if (gradx) gradx[j] = cl * (_u * vr + _t * vt) - sl * vl;
+      if (grady) grady[j] = sl * (_u * vr + _t * vt) + cl * vl;
+      if (gradz) gradz[j] =           _t * vr - _u * vt;
+    }
+  }
+
 } // namespace GeographicLib
@@ -0,0 +1,158 @@
+/**
+ * \file ClosestApproach.cpp
+ * \brief Implementation for GeographicLib::ClosestApproach class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#include <GeographicLib/ClosestApproach.hpp>
+#include <GeographicLib/GeodesicBatchExecutor.hpp>
+#include <algorithm>
+#include <utility>
+
+#if defined(_MSC_VER)
+// Squelch warnings about constant conditional expressions
+#  pragma warning (disable: 4127)
+#endif
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  ClosestApproach::ClosestApproach(const Geodesic& geod)
+    : _geod(geod)
+    , _earth(_geod.EquatorialRadius(), _geod.Flattening())
+    , _eps(_geod.EquatorialRadius() * numeric_limits<real>::epsilon())
+    , _tol(_geod.EquatorialRadius() *
+           pow(numeric_limits<real>::epsilon(), 3/real(4)))
+  {}
+
+  Math::real ClosestApproach::Pair(real lat1, real lon1, real azi1, real v1,
+                                   real lat2, real lon2, real azi2, real v2,
+                                   real tmax, real& t) const {
+    GeodesicLine
+      line1(_geod, lat1, lon1, azi1, caps_),
+      line2(_geod, lat2, lon2, azi2, caps_);
+    real d0 = Math::NaN(), d = d0,
+      // The tolerance on t corresponds to _tol in the relative distance
+      tol = _tol / fmax(fabs(v1) + fabs(v2), numeric_limits<real>::min());
+    t = 0;
+    for (int n = 0; n < numit_ || GEOGRAPHICLIB_PANIC; ++n) {
+      real lat1a, lon1a, azi1a, lat2a, lon2a, azi2a,
+        azi1c, azi2c, m12, M12, M21;
+      line1.Position(v1 * t, lat1a, lon1a, azi1a);
+      line2.Position(v2 * t, lat2a, lon2a, azi2a);
+      _geod.Inverse(lat1a, lon1a, lat2a, lon2a,
+                    d, azi1c, azi2c, m12, M12, M21);
+      if (n == 0) d0 = d;
+      if (d <= _eps) break;     // The objects collide
+      // gam1 and gam2 are the angles between the directions of motion and
+      // the geodesic joining the objects.  Find the zero of d(d^2/2)/dt =
+      // d * (x2 - x1) by Newton's method.
+      real e, gam1 = Math::AngDiff(azi1a, azi1c, e), sgam1, cgam1;
+      Math::sincosde(gam1, e, sgam1, cgam1);
+      real gam2 = Math::AngDiff(azi2a, azi2c, e), sgam2, cgam2;
+      Math::sincosde(gam2, e, sgam2, cgam2);
+      real r12 = d / m12,
+        x1 = v1 * cgam1, y1 = v1 * sgam1,
+        x2 = v2 * cgam2, y2 = v2 * sgam2,
+        g = d * (x2 - x1),
+        dg = (Math::sq(x1) + M12 * r12 * Math::sq(y1)) +
+        (Math::sq(x2) + M21 * r12 * Math::sq(y2)) -
+        2 * (x1 * x2 + r12 * y1 * y2);
+      // If the function is not convex here (the objects are far apart), take
+      // the planar step.
+      if (!(dg > 0)) dg = Math::sq(x1 - x2) + Math::sq(y1 - y2);
+      // The relative velocity vanishes; the distance is constant.
+      if (!(dg > 0)) break;
+      real tn = fmin(tmax, fmax(real(0), t - g / dg));
+      if (!(fabs(tn - t) > tol)) break;
+      t = tn;
+    }
+    // Guard against converging to a local minimum at the wrong end
+    if (d0 < d) {
+      t = 0; d = d0;
+    }
+    return d;
+  }
+
+  void ClosestApproach::Tracks(size_t n, const real lat[], const real lon[],
+                               const real azi[], const real v[],
+                               real tmax, real R,
+                               vector<Encounter>& encounters,
+                               unsigned nthreads) const {
+    if (!(isfinite(tmax) && tmax >= 0 && isfinite(R) && R >= 0))
+      throw GeographicErr("ClosestApproach: bad tmax or R");
+    encounters.clear();
+    if (n < 2) return;
+    GeodesicBatchExecutor exec(nthreads);
+    // The geocentric position of each object at tmax/2 and the radius of
+    // the cap about it which holds its track.
+    vector<real> X(n), Y(n), Z(n), r(n);
+    exec.ForEach(n, [&](size_t i0, size_t i1) -> void {
+      for (size_t i = i0; i < i1; ++i) {
+        real h = fabs(v[i]) * tmax / 2, lat2, lon2;
+        _geod.Direct(lat[i], lon[i], azi[i], copysign(h, v[i]), lat2, lon2);
+        _earth.Forward(lat2, lon2, 0, X[i], Y[i], Z[i]);
+        r[i] = h;
+      }
+    });
+    // Bin the positions into cubes whose side is the largest separation of
+    // the centers of a candidate pair.  Sorting the objects by bin allows
+    // the objects in a bin to be found by binary search.
+    real L = 2 * *max_element(r.begin(), r.end()) + R + _tol;
+    typedef long long bin;
+    struct Key {
+      bin x, y, z;
+      size_t i;
+      bool operator<(const Key& k) const {
+        return x < k.x || (x == k.x && (y < k.y || (y == k.y &&
+               (z < k.z || (z == k.z && i < k.i)))));
+      }
+    };
+    vector<Key> keys(n);
+    for (size_t i = 0; i < n; ++i) {
+      Key& k = keys[i];
+      k.x = bin(floor(X[i] / L)); k.y = bin(floor(Y[i] / L));
+      k.z = bin(floor(Z[i] / L)); k.i = i;
+    }
+    sort(keys.begin(), keys.end());
+    vector<pair<size_t, size_t>> cand;
+    for (size_t i = 0; i < n; ++i) {
+      // Look in the 27 bins surrounding object i for objects j > i.
+      bin x = bin(floor(X[i] / L)), y = bin(floor(Y[i] / L)),
+        z = bin(floor(Z[i] / L));
+      for (bin dx = -1; dx <= 1; ++dx)
+        for (bin dy = -1; dy <= 1; ++dy)
+          for (bin dz = -1; dz <= 1; ++dz) {
+            Key k = {x + dx, y + dy, z + dz, i};
+            for (auto p = upper_bound(keys.begin(), keys.end(), k);
+                 p != keys.end() &&
+                   p->x == k.x && p->y == k.y && p->z == k.z; ++p) {
+              size_t j = p->i;
+              // The chord is no longer than the geodesic distance.
+              if (Math::sq(X[i] - X[j]) + Math::sq(Y[i] - Y[j]) +
+                  Math::sq(Z[i] - Z[j]) <= Math::sq(r[i] + r[j] + R + _tol))
+                cand.push_back(make_pair(i, j));
+            }
+          }
+    }
+    sort(cand.begin(), cand.end());
+    vector<real> tc(cand.size()), dc(cand.size());
+    exec.ForEach(cand.size(), [&](size_t i0, size_t i1) -> void {
+      for (size_t k = i0; k < i1; ++k) {
+        size_t i = cand[k].first, j = cand[k].second;
+        dc[k] = Pair(lat[i], lon[i], azi[i], v[i],
+                     lat[j], lon[j], azi[j], v[j], tmax, tc[k]);
+      }
+    });
+    for (size_t k = 0; k < cand.size(); ++k)
+      if (dc[k] <= R) {
+        Encounter e = {cand[k].first, cand[k].second, tc[k], dc[k]};
+        encounters.push_back(e);
+      }
+  }
+
+} // namespace GeographicLib
@@ -0,0 +1,137 @@
+/**
+ * \file ClosestPoint.cpp
+ * \brief Implementation for GeographicLib::ClosestPoint class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#include <GeographicLib/ClosestPoint.hpp>
+#include <GeographicLib/GeodesicBatchExecutor.hpp>
+#include <vector>
+
+#if defined(_MSC_VER)
+// Squelch warnings about constant conditional expressions
+#  pragma warning (disable: 4127)
+#endif
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  ClosestPoint::ClosestPoint(const Geodesic& geod)
+    : _geod(geod)
+    , _earth(_geod.EquatorialRadius(), _geod.Flattening())
+    , _eps(_geod.EquatorialRadius() * numeric_limits<real>::epsilon())
+    , _tol(_geod.EquatorialRadius() *
+           pow(numeric_limits<real>::epsilon(), 3/real(4)))
+  {}
+
+  Math::real ClosestPoint::Segment(real lat, real lon,
+                                   real lat1, real lon1,
+                                   real lat2, real lon2, real& x) const {
+    return Segment(lat, lon,
+                   _geod.InverseLine(lat1, lon1, lat2, lon2, caps_), x);
+  }
+
+  Math::real ClosestPoint::Segment(real lat, real lon,
+                                   const GeodesicLine& line, real& x) const {
+    real s13 = line.Distance(), z1, azi1, azi2;
+    // The starting guess treats the triangle formed by the start of the
+    // segment and Q as planar.
+    _geod.Inverse(line.Latitude(), line.Longitude(), lat, lon,
+                  z1, azi1, azi2);
+    x = fmin(s13, fmax(real(0),
+                       z1 * Math::cosd(Math::AngDiff(line.Azimuth(), azi1))));
+    real z = z1;
+    for (int n = 0; n < numit_ || GEOGRAPHICLIB_PANIC; ++n) {
+      real latX, lonX, aziX, aziXQ, m12, M12, M21;
+      line.Position(x, latX, lonX, aziX);
+      _geod.Inverse(latX, lonX, lat, lon, z, aziXQ, azi2, m12, M12, M21);
+      if (z <= _eps) break;     // Q is on the segment
+      // gam is the angle at X between the segment and the geodesic XQ.  Find
+      // the zero of d(z^2/2)/dx = -z * cos(gam) by Newton's method.
+      real e, gam = Math::AngDiff(aziX, aziXQ, e), sgam, cgam;
+      Math::sincosde(gam, e, sgam, cgam);
+      real dg = Math::sq(cgam) + M12 * z / m12 * Math::sq(sgam);
+      // If the function is not convex here (Q is far away), take the planar
+      // step.
+      if (!(dg > 0)) dg = 1;
+      real xn = fmin(s13, fmax(real(0), x + z * cgam / dg));
+      if (!(fabs(xn - x) > _tol)) break;
+      x = xn;
+    }
+    // Guard against converging to a local minimum at the wrong end
+    if (z1 < z) {
+      x = 0; z = z1;
+    }
+    return z;
+  }
+
+  void ClosestPoint::MakeCap(real lat1, real lon1, real lat2, real lon2,
+                             Cap& cap) const {
+    GeodesicLine line =
+      _geod.InverseLine(lat1, lon1, lat2, lon2,
+                        Geodesic::LATITUDE | Geodesic::LONGITUDE |
+                        Geodesic::DISTANCE_IN);
+    real lat, lon;
+    line.BoundingCap(0, line.Distance(), lat, lon, cap.r);
+    _earth.Forward(lat, lon, 0, cap.X, cap.Y, cap.Z);
+    cap.lat1 = lat1; cap.lon1 = lon1; cap.lat2 = lat2; cap.lon2 = lon2;
+  }
+
+  void ClosestPoint::Polyline(size_t n, const real lat[], const real lon[],
+                              size_t m, const real latp[], const real lonp[],
+                              size_t seg[], real x[], real d[],
+                              unsigned nthreads) const {
+    if (n == 0) return;
+    if (m == 0) {
+      for (size_t i = 0; i < n; ++i) {
+        seg[i] = 0; x[i] = d[i] = Math::NaN();
+      }
+      return;
+    }
+    GeodesicBatchExecutor exec(nthreads);
+    // A polyline with a single vertex is treated as a segment of length 0.
+    size_t ns = m > 1 ? m - 1 : 1;
+    vector<Cap> caps(ns);
+    exec.ForEach(ns, [&](size_t j0, size_t j1) -> void {
+      for (size_t j = j0; j < j1; ++j) {
+        size_t k = m > 1 ? j + 1 : j;
+        MakeCap(latp[j], lonp[j], latp[k], lonp[k], caps[j]);
+      }
+    });
+    exec.ForEach(n, [&](size_t i0, size_t i1) -> void {
+      vector<real> bound(ns);
+      for (size_t i = i0; i < i1; ++i) {
+        real X, Y, Z;
+        _earth.Forward(lat[i], lon[i], 0, X, Y, Z);
+        // The lower bounds on the distances to the segments
+        size_t jbest = 0;
+        for (size_t j = 0; j < ns; ++j) {
+          const Cap& c = caps[j];
+          real dX = X - c.X, dY = Y - c.Y, dZ = Z - c.Z;
+          bound[j] = sqrt(dX * dX + dY * dY + dZ * dZ) - c.r - _tol;
+          if (bound[j] < bound[jbest]) jbest = j;
+        }
+        const Cap& c = caps[jbest];
+        real xbest,
+          dbest = Segment(lat[i], lon[i],
+                          c.lat1, c.lon1, c.lat2, c.lon2, xbest);
+        for (size_t j = 0; j < ns; ++j) {
+          if (j == jbest || !(bound[j] < dbest)) continue;
+          const Cap& cj = caps[j];
+          real xj,
+            dj = Segment(lat[i], lon[i],
+                         cj.lat1, cj.lon1, cj.lat2, cj.lon2, xj);
+          if (dj < dbest) {
+            jbest = j; xbest = xj; dbest = dj;
+          }
+        }
+        seg[i] = jbest; x[i] = xbest; d[i] = dbest;
+      }
+    });
+  }
+
+} // namespace GeographicLib
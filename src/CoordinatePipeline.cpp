@@ -0,0 +1,107 @@
+/**
+ * \file CoordinatePipeline.cpp
+ * \brief Implementation for GeographicLib::CoordinatePipeline class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#include <GeographicLib/CoordinatePipeline.hpp>
+#include <vector>
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  void CoordinatePipeline::Forward(size_t n, const real lat[],
+                                   const real lon[], const real h[],
+                                   real X[], real Y[], real Z[],
+                                   real x[], real y[], real z[],
+                                   int zone[], bool northp[],
+                                   real easting[], real northing[]) const {
+    if (X || x) {
+      // Per block, convert to geocentric (into X, Y, Z or into the temporary
+      // arrays) and then rotate to the local frame following
+      // LocalCartesian::IntForward.
+      const int K = batchsize_;
+      size_t nt = min(size_t(K), n);
+      vector<real> tmp(X ? 0 : 3 * nt);
+      const real* r = _local._r;
+      for (size_t i0 = 0; i0 < n; i0 += K) {
+        int nb = int(min(size_t(K), n - i0));
+        real
+          *xc = X ? X + i0 : tmp.data(),
+          *yc = X ? Y + i0 : tmp.data() + nt,
+          *zc = X ? Z + i0 : tmp.data() + 2 * nt;
+        _local._earth.ForwardBatch(nb, lat + i0, lon + i0, h + i0,
+                                   xc, yc, zc);
+        if (!x) continue;
+        for (int j = 0; j < nb; ++j) {
+          real
+            xj = xc[j] - _local._x0,
+            yj = yc[j] - _local._y0,
+            zj = zc[j] - _local._z0;
+          x[i0 + j] = r[0] * xj + r[3] * yj + r[6] * zj;
+          y[i0 + j] = r[1] * xj + r[4] * yj + r[7] * zj;
+          z[i0 + j] = r[2] * xj + r[5] * yj + r[8] * zj;
+        }
+      }
+    }
+    // The UTM/UPS stage only needs the geodetic coordinates; it runs as a
+    // single call to UTMUPS::ForwardBatch which does its own blocking.
+    if (zone)
+      UTMUPS::ForwardBatch(n, lat, lon, zone, northp, easting, northing,
+                           nullptr, nullptr, _setzone, _mgrslimits);
+  }
+
+  void CoordinatePipeline::Reverse(size_t n, const real x[], const real y[],
+                                   const real z[],
+                                   real lat[], real lon[], real h[],
+                                   real X[], real Y[], real Z[],
+                                   int zone[], bool northp[],
+                                   real easting[], real northing[]) const {
+    if (!(lat || X || zone)) return;
+    // Per block, rotate from the local frame following
+    // LocalCartesian::IntReverse (into X, Y, Z or into the temporary arrays)
+    // and convert to geodetic (into lat, lon, h or into the temporary
+    // arrays).  If UTM/UPS coordinates are needed and lat, lon are supplied,
+    // the UTM/UPS stage is run once at the end; otherwise it's run on each
+    // block.
+    const int K = batchsize_;
+    size_t nt = min(size_t(K), n);
+    vector<real> tmp((X ? 0 : 3 * nt) + (lat || !zone ? 0 : 3 * nt));
+    real* tmpg = tmp.data() + (X ? 0 : 3 * nt);
+    const real* r = _local._r;
+    for (size_t i0 = 0; i0 < n; i0 += K) {
+      int nb = int(min(size_t(K), n - i0));
+      real
+        *xc = X ? X + i0 : tmp.data(),
+        *yc = X ? Y + i0 : tmp.data() + nt,
+        *zc = X ? Z + i0 : tmp.data() + 2 * nt;
+      for (int j = 0; j < nb; ++j) {
+        real
+          xj = x[i0 + j],
+          yj = y[i0 + j],
+          zj = z[i0 + j];
+        xc[j] = _local._x0 + r[0] * xj + r[1] * yj + r[2] * zj;
+        yc[j] = _local._y0 + r[3] * xj + r[4] * yj + r[5] * zj;
+        zc[j] = _local._z0 + r[6] * xj + r[7] * yj + r[8] * zj;
+      }
+      if (!(lat || zone)) continue;
+      real
+        *la = lat ? lat + i0 : tmpg,
+        *lo = lat ? lon + i0 : tmpg + nt,
+        *hh = lat ? h + i0 : tmpg + 2 * nt;
+      _local._earth.ReverseBatch(nb, xc, yc, zc, la, lo, hh);
+      if (zone && !lat)
+        UTMUPS::ForwardBatch(nb, la, lo, zone + i0, northp + i0,
+                             easting + i0, northing + i0,
+                             nullptr, nullptr, _setzone, _mgrslimits);
+    }
+    if (zone && lat)
+      UTMUPS::ForwardBatch(n, lat, lon, zone, northp, easting, northing,
+                           nullptr, nullptr, _setzone, _mgrslimits);
+  }
+
+} // namespace GeographicLib
@@ -9,6 +9,10 @@
 
 #include <GeographicLib/DMS.hpp>
 #include <GeographicLib/Utility.hpp>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <vector>
 
 #if defined(_MSC_VER)
 // Squelch warnings about constant conditional and enum-float expressions
@@ -25,6 +29,62 @@ namespace GeographicLib {
   const char* const DMS::dmsindicators_ = "D'\":";
   const char* const DMS::components_[] = {"degrees", "minutes", "seconds"};
 
+  namespace {
+
+#if GEOGRAPHICLIB_PRECISION <= 3
+    inline void strtoreal(const char* s, char** r, float& x)
+    { x = strtof(s, r); }
+    inline void strtoreal(const char* s, char** r, double& x)
+    { x = strtod(s, r); }
+    inline void strtoreal(const char* s, char** r, long double& x)
+    { x = strtold(s, r); }
+#endif
+
+    // Decode a plain decimal number (surrounding white space, an optional
+    // sign, digits, and an optional decimal point) without the replacements
+    // and the general DMS grammar.  Return false if dms is not of this form
+    // (or the result might differ from that of the general parser).  For
+    // such strings, DMS::Decode reads the number with Utility::val which
+    // uses strtod (or strtof or strtold) in the "C" locale; integers without
+    // a decimal point are accumulated digit by digit, so they are limited to
+    // digits10 digits to ensure that they are exact.  If the decimal point
+    // is localized, strtod stops at the '.' and the general parser is used.
+    bool FastDecode(const std::string& dms, Math::real& v) {
+#if GEOGRAPHICLIB_PRECISION <= 3
+      const char* p = dms.c_str();
+      const char* end = p + dms.size();
+      while (p < end && isspace(static_cast<unsigned char>(*p))) ++p;
+      while (p < end && isspace(static_cast<unsigned char>(end[-1]))) --end;
+      const char* q = p;
+      if (q < end && (*q == '+' || *q == '-')) ++q;
+      int ndigits = 0;
+      bool pointseen = false;
+      for (; q < end; ++q) {
+        if (*q >= '0' && *q <= '9')
+          ++ndigits;
+        else if (*q == '.' && !pointseen)
+          pointseen = true;
+        else
+          return false;
+      }
+      if (ndigits == 0 ||
+          (!pointseen && ndigits > numeric_limits<Math::real>::digits10))
+        return false;
+      char* r;
+      Math::real x;
+      strtoreal(p, &r, x);
+      if (r != end)
+        return false;
+      v = x;                    // strtod gives -0 for "-0" as needed
+      return true;
+#else
+      (void)dms; (void)v;
+      return false;
+#endif
+    }
+
+  }
+
   // Replace all occurrences of pat by c.  If c is NULL remove pat.
   void DMS::replace(std::string& s, const std::string& pat, char c) {
     string::size_type p = 0;
@@ -100,6 +160,13 @@ namespace GeographicLib {
     // « U+00ab    171  c2 ab      left guillemot (for cgi-bin)
     // » U+00bb    187  c2 bb      right guillemot (for cgi-bin)
 
+    // First try the common case of a plain decimal number
+    real v = 0;
+    if (FastDecode(dms, v)) {
+      ind = NONE;
+      return v;
+    }
+
     string dmsa = dms;
     replace(dmsa, "\xc2\xb0",     'd' ); // U+00b0 degree symbol
     replace(dmsa, "\xc2\xba",     'd' ); // U+00ba alt symbol
@@ -165,7 +232,7 @@ namespace GeographicLib {
     while (beg < end && isspace(dmsa[end - 1]))
       --end;
     // The trimmed string in [beg, end)
-    real v = -0.0;              // So "-0" returns -0.0
+    v = -0.0;                   // So "-0" returns -0.0
     int i = 0;
     flag ind1 = NONE;
     // p is pointer to the next piece that needs decoding
@@ -288,9 +355,8 @@ namespace GeographicLib {
             break;
           }
           if (digcount > 0) {
-            istringstream s(dmsa.substr(p - intcount - digcount - 1,
-                                        intcount + digcount));
-            s >> fcurrent;
+            Utility::val<real>(dmsa.data() + (p - intcount - digcount - 1),
+                               intcount + digcount, fcurrent);
             icurrent = 0;
           }
           ipieces[k] = icurrent;
@@ -324,9 +390,8 @@ namespace GeographicLib {
           break;
         }
         if (digcount > 0) {
-          istringstream s(dmsa.substr(p - intcount - digcount,
-                                      intcount + digcount));
-          s >> fcurrent;
+          Utility::val<real>(dmsa.data() + (p - intcount - digcount),
+                             intcount + digcount, fcurrent);
           icurrent = 0;
         }
         ipieces[npiece] = icurrent;
@@ -415,11 +480,54 @@ namespace GeographicLib {
 
   string DMS::Encode(real angle, component trailing, unsigned prec, flag ind,
                      char dmssep) {
+    // Size the buffer to allow for the integer digits of a large angle.
+    size_t n = 48 + min(prec, unsigned(15 + Math::extra_digits()));
+    for (real a = fabs(angle); a >= 10 && isfinite(a); a /= 10) ++n;
+    char buf[64];
+    vector<char> v;
+    char* s = buf;
+    if (n > sizeof(buf)) {
+      v.resize(n);
+      s = v.data();
+    } else
+      n = sizeof(buf);
+    return string(s, Encode(angle, trailing, prec, ind, dmssep, s, n));
+  }
+
+  size_t DMS::Encode(real angle, component trailing, unsigned prec, flag ind,
+                     char dmssep, char s[], size_t n) {
+    // The string is s[0..k); s[e..n) is reserved for the fraction.
+    size_t k = 0, e = n;
+    // Append c to s
+    auto append = [s, &e, &k](char c) -> void {
+      if (!(k + 1 < e))
+        throw GeographicErr("Buffer too small for DMS string");
+      s[k++] = c; s[k] = '\0';
+    };
+    // Write x with p decimal places at s[k]
+    auto number = [s, &e, &k](real x, int p) -> size_t {
+      if (!(k < e))
+        throw GeographicErr("Buffer too small for DMS string");
+      return Utility::str(x, p, s + k, e - k);
+    };
+    // Replace the len characters at s[k] by themselves left padded with
+    // zeros to a width w (as with setfill('0') << setw(w) for strings)
+    auto pad = [s, &e, &k](size_t len, size_t w) -> void {
+      size_t z = len < w ? w - len : 0;
+      if (!(k + z + len < e))
+        throw GeographicErr("Buffer too small for DMS string");
+      memmove(s + k + z, s + k, len);
+      memset(s + k, '0', z);
+      k += z + len;
+      s[k] = '\0';
+    };
     // Assume check on range of input angle has been made by calling
     // routine (which might be able to offer a better diagnostic).
-    if (!isfinite(angle))
-      return angle < 0 ? string("-inf") :
-        (angle > 0 ? string("inf") : string("nan"));
+    if (!isfinite(angle)) {
+      const char* t = angle < 0 ? "-inf" : (angle > 0 ? "inf" : "nan");
+      while (*t) append(*t++);
+      return k;
+    }
 
     // 15 - 2 * trailing = ceiling(log10(2^53/90/60^trailing)).
     // This suffices to give full real precision for numbers in [-90,90]
@@ -443,73 +551,49 @@ namespace GeographicLib {
     real
       idegree = trailing == DEGREE ? 0 : floor(angle),
       fdegree = (angle - idegree) * scale;
-    string s = Utility::str(fdegree, prec), degree, minute, second;
-    switch (trailing) {
-    case DEGREE:
-      degree = s;
-      break;
-    default:                    // case MINUTE: case SECOND:
-      string::size_type p = s.find_first_of('.');
-      long long i;
-      if (p == 0)
-        i = 0;
-      else {
-        i = stoll(s);
-        if (p == string::npos)
-          s.clear();
-        else
-          s = s.substr(p);
-      }
-      // Now i in [0,Math::dm] or [0,Math::ds] for MINUTE/DEGREE
-      switch (trailing) {
-      case MINUTE:
-        minute = to_string(i % Math::dm) + s; i /= Math::dm;
-        degree = Utility::str(i + idegree, 0); // no overflow since i in [0,1]
-        break;
-      default:                  // case SECOND:
-        second = to_string(i % Math::ms) + s; i /= Math::ms;
-        minute = to_string(i % Math::dm)    ; i /= Math::dm;
-        degree = Utility::str(i + idegree, 0); // no overflow since i in [0,1]
-        break;
-      }
-      break;
-    }
-    // No glue together degree+minute+second with
-    // sign + zero-fill + delimiters + hemisphere
-    ostringstream str;
-    if (prec) ++prec;           // Extra width for decimal point
+    // Now glue together degree+minute+second with sign + zero-fill +
+    // delimiters + hemisphere.  The width of the degrees (if ind != NONE)
+    size_t wdeg = ind != NONE ? 1 + min(int(ind), 2) : 0;
     if (ind == NONE && sign < 0)
-      str << '-';
-    str << setfill('0');
-    switch (trailing) {
-    case DEGREE:
-      if (ind != NONE)
-        str << setw(1 + min(int(ind), 2) + prec);
-      str << degree;
+      append('-');
+    if (trailing == DEGREE) {
+      size_t len = number(fdegree, int(prec));
       // Don't include degree designator (d) if it is the trailing component.
-      break;
-    case MINUTE:
-      if (ind != NONE)
-        str << setw(1 + min(int(ind), 2));
-      str << degree << (dmssep ? dmssep : char(tolower(dmsindicators_[0])))
-          << setw(2 + prec) << minute;
-      if (!dmssep)
-        str << char(tolower(dmsindicators_[1]));
-      break;
-    default:                    // case SECOND:
-      if (ind != NONE)
-        str << setw(1 + min(int(ind), 2));
-      str << degree << (dmssep ? dmssep : char(tolower(dmsindicators_[0])))
-          << setw(2)
-          << minute << (dmssep ? dmssep : char(tolower(dmsindicators_[1])))
-          << setw(2 + prec) << second;
+      pad(len, wdeg ? wdeg + (prec ? prec + 1 : 0) : 0);
+    } else {
+      // Split the number into the integer part i and the fraction (starting
+      // with the decimal point, if any); the fraction is moved to the end of
+      // s while the rest is assembled.
+      size_t len = number(fdegree, int(prec));
+      const char* p = static_cast<const char*>(memchr(s + k, '.', len));
+      size_t flen = p ? len - size_t(p - (s + k)) : 0;
+      long long i = p == s + k ? 0 : strtoll(s + k, nullptr, 10);
+      e = n - flen;
+      memmove(s + e, s + k + len - flen, flen);
+      // Now i in [0,Math::dm] or [0,Math::ds] for MINUTE/DEGREE
+      long long m = trailing == MINUTE ? i : i / Math::ms,
+        sec = i % Math::ms;
+      // no overflow since m / Math::dm in [0,1]
+      len = number(real(m / Math::dm) + idegree, 0);
+      pad(len, wdeg);
+      append(dmssep ? dmssep : char(tolower(dmsindicators_[0])));
+      len = number(real(m % Math::dm), 0);
+      pad(len, 2);
+      if (trailing == SECOND) {
+        append(dmssep ? dmssep : char(tolower(dmsindicators_[1])));
+        len = number(real(sec), 0);
+        pad(len, 2);
+      }
+      memmove(s + k, s + e, flen);
+      k += flen;
+      s[k] = '\0';
+      e = n;
       if (!dmssep)
-        str << char(tolower(dmsindicators_[2]));
-      break;
+        append(char(tolower(dmsindicators_[trailing == MINUTE ? 1 : 2])));
     }
     if (ind != NONE && ind != AZIMUTH)
-      str << hemispheres_[(ind == LATITUDE ? 0 : 2) + (sign < 0 ? 0 : 1)];
-    return str.str();
+      append(hemispheres_[(ind == LATITUDE ? 0 : 2) + (sign < 0 ? 0 : 1)]);
+    return k;
   }
 
 } // namespace GeographicLib
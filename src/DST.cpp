@@ -8,7 +8,11 @@
  **********************************************************************/
 
 #include <GeographicLib/DST.hpp>
+#include <GeographicLib/SharedInstances.hpp>
+#include <algorithm>
+#include <complex>
 #include <vector>
+#include <limits>
 
 #include "kissfft.hh"
 
@@ -16,54 +20,140 @@ namespace GeographicLib {
 
   using namespace std;
 
+  class DST::plan {
+  public:
+    typedef kissfft<real> fft_t;
+    // The DST-IV of even size n = N >> l uses the complex FFT of size n/2 in
+    // fft[l] with the twiddle factors pre[l][j] = exp(-i*pi*(4*j+1)/(4*n))
+    // and post[l][k] = (2/n) * exp(-i*pi*k/n).
+    vector<fft_t> fft;
+    vector< vector< complex<real> > > pre, post;
+    // The odd size q = N >> fft.size() at which the recursion stops and
+    // sines[j] = sin(pi*j/(4*q)) for j in [0, 8*q).
+    int N, q;
+    vector<real> sines;
+    explicit plan(int N0) : N(N0) {
+      int n = N;
+      for (; n > 0 && n % 2 == 0; n /= 2) {
+        int m = n / 2;
+        fft.push_back(fft_t(m, false));
+        pre.push_back(vector< complex<real> >(m));
+        post.push_back(vector< complex<real> >(m));
+        for (int j = 0; j < m; ++j) {
+          real s, c;
+          Math::sincosd(-real(45 * (4*j + 1)) / n, s, c);
+          pre.back()[j] = complex<real>(c, s);
+          Math::sincosd(-real(180 * j) / n, s, c);
+          post.back()[j] = complex<real>(c, s) * (real(2) / n);
+        }
+      }
+      q = n;
+      sines.resize(8 * q);
+      for (int j = 0; j < 8 * q; ++j)
+        sines[j] = Math::sind(real(45 * j) / q);
+    }
+    // DST-IV of size n = N >> l of x[0,n) into F[0,n) with w[0,2*n) as
+    // working storage; F may coincide with x.
+    void dst4(int l, const real x[], real F[], real w[]) const {
+      if (l == int(fft.size())) {
+        // F[k] = 2/q * sum(x[i] * sin(pi*(2*i+1)*(2*k+1)/(4*q)), i, 0, q-1)
+        for (int k = 0; k < q; ++k) {
+          real t = 0;
+          for (int i = 0; i < q; ++i)
+            t += x[i] * sines[((2*i + 1) * (2*k + 1)) % (8*q)];
+          w[k] = 2 * t / q;
+        }
+        copy(w, w + q, F);
+        return;
+      }
+      int n = N >> l, m = n / 2;
+      // complex<real> is layout compatible with real[2]
+      complex<real>
+        *t = reinterpret_cast<complex<real>*>(w),
+        *T = t + m;
+      // The DST-IV of x is (-1)^k times the DCT-IV of x reversed; this is
+      // computed by an FFT of size n/2 of the pairs of elements of the
+      // reversed x from either end.
+      for (int j = 0; j < m; ++j)
+        t[j] = complex<real>(x[n-1-2*j], x[2*j]) * pre[l][j];
+      fft[l].transform(t, T);
+      for (int k = 0; k < m; ++k) {
+        complex<real> u = T[k] * post[l][k];
+        F[2*k] = u.real();
+        F[n-1-2*k] = u.imag();
+      }
+    }
+    // DST-III of size n = N >> l of x[0,n) (the samples at (j+1)*pi/(2*n))
+    // into F[0,n) with w[0,2*n) as working storage.
+    void dst3(int l, const real x[], real F[], real w[]) const {
+      if (l == int(fft.size())) {
+        // F[k] = 2/q * sum(x[i-1] * sin(pi*i*(2*k+1)/(2*q)), i, 1, q-1)
+        //        + 1/q * x[q-1] * (-1)^k
+        for (int k = 0; k < q; ++k) {
+          real t = (k % 2 ? -x[q-1] : x[q-1]) / 2;
+          for (int i = 1; i < q; ++i)
+            t += x[i-1] * sines[(2 * i * (2*k + 1)) % (8*q)];
+          F[k] = 2 * t / q;
+        }
+        return;
+      }
+      // Split into the DST-III of the even samples and the DST-IV of the odd
+      // samples, each of size h = n/2, and combine as in fft_transform2.
+      int n = N >> l, h = n / 2;
+      for (int j = 0; j < h; ++j) {
+        w[j] = x[2*j + 1];
+        w[h + j] = x[2*j];
+      }
+      dst4(l + 1, w + h, w + h, w + n);
+      dst3(l + 1, w, F, w + n);
+      for (int i = 0; i < h; ++i) {
+        real a = F[i], b = w[h + i];
+        F[i] = (b + a) / 2;
+        F[n-1-i] = (b - a) / 2;
+      }
+    }
+  };
+
+  const DST::plan* DST::Plan(int N) {
+    // The plans are cached for the life of the program so that constructing
+    // a DST (e.g., for each GeodesicExact object) doesn't recompute them.
+    static SharedInstances<plan, int> instances;
+    return &instances.Get(N, N);
+  }
+
   DST::DST(int N)
     : _N(N < 0 ? 0 : N)
-    , _fft(make_shared<fft_t>(fft_t(2 * _N, false)))
+    , _plan(Plan(_N))
   {}
 
   void DST::reset(int N) {
     N = N < 0 ? 0 : N;
     if (N == _N) return;
     _N = N;
-    _fft->assign(2 * _N, false);
+    _plan = Plan(_N);
   }
 
-  void DST::fft_transform(real data[], real F[], bool centerp) const {
+  void DST::fft_transform(real data[], real F[], bool centerp,
+                          real temp[]) const {
     // Implement DST-III (centerp = false) or DST-IV (centerp = true).
 
     // Elements (0,N], resp. [0,N), of data should be set on input for centerp
     // = false, resp. true.  F must have a size of at least N and on output
-    // elements [0,N) of F contain the transform.
+    // elements [0,N) of F contain the transform.  temp must have a size of at
+    // least 2*N.
     if (_N == 0) return;
-    if (centerp) {
-      for (int i = 0; i < _N; ++i) {
-        data[_N+i] = data[_N-1-i];
-        data[2*_N+i] = -data[i];
-        data[3*_N+i] = -data[_N-1-i];
-      }
-    } else {
-      data[0] = 0;            // set [0]
-      for (int i = 1; i < _N; ++i) data[_N+i] = data[_N-i]; // set [N+1,2*N-1]
-      for (int i = 0; i < 2*_N; ++i) data[2*_N+i] = -data[i]; // [2*N, 4*N-1]
-    }
-    vector<complex<real>> ctemp(2*_N);
-    _fft->transform_real(data, ctemp.data());
-    if (centerp) {
-      real d = -Math::pi()/(4*_N);
-      for (int i = 0, j = 1; i < _N; ++i, j+=2)
-        ctemp[j] *= exp(complex<real>(0, j*d));
-    }
-    for (int i = 0, j = 1; i < _N; ++i, j+=2) {
-      F[i] = -ctemp[j].imag() / (2*_N);
-    }
+    if (centerp)
+      _plan->dst4(0, data, F, temp);
+    else
+      _plan->dst3(0, data + 1, F, temp);
   }
 
-  void DST::fft_transform2(real data[], real F[]) const {
+  void DST::fft_transform2(real data[], real F[], real temp[]) const {
     // Elements [0,N), of data should be set to the N grid center values and F
     // should have size of at least 2*N.  On input elements [0,N) of F contain
     // the size N transform; on output elements [0,2*N) of F contain the size
     // 2*N transform.
-    fft_transform(data, F+_N, true);
+    fft_transform(data, F+_N, true, temp);
     // Copy DST-IV order N tx to [0,N) elements of data
     for (int i = 0; i < _N; ++i) data[i] = F[i+_N];
     for (int i = _N; i < 2*_N; ++i)
@@ -75,19 +165,47 @@ namespace GeographicLib {
   }
 
   void DST::transform(function<real(real)> f, real F[]) const {
-    vector<real> data(4 * _N);
+    vector<real> scratch(scratchsize());
+    transform(f, F, scratch.data());
+  }
+
+  void DST::refine(function<real(real)> f, real F[]) const {
+    vector<real> scratch(scratchsize());
+    refine(f, F, scratch.data());
+  }
+
+  void DST::transform(function<real(real)> f, real F[], real scratch[])
+    const {
+    // scratch[0,N] holds the data, scratch[2*N,4*N) the working storage
+    real* data = scratch;
     real d = Math::pi()/(2 * _N);
     for (int i = 1; i <= _N; ++i)
       data[i] = f( i * d );
-    fft_transform(data.data(), F, false);
+    fft_transform(data, F, false, scratch + 2*_N);
   }
 
-  void DST::refine(function<real(real)> f, real F[]) const {
-    vector<real> data(4 * _N);
+  void DST::refine(function<real(real)> f, real F[], real scratch[]) const {
+    real* data = scratch;
     real d = Math::pi()/(4 * _N);
     for (int i = 0; i < _N; ++i)
       data[i] = f( (2*i + 1) * d );
-    fft_transform2(data.data(), F);
+    fft_transform2(data, F, scratch + 2*_N);
+  }
+
+  void DST::transform(int M, function<void(real, real[])> f, real F[],
+                      real scratch[]) const {
+    // scratch[4*N,(4+M)*N) holds the interleaved samples; sample i of
+    // function m is at y[i*M+m].
+    if (_N == 0 || M <= 0) return;
+    real* y = scratch + 4*_N;
+    real d = Math::pi()/(2 * _N);
+    for (int i = 0; i < _N; ++i)
+      f( (i + 1) * d, y + i*M );
+    for (int m = 0; m < M; ++m) {
+      for (int i = 1; i <= _N; ++i)
+        scratch[i] = y[(i-1)*M + m];
+      fft_transform(scratch, F + m*_N, false, scratch + 2*_N);
+    }
   }
 
   Math::real DST::eval(real sinx, real cosx, const real F[], int N) {
@@ -147,4 +265,91 @@ namespace GeographicLib {
     return (y1 - y0) * (cosy - cosx) + (z1 - z0) * (cosy + cosx);
   }
 
+  bool DST::sinefit(function<real(real)> f, vector<real>& F, int maxN) {
+    // With M samples of f at x_k = k*pi/(2*M), the discrete sine transform
+    // (DST-I) gives the first M - 1 coefficients exactly for a trigonometric
+    // polynomial of degree less than M.  (The FFT-based transforms above
+    // don't apply here because they are restricted to the odd harmonics.)
+    // The coefficients computed from the samples include noise at about this
+    // level.
+    const real tol = 2 * numeric_limits<real>::epsilon();
+    vector<real> h, hn, sn;
+    for (int M = 16; M <= maxN; M *= 2) {
+      hn.assign(M + 1, 0);
+      for (int k = 1; k < M; ++k)
+        hn[k] = k % 2 == 0 && !h.empty() ? h[k/2] :
+          f(real(k) / M * (Math::pi() / 2));
+      h.swap(hn);
+      sn.resize(2 * M);
+      for (int k = 0; k < 2 * M; ++k)
+        sn[k] = Math::sind(real(k) / M * Math::hd);
+      F.assign(M, 0);
+      real cmax = 0;
+      for (int j = 1; j < M; ++j) {
+        real cj = 0;
+        for (int k = 1; k < M; ++k)
+          cj += h[k] * sn[(j * k) % (2 * M)];
+        F[j] = 2 * cj / M;
+        if (2 * j >= M) cmax = fmax(cmax, fabs(F[j]));
+      }
+      if (cmax <= tol) {
+        int n = M - 1;
+        while (n > 0 && fabs(F[n]) <= tol) --n;
+        F.resize(n + 1);
+        return true;
+      }
+    }
+    F.clear();
+    return false;
+  }
+
+  bool DST::cosinefit(function<real(real)> f, vector<real>& F, int maxN) {
+    // As sinefit but using the DCT-I with M + 1 samples at x_k = k*pi/(2*M)
+    // for k in [0, M].
+    const real tol = 2 * numeric_limits<real>::epsilon();
+    vector<real> h, hn, cs;
+    for (int M = 16; M <= maxN; M *= 2) {
+      hn.resize(M + 1);
+      for (int k = 0; k <= M; ++k)
+        hn[k] = k % 2 == 0 && !h.empty() ? h[k/2] :
+          f(real(k) / M * (Math::pi() / 2));
+      h.swap(hn);
+      cs.resize(2 * M);
+      for (int k = 0; k < 2 * M; ++k)
+        cs[k] = Math::cosd(real(k) / M * Math::hd);
+      F.assign(M + 1, 0);
+      real cmax = 0, fmx = 0;
+      for (int j = 0; j <= M; ++j) {
+        real cj = (h[0] + (j % 2 ? -h[M] : h[M])) / 2;
+        for (int k = 1; k < M; ++k)
+          cj += h[k] * cs[(j * k) % (2 * M)];
+        F[j] = (j == 0 || j == M ? 1 : 2) * cj / M;
+        fmx = fmax(fmx, fabs(F[j]));
+        if (2 * j >= M) cmax = fmax(cmax, fabs(F[j]));
+      }
+      if (cmax <= tol * fmx) {
+        int n = M;
+        while (n > 0 && fabs(F[n]) <= tol * fmx) --n;
+        F.resize(n + 1);
+        return true;
+      }
+    }
+    F.clear();
+    return false;
+  }
+
+  Math::real DST::sineval(real sinx, real cosx, const real F[], int N) {
+    // Evaluate
+    // y = sum(F[i] * sin(2 * i * x), i, 1, N)
+    // using Clenshaw summation.
+    real
+      ar = 2 * (cosx - sinx) * (cosx + sinx), // 2 * cos(2 * x)
+      y0 = 0, y1 = 0;                         // accumulators for sum
+    for (; N > 0; --N) {
+      real t = ar * y0 - y1 + F[N];
+      y1 = y0; y0 = t;
+    }
+    return 2 * sinx * cosx * y0;              // sin(2 * x) * y0
+  }
+
 } // namespace GeographicLib
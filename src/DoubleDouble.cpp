@@ -0,0 +1,619 @@
+/**
+ * \file DoubleDouble.cpp
+ * \brief Implementation for GeographicLib::DoubleDouble class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#include <GeographicLib/DoubleDouble.hpp>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace GeographicLib {
+
+  // N.B. The functions of <cmath> for doubles must be called with std::
+  // qualification in this file; otherwise the DoubleDouble versions defined
+  // here are found and the doubles are converted to DoubleDoubles.
+  using namespace std;
+
+  namespace {
+    typedef DoubleDouble dd;
+
+    // pi/2, ln(2), and ln(10) split into three doubles
+    const double pio2a_ = 1.5707963267948966, pio2b_ = 6.123233995736766e-17,
+      pio2c_ = -1.4973849048591698e-33;
+    const double ln2a_ = 0.6931471805599453, ln2b_ = 2.3190468138462996e-17,
+      ln2c_ = 5.707708438416212e-34;
+    const double ln10a_ = 2.302585092994046, ln10b_ = -2.1707562233822494e-16;
+
+    const dd& pio2() {
+      static const dd pio2 = dd(pio2a_) + pio2b_;
+      return pio2;
+    }
+    const dd& ln2() {
+      static const dd ln2 = dd(ln2a_) + ln2b_;
+      return ln2;
+    }
+
+    // k * ln(2) for an integer k with |k| < 2^21
+    dd kln2(double k)
+    { return (dd(ln2a_) * k + dd(ln2b_) * k) + ln2c_ * k; }
+
+    // 1/n! for n = 0 .. nfact_ - 1
+    const int nfact_ = 32;
+    const dd* invfact() {
+      static const struct table {
+        dd f[nfact_];
+        table() {
+          f[0] = 1;
+          for (int n = 1; n < nfact_; ++n) f[n] = f[n-1] / n;
+        }
+      } t;
+      return t.f;
+    }
+
+    // 10^n for n >= 0
+    dd pow10(int n) {
+      dd p = 1, b = 10;
+      for (; n; n >>= 1) {
+        if (n & 1) p *= b;
+        if (n > 1) b *= b;
+      }
+      return p;
+    }
+
+    // Scale x by 10^n; this avoids overflowing the power of 10.
+    dd scale10(dd x, int n) {
+      for (; n > 280; n -= 280) x *= pow10(280);
+      for (; n < -280; n += 280) x /= pow10(280);
+      return n >= 0 ? x * pow10(n) : x / pow10(-n);
+    }
+
+    // sin(r) and cos(r) for |r| <= pi/4 by Taylor series.  The first
+    // omitted terms are r^31/31! and r^30/30! which are negligible.
+    void sincoskernel(const dd& r, dd& s, dd& c) {
+      const dd* f = invfact();
+      const int nterms = 15;
+      dd r2 = r * r, ps = f[2*nterms - 1], pc = f[2*nterms - 2];
+      for (int k = nterms - 1; k-- > 0;) {
+        ps = f[2*k + 1] - r2 * ps;
+        pc = f[2*k] - r2 * pc;
+      }
+      s = r * ps; c = pc;
+    }
+
+    // Reduce a finite x to r = x - q * pi/2 with |r| <= pi/4 (approx).  The
+    // result is accurate provided that |q| < 2^20 or so.
+    int reduce(const dd& x, dd& r) {
+      double q = std::round(x.hi() / pio2a_);
+      r = ((x - dd(pio2a_) * q) - dd(pio2b_) * q) - pio2c_ * q;
+      return int(q - 4 * std::floor(q / 4));
+    }
+
+    // sin(x) and cos(x) for finite x
+    void sincos(const dd& x, dd& s, dd& c) {
+      dd r, sr, cr;
+      switch (reduce(x, r)) {
+      case 0: sincoskernel(r, s, c); break;
+      case 1: sincoskernel(r, cr, sr); s = sr; c = -cr; break;
+      case 2: sincoskernel(r, sr, cr); s = -sr; c = -cr; break;
+      default: sincoskernel(r, cr, sr); s = -sr; c = cr; break;
+      }
+    }
+
+    // expm1(r) for |r| <= 0.35.  The argument is divided by 2^8 and the
+    // Taylor series (through r^11/11!) is summed; then the result is
+    // squared up using expm1(2r) = expm1(r) * (expm1(r) + 2).  This retains
+    // the sign of zero.
+    dd expm1kernel(const dd& x) {
+      const int m = 8, nterms = 11;
+      const dd* f = invfact();
+      dd r = ldexp(x, -m), p = f[nterms];
+      for (int k = nterms; --k > 0;)
+        p = f[k] + r * p;
+      p = r * p;
+      for (int i = 0; i < m; ++i)
+        p = p * (p + 2.0);
+      return p;
+    }
+
+    // Collect the characters of a number from a stream
+    bool readnumber(istream& is, string& s) {
+      // peek() sets failbit if eofbit is already set, so check eof first
+      auto peek = [&is]() -> int
+        { return is.eof() ? char_traits<char>::eof() : is.peek(); };
+      int ndigits = 0;
+      auto digits = [&is, &s, &peek]() -> int {
+        int n = 0;
+        for (int c = peek(); c >= '0' && c <= '9'; c = peek()) {
+          s += char(is.get()); ++n;
+        }
+        return n;
+      };
+      auto sign = [&is, &s, &peek]() -> void {
+        int c = peek();
+        if (c == '+' || c == '-') s += char(is.get());
+      };
+      sign();
+      ndigits += digits();
+      if (peek() == '.') {
+        s += char(is.get());
+        ndigits += digits();
+      }
+      if (ndigits == 0) return false;
+      int c = peek();
+      if (c == 'e' || c == 'E') {
+        s += char(is.get());
+        sign();
+        if (digits() == 0) return false;
+      }
+      return true;
+    }
+
+    // The decimal exponent e of a positive finite x and x/10^e in [1, 10)
+    int decimalexp(const dd& x, dd& r) {
+      int e = int(std::floor(std::log10(x.hi())));
+      r = scale10(x, -e);
+      if (r >= 10) { r /= 10; ++e; }
+      else if (r < 1) { r *= 10; --e; }
+      return e;
+    }
+
+    // n > 0 decimal digits of r in [1, 10) rounded to nearest (with ties to
+    // even, as for double); e is incremented if rounding gives 10.
+    string decimaldigits(dd r, int n, int& e) {
+      vector<int> d(n + 1);
+      for (int i = 0; i <= n; ++i) {
+        double k = std::floor(r.hi());
+        d[i] = int(k);
+        r = (r - k) * 10.0;
+      }
+      // Fix digits which are out of range because of rounding errors
+      for (int i = n; i > 0; --i) {
+        if (d[i] < 0) { d[i] += 10; --d[i-1]; }
+        else if (d[i] > 9) { d[i] -= 10; ++d[i-1]; }
+      }
+      // r is now 10 times the remainder after d[n]
+      if (d[n] > 5 || (d[n] == 5 && (r > 0 || (r == 0 && d[n-1] % 2)))) {
+        int i = n - 1;
+        for (++d[i]; i > 0 && d[i] > 9; --i) { d[i] -= 10; ++d[i-1]; }
+      }
+      if (d[0] > 9) {
+        d[0] = 1;
+        for (int i = 1; i < n; ++i) d[i] = 0;
+        ++e;
+      }
+      string s(n, '0');
+      for (int i = 0; i < n; ++i) s[i] = char('0' + d[i]);
+      return s;
+    }
+
+    // Format the digits s (the first with weight 10^e) with p decimals
+    string fixedformat(const string& s, int e, int p) {
+      string t;
+      if (e < 0)
+        t = "0" + string(p > 0 ? 1 : 0, '.') + string(-e - 1, '0') + s;
+      else {
+        t = s.substr(0, e + 1);
+        if (int(t.size()) < e + 1) t += string(e + 1 - t.size(), '0');
+        if (p > 0) t += "." + (e + 1 < int(s.size()) ? s.substr(e + 1) : "");
+      }
+      // Pad with zeros (only needed for zero digits)
+      size_t n = t.find('.');
+      int m = n == string::npos ? 0 : int(t.size() - n - 1);
+      if (m < p) t += string(p - m, '0');
+      return t;
+    }
+
+    string sciformat(const string& s, int e) {
+      string t = s.substr(0, 1);
+      if (s.size() > 1) t += "." + s.substr(1);
+      t += e < 0 ? "e-" : "e+";
+      string x = to_string(e < 0 ? -e : e);
+      return t + (x.size() < 2 ? "0" : "") + x;
+    }
+
+  }
+
+  DoubleDouble::DoubleDouble(long long x) {
+    // Split x into two parts which are exactly representable as doubles
+    long long l = x & 0xffffffffLL;
+    *this = DoubleDouble(double(x - l)) + double(l);
+  }
+
+  DoubleDouble::DoubleDouble(unsigned long long x) {
+    unsigned long long l = x & 0xffffffffULL;
+    *this = DoubleDouble(double(x - l)) + double(l);
+  }
+
+  DoubleDouble::DoubleDouble(long double x)
+    : _hi(double(x))
+    , _lo(finite(_hi) ? double(x - _hi) : 0)
+  {}
+
+  long long DoubleDouble::toll() const {
+    DoubleDouble t = trunc(*this);
+    return (long long)t._hi + (long long)t._lo;
+  }
+
+  unsigned long long DoubleDouble::toull() const {
+    DoubleDouble t = trunc(*this);
+    if (t._hi < 0) return (unsigned long long)toll();
+    return t._lo < 0 ?
+      (unsigned long long)t._hi - (unsigned long long)(-t._lo) :
+      (unsigned long long)t._hi + (unsigned long long)t._lo;
+  }
+
+  DoubleDouble round(const DoubleDouble& x) {
+    double hi = std::round(x._hi), lo = 0;
+    if (hi == x._hi) {
+      // hi is an integer; round lo with ties away from zero for x
+      lo = std::round(x._lo);
+      if (std::fabs(lo - x._lo) == 0.5)
+        lo = x._lo + std::copysign(0.5, x._hi);
+    } else if (std::fabs(hi - x._hi) == 0.5 && x._lo != 0)
+      // hi is half an odd integer; lo decides the rounding
+      hi = x._lo > 0 ? std::ceil(x._hi) : std::floor(x._hi);
+    return DoubleDouble::norm(hi, lo, hi);
+  }
+
+  long lround(const DoubleDouble& x)
+  { return long(round(x)); }
+
+  DoubleDouble remquo(const DoubleDouble& x, const DoubleDouble& y, int* q) {
+    *q = 0;
+    if (!DoubleDouble::finite(x._hi) || std::isnan(y._hi) || y._hi == 0)
+      return numeric_limits<DoubleDouble>::quiet_NaN();
+    if (!DoubleDouble::finite(y._hi)) return x;
+    DoubleDouble r;
+    int n;                      // The low bits of the quotient
+    if (y._lo == 0) {
+      // The common case, e.g., y = 360; reduce the two parts of x exactly.
+      int n1, n2;
+      double r1 = std::remquo(x._hi, y._hi, &n1),
+        r2 = std::remquo(x._lo, y._hi, &n2);
+      r = DoubleDouble(r1) + r2;
+      n = n1 + n2;
+    } else {
+      DoubleDouble m = round(x / y);
+      r = x - m * y;
+      n = int(std::fmod(m._hi, 8.0) + std::fmod(m._lo, 8.0));
+    }
+    // Now |r| <= |y|; reduce to |r| <= |y|/2 with ties to even quotients
+    DoubleDouble ay = fabs(y), h = ldexp(ay, -1);
+    int s = std::signbit(y._hi) ? -1 : 1;
+    if (r > h || (r == h && (n & 1))) { r -= ay; n += s; }
+    else if (r < -h || (r == -h && (n & 1))) { r += ay; n -= s; }
+    if (r == 0) r = copysign(r, x);
+    *q = std::signbit(x._hi) != std::signbit(y._hi) ? -(-n & 7) : n & 7;
+    return r;
+  }
+
+  DoubleDouble remainder(const DoubleDouble& x, const DoubleDouble& y)
+  { int q; return remquo(x, y, &q); }
+
+  DoubleDouble fmod(const DoubleDouble& x, const DoubleDouble& y) {
+    DoubleDouble r = remainder(x, y);
+    if (r != 0 && std::signbit(r._hi) != std::signbit(x._hi))
+      r += copysign(fabs(y), x);
+    return r;
+  }
+
+  DoubleDouble nextafter(const DoubleDouble& x, const DoubleDouble& y) {
+    if (std::isnan(x._hi) || std::isnan(y._hi)) return x + y;
+    if (x == y) return y;
+    if (x._hi == 0)
+      return std::copysign(numeric_limits<double>::denorm_min(),
+                           y._hi - x._hi);
+    // Step by epsilon() relative to the leading part of x
+    double d = std::ldexp(1.0, std::ilogb(x._hi) + 1 -
+                          numeric_limits<DoubleDouble>::digits);
+    return x + (y > x ? d : -d);
+  }
+
+  DoubleDouble hypot(const DoubleDouble& x, const DoubleDouble& y) {
+    double a = std::fabs(x._hi), b = std::fabs(y._hi);
+    if (!(DoubleDouble::finite(a) && DoubleDouble::finite(b)) ||
+        (a == 0 && b == 0))
+      return std::hypot(a, b);
+    // Scale by a power of 2 to avoid overflow and underflow
+    int e;
+    std::frexp(std::fmax(a, b), &e);
+    DoubleDouble xs = ldexp(x, -e), ys = ldexp(y, -e);
+    return ldexp(sqrt(xs * xs + ys * ys), e);
+  }
+
+  DoubleDouble cbrt(const DoubleDouble& x) {
+    if (!DoubleDouble::finite(x._hi) || x._hi == 0) return x;
+    double y = std::cbrt(x._hi);
+    // One Newton iteration: y + (x - y^3) / (3*y^2)
+    return y + (x - DoubleDouble(y) * y * y) / (3 * y * y);
+  }
+
+  DoubleDouble exp(const DoubleDouble& x) {
+    if (std::isnan(x._hi)) return x;
+    if (x._hi > 709.8) return numeric_limits<double>::infinity();
+    if (x._hi < -745.2) return 0.0;
+    // x = k * ln(2) + r with |r| <= ln(2)/2
+    double k = std::round(x._hi / ln2a_);
+    return ldexp(expm1kernel(x - kln2(k)) + 1.0, int(k));
+  }
+
+  DoubleDouble expm1(const DoubleDouble& x) {
+    return std::fabs(x._hi) <= 0.35 ? expm1kernel(x) : exp(x) - 1.0;
+  }
+
+  DoubleDouble exp2(const DoubleDouble& x) {
+    if (!(std::fabs(x._hi) < 1100)) return std::exp2(x._hi);
+    // Split off the integer part so that the result is exact for integers
+    double k = std::round(x._hi);
+    return ldexp(exp((x - k) * ln2()), int(k));
+  }
+
+  DoubleDouble log1p(const DoubleDouble& x) {
+    DoubleDouble u = x + 1.0;
+    if (!(u._hi > 0)) return std::log(u._hi); // -inf or nan
+    if (!DoubleDouble::finite(x._hi) || x._hi == 0) return x;
+    // One Newton iteration to solve expm1(y) = x
+    double y = std::log1p(x._hi);
+    DoubleDouble e = expm1(DoubleDouble(y));
+    return y - (e - x) / (e + 1.0);
+  }
+
+  DoubleDouble log(const DoubleDouble& x) {
+    if (!(x._hi > 0 && DoubleDouble::finite(x._hi))) return std::log(x._hi);
+    // x = m * 2^e with m in [sqrt(1/2), sqrt(2)); log1p(m - 1) is accurate
+    // for x close to 1.
+    int e;
+    DoubleDouble m = frexp(x, &e);
+    if (m._hi < 0.7071067811865476) { m = ldexp(m, 1); --e; }
+    return log1p(m - 1.0) + kln2(e);
+  }
+
+  DoubleDouble log2(const DoubleDouble& x) {
+    if (!(x._hi > 0 && DoubleDouble::finite(x._hi))) return std::log2(x._hi);
+    int e;
+    DoubleDouble m = frexp(x, &e);
+    // m in [1/2, 1); the result is exact for powers of 2
+    return m == 0.5 ? DoubleDouble(e - 1) : e + log(m) / ln2();
+  }
+
+  DoubleDouble log10(const DoubleDouble& x) {
+    static const DoubleDouble ln10 = DoubleDouble(ln10a_) + ln10b_;
+    return log(x) / ln10;
+  }
+
+  DoubleDouble pow(const DoubleDouble& x, const DoubleDouble& y) {
+    if (y == 0) return 1.0;
+    if (y == trunc(y) && std::fabs(y._hi) < 1073741824.0) {
+      // Integer powers (including negative x) by repeated squaring
+      long n = long(y);
+      DoubleDouble p = 1.0, b = x;
+      for (unsigned long m = n < 0 ? -n : n; m; m >>= 1) {
+        if (m & 1) p *= b;
+        if (m > 1) b *= b;
+      }
+      return n < 0 ? 1 / p : p;
+    }
+    if (!(x._hi > 0 && DoubleDouble::finite(x._hi) &&
+          DoubleDouble::finite(y._hi)))
+      return std::pow(x._hi, y._hi);
+    return exp(y * log(x));
+  }
+
+  DoubleDouble sin(const DoubleDouble& x) {
+    if (!DoubleDouble::finite(x._hi)) return x - x;
+    if (x._hi == 0) return x;
+    DoubleDouble s, c;
+    sincos(x, s, c);
+    return s;
+  }
+
+  DoubleDouble cos(const DoubleDouble& x) {
+    if (!DoubleDouble::finite(x._hi)) return x - x;
+    DoubleDouble s, c;
+    sincos(x, s, c);
+    return c;
+  }
+
+  DoubleDouble tan(const DoubleDouble& x) {
+    if (!DoubleDouble::finite(x._hi)) return x - x;
+    if (x._hi == 0) return x;
+    DoubleDouble s, c;
+    sincos(x, s, c);
+    return s / c;
+  }
+
+  DoubleDouble atan2(const DoubleDouble& y, const DoubleDouble& x) {
+    if (std::isnan(x._hi) || std::isnan(y._hi)) return x + y;
+    const DoubleDouble& pio2 = GeographicLib::pio2();
+    if (std::isinf(x._hi) || std::isinf(y._hi)) {
+      DoubleDouble z = !std::isinf(y._hi) ?
+        (x._hi > 0 ? DoubleDouble(0.0) : 2 * pio2) :
+        (!std::isinf(x._hi) ? pio2 :
+         (x._hi > 0 ? ldexp(pio2, -1) : 3 * ldexp(pio2, -1)));
+      return copysign(z, y);
+    }
+    if (y._hi == 0)
+      return std::signbit(x._hi) ? copysign(2 * pio2, y) : y;
+    if (x._hi == 0) return copysign(pio2, y);
+    // One Newton iteration starting with the double result
+    double z = std::atan2(y._hi, x._hi);
+    DoubleDouble r = hypot(x, y), xr = x / r, yr = y / r, s, c;
+    sincos(DoubleDouble(z), s, c);
+    return std::fabs(xr._hi) > std::fabs(yr._hi) ?
+      z + (yr - s) / c : z - (xr - c) / s;
+  }
+
+  DoubleDouble atan(const DoubleDouble& x)
+  { return atan2(x, DoubleDouble(1.0)); }
+
+  DoubleDouble asin(const DoubleDouble& x) {
+    if (fabs(x) > 1) return numeric_limits<double>::quiet_NaN();
+    return atan2(x, sqrt((1.0 - x) * (1.0 + x)));
+  }
+
+  DoubleDouble acos(const DoubleDouble& x) {
+    if (fabs(x) > 1) return numeric_limits<double>::quiet_NaN();
+    return atan2(sqrt((1.0 - x) * (1.0 + x)), x);
+  }
+
+  DoubleDouble sinh(const DoubleDouble& x) {
+    if (!DoubleDouble::finite(x._hi) || x._hi == 0) return x;
+    DoubleDouble a = fabs(x), s;
+    if (a._hi > 40)
+      // exp(-a) is negligible
+      s = exp(a - ln2());
+    else {
+      DoubleDouble u = expm1(a);
+      s = ldexp(u + u / (u + 1.0), -1);
+    }
+    return copysign(s, x);
+  }
+
+  DoubleDouble cosh(const DoubleDouble& x) {
+    DoubleDouble a = fabs(x);
+    if (!DoubleDouble::finite(a._hi)) return a;
+    if (a._hi > 40) return exp(a - ln2());
+    DoubleDouble e = exp(a);
+    return ldexp(e + 1 / e, -1);
+  }
+
+  DoubleDouble tanh(const DoubleDouble& x) {
+    if (std::isnan(x._hi) || x._hi == 0) return x;
+    DoubleDouble a = fabs(x);
+    if (a._hi > 40) return std::copysign(1.0, x._hi);
+    DoubleDouble u = expm1(2 * a);
+    return copysign(u / (u + 2.0), x);
+  }
+
+  DoubleDouble asinh(const DoubleDouble& x) {
+    if (!DoubleDouble::finite(x._hi) || x._hi == 0) return x;
+    DoubleDouble a = fabs(x);
+    a = a._hi > 1e150 ? log(a) + ln2() :
+      log1p(a + a * a / (1.0 + sqrt(1.0 + a * a)));
+    return copysign(a, x);
+  }
+
+  DoubleDouble acosh(const DoubleDouble& x) {
+    if (!(x >= 1)) return numeric_limits<double>::quiet_NaN();
+    if (!DoubleDouble::finite(x._hi)) return x;
+    if (x._hi > 1e150) return log(x) + ln2();
+    DoubleDouble t = x - 1.0;
+    return log1p(t + sqrt(t * (x + 1.0)));
+  }
+
+  DoubleDouble atanh(const DoubleDouble& x) {
+    if (std::isnan(x._hi) || x._hi == 0) return x;
+    DoubleDouble a = fabs(x);
+    if (a > 1) return numeric_limits<double>::quiet_NaN();
+    if (a == 1) return std::copysign(numeric_limits<double>::infinity(),
+                                     x._hi);
+    return copysign(ldexp(log1p(2 * a / (1.0 - a)), -1), x);
+  }
+
+  ostream& operator<<(ostream& os, const DoubleDouble& x) {
+    ios_base::fmtflags flags = os.flags(),
+      field = flags & ios_base::floatfield;
+    bool fixed = field == ios_base::fixed,
+      scientific = field == ios_base::scientific;
+    int p = int(os.precision());
+    if (p < 0) p = 6;
+    string s;
+    DoubleDouble a = fabs(x);
+    if (std::isnan(x._hi))
+      s = "nan";
+    else if (std::isinf(x._hi))
+      s = "inf";
+    else if (fixed) {
+      if (a._hi == 0)
+        s = fixedformat("0", 0, p);
+      else {
+        DoubleDouble r;
+        int e = decimalexp(a, r), n = e + 1 + p;
+        if (n > 0)
+          s = decimaldigits(r, n, e);
+        else if (n == 0 && r > 5) {
+          // Rounds up to 10^-p (a tie rounds to the even 0)
+          s = "1"; ++e;
+        } else {
+          s = "0"; e = 0;
+        }
+        s = fixedformat(s, e, p);
+      }
+    } else {
+      // The number of significant digits
+      int n = scientific ? p + 1 : (p == 0 ? 1 : p), e = 0;
+      DoubleDouble r = 1.0;
+      if (a._hi != 0) e = decimalexp(a, r);
+      s = a._hi != 0 ? decimaldigits(r, n, e) : string(n, '0');
+      if (scientific)
+        s = sciformat(s, e);
+      else {
+        // Strip trailing zeros unless showpoint is set
+        if (!(flags & ios_base::showpoint)) {
+          size_t k = s.find_last_not_of('0');
+          s = s.substr(0, k == string::npos ? 1 : k + 1);
+        }
+        if (e < -4 || e >= n)
+          s = sciformat(s, e);
+        else if (e < 0)
+          s = "0." + string(-e - 1, '0') + s;
+        else {
+          if (int(s.size()) < e + 1) s += string(e + 1 - s.size(), '0');
+          if (int(s.size()) > e + 1 || (flags & ios_base::showpoint))
+            s = s.substr(0, e + 1) + "." + s.substr(e + 1);
+        }
+      }
+    }
+    if (std::signbit(x._hi) && !std::isnan(x._hi))
+      s = "-" + s;
+    else if (flags & ios_base::showpos)
+      s = "+" + s;
+    if (flags & ios_base::uppercase)
+      for (char& c : s) c = char(toupper(c));
+    return os << s;
+  }
+
+  istream& operator>>(istream& is, DoubleDouble& x) {
+    istream::sentry sentry(is);
+    if (!sentry) return is;
+    string s;
+    if (!readnumber(is, s)) {
+      is.setstate(ios_base::failbit);
+      return is;
+    }
+    // Accumulate the digits and the decimal exponent
+    DoubleDouble m = 0.0;
+    int e = 0, ndigits = 0;
+    bool neg = false, point = false;
+    size_t i = 0;
+    if (s[i] == '+' || s[i] == '-') neg = s[i++] == '-';
+    for (; i < s.size() && s[i] != 'e' && s[i] != 'E'; ++i) {
+      if (s[i] == '.') { point = true; continue; }
+      if (ndigits < 40) {
+        m = m * 10.0 + double(s[i] - '0');
+        if (m != 0) ++ndigits;
+        if (point) --e;
+      } else if (!point)
+        ++e;
+    }
+    if (i < s.size()) {
+      // The exponent, capped to avoid overflow
+      int k = 0;
+      bool negk = s[++i] == '-';
+      if (s[i] == '+' || s[i] == '-') ++i;
+      for (; i < s.size(); ++i)
+        k = min(10 * k + (s[i] - '0'), 100000);
+      e += negk ? -k : k;
+    }
+    m = scale10(m, e);
+    x = neg ? -m : m;
+    return is;
+  }
+
+} // namespace GeographicLib
@@ -31,7 +31,7 @@ namespace GeographicLib {
     , _b(_a * _f1)
     , _tm(_a, _f, real(1))
     , _ell(-_e12)
-    , _au(_a, _f, real(0), real(1), real(0), real(1), real(1))
+    , _aux(_f)
   {}
 
   const Ellipsoid& Ellipsoid::WGS84() {
@@ -74,11 +74,15 @@ namespace GeographicLib {
                                      Math::degree());
   }
 
-  Math::real Ellipsoid::AuthalicLatitude(real phi) const
-  { return Math::atand(_au.txif(Math::tand(Math::LatFix(phi)))); }
+  Math::real Ellipsoid::AuthalicLatitude(real phi) const {
+    return _aux.Convert(AuxLatitude::GEOGRAPHIC, AuxLatitude::AUTHALIC,
+                        AuxAngle::degrees(Math::LatFix(phi))).degrees();
+  }
 
-  Math::real Ellipsoid::InverseAuthalicLatitude(real xi) const
-  { return Math::atand(_au.tphif(Math::tand(Math::LatFix(xi)))); }
+  Math::real Ellipsoid::InverseAuthalicLatitude(real xi) const {
+    return _aux.Convert(AuxLatitude::AUTHALIC, AuxLatitude::GEOGRAPHIC,
+                        AuxAngle::degrees(Math::LatFix(xi))).degrees();
+  }
 
   Math::real Ellipsoid::ConformalLatitude(real phi) const
   { return Math::atand(Math::taupf(Math::tand(Math::LatFix(phi)), _es)); }
@@ -126,4 +130,111 @@ namespace GeographicLib {
     return _a / (sqrt(v) * (Math::sq(calp) * v / (1 - _e2) + Math::sq(salp)));
   }
 
+  Math::real Ellipsoid::Rectifying(const EllipticFunction& ell, real phi)
+    const {
+    // mu = beta + deltaE(beta) in radians
+    if (fabs(phi) == Math::qd)
+      return phi;
+    real sbet, cbet;
+    Math::sincosd(ParametricLatitude(phi), sbet, cbet);
+    return (atan2(sbet, cbet) + ell.deltaE(sbet, cbet, ell.Delta(sbet, cbet)))
+      / Math::degree();
+  }
+
+  Math::real Ellipsoid::InverseRectifying(const EllipticFunction& ell,
+                                          real mu) const {
+    // beta = mu + deltaEinv(mu) in radians
+    if (fabs(mu) == Math::qd)
+      return mu;
+    real smu, cmu;
+    Math::sincosd(mu, smu, cmu);
+    return InverseParametricLatitude((atan2(smu, cmu) +
+                                      ell.deltaEinv(smu, cmu)) /
+                                     Math::degree());
+  }
+
+  void Ellipsoid::LatitudeBatch(int type, size_t n, const real phi[],
+                                real eta[]) const {
+    switch (type) {
+    case PARAMETRIC:
+      for (size_t i = 0; i < n; ++i) eta[i] = ParametricLatitude(phi[i]);
+      break;
+    case GEOCENTRIC:
+      for (size_t i = 0; i < n; ++i) eta[i] = GeocentricLatitude(phi[i]);
+      break;
+    case RECTIFYING:
+      if (n >= tabmin_) {
+        // Tabulating the elliptic integrals costs about as much as tabmin_
+        // direct evaluations.
+        EllipticFunction ell(_ell);
+        ell.Tabulate();
+        for (size_t i = 0; i < n; ++i) eta[i] = Rectifying(ell, phi[i]);
+      } else
+        for (size_t i = 0; i < n; ++i) eta[i] = RectifyingLatitude(phi[i]);
+      break;
+    case AUTHALIC:
+      for (size_t i = 0; i < n; ++i) eta[i] = AuthalicLatitude(phi[i]);
+      break;
+    case CONFORMAL:
+      for (size_t i = 0; i < n; ++i) eta[i] = ConformalLatitude(phi[i]);
+      break;
+    case ISOMETRIC:
+      for (size_t i = 0; i < n; ++i) eta[i] = IsometricLatitude(phi[i]);
+      break;
+    default:
+      for (size_t i = 0; i < n; ++i) eta[i] = Math::NaN();
+      break;
+    }
+  }
+
+  void Ellipsoid::InverseLatitudeBatch(int type, size_t n, const real eta[],
+                                       real phi[]) const {
+    switch (type) {
+    case PARAMETRIC:
+      for (size_t i = 0; i < n; ++i)
+        phi[i] = InverseParametricLatitude(eta[i]);
+      break;
+    case GEOCENTRIC:
+      for (size_t i = 0; i < n; ++i)
+        phi[i] = InverseGeocentricLatitude(eta[i]);
+      break;
+    case RECTIFYING:
+      if (n >= tabmin_) {
+        EllipticFunction ell(_ell);
+        ell.Tabulate();
+        for (size_t i = 0; i < n; ++i)
+          phi[i] = InverseRectifying(ell, eta[i]);
+      } else
+        for (size_t i = 0; i < n; ++i)
+          phi[i] = InverseRectifyingLatitude(eta[i]);
+      break;
+    case AUTHALIC:
+      for (size_t i = 0; i < n; ++i)
+        phi[i] = InverseAuthalicLatitude(eta[i]);
+      break;
+    case CONFORMAL:
+      for (size_t i = 0; i < n; ++i)
+        phi[i] = InverseConformalLatitude(eta[i]);
+      break;
+    case ISOMETRIC:
+      for (size_t i = 0; i < n; ++i)
+        phi[i] = InverseIsometricLatitude(eta[i]);
+      break;
+    default:
+      for (size_t i = 0; i < n; ++i) phi[i] = Math::NaN();
+      break;
+    }
+  }
+
+  void Ellipsoid::MeridianDistanceBatch(size_t n, const real phi[],
+                                        real s[]) const {
+    if (n >= tabmin_) {
+      EllipticFunction ell(_ell);
+      ell.Tabulate();
+      real l = QuarterMeridian() / Math::qd;
+      for (size_t i = 0; i < n; ++i) s[i] = l * Rectifying(ell, phi[i]);
+    } else
+      for (size_t i = 0; i < n; ++i) s[i] = MeridianDistance(phi[i]);
+  }
+
 } // namespace GeographicLib
@@ -8,6 +8,7 @@
  **********************************************************************/
 
 #include <GeographicLib/EllipticFunction.hpp>
+#include <GeographicLib/DST.hpp>
 
 #if defined(_MSC_VER)
 // Squelch warnings about constant conditional and enum-float expressions
@@ -125,6 +126,35 @@ namespace GeographicLib {
     return (Math::sq( (x0 + y0)/2 ) - s) * Math::pi() / (2 * (xn + yn));
   }
 
+  void EllipticFunction::RFG(real x, real y, real& rf, real& rg) {
+    // RF and RG run the same AGM iteration; this follows RG and gets RF from
+    // the converged means.  If x or y is a nan, RF and RG order the arguments
+    // differently, so call them separately.
+    if (isnan(x) || isnan(y)) {
+      rf = RF(x, y); rg = RG(x, y); return;
+    }
+    static const real tolRG0 =
+      real(2.7) * sqrt((numeric_limits<real>::epsilon() * real(0.01)));
+    real
+      x0 = sqrt(fmax(x, y)),
+      y0 = sqrt(fmin(x, y)),
+      xn = x0,
+      yn = y0,
+      s = 0,
+      mul = real(0.25);
+    while (fabs(xn-yn) > tolRG0 * xn) {
+      // Max 4 trips
+      real t = (xn + yn) /2;
+      yn = sqrt(xn * yn);
+      xn = t;
+      mul *= 2;
+      t = xn - yn;
+      s += mul * t * t;
+    }
+    rf = Math::pi() / (xn + yn);
+    rg = (Math::sq( (x0 + y0)/2 ) - s) * Math::pi() / (2 * (xn + yn));
+  }
+
   Math::real EllipticFunction::RJ(real x, real y, real z, real p) {
     // Carlson, eqs 2.17 - 2.25
     static const real
@@ -223,6 +253,191 @@ namespace GeographicLib {
       (4084080 * mul * An * sqrt(An)) + 3 * s;
   }
 
+  void EllipticFunction::RFBatch(size_t n, const real x[], const real y[],
+                                 const real z[], real rf[]) {
+    // This follows RF with the duplication steps for the K arguments in a
+    // batch done in lockstep.
+    static const real tolRF =
+      pow(3 * numeric_limits<real>::epsilon() * real(0.01), 1/real(8));
+    const int K = batchsize_;
+    for (size_t i0 = 0; i0 < n; i0 += K) {
+      int nb = int(min(size_t(K), n - i0));
+      real xx[K], yy[K], A0[K], An[K], Q[K], x0[K], y0[K], z0[K], mul[K];
+      bool act[K];
+      for (int j = 0; j < nb; ++j) {
+        xx[j] = x[i0 + j]; yy[j] = y[i0 + j]; z0[j] = z[i0 + j];
+        x0[j] = xx[j]; y0[j] = yy[j];
+        A0[j] = (xx[j] + yy[j] + z0[j])/3;
+        An[j] = A0[j];
+        Q[j] = fmax(fmax(fabs(A0[j]-xx[j]), fabs(A0[j]-yy[j])),
+                    fabs(A0[j]-z0[j])) / tolRF;
+        mul[j] = 1;
+      }
+      for (;;) {
+        bool more = false;
+        for (int j = 0; j < nb; ++j) {
+          act[j] = Q[j] >= mul[j] * fabs(An[j]);
+          more = more || act[j];
+        }
+        if (!more) break;
+        for (int j = 0; j < nb; ++j) {
+          real lam = sqrt(x0[j])*sqrt(y0[j]) + sqrt(y0[j])*sqrt(z0[j]) +
+            sqrt(z0[j])*sqrt(x0[j]);
+          An[j] = act[j] ? (An[j] + lam)/4 : An[j];
+          x0[j] = act[j] ? (x0[j] + lam)/4 : x0[j];
+          y0[j] = act[j] ? (y0[j] + lam)/4 : y0[j];
+          z0[j] = act[j] ? (z0[j] + lam)/4 : z0[j];
+          mul[j] = act[j] ? mul[j] * 4 : mul[j];
+        }
+      }
+      for (int j = 0; j < nb; ++j) {
+        real
+          X = (A0[j] - xx[j]) / (mul[j] * An[j]),
+          Y = (A0[j] - yy[j]) / (mul[j] * An[j]),
+          Z = - (X + Y),
+          E2 = X*Y - Z*Z,
+          E3 = X*Y*Z;
+        rf[i0 + j] = (E3 * (6930 * E3 + E2 * (15015 * E2 - 16380) + 17160) +
+                      E2 * ((10010 - 5775 * E2) * E2 - 24024) + 240240) /
+          (240240 * sqrt(An[j]));
+      }
+    }
+  }
+
+  void EllipticFunction::RDBatch(size_t n, const real x[], const real y[],
+                                 const real z[], real rd[]) {
+    // This follows RD with the duplication steps for the K arguments in a
+    // batch done in lockstep.
+    static const real
+      tolRD = pow(real(0.2) * (numeric_limits<real>::epsilon() * real(0.01)),
+                  1/real(8));
+    const int K = batchsize_;
+    for (size_t i0 = 0; i0 < n; i0 += K) {
+      int nb = int(min(size_t(K), n - i0));
+      real xx[K], yy[K], A0[K], An[K], Q[K], x0[K], y0[K], z0[K], mul[K],
+        s[K];
+      bool act[K];
+      for (int j = 0; j < nb; ++j) {
+        xx[j] = x[i0 + j]; yy[j] = y[i0 + j]; z0[j] = z[i0 + j];
+        x0[j] = xx[j]; y0[j] = yy[j];
+        A0[j] = (xx[j] + yy[j] + 3*z0[j])/5;
+        An[j] = A0[j];
+        Q[j] = fmax(fmax(fabs(A0[j]-xx[j]), fabs(A0[j]-yy[j])),
+                    fabs(A0[j]-z0[j])) / tolRD;
+        mul[j] = 1;
+        s[j] = 0;
+      }
+      for (;;) {
+        bool more = false;
+        for (int j = 0; j < nb; ++j) {
+          act[j] = Q[j] >= mul[j] * fabs(An[j]);
+          more = more || act[j];
+        }
+        if (!more) break;
+        for (int j = 0; j < nb; ++j) {
+          real lam = sqrt(x0[j])*sqrt(y0[j]) + sqrt(y0[j])*sqrt(z0[j]) +
+            sqrt(z0[j])*sqrt(x0[j]);
+          s[j] = act[j] ? s[j] + 1/(mul[j] * sqrt(z0[j]) * (z0[j] + lam)) :
+            s[j];
+          An[j] = act[j] ? (An[j] + lam)/4 : An[j];
+          x0[j] = act[j] ? (x0[j] + lam)/4 : x0[j];
+          y0[j] = act[j] ? (y0[j] + lam)/4 : y0[j];
+          z0[j] = act[j] ? (z0[j] + lam)/4 : z0[j];
+          mul[j] = act[j] ? mul[j] * 4 : mul[j];
+        }
+      }
+      for (int j = 0; j < nb; ++j) {
+        real
+          X = (A0[j] - xx[j]) / (mul[j] * An[j]),
+          Y = (A0[j] - yy[j]) / (mul[j] * An[j]),
+          Z = -(X + Y) / 3,
+          E2 = X*Y - 6*Z*Z,
+          E3 = (3*X*Y - 8*Z*Z)*Z,
+          E4 = 3 * (X*Y - Z*Z) * Z*Z,
+          E5 = X*Y*Z*Z*Z;
+        rd[i0 + j] = ((471240 - 540540 * E2) * E5 +
+                      (612612 * E2 - 540540 * E3 - 556920) * E4 +
+                      E3 * (306306 * E3 + E2 * (675675 * E2 - 706860) +
+                            680680) +
+                      E2 * ((417690 - 255255 * E2) * E2 - 875160) + 4084080) /
+          (4084080 * mul[j] * An[j] * sqrt(An[j])) + 3 * s[j];
+      }
+    }
+  }
+
+  void EllipticFunction::RJBatch(size_t n, const real x[], const real y[],
+                                 const real z[], const real p[], real rj[]) {
+    // This follows RJ with the duplication steps for the K arguments in a
+    // batch done in lockstep.  The calls to RC are made only for the active
+    // arguments.
+    static const real
+      tolRD = pow(real(0.2) * (numeric_limits<real>::epsilon() * real(0.01)),
+                  1/real(8));
+    const int K = batchsize_;
+    for (size_t i0 = 0; i0 < n; i0 += K) {
+      int nb = int(min(size_t(K), n - i0));
+      real xx[K], yy[K], zz[K], A0[K], An[K], delta[K], Q[K],
+        x0[K], y0[K], z0[K], p0[K], mul[K], mul3[K], s[K], d0[K], e0[K];
+      bool act[K];
+      for (int j = 0; j < nb; ++j) {
+        xx[j] = x[i0 + j]; yy[j] = y[i0 + j]; zz[j] = z[i0 + j];
+        p0[j] = p[i0 + j];
+        x0[j] = xx[j]; y0[j] = yy[j]; z0[j] = zz[j];
+        A0[j] = (xx[j] + yy[j] + zz[j] + 2*p0[j])/5;
+        An[j] = A0[j];
+        delta[j] = (p0[j]-xx[j]) * (p0[j]-yy[j]) * (p0[j]-zz[j]);
+        Q[j] = fmax(fmax(fabs(A0[j]-xx[j]), fabs(A0[j]-yy[j])),
+                    fmax(fabs(A0[j]-zz[j]), fabs(A0[j]-p0[j]))) / tolRD;
+        mul[j] = 1;
+        mul3[j] = 1;
+        s[j] = 0;
+      }
+      for (;;) {
+        bool more = false;
+        for (int j = 0; j < nb; ++j) {
+          act[j] = Q[j] >= mul[j] * fabs(An[j]);
+          more = more || act[j];
+        }
+        if (!more) break;
+        for (int j = 0; j < nb; ++j) {
+          d0[j] = (sqrt(p0[j])+sqrt(x0[j])) * (sqrt(p0[j])+sqrt(y0[j])) *
+            (sqrt(p0[j])+sqrt(z0[j]));
+          e0[j] = delta[j]/(mul3[j] * Math::sq(d0[j]));
+        }
+        for (int j = 0; j < nb; ++j)
+          if (act[j]) s[j] += RC(1, 1 + e0[j])/(mul[j] * d0[j]);
+        for (int j = 0; j < nb; ++j) {
+          real lam = sqrt(x0[j])*sqrt(y0[j]) + sqrt(y0[j])*sqrt(z0[j]) +
+            sqrt(z0[j])*sqrt(x0[j]);
+          An[j] = act[j] ? (An[j] + lam)/4 : An[j];
+          x0[j] = act[j] ? (x0[j] + lam)/4 : x0[j];
+          y0[j] = act[j] ? (y0[j] + lam)/4 : y0[j];
+          z0[j] = act[j] ? (z0[j] + lam)/4 : z0[j];
+          p0[j] = act[j] ? (p0[j] + lam)/4 : p0[j];
+          mul[j] = act[j] ? mul[j] * 4 : mul[j];
+          mul3[j] = act[j] ? mul3[j] * 64 : mul3[j];
+        }
+      }
+      for (int j = 0; j < nb; ++j) {
+        real
+          X = (A0[j] - xx[j]) / (mul[j] * An[j]),
+          Y = (A0[j] - yy[j]) / (mul[j] * An[j]),
+          Z = (A0[j] - zz[j]) / (mul[j] * An[j]),
+          P = -(X + Y + Z) / 2,
+          E2 = X*Y + X*Z + Y*Z - 3*P*P,
+          E3 = X*Y*Z + 2*P * (E2 + 2*P*P),
+          E4 = (2*X*Y*Z + P * (E2 + 3*P*P)) * P,
+          E5 = X*Y*Z*P*P;
+        rj[i0 + j] = ((471240 - 540540 * E2) * E5 +
+                      (612612 * E2 - 540540 * E3 - 556920) * E4 +
+                      E3 * (306306 * E3 + E2 * (675675 * E2 - 706860) +
+                            680680) +
+                      E2 * ((417690 - 255255 * E2) * E2 - 875160) + 4084080) /
+          (4084080 * mul[j] * An[j] * sqrt(An[j])) + 6 * s[j];
+      }
+    }
+  }
+
   void EllipticFunction::Reset(real k2, real alpha2,
                                real kp2, real alphap2) {
     // Accept nans here (needed for GeodesicExact)
@@ -264,10 +479,16 @@ namespace GeographicLib {
     if (_k2 != 0) {
       // Complete elliptic integral K(k), Carlson eq. 4.1
       // https://dlmf.nist.gov/19.25.E1
-      _kKc = _kp2 != 0 ? RF(_kp2, 1) : Math::infinity();
       // Complete elliptic integral E(k), Carlson eq. 4.2
       // https://dlmf.nist.gov/19.25.E1
-      _eEc = _kp2 != 0 ? 2 * RG(_kp2, 1) : 1;
+      // Both come from the same AGM iteration.
+      if (_kp2 != 0) {
+        real rf, rg;
+        RFG(_kp2, 1, rf, rg);
+        _kKc = rf; _eEc = 2 * rg;
+      } else {
+        _kKc = Math::infinity(); _eEc = 1;
+      }
       // D(k) = (K(k) - E(k))/k^2, Carlson eq.4.3
       // https://dlmf.nist.gov/19.25.E1
       _dDc = _kp2 != 0 ? RD(0, _kp2, 1) / 3 : Math::infinity();
@@ -304,6 +525,39 @@ namespace GeographicLib {
       //   Hc = int(cos(phi),...) = 1
       _hHc = _kp2 != 0 ? _kp2 * RD(0, 1, _kp2) / 3 : 1;
     }
+    Fit();
+  }
+
+  void EllipticFunction::Tabulate(bool tabulate) {
+    if (tabulate == _tab) return;
+    _tab = tabulate;
+    Fit();
+  }
+
+  void EllipticFunction::Fit() {
+    _cF.clear(); _cE.clear(); _cEinv.clear();
+    // The series don't converge for k2 = 1 (and skip nans)
+    if (!(_tab && _kp2 > 0 && isfinite(_k2)))
+      return;
+    // Fit into temporaries, since the delta functions use the series if they
+    // are present.
+    vector<real> cF, cE, cEinv;
+    DST::sinefit([this](real phi) -> real {
+        real sn = sin(phi), cn = cos(phi);
+        return deltaF(sn, cn, Delta(sn, cn));
+      }, cF);
+    DST::sinefit([this](real phi) -> real {
+        real sn = sin(phi), cn = cos(phi);
+        return deltaE(sn, cn, Delta(sn, cn));
+      }, cE);
+    DST::sinefit([this](real tau) -> real {
+        return deltaEinv(sin(tau), cos(tau));
+      }, cEinv);
+    _cF.swap(cF); _cE.swap(cE); _cEinv.swap(cEinv);
+#if GEOGRAPHICLIB_INSTRUMENT
+    // Don't count the calls to Einv made by the fit
+    ResetStatistics();
+#endif
   }
 
   /*
@@ -314,33 +568,44 @@ namespace GeographicLib {
    *   Numericshe Mathematik 7, 78-90 (1965)
    */
 
-  void EllipticFunction::sncndn(real x, real& sn, real& cn, real& dn) const {
-    // Bulirsch's sncndn routine, p 89.
+  unsigned EllipticFunction::Landen(real m[], real n[], real& c, real& d)
+    const {
+    // The first part of Bulirsch's sncndn routine.  On return m[0,l) and
+    // n[0,l) hold the sequences of the transformation, x should be multiplied
+    // by d (if kp2 < 0) and then by c.
     static const real tolJAC =
       sqrt(numeric_limits<real>::epsilon() * real(0.01));
+    real mc = _kp2;
+    d = 0;
+    if (signbit(_kp2)) {
+      d = 1 - mc;
+      mc /= -d;
+      d = sqrt(d);
+    }
+    c = 0;                  // To suppress warning about uninitialized variable
+    unsigned l = 0;
+    for (real a = 1; l < num_ || GEOGRAPHICLIB_PANIC; ++l) {
+      // This converges quadratically.  Max 5 trips
+      m[l] = a;
+      n[l] = mc = sqrt(mc);
+      c = (a + mc) / 2;
+      if (!(fabs(a - mc) > tolJAC * a)) {
+        ++l;
+        break;
+      }
+      mc *= a;
+      a = c;
+    }
+    return l;
+  }
+
+  void EllipticFunction::sncndn(real x, real& sn, real& cn, real& dn) const {
+    // Bulirsch's sncndn routine, p 89.
     if (_kp2 != 0) {
-      real mc = _kp2, d = 0;
-      if (signbit(_kp2)) {
-        d = 1 - mc;
-        mc /= -d;
-        d = sqrt(d);
+      real m[num_], n[num_], c, d;
+      unsigned l = Landen(m, n, c, d);
+      if (signbit(_kp2))
         x *= d;
-      }
-      real c = 0;           // To suppress warning about uninitialized variable
-      real m[num_], n[num_];
-      unsigned l = 0;
-      for (real a = 1; l < num_ || GEOGRAPHICLIB_PANIC; ++l) {
-        // This converges quadratically.  Max 5 trips
-        m[l] = a;
-        n[l] = mc = sqrt(mc);
-        c = (a + mc) / 2;
-        if (!(fabs(a - mc) > tolJAC * a)) {
-          ++l;
-          break;
-        }
-        mc *= a;
-        a = c;
-      }
       x *= c;
       sn = sin(x);
       cn = cos(x);
@@ -369,6 +634,67 @@ namespace GeographicLib {
     }
   }
 
+  void EllipticFunction::sncndnBatch(size_t num, const real x[],
+                                     real sn[], real cn[], real dn[]) const {
+    if (_kp2 == 0) {
+      for (size_t i = 0; i < num; ++i) {
+        real t = x[i];
+        sn[i] = tanh(t);
+        dn[i] = cn[i] = 1 / cosh(t);
+      }
+      return;
+    }
+    // This follows sncndn with the Landen transformation done once and the
+    // descending recursion done in lockstep for the arguments in a batch.
+    real m[num_], n[num_], c0, d;
+    unsigned l0 = Landen(m, n, c0, d);
+    bool neg = signbit(_kp2);
+    const int K = batchsize_;
+    for (size_t i0 = 0; i0 < num; i0 += K) {
+      int nb = int(min(size_t(K), num - i0));
+      real xx[K], s[K], a[K], c[K], dd[K];
+      for (int j = 0; j < nb; ++j) {
+        xx[j] = x[i0 + j];
+        if (neg) xx[j] *= d;
+        xx[j] *= c0;
+      }
+      for (int j = 0; j < nb; ++j) {
+        s[j] = sin(xx[j]);
+        c[j] = cos(xx[j]);
+      }
+      // Lanes with s = 0 compute junk which is discarded
+      for (int j = 0; j < nb; ++j) {
+        a[j] = c[j] / s[j];
+        c[j] = c0 * a[j];
+        dd[j] = 1;
+      }
+      for (unsigned l = l0; l--;) {
+        real b = m[l];
+        for (int j = 0; j < nb; ++j) {
+          a[j] *= c[j];
+          c[j] *= dd[j];
+          dd[j] = (n[l] + a[j]) / (b + a[j]);
+          a[j] = c[j] / b;
+        }
+      }
+      for (int j = 0; j < nb; ++j) {
+        real sj = s[j];
+        if (sj != 0) {
+          real t = 1 / sqrt(c[j]*c[j] + 1);
+          sj = signbit(sj) ? -t : t;
+          real cj = c[j] * sj, dj = dd[j];
+          if (neg) {
+            swap(cj, dj);
+            sj /= d;
+          }
+          sn[i0 + j] = sj; cn[i0 + j] = cj; dn[i0 + j] = dj;
+        } else {
+          sn[i0 + j] = sj; cn[i0 + j] = cos(xx[j]); dn[i0 + j] = 1;
+        }
+      }
+    }
+  }
+
   Math::real EllipticFunction::F(real sn, real cn, real dn) const {
     // Carlson, eq. 4.5 and
     // https://dlmf.nist.gov/19.25.E5
@@ -458,12 +784,16 @@ namespace GeographicLib {
   }
 
   Math::real EllipticFunction::deltaF(real sn, real cn, real dn) const {
+    if (!_cF.empty())
+      return DST::sineval(sn, cn, _cF.data(), int(_cF.size()) - 1);
     // Function is periodic with period pi
     if (signbit(cn)) { cn = -cn; sn = -sn; }
     return F(sn, cn, dn) * (Math::pi()/2) / K() - atan2(sn, cn);
   }
 
   Math::real EllipticFunction::deltaE(real sn, real cn, real dn) const {
+    if (!_cE.empty())
+      return DST::sineval(sn, cn, _cE.data(), int(_cE.size()) - 1);
     // Function is periodic with period pi
     if (signbit(cn)) { cn = -cn; sn = -sn; }
     return E(sn, cn, dn) * (Math::pi()/2) / E() - atan2(sn, cn);
@@ -495,13 +825,13 @@ namespace GeographicLib {
 
   Math::real EllipticFunction::F(real phi) const {
     real sn = sin(phi), cn = cos(phi), dn = Delta(sn, cn);
-    return fabs(phi) < Math::pi() ? F(sn, cn, dn) :
+    return fabs(phi) < Math::pi() && _cF.empty() ? F(sn, cn, dn) :
       (deltaF(sn, cn, dn) + phi) * K() / (Math::pi()/2);
   }
 
   Math::real EllipticFunction::E(real phi) const {
     real sn = sin(phi), cn = cos(phi), dn = Delta(sn, cn);
-    return fabs(phi) < Math::pi() ? E(sn, cn, dn) :
+    return fabs(phi) < Math::pi() && _cE.empty() ? E(sn, cn, dn) :
       (deltaE(sn, cn, dn) + phi) * E() / (Math::pi()/2);
   }
 
@@ -538,6 +868,10 @@ namespace GeographicLib {
   }
 
   Math::real EllipticFunction::Einv(real x) const {
+    if (!_cEinv.empty()) {
+      real tau = x * (Math::pi()/2) / _eEc;
+      return tau + deltaEinv(sin(tau), cos(tau));
+    }
     static const real tolJAC =
       sqrt(numeric_limits<real>::epsilon() * real(0.01));
     real n = floor(x / (2 * _eEc) + real(0.5));
@@ -549,20 +883,28 @@ namespace GeographicLib {
     // For kp2 close to zero use asin(x/_eEc) or
     // J. P. Boyd, Applied Math. and Computation 218, 7005-7013 (2012)
     // https://doi.org/10.1016/j.amc.2011.12.021
-    for (int i = 0; i < num_ || GEOGRAPHICLIB_PANIC; ++i) {
+    int i = 0;
+    for (; i < num_ || GEOGRAPHICLIB_PANIC; ++i) {
       real
         sn = sin(phi),
         cn = cos(phi),
         dn = Delta(sn, cn),
         err = (E(sn, cn, dn) - x)/dn;
       phi -= err;
-      if (!(fabs(err) > tolJAC))
+      if (!(fabs(err) > tolJAC)) {
+        ++i;
         break;
+      }
     }
+#if GEOGRAPHICLIB_INSTRUMENT
+    _einviterations.Add(i);
+#endif
     return n * Math::pi() + phi;
   }
 
   Math::real EllipticFunction::deltaEinv(real stau, real ctau) const {
+    if (!_cEinv.empty())
+      return DST::sineval(stau, ctau, _cEinv.data(), int(_cEinv.size()) - 1);
     // Function is periodic with period pi
     if (signbit(ctau)) { ctau = -ctau; stau = -stau; }
     real tau = atan2(stau, ctau);
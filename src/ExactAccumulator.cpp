@@ -0,0 +1,22 @@
+/**
+ * \file ExactAccumulator.cpp
+ * \brief Implementation for GeographicLib::ExactAccumulator class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#include <GeographicLib/ExactAccumulator.hpp>
+
+namespace GeographicLib {
+
+  /// \cond SKIP
+
+  // Need to instantiate ExactAccumulator to get the code into the shared
+  // library.
+  template class GEOGRAPHICLIB_EXPORT ExactAccumulator<Math::real>;
+
+  /// \endcond
+
+} // namespace GeographicLib
@@ -9,6 +9,8 @@
 
 #include <GeographicLib/GARS.hpp>
 #include <GeographicLib/Utility.hpp>
+#include <GeographicLib/GeodesicRegion.hpp>
+#include <cstring>
 
 #if defined(_MSC_VER)
 // Squelch warnings about enum-float expressions
@@ -23,14 +25,19 @@ namespace GeographicLib {
   const char* const GARS::letters_ = "ABCDEFGHJKLMNPQRSTUVWXYZ";
 
   void GARS::Forward(real lat, real lon, int prec, string& gars) {
+    char gars1[MAXLENGTH + 1];
+    gars.assign(gars1, Forward(lat, lon, prec, gars1));
+  }
+
+  int GARS::Forward(real lat, real lon, int prec, char gars[]) {
     using std::isnan;           // Needed for Centos 7, ubuntu 14
     if (fabs(lat) > Math::qd)
       throw GeographicErr("Latitude " + Utility::str(lat)
                           + "d not in [-" + to_string(Math::qd)
                           + "d, " + to_string(Math::qd) + "d]");
     if (isnan(lat) || isnan(lon)) {
-      gars = "INVALID";
-      return;
+      copy("INVALID", "INVALID" + 8, gars);
+      return 7;
     }
     lon = Math::AngNormalize(lon);
     if (lon == Math::hd) lon = -Math::hd; // lon now in [-180,180)
@@ -42,7 +49,7 @@ namespace GeographicLib {
       ilon = x * mult1_ / m_,
       ilat = y * mult1_ / m_;
     x -= ilon * m_ / mult1_; y -= ilat * m_ / mult1_;
-    char gars1[maxlen_];
+    char* gars1 = gars;         // Write the result directly
     ++ilon;
     for (int c = lonlen_; c--;) {
       gars1[c] = digits_[ ilon % baselon_]; ilon /= baselon_;
@@ -58,13 +65,23 @@ namespace GeographicLib {
         gars1[baselen_ + 1] = digits_[mult3_ * (mult3_ - 1 - ilat) + ilon + 1];
       }
     }
-    gars.resize(baselen_ + prec);
-    copy(gars1, gars1 + baselen_ + prec, gars.begin());
+    gars1[baselen_ + prec] = '\0';
+    return baselen_ + prec;
   }
 
-  void GARS::Reverse(const string& gars, real& lat, real& lon,
+  void GARS::ForwardBatch(size_t n, const real lat[], const real lon[],
+                          int prec, char gars[]) {
+    for (size_t i = 0; i < n; ++i)
+      Forward(lat[i], lon[i], prec, gars + i * (MAXLENGTH + 1));
+  }
+
+  void GARS::Reverse(const char* gars, size_t len0, real& lat, real& lon,
                      int& prec, bool centerp) {
-    int len = int(gars.length());
+    // The string for the error messages (allocated only if an error is
+    // thrown)
+    auto str = [gars, len0]() -> string { return string(gars, len0); };
+    // Any length exceeding maxlen_ is an error
+    int len = int(min(len0, size_t(maxlen_ + 1)));
     if (len >= 3 &&
         toupper(gars[0]) == 'I' &&
         toupper(gars[1]) == 'N' &&
@@ -73,30 +90,31 @@ namespace GeographicLib {
       return;
     }
     if (len < baselen_)
-      throw GeographicErr("GARS must have at least 5 characters " + gars);
+      throw GeographicErr("GARS must have at least 5 characters " + str());
     if (len > maxlen_)
-      throw GeographicErr("GARS can have at most 7 characters " + gars);
+      throw GeographicErr("GARS can have at most 7 characters " + str());
     int prec1 = len - baselen_;
     int ilon = 0;
     for (int c = 0; c < lonlen_; ++c) {
       int k = Utility::lookup(digits_, gars[c]);
       if (k < 0)
-        throw GeographicErr("GARS must start with 3 digits " + gars);
+        throw GeographicErr("GARS must start with 3 digits " + str());
       ilon = ilon * baselon_ + k;
     }
     if (!(ilon >= 1 && ilon <= 2 * Math::td))
         throw GeographicErr("Initial digits in GARS must lie in [1, 720] " +
-                            gars);
+                            str());
     --ilon;
     int ilat = 0;
     for (int c = 0; c < latlen_; ++c) {
       int k = Utility::lookup(letters_, gars[lonlen_ + c]);
       if (k < 0)
-        throw GeographicErr("Illegal letters in GARS " + gars.substr(3,2));
+        throw GeographicErr("Illegal letters in GARS "
+                            + string(gars + 3, 2));
       ilat = ilat * baselat_ + k;
     }
     if (!(ilat < Math::td))
-      throw  GeographicErr("GARS letters must lie in [AA, QZ] " + gars);
+      throw  GeographicErr("GARS letters must lie in [AA, QZ] " + str());
     real
       unit = mult1_,
       lat1 = ilat + latorig_ * unit,
@@ -104,7 +122,7 @@ namespace GeographicLib {
     if (prec1 > 0) {
       int k = Utility::lookup(digits_, gars[baselen_]);
       if (!(k >= 1 && k <= mult2_ * mult2_))
-        throw GeographicErr("6th character in GARS must [1, 4] " + gars);
+        throw GeographicErr("6th character in GARS must [1, 4] " + str());
       --k;
       unit *= mult2_;
       lat1 = mult2_ * lat1 + (mult2_ - 1 - k / mult2_);
@@ -112,7 +130,7 @@ namespace GeographicLib {
       if (prec1 > 1) {
         k = Utility::lookup(digits_, gars[baselen_ + 1]);
         if (!(k >= 1 /* && k <= mult3_ * mult3_ */))
-          throw GeographicErr("7th character in GARS must [1, 9] " + gars);
+          throw GeographicErr("7th character in GARS must [1, 9] " + str());
         --k;
         unit *= mult3_;
         lat1 = mult3_ * lat1 + (mult3_ - 1 - k / mult3_);
@@ -127,4 +145,30 @@ namespace GeographicLib {
     prec = prec1;
   }
 
+  void GARS::ReverseBatch(size_t n, const char gars[],
+                          real lat[], real lon[], int prec[], bool centerp) {
+    for (size_t i = 0; i < n; ++i) {
+      const char* s = gars + i * (MAXLENGTH + 1);
+      const void* e = memchr(s, '\0', MAXLENGTH + 1);
+      int precx = 0;
+      Reverse(s, e ? size_t(static_cast<const char*>(e) - s) : MAXLENGTH + 1,
+              lat[i], lon[i], prec ? prec[i] : precx, centerp);
+    }
+  }
+
+  void GARS::Cover(const GeodesicRegion& region, int prec,
+                   vector<string>& cells, bool compact) {
+    prec = max(0, min(int(maxprec_), prec));
+    // The 30' cells are reached via 15d tiles; these are divided into 2 x 2
+    // quadrants and then 3 x 3 keypad cells.
+    const GeodesicRegion::Level levels[] = {
+      { 12, 24, 0, false },
+      { 30, 30, 0, true },
+      {  2,  2, 1, true },
+      {  3,  3, 2, true },
+    };
+    void (*encode)(real, real, int, string&) = &Forward;
+    region.Cover(levels, 2 + prec, encode, compact, cells);
+  }
+
 } // namespace GeographicLib
@@ -11,51 +11,193 @@
 #include <GeographicLib/MGRS.hpp>
 #include <GeographicLib/DMS.hpp>
 #include <GeographicLib/Utility.hpp>
+#include <cstring>
+#include <memory>
+#include <vector>
 
 namespace GeographicLib {
 
   using namespace std;
 
-  void GeoCoords::Reset(const std::string& s, bool centerp, bool longfirst) {
-    vector<string> sa;
+  namespace {
+
+    // Append the len characters of t to the null-terminated string at s[k]
+    // in the buffer s of size n.
+    void appendstr(const char* t, size_t len, char s[], size_t n, size_t& k) {
+      if (!(k + len < n))
+        throw GeographicErr("Buffer too small for coordinate string");
+      memcpy(s + k, t, len);
+      k += len;
+      s[k] = '\0';
+    }
+
+    // Append x in fixed format with p decimal places; this matches
+    // Utility::str(x, p).
+    void appendfixed(Math::real x, int p, char s[], size_t n, size_t& k) {
+      if (!(k < n))
+        throw GeographicErr("Buffer too small for coordinate string");
+      k += Utility::str(x, p, s + k, n - k);
+    }
+
+  }
+
+  void GeoCoords::Reset(real latitude, real longitude, int zone) {
+    if (zone == UTMUPS::STANDARD && !(fabs(latitude) > Math::qd)) {
+      // UTMUPS::Forward can't fail for the standard zone; so defer the
+      // computation until the UTM/UPS coordinates are needed.
+      _zone = UTMUPS::StandardZone(latitude, longitude);
+      _northp = !signbit(latitude);
+      SetStates(PENDING, PENDING);
+    } else {
+      UTMUPS::Forward(latitude, longitude,
+                      _zone, _northp, _easting, _northing, _gamma, _k,
+                      zone);
+      SetStates(READY, PENDING);
+    }
+    _lat = latitude;
+    _long = Math::AngNormalize(longitude);
+  }
+
+  void GeoCoords::Reset(const char* s, size_t len,
+                        bool centerp, bool longfirst) {
+    // Split s into at most 3 elements; the 4th is only used to detect too
+    // many elements.
     const char* spaces = " \t\n\v\f\r,"; // Include comma as a space
-    for (string::size_type pos0 = 0, pos1; pos0 != string::npos;) {
-      pos1 = s.find_first_not_of(spaces, pos0);
-      if (pos1 == string::npos)
+    const char* sa[4];
+    size_t sn[4];
+    unsigned na = 0;
+    for (size_t pos0 = 0; na < 4;) {
+      while (pos0 < len && strchr(spaces, s[pos0]) && s[pos0])
+        ++pos0;
+      if (pos0 == len)
         break;
-      pos0 = s.find_first_of(spaces, pos1);
-      sa.push_back(s.substr(pos1, pos0 == string::npos ? pos0 : pos0 - pos1));
+      size_t pos1 = pos0;
+      while (pos1 < len && !(strchr(spaces, s[pos1]) && s[pos1]))
+        ++pos1;
+      sa[na] = s + pos0; sn[na] = pos1 - pos0; ++na;
+      pos0 = pos1;
     }
-    if (sa.size() == 1) {
+    if (na == 1) {
       int prec;
-      MGRS::Reverse(sa[0], _zone, _northp, _easting, _northing, prec, centerp);
+      MGRS::Reverse(sa[0], sn[0], _zone, _northp, _easting, _northing, prec,
+                    centerp);
       UTMUPS::Reverse(_zone, _northp, _easting, _northing,
                       _lat, _long, _gamma, _k);
-    } else if (sa.size() == 2) {
-      DMS::DecodeLatLon(sa[0], sa[1], _lat, _long, longfirst);
-      UTMUPS::Forward( _lat, _long,
-                       _zone, _northp, _easting, _northing, _gamma, _k);
-    } else if (sa.size() == 3) {
+    } else if (na == 2) {
+      DMS::DecodeLatLon(string(sa[0], sn[0]), string(sa[1], sn[1]),
+                        _lat, _long, longfirst);
+      // As in Reset(real, real, int), the UTM/UPS coordinates are computed
+      // when needed.
+      _zone = UTMUPS::StandardZone(_lat, _long);
+      _northp = !signbit(_lat);
+      SetStates(PENDING, PENDING);
+      return;
+    } else if (na == 3) {
       unsigned zoneind, coordind;
-      if (sa[0].size() > 0 && isalpha(sa[0][sa[0].size() - 1])) {
+      if (isalpha(sa[0][sn[0] - 1])) {
         zoneind = 0;
         coordind = 1;
-      } else if (sa[2].size() > 0 && isalpha(sa[2][sa[2].size() - 1])) {
+      } else if (isalpha(sa[2][sn[2] - 1])) {
         zoneind = 2;
         coordind = 0;
       } else
-        throw GeographicErr("Neither " + sa[0] + " nor " + sa[2]
+        throw GeographicErr("Neither " + string(sa[0], sn[0]) + " nor "
+                            + string(sa[2], sn[2])
                             + " of the form UTM/UPS Zone + Hemisphere"
                             + " (ex: 38n, 09s, n)");
-      UTMUPS::DecodeZone(sa[zoneind], _zone, _northp);
+      UTMUPS::DecodeZone(string(sa[zoneind], sn[zoneind]), _zone, _northp);
       for (unsigned i = 0; i < 2; ++i)
-        (i ? _northing : _easting) = Utility::val<real>(sa[coordind + i]);
+        (i ? _northing : _easting) =
+          Utility::val<real>(string(sa[coordind + i], sn[coordind + i]));
       UTMUPS::Reverse(_zone, _northp, _easting, _northing,
                       _lat, _long, _gamma, _k);
       FixHemisphere();
     } else
       throw GeographicErr("Coordinate requires 1, 2, or 3 elements");
-    CopyToAlt();
+    SetStates(READY, PENDING);
+  }
+
+  void GeoCoords::SetAltZoneBatch(size_t n, const GeoCoords p[], int zone) {
+    // The objects are processed in blocks.  The points needing their primary
+    // UTM/UPS coordinates (for which the alternate zone is the input zone)
+    // are in the front of the temporary arrays and those needing their
+    // alternate coordinates are at the back.
+    const size_t blocksize = 1024;
+    size_t nt = min(n, blocksize);
+    vector<size_t> ind(nt);
+    vector<int> zn(nt);
+    unique_ptr<bool[]> np(new bool[nt]);
+    vector<real> la(nt), lo(nt), xs(nt), ys(nt), gs(nt), ks(nt);
+    for (size_t i0 = 0; i0 < n; i0 += nt) {
+      size_t nb = min(nt, n - i0), m0 = 0, m1 = nb;
+      for (size_t i = i0; i < i0 + nb; ++i) {
+        const GeoCoords& q = p[i];
+        if (zone == UTMUPS::MATCH) {
+          if (q._altstate.load(memory_order_relaxed) != READY &&
+              q._utmstate.load(memory_order_relaxed) != READY)
+            ind[m0++] = i;
+          continue;
+        }
+        if (isnan(q._lat) || isnan(q._long))
+          continue;             // Leave the undefined points to SetAltZone
+        int z;
+        try {
+          z = UTMUPS::StandardZone(q._lat, q._long, zone);
+        }
+        catch (const GeographicErr&) {
+          continue;             // Leave the error to SetAltZone
+        }
+        if (z == q._zone) {
+          q._altstate.store(PENDING, memory_order_relaxed);
+          if (q._utmstate.load(memory_order_relaxed) != READY)
+            ind[m0++] = i;
+        } else if (q._altstate.load(memory_order_relaxed) != READY ||
+                   z != q._alt_zone)
+          ind[--m1] = i;
+      }
+      for (size_t j = 0; j < nb; ++j) {
+        if (j == m0) j = m1;
+        if (j == nb) break;
+        la[j] = p[ind[j]]._lat; lo[j] = p[ind[j]]._long;
+      }
+      // The standard zone can't fail; but, if it does, Compute gives the
+      // error.
+      try {
+        UTMUPS::ForwardBatch(m0, la.data(), lo.data(), zn.data(), np.get(),
+                             xs.data(), ys.data(), gs.data(), ks.data());
+        for (size_t j = 0; j < m0; ++j) {
+          const GeoCoords& q = p[ind[j]];
+          q._easting = xs[j]; q._northing = ys[j];
+          q._gamma = gs[j]; q._k = ks[j];
+          q._utmstate.store(READY, memory_order_relaxed);
+        }
+      }
+      catch (const GeographicErr&) {}
+      if (m1 == nb) continue;
+      try {
+        UTMUPS::ForwardBatch(nb - m1, la.data() + m1, lo.data() + m1,
+                             zn.data() + m1, np.get() + m1,
+                             xs.data() + m1, ys.data() + m1,
+                             gs.data() + m1, ks.data() + m1, zone);
+        for (size_t j = m1; j < nb; ++j) {
+          const GeoCoords& q = p[ind[j]];
+          q._alt_zone = zn[j];
+          q._alt_easting = xs[j]; q._alt_northing = ys[j];
+          q._alt_gamma = gs[j]; q._alt_k = ks[j];
+          q._altstate.store(READY, memory_order_relaxed);
+        }
+      }
+      catch (const GeographicErr&) {
+        // Some point is out of range for the zone; convert the points one
+        // at a time.
+        for (size_t j = m1; j < nb; ++j) {
+          try {
+            p[ind[j]].SetAltZone(zone);
+          }
+          catch (const GeographicErr&) {}
+        }
+      }
+    }
   }
 
   string GeoCoords::GeoRepresentation(int prec, bool longfirst) const {
@@ -77,6 +219,7 @@ namespace GeographicLib {
   string GeoCoords::MGRSRepresentation(int prec) const {
     // Max precision is um
     prec = max(-1, min(6, prec) + 5);
+    Compute();
     string mgrs;
     MGRS::Forward(_zone, _northp, _easting, _northing, _lat, prec, mgrs);
     return mgrs;
@@ -85,6 +228,7 @@ namespace GeographicLib {
   string GeoCoords::AltMGRSRepresentation(int prec) const {
     // Max precision is um
     prec = max(-1, min(6, prec) + 5);
+    CopyToAlt();
     string mgrs;
     MGRS::Forward(_alt_zone, _northp, _alt_easting, _alt_northing, _lat, prec,
                   mgrs);
@@ -114,7 +258,127 @@ namespace GeographicLib {
     utm = os.str();
   }
 
+  size_t GeoCoords::UTMUPSString(int zone, bool northp,
+                                 real easting, real northing, int prec,
+                                 bool abbrev, char utm[], size_t n) {
+    prec = max(-5, min(9 + Math::extra_digits(), prec));
+    // Need extra real because, since C++11, pow(float, int) returns double
+    real scale = prec < 0 ? real(pow(real(10), -prec)) : real(1);
+    size_t k = 0;
+    appendstr("", 0, utm, n, k);
+    // Format the zone as UTMUPS::EncodeZone does
+    if (zone == UTMUPS::INVALID)
+      appendstr(abbrev ? "inv" : "invalid", abbrev ? 3 : 7, utm, n, k);
+    else {
+      if (!(zone >= UTMUPS::MINZONE && zone <= UTMUPS::MAXZONE))
+        (void)UTMUPS::EncodeZone(zone, northp, abbrev); // throws
+      if (zone != UTMUPS::UPS) {
+        char z[2] = { char('0' + zone / 10), char('0' + zone % 10) };
+        appendstr(z, 2, utm, n, k);
+      }
+      if (abbrev)
+        appendstr(northp ? "n" : "s", 1, utm, n, k);
+      else
+        appendstr(northp ? "north" : "south", 5, utm, n, k);
+    }
+    for (unsigned i = 0; i < 2; ++i) {
+      real v = i ? northing : easting;
+      if (isfinite(v)) {
+        appendstr(" ", 1, utm, n, k);
+        appendfixed(v / scale, max(0, prec), utm, n, k);
+        if (prec < 0 && fabs(v / scale) > real(0.5))
+          appendstr("00000", -prec, utm, n, k);
+      } else
+        appendstr(" nan", 4, utm, n, k);
+    }
+    return k;
+  }
+
+  size_t GeoCoords::GeoRepresentation(int prec, bool longfirst,
+                                      char s[], size_t n) const {
+    prec = max(0, min(9 + Math::extra_digits(), prec) + 5);
+    size_t k = 0;
+    appendstr("", 0, s, n, k);
+    appendfixed(longfirst ? _long : _lat, prec, s, n, k);
+    appendstr(" ", 1, s, n, k);
+    appendfixed(longfirst ? _lat : _long, prec, s, n, k);
+    return k;
+  }
+
+  size_t GeoCoords::DMSRepresentation(int prec, bool longfirst, char dmssep,
+                                      char s[], size_t n) const {
+    prec = max(0, min(10 + Math::extra_digits(), prec) + 5);
+    size_t k = DMS::Encode(longfirst ? _long : _lat, unsigned(prec),
+                           longfirst ? DMS::LONGITUDE : DMS::LATITUDE, dmssep,
+                           s, n);
+    appendstr(" ", 1, s, n, k);
+    k += DMS::Encode(longfirst ? _lat : _long, unsigned(prec),
+                     longfirst ? DMS::LATITUDE : DMS::LONGITUDE, dmssep,
+                     s + k, n - k);
+    return k;
+  }
+
+  size_t GeoCoords::MGRSRepresentation(int prec, char s[], size_t n) const {
+    // Max precision is um
+    prec = max(-1, min(6, prec) + 5);
+    Compute();
+    char mgrs[MGRS::MAXLENGTH + 1];
+    size_t k = 0;
+    appendstr(mgrs, MGRS::Forward(_zone, _northp, _easting, _northing, _lat,
+                                  prec, mgrs), s, n, k);
+    return k;
+  }
+
+  size_t GeoCoords::AltMGRSRepresentation(int prec, char s[], size_t n)
+    const {
+    // Max precision is um
+    prec = max(-1, min(6, prec) + 5);
+    CopyToAlt();
+    char mgrs[MGRS::MAXLENGTH + 1];
+    size_t k = 0;
+    appendstr(mgrs, MGRS::Forward(_alt_zone, _northp,
+                                  _alt_easting, _alt_northing, _lat,
+                                  prec, mgrs), s, n, k);
+    return k;
+  }
+
+  size_t GeoCoords::UTMUPSRepresentation(int prec, bool abbrev,
+                                         char s[], size_t n) const {
+    Compute();
+    return UTMUPSString(_zone, _northp, _easting, _northing, prec, abbrev,
+                        s, n);
+  }
+
+  size_t GeoCoords::UTMUPSRepresentation(bool northp, int prec, bool abbrev,
+                                         char s[], size_t n) const {
+    Compute();
+    real e, n1;
+    int z;
+    UTMUPS::Transfer(_zone, _northp, _easting, _northing,
+                     _zone,  northp,  e,        n1,      z);
+    return UTMUPSString(_zone, northp, e, n1, prec, abbrev, s, n);
+  }
+
+  size_t GeoCoords::AltUTMUPSRepresentation(int prec, bool abbrev,
+                                            char s[], size_t n) const {
+    CopyToAlt();
+    return UTMUPSString(_alt_zone, _northp, _alt_easting, _alt_northing,
+                        prec, abbrev, s, n);
+  }
+
+  size_t GeoCoords::AltUTMUPSRepresentation(bool northp, int prec,
+                                            bool abbrev,
+                                            char s[], size_t n) const {
+    CopyToAlt();
+    real e, n1;
+    int z;
+    UTMUPS::Transfer(_alt_zone, _northp, _alt_easting, _alt_northing,
+                     _alt_zone,  northp,      e,            n1,      z);
+    return UTMUPSString(_alt_zone, northp, e, n1, prec, abbrev, s, n);
+  }
+
   string GeoCoords::UTMUPSRepresentation(int prec, bool abbrev) const {
+    Compute();
     string utm;
     UTMUPSString(_zone, _northp, _easting, _northing, prec, abbrev, utm);
     return utm;
@@ -122,6 +386,7 @@ namespace GeographicLib {
 
   string GeoCoords::UTMUPSRepresentation(bool northp, int prec,
                                          bool abbrev) const {
+    Compute();
     real e, n;
     int z;
     UTMUPS::Transfer(_zone, _northp, _easting, _northing,
@@ -132,6 +397,7 @@ namespace GeographicLib {
   }
 
   string GeoCoords::AltUTMUPSRepresentation(int prec, bool abbrev) const {
+    CopyToAlt();
     string utm;
     UTMUPSString(_alt_zone, _northp, _alt_easting, _alt_northing, prec,
                  abbrev, utm);
@@ -140,6 +406,7 @@ namespace GeographicLib {
 
   string GeoCoords::AltUTMUPSRepresentation(bool northp, int prec,
                                             bool abbrev) const {
+    CopyToAlt();
     real e, n;
     int z;
     UTMUPS::Transfer(_alt_zone, _northp, _alt_easting, _alt_northing,
@@ -8,6 +8,7 @@
  **********************************************************************/
 
 #include <GeographicLib/Geocentric.hpp>
+#include <GeographicLib/CPUDispatch.hpp>
 
 namespace GeographicLib {
 
@@ -152,6 +153,250 @@ namespace GeographicLib {
       Rotation(sphi, cphi, slam, clam, M);
   }
 
+  template<typename T>
+  void Geocentric::IntForwardBatch(size_t n, const T lat[], const T lon[],
+                                   const T h[], T X[], T Y[], T Z[],
+                                   real M[]) const {
+    if (!Init())
+      return;
+    // This follows IntForward with the arithmetic for the K points in a batch
+    // collected into loops which the compiler can vectorize.
+    const int K = batchsize_;
+    for (size_t i0 = 0; i0 < n; i0 += K) {
+      int nb = int(min(size_t(K), n - i0));
+      real sphi[K], cphi[K], slam[K], clam[K], hh[K], nn[K];
+      for (int j = 0; j < nb; ++j) {
+        Math::sincosd(Math::LatFix(real(lat[i0 + j])), sphi[j], cphi[j]);
+        Math::sincosd(real(lon[i0 + j]), slam[j], clam[j]);
+        hh[j] = real(h[i0 + j]);
+      }
+      for (int j = 0; j < nb; ++j)
+        nn[j] = _a/sqrt(1 - _e2 * Math::sq(sphi[j]));
+      for (int j = 0; j < nb; ++j) {
+        real x = (nn[j] + hh[j]) * cphi[j];
+        Z[i0 + j] = T((_e2m * nn[j] + hh[j]) * sphi[j]);
+        Y[i0 + j] = T(x * slam[j]);
+        X[i0 + j] = T(x * clam[j]);
+      }
+      if (M)
+        for (int j = 0; j < nb; ++j)
+          Rotation(sphi[j], cphi[j], slam[j], clam[j], M + (i0 + j) * dim2_);
+    }
+  }
+
+  template<typename U>
+  void Geocentric::IntReverseBatch(size_t n, const U X[], const U Y[],
+                                   const U Z[], U lat[], U lon[], U h[],
+                                   real M[]) const {
+    if (!Init())
+      return;
+    // This follows IntReverse for the common case of a point which is not too
+    // far away, for which disc >= 0 and for which the special treatment of
+    // the equatorial plane or the rotation axis is not needed (this includes
+    // all points more than e^2 a, about 43 km for WGS84, from the center of
+    // the earth, excluding those near infinity).  Other points
+    // are handled by IntReverse.  The arithmetic for the K points in a batch
+    // is collected into loops which the compiler can vectorize; these are
+    // separated by loops with the calls to hypot, cbrt, and atan2 which
+    // aren't vectorized.
+    if (_e4a == 0) {
+      // The sphere is handled by IntReverse
+      for (size_t i = 0; i < n; ++i) {
+        real latx, lonx, hx;
+        IntReverse(real(X[i]), real(Y[i]), real(Z[i]), latx, lonx, hx,
+                   M ? M + i * dim2_ : nullptr);
+        lat[i] = U(latx); lon[i] = U(lonx); h[i] = U(hx);
+      }
+      return;
+    }
+    const int K = batchsize_;
+    for (size_t i0 = 0; i0 < n; i0 += K) {
+      int nb = int(min(size_t(K), n - i0));
+      real xx[K], yy[K], zz[K], R[K], hh[K], slam[K], clam[K],
+        q[K], r2[K], T3[K], T[K], u[K], k1[K], k2[K], d[K], zk[K], rk[K],
+        sphi[K], cphi[K];
+      bool gen[K];
+      for (int j = 0; j < nb; ++j) {
+        xx[j] = real(X[i0 + j]); yy[j] = real(Y[i0 + j]);
+        zz[j] = real(Z[i0 + j]);
+        R[j] = hypot(xx[j], yy[j]);
+        hh[j] = hypot(R[j], zz[j]);
+      }
+      for (int j = 0; j < nb; ++j) {
+        real
+          p = Math::sq(R[j] / _a),
+          q0 = _e2m * Math::sq(zz[j] / _a),
+          r = (p + q0 - _e4a) / 6,
+          pp = _f < 0 ? q0 : p;
+        q[j] = _f < 0 ? p : q0;
+        real
+          S = _e4a * pp * q[j] / 4,
+          rr2 = Math::sq(r),
+          r3 = r * rr2,
+          disc = S * (2 * r3 + S),
+          t3 = S + r3;
+        // sqrt(disc) is NaN if disc < 0, but then gen[j] is false
+        t3 += t3 < 0 ? -sqrt(disc) : sqrt(disc);
+        gen[j] = hh[j] <= _maxrad &&
+          !(_e4a * q[j] == 0 && r <= 0) && disc >= 0;
+        u[j] = r; r2[j] = rr2; T3[j] = t3;
+      }
+      for (int j = 0; j < nb; ++j)
+        T[j] = gen[j] ? cbrt(T3[j]) : 0;
+      for (int j = 0; j < nb; ++j) {
+        real
+          uu = u[j] + (T[j] + (T[j] != 0 ? r2[j] / T[j] : 0)),
+          v = sqrt(Math::sq(uu) + _e4a * q[j]),
+          uv = uu < 0 ? _e4a * q[j] / (v - uu) : uu + v,
+          w = fmax(real(0), _e2a * (uv - q[j]) / (2 * v)),
+          k = uv / (sqrt(uv + Math::sq(w)) + w);
+        k1[j] = _f >= 0 ? k : k - _e2;
+        k2[j] = _f >= 0 ? k + _e2 : k;
+        d[j] = k1[j] * R[j] / k2[j];
+        zk[j] = zz[j] / k1[j];
+        rk[j] = R[j] / k2[j];
+      }
+      for (int j = 0; j < nb; ++j) {
+        size_t i = i0 + j;
+        if (!gen[j]) {
+          real latx, lonx, hx;
+          IntReverse(xx[j], yy[j], zz[j], latx, lonx, hx,
+                     M ? M + i * dim2_ : nullptr);
+          lat[i] = U(latx); lon[i] = U(lonx); h[i] = U(hx);
+          continue;
+        }
+        real H = hypot(zk[j], rk[j]);
+        sphi[j] = zk[j] / H;
+        cphi[j] = rk[j] / H;
+        h[i] = U((1 - _e2m/k1[j]) * hypot(d[j], zz[j]));
+        slam[j] = R[j] != 0 ? yy[j] / R[j] : 0;
+        clam[j] = R[j] != 0 ? xx[j] / R[j] : 1;
+        lat[i] = U(Math::atan2d(sphi[j], cphi[j]));
+        lon[i] = U(Math::atan2d(slam[j], clam[j]));
+        if (M)
+          Rotation(sphi[j], cphi[j], slam[j], clam[j], M + i * dim2_);
+      }
+    }
+  }
+
+  template<typename U>
+  void Geocentric::IntReverseFastBatch(size_t n, const U X[], const U Y[],
+                                       const U Z[], U lat[], U lon[], U h[],
+                                       real M[]) const {
+    if (!Init())
+      return;
+    // One step of Bowring's method: the parametric latitude beta is estimated
+    // by tan(beta) = (b*Z)/(a*R) * (1 + ep2*b/r) and then tan(phi) = (Z +
+    // ep2*b*sin(beta)^3) / (R - e2*a*cos(beta)^3).  The height is given by h
+    // = R*cos(phi) + Z*sin(phi) - a*sqrt(1 - e2*sin(phi)^2).  Points with r <
+    // a/2, where the estimate of phi may be in the wrong quadrant, are handled
+    // by IntReverse.  The norms are computed with sqrt instead of hypot
+    // because the remaining points can't overflow.
+    const int K = batchsize_;
+    const real b = _a * (1 - _f), ep2 = _e2 / _e2m, rmin = _a / 2;
+    for (size_t i0 = 0; i0 < n; i0 += K) {
+      int nb = int(min(size_t(K), n - i0));
+      real xx[K], yy[K], zz[K], R[K], hh[K], slam[K], clam[K],
+        sphi[K], cphi[K];
+      bool gen[K];
+      for (int j = 0; j < nb; ++j) {
+        xx[j] = real(X[i0 + j]); yy[j] = real(Y[i0 + j]);
+        zz[j] = real(Z[i0 + j]);
+      }
+      for (int j = 0; j < nb; ++j) {
+        R[j] = sqrt(Math::sq(xx[j]) + Math::sq(yy[j]));
+        real r = sqrt(Math::sq(R[j]) + Math::sq(zz[j]));
+        gen[j] = _f >= 0 && r >= rmin && r <= _maxrad;
+        real
+          sbet = b * zz[j] * (1 + ep2 * b / r),
+          cbet = _a * R[j],
+          t = sqrt(Math::sq(sbet) + Math::sq(cbet));
+        sbet /= t; cbet /= t;
+        real
+          num = zz[j] + ep2 * b * Math::sq(sbet) * sbet,
+          den = R[j] - _e2 * _a * Math::sq(cbet) * cbet;
+        t = sqrt(Math::sq(num) + Math::sq(den));
+        sphi[j] = num / t; cphi[j] = den / t;
+        hh[j] = R[j] * cphi[j] + zz[j] * sphi[j] -
+          _a * sqrt(1 - _e2 * Math::sq(sphi[j]));
+        slam[j] = R[j] != 0 ? yy[j] / R[j] : 0;
+        clam[j] = R[j] != 0 ? xx[j] / R[j] : 1;
+      }
+      for (int j = 0; j < nb; ++j) {
+        size_t i = i0 + j;
+        if (!gen[j]) {
+          real latx, lonx, hx;
+          IntReverse(xx[j], yy[j], zz[j], latx, lonx, hx,
+                     M ? M + i * dim2_ : nullptr);
+          lat[i] = U(latx); lon[i] = U(lonx); h[i] = U(hx);
+          continue;
+        }
+        h[i] = U(hh[j]);
+        lat[i] = U(Math::atan2d(sphi[j], cphi[j]));
+        lon[i] = U(Math::atan2d(slam[j], clam[j]));
+        if (M)
+          Rotation(sphi[j], cphi[j], slam[j], clam[j], M + i * dim2_);
+      }
+    }
+  }
+
+  void Geocentric::ReverseFast(real X, real Y, real Z,
+                               real& lat, real& lon, real& h) const {
+    IntReverseFastBatch(1, &X, &Y, &Z, &lat, &lon, &h, nullptr);
+  }
+
+  void Geocentric::ForwardBatch(size_t n, const real lat[], const real lon[],
+                                const real h[], real X[], real Y[], real Z[],
+                                real M[]) const {
+    CPUDispatch::Run([&]() -> void {
+      IntForwardBatch(n, lat, lon, h, X, Y, Z, M);
+    });
+  }
+
+  void Geocentric::ReverseBatch(size_t n, const real X[], const real Y[],
+                                const real Z[], real lat[], real lon[],
+                                real h[], real M[]) const {
+    CPUDispatch::Run([&]() -> void {
+      IntReverseBatch(n, X, Y, Z, lat, lon, h, M);
+    });
+  }
+
+  void Geocentric::ReverseFastBatch(size_t n, const real X[], const real Y[],
+                                    const real Z[], real lat[], real lon[],
+                                    real h[], real M[]) const {
+    CPUDispatch::Run([&]() -> void {
+      IntReverseFastBatch(n, X, Y, Z, lat, lon, h, M);
+    });
+  }
+
+#if GEOGRAPHICLIB_PRECISION != 1
+  void Geocentric::ForwardBatch(size_t n, const float lat[],
+                                const float lon[], const float h[],
+                                float X[], float Y[], float Z[],
+                                real M[]) const {
+    CPUDispatch::Run([&]() -> void {
+      IntForwardBatch(n, lat, lon, h, X, Y, Z, M);
+    });
+  }
+
+  void Geocentric::ReverseBatch(size_t n, const float X[], const float Y[],
+                                const float Z[], float lat[], float lon[],
+                                float h[], real M[]) const {
+    CPUDispatch::Run([&]() -> void {
+      IntReverseBatch(n, X, Y, Z, lat, lon, h, M);
+    });
+  }
+
+  void Geocentric::ReverseFastBatch(size_t n, const float X[],
+                                    const float Y[], const float Z[],
+                                    float lat[], float lon[], float h[],
+                                    real M[]) const {
+    CPUDispatch::Run([&]() -> void {
+      IntReverseFastBatch(n, X, Y, Z, lat, lon, h, M);
+    });
+  }
+#endif
+
   void Geocentric::Rotation(real sphi, real cphi, real slam, real clam,
                             real M[dim2_]) {
     // This rotation matrix is given by the following quaternion operations
@@ -0,0 +1,327 @@
+/**
+ * \file GeodesicBatchExecutor.cpp
+ * \brief Implementation for GeographicLib::GeodesicBatchExecutor class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#include <GeographicLib/GeodesicBatchExecutor.hpp>
+#include <GeographicLib/Geodesic.hpp>
+#include <GeographicLib/Utility.hpp>
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  namespace {
+
+    // The scheduler set by SetScheduler and the default number of threads
+    // (0 means use hardware_concurrency).
+    mutex schedulermutex_;
+    GeodesicBatchExecutor::scheduler scheduler_;
+    unsigned concurrency_ = 0;
+
+    // The position of a point along a Hilbert curve filling a 2^16 x 2^16
+    // grid in longitude and latitude; a NaN (or a latitude outside [-90, 90])
+    // gives 2^32 (past the end).  The 16 levels of the curve are handled in
+    // turn using a table indexed by the orientation of the curve at the level
+    // (one of 4) and the quadrant containing the point; each entry gives the
+    // position of the quadrant along the curve (the low 2 bits) and the
+    // orientation at the next level (the high 2 bits).
+    unsigned long long hilbertkey(Math::real lat, Math::real lon) {
+      typedef Math::real real;
+      static const unsigned char table[4][4] = {
+        { 4,  1, 15,  2},
+        { 0, 11,  5,  6},
+        {10,  7,  9, 12},
+        {14, 13,  3,  8},
+      };
+      const int bits = 16;
+      const real m = real(1U << bits);
+      lat = Math::LatFix(lat);
+      if (isnan(lat) || isnan(lon)) return 1ULL << (2 * bits);
+      real
+        x = floor((Math::AngNormalize(lon) + Math::hd) / Math::td * m),
+        y = floor((lat + Math::qd) / Math::hd * m);
+      unsigned
+        ix = unsigned(fmin(m - 1, fmax(real(0), x))),
+        iy = unsigned(fmin(m - 1, fmax(real(0), y))),
+        state = 0;
+      unsigned long long key = 0;
+      for (int i = bits - 1; i >= 0; --i) {
+        unsigned e = table[state][((ix >> i) & 1U) << 1 | ((iy >> i) & 1U)];
+        key = key << 2 | (e & 3U);
+        state = e >> 2;
+      }
+      return key;
+    }
+
+  } // namespace
+
+  GeodesicBatchExecutor::GeodesicBatchExecutor(unsigned nthreads, size_t chunk)
+    : _nthreads(nthreads ? nthreads : Concurrency())
+    , _chunk(chunk ? chunk : 256)
+    , _deadline(chrono::steady_clock::time_point::max())
+    , _cancel(nullptr)
+  {}
+
+  void GeodesicBatchExecutor::SetScheduler(const scheduler& run,
+                                           unsigned concurrency) {
+    lock_guard<mutex> lock(schedulermutex_);
+    scheduler_ = run;
+    concurrency_ = concurrency;
+  }
+
+  unsigned GeodesicBatchExecutor::Concurrency() {
+    unsigned c;
+    {
+      lock_guard<mutex> lock(schedulermutex_);
+      c = concurrency_;
+    }
+    if (c == 0) c = thread::hardware_concurrency();
+    // hardware_concurrency may return 0 if it can't tell
+    return c ? c : 1;
+  }
+
+  void GeodesicBatchExecutor::Run(unsigned n,
+                                  const function<void(unsigned)>& work) {
+    scheduler run;
+    {
+      lock_guard<mutex> lock(schedulermutex_);
+      run = scheduler_;
+    }
+    if (run)
+      run(n, work);
+    else
+      ThreadRun(n, work);
+  }
+
+  void GeodesicBatchExecutor::ThreadRun(unsigned n,
+                                        const function<void(unsigned)>& work) {
+    if (n == 0) return;
+    vector<thread> threads;
+    threads.reserve(n - 1);
+    unsigned k = 1;
+    try {
+      for (; k < n; ++k)
+        threads.push_back(thread(work, k));
+    }
+    catch (const system_error&) {
+      // Can't start another thread; the workers from k on run here instead.
+    }
+    try {
+      work(0);
+      for (unsigned j = k; j < n; ++j)
+        work(j);
+    }
+    catch (...) {
+      // The threads refer to work, so they must finish before unwinding.
+      for (auto& t : threads)
+        t.join();
+      throw;
+    }
+    for (auto& t : threads)
+      t.join();
+  }
+
+  size_t GeodesicBatchExecutor::ForEach
+  (size_t n, const function<void(size_t, size_t)>& f) const {
+    if (Stoppable()) return StoppableForEach(n, f);
+    size_t nchunk = n / _chunk + (n % _chunk ? 1 : 0);
+    unsigned nthreads = unsigned(min(size_t(_nthreads), nchunk));
+    if (nthreads <= 1) {
+      if (n) f(0, n);
+      return n;
+    }
+    // The chunks [lo, hi) still to be done by a thread.  The owner takes
+    // chunks from the front; thieves take from the back.
+    struct Block {
+      mutex m;
+      size_t lo, hi;
+    };
+    vector<Block> blocks(nthreads);
+    for (unsigned k = 0; k < nthreads; ++k) {
+      blocks[k].lo = (nchunk * k) / nthreads;
+      blocks[k].hi = (nchunk * (k + 1)) / nthreads;
+    }
+    atomic<bool> abort(false);
+    mutex errmutex;
+    exception_ptr err;
+    thread::id caller = this_thread::get_id();
+    auto work = [&](unsigned k) -> void {
+      Block& own = blocks[k];
+      try {
+        if (this_thread::get_id() != caller) Utility::set_digits();
+        while (!abort.load(memory_order_relaxed)) {
+          size_t c;
+          {
+            lock_guard<mutex> lock(own.m);
+            c = own.lo < own.hi ? own.lo++ : nchunk;
+          }
+          if (c == nchunk) {
+            // Out of work; steal the back half of the largest block.
+            size_t lo = 0, hi = 0, left = 0;
+            unsigned victim = k;
+            for (unsigned j = 0; j < nthreads; ++j) {
+              if (j == k) continue;
+              lock_guard<mutex> lock(blocks[j].m);
+              if (blocks[j].hi - blocks[j].lo > left) {
+                left = blocks[j].hi - blocks[j].lo; victim = j;
+              }
+            }
+            if (victim == k) break; // Nothing left anywhere
+            {
+              lock_guard<mutex> lock(blocks[victim].m);
+              Block& b = blocks[victim];
+              if (b.hi <= b.lo) continue; // Lost a race; try again
+              hi = b.hi;
+              lo = b.lo + (b.hi - b.lo) / 2;
+              b.hi = lo;
+            }
+            lock_guard<mutex> lock(own.m);
+            own.lo = lo; own.hi = hi;
+            continue;
+          }
+          f(c * _chunk, min(n, (c + 1) * _chunk));
+        }
+      }
+      catch (...) {
+        abort = true;
+        lock_guard<mutex> lock(errmutex);
+        if (!err) err = current_exception();
+      }
+    };
+    Run(nthreads, work);
+    if (err)
+      rethrow_exception(err);
+    return n;
+  }
+
+  size_t GeodesicBatchExecutor::StoppableForEach
+  (size_t n, const function<void(size_t, size_t)>& f) const {
+    // The chunks are handed out in order from a shared counter, so that the
+    // chunks which are done when the executor is stopped are nearly all at
+    // the front.
+    size_t nchunk = n / _chunk + (n % _chunk ? 1 : 0);
+    unsigned nthreads = unsigned(max(size_t(1),
+                                     min(size_t(_nthreads), nchunk)));
+    vector<char> done(nchunk, 0);
+    atomic<size_t> next(0);
+    atomic<bool> abort(false);
+    mutex errmutex;
+    exception_ptr err;
+    thread::id caller = this_thread::get_id();
+    auto work = [&](unsigned) -> void {
+      try {
+        if (this_thread::get_id() != caller) Utility::set_digits();
+        while (!abort.load(memory_order_relaxed) && !Stopped()) {
+          size_t c = next++;
+          if (c >= nchunk) break;
+          f(c * _chunk, min(n, (c + 1) * _chunk));
+          done[c] = 1;
+        }
+      }
+      catch (...) {
+        abort = true;
+        lock_guard<mutex> lock(errmutex);
+        if (!err) err = current_exception();
+      }
+    };
+    if (nthreads == 1)
+      work(0);
+    else
+      Run(nthreads, work);
+    if (err)
+      rethrow_exception(err);
+    size_t c = 0;
+    while (c < nchunk && done[c]) ++c;
+    return min(n, c * _chunk);
+  }
+
+  void GeodesicBatchExecutor::HilbertOrder(size_t n,
+                                           const real lat[],
+                                           const real lon[],
+                                           size_t perm[]) {
+    // A stable least significant digit radix sort of the 33-bit keys in 3
+    // passes of 11 bits.
+    const int radix = 11;
+    const size_t nbins = size_t(1) << radix;
+    vector<unsigned long long> key(n), key1(n);
+    vector<size_t> perm1(n), count(nbins + 1);
+    for (size_t i = 0; i < n; ++i) {
+      key[i] = hilbertkey(lat[i], lon[i]);
+      perm[i] = i;
+    }
+    size_t* p = perm;
+    size_t* p1 = perm1.data();
+    for (int pass = 0; pass < 3; ++pass) {
+      int shift = pass * radix;
+      fill(count.begin(), count.end(), 0);
+      for (size_t i = 0; i < n; ++i)
+        ++count[((key[i] >> shift) & (nbins - 1)) + 1];
+      for (size_t b = 0; b < nbins; ++b)
+        count[b + 1] += count[b];
+      for (size_t i = 0; i < n; ++i) {
+        size_t j = count[(key[i] >> shift) & (nbins - 1)]++;
+        key1[j] = key[i]; p1[j] = p[i];
+      }
+      key.swap(key1); swap(p, p1);
+    }
+    // After an odd number of passes the result is in perm1.
+    if (p != perm)
+      copy(p, p + n, perm);
+  }
+
+  void GeodesicBatchExecutor::ForEachLocal
+  (size_t n, const real lat[], const real lon[],
+   const function<void(size_t, const size_t[])>& f) const {
+    vector<size_t> perm(n);
+    HilbertOrder(n, lat, lon, perm.data());
+    // Use an executor without the deadline
+    GeodesicBatchExecutor(_nthreads, _chunk)
+      .ForEach(n, [&perm, &f](size_t i0, size_t i1) -> void {
+        f(i1 - i0, perm.data() + i0);
+      });
+  }
+
+  void GeodesicBatchExecutor::DirectFan(const Geodesic& g,
+                                        real lat1, real lon1,
+                                        size_t na, const real azi1[],
+                                        size_t nd, bool arcmode,
+                                        const real s12_a12[],
+                                        unsigned outmask,
+                                        real a12[], real lat2[], real lon2[],
+                                        real azi2[], real s12[], real m12[],
+                                        real M12[], real M21[], real S12[])
+    const {
+    g.IntDirectFan(lat1, lon1, na, azi1, nd, arcmode, s12_a12, outmask,
+                   a12, lat2, lon2, azi2, s12, m12, M12, M21, S12, this);
+  }
+
+  void GeodesicBatchExecutor::DistanceMatrix(const Geodesic& g, size_t n,
+                                             const real lat1[],
+                                             const real lon1[],
+                                             size_t m,
+                                             const real lat2[],
+                                             const real lon2[],
+                                             real s12[]) const {
+    g.IntDistanceMatrix(n, lat1, lon1, m, lat2, lon2, s12, this);
+  }
+
+  void GeodesicBatchExecutor::DistanceMatrix(const Geodesic& g, size_t n,
+                                             const real lat[],
+                                             const real lon[],
+                                             real s12[]) const {
+    g.IntDistanceMatrix(n, lat, lon, n, nullptr, nullptr, s12, this);
+  }
+
+} // namespace GeographicLib
@@ -0,0 +1,228 @@
+/**
+ * \file GeodesicBuffer.cpp
+ * \brief Implementation for GeographicLib::GeodesicBuffer class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#include <GeographicLib/GeodesicBuffer.hpp>
+#include <GeographicLib/GeodesicBatchExecutor.hpp>
+#include <GeographicLib/PolygonArea.hpp>
+#include <algorithm>
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  GeodesicBuffer::GeodesicBuffer(const Geodesic& geod)
+    : _geod(geod)
+    , _gnom(geod)
+    , _closest(geod)
+    , _tol(_geod.EquatorialRadius() *
+           pow(numeric_limits<real>::epsilon(), 3/real(4)))
+  {}
+
+  bool GeodesicBuffer::Join(real latA, real lonA, real latB, real lonB,
+                            real latC, real lonC, real latD, real lonD,
+                            real& lat, real& lon) const {
+    // Solve A + u * (B - A) = C + w * (D - C) in the gnomonic projection
+    // centered at A and then again centered at the result.
+    real lat0 = latA, lon0 = lonA;
+    for (int i = 0; i < 2; ++i) {
+      real xA, yA, xB, yB, xC, yC, xD, yD;
+      _gnom.Forward(lat0, lon0, latA, lonA, xA, yA);
+      _gnom.Forward(lat0, lon0, latB, lonB, xB, yB);
+      _gnom.Forward(lat0, lon0, latC, lonC, xC, yC);
+      _gnom.Forward(lat0, lon0, latD, lonD, xD, yD);
+      real
+        ux = xB - xA, uy = yB - yA, wx = xD - xC, wy = yD - yC,
+        cx = xC - xA, cy = yC - yA,
+        den = ux * wy - uy * wx,
+        u = (cx * wy - cy * wx) / den, w = (cx * uy - cy * ux) / den;
+      // Allow some slack since the segments aren't quite straight.
+      const real slack = 1/real(16);
+      if (!(u >= -slack && u <= 1 + slack && w >= -slack && w <= 1 + slack))
+        return false;
+      _gnom.Reverse(lat0, lon0, xA + u * ux, yA + u * uy, lat, lon);
+      if (!(isfinite(lat) && isfinite(lon))) return false;
+      lat0 = lat; lon0 = lon;
+    }
+    return true;
+  }
+
+  void GeodesicBuffer::Outline(const vector<real>& lat,
+                               const vector<real>& lon, bool ring,
+                               real R, real ds,
+                               vector<real>& blat, vector<real>& blon,
+                               unsigned nthreads) const {
+    size_t n = lat.size(), ne = ring ? n : n - 1;
+    // Sample each edge, storing the positions and forward azimuths.  Edge e
+    // joins vertex e and vertex e + 1 (mod n); its samples are
+    // [off[e], off[e+1]).
+    vector<size_t> off(ne + 1, 0);
+    vector<real> slat, slon, sazi, s;
+    for (size_t e = 0; e < ne; ++e) {
+      size_t e1 = (e + 1) % n;
+      GeodesicLine line =
+        _geod.InverseLine(lat[e], lon[e], lat[e1], lon[e1],
+                          Geodesic::LATITUDE | Geodesic::LONGITUDE |
+                          Geodesic::AZIMUTH | Geodesic::DISTANCE_IN);
+      size_t m = size_t(fmax(real(1), ceil(line.Distance() / ds)));
+      s.resize(m + 1);
+      for (size_t k = 0; k <= m; ++k)
+        s[k] = k == m ? line.Distance() : line.Distance() * real(k) / m;
+      off[e + 1] = off[e] + m + 1;
+      slat.resize(off[e + 1]); slon.resize(off[e + 1]);
+      sazi.resize(off[e + 1]);
+      line.PositionBatch(m + 1, false, s.data(),
+                         Geodesic::LATITUDE | Geodesic::LONGITUDE |
+                         Geodesic::AZIMUTH, nullptr,
+                         slat.data() + off[e], slon.data() + off[e],
+                         sazi.data() + off[e],
+                         nullptr, nullptr, nullptr, nullptr, nullptr);
+    }
+    // The directed edges traversed: the edges forwards, and then, for a
+    // polyline, backwards.  The buffer is on the right, so each sample is
+    // offset in the direction azi + 90 * dir.
+    vector<pair<size_t, int>> path;
+    for (size_t e = 0; e < ne; ++e) path.push_back(make_pair(e, 1));
+    if (!ring)
+      for (size_t e = ne; e-- > 0;) path.push_back(make_pair(e, -1));
+    // The start points and azimuths of the perpendicular geodesics
+    vector<real> plat, plon, pazi;
+    for (size_t p = 0; p < path.size(); ++p) {
+      size_t e = path[p].first;
+      int dir = path[p].second;
+      for (size_t k = off[e]; k < off[e + 1]; ++k) {
+        size_t j = dir > 0 ? k : off[e + 1] - 1 - (k - off[e]);
+        plat.push_back(slat[j]); plon.push_back(slon[j]);
+        pazi.push_back(sazi[j] + Math::qd * dir);
+      }
+      // Join to the next directed edge with an arc if it turns left.
+      size_t q = (p + 1) % path.size(), f = path[q].first;
+      int fdir = path[q].second;
+      size_t v = dir > 0 ? off[e + 1] - 1 : off[e],
+        w = fdir > 0 ? off[f] : off[f + 1] - 1;
+      real ain = sazi[v] + (dir > 0 ? 0 : Math::hd),
+        aout = sazi[w] + (fdir > 0 ? 0 : Math::hd),
+        // At the ends of a polyline, turn round counter-clockwise.
+        tau = f == e ? -real(Math::hd) : Math::AngDiff(ain, aout);
+      if (tau < 0) {
+        size_t m = size_t(ceil(-tau * Math::degree() * R / ds));
+        for (size_t k = 1; k < m; ++k) {
+          plat.push_back(slat[v]); plon.push_back(slon[v]);
+          pazi.push_back(ain + Math::qd + tau * real(k) / m);
+        }
+      }
+    }
+    // The raw outline
+    size_t nr = plat.size();
+    vector<real> rlat(nr), rlon(nr), d(nr, R), x(nr);
+    vector<size_t> seg(nr);
+    {
+      GeodesicBatchExecutor exec(nthreads);
+      exec.Direct(_geod, nr, plat.data(), plon.data(), pazi.data(),
+                  false, d.data(),
+                  Geodesic::LATITUDE | Geodesic::LONGITUDE,
+                  nullptr, rlat.data(), rlon.data(), nullptr,
+                  nullptr, nullptr, nullptr, nullptr, nullptr);
+    }
+    // Drop the vertices closer than R to the path
+    vector<real> qlat(lat), qlon(lon);
+    if (ring) {
+      qlat.push_back(lat[0]); qlon.push_back(lon[0]);
+    }
+    _closest.Polyline(nr, rlat.data(), rlon.data(),
+                      qlat.size(), qlat.data(), qlon.data(),
+                      seg.data(), x.data(), d.data(), nthreads);
+    vector<bool> keep(nr);
+    size_t k0 = nr;
+    for (size_t k = 0; k < nr; ++k) {
+      keep[k] = !(d[k] < R - _tol);
+      if (keep[k] && k0 == nr) k0 = k;
+    }
+    if (k0 == nr) return;
+    for (size_t i = 0; i < nr;) {
+      size_t k = (k0 + i) % nr;
+      blat.push_back(rlat[k]); blon.push_back(rlon[k]);
+      size_t j = 1;
+      while (!keep[(k + j) % nr]) ++j;
+      if (j > 1) {
+        // Join the outline across the dropped vertices
+        size_t b = (k + 1) % nr, c = (k + j - 1) % nr, l = (k + j) % nr;
+        real latj, lonj;
+        if (Join(rlat[k], rlon[k], rlat[b], rlon[b],
+                 rlat[c], rlon[c], rlat[l], rlon[l], latj, lonj)) {
+          blat.push_back(latj); blon.push_back(lonj);
+        }
+      }
+      i += j;
+    }
+  }
+
+  void GeodesicBuffer::Polyline(size_t n, const real lat[], const real lon[],
+                                real R, real ds,
+                                vector<real>& blat, vector<real>& blon,
+                                unsigned nthreads) const {
+    if (!(isfinite(R) && R > 0 && isfinite(ds) && ds > 0))
+      throw GeographicErr("GeodesicBuffer: bad R or ds");
+    blat.clear(); blon.clear();
+    vector<real> vlat, vlon;
+    for (size_t i = 0; i < n; ++i)
+      if (vlat.empty() || !(lat[i] == vlat.back() && lon[i] == vlon.back())) {
+        vlat.push_back(lat[i]); vlon.push_back(lon[i]);
+      }
+    if (vlat.empty()) return;
+    if (vlat.size() == 1) {
+      // A geodesic circle, traversed counter-clockwise
+      size_t m = max(size_t(3), size_t(ceil(2 * Math::pi() * R / ds)));
+      vector<real> clat(m, vlat[0]), clon(m, vlon[0]), cazi(m), d(m, R);
+      for (size_t k = 0; k < m; ++k)
+        cazi[k] = -Math::td * real(k) / m;
+      blat.resize(m); blon.resize(m);
+      GeodesicBatchExecutor exec(nthreads);
+      exec.Direct(_geod, m, clat.data(), clon.data(), cazi.data(),
+                  false, d.data(),
+                  Geodesic::LATITUDE | Geodesic::LONGITUDE,
+                  nullptr, blat.data(), blon.data(), nullptr,
+                  nullptr, nullptr, nullptr, nullptr, nullptr);
+      return;
+    }
+    Outline(vlat, vlon, false, R, ds, blat, blon, nthreads);
+  }
+
+  void GeodesicBuffer::Polygon(size_t n, const real lat[], const real lon[],
+                               real R, real ds,
+                               vector<real>& blat, vector<real>& blon,
+                               unsigned nthreads) const {
+    if (!(isfinite(R) && R > 0 && isfinite(ds) && ds > 0))
+      throw GeographicErr("GeodesicBuffer: bad R or ds");
+    blat.clear(); blon.clear();
+    vector<real> vlat, vlon;
+    for (size_t i = 0; i < n; ++i)
+      if (vlat.empty() || !(lat[i] == vlat.back() && lon[i] == vlon.back())) {
+        vlat.push_back(lat[i]); vlon.push_back(lon[i]);
+      }
+    while (vlat.size() > 1 &&
+           vlat.back() == vlat[0] && vlon.back() == vlon[0]) {
+      vlat.pop_back(); vlon.pop_back();
+    }
+    if (vlat.size() < 3) {
+      Polyline(vlat.size(), vlat.data(), vlon.data(), R, ds, blat, blon,
+               nthreads);
+      return;
+    }
+    // Make the polygon counter-clockwise
+    PolygonArea poly(_geod);
+    for (size_t i = 0; i < vlat.size(); ++i) poly.AddPoint(vlat[i], vlon[i]);
+    real perimeter, area;
+    poly.Compute(false, true, perimeter, area);
+    if (area < 0) {
+      reverse(vlat.begin(), vlat.end()); reverse(vlon.begin(), vlon.end());
+    }
+    Outline(vlat, vlon, true, R, ds, blat, blon, nthreads);
+  }
+
+} // namespace GeographicLib
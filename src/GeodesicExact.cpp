@@ -28,6 +28,7 @@
 
 #include <GeographicLib/GeodesicExact.hpp>
 #include <GeographicLib/GeodesicLineExact.hpp>
+#include <GeographicLib/SharedInstances.hpp>
 
 #if defined(_MSC_VER)
 // Squelch warnings about potentially uninitialized local variables,
@@ -345,7 +346,9 @@ namespace GeographicLib {
       10,10,10,10,10,10,10,10,10,10,11,11,11,11,11,11,11,11,11,11,11,12,12,12,
       12,12,12,13,13,13,13,13,13,13,14,14,14,15,15,15,16,16,17,18,19,20
     };
-#elif GEOGRAPHICLIB_PRECISION == 4
+#elif GEOGRAPHICLIB_PRECISION == 4 || GEOGRAPHICLIB_PRECISION == 6
+    // Use the table for quad precision for double-double (which has nearly
+    // the same precision).
     static const unsigned char narr[2*ndiv+1] = {
       25,24,22,21,20,19,19,18,18,17,17,17,17,16,16,16,15,15,15,15,15,15,15,14,
       14,14,14,14,14,13,13,13,13,13,13,13,13,13,13,13,13,12,12,12,12,12,12,12,
@@ -394,6 +397,12 @@ namespace GeographicLib {
     return wgs84;
   }
 
+  const GeodesicExact& GeodesicExact::Get(real a, real f) {
+    static SharedInstances<GeodesicExact> instances;
+    SharedInstances<GeodesicExact>::key_type key = {{a, f, 0, 0}};
+    return instances.Get(key, a, f);
+  }
+
   GeodesicLineExact GeodesicExact::Line(real lat1, real lon1, real azi1,
                                         unsigned caps) const {
     return GeodesicLineExact(*this, lat1, lon1, azi1, caps);
@@ -414,6 +423,45 @@ namespace GeographicLib {
                   lat2, lon2, azi2, s12, m12, M12, M21, S12);
   }
 
+  void GeodesicExact::DirectBatch(size_t n,
+                                  const real lat1[], const real lon1[],
+                                  const real azi1[],
+                                  bool arcmode, const real s12_a12[],
+                                  unsigned outmask,
+                                  real a12[], real lat2[], real lon2[],
+                                  real azi2[], real s12[], real m12[],
+                                  real M12[], real M21[], real S12[]) const {
+    // Keep only the quantities which have somewhere to go, together with the
+    // capabilities they need.  (GenDirect passes this mask to the
+    // GeodesicLine constructor so the capability bits cannot be stripped.)
+    unsigned mask = outmask & LONG_UNROLL;
+    if (lat2 && (outmask & OUT_MASK & LATITUDE)) mask |= LATITUDE;
+    if (lon2 && (outmask & OUT_MASK & LONGITUDE)) mask |= LONGITUDE;
+    if (azi2 && (outmask & OUT_MASK & AZIMUTH)) mask |= AZIMUTH;
+    if (s12 && (outmask & OUT_MASK & DISTANCE)) mask |= DISTANCE;
+    if (m12 && (outmask & OUT_MASK & REDUCEDLENGTH)) mask |= REDUCEDLENGTH;
+    if ((M12 || M21) && (outmask & OUT_MASK & GEODESICSCALE))
+      mask |= GEODESICSCALE;
+    if (S12 && (outmask & OUT_MASK & AREA)) mask |= AREA;
+    real lat2x, lon2x, azi2x, s12x, m12x, M12x, M21x, S12x;
+    for (size_t i = 0; i < n; ++i) {
+      real a12x = GenDirect(lat1[i], lon1[i], azi1[i], arcmode, s12_a12[i],
+                            mask, lat2x, lon2x, azi2x,
+                            s12x, m12x, M12x, M21x, S12x);
+      if (a12) a12[i] = a12x;
+      if (mask & (OUT_MASK & LATITUDE)) lat2[i] = lat2x;
+      if (mask & (OUT_MASK & LONGITUDE)) lon2[i] = lon2x;
+      if (mask & (OUT_MASK & AZIMUTH)) azi2[i] = azi2x;
+      if (mask & (OUT_MASK & DISTANCE)) s12[i] = s12x;
+      if (mask & (OUT_MASK & REDUCEDLENGTH)) m12[i] = m12x;
+      if (mask & (OUT_MASK & GEODESICSCALE)) {
+        if (M12) M12[i] = M12x;
+        if (M21) M21[i] = M21x;
+      }
+      if (mask & (OUT_MASK & AREA)) S12[i] = S12x;
+    }
+  }
+
   GeodesicLineExact GeodesicExact::GenDirectLine(real lat1, real lon1,
                                                  real azi1,
                                                  bool arcmode, real s12_a12,
@@ -740,9 +788,16 @@ namespace GeographicLib {
         Math::norm(ssig1, csig1);
         Math::norm(ssig2, csig2);
         I4Integrand i4(_ep2, k2);
-        vector<real> C4a(_nC4);
-        _fft.transform(i4, C4a.data());
-        S12 = A4 * DST::integral(ssig1, csig1, ssig2, csig2, C4a.data(), _nC4);
+        // Per-thread storage for the coefficients and the DST working space
+        // so that no heap allocation is needed after the first call.  The
+        // integrand is passed directly to the templated transform so that it
+        // can be inlined.
+        static thread_local vector<real> work;
+        if (int(work.size()) < _nC4 + _fft.scratchsize())
+          work.resize(_nC4 + _fft.scratchsize());
+        real* C4a = work.data();
+        _fft.transform(i4, C4a, C4a + _nC4);
+        S12 = A4 * DST::integral(ssig1, csig1, ssig2, csig2, C4a, _nC4);
       } else
         // Avoid problems with indeterminate sig1, sig2 on equator
         S12 = 0;
@@ -815,6 +870,42 @@ namespace GeographicLib {
     return a12;
   }
 
+  void GeodesicExact::InverseBatch(size_t n,
+                                   const real lat1[], const real lon1[],
+                                   const real lat2[], const real lon2[],
+                                   unsigned outmask,
+                                   real a12[], real s12[],
+                                   real azi1[], real azi2[],
+                                   real m12[], real M12[], real M21[],
+                                   real S12[]) const {
+    // Drop the quantities which have nowhere to go.  This saves the work of
+    // computing them (e.g., the area) and it lets the loop below use the
+    // mask alone to decide what to store.
+    outmask &= OUT_MASK;
+    if (!s12) outmask &= ~(OUT_MASK & DISTANCE);
+    if (!azi1 && !azi2) outmask &= ~(OUT_MASK & AZIMUTH);
+    if (!m12) outmask &= ~(OUT_MASK & REDUCEDLENGTH);
+    if (!M12 && !M21) outmask &= ~(OUT_MASK & GEODESICSCALE);
+    if (!S12) outmask &= ~(OUT_MASK & AREA);
+    real s12x, azi1x, azi2x, m12x, M12x, M21x, S12x;
+    for (size_t i = 0; i < n; ++i) {
+      real a12x = GenInverse(lat1[i], lon1[i], lat2[i], lon2[i], outmask,
+                             s12x, azi1x, azi2x, m12x, M12x, M21x, S12x);
+      if (a12) a12[i] = a12x;
+      if (outmask & DISTANCE) s12[i] = s12x;
+      if (outmask & AZIMUTH) {
+        if (azi1) azi1[i] = azi1x;
+        if (azi2) azi2[i] = azi2x;
+      }
+      if (outmask & REDUCEDLENGTH) m12[i] = m12x;
+      if (outmask & GEODESICSCALE) {
+        if (M12) M12[i] = M12x;
+        if (M21) M21[i] = M21x;
+      }
+      if (outmask & AREA) S12[i] = S12x;
+    }
+  }
+
   GeodesicLineExact GeodesicExact::InverseLine(real lat1, real lon1,
                                                real lat2, real lon2,
                                                unsigned caps) const {
@@ -978,7 +1069,13 @@ namespace GeographicLib {
       sig12 = atan2(ssig12, csig12);
     } else if (fabs(_n) > real(0.1) || // Skip astroid calc if too eccentric
                csig12 >= 0 ||
-               ssig12 >= 6 * fabs(_n) * Math::pi() * Math::sq(cbet1)) {
+               // The astroid estimate is better than the spherical one well
+               // beyond the region where the astroid problem is accurate.
+               // For WGS84 and points within 10deg of antipodal, raising the
+               // multiplier from 6 to 48 reduces the mean number of Newton
+               // iterations from 3.4 to 2.8 and the number needing 5 or more
+               // from 2% to 0.02%.
+               ssig12 >= 48 * fabs(_n) * Math::pi() * Math::sq(cbet1)) {
       // Nothing to do, zeroth order spherical approximation is OK
     } else {
       // Scale lam12 and bet2 to x, y coordinate system where antipodal point
@@ -41,7 +41,22 @@ namespace GeographicLib {
                               real lat1, real lon1,
                               real azi1, real salp1, real calp1,
                               unsigned caps) {
+    lat1 = Math::LatFix(lat1);
+    real cbet1, sbet1;
+    Math::sincosdInline(Math::AngRound(lat1), sbet1, cbet1); sbet1 *= g._f1;
+    // Ensure cbet1 = +epsilon at poles
+    Math::norm(sbet1, cbet1); cbet1 = fmax(g.tiny_, cbet1);
+    LineInit(g, lat1, lon1, azi1, salp1, calp1,
+             sbet1, cbet1, sqrt(1 + g._ep2 * Math::sq(sbet1)), caps);
+  }
+
+  void GeodesicLine::LineInit(const Geodesic& g,
+                              real lat1, real lon1,
+                              real azi1, real salp1, real calp1,
+                              real sbet1, real cbet1, real dn1,
+                              unsigned caps) {
     tiny_ = g.tiny_;
+    _order = g._order;
     _lat1 = Math::LatFix(lat1);
     _lon1 = lon1;
     _azi1 = azi1;
@@ -55,11 +70,7 @@ namespace GeographicLib {
     // Always allow latitude and azimuth and unrolling of longitude
     _caps = caps | LATITUDE | AZIMUTH | LONG_UNROLL;
 
-    real cbet1, sbet1;
-    Math::sincosd(Math::AngRound(_lat1), sbet1, cbet1); sbet1 *= _f1;
-    // Ensure cbet1 = +epsilon at poles
-    Math::norm(sbet1, cbet1); cbet1 = fmax(tiny_, cbet1);
-    _dn1 = sqrt(1 + g._ep2 * Math::sq(sbet1));
+    _dn1 = dn1;
 
     // Evaluate alp0 from sin(alp1) * cos(bet1) = sin(alp0),
     _salp0 = _salp1 * cbet1; // alp0 in [0, pi/2 - |bet1|]
@@ -84,37 +95,37 @@ namespace GeographicLib {
     real eps = _k2 / (2 * (1 + sqrt(1 + _k2)) + _k2);
 
     if (_caps & CAP_C1) {
-      _aA1m1 = Geodesic::A1m1f(eps);
-      Geodesic::C1f(eps, _cC1a);
-      _bB11 = Geodesic::SinCosSeries(true, _ssig1, _csig1, _cC1a, nC1_);
+      _aA1m1 = g.A1m1f(eps);
+      g.C1f(eps, _cC1a);
+      _bB11 = Geodesic::SinCosSeries(true, _ssig1, _csig1, _cC1a, _order);
       real s = sin(_bB11), c = cos(_bB11);
       // tau1 = sig1 + B11
       _stau1 = _ssig1 * c + _csig1 * s;
       _ctau1 = _csig1 * c - _ssig1 * s;
       // Not necessary because C1pa reverts C1a
-      //    _bB11 = -SinCosSeries(true, _stau1, _ctau1, _cC1pa, nC1p_);
+      //    _bB11 = -SinCosSeries(true, _stau1, _ctau1, _cC1pa, _order);
     }
 
     if (_caps & CAP_C1p)
-      Geodesic::C1pf(eps, _cC1pa);
+      g.C1pf(eps, _cC1pa);
 
     if (_caps & CAP_C2) {
-      _aA2m1 = Geodesic::A2m1f(eps);
-      Geodesic::C2f(eps, _cC2a);
-      _bB21 = Geodesic::SinCosSeries(true, _ssig1, _csig1, _cC2a, nC2_);
+      _aA2m1 = g.A2m1f(eps);
+      g.C2f(eps, _cC2a);
+      _bB21 = Geodesic::SinCosSeries(true, _ssig1, _csig1, _cC2a, _order);
     }
 
     if (_caps & CAP_C3) {
       g.C3f(eps, _cC3a);
       _aA3c = -_f * _salp0 * g.A3f(eps);
-      _bB31 = Geodesic::SinCosSeries(true, _ssig1, _csig1, _cC3a, nC3_-1);
+      _bB31 = Geodesic::SinCosSeries(true, _ssig1, _csig1, _cC3a, _order-1);
     }
 
     if (_caps & CAP_C4) {
       g.C4f(eps, _cC4a);
       // Multiplier = a^2 * e^2 * cos(alpha0) * sin(alpha0)
       _aA4 = Math::sq(_a) * _calp0 * _salp0 * g._e2;
-      _bB41 = Geodesic::SinCosSeries(false, _ssig1, _csig1, _cC4a, nC4_);
+      _bB41 = Geodesic::SinCosSeries(false, _ssig1, _csig1, _cC4a, _order);
     }
 
     _a13 = _s13 = Math::NaN();
@@ -123,10 +134,10 @@ namespace GeographicLib {
   GeodesicLine::GeodesicLine(const Geodesic& g,
                              real lat1, real lon1, real azi1,
                              unsigned caps) {
-    azi1 = Math::AngNormalize(azi1);
+    azi1 = Math::AngNormalizeInline(azi1);
     real salp1, calp1;
     // Guard against underflow in salp0.  Also -0 is converted to +0.
-    Math::sincosd(Math::AngRound(azi1), salp1, calp1);
+    Math::sincosdInline(Math::AngRound(azi1), salp1, calp1);
     LineInit(g, lat1, lon1, azi1, salp1, calp1, caps);
   }
 
@@ -150,66 +161,82 @@ namespace GeographicLib {
       return Math::NaN();
 
     // Avoid warning about uninitialized B12.
-    real sig12, ssig12, csig12, B12 = 0, AB1 = 0;
+    real sig12, ssig12, csig12, B12 = 0;
     if (arcmode) {
       // Interpret s12_a12 as spherical arc length
       sig12 = s12_a12 * Math::degree();
-      Math::sincosd(s12_a12, ssig12, csig12);
+      Math::sincosdInline(s12_a12, ssig12, csig12);
     } else {
       // Interpret s12_a12 as distance
       real
         tau12 = s12_a12 / (_b * (1 + _aA1m1)),
         s = sin(tau12),
         c = cos(tau12);
-      // tau2 = tau1 + tau12
-      B12 = - Geodesic::SinCosSeries(true,
-                                     _stau1 * c + _ctau1 * s,
-                                     _ctau1 * c - _stau1 * s,
-                                     _cC1pa, nC1p_);
-      sig12 = tau12 - (B12 - _bB11);
+      DistanceArc(s12_a12, tau12, s, c, sig12, ssig12, csig12, B12);
+    }
+    return ArcPosition(arcmode, s12_a12, sig12, ssig12, csig12, B12, outmask,
+                       lat2, lon2, azi2, s12, m12, M12, M21, S12);
+  }
+
+  void GeodesicLine::DistanceArc(real s12, real tau12, real s, real c,
+                                 real& sig12, real& ssig12, real& csig12,
+                                 real& B12) const {
+    // tau2 = tau1 + tau12
+    B12 = - Geodesic::SinCosSeries(true,
+                                   _stau1 * c + _ctau1 * s,
+                                   _ctau1 * c - _stau1 * s,
+                                   _cC1pa, _order);
+    sig12 = tau12 - (B12 - _bB11);
+    ssig12 = sin(sig12); csig12 = cos(sig12);
+    if (fabs(_f) > 0.01) {
+      // Reverted distance series is inaccurate for |f| > 1/100, so correct
+      // sig12 with 1 Newton iteration.  The following table shows the
+      // approximate maximum error for a = WGS_a() and various f relative to
+      // GeodesicExact.
+      //     erri = the error in the inverse solution (nm)
+      //     errd = the error in the direct solution (series only) (nm)
+      //     errda = the error in the direct solution
+      //             (series + 1 Newton) (nm)
+      //
+      //       f     erri  errd errda
+      //     -1/5    12e6 1.2e9  69e6
+      //     -1/10  123e3  12e6 765e3
+      //     -1/20   1110 108e3  7155
+      //     -1/50  18.63 200.9 27.12
+      //     -1/100 18.63 23.78 23.37
+      //     -1/150 18.63 21.05 20.26
+      //      1/150 22.35 24.73 25.83
+      //      1/100 22.35 25.03 25.31
+      //      1/50  29.80 231.9 30.44
+      //      1/20   5376 146e3  10e3
+      //      1/10  829e3  22e6 1.5e6
+      //      1/5   157e6 3.8e9 280e6
+      real
+        ssig2 = _ssig1 * csig12 + _csig1 * ssig12,
+        csig2 = _csig1 * csig12 - _ssig1 * ssig12;
+      B12 = Geodesic::SinCosSeries(true, ssig2, csig2, _cC1a, _order);
+      real serr = (1 + _aA1m1) * (sig12 + (B12 - _bB11)) - s12 / _b;
+      sig12 = sig12 - serr / sqrt(1 + _k2 * Math::sq(ssig2));
       ssig12 = sin(sig12); csig12 = cos(sig12);
-      if (fabs(_f) > 0.01) {
-        // Reverted distance series is inaccurate for |f| > 1/100, so correct
-        // sig12 with 1 Newton iteration.  The following table shows the
-        // approximate maximum error for a = WGS_a() and various f relative to
-        // GeodesicExact.
-        //     erri = the error in the inverse solution (nm)
-        //     errd = the error in the direct solution (series only) (nm)
-        //     errda = the error in the direct solution
-        //             (series + 1 Newton) (nm)
-        //
-        //       f     erri  errd errda
-        //     -1/5    12e6 1.2e9  69e6
-        //     -1/10  123e3  12e6 765e3
-        //     -1/20   1110 108e3  7155
-        //     -1/50  18.63 200.9 27.12
-        //     -1/100 18.63 23.78 23.37
-        //     -1/150 18.63 21.05 20.26
-        //      1/150 22.35 24.73 25.83
-        //      1/100 22.35 25.03 25.31
-        //      1/50  29.80 231.9 30.44
-        //      1/20   5376 146e3  10e3
-        //      1/10  829e3  22e6 1.5e6
-        //      1/5   157e6 3.8e9 280e6
-        real
-          ssig2 = _ssig1 * csig12 + _csig1 * ssig12,
-          csig2 = _csig1 * csig12 - _ssig1 * ssig12;
-        B12 = Geodesic::SinCosSeries(true, ssig2, csig2, _cC1a, nC1_);
-        real serr = (1 + _aA1m1) * (sig12 + (B12 - _bB11)) - s12_a12 / _b;
-        sig12 = sig12 - serr / sqrt(1 + _k2 * Math::sq(ssig2));
-        ssig12 = sin(sig12); csig12 = cos(sig12);
-        // Update B12 below
-      }
+      // Update B12 below
     }
+  }
 
-    real ssig2, csig2, sbet2, cbet2, salp2, calp2;
+  Math::real GeodesicLine::ArcPosition(bool arcmode, real s12_a12,
+                                       real sig12, real ssig12, real csig12,
+                                       real B12, unsigned outmask,
+                                       real& lat2, real& lon2, real& azi2,
+                                       real& s12, real& m12,
+                                       real& M12, real& M21,
+                                       real& S12) const {
+    real AB1 = 0, ssig2, csig2, sbet2, cbet2, salp2, calp2;
     // sig2 = sig1 + sig12
     ssig2 = _ssig1 * csig12 + _csig1 * ssig12;
     csig2 = _csig1 * csig12 - _ssig1 * ssig12;
     real dn2 = sqrt(1 + _k2 * Math::sq(ssig2));
     if (outmask & (DISTANCE | REDUCEDLENGTH | GEODESICSCALE)) {
       if (arcmode || fabs(_f) > 0.01)
-        B12 = Geodesic::SinCosSeries(true, ssig2, csig2, _cC1a, nC1_);
+        B12 = Geodesic::SinCosSeries(true, ssig2, csig2, _cC1a, _order);
       AB1 = (1 + _aA1m1) * (B12 - _bB11);
     }
     // sin(bet2) = cos(alp0) * sin(sig2)
@@ -237,23 +264,23 @@ namespace GeographicLib {
         : atan2(somg2 * _comg1 - comg2 * _somg1,
                 comg2 * _comg1 + somg2 * _somg1);
       real lam12 = omg12 + _aA3c *
-        ( sig12 + (Geodesic::SinCosSeries(true, ssig2, csig2, _cC3a, nC3_-1)
+        ( sig12 + (Geodesic::SinCosSeries(true, ssig2, csig2, _cC3a, _order-1)
                    - _bB31));
       real lon12 = lam12 / Math::degree();
       lon2 = outmask & LONG_UNROLL ? _lon1 + lon12 :
-        Math::AngNormalize(Math::AngNormalize(_lon1) +
-                           Math::AngNormalize(lon12));
+        Math::AngNormalizeInline(Math::AngNormalizeInline(_lon1) +
+                           Math::AngNormalizeInline(lon12));
     }
 
     if (outmask & LATITUDE)
-      lat2 = Math::atan2d(sbet2, _f1 * cbet2);
+      lat2 = Math::atan2dInline(sbet2, _f1 * cbet2);
 
     if (outmask & AZIMUTH)
-      azi2 = Math::atan2d(salp2, calp2);
+      azi2 = Math::atan2dInline(salp2, calp2);
 
     if (outmask & (REDUCEDLENGTH | GEODESICSCALE)) {
       real
-        B22 = Geodesic::SinCosSeries(true, ssig2, csig2, _cC2a, nC2_),
+        B22 = Geodesic::SinCosSeries(true, ssig2, csig2, _cC2a, _order),
         AB2 = (1 + _aA2m1) * (B22 - _bB21),
         J12 = (_aA1m1 - _aA2m1) * sig12 + (AB1 - AB2);
       if (outmask & REDUCEDLENGTH)
@@ -270,7 +297,7 @@ namespace GeographicLib {
 
     if (outmask & AREA) {
       real
-        B42 = Geodesic::SinCosSeries(false, ssig2, csig2, _cC4a, nC4_);
+        B42 = Geodesic::SinCosSeries(false, ssig2, csig2, _cC4a, _order);
       real salp12, calp12;
       if (_calp0 == 0 || _salp0 == 0) {
         // alp12 = alp2 - alp1, used in atan2 so no need to normalize
@@ -303,6 +330,169 @@ namespace GeographicLib {
     return arcmode ? s12_a12 : sig12 / Math::degree();
   }
 
+  void GeodesicLine::PositionBatch(size_t n, bool arcmode,
+                                   const real s12_a12[],
+                                   unsigned outmask,
+                                   real a12[], real lat2[], real lon2[],
+                                   real azi2[], real s12[], real m12[],
+                                   real M12[], real M21[], real S12[]) const {
+    outmask &= OUT_MASK;
+    if (!lat2) outmask &= ~(OUT_MASK & LATITUDE);
+    if (!lon2) outmask &= ~(OUT_MASK & LONGITUDE);
+    if (!azi2) outmask &= ~(OUT_MASK & AZIMUTH);
+    if (!s12) outmask &= ~(OUT_MASK & DISTANCE);
+    if (!m12) outmask &= ~(OUT_MASK & REDUCEDLENGTH);
+    if (!M12 && !M21) outmask &= ~(OUT_MASK & GEODESICSCALE);
+    if (!S12) outmask &= ~(OUT_MASK & AREA);
+    // Don't store the quantities GenPosition leaves untouched.
+    outmask &= _caps;
+    if (!(arcmode || (_caps & (OUT_MASK & DISTANCE_IN)))) outmask = 0;
+    real lat2x, lon2x, azi2x, s12x, m12x, M12x, M21x, S12x;
+    for (size_t i = 0; i < n; ++i) {
+      real a12x = GenPosition(arcmode, s12_a12[i], outmask,
+                              lat2x, lon2x, azi2x,
+                              s12x, m12x, M12x, M21x, S12x);
+      if (a12) a12[i] = a12x;
+      if (outmask & LATITUDE) lat2[i] = lat2x;
+      if (outmask & LONGITUDE) lon2[i] = lon2x;
+      if (outmask & AZIMUTH) azi2[i] = azi2x;
+      if (outmask & DISTANCE) s12[i] = s12x;
+      if (outmask & REDUCEDLENGTH) m12[i] = m12x;
+      if (outmask & GEODESICSCALE) {
+        if (M12) M12[i] = M12x;
+        if (M21) M21[i] = M21x;
+      }
+      if (outmask & AREA) S12[i] = S12x;
+    }
+  }
+
+  void GeodesicLine::Waypoints(size_t n, bool arcmode, unsigned outmask,
+                               real a12[], real lat2[], real lon2[],
+                               real azi2[], real s12[], real m12[],
+                               real M12[], real M21[], real S12[]) const {
+    outmask &= OUT_MASK;
+    if (!lat2) outmask &= ~(OUT_MASK & LATITUDE);
+    if (!lon2) outmask &= ~(OUT_MASK & LONGITUDE);
+    if (!azi2) outmask &= ~(OUT_MASK & AZIMUTH);
+    if (!s12) outmask &= ~(OUT_MASK & DISTANCE);
+    if (!m12) outmask &= ~(OUT_MASK & REDUCEDLENGTH);
+    if (!M12 && !M21) outmask &= ~(OUT_MASK & GEODESICSCALE);
+    if (!S12) outmask &= ~(OUT_MASK & AREA);
+    outmask &= _caps;
+    if (!( Init() && (arcmode || (_caps & (OUT_MASK & DISTANCE_IN))) )) {
+      // Uninitialized or impossible distance calculation requested
+      if (a12)
+        for (size_t i = 0; i < n; ++i) a12[i] = Math::NaN();
+      return;
+    }
+    // The recurrence is restarted every nstep points
+    const size_t nstep = 64;
+    real
+      x13 = arcmode ? _a13 : _s13,
+      dx = n > 1 ? x13 / real(n - 1) : 0,
+      // Convert x to the angle, sig12 or tau12, as in GenPosition
+      b1 = _b * (1 + _aA1m1),
+      dt = arcmode ? dx * Math::degree() : dx / b1,
+      // Coefficients for the recurrence for the sine and cosine of the angle
+      // after a step, s' = s - (alpha * s - beta * c) and c' = c - (alpha * c
+      // + beta * s), where alpha = 2 * sin(dt/2)^2 and beta = sin(dt).  This
+      // form limits the effect of roundoff when dt is small.
+      alpha = 2 * Math::sq(sin(dt / 2)),
+      beta = sin(dt),
+      s = 0, c = 1;
+    real lat2x, lon2x, azi2x, s12x, m12x, M12x, M21x, S12x;
+    for (size_t i = 0; i < n; ++i) {
+      real x = i + 1 == n && n > 1 ? x13 : real(i) * dx;
+      if (i % nstep == 0 || i + 1 == n) {
+        if (arcmode)
+          Math::sincosd(x, s, c);
+        else {
+          s = sin(x / b1); c = cos(x / b1);
+        }
+      } else {
+        real t = s - (alpha * s - beta * c);
+        c -= alpha * c + beta * s;
+        s = t;
+      }
+      real sig12, ssig12, csig12, B12 = 0;
+      if (arcmode) {
+        sig12 = x * Math::degree(); ssig12 = s; csig12 = c;
+      } else
+        DistanceArc(x, x / b1, s, c, sig12, ssig12, csig12, B12);
+      real a12x = ArcPosition(arcmode, x, sig12, ssig12, csig12, B12,
+                              outmask, lat2x, lon2x, azi2x,
+                              s12x, m12x, M12x, M21x, S12x);
+      if (a12) a12[i] = a12x;
+      if (outmask & LATITUDE) lat2[i] = lat2x;
+      if (outmask & LONGITUDE) lon2[i] = lon2x;
+      if (outmask & AZIMUTH) azi2[i] = azi2x;
+      if (outmask & DISTANCE) s12[i] = s12x;
+      if (outmask & REDUCEDLENGTH) m12[i] = m12x;
+      if (outmask & GEODESICSCALE) {
+        if (M12) M12[i] = M12x;
+        if (M21) M21[i] = M21x;
+      }
+      if (outmask & AREA) S12[i] = S12x;
+    }
+  }
+
+  Math::real GeodesicLine::VertexLatitude() const {
+    // tan(bet0) = |calp0|/|salp0| and tan(phi) = tan(bet)/f1
+    return Init() ? Math::atan2d(fabs(_calp0), _f1 * fabs(_salp0)) :
+      Math::NaN();
+  }
+
+  void GeodesicLine::GenBoundingBox(bool arcmode, real s1_a1, real s2_a2,
+                                    real& latmin, real& latmax,
+                                    real& lonmin, real& lonmax) const {
+    using std::isnan;
+    latmin = latmax = lonmin = lonmax = Math::NaN();
+    if (!(_caps & CAP_MASK & LONGITUDE)) return;
+    real lat1, lon1, lat2, lon2, t;
+    unsigned outmask = LATITUDE | LONGITUDE | LONG_UNROLL;
+    real
+      a1 = GenPosition(arcmode, s1_a1, outmask, lat1, lon1, t, t, t, t, t, t),
+      a2 = GenPosition(arcmode, s2_a2, outmask, lat2, lon2, t, t, t, t, t, t);
+    if (isnan(a1 + a2)) return;
+    if (a1 > a2) { swap(a1, a2); swap(lat1, lat2); swap(lon1, lon2); }
+    latmin = fmin(lat1, lat2); latmax = fmax(lat1, lat2);
+    // The vertices are at sig = 90 + 180*k (degrees) where sbet = calp0 *
+    // ssig = +/-calp0.  Consecutive vertices alternate between north and
+    // south, so at most two need to be examined.
+    real sig1 = Math::atan2d(_ssig1, _csig1), lat0 = VertexLatitude(),
+      k0 = ceil((sig1 + a1 - Math::qd) / Math::hd);
+    for (real k = k0; k < k0 + 2 && Math::qd + k * Math::hd <= sig1 + a2; ++k)
+      if ((_calp0 < 0) == (fmod(k, real(2)) != 0))
+        latmax = fmax(latmax, lat0);
+      else
+        latmin = fmin(latmin, -lat0);
+    // The longitude is monotonic and lon2 - lon1 is unrolled.
+    real dlon = fabs(lon2 - lon1);
+    if (dlon >= Math::td) {
+      lonmin = -Math::hd; lonmax = Math::hd;
+    } else {
+      lonmin = Math::AngNormalize(fmin(lon1, lon2));
+      lonmax = lonmin + dlon;
+    }
+  }
+
+  void GeodesicLine::GenBoundingCap(bool arcmode, real s1_a1, real s2_a2,
+                                    real& lat0, real& lon0, real& r) const {
+    lat0 = lon0 = r = Math::NaN();
+    if (!(_caps & CAP_MASK & LONGITUDE)) return;
+    real s1 = Math::NaN(), s2 = Math::NaN(), t;
+    if (arcmode) {
+      GenPosition(true, s1_a1, DISTANCE, t, t, t, s1, t, t, t, t);
+      GenPosition(true, s2_a2, DISTANCE, t, t, t, s2, t, t, t, t);
+    } else {
+      s1 = s1_a1; s2 = s2_a2;
+    }
+    // lat0 and lon0 remain NaN if there's no DISTANCE_IN capability
+    GenPosition(false, (s1 + s2) / 2, LATITUDE | LONGITUDE,
+                lat0, lon0, t, t, t, t, t, t);
+    r = fabs(s2 - s1) / 2;
+  }
+
   void GeodesicLine::SetDistance(real s13) {
     _s13 = s13;
     real t;
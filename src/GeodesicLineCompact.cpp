@@ -0,0 +1,65 @@
+/**
+ * \file GeodesicLineCompact.cpp
+ * \brief Implementation for GeographicLib::GeodesicLineCompact class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#include <GeographicLib/GeodesicLineCompact.hpp>
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  GeodesicLineCompact::GeodesicLineCompact(const Geodesic& g,
+                                           real lat1, real lon1, real azi1,
+                                           unsigned caps)
+    : _g(&g)
+  {
+    // Keep the quantities which the GeodesicLine constructor would.
+    GeodesicLine l(g, lat1, lon1, azi1, caps);
+    _lat1 = l._lat1; _lon1 = l._lon1; _azi1 = l._azi1;
+    _salp1 = l._salp1; _calp1 = l._calp1;
+    _a13 = l._a13; _s13 = l._s13;
+    _caps = l._caps;
+  }
+
+  GeodesicLineCompact::GeodesicLineCompact(const Geodesic& g,
+                                           const GeodesicLine& l)
+    : _g(&g)
+    , _lat1(l._lat1)
+    , _lon1(l._lon1)
+    , _azi1(l._azi1)
+    , _salp1(l._salp1)
+    , _calp1(l._calp1)
+    , _a13(l._a13)
+    , _s13(l._s13)
+    , _caps(l._caps)
+  {
+    if (l.Init() &&
+        !(l._a == g.EquatorialRadius() && l._f == g.Flattening()))
+      throw GeographicErr("GeodesicLine and Geodesic have different "
+                          "ellipsoids");
+  }
+
+  GeodesicLine GeodesicLineCompact::Line() const {
+    GeodesicLine l;
+    if (Init()) {
+      l.LineInit(*_g, _lat1, _lon1, _azi1, _salp1, _calp1, _caps);
+      // Copy both rather than recomputing one from the other, so that they
+      // are exactly those of the original line.
+      l._a13 = _a13; l._s13 = _s13;
+    }
+    return l;
+  }
+
+  void GeodesicLineCompact::GenSetDistance(bool arcmode, real s13_a13) {
+    if (!Init()) return;
+    GeodesicLine l(Line());
+    l.GenSetDistance(arcmode, s13_a13);
+    _a13 = l._a13; _s13 = l._s13;
+  }
+
+} // namespace GeographicLib
@@ -274,6 +274,43 @@ namespace GeographicLib {
     return arcmode ? s12_a12 : sig12 / Math::degree();
   }
 
+  void GeodesicLineExact::PositionBatch(size_t n, bool arcmode,
+                                        const real s12_a12[],
+                                        unsigned outmask,
+                                        real a12[], real lat2[], real lon2[],
+                                        real azi2[], real s12[], real m12[],
+                                        real M12[], real M21[], real S12[])
+    const {
+    outmask &= OUT_MASK;
+    if (!lat2) outmask &= ~(OUT_MASK & LATITUDE);
+    if (!lon2) outmask &= ~(OUT_MASK & LONGITUDE);
+    if (!azi2) outmask &= ~(OUT_MASK & AZIMUTH);
+    if (!s12) outmask &= ~(OUT_MASK & DISTANCE);
+    if (!m12) outmask &= ~(OUT_MASK & REDUCEDLENGTH);
+    if (!M12 && !M21) outmask &= ~(OUT_MASK & GEODESICSCALE);
+    if (!S12) outmask &= ~(OUT_MASK & AREA);
+    // Don't store the quantities GenPosition leaves untouched.
+    outmask &= _caps;
+    if (!(arcmode || (_caps & (OUT_MASK & DISTANCE_IN)))) outmask = 0;
+    real lat2x, lon2x, azi2x, s12x, m12x, M12x, M21x, S12x;
+    for (size_t i = 0; i < n; ++i) {
+      real a12x = GenPosition(arcmode, s12_a12[i], outmask,
+                              lat2x, lon2x, azi2x,
+                              s12x, m12x, M12x, M21x, S12x);
+      if (a12) a12[i] = a12x;
+      if (outmask & LATITUDE) lat2[i] = lat2x;
+      if (outmask & LONGITUDE) lon2[i] = lon2x;
+      if (outmask & AZIMUTH) azi2[i] = azi2x;
+      if (outmask & DISTANCE) s12[i] = s12x;
+      if (outmask & REDUCEDLENGTH) m12[i] = m12x;
+      if (outmask & GEODESICSCALE) {
+        if (M12) M12[i] = M12x;
+        if (M21) M21[i] = M21x;
+      }
+      if (outmask & AREA) S12[i] = S12x;
+    }
+  }
+
   void GeodesicLineExact::SetDistance(real s13) {
     _s13 = s13;
     real t;
@@ -0,0 +1,124 @@
+/**
+ * \file GeodesicRegion.cpp
+ * \brief Implementation for GeographicLib::GeodesicRegion class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#include <GeographicLib/GeodesicRegion.hpp>
+#include <GeographicLib/GeodesicLine.hpp>
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  GeodesicRegion::GeodesicRegion(const Geodesic& geod,
+                                 real lat0, real lon0, real r)
+    : _geod(geod)
+    , _ell(geod.EquatorialRadius(), geod.Flattening())
+    , _earth(geod.EquatorialRadius(), geod.Flattening())
+    , _polygon(false)
+    , _lat0(lat0)
+    , _lon0(lon0)
+    , _r(r)
+    , _pip(geod, 0, nullptr, nullptr)
+    , _closest(geod)
+  {}
+
+  GeodesicRegion::GeodesicRegion(const Geodesic& geod, size_t n,
+                                 const real lat[], const real lon[])
+    : _geod(geod)
+    , _ell(geod.EquatorialRadius(), geod.Flattening())
+    , _earth(geod.EquatorialRadius(), geod.Flattening())
+    , _polygon(true)
+    , _lat0(Math::NaN())
+    , _lon0(Math::NaN())
+    , _r(Math::NaN())
+    , _caps(n < 3 ? 0 : n)
+    , _pip(geod, n, lat, lon)
+    , _closest(geod)
+  {
+    for (size_t i = 0; i < _caps.size(); ++i) {
+      size_t j = i + 1 < n ? i + 1 : 0;
+      Cap& cap = _caps[i];
+      GeodesicLine line =
+        _geod.InverseLine(lat[i], lon[i], lat[j], lon[j],
+                          Geodesic::LATITUDE | Geodesic::LONGITUDE |
+                          Geodesic::DISTANCE_IN);
+      real latc, lonc;
+      line.BoundingCap(0, line.Distance(), latc, lonc, cap.r);
+      _earth.Forward(latc, lonc, 0, cap.X, cap.Y, cap.Z);
+      cap.lat1 = lat[i]; cap.lon1 = lon[i];
+      cap.lat2 = lat[j]; cap.lon2 = lon[j];
+    }
+  }
+
+  GeodesicRegion::classification
+  GeodesicRegion::Classify(real lat1, real lat2, real lon1, real lon2) const {
+    // The center of the box and a bound on the distance from the center to
+    // any point of the box: follow the parallel through the center and then
+    // a meridian.
+    real
+      latm = (lat1 + lat2) / 2, lonm = (lon1 + lon2) / 2,
+      sm = _ell.MeridianDistance(latm),
+      R = fmax(sm - _ell.MeridianDistance(lat1),
+               _ell.MeridianDistance(lat2) - sm) +
+      (lon2 - lon1) / 2 * Math::degree() * _ell.CircleRadius(latm);
+    if (!_polygon) {
+      real s;
+      _geod.Inverse(_lat0, _lon0, latm, lonm, s);
+      return s - R > _r ? OUTSIDE : (s + R < _r ? INSIDE : PARTIAL);
+    }
+    if (_caps.empty()) return OUTSIDE;
+    real X, Y, Z;
+    _earth.Forward(latm, lonm, 0, X, Y, Z);
+    for (const Cap& c : _caps) {
+      // The chord to the center of the cap less the radius of the cap is a
+      // lower bound on the distance to the edge.
+      real dX = X - c.X, dY = Y - c.Y, dZ = Z - c.Z;
+      if (sqrt(dX * dX + dY * dY + dZ * dZ) - c.r > R) continue;
+      real x;
+      if (_closest.Segment(latm, lonm, c.lat1, c.lon1, c.lat2, c.lon2, x)
+          <= R)
+        return PARTIAL;
+    }
+    return _pip.Contains(latm, lonm) ? INSIDE : OUTSIDE;
+  }
+
+  void GeodesicRegion::Descend(const Level levels[], int nlevels, int k,
+                               real lat1, real lon1, real dlat, real dlon,
+                               bool inside, encoder encode, bool compact,
+                               vector<string>& cells) const {
+    // Visit the cells at level k in the box with southwest corner (lat1,
+    // lon1) and dimensions dlat x dlon.
+    const Level& l = levels[k];
+    dlat /= l.nlat; dlon /= l.nlon;
+    bool last = k + 1 == nlevels;
+    for (int i = 0; i < l.nlat; ++i) {
+      real lata = lat1 + i * dlat, latb = lata + dlat;
+      for (int j = 0; j < l.nlon; ++j) {
+        real lona = lon1 + j * dlon;
+        int c = inside ? INSIDE : Classify(lata, latb, lona, lona + dlon);
+        if (c == OUTSIDE) continue;
+        if (last || (c == INSIDE && compact && l.emit)) {
+          cells.push_back(string());
+          encode(lata + dlat / 2, lona + dlon / 2, l.prec, cells.back());
+        } else
+          Descend(levels, nlevels, k + 1, lata, lona, dlat, dlon,
+                  c == INSIDE, encode, compact, cells);
+      }
+    }
+  }
+
+  void GeodesicRegion::Cover(const Level levels[], int nlevels,
+                             encoder encode, bool compact,
+                             vector<string>& cells) const {
+    cells.clear();
+    if (nlevels > 0)
+      Descend(levels, nlevels, 0, -Math::qd, -Math::hd, 2 * Math::qd,
+              Math::td, false, encode, compact, cells);
+  }
+
+} // namespace GeographicLib
@@ -9,6 +9,8 @@
 
 #include <GeographicLib/Geohash.hpp>
 #include <GeographicLib/Utility.hpp>
+#include <GeographicLib/GeodesicRegion.hpp>
+#include <cstring>
 
 #if defined(_MSC_VER)
 // Squelch warnings about enum-float expressions
@@ -22,7 +24,54 @@ namespace GeographicLib {
   const char* const Geohash::lcdigits_ = "0123456789bcdefghjkmnpqrstuvwxyz";
   const char* const Geohash::ucdigits_ = "0123456789BCDEFGHJKMNPQRSTUVWXYZ";
 
+  namespace {
+
+    // Spread the bits of a 32-bit number into the even bits of a 64-bit
+    // number.
+    inline unsigned long long spread(unsigned long long x) {
+      x = (x | (x << 16)) & 0x0000ffff0000ffffULL;
+      x = (x | (x <<  8)) & 0x00ff00ff00ff00ffULL;
+      x = (x | (x <<  4)) & 0x0f0f0f0f0f0f0f0fULL;
+      x = (x | (x <<  2)) & 0x3333333333333333ULL;
+      return (x | (x << 1)) & 0x5555555555555555ULL;
+    }
+
+    // The inverse of spread: gather the even bits of x.
+    inline unsigned long long compact(unsigned long long x) {
+      x &= 0x5555555555555555ULL;
+      x = (x | (x >>  1)) & 0x3333333333333333ULL;
+      x = (x | (x >>  2)) & 0x0f0f0f0f0f0f0f0fULL;
+      x = (x | (x >>  4)) & 0x00ff00ff00ff00ffULL;
+      x = (x | (x >>  8)) & 0x0000ffff0000ffffULL;
+      return (x | (x >> 16)) & 0x00000000ffffffffULL;
+    }
+
+    // Map characters (of either case) to their geohash digit values; -1 for
+    // illegal characters.
+    class digitmap {
+      signed char _val[256];
+    public:
+      explicit digitmap(const char* digits) {
+        fill(_val, _val + 256, -1);
+        for (int k = 0; digits[k]; ++k) {
+          _val[(unsigned char)(digits[k])] = (signed char)(k);
+          _val[(unsigned char)(tolower(digits[k]))] = (signed char)(k);
+        }
+        // Utility::lookup matches a null with the terminator of digits; the
+        // resulting value, 32, contributes no bits.
+        _val[0] = 0;
+      }
+      int operator()(char c) const { return _val[(unsigned char)(c)]; }
+    };
+
+  }
+
   void Geohash::Forward(real lat, real lon, int len, string& geohash) {
+    char geohash1[MAXLENGTH + 1];
+    geohash.assign(geohash1, Forward(lat, lon, len, geohash1));
+  }
+
+  int Geohash::Forward(real lat, real lon, int len, char geohash[]) {
     using std::isnan;           // Needed for Centos 7, ubuntu 14
     static const real shift = ldexp(real(1), 45);
     static const real loneps = Math::hd / shift;
@@ -32,8 +81,8 @@ namespace GeographicLib {
                           + "d not in [-" + to_string(Math::qd)
                           + "d, " + to_string(Math::qd) + "d]");
     if (isnan(lat) || isnan(lon)) {
-      geohash = "invalid";
-      return;
+      copy("invalid", "invalid" + 8, geohash);
+      return 7;
     }
     if (lat == Math::qd) lat -= lateps / 2;
     lon = Math::AngNormalize(lon);
@@ -44,32 +93,34 @@ namespace GeographicLib {
     unsigned long long
       ulon = (unsigned long long)(floor(lon/loneps) + shift),
       ulat = (unsigned long long)(floor(lat/lateps) + shift);
-    char geohash1[maxlen_];
-    unsigned byte = 0;
-    for (unsigned i = 0; i < 5 * unsigned(len);) {
-      if ((i & 1) == 0) {
-        byte = (byte << 1) + unsigned((ulon & mask_) != 0);
-        ulon <<= 1;
-      } else {
-        byte = (byte << 1) + unsigned((ulat & mask_) != 0);
-        ulat <<= 1;
-      }
-      ++i;
-      if (i % 5 == 0) {
-        geohash1[(i/5)-1] = lcdigits_[byte];
-        byte = 0;
-      }
-    }
-    geohash.resize(len);
-    copy(geohash1, geohash1 + len, geohash.begin());
+    // The geohash is given by the bits of ulon and ulat interleaved (lon
+    // first) from the most significant (bit 45) down, 5 bits per character.
+    // hi holds the 60 bits from the top 30 bits of each (characters 0-11)
+    // and lo the 32 bits from the bottom 16 bits of each (characters 12-17).
+    unsigned long long
+      hi = (spread(ulon >> 16) << 1) | spread(ulat >> 16),
+      lo = (spread(ulon & 0xffffU) << 1) | spread(ulat & 0xffffU);
+    for (int k = 0; k < len; ++k)
+      geohash[k] = lcdigits_[k < 12 ?
+                             (hi >> (55 - 5 * k)) & 31U :
+                             (lo >> (87 - 5 * k)) & 31U];
+    geohash[len] = '\0';
+    return len;
   }
 
-  void Geohash::Reverse(const string& geohash, real& lat, real& lon,
+  void Geohash::ForwardBatch(size_t n, const real lat[], const real lon[],
+                             int len, char geohash[]) {
+    for (size_t i = 0; i < n; ++i)
+      Forward(lat[i], lon[i], len, geohash + i * (MAXLENGTH + 1));
+  }
+
+  void Geohash::Reverse(const char* geohash, size_t n, real& lat, real& lon,
                         int& len, bool centerp) {
     static const real shift = ldexp(real(1), 45);
     static const real loneps = Math::hd / shift;
     static const real lateps = Math::qd / shift;
-    int len1 = min(int(maxlen_), int(geohash.length()));
+    static const digitmap digits(ucdigits_);
+    int len1 = int(min(size_t(maxlen_), n));
     if (len1 >= 3 &&
         ((toupper(geohash[0]) == 'I' &&
           toupper(geohash[1]) == 'N' &&
@@ -81,30 +132,62 @@ namespace GeographicLib {
       lat = lon = Math::NaN();
       return;
     }
-    unsigned long long ulon = 0, ulat = 0;
-    for (unsigned k = 0, j = 0; k < unsigned(len1); ++k) {
-      int byte = Utility::lookup(ucdigits_, geohash[k]);
+    // Assemble the interleaved bits in hi and lo as in Forward
+    unsigned long long hi = 0, lo = 0;
+    for (int k = 0; k < len1; ++k) {
+      int byte = digits(geohash[k]);
       if (byte < 0)
-        throw GeographicErr("Illegal character in geohash " + geohash);
-      for (unsigned m = 16; m; m >>= 1) {
-        if (j == 0)
-          ulon = (ulon << 1) + unsigned((byte & m) != 0);
-        else
-          ulat = (ulat << 1) + unsigned((byte & m) != 0);
-        j ^= 1;
-      }
+        throw GeographicErr("Illegal character in geohash "
+                            + string(geohash, n));
+      if (k < 12)
+        hi |= (unsigned long long)(byte) << (55 - 5 * k);
+      else
+        lo |= (unsigned long long)(byte) << (87 - 5 * k);
     }
-    ulon <<= 1; ulat <<= 1;
+    // The bits are left aligned in 46-bit numbers; the center of the cell is
+    // obtained by setting the next bit.
+    int s = 5 * (maxlen_ - len1);
+    unsigned long long
+      ulon = (compact(hi >> 1) << 16) | compact(lo >> 1),
+      ulat = (compact(hi) << 16) | compact(lo);
     if (centerp) {
-      ulon += 1;
-      ulat += 1;
+      ulon += 1ULL << (s / 2);
+      ulat += 1ULL << (s - s / 2);
     }
-    int s = 5 * (maxlen_ - len1);
-    ulon <<=     (s / 2);
-    ulat <<= s - (s / 2);
     lon = ulon * loneps - Math::hd;
     lat = ulat * lateps - Math::qd;
     len = len1;
   }
 
+  void Geohash::ReverseBatch(size_t n, const char geohash[],
+                             real lat[], real lon[], int len[],
+                             bool centerp) {
+    for (size_t i = 0; i < n; ++i) {
+      const char* s = geohash + i * (MAXLENGTH + 1);
+      const void* e = memchr(s, '\0', MAXLENGTH + 1);
+      int lenx = 0;
+      Reverse(s, e ? size_t(static_cast<const char*>(e) - s) : MAXLENGTH + 1,
+              lat[i], lon[i], len ? len[i] : lenx, centerp);
+    }
+  }
+
+  void Geohash::Cover(const GeodesicRegion& region, int len,
+                      vector<string>& cells, bool compact) {
+    len = max(0, min(int(maxlen_), len));
+    if (len == 0) {
+      cells.assign(region.Classify(-Math::qd, Math::qd, -Math::hd, Math::hd)
+                   == GeodesicRegion::OUTSIDE ? 0 : 1, string());
+      return;
+    }
+    // Each character divides a cell into 8 x 4 cells (in longitude and
+    // latitude) if it's in an odd position, otherwise into 4 x 8 cells.
+    GeodesicRegion::Level levels[maxlen_];
+    for (int k = 0; k < len; ++k) {
+      bool odd = k % 2 == 0;
+      levels[k] = { odd ? 4 : 8, odd ? 8 : 4, k + 1, true };
+    }
+    void (*encode)(real, real, int, string&) = &Forward;
+    region.Cover(levels, len, encode, compact, cells);
+  }
+
 } // namespace GeographicLib
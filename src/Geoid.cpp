@@ -10,7 +10,28 @@
 #include <GeographicLib/Geoid.hpp>
 // For getenv
 #include <cstdlib>
+#include <atomic>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <GeographicLib/Utility.hpp>
+#include <GeographicLib/Trace.hpp>
+#include <GeographicLib/SharedInstances.hpp>
+#include <GeographicLib/SphericalEngine.hpp>
+#include <GeographicLib/Geodesic.hpp>
+#include <GeographicLib/GeodesicLine.hpp>
+
+// For memory mapping the data file and for positioned reads
+#if defined(_WIN32)
+#  define WIN32_LEAN_AND_MEAN
+#  define NOMINMAX
+#  include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <unistd.h>
+#  define GEOGRAPHICLIB_GEOID_POSIX 1
+#endif
 
 #if !defined(GEOGRAPHICLIB_DATA)
 #  if defined(_WIN32)
@@ -33,6 +54,85 @@ namespace GeographicLib {
 
   using namespace std;
 
+  namespace {
+    // The single-cell cache for concurrent Geoid objects; there's one per
+    // thread and id identifies the Geoid object which last used it (ids are
+    // never reused, so the cache is never used by the wrong object).
+    struct GeoidCell {
+      unsigned long long id;
+      int ix, iy;
+      Math::real v[10];
+    };
+    thread_local GeoidCell geoidcell_ = {0, 0, 0, {0}};
+    atomic<unsigned long long> geoidcount_(0);
+
+    // Decode a tile of a compressed (pgc) data file.  The tile consists of a
+    // byte giving the Rice parameter k followed by a big-endian bit stream
+    // of the residuals, in row order, of each pixel from the median edge
+    // detector (MED) prediction based on its W, N, and NW neighbors.  A
+    // residual r is mapped to u = 2*r (for r >= 0) or -2*r-1 (for r < 0)
+    // which is coded as u>>k in unary (ones terminated by a zero) followed
+    // by the k low bits of u; if u>>k >= 32, the code is 32 ones followed by
+    // u in 34 bits.  Returns false if the data is corrupt.
+    template<typename T>
+    bool decodetile(const unsigned char* p, size_t len, int w, int h,
+                    unsigned long long maxval, T* v) {
+      if (len < 1 || p[0] > 32) return false;
+      const int k = p[0], qmax = 32, nraw = 34;
+      unsigned long long acc = 0;
+      int nacc = 0;
+      size_t pos = 1;
+      // Ensure that nb bits are available in acc
+      auto need = [&](int nb) -> bool {
+        while (nacc < nb) {
+          if (pos >= len) return false;
+          acc = (acc << 8) | p[pos++];
+          nacc += 8;
+        }
+        return true;
+      };
+      auto get = [&](int nb) -> unsigned long long {
+        nacc -= nb;
+        return (acc >> nacc) & ((1ULL << nb) - 1);
+      };
+      for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+          long long pred;
+          if (y == 0)
+            pred = x == 0 ? 0 : v[x - 1];
+          else if (x == 0)
+            pred = v[(y - 1) * w];
+          else {
+            long long
+              a = v[y * w + x - 1],
+              b = v[(y - 1) * w + x],
+              c = v[(y - 1) * w + x - 1];
+            pred = c >= max(a, b) ? min(a, b) :
+              (c <= min(a, b) ? max(a, b) : a + b - c);
+          }
+          int q = 0;
+          for (; q < qmax; ++q) {
+            if (!need(1)) return false;
+            if (!get(1)) break;
+          }
+          unsigned long long u;
+          if (q == qmax) {
+            if (!need(nraw)) return false;
+            u = get(nraw);
+          } else {
+            if (!need(k)) return false;
+            u = (static_cast<unsigned long long>(q) << k) | get(k);
+          }
+          long long r = pred +
+            (u & 1ULL ? -(long long)(u >> 1) - 1 : (long long)(u >> 1));
+          if (r < 0 || (unsigned long long)(r) > maxval) return false;
+          v[y * w + x] = T(r);
+        }
+      }
+      return true;
+    }
+  }
+
   // This is the transfer matrix for a 3rd order fit with a 12-point stencil
   // with weights
   //
@@ -199,7 +299,7 @@ namespace GeographicLib {
   };
 
   Geoid::Geoid(const std::string& name, const std::string& path, bool cubic,
-               bool threadsafe)
+               bool threadsafe, bool mapfile, bool concurrent)
     : _name(name)
     , _dir(path)
     , _cubic(cubic)
@@ -208,64 +308,151 @@ namespace GeographicLib {
     , _degree( Math::degree() )
     , _eps( sqrt(numeric_limits<real>::epsilon()) )
     , _threadsafe(false)        // Set after cache is read
+    , _map(nullptr)
+    , _mapsize(0)
+    , _maphandle(nullptr)
+    , _maplength(0)
+    , _embedded(false)
+    , _vsize(0)
+    , _vbigendian(false)
+    , _rowstart(0)
+    , _rowstride(0)
+    , _xshift(0)
+    , _concurrent(false)        // Set after the file is opened
+    , _fd(-1)
+    , _filehandle(nullptr)
+    , _id(0)
+    , _cachefits(false)
+    , _tilew(0)
+    , _tileh(0)
+    , _maxtiles(0)
+    , _tilehits(0)
+    , _tilemisses(0)
+    , _compressed(false)
+    , _tilestart(0)
+    , _asyncready(false)
+    , _asyncseq(0)
+    , _cacheseq(0)
+    , _reqsouth(Math::NaN())
+    , _reqwest(Math::NaN())
+    , _reqnorth(Math::NaN())
+    , _reqwidth(Math::NaN())
   {
+    _asyncarea.seq = 0;
+    GEOGRAPHICLIB_TRACE_SPAN("Geoid::Geoid");
     static_assert(sizeof(pixel_t) == pixel_size_, "pixel_t has the wrong size");
+    // A data file compiled into the library is used if no path is given
+    const char* edata = nullptr;
+    size_t esize = 0;
+    string ename = _name + (pixel_size_ != 4 ? ".pgm" : ".pgm4");
+    if (path.empty())
+      Utility::EmbeddedData("geoids/" + ename, edata, esize);
+    istringstream ehdr;
     if (_dir.empty())
       _dir = DefaultGeoidPath();
-    _filename = _dir + "/" + _name + (pixel_size_ != 4 ? ".pgm" : ".pgm4");
-    _file.open(_filename.c_str(), ios::binary);
-    if (!(_file.good()))
-      throw GeographicErr("File not readable " + _filename);
+    if (edata) {
+      _filename = "embedded:geoids/" + ename;
+      // A copy of the start of the data which holds the header
+      ehdr.str(string(edata, min(esize, size_t(1) << 16)));
+      _embedded = true;
+    } else {
+      _filename = _dir + "/" + ename;
+      _file.open(_filename.c_str(), ios::binary);
+    }
+    istream& in = edata ? static_cast<istream&>(ehdr) : _file;
+    if (!edata && !(_file.good())) {
+      // Fall back to the compressed format and then to the GTX and GeoTIFF
+      // formats
+      const char* exts[] = { pixel_size_ != 4 ? ".pgc" : ".pgc4",
+                             ".gtx", ".tif" };
+      int k = 0;
+      for (; k < 3; ++k) {
+        string zfilename = _dir + "/" + _name + exts[k];
+        _file.clear();
+        _file.open(zfilename.c_str(), ios::binary);
+        if (_file.good()) {
+          _filename = zfilename;
+          break;
+        }
+      }
+      if (k == 3)
+        throw GeographicErr("File not readable " + _filename);
+      if (k > 0) {
+        _file.exceptions(ifstream::eofbit | ifstream::failbit |
+                         ifstream::badbit);
+        try {
+          if (k == 1)
+            readgtx();
+          else
+            readtiff();
+        }
+        catch (const ios_base::failure&) {
+          throw GeographicErr("File is truncated " + _filename);
+        }
+        mapfile = true;
+      }
+    }
     string s;
-    if (!(getline(_file, s) && s == "P5"))
-      throw GeographicErr("File not in PGM format " + _filename);
-    _offset = numeric_limits<real>::max();
-    _scale = 0;
-    _maxerror = _rmserror = -1;
-    _description = "NONE";
-    _datetime = "UNKNOWN";
-    while (getline(_file, s)) {
-      if (s.empty())
-        continue;
-      if (s[0] == '#') {
-        istringstream is(s);
-        string commentid, key;
-        if (!(is >> commentid >> key) || commentid != "#")
+    if (!_vsize) {
+      if (!(getline(in, s) && (s == "P5" || s == "P5C")))
+        throw GeographicErr("File not in PGM format " + _filename);
+      _compressed = s == "P5C";
+      _offset = numeric_limits<real>::max();
+      _scale = 0;
+      _maxerror = _rmserror = -1;
+      _description = "NONE";
+      _datetime = "UNKNOWN";
+      while (getline(in, s)) {
+        if (s.empty())
           continue;
-        if (key == "Description" || key == "DateTime") {
-          string::size_type p =
-            s.find_first_not_of(" \t", unsigned(is.tellg()));
-          if (p != string::npos)
-            (key == "Description" ? _description : _datetime) = s.substr(p);
-        } else if (key == "Offset") {
-          if (!(is >> _offset))
-            throw GeographicErr("Error reading offset " + _filename);
-        } else if (key == "Scale") {
-          if (!(is >> _scale))
-            throw GeographicErr("Error reading scale " + _filename);
-        } else if (key == (_cubic ? "MaxCubicError" : "MaxBilinearError")) {
-          // It's not an error if the error can't be read
-          is >> _maxerror;
-        } else if (key == (_cubic ? "RMSCubicError" : "RMSBilinearError")) {
-          // It's not an error if the error can't be read
-          is >> _rmserror;
+        if (s[0] == '#') {
+          istringstream is(s);
+          string commentid, key;
+          if (!(is >> commentid >> key) || commentid != "#")
+            continue;
+          if (key == "Description" || key == "DateTime") {
+            string::size_type p =
+              s.find_first_not_of(" \t", unsigned(is.tellg()));
+            if (p != string::npos)
+              (key == "Description" ? _description : _datetime) = s.substr(p);
+          } else if (key == "Offset") {
+            if (!(is >> _offset))
+              throw GeographicErr("Error reading offset " + _filename);
+          } else if (key == "Scale") {
+            if (!(is >> _scale))
+              throw GeographicErr("Error reading scale " + _filename);
+          } else if (key == (_cubic ? "MaxCubicError" : "MaxBilinearError")) {
+            // It's not an error if the error can't be read
+            is >> _maxerror;
+          } else if (key == (_cubic ? "RMSCubicError" : "RMSBilinearError")) {
+            // It's not an error if the error can't be read
+            is >> _rmserror;
+          } else if (key == "Region")
+            // Written by GeoidGrid for grids which don't cover the earth
+            throw GeographicErr("Regional grids are not supported "
+                                + _filename);
+        } else {
+          istringstream is(s);
+          if (!(is >> _width >> _height))
+            throw GeographicErr("Error reading raster size " + _filename);
+          break;
         }
-      } else {
-        istringstream is(s);
-        if (!(is >> _width >> _height))
-          throw GeographicErr("Error reading raster size " + _filename);
-        break;
       }
-    }
-    {
-      unsigned maxval;
-      if (!(_file >> maxval))
-        throw GeographicErr("Error reading maxval " + _filename);
-      if (maxval != pixel_max_)
-        throw GeographicErr("Incorrect value of maxval " + _filename);
-      // Add 1 for whitespace after maxval
-      _datastart = (unsigned long long)(_file.tellg()) + 1ULL;
-      _swidth = (unsigned long long)(_width);
+      {
+        unsigned maxval;
+        if (!(in >> maxval))
+          throw GeographicErr("Error reading maxval " + _filename);
+        if (maxval != pixel_max_)
+          throw GeographicErr("Incorrect value of maxval " + _filename);
+        if (_compressed &&
+            !(in >> _tilew >> _tileh && _tilew > 0 && _tileh > 0))
+          throw GeographicErr("Error reading tile size " + _filename);
+        // Add 1 for whitespace after maxval (or the tile size)
+        _datastart = (unsigned long long)(in.tellg()) + 1ULL;
+        _swidth = (unsigned long long)(_width);
+      }
+      _maplength = _datastart +
+        pixel_size_ * _swidth * (unsigned long long)(_height);
     }
     if (_offset == numeric_limits<real>::max())
       throw GeographicErr("Offset not set " + _filename);
@@ -282,13 +469,42 @@ namespace GeographicLib {
     if (!(_height & 1))
       // This is so that latitude grid includes the equator.
       throw GeographicErr("Raster height is even " + _filename);
-    _file.seekg(0, ios::end);
-    if (!_file.good() ||
-        _datastart + pixel_size_ * _swidth * (unsigned long long)(_height) !=
-        (unsigned long long)(_file.tellg()))
-      // Possibly this test should be "<" because the file contains, e.g., a
-      // second image.  However, for now we are more strict.
-      throw GeographicErr("File has the wrong length " + _filename);
+    if (_vsize) {
+      // The file length was checked by readgtx or readtiff
+    } else if (_compressed) {
+      if (edata)
+        throw GeographicErr("Embedded data must not be compressed");
+      // Read the tile index, the offsets of the tiles relative to the end of
+      // the index, followed by the total length of the tiles
+      size_t ntiles = size_t((_width + _tilew - 1) / _tilew) *
+        size_t((_height + _tileh - 1) / _tileh);
+      _tileoffsets.resize(ntiles + 1);
+      _file.seekg(streamoff(_datastart));
+      Utility::readarray<unsigned long long, unsigned long long, true>
+        (_file, _tileoffsets);
+      _tilestart = _datastart + 8ULL * (ntiles + 1);
+      bool ok = _file.good() && _tileoffsets[0] == 0;
+      for (size_t i = 0; ok && i < ntiles; ++i)
+        ok = _tileoffsets[i] < _tileoffsets[i + 1];
+      _file.seekg(0, ios::end);
+      if (!(ok && _file.good() && _tilestart + _tileoffsets[ntiles] ==
+            (unsigned long long)(_file.tellg())))
+        throw GeographicErr("File has a corrupt tile index " + _filename);
+    } else {
+      bool ok = true;
+      unsigned long long len = esize;
+      if (!edata) {
+        _file.seekg(0, ios::end);
+        ok = _file.good();
+        len = (unsigned long long)(_file.tellg());
+      }
+      if (!ok ||
+          _datastart + pixel_size_ * _swidth * (unsigned long long)(_height) !=
+          len)
+        // Possibly this test should be "<" because the file contains, e.g., a
+        // second image.  However, for now we are more strict.
+        throw GeographicErr("File has the wrong length " + _filename);
+    }
     _rlonres = _width / real(Math::td);
     _rlatres = (_height - 1) / real(Math::hd);
     _cache = false;
@@ -296,122 +512,1211 @@ namespace GeographicLib {
     _iy = _height;
     // Ensure that file errors throw exceptions
     _file.exceptions(ifstream::eofbit | ifstream::failbit | ifstream::badbit);
-    if (threadsafe) {
+    if (_compressed) {
+      if (mapfile)
+        throw GeographicErr("Cannot memory map compressed file " + _filename);
+      // The data is always read via the tile cache
+      tilebudget(tilebudget_);
+    }
+    if (edata) {
+      // The data is used in place
+      _map = reinterpret_cast<const unsigned char*>(edata);
+      _threadsafe = true;
+    } else if (mapfile) {
+      mapdata();
+      _file.close();
+      _threadsafe = true;
+    } else if (concurrent) {
+      // Keep _file open for CacheArea
+      opendata();
+      _id = ++geoidcount_;
+      _concurrent = true;
+    } else if (threadsafe) {
       CacheAll();
       _file.close();
       _threadsafe = true;
+      // The tiles used to fill the cache are no longer needed
+      _maxtiles = 0;
+      _tileindex.clear();
+      _tiles.clear();
+      if (MemoryPolicy::Replicate() && MemoryPolicy::Nodes() > 1) {
+        // _data serves the node where it was placed (the node of this
+        // thread, unless the policy names a node)
+        int home = MemoryPolicy::Node() >= 0 ? MemoryPolicy::Node() :
+          MemoryPolicy::CurrentNode();
+        _replicas.resize(MemoryPolicy::Nodes());
+        try {
+          for (int node = 0; node < MemoryPolicy::Nodes(); ++node)
+            if (node != home)
+              _replicas[node] = make_shared<const cachearray>
+                (_data->begin(), _data->end(),
+                 MemoryPolicy::Allocator<pixel_t>(node));
+        }
+        catch (const bad_alloc&) {
+          throw GeographicErr("Insufficient memory for replicating " +
+                              _filename);
+        }
+      }
     }
   }
 
-  Math::real Geoid::height(real lat, real lon) const {
-    using std::isnan;           // Needed for Centos 7, ubuntu 14
-    lat = Math::LatFix(lat);
-    if (isnan(lat) || isnan(lon)) {
-      return Math::NaN();
+  Geoid::Geoid(const Geoid& g)
+    : _name(g._name)
+    , _dir(g._dir)
+    , _filename(g._filename)
+    , _cubic(g._cubic)
+    , _a(g._a)
+    , _e2(g._e2)
+    , _degree(g._degree)
+    , _eps(g._eps)
+    , _rlonres(g._rlonres)
+    , _rlatres(g._rlatres)
+    , _description(g._description)
+    , _datetime(g._datetime)
+    , _offset(g._offset)
+    , _scale(g._scale)
+    , _maxerror(g._maxerror)
+    , _rmserror(g._rmserror)
+    , _width(g._width)
+    , _height(g._height)
+    , _datastart(g._datastart)
+    , _swidth(g._swidth)
+    , _threadsafe(g._threadsafe)
+    , _map(nullptr)
+    , _mapsize(0)
+    , _maphandle(nullptr)
+    , _maplength(g._maplength)
+    , _embedded(g._embedded)
+    , _vsize(g._vsize)
+    , _vbigendian(g._vbigendian)
+    , _rowstart(g._rowstart)
+    , _rowstride(g._rowstride)
+    , _xshift(g._xshift)
+    , _concurrent(false)        // Set after the file is opened
+    , _fd(-1)
+    , _filehandle(nullptr)
+    , _id(0)
+    , _data(g._data)            // Shared
+    , _cache(g._cache)
+    , _xoffset(g._xoffset)
+    , _yoffset(g._yoffset)
+    , _xsize(g._xsize)
+    , _ysize(g._ysize)
+    , _replicas(g._replicas)    // Shared
+    , _cachefits(g._cachefits)
+    , _fits(g._fits)            // Shared
+    , _tilew(g._tilew)
+    , _tileh(g._tileh)
+    , _maxtiles(g._maxtiles)
+    , _tilehits(0)
+    , _tilemisses(0)
+    , _compressed(g._compressed)
+    , _tileoffsets(g._tileoffsets)
+    , _tilestart(g._tilestart)
+    , _ix(_width)
+    , _iy(_height)
+    , _asyncready(false)
+    , _asyncseq(0)
+    , _cacheseq(0)
+    , _reqsouth(Math::NaN())
+    , _reqwest(Math::NaN())
+    , _reqnorth(Math::NaN())
+    , _reqwidth(Math::NaN())
+  {
+    _asyncarea.seq = 0;
+    if (g._file.is_open()) {
+      _file.open(_filename.c_str(), ios::binary);
+      if (!(_file.good()))
+        throw GeographicErr("File not readable " + _filename);
+      _file.exceptions(ifstream::eofbit | ifstream::failbit |
+                       ifstream::badbit);
     }
-    lon = Math::AngNormalize(lon);
+    if (_embedded)
+      _map = g._map;
+    else if (g._map)
+      mapdata();
+    else if (g._concurrent) {
+      opendata();
+      _id = ++geoidcount_;
+      _concurrent = true;
+    }
+  }
+
+  Geoid::~Geoid() {
+    // The threads loading the areas refer to this object
+    for (const shared_future<void>& f : _asyncloads)
+      f.wait();
+    unmapdata();
+    closedata();
+  }
+
+  const Geoid& Geoid::Get(const string& name, const string& path,
+                          bool cubic) {
+    static SharedInstances<Geoid, string> instances;
+    string dir = path.empty() ? DefaultGeoidPath() : path;
+    // The components are separated by NULs, which can't appear in names
+    string key = name + '\0' + dir + '\0' + (cubic ? "c" : "b");
+    return instances.Get(key, name, dir, cubic, true);
+  }
+
+  void Geoid::opendata() {
+#if defined(_WIN32)
+    HANDLE f = CreateFileA(_filename.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                           NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (f == INVALID_HANDLE_VALUE)
+      throw GeographicErr("Cannot open " + _filename + " for reading");
+    _filehandle = f;
+#elif GEOGRAPHICLIB_GEOID_POSIX
+    _fd = open(_filename.c_str(), O_RDONLY);
+    if (_fd < 0)
+      throw GeographicErr("Cannot open " + _filename + " for reading");
+#else
+    throw GeographicErr("Positioned reads are not supported on this system");
+#endif
+  }
+
+  void Geoid::closedata() {
+#if defined(_WIN32)
+    if (_filehandle) CloseHandle(_filehandle);
+#elif GEOGRAPHICLIB_GEOID_POSIX
+    if (_fd >= 0) close(_fd);
+#endif
+    _fd = -1;
+    _filehandle = nullptr;
+  }
+
+  void Geoid::preadbytes(unsigned long long off, unsigned char p[], size_t n)
+    const {
+    // A positioned read of n bytes; this doesn't move the file pointer and so
+    // may be used concurrently on several threads.
+    bool ok = true;
+    while (ok && n > 0) {
+#if defined(_WIN32)
+      OVERLAPPED o = {};
+      o.Offset = DWORD(off & 0xffffffffULL);
+      o.OffsetHigh = DWORD(off >> 32);
+      DWORD m = 0;
+      ok = ReadFile(_filehandle, p, DWORD(min(n, size_t(1) << 30)), &m, &o)
+        && m > 0;
+      size_t r = size_t(m);
+#elif GEOGRAPHICLIB_GEOID_POSIX
+      ssize_t m = pread(_fd, p, n, off_t(off));
+      ok = m > 0;
+      size_t r = ok ? size_t(m) : 0;
+#else
+      ok = false;
+      size_t r = 0;
+#endif
+      p += r; n -= r; off += r;
+    }
+    if (!ok) {
+      std::string err("Error reading ");
+      err += _filename;
+      throw GeographicErr(err);
+    }
+  }
+
+  Math::real Geoid::preadval(int ix, int iy) const {
+    unsigned char p[pixel_size_];
+    preadbytes(_datastart +
+               pixel_size_ * (unsigned(iy)*_swidth + unsigned(ix)),
+               p, pixel_size_);
+    unsigned r = (unsigned(p[0]) << 8) | unsigned(p[1]);
+    if (pixel_size_ == 4)
+      r = (r << 16) | (unsigned(p[2]) << 8) | unsigned(p[3]);
+    return real(r);
+  }
+
+  void Geoid::readrun(unsigned long long k, size_t n, pixel_t v[]) const {
+    // Read n consecutive pixels starting at node k of the file
+    unsigned long long off = _datastart + pixel_size_ * k;
+    if (_concurrent) {
+      unsigned char* p = reinterpret_cast<unsigned char*>(v);
+      preadbytes(off, p, pixel_size_ * n);
+      // Convert from big-endian in place
+      for (size_t i = 0; i < n; ++i, p += pixel_size_) {
+        unsigned r = (unsigned(p[0]) << 8) | unsigned(p[1]);
+        if (pixel_size_ == 4)
+          r = (r << 16) | (unsigned(p[2]) << 8) | unsigned(p[3]);
+        v[i] = pixel_t(r);
+      }
+    } else {
+      try {
+        _file.seekg(streamoff(off));
+        Utility::readarray<pixel_t, pixel_t, true>(_file, v, n);
+      }
+      catch (const exception& e) {
+        string err("Error reading ");
+        err += _filename;
+        err += ": ";
+        err += e.what();
+        throw GeographicErr(err);
+      }
+    }
+  }
+
+  Math::real Geoid::tileval(int ix, int iy) const {
+    unique_lock<mutex> lock(_tilemutex, defer_lock);
+    if (_concurrent) lock.lock();
+    int tx = ix / _tilew, ty = iy / _tileh, y0 = ty * _tileh;
+    long long key = (long long)(ty) * ((_width + _tilew - 1) / _tilew) + tx;
+    auto p = _tileindex.find(key);
+    if (p != _tileindex.end()) {
+      ++_tilehits;
+      // Move the tile to the front of the list
+      _tiles.splice(_tiles.begin(), _tiles, p->second);
+    } else {
+      ++_tilemisses;
+      if (_tiles.size() >= _maxtiles) {
+        // Reuse the least recently used tile
+        _tileindex.erase(_tiles.back().key);
+        _tiles.splice(_tiles.begin(), _tiles, --_tiles.end());
+      } else
+        _tiles.emplace_front();
+      tile& t = _tiles.front();
+      int x0 = tx * _tilew;
+      t.key = key;
+      t.width = min(_tilew, _width - x0);
+      int h = min(_tileh, _height - y0);
+      try {
+        t.data.resize(size_t(t.width) * size_t(h));
+        if (_compressed) {
+          unsigned long long off = _tileoffsets[key];
+          vector<unsigned char> buf(size_t(_tileoffsets[key + 1] - off));
+          _file.seekg(streamoff(_tilestart + off));
+          _file.read(reinterpret_cast<char*>(buf.data()),
+                     streamsize(buf.size()));
+          if (!decodetile(buf.data(), buf.size(), t.width, h,
+                          pixel_max_, t.data.data()))
+            throw GeographicErr("corrupt tile");
+        } else {
+          for (int y = 0; y < h; ++y) {
+            filepos(x0, y0 + y);
+            Utility::readarray<pixel_t, pixel_t, true>
+              (_file, &(t.data[size_t(y) * t.width]), t.width);
+          }
+        }
+      }
+      catch (const exception& e) {
+        _tiles.pop_front();
+        string err("Error reading ");
+        err += _filename;
+        err += ": ";
+        err += e.what();
+        throw GeographicErr(err);
+      }
+      _tileindex[key] = _tiles.begin();
+    }
+    const tile& t = _tiles.front();
+    return real(t.data[size_t(iy - y0) * t.width + (ix - tx * _tilew)]);
+  }
+
+  Math::real Geoid::vendorval(int ix, int iy) const {
+    int x = ix + _xshift;
+    if (x >= _width) x -= _width;
+    const unsigned char* p =
+      _map + (_rowstart + iy * _rowstride + (long long)(x) * _vsize);
+    uint64_t u = 0;
+    for (unsigned i = 0; i < _vsize; ++i)
+      u = (u << 8) | p[_vbigendian ? i : _vsize - 1 - i];
+    if (_vsize == 4) {
+      uint32_t u4 = uint32_t(u);
+      float f;
+      memcpy(&f, &u4, 4);
+      return real(f);
+    } else {
+      double d;
+      memcpy(&d, &u, 8);
+      return real(d);
+    }
+  }
+
+  void Geoid::vendorgrid(real lat0, real lon0, real dlat, real dlon,
+                         int nrows, int ncols) {
+    // (lat0, lon0) is the first grid point in the file; the rows run from
+    // north to south if lat0 > 0.  The grid must be global.
+    if (!(dlat > 0 && dlon > 0 && nrows >= 2 && ncols >= 2))
+      throw GeographicErr("Bad grid spacing or size " + _filename);
+    real tol = real(1e-6);
+    int width = ncols;
+    if (fabs(ncols * dlon - Math::td) > tol * dlon)
+      --width;                  // Allow for a repeated column at 360deg
+    if (!(fabs(fabs(lat0) - Math::qd) <= tol * dlat &&
+          fabs((nrows - 1) * dlat - Math::hd) <= tol * dlat &&
+          fabs(width * dlon - Math::td) <= tol * dlon))
+      throw GeographicErr("Regional grids are not supported " + _filename);
+    real x = -lon0 / dlon;
+    // Check the range of x first so that the conversion to int is defined
+    int xshift = fabs(x) <= real(width) * 1024 ? int(floor(x + real(0.5))) :
+      0;
+    if (!(fabs(x - xshift) <= tol))
+      throw GeographicErr("Grid not aligned with longitude 0 " + _filename);
+    _xshift = xshift % width;
+    if (_xshift < 0) _xshift += width;
+    _width = width;
+    _height = nrows;
+    _swidth = (unsigned long long)(ncols);
+    long long rowbytes = (long long)(ncols) * _vsize;
+    _rowstart = (long long)(_datastart);
+    _rowstride = rowbytes;
+    if (!(lat0 > 0)) {
+      _rowstart += (nrows - 1) * rowbytes;
+      _rowstride = -rowbytes;
+    }
+    _offset = 0;
+    _scale = 1;
+    // The errors and the date are unknown
+    _maxerror = _rmserror = -1;
+    _datetime = "UNKNOWN";
+  }
+
+  void Geoid::readgtx() {
+    // A 40-byte header of 4 doubles (the south-west grid point and the
+    // spacings) and 2 ints (the numbers of rows and columns), followed by
+    // the rows from south to north; all big-endian.
+    unsigned char h[40];
+    _file.seekg(0);
+    _file.read(reinterpret_cast<char*>(h), 40);
+    auto get = [&h](int k, int n) -> uint64_t {
+      uint64_t u = 0;
+      for (int i = 0; i < n; ++i) u = (u << 8) | h[k + i];
+      return u;
+    };
+    double v[4];
+    for (int k = 0; k < 4; ++k) {
+      uint64_t u = get(8 * k, 8);
+      memcpy(&v[k], &u, 8);
+    }
+    int nrows = int(int32_t(uint32_t(get(32, 4)))),
+      ncols = int(int32_t(uint32_t(get(36, 4))));
+    _vsize = 4;
+    _vbigendian = true;
+    _datastart = 40;
+    _file.seekg(0, ios::end);
+    _maplength = (unsigned long long)(_file.tellg());
+    if (!(nrows > 0 && ncols > 0 &&
+          _datastart + 4ULL * (unsigned long long)(nrows) * ncols ==
+          _maplength))
+      throw GeographicErr("File has the wrong length " + _filename);
+    vendorgrid(real(v[0]), real(v[1]), real(v[2]), real(v[3]), nrows, ncols);
+    _description = "GTX grid";
+  }
+
+  void Geoid::readtiff() {
+    _file.seekg(0, ios::end);
+    _maplength = (unsigned long long)(_file.tellg());
+    _file.seekg(0);
+    unsigned char h[8];
+    _file.read(reinterpret_cast<char*>(h), 8);
+    bool big = h[0] == 'M' && h[1] == 'M';
+    auto get = [big](const unsigned char* p, int n) -> uint64_t {
+      uint64_t u = 0;
+      for (int i = 0; i < n; ++i) u = (u << 8) | p[big ? i : n - 1 - i];
+      return u;
+    };
+    if (!((big || (h[0] == 'I' && h[1] == 'I')) && get(h + 2, 2) == 42))
+      throw GeographicErr("File not in classic TIFF format " + _filename);
+    // Read the first image file directory
+    _file.seekg(streamoff(get(h + 4, 4)));
+    _file.read(reinterpret_cast<char*>(h), 2);
+    vector<unsigned char> ifd(12 * size_t(get(h, 2)));
+    _file.read(reinterpret_cast<char*>(ifd.data()), streamsize(ifd.size()));
+    // The values of a tag (empty if the tag is absent)
+    auto values = [this, &ifd, &get](unsigned tag) -> vector<double> {
+      vector<double> v;
+      for (size_t e = 0; e < ifd.size(); e += 12) {
+        const unsigned char* p = ifd.data() + e;
+        if (get(p, 2) != tag) continue;
+        unsigned type = unsigned(get(p + 2, 2));
+        size_t n = size_t(get(p + 4, 4)),
+          sz = type == 3 ? 2 : (type == 4 || type == 11 ? 4 :
+                                (type == 12 ? 8 : (type == 1 ? 1 : 0)));
+        if (sz == 0)
+          throw GeographicErr("Unsupported TIFF tag type " + _filename);
+        // Don't trust the count to allocate the buffer
+        if (!((unsigned long long)(n) * sz <= _maplength))
+          throw GeographicErr("Bad TIFF tag count " + _filename);
+        vector<unsigned char> buf(n * sz);
+        if (buf.size() <= 4)
+          copy(p + 8, p + 8 + buf.size(), buf.begin());
+        else {
+          _file.seekg(streamoff(get(p + 8, 4)));
+          _file.read(reinterpret_cast<char*>(buf.data()),
+                     streamsize(buf.size()));
+        }
+        v.resize(n);
+        for (size_t i = 0; i < n; ++i) {
+          uint64_t u = get(buf.data() + i * sz, int(sz));
+          if (type == 11) {
+            uint32_t u4 = uint32_t(u); float f;
+            memcpy(&f, &u4, 4); v[i] = f;
+          } else if (type == 12)
+            memcpy(&v[i], &u, 8);
+          else
+            v[i] = double(u);
+        }
+        break;
+      }
+      return v;
+    };
+    vector<double>
+      width = values(256), height = values(257), bits = values(258),
+      compression = values(259), offsets = values(273),
+      samples = values(277), counts = values(279), planar = values(284),
+      format = values(339), pixelscale = values(33550),
+      tiepoint = values(33922), geokeys = values(34735);
+    if (!values(322).empty())
+      throw GeographicErr("Tiled TIFF files are not supported " + _filename);
+    if (!(width.size() == 1 && height.size() == 1 && bits.size() >= 1 &&
+          offsets.size() >= 1 && counts.size() == offsets.size() &&
+          pixelscale.size() >= 2 && tiepoint.size() >= 6))
+      throw GeographicErr("Missing TIFF or GeoTIFF tags " + _filename);
+    if (!((compression.empty() || compression[0] == 1) &&
+          (samples.empty() || samples[0] == 1) &&
+          (planar.empty() || planar[0] == 1) &&
+          format.size() >= 1 && format[0] == 3 &&
+          (bits[0] == 32 || bits[0] == 64)))
+      throw GeographicErr("TIFF data must be a single band of uncompressed "
+                          "floats " + _filename);
+    if (!(width[0] >= 2 && width[0] <= numeric_limits<int>::max() &&
+          height[0] >= 2 && height[0] <= numeric_limits<int>::max()))
+      throw GeographicErr("Bad TIFF raster size " + _filename);
+    _vsize = unsigned(bits[0]) / 8;
+    _vbigendian = big;
+    int ncols = int(width[0]), nrows = int(height[0]);
+    // The strips must be contiguous so that the image is a single array
+    unsigned long long start = (unsigned long long)(offsets[0]), len = 0;
+    for (size_t i = 0; i < offsets.size(); ++i) {
+      if ((unsigned long long)(offsets[i]) != start + len)
+        throw GeographicErr("TIFF strips are not contiguous " + _filename);
+      len += (unsigned long long)(counts[i]);
+    }
+    // Written to avoid overflow in the product of the sizes
+    unsigned long long rowbytes = (unsigned long long)(_vsize) * ncols;
+    if (!(len % rowbytes == 0 && len / rowbytes == (unsigned long long)(nrows)
+          && start + len <= _maplength))
+      throw GeographicErr("File has the wrong length " + _filename);
+    _datastart = start;
+    // GTRasterTypeGeoKey (1025) is 1 for PixelIsArea (the default) and 2
+    // for PixelIsPoint; the geokey directory is a header of 4 shorts
+    // followed by entries of 4 shorts (key, location, count, value).
+    real a = real(0.5);
+    for (size_t k = 4; k + 3 < geokeys.size(); k += 4)
+      if (geokeys[k] == 1025 && geokeys[k + 1] == 0)
+        a = geokeys[k + 3] == 2 ? 0 : real(0.5);
+    // The tie point maps raster position (i, j) to (lon, lat)
     real
-      fx =  lon * _rlonres,
-      fy = -lat * _rlatres;
-    int
-      ix = int(floor(fx)),
-      iy = min((_height - 1)/2 - 1, int(floor(fy)));
+      dlon = real(pixelscale[0]), dlat = real(pixelscale[1]),
+      lon0 = real(tiepoint[3]) + (a - real(tiepoint[0])) * dlon,
+      lat0 = real(tiepoint[4]) - (a - real(tiepoint[1])) * dlat;
+    if (!(lat0 > 0))
+      throw GeographicErr("TIFF rows must run from north to south "
+                          + _filename);
+    vendorgrid(lat0, lon0, dlat, dlon, nrows, ncols);
+    _description = "GeoTIFF grid";
+  }
+
+  void Geoid::mapdata() {
+    // The length of the file was checked in the constructor
+    unsigned long long len = _maplength;
+    if ((unsigned long long)(size_t(len)) != len)
+      throw GeographicErr("File too large to memory map " + _filename);
+#if defined(_WIN32)
+    HANDLE f = CreateFileA(_filename.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                           NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (f == INVALID_HANDLE_VALUE)
+      throw GeographicErr("Cannot open " + _filename + " for mapping");
+    HANDLE m = CreateFileMappingA(f, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(f);             // The mapping keeps the file open
+    void* p = m ? MapViewOfFile(m, FILE_MAP_READ, 0, 0, 0) : NULL;
+    if (!p) {
+      if (m) CloseHandle(m);
+      throw GeographicErr("Cannot memory map " + _filename);
+    }
+    _maphandle = m;
+    _map = static_cast<const unsigned char*>(p);
+    _mapsize = len;
+#elif GEOGRAPHICLIB_GEOID_POSIX
+    int fd = open(_filename.c_str(), O_RDONLY);
+    if (fd < 0)
+      throw GeographicErr("Cannot open " + _filename + " for mapping");
+    void* p = mmap(nullptr, size_t(len), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);                  // The mapping keeps the file open
+    if (p == MAP_FAILED)
+      throw GeographicErr("Cannot memory map " + _filename);
+    _map = static_cast<const unsigned char*>(p);
+    _mapsize = len;
+#else
+    throw GeographicErr("Memory mapping is not supported on this system");
+#endif
+  }
+
+  void Geoid::unmapdata() {
+    if (!_map) return;
+    if (_embedded) {
+      _map = nullptr;
+      return;
+    }
+#if defined(_WIN32)
+    UnmapViewOfFile(_map);
+    CloseHandle(_maphandle);
+#elif GEOGRAPHICLIB_GEOID_POSIX
+    munmap(const_cast<unsigned char*>(_map), size_t(_mapsize));
+#endif
+    _map = nullptr;
+    _mapsize = 0;
+    _maphandle = nullptr;
+  }
+
+  void Geoid::cellpos(real lat, real lon,
+                      int& ix, int& iy, real& fx, real& fy) const {
+    // lat has already been passed through LatFix and is not a NaN
+    lon = Math::AngNormalize(lon);
+    fx =  lon * _rlonres;
+    fy = -lat * _rlatres;
+    ix = int(floor(fx));
+    iy = min((_height - 1)/2 - 1, int(floor(fy)));
     fx -= ix;
     fy -= iy;
     iy += (_height - 1)/2;
     ix += ix < 0 ? _width : (ix >= _width ? -_width : 0);
-    real v00 = 0, v01 = 0, v10 = 0, v11 = 0;
-    real t[nterms_];
+  }
 
-    if (_threadsafe || !(ix == _ix && iy == _iy)) {
-      if (!_cubic) {
-        v00 = rawval(ix    , iy    );
-        v01 = rawval(ix + 1, iy    );
-        v10 = rawval(ix    , iy + 1);
-        v11 = rawval(ix + 1, iy + 1);
-      } else {
-        real v[stencilsize_];
-        int k = 0;
-        v[k++] = rawval(ix    , iy - 1);
-        v[k++] = rawval(ix + 1, iy - 1);
-        v[k++] = rawval(ix - 1, iy    );
-        v[k++] = rawval(ix    , iy    );
-        v[k++] = rawval(ix + 1, iy    );
-        v[k++] = rawval(ix + 2, iy    );
-        v[k++] = rawval(ix - 1, iy + 1);
-        v[k++] = rawval(ix    , iy + 1);
-        v[k++] = rawval(ix + 1, iy + 1);
-        v[k++] = rawval(ix + 2, iy + 1);
-        v[k++] = rawval(ix    , iy + 2);
-        v[k++] = rawval(ix + 1, iy + 2);
-
-        const int* c3x = iy == 0 ? c3n_ : (iy == _height - 2 ? c3s_ : c3_);
-        int c0x = iy == 0 ? c0n_ : (iy == _height - 2 ? c0s_ : c0_);
-        for (unsigned i = 0; i < nterms_; ++i) {
-          t[i] = 0;
-          for (unsigned j = 0; j < stencilsize_; ++j)
-            t[i] += v[j] * c3x[nterms_ * j + i];
-          t[i] /= c0x;
-        }
+  template<class F>
+  void Geoid::cellfit(int ix, int iy, real t[], F val) const {
+    // val(ix, iy) returns the value at a grid node
+    if (!_cubic) {
+      t[0] = val(ix    , iy    );
+      t[1] = val(ix + 1, iy    );
+      t[2] = val(ix    , iy + 1);
+      t[3] = val(ix + 1, iy + 1);
+    } else {
+      real v[stencilsize_];
+      int k = 0;
+      v[k++] = val(ix    , iy - 1);
+      v[k++] = val(ix + 1, iy - 1);
+      v[k++] = val(ix - 1, iy    );
+      v[k++] = val(ix    , iy    );
+      v[k++] = val(ix + 1, iy    );
+      v[k++] = val(ix + 2, iy    );
+      v[k++] = val(ix - 1, iy + 1);
+      v[k++] = val(ix    , iy + 1);
+      v[k++] = val(ix + 1, iy + 1);
+      v[k++] = val(ix + 2, iy + 1);
+      v[k++] = val(ix    , iy + 2);
+      v[k++] = val(ix + 1, iy + 2);
+
+      const int* c3x = iy == 0 ? c3n_ : (iy == _height - 2 ? c3s_ : c3_);
+      int c0x = iy == 0 ? c0n_ : (iy == _height - 2 ? c0s_ : c0_);
+      for (unsigned i = 0; i < nterms_; ++i) {
+        t[i] = 0;
+        for (unsigned j = 0; j < stencilsize_; ++j)
+          t[i] += v[j] * c3x[nterms_ * j + i];
+        t[i] /= c0x;
       }
-    } else { // same cell; used cached coefficients
-      if (!_cubic) {
-        v00 = _v00;
-        v01 = _v01;
-        v10 = _v10;
-        v11 = _v11;
-      } else
-        copy(_t, _t + nterms_, t);
     }
+  }
+
+  void Geoid::cellfit(int ix, int iy, real t[]) const {
+    const real* f = _fits ? cachedfit(ix, iy) : nullptr;
+    const cachearray* d = _replicas.empty() ? nullptr :
+      _replicas[MemoryPolicy::CurrentNode()].get();
+    if (f)
+      copy(f, f + (_cubic ? nterms_ : 4), t);
+    else if (d)
+      // The copy of the cache on this thread's NUMA node
+      cellfit(ix, iy, t, [this, d](int x, int y) -> real {
+          x += x < 0 ? _width : (x >= _width ? -_width : 0);
+          long long k = cacheindex(x, y);
+          return k >= 0 ? real((*d)[size_t(k)]) : rawval(x, y);
+        });
+    else
+      cellfit(ix, iy, t,
+              [this](int x, int y) -> real { return rawval(x, y); });
+  }
+
+  const Math::real* Geoid::cachedfit(int ix, int iy) const {
+    // The fits cover the cells whose stencils lie in the area cache; with
+    // the whole range of longitudes, this is every column.
+    int lo = _cubic ? 1 : 0, hi = _cubic ? 2 : 1,
+      y = iy - _yoffset - lo, x, w;
+    if (!(y >= 0 && y < _ysize - lo - hi))
+      return nullptr;
+    if (_xsize == _width) {
+      x = ix; w = _width;
+    } else {
+      x = ix - _xoffset;
+      if (x < 0) x += _width;
+      x -= lo; w = _xsize - lo - hi;
+      if (!(x >= 0 && x < w))
+        return nullptr;
+    }
+    return _fits->data() + (size_t(y) * w + x) * (_cubic ? nterms_ : 4);
+  }
+
+  void Geoid::fitarea() const {
+    int lo = _cubic ? 1 : 0, hi = _cubic ? 2 : 1,
+      w = _xsize == _width ? _width : max(0, _xsize - lo - hi),
+      h = max(0, _ysize - lo - hi);
+    size_t nf = _cubic ? nterms_ : 4;
+    shared_ptr< vector<real> > fits;
+    try {
+      fits = make_shared< vector<real> >(size_t(w) * size_t(h) * nf);
+    }
+    catch (const bad_alloc&) {
+      throw GeographicErr("Insufficient memory for the fits for " +
+                          _filename);
+    }
+    auto val = [this](int x, int y) -> real { return rawval(x, y); };
+    real* t = fits->data();
+    for (int y = 0; y < h; ++y) {
+      int iy = _yoffset + lo + y;
+      for (int x = 0; x < w; ++x, t += nf) {
+        int ix = _xsize == _width ? x : _xoffset + lo + x;
+        cellfit(ix < _width ? ix : ix - _width, iy, t, val);
+      }
+    }
+    _fits = fits;
+  }
+
+  void Geoid::CacheFits(bool fits) const {
+    if (_threadsafe)
+      throw GeographicErr("Attempt to change cache of threadsafe Geoid");
+    _cachefits = fits;
+    if (!fits)
+      _fits.reset();
+    else if (_cache && !_fits) {
+      try {
+        fitarea();
+      }
+      catch (const exception&) {
+        CacheClear();
+        throw;
+      }
+    }
+  }
+
+  Math::real Geoid::celleval(const real t[], real fx, real fy) const {
+    real h;
     if (!_cubic) {
       real
-        a = (1 - fx) * v00 + fx * v01,
-        b = (1 - fx) * v10 + fx * v11,
-        c = (1 - fy) * a + fy * b,
-        h = _offset + _scale * c;
-      if (!_threadsafe) {
-        _ix = ix;
-        _iy = iy;
-        _v00 = v00;
-        _v01 = v01;
-        _v10 = v10;
-        _v11 = v11;
-      }
-      return h;
-    } else {
-      real h = t[0] + fx * (t[1] + fx * (t[3] + fx * t[6])) +
+        a = (1 - fx) * t[0] + fx * t[1],
+        b = (1 - fx) * t[2] + fx * t[3];
+      h = (1 - fy) * a + fy * b;
+    } else
+      h = t[0] + fx * (t[1] + fx * (t[3] + fx * t[6])) +
         fy * (t[2] + fx * (t[4] + fx * t[7]) +
              fy * (t[5] + fx * t[8] + fy * t[9]));
-      h = _offset + _scale * h;
-      if (!_threadsafe) {
+    return _offset + _scale * h;
+  }
+
+  Math::real Geoid::height(real lat, real lon) const {
+    using std::isnan;           // Needed for Centos 7, ubuntu 14
+    if (_asyncready.load(memory_order_acquire))
+      installarea();
+    lat = Math::LatFix(lat);
+    if (isnan(lat) || isnan(lon)) {
+      return Math::NaN();
+    }
+    int ix, iy;
+    real fx, fy;
+    cellpos(lat, lon, ix, iy, fx, fy);
+    // The thread's cell cache for a concurrent object
+    static_assert(sizeof(geoidcell_.v) / sizeof(geoidcell_.v[0]) >= nterms_,
+                  "GeoidCell is too small");
+    GeoidCell* cell = _concurrent ? &geoidcell_ : nullptr;
+    real* t = cell ? cell->v : _t;
+    if (cell ?
+        !(cell->id == _id && cell->ix == ix && cell->iy == iy) :
+        _threadsafe || !(ix == _ix && iy == _iy)) {
+      real tt[nterms_];
+      cellfit(ix, iy, tt);
+      if (cell) {
+        cell->id = _id;
+        cell->ix = ix;
+        cell->iy = iy;
+      } else if (!_threadsafe) {
         _ix = ix;
         _iy = iy;
-        copy(t, t + nterms_, _t);
+      } else
+        // Don't touch the cell cache of a thread safe object
+        return celleval(tt, fx, fy);
+      copy(tt, tt + nterms_, t);
+    }
+    return celleval(t, fx, fy);
+  }
+
+  void Geoid::HeightBatch(size_t n, const real lat[], const real lon[],
+                          real h[]) const {
+    IntHeightBatch(n, lat, lon, h);
+  }
+
+  void Geoid::HeightBatch(size_t n,
+                          StridedView<const real> lat,
+                          StridedView<const real> lon,
+                          StridedView<real> h) const {
+    IntHeightBatch(n, lat, lon, h);
+  }
+
+  template<class CA, class A>
+  void Geoid::IntHeightBatch(size_t n, CA lat, CA lon, A h) const {
+    using std::isnan;           // Needed for Centos 7, ubuntu 14
+    if (_asyncready.load(memory_order_acquire))
+      installarea();
+    real t[nterms_];
+    if ((_threadsafe && !_map) ||
+        (_cache && _xsize == _width && _yoffset <= 0 &&
+         _yoffset + _ysize >= _height)) {
+      // All the data is in memory; just treat runs of points in the same cell
+      // together.
+      int ix0 = -1, iy0 = -1;
+      for (size_t i = 0; i < n; ++i) {
+        real phi = Math::LatFix(lat[i]);
+        if (isnan(phi) || isnan(lon[i])) {
+          h[i] = Math::NaN();
+          continue;
+        }
+        int ix, iy;
+        real fx, fy;
+        cellpos(phi, lon[i], ix, iy, fx, fy);
+        if (!(ix == ix0 && iy == iy0)) {
+          cellfit(ix, iy, t);
+          ix0 = ix; iy0 = iy;
+        }
+        h[i] = celleval(t, fx, fy);
       }
-      return h;
+      return;
+    }
+    // Otherwise group the points by cell (preserving the order of the points
+    // within a cell) to minimize the reading of data.  pts holds the cell
+    // number and index of each valid point and fxy holds the fractional
+    // positions within the cells.
+    vector< pair<long long, size_t> > pts;
+    vector<real> fxy(2 * n);
+    pts.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+      real phi = Math::LatFix(lat[i]);
+      if (isnan(phi) || isnan(lon[i])) {
+        h[i] = Math::NaN();
+        continue;
+      }
+      int ix, iy;
+      cellpos(phi, lon[i], ix, iy, fxy[2*i], fxy[2*i+1]);
+      pts.push_back(make_pair((long long)(iy) * _width + ix, i));
+    }
+    sort(pts.begin(), pts.end());
+    if (!_map && !_cache && _maxtiles == 0) {
+      // Every node would be a separate read of the file
+      gatherbatch(pts, fxy, h);
+      return;
+    }
+    for (size_t k = 0; k < pts.size(); ++k) {
+      long long key = pts[k].first;
+      size_t i = pts[k].second;
+      if (k == 0 || key != pts[k - 1].first)
+        cellfit(int(key % _width), int(key / _width), t);
+      h[i] = celleval(t, fxy[2*i], fxy[2*i+1]);
+    }
+  }
+
+  template<class A>
+  void Geoid::gatherbatch(const vector< pair<long long, size_t> >& pts,
+                          const vector<real>& fxy, A h) const {
+    // Take the sorted cells in blocks of batchcells_.  For each block, list
+    // the grid nodes in the stencils, sort them by position in the file, and
+    // merge them into runs, reading through gaps of up to batchgap_ pixels.
+    // Each run is then a single read and the heights are evaluated from the
+    // buffered values.  The runs for nearby cells typically span several
+    // stencils and, with a narrow grid, adjacent rows.
+    struct run {
+      unsigned long long k;     // The first node
+      size_t n, off;            // The number of nodes, the offset in buf
+    };
+    vector<unsigned long long> nodes;
+    vector<run> runs;
+    vector<pixel_t> buf;
+    real t[nterms_];
+    auto gather = [this, &nodes](int x, int y) -> real {
+      nodes.push_back(nodeindex(x, y));
+      return 0;
+    };
+    auto lookup = [this, &runs, &buf](int x, int y) -> real {
+      unsigned long long k = nodeindex(x, y);
+      auto r = upper_bound(runs.begin(), runs.end(), k,
+                           [](unsigned long long a, const run& b) -> bool
+                           { return a < b.k; }) - 1;
+      return real(buf[r->off + size_t(k - r->k)]);
+    };
+    for (size_t k0 = 0; k0 < pts.size();) {
+      size_t k1 = k0, ncells = 0;
+      nodes.clear();
+      for (; k1 < pts.size(); ++k1) {
+        long long key = pts[k1].first;
+        if (k1 == k0 || key != pts[k1 - 1].first) {
+          if (ncells == batchcells_) break;
+          ++ncells;
+          cellfit(int(key % _width), int(key / _width), t, gather);
+        }
+      }
+      sort(nodes.begin(), nodes.end());
+      runs.clear();
+      for (unsigned long long k : nodes) {
+        // nodes is sorted so that k is not before the end of the last run
+        if (!runs.empty() && k <= runs.back().k + runs.back().n + batchgap_)
+          runs.back().n = size_t(k + 1 - runs.back().k);
+        else {
+          run r = { k, 1, 0 };
+          runs.push_back(r);
+        }
+      }
+      size_t len = 0;
+      for (run& r : runs) {
+        r.off = len; len += r.n;
+      }
+      buf.resize(len);
+      for (const run& r : runs)
+        readrun(r.k, r.n, buf.data() + r.off);
+      for (size_t k = k0; k < k1; ++k) {
+        long long key = pts[k].first;
+        size_t i = pts[k].second;
+        if (k == k0 || key != pts[k - 1].first)
+          cellfit(int(key % _width), int(key / _width), t, lookup);
+        h[i] = celleval(t, fxy[2*i], fxy[2*i+1]);
+      }
+      k0 = k1;
     }
   }
 
   void Geoid::CacheClear() const {
     if (!_threadsafe) {
+      try {
+        requestarea(Math::NaN(), Math::NaN(), Math::NaN(), Math::NaN());
+      }
+      catch (const exception&) {
+      }
       _cache = false;
+      _maxtiles = 0;
       try {
-        _data.clear();
-        // Use swap to release memory back to system
-        vector< vector<pixel_t> >().swap(_data);
+        // This releases the memory unless the cache is shared with a copy
+        _data.reset();
+        _fits.reset();
+        _tileindex.clear();
+        _tiles.clear();
       }
       catch (const exception&) {
       }
+      if (_compressed)
+        // The data can only be read via the tile cache
+        tilebudget(tilebudget_);
     }
   }
 
+  namespace {
+    // The layout of a cache snapshot: a 16-byte identifier, a header of 16
+    // long longs (see the indices below), the identity of the data file,
+    // and then the data in native byte order.  For an area cache, the data
+    // is the cache followed by the fits (if any); for a tile cache, each
+    // tile (most recently used first) is its key followed by its pixels.
+    const char snapid_[] = "GeoidCacheSnap01";
+    const size_t snapidsize_ = 16;
+    enum {
+      SNAP_PIXELSIZE, SNAP_BYTEORDER, SNAP_WIDTH, SNAP_HEIGHT,
+      SNAP_DIGITS, SNAP_REALSIZE, SNAP_CUBIC, SNAP_KIND, SNAP_IDSIZE,
+      SNAP_A, SNAP_B, SNAP_C, SNAP_D, SNAP_COUNT, SNAP_MAXTILES,
+      SNAP_RESERVED, SNAP_NUM
+    };
+    // The kinds of cache (SNAP_KIND); for an area cache, SNAP_A, SNAP_B,
+    // SNAP_C, SNAP_D, and SNAP_COUNT are the x and y offsets, the x and y
+    // sizes, and the number of fitted values; for a tile cache, SNAP_A,
+    // SNAP_B, and SNAP_COUNT are the width and height of the tiles and the
+    // number of tiles.
+    enum { SNAP_NONE = 0, SNAP_AREA = 1, SNAP_TILES = 2 };
+    const long long snaporder_ = 0x0102030405060708LL;
+  }
+
+  string Geoid::snapidentity() const {
+    // Enough to detect a snapshot from a different data file
+    return _name + "\n" + _description + "\n" + _datetime + "\n" +
+      Utility::str(_offset, 6) + " " + Utility::str(_scale, 9);
+  }
+
+  void Geoid::SaveCache(const string& filename, bool fits) const {
+    GEOGRAPHICLIB_TRACE_SPAN("Geoid::SaveCache");
+    string id = snapidentity();
+    long long head[SNAP_NUM] = {};
+    head[SNAP_PIXELSIZE] = pixel_size_;
+    head[SNAP_BYTEORDER] = snaporder_;
+    head[SNAP_WIDTH] = _width;
+    head[SNAP_HEIGHT] = _height;
+    head[SNAP_DIGITS] = Math::digits();
+    head[SNAP_REALSIZE] = sizeof(real);
+    head[SNAP_CUBIC] = _cubic;
+    head[SNAP_IDSIZE] = (long long)(id.size());
+    unique_lock<mutex> lock(_tilemutex, defer_lock);
+    if (_cache) {
+      head[SNAP_KIND] = SNAP_AREA;
+      head[SNAP_A] = _xoffset; head[SNAP_B] = _yoffset;
+      head[SNAP_C] = _xsize; head[SNAP_D] = _ysize;
+      head[SNAP_COUNT] = fits && _fits ? (long long)(_fits->size()) : 0;
+    } else if (_maxtiles) {
+      if (_concurrent) lock.lock();
+      head[SNAP_KIND] = SNAP_TILES;
+      head[SNAP_A] = _tilew; head[SNAP_B] = _tileh;
+      head[SNAP_COUNT] = (long long)(_tiles.size());
+      head[SNAP_MAXTILES] = (long long)(_maxtiles);
+    } else
+      head[SNAP_KIND] = SNAP_NONE;
+    ofstream file(filename.c_str(), ios::binary);
+    if (!file.good())
+      throw GeographicErr("Cannot open " + filename);
+    file.write(snapid_, snapidsize_);
+    file.write(reinterpret_cast<const char*>(head), sizeof(head));
+    file.write(id.data(), streamsize(id.size()));
+    if (head[SNAP_KIND] == SNAP_AREA) {
+      file.write(reinterpret_cast<const char*>(_data->data()),
+                 streamsize(_data->size() * sizeof(pixel_t)));
+      if (head[SNAP_COUNT])
+        file.write(reinterpret_cast<const char*>(_fits->data()),
+                   streamsize(_fits->size() * sizeof(real)));
+    } else if (head[SNAP_KIND] == SNAP_TILES) {
+      for (const tile& t : _tiles) {
+        file.write(reinterpret_cast<const char*>(&t.key), sizeof(t.key));
+        file.write(reinterpret_cast<const char*>(t.data.data()),
+                   streamsize(t.data.size() * sizeof(pixel_t)));
+      }
+    }
+    file.close();
+    if (!file.good())
+      throw GeographicErr("Error writing " + filename);
+  }
+
+  void Geoid::LoadCache(const string& filename) const {
+    GEOGRAPHICLIB_TRACE_SPAN("Geoid::LoadCache");
+    if (_threadsafe)
+      throw GeographicErr("Attempt to change cache of threadsafe Geoid");
+    // Map the snapshot; if this isn't possible, read it into memory.
+    SphericalEngine::mappedfile mf;
+    vector<char> buf;
+    const char* p;
+    size_t size;
+    try {
+      mf.map(filename);
+      p = mf.data(); size = mf.size();
+    }
+    catch (const GeographicErr&) {
+      ifstream file(filename.c_str(), ios::binary);
+      if (!file.good())
+        throw GeographicErr("File not readable " + filename);
+      buf.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+      p = buf.data(); size = buf.size();
+    }
+    long long head[SNAP_NUM];
+    if (!(size >= snapidsize_ + sizeof(head) &&
+          memcmp(p, snapid_, snapidsize_) == 0))
+      throw GeographicErr("Not a Geoid cache snapshot " + filename);
+    memcpy(head, p + snapidsize_, sizeof(head));
+    if (!(head[SNAP_PIXELSIZE] == pixel_size_ &&
+          head[SNAP_BYTEORDER] == snaporder_ &&
+          head[SNAP_DIGITS] == Math::digits() &&
+          head[SNAP_REALSIZE] == (long long)(sizeof(real))))
+      throw GeographicErr("Incompatible Geoid cache snapshot " + filename);
+    string id = snapidentity();
+    size_t off = snapidsize_ + sizeof(head);
+    if (!(head[SNAP_WIDTH] == _width && head[SNAP_HEIGHT] == _height &&
+          head[SNAP_CUBIC] == _cubic &&
+          head[SNAP_IDSIZE] == (long long)(id.size()) &&
+          size - off >= id.size() && id.compare(0, id.size(), p + off,
+                                                id.size()) == 0))
+      throw GeographicErr("Geoid cache snapshot " + filename +
+                          " is for a different geoid");
+    off += id.size();
+    size_t rem = size - off;
+    const string corrupt("Corrupt Geoid cache snapshot " + filename);
+    if (head[SNAP_KIND] == SNAP_NONE) {
+      if (rem != 0)
+        throw GeographicErr(corrupt);
+      CacheClear();
+      return;
+    }
+    if (head[SNAP_KIND] == SNAP_AREA) {
+      long long
+        xoffset = head[SNAP_A], yoffset = head[SNAP_B],
+        xsize = head[SNAP_C], ysize = head[SNAP_D], nfits = head[SNAP_COUNT];
+      int lo = _cubic ? 1 : 0, hi = _cubic ? 2 : 1;
+      // The limits set by CacheArea
+      if (!(xsize > 0 && xsize <= _width &&
+            xoffset >= 0 && xoffset < _width &&
+            ysize > 0 && yoffset >= -lo &&
+            yoffset + ysize <= _height + lo && nfits >= 0))
+        throw GeographicErr(corrupt);
+      long long
+        w = xsize == _width ? _width : max(0LL, xsize - lo - hi),
+        h = max(0LL, ysize - lo - hi),
+        nf = _cubic ? nterms_ : 4;
+      size_t npix = size_t(xsize * ysize);
+      if (!((nfits == 0 || nfits == w * h * nf) &&
+            rem == npix * sizeof(pixel_t) + size_t(nfits) * sizeof(real)))
+        throw GeographicErr(corrupt);
+      shared_ptr<cachearray> data;
+      shared_ptr< vector<real> > fits;
+      try {
+        data = make_shared<cachearray>(npix);
+        if (nfits && _cachefits)
+          fits = make_shared< vector<real> >(size_t(nfits));
+      }
+      catch (const bad_alloc&) {
+        throw GeographicErr("Insufficient memory for caching " + _filename);
+      }
+      memcpy(data->data(), p + off, npix * sizeof(pixel_t));
+      if (fits)
+        memcpy(fits->data(), p + off + npix * sizeof(pixel_t),
+               size_t(nfits) * sizeof(real));
+      if (_maxtiles && !_compressed)
+        CacheClear();
+      _data = data;
+      _fits = fits;
+      _xoffset = int(xoffset); _yoffset = int(yoffset);
+      _xsize = int(xsize); _ysize = int(ysize);
+      _cache = true;
+      requestarea(CacheSouth(), CacheWest(), CacheNorth(), CacheEast());
+      if (_cachefits && !_fits) {
+        try {
+          fitarea();
+        }
+        catch (const exception&) {
+          CacheClear();
+          throw;
+        }
+      }
+      return;
+    }
+    if (head[SNAP_KIND] != SNAP_TILES)
+      throw GeographicErr(corrupt);
+    long long
+      tilew = head[SNAP_A], tileh = head[SNAP_B],
+      ntiles = head[SNAP_COUNT], maxtiles = head[SNAP_MAXTILES];
+    if (!(tilew > 0 && tilew <= _width && tileh > 0 && tileh <= _height &&
+          (!_compressed || (tilew == _tilew && tileh == _tileh))))
+      throw GeographicErr(corrupt);
+    long long
+      ntx = (_width + tilew - 1) / tilew,
+      nty = (_height + tileh - 1) / tileh;
+    if (!(ntiles >= 0 && maxtiles >= max(1LL, ntiles) &&
+          maxtiles <= ntx * nty))
+      throw GeographicErr(corrupt);
+    list<tile> tiles;
+    unordered_map<long long, list<tile>::iterator> tileindex;
+    try {
+      for (long long i = 0; i < ntiles; ++i) {
+        long long key;
+        if (rem < sizeof(key))
+          throw GeographicErr(corrupt);
+        memcpy(&key, p + off, sizeof(key));
+        off += sizeof(key); rem -= sizeof(key);
+        if (!(key >= 0 && key < ntx * nty && tileindex.count(key) == 0))
+          throw GeographicErr(corrupt);
+        long long
+          tx = key % ntx, ty = key / ntx,
+          width = min(tilew, _width - tx * tilew),
+          height = min(tileh, _height - ty * tileh);
+        size_t n = size_t(width * height);
+        if (rem < n * sizeof(pixel_t))
+          throw GeographicErr(corrupt);
+        tiles.emplace_back();
+        tile& t = tiles.back();
+        t.key = key;
+        t.width = int(width);
+        t.data.resize(n);
+        memcpy(t.data.data(), p + off, n * sizeof(pixel_t));
+        off += n * sizeof(pixel_t); rem -= n * sizeof(pixel_t);
+        tileindex[key] = --tiles.end();
+      }
+    }
+    catch (const bad_alloc&) {
+      throw GeographicErr("Insufficient memory for caching " + _filename);
+    }
+    if (rem != 0)
+      throw GeographicErr(corrupt);
+    CacheClear();
+    unique_lock<mutex> lock(_tilemutex, defer_lock);
+    if (_concurrent) lock.lock();
+    _tilew = int(tilew); _tileh = int(tileh);
+    _maxtiles = size_t(maxtiles);
+    _tilehits = 0;
+    _tilemisses = 0;
+    _tiles.swap(tiles);
+    _tileindex.swap(tileindex);
+  }
+
+  size_t Geoid::MemoryUsage() const {
+    size_t bytes = sizeof(*this) +
+      _tileoffsets.capacity() * sizeof(unsigned long long);
+    if (_data) bytes += _data->capacity() * sizeof(pixel_t);
+    if (_fits) bytes += _fits->capacity() * sizeof(real);
+    for (const auto& r : _replicas)
+      if (r) bytes += r->capacity() * sizeof(pixel_t);
+    {
+      lock_guard<mutex> lock(_asyncmutex);
+      if (_asyncarea.data)
+        bytes += _asyncarea.data->capacity() * sizeof(pixel_t);
+      if (_asyncarea.fits)
+        bytes += _asyncarea.fits->capacity() * sizeof(real);
+    }
+    lock_guard<mutex> lock(_tilemutex);
+    for (const tile& t : _tiles)
+      bytes += sizeof(tile) + t.data.capacity() * sizeof(pixel_t);
+    return bytes;
+  }
+
+  unsigned long long Geoid::CostEstimate() const {
+    // Finding the cell (cellpos) takes about 12 operations and evaluating
+    // the fit (celleval) about 12 (bilinear) or 22 (cubic).  The cubic fit
+    // (cellfit) multiplies the 12 values by a 10 x 12 matrix.
+    return _cubic ?
+      (_fits ? 34 : 34 + nterms_ * (2 * stencilsize_ + 1)) :
+      24;
+  }
+
+  void Geoid::tilebudget(unsigned long long maxbytes) const {
+    unsigned long long
+      tilebytes = pixel_size_ * (unsigned long long)(_tilew) * _tileh,
+      ntiles = (unsigned long long)((_width + _tilew - 1) / _tilew) *
+      ((_height + _tileh - 1) / _tileh);
+    _maxtiles = size_t(max(1ULL, min(ntiles, maxbytes / tilebytes)));
+    _tilehits = 0;
+    _tilemisses = 0;
+  }
+
+  void Geoid::CacheTiles(unsigned long long maxbytes, real tilesize) const {
+    GEOGRAPHICLIB_TRACE_SPAN("Geoid::CacheTiles");
+    if (_threadsafe)
+      throw GeographicErr("Attempt to change cache of threadsafe Geoid");
+    if (!(tilesize > 0))
+      throw GeographicErr("Tile size must be positive");
+    CacheClear();
+    if (!_compressed) {
+      // The tiles of a compressed file are fixed by the file
+      tilesize = fmin(tilesize, real(Math::td));
+      _tilew =
+        max(1, min(_width, int(floor(tilesize * _rlonres + 1/real(2)))));
+      _tileh =
+        max(1, min(_height, int(floor(tilesize * _rlatres + 1/real(2)))));
+    }
+    tilebudget(maxbytes);
+  }
+
   void Geoid::CacheArea(real south, real west, real north, real east) const {
+    GEOGRAPHICLIB_TRACE_SPAN("Geoid::CacheArea");
     if (_threadsafe)
       throw GeographicErr("Attempt to change cache of threadsafe Geoid");
+    if (_maxtiles && !_compressed)
+      CacheClear();
     if (south > north) {
       CacheClear();
       return;
     }
+    requestarea(south, west, north, east);
+    _fits.reset();
     south = Math::LatFix(south);
     north = Math::LatFix(north);
     west = Math::AngNormalize(west); // west in [-180, 180)
@@ -441,16 +1746,21 @@ namespace GeographicLib {
       ie += iw < 0 ? _width : (iw >= _width ? -_width : 0);
       iw += iw < 0 ? _width : (iw >= _width ? -_width : 0);
     }
-    int oysize = int(_data.size());
+    // Reuse the storage for the existing cache unless it is shared with a
+    // copy of this object.
+    if (_data && _data.use_count() > 1)
+      _data.reset();
     _xsize = ie - iw + 1;
     _ysize = is - in + 1;
     _xoffset = iw;
     _yoffset = in;
 
     try {
-      _data.resize(_ysize, vector<pixel_t>(_xsize));
-      for (int iy = min(oysize, _ysize); iy--;)
-        _data[iy].resize(_xsize);
+      if (!_data)
+        _data = make_shared<cachearray>();
+      // clear first so that the old contents aren't copied
+      _data->clear();
+      _data->resize(size_t(_xsize) * size_t(_ysize));
     }
     catch (const bad_alloc&) {
       CacheClear();
@@ -467,18 +1777,27 @@ namespace GeographicLib {
           if (iw1 >= _width)
             iw1 -= _width;
         }
+        pixel_t* row = _data->data() + size_t(iy - in) * size_t(_xsize);
+        if (_compressed) {
+          // Read the data via the tile cache
+          for (int ix = 0; ix < _xsize; ++ix)
+            row[ix] = pixel_t(tileval(iw1 + ix < _width ?
+                                      iw1 + ix : iw1 + ix - _width, iy1));
+          continue;
+        }
         int xs1 = min(_width - iw1, _xsize);
         filepos(iw1, iy1);
-        Utility::readarray<pixel_t, pixel_t, true>
-          (_file, &(_data[iy - in][0]), xs1);
+        Utility::readarray<pixel_t, pixel_t, true>(_file, row, xs1);
         if (xs1 < _xsize) {
           // Wrap around longitude = 0
           filepos(0, iy1);
           Utility::readarray<pixel_t, pixel_t, true>
-            (_file, &(_data[iy - in][xs1]), _xsize - xs1);
+            (_file, row + xs1, _xsize - xs1);
         }
       }
       _cache = true;
+      if (_cachefits)
+        fitarea();
     }
     catch (const exception& e) {
       CacheClear();
@@ -486,6 +1805,147 @@ namespace GeographicLib {
     }
   }
 
+  void Geoid::requestarea(real south, real west, real north, real east)
+    const {
+    // Called for a synchronous change of the cache; this supersedes the
+    // outstanding asynchronous requests.
+    lock_guard<mutex> lock(_asyncmutex);
+    _cacheseq = ++_asyncseq;
+    _asyncarea.data.reset();
+    _asyncarea.fits.reset();
+    _asyncready.store(false, memory_order_relaxed);
+    _reqsouth = south; _reqnorth = north;
+    _reqwest = Math::AngNormalize(west);
+    east = Math::AngNormalize(east);
+    _reqwidth = east > _reqwest ? east - _reqwest : east - _reqwest + Math::td;
+  }
+
+  bool Geoid::requested(real lat, real lon) const {
+    lock_guard<mutex> lock(_asyncmutex);
+    real dlon = Math::AngDiff(_reqwest, lon);
+    if (dlon < 0) dlon += Math::td;
+    // NaNs give false
+    return lat >= _reqsouth && lat <= _reqnorth && dlon <= _reqwidth;
+  }
+
+  void Geoid::installarea() const {
+    lock_guard<mutex> lock(_asyncmutex);
+    if (_asyncarea.data) {
+      _data = std::move(_asyncarea.data);
+      _fits = std::move(_asyncarea.fits);
+      _xoffset = _asyncarea.xoffset;
+      _yoffset = _asyncarea.yoffset;
+      _xsize = _asyncarea.xsize;
+      _ysize = _asyncarea.ysize;
+      _cache = true;
+      _cacheseq = _asyncarea.seq;
+    }
+    _asyncready.store(false, memory_order_relaxed);
+  }
+
+  shared_future<void> Geoid::CacheAreaAsync(real south, real west,
+                                            real north, real east) const {
+    GEOGRAPHICLIB_TRACE_SPAN("Geoid::CacheAreaAsync");
+    if (_threadsafe || _concurrent)
+      throw GeographicErr("Attempt to change cache of threadsafe Geoid");
+    // The copy has its own file handle and reads the data
+    shared_ptr<Geoid> g = make_shared<Geoid>(*this);
+    unsigned long long seq;
+    {
+      lock_guard<mutex> lock(_asyncmutex);
+      seq = ++_asyncseq;
+      _reqsouth = south; _reqnorth = north;
+      _reqwest = Math::AngNormalize(west);
+      east = Math::AngNormalize(east);
+      _reqwidth = east > _reqwest ? east - _reqwest :
+        east - _reqwest + Math::td;
+      // Forget the requests which have finished
+      _asyncloads.erase
+        (remove_if(_asyncloads.begin(), _asyncloads.end(),
+                   [](const shared_future<void>& f) -> bool {
+                     return f.wait_for(chrono::seconds(0)) ==
+                       future_status::ready;
+                   }),
+         _asyncloads.end());
+    }
+    shared_future<void> f =
+      async(launch::async, [this, g, seq, south, west, north, east]()
+            -> void {
+              try {
+                g->CacheArea(south, west, north, east);
+              }
+              catch (const exception&) {
+                // Let Prefetch try again
+                lock_guard<mutex> lock(_asyncmutex);
+                if (seq == _asyncseq)
+                  _reqsouth = _reqwest = _reqnorth = _reqwidth = Math::NaN();
+                throw;
+              }
+              lock_guard<mutex> lock(_asyncmutex);
+              if (seq > _cacheseq && seq > _asyncarea.seq) {
+                _asyncarea.data = g->_data;
+                _asyncarea.fits = g->_fits;
+                _asyncarea.xoffset = g->_xoffset;
+                _asyncarea.yoffset = g->_yoffset;
+                _asyncarea.xsize = g->_xsize;
+                _asyncarea.ysize = g->_ysize;
+                _asyncarea.seq = seq;
+                _asyncready.store(true, memory_order_release);
+              }
+            }).share();
+    lock_guard<mutex> lock(_asyncmutex);
+    _asyncloads.push_back(f);
+    return f;
+  }
+
+  shared_future<void> Geoid::Prefetch(real lat, real lon, real azi,
+                                      real distance) const {
+    if (!(distance > 0))
+      throw GeographicErr("Prefetch distance must be positive");
+    if (_threadsafe || _concurrent)
+      throw GeographicErr("Attempt to change cache of threadsafe Geoid");
+    const Geodesic& geod = Geodesic::WGS84();
+    GeodesicLine l = geod.Line(lat, lon, azi,
+                               Geodesic::LATITUDE | Geodesic::LONGITUDE |
+                               Geodesic::DISTANCE_IN);
+    // Check the first distance of the track
+    const int ncheck = 4;
+    bool covered = true;
+    for (int k = 0; covered && k <= ncheck; ++k) {
+      real lat2, lon2;
+      l.Position(k * distance / ncheck, lat2, lon2);
+      covered = requested(lat2, lon2);
+    }
+    if (covered)
+      return shared_future<void>();
+    // Find the bounds of the first 2*distance of the track; the longitudes
+    // are measured relative to lon.
+    const int nbound = 8;
+    real south = lat, north = lat, dwest = 0, deast = 0;
+    for (int k = 1; k <= nbound; ++k) {
+      real lat2, lon2;
+      l.Position(2 * k * distance / nbound, lat2, lon2);
+      real dlon = Math::AngDiff(lon, lon2);
+      south = fmin(south, lat2); north = fmax(north, lat2);
+      dwest = fmin(dwest, dlon); deast = fmax(deast, dlon);
+    }
+    // Add the margin, distance/2, converted to degrees (using the
+    // equatorial radius for simplicity).
+    real
+      mlat = distance / (2 * geod.EquatorialRadius() * Math::degree()),
+      maxlat = fmax(fabs(south), fabs(north)) + mlat;
+    south = fmax(south - mlat, -real(Math::qd));
+    north = fmin(north + mlat,  real(Math::qd));
+    real west = 0, east = Math::td;  // All longitudes near the poles
+    if (maxlat < Math::qd) {
+      real mlon = mlat / Math::cosd(maxlat);
+      if (deast - dwest + 2 * mlon < Math::td) {
+        west = lon + dwest - mlon; east = lon + deast + mlon;
+      }
+    }
+    return CacheAreaAsync(south, west, north, east);
+  }
+
   string Geoid::DefaultGeoidPath() {
     string path;
     char* geoidpath = getenv("GEOGRAPHICLIB_GEOID_PATH");
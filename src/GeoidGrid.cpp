@@ -0,0 +1,284 @@
+/**
+ * \file GeoidGrid.cpp
+ * \brief Implementation for GeographicLib::GeoidGrid class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#include <GeographicLib/GeoidGrid.hpp>
+#include <GeographicLib/GeodesicBatchExecutor.hpp>
+#include <GeographicLib/GravityModel.hpp>
+#include <GeographicLib/GravityCircle.hpp>
+#include <GeographicLib/Utility.hpp>
+#include <fstream>
+#include <sstream>
+#include <limits>
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  GeoidGrid::GeoidGrid(const GravityModel& g,
+                       real south, real west, real north, real east,
+                       real tol, const std::string& filename,
+                       int maxres, unsigned nthreads)
+    : _model(g.GravityModelName())
+    , _south(south)
+    , _west(west)
+    , _north(north)
+    , _east(east)
+    , _synthesized(false)
+  {
+    if (!(-Math::qd <= _south && _south < _north && _north <= Math::qd))
+      throw GeographicErr("Latitude range not in [-" + to_string(Math::qd)
+                          + "d, " + to_string(Math::qd) + "d] or empty");
+    if (!(isfinite(_west) && isfinite(_east) && _west < _east))
+      throw GeographicErr("Longitude range is empty");
+    if (!(tol > 0))
+      throw GeographicErr("Tolerance must be positive");
+    if (maxres < 1)
+      throw GeographicErr("Maximum resolution must be at least 1");
+    _wrap = _east - _west >= Math::td;
+    if (!filename.empty()) {
+      bool ok;
+      try {
+        Load(filename);
+        real d = Math::AngNormalize(west - _west);
+        if (d < 0) d += Math::td;
+        ok = _model == g.GravityModelName() && _maxerror <= tol &&
+          _south <= south && north <= _north &&
+          (_wrap || (east - west < Math::td &&
+                     d + (east - west) <= _east - _west));
+      }
+      catch (const GeographicErr&) {
+        ok = false;
+      }
+      if (ok) return;
+      _model = g.GravityModelName();
+      _south = south; _west = west; _north = north; _east = east;
+      _wrap = _east - _west >= Math::td;
+    }
+    for (_ndeg = 1;; _ndeg = min(2 * _ndeg, maxres)) {
+      Synthesize(g, _ndeg, nthreads);
+      if (_maxerror <= tol || _ndeg >= maxres)
+        break;
+    }
+    _synthesized = true;
+    if (!filename.empty())
+      Save(filename);
+  }
+
+  GeoidGrid::GeoidGrid(const std::string& filename)
+    : _synthesized(false)
+  {
+    Load(filename);
+  }
+
+  void GeoidGrid::SetEdges() {
+    _north = real(_ilat0) / _ndeg;
+    _south = real(_ilat0 - _nlat + 1) / _ndeg;
+    _west = real(_ilon0) / _ndeg;
+    _east = _wrap ? _west + Math::td : real(_ilon0 + _nlon - 1) / _ndeg;
+  }
+
+  void GeoidGrid::Synthesize(const GravityModel& g, int ndeg,
+                             unsigned nthreads) {
+    // The enclosing grid points; ceil and floor are applied to the scaled
+    // edges before clamping to the poles.
+    int
+      ilat0 = min(int(ceil(_north * ndeg)),   Math::qd * ndeg),
+      ilat1 = max(int(floor(_south * ndeg)), -Math::qd * ndeg);
+    _ndeg = ndeg;
+    _ilat0 = ilat0;
+    _nlat = ilat0 - ilat1 + 1;
+    if (_wrap) {
+      _ilon0 = 0;
+      _nlon = Math::td * ndeg;
+    } else {
+      _ilon0 = int(floor(_west * ndeg));
+      _nlon = int(ceil(_east * ndeg)) - _ilon0 + 1;
+    }
+    size_t n = size_t(_nlat) * size_t(_nlon);
+    vector<real> h(n);
+    GeodesicBatchExecutor(nthreads, 1).ForEach
+      (size_t(_nlat), [&](size_t i0, size_t i1) -> void {
+        for (size_t i = i0; i < i1; ++i) {
+          real lat = real(_ilat0 - int(i)) / _ndeg;
+          GravityCircle c(g.Circle(lat, 0, GravityModel::GEOID_HEIGHT));
+          for (int j = 0; j < _nlon; ++j)
+            h[i * _nlon + j] = c.GeoidHeight(real(_ilon0 + j) / _ndeg);
+        }
+      });
+    real hmin = numeric_limits<real>::max(), hmax = -hmin;
+    for (size_t k = 0; k < n; ++k) {
+      hmin = fmin(hmin, h[k]); hmax = fmax(hmax, h[k]);
+    }
+    // Quantize with a scale which is a whole number of micrometers
+    _offset = floor(hmin);
+    _scale = fmax(ceil((hmax - _offset) / pixel_max_ * 1000000) / 1000000,
+                  real(1) / 1000000);
+    // Estimate the interpolation error by predicting the values at the odd
+    // points from the subgrid at twice the spacing.
+    real err = -1;
+    for (int i = 0; i < _nlat; ++i) {
+      bool iodd = i & 1;
+      if (iodd && i + 1 >= _nlat) break;
+      size_t km = size_t(i) * _nlon;
+      for (int j = 0; j < _nlon; ++j) {
+        bool jodd = j & 1;
+        if (!(iodd || jodd)) continue;
+        int jm = j - 1, jp = j + 1;
+        if (jp >= _nlon) {
+          if (!_wrap) break;
+          jp -= _nlon;
+        }
+        real pred;
+        if (iodd && jodd)
+          pred = (h[km - _nlon + jm] + h[km - _nlon + jp] +
+                  h[km + _nlon + jm] + h[km + _nlon + jp]) / 4;
+        else if (iodd)
+          pred = (h[km - _nlon + j] + h[km + _nlon + j]) / 2;
+        else
+          pred = (h[km + jm] + h[km + jp]) / 2;
+        err = fmax(err, fabs(pred - h[km + j]));
+      }
+    }
+    _maxerror = err < 0 ? Math::infinity() : err / 4 + _scale / 2;
+    _data.resize(n);
+    for (size_t k = 0; k < n; ++k)
+      _data[k] = pixel_t(fmin(fmax(round((h[k] - _offset) / _scale), real(0)),
+                              real(pixel_max_)));
+    ostringstream desc;
+    desc << "Geoid heights from " << _model << " with a spacing of 1/"
+         << _ndeg << " degree";
+    _description = desc.str();
+    SetEdges();
+  }
+
+  void GeoidGrid::Load(const std::string& filename) {
+    ifstream file(filename.c_str(), ios::binary);
+    if (!file.good())
+      throw GeographicErr("File not readable " + filename);
+    string s;
+    if (!(getline(file, s) && s == "P5"))
+      throw GeographicErr("File not in PGM format " + filename);
+    _model = "NONE";
+    _description = "NONE";
+    _offset = numeric_limits<real>::max();
+    _scale = 0;
+    _maxerror = Math::NaN();
+    bool region = false;
+    int width = 0, height = 0;
+    while (getline(file, s)) {
+      if (s.empty())
+        continue;
+      if (s[0] == '#') {
+        istringstream is(s);
+        string commentid, key;
+        if (!(is >> commentid >> key) || commentid != "#")
+          continue;
+        if (key == "Description" || key == "GravityModel") {
+          string::size_type p =
+            s.find_first_not_of(" \t", unsigned(is.tellg()));
+          if (p != string::npos)
+            (key == "Description" ? _description : _model) = s.substr(p);
+        } else if (key == "Offset") {
+          if (!(is >> _offset))
+            throw GeographicErr("Error reading offset " + filename);
+        } else if (key == "Scale") {
+          if (!(is >> _scale))
+            throw GeographicErr("Error reading scale " + filename);
+        } else if (key == "MaxBilinearError") {
+          // It's not an error if the error can't be read
+          is >> _maxerror;
+        } else if (key == "Region") {
+          if (!(is >> _ilat0 >> _ilon0 >> _ndeg))
+            throw GeographicErr("Error reading region " + filename);
+          region = true;
+        }
+      } else {
+        istringstream is(s);
+        if (!(is >> width >> height))
+          throw GeographicErr("Error reading raster size " + filename);
+        break;
+      }
+    }
+    unsigned maxval;
+    if (!(file >> maxval))
+      throw GeographicErr("Error reading maxval " + filename);
+    if (maxval != pixel_max_)
+      throw GeographicErr("Incorrect value of maxval " + filename);
+    file.get();                 // The whitespace after maxval
+    if (_offset == numeric_limits<real>::max())
+      throw GeographicErr("Offset not set " + filename);
+    if (!(_scale > 0))
+      throw GeographicErr("Scale must be positive " + filename);
+    if (width < 2 || height < 2)
+      throw GeographicErr("Raster size too small " + filename);
+    _nlon = width; _nlat = height;
+    if (region) {
+      if (!(_ndeg > 0 && _ilat0 <= Math::qd * _ndeg &&
+            _ilat0 - _nlat + 1 >= -Math::qd * _ndeg &&
+            _nlon <= Math::td * _ndeg))
+        throw GeographicErr("Inconsistent region " + filename);
+      _wrap = _nlon == Math::td * _ndeg;
+    } else {
+      // A global grid as used by Geoid
+      if (!(width % Math::td == 0 && height == width / 2 + 1))
+        throw GeographicErr("Unsupported raster size " + filename);
+      _ndeg = width / Math::td;
+      _ilat0 = Math::qd * _ndeg;
+      _ilon0 = 0;
+      _wrap = true;
+    }
+    _data.resize(size_t(_nlat) * size_t(_nlon));
+    Utility::readarray<pixel_t, pixel_t, true>(file, _data);
+    SetEdges();
+  }
+
+  void GeoidGrid::Save(const std::string& filename) const {
+    ofstream file(filename.c_str(), ios::binary);
+    if (!file.good())
+      throw GeographicErr("Cannot open " + filename);
+    file << "P5\n"
+         << "# Geoid file in PGM format for the GeographicLib::Geoid class\n"
+         << "# Description " << _description << "\n"
+         << "# GravityModel " << _model << "\n"
+         << "# Offset " << Utility::str(_offset, 0) << "\n"
+         << "# Scale " << Utility::str(_scale, 6) << "\n"
+         // Write the error with enough precision to round trip
+         << "# MaxBilinearError "
+         << Utility::str(_maxerror, numeric_limits<real>::max_digits10)
+         << "\n";
+    if (!Global())
+      file << "# Region " << _ilat0 << " " << _ilon0 << " " << _ndeg << "\n";
+    file << _nlon << " " << _nlat << "\n" << pixel_max_ << "\n";
+    Utility::writearray<pixel_t, pixel_t, true>(file, _data.data(),
+                                                _data.size());
+    file.close();
+    if (!file.good())
+      throw GeographicErr("Error writing " + filename);
+  }
+
+  Math::real GeoidGrid::operator()(real lat, real lon) const {
+    real fy = _ilat0 - lat * _ndeg;
+    if (!(fy >= 0 && fy <= _nlat - 1))
+      return Math::NaN();
+    real d = Math::AngNormalize(lon - _west);
+    if (d < 0) d += Math::td;
+    real fx = d * _ndeg;
+    if (!(fx <= (_wrap ? _nlon : _nlon - 1)))
+      return Math::NaN();
+    int
+      ix = min(int(floor(fx)), _wrap ? _nlon - 1 : _nlon - 2),
+      iy = min(int(floor(fy)), _nlat - 2);
+    fx -= ix; fy -= iy;
+    real
+      a = (1 - fx) * rawval(ix, iy    ) + fx * rawval(ix + 1, iy    ),
+      b = (1 - fx) * rawval(ix, iy + 1) + fx * rawval(ix + 1, iy + 1);
+    return (1 - fy) * a + fy * b;
+  }
+
+} // namespace GeographicLib
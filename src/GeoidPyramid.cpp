@@ -0,0 +1,138 @@
+/**
+ * \file GeoidPyramid.cpp
+ * \brief Implementation for GeographicLib::GeoidPyramid class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#include <GeographicLib/GeoidPyramid.hpp>
+#include <GeographicLib/Utility.hpp>
+#include <algorithm>
+#include <fstream>
+#include <limits>
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  GeoidPyramid::GeoidPyramid(const vector<string>& names, const string& path,
+                             bool cubic) {
+    if (names.empty())
+      throw GeographicErr("A GeoidPyramid needs at least one level");
+    for (const string& name : names)
+      _levels.push_back(make_shared<const Geoid>(name, path, cubic));
+    stable_sort(_levels.begin(), _levels.end(),
+                [](const shared_ptr<const Geoid>& a,
+                   const shared_ptr<const Geoid>& b) -> bool
+                { return a->_width > b->_width; });
+  }
+
+  const Geoid& GeoidPyramid::Level(real tol) const {
+    for (size_t i = _levels.size(); --i;) {
+      real err = _levels[i]->MaxError();
+      // An unknown error is -1
+      if (err >= 0 && err <= tol)
+        return *_levels[i];
+    }
+    return *_levels[0];
+  }
+
+  void GeoidPyramid::Coarsen(const string& name, const string& newname,
+                             int factor, const string& path) {
+    typedef Geoid::pixel_t pixel_t;
+    // With bilinear interpolation, the heights at the grid points are the
+    // grid values.
+    Geoid fine(name, path, false);
+    if (fine._vsize)
+      throw GeographicErr("Cannot coarsen a GTX or GeoTIFF grid " + name);
+    int width = fine._width, height = fine._height;
+    // The new grid must include the equator, i.e., have an even number of
+    // intervals in latitude.
+    if (!(factor >= 2 && width % factor == 0 &&
+          (height - 1) % (2 * factor) == 0))
+      throw GeographicErr("Cannot coarsen " + name + " by a factor of " +
+                          Utility::str(factor));
+    int nlon = width / factor, nlat = (height - 1) / factor + 1;
+    string filename = fine._dir + "/" + newname +
+      (Geoid::pixel_size_ != 4 ? ".pgm" : ".pgm4");
+    vector<pixel_t> row(width), data(size_t(nlon) * size_t(nlat));
+    // Read a row of the fine grid
+    auto readrow = [&fine, &row](int iy) -> void {
+      if (fine._compressed || fine._map) {
+        // Via the tile cache or the embedded data
+        for (int ix = 0; ix < fine._width; ++ix)
+          row[ix] = pixel_t(fine.rawval(ix, iy));
+      } else
+        fine.readrun((unsigned long long)(iy) * fine._swidth, row.size(),
+                     row.data());
+    };
+    for (int y = 0; y < nlat; ++y) {
+      readrow(y * factor);
+      for (int x = 0; x < nlon; ++x)
+        data[size_t(y) * nlon + x] = row[size_t(x) * factor];
+    }
+    // The errors are for bilinear and cubic interpolation; a negative value
+    // is omitted.
+    auto save = [&](const real maxerr[], const real rmserr[]) -> void {
+      ofstream file(filename.c_str(), ios::binary);
+      if (!file.good())
+        throw GeographicErr("Cannot open " + filename);
+      file.precision(numeric_limits<real>::max_digits10);
+      file << "P5\n"
+           << "# Geoid file in PGM format for the GeographicLib::Geoid class\n"
+           << "# Description " << fine.Description() << ", subsampled by "
+           << factor << "\n"
+           << "# DateTime " << fine.DateTime() << "\n"
+           << "# Offset " << fine.Offset() << "\n"
+           << "# Scale " << fine.Scale() << "\n";
+      for (int k = 0; k < 2; ++k) {
+        if (maxerr[k] < 0) continue;
+        const char* interp = k ? "Cubic" : "Bilinear";
+        file << "# Max" << interp << "Error " << maxerr[k] << "\n"
+             << "# RMS" << interp << "Error " << rmserr[k] << "\n";
+      }
+      file << nlon << " " << nlat << "\n" << Geoid::pixel_max_ << "\n";
+      Utility::writearray<pixel_t, pixel_t, true>(file, data.data(),
+                                                  data.size());
+      file.close();
+      if (!file.good())
+        throw GeographicErr("Error writing " + filename);
+    };
+    real maxerr[2] = {-1, -1}, rmserr[2] = {-1, -1};
+    save(maxerr, rmserr);
+    {
+      // Compare the interpolated heights in the new grid with all the grid
+      // values of the fine grid.
+      const Geoid bilinear(newname, fine._dir, false),
+        cubic(newname, fine._dir, true);
+      const Geoid* coarse[2] = { &bilinear, &cubic };
+      vector<real> lat(width), lon(width), h(width);
+      real sum[2] = {0, 0};
+      for (int k = 0; k < 2; ++k) {
+        coarse[k]->CacheAll();
+        maxerr[k] = 0;
+      }
+      for (int ix = 0; ix < width; ++ix)
+        lon[ix] = ix / fine._rlonres;
+      for (int iy = 0; iy < height; ++iy) {
+        readrow(iy);
+        fill(lat.begin(), lat.end(),
+             fmax(Math::qd - iy / fine._rlatres, -real(Math::qd)));
+        for (int k = 0; k < 2; ++k) {
+          coarse[k]->HeightBatch(width, lat.data(), lon.data(), h.data());
+          for (int ix = 0; ix < width; ++ix) {
+            real err = fabs(h[ix] - (fine._offset + fine._scale * row[ix]));
+            maxerr[k] = fmax(maxerr[k], err);
+            sum[k] += Math::sq(err);
+          }
+        }
+      }
+      for (int k = 0; k < 2; ++k)
+        rmserr[k] = sqrt(sum[k] / (real(width) * height));
+    }
+    save(maxerr, rmserr);
+  }
+
+} // namespace GeographicLib
@@ -9,6 +9,8 @@
 
 #include <GeographicLib/Georef.hpp>
 #include <GeographicLib/Utility.hpp>
+#include <GeographicLib/GeodesicRegion.hpp>
+#include <cstring>
 
 #if defined(_MSC_VER)
 // Squelch warnings about enum-float expressions
@@ -25,14 +27,19 @@ namespace GeographicLib {
   const char* const Georef::degrees_ = "ABCDEFGHJKLMNPQ";
 
   void Georef::Forward(real lat, real lon, int prec, string& georef) {
+    char georef1[MAXLENGTH + 1];
+    georef.assign(georef1, Forward(lat, lon, prec, georef1));
+  }
+
+  int Georef::Forward(real lat, real lon, int prec, char georef[]) {
     using std::isnan;           // Needed for Centos 7, ubuntu 14
     if (fabs(lat) > Math::qd)
       throw GeographicErr("Latitude " + Utility::str(lat)
                           + "d not in [-" + to_string(Math::qd)
                           + "d, " + to_string(Math::qd) + "d]");
     if (isnan(lat) || isnan(lon)) {
-      georef = "INVALID";
-      return;
+      copy("INVALID", "INVALID" + 8, georef);
+      return 7;
     }
     lon = Math::AngNormalize(lon); // lon in [-180,180)
     if (lat == Math::qd) lat *= (1 - numeric_limits<real>::epsilon() / 2);
@@ -47,7 +54,7 @@ namespace GeographicLib {
       x = (long long)(floor(lon * real(m))) - lonorig_ * m,
       y = (long long)(floor(lat * real(m))) - latorig_ * m;
     int ilon = int(x / m); int ilat = int(y / m);
-    char georef1[maxlen_];
+    char* georef1 = georef;     // Write the result directly
     georef1[0] = lontile_[ilon / tile_];
     georef1[1] = lattile_[ilat / tile_];
     if (prec >= 0) {
@@ -63,13 +70,23 @@ namespace GeographicLib {
         }
       }
     }
-    georef.resize(baselen_ + 2 * prec);
-    copy(georef1, georef1 + baselen_ + 2 * prec, georef.begin());
+    georef1[baselen_ + 2 * prec] = '\0';
+    return baselen_ + 2 * prec;
   }
 
-  void Georef::Reverse(const string& georef, real& lat, real& lon,
-                       int& prec, bool centerp) {
-    int len = int(georef.length());
+  void Georef::ForwardBatch(size_t n, const real lat[], const real lon[],
+                            int prec, char georef[]) {
+    for (size_t i = 0; i < n; ++i)
+      Forward(lat[i], lon[i], prec, georef + i * (MAXLENGTH + 1));
+  }
+
+  void Georef::Reverse(const char* georef, size_t len0,
+                       real& lat, real& lon, int& prec, bool centerp) {
+    // Strings for the error messages (allocated only if an error is thrown)
+    auto str = [georef, len0]() -> string { return string(georef, len0); };
+    auto tail = [georef, len0]() -> string
+      { return string(georef + baselen_, len0 - baselen_); };
+    int len = int(len0);
     if (len >= 3 &&
         toupper(georef[0]) == 'I' &&
         toupper(georef[1]) == 'N' &&
@@ -79,45 +96,46 @@ namespace GeographicLib {
     }
     if (len < baselen_ - 2)
       throw GeographicErr("Georef must start with at least 2 letters "
-                          + georef);
+                          + str());
     int prec1 = (2 + len - baselen_) / 2 - 1;
     int k;
     k = Utility::lookup(lontile_, georef[0]);
     if (k < 0)
-      throw GeographicErr("Bad longitude tile letter in georef " + georef);
+      throw GeographicErr("Bad longitude tile letter in georef " + str());
     real lon1 = k + lonorig_ / tile_;
     k = Utility::lookup(lattile_, georef[1]);
     if (k < 0)
-      throw GeographicErr("Bad latitude tile letter in georef " + georef);
+      throw GeographicErr("Bad latitude tile letter in georef " + str());
     real lat1 = k + latorig_ / tile_;
     real unit = 1;
     if (len > 2) {
       unit *= tile_;
       k = Utility::lookup(degrees_, georef[2]);
       if (k < 0)
-        throw GeographicErr("Bad longitude degree letter in georef " + georef);
+        throw GeographicErr("Bad longitude degree letter in georef " + str());
       lon1 = lon1 * tile_ + k;
       if (len < 4)
         throw GeographicErr("Missing latitude degree letter in georef "
-                            + georef);
+                            + str());
       k = Utility::lookup(degrees_, georef[3]);
       if (k < 0)
-        throw GeographicErr("Bad latitude degree letter in georef " + georef);
+        throw GeographicErr("Bad latitude degree letter in georef " + str());
       lat1 = lat1 * tile_ + k;
       if (prec1 > 0) {
-        if (georef.find_first_not_of(digits_, baselen_) != string::npos)
-          throw GeographicErr("Non digits in trailing portion of georef "
-                              + georef.substr(baselen_));
+        for (int i = baselen_; i < len; ++i)
+          if (!(georef[i] >= '0' && georef[i] <= '9'))
+            throw GeographicErr("Non digits in trailing portion of georef "
+                                + tail());
         if (len % 2)
           throw GeographicErr("Georef must end with an even number of digits "
-                              + georef.substr(baselen_));
+                              + tail());
         if (prec1 == 1)
           throw GeographicErr("Georef needs at least 4 digits for minutes "
-                              + georef.substr(baselen_));
+                              + tail());
         if (prec1 > maxprec_)
           throw GeographicErr("More than " + Utility::str(2*maxprec_)
                               + " digits in georef "
-                              + georef.substr(baselen_));
+                              + tail());
         for (int i = 0; i < prec1; ++i) {
           int m = i ? base_ : 6;
           unit *= m;
@@ -126,7 +144,7 @@ namespace GeographicLib {
             y = Utility::lookup(digits_, georef[baselen_ + i + prec1]);
           if (!(i || (x < m && y < m)))
             throw GeographicErr("Minutes terms in georef must be less than 60 "
-                                + georef.substr(baselen_));
+                                + tail());
           lon1 = m * lon1 + x;
           lat1 = m * lat1 + y;
         }
@@ -140,4 +158,32 @@ namespace GeographicLib {
     prec = prec1;
   }
 
+  void Georef::ReverseBatch(size_t n, const char georef[],
+                            real lat[], real lon[], int prec[],
+                            bool centerp) {
+    for (size_t i = 0; i < n; ++i) {
+      const char* s = georef + i * (MAXLENGTH + 1);
+      const void* e = memchr(s, '\0', MAXLENGTH + 1);
+      int precx = 0;
+      Reverse(s, e ? size_t(static_cast<const char*>(e) - s) : MAXLENGTH + 1,
+              lat[i], lon[i], prec ? prec[i] : precx, centerp);
+    }
+  }
+
+  void Georef::Cover(const GeodesicRegion& region, int prec,
+                     vector<string>& cells, bool compact) {
+    prec = max(-1, min(int(maxprec_), prec));
+    if (prec == 1) ++prec;      // Disallow prec = 1
+    // 15d tiles, 1d cells, 1' cells (reached via 10' cells), and then each
+    // further digit divides the cells into 10 x 10 cells.
+    GeodesicRegion::Level levels[3 + maxprec_];
+    levels[0] = { 12, 24, -1, true };
+    levels[1] = { tile_, tile_, 0, true };
+    levels[2] = { 6, 6, 0, false };
+    for (int p = 2; p <= maxprec_; ++p)
+      levels[p + 1] = { base_, base_, p, true };
+    void (*encode)(real, real, int, string&) = &Forward;
+    region.Cover(levels, prec + 2, encode, compact, cells);
+  }
+
 } // namespace GeographicLib
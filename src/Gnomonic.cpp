@@ -39,7 +39,7 @@ namespace GeographicLib {
       x = y = Math::NaN();
     else {
       real rho = m/M;
-      Math::sincosd(azi0, x, y);
+      Math::sincosdInline(azi0, x, y);
       x *= rho; y *= rho;
     }
   }
@@ -47,7 +47,7 @@ namespace GeographicLib {
   void Gnomonic::Reverse(real lat0, real lon0, real x, real y,
                          real& lat, real& lon, real& azi, real& rk) const {
     real
-      azi0 = Math::atan2d(x, y),
+      azi0 = Math::atan2dInline(x, y),
       rho = hypot(x, y),
       s = _a * atan(rho/_a);
     bool little = rho <= _a;
@@ -80,4 +80,30 @@ namespace GeographicLib {
     return;
   }
 
+  void Gnomonic::ForwardBatch(size_t n, real lat0, real lon0,
+                              const real lat[], const real lon[],
+                              real x[], real y[],
+                              real azi[], real rk[]) const {
+    for (size_t i = 0; i < n; ++i) {
+      real xi, yi, azii, rki;
+      Forward(lat0, lon0, lat[i], lon[i], xi, yi, azii, rki);
+      x[i] = xi; y[i] = yi;
+      if (azi) azi[i] = azii;
+      if (rk) rk[i] = rki;
+    }
+  }
+
+  void Gnomonic::ReverseBatch(size_t n, real lat0, real lon0,
+                              const real x[], const real y[],
+                              real lat[], real lon[],
+                              real azi[], real rk[]) const {
+    for (size_t i = 0; i < n; ++i) {
+      real lati, loni, azii, rki;
+      Reverse(lat0, lon0, x[i], y[i], lati, loni, azii, rki);
+      lat[i] = lati; lon[i] = loni;
+      if (azi) azi[i] = azii;
+      if (rk) rk[i] = rki;
+    }
+  }
+
 } // namespace GeographicLib
@@ -16,37 +16,33 @@ namespace GeographicLib {
 
   using namespace std;
 
-  GravityCircle::GravityCircle(mask caps, real a, real f, real lat, real h,
-                               real Z, real P, real cphi, real sphi,
-                               real amodel, real GMmodel,
-                               real dzonal0, real corrmult,
-                               real gamma0, real gamma, real frot,
-                               const CircularEngine& gravitational,
-                               const CircularEngine& disturbing,
-                               const CircularEngine& correction)
-    : _caps(caps)
-    , _a(a)
-    , _f(f)
-    , _lat(Math::LatFix(lat))
-    , _h(h)
-    , _zZ(Z)
-    , _pPx(P)
-    , _invR(1 / hypot(_pPx, _zZ))
-    , _cpsi(_pPx * _invR)
-    , _spsi(_zZ * _invR)
-    , _cphi(cphi)
-    , _sphi(sphi)
-    , _amodel(amodel)
-    , _gGMmodel(GMmodel)
-    , _dzonal0(dzonal0)
-    , _corrmult(corrmult)
-    , _gamma0(gamma0)
-    , _gamma(gamma)
-    , _frot(frot)
-    , _gravitational(gravitational)
-    , _disturbing(disturbing)
-    , _correction(correction)
-    {}
+  void GravityCircle::Reset(mask caps, real a, real f, real lat, real h,
+                            real Z, real P, real cphi, real sphi,
+                            real amodel, real GMmodel,
+                            real dzonal0, real corrmult,
+                            real gamma0, real gamma, real frot,
+                            real omega2) {
+    _caps = caps;
+    _a = a;
+    _f = f;
+    _lat = Math::LatFix(lat);
+    _h = h;
+    _zZ = Z;
+    _pPx = P;
+    _invR = 1 / hypot(_pPx, _zZ);
+    _cpsi = _pPx * _invR;
+    _spsi = _zZ * _invR;
+    _cphi = cphi;
+    _sphi = sphi;
+    _amodel = amodel;
+    _gGMmodel = GMmodel;
+    _dzonal0 = dzonal0;
+    _corrmult = corrmult;
+    _gamma0 = gamma0;
+    _gamma = gamma;
+    _frot = frot;
+    _omega2 = omega2;
+  }
 
   Math::real GravityCircle::Gravity(real lon,
                                     real& gx, real& gy, real& gz) const {
@@ -100,33 +96,52 @@ namespace GeographicLib {
   }
 
   Math::real GravityCircle::W(real slam, real clam,
-                              real& gX, real& gY, real& gZ) const {
-    real Wres = V(slam, clam, gX, gY, gZ) + _frot * _pPx / 2;
+                              real& gX, real& gY, real& gZ,
+                              real Wij[]) const {
+    real Wres = V(slam, clam, gX, gY, gZ, Wij) + _frot * _pPx / 2;
     gX += _frot * clam;
     gY += _frot * slam;
+    if (Wij) {
+      Wij[0] += _omega2;
+      Wij[4] += _omega2;
+    }
     return Wres;
   }
 
   Math::real GravityCircle::V(real slam, real clam,
-                              real& GX, real& GY, real& GZ) const {
-    if ((_caps & GRAVITY) != GRAVITY) {
+                              real& GX, real& GY, real& GZ,
+                              real Vij[]) const {
+    if ((_caps & GRAVITY) != GRAVITY ||
+        (Vij && (_caps & GRAVITY_GRADIENT) != GRAVITY_GRADIENT)) {
       GX = GY = GZ = Math::NaN();
+      if (Vij)
+        for (int k = 0; k < 9; ++k) Vij[k] = Math::NaN();
       return Math::NaN();
     }
     real
-      Vres = _gravitational(slam, clam, GX, GY, GZ),
+      Vres = Vij ? _gravitational(slam, clam, GX, GY, GZ, Vij) :
+      _gravitational(slam, clam, GX, GY, GZ),
       f = _gGMmodel / _amodel;
     Vres *= f;
     GX *= f;
     GY *= f;
     GZ *= f;
+    if (Vij)
+      for (int k = 0; k < 9; ++k) Vij[k] *= f;
     return Vres;
   }
 
   Math::real GravityCircle::InternalT(real slam, real clam,
                                       real& deltaX, real& deltaY, real& deltaZ,
-                                      bool gradp, bool correct) const {
-    if (gradp) {
+                                      bool gradp, bool correct,
+                                      real Tij[]) const {
+    if (Tij) {
+      if ((_caps & DISTURBANCE_GRADIENT) != DISTURBANCE_GRADIENT) {
+        deltaX = deltaY = deltaZ = Math::NaN();
+        for (int k = 0; k < 9; ++k) Tij[k] = Math::NaN();
+        return Math::NaN();
+      }
+    } else if (gradp) {
       if ((_caps & DISTURBANCE) != DISTURBANCE) {
         deltaX = deltaY = deltaZ = Math::NaN();
         return Math::NaN();
@@ -137,7 +152,8 @@ namespace GeographicLib {
     }
     if (_dzonal0 == 0)
       correct = false;
-    real T = (gradp
+    real T = (Tij ? _disturbing(slam, clam, deltaX, deltaY, deltaZ, Tij) :
+              gradp
               ? _disturbing(slam, clam, deltaX, deltaY, deltaZ)
               : _disturbing(slam, clam));
     T = (T / _amodel - (correct ? _dzonal0 : 0) * _invR) * _gGMmodel;
@@ -153,6 +169,21 @@ namespace GeographicLib {
         deltaZ += _zZ * r3;
       }
     }
+    if (Tij) {
+      real f = _gGMmodel / _amodel;
+      for (int k = 0; k < 9; ++k)
+        Tij[k] *= f;
+      if (correct) {
+        // The second derivatives of - GM * dzonal0 / R
+        real
+          X3[] = {_pPx * clam, _pPx * slam, _zZ},
+          g = _gGMmodel * _dzonal0 * Math::sq(_invR) * Math::sq(_invR) * _invR,
+          R2 = 1 / Math::sq(_invR);
+        for (int i = 0; i < 3; ++i)
+          for (int j = 0; j < 3; ++j)
+            Tij[3 * i + j] += g * ((i == j ? R2 : 0) - 3 * X3[i] * X3[j]);
+      }
+    }
     return T;
   }
 
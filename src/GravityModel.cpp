@@ -8,10 +8,15 @@
  **********************************************************************/
 
 #include <GeographicLib/GravityModel.hpp>
+#include <algorithm>
 #include <fstream>
+#include <functional>
 #include <limits>
 #include <GeographicLib/SphericalEngine.hpp>
 #include <GeographicLib/GravityCircle.hpp>
+#include <GeographicLib/GeodesicBatchExecutor.hpp>
+#include <GeographicLib/SharedInstances.hpp>
+#include <GeographicLib/Trace.hpp>
 #include <GeographicLib/Utility.hpp>
 
 #if !defined(GEOGRAPHICLIB_DATA)
@@ -36,7 +41,7 @@ namespace GeographicLib {
   using namespace std;
 
   GravityModel::GravityModel(const std::string& name, const std::string& path,
-                             int Nmax, int Mmax)
+                             int Nmax, int Mmax, bool mapfile)
     : _name(name)
     , _dir(path)
     , _description("NONE")
@@ -48,7 +53,12 @@ namespace GeographicLib {
     , _nmx(-1)
     , _mmx(-1)
     , _norm(SphericalHarmonic::FULL)
+    , _coeffs(make_shared<coeffstore>())
+    , _circledlat(Math::NaN())
+    , _circledh(Math::NaN())
+    , _trunctol(0)
   {
+    GEOGRAPHICLIB_TRACE_SPAN("GravityModel::GravityModel");
     if (_dir.empty())
       _dir = DefaultGravityPath();
     bool truncate = Nmax >= 0 || Mmax >= 0;
@@ -58,8 +68,43 @@ namespace GeographicLib {
       if (Mmax < 0) Mmax = numeric_limits<int>::max();
     }
     ReadMetadata(_name);
-    {
-      string coeff = _filename + ".cof";
+    string coeff = _filename + ".cof";
+    if (mapfile) {
+      _coeffs->cofmap.map(coeff);
+      char* data = _coeffs->cofmap.data();
+      const char* end = data + _coeffs->cofmap.size();
+      if (end - data < idlength_)
+        throw GeographicErr("No header in " + coeff);
+      if (_id != string(data, idlength_))
+        throw GeographicErr("ID mismatch: " + _id + " vs " +
+                            string(data, idlength_));
+      data += idlength_;
+      int N, M;
+      real* C;
+      if (truncate) { N = Nmax; M = Mmax; }
+      SphericalEngine::coeff c =
+        SphericalEngine::coeff::mapcoeffs(data, end, N, M, C, truncate);
+      if (!(N >= 0 && M >= 0))
+        throw GeographicErr("Degree and order must be at least 0");
+      if (C[0] != 0)
+        throw GeographicErr("The degree 0 term should be zero");
+      C[0] = 1;                 // Include the 1/r term in the sum
+      _gravitational = SphericalHarmonic(c, _amodel, _norm);
+      if (truncate) { N = Nmax; M = Mmax; }
+      c = SphericalEngine::coeff::mapcoeffs(data, end, N, M, C, truncate);
+      if (N < 0) {
+        N = M = 0;
+        _coeffs->cCC.resize(1, real(0));
+        _coeffs->cCC[0] += _zeta0 / _corrmult;
+        _correction = SphericalHarmonic(_coeffs->cCC, _coeffs->cCS,
+                                        N, N, M, real(1), _norm);
+      } else {
+        C[0] += _zeta0 / _corrmult;
+        _correction = SphericalHarmonic(c, real(1), _norm);
+      }
+      if (data != end)
+        throw GeographicErr("Extra data in " + coeff);
+    } else {
       ifstream coeffstr(coeff.c_str(), ios::binary);
       if (!coeffstr.good())
         throw GeographicErr("Error opening " + coeff);
@@ -70,28 +115,106 @@ namespace GeographicLib {
       id[idlength_] = '\0';
       if (_id != string(id))
         throw GeographicErr("ID mismatch: " + _id + " vs " + id);
-      int N, M;
-      if (truncate) { N = Nmax; M = Mmax; }
-      SphericalEngine::coeff::readcoeffs(coeffstr, N, M, _cCx, _sSx, truncate);
-      if (!(N >= 0 && M >= 0))
+      streamoff size = coeffstr.seekg(0, ios::end).tellg();
+      coeffstr.close();
+      // Read the gravitational and correction coefficients together, using
+      // several threads.
+      int N[2], M[2];
+      vector<real> C[2], S[2];
+      if (truncate) { N[0] = N[1] = Nmax; M[0] = M[1] = Mmax; }
+      streamoff pos =
+        SphericalEngine::coeff::readcoeffs(coeff, idlength_, 2, N, M, C, S,
+                                           truncate);
+      _coeffs->cCx.swap(C[0]); _coeffs->sSx.swap(S[0]);
+      _coeffs->cCC.swap(C[1]); _coeffs->cCS.swap(S[1]);
+      if (!(N[0] >= 0 && M[0] >= 0))
         throw GeographicErr("Degree and order must be at least 0");
-      if (_cCx[0] != 0)
+      if (_coeffs->cCx[0] != 0)
         throw GeographicErr("The degree 0 term should be zero");
-      _cCx[0] = 1;              // Include the 1/r term in the sum
-      _gravitational = SphericalHarmonic(_cCx, _sSx, N, N, M, _amodel, _norm);
-      if (truncate) { N = Nmax; M = Mmax; }
-      SphericalEngine::coeff::readcoeffs(coeffstr, N, M, _cCC, _cCS, truncate);
-      if (N < 0) {
-        N = M = 0;
-        _cCC.resize(1, real(0));
+      _coeffs->cCx[0] = 1;              // Include the 1/r term in the sum
+      _gravitational = SphericalHarmonic(_coeffs->cCx, _coeffs->sSx,
+                                         N[0], N[0], M[0], _amodel, _norm);
+      if (N[1] < 0) {
+        N[1] = M[1] = 0;
+        _coeffs->cCC.resize(1, real(0));
       }
-      _cCC[0] += _zeta0 / _corrmult;
-      _correction = SphericalHarmonic(_cCC, _cCS, N, N, M, real(1), _norm);
-      int pos = int(coeffstr.tellg());
-      coeffstr.seekg(0, ios::end);
-      if (pos != coeffstr.tellg())
+      _coeffs->cCC[0] += _zeta0 / _corrmult;
+      _correction = SphericalHarmonic(_coeffs->cCC, _coeffs->cCS,
+                                      N[1], N[1], M[1], real(1), _norm);
+      if (pos != size)
         throw GeographicErr("Extra data in " + coeff);
     }
+    SetupSums();
+  }
+
+  GravityModel::GravityModel(const GravityModel& model)
+    : _name(model._name)
+    , _dir(model._dir)
+    , _description(model._description)
+    , _date(model._date)
+    , _filename(model._filename)
+    , _id(model._id)
+    , _amodel(model._amodel)
+    , _gGMmodel(model._gGMmodel)
+    , _zeta0(model._zeta0)
+    , _corrmult(model._corrmult)
+    , _nmx(-1)
+    , _mmx(-1)
+    , _norm(model._norm)
+    , _earth(model._earth)
+    , _coeffs(model._coeffs)
+    , _gravitational(model._gravitational)
+    , _correction(model._correction)
+    , _circledlat(model._circledlat)
+    , _circledh(model._circledh)
+    , _trunctol(model._trunctol)
+    , _truncbound(model._truncbound)
+  {
+    // _disturbing refers to _zonal, so set it up afresh
+    SetupSums();
+    _circles.Reset(model._circles.Capacity());
+  }
+
+  GravityModel::GravityModel(const GravityModel& model, int Nmax, int Mmax)
+    : _name(model._name)
+    , _dir(model._dir)
+    , _description(model._description)
+    , _date(model._date)
+    , _filename(model._filename)
+    , _id(model._id)
+    , _amodel(model._amodel)
+    , _gGMmodel(model._gGMmodel)
+    , _zeta0(model._zeta0)
+    , _corrmult(model._corrmult)
+    , _nmx(-1)
+    , _mmx(-1)
+    , _norm(model._norm)
+    , _earth(model._earth)
+    , _coeffs(model._coeffs)
+    , _circledlat(Math::NaN())
+    , _circledh(Math::NaN())
+    , _trunctol(0)
+  {
+    if (Nmax < 0)
+      Nmax = Mmax = numeric_limits<int>::max();
+    else if (Mmax < 0)
+      Mmax = Nmax;
+    else if (Mmax > Nmax)
+      throw GeographicErr("Bad requested degree and order " +
+                          Utility::str(Nmax) + " " + Utility::str(Mmax));
+    _gravitational =
+      SphericalHarmonic(SphericalEngine::coeff
+                        (model._gravitational.Coefficients(), Nmax, Mmax),
+                        _amodel, _norm);
+    SphericalEngine::coeff c(model._correction.Coefficients(), Nmax, Mmax);
+    if (c.nmx() < 0)
+      // The truncated correction sum only contains _zeta0
+      c = SphericalEngine::coeff(model._correction.Coefficients(), 0, 0);
+    _correction = SphericalHarmonic(c, real(1), _norm);
+    SetupSums();
+  }
+
+  void GravityModel::SetupSums() {
     int nmx = _gravitational.Coefficients().nmx();
     _nmx = max(nmx, _correction.Coefficients().nmx());
     _mmx = max(_gravitational.Coefficients().mmx(),
@@ -112,7 +235,7 @@ namespace GeographicLib {
       // goes out to n = 18.
       mult *= amult;
       real
-        r = _cCx[n],                                       // the model term
+        r = _gravitational.Coefficients().Cv(n),           // the model term
         s = - mult * _earth.Jn(n) / sqrt(real(2 * n + 1)), // the normal term
         t = r - s;                                         // the difference
       if (t == r)               // the normal term is negligible
@@ -121,16 +244,22 @@ namespace GeographicLib {
       _zonal.push_back(s);
     }
     int nmx1 = int(_zonal.size()) - 1;
-    _disturbing = SphericalHarmonic1(_cCx, _sSx,
-                                     _gravitational.Coefficients().N(),
-                                     nmx, _gravitational.Coefficients().mmx(),
-                                     _zonal,
-                                     _zonal, // This is not accessed!
-                                     nmx1, nmx1, 0,
+    _disturbing = SphericalHarmonic1(_gravitational.Coefficients(),
+                                     SphericalEngine::coeff
+                                     (_zonal,
+                                      _zonal, // This is not accessed!
+                                      nmx1, nmx1, 0),
                                      _amodel,
                                      SphericalHarmonic1::normalization(_norm));
   }
 
+  const GravityModel& GravityModel::Get(const string& name,
+                                        const string& path) {
+    static SharedInstances<GravityModel, string> instances;
+    string dir = path.empty() ? DefaultGravityPath() : path;
+    return instances.Get(name + '\0' + dir, name, dir);
+  }
+
   void GravityModel::ReadMetadata(const string& name) {
     const char* spaces = " \t\n\v\f\r";
     _filename = _dir + "/" + name + ".egm";
@@ -212,39 +341,93 @@ namespace GeographicLib {
 
   Math::real GravityModel::InternalT(real X, real Y, real Z,
                                      real& deltaX, real& deltaY, real& deltaZ,
-                                     bool gradp, bool correct) const {
+                                     bool gradp, bool correct,
+                                     real Tij[]) const {
+    int N = TruncatedDegree(X, Y, Z);
+    // Don't truncate the normal zonal terms (these are few in number).
+    N = N < 0 ? N : max(N, _disturbing.Coefficients1().nmx());
+    const SphericalHarmonic1& disturbing =
+      N < 0 || N >= _disturbing.Coefficients().nmx() ? _disturbing :
+      SphericalHarmonic1(SphericalEngine::coeff
+                         (_disturbing.Coefficients(), N, N),
+                         _disturbing.Coefficients1(), _amodel, _norm);
+    real T;
+    if (Tij)
+      T = disturbing.Hessian(-1, X, Y, Z, deltaX, deltaY, deltaZ, Tij);
+    else if (gradp) {
+      // initial values to suppress warnings
+      deltaX = deltaY = deltaZ = 0;
+      T = disturbing(-1, X, Y, Z, deltaX, deltaY, deltaZ);
+    } else
+      T = disturbing(-1, X, Y, Z);
+    if (Tij) {
+      real f = _gGMmodel / _amodel;
+      for (int k = 0; k < 9; ++k)
+        Tij[k] *= f;
+      if (correct && _dzonal0 != 0) {
+        // The second derivatives of - GM * dzonal0 / R
+        real
+          X3[] = {X, Y, Z},
+          R2 = Math::sq(hypot(hypot(X, Y), Z)),
+          g = _gGMmodel * _dzonal0 / (R2 * R2 * sqrt(R2));
+        for (int i = 0; i < 3; ++i)
+          for (int j = 0; j < 3; ++j)
+            Tij[3 * i + j] += g * ((i == j ? R2 : 0) - 3 * X3[i] * X3[j]);
+      }
+    }
+    return ScaleT(X, Y, Z, T, deltaX, deltaY, deltaZ, gradp, correct);
+  }
+
+  Math::real GravityModel::T(real X, real Y, real Z,
+                             real& deltaX, real& deltaY, real& deltaZ,
+                             real Tij[]) const {
+    return InternalT(X, Y, Z, deltaX, deltaY, deltaZ, true, true, Tij);
+  }
+
+  Math::real GravityModel::ScaleT(real X, real Y, real Z, real T,
+                                  real& deltaX, real& deltaY, real& deltaZ,
+                                  bool gradp, bool correct) const {
     // If correct, then produce the correct T = W - U.  Otherwise, neglect the
     // n = 0 term (which is proportial to the difference in the model and
     // reference values of GM).
     if (_dzonal0 == 0)
       // No need to do the correction
       correct = false;
-    real T, invR = correct ? 1 / hypot(hypot(X, Y), Z) : 1;
+    real invR = correct ? 1 / hypot(hypot(X, Y), Z) : 1;
     if (gradp) {
-      // initial values to suppress warnings
-      deltaX = deltaY = deltaZ = 0;
-      T = _disturbing(-1, X, Y, Z, deltaX, deltaY, deltaZ);
       real f = _gGMmodel / _amodel;
       deltaX *= f;
       deltaY *= f;
       deltaZ *= f;
       if (correct) {
-        invR = _gGMmodel * _dzonal0 * invR * invR * invR;
-        deltaX += X * invR;
-        deltaY += Y * invR;
-        deltaZ += Z * invR;
+        // Don't overwrite invR, which is needed for T below
+        real g = _gGMmodel * _dzonal0 * invR * invR * invR;
+        deltaX += X * g;
+        deltaY += Y * g;
+        deltaZ += Z * g;
       }
-    } else
-      T = _disturbing(-1, X, Y, Z);
+    }
     T = (T / _amodel - (correct ? _dzonal0 : 0) * invR) * _gGMmodel;
     return T;
   }
 
   Math::real GravityModel::V(real X, real Y, real Z,
                              real& GX, real& GY, real& GZ) const {
-    real
-      Vres = _gravitational(X, Y, Z, GX, GY, GZ),
-      f = _gGMmodel / _amodel;
+    int N = TruncatedDegree(X, Y, Z);
+    real Vres, f = _gGMmodel / _amodel;
+    if (N >= 0 && _gravitational.Packed())
+      // The packed coefficients can be truncated directly
+      Vres = _norm == SphericalHarmonic::FULL ?
+        SphericalEngine::ValuePacked<true, SphericalEngine::FULL>
+        (*_gravitational.Packed(), N, X, Y, Z, _amodel, GX, GY, GZ) :
+        SphericalEngine::ValuePacked<true, SphericalEngine::SCHMIDT>
+        (*_gravitational.Packed(), N, X, Y, Z, _amodel, GX, GY, GZ);
+    else if (N >= 0 && N < _gravitational.Coefficients().nmx())
+      Vres = SphericalHarmonic(SphericalEngine::coeff
+                               (_gravitational.Coefficients(), N, N),
+                               _amodel, _norm)(X, Y, Z, GX, GY, GZ);
+    else
+      Vres = _gravitational(X, Y, Z, GX, GY, GZ);
     Vres *= f;
     GX *= f;
     GY *= f;
@@ -261,13 +444,61 @@ namespace GeographicLib {
     return Wres;
   }
 
+  Math::real GravityModel::V(real X, real Y, real Z,
+                             real& GX, real& GY, real& GZ,
+                             real Vij[]) const {
+    // Follow V, except that the packed coefficients aren't used
+    int N = TruncatedDegree(X, Y, Z);
+    real Vres, f = _gGMmodel / _amodel;
+    if (N >= 0 && N < _gravitational.Coefficients().nmx())
+      Vres = SphericalHarmonic(SphericalEngine::coeff
+                               (_gravitational.Coefficients(), N, N),
+                               _amodel, _norm)
+        .Hessian(X, Y, Z, GX, GY, GZ, Vij);
+    else
+      Vres = _gravitational.Hessian(X, Y, Z, GX, GY, GZ, Vij);
+    Vres *= f;
+    GX *= f;
+    GY *= f;
+    GZ *= f;
+    for (int k = 0; k < 9; ++k)
+      Vij[k] *= f;
+    return Vres;
+  }
+
+  Math::real GravityModel::W(real X, real Y, real Z,
+                             real& gX, real& gY, real& gZ,
+                             real Wij[]) const {
+    real fX, fY,
+      Wres = V(X, Y, Z, gX, gY, gZ, Wij) + _earth.Phi(X, Y, fX, fY),
+      // The second derivatives of Phi = omega^2 * (X^2 + Y^2) / 2
+      omega2 = Math::sq(_earth.AngularVelocity());
+    gX += fX;
+    gY += fY;
+    Wij[0] += omega2;
+    Wij[4] += omega2;
+    return Wres;
+  }
+
   void GravityModel::SphericalAnomaly(real lat, real lon, real h,
                                       real& Dg01, real& xi, real& eta) const {
+    shared_ptr<const GravityCircle> c(CachedCircle(lat, h));
+    if (c) {
+      c->SphericalAnomaly(lon, Dg01, xi, eta);
+      return;
+    }
     real X, Y, Z, M[Geocentric::dim2_];
     _earth.Earth().IntForward(lat, lon, h, X, Y, Z, M);
     real
       deltax, deltay, deltaz,
-      T = InternalT(X, Y, Z, deltax, deltay, deltaz, true, false),
+      T = InternalT(X, Y, Z, deltax, deltay, deltaz, true, false);
+    Anomaly(X, Y, Z, M, T, deltax, deltay, deltaz, Dg01, xi, eta);
+  }
+
+  void GravityModel::Anomaly(real X, real Y, real Z, const real M[],
+                             real T, real deltax, real deltay, real deltaz,
+                             real& Dg01, real& xi, real& eta) const {
+    real
       clam = M[3], slam = -M[0],
       P = hypot(X, Y),
       R = hypot(P, Z),
@@ -289,12 +520,21 @@ namespace GeographicLib {
 
   Math::real GravityModel::GeoidHeight(real lat, real lon) const
   {
+    shared_ptr<const GravityCircle> c(CachedCircle(lat, 0));
+    if (c)
+      return c->GeoidHeight(lon);
     real X, Y, Z;
     _earth.Earth().IntForward(lat, lon, 0, X, Y, Z, NULL);
     real
-      gamma0 = _earth.SurfaceGravity(lat),
       dummy,
-      T = InternalT(X, Y, Z, dummy, dummy, dummy, false, false),
+      T = InternalT(X, Y, Z, dummy, dummy, dummy, false, false);
+    return Geoid(lat, X, Y, Z, T);
+  }
+
+  Math::real GravityModel::Geoid(real lat, real X, real Y, real Z,
+                                 real T) const {
+    real
+      gamma0 = _earth.SurfaceGravity(lat),
       invR = 1 / hypot(hypot(X, Y), Z),
       correction = _corrmult * _correction(invR * X, invR * Y, invR * Z);
     // _zeta0 has been included in _correction
@@ -303,15 +543,180 @@ namespace GeographicLib {
 
   Math::real GravityModel::Gravity(real lat, real lon, real h,
                                    real& gx, real& gy, real& gz) const {
+    shared_ptr<const GravityCircle> c(CachedCircle(lat, h));
+    if (c)
+      return c->Gravity(lon, gx, gy, gz);
     real X, Y, Z, M[Geocentric::dim2_];
     _earth.Earth().IntForward(lat, lon, h, X, Y, Z, M);
     real Wres = W(X, Y, Z, gx, gy, gz);
     Geocentric::Unrotate(M, gx, gy, gz, gx, gy, gz);
     return Wres;
   }
+
+  void GravityModel::GravityBatch(size_t n, const real lat[],
+                                  const real lon[], const real h[], real W[],
+                                  real gx[], real gy[], real gz[],
+                                  unsigned nthreads) const {
+    Batch(BATCH_GRAVITY, n, lat, lon, h, W, gx, gy, gz, nthreads);
+  }
+
+  void GravityModel::DisturbanceBatch(size_t n, const real lat[],
+                                      const real lon[], const real h[],
+                                      real T[], real deltax[], real deltay[],
+                                      real deltaz[], unsigned nthreads) const {
+    Batch(BATCH_DISTURBANCE, n, lat, lon, h, T, deltax, deltay, deltaz,
+          nthreads);
+  }
+
+  void GravityModel::GeoidHeightBatch(size_t n, const real lat[],
+                                      const real lon[], real N[],
+                                      unsigned nthreads) const {
+    Batch(BATCH_GEOID, n, lat, lon, nullptr, N, nullptr, nullptr, nullptr,
+          nthreads);
+  }
+
+  void GravityModel::SphericalAnomalyBatch(size_t n, const real lat[],
+                                           const real lon[], const real h[],
+                                           real Dg01[], real xi[], real eta[],
+                                           unsigned nthreads) const {
+    Batch(BATCH_ANOMALY, n, lat, lon, h, Dg01, xi, eta, nullptr, nthreads);
+  }
+
+  void GravityModel::Batch(batchtype type, size_t n,
+                           const real lat[], const real lon[], const real h[],
+                           real r0[], real r1[], real r2[], real r3[],
+                           unsigned nthreads) const {
+    // The geoid height is evaluated on the ellipsoid
+    auto height = [h](size_t i) -> real { return h ? h[i] : 0; };
+    // Sort the points by latitude and height so that the points on each
+    // circle of latitude are adjacent; the points with NaNs are put at the
+    // end (unsorted) and are treated as scattered points.
+    vector<size_t> idx(n);
+    for (size_t i = 0; i < n; ++i) idx[i] = i;
+    size_t nfinite = size_t(partition(idx.begin(), idx.end(),
+                                      [&](size_t i) -> bool {
+                                        return !(isnan(lat[i]) ||
+                                                 isnan(height(i)));
+                                      }) - idx.begin());
+    sort(idx.begin(), idx.begin() + nfinite,
+         [&](size_t i, size_t j) -> bool {
+           return lat[i] < lat[j] ||
+             (lat[i] == lat[j] && height(i) < height(j));
+         });
+    // Runs of at least circlemin_ points with the same latitude and height
+    // are evaluated with a GravityCircle, the rest with ValueBatch.
+    vector<size_t> circles, scattered;
+    for (size_t i = 0; i < n;) {
+      size_t j = i + 1;
+      if (i < nfinite)
+        while (j < nfinite && lat[idx[j]] == lat[idx[i]] &&
+               height(idx[j]) == height(idx[i]))
+          ++j;
+      if (j - i >= circlemin_)
+        circles.push_back(i);
+      else
+        for (size_t k = i; k < j; ++k) scattered.push_back(idx[k]);
+      i = j;
+    }
+    unsigned caps = type == BATCH_GRAVITY ? GRAVITY :
+      (type == BATCH_DISTURBANCE ? DISTURBANCE :
+       (type == BATCH_GEOID ? GEOID_HEIGHT : SPHERICAL_ANOMALY));
+    GeodesicBatchExecutor(nthreads, 1).
+      ForEach(circles.size(), [&](size_t c0, size_t c1) -> void {
+        GravityCircle circ;
+        for (size_t c = c0; c < c1; ++c) {
+          size_t i = circles[c], i0 = idx[i];
+          Circle(lat[i0], height(i0), caps, circ);
+          for (; i < n && i < nfinite && lat[idx[i]] == lat[i0] &&
+                 height(idx[i]) == height(i0); ++i) {
+            size_t j = idx[i];
+            switch (type) {
+            case BATCH_GRAVITY:
+              r0[j] = circ.Gravity(lon[j], r1[j], r2[j], r3[j]);
+              break;
+            case BATCH_DISTURBANCE:
+              r0[j] = circ.Disturbance(lon[j], r1[j], r2[j], r3[j]);
+              break;
+            case BATCH_GEOID:
+              r0[j] = circ.GeoidHeight(lon[j]);
+              break;
+            case BATCH_ANOMALY:
+            default:
+              circ.SphericalAnomaly(lon[j], r0[j], r1[j], r2[j]);
+              break;
+            }
+          }
+        }
+      });
+    // Follow Gravity, Disturbance, GeoidHeight, and SphericalAnomaly,
+    // hoisting the spherical harmonic sums
+    GeodesicBatchExecutor(nthreads, batchchunk_).
+      ForEach(scattered.size(), [&](size_t k0, size_t k1) -> void {
+        size_t m = k1 - k0;
+        vector<real> X(m), Y(m), Z(m), M(m * Geocentric::dim2_),
+          v(m), gX(m), gY(m), gZ(m);
+        for (size_t k = 0; k < m; ++k) {
+          size_t j = scattered[k0 + k];
+          _earth.Earth().IntForward(lat[j], lon[j], height(j),
+                                    X[k], Y[k], Z[k],
+                                    &M[k * Geocentric::dim2_]);
+        }
+        if (type == BATCH_GRAVITY)
+          _gravitational.ValueBatch(m, X.data(), Y.data(), Z.data(),
+                                    v.data(), gX.data(), gY.data(),
+                                    gZ.data());
+        else if (type == BATCH_GEOID)
+          _disturbing.ValueBatch(-1, m, X.data(), Y.data(), Z.data(),
+                                 v.data());
+        else
+          _disturbing.ValueBatch(-1, m, X.data(), Y.data(), Z.data(),
+                                 v.data(), gX.data(), gY.data(), gZ.data());
+        real f = _gGMmodel / _amodel;
+        for (size_t k = 0; k < m; ++k) {
+          size_t j = scattered[k0 + k];
+          const real* Mk = &M[k * Geocentric::dim2_];
+          switch (type) {
+          case BATCH_GRAVITY:
+            {
+              real fX, fY;
+              r0[j] = v[k] * f + _earth.Phi(X[k], Y[k], fX, fY);
+              Geocentric::Unrotate(Mk, gX[k] * f + fX, gY[k] * f + fY,
+                                   gZ[k] * f, r1[j], r2[j], r3[j]);
+            }
+            break;
+          case BATCH_DISTURBANCE:
+            r0[j] = ScaleT(X[k], Y[k], Z[k], v[k], gX[k], gY[k], gZ[k],
+                           true, true);
+            Geocentric::Unrotate(Mk, gX[k], gY[k], gZ[k],
+                                 r1[j], r2[j], r3[j]);
+            break;
+          case BATCH_GEOID:
+            {
+              real T = ScaleT(X[k], Y[k], Z[k], v[k], gX[k], gY[k], gZ[k],
+                              false, false);
+              r0[j] = Geoid(lat[j], X[k], Y[k], Z[k], T);
+            }
+            break;
+          case BATCH_ANOMALY:
+          default:
+            {
+              real T = ScaleT(X[k], Y[k], Z[k], v[k], gX[k], gY[k], gZ[k],
+                              true, false);
+              Anomaly(X[k], Y[k], Z[k], Mk, T, gX[k], gY[k], gZ[k],
+                      r0[j], r1[j], r2[j]);
+            }
+            break;
+          }
+        }
+      });
+  }
+
   Math::real GravityModel::Disturbance(real lat, real lon, real h,
                                        real& deltax, real& deltay,
                                        real& deltaz) const {
+    shared_ptr<const GravityCircle> c(CachedCircle(lat, h));
+    if (c)
+      return c->Disturbance(lon, deltax, deltay, deltaz);
     real X, Y, Z, M[Geocentric::dim2_];
     _earth.Earth().IntForward(lat, lon, h, X, Y, Z, M);
     real Tres = InternalT(X, Y, Z, deltax, deltay, deltaz, true, true);
@@ -319,7 +724,95 @@ namespace GeographicLib {
     return Tres;
   }
 
-  GravityCircle GravityModel::Circle(real lat, real h, unsigned caps) const {
+  void GravityModel::CacheCircles(real dlat, real dh,
+                                  unsigned long long maxbytes) const {
+    if (!(dlat > 0 && dh > 0))
+      throw GeographicErr("Latitude and height quanta must be positive");
+    _circledlat = dlat;
+    _circledh = dh;
+    _circles.Reset(size_t(max(1ULL, maxbytes / CircleBytes())));
+  }
+
+  unsigned long long GravityModel::CircleBytes() const {
+    // The circle holds 3 CircularEngines each with 6 arrays of size Mmax + 1
+    return sizeof(GravityCircle) + 18ULL * sizeof(real) * (max(_mmx, 0) + 1);
+  }
+
+  size_t GravityModel::MemoryUsage() const {
+    size_t bytes = sizeof(*this) +
+      (_zonal.capacity() + _truncbound.capacity()) * sizeof(real) +
+      size_t(_circles.Size() * CircleBytes());
+    if (_coeffs)
+      bytes += sizeof(coeffstore) +
+        (_coeffs->cCx.capacity() + _coeffs->sSx.capacity() +
+         _coeffs->cCC.capacity() + _coeffs->cCS.capacity()) * sizeof(real);
+    if (_gravitational.Packed())
+      bytes += _gravitational.Packed()->MemoryUsage();
+    return bytes;
+  }
+
+  unsigned long long GravityModel::CostEstimate() const {
+    // The sum with its gradient and the conversions to and from geocentric
+    // coordinates (about 100 operations)
+    const SphericalEngine::coeff& c = _gravitational.Coefficients();
+    return SphericalEngine::CostEstimate(c.nmx(), c.mmx(), 1, 1) + 100;
+  }
+
+  void GravityModel::CircleCacheClear() const {
+    _circles.Reset(0);
+  }
+
+  void GravityModel::PackCoefficients(int nsingle) {
+    _gravitational.Pack(nsingle);
+  }
+
+  void GravityModel::SetTruncationTolerance(real tol) const {
+    if (!(tol >= 0))
+      throw GeographicErr("Truncation tolerance must be nonnegative");
+    if (tol > 0 && _truncbound.empty())
+      _truncbound = SphericalEngine::GradientBounds
+        (_gravitational.Coefficients(), SphericalEngine::normalization(_norm));
+    _trunctol = tol;
+  }
+
+  int GravityModel::TruncatedDegree(real X, real Y, real Z) const {
+    if (_trunctol == 0) return -1;
+    // The gradients of the sums are multiplied by GM/a.
+    real r = hypot(hypot(X, Y), Z);
+    return SphericalEngine::TruncatedDegree
+      (_truncbound, _amodel / r, _trunctol * r * _amodel / _gGMmodel);
+  }
+
+  shared_ptr<const GravityCircle>
+  GravityModel::CachedCircle(real lat, real h) const {
+    if (_circles.Capacity() == 0)
+      return nullptr;
+    real
+      ilat = round(lat / _circledlat),
+      ih = round(h / _circledh),
+      // Beyond this the quantized values can't be represented as keys
+      maxkey = real(1ULL << 62);
+    if (!(fabs(ilat) < maxkey && fabs(ih) < maxkey))
+      return nullptr;           // Caught NaNs here too
+    CircleCache<GravityCircle>::key k = {(long long)(ilat), (long long)(ih),
+                                         0};
+    return _circles.Get(k, [this, ilat, ih]() -> GravityCircle {
+      // Rounding may put the latitude just beyond a pole
+      return Circle(fmax(-real(Math::qd),
+                         fmin(real(Math::qd), ilat * _circledlat)),
+                    ih * _circledh);
+    });
+  }
+
+  GravityCircle GravityModel::Circle(real lat, real h, unsigned caps,
+                                     unsigned nthreads) const {
+    GravityCircle circ;
+    Circle(lat, h, caps, circ, nthreads);
+    return circ;
+  }
+
+  void GravityModel::Circle(real lat, real h, unsigned caps,
+                            GravityCircle& circ, unsigned nthreads) const {
     if (h != 0)
       // Disallow invoking GeoidHeight unless h is zero.
       caps &= ~(CAP_GAMMA0 | CAP_C);
@@ -337,20 +830,38 @@ namespace GeographicLib {
     } else
       gamma = Math::NaN();
     _earth.Phi(X, Y, fx, fy);
-    return GravityCircle(GravityCircle::mask(caps),
-                         _earth._a, _earth._f, lat, h, Z, X, M[7], M[8],
-                         _amodel, _gGMmodel, _dzonal0, _corrmult,
-                         gamma0, gamma, fx,
-                         caps & CAP_G ?
-                         _gravitational.Circle(X, Z, true) :
-                         CircularEngine(),
-                         // N.B. If CAP_DELTA is set then CAP_T should be too.
-                         caps & CAP_T ?
-                         _disturbing.Circle(-1, X, Z, (caps&CAP_DELTA) != 0) :
-                         CircularEngine(),
-                         caps & CAP_C ?
-                         _correction.Circle(invR * X, invR * Z, false) :
-                         CircularEngine());
+    // The CircularEngine objects which aren't needed are left alone so that
+    // their storage can be reused by a later call.  The others are
+    // independent of one another and may be set up concurrently.
+    vector<function<void()>> engines;
+    if (caps & CAP_G)
+      engines.push_back([&]() -> void {
+        if (caps & CAP_HESS)
+          _gravitational.CircleHessian(X, Z, circ._gravitational);
+        else
+          _gravitational.Circle(X, Z, true, circ._gravitational);
+      });
+    // N.B. If CAP_DELTA is set then CAP_T should be too.
+    if (caps & CAP_T)
+      engines.push_back([&]() -> void {
+        if ((caps & DISTURBANCE_GRADIENT) == DISTURBANCE_GRADIENT)
+          _disturbing.CircleHessian(-1, X, Z, circ._disturbing);
+        else
+          _disturbing.Circle(-1, X, Z, (caps&CAP_DELTA) != 0,
+                             circ._disturbing);
+      });
+    if (caps & CAP_C)
+      engines.push_back([&]() -> void {
+        _correction.Circle(invR * X, invR * Z, false, circ._correction);
+      });
+    GeodesicBatchExecutor(nthreads, 1).
+      ForEach(engines.size(), [&](size_t i0, size_t i1) -> void {
+        for (size_t i = i0; i < i1; ++i) engines[i]();
+      });
+    circ.Reset(GravityCircle::mask(caps),
+               _earth._a, _earth._f, lat, h, Z, X, M[7], M[8],
+               _amodel, _gGMmodel, _dzonal0, _corrmult,
+               gamma0, gamma, fx, Math::sq(_earth.AngularVelocity()));
   }
 
   string GravityModel::DefaultGravityPath() {
@@ -0,0 +1,133 @@
+/**
+ * \file GridEvaluator.cpp
+ * \brief Implementation for GeographicLib::GridEvaluator class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#include <GeographicLib/GridEvaluator.hpp>
+#include <GeographicLib/GeodesicBatchExecutor.hpp>
+#include <GeographicLib/GravityModel.hpp>
+#include <GeographicLib/GravityCircle.hpp>
+#include <GeographicLib/MagneticModel.hpp>
+#include <GeographicLib/MagneticCircle.hpp>
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  GridEvaluator::GridEvaluator(real lat0, real dlat, int nlat,
+                               real lon0, real dlon, int nlon,
+                               unsigned nthreads)
+    : _lat0(lat0)
+    , _dlat(dlat)
+    , _lon0(lon0)
+    , _dlon(dlon)
+    , _nlat(nlat)
+    , _nlon(nlon)
+    , _nthreads(GeodesicBatchExecutor(nthreads).NumThreads())
+  {
+    if (!(_nlat >= 0 && _nlon >= 0))
+      throw GeographicErr("Number of rows and columns must be nonnegative");
+    if (_nlat > 0 && !(fabs(Latitude(0)) <= Math::qd &&
+                       fabs(Latitude(_nlat - 1)) <= Math::qd))
+      throw GeographicErr("Latitudes of grid not in [-" + to_string(Math::qd)
+                          + "d, " + to_string(Math::qd) + "d]");
+  }
+
+  void GridEvaluator::Rows(const function<void(int, real)>& f) const {
+    // Each row is a unit of work; the cost of constructing the circle
+    // dominates unless nlon is large.
+    GeodesicBatchExecutor(_nthreads, 1).ForEach
+      (size_t(_nlon ? _nlat : 0), [&](size_t i0, size_t i1) -> void {
+        for (size_t i = i0; i < i1; ++i)
+          f(int(i), Latitude(int(i)));
+      });
+  }
+
+  void GridEvaluator::Gravity(const GravityModel& g, real h,
+                              real W[], real gx[], real gy[], real gz[])
+    const {
+    Rows([&](int i, real lat) -> void {
+      GravityCircle c(g.Circle(lat, h, GravityModel::GRAVITY));
+      size_t k = size_t(i) * _nlon;
+      real w, x, y, z;
+      for (int j = 0; j < _nlon; ++j, ++k) {
+        w = c.Gravity(Longitude(j), x, y, z);
+        if (W) W[k] = w;
+        if (gx) gx[k] = x;
+        if (gy) gy[k] = y;
+        if (gz) gz[k] = z;
+      }
+    });
+  }
+
+  void GridEvaluator::Disturbance(const GravityModel& g, real h,
+                                  real T[], real deltax[], real deltay[],
+                                  real deltaz[]) const {
+    Rows([&](int i, real lat) -> void {
+      GravityCircle c(g.Circle(lat, h, GravityModel::DISTURBANCE));
+      size_t k = size_t(i) * _nlon;
+      real t, x, y, z;
+      for (int j = 0; j < _nlon; ++j, ++k) {
+        t = c.Disturbance(Longitude(j), x, y, z);
+        if (T) T[k] = t;
+        if (deltax) deltax[k] = x;
+        if (deltay) deltay[k] = y;
+        if (deltaz) deltaz[k] = z;
+      }
+    });
+  }
+
+  void GridEvaluator::GeoidHeight(const GravityModel& g, real N[]) const {
+    if (!N) return;
+    Rows([&](int i, real lat) -> void {
+      GravityCircle c(g.Circle(lat, 0, GravityModel::GEOID_HEIGHT));
+      size_t k = size_t(i) * _nlon;
+      for (int j = 0; j < _nlon; ++j, ++k)
+        N[k] = c.GeoidHeight(Longitude(j));
+    });
+  }
+
+  void GridEvaluator::SphericalAnomaly(const GravityModel& g, real h,
+                                       real Dg01[], real xi[], real eta[])
+    const {
+    Rows([&](int i, real lat) -> void {
+      GravityCircle c(g.Circle(lat, h, GravityModel::SPHERICAL_ANOMALY));
+      size_t k = size_t(i) * _nlon;
+      real d, x, e;
+      for (int j = 0; j < _nlon; ++j, ++k) {
+        c.SphericalAnomaly(Longitude(j), d, x, e);
+        if (Dg01) Dg01[k] = d;
+        if (xi) xi[k] = x;
+        if (eta) eta[k] = e;
+      }
+    });
+  }
+
+  void GridEvaluator::Field(const MagneticModel& m, real t, real h,
+                            real Bx[], real By[], real Bz[],
+                            real Bxt[], real Byt[], real Bzt[]) const {
+    bool diffp = Bxt || Byt || Bzt;
+    Rows([&](int i, real lat) -> void {
+      MagneticCircle c(m.Circle(t, lat, h));
+      size_t k = size_t(i) * _nlon;
+      real x, y, z, xt, yt, zt;
+      for (int j = 0; j < _nlon; ++j, ++k) {
+        if (diffp) {
+          c(Longitude(j), x, y, z, xt, yt, zt);
+          if (Bxt) Bxt[k] = xt;
+          if (Byt) Byt[k] = yt;
+          if (Bzt) Bzt[k] = zt;
+        } else
+          c(Longitude(j), x, y, z);
+        if (Bx) Bx[k] = x;
+        if (By) By[k] = y;
+        if (Bz) Bz[k] = z;
+      }
+    });
+  }
+
+} // namespace GeographicLib
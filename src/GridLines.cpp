@@ -0,0 +1,279 @@
+/**
+ * \file GridLines.cpp
+ * \brief Implementation for GeographicLib::GridLines class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#include <GeographicLib/GridLines.hpp>
+#include <GeographicLib/TransverseMercator.hpp>
+#include <GeographicLib/UTMUPS.hpp>
+#include <GeographicLib/Utility.hpp>
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  GridLines::GridLines(real lat1, real lat2, real lon1, real lon2,
+                       const projection& proj, real tol)
+    : _lat1(lat1)
+    , _lat2(lat2)
+    , _lon1(Math::AngNormalize(lon1))
+    , _tol(tol)
+    , _proj(proj)
+  {
+    if (!(fabs(lat1) <= Math::qd && fabs(lat2) <= Math::qd && lat1 <= lat2))
+      throw GeographicErr("Bad latitude range for viewport");
+    if (!(isfinite(lon1) && isfinite(lon2)))
+      throw GeographicErr("Bad longitude range for viewport");
+    if (!(tol > 0))
+      throw GeographicErr("Tolerance " + Utility::str(tol)
+                          + " not positive");
+    real w = remainder(lon2 - lon1, Math::td);
+    if (w < 0 || (w == 0 && lon2 != lon1)) w += Math::td;
+    _lon2 = _lon1 + w;
+  }
+
+  bool GridLines::InView(real lat, real lon) const {
+    if (!(lat >= _lat1 && lat <= _lat2)) return false;
+    real d = Math::AngNormalize(lon - _lon1);
+    if (d < 0) d += Math::td;
+    return d <= _lon2 - _lon1;
+  }
+
+  void GridLines::Project(size_t n, const real lat[], const real lon[],
+                          real x[], real y[]) const {
+    if (_proj)
+      _proj(n, lat, lon, x, y);
+    else
+      for (size_t i = 0; i < n; ++i) {
+        x[i] = lon[i]; y[i] = lat[i];
+      }
+  }
+
+  void GridLines::Trace(const curve& f, const predicate& inside,
+                        real t0, real t1,
+                        Line& line, vector<Line>& lines) const {
+    const int n = nsample_ + 1;
+    vector<real> t(n), lat(n), lon(n);
+    for (int i = 0; i < n; ++i)
+      t[i] = i == nsample_ ? t1 : t0 + (t1 - t0) * i / nsample_;
+    f(n, t.data(), lat.data(), lon.data());
+    vector<char> in(n);
+    for (int i = 0; i < n; ++i)
+      in[i] = inside(lat[i], lon[i]);
+    // Find the end of a portion between ta (inside) and tb (outside); on
+    // return, ta, lata, lona give the last point found inside.
+    auto bisect = [&f, &inside](real& ta, real tb,
+                                real& lata, real& lona) -> void {
+      for (int k = 0; k < numit_; ++k) {
+        real tm = (ta + tb) / 2, latm, lonm;
+        f(1, &tm, &latm, &lonm);
+        if (inside(latm, lonm)) {
+          ta = tm; lata = latm; lona = lonm;
+        } else
+          tb = tm;
+      }
+    };
+    vector<real> tt, mt, mlat, mlon, mx, my;
+    vector<char> act;
+    for (int i = 0; i < n;) {
+      if (!in[i]) { ++i; continue; }
+      tt.clear(); line.lat.clear(); line.lon.clear();
+      if (i > 0) {
+        real ta = t[i], lata = lat[i], lona = lon[i];
+        bisect(ta, t[i - 1], lata, lona);
+        tt.push_back(ta); line.lat.push_back(lata); line.lon.push_back(lona);
+      }
+      int j = i;
+      for (; j < n && in[j]; ++j) {
+        tt.push_back(t[j]); line.lat.push_back(lat[j]);
+        line.lon.push_back(lon[j]);
+      }
+      if (j < n) {
+        real ta = t[j - 1], lata = lat[j - 1], lona = lon[j - 1];
+        bisect(ta, t[j], lata, lona);
+        tt.push_back(ta); line.lat.push_back(lata); line.lon.push_back(lona);
+      }
+      i = j;
+      // Make the longitudes continuous
+      for (size_t k = 1; k < line.lon.size(); ++k)
+        line.lon[k] = line.lon[k-1] + Math::AngDiff(line.lon[k-1],
+                                                    line.lon[k]);
+      size_t m = tt.size();
+      line.x.resize(m); line.y.resize(m);
+      Project(m, line.lat.data(), line.lon.data(),
+              line.x.data(), line.y.data());
+      // Densify: evaluate the midpoints of all the unconverged segments
+      // together and split the segments whose midpoints lie further than
+      // _tol from the chords.
+      act.assign(m - 1, 1);
+      for (int pass = 0; pass < maxpass_; ++pass) {
+        mt.clear();
+        for (size_t k = 0; k + 1 < m; ++k)
+          if (act[k]) mt.push_back((tt[k] + tt[k + 1]) / 2);
+        size_t nm = mt.size();
+        if (nm == 0) break;
+        mlat.resize(nm); mlon.resize(nm); mx.resize(nm); my.resize(nm);
+        f(nm, mt.data(), mlat.data(), mlon.data());
+        for (size_t k = 0, l = 0; k + 1 < m; ++k)
+          if (act[k]) {
+            mlon[l] = line.lon[k] + Math::AngDiff(line.lon[k], mlon[l]);
+            ++l;
+          }
+        Project(nm, mlat.data(), mlon.data(), mx.data(), my.data());
+        Line dense;
+        vector<real> dt;
+        vector<char> dact;
+        dt.reserve(m + nm); dact.reserve(m + nm);
+        for (size_t k = 0, l = 0; k < m; ++k) {
+          dt.push_back(tt[k]);
+          dense.lat.push_back(line.lat[k]); dense.lon.push_back(line.lon[k]);
+          dense.x.push_back(line.x[k]); dense.y.push_back(line.y[k]);
+          if (k + 1 == m) break;
+          if (!act[k]) { dact.push_back(0); continue; }
+          // The distance of the midpoint from the chord
+          real
+            cx = line.x[k + 1] - line.x[k], cy = line.y[k + 1] - line.y[k],
+            dx = mx[l] - line.x[k], dy = my[l] - line.y[k],
+            c = hypot(cx, cy),
+            dev = c > 0 ? fabs(cx * dy - cy * dx) / c : hypot(dx, dy);
+          if (dev > _tol) {
+            dt.push_back(mt[l]);
+            dense.lat.push_back(mlat[l]); dense.lon.push_back(mlon[l]);
+            dense.x.push_back(mx[l]); dense.y.push_back(my[l]);
+            dact.push_back(1); dact.push_back(1);
+          } else
+            dact.push_back(0);
+          ++l;
+        }
+        tt.swap(dt); act.swap(dact);
+        line.lat.swap(dense.lat); line.lon.swap(dense.lon);
+        line.x.swap(dense.x); line.y.swap(dense.y);
+        m = tt.size();
+      }
+      lines.push_back(line);
+    }
+  }
+
+  void GridLines::Graticule(real dlat, real dlon, vector<Line>& lines) const {
+    if (!(dlat > 0 && dlon > 0))
+      throw GeographicErr("Graticule spacing not positive");
+    lines.clear();
+    auto all = [](real, real) -> bool { return true; };
+    Line line;
+    line.zone = 0; line.northp = true;
+    bool full = _lon2 - _lon1 == Math::td;
+    line.type = MERIDIAN;
+    for (real k = ceil(_lon1 / dlon); k * dlon <= _lon2; ++k) {
+      real lon = k * dlon;
+      if (full && lon >= _lon2) break;
+      line.value = Math::AngNormalize(lon);
+      Trace([lon](size_t n, const real t[], real lat[], real lonx[]) -> void {
+              for (size_t i = 0; i < n; ++i) {
+                lat[i] = t[i]; lonx[i] = lon;
+              }
+            }, all, _lat1, _lat2, line, lines);
+    }
+    line.type = PARALLEL;
+    for (real k = ceil(_lat1 / dlat); k * dlat <= _lat2; ++k) {
+      real lat = k * dlat;
+      if (fabs(lat) == Math::qd) continue;
+      line.value = lat;
+      Trace([lat](size_t n, const real t[], real latx[], real lon[]) -> void {
+              for (size_t i = 0; i < n; ++i) {
+                latx[i] = lat; lon[i] = t[i];
+              }
+            }, all, _lon1, _lon2, line, lines);
+    }
+  }
+
+  void GridLines::UTM(real spacing, vector<Line>& lines) const {
+    if (!(spacing > 0))
+      throw GeographicErr("Grid spacing " + Utility::str(spacing)
+                          + " not positive");
+    lines.clear();
+    // The UTM limits
+    const real latS = -80, latN = 84,
+      falseeasting = real(5e5), falsenorthing = real(100e5);
+    real lat1 = fmax(_lat1, latS), lat2 = fmin(_lat2, latN);
+    if (!(lat1 <= lat2)) return;
+    const TransverseMercator& tm = TransverseMercator::UTM();
+    const int n = nsample_ + 1;
+    vector<real> blat(4 * n), blon(4 * n), bx(4 * n), by(4 * n), buf;
+    Line line;
+    for (int zone = UTMUPS::MINUTMZONE; zone <= UTMUPS::MAXUTMZONE; ++zone) {
+      real lon0 = 6 * zone - 183;
+      // Find the bounding box in (x, y) of the part of the viewport which
+      // may lie in this zone by projecting its boundary.  The exceptional
+      // zones in Norway and Svalbard extend at most 6d either side of the
+      // central meridian.
+      real xmin = Math::infinity(), xmax = -xmin, ymin = xmin, ymax = -xmin;
+      for (int k = -1; k <= 2; ++k) {
+        real
+          lon1 = fmax(_lon1, lon0 - 6 + k * Math::td),
+          lon2 = fmin(_lon2, lon0 + 6 + k * Math::td);
+        if (!(lon1 <= lon2)) continue;
+        for (int i = 0; i < n; ++i) {
+          real s = real(i) / nsample_,
+            lat = lat1 + (lat2 - lat1) * s, lon = lon1 + (lon2 - lon1) * s;
+          blat[i] = lat;          blon[i] = lon1;
+          blat[n + i] = lat;      blon[n + i] = lon2;
+          blat[2 * n + i] = lat1; blon[2 * n + i] = lon;
+          blat[3 * n + i] = lat2; blon[3 * n + i] = lon;
+        }
+        tm.ForwardBatch(4 * n, lon0, blat.data(), blon.data(),
+                        bx.data(), by.data());
+        for (int i = 0; i < 4 * n; ++i) {
+          xmin = fmin(xmin, bx[i]); xmax = fmax(xmax, bx[i]);
+          ymin = fmin(ymin, by[i]); ymax = fmax(ymax, by[i]);
+        }
+      }
+      if (!(xmin <= xmax)) continue;
+      // Allow for the bulges of the boundary between the samples
+      real
+        dx = (xmax - xmin) / 100 + 1, dy = (ymax - ymin) / 100 + 1;
+      xmin -= dx; xmax += dx; ymin -= dy; ymax += dy;
+      auto inzone = [this, zone, latS, latN](real lat, real lon) -> bool {
+        return lat >= latS && lat < latN && InView(lat, lon) &&
+          UTMUPS::StandardZone(lat, lon) == zone;
+      };
+      line.zone = zone;
+      line.type = EASTING; line.northp = ymax >= 0;
+      for (real k = ceil((xmin + falseeasting) / spacing);
+           k * spacing - falseeasting <= xmax; ++k) {
+        real x = k * spacing - falseeasting;
+        line.value = k * spacing;
+        Trace([&tm, &buf, lon0, x]
+              (size_t m, const real t[], real lat[], real lon[]) -> void {
+                buf.assign(m, x);
+                tm.ReverseBatch(m, lon0, buf.data(), t, lat, lon);
+              }, inzone, ymin, ymax, line, lines);
+      }
+      line.type = NORTHING;
+      for (int h = 0; h < 2; ++h) {
+        bool northp = h == 0;
+        real y0 = northp ? 0 : falsenorthing,
+          ya = northp ? fmax(ymin, real(0)) : ymin,
+          yb = northp ? ymax : fmin(ymax, real(0));
+        if (!(ya <= yb)) continue;
+        line.northp = northp;
+        for (real k = ceil((ya + y0) / spacing);
+             k * spacing - y0 <= yb; ++k) {
+          real y = k * spacing - y0;
+          // The equator belongs to the northern hemisphere
+          if (!northp && y >= 0) break;
+          line.value = k * spacing;
+          Trace([&tm, &buf, lon0, y]
+                (size_t m, const real t[], real lat[], real lon[]) -> void {
+                  buf.assign(m, y);
+                  tm.ReverseBatch(m, lon0, t, buf.data(), lat, lon);
+                }, inzone, xmin, xmax, line, lines);
+        }
+      }
+    }
+  }
+
+} // namespace GeographicLib
@@ -0,0 +1,131 @@
+/**
+ * \file Helmert.cpp
+ * \brief Implementation for GeographicLib::Helmert class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#include <GeographicLib/Helmert.hpp>
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  Helmert::Helmert()
+    : _t0(0)
+    , _coordframe(false)
+  {
+    for (int k = 0; k < 7; ++k) _p[k] = _dp[k] = 0;
+    Init();
+  }
+
+  Helmert::Helmert(real tx, real ty, real tz, real s,
+                   real rx, real ry, real rz, bool coordframe)
+    : _t0(0)
+    , _coordframe(coordframe)
+  {
+    _p[0] = tx; _p[1] = ty; _p[2] = tz; _p[3] = s;
+    _p[4] = rx; _p[5] = ry; _p[6] = rz;
+    for (int k = 0; k < 7; ++k) _dp[k] = 0;
+    Init();
+  }
+
+  Helmert::Helmert(real tx, real ty, real tz, real s,
+                   real rx, real ry, real rz,
+                   real dtx, real dty, real dtz, real ds,
+                   real drx, real dry, real drz, real t0, bool coordframe)
+    : _t0(t0)
+    , _coordframe(coordframe)
+  {
+    _p[0] = tx; _p[1] = ty; _p[2] = tz; _p[3] = s;
+    _p[4] = rx; _p[5] = ry; _p[6] = rz;
+    _dp[0] = dtx; _dp[1] = dty; _dp[2] = dtz; _dp[3] = ds;
+    _dp[4] = drx; _dp[5] = dry; _dp[6] = drz;
+    Init();
+  }
+
+  void Helmert::Init() {
+    const real
+      ppm = real(1)/1000000,
+      sec = Math::degree() / 3600,
+      sign = _coordframe ? -1 : 1,
+      sc = 1 + _p[3] * ppm,
+      rx = sign * _p[4] * sec,
+      ry = sign * _p[5] * sec,
+      rz = sign * _p[6] * sec;
+    for (size_t k = 0; k < dim_; ++k) _t[k] = _p[k];
+    _m[0] =       sc; _m[1] = -rz * sc; _m[2] =  ry * sc;
+    _m[3] =  rz * sc; _m[4] =       sc; _m[5] = -rx * sc;
+    _m[6] = -ry * sc; _m[7] =  rx * sc; _m[8] =       sc;
+    // The inverse of the matrix is the transpose of its cofactors divided by
+    // the determinant; the translation is then -_mi . _t.
+    _mi[0] = _m[4] * _m[8] - _m[5] * _m[7];
+    _mi[1] = _m[2] * _m[7] - _m[1] * _m[8];
+    _mi[2] = _m[1] * _m[5] - _m[2] * _m[4];
+    _mi[3] = _m[5] * _m[6] - _m[3] * _m[8];
+    _mi[4] = _m[0] * _m[8] - _m[2] * _m[6];
+    _mi[5] = _m[2] * _m[3] - _m[0] * _m[5];
+    _mi[6] = _m[3] * _m[7] - _m[4] * _m[6];
+    _mi[7] = _m[1] * _m[6] - _m[0] * _m[7];
+    _mi[8] = _m[0] * _m[4] - _m[1] * _m[3];
+    real det = _m[0] * _mi[0] + _m[1] * _mi[3] + _m[2] * _mi[6];
+    for (size_t k = 0; k < dim2_; ++k) _mi[k] /= det;
+    for (size_t k = 0; k < dim_; ++k)
+      _ti[k] = -(_mi[3*k] * _t[0] + _mi[3*k+1] * _t[1] + _mi[3*k+2] * _t[2]);
+  }
+
+  Helmert Helmert::AtEpoch(real t) const {
+    Helmert h(*this);
+    real dt = t - _t0;
+    for (int k = 0; k < 7; ++k) h._p[k] += _dp[k] * dt;
+    h._t0 = t;
+    h.Init();
+    return h;
+  }
+
+  void Helmert::ApplyBatch(const real t[], const real m[], size_t n,
+                           const real X[], const real Y[], const real Z[],
+                           real X1[], real Y1[], real Z1[]) {
+    // A simple loop which the compiler can vectorize; the inputs are read
+    // before the outputs are written so the arrays may coincide.
+    for (size_t i = 0; i < n; ++i) {
+      real x = X[i], y = Y[i], z = Z[i];
+      X1[i] = t[0] + m[0] * x + m[1] * y + m[2] * z;
+      Y1[i] = t[1] + m[3] * x + m[4] * y + m[5] * z;
+      Z1[i] = t[2] + m[6] * x + m[7] * y + m[8] * z;
+    }
+  }
+
+  void Helmert::ForwardGeodeticBatch(size_t n, const Geocentric& earth,
+                                     const real lat[], const real lon[],
+                                     const real h[], const Geocentric& earth1,
+                                     real lat1[], real lon1[],
+                                     real h1[]) const {
+    const int K = batchsize_;
+    for (size_t i0 = 0; i0 < n; i0 += K) {
+      int nb = int(min(size_t(K), n - i0));
+      real xc[K], yc[K], zc[K];
+      earth.ForwardBatch(nb, lat + i0, lon + i0, h + i0, xc, yc, zc);
+      ForwardBatch(nb, xc, yc, zc, xc, yc, zc);
+      earth1.ReverseBatch(nb, xc, yc, zc, lat1 + i0, lon1 + i0, h1 + i0);
+    }
+  }
+
+  void Helmert::ReverseGeodeticBatch(size_t n, const Geocentric& earth1,
+                                     const real lat1[], const real lon1[],
+                                     const real h1[], const Geocentric& earth,
+                                     real lat[], real lon[],
+                                     real h[]) const {
+    const int K = batchsize_;
+    for (size_t i0 = 0; i0 < n; i0 += K) {
+      int nb = int(min(size_t(K), n - i0));
+      real xc[K], yc[K], zc[K];
+      earth1.ForwardBatch(nb, lat1 + i0, lon1 + i0, h1 + i0, xc, yc, zc);
+      ReverseBatch(nb, xc, yc, zc, xc, yc, zc);
+      earth.ReverseBatch(nb, xc, yc, zc, lat + i0, lon + i0, h + i0);
+    }
+  }
+
+} // namespace GeographicLib
@@ -0,0 +1,272 @@
+/**
+ * \file Intersect.cpp
+ * \brief Implementation for GeographicLib::Intersect class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#include <GeographicLib/Intersect.hpp>
+#include <GeographicLib/GeodesicBatchExecutor.hpp>
+#include <algorithm>
+#include <mutex>
+
+#if defined(_MSC_VER)
+// Squelch warnings about constant conditional expressions
+#  pragma warning (disable: 4127)
+#endif
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  Intersect::Intersect(const Geodesic& geod)
+    : _geod(geod)
+    , _earth(_geod.EquatorialRadius(), _geod.Flattening())
+      // The mean radius (2*a+b)/3
+    , _r(_geod.EquatorialRadius() * (1 - _geod.Flattening()/3))
+    , _eps(_r * numeric_limits<real>::epsilon())
+    , _tol(_r * pow(numeric_limits<real>::epsilon(), 3/real(4)))
+    , _angtol(_tol / _r)
+  {}
+
+  Intersect::Point Intersect::Closest(real latX, real lonX, real aziX,
+                                      real latY, real lonY, real aziY,
+                                      const Point& p0, int* c) const {
+    return Closest(_geod.Line(latX, lonX, aziX, caps_),
+                   _geod.Line(latY, lonY, aziY, caps_), p0, c);
+  }
+
+  Intersect::Point Intersect::Closest(const GeodesicLine& lineX,
+                                      const GeodesicLine& lineY,
+                                      const Point& p0, int* c) const {
+    real x = p0.first, y = p0.second;
+    int cc = 0;
+    for (int n = 0; n < numit_ || GEOGRAPHICLIB_PANIC; ++n) {
+      real latX, lonX, aziX, latY, lonY, aziY;
+      lineX.Position(x, latX, lonX, aziX);
+      lineY.Position(y, latY, lonY, aziY);
+      real z, aziXa, aziYa;
+      _geod.Inverse(latX, lonX, latY, lonY, z, aziXa, aziYa);
+      if (z <= _eps) {
+        // At the intersection; check whether the geodesics coincide
+        real d = fabs(Math::AngDiff(aziX, aziY)) * Math::degree();
+        cc = d <= _angtol ? 1 : (Math::pi() - d <= _angtol ? -1 : 0);
+        break;
+      }
+      // The angle at X between geodesic X and the geodesic XY and the
+      // exterior angle at Y between geodesic Y and the geodesic XY.
+      real eX, eY,
+        aX = Math::AngDiff(aziX, aziXa, eX),
+        aY = Math::AngDiff(aziY, aziYa, eY),
+        sinX, cosX, sinY, cosY;
+      Math::sincosde(aX, eX, sinX, cosX);
+      Math::sincosde(aY, eY, sinY, cosY);
+      real dx, dy;
+      if (fabs(sinX) <= _angtol && fabs(sinY) <= _angtol) {
+        // X, Y, and the geodesic XY coincide; move to the midpoint
+        cc = cosX * cosY > 0 ? 1 : -1;
+        dx =  cosX * z/2;
+        dy = -cosY * z/2;
+      } else {
+        // Solve the triangle on a sphere of radius _r.  Flip the signs of
+        // the angles if the triangle is inverted so that the intersection
+        // nearest the trial points is found.
+        real eXY, aXY = Math::AngDiff(aX, aY, eXY),
+          s = copysign(real(1), aXY + (eXY + eY - eX));
+        sinX *= s; sinY *= s;
+        real sinz = sin(z/_r), cosz = cos(z/_r);
+        dx = _r * atan2(sinz * sinY,  sinY * cosX * cosz - cosY * sinX);
+        dy = _r * atan2(sinz * sinX, -sinX * cosY * cosz + cosX * sinY);
+      }
+      x += dx; y += dy;
+      if (cc || !(fabs(dx) + fabs(dy) > _tol))
+        break;
+    }
+    if (c) *c = cc;
+    return Point(x, y);
+  }
+
+  Intersect::Point Intersect::Start(const Cap& cx, const Cap& cy,
+                                    real sx, real sy) const {
+    // Unit vectors on the auxiliary sphere for the endpoints
+    real u[4][3];
+    const real ll[4][2] = { {cx.lat1, cx.lon1}, {cx.lat2, cx.lon2},
+                            {cy.lat1, cy.lon1}, {cy.lat2, cy.lon2} };
+    for (int k = 0; k < 4; ++k) {
+      real sphi, cphi, slam, clam;
+      Math::sincosd(ll[k][0], sphi, cphi);
+      Math::sincosd(ll[k][1], slam, clam);
+      sphi *= 1 - Flattening();
+      real h = hypot(sphi, cphi);
+      u[k][0] = cphi/h * clam; u[k][1] = cphi/h * slam; u[k][2] = sphi/h;
+    }
+    auto cross = [](const real a[], const real b[], real p[]) -> void {
+      p[0] = a[1] * b[2] - a[2] * b[1];
+      p[1] = a[2] * b[0] - a[0] * b[2];
+      p[2] = a[0] * b[1] - a[1] * b[0];
+    };
+    auto dot = [](const real a[], const real b[]) -> real
+      { return a[0] * b[0] + a[1] * b[1] + a[2] * b[2]; };
+    // Poles of the great circles and their intersection
+    real nx[3], ny[3], p[3];
+    cross(u[0], u[1], nx);
+    cross(u[2], u[3], ny);
+    cross(nx, ny, p);
+    real nnx = sqrt(dot(nx, nx)), nny = sqrt(dot(ny, ny)),
+      np = sqrt(dot(p, p));
+    // Fall back to the midpoints for degenerate segments or great circles
+    // which (nearly) coincide.
+    if (!(np > _angtol * nnx * nny))
+      return Point(sx/2, sy/2);
+    // Pick the intersection nearer the segments
+    real m[3];
+    for (int j = 0; j < 3; ++j)
+      m[j] = u[0][j] + u[1][j] + u[2][j] + u[3][j];
+    if (dot(p, m) < 0)
+      for (int j = 0; j < 3; ++j) p[j] = -p[j];
+    // The fraction of the way along the segment to the intersection
+    auto frac = [&](const real a[], const real b[], const real n[], real nn)
+      -> real {
+      real t[3];
+      cross(a, p, t);
+      return atan2(dot(t, n) / nn, dot(a, p)) /
+        atan2(nn, dot(a, b));
+    };
+    return Point(frac(u[0], u[1], nx, nnx) * sx,
+                 frac(u[2], u[3], ny, nny) * sy);
+  }
+
+  Intersect::Point Intersect::Segment(const GeodesicLine& lineX,
+                                      const GeodesicLine& lineY,
+                                      const Cap& cx, const Cap& cy,
+                                      int& segmode, int* c) const {
+    real sx = lineX.Distance(), sy = lineY.Distance();
+    int cc;
+    Point q = Closest(lineX, lineY, Start(cx, cy, sx, sy), &cc);
+    real x = q.first, y = q.second;
+    if (cc) {
+      // The geodesics coincide; the point y' on Y lies at x + cc * (y' - y)
+      // on X.  Pick the midpoint of the overlap of the segments (or of the
+      // gap between them).
+      real xa = x - cc * y, xb = xa + cc * sy,
+        lo = max(real(0), min(xa, xb)), hi = min(sx, max(xa, xb));
+      x = (lo + hi) / 2;
+      y += cc * (x - q.first);
+    }
+    segmode =
+      3 * (x < 0 ? -1 : (x > sx ? 1 : 0)) + (y < 0 ? -1 : (y > sy ? 1 : 0));
+    if (c) *c = cc;
+    return Point(x, y);
+  }
+
+  Intersect::Point Intersect::Segment(real latX1, real lonX1,
+                                      real latX2, real lonX2,
+                                      real latY1, real lonY1,
+                                      real latY2, real lonY2,
+                                      int& segmode, int* c) const {
+    Cap cx = { latX1, lonX1, latX2, lonX2, 0, 0, 0, 0 },
+      cy = { latY1, lonY1, latY2, lonY2, 0, 0, 0, 0 };
+    return Segment(_geod.InverseLine(latX1, lonX1, latX2, lonX2, caps_),
+                   _geod.InverseLine(latY1, lonY1, latY2, lonY2, caps_),
+                   cx, cy, segmode, c);
+  }
+
+  Intersect::Point Intersect::Segment(const GeodesicLine& lineX,
+                                      const GeodesicLine& lineY,
+                                      int& segmode, int* c) const {
+    Cap cx, cy;
+    cx.lat1 = lineX.Latitude(); cx.lon1 = lineX.Longitude();
+    lineX.Position(lineX.Distance(), cx.lat2, cx.lon2);
+    cy.lat1 = lineY.Latitude(); cy.lon1 = lineY.Longitude();
+    lineY.Position(lineY.Distance(), cy.lat2, cy.lon2);
+    return Segment(lineX, lineY, cx, cy, segmode, c);
+  }
+
+  void Intersect::MakeCap(real lat1, real lon1, real lat2, real lon2,
+                          Cap& cap) const {
+    GeodesicLine line =
+      _geod.InverseLine(lat1, lon1, lat2, lon2,
+                        Geodesic::LATITUDE | Geodesic::LONGITUDE |
+                        Geodesic::DISTANCE_IN);
+    real lat, lon;
+    line.BoundingCap(0, line.Distance(), lat, lon, cap.r);
+    _earth.Forward(lat, lon, 0, cap.X, cap.Y, cap.Z);
+    cap.lat1 = lat1; cap.lon1 = lon1; cap.lat2 = lat2; cap.lon2 = lon2;
+  }
+
+  void Intersect::AllSegments(size_t nx,
+                              const real latX1[], const real lonX1[],
+                              const real latX2[], const real lonX2[],
+                              size_t ny,
+                              const real latY1[], const real lonY1[],
+                              const real latY2[], const real lonY2[],
+                              vector<Crossing>& crossings,
+                              unsigned nthreads) const {
+    crossings.clear();
+    if (nx == 0 || ny == 0) return;
+    GeodesicBatchExecutor exec(nthreads);
+    vector<Cap> capx(nx), capy(ny);
+    exec.ForEach(nx, [&](size_t i0, size_t i1) -> void {
+      for (size_t i = i0; i < i1; ++i)
+        MakeCap(latX1[i], lonX1[i], latX2[i], lonX2[i], capx[i]);
+    });
+    exec.ForEach(ny, [&](size_t i0, size_t i1) -> void {
+      for (size_t i = i0; i < i1; ++i)
+        MakeCap(latY1[i], lonY1[i], latY2[i], lonY2[i], capy[i]);
+    });
+    // Sort the second set by Z
+    vector<size_t> order(ny);
+    for (size_t j = 0; j < ny; ++j) order[j] = j;
+    sort(order.begin(), order.end(),
+         [&capy](size_t a, size_t b) -> bool
+         { return capy[a].Z < capy[b].Z; });
+    vector<real> zy(ny);
+    real rmax = 0;
+    for (size_t k = 0; k < ny; ++k) {
+      zy[k] = capy[order[k]].Z;
+      rmax = max(rmax, capy[k].r);
+    }
+    mutex m;
+    exec.ForEach(nx, [&](size_t i0, size_t i1) -> void {
+      vector<Crossing> found;
+      for (size_t i = i0; i < i1; ++i) {
+        const Cap& cx = capx[i];
+        // Only caps with |Z - cx.Z| <= cx.r + cy.r can overlap
+        real dz = cx.r + rmax + _tol;
+        bool haveX = false;
+        GeodesicLine lineX;
+        for (size_t k = size_t(lower_bound(zy.begin(), zy.end(), cx.Z - dz) -
+                               zy.begin());
+             k < ny && zy[k] <= cx.Z + dz; ++k) {
+          size_t j = order[k];
+          const Cap& cy = capy[j];
+          real dX = cx.X - cy.X, dY = cx.Y - cy.Y, dZ = cx.Z - cy.Z;
+          if (!(sqrt(dX * dX + dY * dY + dZ * dZ) <= cx.r + cy.r + _tol))
+            continue;
+          if (!haveX) {
+            lineX = _geod.InverseLine(cx.lat1, cx.lon1, cx.lat2, cx.lon2,
+                                      caps_);
+            haveX = true;
+          }
+          int segmode, c;
+          Point p = Segment(lineX,
+                            _geod.InverseLine(cy.lat1, cy.lon1,
+                                              cy.lat2, cy.lon2, caps_),
+                            cx, cy, segmode, &c);
+          if (segmode == 0) {
+            Crossing r = { i, j, p.first, p.second, c };
+            found.push_back(r);
+          }
+        }
+      }
+      lock_guard<mutex> lock(m);
+      crossings.insert(crossings.end(), found.begin(), found.end());
+    });
+    sort(crossings.begin(), crossings.end(),
+         [](const Crossing& a, const Crossing& b) -> bool
+         { return a.i < b.i || (a.i == b.i && a.j < b.j); });
+  }
+
+} // namespace GeographicLib
@@ -0,0 +1,278 @@
+/**
+ * \file JacobiConformal.cpp
+ * \brief Implementation for GeographicLib::JacobiConformal class
+ *
+ * Copyright (c) Charles Karney (2014-2026) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#include <GeographicLib/JacobiConformal.hpp>
+#include <GeographicLib/DST.hpp>
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  Math::real JacobiConformal::coord::direct(real sang, real cang) const {
+    real s1 = _p * sang, c1 = _q * cang; norm(s1, c1);
+    return _s * _e.Pi(s1, c1, _e.Delta(s1, c1));
+  }
+
+  Math::real JacobiConformal::coord::deriv(real sang, real cang) const {
+    // With tan(phi') = (p/q) * tan(ang), dphi'/dang = p*q/D and sin(phi')^2 =
+    // p^2*sin(ang)^2/D where D = q^2*cos(ang)^2 + p^2*sin(ang)^2.
+    real
+      q2 = Math::sq(_q * cang), p2 = Math::sq(_p * sang),
+      D = q2 + p2;
+    return _s * _p * _q /
+      ((q2 + _e.alphap2() * p2) * sqrt((q2 + _e.kp2() * p2) / D));
+  }
+
+  void JacobiConformal::coord::fit() {
+    // The derivative has poles near the real axis when the ellipsoid is
+    // nearly one of revolution; give up (and use direct) if too many terms
+    // are needed.
+    static const int maxN = 2048;
+    _ie.clear();
+    if (DST::cosinefit([this](real ang) -> real
+                       { return deriv(sin(ang), cos(ang)); }, _d, maxN)) {
+      for (real d : _d)
+        if (!isfinite(d)) { _d.clear(); break; }
+    }
+    int n = NTerms() - 1;
+    _c.assign(max(n + 1, 0), 0);
+    _bnd = 0;
+    for (int j = 1; j <= n; ++j) {
+      _c[j] = _d[j] / (2 * j);
+      _bnd += fabs(_c[j]);
+    }
+    if (!Fitted()) return;
+    // ang - t is odd about t = 0 and t = pi/2; sample it with Newton's
+    // method.  If this fails, inv falls back to Newton's method.
+    DST::sinefit([this](real t) -> real
+                 { return newton(_d[0] * t) - t; }, _ie, maxN);
+  }
+
+  void JacobiConformal::coord::eval(real ang, real sang, real cang,
+                                    real& v, real& vp) const {
+    if (!Fitted()) {
+      v = direct(sang, cang); vp = deriv(sang, cang);
+      return;
+    }
+    int n = NTerms() - 1;
+    v = _d[0] * ang + DST::sineval(sang, cang, _c.data(), n);
+    // Clenshaw summation of sum(d[j] * cos(2*j*ang), j, 0, n)
+    real
+      c2 = (cang - sang) * (cang + sang), // cos(2 * ang)
+      ar = 2 * c2,
+      y0 = 0, y1 = 0;
+    for (int j = n; j > 0; --j) {
+      real t = ar * y0 - y1 + _d[j];
+      y1 = y0; y0 = t;
+    }
+    vp = _d[0] + c2 * y0 - y1;
+  }
+
+  Math::real JacobiConformal::coord::operator()(real ang, real sang,
+                                                real cang) const {
+    return Fitted() ?
+      _d[0] * ang + DST::sineval(sang, cang, _c.data(), NTerms() - 1) :
+      direct(sang, cang);
+  }
+
+  Math::real JacobiConformal::coord::inv(real v) const {
+    if (_ie.empty()) return newton(v);
+    real t = v / _d[0];
+    return t + DST::sineval(sin(t), cos(t), _ie.data(), int(_ie.size()) - 1);
+  }
+
+  Math::real JacobiConformal::coord::newton(real v) const {
+    // The function is increasing so use Newton's method falling back to
+    // bisection.  With the series, the periodic part is bounded by _bnd;
+    // otherwise ang is restricted to [-pi, pi].
+    static const real tol = 4 * numeric_limits<real>::epsilon();
+    static const int maxit = 100;
+    real ang, lo, hi;
+    if (Fitted()) {
+      ang = v / _d[0]; lo = (v - _bnd) / _d[0]; hi = (v + _bnd) / _d[0];
+    } else {
+      lo = -Math::pi(); hi = Math::pi();
+      ang = fmax(lo, fmin(hi, v / Quadrant() * (Math::pi() / 2)));
+      if (!isfinite(ang)) ang = 0;
+    }
+    for (int i = 0; i < maxit; ++i) {
+      real f, fp;
+      eval(ang, sin(ang), cos(ang), f, fp);
+      f -= v;
+      if (f == 0) break;
+      if (f > 0) hi = fmin(hi, ang); else lo = fmax(lo, ang);
+      real angn = ang - f / fp;
+      if (!(angn > lo && angn < hi)) angn = (lo + hi) / 2;
+      bool done = fabs(angn - ang) <= tol * fmax(real(1), fabs(ang)) ||
+        !(lo < hi);
+      ang = angn;
+      if (done) break;
+    }
+    return ang;
+  }
+
+  void JacobiConformal::coord::EvalBatch(int n, const real ang[],
+                                         real v[]) const {
+    // As operator()(ang * degree, sin(ang), cos(ang)) / degree with the
+    // Clenshaw sums for the points done together.
+    const int K = batchsize_;
+    real s[K] = {}, c[K] = {}, y[K];
+    for (int j = 0; j < n; ++j)
+      Math::sincosd(ang[j], s[j], c[j]);
+    if (!Fitted()) {
+      for (int j = 0; j < n; ++j)
+        v[j] = direct(s[j], c[j]) / Math::degree();
+      return;
+    }
+    sinebatch(n, s, c, _c.data(), NTerms() - 1, y);
+    real d0 = _d[0];
+    for (int j = 0; j < n; ++j)
+      v[j] = (d0 * (ang[j] * Math::degree()) + y[j]) / Math::degree();
+  }
+
+  void JacobiConformal::coord::InvBatch(int n, const real v[],
+                                        real ang[]) const {
+    // As inv(v * degree) / degree with the Clenshaw sums for the points done
+    // together.
+    if (_ie.empty()) {
+      for (int j = 0; j < n; ++j)
+        ang[j] = newton(v[j] * Math::degree()) / Math::degree();
+      return;
+    }
+    const int K = batchsize_;
+    real t[K], s[K] = {}, c[K] = {}, y[K];
+    real d0 = _d[0];
+    for (int j = 0; j < n; ++j) {
+      t[j] = v[j] * Math::degree() / d0;
+      s[j] = sin(t[j]); c[j] = cos(t[j]);
+    }
+    sinebatch(n, s, c, _ie.data(), int(_ie.size()) - 1, y);
+    for (int j = 0; j < n; ++j)
+      ang[j] = (t[j] + y[j]) / Math::degree();
+  }
+
+  void JacobiConformal::coord::sinebatch(int n, const real s[],
+                                         const real c[], const real F[],
+                                         int N, real y[]) {
+    const int K = batchsize_;
+    real ar[K], y1[K];
+    for (int j = 0; j < n; ++j) {
+      ar[j] = 2 * (c[j] - s[j]) * (c[j] + s[j]);
+      y[j] = y1[j] = 0;
+    }
+    for (; N > 0; --N) {
+      real f = F[N];
+      for (int j = 0; j < n; ++j) {
+        real u = ar[j] * y[j] - y1[j] + f;
+        y1[j] = y[j]; y[j] = u;
+      }
+    }
+    for (int j = 0; j < n; ++j)
+      y[j] = 2 * s[j] * c[j] * y[j];
+  }
+
+  JacobiConformal::JacobiConformal(real a, real b, real c)
+    : _a(a), _b(b), _c(c)
+    , _ab2((_a - _b) * (_a + _b))
+    , _bc2((_b - _c) * (_b + _c))
+    , _ac2((_a - _c) * (_a + _c))
+    , _x(Math::sq(_a / _b), _b, _a,
+         EllipticFunction(_ab2 / _ac2 * Math::sq(_c / _b),
+                          -_ab2 / Math::sq(_b),
+                          _bc2 / _ac2 * Math::sq(_a / _b),
+                          Math::sq(_a / _b)))
+    , _y(Math::sq(_c / _b), _b, _c,
+         EllipticFunction(_bc2 / _ac2 * Math::sq(_a / _b),
+                          +_bc2 / Math::sq(_b),
+                          _ab2 / _ac2 * Math::sq(_c / _b),
+                          Math::sq(_c / _b)))
+  {
+    if (!(isfinite(_a) && _a >= _b && _b >= _c && _c > 0))
+      throw GeographicErr("JacobiConformal: axes are not in order");
+    if (!(_a > _c))
+      throw GeographicErr
+        ("JacobiConformal: use alternate constructor for sphere");
+    _x.fit(); _y.fit();
+  }
+
+  JacobiConformal::JacobiConformal(real a, real b, real c,
+                                   real ab, real bc)
+    : _a(a), _b(b), _c(c)
+    , _ab2(ab * (_a + _b))
+    , _bc2(bc * (_b + _c))
+    , _ac2(_ab2 + _bc2)
+    , _x(Math::sq(_a / _b), _b, _a,
+         EllipticFunction(_ab2 / _ac2 * Math::sq(_c / _b),
+                          -(_a - _b) * (_a + _b) / Math::sq(_b),
+                          _bc2 / _ac2 * Math::sq(_a / _b),
+                          Math::sq(_a / _b)))
+    , _y(Math::sq(_c / _b), _b, _c,
+         EllipticFunction(_bc2 / _ac2 * Math::sq(_a / _b),
+                          +(_b - _c) * (_b + _c) / Math::sq(_b),
+                          _ab2 / _ac2 * Math::sq(_c / _b),
+                          Math::sq(_c / _b)))
+  {
+    if (!(isfinite(_a) && _a >= _b && _b >= _c && _c > 0 &&
+          ab >= 0 && bc >= 0))
+      throw GeographicErr("JacobiConformal: axes are not in order");
+    if (!(ab + bc > 0 && isfinite(_ac2)))
+      throw GeographicErr("JacobiConformal: ab + bc must be positive");
+    _x.fit(); _y.fit();
+  }
+
+  Math::real JacobiConformal::x(real somg, real comg) const {
+    norm(somg, comg);
+    return _x(atan2(somg, comg), somg, comg);
+  }
+
+  Math::real JacobiConformal::x(real omg) const {
+    real somg, comg;
+    Math::sincosd(omg, somg, comg);
+    return _x(omg * Math::degree(), somg, comg) / Math::degree();
+  }
+
+  Math::real JacobiConformal::y(real sbet, real cbet) const {
+    norm(sbet, cbet);
+    return _y(atan2(sbet, cbet), sbet, cbet);
+  }
+
+  Math::real JacobiConformal::y(real bet) const {
+    real sbet, cbet;
+    Math::sincosd(bet, sbet, cbet);
+    return _y(bet * Math::degree(), sbet, cbet) / Math::degree();
+  }
+
+  void JacobiConformal::Reverse(real x, real y, real& bet, real& omg) const {
+    omg = _x.inv(x * Math::degree()) / Math::degree();
+    bet = _y.inv(y * Math::degree()) / Math::degree();
+  }
+
+  void JacobiConformal::ForwardBatch(size_t n, const real bet[],
+                                     const real omg[],
+                                     real x[], real y[]) const {
+    const int K = batchsize_;
+    for (size_t i0 = 0; i0 < n; i0 += K) {
+      int nb = int(min(size_t(K), n - i0));
+      _x.EvalBatch(nb, omg + i0, x + i0);
+      _y.EvalBatch(nb, bet + i0, y + i0);
+    }
+  }
+
+  void JacobiConformal::ReverseBatch(size_t n, const real x[],
+                                     const real y[],
+                                     real bet[], real omg[]) const {
+    const int K = batchsize_;
+    for (size_t i0 = 0; i0 < n; i0 += K) {
+      int nb = int(min(size_t(K), n - i0));
+      _x.InvBatch(nb, x + i0, omg + i0);
+      _y.InvBatch(nb, y + i0, bet + i0);
+    }
+  }
+
+} // namespace GeographicLib
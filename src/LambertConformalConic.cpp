@@ -345,6 +345,13 @@ namespace GeographicLib {
   void LambertConformalConic::Forward(real lon0, real lat, real lon,
                                       real& x, real& y,
                                       real& gamma, real& k) const {
+    Forward(lon0, lat, lon, x, y, gamma, k, true);
+  }
+
+  void LambertConformalConic::Forward(real lon0, real lat, real lon,
+                                      real& x, real& y,
+                                      real& gamma, real& k,
+                                      bool scalep) const {
     lon = Math::AngDiff(lon0, lon);
     // From Snyder, we have
     //
@@ -357,11 +364,11 @@ namespace GeographicLib {
     // where nrho0 = n * rho0, drho = rho - rho0
     // and drho is evaluated with divided differences
     real sphi, cphi;
-    Math::sincosd(Math::LatFix(lat) * _sign, sphi, cphi);
+    Math::sincosdInline(Math::LatFix(lat) * _sign, sphi, cphi);
     cphi = fmax(epsx_, cphi);
     real
       lam = lon * Math::degree(),
-      tphi = sphi/cphi, scbet = hyp(_fm * tphi),
+      tphi = sphi/cphi,
       scphi = 1/cphi, shxi = sinh(Math::eatanhe(sphi, _es)),
       tchi = hyp(shxi) * tphi - shxi * scphi, scchi = hyp(tchi),
       psi = asinh(tchi),
@@ -377,9 +384,11 @@ namespace GeographicLib {
       (_n != 0 ?
        (ctheta < 0 ? 1 - ctheta : Math::sq(stheta)/(1 + ctheta)) / _n : 0)
       - drho * ctheta;
-    k = _k0 * (scbet/_scbet0) /
-      (exp( - (Math::sq(_nc)/(1 + _n)) * dpsi )
-       * (tchi >= 0 ? scchi + tchi : 1 / (scchi - tchi)) / (_scchi0 + _tchi0));
+    if (scalep)
+      k = _k0 * (hyp(_fm * tphi)/_scbet0) /
+        (exp( - (Math::sq(_nc)/(1 + _n)) * dpsi )
+         * (tchi >= 0 ? scchi + tchi : 1 / (scchi - tchi)) /
+         (_scchi0 + _tchi0));
     y *= _sign;
     gamma = _sign * theta / Math::degree();
   }
@@ -387,6 +396,13 @@ namespace GeographicLib {
   void LambertConformalConic::Reverse(real lon0, real x, real y,
                                       real& lat, real& lon,
                                       real& gamma, real& k) const {
+    Reverse(lon0, x, y, lat, lon, gamma, k, true);
+  }
+
+  void LambertConformalConic::Reverse(real lon0, real x, real y,
+                                      real& lat, real& lon,
+                                      real& gamma, real& k,
+                                      bool scalep) const {
     // From Snyder, we have
     //
     //        x = rho * sin(theta)
@@ -441,17 +457,49 @@ namespace GeographicLib {
     gamma = atan2(nx, y1);
     real
       tphi = Math::tauf(tchi, _es),
-      scbet = hyp(_fm * tphi), scchi = hyp(tchi),
       lam = _n != 0 ? gamma / _n : x / y1;
-    lat = Math::atand(_sign * tphi);
+    lat = Math::atan2dInline(_sign * tphi, real(1));
     lon = lam / Math::degree();
-    lon = Math::AngNormalize(lon + Math::AngNormalize(lon0));
-    k = _k0 * (scbet/_scbet0) /
-      (exp(_nc != 0 ? - (Math::sq(_nc)/(1 + _n)) * dpsi : 0)
-       * (tchi >= 0 ? scchi + tchi : 1 / (scchi - tchi)) / (_scchi0 + _tchi0));
+    lon = Math::AngNormalizeInline(lon + Math::AngNormalizeInline(lon0));
+    if (scalep) {
+      real scbet = hyp(_fm * tphi), scchi = hyp(tchi);
+      k = _k0 * (scbet/_scbet0) /
+        (exp(_nc != 0 ? - (Math::sq(_nc)/(1 + _n)) * dpsi : 0)
+         * (tchi >= 0 ? scchi + tchi : 1 / (scchi - tchi)) /
+         (_scchi0 + _tchi0));
+    }
     gamma /= _sign * Math::degree();
   }
 
+  void LambertConformalConic::ForwardBatch(size_t n, real lon0,
+                                           const real lat[], const real lon[],
+                                           real x[], real y[],
+                                           real gamma[], real k[]) const {
+    // Skip the computation of k if it's not needed
+    bool scalep = k != nullptr;
+    for (size_t i = 0; i < n; ++i) {
+      real xi, yi, gi, ki;
+      Forward(lon0, lat[i], lon[i], xi, yi, gi, ki, scalep);
+      x[i] = xi; y[i] = yi;
+      if (gamma) gamma[i] = gi;
+      if (k) k[i] = ki;
+    }
+  }
+
+  void LambertConformalConic::ReverseBatch(size_t n, real lon0,
+                                           const real x[], const real y[],
+                                           real lat[], real lon[],
+                                           real gamma[], real k[]) const {
+    bool scalep = k != nullptr;
+    for (size_t i = 0; i < n; ++i) {
+      real lati, loni, gi, ki;
+      Reverse(lon0, x[i], y[i], lati, loni, gi, ki, scalep);
+      lat[i] = lati; lon[i] = loni;
+      if (gamma) gamma[i] = gi;
+      if (k) k[i] = ki;
+    }
+  }
+
   void LambertConformalConic::SetScale(real lat, real k) {
     if (!(isfinite(k) && k > 0))
       throw GeographicErr("Scale is not positive");
@@ -59,4 +59,87 @@ namespace GeographicLib {
       MatrixMultiply(M);
   }
 
+  template<typename T>
+  void LocalCartesian::IntForwardBatch(size_t n, const real lat[],
+                                       const real lon[], const real h[],
+                                       T x[], T y[], T z[], real M[]) const {
+    // Per batch, convert to geocentric with Geocentric::ForwardBatch and then
+    // apply the rotation following IntForward.
+    const int K = batchsize_;
+    for (size_t i0 = 0; i0 < n; i0 += K) {
+      int nb = int(min(size_t(K), n - i0));
+      real xc[K], yc[K], zc[K];
+      real* M0 = M ? M + i0 * dim2_ : nullptr;
+      _earth.ForwardBatch(nb, lat + i0, lon + i0, h + i0, xc, yc, zc, M0);
+      for (int j = 0; j < nb; ++j) {
+        real
+          xj = xc[j] - _x0,
+          yj = yc[j] - _y0,
+          zj = zc[j] - _z0;
+        x[i0 + j] = T(_r[0] * xj + _r[3] * yj + _r[6] * zj);
+        y[i0 + j] = T(_r[1] * xj + _r[4] * yj + _r[7] * zj);
+        z[i0 + j] = T(_r[2] * xj + _r[5] * yj + _r[8] * zj);
+      }
+      if (M0)
+        for (int j = 0; j < nb; ++j)
+          MatrixMultiply(M0 + j * dim2_);
+    }
+  }
+
+  template<typename T>
+  void LocalCartesian::IntReverseBatch(size_t n, const T x[], const T y[],
+                                       const T z[], real lat[], real lon[],
+                                       real h[], real M[]) const {
+    // Per batch, apply the rotation following IntReverse and then convert
+    // from geocentric with Geocentric::ReverseBatch.
+    const int K = batchsize_;
+    for (size_t i0 = 0; i0 < n; i0 += K) {
+      int nb = int(min(size_t(K), n - i0));
+      real xc[K], yc[K], zc[K];
+      for (int j = 0; j < nb; ++j) {
+        real
+          xj = real(x[i0 + j]),
+          yj = real(y[i0 + j]),
+          zj = real(z[i0 + j]);
+        xc[j] = _x0 + _r[0] * xj + _r[1] * yj + _r[2] * zj;
+        yc[j] = _y0 + _r[3] * xj + _r[4] * yj + _r[5] * zj;
+        zc[j] = _z0 + _r[6] * xj + _r[7] * yj + _r[8] * zj;
+      }
+      real* M0 = M ? M + i0 * dim2_ : nullptr;
+      _earth.ReverseBatch(nb, xc, yc, zc, lat + i0, lon + i0, h + i0, M0);
+      if (M0)
+        for (int j = 0; j < nb; ++j)
+          MatrixMultiply(M0 + j * dim2_);
+    }
+  }
+
+  void LocalCartesian::ForwardBatch(size_t n, const real lat[],
+                                    const real lon[], const real h[],
+                                    real x[], real y[], real z[],
+                                    real M[]) const {
+    IntForwardBatch(n, lat, lon, h, x, y, z, M);
+  }
+
+  void LocalCartesian::ReverseBatch(size_t n, const real x[], const real y[],
+                                    const real z[], real lat[], real lon[],
+                                    real h[], real M[]) const {
+    IntReverseBatch(n, x, y, z, lat, lon, h, M);
+  }
+
+#if GEOGRAPHICLIB_PRECISION != 1
+  void LocalCartesian::ForwardBatch(size_t n, const real lat[],
+                                    const real lon[], const real h[],
+                                    float x[], float y[], float z[],
+                                    real M[]) const {
+    IntForwardBatch(n, lat, lon, h, x, y, z, M);
+  }
+
+  void LocalCartesian::ReverseBatch(size_t n, const float x[],
+                                    const float y[], const float z[],
+                                    real lat[], real lon[], real h[],
+                                    real M[]) const {
+    IntReverseBatch(n, x, y, z, lat, lon, h, M);
+  }
+#endif
+
 } // namespace GeographicLib
@@ -0,0 +1,172 @@
+/**
+ * \file LocalCartesianSet.cpp
+ * \brief Implementation for GeographicLib::LocalCartesianSet class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#include <GeographicLib/LocalCartesianSet.hpp>
+#include <GeographicLib/Utility.hpp>
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  int LocalCartesianSet::Add(real lat0, real lon0, real h0) {
+    int id = NumOrigins();
+    _lat0.push_back(0); _lon0.push_back(0); _h0.push_back(0);
+    _x0.push_back(0); _y0.push_back(0); _z0.push_back(0);
+    for (size_t k = 0; k < dim2_; ++k) _r[k].push_back(0);
+    Reset(id, lat0, lon0, h0);
+    return id;
+  }
+
+  void LocalCartesianSet::Reset(int id, real lat0, real lon0, real h0) {
+    // This follows LocalCartesian::Reset
+    Check(id);
+    _lat0[id] = Math::LatFix(lat0);
+    _lon0[id] = Math::AngNormalize(lon0);
+    _h0[id] = h0;
+    _earth.Forward(_lat0[id], _lon0[id], _h0[id], _x0[id], _y0[id], _z0[id]);
+    real sphi, cphi, slam, clam, r[dim2_];
+    Math::sincosd(_lat0[id], sphi, cphi);
+    Math::sincosd(_lon0[id], slam, clam);
+    Geocentric::Rotation(sphi, cphi, slam, clam, r);
+    for (size_t k = 0; k < dim2_; ++k) _r[k][id] = r[k];
+  }
+
+  void LocalCartesianSet::Clear() {
+    _lat0.clear(); _lon0.clear(); _h0.clear();
+    _x0.clear(); _y0.clear(); _z0.clear();
+    for (size_t k = 0; k < dim2_; ++k) _r[k].clear();
+  }
+
+  void LocalCartesianSet::Check(int id) const {
+    if (!(id >= 0 && id < NumOrigins()))
+      throw GeographicErr("Origin " + Utility::str(id) + " not in [0, "
+                          + Utility::str(NumOrigins()) + ")");
+  }
+
+  void LocalCartesianSet::MatrixMultiply(int id, real M[dim2_]) const {
+    // M = r' . M, following LocalCartesian::MatrixMultiply
+    real t[dim2_];
+    copy(M, M + dim2_, t);
+    for (size_t i = 0; i < dim2_; ++i) {
+      size_t row = i / dim_, col = i % dim_;
+      M[i] = _r[row][id] * t[col] + _r[row+3][id] * t[col+3] +
+        _r[row+6][id] * t[col+6];
+    }
+  }
+
+  template<typename T>
+  void LocalCartesianSet::IntForwardBatch(size_t n, const int id[],
+                                          const real lat[], const real lon[],
+                                          const real h[], T x[], T y[], T z[],
+                                          real M[]) const {
+    for (size_t i = 0; i < n; ++i) Check(id[i]);
+    // Per batch, convert to geocentric with Geocentric::ForwardBatch, gather
+    // the data for the origins, and apply the rotations following
+    // LocalCartesian::IntForwardBatch.
+    const int K = batchsize_;
+    for (size_t i0 = 0; i0 < n; i0 += K) {
+      int nb = int(min(size_t(K), n - i0));
+      real xc[K], yc[K], zc[K], x0[K], y0[K], z0[K], r[dim2_][K];
+      real* M0 = M ? M + i0 * dim2_ : nullptr;
+      _earth.ForwardBatch(nb, lat + i0, lon + i0, h + i0, xc, yc, zc, M0);
+      for (int j = 0; j < nb; ++j) {
+        int k = id[i0 + j];
+        x0[j] = _x0[k]; y0[j] = _y0[k]; z0[j] = _z0[k];
+      }
+      for (size_t l = 0; l < dim2_; ++l)
+        for (int j = 0; j < nb; ++j)
+          r[l][j] = _r[l][id[i0 + j]];
+      for (int j = 0; j < nb; ++j) {
+        real
+          xj = xc[j] - x0[j],
+          yj = yc[j] - y0[j],
+          zj = zc[j] - z0[j];
+        x[i0 + j] = T(r[0][j] * xj + r[3][j] * yj + r[6][j] * zj);
+        y[i0 + j] = T(r[1][j] * xj + r[4][j] * yj + r[7][j] * zj);
+        z[i0 + j] = T(r[2][j] * xj + r[5][j] * yj + r[8][j] * zj);
+      }
+      if (M0)
+        for (int j = 0; j < nb; ++j)
+          MatrixMultiply(id[i0 + j], M0 + j * dim2_);
+    }
+  }
+
+  template<typename T>
+  void LocalCartesianSet::IntReverseBatch(size_t n, const int id[],
+                                          const T x[], const T y[],
+                                          const T z[], real lat[],
+                                          real lon[], real h[],
+                                          real M[]) const {
+    for (size_t i = 0; i < n; ++i) Check(id[i]);
+    // Per batch, gather the data for the origins, apply the rotations
+    // following LocalCartesian::IntReverseBatch, and convert from geocentric
+    // with Geocentric::ReverseBatch.
+    const int K = batchsize_;
+    for (size_t i0 = 0; i0 < n; i0 += K) {
+      int nb = int(min(size_t(K), n - i0));
+      real xc[K], yc[K], zc[K], x0[K], y0[K], z0[K], r[dim2_][K];
+      for (int j = 0; j < nb; ++j) {
+        int k = id[i0 + j];
+        x0[j] = _x0[k]; y0[j] = _y0[k]; z0[j] = _z0[k];
+      }
+      for (size_t l = 0; l < dim2_; ++l)
+        for (int j = 0; j < nb; ++j)
+          r[l][j] = _r[l][id[i0 + j]];
+      for (int j = 0; j < nb; ++j) {
+        real
+          xj = real(x[i0 + j]),
+          yj = real(y[i0 + j]),
+          zj = real(z[i0 + j]);
+        xc[j] = x0[j] + r[0][j] * xj + r[1][j] * yj + r[2][j] * zj;
+        yc[j] = y0[j] + r[3][j] * xj + r[4][j] * yj + r[5][j] * zj;
+        zc[j] = z0[j] + r[6][j] * xj + r[7][j] * yj + r[8][j] * zj;
+      }
+      real* M0 = M ? M + i0 * dim2_ : nullptr;
+      _earth.ReverseBatch(nb, xc, yc, zc, lat + i0, lon + i0, h + i0, M0);
+      if (M0)
+        for (int j = 0; j < nb; ++j)
+          MatrixMultiply(id[i0 + j], M0 + j * dim2_);
+    }
+  }
+
+  void LocalCartesianSet::ForwardBatch(size_t n, const int id[],
+                                       const real lat[], const real lon[],
+                                       const real h[],
+                                       real x[], real y[], real z[],
+                                       real M[]) const {
+    IntForwardBatch(n, id, lat, lon, h, x, y, z, M);
+  }
+
+  void LocalCartesianSet::ReverseBatch(size_t n, const int id[],
+                                       const real x[], const real y[],
+                                       const real z[],
+                                       real lat[], real lon[], real h[],
+                                       real M[]) const {
+    IntReverseBatch(n, id, x, y, z, lat, lon, h, M);
+  }
+
+#if GEOGRAPHICLIB_PRECISION != 1
+  void LocalCartesianSet::ForwardBatch(size_t n, const int id[],
+                                       const real lat[], const real lon[],
+                                       const real h[],
+                                       float x[], float y[], float z[],
+                                       real M[]) const {
+    IntForwardBatch(n, id, lat, lon, h, x, y, z, M);
+  }
+
+  void LocalCartesianSet::ReverseBatch(size_t n, const int id[],
+                                       const float x[], const float y[],
+                                       const float z[],
+                                       real lat[], real lon[], real h[],
+                                       real M[]) const {
+    IntReverseBatch(n, id, x, y, z, lat, lon, h, M);
+  }
+#endif
+
+} // namespace GeographicLib
@@ -9,6 +9,7 @@
 
 #include <GeographicLib/MGRS.hpp>
 #include <GeographicLib/Utility.hpp>
+#include <cstring>
 
 #if defined(_MSC_VER)
 // Squelch warnings about enum-float expressions and mixing enums
@@ -19,6 +20,32 @@ namespace GeographicLib {
 
   using namespace std;
 
+  namespace {
+    // Table-driven lookup of the letters in one of the MGRS letter sets,
+    // giving the index of the letter (ignoring case) or -1 if the letter
+    // isn't in the set.  This is equivalent to Utility::lookup.
+    class letterset {
+    private:
+      signed char _ind[26];
+    public:
+      explicit letterset(const char* s) {
+        fill(_ind, _ind + 26, -1);
+        for (int i = 0; s[i]; ++i)
+          _ind[s[i] - 'A'] = (signed char)(i);
+      }
+      int operator()(char c) const {
+        // Fold lower case to upper case; all other characters map outside
+        // [0, 26).
+        unsigned k = (unsigned((unsigned char)(c)) | 0x20u) - unsigned('a');
+        return k < 26u ? _ind[k] : -1;
+      }
+    };
+
+    int digitindex(char c) {
+      return c >= '0' && c <= '9' ? c - '0' : -1;
+    }
+  }
+
   const char* const MGRS::hemispheres_ = "SN";
   const char* const MGRS::utmcols_[] = { "ABCDEFGH", "JKLMNPQR", "STUVWXYZ" };
   const char* const MGRS::utmrow_ = "ABCDEFGHJKLMNPQRSTUV";
@@ -43,16 +70,22 @@ namespace GeographicLib {
     { maxupsSind_, maxupsNind_,
       maxutmNrow_ + (maxutmSrow_ - minutmNrow_), maxutmNrow_ };
 
-  void MGRS::Forward(int zone, bool northp, real x, real y, real lat,
-                     int prec, std::string& mgrs) {
+  int MGRS::Forward(int zone, bool northp, real x, real y, real lat,
+                    int prec, char mgrs[]) {
     using std::isnan;           // Needed for Centos 7, ubuntu 14
     // The smallest angle s.t., 90 - angeps() < 90 (approx 50e-12 arcsec)
     // 7 = ceil(log_2(90))
     static const real angeps = ldexp(real(1), -(Math::digits() - 7));
+    // Powers of 10 for truncating the easting and northing to prec digits
+    static const long long pow10[maxprec_ + 1] = {
+      1LL, 10LL, 100LL, 1000LL, 10000LL, 100000LL, 1000000LL, 10000000LL,
+      100000000LL, 1000000000LL, 10000000000LL, 100000000000LL,
+    };
     if (zone == UTMUPS::INVALID ||
         isnan(x) || isnan(y) || isnan(lat)) {
-      mgrs = "INVALID";
-      return;
+      static const char invalid[] = "INVALID";
+      copy(invalid, invalid + sizeof(invalid), mgrs);
+      return int(sizeof(invalid)) - 1;
     }
     bool utmp = zone != 0;
     CheckCoords(utmp, northp, x, y);
@@ -62,19 +95,11 @@ namespace GeographicLib {
       throw GeographicErr("MGRS precision " + Utility::str(prec)
                           + " not in [-1, "
                           + Utility::str(int(maxprec_)) + "]");
-    // Fixed char array for accumulating string.  Allow space for zone, 3 block
-    // letters, easting + northing.  Don't need to allow for terminating null.
-    char mgrs1[2 + 3 + 2 * maxprec_];
+    // Allow space for zone, 3 block letters, easting + northing.
     int
       zone1 = zone - 1,
       z = utmp ? 2 : 0,
       mlen = z + 3 + 2 * prec;
-    if (utmp) {
-      mgrs1[0] = digits_[ zone / base_ ];
-      mgrs1[1] = digits_[ zone % base_ ];
-      // This isn't necessary...!  Keep y non-neg
-      // if (!northp) y -= maxutmSrow_ * tile_;
-    }
     // The C++ standard mandates 64 bits for long long.  But
     // check, to make sure.
     static_assert(numeric_limits<long long>::digits >= 44,
@@ -91,6 +116,8 @@ namespace GeographicLib {
       iy = (long long)(floor(yy)),
       m = (long long)(mult_) * (long long)(tile_);
     int xh = int(ix / m), yh = int(iy / m);
+    // Determine the letters before writing anything to mgrs
+    char c0, c1, c2;
     if (utmp) {
       int
         // Correct fuzziness in latitude near equator
@@ -100,34 +127,46 @@ namespace GeographicLib {
       if (irow != yh - (northp ? minutmNrow_ : maxutmSrow_))
         throw GeographicErr("Latitude " + Utility::str(lat)
                             + " is inconsistent with UTM coordinates");
-      mgrs1[z++] = latband_[10 + iband];
-      mgrs1[z++] = utmcols_[zone1 % 3][icol];
-      mgrs1[z++] = utmrow_[(yh + (zone1 & 1 ? utmevenrowshift_ : 0))
-                         % utmrowperiod_];
+      c0 = latband_[10 + iband];
+      c1 = utmcols_[zone1 % 3][icol];
+      c2 = utmrow_[(yh + (zone1 & 1 ? utmevenrowshift_ : 0))
+                   % utmrowperiod_];
+      mgrs[0] = char('0' + zone / base_);
+      mgrs[1] = char('0' + zone % base_);
+      // This isn't necessary...!  Keep y non-neg
+      // if (!northp) y -= maxutmSrow_ * tile_;
     } else {
       bool eastp = xh >= upseasting_;
       int iband = (northp ? 2 : 0) + (eastp ? 1 : 0);
-      mgrs1[z++] = upsband_[iband];
-      mgrs1[z++] = upscols_[iband][xh - (eastp ? upseasting_ :
-                                         (northp ? minupsNind_ :
-                                          minupsSind_))];
-      mgrs1[z++] = upsrows_[northp][yh - (northp ? minupsNind_ : minupsSind_)];
+      c0 = upsband_[iband];
+      c1 = upscols_[iband][xh - (eastp ? upseasting_ :
+                                 (northp ? minupsNind_ : minupsSind_))];
+      c2 = upsrows_[northp][yh - (northp ? minupsNind_ : minupsSind_)];
     }
+    // With prec = -1, only the first letter is retained
+    mgrs[z++] = c0; mgrs[z++] = c1; mgrs[z++] = c2;
     if (prec > 0) {
       ix -= m * xh; iy -= m * yh;
-      long long d = (long long)(pow(real(base_), maxprec_ - prec));
+      long long d = pow10[maxprec_ - prec];
       ix /= d; iy /= d;
       for (int c = prec; c--;) {
-        mgrs1[z + c       ] = digits_[ix % base_]; ix /= base_;
-        mgrs1[z + c + prec] = digits_[iy % base_]; iy /= base_;
+        mgrs[z + c       ] = char('0' + ix % base_); ix /= base_;
+        mgrs[z + c + prec] = char('0' + iy % base_); iy /= base_;
       }
     }
-    mgrs.resize(mlen);
-    copy(mgrs1, mgrs1 + mlen, mgrs.begin());
+    mgrs[mlen] = '\0';
+    return mlen;
   }
 
-  void MGRS::Forward(int zone, bool northp, real x, real y,
+  void MGRS::Forward(int zone, bool northp, real x, real y, real lat,
                      int prec, std::string& mgrs) {
+    // Fixed char array for accumulating string.
+    char mgrs1[MAXLENGTH + 1];
+    int mlen = Forward(zone, northp, x, y, lat, prec, mgrs1);
+    mgrs.assign(mgrs1, mlen);
+  }
+
+  Math::real MGRS::ForwardLatitude(int zone, bool northp, real x, real y) {
     real lat, lon;
     if (zone > 0) {
       // Does a rough estimate for latitude determine the latitude band?
@@ -158,15 +197,50 @@ namespace GeographicLib {
     } else
       // Latitude isn't needed for UPS specs or for INVALID
       lat = 0;
-    Forward(zone, northp, x, y, lat, prec, mgrs);
+    return lat;
   }
 
-  void MGRS::Reverse(const string& mgrs,
+  void MGRS::Forward(int zone, bool northp, real x, real y,
+                     int prec, std::string& mgrs) {
+    Forward(zone, northp, x, y, ForwardLatitude(zone, northp, x, y),
+            prec, mgrs);
+  }
+
+  int MGRS::Forward(int zone, bool northp, real x, real y,
+                    int prec, char mgrs[]) {
+    return Forward(zone, northp, x, y, ForwardLatitude(zone, northp, x, y),
+                   prec, mgrs);
+  }
+
+  void MGRS::ForwardBatch(size_t n, const int zone[], const bool northp[],
+                          const real x[], const real y[], int prec,
+                          char mgrs[], const real lat[]) {
+    for (size_t i = 0; i < n; ++i)
+      Forward(zone[i], northp[i], x[i], y[i],
+              lat ? lat[i] : ForwardLatitude(zone[i], northp[i], x[i], y[i]),
+              prec, mgrs + i * (MAXLENGTH + 1));
+  }
+
+  void MGRS::Reverse(const char* mgrs, size_t len0,
                      int& zone, bool& northp, real& x, real& y,
                      int& prec, bool centerp) {
+    // The letter sets uses by Reverse
+    static const letterset
+      latband(latband_), upsband(upsband_),
+      utmcols[3] = { letterset(utmcols_[0]), letterset(utmcols_[1]),
+                     letterset(utmcols_[2]) },
+      utmrow(utmrow_),
+      upscols[4] = { letterset(upscols_[0]), letterset(upscols_[1]),
+                     letterset(upscols_[2]), letterset(upscols_[3]) },
+      upsrows[2] = { letterset(upsrows_[0]), letterset(upsrows_[1]) };
+    // Strings for the error messages (allocated only if an error is thrown)
+    auto str = [mgrs](int p0, int n) -> string
+      { return string(mgrs + p0, n); };
+    if (len0 > size_t(numeric_limits<int>::max()))
+      throw GeographicErr("MGRS string too long");
     int
       p = 0,
-      len = int(mgrs.length());
+      len = int(len0);
     if (len >= 3 &&
         toupper(mgrs[0]) == 'I' &&
         toupper(mgrs[1]) == 'N' &&
@@ -179,7 +253,7 @@ namespace GeographicLib {
     }
     int zone1 = 0;
     while (p < len) {
-      int i = Utility::lookup(digits_, mgrs[p]);
+      int i = digitindex(mgrs[p]);
       if (i < 0)
         break;
       zone1 = 10 * zone1 + i;
@@ -189,13 +263,13 @@ namespace GeographicLib {
       throw GeographicErr("Zone " + Utility::str(zone1) + " not in [1,60]");
     if (p > 2)
       throw GeographicErr("More than 2 digits at start of MGRS "
-                          + mgrs.substr(0, p));
+                          + str(0, p));
     if (len - p < 1)
-      throw GeographicErr("MGRS string too short " + mgrs);
+      throw GeographicErr("MGRS string too short " + str(0, len));
     bool utmp = zone1 != UTMUPS::UPS;
     int zonem1 = zone1 - 1;
     const char* band = utmp ? latband_ : upsband_;
-    int iband = Utility::lookup(band, mgrs[p++]);
+    int iband = (utmp ? latband : upsband)(mgrs[p++]);
     if (iband < 0)
       throw GeographicErr("Band letter " + Utility::str(mgrs[p-1]) + " not in "
                           + (utmp ? "UTM" : "UPS") + " set " + band);
@@ -221,17 +295,17 @@ namespace GeographicLib {
       prec = -1;
       return;
     } else if (len - p < 2)
-      throw GeographicErr("Missing row letter in " + mgrs);
+      throw GeographicErr("Missing row letter in " + str(0, len));
     const char* col = utmp ? utmcols_[zonem1 % 3] : upscols_[iband];
     const char* row = utmp ? utmrow_ : upsrows_[northp1];
-    int icol = Utility::lookup(col, mgrs[p++]);
+    int icol = (utmp ? utmcols[zonem1 % 3] : upscols[iband])(mgrs[p++]);
     if (icol < 0)
       throw GeographicErr("Column letter " + Utility::str(mgrs[p-1])
                           + " not in "
-                          + (utmp ? "zone " + mgrs.substr(0, p-2) :
+                          + (utmp ? "zone " + str(0, p-2) :
                              "UPS band " + Utility::str(mgrs[p-2]))
                           + " set " + col );
-    int irow = Utility::lookup(row, mgrs[p++]);
+    int irow = (utmp ? utmrow : upsrows[northp1])(mgrs[p++]);
     if (irow < 0)
       throw GeographicErr("Row letter " + Utility::str(mgrs[p-1]) + " not in "
                           + (utmp ? "UTM" :
@@ -243,8 +317,8 @@ namespace GeographicLib {
       iband -= 10;
       irow = UTMRow(iband, icol, irow);
       if (irow == maxutmSrow_)
-        throw GeographicErr("Block " + mgrs.substr(p-2, 2)
-                            + " not in zone/band " + mgrs.substr(0, p-2));
+        throw GeographicErr("Block " + str(p-2, 2)
+                            + " not in zone/band " + str(0, p-2));
 
       irow = northp1 ? irow : irow + 100;
       icol = icol + minutmcol_;
@@ -254,40 +328,61 @@ namespace GeographicLib {
       irow += northp1 ? minupsNind_ : minupsSind_;
     }
     int prec1 = (len - p)/2;
-    real
+    if ((len - p) % 2) {
+      for (int i = p; i < len; ++i)
+        if (digitindex(mgrs[i]) < 0)
+          throw GeographicErr("Encountered a non-digit in " +
+                              str(p, len - p));
+      throw GeographicErr("Not an even number of digits in "
+                          + str(p, len - p));
+    }
+    if (prec1 > maxprec_) {
+      for (int i = p; i < len; ++i)
+        if (digitindex(mgrs[i]) < 0)
+          throw GeographicErr("Encountered a non-digit in " +
+                              str(p, len - p));
+      throw GeographicErr("More than " + Utility::str(2*maxprec_)
+                          + " digits in " + str(p, len - p));
+    }
+    // Accumulate the digits in integers; these are exactly representable as
+    // reals (< 2^44), so the conversion to reals below is exact.
+    long long
       unit = 1,
       x1 = icol,
       y1 = irow;
     for (int i = 0; i < prec1; ++i) {
       unit *= base_;
       int
-        ix = Utility::lookup(digits_, mgrs[p + i]),
-        iy = Utility::lookup(digits_, mgrs[p + i + prec1]);
+        ix = digitindex(mgrs[p + i]),
+        iy = digitindex(mgrs[p + i + prec1]);
       if (ix < 0 || iy < 0)
-        throw GeographicErr("Encountered a non-digit in " + mgrs.substr(p));
+        throw GeographicErr("Encountered a non-digit in " + str(p, len - p));
       x1 = base_ * x1 + ix;
       y1 = base_ * y1 + iy;
     }
-    if ((len - p) % 2) {
-      if (Utility::lookup(digits_, mgrs[len - 1]) < 0)
-        throw GeographicErr("Encountered a non-digit in " + mgrs.substr(p));
-      else
-        throw GeographicErr("Not an even number of digits in "
-                            + mgrs.substr(p));
-    }
-    if (prec1 > maxprec_)
-      throw GeographicErr("More than " + Utility::str(2*maxprec_)
-                          + " digits in " + mgrs.substr(p));
     if (centerp) {
       unit *= 2; x1 = 2 * x1 + 1; y1 = 2 * y1 + 1;
     }
     zone = zone1;
     northp = northp1;
-    x = (tile_ * x1) / unit;
-    y = (tile_ * y1) / unit;
+    x = (tile_ * real(x1)) / real(unit);
+    y = (tile_ * real(y1)) / real(unit);
     prec = prec1;
   }
 
+  void MGRS::ReverseBatch(size_t n, const char mgrs[],
+                          int zone[], bool northp[], real x[], real y[],
+                          int prec[], bool centerp) {
+    for (size_t i = 0; i < n; ++i) {
+      const char* s = mgrs + i * (MAXLENGTH + 1);
+      const void* e = memchr(s, '\0', MAXLENGTH + 1);
+      int precx;
+      Reverse(s, e ? size_t(static_cast<const char*>(e) - s) : MAXLENGTH + 1,
+              zone[i], northp[i], x[i], y[i], precx, centerp);
+      if (prec) prec[i] = precx;
+    }
+  }
+
   void MGRS::CheckCoords(bool utmp, bool& northp, real& x, real& y) {
     // Limits are all multiples of 100km and are all closed on the lower end
     // and open on the upper end -- and this is reflected in the error
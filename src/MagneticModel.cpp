@@ -8,9 +8,15 @@
  **********************************************************************/
 
 #include <GeographicLib/MagneticModel.hpp>
+#include <algorithm>
 #include <fstream>
+#include <functional>
 #include <GeographicLib/SphericalEngine.hpp>
 #include <GeographicLib/MagneticCircle.hpp>
+#include <GeographicLib/MagneticSnapshot.hpp>
+#include <GeographicLib/GeodesicBatchExecutor.hpp>
+#include <GeographicLib/SharedInstances.hpp>
+#include <GeographicLib/Trace.hpp>
 #include <GeographicLib/Utility.hpp>
 
 #if !defined(GEOGRAPHICLIB_DATA)
@@ -35,7 +41,8 @@ namespace GeographicLib {
   using namespace std;
 
   MagneticModel::MagneticModel(const std::string& name, const std::string& path,
-                               const Geocentric& earth, int Nmax, int Mmax)
+                               const Geocentric& earth, int Nmax, int Mmax,
+                               bool mapfile)
     : _name(name)
     , _dir(path)
     , _description("NONE")
@@ -53,7 +60,19 @@ namespace GeographicLib {
     , _mmx(-1)
     , _norm(SphericalHarmonic::SCHMIDT)
     , _earth(earth)
+    , _coeffs(make_shared<coeffstore>())
+    , _circledlat(Math::NaN())
+    , _circledh(Math::NaN())
+    , _circledt(Math::NaN())
+    , _trunctol(0)
   {
+    GEOGRAPHICLIB_TRACE_SPAN("MagneticModel::MagneticModel");
+    // A model compiled into the library is used if no path is given
+    const char *emeta = nullptr, *ecoeff = nullptr;
+    size_t nmeta = 0, ncoeff = 0;
+    bool embedded = _dir.empty() &&
+      Utility::EmbeddedData("magnetic/" + name + ".wmm", emeta, nmeta) &&
+      Utility::EmbeddedData("magnetic/" + name + ".wmm.cof", ecoeff, ncoeff);
     if (_dir.empty())
       _dir = DefaultMagneticPath();
     bool truncate = Nmax >= 0 || Mmax >= 0;
@@ -62,11 +81,43 @@ namespace GeographicLib {
       if (Nmax < 0) Nmax = numeric_limits<int>::max();
       if (Mmax < 0) Mmax = numeric_limits<int>::max();
     }
-    ReadMetadata(_name);
-    _gG.resize(_nNmodels + 1 + _nNconstants);
-    _hH.resize(_nNmodels + 1 + _nNconstants);
-    {
-      string coeff = _filename + ".cof";
+    ReadMetadata(_name, embedded ? emeta : nullptr, nmeta);
+    _coeffs->gG.resize(_nNmodels + 1 + _nNconstants);
+    _coeffs->hH.resize(_nNmodels + 1 + _nNconstants);
+    string coeff = _filename + ".cof";
+    if (mapfile || embedded) {
+      char* data;
+      const char* end;
+      if (embedded) {
+        // The coefficients are used in place; they are never modified.
+        data = const_cast<char*>(ecoeff);
+        end = data + ncoeff;
+      } else {
+        _coeffs->cofmap.map(coeff);
+        data = _coeffs->cofmap.data();
+        end = data + _coeffs->cofmap.size();
+      }
+      if (end - data < idlength_)
+        throw GeographicErr("No header in " + coeff);
+      if (_id != string(data, idlength_))
+        throw GeographicErr("ID mismatch: " + _id + " vs " +
+                            string(data, idlength_));
+      data += idlength_;
+      for (int i = 0; i < _nNmodels + 1 + _nNconstants; ++i) {
+        int N, M;
+        real* C;
+        if (truncate) { N = Nmax; M = Mmax; }
+        SphericalEngine::coeff c =
+          SphericalEngine::coeff::mapcoeffs(data, end, N, M, C, truncate);
+        if (!(M < 0 || C[0] == 0))
+          throw GeographicErr("A degree 0 term is not permitted");
+        _harm.push_back(SphericalHarmonic(c, _a, _norm));
+        _nmx = max(_nmx, _harm.back().Coefficients().nmx());
+        _mmx = max(_mmx, _harm.back().Coefficients().mmx());
+      }
+      if (data != end)
+        throw GeographicErr("Extra data in " + coeff);
+    } else {
       ifstream coeffstr(coeff.c_str(), ios::binary);
       if (!coeffstr.good())
         throw GeographicErr("Error opening " + coeff);
@@ -77,30 +128,85 @@ namespace GeographicLib {
       id[idlength_] = '\0';
       if (_id != string(id))
         throw GeographicErr("ID mismatch: " + _id + " vs " + id);
-      for (int i = 0; i < _nNmodels + 1 + _nNconstants; ++i) {
-        int N, M;
-        if (truncate) { N = Nmax; M = Mmax; }
-        SphericalEngine::coeff::readcoeffs(coeffstr, N, M, _gG[i], _hH[i],
-                                           truncate);
-        if (!(M < 0 || _gG[i][0] == 0))
+      streamoff size = coeffstr.seekg(0, ios::end).tellg();
+      coeffstr.close();
+      // Read the coefficients for all the epochs together, using several
+      // threads.
+      int k = _nNmodels + 1 + _nNconstants;
+      vector<int> N(k, Nmax), M(k, Mmax);
+      streamoff pos =
+        SphericalEngine::coeff::readcoeffs(coeff, idlength_, k,
+                                           N.data(), M.data(),
+                                           _coeffs->gG.data(),
+                                           _coeffs->hH.data(), truncate);
+      for (int i = 0; i < k; ++i) {
+        if (!(M[i] < 0 || _coeffs->gG[i][0] == 0))
           throw GeographicErr("A degree 0 term is not permitted");
-        _harm.push_back(SphericalHarmonic(_gG[i], _hH[i], N, N, M, _a, _norm));
+        _harm.push_back(SphericalHarmonic(_coeffs->gG[i], _coeffs->hH[i],
+                                          N[i], N[i], M[i], _a, _norm));
         _nmx = max(_nmx, _harm.back().Coefficients().nmx());
         _mmx = max(_mmx, _harm.back().Coefficients().mmx());
       }
-      int pos = int(coeffstr.tellg());
-      coeffstr.seekg(0, ios::end);
-      if (pos != coeffstr.tellg())
+      if (pos != size)
         throw GeographicErr("Extra data in " + coeff);
     }
   }
 
-  void MagneticModel::ReadMetadata(const string& name) {
+  MagneticModel::MagneticModel(const MagneticModel& model)
+    : _name(model._name)
+    , _dir(model._dir)
+    , _description(model._description)
+    , _date(model._date)
+    , _filename(model._filename)
+    , _id(model._id)
+    , _t0(model._t0)
+    , _dt0(model._dt0)
+    , _tmin(model._tmin)
+    , _tmax(model._tmax)
+    , _a(model._a)
+    , _hmin(model._hmin)
+    , _hmax(model._hmax)
+    , _nNmodels(model._nNmodels)
+    , _nNconstants(model._nNconstants)
+    , _nmx(model._nmx)
+    , _mmx(model._mmx)
+    , _norm(model._norm)
+    , _earth(model._earth)
+    , _coeffs(model._coeffs)
+    , _harm(model._harm)
+    , _circledlat(model._circledlat)
+    , _circledh(model._circledh)
+    , _circledt(model._circledt)
+    , _trunctol(model._trunctol)
+    , _truncbound(model._truncbound)
+  {
+    _circles.Reset(model._circles.Capacity());
+    _epochs.Reset(model._epochs.Capacity());
+  }
+
+  const MagneticModel& MagneticModel::Get(const string& name,
+                                          const string& path) {
+    static SharedInstances<MagneticModel, string> instances;
+    // An empty path isn't replaced by DefaultMagneticPath() because it
+    // selects an embedded model, if any.
+    return instances.Get(name + '\0' + path, name, path);
+  }
+
+  void MagneticModel::ReadMetadata(const string& name,
+                                   const char* edata, size_t esize) {
     const char* spaces = " \t\n\v\f\r";
-    _filename = _dir + "/" + name + ".wmm";
-    ifstream metastr(_filename.c_str());
-    if (!metastr.good())
-      throw GeographicErr("Cannot open " + _filename);
+    istringstream emetastr;
+    ifstream fmetastr;
+    if (edata) {
+      _filename = "embedded:magnetic/" + name + ".wmm";
+      emetastr.str(string(edata, esize));
+    } else {
+      _filename = _dir + "/" + name + ".wmm";
+      fmetastr.open(_filename.c_str());
+      if (!fmetastr.good())
+        throw GeographicErr("Cannot open " + _filename);
+    }
+    istream& metastr = edata ? static_cast<istream&>(emetastr) : fmetastr;
     string line;
     getline(metastr, line);
     if (!(line.size() >= 6 && line.substr(0,5) == "WMMF-"))
@@ -192,10 +298,40 @@ namespace GeographicLib {
     // Components in geocentric basis
     // initial values to suppress warning
     real BXc = 0, BYc = 0, BZc = 0;
-    _harm[n](X, Y, Z, BX, BY, BZ);
-    _harm[n + 1](X, Y, Z, BXt, BYt, BZt);
-    if (_nNconstants)
-      _harm[_nNmodels + 1](X, Y, Z, BXc, BYc, BZc);
+    // Evaluate the sums for the two epochs (and the constant terms) in a
+    // single pass.
+    const SphericalHarmonic *h0, *h1;
+    shared_ptr<const epochpair> e = Epochs(n, h0, h1);
+    const SphericalHarmonic* harms[] =
+      {h0, h1, _nNconstants ? &_harm[_nNmodels + 1] : nullptr};
+    SphericalHarmonic truncated[3];
+    if (_trunctol > 0) {
+      // The weights of the sums in the field; the tolerance is shared
+      // equally between the sums.
+      real
+        r = hypot(hypot(X, Y), Z),
+        w[] = { interpolate ? fabs(1 - t / _dt0) : 1,
+                interpolate ? fabs(t / _dt0) : fabs(t), 1 };
+      int k[] = { n, n + 1, _nNmodels + 1 }, K = _nNconstants ? 3 : 2;
+      for (int j = 0; j < K; ++j) {
+        const SphericalEngine::coeff& c = harms[j]->Coefficients();
+        int N = SphericalEngine::TruncatedDegree
+          (_truncbound[k[j]], _a / r, _trunctol * r / (_a * K * w[j]));
+        if (N < c.nmx()) {
+          truncated[j] = SphericalHarmonic(SphericalEngine::coeff(c, N, N),
+                                           _a, _norm);
+          harms[j] = &truncated[j];
+        }
+      }
+    }
+    real v[3], gX[3], gY[3], gZ[3];
+    if (_nNconstants) {
+      SphericalHarmonic::GradientMulti<3>(harms, X, Y, Z, v, gX, gY, gZ);
+      BXc = gX[2]; BYc = gY[2]; BZc = gZ[2];
+    } else
+      SphericalHarmonic::GradientMulti<2>(harms, X, Y, Z, v, gX, gY, gZ);
+    BX  = gX[0]; BY  = gY[0]; BZ  = gZ[0];
+    BXt = gX[1]; BYt = gY[1]; BZt = gZ[1];
     if (interpolate) {
       // Convert to a time derivative
       BXt = (BXt - BX) / _dt0;
@@ -218,6 +354,14 @@ namespace GeographicLib {
   void MagneticModel::Field(real t, real lat, real lon, real h, bool diffp,
                             real& Bx, real& By, real& Bz,
                             real& Bxt, real& Byt, real& Bzt) const {
+    shared_ptr<const MagneticCircle> c(CachedCircle(t, lat, h));
+    if (c) {
+      if (diffp)
+        (*c)(lon, Bx, By, Bz, Bxt, Byt, Bzt);
+      else
+        (*c)(lon, Bx, By, Bz);
+      return;
+    }
     real X, Y, Z;
     real M[Geocentric::dim2_];
     _earth.IntForward(lat, lon, h, X, Y, Z, M);
@@ -230,7 +374,323 @@ namespace GeographicLib {
     Geocentric::Unrotate(M, BX, BY, BZ, Bx, By, Bz);
   }
 
-  MagneticCircle MagneticModel::Circle(real t, real lat, real h) const {
+  void MagneticModel::FieldBatch(size_t n, const real t[], const real lat[],
+                                 const real lon[], const real h[],
+                                 real Bx[], real By[], real Bz[],
+                                 real Bxt[], real Byt[], real Bzt[]) const {
+    // Follow Field and FieldGeocentric, hoisting the spherical harmonic sums.
+    // The points are sorted (stably) by the epoch interval so that each sum is
+    // evaluated with ValueBatch over a contiguous range of points.
+    const size_t dim2 = Geocentric::dim2_;
+    vector<int> ind(n);
+    vector<size_t> start(_nNmodels + 1, 0), perm(n);
+    for (size_t i = 0; i < n; ++i) {
+      ind[i] = max(min(int(floor((t[i] - _t0) / _dt0)), _nNmodels - 1), 0);
+      ++start[ind[i] + 1];
+    }
+    for (int k = 0; k < _nNmodels; ++k)
+      start[k + 1] += start[k];
+    {
+      vector<size_t> next(start.begin(), start.end() - 1);
+      for (size_t i = 0; i < n; ++i)
+        perm[next[ind[i]]++] = i;
+    }
+    vector<real> X(n), Y(n), Z(n), M(n * dim2), v(n),
+      B0(3 * n), B1(3 * n), Bc(_nNconstants ? 3 * n : 0);
+    for (size_t j = 0; j < n; ++j) {
+      size_t i = perm[j];
+      _earth.IntForward(lat[i], lon[i], h[i], X[j], Y[j], Z[j], &M[j * dim2]);
+    }
+    for (int k = 0; k < _nNmodels; ++k) {
+      size_t j0 = start[k], m = start[k + 1] - j0;
+      if (m == 0) continue;
+      const SphericalHarmonic *h0, *h1;
+      shared_ptr<const epochpair> e = Epochs(k, h0, h1);
+      h0->ValueBatch(m, &X[j0], &Y[j0], &Z[j0], &v[j0],
+                     &B0[j0], &B0[n + j0], &B0[2 * n + j0]);
+      h1->ValueBatch(m, &X[j0], &Y[j0], &Z[j0], &v[j0],
+                     &B1[j0], &B1[n + j0], &B1[2 * n + j0]);
+    }
+    if (_nNconstants && n)
+      _harm[_nNmodels + 1].ValueBatch(n, X.data(), Y.data(), Z.data(),
+                                      v.data(),
+                                      &Bc[0], &Bc[n], &Bc[2 * n]);
+    for (size_t j = 0; j < n; ++j) {
+      size_t i = perm[j];
+      int k = ind[i];
+      bool interpolate = k + 1 < _nNmodels;
+      real
+        tk = t[i] - _t0 - k * _dt0,
+        BX = B0[j], BY = B0[n + j], BZ = B0[2 * n + j],
+        BXt = B1[j], BYt = B1[n + j], BZt = B1[2 * n + j];
+      if (interpolate) {
+        // Convert to a time derivative
+        BXt = (BXt - BX) / _dt0;
+        BYt = (BYt - BY) / _dt0;
+        BZt = (BZt - BZ) / _dt0;
+      }
+      BX += tk * BXt + (_nNconstants ? Bc[j] : 0);
+      BY += tk * BYt + (_nNconstants ? Bc[n + j] : 0);
+      BZ += tk * BZt + (_nNconstants ? Bc[2 * n + j] : 0);
+      BXt = BXt * - _a; BYt = BYt * - _a; BZt = BZt * - _a;
+      BX *= - _a; BY *= - _a; BZ *= - _a;
+      real x, y, z;
+      if (Bxt || Byt || Bzt) {
+        Geocentric::Unrotate(&M[j * dim2], BXt, BYt, BZt, x, y, z);
+        if (Bxt) Bxt[i] = x;
+        if (Byt) Byt[i] = y;
+        if (Bzt) Bzt[i] = z;
+      }
+      Geocentric::Unrotate(&M[j * dim2], BX, BY, BZ, Bx[i], By[i], Bz[i]);
+    }
+  }
+
+  void MagneticModel::CacheCircles(real dlat, real dh, real dt,
+                                   unsigned long long maxbytes) const {
+    if (!(dlat > 0 && dh > 0 && dt > 0))
+      throw GeographicErr("Latitude, height, and time quanta "
+                          "must be positive");
+    _circledlat = dlat;
+    _circledh = dh;
+    _circledt = dt;
+    _circles.Reset(size_t(max(1ULL, maxbytes / CircleBytes())));
+  }
+
+  unsigned long long MagneticModel::CircleBytes() const {
+    // The circle holds up to 3 CircularEngines each with 6 arrays of size
+    // Mmax + 1
+    return sizeof(MagneticCircle) + 18ULL * sizeof(real) * (max(_mmx, 0) + 1);
+  }
+
+  void MagneticModel::CircleCacheClear() const {
+    _circles.Reset(0);
+  }
+
+  void MagneticModel::SetTruncationTolerance(real tol) const {
+    if (!(tol >= 0))
+      throw GeographicErr("Truncation tolerance must be nonnegative");
+    if (tol > 0 && _truncbound.empty())
+      for (int k = 0; k < int(_harm.size()); ++k) {
+        const SphericalHarmonic* h = &_harm[k];
+        shared_ptr<const epochpair> e;
+        if (Compressed() && k > 0 && k < _nNmodels) {
+          const SphericalHarmonic* h0;
+          e = Epochs(k - 1, h0, h);
+        }
+        _truncbound.push_back
+          (SphericalEngine::GradientBounds
+           (h->Coefficients(), SphericalEngine::normalization(_norm)));
+      }
+    _trunctol = tol;
+  }
+
+  void MagneticModel::Compress(real quantum, size_t maxpairs) {
+    if (!(quantum > 0 && isfinite(quantum)))
+      throw GeographicErr("Quantum must be positive");
+    if (Compressed())
+      throw GeographicErr("The model is already compressed");
+    if (_nNmodels < 2)
+      return;
+    shared_ptr<coeffstore> s = make_shared<coeffstore>();
+    s->quantum = quantum;
+    for (int k = 0; k < _nNmodels; ++k) {
+      const SphericalEngine::coeff& c = _harm[k].Coefficients();
+      s->nmx.push_back(c.nmx());
+      s->mmx.push_back(c.mmx());
+      s->nN = max(s->nN, c.nmx());
+      s->mM = max(s->mM, c.mmx());
+    }
+    int N = s->nN, M = s->mM,
+      nc = SphericalEngine::coeff::Csize(N, M),
+      ns = SphericalEngine::coeff::Ssize(N, M);
+    // The quantized coefficients for each epoch are placed in a common
+    // layout, the C coefficients followed by the S coefficients.  The
+    // differences between successive epochs are encoded as variable length
+    // integers, 7 bits per byte with the high bit set on all but the last
+    // byte; the sign is held in the low bit ("zigzag" encoding).
+    const real maxq = ldexp(real(1), min(Math::digits(), 61));
+    vector<long long> q(nc + ns), q0(nc + ns);
+    for (int k = 0; k < _nNmodels; ++k) {
+      const SphericalEngine::coeff& c = _harm[k].Coefficients();
+      fill(q.begin(), q.end(), 0);
+      for (int m = 0; m <= c.mmx(); ++m)
+        for (int n = m; n <= c.nmx(); ++n) {
+          int l = m * N - m * (m - 1) / 2 + n, l0 = c.index(n, m);
+          real
+            x = round(c.Cv(l0) / quantum),
+            y = m ? round(c.Sv(l0) / quantum) : 0;
+          if (!(fabs(x) < maxq && fabs(y) < maxq))
+            throw GeographicErr("Quantum too small for the coefficients");
+          q[l] = (long long)(x);
+          if (m) q[nc + l - (N + 1)] = (long long)(y);
+        }
+      if (k > 0)
+        for (int i = 0; i < nc + ns; ++i) {
+          long long d = q[i] - q0[i];
+          unsigned long long z = d < 0 ?
+            2 * (unsigned long long)(-(d + 1)) + 1 :
+            2 * (unsigned long long)(d);
+          for (; z >= 0x80U; z >>= 7)
+            s->deltas.push_back((unsigned char)((z & 0x7fU) | 0x80U));
+          s->deltas.push_back((unsigned char)(z));
+        }
+      q.swap(q0);
+    }
+    s->deltas.shrink_to_fit();
+    // Copy the coefficients for the first epoch, the rate of change, and the
+    // constant terms.
+    s->gG.resize(_harm.size());
+    s->hH.resize(_harm.size());
+    for (int k = 0; k < int(_harm.size()); ++k) {
+      if (k > 0 && k < _nNmodels) {
+        _harm[k] = SphericalHarmonic();
+        continue;
+      }
+      const SphericalEngine::coeff& c = _harm[k].Coefficients();
+      int nmx = c.nmx(), mmx = c.mmx();
+      vector<real>& C = s->gG[k];
+      vector<real>& S = s->hH[k];
+      C.resize(SphericalEngine::coeff::Csize(nmx, mmx));
+      S.resize(SphericalEngine::coeff::Ssize(nmx, mmx));
+      for (int m = 0; m <= mmx; ++m)
+        for (int n = m; n <= nmx; ++n) {
+          int l = m * nmx - m * (m - 1) / 2 + n, l0 = c.index(n, m);
+          C[l] = c.Cv(l0);
+          if (m) S[l - (nmx + 1)] = c.Sv(l0);
+        }
+      _harm[k] = SphericalHarmonic(C, S, nmx, nmx, mmx, _a, _norm);
+    }
+    _coeffs = s;
+    _epochs.Reset(maxpairs);
+    _circles.Reset(_circles.Capacity());
+    _truncbound.clear();
+    if (_trunctol > 0)
+      SetTruncationTolerance(_trunctol);
+  }
+
+  MagneticModel::epochpair MagneticModel::DecodeEpochs(int n) const {
+    // Follow Compress: start with the quantized coefficients for the first
+    // epoch and add the differences up to epoch n + 1.
+    const coeffstore& s = *_coeffs;
+    int N = s.nN, M = s.mM,
+      nc = SphericalEngine::coeff::Csize(N, M),
+      ns = SphericalEngine::coeff::Ssize(N, M);
+    vector<long long> q(nc + ns, 0);
+    {
+      const SphericalEngine::coeff& c = _harm[0].Coefficients();
+      for (int m = 0; m <= c.mmx(); ++m)
+        for (int k = m; k <= c.nmx(); ++k) {
+          int l = m * N - m * (m - 1) / 2 + k, l0 = c.index(k, m);
+          q[l] = (long long)(round(c.Cv(l0) / s.quantum));
+          if (m)
+            q[nc + l - (N + 1)] = (long long)(round(c.Sv(l0) / s.quantum));
+        }
+    }
+    epochpair e;
+    const unsigned char* p = s.deltas.data();
+    for (int j = 1; j <= n + 1 && j < _nNmodels; ++j) {
+      for (int i = 0; i < nc + ns; ++i) {
+        unsigned long long z = 0;
+        for (int b = 0; ; b += 7) {
+          z |= (unsigned long long)(*p & 0x7fU) << b;
+          if (!(*p++ & 0x80U)) break;
+        }
+        q[i] += z & 1U ? -(long long)(z >> 1) - 1 : (long long)(z >> 1);
+      }
+      if (j < n) continue;
+      int i = j - n;
+      e.C[i].resize(nc);
+      e.S[i].resize(ns);
+      for (int l = 0; l < nc; ++l)
+        e.C[i][l] = s.quantum * real(q[l]);
+      for (int l = 0; l < ns; ++l)
+        e.S[i][l] = s.quantum * real(q[nc + l]);
+      e.harm[i] = SphericalHarmonic(e.C[i], e.S[i], N, s.nmx[j], s.mmx[j],
+                                    _a, _norm);
+    }
+    return e;
+  }
+
+  shared_ptr<const MagneticModel::epochpair>
+  MagneticModel::Epochs(int n, const SphericalHarmonic*& h0,
+                        const SphericalHarmonic*& h1) const {
+    h0 = &_harm[n];
+    h1 = &_harm[n + 1];
+    if (!Compressed())
+      return nullptr;
+    // The cache of circles is reused with the epoch as the key.
+    CircleCache<epochpair>::key k = {n, 0, 0};
+    shared_ptr<const epochpair> e =
+      _epochs.Get(k, [this, n]() -> epochpair { return DecodeEpochs(n); });
+    if (n > 0) h0 = &e->harm[0];
+    if (n + 1 < _nNmodels) h1 = &e->harm[1];
+    return e;
+  }
+
+  size_t MagneticModel::MemoryUsage() const {
+    size_t bytes = sizeof(*this) + CoefficientBytes() +
+      _harm.capacity() * sizeof(SphericalHarmonic) +
+      size_t(_circles.Size() * CircleBytes());
+    for (const vector<real>& b : _truncbound)
+      bytes += b.capacity() * sizeof(real);
+    if (Compressed()) {
+      // Each pair of decoded epochs holds 2 sets of coefficients in the
+      // common layout
+      size_t nc = SphericalEngine::coeff::Csize(_coeffs->nN, _coeffs->mM),
+        ns = SphericalEngine::coeff::Ssize(_coeffs->nN, _coeffs->mM);
+      bytes += (_coeffs->nmx.capacity() + _coeffs->mmx.capacity()) *
+        sizeof(int) + _epochs.Size() *
+        (sizeof(epochpair) + 2 * (nc + ns) * sizeof(real));
+    }
+    return bytes;
+  }
+
+  unsigned long long MagneticModel::CostEstimate() const {
+    // The sums with their gradients and the conversions to and from
+    // geocentric coordinates (about 100 operations)
+    return SphericalEngine::CostEstimate(_nmx, _mmx, 1, 1,
+                                         _nNconstants ? 3 : 2) + 100;
+  }
+
+  size_t MagneticModel::CoefficientBytes() const {
+    size_t bytes = _coeffs->deltas.size();
+    for (size_t k = 0; k < _coeffs->gG.size(); ++k)
+      bytes += (_coeffs->gG[k].size() + _coeffs->hH[k].size()) * sizeof(real);
+    return bytes;
+  }
+
+  shared_ptr<const MagneticCircle>
+  MagneticModel::CachedCircle(real t, real lat, real h) const {
+    if (_circles.Capacity() == 0)
+      return nullptr;
+    real
+      it = round(t / _circledt),
+      ilat = round(lat / _circledlat),
+      ih = round(h / _circledh),
+      // Beyond this the quantized values can't be represented as keys
+      maxkey = real(1ULL << 62);
+    if (!(fabs(it) < maxkey && fabs(ilat) < maxkey && fabs(ih) < maxkey))
+      return nullptr;           // Caught NaNs here too
+    CircleCache<MagneticCircle>::key k = {(long long)(ilat), (long long)(ih),
+                                          (long long)(it)};
+    return _circles.Get(k, [this, it, ilat, ih]() -> MagneticCircle {
+      // Rounding may put the latitude just beyond a pole
+      return Circle(it * _circledt,
+                    fmax(-real(Math::qd),
+                         fmin(real(Math::qd), ilat * _circledlat)),
+                    ih * _circledh);
+    });
+  }
+
+  MagneticCircle MagneticModel::Circle(real t, real lat, real h,
+                                       unsigned nthreads) const {
+    MagneticCircle circ;
+    Circle(t, lat, h, circ, nthreads);
+    return circ;
+  }
+
+  void MagneticModel::Circle(real t, real lat, real h,
+                             MagneticCircle& circ, unsigned nthreads) const {
     real t1 = t - _t0;
     int n = max(min(int(floor(t1 / _dt0)), _nNmodels - 1), 0);
     bool interpolate = n + 1 < _nNmodels;
@@ -239,16 +699,73 @@ namespace GeographicLib {
     _earth.IntForward(lat, 0, h, X, Y, Z, M);
     // Y = 0, cphi = M[7], sphi = M[8];
 
-    return (_nNconstants == 0 ?
-            MagneticCircle(_a, _earth._f, lat, h, t,
-                           M[7], M[8], t1, _dt0, interpolate,
-                           _harm[n].Circle(X, Z, true),
-                           _harm[n + 1].Circle(X, Z, true)) :
-            MagneticCircle(_a, _earth._f, lat, h, t,
-                           M[7], M[8], t1, _dt0, interpolate,
-                           _harm[n].Circle(X, Z, true),
-                           _harm[n + 1].Circle(X, Z, true),
-                           _harm[_nNmodels + 1].Circle(X, Z, true)));
+    // The CircularEngine objects for the two epochs (and the constant
+    // terms) are independent and may be set up concurrently.
+    CircularEngine* engines[] = {&circ._circ0, &circ._circ1, &circ._circ2};
+    const SphericalHarmonic *h0, *h1;
+    shared_ptr<const epochpair> e = Epochs(n, h0, h1);
+    const SphericalHarmonic* harms[] =
+      {h0, h1, _nNconstants != 0 ? &_harm[_nNmodels + 1] : nullptr};
+    GeodesicBatchExecutor(nthreads, 1).
+      ForEach(_nNconstants != 0 ? 3 : 2, [&](size_t i0, size_t i1) -> void {
+        for (size_t i = i0; i < i1; ++i)
+          harms[i]->Circle(X, Z, true, *engines[i]);
+      });
+    circ.Reset(_a, _earth._f, lat, h, t, M[7], M[8], t1, _dt0,
+               interpolate, _nNconstants != 0);
+  }
+
+  MagneticSnapshot MagneticModel::AtTime(real t, int Nmax, int Mmax) const {
+    if (Nmax >= 0 && Mmax < 0) Mmax = Nmax;
+    if (Nmax < 0) Nmax = numeric_limits<int>::max();
+    if (Mmax < 0) Mmax = numeric_limits<int>::max();
+    if (Mmax > Nmax)
+      throw GeographicErr("Bad requested degree and order " +
+                          Utility::str(Nmax) + " " + Utility::str(Mmax));
+    real t1 = t - _t0;
+    int k = max(min(int(floor(t1 / _dt0)), _nNmodels - 1), 0);
+    bool interpolate = k + 1 < _nNmodels;
+    t1 -= k * _dt0;
+    // The field is w0 * G[k] + w1 * G[k+1] + Gc and its rate of change is
+    // r0 * G[k] + r1 * G[k+1]; this follows FieldGeocentric.
+    real
+      r0 = interpolate ? -1 / _dt0 : 0,
+      r1 = interpolate ?  1 / _dt0 : 1,
+      w0 = 1 + t1 * r0,
+      w1 = t1 * r1;
+    int K = _nNconstants ? 3 : 2;
+    const SphericalHarmonic *h0, *h1;
+    shared_ptr<const epochpair> e = Epochs(k, h0, h1);
+    const SphericalEngine::coeff* c[] =
+      {&h0->Coefficients(), &h1->Coefficients(),
+       _nNconstants ? &_harm[_nNmodels + 1].Coefficients() : nullptr};
+    real w[][3] = {{w0, w1, 1}, {r0, r1, 0}};
+    int N = -1, M = -1;
+    for (int j = 0; j < K; ++j) {
+      N = max(N, min(c[j]->nmx(), Nmax));
+      M = max(M, min(c[j]->mmx(), Mmax));
+    }
+    M = min(M, N);
+    int nc = SphericalEngine::coeff::Csize(N, M),
+      ns = SphericalEngine::coeff::Ssize(N, M);
+    shared_ptr<vector<real> > coeffs =
+      make_shared<vector<real> >(2 * (nc + ns), real(0));
+    for (int i = 0; i < 2; ++i) {
+      real* C = coeffs->data() + i * (nc + ns);
+      real* S = C + nc;
+      for (int j = 0; j < K; ++j) {
+        if (w[i][j] == 0) continue;
+        int mmx = min(c[j]->mmx(), M), nmx = min(c[j]->nmx(), N);
+        for (int m = 0; m <= mmx; ++m)
+          for (int n = m; n <= nmx; ++n) {
+            // The index of (n, m) in C and S for the snapshot
+            int l = m * N - m * (m - 1) / 2 + n, l0 = c[j]->index(n, m);
+            C[l] += w[i][j] * c[j]->Cv(l0);
+            if (m) S[l - (N + 1)] += w[i][j] * c[j]->Sv(l0);
+          }
+      }
+    }
+    return MagneticSnapshot(_a, t, _earth, _norm, N, M, coeffs);
   }
 
   void MagneticModel::FieldComponents(real Bx, real By, real Bz,
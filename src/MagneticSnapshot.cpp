@@ -0,0 +1,68 @@
+/**
+ * \file MagneticSnapshot.cpp
+ * \brief Implementation for GeographicLib::MagneticSnapshot class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#include <GeographicLib/MagneticSnapshot.hpp>
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  MagneticSnapshot::MagneticSnapshot(real a, real t, const Geocentric& earth,
+                                     SphericalHarmonic::normalization norm,
+                                     int N, int M,
+                                     const shared_ptr<const vector<real> >&
+                                     coeffs)
+    : _a(a)
+    , _t(t)
+    , _earth(earth)
+    , _coeffs(coeffs)
+  {
+    // The storage holds C and S for the field followed by C and S for its
+    // rate of change.
+    int nc = SphericalEngine::coeff::Csize(N, M),
+      ns = SphericalEngine::coeff::Ssize(N, M);
+    const real* p = _coeffs->data();
+    _harm[0] = SphericalHarmonic(SphericalEngine::coeff(p, p + nc, N, N, M),
+                                 _a, norm);
+    p += nc + ns;
+    _harm[1] = SphericalHarmonic(SphericalEngine::coeff(p, p + nc, N, N, M),
+                                 _a, norm);
+  }
+
+  void MagneticSnapshot::FieldGeocentric(real X, real Y, real Z,
+                                         real& BX, real& BY, real& BZ,
+                                         real& BXt, real& BYt, real& BZt)
+    const {
+    const SphericalHarmonic* harms[] = {&_harm[0], &_harm[1]};
+    real v[2], gX[2], gY[2], gZ[2];
+    SphericalHarmonic::GradientMulti<2>(harms, X, Y, Z, v, gX, gY, gZ);
+    BX  = - _a * gX[0]; BY  = - _a * gY[0]; BZ  = - _a * gZ[0];
+    BXt = - _a * gX[1]; BYt = - _a * gY[1]; BZt = - _a * gZ[1];
+  }
+
+  void MagneticSnapshot::Field(real lat, real lon, real h, bool diffp,
+                               real& Bx, real& By, real& Bz,
+                               real& Bxt, real& Byt, real& Bzt) const {
+    real X, Y, Z;
+    real M[Geocentric::dim2_];
+    _earth.IntForward(lat, lon, h, X, Y, Z, M);
+    real BX, BY, BZ;
+    if (diffp) {
+      real BXt, BYt, BZt;
+      FieldGeocentric(X, Y, Z, BX, BY, BZ, BXt, BYt, BZt);
+      Geocentric::Unrotate(M, BXt, BYt, BZt, Bxt, Byt, Bzt);
+    } else {
+      // Only the sum for the field is needed
+      _harm[0](X, Y, Z, BX, BY, BZ);
+      BX *= - _a; BY *= - _a; BZ *= - _a;
+    }
+    Geocentric::Unrotate(M, BX, BY, BZ, Bx, By, Bz);
+  }
+
+} // namespace GeographicLib
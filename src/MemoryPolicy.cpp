@@ -0,0 +1,217 @@
+/**
+ * \file MemoryPolicy.cpp
+ * \brief Implementation for GeographicLib::MemoryPolicy class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#include <GeographicLib/MemoryPolicy.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <new>
+#include <sstream>
+#include <string>
+
+// Huge pages and NUMA placement are only supported on Linux.  The NUMA
+// system calls are made directly so that libnuma isn't needed.
+#if defined(__linux__)
+#  include <pthread.h>
+#  include <sched.h>
+#  include <sys/mman.h>
+#  include <sys/syscall.h>
+#  include <unistd.h>
+#  define GEOGRAPHICLIB_MEMORY_LINUX 1
+#else
+#  define GEOGRAPHICLIB_MEMORY_LINUX 0
+#endif
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  namespace {
+    // Blocks of at least this size are mapped separately; this is also the
+    // size of a huge page on x86-64 (and the granularity of the mappings).
+    const size_t largesize_ = size_t(1) << 21;
+    atomic<int> pages_(MemoryPolicy::SMALLPAGES);
+    atomic<int> node_(-1);
+    atomic<bool> replicate_(false);
+
+    // The NUMA topology, read from /sys on first use
+    struct topology {
+      int nodes;
+      vector<int> cpunode;          // The node of each CPU
+      vector< vector<int> > nodecpus; // The CPUs of each node
+      // Parse a list such as "0-3,8-11"
+      static vector<int> parselist(const string& s) {
+        vector<int> v;
+        istringstream str(s);
+        string range;
+        while (getline(str, range, ',')) {
+          int a, b;
+          char dash;
+          istringstream r(range);
+          if (!(r >> a)) continue;
+          b = a;
+          if (r >> dash && dash == '-' && !(r >> b)) b = a;
+          for (int i = a; i <= b; ++i) v.push_back(i);
+        }
+        return v;
+      }
+      static string readline(const string& file) {
+        ifstream f(file.c_str());
+        string s;
+        getline(f, s);
+        return s;
+      }
+      topology() : nodes(1) {
+#if GEOGRAPHICLIB_MEMORY_LINUX
+        const string dir = "/sys/devices/system/node/";
+        vector<int> online = parselist(readline(dir + "online"));
+        for (int node : online) {
+          nodes = max(nodes, node + 1);
+          if (node >= int(nodecpus.size())) nodecpus.resize(node + 1);
+          nodecpus[node] =
+            parselist(readline(dir + "node" + to_string(node) + "/cpulist"));
+          for (int cpu : nodecpus[node]) {
+            if (cpu >= int(cpunode.size())) cpunode.resize(cpu + 1, 0);
+            cpunode[cpu] = node;
+          }
+        }
+#endif
+      }
+    };
+    const topology& topo() {
+      static const topology t;
+      return t;
+    }
+  }
+
+  void MemoryPolicy::SetPages(pages p)
+  { pages_.store(p, memory_order_relaxed); }
+
+  MemoryPolicy::pages MemoryPolicy::Pages()
+  { return pages(pages_.load(memory_order_relaxed)); }
+
+  void MemoryPolicy::SetNode(int node)
+  { node_.store(node < 0 ? -1 : node, memory_order_relaxed); }
+
+  int MemoryPolicy::Node()
+  { return node_.load(memory_order_relaxed); }
+
+  void MemoryPolicy::SetReplicate(bool replicate)
+  { replicate_.store(replicate, memory_order_relaxed); }
+
+  bool MemoryPolicy::Replicate()
+  { return replicate_.load(memory_order_relaxed); }
+
+  int MemoryPolicy::Nodes() { return topo().nodes; }
+
+  int MemoryPolicy::CurrentNode() {
+#if GEOGRAPHICLIB_MEMORY_LINUX
+    const topology& t = topo();
+    if (t.nodes > 1) {
+      int cpu = sched_getcpu();
+      if (cpu >= 0 && cpu < int(t.cpunode.size()))
+        return t.cpunode[cpu];
+    }
+#endif
+    return 0;
+  }
+
+  bool MemoryPolicy::RunOnNode(int node) {
+#if GEOGRAPHICLIB_MEMORY_LINUX
+    const topology& t = topo();
+    if (!(node >= 0 && node < int(t.nodecpus.size()) &&
+          !t.nodecpus[node].empty()))
+      return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : t.nodecpus[node])
+      if (cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    return node == 0;
+#endif
+  }
+
+  void* MemoryPolicy::Allocate(size_t n, int node) {
+#if GEOGRAPHICLIB_MEMORY_LINUX
+    if (n >= largesize_) {
+      size_t len = (n + largesize_ - 1) / largesize_ * largesize_;
+      int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+      void* p = MAP_FAILED;
+      pages pg = Pages();
+#  if defined(MAP_HUGETLB)
+      if (pg == HUGETLB)
+        p = mmap(nullptr, len, PROT_READ | PROT_WRITE, flags | MAP_HUGETLB,
+                 -1, 0);
+#  endif
+      if (p == MAP_FAILED) {
+        // Over-allocate and trim so that the block is aligned for huge pages
+        char* q = static_cast<char*>
+          (mmap(nullptr, len + largesize_, PROT_READ | PROT_WRITE, flags,
+                -1, 0));
+        if (q == MAP_FAILED)
+          throw bad_alloc();
+        size_t lead = (largesize_ - reinterpret_cast<uintptr_t>(q) %
+                       largesize_) % largesize_;
+        if (lead) munmap(q, lead);
+        if (lead < largesize_) munmap(q + lead + len, largesize_ - lead);
+        p = q + lead;
+        if (pg != SMALLPAGES)
+          Advise(p, len);
+      }
+      if (node < 0) node = Node();
+#  if defined(SYS_mbind)
+      if (node >= 0 && node < Nodes()) {
+        // Prefer the node (falling back to others if it's full); this must
+        // be done before the pages are first touched.
+        const int MPOL_PREFERRED_ = 1;
+        const size_t bits = 8 * sizeof(unsigned long);
+        vector<unsigned long> mask(node / bits + 1, 0UL);
+        mask[node / bits] = 1UL << (node % bits);
+        // The kernel reads maxnode - 1 bits
+        syscall(SYS_mbind, p, len, MPOL_PREFERRED_, mask.data(),
+                (unsigned long)(mask.size() * bits + 1), 0U);
+      }
+#  endif
+      return p;
+    }
+#else
+    (void)node;
+#endif
+    return ::operator new(n);
+  }
+
+  void MemoryPolicy::Deallocate(void* p, size_t n) noexcept {
+#if GEOGRAPHICLIB_MEMORY_LINUX
+    if (n >= largesize_) {
+      munmap(p, (n + largesize_ - 1) / largesize_ * largesize_);
+      return;
+    }
+#else
+    (void)n;
+#endif
+    ::operator delete(p);
+  }
+
+  void MemoryPolicy::Advise(void* p, size_t n) {
+#if GEOGRAPHICLIB_MEMORY_LINUX && defined(MADV_HUGEPAGE)
+    if (Pages() == SMALLPAGES || n < largesize_) return;
+    // madvise needs a page aligned range
+    uintptr_t page = uintptr_t(sysconf(_SC_PAGESIZE)),
+      a = (reinterpret_cast<uintptr_t>(p) + page - 1) / page * page,
+      b = (reinterpret_cast<uintptr_t>(p) + n) / page * page;
+    if (b > a)
+      madvise(reinterpret_cast<void*>(a), size_t(b - a), MADV_HUGEPAGE);
+#else
+    (void)p; (void)n;
+#endif
+  }
+
+} // namespace GeographicLib
@@ -56,6 +56,8 @@ namespace GeographicLib {
     // f* = (gammap - gammae) / gammae
     _fstar = (-_f * _gGM / (_a * _b) + _omega2 * (P * (_a + 2 * _b) + _a)) /
       _gammae;
+    // m = omega^2 * a^2 * b / GM, H+M, Eq 2-70
+    _m = _aomega2 * _b / _gGM;
   }
 
   NormalGravity::NormalGravity(real a, real GM, real omega, real f_J2,
@@ -247,6 +249,47 @@ namespace GeographicLib {
     return Ures;
   }
 
+  Math::real NormalGravity::GravityNearSurface(real lat, real h,
+                                               real& gammay, real& gammaz)
+    const {
+    real sphi, cphi;
+    Math::sincosd(Math::LatFix(lat), sphi, cphi);
+    real
+      s2 = Math::sq(sphi),
+      w2 = 1 - _e2 * s2,
+      w = sqrt(w2),
+      // H+M, Eq 2-78
+      gamma0 = (_gammae + _k * s2) / w,
+      // H+M, Eq 2-124: gamma = gamma0 * (1 - c1 * h + c2 * h^2)
+      c1 = 2 * (1 + _f + _m - 2 * _f * s2) / _a,
+      c2 = 3 / Math::sq(_a);
+    // Because the field is irrotational, d(gammay)/dh = d(gammaz)/dy =
+    // - d(gamma0)/dphi / rho where rho = a*(1-e2)/w^3 is the meridional radius
+    // of curvature.
+    gammay = - h * sphi * cphi * (2 * _k * w2 + gamma0 * _e2 * w) /
+      (_a * (1 - _e2));
+    gammaz = - gamma0 * (1 - (c1 - c2 * h) * h);
+    // U = U0 + integral(gammaz, h)
+    return _uU0 - gamma0 * h * (1 - (c1 / 2 - c2 * h / 3) * h);
+  }
+
+  void NormalGravity::GravityBatch(size_t n, const real lat[], const real h[],
+                                   real U[], real gammay[], real gammaz[],
+                                   bool nearsurface) const {
+    for (size_t i = 0; i < n; ++i)
+      U[i] = nearsurface && fabs(h[i]) <= nearsurfacemax_ ?
+        GravityNearSurface(lat[i], h[i], gammay[i], gammaz[i]) :
+        Gravity(lat[i], h[i], gammay[i], gammaz[i]);
+  }
+
+  void NormalGravity::UBatch(size_t n,
+                             const real X[], const real Y[], const real Z[],
+                             real U[], real gammaX[], real gammaY[],
+                             real gammaZ[]) const {
+    for (size_t i = 0; i < n; ++i)
+      U[i] = this->U(X[i], Y[i], Z[i], gammaX[i], gammaY[i], gammaZ[i]);
+  }
+
   Math::real NormalGravity::J2ToFlattening(real a, real GM,
                                            real omega, real J2) {
     // Solve
@@ -9,6 +9,7 @@
 
 #include <GeographicLib/OSGB.hpp>
 #include <GeographicLib/Utility.hpp>
+#include <cstring>
 
 #if defined(_MSC_VER)
 // Squelch warnings about enum-float expressions
@@ -36,7 +37,34 @@ namespace GeographicLib {
     return northoffset;
   }
 
+  void OSGB::ForwardBatch(size_t n, const real lat[], const real lon[],
+                          real x[], real y[], real gamma[], real k[]) {
+    const real x0 = FalseEasting(), y0 = computenorthoffset();
+    OSGBTM().ForwardBatch(n, OriginLongitude(), lat, lon, x, y, gamma, k);
+    for (size_t i = 0; i < n; ++i) {
+      x[i] += x0;
+      y[i] += y0;
+    }
+  }
+
+  void OSGB::ReverseBatch(size_t n, const real x[], const real y[],
+                          real lat[], real lon[], real gamma[], real k[]) {
+    // Remove the false origin in lat and lon and project in place.
+    const real x0 = FalseEasting(), y0 = computenorthoffset();
+    for (size_t i = 0; i < n; ++i) {
+      lat[i] = x[i] - x0;
+      lon[i] = y[i] - y0;
+    }
+    OSGBTM().ReverseBatch(n, OriginLongitude(), lat, lon, lat, lon, gamma, k);
+  }
+
   void OSGB::GridReference(real x, real y, int prec, std::string& gridref) {
+    char grid[MAXLENGTH + 1];
+    int len = GridReference(x, y, prec, grid);
+    gridref.assign(grid, len);
+  }
+
+  int OSGB::GridReference(real x, real y, int prec, char grid[]) {
     using std::isnan;           // Needed for Centos 7, ubuntu 14
     CheckCoords(x, y);
     if (!(prec >= 0 && prec <= maxprec_))
@@ -44,10 +72,10 @@ namespace GeographicLib {
                           + " not in [0, "
                           + Utility::str(int(maxprec_)) + "]");
     if (isnan(x) || isnan(y)) {
-      gridref = "INVALID";
-      return;
+      static const char invalid[] = "INVALID";
+      copy(invalid, invalid + sizeof(invalid), grid);
+      return int(sizeof(invalid)) - 1;
     }
-    char grid[2 + 2 * maxprec_];
     int
       xh = int(floor(x / tile_)),
       yh = int(floor(y / tile_));
@@ -86,15 +114,26 @@ namespace GeographicLib {
       }
     }
     int mlen = z + 2 * prec;
-    gridref.resize(mlen);
-    copy(grid, grid + mlen, gridref.begin());
+    grid[mlen] = '\0';
+    return mlen;
+  }
+
+  void OSGB::GridReferenceBatch(size_t n, const real x[], const real y[],
+                                int prec, char gridref[]) {
+    for (size_t i = 0; i < n; ++i)
+      GridReference(x[i], y[i], prec, gridref + i * (MAXLENGTH + 1));
   }
 
-  void OSGB::GridReference(const std::string& gridref,
+  void OSGB::GridReference(const char* gridref, size_t len0,
                            real& x, real& y, int& prec,
                            bool centerp) {
+    // The string for the error messages (allocated only if an error is
+    // thrown)
+    auto str = [gridref, len0]() -> string { return string(gridref, len0); };
+    if (len0 > size_t(numeric_limits<int>::max()))
+      throw GeographicErr("OSGB string too long");
     int
-      len = int(gridref.size()),
+      len = int(len0),
       p = 0;
     if (len >= 2 &&
         toupper(gridref[0]) == 'I' &&
@@ -107,16 +146,16 @@ namespace GeographicLib {
     for (int i = 0; i < len; ++i) {
       if (!isspace(gridref[i])) {
         if (p >= 2 + 2 * maxprec_)
-          throw GeographicErr("OSGB string " + gridref + " too long");
+          throw GeographicErr("OSGB string " + str() + " too long");
         grid[p++] = gridref[i];
       }
     }
     len = p;
     p = 0;
     if (len < 2)
-      throw GeographicErr("OSGB string " + gridref + " too short");
+      throw GeographicErr("OSGB string " + str() + " too short");
     if (len % 2)
-      throw GeographicErr("OSGB string " + gridref +
+      throw GeographicErr("OSGB string " + str() +
                           " has odd number of characters");
     int
       xh = 0,
@@ -124,7 +163,7 @@ namespace GeographicLib {
     while (p < 2) {
       int i = Utility::lookup(letters_, grid[p++]);
       if (i < 0)
-        throw GeographicErr("Illegal prefix character " + gridref);
+        throw GeographicErr("Illegal prefix character " + str());
       yh = yh * tilegrid_ + tilegrid_ - (i / tilegrid_) - 1;
       xh = xh * tilegrid_ + (i % tilegrid_);
     }
@@ -142,7 +181,7 @@ namespace GeographicLib {
         ix = Utility::lookup(digits_, grid[p + i]),
         iy = Utility::lookup(digits_, grid[p + i + prec1]);
       if (ix < 0 || iy < 0)
-        throw GeographicErr("Encountered a non-digit in " + gridref);
+        throw GeographicErr("Encountered a non-digit in " + str());
       x1 += unit * ix;
       y1 += unit * iy;
     }
@@ -155,6 +194,19 @@ namespace GeographicLib {
     prec = prec1;
   }
 
+  void OSGB::GridReferenceBatch(size_t n, const char gridref[],
+                                real x[], real y[], int prec[],
+                                bool centerp) {
+    for (size_t i = 0; i < n; ++i) {
+      const char* s = gridref + i * (MAXLENGTH + 1);
+      const void* e = memchr(s, '\0', MAXLENGTH + 1);
+      int precx;
+      GridReference(s, e ? size_t(static_cast<const char*>(e) - s) :
+                    MAXLENGTH + 1, x[i], y[i], precx, centerp);
+      if (prec) prec[i] = precx;
+    }
+  }
+
   void OSGB::CheckCoords(real x, real y) {
     // Limits are all multiples of 100km and are all closed on the lower end
     // and open on the upper end -- and this is reflected in the error
@@ -0,0 +1,164 @@
+/**
+ * \file PointInPolygon.cpp
+ * \brief Implementation for GeographicLib::PointInPolygon class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#include <GeographicLib/PointInPolygon.hpp>
+#include <GeographicLib/GeodesicLine.hpp>
+#include <GeographicLib/GeodesicBatchExecutor.hpp>
+#include <algorithm>
+#include <utility>
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  PointInPolygon::PointInPolygon(const Geodesic& geod, size_t n,
+                                 const real lat[], const real lon[],
+                                 unsigned nthreads)
+    : _geod(geod)
+    , _northpole(false)
+  {
+    if (n < 3) return;
+    GeodesicBatchExecutor exec(nthreads);
+    _edges.resize(n);
+    exec.ForEach(n, [&](size_t i0, size_t i1) -> void {
+      for (size_t i = i0; i < i1; ++i) {
+        size_t j = i + 1 < n ? i + 1 : 0;
+        GeodesicLine line =
+          _geod.InverseLine(lat[i], lon[i], lat[j], lon[j],
+                            Geodesic::LATITUDE | Geodesic::LONGITUDE |
+                            Geodesic::AZIMUTH);
+        Edge& e = _edges[i];
+        real lonmin, lonmax;
+        line.GenBoundingBox(true, 0, line.Arc(),
+                            e.latmin, e.latmax, lonmin, lonmax);
+        e.lat1 = lat[i]; e.lon1 = Math::AngNormalize(lon[i]);
+        e.dlon = Math::AngDiff(lon[i], lon[j]);
+        e.azi1 = line.Azimuth();
+      }
+    });
+    // The number of times the polygon winds eastwards around the pole
+    real circ = 0;
+    for (size_t i = 0; i < n; ++i) circ += _edges[i].dlon;
+    int k = int(round(circ / Math::td));
+    _northpole = k > 0 && k % 2 != 0;
+    // The slabs start at every slabsize_'th vertex in order of longitude
+    vector<real> w(n);
+    for (size_t i = 0; i < n; ++i) w[i] = _edges[i].lon1;
+    sort(w.begin(), w.end());
+    for (size_t i = 0; i < n; i += slabsize_)
+      if (_slabwest.empty() || w[i] > _slabwest.back())
+        _slabwest.push_back(w[i]);
+    size_t ns = _slabwest.size();
+    // The (slab, edge) pairs for the edges which overlap each slab; edges
+    // along a meridian never cross the meridian of a point and are omitted.
+    vector<pair<size_t, size_t>> pairs;
+    for (size_t i = 0; i < n; ++i) {
+      const Edge& e = _edges[i];
+      if (e.dlon == 0) continue;
+      real west = e.dlon > 0 ? e.lon1 : Math::AngNormalize(e.lon1 + e.dlon),
+        width = fabs(e.dlon);
+      size_t s = Slab(west);
+      for (size_t m = 0; m < ns; ++m) {
+        pairs.push_back(make_pair(s, i));
+        real east = s + 1 < ns ? _slabwest[s + 1] : _slabwest[0] + Math::td,
+          off = east - west;
+        if (off <= 0) off += Math::td;
+        if (!(off < width)) break;
+        s = s + 1 < ns ? s + 1 : 0;
+      }
+    }
+    sort(pairs.begin(), pairs.end());
+    _slabstart.assign(ns + 1, 0);
+    _slabedges.resize(pairs.size());
+    for (size_t p = 0; p < pairs.size(); ++p) {
+      ++_slabstart[pairs[p].first + 1];
+      _slabedges[p] = pairs[p].second;
+    }
+    for (size_t s = 0; s < ns; ++s)
+      _slabstart[s + 1] += _slabstart[s];
+  }
+
+  size_t PointInPolygon::Slab(real lon) const {
+    // Slab k covers [_slabwest[k], _slabwest[k+1]) and the last slab wraps
+    // around to _slabwest[0] + 360.
+    size_t k = size_t(upper_bound(_slabwest.begin(), _slabwest.end(), lon) -
+                      _slabwest.begin());
+    return k > 0 ? k - 1 : _slabwest.size() - 1;
+  }
+
+  bool PointInPolygon::Contains(real lat, real lon) const {
+    if (_edges.empty()) return false;
+    real lonq = Math::AngNormalize(lon);
+    size_t s = Slab(lonq);
+    bool inside = _northpole;
+    for (size_t p = _slabstart[s]; p < _slabstart[s + 1]; ++p) {
+      const Edge& e = _edges[_slabedges[p]];
+      // The half-open intervals [lon1, lon2) for eastward edges and [lon2,
+      // lon1) for westward edges ensure that a vertex on the meridian is
+      // handled correctly.
+      real d = Math::AngDiff(e.lon1, lonq);
+      if (!(e.dlon > 0 ? (0 <= d && d < e.dlon) : (e.dlon <= d && d < 0)))
+        continue;
+      bool north;
+      if (lat < e.latmin)
+        north = true;
+      else if (lat > e.latmax)
+        north = false;
+      else {
+        // The edge crosses the meridian north of Q if Q is on the right of
+        // an eastward edge or on the left of a westward edge.
+        real s12, azi1, azi2, t;
+        _geod.GenInverse(e.lat1, e.lon1, lat, lon, Geodesic::AZIMUTH,
+                         s12, azi1, azi2, t, t, t, t);
+        north = (e.dlon > 0) == (Math::AngDiff(e.azi1, azi1) > 0);
+      }
+      if (north) inside = !inside;
+    }
+    return inside;
+  }
+
+  void PointInPolygon::BoundingBox(real& latmin, real& latmax,
+                                   real& lonmin, real& lonmax) const {
+    if (_edges.empty()) {
+      latmin = latmax = lonmin = lonmax = Math::NaN();
+      return;
+    }
+    latmin = Math::qd; latmax = -Math::qd;
+    // The range of the unrolled longitude of the vertices
+    real lon = _edges[0].lon1, west = lon, east = lon;
+    for (const Edge& e : _edges) {
+      latmin = fmin(latmin, e.latmin); latmax = fmax(latmax, e.latmax);
+      lon += e.dlon;
+      west = fmin(west, lon); east = fmax(east, lon);
+    }
+    int k = int(round((lon - _edges[0].lon1) / Math::td));
+    if (k != 0 || east - west >= Math::td) {
+      lonmin = -Math::hd; lonmax = Math::hd;
+      if (k != 0) {
+        if (_northpole)
+          latmax = Math::qd;
+        else
+          latmin = -Math::qd;
+      }
+    } else {
+      lonmin = Math::AngNormalize(west); lonmax = lonmin + (east - west);
+    }
+  }
+
+  void PointInPolygon::ContainsBatch(size_t n,
+                                     const real lat[], const real lon[],
+                                     bool inside[], unsigned nthreads) const {
+    GeodesicBatchExecutor exec(nthreads);
+    exec.ForEach(n, [&](size_t i0, size_t i1) -> void {
+      for (size_t i = i0; i < i1; ++i)
+        inside[i] = Contains(lat[i], lon[i]);
+    });
+  }
+
+} // namespace GeographicLib
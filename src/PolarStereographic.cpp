@@ -70,34 +70,104 @@ namespace GeographicLib {
     lat *= northp ? 1 : -1;
     real
       tau = Math::tand(lat),
+      taup = Math::taupf(tau, _es);
+    ForwardFinish(northp, lat, lon, tau, taup, x, y, gamma, k);
+  }
+
+  void PolarStereographic::ForwardFinish(bool northp, real lat, real lon,
+                                         real tau, real taup,
+                                         real& x, real& y,
+                                         real& gamma, real& k) const {
+    real
       secphi = hypot(real(1), tau),
-      taup = Math::taupf(tau, _es),
       rho = hypot(real(1), taup) + fabs(taup);
     rho = taup >= 0 ? (lat != Math::qd ? 1/rho : 0) : rho;
     rho *= 2 * _k0 * _a / _c;
     k = lat != Math::qd ?
       (rho / _a) * secphi * sqrt(_e2m + _e2 / Math::sq(secphi)) : _k0;
-    Math::sincosd(lon, x, y);
+    Math::sincosdInline(lon, x, y);
     x *= rho;
     y *= (northp ? -rho : rho);
-    gamma = Math::AngNormalize(northp ? lon : -lon);
+    gamma = Math::AngNormalizeInline(northp ? lon : -lon);
   }
 
   void PolarStereographic::Reverse(bool northp, real x, real y,
                                    real& lat, real& lon,
                                    real& gamma, real& k) const {
-    real
-      rho = hypot(x, y),
-      t = rho != 0 ? rho / (2 * _k0 * _a / _c) :
-      Math::sq(numeric_limits<real>::epsilon()),
-      taup = (1 / t - t) / 2,
-      tau = Math::tauf(taup, _es),
-      secphi = hypot(real(1), tau);
+    real rho, taup;
+    ReverseStart(x, y, rho, taup);
+    ReverseFinish(northp, x, y, rho, Math::tauf(taup, _es),
+                  lat, lon, gamma, k);
+  }
+
+  void PolarStereographic::ReverseStart(real x, real y,
+                                        real& rho, real& taup) const {
+    rho = hypot(x, y);
+    real t = rho != 0 ? rho / (2 * _k0 * _a / _c) :
+      Math::sq(numeric_limits<real>::epsilon());
+    taup = (1 / t - t) / 2;
+  }
+
+  void PolarStereographic::ReverseFinish(bool northp, real x, real y,
+                                         real rho, real tau,
+                                         real& lat, real& lon,
+                                         real& gamma, real& k) const {
+    real secphi = hypot(real(1), tau);
     k = rho != 0 ? (rho / _a) * secphi * sqrt(_e2m + _e2 / Math::sq(secphi)) :
       _k0;
-    lat = (northp ? 1 : -1) * Math::atand(tau);
-    lon = Math::atan2d(x, northp ? -y : y );
-    gamma = Math::AngNormalize(northp ? lon : -lon);
+    lat = (northp ? 1 : -1) * Math::atan2dInline(tau, real(1));
+    lon = Math::atan2dInline(x, northp ? -y : y );
+    gamma = Math::AngNormalizeInline(northp ? lon : -lon);
+  }
+
+  void PolarStereographic::ForwardBatch(size_t n, bool northp,
+                                        const real lat[], const real lon[],
+                                        real x[], real y[],
+                                        real gamma[], real k[]) const {
+    const int K = batchsize_;
+    real la[K], tau[K], taup[K];
+    for (size_t i0 = 0; i0 < n; i0 += K) {
+      int nb = int(min(size_t(K), n - i0));
+      for (int j = 0; j < nb; ++j) {
+        la[j] = Math::LatFix(lat[i0 + j]) * (northp ? 1 : -1);
+        tau[j] = Math::tand(la[j]);
+      }
+      Math::taupfBatch(nb, tau, _es, taup);
+      for (int j = 0; j < nb; ++j) {
+        size_t i = i0 + j;
+        real xi, yi, gi, ki;
+        ForwardFinish(northp, la[j], lon[i], tau[j], taup[j], xi, yi, gi, ki);
+        x[i] = xi; y[i] = yi;
+        if (gamma) gamma[i] = gi;
+        if (k) k[i] = ki;
+      }
+    }
+  }
+
+  void PolarStereographic::ReverseBatch(size_t n, bool northp,
+                                        const real x[], const real y[],
+                                        real lat[], real lon[],
+                                        real gamma[], real k[]) const {
+    const int K = batchsize_;
+    real xs[K], ys[K], rho[K], tau[K];
+    for (size_t i0 = 0; i0 < n; i0 += K) {
+      int nb = int(min(size_t(K), n - i0));
+      for (int j = 0; j < nb; ++j) {
+        // Save x and y in case the output arrays coincide with them
+        xs[j] = x[i0 + j]; ys[j] = y[i0 + j];
+        ReverseStart(xs[j], ys[j], rho[j], tau[j]);
+      }
+      Math::taufBatch(nb, tau, _es, tau);
+      for (int j = 0; j < nb; ++j) {
+        size_t i = i0 + j;
+        real lati, loni, gi, ki;
+        ReverseFinish(northp, xs[j], ys[j], rho[j], tau[j],
+                      lati, loni, gi, ki);
+        lat[i] = lati; lon[i] = loni;
+        if (gamma) gamma[i] = gi;
+        if (k) k[i] = ki;
+      }
+    }
   }
 
   void PolarStereographic::SetScale(real lat, real k) {
@@ -8,6 +8,10 @@
  **********************************************************************/
 
 #include <GeographicLib/PolygonArea.hpp>
+#include <GeographicLib/ExactAccumulator.hpp>
+#include <GeographicLib/GeodesicBatchExecutor.hpp>
+#include <mutex>
+#include <vector>
 
 #if defined(_MSC_VER)
 // Squelch warnings about enum-float expressions
@@ -85,6 +89,71 @@ namespace GeographicLib {
     ++_num;
   }
 
+  template<class GeodType>
+  void PolygonAreaT<GeodType>::AddPoints(size_t n,
+                                         const real lat[], const real lon[],
+                                         unsigned nthreads) {
+    if (n == 0) return;
+    size_t i0 = 0;
+    if (_num == 0) {
+      AddPoint(lat[0], lon[0]);
+      ++i0;
+    }
+    // The edge k is from point i0 + k - 1 (or the current point for k = 0)
+    // to point i0 + k.  Each chunk of edges is summed exactly on its own
+    // thread and the partial sums are merged; because the sums are exact,
+    // the result doesn't depend on the number of threads.
+    size_t m = n - i0;
+    ExactAccumulator<real> perimetersum, areasum;
+    int crossings = 0;
+    mutex summutex;
+    GeodesicBatchExecutor(nthreads).ForEach(m, [&](size_t k0, size_t k1)
+                                            -> void {
+      ExactAccumulator<real> perimeter, area;
+      int cross = 0;
+      // Solve the problems in blocks with InverseEdges; apart from edge 0,
+      // the starting points of the edges in a block are contiguous in the
+      // input arrays.
+      const size_t B = 64;
+      real s12[B], S12[B];
+      for (size_t kb = k0; kb < k1; kb += B) {
+        size_t nb = min(B, k1 - kb), i = i0 + kb;
+        if (kb == 0) {
+          InverseEdges(1, &_lat1, &_lon1, lat + i, lon + i,
+                       s12, _polyline ? nullptr : S12);
+          if (nb > 1)
+            InverseEdges(nb - 1, lat + i, lon + i, lat + i + 1, lon + i + 1,
+                         s12 + 1, _polyline ? nullptr : S12 + 1);
+        } else
+          InverseEdges(nb, lat + i - 1, lon + i - 1, lat + i, lon + i,
+                       s12, _polyline ? nullptr : S12);
+        for (size_t j = 0; j < nb; ++j) {
+          perimeter += s12[j];
+          if (!_polyline) {
+            area += S12[j];
+            cross += transit(kb + j ? lon[i + j - 1] : _lon1, lon[i + j]);
+          }
+        }
+      }
+      lock_guard<mutex> lock(summutex);
+      perimetersum.merge(perimeter);
+      areasum.merge(area);
+      crossings += cross;
+    });
+    // Transfer the exact sums to the accumulators as two terms each
+    real hi = perimetersum();
+    perimetersum -= hi;
+    _perimetersum += hi; _perimetersum += perimetersum();
+    if (!_polyline) {
+      hi = areasum();
+      areasum -= hi;
+      _areasum += hi; _areasum += areasum();
+      _crossings += crossings;
+    }
+    _lat1 = lat[n - 1]; _lon1 = lon[n - 1];
+    _num += unsigned(m);
+  }
+
   template<class GeodType>
   void PolygonAreaT<GeodType>::AddEdge(real azi, real s) {
     if (_num) {                 // Do nothing if _num is zero
@@ -199,6 +268,208 @@ namespace GeographicLib {
     return num;
   }
 
+  // Solve the inverse problems for a sequence of edges with InverseBatch.
+  // The general version loops over GenInverse.
+  template<class GeodType>
+  void PolygonAreaT<GeodType>::InverseEdges(size_t k,
+                                            const real lat1[],
+                                            const real lon1[],
+                                            const real lat2[],
+                                            const real lon2[],
+                                            real s12[], real S12[]) const {
+    real t, S = 0;
+    for (size_t i = 0; i < k; ++i) {
+      _earth.GenInverse(lat1[i], lon1[i], lat2[i], lon2[i], _mask,
+                        s12[i], t, t, t, t, t, S);
+      if (S12) S12[i] = S;
+    }
+  }
+
+  template<>
+  void PolygonAreaT<Geodesic>::InverseEdges(size_t k,
+                                            const real lat1[],
+                                            const real lon1[],
+                                            const real lat2[],
+                                            const real lon2[],
+                                            real s12[], real S12[]) const {
+    _earth.InverseBatch(k, lat1, lon1, lat2, lon2, _mask,
+                        nullptr, s12, nullptr, nullptr,
+                        nullptr, nullptr, nullptr, S12);
+  }
+
+  template<>
+  void PolygonAreaT<GeodesicExact>::InverseEdges(size_t k,
+                                                 const real lat1[],
+                                                 const real lon1[],
+                                                 const real lat2[],
+                                                 const real lon2[],
+                                                 real s12[], real S12[])
+    const {
+    _earth.InverseBatch(k, lat1, lon1, lat2, lon2, _mask,
+                        nullptr, s12, nullptr, nullptr,
+                        nullptr, nullptr, nullptr, S12);
+  }
+
+  template<>
+  void PolygonAreaT<Rhumb>::InverseEdges(size_t k,
+                                         const real lat1[],
+                                         const real lon1[],
+                                         const real lat2[],
+                                         const real lon2[],
+                                         real s12[], real S12[]) const {
+    _earth.InverseBatch(k, lat1, lon1, lat2, lon2, _mask,
+                        s12, nullptr, S12);
+  }
+
+  template<class GeodType>
+  template<class CA>
+  void PolygonAreaT<GeodType>::RingCompute(size_t m, CA lat, CA lon,
+                                           bool reverse, bool sign,
+                                           vector<real>& work,
+                                           real& perimeter, real& area) const {
+    if (m < 2) {
+      perimeter = 0;
+      if (!_polyline)
+        area = 0;
+      return;
+    }
+    // The number of edges
+    size_t k = _polyline ? m - 1 : m;
+    work.resize(6 * k);
+    real
+      *lat1 = work.data(), *lon1 = lat1 + k,
+      *lat2 = lon1 + k, *lon2 = lat2 + k,
+      *s12 = lon2 + k, *S12 = _polyline ? nullptr : s12 + k;
+    for (size_t i = 0; i < k; ++i) {
+      size_t j = i + 1 < m ? i + 1 : 0;
+      lat1[i] = lat[i]; lon1[i] = lon[i];
+      lat2[i] = lat[j]; lon2[i] = lon[j];
+    }
+    InverseEdges(k, lat1, lon1, lat2, lon2, s12, S12);
+    // Accumulate the results in the same order as AddPoint and Compute
+    Accumulator<> perimetersum, areasum;
+    int crossings = 0;
+    for (size_t i = 0; i + 1 < m; ++i) {
+      perimetersum += s12[i];
+      if (!_polyline) {
+        areasum += S12[i];
+        crossings += transit(lon[i], lon[i + 1]);
+      }
+    }
+    if (_polyline) {
+      perimeter = perimetersum();
+      return;
+    }
+    perimeter = perimetersum(s12[m - 1]);
+    areasum += S12[m - 1];
+    crossings += transit(lon[m - 1], lon[0]);
+    AreaReduce(areasum, crossings, reverse, sign);
+    area = real(0) + areasum();
+  }
+
+  template<class GeodType>
+  void PolygonAreaT<GeodType>::ComputeBatch(size_t nrings,
+                                            const size_t offsets[],
+                                            const real lat[],
+                                            const real lon[],
+                                            bool reverse, bool sign,
+                                            real perimeter[], real area[],
+                                            unsigned nthreads) const {
+    IntComputeBatch(nrings, offsets, lat, lon, reverse, sign,
+                    perimeter, area, nthreads);
+  }
+
+  template<class GeodType>
+  void PolygonAreaT<GeodType>::ComputeBatch(size_t nrings,
+                                            const size_t offsets[],
+                                            StridedView<const real> lat,
+                                            StridedView<const real> lon,
+                                            bool reverse, bool sign,
+                                            StridedView<real> perimeter,
+                                            StridedView<real> area,
+                                            unsigned nthreads) const {
+    IntComputeBatch(nrings, offsets, lat, lon, reverse, sign,
+                    perimeter, area, nthreads);
+  }
+
+  template<class GeodType>
+  template<class CA, class A>
+  void PolygonAreaT<GeodType>::IntComputeBatch(size_t nrings,
+                                               const size_t offsets[],
+                                               CA lat, CA lon,
+                                               bool reverse, bool sign,
+                                               A perimeter, A area,
+                                               unsigned nthreads) const {
+    GeodesicBatchExecutor(nthreads).ForEach
+      (nrings, [&](size_t i0, size_t i1) -> void {
+        vector<real> work;
+        real t = 0;
+        for (size_t i = i0; i < i1; ++i) {
+          size_t j = offsets[i];
+          RingCompute(offsets[i + 1] - j, lat + j, lon + j, reverse, sign,
+                      work, perimeter[i], area ? area[i] : t);
+        }
+      });
+  }
+
+  template<class GeodType>
+  void PolygonAreaT<GeodType>::ComputeBatch(size_t npolygons,
+                                            const size_t polyoffsets[],
+                                            const size_t ringoffsets[],
+                                            const real lat[],
+                                            const real lon[],
+                                            bool reverse, bool sign,
+                                            real perimeter[], real area[],
+                                            unsigned nthreads) const {
+    IntComputeBatch(npolygons, polyoffsets, ringoffsets, lat, lon,
+                    reverse, sign, perimeter, area, nthreads);
+  }
+
+  template<class GeodType>
+  void PolygonAreaT<GeodType>::ComputeBatch(size_t npolygons,
+                                            const size_t polyoffsets[],
+                                            const size_t ringoffsets[],
+                                            StridedView<const real> lat,
+                                            StridedView<const real> lon,
+                                            bool reverse, bool sign,
+                                            StridedView<real> perimeter,
+                                            StridedView<real> area,
+                                            unsigned nthreads) const {
+    IntComputeBatch(npolygons, polyoffsets, ringoffsets, lat, lon,
+                    reverse, sign, perimeter, area, nthreads);
+  }
+
+  template<class GeodType>
+  template<class CA, class A>
+  void PolygonAreaT<GeodType>::IntComputeBatch(size_t npolygons,
+                                               const size_t polyoffsets[],
+                                               const size_t ringoffsets[],
+                                               CA lat, CA lon,
+                                               bool reverse, bool sign,
+                                               A perimeter, A area,
+                                               unsigned nthreads) const {
+    GeodesicBatchExecutor(nthreads).ForEach
+      (npolygons, [&](size_t i0, size_t i1) -> void {
+        vector<real> work;
+        for (size_t i = i0; i < i1; ++i) {
+          Accumulator<> perimetersum, areasum;
+          for (size_t r = polyoffsets[i]; r < polyoffsets[i + 1]; ++r) {
+            size_t j = ringoffsets[r];
+            real p, a = 0;
+            RingCompute(ringoffsets[r + 1] - j, lat + j, lon + j,
+                        reverse, true, work, p, a);
+            perimetersum += p;
+            areasum += a;
+          }
+          perimeter[i] = perimetersum();
+          if (!_polyline && area) {
+            if (!sign && areasum < 0) areasum += _area0;
+            area[i] = real(0) + areasum();
+          }
+        }
+      });
+  }
+
   template<class GeodType>
   template<typename T>
   void PolygonAreaT<GeodType>::AreaReduce(T& area, int crossings,
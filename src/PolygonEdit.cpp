@@ -0,0 +1,191 @@
+/**
+ * \file PolygonEdit.cpp
+ * \brief Implementation for GeographicLib::PolygonEditT class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#include <GeographicLib/PolygonEdit.hpp>
+
+#if defined(_MSC_VER)
+// Squelch warnings about enum-float expressions
+#  pragma warning (disable: 5055)
+#endif
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  template<class GeodType>
+  typename PolygonEditT<GeodType>::edgesum
+  PolygonEditT<GeodType>::merge(const edgesum& x, const edgesum& y) {
+    // Double-double sums with the errors of the leading parts carried into
+    // the trailing parts
+    edgesum r;
+    real t;
+    r.s = Math::sum(x.s, y.s, t); r.st = x.st + y.st + t;
+    r.a = Math::sum(x.a, y.a, t); r.at = x.at + y.at + t;
+    r.crossings = x.crossings + y.crossings;
+    return r;
+  }
+
+  template<class GeodType>
+  void PolygonEditT<GeodType>::Clear() {
+    _num = 0;
+    _first = _free = NONE;
+    _vertices.clear();
+    _leaves = 1;
+    _tree.assign(2 * _leaves, edgesum());
+  }
+
+  template<class GeodType>
+  void PolygonEditT<GeodType>::Check(size_t k) const {
+    if (!(k < _vertices.size() && _vertices[k].prev != NONE))
+      throw GeographicErr("Invalid vertex handle " + to_string(k));
+  }
+
+  template<class GeodType>
+  size_t PolygonEditT<GeodType>::Allocate(real lat, real lon) {
+    size_t k;
+    if (_free != NONE) {
+      k = _free;
+      _free = _vertices[k].next;
+    } else {
+      k = _vertices.size();
+      _vertices.push_back(vertex());
+      if (k == _leaves) {
+        // Double the number of leaves and rebuild the tree
+        size_t leaves = 2 * _leaves;
+        vector<edgesum> tree(2 * leaves);
+        for (size_t i = 0; i < _leaves; ++i)
+          tree[leaves + i] = _tree[_leaves + i];
+        for (size_t i = leaves - 1; i > 0; --i)
+          tree[i] = merge(tree[2 * i], tree[2 * i + 1]);
+        _leaves = leaves;
+        _tree.swap(tree);
+      }
+    }
+    _vertices[k].lat = lat; _vertices[k].lon = lon;
+    return k;
+  }
+
+  template<class GeodType>
+  void PolygonEditT<GeodType>::Update(size_t k, const edgesum& e) {
+    size_t i = _leaves + k;
+    _tree[i] = e;
+    for (i /= 2; i > 0; i /= 2)
+      _tree[i] = merge(_tree[2 * i], _tree[2 * i + 1]);
+  }
+
+  template<class GeodType>
+  void PolygonEditT<GeodType>::SetEdge(size_t k) {
+    const vertex& v = _vertices[k];
+    size_t n = v.next;
+    edgesum e;
+    // No edge from a lone vertex to itself or to close a polyline
+    if (!(n == k || (_polyline && n == _first))) {
+      const vertex& w = _vertices[n];
+      real s12, S12, t;
+      _earth.GenInverse(v.lat, v.lon, w.lat, w.lon, _mask,
+                        s12, t, t, t, t, t, S12);
+      e.s = s12;
+      if (!_polyline) {
+        e.a = S12;
+        e.crossings = PolygonAreaT<GeodType>::transit(v.lon, w.lon);
+      }
+    }
+    Update(k, e);
+  }
+
+  template<class GeodType>
+  size_t PolygonEditT<GeodType>::AddPoint(real lat, real lon) {
+    if (_first != NONE)
+      return Insert(Last(), lat, lon);
+    size_t k = Allocate(lat, lon);
+    _vertices[k].prev = _vertices[k].next = _first = k;
+    ++_num;
+    return k;
+  }
+
+  template<class GeodType>
+  size_t PolygonEditT<GeodType>::Insert(size_t k, real lat, real lon) {
+    Check(k);
+    // N.B. Allocate may reallocate _vertices
+    size_t j = Allocate(lat, lon), n = _vertices[k].next;
+    _vertices[j].prev = k; _vertices[j].next = n;
+    _vertices[k].next = _vertices[n].prev = j;
+    ++_num;
+    SetEdge(k);
+    SetEdge(j);
+    return j;
+  }
+
+  template<class GeodType>
+  void PolygonEditT<GeodType>::Move(size_t k, real lat, real lon) {
+    Check(k);
+    _vertices[k].lat = lat; _vertices[k].lon = lon;
+    size_t p = _vertices[k].prev;
+    SetEdge(k);
+    if (p != k) SetEdge(p);
+  }
+
+  template<class GeodType>
+  void PolygonEditT<GeodType>::Remove(size_t k) {
+    Check(k);
+    size_t p = _vertices[k].prev, n = _vertices[k].next;
+    _vertices[p].next = n; _vertices[n].prev = p;
+    if (_first == k) _first = n == k ? NONE : n;
+    _vertices[k].prev = NONE;
+    _vertices[k].next = _free;
+    _free = k;
+    Update(k, edgesum());
+    --_num;
+    if (_num) SetEdge(p);
+  }
+
+  template<class GeodType>
+  unsigned PolygonEditT<GeodType>::Compute(bool reverse, bool sign,
+                                           real& perimeter, real& area) const
+  {
+    if (_num < 2) {
+      perimeter = 0;
+      if (!_polyline)
+        area = 0;
+      return _num;
+    }
+    const edgesum& total = _tree[1];
+    perimeter = total.s + total.st;
+    if (_polyline)
+      return _num;
+    Accumulator<> tempsum(total.a);
+    tempsum += total.at;
+    // The same reduction as PolygonAreaT::AreaReduce
+    tempsum.remainder(_area0);
+    if (total.crossings & 1)
+      tempsum += (tempsum < 0 ? 1 : -1) * _area0/2;
+    // tempsum is with the clockwise sense.  If !reverse convert to
+    // counter-clockwise convention.
+    if (!reverse) tempsum *= -1;
+    // If sign put area in (-_area0/2, _area0/2], else put area in [0, _area0)
+    if (sign) {
+      if (tempsum > _area0/2)
+        tempsum -= _area0;
+      else if (tempsum <= -_area0/2)
+        tempsum += _area0;
+    } else {
+      if (tempsum >= _area0)
+        tempsum -= _area0;
+      else if (tempsum < 0)
+        tempsum += _area0;
+    }
+    area = real(0) + tempsum();
+    return _num;
+  }
+
+  template class GEOGRAPHICLIB_EXPORT PolygonEditT<Geodesic>;
+  template class GEOGRAPHICLIB_EXPORT PolygonEditT<GeodesicExact>;
+  template class GEOGRAPHICLIB_EXPORT PolygonEditT<Rhumb>;
+
+} // namespace GeographicLib
@@ -0,0 +1,364 @@
+/**
+ * \file PolygonReader.cpp
+ * \brief Implementation for GeographicLib::PolygonReader class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#include <GeographicLib/PolygonReader.hpp>
+#include <GeographicLib/Utility.hpp>
+#include <cstdio>
+#include <cstring>
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  PolygonReader::PolygonReader(istream& in, format fmt)
+    : _buf(in.rdbuf())
+    , _fmt(fmt)
+    , _incollection(false)
+    , _first(false)
+    , _hex(false)
+    , _started(false)
+    , _count(0)
+  {
+    const uint32_t one = 1;
+    unsigned char c;
+    memcpy(&c, &one, 1);
+    _little = c == 1;
+  }
+
+  void PolygonReader::error(const string& msg) const {
+    throw GeographicErr(string(_fmt == GEOJSON ? "GeoJSON" : "WKB") +
+                        " feature " + Utility::str(_count + 1) + ": " + msg);
+  }
+
+  void PolygonReader::skipws() {
+    // 0x1e is the record separator of GeoJSON text sequences
+    for (int c = peek();
+         c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == 0x1e;
+         c = peek())
+      get();
+  }
+
+  void PolygonReader::expect(char c) {
+    skipws();
+    int d = get();
+    if (d != c)
+      error(d == EOF ? string("unexpected end of input") :
+            string("expected '") + c + "' but found '" + char(d) + "'");
+  }
+
+  void PolygonReader::String(string& s) {
+    expect('"');
+    s.clear();
+    for (int c = get(); c != '"'; c = get()) {
+      if (c == EOF) error("unterminated string");
+      // Escapes are kept; the strings are only compared with plain names.
+      if (c == '\\') {
+        s += char(c);
+        c = get();
+        if (c == EOF) error("unterminated string");
+      }
+      s += char(c);
+    }
+  }
+
+  Math::real PolygonReader::Number() {
+    skipws();
+    _tok.clear();
+    for (int c = peek();
+         (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' ||
+           c == 'e' || c == 'E';
+         c = peek())
+      _tok += char(get());
+    real x;
+    if (_tok.empty() || !Utility::val<real>(_tok.data(), _tok.size(), x))
+      error("bad number " + _tok);
+    return x;
+  }
+
+  void PolygonReader::Skip() {
+    skipws();
+    int c = peek();
+    if (c == '"') {
+      String(_tok);
+    } else if (c == '{' || c == '[') {
+      get();
+      char close = c == '{' ? '}' : ']';
+      skipws();
+      if (peek() == close) { get(); return; }
+      while (true) {
+        if (close == '}') {
+          String(_tok);
+          expect(':');
+        }
+        Skip();
+        skipws();
+        c = get();
+        if (c == close) break;
+        if (c != ',') error("expected ',' or '" + string(1, close) + "'");
+      }
+    } else {
+      // A number, true, false, or null
+      bool any = false;
+      for (c = peek(); (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') ||
+             c == '-' || c == '+' || c == '.' || c == 'E'; c = peek()) {
+        get(); any = true;
+      }
+      if (!any) error(c == EOF ? string("unexpected end of input") :
+                      "unexpected '" + string(1, char(c)) + "'");
+    }
+  }
+
+  void PolygonReader::FinishObject() {
+    while (true) {
+      skipws();
+      int c = get();
+      if (c == '}') return;
+      if (c != ',') error("expected ',' or '}'");
+      String(_tok);
+      expect(':');
+      Skip();
+    }
+  }
+
+  void PolygonReader::Ring(size_t start, vector<size_t>& ringoffsets,
+                           vector<real>& lat, vector<real>& lon) {
+    size_t n = lat.size() - start;
+    if (n > 1 && lat.back() == lat[start] && lon.back() == lon[start]) {
+      lat.pop_back(); lon.pop_back(); --n;
+    }
+    if (n > 0) ringoffsets.push_back(lat.size());
+  }
+
+  int PolygonReader::Coordinates(vector<size_t>& ringoffsets,
+                                 vector<real>& lat, vector<real>& lon) {
+    // Return the depth of the value: 0 for a number, 1 for a position, 2
+    // for an array of positions (a ring), etc.  -1 for an empty array.
+    skipws();
+    if (peek() != '[') {
+      Number();
+      return 0;
+    }
+    get();
+    size_t start = lat.size();
+    int depth = -1, nnum = 0;
+    real xy[2] = {0, 0};
+    skipws();
+    if (peek() == ']') { get(); return -1; }
+    while (true) {
+      skipws();
+      int d;
+      if (peek() == '[')
+        d = Coordinates(ringoffsets, lat, lon);
+      else {
+        real x = Number();
+        if (nnum < 2) xy[nnum] = x;
+        ++nnum;
+        d = 0;
+      }
+      if (d >= 0) {
+        if (depth >= 0 && d != depth) error("inconsistent coordinates");
+        depth = d;
+      }
+      skipws();
+      int c = get();
+      if (c == ']') break;
+      if (c != ',') error("expected ',' or ']' in coordinates");
+    }
+    if (depth == 0) {
+      if (nnum < 2) error("position with fewer than 2 coordinates");
+      lon.push_back(xy[0]); lat.push_back(xy[1]);
+    } else if (depth == 1)
+      Ring(start, ringoffsets, lat, lon);
+    return depth < 0 ? -1 : depth + 1;
+  }
+
+  bool PolygonReader::Object(bool top, vector<size_t>& ringoffsets,
+                             vector<real>& lat, vector<real>& lon) {
+    // The opening brace has been read.  Return true if a top level object
+    // contains "features" whose elements are then read by Next.
+    size_t nvert = lat.size(), nring = ringoffsets.size();
+    string type, key;
+    skipws();
+    if (peek() == '}') { get(); return false; }
+    while (true) {
+      String(key);
+      expect(':');
+      skipws();
+      if (key == "type")
+        String(type);
+      else if (key == "coordinates") {
+        size_t start = lat.size();
+        // A bare position (a Point) isn't a ring
+        if (Coordinates(ringoffsets, lat, lon) == 1) {
+          lat.resize(start); lon.resize(start);
+        }
+      } else if (key == "geometry" && peek() == '{') {
+        get();
+        Object(false, ringoffsets, lat, lon);
+      } else if (key == "geometries" && peek() == '[') {
+        get();
+        skipws();
+        if (peek() == ']')
+          get();
+        else
+          while (true) {
+            expect('{');
+            Object(false, ringoffsets, lat, lon);
+            skipws();
+            int c = get();
+            if (c == ']') break;
+            if (c != ',') error("expected ',' or ']' in geometries");
+          }
+      } else if (key == "features" && top && peek() == '[') {
+        get();
+        _incollection = true; _first = true;
+        return true;
+      } else
+        Skip();
+      skipws();
+      int c = get();
+      if (c == '}') break;
+      if (c != ',') error("expected ',' or '}'");
+    }
+    if (type == "Point" || type == "MultiPoint") {
+      lat.resize(nvert); lon.resize(nvert); ringoffsets.resize(nring);
+    }
+    return false;
+  }
+
+  unsigned char PolygonReader::Byte() {
+    if (!_hex) {
+      int c = get();
+      if (c == EOF) error("unexpected end of input");
+      return static_cast<unsigned char>(c);
+    }
+    unsigned v = 0;
+    for (int k = 0; k < 2; ++k) {
+      skipws();
+      int c = get(), d =
+        c >= '0' && c <= '9' ? c - '0' :
+        (c >= 'a' && c <= 'f' ? c - 'a' + 10 :
+         (c >= 'A' && c <= 'F' ? c - 'A' + 10 : -1));
+      if (d < 0) error(c == EOF ? string("unexpected end of input") :
+                       "bad hex digit '" + string(1, char(c)) + "'");
+      v = 16 * v + unsigned(d);
+    }
+    return static_cast<unsigned char>(v);
+  }
+
+  uint32_t PolygonReader::U32(bool little) {
+    uint32_t x = 0;
+    for (int k = 0; k < 4; ++k) {
+      uint32_t b = Byte();
+      x |= little ? b << (8 * k) : b << (8 * (3 - k));
+    }
+    return x;
+  }
+
+  double PolygonReader::F64(bool little) {
+    unsigned char b[8];
+    for (int k = 0; k < 8; ++k) b[little == _little ? k : 7 - k] = Byte();
+    double x;
+    memcpy(&x, b, 8);
+    return x;
+  }
+
+  void PolygonReader::Geometry(int depth, vector<size_t>& ringoffsets,
+                               vector<real>& lat, vector<real>& lon) {
+    if (depth > 32) error("geometries nested too deeply");
+    unsigned char order = Byte();
+    if (order > 1) error("bad byte order " + Utility::str(int(order)));
+    bool little = order == 1;
+    uint32_t type = U32(little);
+    // Extended WKB flags
+    int ndim = 2 + ((type & 0x80000000u) ? 1 : 0) +
+      ((type & 0x40000000u) ? 1 : 0);
+    if (type & 0x20000000u) U32(little); // SRID
+    type &= 0x0fffffffu;
+    // ISO WKB: 1000 for Z, 2000 for M, 3000 for ZM
+    ndim += type >= 3000 ? 2 : (type >= 1000 ? 1 : 0);
+    type %= 1000;
+    auto ring = [this, little, ndim, &ringoffsets, &lat, &lon]() -> void {
+      uint32_t n = U32(little);
+      size_t start = lat.size();
+      for (uint32_t i = 0; i < n; ++i) {
+        lon.push_back(real(F64(little)));
+        lat.push_back(real(F64(little)));
+        for (int k = 2; k < ndim; ++k) F64(little);
+      }
+      Ring(start, ringoffsets, lat, lon);
+    };
+    switch (type) {
+    case 1:                     // Point
+      for (int k = 0; k < ndim; ++k) F64(little);
+      break;
+    case 2:                     // LineString
+      ring();
+      break;
+    case 3:                     // Polygon
+      for (uint32_t n = U32(little), i = 0; i < n; ++i) ring();
+      break;
+    case 4:                     // MultiPoint
+    case 5:                     // MultiLineString
+    case 6:                     // MultiPolygon
+    case 7:                     // GeometryCollection
+      for (uint32_t n = U32(little), i = 0; i < n; ++i)
+        Geometry(depth + 1, ringoffsets, lat, lon);
+      break;
+    default:
+      error("unsupported geometry type " + Utility::str(type));
+    }
+  }
+
+  bool PolygonReader::Next(vector<size_t>& ringoffsets,
+                           vector<real>& lat, vector<real>& lon) {
+    if (ringoffsets.empty() || ringoffsets.back() != lat.size() ||
+        lon.size() != lat.size())
+      throw GeographicErr("PolygonReader: inconsistent output buffers");
+    if (_fmt == WKB) {
+      if (!_started) {
+        skipws();
+        int c = peek();
+        _hex = (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') ||
+          (c >= 'A' && c <= 'F');
+        _started = true;
+      }
+      if (_hex) skipws();
+      if (peek() == EOF) return false;
+      Geometry(0, ringoffsets, lat, lon);
+      ++_count;
+      return true;
+    }
+    while (true) {
+      if (_incollection) {
+        skipws();
+        if (peek() == ']') {
+          get();
+          _incollection = false;
+          FinishObject();
+          continue;
+        }
+        if (!_first) expect(',');
+        _first = false;
+        expect('{');
+        Object(false, ringoffsets, lat, lon);
+        ++_count;
+        return true;
+      }
+      skipws();
+      if (peek() == EOF) return false;
+      expect('{');
+      if (!Object(true, ringoffsets, lat, lon)) {
+        ++_count;
+        return true;
+      }
+    }
+  }
+
+} // namespace GeographicLib
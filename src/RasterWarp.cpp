@@ -0,0 +1,116 @@
+/**
+ * \file RasterWarp.cpp
+ * \brief Implementation for GeographicLib::RasterWarp class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#include <GeographicLib/RasterWarp.hpp>
+#include <GeographicLib/GeodesicBatchExecutor.hpp>
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  RasterWarp::RasterWarp(const Grid& src, const Grid& dst, const transform& f,
+                         resampling method, real tol, unsigned nthreads)
+    : _src(src)
+    , _dst(dst)
+    , _approx(f, SourceTolerance(src, dst, tol))
+    , _method(method)
+    , _nthreads(nthreads)
+  {
+    if (!(method == NEAREST || method == BILINEAR || method == CUBIC))
+      throw GeographicErr("Bad resampling method");
+  }
+
+  Math::real RasterWarp::SourceTolerance(const Grid& src, const Grid& dst,
+                                         real tol) {
+    if (!(src.nx > 0 && src.ny > 0 && dst.nx > 0 && dst.ny > 0))
+      throw GeographicErr("Raster dimensions not positive");
+    if (!(isfinite(src.x0) && isfinite(src.y0) &&
+          isfinite(src.dx) && src.dx != 0 &&
+          isfinite(src.dy) && src.dy != 0 &&
+          isfinite(dst.x0) && isfinite(dst.y0) &&
+          isfinite(dst.dx) && dst.dx != 0 &&
+          isfinite(dst.dy) && dst.dy != 0))
+      throw GeographicErr("Bad raster origin or spacing");
+    if (!(tol > 0))
+      throw GeographicErr("Tolerance not positive");
+    return tol * fmin(fabs(src.dx), fabs(src.dy));
+  }
+
+  template<typename T>
+  void RasterWarp::WarpT(const T src[], T dst[], T nodata) const {
+    const int nx = _src.nx, ny = _src.ny;
+    // The value of the source pixel (i, j) with i and j clamped
+    auto at = [src, nx, ny](int i, int j) -> real {
+      i = i < 0 ? 0 : (i >= nx ? nx - 1 : i);
+      j = j < 0 ? 0 : (j >= ny ? ny - 1 : j);
+      return real(src[size_t(j) * nx + i]);
+    };
+    // The weights of the cubic convolution kernel for offsets -1, 0, 1, 2
+    auto cubic = [](real t, real w[]) -> void {
+      real t2 = t * t, t3 = t2 * t;
+      w[0] = (-t3 + 2 * t2 - t) / 2;
+      w[1] = (3 * t3 - 5 * t2 + 2) / 2;
+      w[2] = (-3 * t3 + 4 * t2 + t) / 2;
+      w[3] = (t3 - t2) / 2;
+    };
+    auto sample = [this, &at, &cubic, nx, ny, nodata](real u, real v) -> T {
+      real fi = (u - _src.x0) / _src.dx, fj = (v - _src.y0) / _src.dy;
+      // The footprint of the source raster; this also rejects NaNs.
+      if (!(fi >= -real(0.5) && fi <= nx - real(0.5) &&
+            fj >= -real(0.5) && fj <= ny - real(0.5)))
+        return nodata;
+      int i = int(floor(fi)), j = int(floor(fj));
+      real a = fi - i, b = fj - j;
+      switch (_method) {
+      case NEAREST:
+        return T(at(int(floor(fi + real(0.5))), int(floor(fj + real(0.5)))));
+      case BILINEAR:
+        return T((1 - b) * ((1 - a) * at(i, j) + a * at(i + 1, j)) +
+                 b * ((1 - a) * at(i, j + 1) + a * at(i + 1, j + 1)));
+      default:
+        {
+          real wi[4], wj[4], s = 0;
+          cubic(a, wi); cubic(b, wj);
+          for (int l = 0; l < 4; ++l) {
+            real r = 0;
+            for (int k = 0; k < 4; ++k)
+              r += wi[k] * at(i - 1 + k, j - 1 + l);
+            s += wj[l] * r;
+          }
+          return T(s);
+        }
+      }
+    };
+    const int mx = _dst.nx;
+    GeodesicBatchExecutor exec(_nthreads, rows_);
+    // The bands of rows_ rows are the same however the work is divided
+    // among the threads; so the results are too.
+    exec.ForEach(size_t(_dst.ny), [&](size_t j0, size_t j1) -> void {
+      vector<real> u, v;
+      for (size_t ja = j0; ja < j1; ja += rows_) {
+        int my = int(min(j1, ja + rows_) - ja);
+        size_t m = size_t(my) * mx;
+        u.resize(m); v.resize(m);
+        _approx.Grid(_dst.x0, _dst.y0 + real(ja) * _dst.dy, _dst.dx, _dst.dy,
+                     mx, my, u.data(), v.data());
+        T* out = dst + ja * mx;
+        for (size_t k = 0; k < m; ++k)
+          out[k] = sample(u[k], v[k]);
+      }
+    });
+  }
+
+  void RasterWarp::Warp(const float src[], float dst[], float nodata) const
+  { WarpT<float>(src, dst, nodata); }
+
+  void RasterWarp::Warp(const double src[], double dst[], double nodata)
+    const
+  { WarpT<double>(src, dst, nodata); }
+
+} // namespace GeographicLib
@@ -9,7 +9,10 @@
  **********************************************************************/
 
 #include <algorithm>
+#include <limits>
 #include <GeographicLib/Rhumb.hpp>
+#include <GeographicLib/DST.hpp>
+#include <GeographicLib/SharedInstances.hpp>
 
 #if defined(_MSC_VER)
 // Squelch warnings about enum-float expressions
@@ -142,6 +145,40 @@ namespace GeographicLib {
       d *= _ell._n;
     }
     // Post condition: o == sizeof(alpcoeff) / sizeof(real)
+    if (_exact) {
+      // The functions mu(chi) - chi and chi(mu) - mu (in radians) given in
+      // terms of elliptic integrals.  The number of terms needed grows with
+      // the precision, so allow more samples for higher precisions.
+      int maxN = 256 * ((Math::digits() + 52) / 53);
+      if (!(DST::sinefit([this](real chi) -> real {
+            real lat = _ell.InverseConformalLatitude(chi / Math::degree());
+            return _ell.RectifyingLatitude(lat) * Math::degree() - chi;
+          }, _cR, maxN) &&
+            DST::sinefit([this](real mu) -> real {
+              real lat = _ell.InverseRectifyingLatitude(mu / Math::degree());
+              return _ell.ConformalLatitude(lat) * Math::degree() - mu;
+            }, _rC, maxN))) {
+        _cR.clear(); _rC.clear();
+      }
+    }
+  }
+
+  Math::real Rhumb::RectifyingLatitude(real lat) const {
+    if (_cR.empty() || fabs(lat) == Math::qd)
+      return _ell.RectifyingLatitude(lat);
+    real chi = _ell.ConformalLatitude(lat) * Math::degree();
+    return (chi + DST::sineval(sin(chi), cos(chi),
+                               _cR.data(), int(_cR.size()) - 1))
+      / Math::degree();
+  }
+
+  Math::real Rhumb::InverseRectifyingLatitude(real mu) const {
+    if (_rC.empty() || fabs(mu) == Math::qd)
+      return _ell.InverseRectifyingLatitude(mu);
+    real m = mu * Math::degree();
+    return _ell.InverseConformalLatitude
+      ((m + DST::sineval(sin(m), cos(m), _rC.data(), int(_rC.size()) - 1))
+       / Math::degree());
   }
 
   const Rhumb& Rhumb::WGS84() {
@@ -150,24 +187,99 @@ namespace GeographicLib {
     return wgs84;
   }
 
-  void Rhumb::GenInverse(real lat1, real lon1, real lat2, real lon2,
-                         unsigned outmask,
+#if GEOGRAPHICLIB_PRECISION != 5
+  namespace {
+    // Construct the instance at load time (see Geodesic::WGS84())
+    const Rhumb& wgs84init_ = Rhumb::WGS84();
+  }
+#endif
+
+  const Rhumb& Rhumb::Get(real a, real f, bool exact) {
+    static SharedInstances<Rhumb> instances;
+    SharedInstances<Rhumb>::key_type key = {{a, f, real(exact), 0}};
+    return instances.Get(key, a, f, exact);
+  }
+
+  Rhumb::invpoint Rhumb::InversePoint(real lat, unsigned outmask) const {
+    invpoint p;
+    p.psi = _ell.IsometricLatitude(lat);
+    p.psir = p.psi * Math::degree();
+    p.shr = sinh(p.psir);
+    p.gdr = atan(p.shr);
+    p.chr = outmask & AREA ? cosh(p.psir) : Math::NaN();
+    p.lat = _exact && _cR.empty() && (outmask & DISTANCE) ?
+      _ell.InverseIsometricLatitude(p.psi) : Math::NaN();
+    return p;
+  }
+
+  void Rhumb::GenInverse(real lon1, const invpoint& p1,
+                         real lon2, const invpoint& p2, unsigned outmask,
                          real& s12, real& azi12, real& S12) const {
     real
       lon12 = Math::AngDiff(lon1, lon2),
-      psi1 = _ell.IsometricLatitude(lat1),
-      psi2 = _ell.IsometricLatitude(lat2),
-      psi12 = psi2 - psi1,
+      psi12 = p2.psi - p1.psi,
       h = hypot(lon12, psi12);
     if (outmask & AZIMUTH)
-      azi12 = Math::atan2d(lon12, psi12);
+      azi12 = Math::atan2dInline(lon12, psi12);
     if (outmask & DISTANCE) {
-      real dmudpsi = DIsometricToRectifying(psi2, psi1);
+      real dmudpsi = DIsometricToRectifying(p2, p1);
       s12 = h * dmudpsi * _ell.QuarterMeridian() / Math::qd;
     }
     if (outmask & AREA)
-      S12 = _c2 * lon12 *
-        MeanSinXi(psi2 * Math::degree(), psi1 * Math::degree());
+      S12 = _c2 * lon12 * MeanSinXi(p2, p1);
+  }
+
+  void Rhumb::GenInverse(real lat1, real lon1, real lat2, real lon2,
+                         unsigned outmask,
+                         real& s12, real& azi12, real& S12) const {
+    GenInverse(lon1, InversePoint(lat1, outmask),
+               lon2, InversePoint(lat2, outmask), outmask, s12, azi12, S12);
+  }
+
+  void Rhumb::InverseBatch(size_t n,
+                           const real lat1[], const real lon1[],
+                           const real lat2[], const real lon2[],
+                           unsigned outmask,
+                           real s12[], real azi12[], real S12[]) const {
+    if (!s12) outmask &= ~DISTANCE;
+    if (!azi12) outmask &= ~AZIMUTH;
+    if (!S12) outmask &= ~AREA;
+    real s12x, azi12x, S12x;
+    // When the problems form a chain (as they do for the edges of a polygon),
+    // point 1 of one problem is point 2 of the previous one; reuse its
+    // invpoint in this case.  The test is bitwise so that the results are
+    // unchanged.
+    invpoint p1, p2;
+    for (size_t i = 0; i < n; ++i) {
+      if (i > 0 && lat1[i] == lat2[i - 1] &&
+          signbit(lat1[i]) == signbit(lat2[i - 1]))
+        p1 = p2;
+      else
+        p1 = InversePoint(lat1[i], outmask);
+      p2 = InversePoint(lat2[i], outmask);
+      GenInverse(lon1[i], p1, lon2[i], p2, outmask, s12x, azi12x, S12x);
+      if (outmask & DISTANCE) s12[i] = s12x;
+      if (outmask & AZIMUTH) azi12[i] = azi12x;
+      if (outmask & AREA) S12[i] = S12x;
+    }
+  }
+
+  void Rhumb::InverseOrigin::InverseBatch(size_t n,
+                                          const real lat2[],
+                                          const real lon2[],
+                                          unsigned outmask, real s12[],
+                                          real azi12[], real S12[]) const {
+    if (!s12) outmask &= ~DISTANCE;
+    if (!azi12) outmask &= ~AZIMUTH;
+    if (!S12) outmask &= ~AREA;
+    real s12x, azi12x, S12x;
+    for (size_t i = 0; i < n; ++i) {
+      _rh->GenInverse(_lon1, _p1, lon2[i], _rh->InversePoint(lat2[i], outmask),
+                      outmask, s12x, azi12x, S12x);
+      if (outmask & DISTANCE) s12[i] = s12x;
+      if (outmask & AZIMUTH) azi12[i] = azi12x;
+      if (outmask & AREA) S12[i] = S12x;
+    }
   }
 
   RhumbLine Rhumb::Line(real lat1, real lon1, real azi12) const
@@ -178,6 +290,24 @@ namespace GeographicLib {
                         real& lat2, real& lon2, real& S12) const
   { Line(lat1, lon1, azi12).GenPosition(s12, outmask, lat2, lon2, S12); }
 
+  void Rhumb::DirectBatch(size_t n,
+                          const real lat1[], const real lon1[],
+                          const real azi12[], const real s12[],
+                          unsigned outmask,
+                          real lat2[], real lon2[], real S12[]) const {
+    if (!lat2) outmask &= ~LATITUDE;
+    if (!lon2) outmask &= ~LONGITUDE;
+    if (!S12) outmask &= ~AREA;
+    real lat2x, lon2x, S12x;
+    for (size_t i = 0; i < n; ++i) {
+      GenDirect(lat1[i], lon1[i], azi12[i], s12[i], outmask,
+                lat2x, lon2x, S12x);
+      if (outmask & LATITUDE) lat2[i] = lat2x;
+      if (outmask & LONGITUDE) lon2[i] = lon2x;
+      if (outmask & AREA) S12[i] = S12x;
+    }
+  }
+
   Math::real Rhumb::DE(real x, real y) const {
     const EllipticFunction& ei = _ell._ell;
     real d = x - y;
@@ -304,28 +434,47 @@ namespace GeographicLib {
                             _ell.RectifyingToConformalCoeffs(), tm_maxord);
   }
 
-  Math::real Rhumb::DIsometricToRectifying(real psix, real psiy) const {
-    if (_exact) {
-      real
-        latx = _ell.InverseIsometricLatitude(psix),
-        laty = _ell.InverseIsometricLatitude(psiy);
-      return DRectifying(latx, laty) / DIsometric(latx, laty);
+  Math::real Rhumb::DIsometricToRectifying(const invpoint& x,
+                                           const invpoint& y) const {
+    // Dgd(psix, psiy) with the sinh's precomputed
+    if (!_cR.empty())
+      return (1 + SinCosSeries(true, x.gdr, y.gdr,
+                               _cR.data(), int(_cR.size()) - 1))
+        * (Datan(x.shr, y.shr) * Dsinh(x.psir, y.psir));
+    else if (_exact)
+      return DRectifying(x.lat, y.lat) / DIsometric(x.lat, y.lat);
+    else
+      return DConformalToRectifying(x.gdr, y.gdr) *
+        (Datan(x.shr, y.shr) * Dsinh(x.psir, y.psir));
+  }
+
+  Rhumb::dirpoint Rhumb::DirectPoint(real mu) const {
+    dirpoint p;
+    p.mur = mu * Math::degree();
+    if (!_rC.empty()) {
+      // As InverseRectifyingLatitude, keeping the conformal latitude
+      real chi = (p.mur + DST::sineval(sin(p.mur), cos(p.mur),
+                                       _rC.data(), int(_rC.size()) - 1))
+        / Math::degree();
+      p.lat = fabs(mu) == Math::qd ? _ell.InverseRectifyingLatitude(mu) :
+        _ell.InverseConformalLatitude(chi);
+      p.t = Math::tand(chi);
     } else {
-      psix *= Math::degree();
-      psiy *= Math::degree();
-      return DConformalToRectifying(gd(psix), gd(psiy)) * Dgd(psix, psiy);
+      p.lat = _ell.InverseRectifyingLatitude(mu);
+      p.t = Math::taupf(Math::tand(p.lat), _ell._es);
     }
+    return p;
   }
 
-  Math::real Rhumb::DRectifyingToIsometric(real mux, real muy) const {
-    real
-      latx = _ell.InverseRectifyingLatitude(mux/Math::degree()),
-      laty = _ell.InverseRectifyingLatitude(muy/Math::degree());
+  Math::real Rhumb::DRectifyingToIsometric(const dirpoint& x,
+                                           const dirpoint& y) const {
+    if (!_rC.empty())
+      return Dgdinv(x.t, y.t) *
+        (1 + SinCosSeries(true, x.mur, y.mur, _rC.data(),
+                          int(_rC.size()) - 1));
     return _exact ?
-      DIsometric(latx, laty) / DRectifying(latx, laty) :
-      Dgdinv(Math::taupf(Math::tand(latx), _ell._es),
-             Math::taupf(Math::tand(laty), _ell._es)) *
-      DRectifyingToConformal(mux, muy);
+      DIsometric(x.lat, y.lat) / DRectifying(x.lat, y.lat) :
+      Dgdinv(x.t, y.t) * DRectifyingToConformal(x.mur, y.mur);
   }
 
   Math::real Rhumb::MeanSinXi(real psix, real psiy) const {
@@ -333,18 +482,30 @@ namespace GeographicLib {
       + SinCosSeries(false, gd(psix), gd(psiy), _rR, maxpow_) * Dgd(psix, psiy);
   }
 
+  Math::real Rhumb::MeanSinXi(const invpoint& x, const invpoint& y) const {
+    // As MeanSinXi(x.psir, y.psir) with the hyperbolic functions precomputed
+    return Dlog(x.chr, y.chr) * Dcosh(x.psir, y.psir)
+      + SinCosSeries(false, x.gdr, y.gdr, _rR, maxpow_) *
+      (Datan(x.shr, y.shr) * Dsinh(x.psir, y.psir));
+  }
+
   RhumbLine::RhumbLine(const Rhumb& rh, real lat1, real lon1, real azi12)
     : _rh(rh)
     , _lat1(Math::LatFix(lat1))
     , _lon1(lon1)
-    , _azi12(Math::AngNormalize(azi12))
+    , _azi12(Math::AngNormalizeInline(azi12))
   {
     real alp12 = _azi12 * Math::degree();
     _salp =      _azi12  == -Math::hd ? 0 : sin(alp12);
     _calp = fabs(_azi12) ==  Math::qd ? 0 : cos(alp12);
-    _mu1 = _rh._ell.RectifyingLatitude(lat1);
+    _mu1 = _rh.RectifyingLatitude(lat1);
     _psi1 = _rh._ell.IsometricLatitude(lat1);
     _r1 = _rh._ell.CircleRadius(lat1);
+    // The quantities for point 1 for DRectifyingToIsometric come directly
+    // from lat1 instead of from _mu1 (via DirectPoint).
+    _p1.mur = _mu1 * Math::degree();
+    _p1.lat = _lat1;
+    _p1.t = Math::taupf(Math::tand(_lat1), _rh._ell._es);
   }
 
   void RhumbLine::GenPosition(real s12, unsigned outmask,
@@ -355,9 +516,9 @@ namespace GeographicLib {
     real psi2, lat2x, lon2x;
     if (fabs(mu2) <= Math::qd) {
       if (_calp != 0) {
-        lat2x = _rh._ell.InverseRectifyingLatitude(mu2);
-        real psi12 = _rh.DRectifyingToIsometric(  mu2 * Math::degree(),
-                                                 _mu1 * Math::degree()) * mu12;
+        Rhumb::dirpoint p2 = _rh.DirectPoint(mu2);
+        lat2x = p2.lat;
+        real psi12 = _rh.DRectifyingToIsometric(p2, _p1) * mu12;
         lon2x = _salp * psi12 / _calp;
         psi2 = _psi1 + psi12;
       } else {
@@ -369,13 +530,13 @@ namespace GeographicLib {
         S12 = _rh._c2 * lon2x *
           _rh.MeanSinXi(_psi1 * Math::degree(), psi2 * Math::degree());
       lon2x = outmask & LONG_UNROLL ? _lon1 + lon2x :
-        Math::AngNormalize(Math::AngNormalize(_lon1) + lon2x);
+        Math::AngNormalizeInline(Math::AngNormalizeInline(_lon1) + lon2x);
     } else {
       // Reduce to the interval [-180, 180)
-      mu2 = Math::AngNormalize(mu2);
+      mu2 = Math::AngNormalizeInline(mu2);
       // Deal with points on the anti-meridian
-      if (fabs(mu2) > Math::qd) mu2 = Math::AngNormalize(Math::hd - mu2);
-      lat2x = _rh._ell.InverseRectifyingLatitude(mu2);
+      if (fabs(mu2) > Math::qd) mu2 = Math::AngNormalizeInline(Math::hd - mu2);
+      lat2x = _rh.InverseRectifyingLatitude(mu2);
       lon2x = Math::NaN();
       if (outmask & AREA)
         S12 = Math::NaN();
@@ -384,4 +545,18 @@ namespace GeographicLib {
     if (outmask & LONGITUDE) lon2 = lon2x;
   }
 
+  void RhumbLine::PositionBatch(size_t n, const real s12[], unsigned outmask,
+                                real lat2[], real lon2[], real S12[]) const {
+    if (!lat2) outmask &= ~LATITUDE;
+    if (!lon2) outmask &= ~LONGITUDE;
+    if (!S12) outmask &= ~AREA;
+    real lat2x, lon2x, S12x;
+    for (size_t i = 0; i < n; ++i) {
+      GenPosition(s12[i], outmask, lat2x, lon2x, S12x);
+      if (outmask & LATITUDE) lat2[i] = lat2x;
+      if (outmask & LONGITUDE) lon2[i] = lon2x;
+      if (outmask & AREA) S12[i] = S12x;
+    }
+  }
+
 } // namespace GeographicLib
@@ -0,0 +1,169 @@
+/**
+ * \file SpatialJoin.cpp
+ * \brief Implementation for GeographicLib::SpatialJoin class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#include <GeographicLib/SpatialJoin.hpp>
+#include <GeographicLib/GeodesicBatchExecutor.hpp>
+#include <algorithm>
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  const size_t SpatialJoin::npos;
+
+  SpatialJoin::SpatialJoin(const Geodesic& geod, size_t npolygons,
+                           const size_t polyoffsets[],
+                           const size_t ringoffsets[],
+                           const real lat[], const real lon[],
+                           unsigned nthreads)
+    : _nlat(1)
+    , _nlon(1)
+  {
+    GeodesicBatchExecutor exec(nthreads);
+    size_t r0 = npolygons ? polyoffsets[0] : 0,
+      nrings = npolygons ? polyoffsets[npolygons] - r0 : 0;
+    // Build the index for each ring on a single thread and handle the
+    // rings in parallel.
+    _rings.resize(nrings);
+    exec.ForEach(nrings, [&](size_t i0, size_t i1) -> void {
+      for (size_t i = i0; i < i1; ++i) {
+        size_t v0 = ringoffsets[r0 + i], v1 = ringoffsets[r0 + i + 1];
+        _rings[i] = make_shared<const PointInPolygon>
+          (geod, v1 - v0, lat + v0, lon + v0, 1U);
+      }
+    });
+    // The bounding box of each polygon is the union of those of its rings.
+    _boxes.resize(npolygons);
+    vector<real> hlat, hlon;
+    for (size_t j = 0; j < npolygons; ++j) {
+      Box& b = _boxes[j];
+      b.ring0 = polyoffsets[j] - r0; b.ring1 = polyoffsets[j + 1] - r0;
+      b.latmin = b.latmax = b.lonmin = b.dlon = Math::NaN();
+      real west = 0, east = 0;
+      for (size_t i = b.ring0; i < b.ring1; ++i) {
+        real latmin, latmax, lonmin, lonmax;
+        _rings[i]->BoundingBox(latmin, latmax, lonmin, lonmax);
+        if (isnan(latmin)) continue;
+        if (isnan(b.latmin)) {
+          b.latmin = latmin; b.latmax = latmax; b.lonmin = lonmin;
+          west = 0; east = lonmax - lonmin;
+        } else {
+          b.latmin = fmin(b.latmin, latmin); b.latmax = fmax(b.latmax, latmax);
+          real d = Math::AngDiff(b.lonmin, lonmin);
+          west = fmin(west, d); east = fmax(east, d + (lonmax - lonmin));
+        }
+      }
+      if (isnan(b.latmin)) continue;
+      if (east - west >= Math::td) {
+        b.lonmin = -Math::hd; b.dlon = Math::td;
+      } else {
+        b.lonmin = Math::AngNormalize(b.lonmin + west); b.dlon = east - west;
+      }
+      hlat.push_back(b.latmax - b.latmin); hlon.push_back(b.dlon);
+    }
+    // Cells the size of the median box, with at most about 16 cells per
+    // polygon
+    if (!hlat.empty()) {
+      nth_element(hlat.begin(), hlat.begin() + hlat.size()/2, hlat.end());
+      nth_element(hlon.begin(), hlon.begin() + hlon.size()/2, hlon.end());
+      const int maxlat = 4096;
+      real mlat = hlat[hlat.size()/2], mlon = hlon[hlon.size()/2];
+      _nlat = mlat > Math::hd / maxlat ? int(Math::hd / mlat) : maxlat;
+      _nlon = mlon > Math::td / (2 * maxlat) ?
+        int(Math::td / mlon) : 2 * maxlat;
+      _nlat = max(1, _nlat); _nlon = max(1, _nlon);
+      size_t maxcells = 16 * hlat.size() + 1024;
+      while (size_t(_nlat) * size_t(_nlon) > maxcells) {
+        if (2 * _nlat > _nlon)
+          _nlat = (_nlat + 1) / 2;
+        else
+          _nlon = (_nlon + 1) / 2;
+      }
+    }
+    _dlat = Math::hd / real(_nlat); _dlon = Math::td / real(_nlon);
+    // List the polygons overlapping each cell, counting them first.
+    size_t ncells = NumCells();
+    _cellstart.assign(ncells + 1, 0);
+    for (int pass = 0; pass < 2; ++pass) {
+      vector<size_t> next;
+      if (pass == 1) {
+        for (size_t k = 0; k < ncells; ++k)
+          _cellstart[k + 1] += _cellstart[k];
+        _cellpolys.resize(_cellstart[ncells]);
+        next.assign(_cellstart.begin(), _cellstart.end() - 1);
+      }
+      for (size_t j = 0; j < npolygons; ++j) {
+        const Box& b = _boxes[j];
+        if (isnan(b.latmin)) continue;
+        int i0 = LatIndex(b.latmin), i1 = LatIndex(b.latmax);
+        real
+          jw = floor((b.lonmin + Math::hd) / _dlon),
+          je = floor((b.lonmin + b.dlon + Math::hd) / _dlon);
+        int nj = int(fmin(real(_nlon), je - jw + 1));
+        for (int i = i0; i <= i1; ++i)
+          for (int t = 0; t < nj; ++t) {
+            size_t k = size_t(i) * size_t(_nlon) +
+              (size_t(jw) + size_t(t)) % size_t(_nlon);
+            if (pass == 0)
+              ++_cellstart[k + 1];
+            else
+              _cellpolys[next[k]++] = j;
+          }
+      }
+    }
+  }
+
+  int SpatialJoin::LatIndex(real lat) const {
+    real x = floor((lat + Math::qd) / _dlat);
+    return !(x >= 0) ? 0 : (x >= _nlat ? _nlat - 1 : int(x));
+  }
+
+  int SpatialJoin::LonIndex(real lon) const {
+    real x = floor((Math::AngNormalize(lon) + Math::hd) / _dlon);
+    // lon = 180 is in the same cell as lon = -180
+    return !(x >= 0) ? 0 : (x >= _nlon ? 0 : int(x));
+  }
+
+  size_t SpatialJoin::FindInCell(size_t k, real lat, real lon) const {
+    for (size_t p = _cellstart[k]; p < _cellstart[k + 1]; ++p) {
+      size_t j = _cellpolys[p];
+      const Box& b = _boxes[j];
+      if (!(lat >= b.latmin && lat <= b.latmax)) continue;
+      real d = Math::AngDiff(b.lonmin, lon);
+      if (d < 0) d += Math::td;
+      if (!(d <= b.dlon)) continue;
+      bool inside = false;
+      for (size_t i = b.ring0; i < b.ring1; ++i)
+        if (_rings[i]->Contains(lat, lon)) inside = !inside;
+      if (inside) return j;
+    }
+    return npos;
+  }
+
+  void SpatialJoin::FindBatch(size_t n, const real lat[], const real lon[],
+                              size_t id[], unsigned nthreads) const {
+    // Sort the points by cell with a counting sort.
+    size_t ncells = NumCells();
+    vector<size_t> cell(n), start(ncells + 1, 0), perm(n);
+    for (size_t i = 0; i < n; ++i) {
+      cell[i] = Cell(lat[i], lon[i]);
+      ++start[cell[i] + 1];
+    }
+    for (size_t k = 0; k < ncells; ++k) start[k + 1] += start[k];
+    for (size_t i = 0; i < n; ++i) perm[start[cell[i]]++] = i;
+    GeodesicBatchExecutor exec(nthreads);
+    exec.ForEach(n, [&](size_t i0, size_t i1) -> void {
+      for (size_t k = i0; k < i1; ++k) {
+        size_t i = perm[k];
+        id[i] = FindInCell(cell[i], lat[i], lon[i]);
+      }
+    });
+  }
+
+} // namespace GeographicLib
@@ -0,0 +1,165 @@
+/**
+ * \file SphericalAnalysis.cpp
+ * \brief Implementation for GeographicLib::SphericalAnalysis class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#include <GeographicLib/SphericalAnalysis.hpp>
+#include <GeographicLib/GeodesicBatchExecutor.hpp>
+#include <GeographicLib/Utility.hpp>
+#include <complex>
+#include <limits>
+#include "kissfft.hh"
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  void SphericalAnalysis::Latitudes(grid g, int nlat,
+                                    vector<real>& lat, vector<real>& w) {
+    if (nlat < 1)
+      throw GeographicErr("Number of latitudes must be positive");
+    lat.resize(nlat); w.resize(nlat);
+    if (g == GAUSS) {
+      // The nodes are the zeros of the Legendre polynomial P[nlat](x) where
+      // x = sin(lat); these are found by Newton's method starting from the
+      // asymptotic approximation.  Only the northern half is computed and the
+      // rest follow by symmetry.
+      const real tol = numeric_limits<real>::epsilon();
+      for (int i = 0; i < (nlat + 1) / 2; ++i) {
+        real x = cos(Math::pi() * (i + real(0.75)) / (nlat + real(0.5))),
+          dp = 0;
+        for (int it = 0; it < 100; ++it) {
+          real p0 = 1, p1 = x;  // P[n-1](x), P[n](x)
+          for (int n = 1; n < nlat; ++n) {
+            real p2 = ((2 * n + 1) * x * p1 - n * p0) / (n + 1);
+            p0 = p1; p1 = p2;
+          }
+          dp = nlat * (x * p1 - p0) / ((x - 1) * (x + 1));
+          real dx = p1 / dp;
+          x -= dx;
+          if (!(fabs(dx) > tol * fabs(x))) break;
+        }
+        if (2 * i + 1 == nlat) x = 0;
+        real u = sqrt((1 - x) * (1 + x));
+        lat[i] = Math::atan2d(x, u); lat[nlat - 1 - i] = -lat[i];
+        w[i] = w[nlat - 1 - i] = 2 / (Math::sq(u * dp));
+      }
+    } else {
+      // Fejer's first rule in x = cos(theta) where theta is the colatitude
+      for (int i = 0; i < nlat; ++i) {
+        real theta = Math::pi() * (2 * i + 1) / (2 * nlat), s = 0;
+        for (int k = 1; 2 * k <= nlat; ++k)
+          s += cos(2 * k * theta) / (4 * Math::sq(real(k)) - 1);
+        lat[i] = Math::qd - real(Math::hd) * (2 * i + 1) / (2 * nlat);
+        w[i] = 2 * (1 - 2 * s) / nlat;
+      }
+    }
+  }
+
+  void SphericalAnalysis::Analyze(grid g, int nlat, int nlon, real lon0,
+                                  const real f[], int N, int M,
+                                  vector<real>& C, vector<real>& S,
+                                  unsigned norm, unsigned nthreads) {
+    typedef complex<real> cpx;
+    if (!(N >= M && M >= 0))
+      throw GeographicErr("Bad requested degree and order " +
+                          Utility::str(N) + " " + Utility::str(M));
+    if (N > MaxDegree(g, nlat))
+      throw GeographicErr("Degree " + Utility::str(N) +
+                          " is too large for " + Utility::str(nlat) +
+                          " latitudes");
+    if (!(2 * M < nlon))
+      throw GeographicErr("Order " + Utility::str(M) +
+                          " is too large for " + Utility::str(nlon) +
+                          " longitudes");
+    vector<real> lat, w;
+    Latitudes(g, nlat, lat, w);
+    size_t nr = size_t(nlat), nm = size_t(M + 1);
+    // The Legendre functions are scaled by 2^-bits to avoid underflow and
+    // the scaling is undone when the exponent returns to 0.
+    const int bits = 256;
+    const real big = ldexp(real(1), bits), small = 1 / big;
+    vector<real> t(nr), u(nr);
+    // For each row and order, the Fourier coefficient (multiplied by the
+    // weights) and the sectoral Legendre function as a mantissa and exponent.
+    vector<cpx> F(nr * nm);
+    vector<real> pmm(nr * nm);
+    vector<int> emm(nr * nm);
+    kissfft<real> fft(size_t(nlon), false);
+    GeodesicBatchExecutor exec(nthreads, 1);
+    exec.ForEach(nr, [&](size_t i0, size_t i1) -> void {
+      vector<cpx> X(nlon), Y(nlon);
+      for (size_t i = i0; i < i1; ++i) {
+        Math::sincosd(lat[i], t[i], u[i]);
+        for (int j = 0; j < nlon; ++j)
+          X[j] = cpx(f[i * nlon + j], 0);
+        fft.transform(X.data(), Y.data());
+        // C[n,m] = sum(w * P[n,m] * Re(F[m])) / (2*nlon) and
+        // S[n,m] = - sum(w * P[n,m] * Im(F[m])) / (2*nlon) where
+        // F[m] = sum(f[j] * exp(-i*m*lon[j])).
+        real mult = w[i] / (2 * nlon), p = 1;
+        int e = 0;
+        for (int m = 0; m <= M; ++m) {
+          real sl, cl;
+          Math::sincosd(Math::AngNormalize(m * lon0), sl, cl);
+          F[i * nm + m] = mult * cpx(cl, -sl) * Y[m];
+          if (m == 1)
+            p *= sqrt(real(3)) * u[i];
+          else if (m > 1)
+            p *= sqrt((2 * m + 1) / real(2 * m)) * u[i];
+          if (fabs(p) < small) { p *= big; e -= bits; }
+          pmm[i * nm + m] = p; emm[i * nm + m] = e;
+        }
+      }
+    });
+    C.assign(SphericalEngine::coeff::Csize(N, M), 0);
+    S.assign(SphericalEngine::coeff::Ssize(N, M), 0);
+    // Each order is a contiguous column of C and S; so the orders can be
+    // handled concurrently.
+    exec.ForEach(nm, [&](size_t m0, size_t m1) -> void {
+      vector<real> a(N + 1), b(N + 1);
+      for (int m = int(m0); m < int(m1); ++m) {
+        // Recurrence P[n,m] = a[n] * t * P[n-1,m] - b[n] * P[n-2,m]
+        for (int n = m + 1; n <= N; ++n) {
+          a[n] = sqrt(real(2 * n - 1) * (2 * n + 1) /
+                      (real(n - m) * (n + m)));
+          b[n] = sqrt(real(2 * n + 1) * (n + m - 1) * (n - m - 1) /
+                      (real(n - m) * (n + m) * (2 * n - 3)));
+        }
+        // The index of (m, m) in C and S
+        int k = m * N - m * (m - 1) / 2 + m;
+        real* c = C.data() + k;
+        real* s = m ? S.data() + (k - (N + 1)) : nullptr;
+        for (size_t i = 0; i < nr; ++i) {
+          cpx fm = F[i * nm + m];
+          real p2 = 0, p1 = pmm[i * nm + m], ti = t[i];
+          int e = emm[i * nm + m];
+          for (int n = m; n <= N; ++n) {
+            if (n > m) {
+              real p = a[n] * ti * p1 - b[n] * p2;
+              p2 = p1; p1 = p;
+              if (e < 0 && fabs(p1) > big) {
+                p1 *= small; p2 *= small; e += bits;
+              }
+            }
+            real v = e ? ldexp(p1, e) : p1;
+            c[n - m] += v * fm.real();
+            if (m) s[n - m] -= v * fm.imag();
+          }
+        }
+        if (norm == SphericalHarmonic::SCHMIDT) {
+          for (int n = m; n <= N; ++n) {
+            real r = sqrt(real(2 * n + 1));
+            c[n - m] *= r;
+            if (m) s[n - m] *= r;
+          }
+        }
+      }
+    });
+  }
+
+} // namespace GeographicLib
@@ -128,11 +128,59 @@
  * Finally, given the derivatives of <tt>V</tt>, we can compute the components
  * of the gradient in spherical coordinates and transform the result into
  * cartesian coordinates.
+ *
+ * The second derivatives (computed by Hessian) follow the same pattern.
+ * The inner sums are differentiated with respect to <tt>t</tt> instead of
+ * <tt>theta</tt>; since <tt>alpha[k]</tt> is proportional to <tt>t</tt> and
+ * <tt>beta[k]</tt> is independent of <tt>t</tt>, this gives, with a dot
+ * denoting d/dt,\verbatim
+    ydot[k] = alpha[k] * ydot[k+1] + beta[k+1] * ydot[k+2]
+              + alpha[k]/t * y[k+1]
+    yddot[k] = alpha[k] * yddot[k+1] + beta[k+1] * yddot[k+2]
+              + 2 * alpha[k]/t * ydot[k+1]
+\endverbatim
+ * and the second derivative wrt <tt>r</tt> is found by multiplying
+ * <tt>C[n,m]</tt> by <tt>(n+1)*(n+2)</tt> and the sum by <tt>1/r^2</tt>.
+ * The components of the Hessian in spherical coordinates involve
+ * <tt>1/u^2 * d^2V/dlambda^2</tt>, etc.; the terms singular in
+ * <tt>u</tt> are combined for each <tt>m</tt> with <tt>P[m,m](t) = const
+ * * u^m</tt> before the outer sum, e.g.,\verbatim
+   1/u^2 * d^2/dlambda^2 + t/u * d/dtheta
+     -> -t * Sdot[m] + (m*(1-m)/u^2 - m) * S[m]
+   1/u * d^2/dtheta dlambda - t/u^2 * d/dlambda
+     -> m * (-Sdot[m] + (m-1)*t/u^2 * S[m]) [swapping sine and cosine]
+   d^2/dtheta^2
+     -> u^2 * Sddot[m] - (2*m+1) * t * Sdot[m] + (m*(m-1)*t^2/u^2 - m) * S[m]
+\endverbatim
+ * where the <tt>1/u^2</tt> factors are cancelled by <tt>P[m,m](t)</tt> for
+ * <tt>m > 1</tt>.
  **********************************************************************/
 
 #include <GeographicLib/SphericalEngine.hpp>
 #include <GeographicLib/CircularEngine.hpp>
+#include <GeographicLib/CPUDispatch.hpp>
+#include <GeographicLib/GeodesicBatchExecutor.hpp>
+#include <GeographicLib/Trace.hpp>
 #include <GeographicLib/Utility.hpp>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+
+// For memory mapping coefficient files
+#if defined(_WIN32)
+#  define WIN32_LEAN_AND_MEAN
+#  define NOMINMAX
+#  include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#  define GEOGRAPHICLIB_SPHERICAL_POSIX 1
+#endif
 
 #if defined(_MSC_VER)
 // Squelch warnings about constant conditional expressions and potentially
@@ -140,13 +188,44 @@
 #  pragma warning (disable: 4127 4701)
 #endif
 
+// Prefetch memory which will be read soon (a hint which may be ignored)
+#if defined(__GNUC__)
+#  define GEOGRAPHICLIB_PREFETCH(p) __builtin_prefetch(p)
+#else
+#  define GEOGRAPHICLIB_PREFETCH(p) ((void)(p))
+#endif
+
 namespace GeographicLib {
 
   using namespace std;
 
-  vector<Math::real>& SphericalEngine::sqrttable() {
-    static vector<real> sqrttable(0);
-    return sqrttable;
+  namespace {
+    // The table of square roots is published as an immutable snapshot.
+    // RootTable replaces a snapshot which is too small by a larger one (which
+    // is then never modified) and the old snapshots are retained so that
+    // pointers to them obtained by other threads remain valid.  Thus readers
+    // need only an atomic load while growing the table requires a lock.
+    struct roottable {
+      int size;
+      unique_ptr<Math::real[]> root;
+    };
+    atomic<const roottable*>& rootcurrent() {
+      static atomic<const roottable*> current(nullptr);
+      return current;
+    }
+    mutex& rootmutex() {
+      static mutex m;
+      return m;
+    }
+    vector<unique_ptr<roottable>>& roothistory() {
+      static vector<unique_ptr<roottable>> history;
+      return history;
+    }
+  }
+
+  const Math::real* SphericalEngine::sqrttable() {
+    const roottable* t = rootcurrent().load(memory_order_acquire);
+    return t ? t->root.get() : nullptr;
   }
 
   template<bool gradp, SphericalEngine::normalization norm, int L>
@@ -156,6 +235,7 @@ namespace GeographicLib {
     {
     static_assert(L > 0, "L must be positive");
     static_assert(norm == FULL || norm == SCHMIDT, "Unknown normalization");
+    GEOGRAPHICLIB_TRACE_SPAN("SphericalEngine::Value");
     int N = c[0].nmx(), M = c[0].mmx();
 
     real
@@ -179,8 +259,775 @@ namespace GeographicLib {
     real vtc = 0, vtc2 = 0, vts = 0, vts2 = 0;   // vt[N + 1], vt[N + 2]
     real vlc = 0, vlc2 = 0, vls = 0, vls2 = 0;   // vl[N + 1], vl[N + 2]
     int k[L];
-    const vector<real>& root( sqrttable() );
-    for (int m = M; m >= 0; --m) {   // m = M .. 0
+    const real* root( sqrttable() );
+    for (int m = M; m >= 0; --m) {   // m = M .. 0
+      // Initialize inner sum
+      real
+        wc  = 0, wc2  = 0, ws  = 0, ws2  = 0, // w [N - m + 1], w [N - m + 2]
+        wrc = 0, wrc2 = 0, wrs = 0, wrs2 = 0, // wr[N - m + 1], wr[N - m + 2]
+        wtc = 0, wtc2 = 0, wts = 0, wts2 = 0; // wt[N - m + 1], wt[N - m + 2]
+      for (int l = 0; l < L; ++l)
+        k[l] = c[l].index(N, m) + 1;
+      for (int n = N; n >= m; --n) {             // n = N .. m; l = N - m .. 0
+        real w, A, Ax, B, R;    // alpha[l], beta[l + 1]
+        switch (norm) {
+        case FULL:
+          w = root[2 * n + 1] / (root[n - m + 1] * root[n + m + 1]);
+          Ax = q * w * root[2 * n + 3];
+          A = t * Ax;
+          B = - q2 * root[2 * n + 5] /
+            (w * root[n - m + 2] * root[n + m + 2]);
+          break;
+        case SCHMIDT:
+          w = root[n - m + 1] * root[n + m + 1];
+          Ax = q * (2 * n + 1) / w;
+          A = t * Ax;
+          B = - q2 * w / (root[n - m + 2] * root[n + m + 2]);
+          break;
+        default: break;       // To suppress warning message from Visual Studio
+        }
+        R = c[0].Cv(--k[0]);
+        for (int l = 1; l < L; ++l)
+          R += c[l].Cv(--k[l], n, m, f[l]);
+        R *= scale();
+        w = A * wc + B * wc2 + R; wc2 = wc; wc = w;
+        if (gradp) {
+          w = A * wrc + B * wrc2 + (n + 1) * R; wrc2 = wrc; wrc = w;
+          w = A * wtc + B * wtc2 -  u*Ax * wc2; wtc2 = wtc; wtc = w;
+        }
+        if (m) {
+          R = c[0].Sv(k[0]);
+          for (int l = 1; l < L; ++l)
+            R += c[l].Sv(k[l], n, m, f[l]);
+          R *= scale();
+          w = A * ws + B * ws2 + R; ws2 = ws; ws = w;
+          if (gradp) {
+            w = A * wrs + B * wrs2 + (n + 1) * R; wrs2 = wrs; wrs = w;
+            w = A * wts + B * wts2 -  u*Ax * ws2; wts2 = wts; wts = w;
+          }
+        }
+      }
+      // Now Sc[m] = wc, Ss[m] = ws
+      // Sc'[m] = wtc, Ss'[m] = wtc
+      if (m) {
+        real v, A, B;           // alpha[m], beta[m + 1]
+        switch (norm) {
+        case FULL:
+          v = root[2] * root[2 * m + 3] / root[m + 1];
+          A = cl * v * uq;
+          B = - v * root[2 * m + 5] / (root[8] * root[m + 2]) * uq2;
+          break;
+        case SCHMIDT:
+          v = root[2] * root[2 * m + 1] / root[m + 1];
+          A = cl * v * uq;
+          B = - v * root[2 * m + 3] / (root[8] * root[m + 2]) * uq2;
+          break;
+        default: break;       // To suppress warning message from Visual Studio
+        }
+        v = A * vc  + B * vc2  +  wc ; vc2  = vc ; vc  = v;
+        v = A * vs  + B * vs2  +  ws ; vs2  = vs ; vs  = v;
+        if (gradp) {
+          // Include the terms Sc[m] * P'[m,m](t) and Ss[m] * P'[m,m](t)
+          wtc += m * tu * wc; wts += m * tu * ws;
+          v = A * vrc + B * vrc2 +  wrc; vrc2 = vrc; vrc = v;
+          v = A * vrs + B * vrs2 +  wrs; vrs2 = vrs; vrs = v;
+          v = A * vtc + B * vtc2 +  wtc; vtc2 = vtc; vtc = v;
+          v = A * vts + B * vts2 +  wts; vts2 = vts; vts = v;
+          v = A * vlc + B * vlc2 + m*ws; vlc2 = vlc; vlc = v;
+          v = A * vls + B * vls2 - m*wc; vls2 = vls; vls = v;
+        }
+      } else {
+        real A, B, qs;
+        switch (norm) {
+        case FULL:
+          A = root[3] * uq;       // F[1]/(q*cl) or F[1]/(q*sl)
+          B = - root[15]/2 * uq2; // beta[1]/q
+          break;
+        case SCHMIDT:
+          A = uq;
+          B = - root[3]/2 * uq2;
+          break;
+        default: break;       // To suppress warning message from Visual Studio
+        }
+        qs = q / scale();
+        vc = qs * (wc + A * (cl * vc + sl * vs ) + B * vc2);
+        if (gradp) {
+          qs /= r;
+          // The components of the gradient in spherical coordinates are
+          // r: dV/dr
+          // theta: 1/r * dV/dtheta
+          // lambda: 1/(r*u) * dV/dlambda
+          vrc =   - qs * (wrc + A * (cl * vrc + sl * vrs) + B * vrc2);
+          vtc =     qs * (wtc + A * (cl * vtc + sl * vts) + B * vtc2);
+          vlc = qs / u * (      A * (cl * vlc + sl * vls) + B * vlc2);
+        }
+      }
+    }
+
+    if (gradp) {
+      // Rotate into cartesian (geocentric) coordinates
+      gradx = cl * (u * vrc + t * vtc) - sl * vlc;
+      grady = sl * (u * vrc + t * vtc) + cl * vlc;
+      gradz =       t * vrc - u * vtc            ;
+    }
+    return vc;
+  }
+
+  SphericalEngine::packedcoeff::packedcoeff(const coeff& c,
+                                            normalization norm, int nsingle)
+    : _nmx(c.nmx())
+    , _mmx(c.mmx())
+    , _nsingle(nsingle < 0 ? _nmx : min(nsingle, _nmx))
+  {
+    RootTable(_nmx);
+    const real* root( sqrttable() );
+    // The number of reals and floats in a 64-byte line
+    const size_t line = max(size_t(1), 64 / sizeof(real)),
+      fline = 64 / sizeof(float);
+    _col.resize(_mmx + 1);
+    _fcol.resize(_mmx + 1);
+    size_t n = 0, fn = 0;
+    for (int m = 0; m <= _mmx; ++m) {
+      _col[m] = n; _fcol[m] = fn;
+      // Round the length of each column up to a whole number of lines
+      n += (4 * size_t(max(0, _nsingle - m + 1)) + line - 1) / line * line;
+      fn += (4 * size_t(_nmx - max(m, _nsingle + 1) + 1) + fline - 1)
+        / fline * fline;
+    }
+    _data.resize(n + line);
+    if (fn) _fdata.resize(fn + fline);
+    // Offset the columns so that they start on a 64-byte boundary
+    uintptr_t addr = reinterpret_cast<uintptr_t>(_data.data()) / sizeof(real);
+    size_t off = (line - addr % line) % line;
+    addr = reinterpret_cast<uintptr_t>(_fdata.data()) / sizeof(float);
+    size_t foff = (fline - addr % fline) % fline;
+    for (int m = 0; m <= _mmx; ++m) {
+      _col[m] += off; _fcol[m] += foff;
+      real* p = _data.data() + _col[m];
+      float* fp = _fdata.data() + _fcol[m];
+      int k = c.index(m, m);
+      for (int n1 = m; n1 <= _nmx; ++n1, ++k) {
+        // These follow the expressions for A / (t * q) and - B / q^2 in Value
+        real w, a, b;
+        switch (norm) {
+        case FULL:
+          w = root[2 * n1 + 1] / (root[n1 - m + 1] * root[n1 + m + 1]);
+          a = w * root[2 * n1 + 3];
+          b = root[2 * n1 + 5] / (w * root[n1 - m + 2] * root[n1 + m + 2]);
+          break;
+        case SCHMIDT:
+        default:
+          w = root[n1 - m + 1] * root[n1 + m + 1];
+          a = (2 * n1 + 1) / w;
+          b = w / (root[n1 - m + 2] * root[n1 + m + 2]);
+          break;
+        }
+        real cv = c.Cv(k), sv = m ? c.Sv(k) : 0;
+        if (n1 <= _nsingle) {
+          p[0] = cv * scale(); p[1] = sv * scale(); p[2] = a; p[3] = b;
+          p += 4;
+        } else {
+          // The scale factor would underflow in a float; so ValuePacked
+          // applies it to these coefficients.
+          fp[0] = float(cv); fp[1] = float(sv); fp[2] = float(a);
+          fp[3] = float(b);
+          fp += 4;
+        }
+      }
+    }
+    if (MemoryPolicy::Replicate() && MemoryPolicy::Nodes() > 1) {
+      // This object serves the node where its records were placed (the node
+      // of this thread, unless the policy names a node).
+      int home = MemoryPolicy::Node() >= 0 ? MemoryPolicy::Node() :
+        MemoryPolicy::CurrentNode();
+      _replicas.resize(MemoryPolicy::Nodes());
+      for (int node = 0; node < MemoryPolicy::Nodes(); ++node)
+        if (node != home)
+          _replicas[node].reset(new packedcoeff(*this, node));
+    }
+  }
+
+  SphericalEngine::packedcoeff::packedcoeff(const packedcoeff& c, int node)
+    : _nmx(c._nmx)
+    , _mmx(c._mmx)
+    , _nsingle(c._nsingle)
+    , _data(MemoryPolicy::Allocator<real>(node))
+    , _col(c._col)
+    , _fdata(MemoryPolicy::Allocator<float>(node))
+    , _fcol(c._fcol)
+  {
+    // Copy the records, shifting them so that the columns start on 64-byte
+    // boundaries in the new storage.
+    const size_t line = max(size_t(1), 64 / sizeof(real)),
+      fline = 64 / sizeof(float);
+    _data.resize(c._data.size());
+    _fdata.resize(c._fdata.size());
+    size_t
+      off = (line - reinterpret_cast<uintptr_t>(_data.data()) /
+             sizeof(real) % line) % line,
+      off0 = c._col.empty() ? 0 : c._col[0],
+      n = c._data.size() - line;
+    copy(c._data.begin() + off0, c._data.begin() + off0 + n,
+         _data.begin() + off);
+    for (size_t& k : _col) k = k - off0 + off;
+    if (!c._fdata.empty()) {
+      size_t
+        foff = (fline - reinterpret_cast<uintptr_t>(_fdata.data()) /
+                sizeof(float) % fline) % fline,
+        foff0 = c._fcol[0],
+        fn = c._fdata.size() - fline;
+      copy(c._fdata.begin() + foff0, c._fdata.begin() + foff0 + fn,
+           _fdata.begin() + foff);
+      for (size_t& k : _fcol) k = k - foff0 + foff;
+    }
+  }
+
+  size_t SphericalEngine::packedcoeff::MemoryUsage() const {
+    size_t bytes = sizeof(*this) +
+      _data.capacity() * sizeof(real) + _fdata.capacity() * sizeof(float) +
+      (_col.capacity() + _fcol.capacity()) * sizeof(size_t) +
+      _replicas.capacity() * sizeof(_replicas[0]);
+    for (const auto& r : _replicas)
+      if (r) bytes += r->MemoryUsage();
+    return bytes;
+  }
+
+  template<bool gradp, SphericalEngine::normalization norm>
+  Math::real SphericalEngine::ValuePacked(const packedcoeff& c0, int N,
+                                          real x, real y, real z, real a,
+                                          real& gradx, real& grady,
+                                          real& gradz) {
+    // This follows Value with L = 1, except that the coefficients and the
+    // recurrence factors for the inner sums come from the records in c.
+    static_assert(norm == FULL || norm == SCHMIDT, "Unknown normalization");
+    GEOGRAPHICLIB_TRACE_SPAN("SphericalEngine::ValuePacked");
+    // The copy of the records on this thread's NUMA node
+    const packedcoeff& c = c0.local();
+    N = min(N, c.nmx());
+    int M = min(N, c.mmx());
+
+    real
+      p = hypot(x, y),
+      cl = p != 0 ? x / p : 1,  // cos(lambda); at pole, pick lambda = 0
+      sl = p != 0 ? y / p : 0,  // sin(lambda)
+      r = hypot(z, p),
+      t = r != 0 ? z / r : 0,   // cos(theta); at origin, pick theta = pi/2
+      u = r != 0 ? fmax(p / r, eps()) : 1, // sin(theta); but avoid the pole
+      q = a / r;
+    real
+      q2 = Math::sq(q),
+      tq = t * q,
+      uq = u * q,
+      uq2 = Math::sq(uq),
+      tu = t / u;
+    // Initialize outer sum
+    real vc  = 0, vc2  = 0, vs  = 0, vs2  = 0;   // v [N + 1], v [N + 2]
+    real vrc = 0, vrc2 = 0, vrs = 0, vrs2 = 0;   // vr[N + 1], vr[N + 2]
+    real vtc = 0, vtc2 = 0, vts = 0, vts2 = 0;   // vt[N + 1], vt[N + 2]
+    real vlc = 0, vlc2 = 0, vls = 0, vls2 = 0;   // vl[N + 1], vl[N + 2]
+    const real* root( sqrttable() );
+    // Prefetch the records this many reals (a few 64-byte lines) ahead
+    const int prefetch = 32;
+    for (int m = M; m >= 0; --m) {   // m = M .. 0
+      // Initialize inner sum
+      real
+        wc  = 0, wc2  = 0, ws  = 0, ws2  = 0, // w [N - m + 1], w [N - m + 2]
+        wrc = 0, wrc2 = 0, wrs = 0, wrs2 = 0, // wr[N - m + 1], wr[N - m + 2]
+        wtc = 0, wtc2 = 0, wts = 0, wts2 = 0; // wt[N - m + 1], wt[N - m + 2]
+      // One step of the inner sum given the record for (n, m); the record
+      // may be float or real, but the sums are accumulated in real.
+      auto step = [&](int n, real ra, real rb, real rc, real rs) -> void {
+        real w,
+          Ax = q * ra, A = tq * ra, // alpha[l]
+          B = - q2 * rb,            // beta[l + 1]
+          R = rc;
+        w = A * wc + B * wc2 + R; wc2 = wc; wc = w;
+        if (gradp) {
+          w = A * wrc + B * wrc2 + (n + 1) * R; wrc2 = wrc; wrc = w;
+          w = A * wtc + B * wtc2 -  u*Ax * wc2; wtc2 = wtc; wtc = w;
+        }
+        if (m) {
+          R = rs;
+          w = A * ws + B * ws2 + R; ws2 = ws; ws = w;
+          if (gradp) {
+            w = A * wrs + B * wrs2 + (n + 1) * R; wrs2 = wrs; wrs = w;
+            w = A * wts + B * wts2 -  u*Ax * ws2; wts2 = wts; wts = w;
+          }
+        }
+      };
+      int n = N;
+      // First the single precision records, n = N .. max(m, nsingle + 1)
+      int n0 = max(m, c.nsingle() + 1);
+      if (n >= n0) {
+        const float* rec = c.fcolumn(m) + 4 * (n - n0);
+        for (; n >= n0; --n, rec -= 4) {
+          if (4 * (n - n0) >= prefetch) GEOGRAPHICLIB_PREFETCH(rec - prefetch);
+          step(n, rec[2], rec[3], rec[0] * scale(), rec[1] * scale());
+        }
+      }
+      // Then the real records, n = min(N, nsingle) .. m
+      if (n >= m) {
+        const real* rec = c.column(m) + 4 * (n - m);
+        for (; n >= m; --n, rec -= 4) {
+          if (4 * (n - m) >= prefetch) GEOGRAPHICLIB_PREFETCH(rec - prefetch);
+          step(n, rec[2], rec[3], rec[0], rec[1]);
+        }
+      }
+      // The outer sum is the same as in Value
+      if (m) {
+        real v, A, B;           // alpha[m], beta[m + 1]
+        switch (norm) {
+        case FULL:
+          v = root[2] * root[2 * m + 3] / root[m + 1];
+          A = cl * v * uq;
+          B = - v * root[2 * m + 5] / (root[8] * root[m + 2]) * uq2;
+          break;
+        case SCHMIDT:
+          v = root[2] * root[2 * m + 1] / root[m + 1];
+          A = cl * v * uq;
+          B = - v * root[2 * m + 3] / (root[8] * root[m + 2]) * uq2;
+          break;
+        default: break;       // To suppress warning message from Visual Studio
+        }
+        v = A * vc  + B * vc2  +  wc ; vc2  = vc ; vc  = v;
+        v = A * vs  + B * vs2  +  ws ; vs2  = vs ; vs  = v;
+        if (gradp) {
+          // Include the terms Sc[m] * P'[m,m](t) and Ss[m] * P'[m,m](t)
+          wtc += m * tu * wc; wts += m * tu * ws;
+          v = A * vrc + B * vrc2 +  wrc; vrc2 = vrc; vrc = v;
+          v = A * vrs + B * vrs2 +  wrs; vrs2 = vrs; vrs = v;
+          v = A * vtc + B * vtc2 +  wtc; vtc2 = vtc; vtc = v;
+          v = A * vts + B * vts2 +  wts; vts2 = vts; vts = v;
+          v = A * vlc + B * vlc2 + m*ws; vlc2 = vlc; vlc = v;
+          v = A * vls + B * vls2 - m*wc; vls2 = vls; vls = v;
+        }
+      } else {
+        real A, B, qs;
+        switch (norm) {
+        case FULL:
+          A = root[3] * uq;       // F[1]/(q*cl) or F[1]/(q*sl)
+          B = - root[15]/2 * uq2; // beta[1]/q
+          break;
+        case SCHMIDT:
+          A = uq;
+          B = - root[3]/2 * uq2;
+          break;
+        default: break;       // To suppress warning message from Visual Studio
+        }
+        qs = q / scale();
+        vc = qs * (wc + A * (cl * vc + sl * vs ) + B * vc2);
+        if (gradp) {
+          qs /= r;
+          vrc =   - qs * (wrc + A * (cl * vrc + sl * vrs) + B * vrc2);
+          vtc =     qs * (wtc + A * (cl * vtc + sl * vts) + B * vtc2);
+          vlc = qs / u * (      A * (cl * vlc + sl * vls) + B * vlc2);
+        }
+      }
+    }
+
+    if (gradp) {
+      // Rotate into cartesian (geocentric) coordinates
+      gradx = cl * (u * vrc + t * vtc) - sl * vlc;
+      grady = sl * (u * vrc + t * vtc) + cl * vlc;
+      gradz =       t * vrc - u * vtc            ;
+    }
+    return vc;
+  }
+
+  template<bool gradp, SphericalEngine::normalization norm, int K>
+  void SphericalEngine::ValueMulti(const coeff c[],
+                                   real x, real y, real z, real a,
+                                   real v[],
+                                   real gradx[], real grady[], real gradz[]) {
+    // This follows Value, except that each accumulator is replaced by an
+    // array over the K sums.  The recursion coefficients are computed once
+    // and the expressions are evaluated in the same way so that the results
+    // are identical.
+    static_assert(K > 0, "K must be positive");
+    static_assert(norm == FULL || norm == SCHMIDT, "Unknown normalization");
+    int N = c[0].nmx(), M = c[0].mmx();
+    for (int j = 1; j < K; ++j) {
+      N = max(N, c[j].nmx()); M = max(M, c[j].mmx());
+    }
+
+    real
+      p = hypot(x, y),
+      cl = p != 0 ? x / p : 1,  // cos(lambda); at pole, pick lambda = 0
+      sl = p != 0 ? y / p : 0,  // sin(lambda)
+      r = hypot(z, p),
+      t = r != 0 ? z / r : 0,   // cos(theta); at origin, pick theta = pi/2
+      u = r != 0 ? fmax(p / r, eps()) : 1, // sin(theta); but avoid the pole
+      q = a / r;
+    real
+      q2 = Math::sq(q),
+      uq = u * q,
+      uq2 = Math::sq(uq),
+      tu = t / u;
+    // Initialize outer sums
+    real vc[K], vc2[K], vs[K], vs2[K],
+      vrc[K], vrc2[K], vrs[K], vrs2[K],
+      vtc[K], vtc2[K], vts[K], vts2[K],
+      vlc[K], vlc2[K], vls[K], vls2[K];
+    for (int j = 0; j < K; ++j) {
+      vc [j] = vc2 [j] = vs [j] = vs2 [j] = 0;
+      vrc[j] = vrc2[j] = vrs[j] = vrs2[j] = 0;
+      vtc[j] = vtc2[j] = vts[j] = vts2[j] = 0;
+      vlc[j] = vlc2[j] = vls[j] = vls2[j] = 0;
+    }
+    int k[K];
+    const real* root( sqrttable() );
+    for (int m = M; m >= 0; --m) {   // m = M .. 0
+      // Initialize inner sums
+      real wc[K], wc2[K], ws[K], ws2[K],
+        wrc[K], wrc2[K], wrs[K], wrs2[K],
+        wtc[K], wtc2[K], wts[K], wts2[K];
+      for (int j = 0; j < K; ++j) {
+        wc [j] = wc2 [j] = ws [j] = ws2 [j] = 0;
+        wrc[j] = wrc2[j] = wrs[j] = wrs2[j] = 0;
+        wtc[j] = wtc2[j] = wts[j] = wts2[j] = 0;
+        k[j] = c[j].index(N, m) + 1;
+      }
+      for (int n = N; n >= m; --n) {             // n = N .. m; l = N - m .. 0
+        real w, A, Ax, B, R;    // alpha[l], beta[l + 1]
+        switch (norm) {
+        case FULL:
+          w = root[2 * n + 1] / (root[n - m + 1] * root[n + m + 1]);
+          Ax = q * w * root[2 * n + 3];
+          A = t * Ax;
+          B = - q2 * root[2 * n + 5] /
+            (w * root[n - m + 2] * root[n + m + 2]);
+          break;
+        case SCHMIDT:
+          w = root[n - m + 1] * root[n + m + 1];
+          Ax = q * (2 * n + 1) / w;
+          A = t * Ax;
+          B = - q2 * w / (root[n - m + 2] * root[n + m + 2]);
+          break;
+        default: break;       // To suppress warning message from Visual Studio
+        }
+        // Terms beyond the degree and order of a sum are zero and leave its
+        // accumulators at zero.
+        for (int j = 0; j < K; ++j) {
+          R = c[j].Cv(--k[j], n, m, 1) * scale();
+          w = A * wc[j] + B * wc2[j] + R; wc2[j] = wc[j]; wc[j] = w;
+          if (gradp) {
+            w = A * wrc[j] + B * wrc2[j] + (n + 1) * R;
+            wrc2[j] = wrc[j]; wrc[j] = w;
+            w = A * wtc[j] + B * wtc2[j] -  u*Ax * wc2[j];
+            wtc2[j] = wtc[j]; wtc[j] = w;
+          }
+          if (m) {
+            R = c[j].Sv(k[j], n, m, 1) * scale();
+            w = A * ws[j] + B * ws2[j] + R; ws2[j] = ws[j]; ws[j] = w;
+            if (gradp) {
+              w = A * wrs[j] + B * wrs2[j] + (n + 1) * R;
+              wrs2[j] = wrs[j]; wrs[j] = w;
+              w = A * wts[j] + B * wts2[j] -  u*Ax * ws2[j];
+              wts2[j] = wts[j]; wts[j] = w;
+            }
+          }
+        }
+      }
+      if (m) {
+        real vv, A, B;          // alpha[m], beta[m + 1]
+        switch (norm) {
+        case FULL:
+          vv = root[2] * root[2 * m + 3] / root[m + 1];
+          A = cl * vv * uq;
+          B = - vv * root[2 * m + 5] / (root[8] * root[m + 2]) * uq2;
+          break;
+        case SCHMIDT:
+          vv = root[2] * root[2 * m + 1] / root[m + 1];
+          A = cl * vv * uq;
+          B = - vv * root[2 * m + 3] / (root[8] * root[m + 2]) * uq2;
+          break;
+        default: break;       // To suppress warning message from Visual Studio
+        }
+        for (int j = 0; j < K; ++j) {
+          vv = A * vc [j] + B * vc2 [j] +  wc [j];
+          vc2 [j] = vc [j]; vc [j] = vv;
+          vv = A * vs [j] + B * vs2 [j] +  ws [j];
+          vs2 [j] = vs [j]; vs [j] = vv;
+          if (gradp) {
+            // Include the terms Sc[m] * P'[m,m](t) and Ss[m] * P'[m,m](t)
+            wtc[j] += m * tu * wc[j]; wts[j] += m * tu * ws[j];
+            vv = A * vrc[j] + B * vrc2[j] +  wrc[j];
+            vrc2[j] = vrc[j]; vrc[j] = vv;
+            vv = A * vrs[j] + B * vrs2[j] +  wrs[j];
+            vrs2[j] = vrs[j]; vrs[j] = vv;
+            vv = A * vtc[j] + B * vtc2[j] +  wtc[j];
+            vtc2[j] = vtc[j]; vtc[j] = vv;
+            vv = A * vts[j] + B * vts2[j] +  wts[j];
+            vts2[j] = vts[j]; vts[j] = vv;
+            vv = A * vlc[j] + B * vlc2[j] + m*ws[j];
+            vlc2[j] = vlc[j]; vlc[j] = vv;
+            vv = A * vls[j] + B * vls2[j] - m*wc[j];
+            vls2[j] = vls[j]; vls[j] = vv;
+          }
+        }
+      } else {
+        real A, B, qs;
+        switch (norm) {
+        case FULL:
+          A = root[3] * uq;       // F[1]/(q*cl) or F[1]/(q*sl)
+          B = - root[15]/2 * uq2; // beta[1]/q
+          break;
+        case SCHMIDT:
+          A = uq;
+          B = - root[3]/2 * uq2;
+          break;
+        default: break;       // To suppress warning message from Visual Studio
+        }
+        for (int j = 0; j < K; ++j) {
+          qs = q / scale();
+          vc[j] = qs * (wc[j] + A * (cl * vc[j] + sl * vs[j]) + B * vc2[j]);
+          if (gradp) {
+            qs /= r;
+            vrc[j] = - qs *
+              (wrc[j] + A * (cl * vrc[j] + sl * vrs[j]) + B * vrc2[j]);
+            vtc[j] =   qs *
+              (wtc[j] + A * (cl * vtc[j] + sl * vts[j]) + B * vtc2[j]);
+            vlc[j] = qs / u *
+              (         A * (cl * vlc[j] + sl * vls[j]) + B * vlc2[j]);
+          }
+        }
+      }
+    }
+
+    for (int j = 0; j < K; ++j) {
+      v[j] = vc[j];
+      if (gradp) {
+        // Rotate into cartesian (geocentric) coordinates
+        gradx[j] = cl * (u * vrc[j] + t * vtc[j]) - sl * vlc[j];
+        grady[j] = sl * (u * vrc[j] + t * vtc[j]) + cl * vlc[j];
+        gradz[j] =       t * vrc[j] - u * vtc[j]              ;
+      }
+    }
+  }
+
+  template<bool gradp, SphericalEngine::normalization norm, int L>
+  void SphericalEngine::ValueBatch(const coeff c[], const real f[], size_t n,
+                                   const real x[], const real y[],
+                                   const real z[], real a, real v[],
+                                   real gradx[], real grady[], real gradz[]) {
+    CPUDispatch::Run([&]() -> void {
+      IntValueBatch<gradp, norm, L>(c, f, n, x, y, z, a, v,
+                                    gradx, grady, gradz);
+    });
+  }
+
+  template<bool gradp, SphericalEngine::normalization norm, int L>
+  void SphericalEngine::IntValueBatch(const coeff c[], const real f[],
+                                      size_t n,
+                                      const real x[], const real y[],
+                                      const real z[], real a, real v[],
+                                      real gradx[], real grady[],
+                                      real gradz[]) {
+    // This follows Value, except that each quantity depending on the point is
+    // replaced by an array over the K points in a batch.  The expressions are
+    // evaluated in the same way so that the results are identical.
+    static_assert(L > 0, "L must be positive");
+    static_assert(norm == FULL || norm == SCHMIDT, "Unknown normalization");
+    const int K = batchsize_;
+    int N = c[0].nmx(), M = c[0].mmx();
+    int k[L];
+    const real* root( sqrttable() );
+    for (size_t i0 = 0; i0 < n; i0 += K) {
+      // Number of points in this batch; pad the batch with the last point
+      int nb = int(min(size_t(K), n - i0));
+      real cl[K], sl[K], r[K], t[K], u[K], q[K], q2[K], uq[K], uq2[K], tu[K];
+      for (int j = 0; j < K; ++j) {
+        size_t i = i0 + min(j, nb - 1);
+        real p = hypot(x[i], y[i]);
+        cl[j] = p != 0 ? x[i] / p : 1;
+        sl[j] = p != 0 ? y[i] / p : 0;
+        r[j] = hypot(z[i], p);
+        t[j] = r[j] != 0 ? z[i] / r[j] : 0;
+        u[j] = r[j] != 0 ? fmax(p / r[j], eps()) : 1;
+        q[j] = a / r[j];
+        q2[j] = Math::sq(q[j]);
+        uq[j] = u[j] * q[j];
+        uq2[j] = Math::sq(uq[j]);
+        tu[j] = t[j] / u[j];
+      }
+      // Initialize outer sum
+      real vc[K], vc2[K], vs[K], vs2[K],
+        vrc[K], vrc2[K], vrs[K], vrs2[K],
+        vtc[K], vtc2[K], vts[K], vts2[K],
+        vlc[K], vlc2[K], vls[K], vls2[K];
+      for (int j = 0; j < K; ++j) {
+        vc [j] = vc2 [j] = vs [j] = vs2 [j] = 0;
+        vrc[j] = vrc2[j] = vrs[j] = vrs2[j] = 0;
+        vtc[j] = vtc2[j] = vts[j] = vts2[j] = 0;
+        vlc[j] = vlc2[j] = vls[j] = vls2[j] = 0;
+      }
+      for (int m = M; m >= 0; --m) {   // m = M .. 0
+        // Initialize inner sum
+        real wc[K], wc2[K], ws[K], ws2[K],
+          wrc[K], wrc2[K], wrs[K], wrs2[K],
+          wtc[K], wtc2[K], wts[K], wts2[K];
+        for (int j = 0; j < K; ++j) {
+          wc [j] = wc2 [j] = ws [j] = ws2 [j] = 0;
+          wrc[j] = wrc2[j] = wrs[j] = wrs2[j] = 0;
+          wtc[j] = wtc2[j] = wts[j] = wts2[j] = 0;
+        }
+        for (int l = 0; l < L; ++l)
+          k[l] = c[l].index(N, m) + 1;
+        for (int n1 = N; n1 >= m; --n1) {        // n = N .. m; l = N - m .. 0
+          // The coefficients are fetched once for all the points
+          real w, d, R, Rs = 0, Ax[K], A[K], B[K];
+          switch (norm) {
+          case FULL:
+            w = root[2 * n1 + 1] / (root[n1 - m + 1] * root[n1 + m + 1]);
+            d = w * root[n1 - m + 2] * root[n1 + m + 2];
+            for (int j = 0; j < K; ++j) {
+              Ax[j] = q[j] * w * root[2 * n1 + 3];
+              A[j] = t[j] * Ax[j];
+              B[j] = - q2[j] * root[2 * n1 + 5] / d;
+            }
+            break;
+          case SCHMIDT:
+            w = root[n1 - m + 1] * root[n1 + m + 1];
+            d = root[n1 - m + 2] * root[n1 + m + 2];
+            for (int j = 0; j < K; ++j) {
+              Ax[j] = q[j] * (2 * n1 + 1) / w;
+              A[j] = t[j] * Ax[j];
+              B[j] = - q2[j] * w / d;
+            }
+            break;
+          default: break;     // To suppress warning message from Visual Studio
+          }
+          R = c[0].Cv(--k[0]);
+          for (int l = 1; l < L; ++l)
+            R += c[l].Cv(--k[l], n1, m, f[l]);
+          R *= scale();
+          if (m) {
+            Rs = c[0].Sv(k[0]);
+            for (int l = 1; l < L; ++l)
+              Rs += c[l].Sv(k[l], n1, m, f[l]);
+            Rs *= scale();
+          }
+          for (int j = 0; j < K; ++j) {
+            w = A[j] * wc[j] + B[j] * wc2[j] + R; wc2[j] = wc[j]; wc[j] = w;
+            if (gradp) {
+              w = A[j] * wrc[j] + B[j] * wrc2[j] + (n1 + 1) * R;
+              wrc2[j] = wrc[j]; wrc[j] = w;
+              w = A[j] * wtc[j] + B[j] * wtc2[j] - u[j]*Ax[j] * wc2[j];
+              wtc2[j] = wtc[j]; wtc[j] = w;
+            }
+          }
+          if (m) {
+            for (int j = 0; j < K; ++j) {
+              w = A[j] * ws[j] + B[j] * ws2[j] + Rs; ws2[j] = ws[j]; ws[j] = w;
+              if (gradp) {
+                w = A[j] * wrs[j] + B[j] * wrs2[j] + (n1 + 1) * Rs;
+                wrs2[j] = wrs[j]; wrs[j] = w;
+                w = A[j] * wts[j] + B[j] * wts2[j] - u[j]*Ax[j] * ws2[j];
+                wts2[j] = wts[j]; wts[j] = w;
+              }
+            }
+          }
+        }
+        if (m) {
+          real v0, v1, v2;
+          switch (norm) {
+          case FULL:
+            v0 = root[2] * root[2 * m + 3] / root[m + 1];
+            v1 = root[2 * m + 5];
+            break;
+          case SCHMIDT:
+            v0 = root[2] * root[2 * m + 1] / root[m + 1];
+            v1 = root[2 * m + 3];
+            break;
+          default:            // To suppress warning message from Visual Studio
+            v0 = v1 = 0;
+            break;
+          }
+          v2 = root[8] * root[m + 2];
+          for (int j = 0; j < K; ++j) {
+            real
+              A = cl[j] * v0 * uq[j],
+              B = - v0 * v1 / v2 * uq2[j],
+              w;
+            w = A * vc [j] + B * vc2 [j] + wc[j]; vc2 [j] = vc [j]; vc [j] = w;
+            w = A * vs [j] + B * vs2 [j] + ws[j]; vs2 [j] = vs [j]; vs [j] = w;
+            if (gradp) {
+              // Include the terms Sc[m] * P'[m,m](t) and Ss[m] * P'[m,m](t)
+              wtc[j] += m * tu[j] * wc[j]; wts[j] += m * tu[j] * ws[j];
+              w = A * vrc[j] + B * vrc2[j] +  wrc[j];
+              vrc2[j] = vrc[j]; vrc[j] = w;
+              w = A * vrs[j] + B * vrs2[j] +  wrs[j];
+              vrs2[j] = vrs[j]; vrs[j] = w;
+              w = A * vtc[j] + B * vtc2[j] +  wtc[j];
+              vtc2[j] = vtc[j]; vtc[j] = w;
+              w = A * vts[j] + B * vts2[j] +  wts[j];
+              vts2[j] = vts[j]; vts[j] = w;
+              w = A * vlc[j] + B * vlc2[j] + m*ws[j];
+              vlc2[j] = vlc[j]; vlc[j] = w;
+              w = A * vls[j] + B * vls2[j] - m*wc[j];
+              vls2[j] = vls[j]; vls[j] = w;
+            }
+          }
+        } else {
+          real A0, B0;
+          switch (norm) {
+          case FULL:
+            A0 = root[3];       // F[1]/(q*cl) or F[1]/(q*sl)
+            B0 = - root[15]/2;  // beta[1]/q
+            break;
+          case SCHMIDT:
+            A0 = 1;
+            B0 = - root[3]/2;
+            break;
+          default:            // To suppress warning message from Visual Studio
+            A0 = B0 = 0;
+            break;
+          }
+          for (int j = 0; j < K; ++j) {
+            real
+              A = norm == SCHMIDT ? uq[j] : A0 * uq[j],
+              B = B0 * uq2[j],
+              qs = q[j] / scale();
+            vc[j] = qs * (wc[j] + A * (cl[j] * vc[j] + sl[j] * vs[j]) +
+                          B * vc2[j]);
+            if (gradp) {
+              qs /= r[j];
+              vrc[j] = - qs * (wrc[j] + A * (cl[j] * vrc[j] + sl[j] * vrs[j])
+                               + B * vrc2[j]);
+              vtc[j] =   qs * (wtc[j] + A * (cl[j] * vtc[j] + sl[j] * vts[j])
+                               + B * vtc2[j]);
+              vlc[j] = qs / u[j] * (     A * (cl[j] * vlc[j] + sl[j] * vls[j])
+                                    + B * vlc2[j]);
+            }
+          }
+        }
+      }
+      for (int j = 0; j < nb; ++j) {
+        size_t i = i0 + j;
+        v[i] = vc[j];
+        if (gradp) {
+          // Rotate into cartesian (geocentric) coordinates
+          gradx[i] = cl[j] * (u[j] * vrc[j] + t[j] * vtc[j]) - sl[j] * vlc[j];
+          grady[i] = sl[j] * (u[j] * vrc[j] + t[j] * vtc[j]) + cl[j] * vlc[j];
+          gradz[i] =          t[j] * vrc[j] - u[j] * vtc[j]                 ;
+        }
+      }
+    }
+  }
+
+  template<bool gradp, SphericalEngine::normalization norm, int L>
+  void SphericalEngine::InnerSums(const coeff c[], const real f[],
+                                  real t, real u, real q, int m0, int m1,
+                                  real ww[]) {
+    // The inner sums of Value and Circle for m in [m0, m1).  These are
+    // stored in ww[k*m + i] where k = 6 (or 2 if !gradp) and i = 0 .. k-1
+    // indexes wc, ws, wrc, wrs, wtc, wts (without the P'[m,m](t) terms).
+    const int nw = gradp ? 6 : 2;
+    int N = c[0].nmx();
+    real q2 = Math::sq(q);
+    int k[L];
+    const real* root( sqrttable() );
+    for (int m = m0; m < m1; ++m) {
       // Initialize inner sum
       real
         wc  = 0, wc2  = 0, ws  = 0, ws2  = 0, // w [N - m + 1], w [N - m + 2]
@@ -227,8 +1074,68 @@ namespace GeographicLib {
           }
         }
       }
-      // Now Sc[m] = wc, Ss[m] = ws
-      // Sc'[m] = wtc, Ss'[m] = wtc
+      real* p = ww + nw * m;
+      p[0] = wc; p[1] = ws;
+      if (gradp) {
+        p[2] = wrc; p[3] = wrs; p[4] = wtc; p[5] = wts;
+      }
+    }
+  }
+
+  template<bool gradp, SphericalEngine::normalization norm, int L>
+  void SphericalEngine::ParallelSums(const coeff c[], const real f[],
+                                     real t, real u, real q,
+                                     unsigned nthreads, vector<real>& ww) {
+    int M = c[0].mmx();
+    ww.resize((gradp ? 6 : 2) * size_t(M + 1));
+    // The cost of the sum for order m is proportional to N - m + 1, so
+    // split the orders into several chunks per thread and let the threads
+    // steal work from one another.
+    unsigned nt = GeodesicBatchExecutor(nthreads).NumThreads();
+    GeodesicBatchExecutor exec(nt, max(size_t(1),
+                                       size_t(M + 1) / (16 * size_t(nt))));
+    exec.ForEach(size_t(M + 1), [&](size_t m0, size_t m1) -> void {
+      InnerSums<gradp, norm, L>(c, f, t, u, q, int(m0), int(m1), ww.data());
+    });
+  }
+
+  template<bool gradp, SphericalEngine::normalization norm, int L>
+  Math::real SphericalEngine::ValueParallel(const coeff c[], const real f[],
+                                            real x, real y, real z, real a,
+                                            real& gradx, real& grady,
+                                            real& gradz, unsigned nthreads) {
+    static_assert(L > 0, "L must be positive");
+    static_assert(norm == FULL || norm == SCHMIDT, "Unknown normalization");
+    int M = c[0].mmx();
+
+    real
+      p = hypot(x, y),
+      cl = p != 0 ? x / p : 1,  // cos(lambda); at pole, pick lambda = 0
+      sl = p != 0 ? y / p : 0,  // sin(lambda)
+      r = hypot(z, p),
+      t = r != 0 ? z / r : 0,   // cos(theta); at origin, pick theta = pi/2
+      u = r != 0 ? fmax(p / r, eps()) : 1, // sin(theta); but avoid the pole
+      q = a / r;
+    real
+      uq = u * q,
+      uq2 = Math::sq(uq),
+      tu = t / u;
+    // The inner sums
+    vector<real> ww;
+    ParallelSums<gradp, norm, L>(c, f, t, u, q, nthreads, ww);
+    const int nw = gradp ? 6 : 2;
+    // The outer sum is the same as in Value
+    real vc  = 0, vc2  = 0, vs  = 0, vs2  = 0;   // v [N + 1], v [N + 2]
+    real vrc = 0, vrc2 = 0, vrs = 0, vrs2 = 0;   // vr[N + 1], vr[N + 2]
+    real vtc = 0, vtc2 = 0, vts = 0, vts2 = 0;   // vt[N + 1], vt[N + 2]
+    real vlc = 0, vlc2 = 0, vls = 0, vls2 = 0;   // vl[N + 1], vl[N + 2]
+    const real* root( sqrttable() );
+    for (int m = M; m >= 0; --m) {   // m = M .. 0
+      const real* pw = ww.data() + nw * m;
+      real wc = pw[0], ws = pw[1], wrc = 0, wrs = 0, wtc = 0, wts = 0;
+      if (gradp) {
+        wrc = pw[2]; wrs = pw[3]; wtc = pw[4]; wts = pw[5];
+      }
       if (m) {
         real v, A, B;           // alpha[m], beta[m + 1]
         switch (norm) {
@@ -273,10 +1180,6 @@ namespace GeographicLib {
         vc = qs * (wc + A * (cl * vc + sl * vs ) + B * vc2);
         if (gradp) {
           qs /= r;
-          // The components of the gradient in spherical coordinates are
-          // r: dV/dr
-          // theta: 1/r * dV/dtheta
-          // lambda: 1/(r*u) * dV/dlambda
           vrc =   - qs * (wrc + A * (cl * vrc + sl * vrs) + B * vrc2);
           vtc =     qs * (wtc + A * (cl * vtc + sl * vts) + B * vtc2);
           vlc = qs / u * (      A * (cl * vlc + sl * vls) + B * vlc2);
@@ -293,9 +1196,50 @@ namespace GeographicLib {
     return vc;
   }
 
+  template<bool gradp, SphericalEngine::normalization norm, int L>
+  CircularEngine SphericalEngine::CircleParallel(const coeff c[],
+                                                 const real f[],
+                                                 real p, real z, real a,
+                                                 unsigned nthreads) {
+    static_assert(L > 0, "L must be positive");
+    static_assert(norm == FULL || norm == SCHMIDT, "Unknown normalization");
+    int M = c[0].mmx();
+
+    real
+      r = hypot(z, p),
+      t = r != 0 ? z / r : 0,   // cos(theta); at origin, pick theta = pi/2
+      u = r != 0 ? fmax(p / r, eps()) : 1, // sin(theta); but avoid the pole
+      q = a / r;
+    real tu = t / u;
+    CircularEngine circ;
+    circ.Reset(M, gradp, norm, a, r, u, t);
+    vector<real> ww;
+    ParallelSums<gradp, norm, L>(c, f, t, u, q, nthreads, ww);
+    const int nw = gradp ? 6 : 2;
+    for (int m = M; m >= 0; --m) {   // m = M .. 0
+      const real* pw = ww.data() + nw * m;
+      if (!gradp)
+        circ.SetCoeff(m, pw[0], pw[1]);
+      else {
+        // Include the terms Sc[m] * P'[m,m](t) and  Ss[m] * P'[m,m](t)
+        real wtc = pw[4] + m * tu * pw[0], wts = pw[5] + m * tu * pw[1];
+        circ.SetCoeff(m, pw[0], pw[1], pw[2], pw[3], wtc, wts);
+      }
+    }
+    return circ;
+  }
+
   template<bool gradp, SphericalEngine::normalization norm, int L>
   CircularEngine SphericalEngine::Circle(const coeff c[], const real f[],
                                          real p, real z, real a) {
+    CircularEngine circ;
+    Circle<gradp, norm, L>(c, f, p, z, a, circ);
+    return circ;
+  }
+
+  template<bool gradp, SphericalEngine::normalization norm, int L>
+  void SphericalEngine::Circle(const coeff c[], const real f[],
+                               real p, real z, real a, CircularEngine& circ) {
 
     static_assert(L > 0, "L must be positive");
     static_assert(norm == FULL || norm == SCHMIDT, "Unknown normalization");
@@ -309,9 +1253,9 @@ namespace GeographicLib {
     real
       q2 = Math::sq(q),
       tu = t / u;
-    CircularEngine circ(M, gradp, norm, a, r, u, t);
+    circ.Reset(M, gradp, norm, a, r, u, t);
     int k[L];
-    const vector<real>& root( sqrttable() );
+    const real* root( sqrttable() );
     for (int m = M; m >= 0; --m) {   // m = M .. 0
       // Initialize inner sum
       real
@@ -367,19 +1311,331 @@ namespace GeographicLib {
         circ.SetCoeff(m, wc, ws, wrc, wrs, wtc, wts);
       }
     }
+  }
 
-    return circ;
+  template<SphericalEngine::normalization norm, int L>
+  void SphericalEngine::HessianSums(const coeff c[], const real f[],
+                                    real t, real u, real q, int m0, int m1,
+                                    real ww[]) {
+    // For each m, the sums are combined into the coefficients for the outer
+    // sums for (in pairs of cosine and sine terms)
+    //   0: V, 1: dV/dr, 2: dV/dtheta, 3: d^2V/dr^2, 4: d^2V/dr dtheta,
+    //   5: d^2V/dtheta^2, 6: 1/u^2 * d^2V/dlambda^2 + t/u * dV/dtheta,
+    //   7: 1/u * d^2V/dtheta dlambda - t/u^2 * dV/dlambda (before the
+    //      multiplication by m and the swapping of sines and cosines)
+    // omitting the factors of -1/r for the derivatives wrt r.  Derivatives
+    // wrt t (denoted by the suffix d) are accumulated in the inner sums.
+    int N = c[0].nmx();
+    real
+      q2 = Math::sq(q),
+      tu = t / u,
+      u2 = Math::sq(u);
+    int k[L];
+    const real* root( sqrttable() );
+    for (int m = m0; m < m1; ++m) {
+      // Initialize inner sum; wrr has the multipliers (n+1)*(n+2)
+      real
+        wc   = 0, wc2   = 0, ws   = 0, ws2   = 0,
+        wrc  = 0, wrc2  = 0, wrs  = 0, wrs2  = 0,
+        wdc  = 0, wdc2  = 0, wds  = 0, wds2  = 0,
+        wrrc = 0, wrrc2 = 0, wrrs = 0, wrrs2 = 0,
+        wrdc = 0, wrdc2 = 0, wrds = 0, wrds2 = 0,
+        wddc = 0, wddc2 = 0, wdds = 0, wdds2 = 0;
+      for (int l = 0; l < L; ++l)
+        k[l] = c[l].index(N, m) + 1;
+      for (int n = N; n >= m; --n) {             // n = N .. m; l = N - m .. 0
+        real w, A, Ax, B, R;    // alpha[l], beta[l + 1]
+        switch (norm) {
+        case FULL:
+          w = root[2 * n + 1] / (root[n - m + 1] * root[n + m + 1]);
+          Ax = q * w * root[2 * n + 3];
+          A = t * Ax;
+          B = - q2 * root[2 * n + 5] /
+            (w * root[n - m + 2] * root[n + m + 2]);
+          break;
+        case SCHMIDT:
+          w = root[n - m + 1] * root[n + m + 1];
+          Ax = q * (2 * n + 1) / w;
+          A = t * Ax;
+          B = - q2 * w / (root[n - m + 2] * root[n + m + 2]);
+          break;
+        default: break;       // To suppress warning message from Visual Studio
+        }
+        R = c[0].Cv(--k[0]);
+        for (int l = 1; l < L; ++l)
+          R += c[l].Cv(--k[l], n, m, f[l]);
+        R *= scale();
+        // The derivatives wrt t use the previous values of wc, wrc, and wdc
+        w = A * wddc + B * wddc2 + 2*Ax * wdc; wddc2 = wddc; wddc = w;
+        w = A * wdc  + B * wdc2  +   Ax * wc ; wdc2  = wdc ; wdc  = w;
+        w = A * wrdc + B * wrdc2 +   Ax * wrc; wrdc2 = wrdc; wrdc = w;
+        w = A * wc   + B * wc2   + R; wc2 = wc; wc = w;
+        w = A * wrc  + B * wrc2  + (n + 1) * R; wrc2 = wrc; wrc = w;
+        w = A * wrrc + B * wrrc2 + (n + 1) * (n + 2) * R;
+        wrrc2 = wrrc; wrrc = w;
+        if (m) {
+          R = c[0].Sv(k[0]);
+          for (int l = 1; l < L; ++l)
+            R += c[l].Sv(k[l], n, m, f[l]);
+          R *= scale();
+          w = A * wdds + B * wdds2 + 2*Ax * wds; wdds2 = wdds; wdds = w;
+          w = A * wds  + B * wds2  +   Ax * ws ; wds2  = wds ; wds  = w;
+          w = A * wrds + B * wrds2 +   Ax * wrs; wrds2 = wrds; wrds = w;
+          w = A * ws   + B * ws2   + R; ws2 = ws; ws = w;
+          w = A * wrs  + B * wrs2  + (n + 1) * R; wrs2 = wrs; wrs = w;
+          w = A * wrrs + B * wrrs2 + (n + 1) * (n + 2) * R;
+          wrrs2 = wrrs; wrrs = w;
+        }
+      }
+      real
+        mtu = m * tu,
+        ftt = m * (m - 1) * Math::sq(tu) - m,
+        fll = m * (1 - m) / u2 - m,
+        ftl = (m - 1) * t / u2,
+        * p = ww + 16 * m;
+      p[ 0] = wc;                       p[ 1] = ws;
+      p[ 2] = wrc;                      p[ 3] = wrs;
+      p[ 4] = -u * wdc + mtu * wc;      p[ 5] = -u * wds + mtu * ws;
+      p[ 6] = wrrc;                     p[ 7] = wrrs;
+      p[ 8] = -u * wrdc + mtu * wrc;    p[ 9] = -u * wrds + mtu * wrs;
+      p[10] = u2 * wddc - (2 * m + 1) * t * wdc + ftt * wc;
+      p[11] = u2 * wdds - (2 * m + 1) * t * wds + ftt * ws;
+      p[12] = -t * wdc + fll * wc;      p[13] = -t * wds + fll * ws;
+      p[14] = -wdc + ftl * wc;          p[15] = -wds + ftl * ws;
+    }
+  }
+
+  Math::real SphericalEngine::HessianSum(unsigned norm, int M, real r,
+                                         real q, real t, real u,
+                                         real cl, real sl, const real ww[],
+                                         real& gradx, real& grady,
+                                         real& gradz, real hess[]) {
+    // The outer sums for the 8 quantities given by HessianSums together with
+    // those for dV/dlambda, d^2V/dr dlambda, and quantity 7 with the
+    // multiplication by m and the swapping of sines and cosines.
+    const int nv = 10;
+    static const int src[nv] = {0, 1, 2, 3, 4, 5, 6, 0, 1, 7};
+    real
+      uq = u * q,
+      uq2 = Math::sq(uq),
+      vc[nv], vc2[nv], vs[nv], vs2[nv];
+    for (int j = 0; j < nv; ++j)
+      vc[j] = vc2[j] = vs[j] = vs2[j] = 0;
+    const real* root( sqrttable() );
+    for (int m = M; m > 0; --m) {    // m = M .. 1
+      real v, A, B;             // alpha[m], beta[m + 1]
+      switch (norm) {
+      case FULL:
+        v = root[2] * root[2 * m + 3] / root[m + 1];
+        A = cl * v * uq;
+        B = - v * root[2 * m + 5] / (root[8] * root[m + 2]) * uq2;
+        break;
+      case SCHMIDT:
+        v = root[2] * root[2 * m + 1] / root[m + 1];
+        A = cl * v * uq;
+        B = - v * root[2 * m + 3] / (root[8] * root[m + 2]) * uq2;
+        break;
+      default:
+        A = B = 0;
+      }
+      const real* p = ww + 16 * m;
+      for (int j = 0; j < nv; ++j) {
+        real wc = p[2 * src[j]], ws = p[2 * src[j] + 1];
+        if (j >= 7) {
+          real w = wc; wc = m * ws; ws = - m * w;
+        }
+        v = A * vc[j] + B * vc2[j] + wc; vc2[j] = vc[j]; vc[j] = v;
+        v = A * vs[j] + B * vs2[j] + ws; vs2[j] = vs[j]; vs[j] = v;
+      }
+    }
+    real A, B;
+    switch (norm) {
+    case FULL:
+      A = root[3] * uq;         // F[1]/(q*cl) or F[1]/(q*sl)
+      B = - root[15]/2 * uq2;   // beta[1]/q
+      break;
+    case SCHMIDT:
+      A = uq;
+      B = - root[3]/2 * uq2;
+      break;
+    default:
+      A = B = 0;
+    }
+    real X[nv];
+    for (int j = 0; j < nv; ++j)
+      X[j] = (j < 7 ? ww[2 * src[j]] : 0) +
+        A * (cl * vc[j] + sl * vs[j]) + B * vc2[j];
+    real
+      qs = q / scale(),
+      V = qs * X[0];
+    qs /= r;
+    // The components of the gradient in spherical coordinates
+    real
+      gr =   - qs * X[1],       // dV/dr
+      gt =     qs * X[2],       // 1/r * dV/dtheta
+      gl = qs / u * X[7];       // 1/(r*u) * dV/dlambda
+    qs /= r;
+    // The components of the Hessian in spherical coordinates (in the
+    // directions of increasing r, theta, and lambda)
+    real h[3][3];
+    h[0][0] = qs * X[3];
+    h[0][1] = h[1][0] = - qs * X[4] - gt / r;
+    h[0][2] = h[2][0] = - qs / u * X[8] - gl / r;
+    h[1][1] = qs * X[5] + gr / r;
+    h[1][2] = h[2][1] = qs * X[9];
+    h[2][2] = qs * X[6] + gr / r;
+    // Rotate into cartesian (geocentric) coordinates; the columns of R are
+    // the unit vectors in the r, theta, and lambda directions.
+    real R[3][3] = {
+      {cl * u, cl * t, -sl},
+      {sl * u, sl * t,  cl},
+      {     t,     -u,   0},
+    };
+    gradx = R[0][0] * gr + R[0][1] * gt + R[0][2] * gl;
+    grady = R[1][0] * gr + R[1][1] * gt + R[1][2] * gl;
+    gradz = R[2][0] * gr + R[2][1] * gt                ;
+    real RH[3][3];
+    for (int i = 0; i < 3; ++i)
+      for (int b = 0; b < 3; ++b)
+        RH[i][b] = R[i][0] * h[0][b] + R[i][1] * h[1][b] + R[i][2] * h[2][b];
+    for (int i = 0; i < 3; ++i)
+      for (int j = 0; j <= i; ++j)
+        hess[3 * i + j] = hess[3 * j + i] =
+          RH[i][0] * R[j][0] + RH[i][1] * R[j][1] + RH[i][2] * R[j][2];
+    return V;
+  }
+
+  template<SphericalEngine::normalization norm, int L>
+  Math::real SphericalEngine::Hessian(const coeff c[], const real f[],
+                                      real x, real y, real z, real a,
+                                      real& gradx, real& grady, real& gradz,
+                                      real hess[]) {
+    static_assert(L > 0, "L must be positive");
+    static_assert(norm == FULL || norm == SCHMIDT, "Unknown normalization");
+    GEOGRAPHICLIB_TRACE_SPAN("SphericalEngine::Hessian");
+    int M = c[0].mmx();
+    real
+      p = hypot(x, y),
+      cl = p != 0 ? x / p : 1,  // cos(lambda); at pole, pick lambda = 0
+      sl = p != 0 ? y / p : 0,  // sin(lambda)
+      r = hypot(z, p),
+      t = r != 0 ? z / r : 0,   // cos(theta); at origin, pick theta = pi/2
+      u = r != 0 ? fmax(p / r, eps()) : 1, // sin(theta); but avoid the pole
+      q = a / r;
+    vector<real> ww(16 * size_t(M + 1));
+    HessianSums<norm, L>(c, f, t, u, q, 0, M + 1, ww.data());
+    return HessianSum(norm, M, r, q, t, u, cl, sl, ww.data(),
+                      gradx, grady, gradz, hess);
+  }
+
+  template<SphericalEngine::normalization norm, int L>
+  void SphericalEngine::CircleHessian(const coeff c[], const real f[],
+                                      real p, real z, real a,
+                                      CircularEngine& circ) {
+    static_assert(L > 0, "L must be positive");
+    static_assert(norm == FULL || norm == SCHMIDT, "Unknown normalization");
+    int M = c[0].mmx();
+    real
+      r = hypot(z, p),
+      t = r != 0 ? z / r : 0,   // cos(theta); at origin, pick theta = pi/2
+      u = r != 0 ? fmax(p / r, eps()) : 1, // sin(theta); but avoid the pole
+      q = a / r;
+    circ.Reset(M, true, norm, a, r, u, t, true);
+    HessianSums<norm, L>(c, f, t, u, q, 0, M + 1, circ._wh.data());
+    // The sums for the gradient are the first 6 of each set of 16
+    for (int m = 0; m <= M; ++m) {
+      const real* pw = circ._wh.data() + 16 * m;
+      circ.SetCoeff(m, pw[0], pw[1], pw[2], pw[3], pw[4], pw[5]);
+    }
+  }
+
+  vector<Math::real> SphericalEngine::GradientBounds(const coeff& c,
+                                                     normalization norm) {
+    int N = c.nmx(), M = c.mmx();
+    vector<real> b(N + 1, 0);
+    for (int n = 0; n <= N; ++n) {
+      real s = 0;
+      for (int m = 0; m <= min(n, M); ++m) {
+        int k = c.index(n, m);
+        s += Math::sq(c.Cv(k)) + (m ? Math::sq(c.Sv(k)) : 0);
+      }
+      b[n] = sqrt(s * (n + 1) * (2 * n + 1)) *
+        (norm == FULL ? sqrt(real(2 * n + 1)) : 1);
+    }
+    return b;
+  }
+
+  int SphericalEngine::TruncatedDegree(const vector<real>& b,
+                                       real q, real tol) {
+    int n = int(b.size()) - 1;
+    // Skip the terms for which q^(n+1) underflows; these are negligible.
+    // With q = 0, this skips all the terms.
+    if (q < 1) {
+      real nmax = log(numeric_limits<real>::min()) / log(q) - 1;
+      if (nmax < n) n = int(nmax);
+    }
+    real qn = pow(q, n + 1), tail = 0;
+    for (; n > 0; --n) {
+      tail += b[n] * qn;
+      if (tail > tol) break;
+      qn /= q;
+    }
+    return max(n, 0);
   }
 
   void SphericalEngine::RootTable(int N) {
     // Need square roots up to max(2 * N + 5, 15).
-    vector<real>& root( sqrttable() );
-    int L = max(2 * N + 5, 15) + 1, oldL = int(root.size());
+    int L = max(2 * N + 5, 15) + 1;
+    const roottable* t = rootcurrent().load(memory_order_acquire);
+    if (t && t->size >= L)
+      return;
+    lock_guard<mutex> lock(rootmutex());
+    // Check again in case another thread has grown the table
+    t = rootcurrent().load(memory_order_relaxed);
+    int oldL = t ? t->size : 0;
     if (oldL >= L)
       return;
-    root.resize(L);
+    // Grow geometrically so that the retained snapshots use at most as much
+    // memory as the current one.
+    L = max(L, 2 * oldL);
+    unique_ptr<roottable> u(new roottable);
+    u->size = L;
+    u->root.reset(new real[L]);
+    for (int l = 0; l < oldL; ++l)
+      u->root[l] = t->root[l];
     for (int l = oldL; l < L; ++l)
-      root[l] = sqrt(real(l));
+      u->root[l] = sqrt(real(l));
+    roothistory().push_back(move(u));
+    rootcurrent().store(roothistory().back().get(), memory_order_release);
+  }
+
+  size_t SphericalEngine::RootTableMemoryUsage() {
+    lock_guard<mutex> lock(rootmutex());
+    size_t bytes = 0;
+    for (const auto& t : roothistory())
+      bytes += sizeof(roottable) + size_t(t->size) * sizeof(real);
+    return bytes;
+  }
+
+  unsigned long long SphericalEngine::CostEstimate(int N, int M, int L,
+                                                   int deriv, int K) {
+    if (M < 0) return 0;
+    // The operations (see Value, HessianSums, and HessianSum) for: the
+    // recurrence coefficients for each (n, m); each coefficient in each sum;
+    // and each order m in each sum (for the outer sum).
+    unsigned long long
+      nc = coeff::Csize(N, M),
+      ns = coeff::Ssize(N, M),
+      perc = (deriv >= 2 ? 34 : deriv == 1 ? 16 : 6) + 2 * (max(L, 1) - 1),
+      perm = deriv >= 2 ? 150 : deriv == 1 ? 50 : 20;
+    K = max(K, 1);
+    return 50 + 10 * nc + K * (perc * (nc + ns) + perm * (M + 1));
+  }
+
+  void SphericalEngine::ClearRootTable() {
+    lock_guard<mutex> lock(rootmutex());
+    rootcurrent().store(nullptr, memory_order_release);
+    vector<unique_ptr<roottable>>().swap(roothistory());
   }
 
   void SphericalEngine::coeff::readcoeffs(istream& stream, int& N, int& M,
@@ -401,6 +1657,9 @@ namespace GeographicLib {
                           Utility::str(N0) + " " + Utility::str(M0));
     N = truncate ? min(N, N0) : N0;
     M = truncate ? min(M, M0) : M0;
+    C.clear(); S.clear();
+    MemoryPolicy::Reserve(C, SphericalEngine::coeff::Csize(N, M));
+    MemoryPolicy::Reserve(S, SphericalEngine::coeff::Ssize(N, M));
     C.resize(SphericalEngine::coeff::Csize(N, M));
     S.resize(SphericalEngine::coeff::Ssize(N, M));
     int skip = (SphericalEngine::coeff::Csize(N0, M0) -
@@ -427,6 +1686,198 @@ namespace GeographicLib {
     return;
   }
 
+  streamoff SphericalEngine::coeff::readcoeffs(const string& filename,
+                                               streamoff pos, int k,
+                                               int N[], int M[],
+                                               vector<real> C[],
+                                               vector<real> S[],
+                                               bool truncate,
+                                               unsigned nthreads) {
+    ifstream stream(filename.c_str(), ios::binary);
+    if (!stream.good())
+      throw GeographicErr("Error opening " + filename);
+    stream.seekg(0, ios::end);
+    streamoff size = stream.tellg();
+    // A run of coefficients in the file: its offset, where it goes, and the
+    // number of coefficients.
+    struct run {
+      streamoff off;
+      real* dst;
+      size_t num;
+    };
+    vector<run> runs;
+    const streamoff dsize = streamoff(sizeof(double));
+    for (int i = 0; i < k; ++i) {
+      if (truncate) {
+        if (!((N[i] >= M[i] && M[i] >= 0) || (N[i] == -1 && M[i] == -1)))
+          throw GeographicErr("Bad requested degree and order " +
+                              Utility::str(N[i]) + " " + Utility::str(M[i]));
+      }
+      stream.seekg(pos);
+      int nm[2];
+      Utility::readarray<int, int, false>(stream, nm, 2);
+      int N0 = nm[0], M0 = nm[1];
+      if (!((N0 >= M0 && M0 >= 0) || (N0 == -1 && M0 == -1)))
+        throw GeographicErr("Bad degree and order " +
+                            Utility::str(N0) + " " + Utility::str(M0));
+      int n = truncate ? min(N[i], N0) : N0, m = truncate ? min(M[i], M0) : M0;
+      N[i] = n; M[i] = m;
+      C[i].clear(); S[i].clear();
+      MemoryPolicy::Reserve(C[i], Csize(n, m));
+      MemoryPolicy::Reserve(S[i], Ssize(n, m));
+      C[i].resize(Csize(n, m));
+      S[i].resize(Ssize(n, m));
+      streamoff
+        c0 = pos + 2 * streamoff(sizeof(int)),
+        s0 = c0 + Csize(N0, M0) * dsize;
+      pos = s0 + Ssize(N0, M0) * dsize;
+      if (pos > size)
+        throw GeographicErr("Premature end of " + filename);
+      // Column j of C starts at element Csize(N, j - 1); column j > 0 of S
+      // starts at element Ssize(N, j - 1).  Adjacent runs are merged.
+      for (int j = 0; j <= m; ++j) {
+        run rc = {c0 + Csize(N0, j - 1) * dsize,
+                  C[i].data() + Csize(n, j - 1), size_t(n + 1 - j)};
+        if (!runs.empty() &&
+            runs.back().off + streamoff(runs.back().num) * dsize == rc.off &&
+            runs.back().dst + runs.back().num == rc.dst)
+          runs.back().num += rc.num;
+        else
+          runs.push_back(rc);
+      }
+      for (int j = 1; j <= m; ++j) {
+        run rs = {s0 + Ssize(N0, j - 1) * dsize,
+                  S[i].data() + Ssize(n, j - 1), size_t(n + 1 - j)};
+        if (runs.back().off + streamoff(runs.back().num) * dsize == rs.off &&
+            runs.back().dst + runs.back().num == rs.dst)
+          runs.back().num += rs.num;
+        else
+          runs.push_back(rs);
+      }
+    }
+    // Split the runs into pieces of at most chunk coefficients
+    const size_t chunk = 1U << 16;
+    vector<run> pieces;
+    size_t total = 0;
+    for (const run& r : runs) {
+      total += r.num;
+      for (size_t j = 0; j < r.num; j += chunk) {
+        run p = {r.off + streamoff(j) * dsize, r.dst + j,
+                 min(chunk, r.num - j)};
+        pieces.push_back(p);
+      }
+    }
+    GeodesicBatchExecutor(total <= chunk ? 1 : nthreads, 1)
+      .ForEach(pieces.size(), [&](size_t j0, size_t j1) -> void {
+        ifstream str(filename.c_str(), ios::binary);
+        if (!str.good())
+          throw GeographicErr("Error opening " + filename);
+        for (size_t j = j0; j < j1; ++j) {
+          str.seekg(pieces[j].off);
+          Utility::readarray<double, real, false>(str, pieces[j].dst,
+                                                  pieces[j].num);
+        }
+      });
+    return pos;
+  }
+
+  SphericalEngine::coeff
+  SphericalEngine::coeff::mapcoeffs(char*& data, const char* end,
+                                    int& N, int& M, real*& C, bool truncate) {
+    if (!(numeric_limits<real>::is_iec559 && sizeof(real) == sizeof(double)
+          && !Math::bigendian))
+      throw GeographicErr("Mapping coefficients requires little-endian "
+                          "IEEE doubles");
+    if (truncate) {
+      if (!((N >= M && M >= 0) || (N == -1 && M == -1)))
+        throw GeographicErr("Bad requested degree and order " +
+                            Utility::str(N) + " " + Utility::str(M));
+    }
+    int nm[2];
+    if (end - data < ptrdiff_t(sizeof(nm)))
+      throw GeographicErr("Truncated coefficient data");
+    memcpy(nm, data, sizeof(nm));
+    data += sizeof(nm);
+    int N0 = nm[0], M0 = nm[1];
+    if (!((N0 >= M0 && M0 >= 0) || (N0 == -1 && M0 == -1)))
+      throw GeographicErr("Bad degree and order " +
+                          Utility::str(N0) + " " + Utility::str(M0));
+    N = truncate ? min(N, N0) : N0;
+    M = truncate ? min(M, M0) : M0;
+    ptrdiff_t
+      csize = Csize(N0, M0),
+      ssize = Ssize(N0, M0);
+    if ((end - data) / ptrdiff_t(sizeof(real)) < csize + ssize)
+      throw GeographicErr("Truncated coefficient data");
+    if (reinterpret_cast<uintptr_t>(data) % sizeof(real) != 0)
+      throw GeographicErr("Misaligned coefficient data");
+    C = reinterpret_cast<real*>(data);
+    real* S = C + csize;
+    data += (csize + ssize) * sizeof(real);
+    return coeff(C, S, N0, N, M);
+  }
+
+  void SphericalEngine::mappedfile::map(const string& filename) {
+    unmap();
+#if defined(_WIN32)
+    HANDLE f = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                           NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (f == INVALID_HANDLE_VALUE)
+      throw GeographicErr("Cannot open " + filename + " for mapping");
+    LARGE_INTEGER len;
+    if (!GetFileSizeEx(f, &len) ||
+        (unsigned long long)(size_t(len.QuadPart)) !=
+        (unsigned long long)(len.QuadPart)) {
+      CloseHandle(f);
+      throw GeographicErr("Cannot memory map " + filename);
+    }
+    HANDLE m = CreateFileMappingA(f, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+    CloseHandle(f);             // The mapping keeps the file open
+    void* p = m ? MapViewOfFile(m, FILE_MAP_COPY, 0, 0, 0) : NULL;
+    if (!p) {
+      if (m) CloseHandle(m);
+      throw GeographicErr("Cannot memory map " + filename);
+    }
+    _handle = m;
+    _data = static_cast<char*>(p);
+    _size = size_t(len.QuadPart);
+#elif GEOGRAPHICLIB_SPHERICAL_POSIX
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+      throw GeographicErr("Cannot open " + filename + " for mapping");
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0 ||
+        (unsigned long long)(size_t(st.st_size)) !=
+        (unsigned long long)(st.st_size)) {
+      close(fd);
+      throw GeographicErr("Cannot memory map " + filename);
+    }
+    size_t len = size_t(st.st_size);
+    // Copy-on-write so that the caller may alter a few coefficients
+    void* p = mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);                  // The mapping keeps the file open
+    if (p == MAP_FAILED)
+      throw GeographicErr("Cannot memory map " + filename);
+    _data = static_cast<char*>(p);
+    _size = len;
+#else
+    throw GeographicErr("Memory mapping is not supported on this system");
+#endif
+  }
+
+  void SphericalEngine::mappedfile::unmap() {
+    if (!_data) return;
+#if defined(_WIN32)
+    UnmapViewOfFile(_data);
+    CloseHandle(_handle);
+#elif GEOGRAPHICLIB_SPHERICAL_POSIX
+    munmap(_data, _size);
+#endif
+    _data = nullptr;
+    _size = 0;
+    _handle = nullptr;
+  }
+
   /// \cond SKIP
   template Math::real GEOGRAPHICLIB_EXPORT
   SphericalEngine::Value<true, SphericalEngine::FULL, 1>
@@ -467,6 +1918,147 @@ namespace GeographicLib {
   SphericalEngine::Value<false, SphericalEngine::SCHMIDT, 3>
   (const coeff[], const real[], real, real, real, real, real&, real&, real&);
 
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::ValueBatch<true, SphericalEngine::FULL, 1>
+  (const coeff[], const real[], size_t, const real[], const real[],
+   const real[], real, real[], real[], real[], real[]);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::ValueBatch<false, SphericalEngine::FULL, 1>
+  (const coeff[], const real[], size_t, const real[], const real[],
+   const real[], real, real[], real[], real[], real[]);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::ValueBatch<true, SphericalEngine::SCHMIDT, 1>
+  (const coeff[], const real[], size_t, const real[], const real[],
+   const real[], real, real[], real[], real[], real[]);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::ValueBatch<false, SphericalEngine::SCHMIDT, 1>
+  (const coeff[], const real[], size_t, const real[], const real[],
+   const real[], real, real[], real[], real[], real[]);
+
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::ValueBatch<true, SphericalEngine::FULL, 2>
+  (const coeff[], const real[], size_t, const real[], const real[],
+   const real[], real, real[], real[], real[], real[]);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::ValueBatch<false, SphericalEngine::FULL, 2>
+  (const coeff[], const real[], size_t, const real[], const real[],
+   const real[], real, real[], real[], real[], real[]);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::ValueBatch<true, SphericalEngine::SCHMIDT, 2>
+  (const coeff[], const real[], size_t, const real[], const real[],
+   const real[], real, real[], real[], real[], real[]);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::ValueBatch<false, SphericalEngine::SCHMIDT, 2>
+  (const coeff[], const real[], size_t, const real[], const real[],
+   const real[], real, real[], real[], real[], real[]);
+
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::ValueBatch<true, SphericalEngine::FULL, 3>
+  (const coeff[], const real[], size_t, const real[], const real[],
+   const real[], real, real[], real[], real[], real[]);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::ValueBatch<false, SphericalEngine::FULL, 3>
+  (const coeff[], const real[], size_t, const real[], const real[],
+   const real[], real, real[], real[], real[], real[]);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::ValueBatch<true, SphericalEngine::SCHMIDT, 3>
+  (const coeff[], const real[], size_t, const real[], const real[],
+   const real[], real, real[], real[], real[], real[]);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::ValueBatch<false, SphericalEngine::SCHMIDT, 3>
+  (const coeff[], const real[], size_t, const real[], const real[],
+   const real[], real, real[], real[], real[], real[]);
+
+  template Math::real GEOGRAPHICLIB_EXPORT
+  SphericalEngine::ValueParallel<true, SphericalEngine::FULL, 1>
+  (const coeff[], const real[], real, real, real, real, real&, real&, real&,
+   unsigned);
+  template Math::real GEOGRAPHICLIB_EXPORT
+  SphericalEngine::ValueParallel<false, SphericalEngine::FULL, 1>
+  (const coeff[], const real[], real, real, real, real, real&, real&, real&,
+   unsigned);
+  template Math::real GEOGRAPHICLIB_EXPORT
+  SphericalEngine::ValueParallel<true, SphericalEngine::SCHMIDT, 1>
+  (const coeff[], const real[], real, real, real, real, real&, real&, real&,
+   unsigned);
+  template Math::real GEOGRAPHICLIB_EXPORT
+  SphericalEngine::ValueParallel<false, SphericalEngine::SCHMIDT, 1>
+  (const coeff[], const real[], real, real, real, real, real&, real&, real&,
+   unsigned);
+
+  template Math::real GEOGRAPHICLIB_EXPORT
+  SphericalEngine::ValueParallel<true, SphericalEngine::FULL, 2>
+  (const coeff[], const real[], real, real, real, real, real&, real&, real&,
+   unsigned);
+  template Math::real GEOGRAPHICLIB_EXPORT
+  SphericalEngine::ValueParallel<false, SphericalEngine::FULL, 2>
+  (const coeff[], const real[], real, real, real, real, real&, real&, real&,
+   unsigned);
+  template Math::real GEOGRAPHICLIB_EXPORT
+  SphericalEngine::ValueParallel<true, SphericalEngine::SCHMIDT, 2>
+  (const coeff[], const real[], real, real, real, real, real&, real&, real&,
+   unsigned);
+  template Math::real GEOGRAPHICLIB_EXPORT
+  SphericalEngine::ValueParallel<false, SphericalEngine::SCHMIDT, 2>
+  (const coeff[], const real[], real, real, real, real, real&, real&, real&,
+   unsigned);
+
+  template Math::real GEOGRAPHICLIB_EXPORT
+  SphericalEngine::ValueParallel<true, SphericalEngine::FULL, 3>
+  (const coeff[], const real[], real, real, real, real, real&, real&, real&,
+   unsigned);
+  template Math::real GEOGRAPHICLIB_EXPORT
+  SphericalEngine::ValueParallel<false, SphericalEngine::FULL, 3>
+  (const coeff[], const real[], real, real, real, real, real&, real&, real&,
+   unsigned);
+  template Math::real GEOGRAPHICLIB_EXPORT
+  SphericalEngine::ValueParallel<true, SphericalEngine::SCHMIDT, 3>
+  (const coeff[], const real[], real, real, real, real, real&, real&, real&,
+   unsigned);
+  template Math::real GEOGRAPHICLIB_EXPORT
+  SphericalEngine::ValueParallel<false, SphericalEngine::SCHMIDT, 3>
+  (const coeff[], const real[], real, real, real, real, real&, real&, real&,
+   unsigned);
+
+  template CircularEngine GEOGRAPHICLIB_EXPORT
+  SphericalEngine::CircleParallel<true, SphericalEngine::FULL, 1>
+  (const coeff[], const real[], real, real, real, unsigned);
+  template CircularEngine GEOGRAPHICLIB_EXPORT
+  SphericalEngine::CircleParallel<false, SphericalEngine::FULL, 1>
+  (const coeff[], const real[], real, real, real, unsigned);
+  template CircularEngine GEOGRAPHICLIB_EXPORT
+  SphericalEngine::CircleParallel<true, SphericalEngine::SCHMIDT, 1>
+  (const coeff[], const real[], real, real, real, unsigned);
+  template CircularEngine GEOGRAPHICLIB_EXPORT
+  SphericalEngine::CircleParallel<false, SphericalEngine::SCHMIDT, 1>
+  (const coeff[], const real[], real, real, real, unsigned);
+
+  template CircularEngine GEOGRAPHICLIB_EXPORT
+  SphericalEngine::CircleParallel<true, SphericalEngine::FULL, 2>
+  (const coeff[], const real[], real, real, real, unsigned);
+  template CircularEngine GEOGRAPHICLIB_EXPORT
+  SphericalEngine::CircleParallel<false, SphericalEngine::FULL, 2>
+  (const coeff[], const real[], real, real, real, unsigned);
+  template CircularEngine GEOGRAPHICLIB_EXPORT
+  SphericalEngine::CircleParallel<true, SphericalEngine::SCHMIDT, 2>
+  (const coeff[], const real[], real, real, real, unsigned);
+  template CircularEngine GEOGRAPHICLIB_EXPORT
+  SphericalEngine::CircleParallel<false, SphericalEngine::SCHMIDT, 2>
+  (const coeff[], const real[], real, real, real, unsigned);
+
+  template CircularEngine GEOGRAPHICLIB_EXPORT
+  SphericalEngine::CircleParallel<true, SphericalEngine::FULL, 3>
+  (const coeff[], const real[], real, real, real, unsigned);
+  template CircularEngine GEOGRAPHICLIB_EXPORT
+  SphericalEngine::CircleParallel<false, SphericalEngine::FULL, 3>
+  (const coeff[], const real[], real, real, real, unsigned);
+  template CircularEngine GEOGRAPHICLIB_EXPORT
+  SphericalEngine::CircleParallel<true, SphericalEngine::SCHMIDT, 3>
+  (const coeff[], const real[], real, real, real, unsigned);
+  template CircularEngine GEOGRAPHICLIB_EXPORT
+  SphericalEngine::CircleParallel<false, SphericalEngine::SCHMIDT, 3>
+  (const coeff[], const real[], real, real, real, unsigned);
+
   template CircularEngine GEOGRAPHICLIB_EXPORT
   SphericalEngine::Circle<true, SphericalEngine::FULL, 1>
   (const coeff[], const real[], real, real, real);
@@ -505,6 +2097,131 @@ namespace GeographicLib {
   template CircularEngine GEOGRAPHICLIB_EXPORT
   SphericalEngine::Circle<false, SphericalEngine::SCHMIDT, 3>
   (const coeff[], const real[], real, real, real);
-  /// \endcond
+
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Circle<true, SphericalEngine::FULL, 1>
+  (const coeff[], const real[], real, real, real, CircularEngine&);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Circle<false, SphericalEngine::FULL, 1>
+  (const coeff[], const real[], real, real, real, CircularEngine&);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Circle<true, SphericalEngine::SCHMIDT, 1>
+  (const coeff[], const real[], real, real, real, CircularEngine&);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Circle<false, SphericalEngine::SCHMIDT, 1>
+  (const coeff[], const real[], real, real, real, CircularEngine&);
+
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Circle<true, SphericalEngine::FULL, 2>
+  (const coeff[], const real[], real, real, real, CircularEngine&);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Circle<false, SphericalEngine::FULL, 2>
+  (const coeff[], const real[], real, real, real, CircularEngine&);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Circle<true, SphericalEngine::SCHMIDT, 2>
+  (const coeff[], const real[], real, real, real, CircularEngine&);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Circle<false, SphericalEngine::SCHMIDT, 2>
+  (const coeff[], const real[], real, real, real, CircularEngine&);
+
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Circle<true, SphericalEngine::FULL, 3>
+  (const coeff[], const real[], real, real, real, CircularEngine&);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Circle<false, SphericalEngine::FULL, 3>
+  (const coeff[], const real[], real, real, real, CircularEngine&);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Circle<true, SphericalEngine::SCHMIDT, 3>
+  (const coeff[], const real[], real, real, real, CircularEngine&);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Circle<false, SphericalEngine::SCHMIDT, 3>
+  (const coeff[], const real[], real, real, real, CircularEngine&);
+    template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::ValueMulti<true, SphericalEngine::FULL, 2>
+  (const coeff[], real, real, real, real, real[], real[], real[], real[]);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::ValueMulti<false, SphericalEngine::FULL, 2>
+  (const coeff[], real, real, real, real, real[], real[], real[], real[]);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::ValueMulti<true, SphericalEngine::SCHMIDT, 2>
+  (const coeff[], real, real, real, real, real[], real[], real[], real[]);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::ValueMulti<false, SphericalEngine::SCHMIDT, 2>
+  (const coeff[], real, real, real, real, real[], real[], real[], real[]);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::ValueMulti<true, SphericalEngine::FULL, 3>
+  (const coeff[], real, real, real, real, real[], real[], real[], real[]);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::ValueMulti<false, SphericalEngine::FULL, 3>
+  (const coeff[], real, real, real, real, real[], real[], real[], real[]);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::ValueMulti<true, SphericalEngine::SCHMIDT, 3>
+  (const coeff[], real, real, real, real, real[], real[], real[], real[]);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::ValueMulti<false, SphericalEngine::SCHMIDT, 3>
+  (const coeff[], real, real, real, real, real[], real[], real[], real[]);
+
+  template Math::real GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Hessian<SphericalEngine::FULL, 1>
+  (const coeff[], const real[], real, real, real, real, real&, real&, real&,
+   real[]);
+  template Math::real GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Hessian<SphericalEngine::SCHMIDT, 1>
+  (const coeff[], const real[], real, real, real, real, real&, real&, real&,
+   real[]);
+
+  template Math::real GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Hessian<SphericalEngine::FULL, 2>
+  (const coeff[], const real[], real, real, real, real, real&, real&, real&,
+   real[]);
+  template Math::real GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Hessian<SphericalEngine::SCHMIDT, 2>
+  (const coeff[], const real[], real, real, real, real, real&, real&, real&,
+   real[]);
+
+  template Math::real GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Hessian<SphericalEngine::FULL, 3>
+  (const coeff[], const real[], real, real, real, real, real&, real&, real&,
+   real[]);
+  template Math::real GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Hessian<SphericalEngine::SCHMIDT, 3>
+  (const coeff[], const real[], real, real, real, real, real&, real&, real&,
+   real[]);
+
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::CircleHessian<SphericalEngine::FULL, 1>
+  (const coeff[], const real[], real, real, real, CircularEngine&);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::CircleHessian<SphericalEngine::SCHMIDT, 1>
+  (const coeff[], const real[], real, real, real, CircularEngine&);
+
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::CircleHessian<SphericalEngine::FULL, 2>
+  (const coeff[], const real[], real, real, real, CircularEngine&);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::CircleHessian<SphericalEngine::SCHMIDT, 2>
+  (const coeff[], const real[], real, real, real, CircularEngine&);
+
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::CircleHessian<SphericalEngine::FULL, 3>
+  (const coeff[], const real[], real, real, real, CircularEngine&);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::CircleHessian<SphericalEngine::SCHMIDT, 3>
+  (const coeff[], const real[], real, real, real, CircularEngine&);
+
+  template Math::real GEOGRAPHICLIB_EXPORT
+  SphericalEngine::ValuePacked<true, SphericalEngine::FULL>
+  (const packedcoeff&, int, real, real, real, real, real&, real&, real&);
+  template Math::real GEOGRAPHICLIB_EXPORT
+  SphericalEngine::ValuePacked<false, SphericalEngine::FULL>
+  (const packedcoeff&, int, real, real, real, real, real&, real&, real&);
+  template Math::real GEOGRAPHICLIB_EXPORT
+  SphericalEngine::ValuePacked<true, SphericalEngine::SCHMIDT>
+  (const packedcoeff&, int, real, real, real, real, real&, real&, real&);
+  template Math::real GEOGRAPHICLIB_EXPORT
+  SphericalEngine::ValuePacked<false, SphericalEngine::SCHMIDT>
+  (const packedcoeff&, int, real, real, real, real, real&, real&, real&);
+
+/// \endcond
 
 } // namespace GeographicLib
@@ -0,0 +1,158 @@
+/**
+ * \file Trace.cpp
+ * \brief Implementation for GeographicLib::Trace class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#include <GeographicLib/Trace.hpp>
+// For getenv
+#include <cstdlib>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+#if defined(_MSC_VER)
+// Squelch warnings about unsafe use of getenv
+#  pragma warning (disable: 4996)
+#endif
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  namespace {
+    struct event {
+      const char* name;
+      long long start, dur;     // nanoseconds
+      int tid;
+    };
+    // The shared state is constructed on first use so that spans can be
+    // created during static initialization.
+    struct state {
+      atomic<bool> on;
+      atomic<Trace::handler> h;
+      atomic<int> nexttid;
+      chrono::steady_clock::time_point t0;
+      mutex m;
+      vector<event> events;
+      state() : on(false), h(nullptr), nexttid(0)
+              , t0(chrono::steady_clock::now()) {}
+    };
+    state& st() {
+      static state s;
+      return s;
+    }
+    long long now() {
+      return chrono::duration_cast<chrono::nanoseconds>
+        (chrono::steady_clock::now() - st().t0).count();
+    }
+    int threadid() {
+      thread_local int tid = st().nexttid.fetch_add(1);
+      return tid;
+    }
+    // Escape a span name for JSON
+    void writestring(ostream& os, const char* s) {
+      os << '"';
+      for (; *s; ++s) {
+        if (*s == '"' || *s == '\\')
+          os << '\\' << *s;
+        else if ((unsigned char)(*s) < 0x20)
+          os << "\\u" << hex << setw(4) << setfill('0') << int(*s)
+             << dec << setfill(' ');
+        else
+          os << *s;
+      }
+      os << '"';
+    }
+  }
+
+  void Trace::Enable(bool on) {
+    st().on.store(on, memory_order_relaxed);
+  }
+
+  bool Trace::Enabled() {
+    return st().on.load(memory_order_relaxed);
+  }
+
+  void Trace::SetHandler(handler h) {
+    st().h.store(h, memory_order_relaxed);
+  }
+
+  void Trace::Clear() {
+    state& s = st();
+    lock_guard<mutex> lock(s.m);
+    s.events.clear();
+  }
+
+  size_t Trace::Size() {
+    state& s = st();
+    lock_guard<mutex> lock(s.m);
+    return s.events.size();
+  }
+
+  void Trace::WriteJSON(ostream& os) {
+    state& s = st();
+    lock_guard<mutex> lock(s.m);
+    ios_base::fmtflags flags = os.flags();
+    os << "{\"traceEvents\":[";
+    os << fixed << setprecision(3);
+    for (size_t i = 0; i < s.events.size(); ++i) {
+      const event& e = s.events[i];
+      os << (i ? ",\n" : "\n") << "{\"name\":";
+      writestring(os, e.name);
+      os << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << e.tid
+         << ",\"ts\":" << double(e.start) / 1000
+         << ",\"dur\":" << double(e.dur) / 1000 << "}";
+    }
+    os << "\n],\"displayTimeUnit\":\"ns\"}\n";
+    os.flags(flags);
+  }
+
+  Trace::Span::Span(const char* name)
+    : _name(name)
+    , _start(0)
+    , _h(st().h.load(memory_order_relaxed))
+    , _rec(st().on.load(memory_order_relaxed))
+  {
+    if (_h) _h(_name, true);
+    if (_rec) _start = now();
+  }
+
+  Trace::Span::~Span() {
+    if (_rec) {
+      event e = {_name, _start, now() - _start, threadid()};
+      state& s = st();
+      lock_guard<mutex> lock(s.m);
+      s.events.push_back(e);
+    }
+    if (_h) _h(_name, false);
+  }
+
+  Trace::Session::Session() {
+#if GEOGRAPHICLIB_INSTRUMENT
+    const char* file = getenv("GEOGRAPHICLIB_TRACE");
+    if (file && *file) {
+      _file = file;
+      Enable(true);
+    }
+#endif
+  }
+
+  Trace::Session::~Session() {
+    if (_file.empty()) return;
+    Enable(false);
+    ofstream out(_file);
+    if (out.good())
+      WriteJSON(out);
+    else
+      cerr << "Cannot write trace to " << _file << "\n";
+  }
+
+} // namespace GeographicLib
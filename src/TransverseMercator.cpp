@@ -36,6 +36,8 @@
 
 #include <complex>
 #include <GeographicLib/TransverseMercator.hpp>
+#include <GeographicLib/SharedInstances.hpp>
+#include <GeographicLib/CPUDispatch.hpp>
 
 #if defined(_MSC_VER)
 // Squelch warnings about enum-float expressions
@@ -284,6 +286,19 @@ namespace GeographicLib {
     return utm;
   }
 
+#if GEOGRAPHICLIB_PRECISION != 5
+  namespace {
+    // Construct the UTM projection at load time (see Geodesic::WGS84())
+    const TransverseMercator& utminit_ = TransverseMercator::UTM();
+  }
+#endif
+
+  const TransverseMercator& TransverseMercator::Get(real a, real f, real k0) {
+    static SharedInstances<TransverseMercator> instances;
+    SharedInstances<TransverseMercator>::key_type key = {{a, f, k0, 0}};
+    return instances.Get(key, a, f, k0);
+  }
+
   // Engsager and Poder (2007) use trigonometric series to convert between phi
   // and phip.  Here are the series...
   //
@@ -350,26 +365,26 @@ namespace GeographicLib {
   // There are adapted from TransverseMercatorExact (taup and taupinv).  tau =
   // tan(phi), taup = sinh(psi)
 
-  void TransverseMercator::Forward(real lon0, real lat, real lon,
-                                   real& x, real& y,
-                                   real& gamma, real& k) const {
+  void TransverseMercator::ForwardStart(real lon0, real lat, real lon,
+                                        real& xip, real& etap,
+                                        real& gamma, real& k, int& latsign,
+                                        int& lonsign, bool& backside) const {
     lat = Math::LatFix(lat);
     lon = Math::AngDiff(lon0, lon);
     // Explicitly enforce the parity
-    int
-      latsign = signbit(lat) ? -1 : 1,
-      lonsign = signbit(lon) ? -1 : 1;
+    latsign = signbit(lat) ? -1 : 1;
+    lonsign = signbit(lon) ? -1 : 1;
     lon *= lonsign;
     lat *= latsign;
-    bool backside = lon > Math::qd;
+    backside = lon > Math::qd;
     if (backside) {
       if (lat == 0)
         latsign = -1;
       lon = Math::hd - lon;
     }
     real sphi, cphi, slam, clam;
-    Math::sincosd(lat, sphi, cphi);
-    Math::sincosd(lon, slam, clam);
+    Math::sincosdInline(lat, sphi, cphi);
+    Math::sincosdInline(lon, slam, clam);
     // phi = latitude
     // phi' = conformal latitude
     // psi = isometric latitude
@@ -387,7 +402,6 @@ namespace GeographicLib {
     //   cos(xip)   = cos(phi')*cos(lam)/denom = sech(psi)*cos(lam)/denom
     //   cosh(etap) = 1/denom                  = 1/denom
     //   sinh(etap) = cos(phi')*sin(lam)/denom = sech(psi)*sin(lam)/denom
-    real etap, xip;
     if (lat != Math::qd) {
       real
         tau = sphi / cphi,
@@ -400,7 +414,7 @@ namespace GeographicLib {
       // atan(tan(xip) * tanh(etap)) = atan(tan(lam) * sin(phi'));
       // sin(phi') = tau'/sqrt(1 + tau'^2)
       // Krueger p 22 (44)
-      gamma = Math::atan2d(slam * taup, clam * hypot(real(1), taup));
+      gamma = Math::atan2dInline(slam * taup, clam * hypot(real(1), taup));
       // k0 = sqrt(1 - _e2 * sin(phi)^2) * (cos(phi') / cos(phi)) * cosh(etap)
       // Note 1/cos(phi) = cosh(psip);
       // and cos(phi') * cosh(etap) = 1/hypot(sinh(psi), cos(lam))
@@ -416,6 +430,29 @@ namespace GeographicLib {
       gamma = lon;
       k = _c;
     }
+  }
+
+  void TransverseMercator::ForwardFinish(real xi, real eta, int latsign,
+                                         int lonsign, bool backside,
+                                         real& x, real& y,
+                                         real& gamma, real& k) const {
+    y = _a1 * _k0 * (backside ? Math::pi() - xi : xi) * latsign;
+    x = _a1 * _k0 * eta * lonsign;
+    if (backside)
+      gamma = Math::hd - gamma;
+    gamma *= latsign * lonsign;
+    gamma = Math::AngNormalizeInline(gamma);
+    k *= _k0;
+  }
+
+  void TransverseMercator::Forward(real lon0, real lat, real lon,
+                                   real& x, real& y,
+                                   real& gamma, real& k) const {
+    real xip, etap;
+    int latsign, lonsign;
+    bool backside;
+    ForwardStart(lon0, lat, lon, xip, etap, gamma, k,
+                 latsign, lonsign, backside);
     // {xi',eta'} is {northing,easting} for Gauss-Schreiber transverse Mercator
     // (for eta' = 0, xi' = bet). {xi,eta} is {northing,easting} for transverse
     // Mercator with constant scale on the central meridian (for eta = 0, xip =
@@ -504,16 +541,107 @@ namespace GeographicLib {
     y1 = complex<real>(xip, etap) + a * y0;
     // Fold in change in convergence and scale for Gauss-Schreiber TM to
     // Gauss-Krueger TM.
-    gamma -= Math::atan2d(z1.imag(), z1.real());
+    gamma -= Math::atan2dInline(z1.imag(), z1.real());
     k *= _b1 * abs(z1);
-    real xi = y1.real(), eta = y1.imag();
-    y = _a1 * _k0 * (backside ? Math::pi() - xi : xi) * latsign;
-    x = _a1 * _k0 * eta * lonsign;
+    ForwardFinish(y1.real(), y1.imag(), latsign, lonsign, backside,
+                  x, y, gamma, k);
+  }
+
+  template<typename T>
+  void TransverseMercator::IntForwardBatch(size_t n, real lon0,
+                                           const T lat[], const T lon[],
+                                           T x[], T y[],
+                                           T gamma[], T k[]) const {
+    // This follows Forward with the complex arithmetic in the Clenshaw
+    // summation written out in terms of real and imaginary parts (evaluated in
+    // the same order as by std::complex) for the K points in a batch.
+    const int K = batchsize_;
+    for (size_t i0 = 0; i0 < n; i0 += K) {
+      int nb = int(min(size_t(K), n - i0));
+      real xip[K], etap[K], gam[K], kk[K],
+        ar[K], ai[K], br[K], bi[K],
+        y0r[K], y0i[K], y1r[K], y1i[K], z0r[K], z0i[K], z1r[K], z1i[K];
+      int latsign[K], lonsign[K];
+      bool backside[K];
+      for (int j = 0; j < nb; ++j) {
+        size_t i = i0 + j;
+        ForwardStart(lon0, real(lat[i]), real(lon[i]),
+                     xip[j], etap[j], gam[j], kk[j],
+                     latsign[j], lonsign[j], backside[j]);
+        real
+          c0 = cos(2 * xip[j]), ch0 = cosh(2 * etap[j]),
+          s0 = sin(2 * xip[j]), sh0 = sinh(2 * etap[j]);
+        ar[j] = 2 * c0 * ch0; ai[j] = -2 * s0 * sh0; // 2 * cos(2*zeta')
+        br[j] = s0 * ch0; bi[j] = c0 * sh0;          // sin(2*zeta')
+      }
+      for (int j = nb; j < K; ++j) {
+        // Pad the batch with the last point
+        ar[j] = ar[nb - 1]; ai[j] = ai[nb - 1];
+      }
+      int m = maxpow_;
+      for (int j = 0; j < K; ++j) {
+        y0r[j] = m & 1 ?       _alp[m] : 0; y0i[j] = 0;
+        z0r[j] = m & 1 ? 2*m * _alp[m] : 0; z0i[j] = 0;
+        y1r[j] = y1i[j] = z1r[j] = z1i[j] = 0;
+      }
+      if (m & 1) --m;
+      while (m) {
+        for (int j = 0; j < K; ++j) {
+          real t;
+          t      = (ar[j] * y0r[j] - ai[j] * y0i[j]) - y1r[j] +       _alp[m];
+          y1i[j] = (ar[j] * y0i[j] + ai[j] * y0r[j]) - y1i[j];
+          y1r[j] = t;
+          t      = (ar[j] * z0r[j] - ai[j] * z0i[j]) - z1r[j] + 2*m * _alp[m];
+          z1i[j] = (ar[j] * z0i[j] + ai[j] * z0r[j]) - z1i[j];
+          z1r[j] = t;
+        }
+        --m;
+        for (int j = 0; j < K; ++j) {
+          real t;
+          t      = (ar[j] * y1r[j] - ai[j] * y1i[j]) - y0r[j] +       _alp[m];
+          y0i[j] = (ar[j] * y1i[j] + ai[j] * y1r[j]) - y0i[j];
+          y0r[j] = t;
+          t      = (ar[j] * z1r[j] - ai[j] * z1i[j]) - z0r[j] + 2*m * _alp[m];
+          z0i[j] = (ar[j] * z1i[j] + ai[j] * z1r[j]) - z0i[j];
+          z0r[j] = t;
+        }
+        --m;
+      }
+      for (int j = 0; j < nb; ++j) {
+        size_t i = i0 + j;
+        ar[j] /= real(2); ai[j] /= real(2);      // cos(2*zeta')
+        real
+          zr = (real(1) - z1r[j]) + (ar[j] * z0r[j] - ai[j] * z0i[j]),
+          zi = (real(0) - z1i[j]) + (ar[j] * z0i[j] + ai[j] * z0r[j]),
+          xi = xip[j] + (br[j] * y0r[j] - bi[j] * y0i[j]),
+          eta = etap[j] + (br[j] * y0i[j] + bi[j] * y0r[j]);
+        gam[j] -= Math::atan2dInline(zi, zr);
+        // abs(complex) (and not hypot) so that k matches Forward for all
+        // types of real
+        kk[j] *= _b1 * abs(complex<real>(zr, zi));
+        real xj, yj;
+        ForwardFinish(xi, eta, latsign[j], lonsign[j], backside[j],
+                      xj, yj, gam[j], kk[j]);
+        x[i] = T(xj); y[i] = T(yj);
+        if (gamma) gamma[i] = T(gam[j]);
+        if (k) k[i] = T(kk[j]);
+      }
+    }
+  }
+
+  void TransverseMercator::ReverseStart(real x, real y,
+                                        real& xi, real& eta, int& xisign,
+                                        int& etasign, bool& backside) const {
+    xi = y / (_a1 * _k0);
+    eta = x / (_a1 * _k0);
+    // Explicitly enforce the parity
+    xisign = signbit(xi) ? -1 : 1;
+    etasign = signbit(eta) ? -1 : 1;
+    xi *= xisign;
+    eta *= etasign;
+    backside = xi > Math::pi()/2;
     if (backside)
-      gamma = Math::hd - gamma;
-    gamma *= latsign * lonsign;
-    gamma = Math::AngNormalize(gamma);
-    k *= _k0;
+      xi = Math::pi() - xi;
   }
 
   void TransverseMercator::Reverse(real lon0, real x, real y,
@@ -522,18 +650,10 @@ namespace GeographicLib {
     // This undoes the steps in Forward.  The wrinkles are: (1) Use of the
     // reverted series to express zeta' in terms of zeta. (2) Newton's method
     // to solve for phi in terms of tan(phi).
-    real
-      xi = y / (_a1 * _k0),
-      eta = x / (_a1 * _k0);
-    // Explicitly enforce the parity
-    int
-      xisign = signbit(xi) ? -1 : 1,
-      etasign = signbit(eta) ? -1 : 1;
-    xi *= xisign;
-    eta *= etasign;
-    bool backside = xi > Math::pi()/2;
-    if (backside)
-      xi = Math::pi() - xi;
+    real xi, eta;
+    int xisign, etasign;
+    bool backside;
+    ReverseStart(x, y, xi, eta, xisign, etasign, backside);
     real
       c0 = cos(2 * xi), ch0 = cosh(2 * eta),
       s0 = sin(2 * xi), sh0 = sinh(2 * eta);
@@ -556,25 +676,282 @@ namespace GeographicLib {
     a = complex<real>(s0 * ch0, c0 * sh0); // sin(2*zeta)
     y1 = complex<real>(xi, eta) + a * y0;
     // Convergence and scale for Gauss-Schreiber TM to Gauss-Krueger TM.
-    gamma = Math::atan2d(z1.imag(), z1.real());
+    gamma = Math::atan2dInline(z1.imag(), z1.real());
     k = _b1 / abs(z1);
+    ReverseFinish(lon0, y1.real(), y1.imag(), xisign, etasign, backside,
+                  lat, lon, gamma, k);
+  }
+
+  template<typename T>
+  void TransverseMercator::IntReverseBatch(size_t n, real lon0,
+                                           const T x[], const T y[],
+                                           T lat[], T lon[],
+                                           T gamma[], T k[]) const {
+    // This follows Reverse in the same way that ForwardBatch follows Forward.
+    const int K = batchsize_;
+    for (size_t i0 = 0; i0 < n; i0 += K) {
+      int nb = int(min(size_t(K), n - i0));
+      real xi[K], eta[K],
+        ar[K], ai[K], br[K], bi[K],
+        y0r[K], y0i[K], y1r[K], y1i[K], z0r[K], z0i[K], z1r[K], z1i[K];
+      int xisign[K], etasign[K];
+      bool backside[K];
+      for (int j = 0; j < nb; ++j) {
+        size_t i = i0 + j;
+        ReverseStart(real(x[i]), real(y[i]), xi[j], eta[j],
+                     xisign[j], etasign[j], backside[j]);
+        real
+          c0 = cos(2 * xi[j]), ch0 = cosh(2 * eta[j]),
+          s0 = sin(2 * xi[j]), sh0 = sinh(2 * eta[j]);
+        ar[j] = 2 * c0 * ch0; ai[j] = -2 * s0 * sh0; // 2 * cos(2*zeta)
+        br[j] = s0 * ch0; bi[j] = c0 * sh0;          // sin(2*zeta)
+      }
+      for (int j = nb; j < K; ++j) {
+        // Pad the batch with the last point
+        ar[j] = ar[nb - 1]; ai[j] = ai[nb - 1];
+      }
+      int m = maxpow_;
+      for (int j = 0; j < K; ++j) {
+        y0r[j] = m & 1 ?       -_bet[m] : 0; y0i[j] = 0;
+        z0r[j] = m & 1 ? -2*m * _bet[m] : 0; z0i[j] = 0;
+        y1r[j] = y1i[j] = z1r[j] = z1i[j] = 0;
+      }
+      if (m & 1) --m;
+      while (m) {
+        for (int j = 0; j < K; ++j) {
+          real t;
+          t      = (ar[j] * y0r[j] - ai[j] * y0i[j]) - y1r[j] -       _bet[m];
+          y1i[j] = (ar[j] * y0i[j] + ai[j] * y0r[j]) - y1i[j];
+          y1r[j] = t;
+          t      = (ar[j] * z0r[j] - ai[j] * z0i[j]) - z1r[j] - 2*m * _bet[m];
+          z1i[j] = (ar[j] * z0i[j] + ai[j] * z0r[j]) - z1i[j];
+          z1r[j] = t;
+        }
+        --m;
+        for (int j = 0; j < K; ++j) {
+          real t;
+          t      = (ar[j] * y1r[j] - ai[j] * y1i[j]) - y0r[j] -       _bet[m];
+          y0i[j] = (ar[j] * y1i[j] + ai[j] * y1r[j]) - y0i[j];
+          y0r[j] = t;
+          t      = (ar[j] * z1r[j] - ai[j] * z1i[j]) - z0r[j] - 2*m * _bet[m];
+          z0i[j] = (ar[j] * z1i[j] + ai[j] * z1r[j]) - z0i[j];
+          z0r[j] = t;
+        }
+        --m;
+      }
+      for (int j = 0; j < nb; ++j) {
+        size_t i = i0 + j;
+        ar[j] /= real(2); ai[j] /= real(2);      // cos(2*zeta)
+        real
+          zr = (real(1) - z1r[j]) + (ar[j] * z0r[j] - ai[j] * z0i[j]),
+          zi = (real(0) - z1i[j]) + (ar[j] * z0i[j] + ai[j] * z0r[j]),
+          xip = xi[j] + (br[j] * y0r[j] - bi[j] * y0i[j]),
+          etap = eta[j] + (br[j] * y0i[j] + bi[j] * y0r[j]),
+          gam = Math::atan2dInline(zi, zr),
+          kk = _b1 / abs(complex<real>(zr, zi)),
+          latj, lonj;
+        ReverseFinish(lon0, xip, etap, xisign[j], etasign[j], backside[j],
+                      latj, lonj, gam, kk);
+        lat[i] = T(latj); lon[i] = T(lonj);
+        if (gamma) gamma[i] = T(gam);
+        if (k) k[i] = T(kk);
+      }
+    }
+  }
+
+  void TransverseMercator::ForwardBatch(size_t n, real lon0,
+                                        const real lat[], const real lon[],
+                                        real x[], real y[],
+                                        real gamma[], real k[]) const {
+    CPUDispatch::Run([&]() -> void {
+      IntForwardBatch(n, lon0, lat, lon, x, y, gamma, k);
+    });
+  }
+
+  void TransverseMercator::ReverseBatch(size_t n, real lon0,
+                                        const real x[], const real y[],
+                                        real lat[], real lon[],
+                                        real gamma[], real k[]) const {
+    CPUDispatch::Run([&]() -> void {
+      IntReverseBatch(n, lon0, x, y, lat, lon, gamma, k);
+    });
+  }
+
+  void TransverseMercator::TransferBatch(size_t n, real lon0in,
+                                         const real xin[], const real yin[],
+                                         real lon0out,
+                                         real xout[], real yout[],
+                                         real lon[]) const {
+    CPUDispatch::Run([&]() -> void {
+      IntTransferBatch(n, lon0in, xin, yin, lon0out, xout, yout, lon);
+    });
+  }
+
+  void TransverseMercator::IntTransferBatch(size_t n, real lon0in,
+                                            const real xin[],
+                                            const real yin[],
+                                            real lon0out,
+                                            real xout[], real yout[],
+                                            real lon[]) const {
+    // This follows ReverseBatch up to the computation of tan(phi') in
+    // ReverseFinish and then ForwardBatch from the computation of xi' and
+    // eta' in ForwardStart.  Only the Clenshaw sums for the coordinates are
+    // needed (not those for the convergence and scale).
+    const int K = batchsize_;
+    // Sum the series with coefficients c[1..maxpow_] times sgn for the
+    // points with 2 * cos(2*zeta) = ar + i*ai
+    auto clenshaw = [](const real c[], real sgn,
+                       const real ar[], const real ai[],
+                       real y0r[], real y0i[]) -> void {
+      real y1r[K], y1i[K];
+      int m = maxpow_;
+      for (int j = 0; j < K; ++j) {
+        y0r[j] = m & 1 ? sgn * c[m] : 0; y0i[j] = 0;
+        y1r[j] = y1i[j] = 0;
+      }
+      if (m & 1) --m;
+      while (m) {
+        for (int j = 0; j < K; ++j) {
+          real t;
+          t      = (ar[j] * y0r[j] - ai[j] * y0i[j]) - y1r[j] + sgn * c[m];
+          y1i[j] = (ar[j] * y0i[j] + ai[j] * y0r[j]) - y1i[j];
+          y1r[j] = t;
+        }
+        --m;
+        for (int j = 0; j < K; ++j) {
+          real t;
+          t      = (ar[j] * y1r[j] - ai[j] * y1i[j]) - y0r[j] + sgn * c[m];
+          y0i[j] = (ar[j] * y1i[j] + ai[j] * y1r[j]) - y0i[j];
+          y0r[j] = t;
+        }
+        --m;
+      }
+    };
+    for (size_t i0 = 0; i0 < n; i0 += K) {
+      int nb = int(min(size_t(K), n - i0));
+      real xi[K], eta[K], ar[K], ai[K], br[K], bi[K], y0r[K], y0i[K];
+      int xisign[K], etasign[K], latsign[K], lonsign[K];
+      bool backside[K];
+      for (int j = 0; j < nb; ++j) {
+        ReverseStart(xin[i0 + j], yin[i0 + j], xi[j], eta[j],
+                     xisign[j], etasign[j], backside[j]);
+        real
+          c0 = cos(2 * xi[j]), ch0 = cosh(2 * eta[j]),
+          s0 = sin(2 * xi[j]), sh0 = sinh(2 * eta[j]);
+        ar[j] = 2 * c0 * ch0; ai[j] = -2 * s0 * sh0; // 2 * cos(2*zeta)
+        br[j] = s0 * ch0; bi[j] = c0 * sh0;          // sin(2*zeta)
+      }
+      for (int j = nb; j < K; ++j) {
+        // Pad the batch with the last point
+        ar[j] = ar[nb - 1]; ai[j] = ai[nb - 1];
+      }
+      clenshaw(_bet, -1, ar, ai, y0r, y0i);
+      for (int j = 0; j < nb; ++j) {
+        real
+          xip = xi[j] + (br[j] * y0r[j] - bi[j] * y0i[j]),
+          etap = eta[j] + (br[j] * y0i[j] + bi[j] * y0r[j]),
+          s = sinh(etap),
+          c = fmax(real(0), cos(xip)), // cos(pi/2) might be negative
+          r = hypot(s, c),
+          lam, taup;
+        // The longitude and tan(phi') as in ReverseFinish
+        if (r != 0) {
+          lam = Math::atan2dInline(s, c);
+          taup = sin(xip) / r;
+        } else {
+          lam = 0;
+          taup = Math::infinity();
+        }
+        taup *= xisign[j];
+        if (backside[j])
+          lam = Math::hd - lam;
+        lam *= etasign[j];
+        lam = Math::AngNormalizeInline(lam + lon0in);
+        if (lon) lon[i0 + j] = lam;
+        // xi' and eta' as in ForwardStart
+        lam = Math::AngDiff(lon0out, lam);
+        latsign[j] = signbit(taup) ? -1 : 1;
+        lonsign[j] = signbit(lam) ? -1 : 1;
+        lam *= lonsign[j];
+        taup *= latsign[j];
+        backside[j] = lam > Math::qd;
+        if (backside[j]) {
+          if (taup == 0)
+            latsign[j] = -1;
+          lam = Math::hd - lam;
+        }
+        real slam, clam;
+        Math::sincosdInline(lam, slam, clam);
+        if (isfinite(taup)) {
+          xi[j] = atan2(taup, clam);
+          eta[j] = asinh(slam / hypot(taup, clam));
+        } else {
+          xi[j] = Math::pi()/2;
+          eta[j] = 0;
+        }
+        real
+          c0 = cos(2 * xi[j]), ch0 = cosh(2 * eta[j]),
+          s0 = sin(2 * xi[j]), sh0 = sinh(2 * eta[j]);
+        ar[j] = 2 * c0 * ch0; ai[j] = -2 * s0 * sh0; // 2 * cos(2*zeta')
+        br[j] = s0 * ch0; bi[j] = c0 * sh0;          // sin(2*zeta')
+      }
+      for (int j = nb; j < K; ++j) {
+        ar[j] = ar[nb - 1]; ai[j] = ai[nb - 1];
+      }
+      clenshaw(_alp, 1, ar, ai, y0r, y0i);
+      for (int j = 0; j < nb; ++j) {
+        real
+          xij = xi[j] + (br[j] * y0r[j] - bi[j] * y0i[j]),
+          etaj = eta[j] + (br[j] * y0i[j] + bi[j] * y0r[j]);
+        // As in ForwardFinish
+        yout[i0 + j] = _a1 * _k0 * (backside[j] ? Math::pi() - xij : xij)
+          * latsign[j];
+        xout[i0 + j] = _a1 * _k0 * etaj * lonsign[j];
+      }
+    }
+  }
+
+#if GEOGRAPHICLIB_PRECISION != 1
+  void TransverseMercator::ForwardBatch(size_t n, real lon0,
+                                        const float lat[], const float lon[],
+                                        float x[], float y[],
+                                        float gamma[], float k[]) const {
+    CPUDispatch::Run([&]() -> void {
+      IntForwardBatch(n, lon0, lat, lon, x, y, gamma, k);
+    });
+  }
+
+  void TransverseMercator::ReverseBatch(size_t n, real lon0,
+                                        const float x[], const float y[],
+                                        float lat[], float lon[],
+                                        float gamma[], float k[]) const {
+    CPUDispatch::Run([&]() -> void {
+      IntReverseBatch(n, lon0, x, y, lat, lon, gamma, k);
+    });
+  }
+#endif
+
+  void TransverseMercator::ReverseFinish(real lon0, real xip, real etap,
+                                         int xisign, int etasign,
+                                         bool backside,
+                                         real& lat, real& lon,
+                                         real& gamma, real& k) const {
     // JHS 154 has
     //
     //   phi' = asin(sin(xi') / cosh(eta')) (Krueger p 17 (25))
     //   lam = asin(tanh(eta') / cos(phi')
     //   psi = asinh(tan(phi'))
     real
-      xip = y1.real(), etap = y1.imag(),
       s = sinh(etap),
       c = fmax(real(0), cos(xip)), // cos(pi/2) might be negative
       r = hypot(s, c);
     if (r != 0) {
-      lon = Math::atan2d(s, c); // Krueger p 17 (25)
+      lon = Math::atan2dInline(s, c); // Krueger p 17 (25)
       // Use Newton's method to solve for tau
       real
         sxip = sin(xip),
         tau = Math::tauf(sxip/r, _es);
-      gamma += Math::atan2d(sxip * tanh(etap), c); // Krueger p 19 (31)
+      gamma += Math::atan2dInline(sxip * tanh(etap), c); // Krueger p 19 (31)
       lat = Math::atand(tau);
       // Note cos(phi') * cosh(eta') = r
       k *= sqrt(_e2m + _e2 / (1 + Math::sq(tau))) *
@@ -588,11 +965,11 @@ namespace GeographicLib {
     if (backside)
       lon = Math::hd - lon;
     lon *= etasign;
-    lon = Math::AngNormalize(lon + lon0);
+    lon = Math::AngNormalizeInline(lon + lon0);
     if (backside)
       gamma = Math::hd - gamma;
     gamma *= xisign * etasign;
-    gamma = Math::AngNormalize(gamma);
+    gamma = Math::AngNormalizeInline(gamma);
     k *= _k0;
   }
 
@@ -53,7 +53,8 @@ namespace GeographicLib {
   using namespace std;
 
   TransverseMercatorExact::TransverseMercatorExact(real a, real f, real k0,
-                                                   bool extendp)
+                                                   bool extendp,
+                                                   bool seedtable)
     : tol_(numeric_limits<real>::epsilon())
     , tol2_(real(0.1) * tol_)
     , taytol_(pow(tol_, real(0.6)))
@@ -64,6 +65,7 @@ namespace GeographicLib {
     , _mv(1 - _mu)              // 1 - e^2
     , _e(sqrt(_mu))
     , _extendp(extendp)
+    , _seedp(false)
     , _eEu(_mu)
     , _eEv(_mv)
   {
@@ -75,6 +77,73 @@ namespace GeographicLib {
       throw GeographicErr("Polar semi-axis is not positive");
     if (!(isfinite(_k0) && _k0 > 0))
       throw GeographicErr("Scale is not positive");
+    if (seedtable)
+      SeedTables();
+  }
+
+  void TransverseMercatorExact::SeedTables() {
+    // The tables cover 0 <= lam <= pi/3 and
+    // 0 <= psi <= (zetanx_-1)/(zetany_-1) * pi/3 (so lat <= 88d); and
+    // 0 <= xi <= Eu.E() and 0 <= eta <= 1.3.  Over these regions zetainv0
+    // and sigmainv0 use the spherical and linear starting guesses, whose
+    // errors are smooth and O(e^2).  With the tabulated corrections, the
+    // error in the starting guess is usually small enough for Newton's method
+    // to converge with 2 iterations.
+    _zetah = (Math::pi()/3) / (zetany_ - 1);
+    _sigmahx = _eEu.E() / (sigmanx_ - 1);
+    _sigmahy = real(1.3) / (sigmany_ - 1);
+    _zetatab.resize(2 * zetanx_ * zetany_);
+    _sigmatab.resize(2 * sigmanx_ * sigmany_);
+    for (int i = 0; i < zetanx_; ++i)
+      for (int j = 0; j < zetany_; ++j) {
+        real psi = i * _zetah, lam = j * _zetah, u, v, u0, v0;
+        zetainv(sinh(psi), lam, u, v);
+        zetainv0(psi, lam, u0, v0);
+        _zetatab[2 * (i * zetany_ + j)    ] = u - u0;
+        _zetatab[2 * (i * zetany_ + j) + 1] = v - v0;
+      }
+    for (int i = 0; i < sigmanx_; ++i)
+      for (int j = 0; j < sigmany_; ++j) {
+        real xi = i * _sigmahx, eta = j * _sigmahy, u, v, u0, v0;
+        sigmainv(xi, eta, u, v);
+        sigmainv0(xi, eta, u0, v0);
+        _sigmatab[2 * (i * sigmany_ + j)    ] = u - u0;
+        _sigmatab[2 * (i * sigmany_ + j) + 1] = v - v0;
+      }
+    _seedp = true;
+#if GEOGRAPHICLIB_INSTRUMENT
+    ResetStatistics();
+#endif
+  }
+
+  void TransverseMercatorExact::seedinterp(const real tab[], int nx, int ny,
+                                           real x, real y,
+                                           real& du, real& dv) {
+    // Tensor product of cubic Lagrange interpolants using the 4 x 4 block of
+    // nodes surrounding (x, y), where x and y are measured in units of the
+    // node spacing.  The block is shifted inwards at the edges of the table.
+    int
+      ix = min(max(int(floor(x)) - 1, 0), nx - 4),
+      iy = min(max(int(floor(y)) - 1, 0), ny - 4);
+    x -= ix; y -= iy;
+    real wx[4], wy[4];
+    wx[0] = -(x - 1) * (x - 2) * (x - 3) / 6;
+    wx[1] =  x * (x - 2) * (x - 3) / 2;
+    wx[2] = -x * (x - 1) * (x - 3) / 2;
+    wx[3] =  x * (x - 1) * (x - 2) / 6;
+    wy[0] = -(y - 1) * (y - 2) * (y - 3) / 6;
+    wy[1] =  y * (y - 2) * (y - 3) / 2;
+    wy[2] = -y * (y - 1) * (y - 3) / 2;
+    wy[3] =  y * (y - 1) * (y - 2) / 6;
+    du = dv = 0;
+    for (int i = 0; i < 4; ++i) {
+      const real* t = tab + 2 * ((ix + i) * ny + iy);
+      real su = 0, sv = 0;
+      for (int j = 0; j < 4; ++j) {
+        su += wy[j] * t[2 * j]; sv += wy[j] * t[2 * j + 1];
+      }
+      du += wx[i] * su; dv += wx[i] * sv;
+    }
   }
 
   const TransverseMercatorExact& TransverseMercatorExact::UTM() {
@@ -191,11 +260,23 @@ namespace GeographicLib {
     real
       psi = asinh(taup),
       scal = 1/hypot(real(1), taup);
-    if (zetainv0(psi, lam, u, v))
+    if (zetainv0(psi, lam, u, v)) {
+#if GEOGRAPHICLIB_INSTRUMENT
+      _zetainvit.Add(0);
+#endif
       return;
+    }
+    if (_seedp && psi >= 0 && psi <= (zetanx_ - 1) * _zetah &&
+        lam >= 0 && lam <= (zetany_ - 1) * _zetah) {
+      real du, dv;
+      seedinterp(_zetatab.data(), zetanx_, zetany_,
+                 psi / _zetah, lam / _zetah, du, dv);
+      u += du; v += dv;
+    }
     real stol2 = tol2_ / Math::sq(fmax(psi, real(1)));
     // min iterations = 2, max iterations = 6; mean = 4.0
-    for (int i = 0, trip = 0; i < numit_ || GEOGRAPHICLIB_PANIC; ++i) {
+    int i = 0;
+    for (int trip = 0; i < numit_ || GEOGRAPHICLIB_PANIC; ++i) {
       real snu, cnu, dnu, snv, cnv, dnv;
       _eEu.sncndn(u, snu, cnu, dnu);
       _eEv.sncndn(v, snv, cnv, dnv);
@@ -210,12 +291,17 @@ namespace GeographicLib {
         delv = tau1 * dv1 + lam1 * du1;
       u -= delu;
       v -= delv;
-      if (trip)
+      if (trip) {
+        ++i;
         break;
+      }
       real delw2 = Math::sq(delu) + Math::sq(delv);
       if (!(delw2 >= stol2))
         ++trip;
     }
+#if GEOGRAPHICLIB_INSTRUMENT
+    _zetainvit.Add(i);
+#endif
   }
 
   void TransverseMercatorExact::sigma(real /*u*/, real snu, real cnu, real dnu,
@@ -296,10 +382,22 @@ namespace GeographicLib {
   // Invert sigma using Newton's method
   void TransverseMercatorExact::sigmainv(real xi, real eta,
                                          real& u, real& v) const {
-    if (sigmainv0(xi, eta, u, v))
+    if (sigmainv0(xi, eta, u, v)) {
+#if GEOGRAPHICLIB_INSTRUMENT
+      _sigmainvit.Add(0);
+#endif
       return;
+    }
+    if (_seedp && xi >= 0 && xi <= (sigmanx_ - 1) * _sigmahx &&
+        eta >= 0 && eta <= (sigmany_ - 1) * _sigmahy) {
+      real du, dv;
+      seedinterp(_sigmatab.data(), sigmanx_, sigmany_,
+                 xi / _sigmahx, eta / _sigmahy, du, dv);
+      u += du; v += dv;
+    }
     // min iterations = 2, max iterations = 7; mean = 3.9
-    for (int i = 0, trip = 0; i < numit_ || GEOGRAPHICLIB_PANIC; ++i) {
+    int i = 0;
+    for (int trip = 0; i < numit_ || GEOGRAPHICLIB_PANIC; ++i) {
       real snu, cnu, dnu, snv, cnv, dnv;
       _eEu.sncndn(u, snu, cnu, dnu);
       _eEv.sncndn(v, snv, cnv, dnv);
@@ -313,12 +411,17 @@ namespace GeographicLib {
         delv = xi1 * dv1 + eta1 * du1;
       u -= delu;
       v -= delv;
-      if (trip)
+      if (trip) {
+        ++i;
         break;
+      }
       real delw2 = Math::sq(delu) + Math::sq(delv);
       if (!(delw2 >= tol2_))
         ++trip;
     }
+#if GEOGRAPHICLIB_INSTRUMENT
+    _sigmainvit.Add(i);
+#endif
   }
 
   void TransverseMercatorExact::Scale(real tau, real /*lam*/,
@@ -349,7 +452,8 @@ namespace GeographicLib {
 
   void TransverseMercatorExact::Forward(real lon0, real lat, real lon,
                                         real& x, real& y,
-                                        real& gamma, real& k) const {
+                                        real& gamma, real& k,
+                                        bool scalep) const {
     lat = Math::LatFix(lat);
     lon = Math::AngDiff(lon0, lon);
     // Explicitly enforce the parity
@@ -390,6 +494,8 @@ namespace GeographicLib {
       xi = 2 * _eEu.E() - xi;
     y = xi * _a * _k0 * latsign;
     x = eta * _a * _k0 * lonsign;
+    if (!scalep)
+      return;
 
     if (lat == Math::qd) {
       gamma = lon;
@@ -461,4 +567,33 @@ namespace GeographicLib {
     k *= _k0;
   }
 
+  void TransverseMercatorExact::ForwardBatch(size_t n, real lon0,
+                                             const real lat[],
+                                             const real lon[],
+                                             real x[], real y[],
+                                             real gamma[], real k[]) const {
+    // Skip the computation of gamma and k if they're not needed
+    bool scalep = gamma || k;
+    for (size_t i = 0; i < n; ++i) {
+      real xi, yi, gi, ki;
+      Forward(lon0, lat[i], lon[i], xi, yi, gi, ki, scalep);
+      x[i] = xi; y[i] = yi;
+      if (gamma) gamma[i] = gi;
+      if (k) k[i] = ki;
+    }
+  }
+
+  void TransverseMercatorExact::ReverseBatch(size_t n, real lon0,
+                                             const real x[], const real y[],
+                                             real lat[], real lon[],
+                                             real gamma[], real k[]) const {
+    for (size_t i = 0; i < n; ++i) {
+      real lati, loni, gi, ki;
+      Reverse(lon0, x[i], y[i], lati, loni, gi, ki);
+      lat[i] = lati; lon[i] = loni;
+      if (gamma) gamma[i] = gi;
+      if (k) k[i] = ki;
+    }
+  }
+
 } // namespace GeographicLib
@@ -0,0 +1,255 @@
+/**
+ * \file TriaxialGeodesic.cpp
+ * \brief Implementation for GeographicLib::TriaxialGeodesic class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#include <GeographicLib/TriaxialGeodesic.hpp>
+#include <GeographicLib/TriaxialGeodesicLine.hpp>
+#include <algorithm>
+#include <limits>
+
+#if defined(_MSC_VER)
+// Squelch warnings about constant conditional expressions
+#  pragma warning (disable: 4127)
+#endif
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  TriaxialGeodesic::TriaxialGeodesic(real a, real b, real c)
+    : _a(a)
+    , _b(b)
+    , _c(c)
+  {
+    if (!(isfinite(_a) && _a > _b))
+      throw GeographicErr("Major radius is not positive or not larger "
+                          "than median radius");
+    if (!(isfinite(_c) && _c > 0))
+      throw GeographicErr("Minor radius is not positive");
+    if (!(_b > _c))
+      throw GeographicErr("Median radius is not larger than minor radius");
+    real d = (_a - _c) * (_a + _c);
+    _k2 = (_b - _c) * (_b + _c) / d;
+    _kp2 = (_a - _b) * (_a + _b) / d;
+  }
+
+  void TriaxialGeodesic::cart(real sbet, real cbet, real somg, real comg,
+                              real r[]) const {
+    r[0] = _a * comg * sqrt(_k2 * Math::sq(cbet) + _kp2);
+    r[1] = _b * cbet * somg;
+    r[2] = _c * sbet * sqrt(_k2 + _kp2 * Math::sq(somg));
+  }
+
+  void TriaxialGeodesic::tangents(real sbet, real cbet, real somg, real comg,
+                                  real ebet[], real eomg[]) const {
+    // Unit vectors in the directions of increasing bet and omg.  These are
+    // orthogonal (except at the umbilical points where they are undefined).
+    real
+      A = sqrt(_k2 * Math::sq(cbet) + _kp2),
+      B = sqrt(_k2 + _kp2 * Math::sq(somg));
+    ebet[0] = -_a * comg * _k2 * cbet * sbet / A;
+    ebet[1] = -_b * sbet * somg;
+    ebet[2] = _c * cbet * B;
+    eomg[0] = -_a * somg * A;
+    eomg[1] = _b * cbet * comg;
+    eomg[2] = _c * sbet * _kp2 * somg * comg / B;
+    real
+      nb = hypot(hypot(ebet[0], ebet[1]), ebet[2]),
+      no = hypot(hypot(eomg[0], eomg[1]), eomg[2]);
+    for (int i = 0; i < 3; ++i) { ebet[i] /= nb; eomg[i] /= no; }
+  }
+
+  void TriaxialGeodesic::ToCartesian(real bet, real omg,
+                                     real& X, real& Y, real& Z) const {
+    real sbet, cbet, somg, comg, r[3];
+    Math::sincosd(bet, sbet, cbet);
+    Math::sincosd(omg, somg, comg);
+    cart(sbet, cbet, somg, comg, r);
+    X = r[0]; Y = r[1]; Z = r[2];
+  }
+
+  void TriaxialGeodesic::FromCartesian(real X, real Y, real Z,
+                                       real& bet, real& omg) const {
+    // With u = sin(bet)^2 and w = cos(omg)^2,
+    //   x2 = (X/a)^2 = w * (1 - k^2 * u)
+    //   z2 = (Z/c)^2 = u * (1 - kp^2 * w)
+    // so that q = u * w satisfies k^2*kp^2*q^2 + (kp^2*x2 + k^2*z2 - 1)*q +
+    // x2*z2 = 0; the smaller root is the right one.
+    real
+      x2 = Math::sq(X / _a), z2 = Math::sq(Z / _c),
+      A = _k2 * _kp2,
+      B = _kp2 * x2 + _k2 * z2 - 1,
+      C = x2 * z2,
+      disc = fmax(real(0), Math::sq(B) - 4 * A * C),
+      q = C == 0 ? 0 : 2 * C / (-B + sqrt(disc)),
+      u = fmin(real(1), fmax(real(0), z2 + _kp2 * q)),
+      w = fmin(real(1), fmax(real(0), x2 + _k2 * q)),
+      sbet = copysign(sqrt(u), Z), cbet = sqrt(1 - u),
+      comg = copysign(sqrt(w), X),
+      somg = signbit(Y) ? -sqrt(1 - w) : sqrt(1 - w);
+    bet = Math::atan2d(sbet, cbet);
+    omg = Math::atan2d(somg, comg);
+  }
+
+  TriaxialGeodesicLine TriaxialGeodesic::Line(real bet1, real omg1,
+                                              real alp1) const {
+    return TriaxialGeodesicLine(*this, bet1, omg1, alp1);
+  }
+
+  void TriaxialGeodesic::Direct(real bet1, real omg1, real alp1, real s12,
+                                real& bet2, real& omg2, real& alp2) const {
+    TriaxialGeodesicLine(*this, bet1, omg1, alp1).Position(s12,
+                                                           bet2, omg2, alp2);
+  }
+
+  void TriaxialGeodesic::DirectBatch(size_t n, const real bet1[],
+                                     const real omg1[], const real alp1[],
+                                     const real s12[], real bet2[],
+                                     real omg2[], real alp2[]) const {
+    real alp2x;
+    for (size_t i = 0; i < n; ++i) {
+      Direct(bet1[i], omg1[i], alp1[i], s12[i], bet2[i], omg2[i], alp2x);
+      if (alp2) alp2[i] = alp2x;
+    }
+  }
+
+  bool TriaxialGeodesic::Newton(real bet1, real omg1, const real r2[],
+                                real& s12, real& alp1) const {
+    // Newton's method on (s12, alp1) to reduce the miss distance r2 - r(s12).
+    // The derivative with respect to s12 is the tangent t at the end point;
+    // the derivative with respect to alp1 is m12 * n where n is the normal
+    // to t in the tangent plane and the reduced length m12 is found by
+    // differencing neighboring geodesics.
+    static const int maxit = 30;
+    static const real
+      tol = 256 * numeric_limits<real>::epsilon(),
+      h = cbrt(numeric_limits<real>::epsilon()), // in radians
+      hd = h / Math::degree(),
+      maxdalp = 0.5;                  // max change in alp1 (radians)
+    real tola = tol * _a;
+    for (int i = 0; i < maxit; ++i) {
+      real bet2, omg2, alp2, r[3], ebet[3], eomg[3];
+      Line(bet1, omg1, alp1).Position(s12, bet2, omg2, alp2);
+      real sbet2, cbet2, somg2, comg2, salp2, calp2;
+      Math::sincosd(bet2, sbet2, cbet2);
+      Math::sincosd(omg2, somg2, comg2);
+      Math::sincosd(alp2, salp2, calp2);
+      cart(sbet2, cbet2, somg2, comg2, r);
+      tangents(sbet2, cbet2, somg2, comg2, ebet, eomg);
+      real dr[3], t[3], n[3];
+      for (int k = 0; k < 3; ++k) {
+        dr[k] = r2[k] - r[k];
+        t[k] = calp2 * ebet[k] + salp2 * eomg[k];
+        n[k] = -salp2 * ebet[k] + calp2 * eomg[k];
+      }
+      real err = hypot(hypot(dr[0], dr[1]), dr[2]);
+      if (!isfinite(err)) return false;
+      real rp[3], rm[3];
+      Line(bet1, omg1, alp1 + hd).Position(s12, bet2, omg2, alp2);
+      ToCartesian(bet2, omg2, rp[0], rp[1], rp[2]);
+      Line(bet1, omg1, alp1 - hd).Position(s12, bet2, omg2, alp2);
+      ToCartesian(bet2, omg2, rm[0], rm[1], rm[2]);
+      real ds = 0, dn = 0, m12 = 0;
+      for (int k = 0; k < 3; ++k) {
+        ds += dr[k] * t[k];
+        dn += dr[k] * n[k];
+        m12 += (rp[k] - rm[k]) * n[k];
+      }
+      m12 /= 2 * h;
+      if (!(fabs(m12) > 0)) return false;
+      real dalp = fmin(maxdalp, fmax(-maxdalp, dn / m12));
+      s12 += ds;
+      alp1 = Math::AngNormalize(alp1 + dalp / Math::degree());
+      // The final correction reduces the error to roundoff.
+      if (err <= tola) return true;
+    }
+    return false;
+  }
+
+  bool TriaxialGeodesic::Search(real bet1, real omg1,
+                                const real r2[], bool have,
+                                real& s12, real& alp1) const {
+    // Sample geodesics from point 1 in nalp directions up to a distance pi*a
+    // (which bounds the length of the shortest geodesic) and refine the
+    // closest approaches to point 2 with Newton's method.
+    static const int nalp = 16, ns = 32, ncand = 4;
+    struct cand { real d, s, alp; };
+    vector<cand> cands;
+    cands.reserve(nalp);
+    for (int i = 0; i < nalp; ++i) {
+      real alp = -Math::hd + (i + real(0.5)) * (Math::td / nalp);
+      TriaxialGeodesicLine l(*this, bet1, omg1, alp);
+      cand best = { Math::infinity(), 0, alp };
+      for (int j = 1; j <= ns; ++j) {
+        real s = j * (Math::pi() * _a / ns), bet2, omg2, alp2, r[3];
+        l.Position(s, bet2, omg2, alp2);
+        ToCartesian(bet2, omg2, r[0], r[1], r[2]);
+        real d = hypot(hypot(r[0] - r2[0], r[1] - r2[1]), r[2] - r2[2]);
+        if (d < best.d) { best.d = d; best.s = s; }
+      }
+      cands.push_back(best);
+    }
+    sort(cands.begin(), cands.end(),
+         [](const cand& x, const cand& y) -> bool { return x.d < y.d; });
+    bool found = have;
+    for (int i = 0; i < ncand; ++i) {
+      real s = cands[i].s, alp = cands[i].alp;
+      if (Newton(bet1, omg1, r2, s, alp) &&
+          (!found || fabs(s) < fabs(s12))) {
+        found = true; s12 = s; alp1 = alp;
+      }
+    }
+    return found;
+  }
+
+  void TriaxialGeodesic::Inverse(real bet1, real omg1, real bet2, real omg2,
+                                 real& s12, real& alp1, real& alp2) const {
+    real sbet1, cbet1, somg1, comg1, sbet2, cbet2, somg2, comg2;
+    Math::sincosd(bet1, sbet1, cbet1);
+    Math::sincosd(omg1, somg1, comg1);
+    Math::sincosd(bet2, sbet2, cbet2);
+    Math::sincosd(omg2, somg2, comg2);
+    real r1[3], r2[3], ebet[3], eomg[3];
+    cart(sbet1, cbet1, somg1, comg1, r1);
+    cart(sbet2, cbet2, somg2, comg2, r2);
+    real d[3] = { r2[0] - r1[0], r2[1] - r1[1], r2[2] - r1[2] },
+      chord = hypot(hypot(d[0], d[1]), d[2]);
+    if (chord == 0) {
+      s12 = 0; alp1 = alp2 = 0;
+      return;
+    }
+    // Start with the chord direction projected onto the tangent plane.
+    tangents(sbet1, cbet1, somg1, comg1, ebet, eomg);
+    real db = 0, dw = 0;
+    for (int k = 0; k < 3; ++k) { db += d[k] * ebet[k]; dw += d[k] * eomg[k]; }
+    real alp = Math::atan2d(dw, db), s = chord;
+    bool ok = Newton(bet1, omg1, r2, s, alp);
+    // A geodesic shorter than pi*b*c/a is the shortest path.
+    if (!ok || fabs(s) > Math::pi() * _b * _c / _a)
+      ok = Search(bet1, omg1, r2, ok, s, alp);
+    if (!ok)
+      throw GeographicErr("TriaxialGeodesic: inverse problem didn't converge");
+    if (signbit(s)) { s = -s; alp = Math::AngNormalize(alp + Math::hd); }
+    real b2, o2;
+    Line(bet1, omg1, alp).Position(s, b2, o2, alp2);
+    s12 = s; alp1 = alp;
+  }
+
+  void TriaxialGeodesic::InverseBatch(size_t n, const real bet1[],
+                                      const real omg1[], const real bet2[],
+                                      const real omg2[], real s12[],
+                                      real alp1[], real alp2[]) const {
+    real alp1x, alp2x;
+    for (size_t i = 0; i < n; ++i) {
+      Inverse(bet1[i], omg1[i], bet2[i], omg2[i], s12[i], alp1x, alp2x);
+      if (alp1) alp1[i] = alp1x;
+      if (alp2) alp2[i] = alp2x;
+    }
+  }
+
+} // namespace GeographicLib
@@ -0,0 +1,285 @@
+/**
+ * \file TriaxialGeodesicLine.cpp
+ * \brief Implementation for GeographicLib::TriaxialGeodesicLine class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ *
+ * In the working orientation (gamma > 0, swapping a and c if necessary) the
+ * metric is ds^2 = W * (P(bet) * dbet^2 + Q(omg) * domg^2) with
+ *
+ *   W = k^2*cos(bet)^2 + kp^2*sin(omg)^2
+ *   P = (b^2*sin(bet)^2 + c^2*cos(bet)^2) / (kp^2 + k^2*cos(bet)^2)
+ *   Q = (a^2*sin(omg)^2 + b^2*cos(omg)^2) / (k^2 + kp^2*sin(omg)^2)
+ *
+ * With dtau = ds/W, Jacobi's solution is
+ *
+ *   dtau = sqrt(P) * dbet / sqrt(k^2*cos(bet)^2 - gamma)
+ *        = sqrt(Q) * domg / sqrt(kp^2*sin(omg)^2 + gamma)
+ *   ds = k^2*cos(bet)^2 * dtau + kp^2*sin(omg)^2 * dtau
+ *
+ * Substituting sin(bet) = sqrt(m) * sn(v, m) with m = 1 - gamma/k^2 and
+ * omg = am(u, kap2) + pi/2 with kap2 = kp^2/(kp^2 + gamma) removes the
+ * singularities in the integrands; these are then even periodic functions of
+ * v and u with periods 2*K(m) and 2*K(kap2).
+ **********************************************************************/
+
+#include <GeographicLib/TriaxialGeodesicLine.hpp>
+#include <GeographicLib/DST.hpp>
+#include <limits>
+
+#if defined(_MSC_VER)
+// Squelch warnings about constant conditional expressions
+#  pragma warning (disable: 4127)
+#endif
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  void TriaxialGeodesicLine::fseries::fit(function<real(real)> f) {
+    // Geodesics which pass close to an umbilical point need many terms.
+    static const int maxN = 2048;
+    if (!DST::cosinefit(f, _d, maxN))
+      throw GeographicErr("TriaxialGeodesicLine: Fourier series didn't "
+                          "converge");
+    int n = int(_d.size()) - 1;
+    _c.resize(n + 1);
+    _c[0] = 0;
+    _bnd = 0;
+    for (int j = 1; j <= n; ++j) {
+      _c[j] = _d[j] / (2 * j);
+      _bnd += fabs(_c[j]);
+    }
+  }
+
+  void TriaxialGeodesicLine::fseries::eval(real x, real& f, real& fp) const {
+    real sx = sin(x), cx = cos(x);
+    int n = int(_c.size()) - 1;
+    f = _d[0] * x + DST::sineval(sx, cx, _c.data(), n);
+    // Clenshaw summation of sum(d[j] * cos(2*j*x), j, 0, n)
+    real
+      c2 = (cx - sx) * (cx + sx),   // cos(2 * x)
+      ar = 2 * c2,
+      y0 = 0, y1 = 0;
+    for (int j = n; j > 0; --j) {
+      real t = ar * y0 - y1 + _d[j];
+      y1 = y0; y0 = t;
+    }
+    fp = _d[0] + c2 * y0 - y1;
+  }
+
+  Math::real TriaxialGeodesicLine::fseries::operator()(real x) const {
+    return _d[0] * x +
+      DST::sineval(sin(x), cos(x), _c.data(), int(_c.size()) - 1);
+  }
+
+  Math::real TriaxialGeodesicLine::fseries::deriv(real x) const {
+    real f, fp;
+    eval(x, f, fp);
+    return fp;
+  }
+
+  Math::real TriaxialGeodesicLine::fseries::inv(real y) const {
+    // The function is increasing and its periodic part is bounded by _bnd,
+    // so the root is bracketed; use Newton's method falling back to
+    // bisection.
+    static const real tol = 4 * numeric_limits<real>::epsilon();
+    static const int maxit = 100;
+    real
+      x = y / _d[0],
+      lo = (y - _bnd) / _d[0],
+      hi = (y + _bnd) / _d[0];
+    for (int i = 0; i < maxit; ++i) {
+      real f, fp;
+      eval(x, f, fp);
+      f -= y;
+      if (f == 0) break;
+      if (f > 0) hi = fmin(hi, x); else lo = fmax(lo, x);
+      real xn = x - f / fp;
+      if (!(xn > lo && xn < hi)) xn = (lo + hi) / 2;
+      bool done = fabs(xn - x) <= tol * fmax(real(1), fabs(x)) ||
+        !(lo < hi);
+      x = xn;
+      if (done) break;
+    }
+    return x;
+  }
+
+  TriaxialGeodesicLine::TriaxialGeodesicLine(const TriaxialGeodesic& t,
+                                             real bet1, real omg1,
+                                             real alp1)
+    : _bet1(bet1)
+    , _omg1(Math::AngNormalize(omg1))
+    , _alp1(Math::AngNormalize(alp1))
+  {
+    real sbet, cbet, somg, comg, salp, calp;
+    Math::sincosd(bet1, sbet, cbet);
+    Math::sincosd(omg1, somg, comg);
+    Math::sincosd(alp1, salp, calp);
+    // (bet, omg, alp) and (180 - bet, -omg, alp + 180) are the same
+    if (signbit(cbet)) {
+      cbet = -cbet; somg = -somg; salp = -salp; calp = -calp;
+    }
+    real gam = t._k2 * Math::sq(cbet * salp) - t._kp2 * Math::sq(somg * calp);
+    _gam = gam;
+    _swap = gam < 0;
+    if (_swap) {
+      // Swap a and c: bet' = omg - 90, omg' = bet + 90, alp' = 90 - alp
+      real sbetx = -comg, cbetx = somg;
+      comg = -sbet; somg = cbet;
+      sbet = sbetx; cbet = cbetx;
+      swap(salp, calp);
+      if (signbit(cbet)) {
+        cbet = -cbet; somg = -somg; salp = -salp; calp = -calp;
+      }
+      _a = t._c; _b = t._b; _c = t._a; _k2 = t._kp2; _kp2 = t._k2;
+      gam = -gam;
+    } else {
+      _a = t._a; _b = t._b; _c = t._c; _k2 = t._k2; _kp2 = t._kp2;
+    }
+    if (gam == 0)
+      // An umbilical geodesic; substitute a tiny positive gamma.
+      gam = _k2 * _kp2 * Math::sq(numeric_limits<real>::epsilon());
+    real
+      w1 = _k2 * Math::sq(cbet) + _kp2 * Math::sq(somg),
+      // k^2 - gamma and kp^2 + gamma avoiding cancellation
+      km = _k2 * (Math::sq(sbet) + Math::sq(cbet * calp)) +
+      _kp2 * Math::sq(somg * calp),
+      kp = _kp2 * (Math::sq(comg) + Math::sq(somg * salp)) +
+      _k2 * Math::sq(cbet * salp);
+    _sqm = sqrt(km); _sqg = sqrt(kp);
+    _sig = signbit(salp) ? -1 : 1;
+    _eb.Reset(km / _k2, 0, gam / _k2, 1);
+    _eo.Reset(_kp2 / kp, 0, gam / kp, 1);
+    _kb = _eb.K() / (Math::pi() / 2); _kK4b = 4 * _eb.K();
+    _ko = _eo.K() / (Math::pi() / 2); _kK4o = 4 * _eo.K();
+
+    // The starting points: sin(bet) = sqrt(m) * sin(phi) and
+    // cos(phi) = cos(alp) * sqrt(W) / sqrt(k^2 - gamma); the angle for omg is
+    // theta = omg - 90 with delta(theta) = |sin(alp)| * sqrt(W) /
+    // sqrt(kp^2 + gamma).
+    real sphi = 0, cphi = 1;
+    if (km > 0) {
+      sphi = sbet * sqrt(_k2) / _sqm; cphi = calp * sqrt(w1) / _sqm;
+      Math::norm(sphi, cphi);
+    }
+    real
+      v1 = _eb.F(sphi, cphi, cbet),
+      u1 = _eo.F(-comg, somg, fabs(salp) * sqrt(w1) / _sqg);
+
+    real
+      a2 = Math::sq(_a), b2 = Math::sq(_b), c2 = Math::sq(_c),
+      k = sqrt(_k2);
+    // The integrands for tau and s as functions of zeta = v / _kb and xi = u
+    // / _ko.
+    auto fbet = [this, b2, c2, k](real zeta, bool sp) -> real {
+      real sn, cn, dn;
+      _eb.sncndn(_kb * zeta, sn, cn, dn);
+      real s2 = _eb.k2() * Math::sq(sn), cb2 = Math::sq(dn),
+        f = _kb * sqrt((b2 * s2 + c2 * cb2) / (_kp2 + _k2 * cb2)) / k;
+      return sp ? _k2 * cb2 * f : f;
+    };
+    auto fomg = [this, a2, b2](real xi, bool sp) -> real {
+      real sn, cn, dn;
+      _eo.sncndn(_ko * xi, sn, cn, dn);
+      // sin(omg) = cn, cos(omg) = -sn
+      real so2 = Math::sq(cn), co2 = Math::sq(sn),
+        f = _ko * sqrt((a2 * so2 + b2 * co2) / (_k2 + _kp2 * so2)) / _sqg;
+      return sp ? _kp2 * so2 * f : f;
+    };
+    _tb.fit([&fbet](real z) -> real { return fbet(z, false); });
+    _sb.fit([&fbet](real z) -> real { return fbet(z, true); });
+    _to.fit([&fomg](real z) -> real { return fomg(z, false); });
+    _so.fit([&fomg](real z) -> real { return fomg(z, true); });
+
+    real zeta1 = v1 / _kb, xi1 = u1 / _ko;
+    _tb1 = _tb(zeta1); _sb1 = _sb(zeta1);
+    _to1 = _to(xi1); _so1 = _so(xi1);
+
+    // s is approximately _wbar * tau; bound the deviation from this.
+    real rb = _sb.a0() / _tb.a0(), ro = _so.a0() / _to.a0();
+    _wbar = rb + ro;
+    _bnd = 0;
+    const vector<real>
+      &tb = _tb.coeffs(), &sb = _sb.coeffs(),
+      &to = _to.coeffs(), &so = _so.coeffs();
+    for (size_t j = 1; j < max(tb.size(), sb.size()); ++j)
+      _bnd += fabs((j < sb.size() ? sb[j] : 0) -
+                   rb * (j < tb.size() ? tb[j] : 0));
+    for (size_t j = 1; j < max(to.size(), so.size()); ++j)
+      _bnd += fabs((j < so.size() ? so[j] : 0) -
+                   ro * (j < to.size() ? to[j] : 0));
+    _bnd *= 2;
+  }
+
+  void TriaxialGeodesicLine::GenPosition(real s12, real& sbet2, real& cbet2,
+                                         real& somg2, real& comg2,
+                                         real& salp2, real& calp2) const {
+    // Solve s(tau) = s12; ds/dtau = W > 0.
+    static const real tol = 4 * numeric_limits<real>::epsilon();
+    static const int maxit = 100;
+    real
+      tau = s12 / _wbar,
+      lo = (s12 - _bnd) / _wbar,
+      hi = (s12 + _bnd) / _wbar,
+      zeta = 0, xi = 0;
+    for (int i = 0; i < maxit; ++i) {
+      zeta = _tb.inv(_tb1 + tau);
+      xi = _to.inv(_to1 + _sig * tau);
+      real sb, dsb, so, dso, tb, dtb, to, dto;
+      _sb.eval(zeta, sb, dsb); _tb.eval(zeta, tb, dtb);
+      _so.eval(xi, so, dso); _to.eval(xi, to, dto);
+      real f = sb - _sb1 + _sig * (so - _so1) - s12;
+      if (f == 0) break;
+      if (f > 0) hi = fmin(hi, tau); else lo = fmax(lo, tau);
+      real taun = tau - f / (dsb / dtb + dso / dto);
+      if (!(taun > lo && taun < hi)) taun = (lo + hi) / 2;
+      if (fabs(taun - tau) <= tol * (fabs(tau) + _b) || !(lo < hi)) {
+        tau = taun;
+        zeta = _tb.inv(_tb1 + tau);
+        xi = _to.inv(_to1 + _sig * tau);
+        break;
+      }
+      tau = taun;
+    }
+    real sn, cn, dn;
+    _eb.sncndn(remainder(_kb * zeta, _kK4b), sn, cn, dn);
+    sbet2 = _sqm / sqrt(_k2) * sn; cbet2 = dn;
+    calp2 = _sqm * cn;
+    _eo.sncndn(remainder(_ko * xi, _kK4o), sn, cn, dn);
+    somg2 = cn; comg2 = -sn;
+    salp2 = _sig * _sqg * dn;
+    if (_swap) {
+      // The inverse of the swap is the same transformation
+      real sbetx = -comg2, cbetx = somg2;
+      comg2 = -sbet2; somg2 = cbet2;
+      sbet2 = sbetx; cbet2 = cbetx;
+      swap(salp2, calp2);
+    }
+    if (signbit(cbet2)) {
+      cbet2 = -cbet2; somg2 = -somg2; salp2 = -salp2; calp2 = -calp2;
+    }
+  }
+
+  void TriaxialGeodesicLine::Position(real s12, real& bet2, real& omg2,
+                                      real& alp2) const {
+    real sbet2, cbet2, somg2, comg2, salp2, calp2;
+    GenPosition(s12, sbet2, cbet2, somg2, comg2, salp2, calp2);
+    bet2 = Math::atan2d(sbet2, cbet2);
+    omg2 = Math::atan2d(somg2, comg2);
+    alp2 = Math::atan2d(salp2, calp2);
+  }
+
+  void TriaxialGeodesicLine::PositionBatch(size_t n, const real s12[],
+                                           real bet2[], real omg2[],
+                                           real alp2[]) const {
+    real alp2x;
+    for (size_t i = 0; i < n; ++i) {
+      Position(s12[i], bet2[i], omg2[i], alp2x);
+      if (alp2) alp2[i] = alp2x;
+    }
+  }
+
+} // namespace GeographicLib
@@ -121,6 +121,122 @@ namespace GeographicLib {
     k = k1;
   }
 
+  void UTMUPS::ForwardBatch(size_t n, const real lat[], const real lon[],
+                            int zone[], bool northp[], real x[], real y[],
+                            real gamma[], real k[],
+                            int setzone, bool mgrslimits) {
+    IntForwardBatch(n, lat, lon, zone, northp, x, y, gamma, k,
+                    setzone, mgrslimits);
+  }
+
+  void UTMUPS::ForwardBatch(size_t n,
+                            StridedView<const real> lat,
+                            StridedView<const real> lon,
+                            int zone[], bool northp[],
+                            StridedView<real> x, StridedView<real> y,
+                            StridedView<real> gamma, StridedView<real> k,
+                            int setzone, bool mgrslimits) {
+    IntForwardBatch(n, lat, lon, zone, northp, x, y, gamma, k,
+                    setzone, mgrslimits);
+  }
+
+  template<class CA, class A>
+  void UTMUPS::IntForwardBatch(size_t n, CA lat, CA lon,
+                               int zone[], bool northp[], A x, A y,
+                               A gamma, A k, int setzone, bool mgrslimits) {
+    // The points are processed in blocks (so that the temporary arrays stay
+    // in the cache).  The points in a block are classified by zone; groups 0
+    // (UPS) through MAXZONE are the zones and group MAXZONE + 1 holds the
+    // invalid points.  The results are computed in temporary arrays sorted by
+    // group and then copied to the output arrays.
+    const int ng = MAXZONE + 2;
+    const size_t blocksize = 1024;
+    size_t nt = min(n, blocksize);
+    vector<int> zn(nt);
+    vector<size_t> start(ng + 1), next(ng), perm(nt);
+    vector<real> la(nt), lo(nt), xs(nt), ys(nt), gs(nt), ks(nt);
+    for (size_t i0 = 0; i0 < n; i0 += nt) {
+      size_t nb = min(nt, n - i0);
+      fill(start.begin(), start.end(), 0);
+      for (size_t l = 0; l < nb; ++l) {
+        size_t i = i0 + l;
+        if (fabs(lat[i]) > Math::qd)
+          throw GeographicErr("Latitude " + Utility::str(lat[i])
+                              + "d not in [-" + to_string(Math::qd)
+                              + "d, " + to_string(Math::qd) + "d]");
+        zn[l] = StandardZone(lat[i], lon[i], setzone);
+        ++start[(zn[l] == INVALID ? ng - 1 : zn[l]) + 1];
+      }
+      for (int g = 0; g < ng; ++g)
+        start[g + 1] += start[g];
+      copy(start.begin(), start.end() - 1, next.begin());
+      for (size_t l = 0; l < nb; ++l)
+        perm[next[zn[l] == INVALID ? ng - 1 : zn[l]]++] = l;
+      for (size_t j = 0; j < nb; ++j) {
+        la[j] = lat[i0 + perm[j]]; lo[j] = lon[i0 + perm[j]];
+      }
+      for (int g = 0; g < ng; ++g) {
+        size_t j0 = start[g], j1 = start[g + 1];
+        if (j0 == j1) continue;
+        if (g == ng - 1) {
+          for (size_t j = j0; j < j1; ++j)
+            xs[j] = ys[j] = gs[j] = ks[j] = Math::NaN();
+          continue;
+        }
+        bool utmp = g != UPS;
+        if (utmp) {
+          real lon0 = CentralMeridian(g);
+          for (size_t j = j0; j < j1; ++j)
+            if (!(Math::AngDiff(lon0, lo[j]) <= 60))
+              throw GeographicErr("Longitude " + Utility::str(lo[j])
+                                  + "d more than 60d from center of UTM zone "
+                                  + Utility::str(g));
+          // The zone is evaluated with the batched projection
+          TransverseMercator::UTM().ForwardBatch(j1 - j0, lon0,
+                                                 &la[j0], &lo[j0],
+                                                 &xs[j0], &ys[j0],
+                                                 &gs[j0], &ks[j0]);
+        } else {
+          // Runs of points in the same hemisphere are evaluated with the
+          // batched projection
+          for (size_t j = j0, jn; j < j1; j = jn) {
+            bool northp1 = !(signbit(la[j]));
+            for (jn = j; jn < j1 && !(signbit(la[jn])) == northp1; ++jn)
+              if (fabs(la[jn]) < 70)
+                throw GeographicErr("Latitude " + Utility::str(la[jn])
+                                    + "d more than 20d from "
+                                    + (northp1 ? "N" : "S") + " pole");
+            PolarStereographic::UPS().ForwardBatch(jn - j, northp1,
+                                                   &la[j], &lo[j],
+                                                   &xs[j], &ys[j],
+                                                   &gs[j], &ks[j]);
+          }
+        }
+        for (size_t j = j0; j < j1; ++j) {
+          bool northp1 = !(signbit(la[j]));
+          int ind = (utmp ? 2 : 0) + (northp1 ? 1 : 0);
+          xs[j] += falseeasting_[ind];
+          ys[j] += falsenorthing_[ind];
+          if (! CheckCoords(utmp, northp1, xs[j], ys[j], mgrslimits, false) )
+            throw GeographicErr("Latitude " + Utility::str(la[j])
+                                + ", longitude " + Utility::str(lo[j])
+                                + " out of legal range for "
+                                + (utmp ? "UTM zone " + Utility::str(g) :
+                                   "UPS"));
+        }
+      }
+      for (size_t j = 0; j < nb; ++j) {
+        size_t l = perm[j], i = i0 + l;
+        zone[i] = zn[l];
+        northp[i] = !(signbit(la[j]));
+        x[i] = xs[j];
+        y[i] = ys[j];
+        if (gamma) gamma[i] = gs[j];
+        if (k) k[i] = ks[j];
+      }
+    }
+  }
+
   void UTMUPS::Reverse(int zone, bool northp, real x, real y,
                        real& lat, real& lon, real& gamma, real& k,
                        bool mgrslimits) {
@@ -209,6 +325,85 @@ namespace GeographicLib {
     return;
   }
 
+  void UTMUPS::TransferBatch(size_t n, const int zonein[],
+                             const bool northpin[],
+                             const real xin[], const real yin[],
+                             int zoneout, bool northpout,
+                             real xout[], real yout[], int zone[]) {
+    if (!(zoneout > UPS && zoneout <= MAXZONE)) {
+      for (size_t i = 0; i < n; ++i)
+        Transfer(zonein[i], northpin[i], xin[i], yin[i],
+                 zoneout, northpout, xout[i], yout[i], zone[i]);
+      return;
+    }
+    // The points are processed in blocks.  The points in a block are
+    // classified by input zone; group 0 holds the points which aren't
+    // transferred between UTM zones and groups 1 through MAXZONE hold the
+    // points in the other UTM zones.  A point which fails the checks made by
+    // Transfer is handed to Transfer (which throws an exception).
+    const int ng = MAXZONE + 1;
+    const size_t blocksize = 1024;
+    size_t nt = min(n, blocksize);
+    const real lon0 = CentralMeridian(zoneout);
+    vector<int> zn(nt);
+    vector<size_t> start(ng + 1), next(ng), perm(nt);
+    vector<real> xs(nt), ys(nt), lo(nt);
+    for (size_t i0 = 0; i0 < n; i0 += nt) {
+      size_t nb = min(nt, n - i0);
+      fill(start.begin(), start.end(), 0);
+      for (size_t l = 0; l < nb; ++l) {
+        int z = zonein[i0 + l];
+        zn[l] = z > UPS && z <= MAXZONE && z != zoneout ? z : 0;
+        ++start[zn[l] + 1];
+      }
+      for (int g = 0; g < ng; ++g)
+        start[g + 1] += start[g];
+      copy(start.begin(), start.end() - 1, next.begin());
+      for (size_t l = 0; l < nb; ++l)
+        perm[next[zn[l]]++] = l;
+      for (size_t j = start[0]; j < start[1]; ++j) {
+        size_t i = i0 + perm[j];
+        Transfer(zonein[i], northpin[i], xin[i], yin[i],
+                 zoneout, northpout, xout[i], yout[i], zone[i]);
+      }
+      for (size_t j = start[1]; j < nb; ++j) {
+        size_t i = i0 + perm[j];
+        int ind = 2 + (northpin[i] ? 1 : 0);
+        xs[j] = xin[i] - falseeasting_[ind];
+        ys[j] = yin[i] - falsenorthing_[ind];
+      }
+      for (int g = 1; g < ng; ++g) {
+        size_t j0 = start[g], j1 = start[g + 1];
+        if (j0 == j1) continue;
+        TransverseMercator::UTM().TransferBatch(j1 - j0, CentralMeridian(g),
+                                                &xs[j0], &ys[j0], lon0,
+                                                &xs[j0], &ys[j0], &lo[j0]);
+      }
+      for (size_t j = start[1]; j < nb; ++j) {
+        size_t i = i0 + perm[j];
+        bool northp = !(signbit(ys[j]));
+        int ind = 2 + (northp ? 1 : 0);
+        real
+          x = xs[j] + falseeasting_[ind],
+          y = ys[j] + falsenorthing_[ind];
+        // The checks made by Reverse and Forward (Forward rejects NaNs with
+        // the longitude check)
+        if (!(CheckCoords(true, northpin[i], xin[i], yin[i], false, false) &&
+              Math::AngDiff(lon0, lo[j]) <= 60 &&
+              CheckCoords(true, northp, x, y, false, false))) {
+          Transfer(zonein[i], northpin[i], xin[i], yin[i],
+                   zoneout, northpout, xout[i], yout[i], zone[i]);
+          continue;
+        }
+        if (northp != northpout)
+          y += (northpout ? -1 : 1) * MGRS::utmNshift_;
+        xout[i] = x;
+        yout[i] = y;
+        zone[i] = zoneout;
+      }
+    }
+  }
+
   void UTMUPS::DecodeZone(const string& zonestr, int& zone, bool& northp)
   {
     unsigned zlen = unsigned(zonestr.size());
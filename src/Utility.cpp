@@ -7,7 +7,12 @@
  * https://geographiclib.sourceforge.io/
  **********************************************************************/
 
+#include <cerrno>
+#include <clocale>
+#include <cstdio>
 #include <cstdlib>
+#include <cstring>
+#include <limits>
 #include <GeographicLib/Utility.hpp>
 
 #if defined(_MSC_VER)
@@ -15,10 +20,31 @@
 #  pragma warning (disable: 4996)
 #endif
 
+#if GEOGRAPHICLIB_EMBEDDED_DATA
+// The data files compiled into the library; this is generated by
+// cmake/embed-data.cmake and defines embeddedfiles_.
+#  include "EmbeddedData.inc"
+#endif
+
 namespace GeographicLib {
 
   using namespace std;
 
+  bool Utility::EmbeddedData(const std::string& name,
+                             const char*& data, size_t& size) {
+#if GEOGRAPHICLIB_EMBEDDED_DATA
+    for (const auto& f : embeddedfiles_) {
+      if (name == f.name) {
+        data = f.data; size = f.size;
+        return true;
+      }
+    }
+#else
+    (void)name; (void)data; (void)size;
+#endif
+    return false;
+  }
+
   int Utility::day(int y, int m, int d) {
     // Convert from date to sequential day and vice versa
     //
@@ -146,6 +172,35 @@ namespace GeographicLib {
     y = y1; m = m1; d = d1;
   }
 
+  size_t Utility::str(Math::real x, int p, char s[], size_t n) {
+    int m = -1;
+#if GEOGRAPHICLIB_PRECISION <= 3
+    if (p >= 0 && isfinite(x)) {
+#  if GEOGRAPHICLIB_PRECISION == 3
+      m = snprintf(s, n, "%.*Lf", p, x);
+#  else
+      m = snprintf(s, n, "%.*f", p, double(x));
+#  endif
+      if (!(m >= 0 && size_t(m) < n))
+        throw GeographicErr("Buffer too small for number");
+      // str uses the "C" locale; undo any localized decimal point
+      char dp = *localeconv()->decimal_point;
+      if (dp != '.')
+        for (int i = 0; i < m; ++i)
+          if (s[i] == dp) s[i] = '.';
+    }
+#endif
+    if (m < 0) {
+      string t = str(x, p);
+      if (!(t.size() < n))
+        throw GeographicErr("Buffer too small for number");
+      memcpy(s, t.data(), t.size());
+      s[t.size()] = '\0';
+      m = int(t.size());
+    }
+    return size_t(m);
+  }
+
   std::string Utility::trim(const std::string& s) {
     unsigned
       beg = 0,
@@ -167,6 +222,103 @@ namespace GeographicLib {
     return p != NULL ? int(p - s) : -1;
   }
 
+  namespace {
+    // Is [s, end) a plain number, [+-]ddd.ddde[+-]dd (with at least one
+    // mantissa digit)?  If integer, only [+-]ddd is allowed.
+    bool plainnumber(const char* s, const char* end, bool integer) {
+      if (s < end && (*s == '+' || *s == '-')) ++s;
+      int ndigits = 0;
+      for (; s < end && *s >= '0' && *s <= '9'; ++s) ++ndigits;
+      if (integer)
+        return ndigits > 0 && s == end;
+      if (s < end && *s == '.')
+        for (++s; s < end && *s >= '0' && *s <= '9'; ++s) ++ndigits;
+      if (ndigits == 0)
+        return false;
+      if (s < end && (*s == 'e' || *s == 'E')) {
+        ++s;
+        if (s < end && (*s == '+' || *s == '-')) ++s;
+        int edigits = 0;
+        for (; s < end && *s >= '0' && *s <= '9'; ++s) ++edigits;
+        if (edigits == 0)
+          return false;
+      }
+      return s == end;
+    }
+
+    inline void strtonum(const char* s, char** r, float& x)
+    { x = strtof(s, r); }
+    inline void strtonum(const char* s, char** r, double& x)
+    { x = strtod(s, r); }
+    inline void strtonum(const char* s, char** r, long double& x)
+    { x = strtold(s, r); }
+
+    // [s, end) needn't be null terminated, so copy it to a buffer for
+    // strtod, etc.; longer strings are left to the stream.
+    template<typename T>
+    bool fastfloat(const char* s, const char* end, T& x) {
+      char buf[64];
+      size_t len = size_t(end - s);
+      if (!(len < sizeof(buf) && plainnumber(s, end, false)))
+        return false;
+      memcpy(buf, s, len); buf[len] = '\0';
+      char* r;
+      int olderrno = errno;
+      errno = 0;
+      T y;
+      strtonum(buf, &r, y);
+      // On overflow (or underflow), the stream may give a different result;
+      // if the decimal point is localized, strtod stops at the '.'.
+      bool ok = errno == 0 && r == buf + len;
+      errno = olderrno;
+      if (ok) x = y;
+      return ok;
+    }
+
+    template<typename T>
+    bool fastint(const char* s, const char* end, T& x) {
+      char buf[32];
+      size_t len = size_t(end - s);
+      if (!(len < sizeof(buf) && plainnumber(s, end, true)))
+        return false;
+      memcpy(buf, s, len); buf[len] = '\0';
+      char* r;
+      int olderrno = errno;
+      errno = 0;
+      long long y = strtoll(buf, &r, 10);
+      bool ok = errno == 0 && r == buf + len &&
+        y >= (long long)(numeric_limits<T>::min()) &&
+        y <= (long long)(numeric_limits<T>::max());
+      errno = olderrno;
+      if (ok) x = T(y);
+      return ok;
+    }
+  }
+
+  bool Utility::fastval(const char* s, const char* end, float& x)
+  { return fastfloat(s, end, x); }
+
+  bool Utility::fastval(const char* s, const char* end, double& x)
+  { return fastfloat(s, end, x); }
+
+  bool Utility::fastval(const char* s, const char* end, long double& x)
+  { return fastfloat(s, end, x); }
+
+  bool Utility::fastval(const char* s, const char* end, int& x)
+  { return fastint(s, end, x); }
+
+  bool Utility::fastval(const char* s, const char* end, long& x)
+  { return fastint(s, end, x); }
+
+  bool Utility::fastval(const char* s, const char* end, long long& x)
+  { return fastint(s, end, x); }
+
+  bool Utility::upmatch(const char* s, size_t len, const char* t) {
+    for (; len > 0 && *t; --len, ++s, ++t)
+      if (toupper(static_cast<unsigned char>(*s)) != *t) return false;
+    return len == 0 && *t == 0;
+  }
+
   bool Utility::ParseLine(const std::string& line,
                           std::string& key, std::string& value,
                           char equals, char comment) {
@@ -0,0 +1,215 @@
+# Check the --binary and --grid modes of a command line tool against its
+# text mode.  This is run in script mode with
+#
+#   cmake -DTOOL=/path/to/GeodSolve -DARGS="-i;-p;0"
+#     -DTEXT="40.6 -73.8 49.01 2.55;..." -DBINARY=cdcccccccc4c4440...
+#     -DOUT=prefix -P checkbinary.cmake
+#
+# TEXT holds the input lines and BINARY the same numbers as little-endian
+# doubles (in hex; the bytes must be nonzero so that they can be written
+# by cmake).  The tool is run on both with the options ARGS.  Each record
+# of the binary output is compared with the corresponding line of the text
+# output: each double, rounded to the number of decimals of the text, must
+# match to within 1 in the last place, and an ERROR line must correspond
+# to a record of NaNs.  The exit codes of the two runs must also match.
+#
+# Alternatively, with -DGRID="south;west;north;east;dlat;dlon" (and
+# optionally -DGTX=ON), the binary output is made with --grid (and --gtx)
+# instead of --binary; TEXT then lists the grid points in the order they
+# are written (north to south, or south to north for GTX).
+
+# Convert the 16 hex digits of a little-endian double (or the 8 hex digits
+# of a big-endian float) to the integer round(x * 10^k) (to within 1); set
+# var to "nan" for a NaN or infinity.
+function (decode hex k var)
+  string (LENGTH ${hex} n)
+  if (n EQUAL 8)
+    math (EXPR bits "0x${hex}")
+    math (EXPR sign "${bits} >> 31")
+    math (EXPR e "(${bits} >> 23) & 255")
+    if (e EQUAL 255)
+      set (${var} nan PARENT_SCOPE)
+      return ()
+    endif ()
+    math (EXPR m "(${bits} & 8388607) << 29")
+    if (e GREATER 0)
+      math (EXPR e "${e} + 896")
+    endif ()
+  else ()
+    set (be "")
+    foreach (i 14 12 10 8 6 4 2 0)
+      string (SUBSTRING ${hex} ${i} 2 b)
+      string (APPEND be ${b})
+    endforeach ()
+    string (SUBSTRING ${be} 0 4 hi)
+    string (SUBSTRING ${be} 4 12 lo)
+    math (EXPR hi "0x${hi}")
+    math (EXPR lo "0x${lo}")
+    math (EXPR sign "${hi} >> 15")
+    math (EXPR e "(${hi} >> 4) & 2047")
+    if (e EQUAL 2047)
+      set (${var} nan PARENT_SCOPE)
+      return ()
+    endif ()
+    math (EXPR m "((${hi} & 15) << 48) | ${lo}")
+  endif ()
+  # x = m * 2^(e - 1075) (the float has been converted to this form); split
+  # m = mh * 2^26 + ml to multiply by 10^k without overflow
+  if (e GREATER 0)
+    math (EXPR m "${m} | (1 << 52)")
+  else ()
+    set (e 1)
+  endif ()
+  set (p 1)
+  while (k GREATER 0)
+    math (EXPR p "${p} * 10")
+    math (EXPR k "${k} - 1")
+  endwhile ()
+  math (EXPR mh "(${m} >> 26) * ${p}")
+  math (EXPR ml "(${m} & 67108863) * ${p}")
+  math (EXPR sh "1075 - ${e}")
+  if (sh GREATER_EQUAL 26)
+    math (EXPR x "(${mh} + (${ml} >> 26)) >> (${sh} - 26)")
+  elseif (sh GREATER_EQUAL 0)
+    math (EXPR x "(${mh} << (26 - ${sh})) + (${ml} >> ${sh})")
+  else ()
+    message (FATAL_ERROR "Value too large: ${be}")
+  endif ()
+  if (sign)
+    math (EXPR x "-${x}")
+  endif ()
+  set (${var} ${x} PARENT_SCOPE)
+endfunction ()
+
+if (GRID)
+  set (MODE --grid ${GRID})
+  if (GTX)
+    list (APPEND MODE --gtx)
+  endif ()
+else ()
+  set (BIN "")
+  string (LENGTH ${BINARY} n)
+  math (EXPR n "${n} - 1")
+  foreach (i RANGE 0 ${n} 2)
+    string (SUBSTRING ${BINARY} ${i} 2 b)
+    math (EXPR b "0x${b}")
+    if (b EQUAL 0)
+      message (FATAL_ERROR "Zero byte in BINARY")
+    endif ()
+    string (ASCII ${b} c)
+    string (APPEND BIN "${c}")
+  endforeach ()
+  file (WRITE ${OUT}.in "${BIN}")
+  set (MODE --binary --input-file ${OUT}.in)
+endif ()
+
+# The tools return the number of errors
+execute_process (COMMAND ${TOOL} ${ARGS} --input-string "${TEXT}"
+  OUTPUT_VARIABLE text RESULT_VARIABLE textres)
+execute_process (COMMAND ${TOOL} ${ARGS} ${MODE} --output-file ${OUT}.out
+  RESULT_VARIABLE res)
+if (NOT res STREQUAL textres)
+  message (FATAL_ERROR "${TOOL} returns ${textres} and ${res} with ${MODE}")
+endif ()
+file (READ ${OUT}.out out HEX)
+# The size of each number in hex digits
+set (size 16)
+if (GTX)
+  # The header gives the south and west edges and the spacings (as
+  # big-endian doubles) and the numbers of rows and columns (as big-endian
+  # ints); then come the heights as big-endian floats
+  list (GET GRID 0 south)
+  list (GET GRID 1 west)
+  list (GET GRID 4 dlat)
+  list (GET GRID 5 dlon)
+  set (i 0)
+  foreach (want ${south} ${west} ${dlat} ${dlon})
+    set (le "")
+    foreach (b 14 12 10 8 6 4 2 0)
+      math (EXPR pos "${i} + ${b}")
+      string (SUBSTRING ${out} ${pos} 2 c)
+      string (APPEND le ${c})
+    endforeach ()
+    string (REGEX MATCH "\\.[0-9]+$" k ${want})
+    string (LENGTH "${k}" k)
+    if (k GREATER 0)
+      math (EXPR k "${k} - 1")
+    endif ()
+    string (REPLACE "." "" want ${want})
+    decode (${le} ${k} got)
+    if (NOT got EQUAL want)
+      message (FATAL_ERROR "GTX header has ${got} instead of ${want}")
+    endif ()
+    math (EXPR i "${i} + 16")
+  endforeach ()
+  string (SUBSTRING ${out} 64 8 nrows)
+  string (SUBSTRING ${out} 72 8 ncols)
+  math (EXPR n "0x${nrows} * 0x${ncols}")
+  string (SUBSTRING ${out} 80 -1 out)
+  set (size 8)
+  string (REGEX REPLACE "[^;]" "" semis "${TEXT}")
+  string (LENGTH "${semis}" m)
+  math (EXPR m "${m} + 1")
+  if (NOT n EQUAL m)
+    message (FATAL_ERROR "GTX header gives ${n} points instead of ${m}")
+  endif ()
+endif ()
+
+string (REGEX REPLACE "\r?\n$" "" text "${text}")
+string (REGEX REPLACE "\r?\n" ";" lines "${text}")
+list (LENGTH lines nlines)
+string (LENGTH "${out}" nout)
+math (EXPR nrec "${nout} / ${size} / ${nlines}")
+math (EXPR nwant "${nrec} * ${size} * ${nlines}")
+if (NOT nout EQUAL nwant OR nrec EQUAL 0)
+  message (FATAL_ERROR "${nout} hex digits of output for ${nlines} lines")
+endif ()
+
+set (errors 0)
+set (j 0)
+foreach (line ${lines})
+  if (line MATCHES "^ERROR")
+    set (nums "")
+    foreach (i RANGE 1 ${nrec})
+      list (APPEND nums nan)
+    endforeach ()
+  else ()
+    string (REGEX REPLACE " +" ";" nums "${line}")
+    list (LENGTH nums n)
+    if (NOT n EQUAL nrec)
+      message (FATAL_ERROR "Expected ${nrec} numbers in \"${line}\"")
+    endif ()
+  endif ()
+  foreach (num ${nums})
+    math (EXPR pos "${j} * ${size}")
+    string (SUBSTRING ${out} ${pos} ${size} hex)
+    math (EXPR j "${j} + 1")
+    if (num MATCHES "^-?[0-9]+(\\.([0-9]+))?$")
+      string (LENGTH "${CMAKE_MATCH_2}" k)
+      string (REPLACE "." "" want ${num})
+      decode (${hex} ${k} got)
+      if (got STREQUAL nan)
+        set (bad 1)
+      else ()
+        math (EXPR bad "${got} - ${want}")
+        if (bad GREATER_EQUAL -1 AND bad LESS_EQUAL 1)
+          set (bad 0)
+        endif ()
+      endif ()
+    else ()
+      decode (${hex} 0 got)
+      if (got STREQUAL nan AND num MATCHES "^(nan|ERROR)")
+        set (bad 0)
+      else ()
+        set (bad 1)
+      endif ()
+    endif ()
+    if (bad)
+      message ("Mismatch: ${num} in \"${line}\" vs ${hex}")
+      math (EXPR errors "${errors} + 1")
+    endif ()
+  endforeach ()
+endforeach ()
+if (errors)
+  message (FATAL_ERROR "${errors} mismatches")
+endif ()
@@ -0,0 +1,112 @@
+#! /bin/sh
+#
+# Check the server mode of a command line tool.  This is run with
+#
+#   sh checkserver.sh TOOL SOCKET INPUT REJECT [OPTIONS...]
+#
+# TOOL --serve SOCKET is started in the background.  The output, error
+# output, and exit status of TOOL --connect SOCKET OPTIONS on the input
+# lines INPUT (separated by semicolons) must be the same as those of TOOL
+# OPTIONS run directly.  This is checked for one request and for 8
+# simultaneous ones, and for a bad option (which must give a usage
+# message).  Finally, the client must reject an input larger than the
+# server accepts, and the server must reject --input-file, --output-file,
+# and each of the semicolon-separated options in REJECT (which may be
+# empty).  The server is killed on exit.  On success the output is
+# printed.
+
+tool=$1
+sock=$2
+input=$3
+reject=$4
+shift 4
+dir=`mktemp -d`
+pid=
+trap 'test -n "$pid" && kill $pid; rm -rf "$dir" "$sock"' 0
+trap 'exit 1' 1 2 15
+
+# Don't mistake a stale socket for the new one
+rm -f "$sock"
+"$tool" --serve "$sock" 2> "$dir/serve.err" &
+pid=$!
+i=0
+while test ! -S "$sock"; do
+    i=`expr $i + 1`
+    if test $i -gt 100 || ! kill -0 $pid 2> /dev/null; then
+        echo "Server did not start"
+        cat "$dir/serve.err"
+        exit 1
+    fi
+    sleep 1
+done
+
+"$tool" "$@" --input-string "$input" > "$dir/want.out" 2> "$dir/want.err" \
+    < /dev/null
+echo $? > "$dir/want.status"
+
+status=0
+clients=
+for k in 1 2 3 4 5 6 7 8; do
+    ( "$tool" --connect "$sock" "$@" --input-string "$input" \
+        > "$dir/got$k.out" 2> "$dir/got$k.err" < /dev/null
+      echo $? > "$dir/got$k.status" ) &
+    # Make the first request alone; don't wait for the server
+    if test $k -eq 1; then
+        wait $!
+    else
+        clients="$clients $!"
+    fi
+done
+wait $clients
+compare () {
+    for f in out err status; do
+        if ! cmp -s "$dir/$1.$f" "$dir/$2.$f"; then
+            echo "Request $2: standard $f differs"
+            diff "$dir/$1.$f" "$dir/$2.$f"
+            status=1
+        fi
+    done
+}
+for k in 1 2 3 4 5 6 7 8; do
+    compare want got$k
+done
+
+# The usage message for a bad option goes to the client
+"$tool" --bad-option > "$dir/bad.out" 2> "$dir/bad.err" < /dev/null
+echo $? > "$dir/bad.status"
+"$tool" --connect "$sock" --bad-option > "$dir/gotbad.out" \
+    2> "$dir/gotbad.err" < /dev/null
+echo $? > "$dir/gotbad.status"
+compare bad gotbad
+if test ! -s "$dir/gotbad.err"; then
+    echo "No usage message for a bad option"
+    status=1
+fi
+
+# The server limits the size of a request
+if head -c 17000000 /dev/zero |
+        "$tool" --connect "$sock" "$@" > /dev/null 2> "$dir/big.err" ||
+        test ! -s "$dir/big.err"; then
+    echo "Large input accepted by the client"
+    status=1
+fi
+
+# A remote request can't read the server's files (or, e.g., load its own
+# geoids); the error message must mention --connect
+oldifs=$IFS
+IFS=';'
+set -- "--input-file /dev/null" "--output-file /dev/null" $reject
+IFS=$oldifs
+for opts in "$@"; do
+    if "$tool" --connect "$sock" $opts < /dev/null > /dev/null \
+           2> "$dir/reject.err" ||
+            ! grep -q -e --connect "$dir/reject.err"; then
+        echo "$opts accepted by the server"
+        status=1
+    fi
+done
+
+# The test also matches this output (ctest ignores the exit status when
+# matching)
+test $status -eq 0 && cat "$dir/want.out"
+exit $status
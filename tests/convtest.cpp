@@ -0,0 +1,783 @@
+/**
+ * \file convtest.cpp
+ * \brief Test the conversions of coordinates to and from strings
+ *
+ * Copyright (c) Charles Karney (2022) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <GeographicLib/DMS.hpp>
+#include <GeographicLib/GARS.hpp>
+#include <GeographicLib/GeoCoords.hpp>
+#include <GeographicLib/Geohash.hpp>
+#include <GeographicLib/Georef.hpp>
+#include <GeographicLib/MGRS.hpp>
+#include <GeographicLib/UTMUPS.hpp>
+#include <GeographicLib/Utility.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+typedef Math::real T;
+
+static int checkSame(T x, T y) {
+  // Results computed in different ways must be bitwise identical
+  if (x == y || (isnan(x) && isnan(y)))
+    return 0;
+  cout << "checkSame fails: " << x << " != " << y << "\n";
+  return 1;
+}
+
+static int checkString(const string& x, const string& y) {
+  if (x == y)
+    return 0;
+  cout << "checkString fails: " << x << " != " << y << "\n";
+  return 1;
+}
+
+// Check that a representation written to a char array by f matches the
+// std::string returned by g, or that both throw an exception.
+template<typename F, typename G>
+static int checkRep(F f, G g) {
+  char buf[64];
+  string s;
+  bool thrown = false, throwna = false;
+  try { s = g(); } catch (const GeographicErr&) { thrown = true; }
+  try { f(buf, sizeof(buf)); } catch (const GeographicErr&) { throwna = true; }
+  if (thrown || throwna) {
+    if (thrown == throwna) return 0;
+    cout << "checkRep fails: only one version throws\n";
+    return 1;
+  }
+  return checkString(buf, s);
+}
+
+static int testmgrsbatch() {
+  // The char array and batch versions of MGRS::Forward and Reverse give
+  // the same results as the std::string versions; the digits are those of
+  // the UTM/UPS coordinates truncated to 1 m; illegal strings are rejected.
+  const int n = 500, len = MGRS::MAXLENGTH + 1;
+  vector<int> zone(n), zonea(n), preca(n);
+  vector<T> lat(n), x(n), y(n), xa(n), ya(n);
+  unique_ptr<bool[]> northp(new bool[n]), northpa(new bool[n]);
+  vector<char> mgrs(n * len), mgrsa(n * len);
+  for (int i = 0; i < n; ++i) {
+    T lon = remainder(T(i) * T(7.3), T(360));
+    lat[i] = T(89.9) * sin(T(i) / 7);
+    UTMUPS::Forward(lat[i], lon, zone[i], northp[i], x[i], y[i]);
+  }
+  int result = 0;
+  {
+    string s;
+    MGRS::Forward(38, true, T(444140.6), T(3684706.3), 2, s);
+    result += checkString(s, "38SMB4484");
+  }
+  for (int prec = 0; prec <= 5; prec += 5) {
+    MGRS::ForwardBatch(n, zone.data(), northp.get(), x.data(), y.data(),
+                       prec, mgrs.data());
+    MGRS::ForwardBatch(n, zone.data(), northp.get(), x.data(), y.data(),
+                       prec, mgrsa.data(), lat.data());
+    for (int i = 0; i < n; ++i) {
+      string s, sa;
+      char buf[len];
+      MGRS::Forward(zone[i], northp[i], x[i], y[i], prec, s);
+      MGRS::Forward(zone[i], northp[i], x[i], y[i], lat[i], prec, sa);
+      int l = MGRS::Forward(zone[i], northp[i], x[i], y[i], prec, buf);
+      result += checkString(mgrs.data() + i * len, s) +
+        checkString(mgrsa.data() + i * len, sa) + checkString(buf, s);
+      result += l != int(s.size());
+      if (prec == 5) {
+        // The trailing digits are the easting and northing mod 100 km
+        long long
+          e = (long long)(floor(x[i])) % 100000,
+          nn = (long long)(floor(y[i])) % 100000;
+        char digits[16];
+        snprintf(digits, sizeof(digits), "%05lld%05lld", e, nn);
+        result += checkString(s.substr(s.size() - 10), digits);
+      }
+    }
+    MGRS::ReverseBatch(n, mgrs.data(), zonea.data(), northpa.get(),
+                       xa.data(), ya.data(), preca.data(), false);
+    for (int i = 0; i < n; ++i) {
+      int zoneb, precb;
+      bool northpb;
+      T xb, yb;
+      MGRS::Reverse(string(mgrs.data() + i * len), zoneb, northpb, xb, yb,
+                    precb, false);
+      result += zonea[i] != zoneb || northpa[i] != northpb ||
+        preca[i] != precb || precb != prec;
+      result += checkSame(xa[i], xb) + checkSame(ya[i], yb);
+      // The SW corner of the square containing the point
+      T q = prec == 5 ? 1 : 100000;
+      result += checkSame(xb, floor(x[i] / q) * q) +
+        checkSame(yb, floor(y[i] / q) * q);
+    }
+  }
+  // The first record is legal and the second is not
+  memset(mgrs.data(), 0, len);
+  memcpy(mgrs.data(), "38SMB4484", 9);
+  // The too-long string (precision 12) fills its whole record in the batch
+  // so it is not null terminated.
+  const char* bad[] = {"38SMB448", "38SIB4484", "", "61SMB4484",
+                       "38SMB44x4", "38SMB 4484",
+                       "38SMB444444444444444444444444"};
+  for (const char* b : bad) {
+    int zoneb, precb;
+    bool northpb;
+    T xb, yb;
+    try {
+      MGRS::Reverse(b, strlen(b), zoneb, northpb, xb, yb, precb);
+      ++result;
+    }
+    catch (const GeographicErr&) {}
+    memset(mgrs.data() + len, 0, len);
+    memcpy(mgrs.data() + len, b, min(strlen(b), size_t(len)));
+    try {
+      MGRS::ReverseBatch(2, mgrs.data(), zonea.data(), northpa.get(),
+                         xa.data(), ya.data());
+      ++result;
+    }
+    catch (const GeographicErr&) {}
+  }
+  return result;
+}
+
+static int testgeocoordsbuffer() {
+  // GeoCoords::Reset with a char array parses strings as the std::string
+  // version does, and the representations written to char arrays match
+  // those returned as std::strings; illegal strings and buffers which are
+  // too small are rejected.
+  const char* input[] = {"33.3 44.4", "-33.3 -44.4", "38SMB4484",
+                         "38n 444140 3684706", "s 2000000 2000000",
+                         "33d18'N 44d24'E", "89.99 0", "-0.0000001 179.9999",
+                         "4QFJ12345678", "ZAB", "31U"};
+  int result = 0;
+  for (const char* in : input) {
+    for (int longfirst = 0; longfirst < 2; ++longfirst) {
+      GeoCoords p, pa;
+      bool thrown = false, throwna = false;
+      try { p.Reset(string(in), true, longfirst != 0); }
+      catch (const GeographicErr&) { thrown = true; }
+      try { pa.Reset(in, strlen(in), true, longfirst != 0); }
+      catch (const GeographicErr&) { throwna = true; }
+      result += thrown != throwna;
+      if (thrown || throwna) continue;
+      result += checkSame(p.Latitude(), pa.Latitude()) +
+        checkSame(p.Longitude(), pa.Longitude()) +
+        checkSame(p.Easting(), pa.Easting()) +
+        checkSame(p.Northing(), pa.Northing());
+      result += p.Zone() != pa.Zone() || p.Northp() != pa.Northp();
+      // Use the neighboring UTM zone for the alternate representation if
+      // possible.
+      try {
+        p.SetAltZone(p.Zone() == UTMUPS::UPS ? UTMUPS::UPS :
+                     (p.Zone() % 60) + 1);
+      }
+      catch (const GeographicErr&) {}
+      const bool lf = longfirst != 0;
+      for (int prec = -5; prec <= 10; ++prec) {
+        result += checkRep([&](char* b, size_t m) -> void {
+            p.GeoRepresentation(prec, lf, b, m); },
+          [&]() -> string { return p.GeoRepresentation(prec, lf); });
+        result += checkRep([&](char* b, size_t m) -> void {
+            p.DMSRepresentation(prec, lf, ':', b, m); },
+          [&]() -> string { return p.DMSRepresentation(prec, lf, ':'); });
+        result += checkRep([&](char* b, size_t m) -> void {
+            p.MGRSRepresentation(prec, b, m); },
+          [&]() -> string { return p.MGRSRepresentation(prec); });
+        result += checkRep([&](char* b, size_t m) -> void {
+            p.AltMGRSRepresentation(prec, b, m); },
+          [&]() -> string { return p.AltMGRSRepresentation(prec); });
+        for (int abbrev = 0; abbrev < 2; ++abbrev) {
+          const bool ab = abbrev != 0, np = !p.Northp();
+          result += checkRep([&](char* b, size_t m) -> void {
+              p.UTMUPSRepresentation(prec, ab, b, m); },
+            [&]() -> string { return p.UTMUPSRepresentation(prec, ab); });
+          result += checkRep([&](char* b, size_t m) -> void {
+              p.UTMUPSRepresentation(np, prec, ab, b, m); },
+            [&]() -> string {
+              return p.UTMUPSRepresentation(np, prec, ab); });
+          result += checkRep([&](char* b, size_t m) -> void {
+              p.AltUTMUPSRepresentation(prec, ab, b, m); },
+            [&]() -> string {
+              return p.AltUTMUPSRepresentation(prec, ab); });
+        }
+      }
+    }
+  }
+  {
+    // Compare with the conversions done directly
+    GeoCoords p;
+    T lat, lon, x, y;
+    int zone, prec;
+    bool northp;
+    p.Reset("33d18'N 44d24'E", 15);
+    DMS::DecodeLatLon("33d18'N", "44d24'E", lat, lon);
+    result += checkSame(p.Latitude(), lat) + checkSame(p.Longitude(), lon);
+    p.Reset("4QFJ12345678", 12);
+    MGRS::Reverse(string("4QFJ12345678"), zone, northp, x, y, prec);
+    UTMUPS::Reverse(zone, northp, x, y, lat, lon);
+    result += checkSame(p.Easting(), x) + checkSame(p.Northing(), y) +
+      checkSame(p.Latitude(), lat) + checkSame(p.Longitude(), lon);
+  }
+  const char* bad[] = {"", "33.3", "33.3 44.4 55.5 66.6", "38SMB448",
+                       "91 0", "38x 444140 3684706", "garbage", "33.3 4x"};
+  for (const char* in : bad) {
+    GeoCoords p;
+    try {
+      p.Reset(in, strlen(in));
+      ++result;
+    }
+    catch (const GeographicErr&) {}
+  }
+  {
+    GeoCoords p("33.3 44.4");
+    char buf[8];
+    try {
+      p.GeoRepresentation(5, false, buf, sizeof(buf));
+      ++result;
+    }
+    catch (const GeographicErr&) {}
+  }
+  return result;
+}
+
+static int testdmsdecodefast() {
+  // DMS::Decode gives the same results for plain decimal numbers (handled
+  // by the fast path) as when the numbers are given with a "d" suffix (and
+  // so parsed by the general parser) and, except for long integers (which
+  // the general parser accumulates digit by digit), as reading the number
+  // with an istringstream.
+  const char* input[] = {"0", "-0", "+12", "12.", ".5", "-.5", "  33.3 ",
+                         "-123.456789", "179.99999999999999",
+                         "0.1000000000000000055511151231257827",
+                         "123456789012345678901234567890", "1234567",
+                         "90.000000000000000000000000000001", "-7.25",
+                         "000000000000000000000000000000000001.5"};
+  int result = 0;
+  for (const char* in : input) {
+    DMS::flag ind, inda;
+    T x = DMS::Decode(string(in), ind);
+    string ins(in);
+    ins.erase(ins.find_last_not_of(' ') + 1);
+    T xa = DMS::Decode(ins + "d", inda);
+    result += checkSame(x, xa) + (ind != DMS::NONE) + (inda != DMS::NONE);
+    if (ins.find('.') != string::npos) {
+      istringstream str(ins);
+      T xb;
+      str >> xb;
+      result += checkSame(x, xb);
+    }
+  }
+  // Nearby strings which aren't plain decimal numbers
+  const char* bad[] = {"", "-", ".", "1.2.3", "12x", "--1", "+-1", "1 2"};
+  for (const char* in : bad) {
+    DMS::flag ind;
+    try {
+      DMS::Decode(string(in), ind);
+      ++result;
+    }
+    catch (const GeographicErr&) {}
+  }
+  return result;
+}
+
+// A straightforward geohash encoder by successive bisection (exact for the
+// first 52 bits or so).
+static string geohashref(T lat, T lon, int len) {
+  static const char* const digits = "0123456789bcdefghjkmnpqrstuvwxyz";
+  T lat0 = -90, lat1 = 90, lon0 = -180, lon1 = 180;
+  string h;
+  int bits = 0, c = 0;
+  bool lonp = true;
+  while (int(h.size()) < len) {
+    T& lo = lonp ? lon0 : lat0;
+    T& hi = lonp ? lon1 : lat1;
+    T x = lonp ? lon : lat, mid = (lo + hi) / 2;
+    c <<= 1;
+    if (x >= mid) { c |= 1; lo = mid; } else hi = mid;
+    lonp = !lonp;
+    if (++bits == 5) { h += digits[c]; bits = c = 0; }
+  }
+  return h;
+}
+
+static int testgridrefbatch() {
+  // The char array and batch versions of the Geohash, GARS, and Georef
+  // conversions give the same results as the std::string versions;
+  // geohashes match a reference encoder; illegal strings are rejected.
+  const int n = 300;
+  vector<T> lat(n), lon(n), lata(n), lona(n);
+  vector<int> prec(n);
+  for (int i = 0; i < n; ++i) {
+    lat[i] = T(89.9) * sin(T(i) / 7);
+    lon[i] = remainder(T(i) * T(7.3), T(360)) + T(0.1);
+  }
+  int result = 0;
+  {
+    string h;
+    Geohash::Forward(T(57.64911), T(10.40744), 11, h);
+    result += checkString(h, "u4pruydqqvj");
+    GARS::Forward(T(57.64911), T(10.40744), 2, h);
+    result += checkString(h, "381NH45");
+  }
+  const int hlen = Geohash::MAXLENGTH + 1;
+  vector<char> codes(n * hlen);
+  for (int len = 0; len <= 12; len += 4) {
+    Geohash::ForwardBatch(n, lat.data(), lon.data(), len, codes.data());
+    for (int i = 0; i < n; ++i) {
+      string h;
+      char buf[hlen];
+      Geohash::Forward(lat[i], lon[i], len, h);
+      Geohash::Forward(lat[i], lon[i], len, buf);
+      result += checkString(codes.data() + i * hlen, h) +
+        checkString(buf, h) + checkString(h, geohashref(lat[i], lon[i], len));
+    }
+    Geohash::ReverseBatch(n, codes.data(), lata.data(), lona.data(),
+                          prec.data(), false);
+    for (int i = 0; i < n; ++i) {
+      T lat1, lon1;
+      int len1;
+      Geohash::Reverse(string(codes.data() + i * hlen), lat1, lon1, len1,
+                       false);
+      result += checkSame(lata[i], lat1) + checkSame(lona[i], lon1) +
+        (prec[i] != len1) + (len1 != len);
+      result += !(lat1 <= lat[i] && lon1 <= lon[i]);
+    }
+  }
+  const int glen = GARS::MAXLENGTH + 1;
+  codes.resize(n * glen);
+  for (int p = 0; p <= 2; ++p) {
+    GARS::ForwardBatch(n, lat.data(), lon.data(), p, codes.data());
+    GARS::ReverseBatch(n, codes.data(), lata.data(), lona.data(),
+                       prec.data());
+    for (int i = 0; i < n; ++i) {
+      string h;
+      T lat1, lon1;
+      int p1;
+      GARS::Forward(lat[i], lon[i], p, h);
+      result += checkString(codes.data() + i * glen, h);
+      GARS::Reverse(h, lat1, lon1, p1);
+      result += checkSame(lata[i], lat1) + checkSame(lona[i], lon1) +
+        (prec[i] != p1) + (p1 != p);
+    }
+  }
+  const int rlen = Georef::MAXLENGTH + 1;
+  codes.resize(n * rlen);
+  for (int p = -1; p <= 6; ++p) {
+    Georef::ForwardBatch(n, lat.data(), lon.data(), p, codes.data());
+    Georef::ReverseBatch(n, codes.data(), lata.data(), lona.data(),
+                         prec.data());
+    for (int i = 0; i < n; ++i) {
+      string h;
+      T lat1, lon1;
+      int p1;
+      Georef::Forward(lat[i], lon[i], p, h);
+      result += checkString(codes.data() + i * rlen, h);
+      Georef::Reverse(h, lat1, lon1, p1);
+      result += checkSame(lata[i], lat1) + checkSame(lona[i], lon1) +
+        (prec[i] != p1) + (p1 != (p == 1 ? 2 : p)); // prec 1 acts as 2
+    }
+  }
+  {
+    const char* bad[] = {"u4pa", "u4p!", "u4pruydqqvjI"};
+    for (const char* b : bad) {
+      T lat1, lon1;
+      int len1;
+      try {
+        Geohash::Reverse(b, strlen(b), lat1, lon1, len1);
+        ++result;
+      }
+      catch (const GeographicErr&) {}
+    }
+  }
+  {
+    const char* bad[] = {"381N", "000AA", "721AA", "381NI", "381NH0",
+                         "381NH40"};
+    for (const char* b : bad) {
+      T lat1, lon1;
+      int p1;
+      try {
+        GARS::Reverse(b, strlen(b), lat1, lon1, p1);
+        ++result;
+      }
+      catch (const GeographicErr&) {}
+    }
+  }
+  {
+    const char* bad[] = {"N", "IKLN", "NKLN244", "NKLZ", "NKL1"};
+    for (const char* b : bad) {
+      T lat1, lon1;
+      int p1;
+      try {
+        Georef::Reverse(b, strlen(b), lat1, lon1, p1);
+        ++result;
+      }
+      catch (const GeographicErr&) {}
+    }
+  }
+  return result;
+}
+
+static int testgeocoordslazy() {
+  // A GeoCoords set from a latitude and longitude (or a string giving
+  // them) with the standard zone computes its UTM/UPS coordinates when
+  // they're needed; the results match those of UTMUPS::Forward and of
+  // GeoCoords given the zone explicitly (which are computed at once), also
+  // for copies made before the computation and for the alternate zone.
+  const T lats[] = {-90, -84, T(-80.5), -80, -45, -T(0), 0, 12, 56, 60,
+                    72, 84, T(84.5), 90, Math::NaN()};
+  const T lons[] = {-180, -T(0.5), 0, 3, T(5.5), 9, 21, 33, 42, 179, 180};
+  int result = 0;
+  for (T lat : lats)
+    for (T lon : lons) {
+      int zone;
+      bool northp;
+      T x, y, gam, k;
+      UTMUPS::Forward(lat, lon, zone, northp, x, y, gam, k);
+      GeoCoords a(lat, lon), c(a), e(lat, lon, isnan(lat) ?
+                                    int(UTMUPS::STANDARD) : zone);
+      ostringstream str;
+      str << lat << " " << lon;
+      GeoCoords s(str.str());
+      int j = a.Zone() != zone || a.Northp() != northp ||
+        c.Zone() != zone || s.Zone() != zone || e.Zone() != zone;
+      j += checkSame(a.Easting(), x) + checkSame(a.Northing(), y) +
+        checkSame(a.Convergence(), gam) + checkSame(a.Scale(), k);
+      j += checkSame(c.Northing(), y) + checkSame(s.Easting(), x) +
+        checkSame(s.Scale(), k);
+      // The alternate zone before and after the coordinates are computed
+      GeoCoords b(lat, lon);
+      j += b.AltZone() != zone;
+      j += checkSame(b.AltEasting(), x) + checkSame(b.AltNorthing(), y);
+      if (!isnan(lat)) {
+        for (int alt = -1; alt <= 1; alt += 2) {
+          // A neighboring zone, which may be too far away
+          const int z = zone == UTMUPS::UPS ? zone :
+            (zone + alt + 59) % 60 + 1;
+          GeoCoords d(lat, lon), f(lat, lon, zone);
+          bool dthrow = false, fthrow = false;
+          try { d.SetAltZone(z); }
+          catch (const GeographicErr&) { dthrow = true; }
+          try { f.SetAltZone(z); }
+          catch (const GeographicErr&) { fthrow = true; }
+          j += dthrow != fthrow;
+          if (fthrow) continue;
+          j += d.AltZone() != f.AltZone() ||
+            checkSame(d.AltEasting(), f.AltEasting()) +
+            checkSame(d.AltConvergence(), f.AltConvergence());
+          j += checkString(d.AltUTMUPSRepresentation(2),
+                           f.AltUTMUPSRepresentation(2));
+          d.SetAltZone();
+          j += checkSame(d.AltNorthing(), y);
+        }
+        for (int prec = -1; prec <= 3; ++prec)
+          j += checkString(a.UTMUPSRepresentation(prec),
+                           e.UTMUPSRepresentation(prec)) +
+            checkString(s.MGRSRepresentation(prec),
+                        e.MGRSRepresentation(prec)) +
+            checkString(c.AltUTMUPSRepresentation(prec, false),
+                        e.AltUTMUPSRepresentation(prec, false));
+      }
+      if (j) cout << "testgeocoordslazy failure: " << lat << " " << lon
+                  << "\n";
+      result += j;
+    }
+  // Latitudes out of range are rejected at once
+  for (int k = 0; k < 2; ++k) {
+    try {
+      GeoCoords g(k ? -91 : 91, 10);
+      ++result;
+    }
+    catch (const GeographicErr&) {}
+  }
+  return result;
+}
+
+static int testgeocoordsthreads() {
+  // Several threads query the same GeoCoords objects, whose UTM/UPS
+  // coordinates and alternate zone data haven't been computed yet, and copy
+  // them; all get the results of objects given the zone explicitly (which
+  // are computed at once).
+  const int n = 200, nthreads = 4;
+  vector<GeoCoords> lazy, eager;
+  for (int i = 0; i < n; ++i) {
+    T lat = T(i % 170) - 84 + T(0.25), lon = T(i * 7 % 360) - 180;
+    lazy.push_back(GeoCoords(lat, lon));
+    eager.push_back(GeoCoords(lat, lon, UTMUPS::StandardZone(lat, lon)));
+  }
+  vector<vector<T>> got(nthreads, vector<T>(6 * n));
+  vector<vector<string>> gotstr(nthreads, vector<string>(n));
+  vector<thread> pool;
+  for (int t = 0; t < nthreads; ++t)
+    pool.push_back(thread([&, t]() -> void {
+      for (int i = 0; i < n; ++i) {
+        // Threads walk the points in opposite directions and half of them
+        // start with the alternate zone data
+        int k = t % 2 ? i : n - 1 - i;
+        const GeoCoords& g = lazy[k];
+        T* r = got[t].data() + 6 * k;
+        if (t % 2) {
+          r[0] = g.AltEasting(); r[1] = g.Easting();
+        } else {
+          r[1] = g.Easting(); r[0] = g.AltEasting();
+        }
+        const GeoCoords c(g);
+        r[2] = c.Northing(); r[3] = g.AltConvergence();
+        r[4] = g.Scale(); r[5] = T(g.AltZone());
+        gotstr[t][k] = c.UTMUPSRepresentation(2);
+      }
+    }));
+  for (thread& t : pool) t.join();
+  int result = 0;
+  for (int t = 0; t < nthreads; ++t)
+    for (int i = 0; i < n; ++i) {
+      const GeoCoords& e = eager[i];
+      const T* r = got[t].data() + 6 * i;
+      result += checkSame(r[0], e.AltEasting()) +
+        checkSame(r[1], e.Easting()) + checkSame(r[2], e.Northing()) +
+        checkSame(r[3], e.AltConvergence()) + checkSame(r[4], e.Scale()) +
+        checkSame(r[5], T(e.AltZone())) +
+        checkString(gotstr[t][i], e.UTMUPSRepresentation(2));
+    }
+  return result;
+}
+
+static int testaltzonebatch() {
+  // GeoCoords::SetAltZoneBatch has the same effect as calling SetAltZone
+  // on each object: the coordinates match bitwise and the objects for
+  // which SetAltZone throws an exception are left to do so.  The objects
+  // are made in several ways, there are more than fit in one block, and
+  // the zones include ones which some of the points can't use.
+  const int n = 2500;
+  vector<GeoCoords> a(n);
+  for (int i = 0; i < n; ++i) {
+    T lat = T(89.9) * sin(T(i) * T(0.37)),
+      lon = remainder(T(i) * T(13.7), T(360));
+    switch (i % 5) {
+    case 0: a[i].Reset(lat, lon); break;
+    case 1: a[i].Reset(lat, lon, UTMUPS::StandardZone(lat, lon)); break;
+    case 2: a[i].Reset(Utility::str(lat, 6) + " " + Utility::str(lon, 6));
+      break;
+    case 3: a[i].Reset(GeoCoords(lat, lon).MGRSRepresentation(1)); break;
+    default:
+      if (i % 25 == 4) a[i].Reset(Math::NaN(), lon);
+      else a[i].Reset(GeoCoords(lat, lon).UTMUPSRepresentation(2));
+      break;
+    }
+    // Some objects start with a different alternate zone (if they can)
+    if (i % 7 == 0) {
+      try { a[i].SetAltZone(UTMUPS::UTM); }
+      catch (const GeographicErr&) {}
+    }
+  }
+  const int zones[] = {UTMUPS::STANDARD, UTMUPS::MATCH, UTMUPS::UTM,
+                       UTMUPS::UPS, 1, 38, 60};
+  int result = 0;
+  for (int zone : zones) {
+    vector<GeoCoords> b(a), c(a);
+    GeoCoords::SetAltZoneBatch(n, b.data(), zone);
+    int j = 0;
+    for (int i = 0; i < n; ++i) {
+      bool bthrow = false, cthrow = false;
+      try { b[i].SetAltZone(zone); }
+      catch (const GeographicErr&) { bthrow = true; }
+      try { c[i].SetAltZone(zone); }
+      catch (const GeographicErr&) { cthrow = true; }
+      j += bthrow != cthrow;
+      j += b[i].Zone() != c[i].Zone() || b[i].AltZone() != c[i].AltZone();
+      j += checkSame(b[i].Easting(), c[i].Easting()) +
+        checkSame(b[i].Northing(), c[i].Northing()) +
+        checkSame(b[i].Convergence(), c[i].Convergence()) +
+        checkSame(b[i].Scale(), c[i].Scale()) +
+        checkSame(b[i].AltEasting(), c[i].AltEasting()) +
+        checkSame(b[i].AltNorthing(), c[i].AltNorthing()) +
+        checkSame(b[i].AltConvergence(), c[i].AltConvergence()) +
+        checkSame(b[i].AltScale(), c[i].AltScale());
+    }
+    if (j) cout << "testaltzonebatch failure: zone " << zone << "\n";
+    result += j;
+  }
+  return result;
+}
+
+static int testformatbuffer() {
+  // Utility::str and DMS::Encode writing to char arrays give the same
+  // strings as the versions returning std::strings (including for signed
+  // zeros, ties, and special values) and the correct lengths; a buffer
+  // with no room for the terminating null is rejected.
+  const T nums[] = {0, -T(0), 1/T(3), T(2.5), T(0.125), T(-1e-10),
+                    T(1234567.891), T(1e20), T(179.99999999), T(-359.5),
+                    Math::NaN(), Math::infinity(), -Math::infinity()};
+  int result = 0;
+  // Write with f into a buffer of n + 1 and n characters where n is the
+  // length of s
+  auto fits = [](const string& s, function<size_t(char*, size_t)> f)
+    -> int {
+    vector<char> buf(s.size() + 1);
+    int r = f(buf.data(), buf.size()) != s.size() ||
+      checkString(buf.data(), s);
+    try {
+      f(buf.data(), s.size());
+      ++r;
+    }
+    catch (const GeographicErr&) {}
+    return r;
+  };
+  for (T x : nums) {
+    for (int p = -1; p <= 15; ++p) {
+      result += checkRep([&](char* b, size_t m) -> void {
+          Utility::str(x, p, b, m); },
+        [&]() -> string { return Utility::str(x, p); });
+      result += fits(Utility::str(x, p), [&](char* b, size_t m) -> size_t {
+          return Utility::str(x, p, b, m); });
+    }
+    const DMS::flag inds[] = {DMS::NONE, DMS::LATITUDE, DMS::LONGITUDE,
+                              DMS::AZIMUTH, DMS::NUMBER};
+    for (DMS::flag ind : inds)
+      for (int sep = 0; sep < 2; ++sep) {
+        const char dmssep = sep ? ':' : char(0);
+        for (unsigned prec = 0; prec <= 12; ++prec) {
+          result += checkRep([&](char* b, size_t m) -> void {
+              DMS::Encode(x, prec, ind, dmssep, b, m); },
+            [&]() -> string { return DMS::Encode(x, prec, ind, dmssep); });
+          for (int c = 0; c < 3; ++c) {
+            const DMS::component tr = DMS::component(c);
+            result += checkRep([&](char* b, size_t m) -> void {
+                DMS::Encode(x, tr, prec, ind, dmssep, b, m); },
+              [&]() -> string {
+                return DMS::Encode(x, tr, prec, ind, dmssep); });
+          }
+        }
+        if (isfinite(x) && fabs(x) < 1000)
+          result += fits(DMS::Encode(x, DMS::SECOND, 3, ind, dmssep),
+                         [&](char* b, size_t m) -> size_t {
+                           return DMS::Encode(x, DMS::SECOND, 3, ind,
+                                              dmssep, b, m); });
+      }
+  }
+  return result;
+}
+
+// Convert s to a T with a stream, as Utility::val did before plain numbers
+// were read with strtod; return false if this would throw an exception.
+template<typename U>
+static bool streamval(const string& s, U& x) {
+  string t(Utility::trim(s));
+  if (t.empty()) return false;
+  istringstream is(t);
+  U y;
+  if (is >> y) {
+    int pos = int(is.tellg());
+    if (pos < 0 || pos == int(t.size())) {
+      x = y;
+      return true;
+    }
+  }
+  if (numeric_limits<U>::is_integer) return false;
+  y = Utility::nummatch<U>(t);
+  if (y == 0) return false;
+  x = y;
+  return true;
+}
+
+// Check that Utility::val<U> (both versions) and streamval agree on s
+template<typename U>
+static int checkVal(const string& s) {
+  U x = 7, y = 7, z = 7;
+  bool ok = streamval<U>(s, x), oka = Utility::val<U>(s.data(), s.size(), y),
+    okb = true;
+  try { z = Utility::val<U>(s); }
+  catch (const GeographicErr&) { okb = false; }
+  bool same = ok == oka && ok == okb &&
+    (!ok || ((x == y || (x != x && y != y)) &&
+             (x == z || (x != x && z != z)) &&
+             signbit(double(x)) == signbit(double(y))));
+  if (!ok) same = same && y == 7;
+  if (same) return 0;
+  cout << "checkVal fails: \"" << s << "\" " << x << " " << y << " " << z
+       << " " << ok << oka << okb << "\n";
+  return 1;
+}
+
+static int testvalfast() {
+  // Utility::val reads plain numbers with strtod and the like; the results
+  // (and the rejection of bad strings) are the same as reading them with a
+  // stream for each type, including for overflow, underflow, subnormals,
+  // long strings, and special values.
+  vector<string> strs = {
+    "0", "-0", "+5", " 12 ", "\t-3.25\n", "1.", ".5", "-.5e-3", "1e", "e5",
+    "1e+", "1.5E+300", "1e400", "-1e400", "1e-400", "4.9e-324", "2.2e-308",
+    "3.4028235e38", "3.5e38", "1e-46", "0x10", "0x1p3", "12abc", "1 2",
+    "--1", "+-1", "1.2.3", ".", "", " ", "nan", "-inf", "INFINITY", "1.#INF",
+    "-1.#IND", "Nan00", "2147483647", "2147483648", "-2147483648",
+    "-2147483649", "9223372036854775807", "9223372036854775808", "007",
+    "1e5", "12.0", "0.1000000000000000055511151231257827021181583404541015625",
+    "123456789012345678901234567890123456789012345678901234567890123456789",
+    "1.00000000000000011102230246251565404236316680908203125",
+    "0.30000000000000004", "179.99999999999998578"};
+  // Random numbers written with various precisions
+  for (int i = 0; i < 500; ++i) {
+    double x = ldexp(double((i * 2654435761u) % 1000003u) + 0.123456789 * i,
+                     (i * 37) % 200 - 100);
+    if (i % 2) x = -x;
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%.*g", 1 + i % 20, x);
+    strs.push_back(buf);
+    snprintf(buf, sizeof(buf), "%.*f", i % 12, x);
+    if (strlen(buf) < 40) strs.push_back(buf);
+  }
+  int result = 0;
+  for (const string& s : strs)
+    result += checkVal<double>(s) + checkVal<float>(s) +
+      checkVal<long double>(s) + checkVal<T>(s) + checkVal<int>(s) +
+      checkVal<long>(s) + checkVal<long long>(s);
+  return result;
+}
+
+int main() {
+  int n = 0, i;
+
+  i = testmgrsbatch(); n += i;
+  if (i) cout << "testmgrsbatch failure\n";
+
+  i = testgeocoordsbuffer(); n += i;
+  if (i) cout << "testgeocoordsbuffer failure\n";
+
+  i = testdmsdecodefast(); n += i;
+  if (i) cout << "testdmsdecodefast failure\n";
+
+  i = testgridrefbatch(); n += i;
+  if (i) cout << "testgridrefbatch failure\n";
+
+  i = testgeocoordslazy(); n += i;
+  if (i) cout << "testgeocoordslazy failure\n";
+
+  i = testgeocoordsthreads(); n += i;
+  if (i) cout << "testgeocoordsthreads failure\n";
+
+  i = testaltzonebatch(); n += i;
+  if (i) cout << "testaltzonebatch failure\n";
+
+  i = testformatbuffer(); n += i;
+  if (i) cout << "testformatbuffer failure\n";
+
+  i = testvalfast(); n += i;
+  if (i) cout << "testvalfast failure\n";
+
+  if (n) {
+    cout << n << " failure" << (n > 1 ? "s" : "") << "\n";
+    return 1;
+  }
+}
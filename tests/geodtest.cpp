@@ -7,9 +7,64 @@
  * https://geographiclib.sourceforge.io/
  **********************************************************************/
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
 #include <iostream>
+#include <sstream>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
 #include <GeographicLib/Geodesic.hpp>
+#include <GeographicLib/Geocentric.hpp>
+#include <GeographicLib/Accumulator.hpp>
+#include <GeographicLib/AlbersEqualArea.hpp>
+#include <GeographicLib/AuxLatitude.hpp>
+#include <GeographicLib/AzimuthalEquidistant.hpp>
+#include <GeographicLib/CassiniSoldner.hpp>
+#include <GeographicLib/ClosestApproach.hpp>
+#include <GeographicLib/ClosestPoint.hpp>
+#include <GeographicLib/CPUDispatch.hpp>
+#include <GeographicLib/GeodesicBatchExecutor.hpp>
+#include <GeographicLib/GeodesicBuffer.hpp>
 #include <GeographicLib/GeodesicExact.hpp>
+#include <GeographicLib/GeodesicLine.hpp>
+#include <GeographicLib/GeodesicLineCompact.hpp>
+#include <GeographicLib/GeodesicLineExact.hpp>
+#include <GeographicLib/GeodesicRegion.hpp>
+#include <GeographicLib/GARS.hpp>
+#include <GeographicLib/Gnomonic.hpp>
+#include <GeographicLib/Geohash.hpp>
+#include <GeographicLib/Georef.hpp>
+#include <GeographicLib/GridLines.hpp>
+#include <GeographicLib/Helmert.hpp>
+#include <GeographicLib/Rhumb.hpp>
+#include <GeographicLib/PolarStereographic.hpp>
+#include <GeographicLib/SpatialJoin.hpp>
+#include <GeographicLib/SphericalHarmonic.hpp>
+#include <GeographicLib/StridedView.hpp>
+#include <GeographicLib/SphericalHarmonic1.hpp>
+#include <GeographicLib/DST.hpp>
+#include <GeographicLib/Intersect.hpp>
+#include <GeographicLib/JacobiConformal.hpp>
+#include <GeographicLib/LambertConformalConic.hpp>
+#include <GeographicLib/LocalCartesian.hpp>
+#include <GeographicLib/LocalCartesianSet.hpp>
+#include <GeographicLib/Ellipsoid.hpp>
+#include <GeographicLib/EllipticFunction.hpp>
+#include <GeographicLib/ExactAccumulator.hpp>
+#include <GeographicLib/OSGB.hpp>
+#include <GeographicLib/PointInPolygon.hpp>
+#include <GeographicLib/PolygonArea.hpp>
+#include <GeographicLib/PolygonReader.hpp>
+#include <GeographicLib/TransverseMercator.hpp>
+#include <GeographicLib/TransverseMercatorExact.hpp>
+#include <GeographicLib/TriaxialGeodesic.hpp>
+#include <GeographicLib/UTMUPS.hpp>
+#include <GeographicLib/Utility.hpp>
 
 using namespace std;
 using namespace GeographicLib;
@@ -23,6 +78,14 @@ static int checkEquals(T x, T y, T d) {
   return 1;
 }
 
+static int checkSame(T x, T y) {
+  // Batch results must be bitwise identical to the scalar ones
+  if (x == y || (isnan(x) && isnan(y)))
+    return 0;
+  cout << "checkSame fails: " << x << " != " << y << "\n";
+  return 1;
+}
+
 static const int ncases = 20;
 static const T testcases[ncases][12] = {
   {35.60777, -139.44815, 111.098748429560326,
@@ -192,28 +255,3509 @@ static int testarcdirect(T f = 1) {
   return result;
 }
 
-int main() {
-  int n = 0, i;
+template <class G>
+static int testinversebatch() {
+  T lat1[ncases], lon1[ncases], lat2[ncases], lon2[ncases],
+    a12[ncases], s12[ncases], azi1[ncases], azi2[ncases],
+    m12[ncases], M12[ncases], M21[ncases], S12[ncases], s12b[ncases];
+  T s12a, azi1a, azi2a, m12a, M12a, M21a, S12a, a12a;
+  const G& g = G::WGS84();
+  for (int i = 0; i < ncases; ++i) {
+    lat1[i] = testcases[i][0]; lon1[i] = testcases[i][1];
+    lat2[i] = testcases[i][3]; lon2[i] = testcases[i][4];
+  }
+  g.InverseBatch(ncases, lat1, lon1, lat2, lon2, G::ALL,
+                 a12, s12, azi1, azi2, m12, M12, M21, S12);
+  // Only request the distance
+  g.InverseBatch(ncases, lat1, lon1, lat2, lon2, G::ALL,
+                 nullptr, s12b, nullptr, nullptr,
+                 nullptr, nullptr, nullptr, nullptr);
+  int result = 0;
+  for (int i = 0; i < ncases; ++i) {
+    int k = 0;
+    a12a = g.GenInverse(lat1[i], lon1[i], lat2[i], lon2[i], G::ALL,
+                        s12a, azi1a, azi2a, m12a, M12a, M21a, S12a);
+    k += checkSame(a12[i], a12a);
+    k += checkSame(s12[i], s12a);
+    k += checkSame(azi1[i], azi1a);
+    k += checkSame(azi2[i], azi2a);
+    k += checkSame(m12[i], m12a);
+    k += checkSame(M12[i], M12a);
+    k += checkSame(M21[i], M21a);
+    k += checkSame(S12[i], S12a);
+    k += checkSame(s12b[i], s12a);
+    if (k) cout << "testinversebatch failure: case " << i << "\n";
+    result += k;
+  }
+  return result;
+}
 
-  i = testinverse<Geodesic>(); n += i;
-  if (i) cout << "testinverse<Geodesic> failure\n";
+template <class G>
+static int testdirectbatch() {
+  T lat1[ncases], lon1[ncases], azi1[ncases], s12[ncases],
+    a12[ncases], lat2[ncases], lon2[ncases], azi2[ncases],
+    m12[ncases], M12[ncases], M21[ncases], S12[ncases];
+  T lat2a, lon2a, azi2a, s12a, m12a, M12a, M21a, S12a, a12a;
+  const G& g = G::WGS84();
+  const unsigned outmask = G::ALL | G::LONG_UNROLL;
+  for (int i = 0; i < ncases; ++i) {
+    lat1[i] = testcases[i][0]; lon1[i] = testcases[i][1];
+    azi1[i] = testcases[i][2]; s12[i] = testcases[i][6];
+  }
+  g.DirectBatch(ncases, lat1, lon1, azi1, false, s12, outmask,
+                a12, lat2, lon2, azi2, nullptr, m12, M12, M21, S12);
+  int result = 0;
+  for (int i = 0; i < ncases; ++i) {
+    int k = 0;
+    a12a = g.GenDirect(lat1[i], lon1[i], azi1[i], false, s12[i], outmask,
+                       lat2a, lon2a, azi2a, s12a, m12a, M12a, M21a, S12a);
+    k += checkSame(a12[i], a12a);
+    k += checkSame(lat2[i], lat2a);
+    k += checkSame(lon2[i], lon2a);
+    k += checkSame(azi2[i], azi2a);
+    k += checkSame(m12[i], m12a);
+    k += checkSame(M12[i], M12a);
+    k += checkSame(M21[i], M21a);
+    k += checkSame(S12[i], S12a);
+    if (k) cout << "testdirectbatch failure: case " << i << "\n";
+    result += k;
+  }
+  // Points along a single line given by arc length
+  auto l = g.Line(lat1[0], lon1[0], azi1[0]);
+  for (int i = 0; i < ncases; ++i)
+    a12[i] = testcases[i][7];
+  l.PositionBatch(ncases, true, a12, outmask,
+                  nullptr, lat2, lon2, azi2, s12, m12, M12, M21, S12);
+  for (int i = 0; i < ncases; ++i) {
+    int k = 0;
+    l.GenPosition(true, a12[i], outmask,
+                  lat2a, lon2a, azi2a, s12a, m12a, M12a, M21a, S12a);
+    k += checkSame(lat2[i], lat2a);
+    k += checkSame(lon2[i], lon2a);
+    k += checkSame(azi2[i], azi2a);
+    k += checkSame(s12[i], s12a);
+    k += checkSame(m12[i], m12a);
+    k += checkSame(M12[i], M12a);
+    k += checkSame(M21[i], M21a);
+    k += checkSame(S12[i], S12a);
+    if (k) cout << "testdirectbatch line failure: case " << i << "\n";
+    result += k;
+  }
+  return result;
+}
 
-  i = testdirect<Geodesic>(); n += i;
-  if (i) cout << "testdirect<Geodesic> failure\n";
+template <class G>
+static int testexecutor() {
+  // Many copies of the test cases solved with 3 threads and small chunks so
+  // that the work stealing code is exercised.
+  const int n = 50 * ncases;
+  vector<T> lat1(n), lon1(n), lat2(n), lon2(n), s12(n), S12(n);
+  for (int i = 0; i < n; ++i) {
+    lat1[i] = testcases[i % ncases][0]; lon1[i] = testcases[i % ncases][1];
+    lat2[i] = testcases[i % ncases][3]; lon2[i] = testcases[i % ncases][4];
+  }
+  const G& g = G::WGS84();
+  GeodesicBatchExecutor exec(3, 7);
+  exec.Inverse(g, n, lat1.data(), lon1.data(), lat2.data(), lon2.data(),
+               G::DISTANCE | G::AREA, nullptr, s12.data(), nullptr, nullptr,
+               nullptr, nullptr, nullptr, S12.data());
+  int result = 0;
+  for (int i = 0; i < n; ++i) {
+    T s12a, S12a, t;
+    g.GenInverse(lat1[i], lon1[i], lat2[i], lon2[i], G::DISTANCE | G::AREA,
+                 s12a, t, t, t, t, t, S12a);
+    int k = checkSame(s12[i], s12a) + checkSame(S12[i], S12a);
+    if (k) cout << "testexecutor failure: case " << i << "\n";
+    result += k;
+  }
+  return result;
+}
 
-  i = testarcdirect<Geodesic>(); n += i;
-  if (i) cout << "testarcdirect<Geodesic> failure\n";
+static int testthreadrun() {
+  // An exception on the calling thread reaches the caller only after the
+  // other workers have finished (rather than terminating the program).
+  int result = 0;
+  atomic<unsigned> done(0);
+  bool thrown = false;
+  try {
+    GeodesicBatchExecutor::ThreadRun(4, [&done](unsigned k) -> void {
+      if (k == 0) throw GeographicErr("test");
+      this_thread::sleep_for(chrono::milliseconds(10));
+      ++done;
+    });
+  }
+  catch (const GeographicErr&) {
+    thrown = true;
+  }
+  result += thrown && done == 3 ? 0 : 1;
+  done = 0;
+  GeodesicBatchExecutor::ThreadRun(5, [&done](unsigned) -> void { ++done; });
+  result += done == 5 ? 0 : 1;
+  return result;
+}
 
-  // Allow 2x error with GeodesicExact calcuations (for WGS84)
-  i = testinverse<GeodesicExact>(2); n += i;
-  if (i) cout << "testinverse<GeodesicExact> failure\n";
+static int testtmbatch() {
+  // TransverseMercator::ForwardBatch and ReverseBatch give the same results
+  // as Forward and Reverse (for more points than are processed together
+  // and for outputs overwriting the inputs).
+  const TransverseMercator& tm = TransverseMercator::UTM();
+  const int n = 300;
+  const T lon0 = -3;
+  vector<T> lat(n), lon(n), x(n), y(n), gamma(n), k(n), lata(n), lona(n);
+  for (int i = 0; i < n; ++i) {
+    lat[i] = 90 * sin(T(i) / 7);
+    lon[i] = lon0 + 60 * cos(T(i) / 11);
+  }
+  lat[0] = 90; lat[1] = -90; lon[2] = lon0 + 90; lat[2] = 0;
+  int result = 0;
+  tm.ForwardBatch(n, lon0, lat.data(), lon.data(), x.data(), y.data(),
+                  gamma.data(), k.data());
+  for (int i = 0; i < n; ++i) {
+    T xa, ya, gammaa, ka;
+    tm.Forward(lon0, lat[i], lon[i], xa, ya, gammaa, ka);
+    result += checkSame(x[i], xa) + checkSame(y[i], ya) +
+      checkSame(gamma[i], gammaa) + checkSame(k[i], ka);
+  }
+  tm.ReverseBatch(n, lon0, x.data(), y.data(), lata.data(), lona.data(),
+                  gamma.data(), k.data());
+  for (int i = 0; i < n; ++i) {
+    T lat1, lon1, gammaa, ka;
+    tm.Reverse(lon0, x[i], y[i], lat1, lon1, gammaa, ka);
+    result += checkSame(lata[i], lat1) + checkSame(lona[i], lon1) +
+      checkSame(gamma[i], gammaa) + checkSame(k[i], ka);
+  }
+  // In place, without gamma and k
+  vector<T> xa(x), ya(y);
+  tm.ReverseBatch(n, lon0, xa.data(), ya.data(), xa.data(), ya.data());
+  tm.ForwardBatch(n, lon0, xa.data(), ya.data(), xa.data(), ya.data());
+  for (int i = 0; i < n; ++i) {
+    T x1, y1;
+    tm.Forward(lon0, lata[i], lona[i], x1, y1);
+    result += checkSame(xa[i], x1) + checkSame(ya[i], y1);
+  }
+  return result;
+}
 
-  i = testdirect<GeodesicExact>(4); n += i;
-  if (i) cout << "testdirect<GeodesicExact> failure\n";
+static int testutmupsbatch() {
+  // UTMUPS::ForwardBatch gives the same results as Forward for points in
+  // many UTM zones and in UPS, with and without the MGRS limits and with
+  // a zone override, and it throws an exception for an invalid point.
+  const int n = 1500;
+  vector<T> lat(n), lon(n), x(n), y(n), gamma(n), k(n);
+  vector<int> zone(n);
+  unique_ptr<bool[]> northp(new bool[n]);
+  for (int i = 0; i < n; ++i) {
+    lat[i] = T(89.9) * sin(T(i) / 7);
+    lon[i] = remainder(T(i) * T(7.3), T(360));
+  }
+  int result = 0;
+  for (int mgrslimits = 0; mgrslimits < 2; ++mgrslimits) {
+    UTMUPS::ForwardBatch(n, lat.data(), lon.data(), zone.data(),
+                         northp.get(), x.data(), y.data(),
+                         gamma.data(), k.data(), UTMUPS::STANDARD,
+                         mgrslimits != 0);
+    for (int i = 0; i < n; ++i) {
+      int zonea;
+      bool northpa;
+      T xa, ya, gammaa, ka;
+      UTMUPS::Forward(lat[i], lon[i], zonea, northpa, xa, ya, gammaa, ka,
+                      UTMUPS::STANDARD, mgrslimits != 0);
+      result += zone[i] != zonea || northp[i] != northpa;
+      result += checkSame(x[i], xa) + checkSame(y[i], ya) +
+        checkSame(gamma[i], gammaa) + checkSame(k[i], ka);
+    }
+  }
+  // All points near zone 31 projected in that zone
+  for (int i = 0; i < n; ++i) {
+    lat[i] = 80 * sin(T(i) / 7); lon[i] = 3 + 3 * cos(T(i) / 5);
+  }
+  UTMUPS::ForwardBatch(n, lat.data(), lon.data(), zone.data(),
+                       northp.get(), x.data(), y.data(),
+                       nullptr, nullptr, 31);
+  for (int i = 0; i < n; ++i) {
+    int zonea;
+    bool northpa;
+    T xa, ya;
+    UTMUPS::Forward(lat[i], lon[i], zonea, northpa, xa, ya, 31);
+    result += zone[i] != 31 || northp[i] != northpa;
+    result += checkSame(x[i], xa) + checkSame(y[i], ya);
+  }
+  lat[n/2] = 91;
+  try {
+    UTMUPS::ForwardBatch(n, lat.data(), lon.data(), zone.data(),
+                         northp.get(), x.data(), y.data());
+    ++result;
+  }
+  catch (const GeographicErr&) {}
+  return result;
+}
 
-  i = testarcdirect<GeodesicExact>(2); n += i;
-  if (i) cout << "testarcdirect<GeodesicExact> failure\n";
+static int testtmexactseed() {
+  // TransverseMercatorExact with the tables of starting guesses agrees with
+  // the version without to within roundoff, and the batch functions give
+  // the same results as Forward and Reverse.
+  const TransverseMercatorExact
+    tm(Constants::WGS84_a(), Constants::WGS84_f(), Constants::UTM_k0()),
+    tms(Constants::WGS84_a(), Constants::WGS84_f(), Constants::UTM_k0(),
+        false, true);
+  int result = !tms.SeedTable() || tm.SeedTable();
+  const int n = 200;
+  const T lon0 = 9;
+  vector<T> lat(n), lon(n), x(n), y(n), gamma(n), k(n), lata(n), lona(n);
+  for (int i = 0; i < n; ++i) {
+    lat[i] = 89 * sin(T(i) / 7);
+    lon[i] = lon0 + 60 * cos(T(i) / 11);
+  }
+  tms.ForwardBatch(n, lon0, lat.data(), lon.data(), x.data(), y.data(),
+                   gamma.data(), k.data());
+  for (int i = 0; i < n; ++i) {
+    T xa, ya, gammaa, ka;
+    tms.Forward(lon0, lat[i], lon[i], xa, ya, gammaa, ka);
+    result += checkSame(x[i], xa) + checkSame(y[i], ya) +
+      checkSame(gamma[i], gammaa) + checkSame(k[i], ka);
+    tm.Forward(lon0, lat[i], lon[i], xa, ya, gammaa, ka);
+    result += checkEquals(x[i], xa, T(1e-8)) +
+      checkEquals(y[i], ya, T(1e-8)) +
+      checkEquals(gamma[i], gammaa, T(1e-11)) +
+      checkEquals(k[i], ka, T(1e-13));
+  }
+  tms.ReverseBatch(n, lon0, x.data(), y.data(), lata.data(), lona.data(),
+                   gamma.data(), k.data());
+  for (int i = 0; i < n; ++i) {
+    T lat1, lon1, gammaa, ka;
+    tms.Reverse(lon0, x[i], y[i], lat1, lon1, gammaa, ka);
+    result += checkSame(lata[i], lat1) + checkSame(lona[i], lon1) +
+      checkSame(gamma[i], gammaa) + checkSame(k[i], ka);
+    tm.Reverse(lon0, x[i], y[i], lat1, lon1, gammaa, ka);
+    result += checkEquals(lata[i], lat1, T(1e-11)) +
+      checkEquals(lona[i], lon1, T(1e-11)) +
+      checkEquals(lata[i], lat[i], T(1e-10)) +
+      checkEquals(lona[i], lon[i], T(1e-10));
+  }
+  return result;
+}
+
+static int testgeocentricbatch() {
+  // Geocentric::ForwardBatch and ReverseBatch give the same results as
+  // Forward and Reverse, including the rotation matrices and points near
+  // the center of the earth, on the axis, and very far away.
+  const Geocentric& earth = Geocentric::WGS84();
+  const int n = 150;
+  vector<T> lat(n), lon(n), h(n), X(n), Y(n), Z(n), M(9 * n);
+  for (int i = 0; i < n; ++i) {
+    lat[i] = 90 * sin(T(i) / 7);
+    lon[i] = remainder(T(i) * T(7.3), T(360));
+    h[i] = T(i % 5 - 1) * 3000;
+  }
+  lat[0] = 90; h[1] = -6350000; h[2] = 1e12;
+  int result = 0;
+  earth.ForwardBatch(n, lat.data(), lon.data(), h.data(),
+                     X.data(), Y.data(), Z.data(), M.data());
+  for (int i = 0; i < n; ++i) {
+    T Xa, Ya, Za;
+    vector<T> Ma(9);
+    earth.Forward(lat[i], lon[i], h[i], Xa, Ya, Za, Ma);
+    result += checkSame(X[i], Xa) + checkSame(Y[i], Ya) +
+      checkSame(Z[i], Za);
+    for (int j = 0; j < 9; ++j)
+      result += checkSame(M[9 * i + j], Ma[j]);
+  }
+  // Include the center of the earth and points near it
+  X[3] = Y[3] = Z[3] = 0; X[4] = 1; Y[4] = -2; Z[4] = 3;
+  vector<T> lata(n), lona(n), ha(n);
+  earth.ReverseBatch(n, X.data(), Y.data(), Z.data(),
+                     lata.data(), lona.data(), ha.data(), M.data());
+  for (int i = 0; i < n; ++i) {
+    T lat1, lon1, h1;
+    vector<T> Ma(9);
+    earth.Reverse(X[i], Y[i], Z[i], lat1, lon1, h1, Ma);
+    result += checkSame(lata[i], lat1) + checkSame(lona[i], lon1) +
+      checkSame(ha[i], h1);
+    for (int j = 0; j < 9; ++j)
+      result += checkSame(M[9 * i + j], Ma[j]);
+  }
+  // In place without the rotation matrices
+  earth.ReverseBatch(n, X.data(), Y.data(), Z.data(),
+                     X.data(), Y.data(), Z.data());
+  for (int i = 0; i < n; ++i)
+    result += checkSame(X[i], lata[i]) + checkSame(Y[i], lona[i]) +
+      checkSame(Z[i], ha[i]);
+  return result;
+}
+
+static int testlocalcartesianbatch() {
+  // LocalCartesian::ForwardBatch and ReverseBatch give the same results as
+  // Forward and Reverse, including the rotation matrices.
+  const LocalCartesian lc(T(-33.9), T(151.2), 40);
+  const int n = 150;
+  vector<T> lat(n), lon(n), h(n), x(n), y(n), z(n), M(9 * n),
+    lata(n), lona(n), ha(n);
+  for (int i = 0; i < n; ++i) {
+    lat[i] = -33 + 20 * sin(T(i) / 7);
+    lon[i] = remainder(T(i) * T(7.3), T(360));
+    h[i] = T(i % 5 - 1) * 3000;
+  }
+  lat[0] = -90;
+  int result = 0;
+  lc.ForwardBatch(n, lat.data(), lon.data(), h.data(),
+                  x.data(), y.data(), z.data(), M.data());
+  for (int i = 0; i < n; ++i) {
+    T xa, ya, za;
+    vector<T> Ma(9);
+    lc.Forward(lat[i], lon[i], h[i], xa, ya, za, Ma);
+    result += checkSame(x[i], xa) + checkSame(y[i], ya) +
+      checkSame(z[i], za);
+    for (int j = 0; j < 9; ++j)
+      result += checkSame(M[9 * i + j], Ma[j]);
+  }
+  lc.ReverseBatch(n, x.data(), y.data(), z.data(),
+                  lata.data(), lona.data(), ha.data(), M.data());
+  for (int i = 0; i < n; ++i) {
+    T lat1, lon1, h1;
+    vector<T> Ma(9);
+    lc.Reverse(x[i], y[i], z[i], lat1, lon1, h1, Ma);
+    result += checkSame(lata[i], lat1) + checkSame(lona[i], lon1) +
+      checkSame(ha[i], h1);
+    for (int j = 0; j < 9; ++j)
+      result += checkSame(M[9 * i + j], Ma[j]);
+  }
+  // In place without the rotation matrices
+  lc.ReverseBatch(n, x.data(), y.data(), z.data(),
+                  x.data(), y.data(), z.data());
+  for (int i = 0; i < n; ++i)
+    result += checkSame(x[i], lata[i]) + checkSame(y[i], lona[i]) +
+      checkSame(z[i], ha[i]);
+  return result;
+}
+
+static int testaccumulatorarray() {
+  // Accumulator::Add for an array and Accumulator::merge agree with adding
+  // the values one at a time to within the accuracy of the double-length
+  // sums (the exact sum is given by ExactAccumulator).
+  const int n = 1003;
+  vector<T> x(n);
+  for (int i = 0; i < n; ++i)
+    x[i] = (i % 3 ? 1 : -1) * pow(T(10), T(i % 9 - 4)) * (1 + T(i) / 7);
+  T tol = 0;
+  for (int i = 0; i < n; ++i) tol += fabs(x[i]);
+  tol *= n * Math::sq(numeric_limits<T>::epsilon());
+  ExactAccumulator<T> exact;
+  exact.Add(x.data(), n);
+  Accumulator<T> a, b(T(0.5)), c, d;
+  a.Add(x.data(), n);
+  for (int i = 0; i < n; ++i) { b += x[i]; (i % 2 ? c : d) += x[i]; }
+  c.merge(d);
+  int result = 0;
+  result += checkEquals(a(), exact(), tol) +
+    checkEquals(b() - T(0.5), exact(), tol) +
+    checkEquals(c(), exact(), tol);
+  // Adding to a nonzero sum and merging with itself
+  b.Add(x.data(), n);
+  result += checkEquals(b() - T(0.5), 2 * exact(), 2 * tol);
+  b.merge(b);
+  result += checkEquals(b() - 1, 4 * exact(), 4 * tol);
+  // Fewer values than the number of lanes and cancellation
+  const T y[] = {T(1e20), 1, T(-1e20)};
+  Accumulator<T> e;
+  e.Add(y, 3);
+  result += checkSame(e(), 1);
+  e.Add(y, 0);
+  result += checkSame(e(), 1);
+  return result;
+}
+
+static int testexactarea() {
+  // The area integral evaluated by GeodesicExact::Inverse (with per-thread
+  // scratch space) agrees with the one from GeodesicExact::Direct and gives
+  // the same results when evaluated concurrently.
+  const int n = 200;
+  int result = 0;
+  for (int sgn = -1; sgn <= 1; sgn += 2) {
+    const GeodesicExact g(6.4e6, sgn * T(0.2));
+    vector<T> lat1(n), lon2(n), lat2(n), S12(n), S12t(n);
+    for (int i = 0; i < n; ++i) {
+      lat1[i] = -85 + T(170 * i) / n;
+      lat2[i] = 80 - T(157 * i) / n;
+      lon2[i] = T(359 * i) / n - 179;
+    }
+    auto inverse = [&](int i) -> T {
+      T s12, azi1, azi2, m12, M12, M21, S;
+      g.GenInverse(lat1[i], 0, lat2[i], lon2[i], GeodesicExact::ALL,
+                   s12, azi1, azi2, m12, M12, M21, S);
+      return S;
+    };
+    GeodesicBatchExecutor(4, 1).ForEach
+      (n, [&](size_t i0, size_t i1) -> void {
+        for (size_t i = i0; i < i1; ++i)
+          S12t[i] = inverse(int(i));
+      });
+    for (int i = 0; i < n; ++i) {
+      T s12, azi1, azi2, m12, M12, M21;
+      g.GenInverse(lat1[i], 0, lat2[i], lon2[i], GeodesicExact::ALL,
+                   s12, azi1, azi2, m12, M12, M21, S12[i]);
+      result += checkSame(S12t[i], S12[i]);
+      T lat2a, lon2a, azi2a, s12a, m12a, M12a, M21a, S12a;
+      g.GenDirect(lat1[i], 0, azi1, false, s12, GeodesicExact::ALL,
+                  lat2a, lon2a, azi2a, s12a, m12a, M12a, M21a, S12a);
+      result += checkEquals(S12a, S12[i], 1e-12 * g.EllipsoidArea());
+    }
+  }
+  return result;
+}
+
+static int testellipticagm() {
+  // The complete integrals K and E, which EllipticFunction::Reset obtains
+  // from a single AGM iteration, are the same as RF(k'^2, 1) and
+  // 2 * RG(k'^2, 1).
+  int result = 0;
+  EllipticFunction ell;
+  for (int i = -40; i <= 40; ++i) {
+    T kp2 = i < 0 ? -T(i) / 39 : (i == 0 ? 0 : T(i) * T(1.7)),
+      k2 = 1 - kp2;
+    ell.Reset(k2, 0, kp2, 1);
+    if (kp2 != 0)
+      result += checkSame(ell.K(), EllipticFunction::RF(kp2, 1)) +
+        checkSame(ell.E(), 2 * EllipticFunction::RG(kp2, 1));
+    else
+      result += checkSame(ell.K(), Math::infinity()) +
+        checkSame(ell.E(), T(1));
+  }
+  ell.Reset(Math::NaN(), 0, Math::NaN(), 1);
+  result += checkSame(ell.K(), EllipticFunction::RF(Math::NaN(), 1)) +
+    checkSame(ell.E(), 2 * EllipticFunction::RG(Math::NaN(), 1));
+  return result;
+}
+
+template<class FB, class F, class RB, class R>
+static int projbatchcheck(const vector<T>& lat, const vector<T>& lon,
+                          FB fwdbatch, F fwd, RB revbatch, R rev) {
+  // The batch projections fwdbatch(n, lat, lon, x, y, g, k) and revbatch(n,
+  // x, y, lat, lon, g, k) give the same results as the point projections
+  // fwd(lat, lon, x, y, g, k) and rev(x, y, lat, lon, g, k), with and
+  // without the optional outputs and with the outputs overwriting the
+  // inputs.
+  size_t n = lat.size();
+  vector<T> x(n), y(n), g(n), k(n), lata(n), lona(n);
+  fwdbatch(n, lat.data(), lon.data(), x.data(), y.data(), g.data(),
+           k.data());
+  int result = 0;
+  for (size_t i = 0; i < n; ++i) {
+    T x1, y1, g1, k1;
+    fwd(lat[i], lon[i], x1, y1, g1, k1);
+    result += checkSame(x[i], x1) + checkSame(y[i], y1) +
+      checkSame(g[i], g1) + checkSame(k[i], k1);
+  }
+  revbatch(n, x.data(), y.data(), lata.data(), lona.data(), g.data(),
+           k.data());
+  for (size_t i = 0; i < n; ++i) {
+    T lat1, lon1, g1, k1;
+    rev(x[i], y[i], lat1, lon1, g1, k1);
+    result += checkSame(lata[i], lat1) + checkSame(lona[i], lon1) +
+      checkSame(g[i], g1) + checkSame(k[i], k1);
+  }
+  vector<T> xa(x), ya(y);
+  revbatch(n, xa.data(), ya.data(), xa.data(), ya.data(), nullptr, nullptr);
+  for (size_t i = 0; i < n; ++i)
+    result += checkSame(xa[i], lata[i]) + checkSame(ya[i], lona[i]);
+  xa = lat; ya = lon;
+  fwdbatch(n, xa.data(), ya.data(), xa.data(), ya.data(), nullptr, nullptr);
+  for (size_t i = 0; i < n; ++i)
+    result += checkSame(xa[i], x[i]) + checkSame(ya[i], y[i]);
+  return result;
+}
+
+template<class P>
+static int conicbatchcheck(const P& p, T lon0,
+                           const vector<T>& lat, const vector<T>& lon) {
+  return projbatchcheck
+    (lat, lon,
+     [&p, lon0](size_t n, const T* lat1, const T* lon1, T* x, T* y,
+                T* g, T* k) -> void
+     { p.ForwardBatch(n, lon0, lat1, lon1, x, y, g, k); },
+     [&p, lon0](T lat1, T lon1, T& x, T& y, T& g, T& k) -> void
+     { p.Forward(lon0, lat1, lon1, x, y, g, k); },
+     [&p, lon0](size_t n, const T* x, const T* y, T* lat1, T* lon1,
+                T* g, T* k) -> void
+     { p.ReverseBatch(n, lon0, x, y, lat1, lon1, g, k); },
+     [&p, lon0](T x, T y, T& lat1, T& lon1, T& g, T& k) -> void
+     { p.Reverse(lon0, x, y, lat1, lon1, g, k); });
+}
+
+static int testconicbatch() {
+  // LambertConformalConic and AlbersEqualArea ForwardBatch and ReverseBatch
+  // give the same results as Forward and Reverse.
+  const int n = 200;
+  const T lon0 = -100;
+  vector<T> lat(n), lon(n);
+  for (int i = 0; i < n; ++i) {
+    lat[i] = 90 * sin(T(i) / 7);
+    lon[i] = lon0 + 170 * cos(T(i) / 11);
+  }
+  lat[0] = 90; lat[1] = -90; lon[2] = lon0 + 180;
+  const T a = Constants::WGS84_a(), f = Constants::WGS84_f();
+  const LambertConformalConic lcc(a, f, 33, 45, 1),
+    lcc1(a, f, -40, 1);
+  const AlbersEqualArea aea(a, f, 29.5, 45.5, 1),
+    aea1(a, -f, -20, 1);
+  return conicbatchcheck(lcc, lon0, lat, lon) +
+    conicbatchcheck(lcc1, lon0, lat, lon) +
+    conicbatchcheck(aea, lon0, lat, lon) +
+    conicbatchcheck(aea1, lon0, lat, lon) +
+    conicbatchcheck(LambertConformalConic::Mercator(), lon0, lat, lon) +
+    conicbatchcheck(AlbersEqualArea::AzimuthalEqualAreaNorth(),
+                    lon0, lat, lon);
+}
+
+static int testpolarbatch() {
+  // Math::taupfBatch and taufBatch give the same results as taupf and tauf
+  // and PolarStereographic::ForwardBatch and ReverseBatch give the same
+  // results as Forward and Reverse (for more points than are processed
+  // together).
+  const int n = 150;
+  const T es = sqrt(Constants::WGS84_f() * (2 - Constants::WGS84_f()));
+  vector<T> tau(n), taup(n), taua(n);
+  for (int i = 0; i < n; ++i)
+    tau[i] = T(i - 75) * T(i - 75) * T(i - 75) / 1000;
+  tau[0] = Math::infinity(); tau[1] = -Math::infinity(); tau[2] = 0;
+  int result = 0;
+  for (int sgn = -1; sgn <= 1; sgn += 2) {
+    Math::taupfBatch(n, tau.data(), sgn * es, taup.data());
+    Math::taufBatch(n, taup.data(), sgn * es, taua.data());
+    for (int i = 0; i < n; ++i)
+      result += checkSame(taup[i], Math::taupf(tau[i], sgn * es)) +
+        checkSame(taua[i], Math::tauf(taup[i], sgn * es));
+    taua = tau;
+    Math::taupfBatch(n, taua.data(), sgn * es, taua.data());
+    for (int i = 0; i < n; ++i)
+      result += checkSame(taua[i], taup[i]);
+  }
+  const PolarStereographic& ups = PolarStereographic::UPS();
+  vector<T> lat(n), lon(n);
+  for (int i = 0; i < n; ++i) {
+    lat[i] = 90 - T(i) * T(0.3);
+    lon[i] = remainder(T(i) * T(7.3), T(360));
+  }
+  for (int northp = 1; northp >= 0; --northp) {
+    const bool np = northp != 0;
+    if (!np)
+      for (int i = 0; i < n; ++i) lat[i] = -lat[i];
+    result += projbatchcheck
+      (lat, lon,
+       [&ups, np](size_t m, const T* lat1, const T* lon1, T* x, T* y,
+                  T* g, T* k) -> void
+       { ups.ForwardBatch(m, np, lat1, lon1, x, y, g, k); },
+       [&ups, np](T lat1, T lon1, T& x, T& y, T& g, T& k) -> void
+       { ups.Forward(np, lat1, lon1, x, y, g, k); },
+       [&ups, np](size_t m, const T* x, const T* y, T* lat1, T* lon1,
+                  T* g, T* k) -> void
+       { ups.ReverseBatch(m, np, x, y, lat1, lon1, g, k); },
+       [&ups, np](T x, T y, T& lat1, T& lon1, T& g, T& k) -> void
+       { ups.Reverse(np, x, y, lat1, lon1, g, k); });
+  }
+  return result;
+}
+
+template<class P>
+static int azimuthalbatchcheck(const P& p, T lat0, T lon0,
+                               const vector<T>& lat, const vector<T>& lon) {
+  return projbatchcheck
+    (lat, lon,
+     [&p, lat0, lon0](size_t n, const T* lat1, const T* lon1, T* x, T* y,
+                      T* azi, T* rk) -> void
+     { p.ForwardBatch(n, lat0, lon0, lat1, lon1, x, y, azi, rk); },
+     [&p, lat0, lon0](T lat1, T lon1, T& x, T& y, T& azi, T& rk) -> void
+     { p.Forward(lat0, lon0, lat1, lon1, x, y, azi, rk); },
+     [&p, lat0, lon0](size_t n, const T* x, const T* y, T* lat1, T* lon1,
+                      T* azi, T* rk) -> void
+     { p.ReverseBatch(n, lat0, lon0, x, y, lat1, lon1, azi, rk); },
+     [&p, lat0, lon0](T x, T y, T& lat1, T& lon1, T& azi, T& rk) -> void
+     { p.Reverse(lat0, lon0, x, y, lat1, lon1, azi, rk); });
+}
+
+static int testazimuthalbatch() {
+  // AzimuthalEquidistant, CassiniSoldner, and Gnomonic ForwardBatch and
+  // ReverseBatch give the same results as Forward and Reverse; this
+  // includes CassiniSoldner::ReverseBatch applied to the rows of a raster
+  // (which share the point on the central meridian).
+  const int n = 120;
+  const T lat0 = 40, lon0 = -75;
+  vector<T> lat(n), lon(n);
+  for (int i = 0; i < n; ++i) {
+    lat[i] = 89 * sin(T(i) / 7);
+    lon[i] = lon0 + 150 * cos(T(i) / 11);
+  }
+  lat[0] = lat0; lon[0] = lon0; lat[1] = -lat0; lon[1] = lon0 + 180;
+  const Geodesic& geod = Geodesic::WGS84();
+  const AzimuthalEquidistant azeq(geod);
+  const Gnomonic gnom(geod);
+  int result = azimuthalbatchcheck(azeq, lat0, lon0, lat, lon) +
+    azimuthalbatchcheck(gnom, lat0, lon0, lat, lon);
+  const CassiniSoldner cass(lat0, lon0, geod);
+  result += projbatchcheck
+    (lat, lon,
+     [&cass](size_t m, const T* lat1, const T* lon1, T* x, T* y,
+             T* azi, T* rk) -> void
+     { cass.ForwardBatch(m, lat1, lon1, x, y, azi, rk); },
+     [&cass](T lat1, T lon1, T& x, T& y, T& azi, T& rk) -> void
+     { cass.Forward(lat1, lon1, x, y, azi, rk); },
+     [&cass](size_t m, const T* x, const T* y, T* lat1, T* lon1,
+             T* azi, T* rk) -> void
+     { cass.ReverseBatch(m, x, y, lat1, lon1, azi, rk); },
+     [&cass](T x, T y, T& lat1, T& lon1, T& azi, T& rk) -> void
+     { cass.Reverse(x, y, lat1, lon1, azi, rk); });
+  const int nx = 13, ny = 7;
+  vector<T> x(nx * ny), y(nx * ny), lata(nx * ny), lona(nx * ny),
+    azi(nx * ny), rk(nx * ny);
+  for (int j = 0; j < ny; ++j)
+    for (int i = 0; i < nx; ++i) {
+      x[j * nx + i] = T(i - nx/2) * 150000;
+      y[j * nx + i] = T(j - ny/2) * 400000;
+    }
+  cass.ReverseBatch(nx * ny, x.data(), y.data(), lata.data(), lona.data(),
+                    azi.data(), rk.data());
+  for (int i = 0; i < nx * ny; ++i) {
+    T lat1, lon1, azi1, rk1;
+    cass.Reverse(x[i], y[i], lat1, lon1, azi1, rk1);
+    result += checkSame(lata[i], lat1) + checkSame(lona[i], lon1) +
+      checkSame(azi[i], azi1) + checkSame(rk[i], rk1);
+  }
+  return result;
+}
+
+static int testtaufprolate() {
+  // Math::tauf inverts Math::taupf and PolarStereographic::Reverse inverts
+  // Forward for oblate and prolate ellipsoids (tauf used to get e^2 wrong
+  // for f < 0).
+  int result = 0;
+  const T fs[] = {1/T(298.257223563), -1/T(150), -1/T(10)};
+  for (T f : fs) {
+    T e2 = f * (2 - f), es = (f < 0 ? -1 : 1) * sqrt(fabs(e2));
+    for (int i = -88; i <= 88; i += 4) {
+      T tau = Math::tand(T(i) + T(0.3));
+      result += checkEquals(Math::tauf(Math::taupf(tau, es), es), tau,
+                            16 * numeric_limits<T>::epsilon() *
+                            fmax(T(1), fabs(tau)));
+    }
+    PolarStereographic ps(Constants::WGS84_a(), f, Constants::UPS_k0());
+    for (int i = 10; i <= 88; i += 6) {
+      T lat = T(i) + T(0.3), lon = T(i) * 3 - 120, x, y, lat1, lon1;
+      ps.Forward(true, lat, lon, x, y);
+      ps.Reverse(true, x, y, lat1, lon1);
+      result += checkEquals(lat1, lat, T(1e-12)) +
+        checkEquals(lon1, lon, T(1e-12));
+    }
+  }
+  return result;
+}
+
+static int testexecutorproject() {
+  // GeodesicBatchExecutor::Forward and Reverse with TransverseMercator
+  const int n = 50 * ncases;
+  vector<T> lat(n), lon(n), x(n), y(n), k(n), lat2(n), lon2(n);
+  for (int i = 0; i < n; ++i) {
+    lat[i] = testcases[i % ncases][0];
+    lon[i] = remainder(testcases[i % ncases][1], T(40));
+  }
+  const TransverseMercator& tm = TransverseMercator::UTM();
+  GeodesicBatchExecutor exec(3, 7);
+  exec.Forward(tm, n, 3, lat.data(), lon.data(), x.data(), y.data(),
+               nullptr, k.data());
+  exec.Reverse(tm, n, 3, x.data(), y.data(), lat2.data(), lon2.data());
+  int result = 0;
+  for (int i = 0; i < n; ++i) {
+    T xa, ya, gamma, ka, lata, lona;
+    tm.Forward(3, lat[i], lon[i], xa, ya, gamma, ka);
+    tm.Reverse(3, xa, ya, lata, lona);
+    int j = checkSame(x[i], xa) + checkSame(y[i], ya) + checkSame(k[i], ka) +
+      checkSame(lat2[i], lata) + checkSame(lon2[i], lona);
+    if (j) cout << "testexecutorproject failure: case " << i << "\n";
+    result += j;
+  }
+  return result;
+}
+
+static int testrhumbbatch() {
+  // Rhumb::InverseBatch, Rhumb::DirectBatch, and RhumbLine::PositionBatch
+  // must match the scalar calls.
+  T lat1[ncases], lon1[ncases], lat2[ncases], lon2[ncases],
+    s12[ncases], azi12[ncases], S12[ncases];
+  T lat2a, lon2a, s12a, azi12a, S12a;
+  const Rhumb& r = Rhumb::WGS84();
+  for (int i = 0; i < ncases; ++i) {
+    lat1[i] = testcases[i][0]; lon1[i] = testcases[i][1];
+    lat2[i] = testcases[i][3]; lon2[i] = testcases[i][4];
+  }
+  r.InverseBatch(ncases, lat1, lon1, lat2, lon2, Rhumb::ALL,
+                 s12, azi12, S12);
+  int result = 0;
+  for (int i = 0; i < ncases; ++i) {
+    r.GenInverse(lat1[i], lon1[i], lat2[i], lon2[i], Rhumb::ALL,
+                 s12a, azi12a, S12a);
+    int k = checkSame(s12[i], s12a) + checkSame(azi12[i], azi12a) +
+      checkSame(S12[i], S12a);
+    if (k) cout << "testrhumbbatch inverse failure: case " << i << "\n";
+    result += k;
+  }
+  const unsigned outmask = Rhumb::ALL | Rhumb::LONG_UNROLL;
+  r.DirectBatch(ncases, lat1, lon1, azi12, s12, outmask, lat2, lon2, S12);
+  for (int i = 0; i < ncases; ++i) {
+    r.GenDirect(lat1[i], lon1[i], azi12[i], s12[i], outmask,
+                lat2a, lon2a, S12a);
+    int k = checkSame(lat2[i], lat2a) + checkSame(lon2[i], lon2a) +
+      checkSame(S12[i], S12a);
+    if (k) cout << "testrhumbbatch direct failure: case " << i << "\n";
+    result += k;
+  }
+  // Points along a single rhumb line
+  RhumbLine l = r.Line(lat1[0], lon1[0], azi12[0]);
+  l.PositionBatch(ncases, s12, outmask, lat2, lon2, nullptr);
+  for (int i = 0; i < ncases; ++i) {
+    l.GenPosition(s12[i], outmask, lat2a, lon2a, S12a);
+    int k = checkSame(lat2[i], lat2a) + checkSame(lon2[i], lon2a);
+    if (k) cout << "testrhumbbatch line failure: case " << i << "\n";
+    result += k;
+  }
+  return result;
+}
+
+static int testellipticbatch() {
+  // The EllipticFunction batch functions must match the scalar calls.
+  const int n = 21;
+  T x[n], y[n], z[n], p[n], r[n];
+  for (int i = 0; i < n; ++i) {
+    x[i] = T(i) / 4; y[i] = 1 + T(i * i) / 7; z[i] = T(3) / (i + 1);
+    p[i] = 1 + T(i % 5);
+  }
+  int result = 0;
+  EllipticFunction::RFBatch(n, x, y, z, r);
+  for (int i = 0; i < n; ++i)
+    result += checkSame(r[i], EllipticFunction::RF(x[i], y[i], z[i]));
+  EllipticFunction::RDBatch(n, x, y, z, r);
+  for (int i = 0; i < n; ++i)
+    result += checkSame(r[i], EllipticFunction::RD(x[i], y[i], z[i]));
+  EllipticFunction::RJBatch(n, x, y, z, p, r);
+  for (int i = 0; i < n; ++i)
+    result += checkSame(r[i], EllipticFunction::RJ(x[i], y[i], z[i], p[i]));
+  const T k2s[] = {T(0.3), -2, 1};
+  for (int l = 0; l < 3; ++l) {
+    EllipticFunction ell(k2s[l]);
+    T sn[n], cn[n], dn[n], sna, cna, dna;
+    for (int i = 0; i < n; ++i) x[i] = (i - 10) * T(0.37);
+    x[10] = 0;
+    ell.sncndnBatch(n, x, sn, cn, dn);
+    for (int i = 0; i < n; ++i) {
+      ell.sncndn(x[i], sna, cna, dna);
+      result += checkSame(sn[i], sna) + checkSame(cn[i], cna) +
+        checkSame(dn[i], dna);
+    }
+  }
+  return result;
+}
+
+static int testelliptictabulate() {
+  // EllipticFunction::Tabulate must give the same results as the direct
+  // evaluation to within roundoff.
+  const T k2s[] = {T(0.1), T(0.7), -3, T(0.006694)};
+  int result = 0;
+  for (int l = 0; l < 4; ++l) {
+    EllipticFunction ell(k2s[l]), ellt(k2s[l]);
+    ellt.Tabulate();
+    for (int i = -40; i <= 40; ++i) {
+      T phi = i * T(0.1), x = i * T(0.13);
+      result += checkEquals(ellt.F(phi), ell.F(phi), 1e-13) +
+        checkEquals(ellt.E(phi), ell.E(phi), 1e-13) +
+        checkEquals(ellt.Einv(x), ell.Einv(x), 1e-13);
+    }
+  }
+  if (result) cout << "testelliptictabulate failure\n";
+  return result;
+}
+
+static int testdstbatch() {
+  // The non-allocating and batched DST transforms must give exactly the same
+  // results as the allocating single-function versions.
+  const int N = 24, M = 3;
+  DST fft(N);
+  auto f = [](int m, T x) -> T {
+    return sin(x) / (1 + (m + 1) * T(0.3) * Math::sq(cos(x)));
+  };
+  vector<T> scratch(fft.scratchsize(M)), F(2 * N), G(2 * N), B(M * N);
+  fft.transform(M, [&f](T x, T y[]) -> void {
+      for (int m = 0; m < M; ++m) y[m] = f(m, x);
+    }, B.data(), scratch.data());
+  int result = 0;
+  for (int m = 0; m < M; ++m) {
+    auto fm = [&f, m](T x) -> T { return f(m, x); };
+    fft.transform(fm, F.data());
+    fft.transform(fm, G.data(), scratch.data());
+    for (int j = 0; j < N; ++j)
+      result += checkSame(G[j], F[j]) + checkSame(B[m * N + j], F[j]);
+    fft.refine(fm, F.data());
+    fft.refine(fm, G.data(), scratch.data());
+    for (int j = 0; j < 2 * N; ++j)
+      result += checkSame(G[j], F[j]);
+  }
+  return result;
+}
+
+static int testdstsizes() {
+  // The recursive transforms agree with the direct summation of the DST-III
+  // for even sizes, odd sizes, and sizes with both even and odd factors; the
+  // refined transform agrees with the transform of twice the size.
+  const int Ns[] = {1, 2, 3, 5, 8, 12, 25, 48};
+  auto f = [](T x) -> T {
+    return sin(x) / (1 + T(0.3) * Math::sq(cos(x))) + sin(7 * x) / 10;
+  };
+  int result = 0;
+  for (int N : Ns) {
+    DST fft(N), fft2(2 * N);
+    vector<T> F(2 * N), G(2 * N);
+    fft.transform(f, F.data());
+    for (int l = 0; l < N; ++l) {
+      T t = 0;
+      for (int j = 1; j <= N; ++j) {
+        T s = j * Math::pi() / (2 * N);
+        t += (j == N ? T(0.5) : 1) * f(s) * sin((2 * l + 1) * s);
+      }
+      result += checkEquals(F[l], 2 * t / N, T(1e-14));
+    }
+    // A reset object shares the cached plan and gives identical results
+    DST fft1;
+    fft1.reset(N);
+    fft1.transform(f, G.data());
+    for (int l = 0; l < N; ++l)
+      result += checkSame(G[l], F[l]);
+    fft.refine(f, F.data());
+    fft2.transform(f, G.data());
+    for (int l = 0; l < 2 * N; ++l)
+      result += checkEquals(F[l], G[l], T(1e-14));
+  }
+  return result;
+}
+
+static int testrhumbflat() {
+  // Exact rhumb lines with large flattenings, oblate and prolate.  Meridian
+  // distances are checked against Ellipsoid; other lines check that Direct
+  // inverts Inverse.
+  const T fs[] = {T(0.5), T(0.7), -T(0.5), -T(1)};
+  const T lats[][2] = {{0, 85}, {-30, 60}, {10, 89}, {-80, -20}};
+  int result = 0;
+  for (int j = 0; j < 4; ++j) {
+    Rhumb r(1, fs[j], true);
+    Ellipsoid e(1, fs[j]);
+    for (int i = 0; i < 4; ++i) {
+      T lat1 = lats[i][0], lat2 = lats[i][1], s12, azi12, lat2a, lon2a;
+      r.Inverse(lat1, 0, lat2, 0, s12, azi12);
+      int k = checkEquals(s12, e.MeridianDistance(lat2) -
+                          e.MeridianDistance(lat1), 1e-14);
+      r.Inverse(lat1, 0, lat2, 50, s12, azi12);
+      r.Direct(lat1, 0, azi12, s12, lat2a, lon2a);
+      k += checkEquals(lat2a, lat2, 1e-11) + checkEquals(lon2a, 50, 1e-11);
+      if (k) cout << "testrhumbflat failure: f = " << fs[j]
+                  << " case " << i << "\n";
+      result += k;
+    }
+  }
+  return result;
+}
+
+static int testauxlatitude() {
+  // For WGS84 the series and exact conversions between all pairs of
+  // auxiliary latitudes agree; the batch conversion matches the scalar one.
+  AuxLatitude aux(Constants::WGS84_f());
+  const int n = 19;
+  T zeta[n], eta[n], etas[n];
+  for (int i = 0; i < n; ++i) zeta[i] = -90 + 10 * i - (i > 0 && i < n-1);
+  int result = 0;
+  for (int auxin = 0; auxin < AuxLatitude::AUXNUMBER; ++auxin)
+    for (int auxout = 0; auxout < AuxLatitude::AUXNUMBER; ++auxout) {
+      aux.Convert(auxin, auxout, n, zeta, eta);
+      aux.Convert(auxin, auxout, n, zeta, etas, true);
+      int k = 0;
+      for (int i = 0; i < n; ++i) {
+        AuxAngle z = AuxAngle::degrees(zeta[i]);
+        k += checkSame(eta[i], aux.Convert(auxin, auxout, z).degrees()) +
+          checkSame(etas[i], aux.Convert(auxin, auxout, z, true).degrees()) +
+          checkEquals(etas[i], eta[i], 1e-13);
+      }
+      if (k) cout << "testauxlatitude failure: " << auxin << " -> "
+                  << auxout << "\n";
+      result += k;
+    }
+  return result;
+}
+
+static int testellipsoidbatch() {
+  // Ellipsoid batch latitude conversions; the rectifying latitude and
+  // meridian distance use tabulated elliptic integrals for long arrays.
+  int result = 0;
+  const T fs[] = {1/T(298.257223563), T(0.3), -T(0.5)};
+  for (int j = 0; j < 3; ++j) {
+    Ellipsoid e(6.4e6, fs[j]);
+    for (int n : {10, 1000}) {
+      vector<T> phi(n), eta(n), phi2(n), s(n);
+      for (int i = 0; i < n; ++i) phi[i] = -90 + 180 * T(i) / (n - 1);
+      for (int type = Ellipsoid::PARAMETRIC; type <= Ellipsoid::ISOMETRIC;
+           ++type) {
+        // The isometric latitude is infinite at the poles
+        int i0 = type == Ellipsoid::ISOMETRIC ? 1 : 0;
+        e.LatitudeBatch(type, n - 2*i0, phi.data() + i0, eta.data());
+        e.InverseLatitudeBatch(type, n - 2*i0, eta.data(), phi2.data());
+        int k = 0;
+        for (int i = i0; i < n - i0; ++i) {
+          T x, y;
+          switch (type) {
+          case Ellipsoid::PARAMETRIC: x = e.ParametricLatitude(phi[i]); break;
+          case Ellipsoid::GEOCENTRIC: x = e.GeocentricLatitude(phi[i]); break;
+          case Ellipsoid::RECTIFYING: x = e.RectifyingLatitude(phi[i]); break;
+          case Ellipsoid::AUTHALIC:   x = e.AuthalicLatitude(phi[i]);   break;
+          case Ellipsoid::CONFORMAL:  x = e.ConformalLatitude(phi[i]);  break;
+          default:                    x = e.IsometricLatitude(phi[i]);  break;
+          }
+          if (type == Ellipsoid::RECTIFYING && n > 256)
+            k += checkEquals(eta[i - i0], x, 1e-12);
+          else
+            k += checkSame(eta[i - i0], x);
+          y = phi2[i - i0];
+          k += checkEquals(y, phi[i], 1e-12);
+        }
+        if (k) cout << "testellipsoidbatch failure: f = " << fs[j]
+                    << " n = " << n << " type = " << type << "\n";
+        result += k;
+      }
+      e.MeridianDistanceBatch(n, phi.data(), s.data());
+      for (int i = 0; i < n; ++i)
+        result += checkEquals(s[i], e.MeridianDistance(phi[i]), 1e-7);
+    }
+  }
+  return result;
+}
+
+static void triaxialode(const T ax[], T s, int n, T r[], T v[]) {
+  // Integrate the geodesic equations for a triaxial ellipsoid in cartesian
+  // coordinates with RK4; the acceleration is normal to the surface.
+  auto acc = [ax](const T x[], const T u[], T y[]) -> void {
+    T num = 0, den = 0;
+    for (int i = 0; i < 3; ++i) {
+      num += 2 * Math::sq(u[i] / ax[i]);
+      den += 4 * Math::sq(x[i] / Math::sq(ax[i]));
+    }
+    for (int i = 0; i < 3; ++i)
+      y[i] = -num / den * 2 * x[i] / Math::sq(ax[i]);
+  };
+  T h = s / n;
+  for (int k = 0; k < n; ++k) {
+    T kr[4][3], kv[4][3], x[3], u[3];
+    for (int j = 0; j < 4; ++j) {
+      T c = j == 0 ? 0 : (j == 3 ? h : h / 2);
+      for (int i = 0; i < 3; ++i) {
+        x[i] = r[i] + (j ? c * kr[j-1][i] : 0);
+        u[i] = v[i] + (j ? c * kv[j-1][i] : 0);
+        kr[j][i] = u[i];
+      }
+      acc(x, u, kv[j]);
+    }
+    for (int i = 0; i < 3; ++i) {
+      r[i] += h / 6 * (kr[0][i] + 2 * kr[1][i] + 2 * kr[2][i] + kr[3][i]);
+      v[i] += h / 6 * (kv[0][i] + 2 * kv[1][i] + 2 * kv[2][i] + kv[3][i]);
+    }
+  }
+}
+
+static int testtriaxial() {
+  // TriaxialGeodesic::Direct is checked against integrating the geodesic
+  // equations in cartesian coordinates; Inverse must invert Direct; the batch
+  // versions must match the scalar ones.
+  const T ax[] = {3, 2, 1};
+  TriaxialGeodesic t(ax[0], ax[1], ax[2]);
+  // bet1, omg1, alp1, s12; gamma > 0, < 0, near umbilical, long
+  const T cases[][4] = {{10, 20, 30, 2}, {60, 10, 5, T(1.5)},
+                        {89, 1, 10, 8}, {-30, 120, 170, 20}};
+  const int ncase = 4;
+  int result = 0;
+  T bet2[ncase], omg2[ncase], alp2[ncase];
+  for (int i = 0; i < ncase; ++i) {
+    T bet1 = cases[i][0], omg1 = cases[i][1], alp1 = cases[i][2],
+      s12 = cases[i][3];
+    t.Direct(bet1, omg1, alp1, s12, bet2[i], omg2[i], alp2[i]);
+    // The initial velocity from the unit tangent in cartesian coordinates
+    T r[3], v[3], rp[3], rm[3], b, o, a, h = T(1)/1024;
+    t.ToCartesian(bet1, omg1, r[0], r[1], r[2]);
+    t.Direct(bet1, omg1, alp1, h, b, o, a);
+    t.ToCartesian(b, o, rp[0], rp[1], rp[2]);
+    t.Direct(bet1, omg1, alp1, -h, b, o, a);
+    t.ToCartesian(b, o, rm[0], rm[1], rm[2]);
+    // Fourth-order central difference for the tangent
+    T rp2[3], rm2[3];
+    t.Direct(bet1, omg1, alp1, 2 * h, b, o, a);
+    t.ToCartesian(b, o, rp2[0], rp2[1], rp2[2]);
+    t.Direct(bet1, omg1, alp1, -2 * h, b, o, a);
+    t.ToCartesian(b, o, rm2[0], rm2[1], rm2[2]);
+    for (int k = 0; k < 3; ++k)
+      v[k] = (8 * (rp[k] - rm[k]) - (rp2[k] - rm2[k])) / (12 * h);
+    triaxialode(ax, s12, 20000, r, v);
+    T X, Y, Z;
+    t.ToCartesian(bet2[i], omg2[i], X, Y, Z);
+    int k = checkEquals(X, r[0], 1e-8) + checkEquals(Y, r[1], 1e-8) +
+      checkEquals(Z, r[2], 1e-8);
+    // Round trip through cartesian coordinates
+    T bet, omg;
+    t.FromCartesian(X, Y, Z, bet, omg);
+    k += checkEquals(bet, bet2[i], 1e-10) + checkEquals(omg, omg2[i], 1e-10);
+    // The inverse problem; the geodesic may be shorter than s12 for the
+    // longer cases
+    T s, a1, a2;
+    t.Inverse(bet1, omg1, bet2[i], omg2[i], s, a1, a2);
+    if (s12 < Math::pi() * ax[1] * ax[2] / ax[0])
+      k += checkEquals(s, s12, 1e-12);
+    else
+      k += s > s12 + 1e-12;
+    t.Direct(bet1, omg1, a1, s, b, o, a);
+    t.ToCartesian(b, o, rp[0], rp[1], rp[2]);
+    k += checkEquals(rp[0], X, 1e-12) + checkEquals(rp[1], Y, 1e-12) +
+      checkEquals(rp[2], Z, 1e-12);
+    if (k) cout << "testtriaxial failure: case " << i << "\n";
+    result += k;
+  }
+  {
+    T bet1[ncase], omg1[ncase], alp1[ncase], s12[ncase],
+      bet2b[ncase], omg2b[ncase], alp2b[ncase], s12b[ncase];
+    for (int i = 0; i < ncase; ++i) {
+      bet1[i] = cases[i][0]; omg1[i] = cases[i][1];
+      alp1[i] = cases[i][2]; s12[i] = cases[i][3];
+    }
+    t.DirectBatch(ncase, bet1, omg1, alp1, s12, bet2b, omg2b, alp2b);
+    for (int i = 0; i < ncase; ++i)
+      result += checkSame(bet2b[i], bet2[i]) + checkSame(omg2b[i], omg2[i]) +
+        checkSame(alp2b[i], alp2[i]);
+    // Just the short cases for the inverse
+    t.InverseBatch(2, bet1, omg1, bet2, omg2, s12b, alp1, alp2b);
+    for (int i = 0; i < 2; ++i) {
+      T s, a1, a2;
+      t.Inverse(bet1[i], omg1[i], bet2[i], omg2[i], s, a1, a2);
+      result += checkSame(s12b[i], s) + checkSame(alp1[i], a1) +
+        checkSame(alp2b[i], a2);
+    }
+  }
+  return result;
+}
+
+static int testinversefast() {
+  // The fast tier of Geodesic::Inverse is accurate to about 7 mm.
+  const Geodesic& g0 = Geodesic::WGS84();
+  Geodesic g(g0.EquatorialRadius(), g0.Flattening(), true);
+  int result = 0;
+  for (int i = 0; i < ncases; ++i) {
+    T s12, azi1, azi2, m12;
+    g.Inverse(testcases[i][0], testcases[i][1],
+              testcases[i][3], testcases[i][4], s12, azi1, azi2, m12);
+    int k = 0;
+    k += checkEquals(azi1, testcases[i][2], T(2e-5));
+    k += checkEquals(azi2, testcases[i][5], T(2e-5));
+    k += checkEquals(s12, testcases[i][6], T(0.01));
+    k += checkEquals(m12, testcases[i][8], T(0.01));
+    if (k) cout << "testinversefast failure: case " << i << "\n";
+    result += k;
+  }
+  // Short lines: compare with the full precision solution
+  for (int i = 0; i < 100; ++i) {
+    T lat1 = 89 * sin(T(i) * T(0.9)), lon1 = T(i),
+      lat2, lon2, s12, s12a, azi1, azi1a, azi2, azi2a;
+    g0.Direct(lat1, lon1, remainder(T(i) * T(71.3), T(360)), 1e3 * (i + 1),
+              lat2, lon2);
+    g0.Inverse(lat1, lon1, lat2, lon2, s12, azi1, azi2);
+    g.Inverse(lat1, lon1, lat2, lon2, s12a, azi1a, azi2a);
+    result += checkEquals(s12a, s12, T(0.01));
+    result += checkEquals(azi1a, azi1, T(2e-5));
+    result += checkEquals(azi2a, azi2, T(2e-5));
+  }
+  return result;
+}
+
+static int testboundingbox() {
+  // GeodesicLine::BoundingBox must enclose sampled points on the geodesic
+  // and be attained by them; BoundingCap must enclose them.
+  const Geodesic& g = Geodesic::WGS84();
+  int result = 0;
+  for (int i = 0; i < 40; ++i) {
+    T lat1 = 89 * sin(T(i) * T(0.9)), lon1 = 179 * sin(T(i) * T(2.3)),
+      azi1 = remainder(T(i) * T(71.3), T(360)),
+      s1 = (i % 5 - 2) * T(3e6), s2 = s1 + (1 + i % 7) * T(2e6);
+    GeodesicLine l = g.Line(lat1, lon1, azi1);
+    T latmin, latmax, lonmin, lonmax, lat0, lon0, r;
+    l.BoundingBox(s2, s1, latmin, latmax, lonmin, lonmax);
+    l.BoundingCap(s1, s2, lat0, lon0, r);
+    T latlo = 90, lathi = -90, dlon = 0;
+    const int n = 2000;
+    for (int j = 0; j <= n; ++j) {
+      T lat, lon, s12;
+      l.Position(s1 + (s2 - s1) * j / n, lat, lon);
+      latlo = fmin(latlo, lat); lathi = fmax(lathi, lat);
+      dlon = fmax(dlon, Math::AngNormalize(lon - lonmin));
+      g.Inverse(lat0, lon0, lat, lon, s12);
+      if (s12 > r * (1 + T(1e-12))) ++result;
+    }
+    // The sampling misses the extremes by up to 0.003 degrees near a pole
+    result += checkEquals(latlo, latmin, T(0.01));
+    result += checkEquals(lathi, latmax, T(0.01));
+    if (latlo < latmin || lathi > latmax) ++result;
+    if (lonmax - lonmin < Math::td) {
+      result += checkEquals(dlon, lonmax - lonmin, T(1e-9));
+      if (dlon > lonmax - lonmin + T(1e-12)) ++result;
+    }
+  }
+  return result;
+}
+
+static int testintersect() {
+  // Intersect::Segment must find a point common to both segments and
+  // Intersect::AllSegments must agree with a brute force search.
+  const Geodesic& g = Geodesic::WGS84();
+  Intersect inter(g);
+  int result = 0;
+  const int n = 60;
+  vector<T> lat1(n), lon1(n), lat2(n), lon2(n);
+  for (int i = 0; i < n; ++i) {
+    lat1[i] = 40 + 10 * sin(T(i) * T(0.7));
+    lon1[i] = 10 * sin(T(i) * T(1.9));
+    g.Direct(lat1[i], lon1[i], remainder(T(i) * T(97.3), T(360)),
+             100e3 + 4e3 * i, lat2[i], lon2[i]);
+  }
+  vector<Intersect::Crossing> brute, crossings;
+  for (int i = 0; i < n; ++i)
+    for (int j = 0; j < n; ++j) {
+      int segmode, c;
+      Intersect::Point p =
+        inter.Segment(lat1[i], lon1[i], lat2[i], lon2[i],
+                      lat1[j], lon1[j], lat2[j], lon2[j], segmode, &c);
+      if (segmode != 0) continue;
+      Intersect::Crossing x = { size_t(i), size_t(j), p.first, p.second, c };
+      brute.push_back(x);
+      if (i == j) {
+        result += checkEquals(T(c), T(1), 0);
+        continue;
+      }
+      T latx, lonx, laty, lony, s12;
+      g.InverseLine(lat1[i], lon1[i], lat2[i], lon2[i]).
+        Position(p.first, latx, lonx);
+      g.InverseLine(lat1[j], lon1[j], lat2[j], lon2[j]).
+        Position(p.second, laty, lony);
+      g.Inverse(latx, lonx, laty, lony, s12);
+      result += checkEquals(s12, 0, T(1e-6));
+    }
+  inter.AllSegments(n, lat1.data(), lon1.data(), lat2.data(), lon2.data(),
+                    n, lat1.data(), lon1.data(), lat2.data(), lon2.data(),
+                    crossings, 3);
+  if (crossings.size() != brute.size() || brute.size() <= size_t(n))
+    ++result;
+  else
+    for (size_t k = 0; k < brute.size(); ++k) {
+      result += checkEquals(T(crossings[k].i), T(brute[k].i), 0);
+      result += checkEquals(T(crossings[k].j), T(brute[k].j), 0);
+      result += checkSame(crossings[k].x, brute[k].x);
+      result += checkSame(crossings[k].y, brute[k].y);
+    }
+  {
+    // Overlapping segments on the same geodesic
+    GeodesicLine l = g.InverseLine(10, 10, 20, 20);
+    T lata, lona, latb, lonb;
+    l.Position(300e3, lata, lona);
+    l.Position(900e3, latb, lonb);
+    int segmode, c;
+    Intersect::Point p =
+      inter.Segment(10, 10, 20, 20, latb, lonb, lata, lona, segmode, &c);
+    result += checkEquals(T(segmode), 0, 0);
+    result += checkEquals(T(c), -1, 0);
+    result += checkEquals(p.first, 600e3, T(1e-6));
+    result += checkEquals(p.second, 300e3, T(1e-6));
+  }
+  return result;
+}
+
+static int testclosestpoint() {
+  // ClosestPoint::Segment must agree with a dense sampling of the segment
+  // and ClosestPoint::Polyline must agree with a brute force search.
+  const Geodesic& g = Geodesic::WGS84();
+  ClosestPoint cp(g);
+  int result = 0;
+  const size_t nref = 20001;
+  vector<T> latr(nref), lonr(nref);
+  const T segs[][4] = {
+    {40, 10, 44, 16}, {-30, 170, -25, -175}, {0, 0, 1, 0.5}
+  };
+  const T pts[][2] = {
+    {43, 12}, {39, 9}, {45, 20}, {-28, -179}, {-20, 180}, {0.6, 0.1},
+    {2, -1}
+  };
+  for (int i = 0; i < 3; ++i) {
+    GeodesicLine l = g.InverseLine(segs[i][0], segs[i][1],
+                                   segs[i][2], segs[i][3],
+                                   ClosestPoint::LineCaps());
+    l.Waypoints(nref, false, Geodesic::LATITUDE | Geodesic::LONGITUDE,
+                nullptr, latr.data(), lonr.data(), nullptr,
+                nullptr, nullptr, nullptr, nullptr, nullptr);
+    for (int j = 0; j < 7; ++j) {
+      T x, d = cp.Segment(pts[j][0], pts[j][1], segs[i][0], segs[i][1],
+                          segs[i][2], segs[i][3], x), dref = Math::infinity();
+      for (size_t k = 0; k < nref; ++k) {
+        T s12;
+        g.Inverse(pts[j][0], pts[j][1], latr[k], lonr[k], s12);
+        dref = fmin(dref, s12);
+      }
+      int k = 0;
+      k += checkEquals(d, dref - T(0.01), T(0.01) + T(1e-6));
+      if (x > 0 && x < l.Distance()) {
+        // The geodesic to the closest point meets the segment at right
+        // angles
+        T lat, lon, azi, s12, azi1, azi2;
+        l.Position(x, lat, lon, azi);
+        g.Inverse(lat, lon, pts[j][0], pts[j][1], s12, azi1, azi2);
+        k += checkEquals(fabs(Math::AngDiff(azi, azi1)), 90, T(1e-8));
+      }
+      if (k) cout << "testclosestpoint failure: segment " << i
+                  << " point " << j << "\n";
+      result += k;
+    }
+    // A point on the segment
+    T lat, lon, x;
+    l.Position(l.Distance() / 3, lat, lon);
+    result += checkEquals(cp.Segment(lat, lon, l, x), 0, T(1e-6));
+    result += checkEquals(x, l.Distance() / 3, T(1e-6));
+  }
+  {
+    const size_t m = 40, n = 200;
+    vector<T> latp(m), lonp(m), lat(n), lon(n), x(n), d(n);
+    vector<size_t> seg(n);
+    for (size_t j = 0; j < m; ++j) {
+      latp[j] = 45 + 2 * sin(T(j) * T(0.9));
+      lonp[j] = T(j) / 4;
+    }
+    for (size_t i = 0; i < n; ++i) {
+      lat[i] = 45 + 3 * sin(T(i) * T(1.3));
+      lon[i] = -1 + 12 * (T(i) / n);
+    }
+    cp.Polyline(n, lat.data(), lon.data(), m, latp.data(), lonp.data(),
+                seg.data(), x.data(), d.data(), 3);
+    int k = 0;
+    for (size_t i = 0; i < n; ++i) {
+      T dbest = Math::infinity(), xbest = 0;
+      for (size_t j = 0; j + 1 < m; ++j) {
+        T xj, dj = cp.Segment(lat[i], lon[i], latp[j], lonp[j],
+                              latp[j+1], lonp[j+1], xj);
+        if (dj < dbest) { dbest = dj; xbest = xj; }
+      }
+      k += checkSame(d[i], dbest);
+      // Ties between adjacent segments at a vertex may resolve either way
+      if (x[i] != xbest && !(x[i] == 0 || xbest == 0)) ++k;
+    }
+    if (k) cout << "testclosestpoint failure: polyline\n";
+    result += k;
+  }
+  return result;
+}
+
+static int testpointinpolygon() {
+  // PointInPolygon::Contains must agree with counting the intersections of
+  // the edges with the meridian from the point to the north pole, for both
+  // orientations of the polygon; ContainsBatch must agree with Contains.
+  // Polygons encircling a pole contain the region on the left.
+  const Geodesic& g = Geodesic::WGS84();
+  Intersect inter(g);
+  int result = 0;
+  const size_t n = 200, nq = 300;
+  vector<T> lat(n), lon(n), latr(n), lonr(n), latq(nq), lonq(nq);
+  for (size_t i = 0; i < n; ++i) {
+    T r = 300e3 + 200e3 * sin(T(i) * T(0.37)) * cos(T(i) * T(0.11));
+    g.Direct(40, 10, T(i) * (Math::td / n), r, lat[i], lon[i]);
+    latr[n - 1 - i] = lat[i]; lonr[n - 1 - i] = lon[i];
+  }
+  for (size_t i = 0; i < nq; ++i) {
+    latq[i] = 40 + 5 * sin(T(i) * T(1.7));
+    lonq[i] = 10 + 7 * sin(T(i) * T(2.3) + T(0.1));
+  }
+  PointInPolygon poly(g, n, lat.data(), lon.data(), 3),
+    polyr(g, n, latr.data(), lonr.data());
+  unique_ptr<bool[]> inside(new bool[nq]);
+  poly.ContainsBatch(nq, latq.data(), lonq.data(), inside.get(), 3);
+  int k = 0, nin = 0;
+  for (size_t i = 0; i < nq; ++i) {
+    int cross = 0;
+    for (size_t j = 0; j < n; ++j) {
+      size_t j1 = j + 1 < n ? j + 1 : 0;
+      int segmode;
+      inter.Segment(latq[i], lonq[i], 90, lonq[i],
+                    lat[j], lon[j], lat[j1], lon[j1], segmode);
+      if (segmode == 0) ++cross;
+    }
+    bool in = poly.Contains(latq[i], lonq[i]);
+    if (in != (cross % 2 != 0)) ++k;
+    if (polyr.Contains(latq[i], lonq[i]) != in) ++k;
+    if (inside[i] != in) ++k;
+    if (in) ++nin;
+  }
+  // Make sure that the test has points both inside and outside
+  if (nin == 0 || nin == int(nq)) ++k;
+  if (k) cout << "testpointinpolygon failure: star polygon\n";
+  result += k;
+  {
+    // A ring of latitude 60 traversed eastwards and westwards
+    const size_t m = 36;
+    vector<T> latc(m, 60), lonc(m);
+    for (size_t i = 0; i < m; ++i) lonc[i] = T(i) * 10 - 175;
+    PointInPolygon east(g, m, latc.data(), lonc.data());
+    reverse(lonc.begin(), lonc.end());
+    PointInPolygon west(g, m, latc.data(), lonc.data());
+    k = 0;
+    for (int j = 0; j < 8; ++j) {
+      T lonp = T(j) * 45 - 180 + T(0.3);
+      k += !east.Contains(80, lonp) + east.Contains(50, lonp);
+      k += west.Contains(80, lonp) + !west.Contains(50, lonp);
+      k += !west.Contains(-80, lonp);
+    }
+    if (k) cout << "testpointinpolygon failure: polar cap\n";
+    result += k;
+  }
+  result += PointInPolygon(g, 2, lat.data(), lon.data()).Contains(40, 10);
+  return result;
+}
+
+static int testorder() {
+  // Geodesic with each series order from 3 to 8; the errors for order 3 and
+  // 4 are about 8 um and 30 nm in s12 and 8000 m^2 and 12 m^2 in S12.
+  const T a = Constants::WGS84_a(), f = Constants::WGS84_f();
+  int result = 0;
+  for (int order = 3; order <= 8; ++order) {
+    Geodesic g(a, f, false, order);
+    T d = order == 3 ? 1e5 : (order == 4 ? 1e3 : 1);
+    int k = 0;
+    k += g.Order() != order;
+    for (int i = 0; i < ncases; ++i) {
+      T lat1 = testcases[i][0], lon1 = testcases[i][1],
+        lat2 = testcases[i][3], lon2 = testcases[i][4],
+        s12 = testcases[i][6], S12 = testcases[i][11],
+        s12a, azi1a, azi2a, m12a, M12a, M21a, S12a, lat2a, lon2a;
+      g.Inverse(lat1, lon1, lat2, lon2, s12a, azi1a, azi2a,
+                m12a, M12a, M21a, S12a);
+      k += checkEquals(azi1a, testcases[i][2], 1e-12 * d);
+      k += checkEquals(s12a, s12, 1e-8 * d);
+      k += checkEquals(S12a, S12, 0.5 * d);
+      // The reduced length and geodesic scales (the A2 and C2 series)
+      k += checkEquals(m12a, testcases[i][8], 1e-8 * d);
+      k += checkEquals(M12a, testcases[i][9], 1e-15 * d);
+      k += checkEquals(M21a, testcases[i][10], 1e-15 * d);
+      GeodesicLine l = g.Line(lat1, lon1, testcases[i][2]);
+      l.Position(s12, lat2a, lon2a);
+      k += checkEquals(lat2a, lat2, 1e-12 * d);
+      k += checkEquals(Math::AngDiff(lon2, lon2a), 0, 1e-12 * d);
+    }
+    // The area of an octant
+    PolygonArea p(g);
+    p.AddPoint(0, 0); p.AddPoint(0, 90); p.AddPoint(90, 0);
+    T perim, area;
+    p.Compute(false, true, perim, area);
+    k += checkEquals(area, g.EllipsoidArea() / 8, 0.5 * d);
+    if (k) cout << "testorder failure: order " << order << "\n";
+    result += k;
+  }
+  try {
+    Geodesic g(a, f, false, 9);
+    ++result;
+  }
+  catch (const GeographicErr&) {}
+  return result;
+}
+
+static int testseriesexact() {
+  // The series of Geodesic (with their coefficients scaled in the
+  // constructor) agree with GeodesicExact for |f| = 1/150 (the largest
+  // flattening for which the default order gives full accuracy), for
+  // direct and inverse problems covering the range of eps.
+  const T a = 6.4e6;
+  int result = 0;
+  for (int sgn = -1; sgn <= 1; sgn += 2) {
+    const T f = sgn / T(150);
+    const Geodesic g(a, f);
+    const GeodesicExact ge(a, f);
+    int k = 0;
+    for (int i = 0; i < 400; ++i) {
+      T lat1 = T(89.9) * sin(T(i) * T(0.37)),
+        lat2 = T(89.9) * sin(T(i) * T(1.13)),
+        lon2 = i % 20 == 0 ? 180 - T(i % 7) / 10 :
+        remainder(T(i) * T(13.7), T(360)),
+        s12, azi1, azi2, m12, M12, M21, S12,
+        s12e, azi1e, azi2e, m12e, M12e, M21e, S12e;
+      g.Inverse(lat1, 0, lat2, lon2, s12, azi1, azi2, m12, M12, M21, S12);
+      ge.Inverse(lat1, 0, lat2, lon2, s12e, azi1e, azi2e,
+                 m12e, M12e, M21e, S12e);
+      k += checkEquals(s12, s12e, 2e-8) + checkEquals(m12, m12e, 2e-8) +
+        checkEquals(M12, M12e, 1e-14) + checkEquals(M21, M21e, 1e-14) +
+        checkEquals(S12, S12e, 0.1);
+      // Azimuths are ill-conditioned for nearly antipodal points
+      if (i % 20)
+        k += checkEquals(Math::AngDiff(azi1, azi1e), 0, 1e-11) +
+          checkEquals(Math::AngDiff(azi2, azi2e), 0, 1e-11);
+      T lat2a, lon2a, azi2a, m12a, M12a, M21a, S12a,
+        lat2b, lon2b, azi2b, m12b, M12b, M21b, S12b;
+      g.GenDirect(lat1, 0, azi1e, false, s12e, Geodesic::ALL,
+                  lat2a, lon2a, azi2a, s12, m12a, M12a, M21a, S12a);
+      ge.GenDirect(lat1, 0, azi1e, false, s12e, GeodesicExact::ALL,
+                   lat2b, lon2b, azi2b, s12, m12b, M12b, M21b, S12b);
+      // The longitude and azimuth are ill-conditioned near the poles; so
+      // compare the end points by the distance between them
+      T d;
+      ge.Inverse(lat2a, lon2a, lat2b, lon2b, d);
+      k += checkEquals(d, 0, 2e-8) + checkEquals(m12a, m12b, 2e-8) +
+        checkEquals(M12a, M12b, 1e-14);
+    }
+    if (k) cout << "testseriesexact failure: f = " << f << "\n";
+    result += k;
+  }
+  return result;
+}
+
+static int testfloatbatch() {
+  // The float versions of the batch functions give the results of the
+  // scalar functions, evaluated for the floats, rounded to floats.
+  float lat1[ncases], lon1[ncases], lat2[ncases], lon2[ncases],
+    azi1[ncases], s12[ncases], r1[ncases], r2[ncases], r3[ncases];
+  for (int i = 0; i < ncases; ++i) {
+    lat1[i] = float(testcases[i][0]); lon1[i] = float(testcases[i][1]);
+    lat2[i] = float(testcases[i][3]); lon2[i] = float(testcases[i][4]);
+    azi1[i] = float(testcases[i][2]); s12[i] = float(testcases[i][6]);
+  }
+  const Geodesic& g = Geodesic::WGS84();
+  const Geocentric& earth = Geocentric::WGS84();
+  const TransverseMercator& tm = TransverseMercator::UTM();
+  int result = 0;
+  g.InverseBatch(ncases, lat1, lon1, lat2, lon2, Geodesic::ALL,
+                 nullptr, r1, r2, nullptr, nullptr, nullptr, nullptr, r3);
+  for (int i = 0; i < ncases; ++i) {
+    T s12a, azi1a, azi2a, m12a, M12a, M21a, S12a;
+    g.GenInverse(lat1[i], lon1[i], lat2[i], lon2[i], Geodesic::ALL,
+                 s12a, azi1a, azi2a, m12a, M12a, M21a, S12a);
+    result += checkSame(r1[i], float(s12a));
+    result += checkSame(r2[i], float(azi1a));
+    result += checkSame(r3[i], float(S12a));
+  }
+  g.DirectBatch(ncases, lat1, lon1, azi1, false, s12, Geodesic::ALL,
+                nullptr, r1, r2, r3, nullptr, nullptr, nullptr, nullptr,
+                nullptr);
+  for (int i = 0; i < ncases; ++i) {
+    T lat2a, lon2a, azi2a;
+    g.Direct(lat1[i], lon1[i], azi1[i], s12[i], lat2a, lon2a, azi2a);
+    result += checkSame(r1[i], float(lat2a));
+    result += checkSame(r2[i], float(lon2a));
+    result += checkSame(r3[i], float(azi2a));
+  }
+  // Use s12 for the heights
+  earth.ForwardBatch(ncases, lat1, lon1, s12, r1, r2, r3);
+  for (int i = 0; i < ncases; ++i) {
+    T X, Y, Z;
+    earth.Forward(lat1[i], lon1[i], s12[i], X, Y, Z);
+    result += checkSame(r1[i], float(X));
+    result += checkSame(r2[i], float(Y));
+    result += checkSame(r3[i], float(Z));
+  }
+  earth.ReverseBatch(ncases, r1, r2, r3, r1, r2, r3);
+  for (int i = 0; i < ncases; ++i) {
+    T X, Y, Z, lat, lon, h;
+    earth.Forward(lat1[i], lon1[i], s12[i], X, Y, Z);
+    earth.Reverse(float(X), float(Y), float(Z), lat, lon, h);
+    result += checkSame(r1[i], float(lat));
+    result += checkSame(r2[i], float(lon));
+    result += checkSame(r3[i], float(h));
+  }
+  tm.ForwardBatch(ncases, 3, lat1, lon1, r1, r2, r3);
+  for (int i = 0; i < ncases; ++i) {
+    T x, y, gamma, k;
+    tm.Forward(3, lat1[i], lon1[i], x, y, gamma, k);
+    result += checkSame(r1[i], float(x));
+    result += checkSame(r2[i], float(y));
+    result += checkSame(r3[i], float(gamma));
+  }
+  tm.ReverseBatch(ncases, 3, r1, r2, r1, r2);
+  for (int i = 0; i < ncases; ++i) {
+    T x, y, lat, lon;
+    tm.Forward(3, lat1[i], lon1[i], x, y);
+    tm.Reverse(3, float(x), float(y), lat, lon);
+    result += checkSame(r1[i], float(lat));
+    result += checkSame(r2[i], float(lon));
+  }
+  return result;
+}
+
+template<typename X>
+static int testroundtrip(size_t num) {
+  // Write and read back in both byte orders; the arrays span several of
+  // the pieces read by readarray.
+  vector<X> a(num), b(num);
+  for (size_t k = 0; k < num; ++k)
+    a[k] = X(k * 2654435761u % 65521u);
+  int result = 0;
+  for (int big = 0; big < 2; ++big) {
+    stringstream str;
+    if (big) {
+      Utility::writearray<X, X, true>(str, a);
+      Utility::readarray<X, X, true>(str, b);
+    } else {
+      Utility::writearray<X, X, false>(str, a);
+      Utility::readarray<X, X, false>(str, b);
+    }
+    result += a == b ? 0 : 1;
+  }
+  return result;
+}
+
+static int testreadarray() {
+  int result = 0;
+  result += Math::swab<unsigned short>(0x0102u) == 0x0201u ? 0 : 1;
+  result += Math::swab<unsigned>(0x01020304u) == 0x04030201u ? 0 : 1;
+  result += Math::swab<unsigned long long>(0x0102030405060708ull) ==
+    0x0807060504030201ull ? 0 : 1;
+  result += Math::swab(Math::swab(1.0/3)) == 1.0/3 ? 0 : 1;
+  result += testroundtrip<unsigned short>(200000);
+  result += testroundtrip<float>(100000);
+  result += testroundtrip<double>(100000);
+  // Reading big-endian unsigned shorts converted to ints
+  {
+    const unsigned short a[] = {1, 0x1234, 0xfffe};
+    stringstream str;
+    Utility::writearray<unsigned short, unsigned short, true>(str, a, 3);
+    string s = str.str();
+    result += s == string("\x00\x01\x12\x34\xff\xfe", 6) ? 0 : 1;
+    int b[3];
+    Utility::readarray<unsigned short, int, true>(str, b, 3);
+    result += b[0] == 1 && b[1] == 0x1234 && b[2] == 0xfffe ? 0 : 1;
+  }
+  return result;
+}
+
+static int testdistancematrix() {
+  // The end points of the test cases together with points at the poles, on
+  // the equator, and nearly antipodal to one another; there are enough points
+  // to span several tiles.
+  vector<T> lat, lon;
+  for (int i = 0; i < ncases; ++i) {
+    lat.push_back(testcases[i][0]); lon.push_back(testcases[i][1]);
+    lat.push_back(testcases[i][3]); lon.push_back(testcases[i][4]);
+  }
+  for (int i = 0; i < 50; ++i) {
+    T x = T(i) / 49;
+    lat.push_back(i % 5 == 0 ? 90 : (i % 5 == 1 ? -90 : 0));
+    lon.push_back(360 * x - 180);
+    lat.push_back(60 * x - 30); lon.push_back(T(i % 7) * 30);
+    lat.push_back(30 - 60 * x); lon.push_back(T(i % 7) * 30 + T(179.5));
+  }
+  const size_t n = lat.size(), m = n / 3;
+  const Geodesic& g = Geodesic::WGS84();
+  GeodesicBatchExecutor exec(3);
+  vector<T> s12(n * m), s12e(n * m), d12(n * n), d12e(n * n);
+  // Rectangular matrix with the second set the last m points
+  g.DistanceMatrix(n, lat.data(), lon.data(),
+                   m, lat.data() + (n - m), lon.data() + (n - m), s12.data());
+  exec.DistanceMatrix(g, n, lat.data(), lon.data(),
+                      m, lat.data() + (n - m), lon.data() + (n - m),
+                      s12e.data());
+  g.DistanceMatrix(n, lat.data(), lon.data(), d12.data());
+  exec.DistanceMatrix(g, n, lat.data(), lon.data(), d12e.data());
+  int result = 0;
+  for (size_t i = 0; i < n; ++i) {
+    int k = 0;
+    for (size_t j = 0; j < m; ++j) {
+      T s12a;
+      g.Inverse(lat[i], lon[i], lat[n - m + j], lon[n - m + j], s12a);
+      k += checkSame(s12[i * m + j], s12a) + checkSame(s12e[i * m + j], s12a);
+    }
+    for (size_t j = 0; j < n; ++j) {
+      T s12a;
+      g.Inverse(lat[i], lon[i], lat[j], lon[j], s12a);
+      k += checkSame(d12[i * n + j], s12a) + checkSame(d12e[i * n + j], s12a);
+    }
+    if (k) cout << "testdistancematrix failure: row " << i << "\n";
+    result += k;
+  }
+  return result;
+}
+
+static int testinversefrom() {
+  // Geodesic::InverseFrom from each end point of the test cases to all the
+  // end points
+  const Geodesic& g = Geodesic::WGS84();
+  const unsigned outmask = Geodesic::ALL;
+  vector<T> lat2(2 * ncases), lon2(2 * ncases);
+  for (int j = 0; j < ncases; ++j) {
+    lat2[2 * j] = testcases[j][0]; lon2[2 * j] = testcases[j][1];
+    lat2[2 * j + 1] = testcases[j][3]; lon2[2 * j + 1] = testcases[j][4];
+  }
+  const size_t n = lat2.size();
+  vector<T> a12(n), s12(n), azi1(n), azi2(n), m12(n), M12(n), M21(n), S12(n);
+  int result = 0;
+  for (size_t i = 0; i < n; ++i) {
+    Geodesic::InverseOrigin o = g.InverseFrom(lat2[i], lon2[i]);
+    o.InverseBatch(n, lat2.data(), lon2.data(), outmask,
+                   a12.data(), s12.data(), azi1.data(), azi2.data(),
+                   m12.data(), M12.data(), M21.data(), S12.data());
+    int k = 0;
+    for (size_t j = 0; j < n; ++j) {
+      T a12a, s12a, azi1a, azi2a, m12a, M12a, M21a, S12a,
+        a12b, s12b, azi1b, azi2b, t;
+      a12a = g.GenInverse(lat2[i], lon2[i], lat2[j], lon2[j], outmask,
+                          s12a, azi1a, azi2a, m12a, M12a, M21a, S12a);
+      k += checkSame(a12[j], a12a) + checkSame(s12[j], s12a);
+      k += checkSame(azi1[j], azi1a) + checkSame(azi2[j], azi2a);
+      k += checkSame(m12[j], m12a) + checkSame(S12[j], S12a);
+      k += checkSame(M12[j], M12a) + checkSame(M21[j], M21a);
+      a12b = o.Inverse(lat2[j], lon2[j], s12b, azi1b, azi2b);
+      k += checkSame(a12b, a12a) + checkSame(s12b, s12a);
+      k += checkSame(azi1b, azi1a) + checkSame(azi2b, azi2a);
+      o.Inverse(lat2[j], lon2[j], t);
+      k += checkSame(t, s12a);
+    }
+    if (k) cout << "testinversefrom failure: point " << i << "\n";
+    result += k;
+  }
+  return result;
+}
+
+static int testinversewarm() {
+  // Geodesic::GenInverseWarm with the exact azimuths, perturbed azimuths,
+  // and nans as the guesses
+  const Geodesic& g = Geodesic::WGS84();
+  const T dazi[] = {0, T(0.5), -T(0.5), Math::NaN()};
+  int result = 0;
+  for (int i = 0; i < ncases; ++i) {
+    int k = 0;
+    T lat1 = testcases[i][0], lon1 = testcases[i][1],
+      lat2 = testcases[i][3], lon2 = testcases[i][4];
+    T azi1a, azi2a, s12a, a12a, m12a, M12a, M21a, S12a;
+    a12a = g.GenInverse(lat1, lon1, lat2, lon2, Geodesic::ALL,
+                        s12a, azi1a, azi2a, m12a, M12a, M21a, S12a);
+    for (int j = 0; j < 4; ++j) {
+      T azi1 = testcases[i][2] + dazi[j], azi2 = testcases[i][5] - dazi[j],
+        s12, a12, m12, M12, M21, S12;
+      a12 = g.GenInverseWarm(lat1, lon1, lat2, lon2, Geodesic::ALL,
+                             s12, azi1, azi2, m12, M12, M21, S12);
+      if (j == 3) {
+        k += checkSame(azi1, azi1a) + checkSame(azi2, azi2a);
+        k += checkSame(s12, s12a) + checkSame(a12, a12a);
+        k += checkSame(m12, m12a) + checkSame(S12, S12a);
+        k += checkSame(M12, M12a) + checkSame(M21, M21a);
+      } else {
+        k += checkEquals(azi1, testcases[i][2], 1e-13);
+        k += checkEquals(azi2, testcases[i][5], 1e-13);
+        k += checkEquals(s12, testcases[i][6], 1e-8);
+        k += checkEquals(a12, testcases[i][7], 1e-13);
+        k += checkEquals(m12, testcases[i][8], 1e-8);
+        k += checkEquals(M12, testcases[i][9], 1e-15);
+        k += checkEquals(M21, testcases[i][10], 1e-15);
+        k += checkEquals(S12, testcases[i][11], 0.1);
+      }
+    }
+    if (k) cout << "testinversewarm failure: case " << i << "\n";
+    result += k;
+  }
+  return result;
+}
+
+static int testwithindistance() {
+  // Geodesic::WithinDistance with thresholds which the bounds decide and
+  // ones which need the inverse problem to be solved
+  const Geodesic& g = Geodesic::WGS84();
+  const T fac[] = {T(0.5), 1 - T(1e-3), 1 - T(1e-7), 1 + T(1e-7), 1 + T(1e-3),
+                   2};
+  int result = 0;
+  for (int i = 0; i < ncases; ++i) {
+    int k = 0;
+    T lat1 = testcases[i][0], lon1 = testcases[i][1],
+      lat2 = testcases[i][3], lon2 = testcases[i][4], s12;
+    g.Inverse(lat1, lon1, lat2, lon2, s12);
+    for (int j = 0; j < 6; ++j) {
+      T R = fac[j] * s12;
+      k += g.WithinDistance(lat1, lon1, lat2, lon2, R) == (s12 < R) ? 0 : 1;
+    }
+    if (k) cout << "testwithindistance failure: case " << i << "\n";
+    result += k;
+  }
+  return result;
+}
+
+static int testsphere() {
+  // Geodesic on a sphere, which uses the closed form solution of the inverse
+  // problem, against GeodesicExact (which doesn't)
+  const T a = 6371e3;
+  Geodesic g(a, 0);
+  GeodesicExact ge(a, 0);
+  vector<T> lat, lon;
+  for (int i = 0; i < ncases; ++i) {
+    lat.push_back(testcases[i][0]); lon.push_back(testcases[i][1]);
+    lat.push_back(testcases[i][3]); lon.push_back(testcases[i][4]);
+  }
+  // Include coincident, antipodal, and nearly antipodal points
+  lat.push_back(10); lon.push_back(20);
+  lat.push_back(-10); lon.push_back(-160);
+  lat.push_back(-10.5); lon.push_back(-160.5);
+  int result = 0;
+  for (size_t i = 0; i < lat.size(); ++i) {
+    int k = 0;
+    for (size_t j = 0; j < lat.size(); ++j) {
+      T s12, azi1, azi2, m12, M12, M21, S12,
+        s12a, azi1a, azi2a, m12a, M12a, M21a, S12a;
+      g.Inverse(lat[i], lon[i], lat[j], lon[j],
+                s12, azi1, azi2, m12, M12, M21, S12);
+      ge.Inverse(lat[i], lon[i], lat[j], lon[j],
+                 s12a, azi1a, azi2a, m12a, M12a, M21a, S12a);
+      k += checkEquals(s12, s12a, 1e-8);
+      // Azimuths are indeterminate for coincident and antipodal points
+      if (m12a > 1) {
+        k += checkEquals(Math::AngDiff(azi1, azi1a), 0, 1e-12);
+        k += checkEquals(Math::AngDiff(azi2, azi2a), 0, 1e-12);
+        k += checkEquals(S12, S12a, 1);
+      }
+      k += checkEquals(m12, m12a, 1e-6);
+      k += checkEquals(M12, M12a, 1e-14);
+      k += checkEquals(M21, M21a, 1e-14);
+    }
+    if (k) cout << "testsphere failure: point " << i << "\n";
+    result += k;
+  }
+  // The area and perimeter of an octant
+  PolygonArea p(g);
+  p.AddPoint(0, 0); p.AddPoint(0, 90); p.AddPoint(90, 0);
+  T perim, area;
+  p.Compute(false, true, perim, area);
+  result += checkEquals(area, g.EllipsoidArea() / 8, 1);
+  result += checkEquals(perim, 3 * Math::pi() * a / 2, 1e-8);
+  return result;
+}
+
+static int testwaypoints() {
+  // GeodesicLine::Waypoints against PositionBatch for lines spanning several
+  // restarts of the recurrence
+  const Geodesic& g = Geodesic::WGS84();
+  const size_t n = 200;
+  const unsigned outmask = Geodesic::ALL;
+  vector<T> x(n), a12(n), lat2(n), lon2(n), azi2(n), s12(n),
+    a12a(n), lat2a(n), lon2a(n), azi2a(n), s12a(n), S12(n), S12a(n);
+  int result = 0;
+  for (int i = 0; i < ncases; ++i) {
+    GeodesicLine l = g.InverseLine(testcases[i][0], testcases[i][1],
+                                   testcases[i][3], testcases[i][4],
+                                   Geodesic::ALL);
+    int k = 0;
+    for (int arcmode = 0; arcmode < 2; ++arcmode) {
+      T x13 = arcmode ? l.Arc() : l.Distance();
+      for (size_t j = 0; j < n; ++j)
+        x[j] = j + 1 == n ? x13 : T(j) * (x13 / T(n - 1));
+      l.PositionBatch(n, arcmode != 0, x.data(), outmask,
+                      a12.data(), lat2.data(), lon2.data(), azi2.data(),
+                      s12.data(), nullptr, nullptr, nullptr, S12.data());
+      l.Waypoints(n, arcmode != 0, outmask,
+                  a12a.data(), lat2a.data(), lon2a.data(), azi2a.data(),
+                  s12a.data(), nullptr, nullptr, nullptr, S12a.data());
+      for (size_t j = 0; j < n; ++j) {
+        k += checkEquals(a12a[j], a12[j], 1e-13);
+        k += checkEquals(lat2a[j], lat2[j], 1e-13);
+        k += checkEquals(Math::AngDiff(lon2a[j], lon2[j]), 0, 1e-11);
+        k += checkEquals(Math::AngDiff(azi2a[j], azi2[j]), 0, 1e-11);
+        k += checkEquals(s12a[j], s12[j], 1e-8);
+        k += checkEquals(S12a[j], S12[j], 1);
+      }
+      // The first and last points are points 1 and 3
+      k += checkSame(lat2a[0], lat2[0]) + checkSame(lat2a[n-1], lat2[n-1]);
+    }
+    if (k) cout << "testwaypoints failure: case " << i << "\n";
+    result += k;
+  }
+  return result;
+}
+
+static int testdensify() {
+  // GeodesicLine::Densify with a transverse Mercator projection: the
+  // polyline should follow a dense sampling of the projected geodesic to
+  // within (about) the tolerance.  RhumbLine::Densify with a Mercator
+  // projection: only the end points are needed.
+  const Geodesic& g = Geodesic::WGS84();
+  const TransverseMercator& tm = TransverseMercator::UTM();
+  const T lon0 = 3, tol = 10;
+  auto proj = [&tm, lon0](T lat, T lon, T& x, T& y) -> void {
+    tm.Forward(lon0, lat, lon, x, y);
+  };
+  const T lines[][4] = {
+    {40, -10, 45, 20}, {60, 0, 62, 6}, {-20, -5, 30, 10}, {0, 3, 0, 3.001}
+  };
+  const size_t nref = 2001;
+  vector<T> lat, lon, latr(nref), lonr(nref), x, y;
+  int result = 0;
+  for (int i = 0; i < 4; ++i) {
+    GeodesicLine l = g.InverseLine(lines[i][0], lines[i][1],
+                                   lines[i][2], lines[i][3]);
+    l.Densify(proj, tol, lat, lon);
+    size_t n = lat.size();
+    int k = 0;
+    k += checkEquals(lat[0], lines[i][0], 1e-13);
+    k += checkEquals(lon[0], lines[i][1], 1e-13);
+    k += checkEquals(lat[n-1], lines[i][2], 1e-13);
+    k += checkEquals(lon[n-1], lines[i][3], 1e-13);
+    k += n >= 2 && n <= 200 ? 0 : 1;
+    x.resize(n); y.resize(n);
+    for (size_t j = 0; j < n; ++j)
+      proj(lat[j], lon[j], x[j], y[j]);
+    l.Waypoints(nref, true, Geodesic::LATITUDE | Geodesic::LONGITUDE,
+                nullptr, latr.data(), lonr.data(), nullptr,
+                nullptr, nullptr, nullptr, nullptr, nullptr);
+    T dmax = 0;
+    for (size_t r = 0; r < nref; ++r) {
+      T xr, yr, d = Math::infinity();
+      proj(latr[r], lonr[r], xr, yr);
+      for (size_t j = 0; j + 1 < n; ++j) {
+        T dx = x[j+1] - x[j], dy = y[j+1] - y[j],
+          ex = xr - x[j], ey = yr - y[j],
+          u = fmin(T(1), fmax(T(0), (dx * ex + dy * ey) /
+                              (Math::sq(dx) + Math::sq(dy))));
+        d = fmin(d, hypot(ex - u * dx, ey - u * dy));
+      }
+      dmax = fmax(dmax, d);
+    }
+    k += checkEquals(dmax, 0, T(1.2) * tol);
+    if (k) cout << "testdensify failure: case " << i << "\n";
+    result += k;
+  }
+  {
+    const Rhumb& rh = Rhumb::WGS84();
+    const Ellipsoid ell(rh.EquatorialRadius(), rh.Flattening());
+    const T a = rh.EquatorialRadius();
+    auto merc = [&ell, a](T lat, T lon, T& x, T& y) -> void {
+      x = a * lon * Math::degree();
+      y = a * ell.IsometricLatitude(lat) * Math::degree();
+    };
+    RhumbLine l = rh.Line(10, 170, 40);
+    l.Densify(5e6, merc, T(1e-3), lat, lon);
+    int k = lat.size() == 2 ? 0 : 1;
+    // The longitude is unrolled across the antimeridian
+    k += lon[1] > 180 ? 0 : 1;
+    if (k) cout << "testdensify failure: rhumb line\n";
+    result += k;
+  }
+  return result;
+}
+
+static int testtransferbatch() {
+  // UTMUPS::TransferBatch matches Transfer to within roundoff.  The points
+  // are near the boundary of zones 31 and 32, with a few in UPS.
+  const int n = 400;
+  vector<int> zone(n), zone1(n);
+  vector<T> x(n), y(n), x1(n), y1(n);
+  unique_ptr<bool[]> northp(new bool[n]);
+  for (int i = 0; i < n; ++i) {
+    T lat = -79.5 + T(i) * 163 / n, lon = 5 + T(i % 7) / 3, gamma, k;
+    if (i % 50 == 0) lat = i % 100 ? T(84.5) : T(-80.3);
+    UTMUPS::Forward(lat, lon, zone[i], northp[i], x[i], y[i], gamma, k);
+  }
+  int result = 0;
+  for (int zoneout = 31; zoneout <= 32; ++zoneout) {
+    bool northpout = zoneout == 31;
+    UTMUPS::TransferBatch(n, zone.data(), northp.get(), x.data(), y.data(),
+                          zoneout, northpout,
+                          x1.data(), y1.data(), zone1.data());
+    for (int i = 0; i < n; ++i) {
+      T xa, ya;
+      int zonea;
+      UTMUPS::Transfer(zone[i], northp[i], x[i], y[i], zoneout, northpout,
+                       xa, ya, zonea);
+      result += zone1[i] != zonea;
+      result += checkEquals(x1[i], xa, T(1e-8));
+      result += checkEquals(y1[i], ya, T(1e-8));
+    }
+  }
+  // Zone 60 is too far away
+  try {
+    UTMUPS::TransferBatch(n, zone.data(), northp.get(), x.data(), y.data(),
+                          60, true, x1.data(), y1.data(), zone1.data());
+    ++result;
+  }
+  catch (const GeographicErr&) {}
+  {
+    // More points than fit in a block, from zones 33 through 35 and UPS,
+    // transferred in place to zone 34 (and the polar ones to UPS)
+    const int m = 2500;
+    vector<int> zm(m), zp(m);
+    vector<T> xm(m), ym(m), xp(m), yp(m);
+    unique_ptr<bool[]> nm(new bool[m]);
+    for (int i = 0; i < m; ++i) {
+      T lat = -79 + T((i * 37) % m) * 163 / m, lon = 17 + T(i % 9),
+        gamma, k;
+      // In UPS but close enough to the equator to transfer to UTM
+      if (i % 3 == 0) lat = 84 + T(i % 5) / 10;
+      UTMUPS::Forward(lat, lon, zm[i], nm[i], xm[i], ym[i], gamma, k);
+    }
+    for (int zoneout = 0; zoneout <= 34; zoneout += 34) {
+      vector<int> zi, zo;
+      vector<T> xi, yi;
+      vector<char> ni;
+      for (int i = 0; i < m; ++i)
+        if (zoneout || i % 3 == 0) {
+          zi.push_back(zm[i]); ni.push_back(nm[i]);
+          xi.push_back(xm[i]); yi.push_back(ym[i]);
+        }
+      const size_t mi = zi.size();
+      unique_ptr<bool[]> nb(new bool[mi]);
+      for (size_t i = 0; i < mi; ++i) nb[i] = ni[i] != 0;
+      vector<T> xo(xi), yo(yi);
+      zo.resize(mi);
+      UTMUPS::TransferBatch(mi, zi.data(), nb.get(), xo.data(), yo.data(),
+                            zoneout, true, xo.data(), yo.data(), zo.data());
+      int j = 0;
+      for (size_t i = 0; i < mi; ++i) {
+        T xa, ya;
+        int zonea;
+        UTMUPS::Transfer(zi[i], nb[i], xi[i], yi[i], zoneout, true,
+                         xa, ya, zonea);
+        j += zo[i] != zonea;
+        j += checkEquals(xo[i], xa, T(1e-8)) + checkEquals(yo[i], ya, T(1e-8));
+      }
+      if (j) cout << "testtransferbatch failure: zone " << zoneout << "\n";
+      result += j;
+    }
+  }
+  {
+    // TransverseMercator::TransferBatch matches Reverse followed by Forward
+    const TransverseMercator& tm = TransverseMercator::UTM();
+    const int m = 300;
+    vector<T> xi(m), yi(m), xo(m), yo(m), lon(m);
+    for (int i = 0; i < m; ++i) {
+      T gamma, k;
+      tm.Forward(15, -80 + T(i) * 164 / m, 10 + T(i % 9), xi[i], yi[i],
+                 gamma, k);
+    }
+    tm.TransferBatch(m, 15, xi.data(), yi.data(), 21,
+                     xo.data(), yo.data(), lon.data());
+    for (int i = 0; i < m; ++i) {
+      T lat1, lon1, xa, ya, gamma, k;
+      tm.Reverse(15, xi[i], yi[i], lat1, lon1, gamma, k);
+      tm.Forward(21, lat1, lon1, xa, ya, gamma, k);
+      result += checkEquals(xo[i], xa, T(1e-8)) +
+        checkEquals(yo[i], ya, T(1e-8)) + checkEquals(lon[i], lon1, T(1e-12));
+    }
+  }
+  return result;
+}
+
+static int testhelmert() {
+  // The WGS 72 to WGS 84 example from EPSG Guidance Note 7-2 (position
+  // vector convention); the coordinate frame convention flips the rotation.
+  int result = 0;
+  Helmert wgs72(0, 0, T(4.5), T(0.219), 0, 0, T(0.554)),
+    wgs72c(0, 0, T(4.5), T(0.219), 0, 0, T(-0.554), true);
+  T X, Y, Z, X1, Y1, Z1;
+  wgs72.Forward(T(3657660.66), T(255768.55), T(5201382.11), X, Y, Z);
+  result += checkEquals(X, T(3657660.78), T(0.01));
+  result += checkEquals(Y, T(255778.43), T(0.01));
+  result += checkEquals(Z, T(5201387.75), T(0.01));
+  wgs72c.Forward(T(3657660.66), T(255768.55), T(5201382.11), X1, Y1, Z1);
+  result += checkEquals(X1, X, T(1e-8));
+  result += checkEquals(Y1, Y, T(1e-8));
+  result += checkEquals(Z1, Z, T(1e-8));
+  wgs72.Reverse(X, Y, Z, X1, Y1, Z1);
+  result += checkEquals(X1, T(3657660.66), T(1e-8));
+  result += checkEquals(Y1, T(255768.55), T(1e-8));
+  result += checkEquals(Z1, T(5201382.11), T(1e-8));
+  // The 14-parameter transformation at an epoch matches the 7-parameter
+  // one with the parameters advanced by hand.
+  Helmert itrf(T(1.6e-3), T(1.9e-3), T(2.4e-3), T(-0.02e-3), 1, 2, 3,
+               0, 0, T(-0.1e-3), T(0.03e-3), T(0.1), 0, 0, 2010),
+    itrf2020 = itrf.AtEpoch(2020),
+    itrf2020a(T(1.6e-3), T(1.9e-3), T(1.4e-3), T(0.28e-3), 2, 2, 3);
+  result += itrf2020.Epoch() != 2020;
+  itrf2020.Forward(T(-2e6), T(5e6), T(3e6), X, Y, Z);
+  itrf2020a.Forward(T(-2e6), T(5e6), T(3e6), X1, Y1, Z1);
+  result += checkEquals(X1, X, T(1e-8));
+  result += checkEquals(Y1, Y, T(1e-8));
+  result += checkEquals(Z1, Z, T(1e-8));
+  // The batch versions agree with the scalar ones (in place and across
+  // datums)
+  const int n = 150;
+  const Geocentric& earth = Geocentric::WGS84();
+  Geocentric earth1(T(6378135), 1/T(298.26));
+  vector<T> lat(n), lon(n), h(n), lat1(n), lon1(n), h1(n),
+    Xs(n), Ys(n), Zs(n);
+  for (int i = 0; i < n; ++i) {
+    lat[i] = -89 + T(i) * 178 / n; lon[i] = -179 + T(i % 36) * 10;
+    h[i] = T(i % 11) * 500 - 1000;
+    earth.Forward(lat[i], lon[i], h[i], Xs[i], Ys[i], Zs[i]);
+  }
+  wgs72.ForwardGeodeticBatch(n, earth, lat.data(), lon.data(), h.data(),
+                             earth1, lat1.data(), lon1.data(), h1.data());
+  wgs72.ForwardBatch(n, Xs.data(), Ys.data(), Zs.data(),
+                     Xs.data(), Ys.data(), Zs.data());
+  for (int i = 0; i < n; ++i) {
+    T lata, lona, ha;
+    earth.Forward(lat[i], lon[i], h[i], X, Y, Z);
+    wgs72.Forward(X, Y, Z, X1, Y1, Z1);
+    result += checkEquals(Xs[i], X1, 0);
+    result += checkEquals(Ys[i], Y1, 0);
+    result += checkEquals(Zs[i], Z1, 0);
+    earth1.Reverse(X1, Y1, Z1, lata, lona, ha);
+    result += checkEquals(lat1[i], lata, T(1e-12));
+    result += checkEquals(lon1[i], lona, T(1e-12));
+    result += checkEquals(h1[i], ha, T(1e-6));
+  }
+  wgs72.ReverseGeodeticBatch(n, earth1, lat1.data(), lon1.data(), h1.data(),
+                             earth, lat1.data(), lon1.data(), h1.data());
+  for (int i = 0; i < n; ++i) {
+    result += checkEquals(lat1[i], lat[i], T(1e-12));
+    result += checkEquals(lon1[i], lon[i], T(1e-12));
+    result += checkEquals(h1[i], h[i], T(1e-6));
+  }
+  return result;
+}
+
+static int testexactaccumulator() {
+  // ExactAccumulator gives the same sum for any order of the additions and
+  // any division into partial sums; PolygonArea::AddPoints gives the same
+  // results for any number of threads.
+  const int n = 1000;
+  vector<T> x(n);
+  for (int i = 0; i < n; ++i)
+    x[i] = (i % 3 ? 1 : -1) * pow(T(10), T(i % 37 - 18)) * (1 + T(i) / 7);
+  ExactAccumulator<T> a, b, c, d;
+  a.Add(x.data(), n);
+  for (int i = n - 1; i >= 0; --i) b += x[i];
+  for (int i = 0; i < n; i += 2) c += x[i];
+  for (int i = 1; i < n; i += 2) d += x[i];
+  c.merge(d);
+  int result = checkSame(b(), a()) + checkSame(c(), a());
+  // Cancellation is exact
+  ExactAccumulator<T> e(T(1e30));
+  e += T(1); e -= T(1e30);
+  result += checkSame(e(), T(1));
+  e -= T(2);
+  result += checkSame(e(), T(-1));
+  const int m = 5000;
+  vector<T> lat(m), lon(m);
+  for (int i = 0; i < m; ++i) {
+    T t = 2 * Math::pi() * i / m;
+    lat[i] = 30 + 20 * sin(3 * t); lon[i] = 100 * cos(t);
+  }
+  T perimeter0 = 0, area0 = 0;
+  for (unsigned nthreads = 1; nthreads <= 4; ++nthreads) {
+    PolygonArea poly(Geodesic::WGS84());
+    poly.AddPoints(m, lat.data(), lon.data(), nthreads);
+    T perimeter, area;
+    poly.Compute(false, true, perimeter, area);
+    if (nthreads == 1) {
+      perimeter0 = perimeter; area0 = area;
+      PolygonArea poly1(Geodesic::WGS84());
+      for (int i = 0; i < m; ++i) poly1.AddPoint(lat[i], lon[i]);
+      T perimeter1, area1;
+      poly1.Compute(false, true, perimeter1, area1);
+      // AddPoint may differ by one unit in the last place
+      const T eps = numeric_limits<T>::epsilon();
+      result += checkEquals(perimeter, perimeter1, eps * perimeter1);
+      result += checkEquals(area, area1,
+                            eps * Geodesic::WGS84().EllipsoidArea());
+    } else
+      result += checkSame(perimeter, perimeter0) + checkSame(area, area0);
+  }
+  return result;
+}
+
+static int testalbersreverse() {
+  // The inverse of the authalic latitude agrees with the exact conversion
+  // in AuxLatitude whether it uses the Fourier series (abs(f) <= 1/150) or
+  // Newton's method.
+  int result = 0;
+  const T fs[] = {1/T(298.257223563), -1/T(150), 1/T(100)};
+  for (T f : fs) {
+    Ellipsoid ell(1, f);
+    AuxLatitude aux(f);
+    for (int i = -90; i <= 90; ++i) {
+      T xi = i == 0 ? T(0.1) : T(i) - T(0.3) * (i > 0 ? 1 : -1);
+      result += checkEquals(ell.InverseAuthalicLatitude(xi),
+                            aux.FromAuxiliary(AuxLatitude::AUTHALIC,
+                                              AuxAngle::degrees(xi))
+                            .degrees(), T(1e-13));
+    }
+  }
+  // Round trip through the projection (avoiding the south pole where the
+  // projection is ill-conditioned)
+  AlbersEqualArea albers(Constants::WGS84_a(), Constants::WGS84_f(),
+                         T(29.5), T(45.5), 1);
+  for (int i = -80; i <= 89; ++i) {
+    T lat = T(i) + T(0.25), lon = T(i % 60), x, y, gam, k, lat1, lon1;
+    albers.Forward(0, lat, lon, x, y, gam, k);
+    albers.Reverse(0, x, y, lat1, lon1, gam, k);
+    result += checkEquals(lat1, lat, T(1e-12));
+    result += checkEquals(lon1, lon, T(1e-12));
+  }
+  return result;
+}
+
+static int testosgbbatch() {
+  // The batch conversions agree with the scalar ones
+  int result = 0;
+  const int n = 100, m = OSGB::MAXLENGTH + 1;
+  vector<T> lat(n), lon(n), x(n), y(n), gam(n), k(n), x1(n), y1(n);
+  for (int i = 0; i < n; ++i) {
+    lat[i] = 50 + T(i) * 8 / n; lon[i] = -7 + T(i % 25) * 9 / 25;
+  }
+  OSGB::ForwardBatch(n, lat.data(), lon.data(), x.data(), y.data(),
+                     gam.data(), k.data());
+  for (int i = 0; i < n; ++i) {
+    T xa, ya, gama, ka;
+    OSGB::Forward(lat[i], lon[i], xa, ya, gama, ka);
+    result += checkEquals(x[i], xa, 0);
+    result += checkEquals(y[i], ya, 0);
+    result += checkEquals(gam[i], gama, 0);
+    result += checkEquals(k[i], ka, 0);
+  }
+  x1 = x; y1 = y;
+  OSGB::ReverseBatch(n, x1.data(), y1.data(), x1.data(), y1.data());
+  for (int i = 0; i < n; ++i) {
+    T lata, lona;
+    OSGB::Reverse(x[i], y[i], lata, lona);
+    result += checkEquals(x1[i], lata, 0);
+    result += checkEquals(y1[i], lona, 0);
+  }
+  x[n-1] = Math::NaN();
+  vector<char> grid(n * m);
+  vector<int> prec(n);
+  for (int p = 0; p <= 11; p += 1) {
+    OSGB::GridReferenceBatch(n, x.data(), y.data(), p, grid.data());
+    OSGB::GridReferenceBatch(n, grid.data(), x1.data(), y1.data(),
+                             prec.data(), false);
+    for (int i = 0; i < n; ++i) {
+      string gridref;
+      T xa, ya;
+      int preca;
+      OSGB::GridReference(x[i], y[i], p, gridref);
+      result += gridref != string(grid.data() + i * m);
+      OSGB::GridReference(gridref, xa, ya, preca, false);
+      result += checkSame(x1[i], xa);
+      result += checkSame(y1[i], ya);
+      result += prec[i] != preca;
+    }
+  }
+  result += prec[n-1] != -2;
+  return result;
+}
+
+static int testgeodesicregion() {
+  // Every point in the region lies in a cell of the cover
+  int result = 0;
+  const Geodesic& g = Geodesic::WGS84();
+  const T lat0 = T(48.857), lon0 = T(2.352), r = 20000;
+  GeodesicRegion circle(g, lat0, lon0, r);
+  result += circle.Classify(T(48.85), T(48.86), T(2.35), T(2.36)) !=
+    GeodesicRegion::INSIDE;
+  result += circle.Classify(-10, 10, -10, 10) != GeodesicRegion::OUTSIDE;
+  result += circle.Classify(48, 49, 2, 3) != GeodesicRegion::PARTIAL;
+  const T plat[] = {48, 48, T(49.5), 49}, plon[] = {1, T(3.5), 3, T(1.2)};
+  GeodesicRegion polygon(g, 4, plat, plon);
+  PointInPolygon pip(g, 4, plat, plon);
+  vector<string> hash, hashc, gars, georef;
+  Geohash::Cover(circle, 6, hash);
+  Geohash::Cover(circle, 6, hashc, true);
+  GARS::Cover(circle, 2, gars);
+  Georef::Cover(circle, 2, georef);
+  result += !(hashc.size() < hash.size());
+  // Cells intersecting the circle plus a few close to its boundary
+  result += !(hash.size() > 2000 && hash.size() < 3000);
+  sort(hash.begin(), hash.end()); sort(hashc.begin(), hashc.end());
+  sort(gars.begin(), gars.end()); sort(georef.begin(), georef.end());
+  for (int i = 0; i < 2000; ++i) {
+    T lat, lon;
+    g.Direct(lat0, lon0, T(i) * 37 * 360 / 2000,
+             r * sqrt((T(i % 100) + T(0.5)) / 100), lat, lon);
+    string code;
+    Geohash::Forward(lat, lon, 6, code);
+    result += !binary_search(hash.begin(), hash.end(), code);
+    bool found = false;
+    for (int len = 1; len <= 6 && !found; ++len)
+      found = binary_search(hashc.begin(), hashc.end(), code.substr(0, len));
+    result += !found;
+    GARS::Forward(lat, lon, 2, code);
+    result += !binary_search(gars.begin(), gars.end(), code);
+    Georef::Forward(lat, lon, 2, code);
+    result += !binary_search(georef.begin(), georef.end(), code);
+  }
+  Geohash::Cover(polygon, 5, hash);
+  sort(hash.begin(), hash.end());
+  for (int i = 0; i < 100; ++i) {
+    for (int j = 0; j < 100; ++j) {
+      T lat = T(47.9) + T(i) * T(1.7) / 100,
+        lon = T(0.9) + T(j) * T(2.7) / 100;
+      if (!pip.Contains(lat, lon)) continue;
+      string code;
+      Geohash::Forward(lat, lon, 5, code);
+      result += !binary_search(hash.begin(), hash.end(), code);
+    }
+  }
+  return result;
+}
+
+static int testgridlines() {
+  // The grid lines lie in their zones and the viewport and the points have
+  // the right eastings and northings; the viewport includes the Norway
+  // exception and the equator.
+  int result = 0;
+  GridLines grid(-2, 64, 2, 10, GridLines::projection(), T(0.001));
+  vector<GridLines::Line> lines;
+  grid.UTM(100000, lines);
+  int nzone[61] = {0};
+  bool south = false;
+  for (const GridLines::Line& l : lines) {
+    ++nzone[l.zone];
+    if (l.type == GridLines::NORTHING && !l.northp) south = true;
+    result += !(l.lat.size() >= 2);
+    for (size_t i = 0; i < l.lat.size(); ++i) {
+      int zone; bool northp; T x, y;
+      UTMUPS::Forward(l.lat[i], l.lon[i], zone, northp, x, y);
+      result += zone != l.zone;
+      result += !(l.lat[i] >= -2 && l.lat[i] <= 64 &&
+                  l.lon[i] >= 2 && l.lon[i] <= 10);
+      result += l.x[i] != l.lon[i] || l.y[i] != l.lat[i];
+      if (l.type == GridLines::EASTING)
+        result += checkEquals(x, l.value, T(1e-6));
+      else {
+        result += northp != l.northp;
+        result += checkEquals(y, l.value, T(1e-6));
+      }
+    }
+  }
+  result += !(nzone[31] > 0 && nzone[32] > 0 && nzone[33] == 0);
+  result += !south;
+  grid.Graticule(1, 1, lines);
+  // 9 meridians and 67 parallels
+  result += lines.size() != 76;
+  // Across the antimeridian
+  GridLines grid2(-10, 10, 175, -170);
+  grid2.UTM(500000, lines);
+  for (const GridLines::Line& l : lines)
+    result += !(l.zone == 60 || l.zone == 1 || l.zone == 2);
+  return result;
+}
+
+static int testpolygonreader() {
+  // Binary WKB: a little-endian polygon, a big-endian EWKB polygon with Z
+  // and an SRID, and a point; compare with adding the vertices.
+  int result = 0;
+  auto u32 = [](string& b, unsigned x, bool little) -> void {
+    for (int k = 0; k < 4; ++k)
+      b += char((x >> (8 * (little ? k : 3 - k))) & 0xffu);
+  };
+  auto f64 = [](string& b, double x, bool little) -> void {
+    unsigned char c[8];
+    memcpy(c, &x, 8);
+    const unsigned one = 1;
+    bool host = *reinterpret_cast<const unsigned char*>(&one) == 1;
+    for (int k = 0; k < 8; ++k)
+      b += char(c[little == host ? k : 7 - k]);
+  };
+  const double plat[] = {-1, 0, 1, 0, -1}, plon[] = {0, 1, 0, -1, 0};
+  string b;
+  for (int g = 0; g < 2; ++g) {
+    bool little = g == 0;
+    b += char(little ? 1 : 0);
+    u32(b, little ? 3u : 0xa0000003u, little);
+    if (!little) u32(b, 4326, little);
+    u32(b, 1, little); u32(b, 5, little);
+    for (int i = 0; i < 5; ++i) {
+      f64(b, plon[i], little); f64(b, plat[i], little);
+      if (!little) f64(b, 100, little);
+    }
+  }
+  b += char(1); u32(b, 1, true); f64(b, 1, true); f64(b, 2, true);
+  istringstream in(b);
+  PolygonReader reader(in, PolygonReader::WKB);
+  vector<size_t> polyoffsets(1, 0), ringoffsets(1, 0);
+  vector<T> lat, lon;
+  while (reader.Next(ringoffsets, lat, lon))
+    polyoffsets.push_back(ringoffsets.size() - 1);
+  result += reader.Count() != 3;
+  result += polyoffsets.size() != 4 || ringoffsets.size() != 3;
+  result += lat.size() != 8;
+  PolygonArea poly(Geodesic::WGS84());
+  for (int i = 0; i < 4; ++i) poly.AddPoint(plat[i], plon[i]);
+  T perimeter, area;
+  poly.Compute(false, true, perimeter, area);
+  T p[3], a[3];
+  poly.ComputeBatch(3, polyoffsets.data(), ringoffsets.data(),
+                    lat.data(), lon.data(), false, true, p, a, 1);
+  for (int i = 0; i < 2; ++i) {
+    result += checkEquals(p[i], perimeter, 0);
+    result += checkEquals(a[i], area, 0);
+  }
+  result += p[2] != 0 || a[2] != 0;
+  // Truncated input
+  istringstream trunc(b.substr(0, 20));
+  PolygonReader reader2(trunc, PolygonReader::WKB);
+  try {
+    reader2.Next(ringoffsets, lat, lon);
+    ++result;
+  }
+  catch (const GeographicErr&) {}
+  return result;
+}
+
+static int testdirectfan() {
+  // Geodesic::DirectFan and GeodesicBatchExecutor::DirectFan agree exactly
+  // with Geodesic::GenDirect.
+  const Geodesic& g = Geodesic::WGS84();
+  const int na = 37, nd = 5;
+  const T lat1 = 40.6, lon1 = -73.8;
+  T azi1[na], s12[nd] = {0, 1e3, 1e5, 1e7, 2e7};
+  for (int i = 0; i < na; ++i) azi1[i] = T(10 * i - 180);
+  const int n = na * nd;
+  vector<T> a12(n), lat2(n), lon2(n), azi2(n), m12(n), S12(n),
+    lat2b(n), lon2b(n), S12b(n);
+  const unsigned outmask = Geodesic::ALL | Geodesic::LONG_UNROLL;
+  g.DirectFan(lat1, lon1, na, azi1, nd, false, s12, outmask,
+              a12.data(), lat2.data(), lon2.data(), azi2.data(), nullptr,
+              m12.data(), nullptr, nullptr, S12.data());
+  GeodesicBatchExecutor(4).DirectFan(g, lat1, lon1, na, azi1, nd, false, s12,
+                                     outmask, nullptr, lat2b.data(),
+                                     lon2b.data(), nullptr, nullptr, nullptr,
+                                     nullptr, nullptr, S12b.data());
+  int result = 0;
+  for (int i = 0; i < na; ++i)
+    for (int j = 0; j < nd; ++j) {
+      int k = i * nd + j;
+      T lat2a, lon2a, azi2a, s12a, m12a, M12a, M21a, S12a,
+        a12a = g.GenDirect(lat1, lon1, azi1[i], false, s12[j], outmask,
+                           lat2a, lon2a, azi2a, s12a, m12a, M12a, M21a,
+                           S12a);
+      result += checkSame(a12[k], a12a);
+      result += checkSame(lat2[k], lat2a);
+      result += checkSame(lon2[k], lon2a);
+      result += checkSame(azi2[k], azi2a);
+      result += checkSame(m12[k], m12a);
+      result += checkSame(S12[k], S12a);
+      result += checkSame(lat2b[k], lat2a);
+      result += checkSame(lon2b[k], lon2a);
+      result += checkSame(S12b[k], S12a);
+    }
+  return result;
+}
+
+static int testgeodesiclinecompact() {
+  // A GeodesicLineCompact reproduces its GeodesicLine exactly.
+  const Geodesic& g = Geodesic::WGS84();
+  GeodesicLine l = g.InverseLine(40.6, -73.8, 1.4, 103.9),
+    l1(g, -30, 0, 45, GeodesicLine::LATITUDE | GeodesicLine::DISTANCE_IN);
+  GeodesicLineCompact c(g, l),
+    c1(g, -30, 0, 45, GeodesicLine::LATITUDE | GeodesicLine::DISTANCE_IN);
+  int result = 0;
+  result += sizeof(c) >= sizeof(l) / 4;
+  result += checkSame(c.Distance(), l.Distance());
+  result += checkSame(c.Arc(), l.Arc());
+  result += checkSame(c.Line().Distance(), l.Distance());
+  result += c.Capabilities() != l.Capabilities();
+  for (int i = 0; i <= 10; ++i) {
+    T s = l.Distance() * i / 10, lat2, lon2, azi2, s12, m12, M12, M21, S12,
+      lat2a, lon2a, azi2a, s12a, m12a, M12a, M21a, S12a,
+      a12 = l.GenPosition(false, s, Geodesic::ALL, lat2, lon2, azi2,
+                          s12, m12, M12, M21, S12),
+      a12a = c.GenPosition(false, s, Geodesic::ALL, lat2a, lon2a, azi2a,
+                           s12a, m12a, M12a, M21a, S12a);
+    result += checkSame(a12a, a12);
+    result += checkSame(lat2a, lat2);
+    result += checkSame(lon2a, lon2);
+    result += checkSame(azi2a, azi2);
+    result += checkSame(m12a, m12);
+    result += checkSame(M21a, M21);
+    result += checkSame(S12a, S12);
+    l1.Position(s, lat2, lon2);
+    lat2a = 0; lon2a = 0;
+    c1.Position(s, lat2a, lon2a);
+    result += checkSame(lat2a, lat2);
+    // c1 doesn't have the LONGITUDE capability
+    result += lon2a != 0;
+  }
+  c1.SetDistance(1e6);
+  l1.SetDistance(1e6);
+  result += checkSame(c1.Arc(), l1.Arc());
+  T lat2, lon2;
+  result += !isnan(GeodesicLineCompact().Position(1e6, lat2, lon2));
+  try {
+    GeodesicLineCompact c2(Geodesic(6.4e6, 0), l);
+    ++result;
+  }
+  catch (const GeographicErr&) {}
+  return result;
+}
+
+static int testantipodal() {
+  // Nearly antipodal points for which InverseStart now uses the astroid
+  // estimate (it previously used the spherical one); compare Geodesic with
+  // GeodesicExact.
+  const Geodesic& g = Geodesic::WGS84();
+  const GeodesicExact& ge = GeodesicExact::WGS84();
+  int result = 0;
+  for (int i = 0; i < 9; ++i) {
+    T lat1 = T(10 * i + 1), lat2 = -lat1 + T(i % 3 - 1) * 3,
+      lon2 = 180 - T(1 + i % 4) * 2,
+      s12, azi1, azi2, s12e, azi1e, azi2e;
+    g.Inverse(lat1, 0, lat2, lon2, s12, azi1, azi2);
+    ge.Inverse(lat1, 0, lat2, lon2, s12e, azi1e, azi2e);
+    result += checkEquals(s12, s12e, T(5e-8));
+    result += checkEquals(azi1, azi1e, T(1e-11));
+    result += checkEquals(azi2, azi2e, T(1e-11));
+  }
+  return result;
+}
+
+static int testclosestapproach() {
+  ClosestApproach ca;
+  int result = 0;
+  {
+    // The example in develop/ClosestApproach.cpp: planes leave Istanbul and
+    // Reykjavik at the same time (t in hours, v in meters per hour).
+    T t, d = ca.Pair(42, 29, -51, 900e3, 64, -22, 154, 800e3, 10, t);
+    result += checkEquals(t, T(2.718941), T(1e-6));
+    result += checkEquals(d, T(1082700), T(1));
+    // The closest approach is at the end of a shorter interval
+    d = ca.Pair(42, 29, -51, 900e3, 64, -22, 154, 800e3, 2, t);
+    result += checkEquals(t, 2, 0);
+    // Diverging objects are closest at the start
+    T s12;
+    Geodesic::WGS84().Inverse(42, 29, 64, -22, s12);
+    d = ca.Pair(42, 29, 129, 900e3, 64, -22, -26, 800e3, 10, t);
+    result += checkEquals(t, 0, 0);
+    result += checkEquals(d, s12, T(1e-6));
+  }
+  {
+    // Compare Tracks with all the pairs
+    const size_t n = 60;
+    const T tmax = 1, R = 5e3;
+    vector<T> lat(n), lon(n), azi(n), v(n);
+    for (size_t i = 0; i < n; ++i) {
+      lat[i] = 50 + T((i * 37) % 101) / 100;
+      lon[i] = 10 + T((i * 53) % 103) / 60;
+      azi[i] = T((i * 97) % 360);
+      v[i] = T(20e3 + (i * 71) % 400 * 1e2);
+    }
+    vector<ClosestApproach::Encounter> e1, e3;
+    ca.Tracks(n, lat.data(), lon.data(), azi.data(), v.data(), tmax, R, e1, 1);
+    ca.Tracks(n, lat.data(), lon.data(), azi.data(), v.data(), tmax, R, e3, 3);
+    size_t k = 0;
+    for (size_t i = 0; i < n; ++i)
+      for (size_t j = i + 1; j < n; ++j) {
+        T t, d = ca.Pair(lat[i], lon[i], azi[i], v[i],
+                         lat[j], lon[j], azi[j], v[j], tmax, t);
+        if (!(d <= R)) continue;
+        if (k < e1.size()) {
+          result += e1[k].i == i && e1[k].j == j ? 0 : 1;
+          result += checkEquals(e1[k].t, t, 0);
+          result += checkEquals(e1[k].d, d, 0);
+        }
+        ++k;
+      }
+    result += k == e1.size() && k > 0 ? 0 : 1;
+    result += e3.size() == e1.size() ? 0 : 1;
+    for (size_t m = 0; m < e1.size() && m < e3.size(); ++m)
+      result += e1[m].i == e3[m].i && e1[m].j == e3[m].j &&
+        e1[m].d == e3[m].d ? 0 : 1;
+    try {
+      ca.Tracks(n, lat.data(), lon.data(), azi.data(), v.data(), -1, R, e1);
+      ++result;
+    }
+    catch (const GeographicErr&) {}
+  }
+  return result;
+}
+
+static int testgeodesicbuffer() {
+  const Geodesic& g = Geodesic::WGS84();
+  GeodesicBuffer buffer(g);
+  ClosestPoint cp(g);
+  const T R = 1000, ds = 20;
+  int result = 0;
+  auto area = [&g](const vector<T>& lat, const vector<T>& lon) -> T {
+    PolygonArea poly(g);
+    for (size_t i = 0; i < lat.size(); ++i) poly.AddPoint(lat[i], lon[i]);
+    T perimeter, a;
+    poly.Compute(false, true, perimeter, a);
+    return a;
+  };
+  // Check that the vertices of the outline are at a distance R from the
+  // path; the joins are slightly closer.
+  auto check = [&cp, R, ds](const vector<T>& blat, const vector<T>& blon,
+                            vector<T> lat, vector<T> lon) -> int {
+    size_t n = blat.size();
+    vector<size_t> seg(n);
+    vector<T> x(n), d(n);
+    cp.Polyline(n, blat.data(), blon.data(), lat.size(),
+                lat.data(), lon.data(), seg.data(), x.data(), d.data(), 2);
+    int r = n > 0 ? 0 : 1;
+    for (size_t i = 0; i < n; ++i)
+      r += d[i] <= R + T(1e-6) && d[i] >= R - ds * ds / (4 * R) ? 0 : 1;
+    return r;
+  };
+  vector<T> blat, blon;
+  {
+    // A square; its buffer has area A + P * R + pi * R^2
+    vector<T> lat = {50, 50, T(50.1), T(50.1)},
+      lon = {10, T(10.1), T(10.1), 10};
+    PolygonArea poly(g);
+    for (size_t i = 0; i < 4; ++i) poly.AddPoint(lat[i], lon[i]);
+    T P, A;
+    poly.Compute(false, true, P, A);
+    buffer.Polygon(4, lat.data(), lon.data(), R, ds, blat, blon);
+    T a = area(blat, blon);
+    result += checkEquals(a / (A + P * R + Math::pi() * R * R), 1, T(1e-5));
+    lat.push_back(lat[0]); lon.push_back(lon[0]);
+    result += check(blat, blon, lat, lon);
+    // Clockwise with a closing vertex gives the same outline
+    vector<T> blat1, blon1;
+    reverse(lat.begin(), lat.end()); reverse(lon.begin(), lon.end());
+    buffer.Polygon(5, lat.data(), lon.data(), R, ds, blat1, blon1);
+    result += checkEquals(area(blat1, blon1), a, T(1e-3));
+  }
+  {
+    // A polyline with a right-angle turn.  The convex side of the corner
+    // gains a quarter circle and the concave side loses a square.
+    vector<T> lat = {50, T(50.1), T(50.1)}, lon = {10, 10, T(10.2)};
+    T s1, s2;
+    g.Inverse(lat[0], lon[0], lat[1], lon[1], s1);
+    g.Inverse(lat[1], lon[1], lat[2], lon[2], s2);
+    buffer.Polyline(3, lat.data(), lon.data(), R, ds, blat, blon);
+    result += checkEquals(area(blat, blon) /
+                          (2 * R * (s1 + s2) + Math::pi() * R * R +
+                           (Math::pi() / 4 - 1) * R * R), 1, T(1e-4));
+    result += check(blat, blon, lat, lon);
+    // A narrow U, the buffers of whose arms overlap
+    lat = {T(50.1), 50, 50, T(50.1)}; lon = {10, 10, T(10.02), T(10.02)};
+    buffer.Polyline(4, lat.data(), lon.data(), R, ds, blat, blon);
+    result += check(blat, blon, lat, lon);
+  }
+  {
+    // A single point gives a geodesic circle
+    T lat = 50, lon = 10;
+    buffer.Polyline(1, &lat, &lon, R, ds, blat, blon);
+    result += checkEquals(area(blat, blon) / (Math::pi() * R * R), 1,
+                          T(1e-4));
+    result += check(blat, blon, vector<T>(1, lat), vector<T>(1, lon));
+    try {
+      buffer.Polyline(1, &lat, &lon, 0, ds, blat, blon);
+      ++result;
+    }
+    catch (const GeographicErr&) {}
+  }
+  return result;
+}
+
+static int testspatialjoin() {
+  // A 10 x 10 grid of squares straddling the antimeridian; square 55 has a
+  // hole and the last polygon overlaps squares 0, 1, 10, and 11.
+  const Geodesic& g = Geodesic::WGS84();
+  const int N = 10;
+  const T d = 1;
+  vector<size_t> polyoffsets(1, 0), ringoffsets(1, 0);
+  vector<T> lat, lon;
+  auto ring = [&](T lat0, T lon0, T h) -> void {
+    T dlat[] = {0, 0, h, h}, dlon[] = {0, h, h, 0};
+    for (int k = 0; k < 4; ++k) {
+      lat.push_back(lat0 + dlat[k]);
+      lon.push_back(Math::AngNormalize(lon0 + dlon[k]));
+    }
+    ringoffsets.push_back(lat.size());
+  };
+  for (int i = 0; i < N; ++i)
+    for (int j = 0; j < N; ++j) {
+      ring(10 + i * d, 175 + j * d, d);
+      if (i == 5 && j == 5) ring(10 + i * d + d/4, 175 + j * d + d/4, d/2);
+      polyoffsets.push_back(ringoffsets.size() - 1);
+    }
+  ring(10 + d/2, 175 + d/2, d);
+  polyoffsets.push_back(ringoffsets.size() - 1);
+  size_t np = polyoffsets.size() - 1;
+  SpatialJoin join(g, np, polyoffsets.data(), ringoffsets.data(),
+                   lat.data(), lon.data(), 2);
+  int result = 0;
+  result += join.NumPolygons() == np && join.NumRings() == np + 1 ? 0 : 1;
+  // Brute force
+  vector<PointInPolygon> rings;
+  for (size_t i = 0; i + 1 < ringoffsets.size(); ++i)
+    rings.push_back(PointInPolygon(g, ringoffsets[i + 1] - ringoffsets[i],
+                                   lat.data() + ringoffsets[i],
+                                   lon.data() + ringoffsets[i], 1));
+  const size_t n = 2000;
+  vector<T> plat(n), plon(n);
+  vector<size_t> id1(n), id3(n);
+  for (size_t k = 0; k < n; ++k) {
+    plat[k] = 9 + T((k * 7919) % 12000) / 1000;
+    plon[k] = Math::AngNormalize(174 + T((k * 6271) % 12007) / 1000);
+  }
+  join.FindBatch(n, plat.data(), plon.data(), id1.data(), 1);
+  join.FindBatch(n, plat.data(), plon.data(), id3.data(), 3);
+  size_t nin = 0;
+  for (size_t k = 0; k < n; ++k) {
+    size_t id = SpatialJoin::npos;
+    for (size_t j = 0; j < np && id == SpatialJoin::npos; ++j) {
+      bool inside = false;
+      for (size_t i = polyoffsets[j]; i < polyoffsets[j + 1]; ++i)
+        if (rings[i].Contains(plat[k], plon[k])) inside = !inside;
+      if (inside) id = j;
+    }
+    if (id != SpatialJoin::npos) ++nin;
+    result += id1[k] == id && id3[k] == id &&
+      join.Find(plat[k], plon[k]) == id ? 0 : 1;
+  }
+  result += nin > n / 2 && nin < n ? 0 : 1;
+  // The hole, the overlap, and a point outside
+  result += join.Find(15 + d/2, Math::AngNormalize(180 + d/2)) ==
+    SpatialJoin::npos ? 0 : 1;
+  result += join.Find(15 + d/8, Math::AngNormalize(180 + d/8)) == 55 ? 0 : 1;
+  result += join.Find(10 + 7*d/8, 175 + 7*d/8) == 0 ? 0 : 1;
+  result += join.Find(11 + d/8, 176 + d/8) == 11 ? 0 : 1;
+  result += join.Find(-10, 0) == SpatialJoin::npos ? 0 : 1;
+  // The bounding box of a ring straddling the antimeridian
+  T latmin, latmax, lonmin, lonmax;
+  rings[9].BoundingBox(latmin, latmax, lonmin, lonmax);
+  result += checkEquals(lonmin, 184 - Math::td, 0);
+  result += checkEquals(lonmax - lonmin, d, 0);
+  result += checkEquals(latmin, 10, T(1e-12));
+  result += latmax > 10 + d && latmax < 10 + d + T(0.01) ? 0 : 1;
+  return result;
+}
+
+static int testhilbertorder() {
+  // The centers of the cells of a 64 x 64 grid in latitude and longitude,
+  // shuffled, followed by a NaN and a repeat of the first point.
+  const int m = 64;
+  const size_t n = m * m + 2;
+  vector<T> lat(n), lon(n);
+  for (size_t k = 0; k < n - 2; ++k) {
+    size_t c = (k * 1237) % (n - 2);
+    lat[k] = -90 + 180 * (T(c / m) + T(0.5)) / m;
+    lon[k] = -180 + 360 * (T(c % m) + T(0.5)) / m + (k % 3 ? 0 : 720);
+  }
+  lat[n - 2] = Math::NaN(); lon[n - 2] = 0;
+  lat[n - 1] = lat[0]; lon[n - 1] = lon[0];
+  vector<size_t> perm(n);
+  GeodesicBatchExecutor::HilbertOrder(n, lat.data(), lon.data(),
+                                      perm.data());
+  int result = 0;
+  vector<int> seen(n, 0);
+  for (size_t k = 0; k < n; ++k)
+    if (perm[k] < n) ++seen[perm[k]];
+  for (size_t k = 0; k < n; ++k)
+    result += seen[k] == 1 ? 0 : 1;
+  result += perm[n - 1] == n - 2 ? 0 : 1;
+  // Consecutive cells along the curve are neighbors and the repeated point
+  // comes straight after the original.
+  int adjacent = 0, ix0 = 0, iy0 = 0;
+  for (size_t k = 0; k + 1 < n; ++k) {
+    size_t i = perm[k];
+    int ix = int(floor((Math::AngNormalize(lon[i]) + 180) * m / 360)),
+      iy = int(floor((lat[i] + 90) * m / 180));
+    if (k > 0 && abs(ix - ix0) + abs(iy - iy0) == 1) ++adjacent;
+    if (i == 0)
+      result += perm[k + 1] == n - 1 ? 0 : 1;
+    ix0 = ix; iy0 = iy;
+  }
+  // The curve passes through all m * m cells
+  result += adjacent == m * m - 1 ? 0 : 1;
+  // ForEachLocal visits each point once and the results come out in the
+  // original order.
+  vector<T> h(n, Math::NaN());
+  GeodesicBatchExecutor exec(3, 100);
+  exec.ForEachLocal(n, lat.data(), lon.data(),
+                    [&](size_t k, const size_t idx[]) -> void {
+                      for (size_t j = 0; j < k; ++j)
+                        h[idx[j]] = 2 * lat[idx[j]];
+                    });
+  for (size_t k = 0; k < n - 2; ++k)
+    result += h[k] == 2 * lat[k] ? 0 : 1;
+  return result;
+}
+
+static int testscheduler() {
+  // A scheduler which runs the workers in reverse order on the calling
+  // thread (like a pool with no free threads) must give the same results.
+  unsigned nworkers = 0;
+  GeodesicBatchExecutor::SetScheduler
+    ([&nworkers](unsigned n, const function<void(unsigned)>& work) -> void {
+      for (unsigned k = n; k-- > 0;) {
+        ++nworkers;
+        work(k);
+      }
+    }, 3);
+  int result = 0;
+  result += GeodesicBatchExecutor().NumThreads() == 3 ? 0 : 1;
+  const Geodesic& g = Geodesic::WGS84();
+  const size_t n = 500;
+  vector<T> lat1(n), lon1(n), lat2(n), lon2(n), s12(n), s12a(n);
+  for (size_t i = 0; i < n; ++i) {
+    lat1[i] = 90 * sin(T(i) * T(0.7)); lon1[i] = 0;
+    lat2[i] = 90 * sin(T(i) * T(1.3) + 1);
+    lon2[i] = remainder(T(i) * T(37.1), T(360));
+  }
+  g.InverseBatch(n, lat1.data(), lon1.data(), lat2.data(), lon2.data(),
+                 Geodesic::DISTANCE, nullptr, s12.data(), nullptr, nullptr,
+                 nullptr, nullptr, nullptr, nullptr);
+  GeodesicBatchExecutor exec(0, 16);
+  exec.Inverse(g, n, lat1.data(), lon1.data(), lat2.data(), lon2.data(),
+               Geodesic::DISTANCE, nullptr, s12a.data(), nullptr, nullptr,
+               nullptr, nullptr, nullptr, nullptr);
+  result += s12 == s12a && nworkers == 3 ? 0 : 1;
+  // Exceptions still reach the caller.
+  bool thrown = false;
+  try {
+    exec.ForEach(n, [](size_t i0, size_t) -> void {
+      if (i0 >= 100) throw GeographicErr("test");
+    });
+  }
+  catch (const GeographicErr&) {
+    thrown = true;
+  }
+  result += thrown ? 0 : 1;
+  GeodesicBatchExecutor::SetScheduler();
+  unsigned hc = thread::hardware_concurrency();
+  result += GeodesicBatchExecutor().NumThreads() == (hc ? hc : 1) ? 0 : 1;
+  return result;
+}
+
+static int testcpudispatch() {
+  // Each available instruction set gives the same results.  (Only g++
+  // turns off the fused multiply-add of AVX-512.)
+#if defined(__clang__)
+  const T eps = 100 * numeric_limits<T>::epsilon();
+#else
+  const T eps = 0;
+#endif
+  int result = 0;
+  CPUDispatch::isa best = CPUDispatch::Detected();
+  result += CPUDispatch::Available(CPUDispatch::BASELINE) &&
+    CPUDispatch::Selected() == best ? 0 : 1;
+  const TransverseMercator& tm = TransverseMercator::UTM();
+  const Geocentric& ec = Geocentric::WGS84();
+  const int N = 12;
+  vector<T> C((N + 1) * (N + 2) / 2), S(C.size());
+  for (size_t j = 0; j < C.size(); ++j) {
+    C[j] = 1 / T(j + 1); S[j] = 1 / T(2 * j + 3);
+  }
+  SphericalHarmonic sh(C, S, N, Constants::WGS84_a());
+  const size_t n = 101, m = 8 * n;
+  vector<T> lat(n), lon(n), h(n, 100), out0(m), out(m);
+  for (size_t i = 0; i < n; ++i) {
+    lat[i] = 80 * sin(T(i)); lon[i] = 3 + 5 * cos(T(i) * T(1.3));
+  }
+  for (int i = int(best); i >= 0; --i) {
+    CPUDispatch::Select(CPUDispatch::isa(i));
+    T* o = i == int(best) ? out0.data() : out.data();
+    tm.ForwardBatch(n, 3, lat.data(), lon.data(), o, o + n);
+    ec.ForwardBatch(n, lat.data(), lon.data(), h.data(),
+                    o + 2*n, o + 3*n, o + 4*n);
+    sh.ValueBatch(n, o + 2*n, o + 3*n, o + 4*n, o + 5*n);
+    tm.TransferBatch(n, 3, o, o + n, 9, o + 6*n, o + 7*n);
+    if (o == out.data())
+      for (size_t j = 0; j < m; ++j)
+        result += checkEquals(out[j], out0[j], eps * fabs(out0[j]));
+  }
+  // An unavailable instruction set is rejected.
+  if (best != CPUDispatch::AVX512) {
+    bool thrown = false;
+    try { CPUDispatch::Select(CPUDispatch::AVX512); }
+    catch (const GeographicErr&) { thrown = true; }
+    result += thrown ? 0 : 1;
+  }
+  result += CPUDispatch::Name(CPUDispatch::AVX2) == "avx2" ? 0 : 1;
+  CPUDispatch::Select(best);
+  return result;
+}
+
+static int testdeadline() {
+  const Geodesic& g = Geodesic::WGS84();
+  const size_t n = 5000, chunk = 100;
+  vector<T> lat1(n), lon1(n, 0), lat2(n), lon2(n), s12(n), s12a(n);
+  for (size_t i = 0; i < n; ++i) {
+    lat1[i] = 90 * sin(T(i) * T(0.7));
+    lat2[i] = 90 * sin(T(i) * T(1.3) + 1);
+    lon2[i] = remainder(T(i) * T(37.1), T(360));
+  }
+  g.InverseBatch(n, lat1.data(), lon1.data(), lat2.data(), lon2.data(),
+                 Geodesic::DISTANCE, nullptr, s12.data(), nullptr, nullptr,
+                 nullptr, nullptr, nullptr, nullptr);
+  auto inverse = [&](const GeodesicBatchExecutor& exec) -> size_t {
+    fill(s12a.begin(), s12a.end(), Math::NaN());
+    return exec.Inverse(g, n, lat1.data(), lon1.data(),
+                        lat2.data(), lon2.data(), Geodesic::DISTANCE,
+                        nullptr, s12a.data(), nullptr, nullptr,
+                        nullptr, nullptr, nullptr, nullptr);
+  };
+  int result = 0;
+  for (unsigned nthreads = 1; nthreads <= 3; ++nthreads) {
+    GeodesicBatchExecutor exec(nthreads, chunk);
+    atomic<bool> cancel(false);
+    // A deadline in the future and an unset flag don't stop the calls.
+    exec.SetDeadline(chrono::steady_clock::now() + chrono::hours(1));
+    exec.SetCancel(&cancel);
+    result += inverse(exec) == n && s12a == s12 ? 0 : 1;
+    // The flag is set part of the way through; the completed elements are
+    // a whole number of leading chunks.
+    size_t m = exec.ForEach(n, [&](size_t i0, size_t i1) -> void {
+      g.InverseBatch(i1 - i0, lat1.data() + i0, lon1.data() + i0,
+                     lat2.data() + i0, lon2.data() + i0, Geodesic::DISTANCE,
+                     nullptr, s12a.data() + i0, nullptr, nullptr,
+                     nullptr, nullptr, nullptr, nullptr);
+      if (i1 >= n / 2) cancel = true;
+    });
+    result += m % chunk == 0 && m >= n / 2 && m < n ? 0 : 1;
+    for (size_t i = 0; i < m; ++i)
+      result += s12a[i] == s12[i] ? 0 : 1;
+    // The flag is still set.
+    result += inverse(exec) == 0 && isnan(s12a[0]) ? 0 : 1;
+    cancel = false;
+    // A deadline in the past.
+    exec.SetDeadline(chrono::steady_clock::now());
+    result += inverse(exec) == 0 ? 0 : 1;
+    exec.SetDeadline();
+    exec.SetCancel();
+    result += inverse(exec) == n && s12a == s12 ? 0 : 1;
+  }
+  return result;
+}
+
+static int teststridedview() {
+  // The GeoArrow interleaved layout: (lon, lat) pairs
+  typedef StridedView<const T> cview;
+  typedef StridedView<T> view;
+  const Geodesic& g = Geodesic::WGS84();
+  const size_t n = 50;
+  vector<T> xy(2 * n), lat(n), lon(n);
+  for (size_t i = 0; i < n; ++i) {
+    lat[i] = xy[2*i+1] = 60 * sin(T(i) * T(0.7));
+    lon[i] = xy[2*i] = remainder(T(i) * T(37.1), T(360));
+  }
+  cview clat = cview::Interleaved(xy.data(), 2, 1),
+    clon = cview::Interleaved(xy.data(), 2, 0);
+  int result = 0;
+  // Distances and azimuths between consecutive points; the results are
+  // written interleaved.
+  vector<T> s12(n - 1), azi1(n - 1), res(2 * (n - 1));
+  g.InverseBatch(n - 1, lat.data(), lon.data(), lat.data() + 1,
+                 lon.data() + 1, Geodesic::DISTANCE | Geodesic::AZIMUTH,
+                 nullptr, s12.data(), azi1.data(), nullptr,
+                 nullptr, nullptr, nullptr, nullptr);
+  g.InverseBatch(n - 1, clat, clon, clat + 1, clon + 1,
+                 Geodesic::DISTANCE | Geodesic::AZIMUTH, nullptr,
+                 view::Interleaved(res.data(), 2, 0),
+                 view::Interleaved(res.data(), 2, 1), nullptr,
+                 nullptr, nullptr, nullptr, nullptr);
+  for (size_t i = 0; i + 1 < n; ++i)
+    result += res[2*i] == s12[i] && res[2*i+1] == azi1[i] ? 0 : 1;
+  // Back again in place, with a negative stride for the azimuths
+  vector<T> out(2 * (n - 1));
+  g.DirectBatch(n - 1, clat, clon, cview(azi1.data() + n - 2, -1), false,
+                cview(s12.data() + n - 2, -1),
+                Geodesic::LATITUDE | Geodesic::LONGITUDE, nullptr,
+                view::Interleaved(out.data(), 2, 1),
+                view::Interleaved(out.data(), 2, 0), nullptr, nullptr,
+                nullptr, nullptr, nullptr, nullptr);
+  for (size_t i = 0; i + 1 < n; ++i) {
+    T lat2, lon2;
+    g.Direct(lat[i], lon[i], azi1[n - 2 - i], s12[n - 2 - i], lat2, lon2);
+    result += out[2*i+1] == lat2 && out[2*i] == lon2 ? 0 : 1;
+  }
+  // UTM coordinates overwriting the geographic ones
+  vector<int> zone(n), zone1(n);
+  unique_ptr<bool[]> northp(new bool[n]), northp1(new bool[n]);
+  vector<T> x(n), y(n), buf(xy);
+  UTMUPS::ForwardBatch(n, lat.data(), lon.data(), zone.data(), northp.get(),
+                       x.data(), y.data());
+  UTMUPS::ForwardBatch(n, cview::Interleaved(buf.data(), 2, 1),
+                       cview::Interleaved(buf.data(), 2, 0),
+                       zone1.data(), northp1.get(),
+                       view::Interleaved(buf.data(), 2, 0),
+                       view::Interleaved(buf.data(), 2, 1));
+  for (size_t i = 0; i < n; ++i)
+    result += buf[2*i] == x[i] && buf[2*i+1] == y[i] &&
+      zone1[i] == zone[i] && northp1[i] == northp[i] ? 0 : 1;
+  // Two polygons taken from the interleaved buffer
+  PolygonArea poly(g);
+  size_t offsets[] = {0, 20, n};
+  T perim[2], area[2], pa[4];
+  poly.ComputeBatch(2, offsets, lat.data(), lon.data(), false, true,
+                    perim, area, 1);
+  poly.ComputeBatch(2, offsets, clat, clon, false, true,
+                    view::Interleaved(pa, 2, 0), view::Interleaved(pa, 2, 1),
+                    1);
+  for (int i = 0; i < 2; ++i)
+    result += pa[2*i] == perim[i] && pa[2*i+1] == area[i] ? 0 : 1;
+  return result;
+}
+
+static int testgeocentricfast() {
+  // ReverseFast agrees with Reverse to within 2 um horizontally and 10 nm
+  // vertically for |h| < 100 km; points near the center use Reverse.
+  const Geocentric& ec = Geocentric::WGS84();
+  const T eps = numeric_limits<T>::epsilon(),
+    angtol = fmax(T(3e-11), 100 * eps * 90),
+    htol = fmax(T(1e-8), 100 * eps * Constants::WGS84_a()),
+    mtol = fmax(T(1e-12), 1000 * eps);
+  const size_t n = 203;
+  vector<T> X(n), Y(n), Z(n), lat(n), lon(n), h(n), M(9 * n);
+  for (size_t i = 0; i < n; ++i) {
+    T h0 = i < n - 3 ? T(1e5) * sin(T(i) * T(1.7)) : -T(5e6) - T(i);
+    ec.Forward(90 * sin(T(i)), 180 * cos(T(i) * T(0.3)), h0,
+               X[i], Y[i], Z[i]);
+  }
+  int result = 0;
+  ec.ReverseFastBatch(n, X.data(), Y.data(), Z.data(),
+                      lat.data(), lon.data(), h.data(), M.data());
+  for (size_t i = 0; i < n; ++i) {
+    T lat0, lon0, h0, lat1, lon1, h1;
+    vector<T> M0(9);
+    ec.Reverse(X[i], Y[i], Z[i], lat0, lon0, h0, M0);
+    ec.ReverseFast(X[i], Y[i], Z[i], lat1, lon1, h1);
+    result += checkSame(lat[i], lat1);
+    result += checkSame(lon[i], lon1);
+    result += checkSame(h[i], h1);
+    if (i < n - 3) {
+      result += checkEquals(lat1, lat0, angtol);
+      result += checkEquals(lon1, lon0, angtol);
+      result += checkEquals(h1, h0, htol);
+    } else {
+      result += checkSame(lat1, lat0);
+      result += checkSame(h1, h0);
+    }
+    for (int k = 0; k < 9; ++k)
+      result += checkEquals(M[9 * i + k], M0[k], mtol);
+  }
+#if GEOGRAPHICLIB_PRECISION != 1
+  vector<float> Xf(n), Yf(n), Zf(n), latf(n), lonf(n), hf(n);
+  for (size_t i = 0; i < n; ++i) {
+    Xf[i] = float(X[i]); Yf[i] = float(Y[i]); Zf[i] = float(Z[i]);
+  }
+  ec.ReverseFastBatch(n, Xf.data(), Yf.data(), Zf.data(),
+                      latf.data(), lonf.data(), hf.data());
+  for (size_t i = 0; i < n; ++i) {
+    T lat1, lon1, h1;
+    ec.ReverseFast(Xf[i], Yf[i], Zf[i], lat1, lon1, h1);
+    result += checkSame(latf[i], float(lat1));
+    result += checkSame(lonf[i], float(lon1));
+    result += checkSame(hf[i], float(h1));
+  }
+#endif
+  return result;
+}
+
+static int testlocalcartesianset() {
+  // The conversions for each origin match LocalCartesian exactly, with the
+  // points for the origins interleaved.
+  const int norig = 5;
+  LocalCartesianSet set;
+  vector<LocalCartesian> lc;
+  for (int k = 0; k < norig; ++k) {
+    T lat0 = 70 * sin(T(k)), lon0 = 150 * cos(T(k)), h0 = T(100 * k);
+    lc.push_back(LocalCartesian(lat0, lon0, h0));
+    if (set.Add(lat0, lon0, h0) != k) return 1;
+  }
+  int result = 0;
+  // Moving an origin only changes that origin
+  set.Reset(2, 10, 20, 30); lc[2].Reset(10, 20, 30);
+  result += set.NumOrigins() == norig &&
+    set.LatitudeOrigin(2) == 10 && set.HeightOrigin(2) == 30 ? 0 : 1;
+  const size_t n = 150;
+  vector<int> id(n);
+  vector<T> lat(n), lon(n), h(n), x(n), y(n), z(n), M(9 * n),
+    lat1(n), lon1(n), h1(n), M1(9 * n);
+  for (size_t i = 0; i < n; ++i) {
+    id[i] = int((i * 7) % norig);
+    lat[i] = lc[id[i]].LatitudeOrigin() + T(0.1) * sin(T(i));
+    lon[i] = lc[id[i]].LongitudeOrigin() + T(0.1) * cos(T(i));
+    h[i] = T(i);
+  }
+  set.ForwardBatch(n, id.data(), lat.data(), lon.data(), h.data(),
+                   x.data(), y.data(), z.data(), M.data());
+  set.ReverseBatch(n, id.data(), x.data(), y.data(), z.data(),
+                   lat1.data(), lon1.data(), h1.data(), M1.data());
+  for (size_t i = 0; i < n; ++i) {
+    const LocalCartesian& l = lc[id[i]];
+    T xa, ya, za, lata, lona, ha;
+    vector<T> Ma(9), M1a(9);
+    l.Forward(lat[i], lon[i], h[i], xa, ya, za, Ma);
+    l.Reverse(xa, ya, za, lata, lona, ha, M1a);
+    result += checkSame(x[i], xa);
+    result += checkSame(y[i], ya);
+    result += checkSame(z[i], za);
+    result += checkSame(lat1[i], lata);
+    result += checkSame(lon1[i], lona);
+    result += checkSame(h1[i], ha);
+    for (int k = 0; k < 9; ++k) {
+      result += checkSame(M[9 * i + k], Ma[k]);
+      result += checkSame(M1[9 * i + k], M1a[k]);
+    }
+    T xs, ys, zs;
+    set.Forward(id[i], lat[i], lon[i], h[i], xs, ys, zs);
+    result += checkSame(xs, xa);
+  }
+#if GEOGRAPHICLIB_PRECISION != 1
+  vector<float> xf(n), yf(n), zf(n);
+  set.ForwardBatch(n, id.data(), lat.data(), lon.data(), h.data(),
+                   xf.data(), yf.data(), zf.data());
+  set.ReverseBatch(n, id.data(), xf.data(), yf.data(), zf.data(),
+                   lat1.data(), lon1.data(), h1.data());
+  for (size_t i = 0; i < n; ++i) {
+    T lata, lona, ha;
+    result += checkSame(xf[i], float(x[i]));
+    lc[id[i]].Reverse(xf[i], yf[i], zf[i], lata, lona, ha);
+    result += checkSame(lat1[i], lata);
+  }
+#endif
+  // A bad origin is rejected before any output is written
+  id[n - 1] = norig;
+  x[0] = 0;
+  try {
+    set.ForwardBatch(n, id.data(), lat.data(), lon.data(), h.data(),
+                     x.data(), y.data(), z.data());
+    ++result;
+  }
+  catch (const GeographicErr&) {}
+  result += x[0] == 0 ? 0 : 1;
+  set.Clear();
+  result += set.NumOrigins() == 0 ? 0 : 1;
+  return result;
+}
+
+static int testrhumbinversefrom() {
+  // Rhumb::InverseFrom from each end point of the test cases (and the poles)
+  // to all the others, with and without the exact series
+  vector<T> lat2(2 * ncases + 2), lon2(2 * ncases + 2);
+  for (int j = 0; j < ncases; ++j) {
+    lat2[2 * j] = testcases[j][0]; lon2[2 * j] = testcases[j][1];
+    lat2[2 * j + 1] = testcases[j][3]; lon2[2 * j + 1] = testcases[j][4];
+  }
+  lat2[2 * ncases] = 90; lon2[2 * ncases] = 10;
+  lat2[2 * ncases + 1] = -90; lon2[2 * ncases + 1] = -20;
+  const size_t n = lat2.size();
+  vector<T> s12(n), azi12(n), S12(n);
+  int result = 0;
+  for (int exact = 0; exact < 2; ++exact) {
+    const Rhumb& rh = Rhumb::Get(Constants::WGS84_a(), Constants::WGS84_f(),
+                                 exact != 0);
+    for (size_t i = 0; i < n; ++i) {
+      Rhumb::InverseOrigin o = rh.InverseFrom(lat2[i], lon2[i]);
+      o.InverseBatch(n, lat2.data(), lon2.data(), Rhumb::ALL,
+                     s12.data(), azi12.data(), S12.data());
+      int k = 0;
+      for (size_t j = 0; j < n; ++j) {
+        T s12a, azi12a, S12a, s12b, azi12b, t;
+        rh.GenInverse(lat2[i], lon2[i], lat2[j], lon2[j], Rhumb::ALL,
+                      s12a, azi12a, S12a);
+        k += checkSame(s12[j], s12a) + checkSame(azi12[j], azi12a) +
+          checkSame(S12[j], S12a);
+        o.Inverse(lat2[j], lon2[j], s12b, azi12b);
+        k += checkSame(s12b, s12a) + checkSame(azi12b, azi12a);
+        o.GenInverse(lat2[j], lon2[j], Rhumb::DISTANCE, s12b, t, t);
+        k += checkSame(s12b, s12a);
+      }
+      if (k) cout << "testrhumbinversefrom failure: point " << i << "\n";
+      result += k;
+    }
+  }
+  return result;
+}
+
+template<class GeodType>
+static int polygonbatchcheck(const GeodType& earth) {
+  // AddPoints and ComputeBatch for PolygonAreaT<GeodType> agree with
+  // AddPoint.  The ring crosses the equator via lat = +/-0.
+  const size_t m = 301;
+  vector<T> lat(m), lon(m);
+  for (size_t i = 0; i < m; ++i) {
+    T t = 2 * Math::pi() * T(i) / m;
+    lat[i] = 20 * sin(t); lon[i] = 100 * cos(2 * t) + 40 * sin(t);
+  }
+  lat[0] = 0; lat[m / 2] = -T(0);
+  PolygonAreaT<GeodType> poly1(earth);
+  for (size_t i = 0; i < m; ++i) poly1.AddPoint(lat[i], lon[i]);
+  T perimeter1, area1, perimeter0 = 0, area0 = 0;
+  poly1.Compute(false, true, perimeter1, area1);
+  int result = 0;
+  for (unsigned nthreads = 1; nthreads <= 3; ++nthreads) {
+    PolygonAreaT<GeodType> poly(earth);
+    poly.AddPoints(m, lat.data(), lon.data(), nthreads);
+    T perimeter, area;
+    poly.Compute(false, true, perimeter, area);
+    if (nthreads == 1) {
+      perimeter0 = perimeter; area0 = area;
+      // AddPoint may differ by one unit in the last place
+      const T eps = numeric_limits<T>::epsilon();
+      result += checkEquals(perimeter, perimeter1, eps * perimeter1);
+      result += checkEquals(area, area1, eps * earth.EllipsoidArea());
+    } else
+      result += checkSame(perimeter, perimeter0) + checkSame(area, area0);
+  }
+  const size_t offsets[] = {0, m};
+  T perimeter, area;
+  poly1.ComputeBatch(1, offsets, lat.data(), lon.data(), false, true,
+                     &perimeter, &area, 2);
+  result += checkSame(perimeter, perimeter1) + checkSame(area, area1);
+  return result;
+}
+
+static int testpolygonbatchtypes() {
+  // The batch polygon engine for all the geodesic types; Rhumb::InverseBatch
+  // gives the same results for a chain of problems as GenInverse.
+  int result = 0, i;
+  i = polygonbatchcheck(Geodesic::WGS84()); result += i;
+  if (i) cout << "testpolygonbatchtypes failure: Geodesic\n";
+  i = polygonbatchcheck(GeodesicExact::WGS84()); result += i;
+  if (i) cout << "testpolygonbatchtypes failure: GeodesicExact\n";
+  for (int exact = 0; exact < 2; ++exact) {
+    const Rhumb& rh = Rhumb::Get(Constants::WGS84_a(), Constants::WGS84_f(),
+                                 exact != 0);
+    i = polygonbatchcheck(rh); result += i;
+    if (i) cout << "testpolygonbatchtypes failure: Rhumb " << exact << "\n";
+    const T lat[] = {10, 0, -T(0), -T(0), 90, 35, 35, -90},
+      lon[] = {0, 20, 30, -40, 50, 60, -70, 80};
+    const size_t n = sizeof(lat) / sizeof(T) - 1;
+    T s12[n], azi12[n], S12[n];
+    rh.InverseBatch(n, lat, lon, lat + 1, lon + 1, Rhumb::ALL,
+                    s12, azi12, S12);
+    for (size_t j = 0; j < n; ++j) {
+      T s12a, azi12a, S12a;
+      rh.GenInverse(lat[j], lon[j], lat[j + 1], lon[j + 1], Rhumb::ALL,
+                    s12a, azi12a, S12a);
+      result += checkSame(s12[j], s12a) + checkSame(azi12[j], azi12a) +
+        checkSame(S12[j], S12a);
+    }
+  }
+  return result;
+}
+
+static T jacobiref(T s, T p, T q, const EllipticFunction& e, T ang) {
+  // The direct evaluation of a JacobiConformal coordinate
+  T sang, cang;
+  Math::sincosd(ang, sang, cang);
+  T s1 = p * sang, c1 = q * cang, r = hypot(s1, c1);
+  s1 /= r; c1 /= r;
+  return s * e.Pi(s1, c1, e.Delta(s1, c1)) / Math::degree();
+}
+
+static int testjacobiconformal() {
+  // The Fourier series match the elliptic integrals, the batch matches the
+  // scalar functions exactly, and Reverse inverts Forward.  The last case is
+  // an oblate ellipsoid for which y is computed with the elliptic integrals.
+  const T axes[3][3] = {{T(1.02), 1, T(0.8)},
+                        {6378137+35, 6378137-35, 6356752},
+                        {1, 1, T(0.9)}};
+  int result = 0;
+  for (int k = 0; k < 3; ++k) {
+    T a = axes[k][0], b = axes[k][1], c = axes[k][2],
+      ab2 = (a - b) * (a + b), bc2 = (b - c) * (b + c), ac2 = ab2 + bc2;
+    JacobiConformal jc(a, b, c, a - b, b - c);
+    EllipticFunction
+      ex(ab2 / ac2 * Math::sq(c / b), -ab2 / Math::sq(b),
+         bc2 / ac2 * Math::sq(a / b), Math::sq(a / b)),
+      ey(bc2 / ac2 * Math::sq(a / b), bc2 / Math::sq(b),
+         ab2 / ac2 * Math::sq(c / b), Math::sq(c / b));
+    result += jc.XTerms() > 0 ? 0 : 1;
+    result += (k == 2 ? jc.YTerms() == 0 : jc.YTerms() > 0) ? 0 : 1;
+    result += checkEquals(jc.x(), Math::sq(a / b) * ex.Pi(), 0);
+    const size_t n = 37;
+    vector<T> bet(n), omg(n), x(n), y(n), bet1(n), omg1(n);
+    for (size_t i = 0; i < n; ++i) {
+      omg[i] = -180 + 10 * T(i);
+      // Avoid the pole of y for the oblate ellipsoid
+      bet[i] = 89 * sin(T(i));
+    }
+    jc.ForwardBatch(n, bet.data(), omg.data(), x.data(), y.data());
+    jc.ReverseBatch(n, x.data(), y.data(), bet1.data(), omg1.data());
+    const T tol = 300 * numeric_limits<T>::epsilon();
+    for (size_t i = 0; i < n; ++i) {
+      T xs, ys, bets, omgs;
+      jc.Forward(bet[i], omg[i], xs, ys);
+      result += checkSame(x[i], xs);
+      result += checkSame(y[i], ys);
+      jc.Reverse(xs, ys, bets, omgs);
+      result += checkSame(bet1[i], bets);
+      result += checkSame(omg1[i], omgs);
+      result += checkEquals(xs, jacobiref(Math::sq(a / b), b, a, ex, omg[i]),
+                            tol * 360);
+      result += checkEquals(ys, jacobiref(Math::sq(c / b), b, c, ey, bet[i]),
+                            tol * 360);
+      result += checkEquals(omgs, omg[i], tol * 180);
+      result += checkEquals(bets, bet[i], tol * 180);
+    }
+    T somg, comg;
+    Math::sincosd(T(30), somg, comg);
+    result += checkEquals(jc.x(2 * somg, 2 * comg),
+                          jc.x(T(30)) * Math::degree(), tol);
+  }
+  return result;
+}
+
+// Computed by a static initializer of this program, which may run before
+// or after the library constructs the WGS84 instances at load time.
+static T wgs84dist(const Geodesic& g) {
+  T s12;
+  g.Inverse(T(10), T(20), T(-30), T(140), s12);
+  return s12;
+}
+static const T wgs84s12 = wgs84dist(Geodesic::WGS84());
+
+static int testwgs84instances() {
+  // The shared WGS84 and UTM instances (constructed when the library is
+  // loaded) match the objects constructed with the same parameters.
+  const Geodesic& g = Geodesic::WGS84();
+  const Rhumb& r = Rhumb::WGS84();
+  const TransverseMercator& tm = TransverseMercator::UTM();
+  Geodesic g0(Constants::WGS84_a(), Constants::WGS84_f());
+  Rhumb r0(Constants::WGS84_a(), Constants::WGS84_f(), false);
+  TransverseMercator tm0(Constants::WGS84_a(), Constants::WGS84_f(),
+                         Constants::UTM_k0());
+  int result = 0;
+  result += &g == &Geodesic::WGS84() ? 0 : 1;
+  result += &r == &Rhumb::WGS84() ? 0 : 1;
+  result += &tm == &TransverseMercator::UTM() ? 0 : 1;
+  result += checkSame(wgs84s12, wgs84dist(g0));
+  for (int k = 0; k < ncases; ++k) {
+    T lat1 = testcases[k][0], lon1 = testcases[k][1],
+      azi1 = testcases[k][2], lat2 = testcases[k][3],
+      lon2 = testcases[k][4], s12 = testcases[k][6];
+    T a[10], b[10];
+    a[0] = g.Inverse(lat1, lon1, lat2, lon2,
+                     a[1], a[2], a[3], a[4], a[5], a[6], a[7]);
+    b[0] = g0.Inverse(lat1, lon1, lat2, lon2,
+                      b[1], b[2], b[3], b[4], b[5], b[6], b[7]);
+    for (int j = 0; j < 8; ++j) result += checkSame(a[j], b[j]);
+    a[0] = g.Direct(lat1, lon1, azi1, s12,
+                    a[1], a[2], a[3], a[4], a[5], a[6], a[7]);
+    b[0] = g0.Direct(lat1, lon1, azi1, s12,
+                     b[1], b[2], b[3], b[4], b[5], b[6], b[7]);
+    for (int j = 0; j < 8; ++j) result += checkSame(a[j], b[j]);
+    r.Inverse(lat1, lon1, lat2, lon2, a[0], a[1], a[2]);
+    r0.Inverse(lat1, lon1, lat2, lon2, b[0], b[1], b[2]);
+    r.Direct(lat1, lon1, azi1, s12, a[3], a[4], a[5]);
+    r0.Direct(lat1, lon1, azi1, s12, b[3], b[4], b[5]);
+    // Central meridian within 3 degrees of the point
+    T lon0 = lon1 + T(k % 7 - 3);
+    tm.Forward(lon0, lat1, lon1, a[6], a[7], a[8], a[9]);
+    tm0.Forward(lon0, lat1, lon1, b[6], b[7], b[8], b[9]);
+    for (int j = 0; j < 10; ++j) result += checkSame(a[j], b[j]);
+    tm.Reverse(lon0, a[6], a[7], a[0], a[1], a[2], a[3]);
+    tm0.Reverse(lon0, b[6], b[7], b[0], b[1], b[2], b[3]);
+    for (int j = 0; j < 4; ++j) result += checkSame(a[j], b[j]);
+  }
+  return result;
+}
+
+int main() {
+  int n = 0, i;
+
+  i = testinverse<Geodesic>(); n += i;
+  if (i) cout << "testinverse<Geodesic> failure\n";
+
+  i = testdirect<Geodesic>(); n += i;
+  if (i) cout << "testdirect<Geodesic> failure\n";
+
+  i = testarcdirect<Geodesic>(); n += i;
+  if (i) cout << "testarcdirect<Geodesic> failure\n";
+
+  i = testinversebatch<Geodesic>(); n += i;
+  if (i) cout << "testinversebatch<Geodesic> failure\n";
+
+  i = testdirectbatch<Geodesic>(); n += i;
+  if (i) cout << "testdirectbatch<Geodesic> failure\n";
+
+  i = testexecutor<Geodesic>(); n += i;
+  if (i) cout << "testexecutor<Geodesic> failure\n";
+
+  i = testthreadrun(); n += i;
+  if (i) cout << "testthreadrun failure\n";
+  i = testexecutorproject(); n += i;
+  if (i) cout << "testexecutorproject failure\n";
+
+  i = testtmbatch(); n += i;
+  if (i) cout << "testtmbatch failure\n";
+
+  i = testutmupsbatch(); n += i;
+  if (i) cout << "testutmupsbatch failure\n";
+
+  i = testtmexactseed(); n += i;
+  if (i) cout << "testtmexactseed failure\n";
+
+  i = testgeocentricbatch(); n += i;
+  if (i) cout << "testgeocentricbatch failure\n";
+
+  i = testlocalcartesianbatch(); n += i;
+  if (i) cout << "testlocalcartesianbatch failure\n";
+
+  i = testaccumulatorarray(); n += i;
+  if (i) cout << "testaccumulatorarray failure\n";
+
+  i = testexactarea(); n += i;
+  if (i) cout << "testexactarea failure\n";
+
+  i = testellipticagm(); n += i;
+  if (i) cout << "testellipticagm failure\n";
+
+  i = testconicbatch(); n += i;
+  if (i) cout << "testconicbatch failure\n";
+
+  i = testpolarbatch(); n += i;
+  if (i) cout << "testpolarbatch failure\n";
+
+  i = testazimuthalbatch(); n += i;
+  if (i) cout << "testazimuthalbatch failure\n";
+
+  // Allow 2x error with GeodesicExact calcuations (for WGS84)
+  i = testinverse<GeodesicExact>(2); n += i;
+  if (i) cout << "testinverse<GeodesicExact> failure\n";
+
+  i = testdirect<GeodesicExact>(4); n += i;
+  if (i) cout << "testdirect<GeodesicExact> failure\n";
+
+  i = testarcdirect<GeodesicExact>(2); n += i;
+  if (i) cout << "testarcdirect<GeodesicExact> failure\n";
+
+  i = testinversebatch<GeodesicExact>(); n += i;
+  if (i) cout << "testinversebatch<GeodesicExact> failure\n";
+
+  i = testdirectbatch<GeodesicExact>(); n += i;
+  if (i) cout << "testdirectbatch<GeodesicExact> failure\n";
+
+  i = testexecutor<GeodesicExact>(); n += i;
+  if (i) cout << "testexecutor<GeodesicExact> failure\n";
+
+  i = testtaufprolate(); n += i;
+  if (i) cout << "testtaufprolate failure\n";
+  i = testrhumbbatch(); n += i;
+  if (i) cout << "testrhumbbatch failure\n";
+
+  i = testellipticbatch(); n += i;
+  if (i) cout << "testellipticbatch failure\n";
+
+  i = testelliptictabulate(); n += i;
+  if (i) cout << "testelliptictabulate failure\n";
+
+  i = testdstbatch(); n += i;
+  if (i) cout << "testdstbatch failure\n";
+
+  i = testdstsizes(); n += i;
+  if (i) cout << "testdstsizes failure\n";
+
+  i = testrhumbflat(); n += i;
+  if (i) cout << "testrhumbflat failure\n";
+
+  i = testtriaxial(); n += i;
+  if (i) cout << "testtriaxial failure\n";
+
+  i = testauxlatitude(); n += i;
+  if (i) cout << "testauxlatitude failure\n";
+
+  i = testellipsoidbatch(); n += i;
+  if (i) cout << "testellipsoidbatch failure\n";
+
+  i = testinversefast(); n += i;
+  if (i) cout << "testinversefast failure\n";
+
+  i = testboundingbox(); n += i;
+  if (i) cout << "testboundingbox failure\n";
+
+  i = testintersect(); n += i;
+  if (i) cout << "testintersect failure\n";
+
+  i = testorder(); n += i;
+  if (i) cout << "testorder failure\n";
+
+  i = testseriesexact(); n += i;
+  if (i) cout << "testseriesexact failure\n";
+
+  i = testfloatbatch(); n += i;
+  if (i) cout << "testfloatbatch failure\n";
+
+  i = testreadarray(); n += i;
+  if (i) cout << "testreadarray failure\n";
+
+  i = testdistancematrix(); n += i;
+  if (i) cout << "testdistancematrix failure\n";
+
+  i = testinversefrom(); n += i;
+  if (i) cout << "testinversefrom failure\n";
+
+  i = testinversewarm(); n += i;
+  if (i) cout << "testinversewarm failure\n";
+
+  i = testwithindistance(); n += i;
+  if (i) cout << "testwithindistance failure\n";
+
+  i = testsphere(); n += i;
+  if (i) cout << "testsphere failure\n";
+
+  i = testwaypoints(); n += i;
+  if (i) cout << "testwaypoints failure\n";
+
+  i = testdensify(); n += i;
+  if (i) cout << "testdensify failure\n";
+
+  i = testclosestpoint(); n += i;
+  if (i) cout << "testclosestpoint failure\n";
+
+  i = testpointinpolygon(); n += i;
+  if (i) cout << "testpointinpolygon failure\n";
+
+  i = testtransferbatch(); n += i;
+  if (i) cout << "testtransferbatch failure\n";
+
+  i = testhelmert(); n += i;
+  if (i) cout << "testhelmert failure\n";
+
+  i = testexactaccumulator(); n += i;
+  if (i) cout << "testexactaccumulator failure\n";
+  i = testalbersreverse(); n += i;
+  if (i) cout << "testalbersreverse failure\n";
+  i = testosgbbatch(); n += i;
+  if (i) cout << "testosgbbatch failure\n";
+  i = testgeodesicregion(); n += i;
+  if (i) cout << "testgeodesicregion failure\n";
+  i = testgridlines(); n += i;
+  if (i) cout << "testgridlines failure\n";
+  i = testpolygonreader(); n += i;
+  if (i) cout << "testpolygonreader failure\n";
+
+  i = testdirectfan(); n += i;
+  if (i) cout << "testdirectfan failure\n";
+
+  i = testgeodesiclinecompact(); n += i;
+  if (i) cout << "testgeodesiclinecompact failure\n";
+
+  i = testantipodal(); n += i;
+  if (i) cout << "testantipodal failure\n";
+
+  i = testclosestapproach(); n += i;
+  if (i) cout << "testclosestapproach failure\n";
+
+  i = testgeodesicbuffer(); n += i;
+  if (i) cout << "testgeodesicbuffer failure\n";
 
+  i = testspatialjoin(); n += i;
+  if (i) cout << "testspatialjoin failure\n";
+  i = testhilbertorder(); n += i;
+  if (i) cout << "testhilbertorder failure\n";
+  i = testscheduler(); n += i;
+  if (i) cout << "testscheduler failure\n";
+  i = testcpudispatch(); n += i;
+  if (i) cout << "testcpudispatch failure\n";
+  i = testdeadline(); n += i;
+  if (i) cout << "testdeadline failure\n";
+  i = teststridedview(); n += i;
+  if (i) cout << "teststridedview failure\n";
+  i = testgeocentricfast(); n += i;
+  if (i) cout << "testgeocentricfast failure\n";
+  i = testlocalcartesianset(); n += i;
+  if (i) cout << "testlocalcartesianset failure\n";
+  i = testjacobiconformal(); n += i;
+  if (i) cout << "testjacobiconformal failure\n";
+  i = testwgs84instances(); n += i;
+  if (i) cout << "testwgs84instances failure\n";
+  i = testrhumbinversefrom(); n += i;
+  if (i) cout << "testrhumbinversefrom failure\n";
+  i = testpolygonbatchtypes(); n += i;
+  if (i) cout << "testpolygonbatchtypes failure\n";
   if (n) {
     cout << n << " failure" << (n > 1 ? "s" : "") << "\n";
     return 1;
@@ -0,0 +1,1087 @@
+/**
+ * \file geoidtest.cpp
+ * \brief Test the Geoid class with a synthetic geoid
+ *
+ * Copyright (c) Charles Karney (2022) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+#include <GeographicLib/GeodesicBatchExecutor.hpp>
+#include <GeographicLib/Geoid.hpp>
+#include <GeographicLib/GeoidPyramid.hpp>
+#include <GeographicLib/MemoryPolicy.hpp>
+#include <GeographicLib/Utility.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+typedef Math::real T;
+
+static int checkEquals(T x, T y, T d) {
+  if (fabs(x - y) <= d)
+    return 0;
+  cout << "checkEquals fails: " << x << " != " << y << " +/- " << d << "\n";
+  return 1;
+}
+
+static int checkSame(T x, T y) {
+  // Cached heights must be bitwise identical to the original ones
+  if (x == y || (isnan(x) && isnan(y)))
+    return 0;
+  cout << "checkSame fails: " << x << " != " << y << "\n";
+  return 1;
+}
+
+// The pixel values of a synthetic 2-degree geoid, 180 x 91, with offset
+// -100 m and scale 0.01 m.
+static const int gwidth = 180, gheight = 91;
+static unsigned geoidpixel(int ix, int iy) {
+  double lat = 90 - 2 * iy, lon = 2 * ix;
+  return unsigned(10000 + 4000 * sin(lat * Math::degree()) *
+                  cos(2 * lon * Math::degree()) +
+                  100 * ((ix * 7 + iy * 3) % 11));
+}
+
+// Write the synthetic geoid as a pgm file (with 4-byte pixels if Geoid
+// expects them) in the current directory and return the file name.
+static string writegeoid(const string& name) {
+  const bool wide = GEOGRAPHICLIB_GEOID_PGM_PIXEL_WIDTH == 4;
+  const string pgm = name + (wide ? ".pgm4" : ".pgm");
+  ofstream out(pgm.c_str(), ios::binary);
+  out << "P5\n# Offset -100\n# Scale 0.01\n" << gwidth << " " << gheight
+      << "\n" << (wide ? "4294967295" : "65535") << "\n";
+  for (int iy = 0; iy < gheight; ++iy)
+    for (int ix = 0; ix < gwidth; ++ix) {
+      unsigned v = geoidpixel(ix, iy);
+      for (int k = wide ? 3 : 1; k >= 0; --k)
+        out.put(char((v >> (8 * k)) & 0xffu));
+    }
+  return pgm;
+}
+
+// Encode the tile of the synthetic geoid with its NW corner at (x0, y0) in
+// the compressed format (see GeoidToPGC.cpp) with Rice parameter k.
+static vector<unsigned char> pgctile(int x0, int y0, int w, int h, int k) {
+  vector<unsigned char> buf(1, (unsigned char)(k));
+  unsigned long long acc = 0;
+  int nacc = 0;
+  auto put = [&buf, &acc, &nacc](unsigned long long x, int nb) -> void {
+    for (int i = nb; i--;) {
+      acc = (acc << 1) | ((x >> i) & 1ULL);
+      if (++nacc == 8) {
+        buf.push_back((unsigned char)(acc)); acc = 0; nacc = 0;
+      }
+    }
+  };
+  vector<long long> v(size_t(w) * h);
+  for (int y = 0; y < h; ++y)
+    for (int x = 0; x < w; ++x)
+      v[y * w + x] = geoidpixel(x0 + x, y0 + y);
+  for (int y = 0; y < h; ++y)
+    for (int x = 0; x < w; ++x) {
+      long long pred;
+      if (y == 0)
+        pred = x == 0 ? 0 : v[x - 1];
+      else if (x == 0)
+        pred = v[(y - 1) * w];
+      else {
+        long long a = v[y * w + x - 1], b = v[(y - 1) * w + x],
+          c = v[(y - 1) * w + x - 1];
+        pred = c >= max(a, b) ? min(a, b) :
+          (c <= min(a, b) ? max(a, b) : a + b - c);
+      }
+      long long r = v[y * w + x] - pred;
+      unsigned long long u = r >= 0 ? 2ULL * r : 2ULL * (-r) - 1,
+        q = u >> k;
+      if (q < 32) {
+        for (; q; --q) put(1, 1);
+        put(0, 1);
+        put(u, k);
+      } else {
+        put(~0ULL, 32);
+        put(u, 34);
+      }
+    }
+  if (nacc) put(0, 8 - nacc);
+  return buf;
+}
+
+// Write a compressed file with the given tiles; the tile index is given
+// by offsets (if it's empty, the correct index is written).
+static void writepgc(const string& filename, int tile,
+                     const vector< vector<unsigned char> >& tiles,
+                     vector<unsigned long long> offsets =
+                     vector<unsigned long long>()) {
+  const bool wide = GEOGRAPHICLIB_GEOID_PGM_PIXEL_WIDTH == 4;
+  if (offsets.empty()) {
+    offsets.push_back(0);
+    for (const auto& t : tiles) offsets.push_back(offsets.back() + t.size());
+  }
+  ofstream out(filename.c_str(), ios::binary);
+  out << "P5C\n# Offset -100\n# Scale 0.01\n" << gwidth << " " << gheight
+      << "\n" << (wide ? "4294967295" : "65535") << " " << tile << " "
+      << tile << "\n";
+  Utility::writearray<unsigned long long, unsigned long long, true>
+    (out, offsets);
+  for (const auto& t : tiles)
+    out.write(reinterpret_cast<const char*>(t.data()),
+              streamsize(t.size()));
+}
+
+static int testgeoidconcurrent() {
+  // A concurrent Geoid (which reads with pread and has a per-thread cell
+  // cache) gives the same heights as the default one (which reads through
+  // a stream), also when shared by several threads and with an area cache.
+  const string name = "geoidtest-conc", pgm = writegeoid(name);
+  const int n = 2000;
+  vector<T> lat(n), lon(n), h(n);
+  for (int i = 0; i < n; ++i) {
+    lat[i] = T(89.9) * sin(T(i) * T(0.37));
+    lon[i] = remainder(T(i) * T(13.7), T(360));
+  }
+  int result = 0;
+  for (int cubic = 0; cubic < 2; ++cubic) {
+    Geoid g(name, ".", cubic != 0),
+      gc(name, ".", cubic != 0, false, false, true);
+    result += !(gc.Concurrent() && gc.ThreadSafe() && !gc.Cache() &&
+                !g.Concurrent() && !g.ThreadSafe());
+    for (int i = 0; i < n; ++i) h[i] = g(lat[i], lon[i]);
+    atomic<int> bad(0);
+    // Chunks of 10 points so that the threads interleave
+    GeodesicBatchExecutor(4, 10).ForEach(n, [&](size_t i0, size_t i1)
+                                         -> void {
+      for (size_t i = i0; i < i1; ++i)
+        if (!(gc(lat[i], lon[i]) == h[i])) ++bad;
+    });
+    result += bad;
+    gc.CacheArea(-20, -30, 40, 50);
+    result += !gc.Cache();
+    for (int i = 0; i < n; ++i) result += checkSame(gc(lat[i], lon[i]), h[i]);
+    gc.CacheClear();
+    for (int i = 0; i < n; ++i) result += checkSame(gc(lat[i], lon[i]), h[i]);
+  }
+  remove(pgm.c_str());
+  return result;
+}
+
+static int testgeoidtiles() {
+  // The heights found via a tile cache (also with a concurrent Geoid)
+  // match those found by reading the file directly, whether the points are
+  // scattered (so that tiles are evicted) or clustered, and with a budget
+  // of less than one tile.
+  const string name = "geoidtest-tiles", pgm = writegeoid(name);
+  const int n = 2000;
+  const unsigned long long tilebytes =
+    10 * 10 * GEOGRAPHICLIB_GEOID_PGM_PIXEL_WIDTH; // A 20-degree tile
+  vector<T> lat(n), lon(n), h(n), latc(n), lonc(n), hc(n);
+  for (int i = 0; i < n; ++i) {
+    lat[i] = T(89.9) * sin(T(i) * T(0.37));
+    lon[i] = remainder(T(i) * T(13.7), T(360));
+    latc[i] = 30 + T(i % 37) / 5; lonc[i] = -60 + T(i % 41) / 4;
+  }
+  int result = 0;
+  Geoid g(name, ".");
+  for (int i = 0; i < n; ++i) {
+    h[i] = g(lat[i], lon[i]); hc[i] = g(latc[i], lonc[i]);
+  }
+  for (int conc = 0; conc < 2; ++conc) {
+    Geoid gt(name, ".", true, false, false, conc != 0);
+    gt.CacheTiles(4 * tilebytes, 20);
+    result += !(gt.TileCache() && gt.TileCacheCapacity() == 4 &&
+                gt.TileCacheSize() == 0 && !gt.Cache());
+    // The concurrent Geoid is shared by 4 threads
+    atomic<int> bad(0);
+    GeodesicBatchExecutor(conc ? 4 : 1, 10).ForEach
+      (n, [&](size_t i0, size_t i1) -> void {
+        for (size_t i = i0; i < i1; ++i)
+          if (!(gt(lat[i], lon[i]) == h[i])) ++bad;
+      });
+    result += bad;
+    result += !(gt.TileCacheSize() == 4 &&
+                gt.TileCacheMisses() > 100 && gt.TileCacheHits() > 0);
+    unsigned long long misses = gt.TileCacheMisses();
+    for (int i = 0; i < n; ++i)
+      result += checkSame(gt(latc[i], lonc[i]), hc[i]);
+    // The cluster needs no more than 4 tiles
+    result += gt.TileCacheMisses() - misses > 4;
+    // A single tile of 2 x 2 pixels
+    gt.CacheTiles(1, 2);
+    result += gt.TileCacheCapacity() != 1;
+    for (int i = 0; i < n; ++i) result += checkSame(gt(lat[i], lon[i]), h[i]);
+    result += gt.TileCacheSize() != 1;
+    // CacheArea replaces the tile cache
+    gt.CacheArea(-20, -30, 40, 50);
+    result += gt.TileCache() || !gt.Cache();
+    try {
+      gt.CacheTiles(tilebytes, 0);
+      ++result;
+    }
+    catch (const GeographicErr&) {}
+  }
+  remove(pgm.c_str());
+  return result;
+}
+
+static int testgeoidbatch() {
+  // HeightBatch gives the same heights as computing them one at a time,
+  // for each way of reading the data; NaN coordinates give NaN heights.
+  const string name = "geoidtest-batch", pgm = writegeoid(name);
+  const int n = 1000;
+  vector<T> lat(n), lon(n), h(n), hb(n);
+  for (int i = 0; i < n; ++i) {
+    // Alternate scattered points with runs of points in one cell
+    lat[i] = i % 3 ? 30 + T(i % 7) / 10 : T(89.9) * sin(T(i) * T(0.37));
+    lon[i] = i % 3 ? -61 + T(i % 5) / 10 : remainder(T(i) * T(13.7), T(360));
+  }
+  lat[17] = Math::NaN(); lon[18] = Math::NaN();
+  int result = 0;
+  for (int k = 0; k < 7; ++k) {
+    // 0 = bilinear, 1 = default, 2 = area cache, 3 = tile cache,
+    // 4 = threadsafe, 5 = memory mapped, 6 = concurrent
+    Geoid g(name, ".", k != 0, k == 4, k == 5, k == 6);
+    if (k == 2) g.CacheArea(-20, -30, 40, 50);
+    if (k == 3) g.CacheTiles(1000, 10);
+    for (int i = 0; i < n; ++i) h[i] = g(lat[i], lon[i]);
+    g.HeightBatch(n, lat.data(), lon.data(), hb.data());
+    int j = 0;
+    for (int i = 0; i < n; ++i) j += checkSame(hb[i], h[i]);
+    j += !(isnan(hb[17]) && isnan(hb[18]));
+    if (j) cout << "testgeoidbatch failure: case " << k << "\n";
+    result += j;
+  }
+  remove(pgm.c_str());
+  return result;
+}
+
+static int testgeoidcompressed() {
+  // A compressed (pgc) file gives the same heights as the pgm file; corrupt
+  // tile indexes are rejected by the constructor and corrupt tiles when
+  // they are decoded, without affecting the other tiles.
+  const string ref = "geoidtest-ref", pgm = writegeoid(ref),
+    name = "geoidtest-pgc",
+    pgc = name + (GEOGRAPHICLIB_GEOID_PGM_PIXEL_WIDTH == 4 ?
+                  ".pgc4" : ".pgc");
+  const int tile = 16, ntx = (gwidth + tile - 1) / tile,
+    nty = (gheight + tile - 1) / tile;
+  vector< vector<unsigned char> > tiles;
+  for (int ty = 0; ty < nty; ++ty)
+    for (int tx = 0; tx < ntx; ++tx)
+      tiles.push_back(pgctile(tx * tile, ty * tile,
+                              min(tile, gwidth - tx * tile),
+                              min(tile, gheight - ty * tile),
+                              // Exercise the escape for large residuals
+                              (tx + ty) % 3 ? 6 : 2));
+  const int n = 1000;
+  vector<T> lat(n), lon(n), h(n), hb(n);
+  for (int i = 0; i < n; ++i) {
+    lat[i] = T(89.9) * sin(T(i) * T(0.37));
+    lon[i] = remainder(T(i) * T(13.7), T(360));
+  }
+  int result = 0;
+  writepgc(pgc, tile, tiles);
+  for (int cubic = 0; cubic < 2; ++cubic) {
+    Geoid g(ref, ".", cubic != 0), gz(name, ".", cubic != 0);
+    result += !(gz.Compressed() && gz.TileCache() && !g.Compressed());
+    for (int i = 0; i < n; ++i) {
+      h[i] = g(lat[i], lon[i]);
+      result += checkSame(gz(lat[i], lon[i]), h[i]);
+    }
+    // A budget of one tile
+    gz.CacheTiles(1);
+    gz.HeightBatch(n, lat.data(), lon.data(), hb.data());
+    for (int i = 0; i < n; ++i) result += checkSame(hb[i], h[i]);
+    gz.CacheArea(-20, -30, 40, 50);
+    for (int i = 0; i < n; ++i) result += checkSame(gz(lat[i], lon[i]), h[i]);
+  }
+  try {
+    Geoid gz(name, ".", true, false, true);
+    ++result;
+  }
+  catch (const GeographicErr&) {}
+  // Corrupt tile indexes
+  vector<unsigned long long> offsets(1, 0);
+  for (const auto& t : tiles) offsets.push_back(offsets.back() + t.size());
+  for (int k = 0; k < 4; ++k) {
+    vector<unsigned long long> o(offsets);
+    if (k == 0)
+      o[0] = 1;                 // Doesn't start at 0
+    else if (k == 1)
+      o[2] = o[1];              // An empty tile
+    else if (k == 2)
+      swap(o[3], o[4]);         // Decreasing offsets
+    else
+      o.back() += 1;            // The file is too short
+    writepgc(pgc, tile, tiles, o);
+    try {
+      Geoid gz(name, ".");
+      ++result;
+      cout << "testgeoidcompressed: corrupt index " << k << " accepted\n";
+    }
+    catch (const GeographicErr&) {}
+  }
+  // Corrupt tiles (tile 0 holds the NW corner, tile 1 the area east of it)
+  for (int k = 0; k < 3; ++k) {
+    vector< vector<unsigned char> > t(tiles);
+    if (k == 0)
+      t[0][0] = 33;             // Bad Rice parameter
+    else if (k == 1)
+      t[0].resize(t[0].size() / 2); // The bit stream ends too soon
+    else
+      // Residuals which give values out of range
+      fill(t[0].begin() + 1, t[0].end(), (unsigned char)(0xff));
+    writepgc(pgc, tile, t);
+    Geoid gz(name, ".");
+    try {
+      gz(80, 10);
+      ++result;
+      cout << "testgeoidcompressed: corrupt tile " << k << " accepted\n";
+    }
+    catch (const GeographicErr&) {}
+    result += checkSame(gz(80, 50), Geoid(ref, ".")(80, 50));
+  }
+  remove(pgc.c_str());
+  remove(pgm.c_str());
+  return result;
+}
+
+static int testgeoidsnapshot() {
+  // A cache snapshot of a synthetic 2-degree geoid restores the area cache
+  // (with and without the fits) and the tile cache, giving the same heights
+  // without reading the data; bad snapshots are rejected.
+  const string name = "geoidtest-geoid", pgm = writegeoid(name),
+    snap = "geoidtest-geoid.snap", snap2 = "geoidtest-geoid2.snap";
+  const int n = 200;
+  vector<T> lat(n), lon(n), h0(n);
+  for (int i = 0; i < n; ++i) {
+    lat[i] = T(0.7) * (i % 127) - 45; lon[i] = T(0.37) * (i * 7 % 500) - 60;
+  }
+  int result = 0;
+  {
+    // Area cache with fits
+    Geoid g(name, ".");
+    g.CacheFits();
+    g.CacheArea(-20, -30, 40, 50);
+    g.SaveCache(snap);
+    g.SaveCache(snap2, false);
+    for (int i = 0; i < n; ++i) h0[i] = g(lat[i], lon[i]);
+    Geoid g1(name, "."), g2(name, ".");
+    g1.CacheFits();
+    g1.LoadCache(snap);
+    result += !(g1.Cache() && g1.FitCache());
+    result += checkSame(g1.CacheWest(), g.CacheWest()) +
+      checkSame(g1.CacheEast(), g.CacheEast()) +
+      checkSame(g1.CacheNorth(), g.CacheNorth()) +
+      checkSame(g1.CacheSouth(), g.CacheSouth());
+    for (int i = 0; i < n; ++i) result += checkSame(g1(lat[i], lon[i]), h0[i]);
+    // Fits in the snapshot are skipped without CacheFits; without fits in
+    // the snapshot, they are computed with CacheFits
+    g2.LoadCache(snap);
+    result += !(g2.Cache() && !g2.FitCache());
+    for (int i = 0; i < n; ++i) result += checkSame(g2(lat[i], lon[i]), h0[i]);
+    g1.LoadCache(snap2);
+    result += !(g1.Cache() && g1.FitCache());
+    for (int i = 0; i < n; ++i) result += checkSame(g1(lat[i], lon[i]), h0[i]);
+    // Bilinear interpolation uses different data
+    Geoid gb(name, ".", false);
+    try {
+      gb.LoadCache(snap);
+      ++result;
+    }
+    catch (const GeographicErr&) {}
+    result += gb.Cache();
+  }
+  {
+    // Tile cache; the loaded tiles supply all the heights
+    Geoid g(name, ".");
+    g.CacheTiles(100 * 10 * 10 * GEOGRAPHICLIB_GEOID_PGM_PIXEL_WIDTH, 20);
+    g.HeightBatch(n, lat.data(), lon.data(), h0.data());
+    g.SaveCache(snap);
+    Geoid g1(name, ".");
+    g1.LoadCache(snap);
+    result += !(g1.TileCache() &&
+                g1.TileCacheCapacity() == g.TileCacheCapacity() &&
+                g1.TileCacheSize() == g.TileCacheSize());
+    for (int i = 0; i < n; ++i) result += checkSame(g1(lat[i], lon[i]), h0[i]);
+    result += g1.TileCacheMisses() != 0 || g.TileCacheSize() >= 100;
+    // A truncated snapshot is rejected and the cache is unchanged
+    {
+      ifstream in(snap.c_str(), ios::binary);
+      string data((istreambuf_iterator<char>(in)),
+                  istreambuf_iterator<char>());
+      ofstream out(snap2.c_str(), ios::binary);
+      out.write(data.data(), streamsize(data.size() - 2));
+    }
+    try {
+      g1.LoadCache(snap2);
+      ++result;
+    }
+    catch (const GeographicErr&) {}
+    result += !(g1.TileCache() && g1.TileCacheSize() == g.TileCacheSize());
+    // An empty cache
+    g.CacheClear();
+    g.SaveCache(snap);
+    g1.LoadCache(snap);
+    result += g1.Cache() || g1.TileCache();
+  }
+  remove(snap.c_str());
+  remove(snap2.c_str());
+  remove(pgm.c_str());
+  return result;
+}
+
+static int testgeoidcopy() {
+  // A copy of a Geoid (in each mode) gives the same heights as the
+  // original after the original is destroyed; setting the area cache of a
+  // copy doesn't change the cache of the original.
+  const string name = "geoidtest-copy", pgm = writegeoid(name);
+  const int n = 500;
+  vector<T> lat(n), lon(n), h(n);
+  for (int i = 0; i < n; ++i) {
+    lat[i] = T(89.9) * sin(T(i) * T(0.37));
+    lon[i] = remainder(T(i) * T(13.7), T(360));
+  }
+  int result = 0;
+  for (int k = 0; k < 6; ++k) {
+    // 0 = default, 1 = area cache, 2 = tile cache, 3 = threadsafe,
+    // 4 = memory mapped, 5 = concurrent
+    unique_ptr<Geoid> g(new Geoid(name, ".", true, k == 3, k == 4, k == 5));
+    if (k == 1) g->CacheArea(-20, -30, 40, 50);
+    if (k == 2) g->CacheTiles(1000, 10);
+    for (int i = 0; i < n; ++i) h[i] = (*g)(lat[i], lon[i]);
+    Geoid gc(*g);
+    result += gc.Cache() != g->Cache() || gc.ThreadSafe() != g->ThreadSafe();
+    if (k == 1) {
+      const T south = g->CacheSouth(), north = g->CacheNorth();
+      Geoid gc1(*g);
+      gc1.CacheArea(0, 0, 10, 10);
+      result += checkSame(g->CacheSouth(), south) +
+        checkSame(g->CacheNorth(), north) + !(gc1.CacheNorth() < north);
+      gc1.CacheClear();
+      result += !g->Cache() || gc1.Cache();
+    }
+    g.reset();
+    int j = 0;
+    for (int i = 0; i < n; ++i) j += checkSame(gc(lat[i], lon[i]), h[i]);
+    if (j) cout << "testgeoidcopy failure: case " << k << "\n";
+    result += j;
+  }
+  remove(pgm.c_str());
+  return result;
+}
+
+static int testgeoidasync() {
+  // An area read by CacheAreaAsync is installed by the next height
+  // computation and gives the same heights as CacheArea; Prefetch requests
+  // a new area only when the track leaves the last one; a request is
+  // discarded by CacheClear; thread safe Geoids reject both.
+  const string name = "geoidtest-async", pgm = writegeoid(name);
+  const int n = 300;
+  vector<T> lat(n), lon(n), h(n);
+  for (int i = 0; i < n; ++i) {
+    lat[i] = 10 + T(i % 37) / 2; lon[i] = -20 + T(i % 41) / 2;
+  }
+  int result = 0;
+  Geoid g(name, "."), ga(name, ".");
+  g.CacheArea(5, -25, 35, 5);
+  for (int i = 0; i < n; ++i) h[i] = g(lat[i], lon[i]);
+  shared_future<void> f = ga.CacheAreaAsync(5, -25, 35, 5);
+  f.get();
+  // The cache is installed by the next height computation
+  result += checkSame(ga(lat[0], lon[0]), h[0]) + !ga.Cache();
+  result += checkSame(ga.CacheSouth(), g.CacheSouth()) +
+    checkSame(ga.CacheNorth(), g.CacheNorth()) +
+    checkSame(ga.CacheWest(), g.CacheWest()) +
+    checkSame(ga.CacheEast(), g.CacheEast());
+  for (int i = 0; i < n; ++i) result += checkSame(ga(lat[i], lon[i]), h[i]);
+  ga.HeightBatch(n, lat.data(), lon.data(), h.data());
+  for (int i = 0; i < n; ++i) result += checkSame(g(lat[i], lon[i]), h[i]);
+  // A discarded request
+  ga.CacheClear();
+  f = ga.CacheAreaAsync(-40, 100, -30, 120);
+  ga.CacheClear();
+  f.get();
+  result += checkSame(ga(lat[0], lon[0]), h[0]) + ga.Cache();
+  // Prefetch along a track heading east from (20, -10)
+  Geoid gp(name, ".");
+  f = gp.Prefetch(20, -10, 90, 100000);
+  result += !f.valid();
+  f.get();
+  result += checkSame(gp(20, -10), g(20, -10)) + !gp.Cache();
+  // The next 100 km lie in the requested area
+  result += gp.Prefetch(20, T(-9.9), 90, 100000).valid();
+  f = gp.Prefetch(20, 20, 90, 100000);
+  result += !f.valid();
+  f.get();
+  result += checkSame(gp(20, T(20.5)), Geoid(name, ".")(20, T(20.5))) +
+    !(gp.CacheWest() <= 20 && gp.CacheEast() > T(20.5));
+  try {
+    gp.Prefetch(20, 20, 90, 0);
+    ++result;
+  }
+  catch (const GeographicErr&) {}
+  for (int k = 0; k < 2; ++k) {
+    Geoid gt(name, ".", true, k == 0, false, k == 1);
+    try {
+      gt.CacheAreaAsync(5, -25, 35, 5);
+      ++result;
+    }
+    catch (const GeographicErr&) {}
+    try {
+      gt.Prefetch(20, -10, 90, 100000);
+      ++result;
+    }
+    catch (const GeographicErr&) {}
+  }
+  remove(pgm.c_str());
+  return result;
+}
+
+static int testgeoidcoalesce() {
+  // HeightBatch reading directly from the file (with the reads merged into
+  // runs) gives the same heights as a memory mapped Geoid, for points
+  // scattered over the grid (so that there are several runs per block),
+  // at the poles, and on either side of the date line.
+  const string name = "geoidtest-runs", pgm = writegeoid(name);
+  const bool canmap = numeric_limits<T>::is_iec559 &&
+    sizeof(T) == sizeof(double) && !Math::bigendian;
+  const int n = 1200;
+  vector<T> lat(n), lon(n), h(n), hb(n);
+  for (int i = 0; i < n; ++i) {
+    lat[i] = T(90) * sin(T(i) * T(0.731));
+    lon[i] = T(i % 4 == 0 ? 179.9 : 360) * cos(T(i) * T(1.37));
+  }
+  lat[0] = 90; lat[1] = -90; lon[2] = 180; lon[3] = -180;
+  int result = 0;
+  for (int cubic = 0; cubic < 2; ++cubic) {
+    Geoid g(name, ".", cubic != 0, false, canmap, false);
+    for (int i = 0; i < n; ++i) h[i] = g(lat[i], lon[i]);
+    for (int conc = 0; conc < 2; ++conc) {
+      Geoid gr(name, ".", cubic != 0, false, false, conc != 0);
+      gr.HeightBatch(n, lat.data(), lon.data(), hb.data());
+      for (int i = 0; i < n; ++i) result += checkSame(hb[i], h[i]);
+      // A batch of one point and an empty batch
+      gr.HeightBatch(1, lat.data() + 5, lon.data() + 5, hb.data());
+      gr.HeightBatch(0, lat.data(), lon.data(), hb.data());
+      result += checkSame(hb[0], h[5]);
+    }
+  }
+  remove(pgm.c_str());
+  return result;
+}
+
+static int testgeoidfits() {
+  // The heights computed with the precomputed fits of the area cache are
+  // the same as without them, for a regional area, the whole grid (where
+  // the stencils wrap around in longitude), and an area read on another
+  // thread; clearing the cache releases the fits.
+  const string name = "geoidtest-fits", pgm = writegeoid(name);
+  const int n = 1000;
+  vector<T> lat(n), lon(n), h(n), hb(n);
+  for (int i = 0; i < n; ++i) {
+    lat[i] = T(89.9) * sin(T(i) * T(0.37));
+    lon[i] = remainder(T(i) * T(13.7), T(360));
+  }
+  lat[0] = 90; lat[1] = -90; lon[2] = 180; lon[3] = T(359.9);
+  int result = 0;
+  for (int cubic = 0; cubic < 2; ++cubic) {
+    Geoid g(name, ".", cubic != 0), gf(name, ".", cubic != 0);
+    for (int i = 0; i < n; ++i) h[i] = g(lat[i], lon[i]);
+    gf.CacheFits();
+    result += gf.FitCache();
+    for (int k = 0; k < 3; ++k) {
+      if (k == 0)
+        gf.CacheArea(-20, -30, 40, 50);
+      else if (k == 1)
+        gf.CacheAll();
+      else {
+        gf.CacheClear();
+        gf.CacheAreaAsync(-20, -30, 40, 50).get();
+        gf(lat[0], lon[0]);
+      }
+      result += !(gf.Cache() && gf.FitCache());
+      for (int i = 0; i < n; ++i)
+        result += checkSame(gf(lat[i], lon[i]), h[i]);
+      gf.HeightBatch(n, lat.data(), lon.data(), hb.data());
+      for (int i = 0; i < n; ++i) result += checkSame(hb[i], h[i]);
+    }
+    gf.CacheClear();
+    result += gf.Cache() || gf.FitCache();
+    // Turning off the fits releases them
+    gf.CacheAll();
+    gf.CacheFits(false);
+    result += !gf.Cache() || gf.FitCache();
+    for (int i = 0; i < n; ++i) result += checkSame(gf(lat[i], lon[i]), h[i]);
+  }
+  try {
+    Geoid gt(name, ".", true, true);
+    gt.CacheFits();
+    ++result;
+  }
+  catch (const GeographicErr&) {}
+  remove(pgm.c_str());
+  return result;
+}
+
+static int testgeoidpyramid() {
+  // Coarsen reproduces the grid values at the nodes of the coarser grid and
+  // records its maximum error with respect to all the nodes of the source
+  // grid; GeoidPyramid picks the coarsest level within the tolerance.
+  const string name = "geoidtest-pyr", pgm = writegeoid(name),
+    ext = pgm.substr(name.size()), name6 = name + "6", name9 = name + "9";
+  int result = 0;
+  GeoidPyramid::Coarsen(name, name6, 3, ".");
+  GeoidPyramid::Coarsen(name, name9, 9, ".");
+  const Geoid g(name, ".", false), g6(name6, ".", false),
+    g6c(name6, "."), g9(name9, ".", false);
+  T maxerr6 = 0;
+  for (int iy = 0; iy < gheight; ++iy)
+    for (int ix = 0; ix < gwidth; ++ix) {
+      T lat = 90 - 2 * T(iy), lon = 2 * T(ix), h = g(lat, lon);
+      if (iy % 3 == 0 && ix % 3 == 0)
+        result += checkSame(g6(lat, lon), h);
+      if (iy % 9 == 0 && ix % 9 == 0)
+        result += checkSame(g9(lat, lon), h);
+      maxerr6 = fmax(maxerr6, fabs(g6(lat, lon) - h));
+    }
+  result += !(fabs(g6.MaxError() - maxerr6) < 1e-12 && maxerr6 > 0 &&
+              g6c.MaxError() > 0 && g.MaxError() < 0);
+  // The levels may be given in any order
+  vector<string> names;
+  names.push_back(name9); names.push_back(name); names.push_back(name6);
+  const GeoidPyramid p(names, ".", false);
+  result += p.Levels() != 3 || p.LevelGeoid(0).GeoidName() != name ||
+    p.LevelGeoid(1).GeoidName() != name6 ||
+    p.LevelGeoid(2).GeoidName() != name9;
+  const T err6 = g6.MaxError(), err9 = g9.MaxError();
+  result += &p.Level(0) != &p.LevelGeoid(0) ||
+    &p.Level(err6) != &p.LevelGeoid(err6 < err9 ? 1 : 2) ||
+    &p.Level(fmax(err6, err9)) != &p.LevelGeoid(2);
+  const int n = 100;
+  vector<T> lat(n), lon(n), h(n);
+  for (int i = 0; i < n; ++i) {
+    lat[i] = T(89.9) * sin(T(i) * T(0.37));
+    lon[i] = remainder(T(i) * T(13.7), T(360));
+  }
+  p.HeightBatch(n, lat.data(), lon.data(), err6, h.data());
+  for (int i = 0; i < n; ++i)
+    result += checkSame(h[i], p.Level(err6)(lat[i], lon[i])) +
+      checkSame(p(lat[i], lon[i], 0), g(lat[i], lon[i]));
+  try {
+    GeoidPyramid::Coarsen(name, name + "x", 7, ".");
+    ++result;
+  }
+  catch (const GeographicErr&) {}
+  try {
+    GeoidPyramid::Coarsen(name, name + "x", 1, ".");
+    ++result;
+  }
+  catch (const GeographicErr&) {}
+  // 45 intervals in latitude
+  try {
+    GeoidPyramid::Coarsen(name, name + "x", 2, ".");
+    ++result;
+  }
+  catch (const GeographicErr&) {}
+  try {
+    GeoidPyramid q((vector<string>()));
+    ++result;
+  }
+  catch (const GeographicErr&) {}
+  remove(pgm.c_str());
+  remove((name6 + ext).c_str());
+  remove((name9 + ext).c_str());
+  return result;
+}
+
+// The value of the synthetic geoid at grid point (ix, iy) in meters
+static double geoidvalue(int ix, int iy) {
+  return -100 + 0.01 * geoidpixel(ix, iy);
+}
+
+// Append n bytes of u in the given byte order
+static void putbytes(vector<unsigned char>& buf, unsigned long long u, int n,
+                     bool big) {
+  for (int i = 0; i < n; ++i)
+    buf.push_back((unsigned char)(u >> (8 * (big ? n - 1 - i : i))));
+}
+
+static unsigned long long doublebits(double x) {
+  unsigned long long u;
+  memcpy(&u, &x, 8);
+  return u;
+}
+
+// Write the synthetic geoid as a GTX grid (float32, big-endian, rows from
+// south to north) with the first column at longitude lon0; if repeat, the
+// column at lon0 + 360 is included.  The header can be replaced by hdr.
+static void writegtx(const string& filename, int lon0, bool repeat,
+                     const vector<double>& hdr = vector<double>()) {
+  const int ncols = gwidth + (repeat ? 1 : 0), shift = lon0 / 2;
+  vector<double> h(hdr);
+  if (h.empty()) {
+    h.push_back(-90); h.push_back(lon0); h.push_back(2); h.push_back(2);
+    h.push_back(gheight); h.push_back(ncols);
+  }
+  vector<unsigned char> buf;
+  for (int k = 0; k < 4; ++k) putbytes(buf, doublebits(h[k]), 8, true);
+  for (int k = 4; k < 6; ++k)
+    putbytes(buf, (unsigned long long)(long long)(h[k]), 4, true);
+  for (int iy = gheight; iy--;)
+    for (int c = 0; c < ncols; ++c) {
+      float f = float(geoidvalue(((c + shift) % gwidth + gwidth) % gwidth,
+                                 iy));
+      uint32_t u;
+      memcpy(&u, &f, 4);
+      putbytes(buf, u, 4, true);
+    }
+  ofstream out(filename.c_str(), ios::binary);
+  out.write(reinterpret_cast<const char*>(buf.data()),
+            streamsize(buf.size()));
+}
+
+// A TIFF tag: type 3 = short, 4 = long, 12 = double; a nonzero count
+// replaces the number of values in the IFD entry
+struct tifftag {
+  unsigned tag, type;
+  vector<double> v;
+  unsigned long long count;
+};
+
+// Write the synthetic geoid as a GeoTIFF (rows from north to south, the
+// first column at longitude -180) with float32 or float64 values in nstrips
+// strips.  The tags may be modified by fixup before they are written.
+template<class F>
+static void writetiff(const string& filename, bool big, int bits,
+                      bool point, int nstrips, F fixup) {
+  vector<unsigned char> buf;
+  putbytes(buf, big ? 0x4d4d : 0x4949, 2, true);
+  putbytes(buf, 42, 2, big);
+  putbytes(buf, 0, 4, big);     // The IFD offset, filled in below
+  vector<double> offsets, counts;
+  const int rows = (gheight + nstrips - 1) / nstrips;
+  for (int iy = 0; iy < gheight; ++iy) {
+    if (iy % rows == 0) {
+      offsets.push_back(double(buf.size()));
+      counts.push_back(0);
+    }
+    for (int c = 0; c < gwidth; ++c) {
+      double v = geoidvalue((c + gwidth / 2) % gwidth, iy);
+      if (bits == 32) {
+        float f = float(v);
+        uint32_t u;
+        memcpy(&u, &f, 4);
+        putbytes(buf, u, 4, big);
+      } else
+        putbytes(buf, doublebits(v), 8, big);
+      counts.back() += bits / 8;
+    }
+  }
+  vector<tifftag> tags;
+  auto add = [&tags](unsigned tag, unsigned type, vector<double> v)
+    -> void { tifftag t = {tag, type, v, 0}; tags.push_back(t); };
+  add(256, 4, vector<double>(1, gwidth));
+  add(257, 4, vector<double>(1, gheight));
+  add(258, 3, vector<double>(1, bits));
+  add(259, 3, vector<double>(1, 1));
+  add(273, 4, offsets);
+  add(277, 3, vector<double>(1, 1));
+  add(279, 4, counts);
+  add(284, 3, vector<double>(1, 1));
+  add(339, 3, vector<double>(1, 3));
+  add(33550, 12, vector<double>{2, 2, 0});
+  add(33922, 12, point ? vector<double>{0, 0, 0, -180, 90, 0} :
+      vector<double>{0, 0, 0, -181, 91, 0});
+  add(34735, 3, vector<double>{1, 1, 0, 1, 1025, 0, 1, point ? 2. : 1.});
+  fixup(tags);
+  const unsigned long long ifd = buf.size();
+  for (int k = 0; k < 4; ++k) buf[4 + k] = (unsigned char)
+    (ifd >> (8 * (big ? 3 - k : k)));
+  putbytes(buf, tags.size(), 2, big);
+  // The values which don't fit in the IFD entries follow the IFD
+  unsigned long long extra = ifd + 2 + 12 * tags.size() + 4;
+  vector<unsigned char> values;
+  for (const auto& t : tags) {
+    int sz = t.type == 3 ? 2 : (t.type == 12 ? 8 : 4);
+    vector<unsigned char> v;
+    for (double x : t.v)
+      putbytes(v, t.type == 12 ? doublebits(x) :
+               (unsigned long long)(x), sz, big);
+    putbytes(buf, t.tag, 2, big);
+    putbytes(buf, t.type, 2, big);
+    putbytes(buf, t.count ? t.count : t.v.size(), 4, big);
+    if (v.size() <= 4) {
+      v.resize(4);
+      buf.insert(buf.end(), v.begin(), v.end());
+    } else {
+      putbytes(buf, extra + values.size(), 4, big);
+      values.insert(values.end(), v.begin(), v.end());
+    }
+  }
+  putbytes(buf, 0, 4, big);
+  buf.insert(buf.end(), values.begin(), values.end());
+  ofstream out(filename.c_str(), ios::binary);
+  out.write(reinterpret_cast<const char*>(buf.data()),
+            streamsize(buf.size()));
+}
+
+// Replace the byte at pos in a file
+static void patchfile(const string& filename, size_t pos, unsigned char c) {
+  fstream f(filename.c_str(), ios::in | ios::out | ios::binary);
+  f.seekp(streamoff(pos));
+  f.put(char(c));
+}
+
+static int testgeoidvendor() {
+  // GTX and GeoTIFF grids (in the various layouts) give the same heights
+  // as the PGM file, to within the rounding of float32 values; corrupt
+  // files are rejected.
+  const string ref = "geoidtest-vref", pgm = writegeoid(ref),
+    gtxname = "geoidtest-gtx", gtx = gtxname + ".gtx",
+    tifname = "geoidtest-tif", tif = tifname + ".tif";
+  const int n = 500;
+  vector<T> lat(n), lon(n), h(n);
+  for (int i = 0; i < n; ++i) {
+    lat[i] = T(89.9) * sin(T(i) * T(0.37));
+    lon[i] = remainder(T(i) * T(13.7), T(360));
+  }
+  lat[0] = 90; lat[1] = -90; lon[2] = 180; lon[3] = -180;
+  int result = 0;
+  auto compare = [&](const string& name, T tol) -> int {
+    int r = 0;
+    for (int cubic = 0; cubic < 2; ++cubic) {
+      const Geoid g(ref, ".", cubic != 0), gv(name, ".", cubic != 0);
+      r += !(gv.Offset() == 0 && gv.Scale() == 1 && gv.MaxError() < 0 &&
+             gv.ThreadSafe());
+      gv.HeightBatch(n, lat.data(), lon.data(), h.data());
+      for (int i = 0; i < n; ++i) {
+        T h0 = g(lat[i], lon[i]);
+        r += checkEquals(gv(lat[i], lon[i]), h0, tol) +
+          checkEquals(h[i], h0, tol);
+      }
+    }
+    if (r) cout << "testgeoidvendor: " << name << " mismatch\n";
+    return r;
+  };
+  auto rejected = [](const string& name, const string& what) -> int {
+    try {
+      Geoid g(name, ".");
+      cout << "testgeoidvendor: " << what << " accepted\n";
+      return 1;
+    }
+    catch (const GeographicErr&) {}
+    return 0;
+  };
+  const T tol32 = T(2e-5), tol64 = T(1e-9);
+  const int lon0s[] = {0, -180, 10};
+  for (int k = 0; k < 3; ++k) {
+    writegtx(gtx, lon0s[k], k == 1);
+    result += compare(gtxname, tol32);
+  }
+  try {
+    GeoidPyramid::Coarsen(gtxname, gtxname + "x", 3, ".");
+    ++result;
+  }
+  catch (const GeographicErr&) {}
+  auto nofix = [](vector<tifftag>&) -> void {};
+  writetiff(tif, false, 32, true, 1, nofix);
+  result += compare(tifname, tol32);
+  writetiff(tif, true, 64, false, 7, nofix);
+  result += compare(tifname, tol64);
+  writetiff(tif, false, 64, true, 3, nofix);
+  result += compare(tifname, tol64);
+  writetiff(tif, true, 32, false, 1, nofix);
+  result += compare(tifname, tol32);
+  // Corrupt GTX files: the wrong length (from the number of rows or of
+  // columns), a regional grid, a grid not aligned with longitude 0, an
+  // origin which is a NaN or huge, and a truncated header
+  const double nan = numeric_limits<double>::quiet_NaN();
+  const double gtxbad[][6] = {
+    {-90, 0, 2, 2, gheight + 1, gwidth},
+    {-90, 0, 2, 2, gheight, -gwidth},
+    {-90, 0, 1, 2, gheight, gwidth},
+    {-90, 1, 2, 2, gheight, gwidth},
+    {-90, nan, 2, 2, gheight, gwidth},
+    {-90, 1e300, 2, 2, gheight, gwidth},
+    {-90, 0, nan, 2, gheight, gwidth},
+  };
+  for (const auto& hdr : gtxbad) {
+    writegtx(gtx, 0, false, vector<double>(hdr, hdr + 6));
+    result += rejected(gtxname, "corrupt GTX header");
+  }
+  {
+    ofstream out(gtx.c_str(), ios::binary);
+    out.write("\x40\x56\x80", 3);
+  }
+  result += rejected(gtxname, "truncated GTX header");
+  // Corrupt GeoTIFF files
+  auto settag = [](vector<tifftag>& tags, unsigned tag, double v) -> void {
+    for (auto& t : tags)
+      if (t.tag == tag) t.v[0] = v;
+  };
+  auto droptag = [](vector<tifftag>& tags, unsigned tag) -> void {
+    for (size_t i = 0; i < tags.size(); ++i)
+      if (tags[i].tag == tag) tags.erase(tags.begin() + i);
+  };
+  const int ntiff = 12;
+  for (int k = 0; k < ntiff; ++k) {
+    writetiff(tif, k % 2 == 0, 32, false, 3, [&](vector<tifftag>& tags)
+              -> void {
+      switch (k) {
+      case 0: droptag(tags, 33922); break;           // No tie point
+      case 1: settag(tags, 259, 5); break;           // Compressed
+      case 2: settag(tags, 339, 1); break;           // Integers
+      case 3: settag(tags, 258, 16); break;          // Half floats
+      case 4:                                        // Tiled
+        tags.push_back(tifftag{322, 4, vector<double>(1, 16), 0}); break;
+      case 5: tags[4].v[1] += 4; break;              // Strips with a gap
+      case 6: tags[6].v[0] -= 4; break;              // Too little data
+      case 7: tags[10].v[4] = -89; break;            // Rows south to north
+      case 8: tags[4].count = 0x40000000ULL; break;  // A huge count
+      case 9: settag(tags, 256, 4294967295.); break; // A huge width
+      case 10: tags[9].type = 5; break;              // A rational
+      default: settag(tags, 33550, 0); break;        // Zero spacing
+      }
+    });
+    result += rejected(tifname, "corrupt TIFF " + Utility::str(k));
+  }
+  // Not a classic TIFF file (BigTIFF), and the IFD past the end of file
+  writetiff(tif, false, 32, false, 1, nofix);
+  patchfile(tif, 2, 43);
+  result += rejected(tifname, "BigTIFF");
+  writetiff(tif, true, 32, false, 1, nofix);
+  patchfile(tif, 4, 0x7f);
+  result += rejected(tifname, "TIFF with a bad IFD offset");
+  remove(gtx.c_str());
+  remove(tif.c_str());
+  remove(pgm.c_str());
+  return result;
+}
+
+static int testgeoidembedded() {
+  // A name which isn't compiled into the library isn't found and the
+  // outputs are left alone; an embedded geoid (if any) gives the same
+  // heights, pointwise and in a batch, as the file it was made from.
+  const char* data = nullptr;
+  size_t size = 7;
+  int result = Utility::EmbeddedData("geoids/no-such-geoid.pgm", data, size)
+    || data != nullptr || size != 7;
+#if defined(GEOGRAPHICLIB_TEST_EMBEDDED_GEOID)
+  const string name = GEOGRAPHICLIB_TEST_EMBEDDED_GEOID;
+  const Geoid ge(name, ""), gf(name, GEOGRAPHICLIB_TEST_EMBEDDED_DIR);
+  result += ge.GeoidFile().compare(0, 9, "embedded:") != 0 ||
+    gf.GeoidFile().compare(0, 9, "embedded:") == 0;
+  result += ge.Description() != gf.Description() ||
+    ge.DateTime() != gf.DateTime();
+  const int n = 500;
+  vector<T> lat(n), lon(n), h(n);
+  for (int i = 0; i < n; ++i) {
+    lat[i] = T(89.9) * sin(T(i) * T(0.37));
+    lon[i] = remainder(T(i) * T(13.7), T(360));
+  }
+  ge.HeightBatch(n, lat.data(), lon.data(), h.data());
+  for (int i = 0; i < n; ++i) {
+    const T hf = gf(lat[i], lon[i]);
+    result += checkSame(ge(lat[i], lon[i]), hf) + checkSame(h[i], hf);
+  }
+#endif
+  return result;
+}
+
+static int testgeoidpolicy() {
+  // The area cache, allocated with each page size and node and replicated
+  // for a thread safe geoid (if there's more than one node), gives the
+  // same heights as reading the file, also on several threads.
+  const string name = "geoidtest-policy", pgm = writegeoid(name);
+  const int n = 1000;
+  vector<T> lat(n), lon(n), h(n), hb(n);
+  for (int i = 0; i < n; ++i) {
+    lat[i] = T(89.9) * sin(T(i) * T(0.37));
+    lon[i] = remainder(T(i) * T(13.7), T(360));
+  }
+  const Geoid g0(name, ".");
+  for (int i = 0; i < n; ++i) h[i] = g0(lat[i], lon[i]);
+  int result = 0;
+  for (int k = 0; k < 6; ++k) {
+    // k % 3 = page size, k / 3 = area cache or thread safe
+    MemoryPolicy::SetPages(MemoryPolicy::pages(k % 3));
+    MemoryPolicy::SetNode(k % 2 ? 0 : -1);
+    MemoryPolicy::SetReplicate(k >= 3);
+    Geoid g(name, ".", true, k >= 3);
+    if (k < 3) g.CacheArea(-60, -170, 70, 170);
+    MemoryPolicy::SetPages(MemoryPolicy::SMALLPAGES);
+    MemoryPolicy::SetNode(-1);
+    MemoryPolicy::SetReplicate(false);
+    GeodesicBatchExecutor exec(k >= 3 ? 4 : 1, 16);
+    exec.ForEach(n, [&](size_t i0, size_t i1) -> void {
+      for (size_t i = i0; i < i1; ++i) hb[i] = g(lat[i], lon[i]);
+    });
+    int j = 0;
+    for (int i = 0; i < n; ++i) j += checkSame(hb[i], h[i]);
+    if (j) cout << "testgeoidpolicy failure: case " << k << "\n";
+    result += j;
+  }
+  remove(pgm.c_str());
+  return result;
+}
+
+int main() {
+  int n = 0, i;
+
+  i = testgeoidconcurrent(); n += i;
+  if (i) cout << "testgeoidconcurrent failure\n";
+
+  i = testgeoidtiles(); n += i;
+  if (i) cout << "testgeoidtiles failure\n";
+
+  i = testgeoidbatch(); n += i;
+  if (i) cout << "testgeoidbatch failure\n";
+
+  i = testgeoidcompressed(); n += i;
+  if (i) cout << "testgeoidcompressed failure\n";
+
+  i = testgeoidsnapshot(); n += i;
+  if (i) cout << "testgeoidsnapshot failure\n";
+
+  i = testgeoidcopy(); n += i;
+  if (i) cout << "testgeoidcopy failure\n";
+
+  i = testgeoidasync(); n += i;
+  if (i) cout << "testgeoidasync failure\n";
+
+  i = testgeoidcoalesce(); n += i;
+  if (i) cout << "testgeoidcoalesce failure\n";
+
+  i = testgeoidfits(); n += i;
+  if (i) cout << "testgeoidfits failure\n";
+
+  i = testgeoidpyramid(); n += i;
+  if (i) cout << "testgeoidpyramid failure\n";
+
+  i = testgeoidvendor(); n += i;
+  if (i) cout << "testgeoidvendor failure\n";
+
+  i = testgeoidembedded(); n += i;
+  if (i) cout << "testgeoidembedded failure\n";
+
+  i = testgeoidpolicy(); n += i;
+  if (i) cout << "testgeoidpolicy failure\n";
+
+  if (n) {
+    cout << n << " failure" << (n > 1 ? "s" : "") << "\n";
+    return 1;
+  }
+}
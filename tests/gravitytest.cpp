@@ -0,0 +1,645 @@
+/**
+ * \file gravitytest.cpp
+ * \brief Test the gravity models with a synthetic model
+ *
+ * Copyright (c) Charles Karney (2022) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+#include <GeographicLib/Geocentric.hpp>
+#include <GeographicLib/GeodesicBatchExecutor.hpp>
+#include <GeographicLib/Geoid.hpp>
+#include <GeographicLib/GeoidGrid.hpp>
+#include <GeographicLib/GravityCircle.hpp>
+#include <GeographicLib/GravityModel.hpp>
+#include <GeographicLib/GridEvaluator.hpp>
+#include <GeographicLib/NormalGravity.hpp>
+#include <GeographicLib/SphericalEngine.hpp>
+#include <GeographicLib/Utility.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+typedef Math::real T;
+
+static int checkEquals(T x, T y, T d) {
+  if (fabs(x - y) <= d)
+    return 0;
+  cout << "checkEquals fails: " << x << " != " << y << " +/- " << d << "\n";
+  return 1;
+}
+
+static int checkSame(T x, T y) {
+  // Results computed in different ways must be bitwise identical
+  if (x == y || (isnan(x) && isnan(y)))
+    return 0;
+  cout << "checkSame fails: " << x << " != " << y << "\n";
+  return 1;
+}
+
+// Write a synthetic gravity model of degree N, with the WGS84 normal
+// gravity field and a small disturbing potential, to the current
+// directory.
+static void writegravity(const string& name, int N) {
+  {
+    ofstream meta((name + ".egm").c_str());
+    meta << "EGMF-1\nName " << name << "\nModelRadius 6378136.3\n"
+         << "ModelMass 3986004.415e8\nAngularVelocity 7292115e-11\n"
+         << "ReferenceRadius 6378137\nReferenceMass 3986004.418e8\n"
+         << "Flattening 1/298.257223563\nHeightOffset -0.41\n"
+         << "ID GRAVTEST\n";
+  }
+  ofstream out((name + ".egm.cof").c_str(), ios::binary);
+  out.write("GRAVTEST", 8);
+  // The gravitational coefficients and the geoid height correction
+  const int Nk[] = {N, 4};
+  for (int k = 0; k < 2; ++k) {
+    int nm[2] = {Nk[k], Nk[k]};
+    Utility::writearray<int, int, false>(out, nm, 2);
+    vector<double>
+      C(SphericalEngine::coeff::Csize(Nk[k], Nk[k])),
+      S(SphericalEngine::coeff::Ssize(Nk[k], Nk[k]));
+    for (size_t j = 0; j < C.size(); ++j)
+      C[j] = (k ? 0.1 : 1e-6) * sin(double(j) + 1) / double(j + 1);
+    for (size_t j = 0; j < S.size(); ++j)
+      S[j] = (k ? 0.1 : 1e-6) * cos(double(j) + 1) / double(j + 2);
+    if (k == 0) {
+      // No degree 0 term; C20 (fully normalized) as for the earth
+      C[0] = 0; C[2] = -4.841652e-4;
+    }
+    Utility::writearray<double, double, false>(out, C);
+    Utility::writearray<double, double, false>(out, S);
+  }
+}
+
+static void removegravity(const string& name) {
+  remove((name + ".egm").c_str());
+  remove((name + ".egm.cof").c_str());
+}
+
+static int testgravitybatch() {
+  // GravityBatch agrees with Gravity for each point, on one thread and on
+  // several; the points include groups on the same circle of latitude
+  // (evaluated with a GravityCircle) and scattered points.
+  const string name = "gravitytest-batch";
+  writegravity(name, 36);
+  const GravityModel g(name, ".");
+  const int n = 200;
+  vector<T> lat(n), lon(n), h(n), W(n), gx(n), gy(n), gz(n);
+  for (int i = 0; i < n; ++i) {
+    bool circle = i % 4 == 0;
+    lat[i] = circle ? T(35.5) : T(89) * sin(T(i) * T(0.37));
+    lon[i] = remainder(T(i) * T(13.7), T(360));
+    h[i] = circle ? 1000 : T(i % 9) * 2000 - 500;
+  }
+  int result = 0;
+  for (unsigned nthreads = 1; nthreads <= 3; nthreads += 2) {
+    g.GravityBatch(n, lat.data(), lon.data(), h.data(), W.data(),
+                   gx.data(), gy.data(), gz.data(), nthreads);
+    for (int i = 0; i < n; ++i) {
+      T gxa, gya, gza, Wa = g.Gravity(lat[i], lon[i], h[i], gxa, gya, gza);
+      result += checkEquals(W[i], Wa, T(1e-7)) +
+        checkEquals(gx[i], gxa, T(1e-13)) +
+        checkEquals(gy[i], gya, T(1e-13)) +
+        checkEquals(gz[i], gza, T(1e-13));
+    }
+  }
+  removegravity(name);
+  return result;
+}
+
+static int testgridevaluator() {
+  // GridEvaluator gives the same results as the corresponding
+  // GravityCircle functions and agrees with the point functions.
+  const string name = "gravitytest-grid";
+  writegravity(name, 24);
+  const GravityModel g(name, ".");
+  const int nlat = 9, nlon = 10;
+  const T h = 500;
+  int result = 0;
+  for (unsigned nthreads = 1; nthreads <= 3; nthreads += 2) {
+    // North-up layout
+    const GridEvaluator grid(60, -15, nlat, -180, 37, nlon, nthreads);
+    result += grid.Size() != size_t(nlat * nlon);
+    vector<T> W(grid.Size()), gx(grid.Size()), gy(grid.Size()),
+      gz(grid.Size()), Tp(grid.Size()), dx(grid.Size()), dy(grid.Size()),
+      dz(grid.Size()), N(grid.Size()), Dg(grid.Size()), xi(grid.Size()),
+      eta(grid.Size()), gza(grid.Size());
+    grid.Gravity(g, h, W.data(), gx.data(), gy.data(), gz.data());
+    grid.Disturbance(g, h, Tp.data(), dx.data(), dy.data(), dz.data());
+    grid.GeoidHeight(g, N.data());
+    grid.SphericalAnomaly(g, h, Dg.data(), xi.data(), eta.data());
+    // Only some of the outputs requested
+    grid.Gravity(g, h, nullptr, nullptr, nullptr, gza.data());
+    for (int i = 0; i < nlat; ++i) {
+      T lat = grid.Latitude(i);
+      // The geoid height is only available for circles with h = 0
+      const GravityCircle c(g.Circle(lat, h)), c0(g.Circle(lat, 0));
+      for (int j = 0; j < nlon; ++j) {
+        size_t k = size_t(i) * nlon + j;
+        T lon = grid.Longitude(j), x, y, z, v;
+        v = c.Gravity(lon, x, y, z);
+        result += checkSame(W[k], v) + checkSame(gx[k], x) +
+          checkSame(gy[k], y) + checkSame(gz[k], z) + checkSame(gza[k], z);
+        v = g.Gravity(lat, lon, h, x, y, z);
+        result += checkEquals(W[k], v, T(1e-7)) +
+          checkEquals(gz[k], z, T(1e-13));
+        v = c.Disturbance(lon, x, y, z);
+        result += checkSame(Tp[k], v) + checkSame(dx[k], x) +
+          checkSame(dy[k], y) + checkSame(dz[k], z);
+        result += checkSame(N[k], c0.GeoidHeight(lon)) +
+          checkEquals(N[k], g.GeoidHeight(lat, lon), T(1e-9));
+        c.SphericalAnomaly(lon, v, x, y);
+        result += checkSame(Dg[k], v) + checkSame(xi[k], x) +
+          checkSame(eta[k], y);
+      }
+    }
+  }
+  try {
+    GridEvaluator grid(-80, -6, 3, 0, 1, 1);
+    ++result;
+  }
+  catch (const GeographicErr&) {}
+  try {
+    GridEvaluator grid(0, 1, 1, 0, 1, -1);
+    ++result;
+  }
+  catch (const GeographicErr&) {}
+  removegravity(name);
+  return result;
+}
+
+static int testgravitymapfile() {
+  // A memory mapped gravity model (optionally truncated) gives the same
+  // results as one which is read; a truncated coefficient file is rejected
+  // whether or not it is mapped.
+  const string name = "gravitytest-map";
+  writegravity(name, 20);
+  // Mapping requires little-endian IEEE doubles
+  const bool canmap = numeric_limits<T>::is_iec559 &&
+    sizeof(T) == sizeof(double) && !Math::bigendian;
+  int result = 0;
+  for (int trunc = 0; trunc < 2; ++trunc) {
+    int Nmax = trunc ? 12 : -1, Mmax = trunc ? 9 : -1;
+    const GravityModel g(name, ".", Nmax, Mmax);
+    if (!canmap) {
+      try {
+        GravityModel gm(name, ".", Nmax, Mmax, true);
+        ++result;
+      }
+      catch (const GeographicErr&) {}
+      continue;
+    }
+    const GravityModel gm(name, ".", Nmax, Mmax, true);
+    result += g.MemoryMapped() || !gm.MemoryMapped();
+    result += gm.Degree() != g.Degree() || gm.Order() != g.Order();
+    for (int i = 0; i < 10; ++i) {
+      T lat = 17 * T(i) - 80, lon = 41 * T(i) - 190, h = 300 * T(i),
+        gx, gy, gz, gxa, gya, gza;
+      result += checkSame(gm.Gravity(lat, lon, h, gxa, gya, gza),
+                          g.Gravity(lat, lon, h, gx, gy, gz)) +
+        checkSame(gxa, gx) + checkSame(gya, gy) + checkSame(gza, gz);
+      result += checkSame(gm.GeoidHeight(lat, lon),
+                          g.GeoidHeight(lat, lon));
+    }
+  }
+  {
+    // Chop the end off the coefficient file
+    ifstream in((name + ".egm.cof").c_str(), ios::binary);
+    string data((istreambuf_iterator<char>(in)),
+                istreambuf_iterator<char>());
+    in.close();
+    ofstream out((name + ".egm.cof").c_str(), ios::binary);
+    out.write(data.data(), streamsize(data.size() - 12));
+  }
+  for (int mapfile = 0; mapfile < 2; ++mapfile) {
+    try {
+      GravityModel g(name, ".", -1, -1, mapfile != 0);
+      ++result;
+    }
+    catch (const GeographicErr&) {}
+  }
+  removegravity(name);
+  return result;
+}
+
+static int testgravitytruncated() {
+  // A truncated view of a gravity model gives the same results as a model
+  // loaded with the same truncation, even after the original model has
+  // been destroyed.
+  const string name = "gravitytest-trunc";
+  writegravity(name, 20);
+  const int Nmax[] = {12, 10, 20, -1, 0}, Mmax[] = {9, -1, 3, -1, 0};
+  int result = 0;
+  for (int k = 0; k < 5; ++k) {
+    const GravityModel g(name, ".", Nmax[k], Mmax[k]);
+    unique_ptr<GravityModel> full(new GravityModel(name, "."));
+    const GravityModel gv(*full, Nmax[k], Mmax[k]);
+    full.reset();
+    result += gv.Degree() != g.Degree() || gv.Order() != g.Order();
+    for (int i = 0; i < 10; ++i) {
+      T lat = 17 * T(i) - 80, lon = 41 * T(i) - 190, h = 300 * T(i),
+        gx, gy, gz, gxa, gya, gza;
+      result += checkSame(gv.Gravity(lat, lon, h, gxa, gya, gza),
+                          g.Gravity(lat, lon, h, gx, gy, gz)) +
+        checkSame(gxa, gx) + checkSame(gya, gy) + checkSame(gza, gz);
+      result += checkSame(gv.GeoidHeight(lat, lon),
+                          g.GeoidHeight(lat, lon));
+    }
+  }
+  try {
+    const GravityModel g(name, ".");
+    GravityModel gv(g, 5, 6);
+    ++result;
+  }
+  catch (const GeographicErr&) {}
+  removegravity(name);
+  return result;
+}
+
+static int testgeoidgrid() {
+  // The heights interpolated in a GeoidGrid agree with
+  // GravityModel::GeoidHeight to within the error estimate; the grid is
+  // saved and reused; a global grid can be read by Geoid, but a regional
+  // one is rejected.
+  const string name = "gravitytest-grid";
+  writegravity(name, 20);
+  const GravityModel g(name, ".");
+  int result = 0;
+  {
+    const string file = "gravitytest-regional.pgm";
+    remove(file.c_str());
+    const T tol = T(0.002);
+    const GeoidGrid grid(g, 10, 30, 20, 45, tol, file, 16, 3);
+    result += !grid.Synthesized() || grid.Global();
+    result += !(grid.MaxError() <= tol && grid.South() <= 10 &&
+                grid.West() <= 30 && grid.North() >= 20 &&
+                grid.East() >= 45);
+    for (int i = 0; i < 20; ++i) {
+      T lat = 10 + T(0.49) * T(i), lon = 30 + T(0.73) * T(i);
+      result += checkEquals(grid(lat, lon), g.GeoidHeight(lat, lon),
+                            2 * tol);
+    }
+    result += !isnan(grid(25, 40));
+    // Reused when the tolerance is met
+    const GeoidGrid grida(g, 12, 31, 19, 44, 2 * tol, file, 16, 3),
+      gridb(file);
+    result += grida.Synthesized() || gridb.Synthesized();
+    for (int i = 0; i < 20; ++i) {
+      T lat = 12 + T(0.33) * T(i), lon = 31 + T(0.61) * T(i);
+      result += checkSame(grida(lat, lon), grid(lat, lon)) +
+        checkSame(gridb(lat, lon), grid(lat, lon));
+    }
+    try {
+      Geoid geoid("gravitytest-regional", ".");
+      ++result;
+    }
+    catch (const GeographicErr&) {}
+    remove(file.c_str());
+  }
+  {
+    const string file = "gravitytest-global.pgm";
+    const GeoidGrid grid(g, -90, -180, 90, 180, 1, "", 2);
+    result += !grid.Global();
+    grid.Save(file);
+    const Geoid geoid("gravitytest-global", ".", false);
+    for (int i = 0; i < 20; ++i) {
+      T lat = 9 * T(i) - 85, lon = 19 * T(i) - 180;
+      result += checkEquals(geoid(lat, lon), grid(lat, lon), T(1e-6));
+    }
+    remove(file.c_str());
+  }
+  try {
+    GeoidGrid grid(g, 20, 30, 10, 45, 1);
+    ++result;
+  }
+  catch (const GeographicErr&) {}
+  removegravity(name);
+  return result;
+}
+
+static int testgravitycache() {
+  // With a cache of circles, the point functions give the results for the
+  // circle at the rounded latitude and height; the cache is bounded and
+  // may be used concurrently.
+  const string name = "gravitytest-cache";
+  writegravity(name, 20);
+  const GravityModel g(name, "."), g0(name, ".");
+  const T dlat = T(0.25), dh = 10;
+  g.CacheCircles(dlat, dh);
+  int result = !g.CachingCircles() || g0.CachingCircles();
+  const int n = 40;
+  vector<T> lat(n), lon(n), h(n);
+  for (int i = 0; i < n; ++i) {
+    // 3 distinct circles, (30.25, 0), (30.25, 100), and (31.25, 100)
+    lat[i] = T(30.2) + (i % 4 == 3 ? 1 : 0) + T(0.01) * T(i % 3);
+    h[i] = 100 * T(i % 2) + T(i % 5);
+    lon[i] = 11 * T(i) - 180;
+  }
+  for (int i = 0; i < n; ++i) {
+    const GravityCircle
+      c(g0.Circle(round(lat[i] / dlat) * dlat, round(h[i] / dh) * dh)),
+      c0(g0.Circle(round(lat[i] / dlat) * dlat, 0));
+    T gx, gy, gz, gxa, gya, gza, Dg, xi, eta, Dga, xia, etaa;
+    result += checkSame(g.Gravity(lat[i], lon[i], h[i], gx, gy, gz),
+                        c.Gravity(lon[i], gxa, gya, gza)) +
+      checkSame(gx, gxa) + checkSame(gy, gya) + checkSame(gz, gza);
+    result += checkSame(g.Disturbance(lat[i], lon[i], h[i], gx, gy, gz),
+                        c.Disturbance(lon[i], gxa, gya, gza)) +
+      checkSame(gx, gxa) + checkSame(gy, gya) + checkSame(gz, gza);
+    result += checkSame(g.GeoidHeight(lat[i], lon[i]),
+                        c0.GeoidHeight(lon[i]));
+    g.SphericalAnomaly(lat[i], lon[i], h[i], Dg, xi, eta);
+    c.SphericalAnomaly(lon[i], Dga, xia, etaa);
+    result += checkSame(Dg, Dga) + checkSame(xi, xia) + checkSame(eta, etaa);
+  }
+  // One more circle, (31.25, 0), for the geoid height; each is made once
+  result += g.CircleCacheSize() != 4 || g.CircleCacheMisses() != 4 ||
+    g.CircleCacheHits() != 4 * n - 4;
+  vector<T> W(n), Wa(n);
+  for (int i = 0; i < n; ++i) {
+    T gx, gy, gz;
+    W[i] = g.Gravity(lat[i], lon[i], h[i], gx, gy, gz);
+  }
+  // A cache holding just one circle, used on several threads
+  g.CacheCircles(dlat, dh, 1);
+  result += g.CircleCacheCapacity() != 1;
+  atomic<int> bad(0);
+  GeodesicBatchExecutor(4, 3).ForEach
+    (n, [&](size_t i0, size_t i1) -> void {
+      for (size_t i = i0; i < i1; ++i) {
+        T gx, gy, gz;
+        if (g.Gravity(lat[i], lon[i], h[i], gx, gy, gz) != W[i]) ++bad;
+      }
+    });
+  result += bad + (g.CircleCacheSize() != 1);
+  g.CircleCacheClear();
+  result += g.CachingCircles();
+  try {
+    g.CacheCircles(0, dh);
+    ++result;
+  }
+  catch (const GeographicErr&) {}
+  removegravity(name);
+  return result;
+}
+
+static int testcirclethreads() {
+  // The CircularEngine objects of a GravityCircle set up on several threads
+  // give the same results as those set up on one thread.
+  const string name = "gravitytest-threads";
+  writegravity(name, 30);
+  const GravityModel g(name, ".");
+  int result = 0;
+  const T lats[] = {-75, 0, 42.5};
+  const T hs[] = {0, 2500};
+  for (T lat : lats)
+    for (T h : hs) {
+      const GravityCircle c1(g.Circle(lat, h));
+      GravityCircle c0(g.Circle(lat, h, GravityModel::ALL, 0)), c3;
+      g.Circle(lat, h, GravityModel::ALL, c3, 3);
+      const GravityCircle* cs[] = {&c0, &c3};
+      for (const GravityCircle* c : cs)
+        for (int j = 0; j < 12; ++j) {
+          T lon = 30 * T(j) - 175;
+          T gx, gy, gz, gxa, gya, gza, Dg, xi, eta, Dga, xia, etaa;
+          result += checkSame(c->Gravity(lon, gx, gy, gz),
+                              c1.Gravity(lon, gxa, gya, gza)) +
+            checkSame(gx, gxa) + checkSame(gy, gya) + checkSame(gz, gza);
+          result += checkSame(c->Disturbance(lon, gx, gy, gz),
+                              c1.Disturbance(lon, gxa, gya, gza)) +
+            checkSame(gx, gxa) + checkSame(gy, gya) + checkSame(gz, gza);
+          result += checkSame(c->GeoidHeight(lon), c1.GeoidHeight(lon));
+          c->SphericalAnomaly(lon, Dg, xi, eta);
+          c1.SphericalAnomaly(lon, Dga, xia, etaa);
+          result += checkSame(Dg, Dga) + checkSame(xi, xia) +
+            checkSame(eta, etaa);
+        }
+    }
+  removegravity(name);
+  return result;
+}
+
+static int testpointbatches() {
+  // DisturbanceBatch, GeoidHeightBatch, and SphericalAnomalyBatch agree
+  // with Disturbance, GeoidHeight, and SphericalAnomaly for each point.
+  // The model mass differs from the reference mass, so this also checks
+  // that the disturbing potential from the point functions agrees with
+  // that from GravityCircle.
+  const string name = "gravitytest-pointbatch";
+  writegravity(name, 36);
+  const GravityModel g(name, ".");
+  const Geocentric earth(g.EquatorialRadius(), g.Flattening());
+  const int n = 200;
+  vector<T> lat(n), lon(n), h(n), Tv(n), dx(n), dy(n), dz(n),
+    N(n), Dg(n), xi(n), eta(n);
+  for (int i = 0; i < n; ++i) {
+    bool circle = i % 4 == 0;
+    lat[i] = circle ? T(-12.5) : T(89) * sin(T(i) * T(0.41));
+    lon[i] = remainder(T(i) * T(17.3), T(360));
+    h[i] = circle ? 300 : T(i % 7) * 3000 - 400;
+  }
+  int result = 0;
+  for (unsigned nthreads = 1; nthreads <= 3; nthreads += 2) {
+    g.DisturbanceBatch(n, lat.data(), lon.data(), h.data(), Tv.data(),
+                       dx.data(), dy.data(), dz.data(), nthreads);
+    g.GeoidHeightBatch(n, lat.data(), lon.data(), N.data(), nthreads);
+    g.SphericalAnomalyBatch(n, lat.data(), lon.data(), h.data(), Dg.data(),
+                            xi.data(), eta.data(), nthreads);
+    for (int i = 0; i < n; ++i) {
+      T dxa, dya, dza, Dga, xia, etaa,
+        Ta = g.Disturbance(lat[i], lon[i], h[i], dxa, dya, dza);
+      result += checkEquals(Tv[i], Ta, T(1e-9)) +
+        checkEquals(dx[i], dxa, T(1e-13)) +
+        checkEquals(dy[i], dya, T(1e-13)) +
+        checkEquals(dz[i], dza, T(1e-13));
+      result += checkEquals(N[i], g.GeoidHeight(lat[i], lon[i]), T(1e-9));
+      g.SphericalAnomaly(lat[i], lon[i], h[i], Dga, xia, etaa);
+      result += checkEquals(Dg[i], Dga, T(1e-13)) +
+        checkEquals(xi[i], xia, T(1e-13)) +
+        checkEquals(eta[i], etaa, T(1e-13));
+    }
+  }
+  for (int i = 0; i < n; i += 9) {
+    T dxa, dya, dza, dxb, dyb, dzb;
+    const GravityCircle c(g.Circle(lat[i], h[i], GravityModel::DISTURBANCE));
+    result +=
+      checkEquals(g.Disturbance(lat[i], lon[i], h[i], dxa, dya, dza),
+                  c.Disturbance(lon[i], dxb, dyb, dzb), T(1e-9)) +
+      checkEquals(dxa, dxb, T(1e-13)) + checkEquals(dya, dyb, T(1e-13)) +
+      checkEquals(dza, dzb, T(1e-13));
+    T X, Y, Z;
+    earth.Forward(lat[i], lon[i], h[i], X, Y, Z);
+    result += checkEquals(g.T(X, Y, Z), c.T(lon[i]), T(1e-9));
+  }
+  removegravity(name);
+  return result;
+}
+
+static int testnormalbatch() {
+  // NormalGravity::GravityBatch and UBatch give the same results as Gravity
+  // and U.  With nearsurface set, GravityBatch gives the results of
+  // GravityNearSurface for |h| <= 10 km; these agree with Gravity to 2e-6
+  // m/s^2 and 1e-2 m^2/s^2.
+  const int n = 300;
+  vector<T> lat(n), h(n), U(n), gy(n), gz(n), X(n), Y(n), Z(n),
+    gX(n), gY(n), gZ(n);
+  for (int i = 0; i < n; ++i) {
+    lat[i] = 90 * sin(T(i) / 7);
+    h[i] = T(i % 11) * 2500 - 12500;
+  }
+  lat[0] = 90; lat[1] = -90;
+  const NormalGravity* earths[] = {&NormalGravity::WGS84(),
+                                   &NormalGravity::GRS80()};
+  int result = 0;
+  for (const NormalGravity* e : earths) {
+    e->GravityBatch(n, lat.data(), h.data(), U.data(), gy.data(), gz.data());
+    for (int i = 0; i < n; ++i) {
+      T gya, gza, Ua = e->Gravity(lat[i], h[i], gya, gza);
+      result += checkSame(U[i], Ua) + checkSame(gy[i], gya) +
+        checkSame(gz[i], gza);
+    }
+    e->GravityBatch(n, lat.data(), h.data(), U.data(), gy.data(), gz.data(),
+                    true);
+    for (int i = 0; i < n; ++i) {
+      T gya, gza, Ua = e->Gravity(lat[i], h[i], gya, gza);
+      if (fabs(h[i]) <= 10000) {
+        result += checkEquals(U[i], Ua, T(1e-2)) +
+          checkEquals(gy[i], gya, T(2e-7)) +
+          checkEquals(gz[i], gza, T(2e-6));
+        Ua = e->GravityNearSurface(lat[i], h[i], gya, gza);
+      }
+      result += checkSame(U[i], Ua) + checkSame(gy[i], gya) +
+        checkSame(gz[i], gza);
+    }
+    const Geocentric earth(e->EquatorialRadius(), e->Flattening());
+    for (int i = 0; i < n; ++i)
+      earth.Forward(lat[i], T(i) * T(7.3), h[i], X[i], Y[i], Z[i]);
+    e->UBatch(n, X.data(), Y.data(), Z.data(), U.data(),
+              gX.data(), gY.data(), gZ.data());
+    for (int i = 0; i < n; ++i) {
+      T gXa, gYa, gZa, Ua = e->U(X[i], Y[i], Z[i], gXa, gYa, gZa);
+      result += checkSame(U[i], Ua) + checkSame(gX[i], gXa) +
+        checkSame(gY[i], gYa) + checkSame(gZ[i], gZa);
+    }
+  }
+  return result;
+}
+
+static int testgravitycopy() {
+  // A copy of a GravityModel (read, memory mapped, or a truncated view)
+  // gives the same results after the original is destroyed.
+  const string name = "gravitytest-copy";
+  writegravity(name, 20);
+  const bool canmap = numeric_limits<T>::is_iec559 &&
+    sizeof(T) == sizeof(double) && !Math::bigendian;
+  int result = 0;
+  for (int k = 0; k < 3; ++k) {
+    // 0 = read, 1 = memory mapped, 2 = truncated view
+    if (k == 1 && !canmap) continue;
+    unique_ptr<GravityModel> g(new GravityModel(name, ".", -1, -1, k == 1));
+    if (k == 2) g.reset(new GravityModel(*g, 12, 9));
+    const int n = 10;
+    T W[n], gx[n], gy[n], gz[n], N[n];
+    for (int i = 0; i < n; ++i) {
+      W[i] = g->Gravity(17 * T(i) - 80, 35 * T(i) - 170, 100 * T(i),
+                        gx[i], gy[i], gz[i]);
+      N[i] = g->GeoidHeight(17 * T(i) - 80, 35 * T(i) - 170);
+    }
+    GravityModel gc(*g);
+    result += gc.Degree() != g->Degree() || gc.Order() != g->Order();
+    g.reset();
+    for (int i = 0; i < n; ++i) {
+      T gxa, gya, gza;
+      result += checkSame(gc.Gravity(17 * T(i) - 80, 35 * T(i) - 170,
+                                     100 * T(i), gxa, gya, gza), W[i]) +
+        checkSame(gxa, gx[i]) + checkSame(gya, gy[i]) +
+        checkSame(gza, gz[i]) +
+        checkSame(gc.GeoidHeight(17 * T(i) - 80, 35 * T(i) - 170), N[i]);
+    }
+  }
+  removegravity(name);
+  return result;
+}
+
+static int testdisturbancemass() {
+  // Disturbance and T with the gradient used to misapply the n = 0 term
+  // for a model mass which differs from the reference mass (as it does
+  // for the synthetic model).  T must equal W - U and agree with
+  // GravityCircle.
+  const string name = "gravitytest-mass";
+  writegravity(name, 12);
+  const GravityModel g(name, ".");
+  const Geocentric earth(g.EquatorialRadius(), g.Flattening());
+  int result = 0;
+  for (int i = 0; i < 12; ++i) {
+    T lat = 15 * T(i) - 82, lon = 31 * T(i) - 175, h = 2500 * T(i % 5) - 300;
+    T X, Y, Z, gX, gY, gZ, gamX, gamY, gamZ, dX, dY, dZ, dx, dy, dz;
+    earth.Forward(lat, lon, h, X, Y, Z);
+    T WU = g.W(X, Y, Z, gX, gY, gZ) - g.U(X, Y, Z, gamX, gamY, gamZ);
+    result += checkEquals(g.T(X, Y, Z), WU, T(1e-6)) +
+      checkEquals(g.T(X, Y, Z, dX, dY, dZ), WU, T(1e-6)) +
+      checkEquals(dX, gX - gamX, T(1e-12)) +
+      checkEquals(dY, gY - gamY, T(1e-12)) +
+      checkEquals(dZ, gZ - gamZ, T(1e-12)) +
+      checkEquals(g.Disturbance(lat, lon, h, dx, dy, dz), WU, T(1e-6));
+    const GravityCircle c(g.Circle(lat, h, GravityModel::DISTURBANCE));
+    result += checkEquals(c.T(lon), WU, T(1e-6)) +
+      checkEquals(c.T(lon, dX, dY, dZ), WU, T(1e-6)) +
+      checkEquals(c.Disturbance(lon, dx, dy, dz), WU, T(1e-6));
+  }
+  removegravity(name);
+  return result;
+}
+
+int main() {
+  int n = 0, i;
+
+  i = testgravitybatch(); n += i;
+  if (i) cout << "testgravitybatch failure\n";
+
+  i = testgridevaluator(); n += i;
+  if (i) cout << "testgridevaluator failure\n";
+
+  i = testgravitymapfile(); n += i;
+  if (i) cout << "testgravitymapfile failure\n";
+
+  i = testgravitytruncated(); n += i;
+  if (i) cout << "testgravitytruncated failure\n";
+
+  i = testgeoidgrid(); n += i;
+  if (i) cout << "testgeoidgrid failure\n";
+
+  i = testgravitycache(); n += i;
+  if (i) cout << "testgravitycache failure\n";
+
+  i = testcirclethreads(); n += i;
+  if (i) cout << "testcirclethreads failure\n";
+
+  i = testpointbatches(); n += i;
+  if (i) cout << "testpointbatches failure\n";
+
+  i = testnormalbatch(); n += i;
+  if (i) cout << "testnormalbatch failure\n";
+
+  i = testgravitycopy(); n += i;
+  if (i) cout << "testgravitycopy failure\n";
+
+  i = testdisturbancemass(); n += i;
+  if (i) cout << "testdisturbancemass failure\n";
+
+  if (n) {
+    cout << n << " failure" << (n > 1 ? "s" : "") << "\n";
+    return 1;
+  }
+}
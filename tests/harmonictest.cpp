@@ -0,0 +1,638 @@
+/**
+ * \file harmonictest.cpp
+ * \brief Test the spherical harmonic sums
+ *
+ * Copyright (c) Charles Karney (2022) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <vector>
+#include <GeographicLib/CircularEngine.hpp>
+#include <GeographicLib/GeodesicBatchExecutor.hpp>
+#include <GeographicLib/MemoryPolicy.hpp>
+#include <GeographicLib/SphericalAnalysis.hpp>
+#include <GeographicLib/SphericalHarmonic.hpp>
+#include <GeographicLib/SphericalHarmonic1.hpp>
+#include <GeographicLib/Utility.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+typedef Math::real T;
+
+static int checkEquals(T x, T y, T d) {
+  if (fabs(x - y) <= d)
+    return 0;
+  cout << "checkEquals fails: " << x << " != " << y << " +/- " << d << "\n";
+  return 1;
+}
+
+static int checkSame(T x, T y) {
+  // Results computed in different ways must be bitwise identical
+  if (x == y || (isnan(x) && isnan(y)))
+    return 0;
+  cout << "checkSame fails: " << x << " != " << y << "\n";
+  return 1;
+}
+
+static int testvaluebatch() {
+  // SphericalHarmonic::ValueBatch gives the same values and gradients as
+  // operator() for each point, with both normalizations and with a number
+  // of points which isn't a multiple of the batch size.
+  const int N = 30, n = 21;
+  const T a = 1;
+  vector<T> C((N + 1) * (N + 2) / 2), S(N * (N + 1) / 2);
+  for (size_t k = 0; k < C.size(); ++k) C[k] = 1 / T(k + 1);
+  for (size_t k = 0; k < S.size(); ++k) S[k] = 1 / T(k + 2);
+  T x[n], y[n], z[n], v[n], gx[n], gy[n], gz[n], v1[n];
+  for (int i = 0; i < n; ++i) {
+    T r = 1 + T(i) / 20;
+    x[i] = r * cos(T(i)) * sin(T(i) / 3);
+    y[i] = r * sin(T(i)) * sin(T(i) / 3);
+    z[i] = r * cos(T(i) / 3);
+  }
+  // A point on the polar axis
+  x[5] = y[5] = 0;
+  int result = 0;
+  for (int norm = 0; norm < 2; ++norm) {
+    SphericalHarmonic h(C, S, N, a, norm ? SphericalHarmonic::SCHMIDT :
+                        SphericalHarmonic::FULL);
+    h.ValueBatch(n, x, y, z, v, gx, gy, gz);
+    h.ValueBatch(n, x, y, z, v1);
+    for (int i = 0; i < n; ++i) {
+      T gxa, gya, gza, va = h(x[i], y[i], z[i], gxa, gya, gza);
+      result += checkSame(v[i], va) + checkSame(gx[i], gxa) +
+        checkSame(gy[i], gya) + checkSame(gz[i], gza) +
+        checkSame(v1[i], h(x[i], y[i], z[i]));
+    }
+  }
+  return result;
+}
+
+static int testvalueparallel() {
+  // ValueParallel and CircleParallel give the same results as operator()
+  // and Circle for any number of threads.
+  const int N = 60;
+  const T a = 1;
+  vector<T> C((N + 1) * (N + 2) / 2), S(N * (N + 1) / 2);
+  for (size_t k = 0; k < C.size(); ++k) C[k] = 1 / T(k + 1);
+  for (size_t k = 0; k < S.size(); ++k) S[k] = 1 / T(k + 2);
+  int result = 0;
+  for (int norm = 0; norm < 2; ++norm) {
+    SphericalHarmonic h(C, S, N, a, norm ? SphericalHarmonic::SCHMIDT :
+                        SphericalHarmonic::FULL);
+    const T x = T(0.8), y = T(-0.7), z = T(0.6), p = hypot(x, y);
+    T gx, gy, gz, v = h(x, y, z, gx, gy, gz);
+    CircularEngine circ = h.Circle(p, z, true);
+    for (unsigned nthreads = 1; nthreads <= 4; ++nthreads) {
+      T gxa, gya, gza;
+      result += checkSame(h.ValueParallel(x, y, z, nthreads), h(x, y, z));
+      result += checkSame(h.ValueParallel(x, y, z, gxa, gya, gza, nthreads),
+                          v) +
+        checkSame(gxa, gx) + checkSame(gya, gy) + checkSame(gza, gz);
+      CircularEngine circa = h.CircleParallel(p, z, true, nthreads);
+      for (int lon = -180; lon < 180; lon += 45) {
+        T gxb, gyb, gzb;
+        result += checkSame(circa(T(lon), gxa, gya, gza),
+                            circ(T(lon), gxb, gyb, gzb)) +
+          checkSame(gxa, gxb) + checkSame(gya, gyb) + checkSame(gza, gzb);
+      }
+    }
+  }
+  return result;
+}
+
+static int testcirclevalues() {
+  // CircularEngine::Values agrees with operator() to within roundoff,
+  // including when the order exceeds the number of longitudes so that
+  // terms are folded in the transform.
+  const int N = 30;
+  const T a = 1;
+  vector<T> C((N + 1) * (N + 2) / 2), S(N * (N + 1) / 2);
+  for (size_t k = 0; k < C.size(); ++k) C[k] = 1 / T(k + 1);
+  for (size_t k = 0; k < S.size(); ++k) S[k] = 1 / T(k + 2);
+  const SphericalHarmonic h(C, S, N, a);
+  const CircularEngine circ = h.Circle(T(0.8), T(0.5), true);
+  const int nlon[] = {1, 7, 45, 64};
+  const T lon0 = T(-17.5), eps = numeric_limits<T>::epsilon();
+  int result = 0;
+  for (int n : nlon) {
+    vector<T> v(n), gx(n), gy(n), gz(n), w(n);
+    circ.Values(lon0, n, v.data(), gx.data(), gy.data(), gz.data());
+    circ.Values(lon0, n, w.data());
+    T vmax = 0, gmax = 0;
+    vector<T> va(n), gxa(n), gya(n), gza(n);
+    for (int j = 0; j < n; ++j) {
+      va[j] = circ(lon0 + j * (T(360) / n), gxa[j], gya[j], gza[j]);
+      vmax = fmax(vmax, fabs(va[j]));
+      gmax = fmax(gmax, fmax(fabs(gxa[j]), fmax(fabs(gya[j]),
+                                                fabs(gza[j]))));
+    }
+    for (int j = 0; j < n; ++j) {
+      result += checkEquals(v[j], va[j], 100 * eps * vmax) +
+        checkEquals(w[j], va[j], 100 * eps * vmax) +
+        checkEquals(gx[j], gxa[j], 1000 * eps * gmax) +
+        checkEquals(gy[j], gya[j], 1000 * eps * gmax) +
+        checkEquals(gz[j], gza[j], 1000 * eps * gmax);
+    }
+  }
+  return result;
+}
+
+static int testroottable() {
+  // Spherical harmonic sums of increasing degree (each growing the table
+  // of square roots) can be constructed and evaluated concurrently; the
+  // results are the same as when they are evaluated sequentially.
+  const int nsums = 12;
+  auto value = [](int k) -> T {
+    const int N = 100 + 53 * k;
+    vector<T> C((N + 1) * (N + 2) / 2), S(N * (N + 1) / 2);
+    for (size_t j = 0; j < C.size(); ++j) C[j] = 1 / T(j + 1);
+    for (size_t j = 0; j < S.size(); ++j) S[j] = 1 / T(j + 2);
+    const SphericalHarmonic h(C, S, N, 1);
+    return h(T(0.8), T(-0.7), T(0.6));
+  };
+  vector<T> v(nsums);
+  GeodesicBatchExecutor(4, 1).ForEach
+    (nsums, [&](size_t i0, size_t i1) -> void {
+      for (size_t i = i0; i < i1; ++i)
+        v[i] = value(int(i));
+    });
+  int result = 0;
+  for (int k = 0; k < nsums; ++k)
+    result += checkSame(v[k], value(k));
+  return result;
+}
+
+static int testcircleinplace() {
+  // A CircularEngine re-targeted in place (after being used for a circle
+  // with a different gradp and normalization) gives the same results as
+  // one constructed afresh.
+  const int N = 4;
+  const T a = 1;
+  vector<T> C((N + 1) * (N + 2) / 2), S(N * (N + 1) / 2),
+    C1(C.size()), S1(S.size());
+  for (size_t k = 0; k < C.size(); ++k) {
+    C[k] = 1 / T(k + 1); C1[k] = T(0.1) / T(k + 2);
+  }
+  for (size_t k = 0; k < S.size(); ++k) {
+    S[k] = 1 / T(k + 3); S1[k] = T(0.1) / T(k + 4);
+  }
+  SphericalHarmonic h(C, S, N, a, SphericalHarmonic::SCHMIDT);
+  SphericalHarmonic1 h1(C, S, N, C1, S1, N, a, SphericalHarmonic::FULL);
+  int result = 0;
+  CircularEngine circ;
+  const T p = T(0.8), z = T(0.7), tau = T(0.3);
+  for (int gradp = 1; gradp >= 0; --gradp) {
+    h.Circle(p + 1, z - 1, gradp == 0, circ);
+    h1.Circle(tau, p, z, gradp != 0, circ);
+    CircularEngine fresh = h1.Circle(tau, p, z, gradp != 0);
+    for (int lon = -180; lon < 180; lon += 45) {
+      T gx, gy, gz, gxa, gya, gza;
+      result += checkSame(circ(T(lon), gx, gy, gz),
+                          fresh(T(lon), gxa, gya, gza));
+      if (gradp) {
+        result += checkSame(gx, gxa);
+        result += checkSame(gy, gya);
+        result += checkSame(gz, gza);
+      }
+    }
+  }
+  return result;
+}
+
+static int testharmonicmulti() {
+  // Sums evaluated together with GradientMulti match those evaluated
+  // separately, also when the degrees and orders differ.
+  const T a = 1;
+  vector<SphericalHarmonic> h;
+  vector<vector<T>> C(3), S(3);
+  for (int j = 0; j < 3; ++j) {
+    int N = 3 + 2 * j;
+    C[j].resize((N + 1) * (N + 2) / 2); S[j].resize(N * (N + 1) / 2);
+    for (size_t k = 0; k < C[j].size(); ++k) C[j][k] = 1 / T(k + j + 1);
+    for (size_t k = 0; k < S[j].size(); ++k) S[j][k] = 1 / T(k + j + 3);
+    h.push_back(SphericalHarmonic(C[j], S[j], N, N, N - j, a,
+                                  SphericalHarmonic::SCHMIDT));
+  }
+  const SphericalHarmonic* hp[] = {&h[2], &h[0], &h[1]};
+  int result = 0;
+  T x = T(0.3), y = T(-0.5), z = T(0.9);
+  T v[3], gx[3], gy[3], gz[3];
+  SphericalHarmonic::GradientMulti<3>(hp, x, y, z, v, gx, gy, gz);
+  for (int j = 0; j < 3; ++j) {
+    T gxa, gya, gza, va = (*hp[j])(x, y, z, gxa, gya, gza);
+    result += checkSame(v[j], va);
+    result += checkSame(gx[j], gxa);
+    result += checkSame(gy[j], gya);
+    result += checkSame(gz[j], gza);
+  }
+  SphericalHarmonic hf(C[0], S[0], 3, a, SphericalHarmonic::FULL);
+  const SphericalHarmonic* hq[] = {&h[0], &hf};
+  try {
+    SphericalHarmonic::GradientMulti<2>(hq, x, y, z, v, gx, gy, gz);
+    ++result;
+  }
+  catch (const GeographicErr&) {}
+  return result;
+}
+
+static int testtruncateddegree() {
+  // The gradient of the terms neglected by truncating a sum at the degree
+  // given by TruncatedDegree is within the tolerance.
+  const int N = 30;
+  const T a = 1;
+  vector<T> C((N + 1) * (N + 2) / 2), S(N * (N + 1) / 2);
+  for (size_t k = 0; k < C.size(); ++k) C[k] = T(0.1) / T(k + 1);
+  for (size_t k = 0; k < S.size(); ++k) S[k] = T(0.1) / T(k + 2);
+  int result = 0;
+  for (int norm = 0; norm < 2; ++norm) {
+    SphericalEngine::normalization nn = norm ? SphericalEngine::SCHMIDT :
+      SphericalEngine::FULL;
+    SphericalHarmonic h(C, S, N, a, nn);
+    vector<T> b = SphericalEngine::GradientBounds(h.Coefficients(), nn);
+    result += b.size() != size_t(N + 1);
+    T x = T(1.2), y = T(-0.9), z = T(1.1), r = hypot(hypot(x, y), z),
+      tol = T(1e-6);
+    int Nt = SphericalEngine::TruncatedDegree(b, a / r, tol);
+    result += !(Nt > 0 && Nt < N);
+    result += SphericalEngine::TruncatedDegree(b, a / r, 0) != N;
+    result += SphericalEngine::TruncatedDegree(b, 0, tol) != 0;
+    SphericalHarmonic ht(SphericalEngine::coeff(h.Coefficients(), Nt, Nt),
+                         a, nn);
+    T gx, gy, gz, gxt, gyt, gzt;
+    h(x, y, z, gx, gy, gz);
+    ht(x, y, z, gxt, gyt, gzt);
+    result += !(hypot(hypot(gx - gxt, gy - gyt), gz - gzt) <= tol / r);
+  }
+  return result;
+}
+
+static int testpackedcoeff() {
+  // Sums evaluated with packed coefficients match the usual evaluation to
+  // within roundoff, also when truncated.
+  const int N = 40, Nt = 25;
+  const T a = 1;
+  vector<T> C((N + 1) * (N + 2) / 2), S(N * (N + 1) / 2);
+  for (size_t k = 0; k < C.size(); ++k) C[k] = 1 / T(k + 1);
+  for (size_t k = 0; k < S.size(); ++k) S[k] = 1 / T(k + 2);
+  int result = 0;
+  for (int norm = 0; norm < 2; ++norm) {
+    SphericalEngine::normalization nn = norm ? SphericalEngine::SCHMIDT :
+      SphericalEngine::FULL;
+    SphericalHarmonic h(C, S, N, a, nn), hp(h);
+    hp.Pack();
+    result += !hp.Packed() || h.Packed();
+    SphericalHarmonic ht(SphericalEngine::coeff(h.Coefficients(), Nt, Nt),
+                         a, nn);
+    T x = T(0.7), y = T(-0.4), z = T(0.6);
+    T gx, gy, gz, gxp, gyp, gzp, vt, vp;
+    T v = h(x, y, z, gx, gy, gz);
+    result += checkEquals(hp(x, y, z, gxp, gyp, gzp), v, 1e-12 * fabs(v));
+    result += checkEquals(gxp, gx, 1e-12 * fabs(gx));
+    result += checkEquals(gyp, gy, 1e-12 * fabs(gy));
+    result += checkEquals(gzp, gz, 1e-12 * fabs(gz));
+    result += checkEquals(hp(x, y, z), v, 1e-12 * fabs(v));
+    vt = ht(x, y, z, gx, gy, gz);
+    vp = norm ?
+      SphericalEngine::ValuePacked<true, SphericalEngine::SCHMIDT>
+      (*hp.Packed(), Nt, x, y, z, a, gxp, gyp, gzp) :
+      SphericalEngine::ValuePacked<true, SphericalEngine::FULL>
+      (*hp.Packed(), Nt, x, y, z, a, gxp, gyp, gzp);
+    result += checkEquals(vp, vt, 1e-12 * fabs(vt));
+    result += checkEquals(gzp, gz, 1e-12 * fabs(gz));
+  }
+  return result;
+}
+
+static int testpackedsingle() {
+  // With the high degree records in single precision, the error is a small
+  // multiple of float epsilon times the contribution of these degrees; the
+  // sums truncated at nsingle are unaffected.
+  const int N = 40, Ns = 25;
+  const T a = 1;
+  vector<T> C((N + 1) * (N + 2) / 2), S(N * (N + 1) / 2);
+  for (size_t k = 0; k < C.size(); ++k) C[k] = 1 / T(k + 1);
+  for (size_t k = 0; k < S.size(); ++k) S[k] = 1 / T(k + 2);
+  int result = 0;
+  for (int norm = 0; norm < 2; ++norm) {
+    SphericalEngine::normalization nn = norm ? SphericalEngine::SCHMIDT :
+      SphericalEngine::FULL;
+    SphericalHarmonic h(C, S, N, a, nn),
+      ht(SphericalEngine::coeff(h.Coefficients(), Ns, Ns), a, nn);
+    T x = T(0.7), y = T(-0.4), z = T(0.6);
+    T gx, gy, gz, gxt, gyt, gzt, gxp, gyp, gzp;
+    T v = h(x, y, z, gx, gy, gz), vt = ht(x, y, z, gxt, gyt, gzt);
+    for (int ns = 0; ns <= N; ns += Ns) {
+      SphericalHarmonic hp(h);
+      hp.Pack(ns);
+      result += hp.Packed()->nsingle() != ns;
+      T vp = hp(x, y, z, gxp, gyp, gzp),
+        // The contribution of the single precision terms
+        d = ns == 0 ? v : ns == Ns ? v - vt : 0;
+      result += checkEquals(vp, v, 1e-6 * fabs(d) + 1e-12 * fabs(v));
+      result += checkEquals(gzp, gz, 1e-5 * fabs(gz));
+    }
+    SphericalHarmonic hp(h);
+    hp.Pack(Ns);
+    T vp = norm ?
+      SphericalEngine::ValuePacked<true, SphericalEngine::SCHMIDT>
+      (*hp.Packed(), Ns, x, y, z, a, gxp, gyp, gzp) :
+      SphericalEngine::ValuePacked<true, SphericalEngine::FULL>
+      (*hp.Packed(), Ns, x, y, z, a, gxp, gyp, gzp);
+    result += checkEquals(vp, vt, 1e-12 * fabs(vt));
+    result += checkEquals(gzp, gzt, 1e-12 * fabs(gzt));
+  }
+  return result;
+}
+
+static int testpackedpolicy() {
+  // Coefficients packed with huge pages, on a given node, and replicated
+  // (if there's more than one node) give the same sums as ones packed
+  // with the default policy; the records are larger than 2 MB so that
+  // they're mapped separately.
+  const int N = 600;
+  const T a = 1;
+  vector<T> C((N + 1) * (N + 2) / 2), S(N * (N + 1) / 2);
+  for (size_t k = 0; k < C.size(); ++k) C[k] = 1 / T(k + 1);
+  for (size_t k = 0; k < S.size(); ++k) S[k] = 1 / T(k + 2);
+  SphericalHarmonic h(C, S, N, a);
+  h.Pack();
+  int result = 0;
+  for (int p = 1; p < 3; ++p) {
+    MemoryPolicy::SetPages(MemoryPolicy::pages(p));
+    MemoryPolicy::SetNode(0);
+    MemoryPolicy::SetReplicate(true);
+    SphericalHarmonic hp(C, S, N, a);
+    hp.Pack();
+    MemoryPolicy::SetPages(MemoryPolicy::SMALLPAGES);
+    MemoryPolicy::SetNode(-1);
+    MemoryPolicy::SetReplicate(false);
+    // Without replicas the records are read from the object itself
+    result += MemoryPolicy::Nodes() == 1 &&
+      &hp.Packed()->local() != hp.Packed().get();
+    for (int i = 0; i < 10; ++i) {
+      T x = T(0.7) - T(i) / 10, y = T(-0.4) + T(i) / 20, z = T(0.6),
+        gx, gy, gz, gxp, gyp, gzp;
+      T v = h(x, y, z, gx, gy, gz);
+      result += checkSame(hp(x, y, z, gxp, gyp, gzp), v) +
+        checkSame(gxp, gx) + checkSame(gyp, gy) + checkSame(gzp, gz);
+    }
+  }
+  return result;
+}
+
+static int testsphericalanalysis() {
+  // Analysis of a sum synthesized on the grid recovers its coefficients.
+  const int N = 12, M = 10, nlon = 2 * M + 2;
+  const T a = 1, lon0 = 10;
+  int result = 0;
+  vector<T> C(SphericalEngine::coeff::Csize(N, M)),
+    S(SphericalEngine::coeff::Ssize(N, M)), C1, S1, lat, w;
+  for (size_t k = 0; k < C.size(); ++k) C[k] = 1 / T(k + 1);
+  for (size_t k = 0; k < S.size(); ++k) S[k] = 1 / T(k + 2);
+  for (int g = 0; g < 2; ++g) {
+    SphericalAnalysis::grid gg = g ? SphericalAnalysis::GAUSS :
+      SphericalAnalysis::EQUIANGULAR;
+    int nlat = g ? N + 1 : 2 * N + 1;
+    result += SphericalAnalysis::MaxDegree(gg, nlat) != N;
+    SphericalAnalysis::Latitudes(gg, nlat, lat, w);
+    T wsum = 0;
+    for (int i = 0; i < nlat; ++i) wsum += w[i];
+    result += checkEquals(wsum, T(2), 1e-14);
+    for (int norm = 0; norm < 2; ++norm) {
+      SphericalHarmonic::normalization nn = norm ? SphericalHarmonic::SCHMIDT :
+        SphericalHarmonic::FULL;
+      SphericalHarmonic h(C, S, N, N, M, a, nn);
+      vector<T> f(nlat * nlon);
+      for (int i = 0; i < nlat; ++i)
+        for (int j = 0; j < nlon; ++j) {
+          T sphi, cphi, slam, clam;
+          Math::sincosd(lat[i], sphi, cphi);
+          Math::sincosd(lon0 + j * T(360) / nlon, slam, clam);
+          f[i * nlon + j] = h(cphi * clam, cphi * slam, sphi);
+        }
+      SphericalAnalysis::Analyze(gg, nlat, nlon, lon0, f.data(), N, M,
+                                 C1, S1, nn, 2);
+      result += C1.size() != C.size() || S1.size() != S.size();
+      for (size_t k = 0; k < C.size(); ++k)
+        result += checkEquals(C1[k], C[k], 1e-13);
+      for (size_t k = 0; k < S.size(); ++k)
+        result += checkEquals(S1[k], S[k], 1e-13);
+    }
+    try {
+      SphericalAnalysis::Analyze(gg, nlat, nlon, lon0, lat.data(), N + 1, M,
+                                 C1, S1);
+      ++result;
+    }
+    catch (const GeographicErr&) {}
+  }
+  return result;
+}
+
+static int testharmonichessian() {
+  // The second derivatives given by Hessian agree with differences of the
+  // gradient and have zero trace; this includes points on the polar axis.
+  // CircularEngine gives the same results.
+  const int N = 8;
+  const T a = 1;
+  vector<T> C((N + 1) * (N + 2) / 2), S(N * (N + 1) / 2),
+    C1(C.size()), S1(S.size());
+  for (size_t k = 0; k < C.size(); ++k) {
+    C[k] = sin(T(k + 1)) / T(k + 1); C1[k] = T(0.1) / T(k + 2);
+  }
+  for (size_t k = 0; k < S.size(); ++k) {
+    S[k] = cos(T(k + 3)) / T(k + 3); S1[k] = T(0.1) / T(k + 4);
+  }
+  const T pts[][3] = {
+    {T(0.9), T(0.4), T(0.7)}, {T(-0.3), T(1.1), T(-0.2)},
+    {0, 0, T(1.3)}, {0, 0, T(-1.2)}, {T(1.2), 0, 0},
+  };
+  const T e = pow(numeric_limits<T>::epsilon(), T(1)/3),
+    tol = 200 * Math::sq(e);
+  int result = 0;
+  for (int norm = 0; norm < 2; ++norm) {
+    SphericalHarmonic::normalization nn = norm ? SphericalHarmonic::SCHMIDT :
+      SphericalHarmonic::FULL;
+    SphericalHarmonic h(C, S, N, a, nn);
+    SphericalHarmonic1 h1(C, S, N, C1, S1, N, a, nn);
+    CircularEngine circ, circ1;
+    for (const auto& x : pts) {
+      T gx, gy, gz, hess[9], hess1[9], gxa, gya, gza,
+        v = h.Hessian(x[0], x[1], x[2], gx, gy, gz, hess),
+        va = h(x[0], x[1], x[2], gxa, gya, gza);
+      result += checkEquals(v, va, tol);
+      result += checkEquals(gx, gxa, tol);
+      result += checkEquals(gy, gya, tol);
+      result += checkEquals(gz, gza, tol);
+      result += checkEquals(hess[0] + hess[4] + hess[8], 0, tol);
+      for (int j = 0; j < 3; ++j) {
+        T xp[] = {x[0], x[1], x[2]}, xm[] = {x[0], x[1], x[2]}, gp[3], gm[3];
+        xp[j] += e; xm[j] -= e;
+        h(xp[0], xp[1], xp[2], gp[0], gp[1], gp[2]);
+        h(xm[0], xm[1], xm[2], gm[0], gm[1], gm[2]);
+        for (int i = 0; i < 3; ++i) {
+          result += checkEquals(hess[3 * i + j], (gp[i] - gm[i]) / (2 * e),
+                                tol);
+          result += checkSame(hess[3 * i + j], hess[3 * j + i]);
+        }
+      }
+      h1.Hessian(T(0.3), x[0], x[1], x[2], gx, gy, gz, hess1);
+      result += checkEquals(hess1[0] + hess1[4] + hess1[8], 0, tol);
+      T p = hypot(x[0], x[1]),
+        sl = p != 0 ? x[1] / p : 0, cl = p != 0 ? x[0] / p : 1;
+      h.CircleHessian(p, x[2], circ);
+      h1.CircleHessian(T(0.3), p, x[2], circ1);
+      T hessc[9];
+      result += checkEquals(circ(sl, cl, gxa, gya, gza, hessc), v, tol);
+      for (int k = 0; k < 9; ++k)
+        result += checkEquals(hessc[k], hess[k], tol);
+      circ1(sl, cl, gxa, gya, gza, hessc);
+      for (int k = 0; k < 9; ++k)
+        result += checkEquals(hessc[k], hess1[k], tol);
+    }
+  }
+  return result;
+}
+
+static int testreadcoeffsparallel() {
+  // Reading several sets of coefficients from a file in parallel matches
+  // reading them in turn from a stream, with and without truncation.
+  const char* filename = "harmonictest-coeffs.cof";
+  const int k = 4, N0[k] = {400, -1, 6, 5}, M0[k] = {300, -1, 6, 0};
+  {
+    ofstream out(filename, ios::binary);
+    out.write("HEADER00", 8);
+    for (int i = 0; i < k; ++i) {
+      int nm[2] = {N0[i], M0[i]};
+      Utility::writearray<int, int, false>(out, nm, 2);
+      vector<double>
+        C(SphericalEngine::coeff::Csize(N0[i], M0[i])),
+        S(SphericalEngine::coeff::Ssize(N0[i], M0[i]));
+      for (size_t j = 0; j < C.size(); ++j) C[j] = double(i) + 1.0/(j + 1);
+      for (size_t j = 0; j < S.size(); ++j) S[j] = double(i) - 1.0/(j + 2);
+      Utility::writearray<double, double, false>(out, C);
+      Utility::writearray<double, double, false>(out, S);
+    }
+  }
+  int result = 0;
+  for (int trunc = 0; trunc < 2; ++trunc) {
+    const int Nt[k] = {350, -1, 3, 7}, Mt[k] = {350, -1, 2, 7};
+    int N[k], M[k];
+    vector<T> C[k], S[k];
+    for (int i = 0; i < k; ++i) { N[i] = Nt[i]; M[i] = Mt[i]; }
+    streamoff pos = SphericalEngine::coeff::readcoeffs
+      (filename, 8, k, N, M, C, S, trunc != 0, 4);
+    ifstream in(filename, ios::binary);
+    in.seekg(8);
+    for (int i = 0; i < k; ++i) {
+      int n = Nt[i], m = Mt[i];
+      vector<T> C1, S1;
+      SphericalEngine::coeff::readcoeffs(in, n, m, C1, S1, trunc != 0);
+      result += N[i] != n || M[i] != m || C[i] != C1 || S[i] != S1;
+    }
+    result += pos != streamoff(in.tellg());
+  }
+  {
+    // A truncated file
+    ofstream out(filename, ios::binary | ios::app);
+    int nm[2] = {10, 10};
+    Utility::writearray<int, int, false>(out, nm, 2);
+  }
+  int N[k + 1], M[k + 1];
+  vector<T> C[k + 1], S[k + 1];
+  try {
+    SphericalEngine::coeff::readcoeffs(filename, 8, k + 1, N, M, C, S);
+    ++result;
+  }
+  catch (const GeographicErr&) {}
+  remove(filename);
+  return result;
+}
+
+static int testmemoryusage() {
+  // The estimates of cost grow with the work done and the memory usage
+  // accounts for the arrays held.
+  int result = 0;
+  typedef unsigned long long ull;
+  result += SphericalEngine::CostEstimate(-1, -1) != 0;
+  ull c0 = SphericalEngine::CostEstimate(30, 30),
+    c1 = SphericalEngine::CostEstimate(30, 30, 1, 1),
+    c2 = SphericalEngine::CostEstimate(30, 30, 1, 2);
+  result += !(0 < c0 && c0 < c1 && c1 < c2);
+  result += !(SphericalEngine::CostEstimate(30, 20) < c0);
+  result += !(SphericalEngine::CostEstimate(30, 30, 2) > c0);
+  result += !(SphericalEngine::CostEstimate(30, 30, 1, 1, 2) > c1);
+  const int N = 30;
+  vector<T> C((N + 1) * (N + 2) / 2, T(0.01)), S(N * (N + 1) / 2, T(0.01));
+  SphericalHarmonic h(C, S, N, 1);
+  result += !(SphericalEngine::RootTableMemoryUsage() >=
+              size_t(2 * N + 5) * sizeof(T));
+  CircularEngine circ0 = h.Circle(T(0.3), T(0.8), false),
+    circ1 = h.Circle(T(0.3), T(0.8), true);
+  result += !(circ0.MemoryUsage() >= 2 * (N + 1) * sizeof(T));
+  result += !(circ1.MemoryUsage() >= circ0.MemoryUsage() +
+              4 * (N + 1) * sizeof(T));
+  result += !(0 < circ0.CostEstimate() &&
+              circ0.CostEstimate() < circ1.CostEstimate() &&
+              circ1.CostEstimate() < c1);
+  h.Pack();
+  result += !(h.Packed()->MemoryUsage() >= 2 * C.size() * sizeof(T));
+  return result;
+}
+
+int main() {
+  int n = 0, i;
+
+  i = testvaluebatch(); n += i;
+  if (i) cout << "testvaluebatch failure\n";
+
+  i = testvalueparallel(); n += i;
+  if (i) cout << "testvalueparallel failure\n";
+
+  i = testcirclevalues(); n += i;
+  if (i) cout << "testcirclevalues failure\n";
+
+  i = testroottable(); n += i;
+  if (i) cout << "testroottable failure\n";
+
+  i = testcircleinplace(); n += i;
+  if (i) cout << "testcircleinplace failure\n";
+
+  i = testharmonicmulti(); n += i;
+  if (i) cout << "testharmonicmulti failure\n";
+
+  i = testtruncateddegree(); n += i;
+  if (i) cout << "testtruncateddegree failure\n";
+
+  i = testpackedcoeff(); n += i;
+  if (i) cout << "testpackedcoeff failure\n";
+
+  i = testpackedsingle(); n += i;
+  if (i) cout << "testpackedsingle failure\n";
+
+  i = testpackedpolicy(); n += i;
+  if (i) cout << "testpackedpolicy failure\n";
+
+  i = testsphericalanalysis(); n += i;
+  if (i) cout << "testsphericalanalysis failure\n";
+
+  i = testharmonichessian(); n += i;
+  if (i) cout << "testharmonichessian failure\n";
+
+  i = testreadcoeffsparallel(); n += i;
+  if (i) cout << "testreadcoeffsparallel failure\n";
+
+  i = testmemoryusage(); n += i;
+  if (i) cout << "testmemoryusage failure\n";
+
+  if (n) {
+    cout << n << " failure" << (n > 1 ? "s" : "") << "\n";
+    return 1;
+  }
+}
@@ -0,0 +1,503 @@
+/**
+ * \file magnetictest.cpp
+ * \brief Test the magnetic models
+ *
+ * Copyright (c) Charles Karney (2022) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+#include <GeographicLib/Geocentric.hpp>
+#include <GeographicLib/GeodesicBatchExecutor.hpp>
+#include <GeographicLib/GridEvaluator.hpp>
+#include <GeographicLib/MagneticCircle.hpp>
+#include <GeographicLib/MagneticModel.hpp>
+#include <GeographicLib/MagneticSnapshot.hpp>
+#include <GeographicLib/SphericalEngine.hpp>
+#include <GeographicLib/Utility.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+typedef Math::real T;
+
+static int checkEquals(T x, T y, T d) {
+  if (fabs(x - y) <= d)
+    return 0;
+  cout << "checkEquals fails: " << x << " != " << y << " +/- " << d << "\n";
+  return 1;
+}
+
+static int checkSame(T x, T y) {
+  // Results computed in different ways must be bitwise identical
+  if (x == y || (isnan(x) && isnan(y)))
+    return 0;
+  cout << "checkSame fails: " << x << " != " << y << "\n";
+  return 1;
+}
+
+// Write a synthetic magnetic model with 4 epochs (2000 to 2020) to the
+// current directory.
+static void writemagnetic(const string& name) {
+  ofstream meta((name + ".wmm").c_str());
+  meta << "WMMF-2\nName " << name << "\nRadius 6371200\nEpoch 2000\n"
+       << "DeltaEpoch 5\nNumModels 4\nNumConstants 1\nMinTime 2000\n"
+       << "MaxTime 2025\nMinHeight -1000\nMaxHeight 850000\n"
+       << "ID MAGNTEST\n";
+  ofstream out((name + ".wmm.cof").c_str(), ios::binary);
+  out.write("MAGNTEST", 8);
+  // 4 epochs (the first of lower degree), the rate of change, and the
+  // constant terms; the coefficients are multiples of 0.1 nT.
+  const int N[] = {4, 6, 6, 6, 6, 2};
+  for (int k = 0; k < 6; ++k) {
+    int nm[2] = {N[k], N[k]};
+    Utility::writearray<int, int, false>(out, nm, 2);
+    vector<double>
+      C(SphericalEngine::coeff::Csize(N[k], N[k])),
+      S(SphericalEngine::coeff::Ssize(N[k], N[k]));
+    for (size_t j = 1; j < C.size(); ++j)
+      C[j] = round(10 * (30000 / double(j * j) + 20 * (k + 1) * sin(j)))/10;
+    for (size_t j = 0; j < S.size(); ++j)
+      S[j] = round(10 * (-10000 / double(j + 1) + 7 * k * cos(j))) / 10;
+    Utility::writearray<double, double, false>(out, C);
+    Utility::writearray<double, double, false>(out, S);
+  }
+}
+
+static void removemagnetic(const string& name) {
+  remove((name + ".wmm").c_str());
+  remove((name + ".wmm.cof").c_str());
+}
+
+static int testgridfield() {
+  // GridEvaluator::Field gives the same results as MagneticCircle and
+  // agrees with MagneticModel::operator().
+  const string name = "magnetictest-grid";
+  writemagnetic(name);
+  const MagneticModel m(name, ".");
+  const int nlat = 7, nlon = 12;
+  const T t = T(2012.5), h = 2000;
+  int result = 0;
+  for (unsigned nthreads = 1; nthreads <= 3; nthreads += 2) {
+    const GridEvaluator grid(-90, 30, nlat, 0, 30, nlon, nthreads);
+    vector<T> Bx(grid.Size()), By(grid.Size()), Bz(grid.Size()),
+      Bxt(grid.Size()), Byt(grid.Size()), Bzt(grid.Size()), Cz(grid.Size());
+    grid.Field(m, t, h, Bx.data(), By.data(), Bz.data(),
+               Bxt.data(), Byt.data(), Bzt.data());
+    // Without the rates of change
+    grid.Field(m, t, h, nullptr, nullptr, Cz.data());
+    for (int i = 0; i < nlat; ++i) {
+      T lat = grid.Latitude(i);
+      const MagneticCircle c(m.Circle(t, lat, h));
+      for (int j = 0; j < nlon; ++j) {
+        size_t k = size_t(i) * nlon + j;
+        T lon = grid.Longitude(j), x, y, z, xt, yt, zt;
+        c(lon, x, y, z, xt, yt, zt);
+        result += checkSame(Bx[k], x) + checkSame(By[k], y) +
+          checkSame(Bz[k], z) + checkSame(Bxt[k], xt) +
+          checkSame(Byt[k], yt) + checkSame(Bzt[k], zt) +
+          checkSame(Cz[k], z);
+        m(t, lat, lon, h, x, y, z, xt, yt, zt);
+        result += checkEquals(Bx[k], x, T(1e-9)) +
+          checkEquals(By[k], y, T(1e-9)) + checkEquals(Bz[k], z, T(1e-9)) +
+          checkEquals(Bzt[k], zt, T(1e-9));
+      }
+    }
+  }
+  removemagnetic(name);
+  return result;
+}
+
+static int testmagneticmapfile() {
+  // A memory mapped magnetic model gives the same field as one which is
+  // read; a truncated coefficient file is rejected whether or not it is
+  // mapped.
+  const string name = "magnetictest-map";
+  writemagnetic(name);
+  // Mapping requires little-endian IEEE doubles
+  const bool canmap = numeric_limits<T>::is_iec559 &&
+    sizeof(T) == sizeof(double) && !Math::bigendian;
+  int result = 0;
+  for (int trunc = 0; trunc < 2; ++trunc) {
+    int Nmax = trunc ? 5 : -1, Mmax = trunc ? 3 : -1;
+    const MagneticModel m(name, ".", Geocentric::WGS84(), Nmax, Mmax);
+    if (!canmap) {
+      try {
+        MagneticModel mm(name, ".", Geocentric::WGS84(), Nmax, Mmax, true);
+        ++result;
+      }
+      catch (const GeographicErr&) {}
+      continue;
+    }
+    const MagneticModel mm(name, ".", Geocentric::WGS84(), Nmax, Mmax, true);
+    result += m.MemoryMapped() || !mm.MemoryMapped();
+    result += mm.Degree() != m.Degree() || mm.Order() != m.Order();
+    for (int i = 0; i < 10; ++i) {
+      T t = 2000 + T(2.3) * T(i), lat = 17 * T(i) - 80,
+        lon = 41 * T(i) - 190, h = 3000 * T(i),
+        bx, by, bz, bxt, byt, bzt, cx, cy, cz, cxt, cyt, czt;
+      m(t, lat, lon, h, bx, by, bz, bxt, byt, bzt);
+      mm(t, lat, lon, h, cx, cy, cz, cxt, cyt, czt);
+      result += checkSame(cx, bx) + checkSame(cy, by) + checkSame(cz, bz) +
+        checkSame(cxt, bxt) + checkSame(cyt, byt) + checkSame(czt, bzt);
+    }
+  }
+  {
+    // Chop the end off the coefficient file
+    ifstream in((name + ".wmm.cof").c_str(), ios::binary);
+    string data((istreambuf_iterator<char>(in)),
+                istreambuf_iterator<char>());
+    in.close();
+    ofstream out((name + ".wmm.cof").c_str(), ios::binary);
+    out.write(data.data(), streamsize(data.size() - 12));
+  }
+  for (int mapfile = 0; mapfile < 2; ++mapfile) {
+    try {
+      MagneticModel m(name, ".", Geocentric::WGS84(), -1, -1, mapfile != 0);
+      ++result;
+    }
+    catch (const GeographicErr&) {}
+  }
+  removemagnetic(name);
+  return result;
+}
+
+static int testfieldbatch() {
+  // FieldBatch gives the same results as operator() for a trajectory
+  // spanning all the epochs of the model (and extrapolated beyond them),
+  // with and without the rates of change.
+  const string name = "magnetictest-batch";
+  writemagnetic(name);
+  const MagneticModel m(name, ".");
+  const size_t n = 150;
+  vector<T> t(n), lat(n), lon(n), h(n), Bx(n), By(n), Bz(n), Bxt(n),
+    Byt(n), Bzt(n), Cx(n), Cy(n), Cz(n), Czt(n);
+  for (size_t i = 0; i < n; ++i) {
+    // Times (in no particular order) from 1999 to 2026
+    t[i] = 1999 + T((i * 37) % n) * 27 / T(n);
+    lat[i] = 85 * sin(T(i) / 10); lon[i] = T(2.5) * T(i) - 180;
+    h[i] = 100 * T(i % 25);
+  }
+  m.FieldBatch(n, t.data(), lat.data(), lon.data(), h.data(),
+               Bx.data(), By.data(), Bz.data(),
+               Bxt.data(), Byt.data(), Bzt.data());
+  m.FieldBatch(n, t.data(), lat.data(), lon.data(), h.data(),
+               Cx.data(), Cy.data(), Cz.data(), nullptr, nullptr, Czt.data());
+  int result = 0;
+  for (size_t i = 0; i < n; ++i) {
+    T bx, by, bz, bxt, byt, bzt;
+    m(t[i], lat[i], lon[i], h[i], bx, by, bz, bxt, byt, bzt);
+    result += checkSame(Bx[i], bx) + checkSame(By[i], by) +
+      checkSame(Bz[i], bz) + checkSame(Bxt[i], bxt) +
+      checkSame(Byt[i], byt) + checkSame(Bzt[i], bzt);
+    result += checkSame(Cx[i], bx) + checkSame(Cy[i], by) +
+      checkSame(Cz[i], bz) + checkSame(Czt[i], bzt);
+  }
+  removemagnetic(name);
+  return result;
+}
+
+static int testmagneticcache() {
+  // With a cache of circles, operator() gives the field for the circle at
+  // the rounded time, latitude, and height; the cache may be used
+  // concurrently.
+  const string name = "magnetictest-cache";
+  writemagnetic(name);
+  const MagneticModel m(name, "."), m0(name, ".");
+  const T dlat = T(0.5), dh = 100, dt = T(0.1);
+  m.CacheCircles(dlat, dh, dt);
+  int result = !m.CachingCircles() || m0.CachingCircles();
+  const int n = 30;
+  vector<T> t(n), lat(n), lon(n), h(n), Bx(n);
+  for (int i = 0; i < n; ++i) {
+    t[i] = T(2011.02) + T(0.01) * T(i % 3);
+    lat[i] = T(-40.1) + (i % 2 ? 2 : 0);
+    h[i] = T(1010);
+    lon[i] = 13 * T(i) - 180;
+  }
+  for (int i = 0; i < n; ++i) {
+    const MagneticCircle c(m0.Circle(round(t[i] / dt) * dt,
+                                     round(lat[i] / dlat) * dlat,
+                                     round(h[i] / dh) * dh));
+    T bx, by, bz, bxt, byt, bzt, cx, cy, cz, cxt, cyt, czt;
+    m(t[i], lat[i], lon[i], h[i], bx, by, bz, bxt, byt, bzt);
+    c(lon[i], cx, cy, cz, cxt, cyt, czt);
+    result += checkSame(bx, cx) + checkSame(by, cy) + checkSame(bz, cz) +
+      checkSame(bxt, cxt) + checkSame(byt, cyt) + checkSame(bzt, czt);
+    Bx[i] = bx;
+  }
+  result += m.CircleCacheSize() != 2 || m.CircleCacheMisses() != 2 ||
+    m.CircleCacheHits() != n - 2;
+  // A cache holding just one circle, used on several threads
+  m.CacheCircles(dlat, dh, dt, 1);
+  result += m.CircleCacheCapacity() != 1;
+  atomic<int> bad(0);
+  GeodesicBatchExecutor(4, 3).ForEach
+    (n, [&](size_t i0, size_t i1) -> void {
+      for (size_t i = i0; i < i1; ++i) {
+        T bx, by, bz;
+        m(t[i], lat[i], lon[i], h[i], bx, by, bz);
+        if (bx != Bx[i]) ++bad;
+      }
+    });
+  result += bad;
+  m.CircleCacheClear();
+  result += m.CachingCircles();
+  removemagnetic(name);
+  return result;
+}
+
+static int testcirclethreads() {
+  // The CircularEngine objects of a MagneticCircle set up on several
+  // threads give the same results as those set up on one thread.
+  const string name = "magnetictest-threads";
+  writemagnetic(name);
+  const MagneticModel m(name, ".");
+  int result = 0;
+  // Within an epoch, on an epoch boundary, and in the last epoch
+  const T ts[] = {2003.7, 2010, 2022.1};
+  for (T t : ts) {
+    const MagneticCircle c1(m.Circle(t, 35, 1500));
+    MagneticCircle c0(m.Circle(t, 35, 1500, 0)), c3;
+    m.Circle(t, 35, 1500, c3, 3);
+    const MagneticCircle* cs[] = {&c0, &c3};
+    for (const MagneticCircle* c : cs)
+      for (int j = 0; j < 12; ++j) {
+        T lon = 30 * T(j) - 175;
+        T bx, by, bz, bxt, byt, bzt, cx, cy, cz, cxt, cyt, czt;
+        (*c)(lon, bx, by, bz, bxt, byt, bzt);
+        c1(lon, cx, cy, cz, cxt, cyt, czt);
+        result += checkSame(bx, cx) + checkSame(by, cy) +
+          checkSame(bz, cz) + checkSame(bxt, cxt) + checkSame(byt, cyt) +
+          checkSame(bzt, czt);
+      }
+  }
+  removemagnetic(name);
+  return result;
+}
+
+static int testattime() {
+  // A MagneticSnapshot from AtTime agrees with operator() (also for times
+  // outside the range of the model), a copy used on several threads gives
+  // the same results, and a truncated snapshot agrees with a model
+  // constructed with the same truncation.
+  const string name = "magnetictest-snapshot";
+  writemagnetic(name);
+  const MagneticModel m(name, "."), m3(name, ".", Geocentric::WGS84(), 3, 2);
+  const T tol = T(1e-9);
+  const T ts[] = {1995, 2000, 2003.7, 2010, 2022.1, 2030};
+  const int n = 40;
+  int result = 0;
+  for (T t : ts) {
+    const MagneticSnapshot s(m.AtTime(t)), s3(m.AtTime(t, 3, 2));
+    result += checkSame(s.Time(), t) + (s.Degree() != m.Degree()) +
+      (s3.Degree() != 3 || s3.Order() != 2);
+    vector<T> Bx(n);
+    for (int i = 0; i < n; ++i) {
+      T lat = 89 * sin(T(i) / 3), lon = 17 * T(i) - 180, h = 2000 * T(i),
+        bx, by, bz, bxt, byt, bzt, cx, cy, cz, cxt, cyt, czt;
+      m(t, lat, lon, h, bx, by, bz, bxt, byt, bzt);
+      s(lat, lon, h, cx, cy, cz, cxt, cyt, czt);
+      result += checkEquals(bx, cx, tol) + checkEquals(by, cy, tol) +
+        checkEquals(bz, cz, tol) + checkEquals(bxt, cxt, tol) +
+        checkEquals(byt, cyt, tol) + checkEquals(bzt, czt, tol);
+      s(lat, lon, h, Bx[i], cy, cz);
+      result += checkSame(Bx[i], cx);
+      m3(t, lat, lon, h, bx, by, bz, bxt, byt, bzt);
+      s3(lat, lon, h, cx, cy, cz, cxt, cyt, czt);
+      result += checkEquals(bx, cx, tol) + checkEquals(by, cy, tol) +
+        checkEquals(bz, cz, tol) + checkEquals(bxt, cxt, tol) +
+        checkEquals(byt, cyt, tol) + checkEquals(bzt, czt, tol);
+    }
+    const MagneticSnapshot sc(s);
+    atomic<int> bad(0);
+    GeodesicBatchExecutor(4, 3).ForEach
+      (n, [&](size_t i0, size_t i1) -> void {
+        for (size_t i = i0; i < i1; ++i) {
+          T lat = 89 * sin(T(i) / 3), lon = 17 * T(i) - 180,
+            h = 2000 * T(i), bx, by, bz;
+          sc(lat, lon, h, bx, by, bz);
+          if (!(bx == Bx[i])) ++bad;
+        }
+      });
+    result += bad;
+  }
+  result += MagneticSnapshot().Init() ? 1 : 0;
+  removemagnetic(name);
+  return result;
+}
+
+static int testmagneticcopy() {
+  // A copy of a MagneticModel (read, memory mapped, or compressed) gives
+  // the same results after the original is destroyed.
+  const string name = "magnetictest-copy";
+  writemagnetic(name);
+  const bool canmap = numeric_limits<T>::is_iec559 &&
+    sizeof(T) == sizeof(double) && !Math::bigendian;
+  int result = 0;
+  for (int k = 0; k < 3; ++k) {
+    // 0 = read, 1 = memory mapped, 2 = compressed
+    if (k == 1 && !canmap) continue;
+    unique_ptr<MagneticModel>
+      m(new MagneticModel(name, ".", Geocentric::WGS84(), -1, -1, k == 1));
+    if (k == 2) m->Compress(T(0.1));
+    const int n = 10;
+    T Bx[n], By[n], Bz[n], Bxt[n], Byt[n], Bzt[n];
+    for (int i = 0; i < n; ++i)
+      (*m)(2001 + 2 * T(i), 17 * T(i) - 80, 35 * T(i) - 170, 100 * T(i),
+           Bx[i], By[i], Bz[i], Bxt[i], Byt[i], Bzt[i]);
+    MagneticModel mc(*m);
+    result += mc.Degree() != m->Degree() || mc.Compressed() != m->Compressed();
+    m.reset();
+    for (int i = 0; i < n; ++i) {
+      T bx, by, bz, bxt, byt, bzt;
+      mc(2001 + 2 * T(i), 17 * T(i) - 80, 35 * T(i) - 170, 100 * T(i),
+         bx, by, bz, bxt, byt, bzt);
+      result += checkSame(bx, Bx[i]) + checkSame(by, By[i]) +
+        checkSame(bz, Bz[i]) + checkSame(bxt, Bxt[i]) +
+        checkSame(byt, Byt[i]) + checkSame(bzt, Bzt[i]);
+    }
+  }
+  removemagnetic(name);
+  return result;
+}
+
+static int testmagneticcompress() {
+  // A compressed magnetic model with several epochs gives the same field as
+  // the original one.
+  writemagnetic("magnetictest-mag");
+  int result = 0;
+  MagneticModel m0("magnetictest-mag", "."), m1("magnetictest-mag", ".");
+  m1.Compress(T(0.1), 2);
+  result += !m1.Compressed() || m0.Compressed();
+  result += checkEquals(m1.CompressionQuantum(), T(0.1), 0);
+  result += !(m1.CoefficientBytes() < m0.CoefficientBytes());
+  result += m1.Degree() != m0.Degree() || m1.Order() != m0.Order();
+  try {
+    m1.Compress(T(0.1));
+    ++result;
+  }
+  catch (const GeographicErr&) {}
+  const MagneticModel m2(m1);
+  const T tol = T(1e-9);
+  const T t[] = {2000, 2003.5, 2005, 2012, 2016, 2019.9, 2023};
+  const size_t n = sizeof(t) / sizeof(T);
+  vector<T> lat(n), lon(n), h(n), Bx(n), By(n), Bz(n), Bxt(n), Byt(n),
+    Bzt(n);
+  for (size_t i = 0; i < n; ++i) {
+    lat[i] = 13 * T(i) - 40; lon[i] = 47 * T(i) - 150; h[i] = 1000 * T(i);
+  }
+  m1.FieldBatch(n, t, lat.data(), lon.data(), h.data(), Bx.data(),
+                By.data(), Bz.data(), Bxt.data(), Byt.data(), Bzt.data());
+  for (size_t i = 0; i < n; ++i) {
+    T bx, by, bz, bxt, byt, bzt, cx, cy, cz, cxt, cyt, czt;
+    m0(t[i], lat[i], lon[i], h[i], bx, by, bz, bxt, byt, bzt);
+    m2(t[i], lat[i], lon[i], h[i], cx, cy, cz, cxt, cyt, czt);
+    result += checkEquals(bx, cx, tol) + checkEquals(by, cy, tol) +
+      checkEquals(bz, cz, tol) + checkEquals(bxt, cxt, tol) +
+      checkEquals(byt, cyt, tol) + checkEquals(bzt, czt, tol);
+    result += checkEquals(bx, Bx[i], tol) + checkEquals(bz, Bz[i], tol) +
+      checkEquals(byt, Byt[i], tol);
+    m1.Circle(t[i], lat[i], h[i])(lon[i], cx, cy, cz, cxt, cyt, czt);
+    result += checkEquals(by, cy, tol) + checkEquals(bzt, czt, tol);
+    m1.AtTime(t[i])(lat[i], lon[i], h[i], cx, cy, cz, cxt, cyt, czt);
+    result += checkEquals(bx, cx, tol) + checkEquals(bxt, cxt, tol);
+  }
+  result += !(m1.MemoryUsage() > m1.CoefficientBytes() &&
+              m1.CostEstimate() == m0.CostEstimate() &&
+              m0.CostEstimate() > 0);
+  {
+    size_t bytes = m0.MemoryUsage();
+    T bx, by, bz;
+    m0.CacheCircles(1, 1, 1);
+    m0(2011, 20, 30, 0, bx, by, bz);
+    result += !(m0.MemoryUsage() > bytes);
+    m0.CircleCacheClear();
+    result += m0.MemoryUsage() != bytes;
+  }
+  m0.SetTruncationTolerance(1);
+  m1.SetTruncationTolerance(1);
+  {
+    T bx, by, bz, cx, cy, cz;
+    m0(2011, 20, 30, 5e6, bx, by, bz);
+    m1(2011, 20, 30, 5e6, cx, cy, cz);
+    result += checkEquals(bx, cx, tol) + checkEquals(bz, cz, tol);
+  }
+  removemagnetic("magnetictest-mag");
+  return result;
+}
+
+static int testmagneticembedded() {
+  // A name which isn't compiled into the library isn't found and the
+  // outputs are left alone; an embedded magnetic model (if any) gives the
+  // same field as the files it was made from.
+  const char* data = nullptr;
+  size_t size = 7;
+  int result =
+    Utility::EmbeddedData("magnetic/no-such-model.wmm", data, size) ||
+    data != nullptr || size != 7;
+#if defined(GEOGRAPHICLIB_TEST_EMBEDDED_MAGNETIC)
+  const string name = GEOGRAPHICLIB_TEST_EMBEDDED_MAGNETIC;
+  const MagneticModel me(name, ""),
+    mf(name, GEOGRAPHICLIB_TEST_EMBEDDED_DIR);
+  result += me.MagneticFile().compare(0, 9, "embedded:") != 0 ||
+    mf.MagneticFile().compare(0, 9, "embedded:") == 0;
+  result += me.Degree() != mf.Degree() || me.Order() != mf.Order() ||
+    me.Description() != mf.Description();
+  for (int i = 0; i < 10; ++i) {
+    T t = mf.MinTime() + (mf.MaxTime() - mf.MinTime()) * T(i) / 10,
+      lat = 17 * T(i) - 80, lon = 41 * T(i) - 190, h = 3000 * T(i),
+      bx, by, bz, bxt, byt, bzt, cx, cy, cz, cxt, cyt, czt;
+    mf(t, lat, lon, h, bx, by, bz, bxt, byt, bzt);
+    me(t, lat, lon, h, cx, cy, cz, cxt, cyt, czt);
+    result += checkSame(cx, bx) + checkSame(cy, by) + checkSame(cz, bz) +
+      checkSame(cxt, bxt) + checkSame(cyt, byt) + checkSame(czt, bzt);
+  }
+#endif
+  return result;
+}
+
+int main() {
+  int n = 0, i;
+
+  i = testgridfield(); n += i;
+  if (i) cout << "testgridfield failure\n";
+
+  i = testmagneticmapfile(); n += i;
+  if (i) cout << "testmagneticmapfile failure\n";
+
+  i = testfieldbatch(); n += i;
+  if (i) cout << "testfieldbatch failure\n";
+
+  i = testmagneticcache(); n += i;
+  if (i) cout << "testmagneticcache failure\n";
+
+  i = testcirclethreads(); n += i;
+  if (i) cout << "testcirclethreads failure\n";
+
+  i = testattime(); n += i;
+  if (i) cout << "testattime failure\n";
+
+  i = testmagneticcopy(); n += i;
+  if (i) cout << "testmagneticcopy failure\n";
+
+  i = testmagneticcompress(); n += i;
+  if (i) cout << "testmagneticcompress failure\n";
+
+  i = testmagneticembedded(); n += i;
+  if (i) cout << "testmagneticembedded failure\n";
+
+  if (n) {
+    cout << n << " failure" << (n > 1 ? "s" : "") << "\n";
+    return 1;
+  }
+}
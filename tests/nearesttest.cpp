@@ -0,0 +1,430 @@
+/**
+ * \file nearesttest.cpp
+ * \brief Test NearestNeighbor with geodesic distances
+ *
+ * Copyright (c) Charles Karney (2022) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <utility>
+#include <vector>
+#include <GeographicLib/Geodesic.hpp>
+#include <GeographicLib/GeodesicBatchExecutor.hpp>
+#include <GeographicLib/NearestNeighbor.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+typedef Math::real T;
+
+struct geodpos {
+  T lat, lon;
+};
+
+class geoddist {
+public:
+  T operator()(const geodpos& a, const geodpos& b) const {
+    T d;
+    Geodesic::WGS84().Inverse(a.lat, a.lon, b.lat, b.lon, d);
+    return d;
+  }
+};
+
+static int testnearestthreads() {
+  // NearestNeighbor must construct the same tree with several threads
+  typedef NearestNeighbor<T, geodpos, geoddist> NN;
+  vector<geodpos> pts(20000);
+  for (int i = 0; i < int(pts.size()); ++i) {
+    pts[i].lat = 90 * sin(T(i) * T(0.7));
+    pts[i].lon = remainder(T(i) * T(61.3), T(360));
+  }
+  geoddist dist;
+  NN nn1(pts, dist, 4, 1), nn4(pts, dist, 4, 4);
+  ostringstream s1, s4;
+  nn1.Save(s1, false); nn4.Save(s4, false);
+  int result = s1.str() == s4.str() ? 0 : 1;
+  if (result) cout << "testnearestthreads tree mismatch\n";
+  return result;
+}
+
+static int testnearestsearch() {
+  // NearestNeighbor::Search must agree with a brute force search and a
+  // tree restored with Load must save identically.
+  typedef NearestNeighbor<T, geodpos, geoddist> NN;
+  vector<geodpos> pts(2000);
+  for (int i = 0; i < int(pts.size()); ++i) {
+    pts[i].lat = 90 * sin(T(i) * T(0.7));
+    pts[i].lon = remainder(T(i) * T(61.3), T(360));
+  }
+  geoddist dist;
+  NN nn(pts, dist, 4);
+  int result = 0;
+  const int k = 5;
+  for (int j = 0; j < 20; ++j) {
+    geodpos q;
+    q.lat = 90 * sin(T(j) * T(1.3) + 1);
+    q.lon = remainder(T(j) * T(37.1), T(360));
+    vector<int> ind;
+    nn.Search(pts, dist, q, ind, k);
+    vector<pair<T, int>> all(pts.size());
+    for (int i = 0; i < int(pts.size()); ++i)
+      all[i] = make_pair(dist(pts[i], q), i);
+    partial_sort(all.begin(), all.begin() + k, all.end());
+    if (int(ind.size()) != k) { ++result; continue; }
+    for (int i = 0; i < k; ++i)
+      if (ind[i] != all[i].second) ++result;
+  }
+  if (result) cout << "testnearestsearch search mismatch\n";
+  ostringstream s1, s2;
+  nn.Save(s1, false);
+  istringstream is(s1.str());
+  NN nn2;
+  nn2.Load(is, false);
+  nn2.Save(s2, false);
+#if GEOGRAPHICLIB_PRECISION != 6
+  // A double-double number doesn't survive a round trip through text
+  if (s1.str() != s2.str()) {
+    cout << "testnearestsearch load mismatch\n";
+    ++result;
+  }
+#endif
+  // Search a tree saved with SaveMapped in place
+  ostringstream s3;
+  nn.SaveMapped(s3);
+  string m = s3.str();
+  vector<long double> buf(m.size() / sizeof(long double) + 1);
+  memcpy(buf.data(), m.data(), m.size());
+  NN nn3;
+  nn3.LoadMapped(reinterpret_cast<const char*>(buf.data()), m.size());
+  for (int j = 0; j < 20; ++j) {
+    geodpos q;
+    q.lat = 90 * sin(T(j) * T(2.1));
+    q.lon = remainder(T(j) * T(53.7), T(360));
+    vector<int> ind, ind3;
+    nn.Search(pts, dist, q, ind, k);
+    nn3.Search(pts, dist, q, ind3, k);
+    if (ind != ind3) ++result;
+  }
+  ostringstream s4;
+  nn3.Save(s4, false);
+  if (s1.str() != s4.str()) {
+    cout << "testnearestsearch mapped mismatch\n";
+    ++result;
+  }
+  return result;
+}
+
+static int testnearestbatch() {
+  // NearestNeighbor::SearchBatch with several threads must agree with
+  // Search and count every search in the statistics.
+  typedef NearestNeighbor<T, geodpos, geoddist> NN;
+  vector<geodpos> pts(2000), queries(500);
+  for (int i = 0; i < int(pts.size()); ++i) {
+    pts[i].lat = 90 * sin(T(i) * T(0.7));
+    pts[i].lon = remainder(T(i) * T(61.3), T(360));
+  }
+  for (int j = 0; j < int(queries.size()); ++j) {
+    queries[j].lat = 90 * sin(T(j) * T(1.3) + 1);
+    queries[j].lon = remainder(T(j) * T(37.1), T(360));
+  }
+  geoddist dist;
+  NN nn(pts, dist, 4);
+  vector<vector<int>> ind;
+  vector<T> d;
+  nn.SearchBatch(pts, dist, queries, ind, d, 3, Math::infinity<T>(), -1,
+                 true, 0, 4);
+  int result = 0;
+  for (int j = 0; j < int(queries.size()); ++j) {
+    vector<int> ind1;
+    T d1 = nn.Search(pts, dist, queries[j], ind1, 3);
+    if (ind1 != ind[j] || d1 != d[j]) ++result;
+  }
+  int setupcost, num, cost, mincost, maxcost;
+  double mean, sd;
+  nn.Statistics(setupcost, num, cost, mincost, maxcost, mean, sd);
+  if (num != 2 * int(queries.size()) ||
+      !(mincost <= mean && mean <= maxcost)) ++result;
+  if (result) cout << "testnearestbatch mismatch\n";
+  return result;
+}
+
+// A geodesic distance with a lower bound (b times the angle between the
+// geocentric position vectors) and a batch version
+struct geodposu {
+  T lat, lon, u[3];
+};
+
+class geoddistbatch {
+public:
+  T operator()(const geodposu& a, const geodposu& b) const {
+    T d;
+    Geodesic::WGS84().Inverse(a.lat, a.lon, b.lat, b.lon, d);
+    return d;
+  }
+  T LowerBound(const geodposu& a, const geodposu& b) const {
+    const Geodesic& g = Geodesic::WGS84();
+    T c0 = a.u[1] * b.u[2] - a.u[2] * b.u[1],
+      c1 = a.u[2] * b.u[0] - a.u[0] * b.u[2],
+      c2 = a.u[0] * b.u[1] - a.u[1] * b.u[0],
+      psi = atan2(sqrt(c0 * c0 + c1 * c1 + c2 * c2),
+                  a.u[0] * b.u[0] + a.u[1] * b.u[1] + a.u[2] * b.u[2]);
+    return (1 - 1/T(1000000)) *
+      g.EquatorialRadius() * (1 - g.Flattening()) * psi;
+  }
+  void Batch(const vector<geodposu>& pts, const int index[], int n,
+             const geodposu& q, T d[]) const {
+    T lat1[10], lon1[10], lat2[10], lon2[10];
+    for (int i = 0; i < n; ++i) {
+      lat1[i] = pts[index[i]].lat; lon1[i] = pts[index[i]].lon;
+      lat2[i] = q.lat; lon2[i] = q.lon;
+    }
+    ++calls;
+    Geodesic::WGS84().InverseBatch(n, lat1, lon1, lat2, lon2,
+                                   Geodesic::DISTANCE, nullptr, d,
+                                   nullptr, nullptr, nullptr, nullptr,
+                                   nullptr, nullptr);
+  }
+  static geodposu pos(T lat, T lon) {
+    T e2m = Math::sq(1 - Geodesic::WGS84().Flattening()), sphi, cphi, slam,
+      clam;
+    Math::sincosd(lat, sphi, cphi); Math::sincosd(lon, slam, clam);
+    T x = cphi * clam, y = cphi * slam, z = e2m * sphi,
+      r = sqrt(x * x + y * y + z * z);
+    geodposu p = {lat, lon, {x / r, y / r, z / r}};
+    return p;
+  }
+  mutable atomic<int> calls;
+  geoddistbatch() : calls(0) {}
+};
+
+static int testnearestleaf() {
+  // NearestNeighbor::Search with the LowerBound and Batch members of the
+  // distance function must give the same results as without them with
+  // fewer distance calculations.
+  typedef NearestNeighbor<T, geodpos, geoddist> NN;
+  typedef NearestNeighbor<T, geodposu, geoddistbatch> NNB;
+  vector<geodpos> pts(2000);
+  vector<geodposu> ptsu(pts.size());
+  for (int i = 0; i < int(pts.size()); ++i) {
+    pts[i].lat = 90 * sin(T(i) * T(0.7));
+    pts[i].lon = remainder(T(i) * T(61.3), T(360));
+    ptsu[i] = geoddistbatch::pos(pts[i].lat, pts[i].lon);
+  }
+  geoddist dist;
+  geoddistbatch distb;
+  NN nn(pts, dist, 8);
+  NNB nnb(ptsu, distb, 8);
+  int result = 0;
+  for (int i = 0; i < int(pts.size()); i += 7)
+    for (int j = 0; j < int(pts.size()); j += 11)
+      if (distb.LowerBound(ptsu[i], ptsu[j]) > distb(ptsu[i], ptsu[j]))
+        ++result;
+  if (result) cout << "testnearestleaf lower bound failure\n";
+  nn.ResetStatistics(); nnb.ResetStatistics(); distb.calls = 0;
+  for (int j = 0; j < 50; ++j) {
+    geodpos q;
+    q.lat = 90 * sin(T(j) * T(1.3) + 1);
+    q.lon = remainder(T(j) * T(37.1), T(360));
+    vector<int> ind, indb;
+    T d = nn.Search(pts, dist, q, ind, 5),
+      db = nnb.Search(ptsu, distb, geoddistbatch::pos(q.lat, q.lon),
+                      indb, 5);
+    if (ind != indb || d != db) ++result;
+  }
+  int setupcost, num, cost, numb, costb, mincost, maxcost;
+  double mean, sd;
+  nn.Statistics(setupcost, num, cost, mincost, maxcost, mean, sd);
+  nnb.Statistics(setupcost, numb, costb, mincost, maxcost, mean, sd);
+  if (!(numb == num && costb < cost && distb.calls > 0)) ++result;
+  if (result) cout << "testnearestleaf mismatch " << cost << " "
+                   << costb << "\n";
+  return result;
+}
+
+static int testnearestvisit() {
+  // NearestNeighbor::Visit must find the same points as Search with k =
+  // pts.size() (with and without the LowerBound and Batch members of the
+  // distance function) and stop when the visitor returns false.
+  typedef NearestNeighbor<T, geodpos, geoddist> NN;
+  typedef NearestNeighbor<T, geodposu, geoddistbatch> NNB;
+  vector<geodpos> pts(2000);
+  vector<geodposu> ptsu(pts.size());
+  for (int i = 0; i < int(pts.size()); ++i) {
+    pts[i].lat = 90 * sin(T(i) * T(0.7));
+    pts[i].lon = remainder(T(i) * T(61.3), T(360));
+    ptsu[i] = geoddistbatch::pos(pts[i].lat, pts[i].lon);
+  }
+  geoddist dist;
+  geoddistbatch distb;
+  NN nn(pts, dist, 4);
+  NNB nnb(ptsu, distb, 4);
+  int result = 0;
+  const T maxdist = 1500000, mindist = 100000;
+  for (int j = 0; j < 20; ++j) {
+    geodpos q;
+    q.lat = 90 * sin(T(j) * T(1.3) + 1);
+    q.lon = remainder(T(j) * T(37.1), T(360));
+    vector<int> ind;
+    nn.Search(pts, dist, q, ind, int(pts.size()), maxdist, mindist);
+    sort(ind.begin(), ind.end());
+    vector<int> vis, visb;
+    vector<T> d(pts.size(), -1);
+    int num = nn.Visit(pts, dist, q,
+                       [&vis, &d](int i, T s) -> bool {
+                         vis.push_back(i); d[i] = s; return true;
+                       }, maxdist, mindist),
+      numb = nnb.Visit(ptsu, distb, geoddistbatch::pos(q.lat, q.lon),
+                       [&visb](int i, T) -> bool {
+                         visb.push_back(i); return true;
+                       }, maxdist, mindist);
+    if (num != int(vis.size()) || numb != int(visb.size())) ++result;
+    sort(vis.begin(), vis.end());
+    sort(visb.begin(), visb.end());
+    if (vis != ind || visb != ind) ++result;
+    for (int i : vis)
+      if (d[i] != dist(pts[i], q)) ++result;
+    if (ind.size() > 3) {
+      int count = 0;
+      num = nn.Visit(pts, dist, q,
+                     [&count](int, T) -> bool { return ++count < 3; },
+                     maxdist, mindist);
+      if (num != 3 || count != 3) ++result;
+    }
+  }
+  if (result) cout << "testnearestvisit mismatch\n";
+  return result;
+}
+
+static int testnearestinsert(int bucket) {
+  // NearestNeighbor::Insert and Remove must give the same search results
+  // as a brute force search over the remaining points.
+  typedef NearestNeighbor<T, geodpos, geoddist> NN;
+  vector<geodpos> pts(3000);
+  for (int i = 0; i < int(pts.size()); ++i) {
+    pts[i].lat = 90 * sin(T(i) * T(0.7));
+    pts[i].lon = remainder(T(i) * T(61.3), T(360));
+  }
+  geoddist dist;
+  vector<geodpos> pts1(pts.begin(), pts.begin() + 500);
+  NN nn(pts1, dist, bucket);
+  vector<bool> live(pts.size(), true);
+  int result = 0;
+  for (int n = 1000; n <= int(pts.size()); n += 500) {
+    pts1.assign(pts.begin(), pts.begin() + n);
+    nn.Insert(pts1, dist);
+    // Remove every 7th point below n
+    for (int i = 0; i < n; i += 7)
+      if (live[i]) { nn.Remove(pts1, dist, i); live[i] = false; }
+  }
+  ostringstream s;
+  nn.Save(s, false);
+  istringstream is(s.str());
+  NN nn2;
+  nn2.Load(is, false);
+  const int k = 5;
+  for (int j = 0; j < 20; ++j) {
+    geodpos q;
+    q.lat = 90 * sin(T(j) * T(1.3) + 1);
+    q.lon = remainder(T(j) * T(37.1), T(360));
+    vector<int> ind, ind2;
+    nn.Search(pts1, dist, q, ind, k);
+    nn2.Search(pts1, dist, q, ind2, k);
+    vector<pair<T, int>> all;
+    for (int i = 0; i < int(pts1.size()); ++i)
+      if (live[i]) all.push_back(make_pair(dist(pts1[i], q), i));
+    partial_sort(all.begin(), all.begin() + k, all.end());
+    if (int(ind.size()) != k || ind != ind2) { ++result; continue; }
+    for (int i = 0; i < k; ++i)
+      if (ind[i] != all[i].second) ++result;
+  }
+  if (result) cout << "testnearestinsert mismatch bucket = " << bucket << "\n";
+  return result;
+}
+
+static int testnearestscheduler() {
+  // NearestNeighbor builds its tree with the scheduler set by
+  // GeodesicBatchExecutor::SetScheduler; here one which runs the workers in
+  // reverse order on the calling thread.
+  unsigned nworkers = 0;
+  GeodesicBatchExecutor::SetScheduler
+    ([&nworkers](unsigned n, const function<void(unsigned)>& work) -> void {
+      for (unsigned k = n; k-- > 0;) {
+        ++nworkers;
+        work(k);
+      }
+    }, 3);
+  typedef NearestNeighbor<T, geodpos, geoddist> NN;
+  vector<geodpos> pts(2000);
+  for (int i = 0; i < int(pts.size()); ++i) {
+    pts[i].lat = 90 * sin(T(i) * T(0.7));
+    pts[i].lon = remainder(T(i) * T(61.3), T(360));
+  }
+  geoddist dist;
+  NN nn0(pts, dist, 4, 0), nn1(pts, dist, 4, 1);
+  GeodesicBatchExecutor::SetScheduler();
+  int result = nworkers > 0 ? 0 : 1;
+  for (int i = 0; i < 500; i += 7) {
+    geodpos q;
+    q.lat = 90 * sin(T(i) * T(1.3) + 1);
+    q.lon = remainder(T(i) * T(37.1), T(360));
+    vector<int> ind0, ind1;
+    T d0 = nn0.Search(pts, dist, q, ind0, 3),
+      d1 = nn1.Search(pts, dist, q, ind1, 3);
+    result += d0 == d1 && ind0 == ind1 ? 0 : 1;
+  }
+  return result;
+}
+
+static int testnearestmemory() {
+  // The memory usage accounts for the tree.
+  typedef NearestNeighbor<T, geodpos, geoddist> NN;
+  vector<geodpos> pts(1000);
+  for (int i = 0; i < int(pts.size()); ++i) {
+    pts[i].lat = 90 * sin(T(i) * T(0.7));
+    pts[i].lon = remainder(T(i) * T(61.3), T(360));
+  }
+  NN nn0, nn1(pts, geoddist(), 4);
+  return nn1.MemoryUsage() > nn0.MemoryUsage() +
+    pts.size() / 4 * sizeof(int) ? 0 : 1;
+}
+
+int main() {
+  int n = 0, i;
+
+  i = testnearestthreads(); n += i;
+  if (i) cout << "testnearestthreads failure\n";
+
+  i = testnearestsearch(); n += i;
+  if (i) cout << "testnearestsearch failure\n";
+
+  i = testnearestbatch(); n += i;
+  if (i) cout << "testnearestbatch failure\n";
+
+  i = testnearestleaf(); n += i;
+  if (i) cout << "testnearestleaf failure\n";
+
+  i = testnearestvisit(); n += i;
+  if (i) cout << "testnearestvisit failure\n";
+
+  i = testnearestinsert(4) + testnearestinsert(0); n += i;
+  if (i) cout << "testnearestinsert failure\n";
+
+  i = testnearestscheduler(); n += i;
+  if (i) cout << "testnearestscheduler failure\n";
+
+  i = testnearestmemory(); n += i;
+  if (i) cout << "testnearestmemory failure\n";
+
+  if (n) {
+    cout << n << " failure" << (n > 1 ? "s" : "") << "\n";
+    return 1;
+  }
+}
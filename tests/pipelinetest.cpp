@@ -0,0 +1,109 @@
+/**
+ * \file pipelinetest.cpp
+ * \brief Test CoordinatePipeline against the individual conversions
+ *
+ * Copyright (c) Charles Karney (2022) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#include <iostream>
+#include <memory>
+#include <vector>
+#include <GeographicLib/CoordinatePipeline.hpp>
+#include <GeographicLib/Geocentric.hpp>
+#include <GeographicLib/LocalCartesian.hpp>
+#include <GeographicLib/UTMUPS.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+typedef Math::real T;
+
+static int checkEquals(T x, T y, T d) {
+  if (fabs(x - y) <= d)
+    return 0;
+  cout << "checkEquals fails: " << x << " != " << y << " +/- " << d << "\n";
+  return 1;
+}
+
+static int testpipeline() {
+  // CoordinatePipeline matches Geocentric, LocalCartesian, and UTMUPS to
+  // within roundoff.  The number of points spans more than one block.
+  const int n = 1500;
+  LocalCartesian local(T(47.5), T(8.3), T(400));
+  CoordinatePipeline pipe(local);
+  vector<T> lat(n), lon(n), h(n), X(n), Y(n), Z(n), x(n), y(n), z(n),
+    e(n), nn(n), lat1(n), lon1(n), h1(n), e1(n), nn1(n);
+  vector<int> zone(n), zone1(n);
+  unique_ptr<bool[]> northp(new bool[n]), northp1(new bool[n]);
+  for (int i = 0; i < n; ++i) {
+    // Avoid the equator where the hemisphere of the round trip is
+    // ambiguous
+    lat[i] = -70 + (T(i) + T(0.5)) * 150 / n;
+    lon[i] = -170 + T(i % 97) * 340 / 97;
+    h[i] = T(i % 13) * 100 - 300;
+  }
+  int result = 0;
+  pipe.Forward(n, lat.data(), lon.data(), h.data(),
+               X.data(), Y.data(), Z.data(), x.data(), y.data(), z.data(),
+               zone.data(), northp.get(), e.data(), nn.data());
+  for (int i = 0; i < n; ++i) {
+    T Xa, Ya, Za, xa, ya, za, ea, na, gamma, k;
+    int zonea;
+    bool northpa;
+    Geocentric::WGS84().Forward(lat[i], lon[i], h[i], Xa, Ya, Za);
+    local.Forward(lat[i], lon[i], h[i], xa, ya, za);
+    UTMUPS::Forward(lat[i], lon[i], zonea, northpa, ea, na, gamma, k);
+    result += checkEquals(X[i], Xa, T(1e-8));
+    result += checkEquals(Y[i], Ya, T(1e-8));
+    result += checkEquals(Z[i], Za, T(1e-8));
+    result += checkEquals(x[i], xa, T(1e-8));
+    result += checkEquals(y[i], ya, T(1e-8));
+    result += checkEquals(z[i], za, T(1e-8));
+    result += zone[i] != zonea || northp[i] != northpa;
+    result += checkEquals(e[i], ea, T(1e-8));
+    result += checkEquals(nn[i], na, T(1e-8));
+  }
+  // Only the local coordinates are needed
+  vector<T> x1(n), y1(n), z1(n);
+  pipe.Forward(n, lat.data(), lon.data(), h.data(),
+               nullptr, nullptr, nullptr, x1.data(), y1.data(), z1.data(),
+               nullptr, nullptr, nullptr, nullptr);
+  for (int i = 0; i < n; ++i)
+    result += x1[i] != x[i] || y1[i] != y[i] || z1[i] != z[i];
+  // Back from local coordinates, with and without the geodetic output
+  pipe.Reverse(n, x.data(), y.data(), z.data(),
+               lat1.data(), lon1.data(), h1.data(),
+               X.data(), Y.data(), Z.data(),
+               zone1.data(), northp1.get(), e1.data(), nn1.data());
+  for (int i = 0; i < n; ++i) {
+    result += checkEquals(lat1[i], lat[i], T(1e-12));
+    result += checkEquals(lon1[i], lon[i], T(1e-12));
+    result += checkEquals(h1[i], h[i], T(1e-6));
+    result += zone1[i] != zone[i] || northp1[i] != northp[i];
+    result += checkEquals(e1[i], e[i], T(1e-6));
+    result += checkEquals(nn1[i], nn[i], T(1e-6));
+  }
+  pipe.Reverse(n, x.data(), y.data(), z.data(),
+               nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+               zone1.data(), northp1.get(), e1.data(), nn1.data());
+  for (int i = 0; i < n; ++i) {
+    result += zone1[i] != zone[i] || northp1[i] != northp[i];
+    result += checkEquals(e1[i], e[i], T(1e-6));
+    result += checkEquals(nn1[i], nn[i], T(1e-6));
+  }
+  return result;
+}
+
+int main() {
+  int n = 0, i;
+
+  i = testpipeline(); n += i;
+  if (i) cout << "testpipeline failure\n";
+
+  if (n) {
+    cout << n << " failure" << (n > 1 ? "s" : "") << "\n";
+    return 1;
+  }
+}
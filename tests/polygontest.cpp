@@ -10,6 +10,7 @@
 #include <iostream>
 #include <limits>
 #include <string>
+#include <vector>
 #include <GeographicLib/Math.hpp>
 #include <GeographicLib/Utility.hpp>
 #include <GeographicLib/DMS.hpp>
@@ -18,6 +19,8 @@
 #include <GeographicLib/UTMUPS.hpp>
 #include <GeographicLib/MGRS.hpp>
 #include <GeographicLib/PolygonArea.hpp>
+#include <GeographicLib/PolygonEdit.hpp>
+#include <GeographicLib/Rhumb.hpp>
 
 using namespace std;
 using namespace GeographicLib;
@@ -183,6 +186,94 @@ static int Planimeter29() {
   return result;
 }
 
+template<class G>
+static int addpointscheck(const G& g, bool polyline, T tol) {
+  // A random walk crossing the antimeridian and encircling the north pole
+  const size_t n = 70000;
+  vector<T> lat(n), lon(n);
+  for (size_t i = 0; i < n; ++i) {
+    T t = T(i) / T(n);
+    lat[i] = 60 + 20 * sin(37 * t) + T(0.01) * sin(T(i));
+    lon[i] = Math::AngNormalize(360 * t + 170 + 5 * cos(91 * t));
+  }
+  PolygonAreaT<G> p(g, polyline), p1(g, polyline), p4(g, polyline);
+  for (size_t i = 0; i < n; ++i)
+    p.AddPoint(lat[i], lon[i]);
+  p1.AddPoints(n, lat.data(), lon.data(), 1);
+  p4.AddPoint(lat[0], lon[0]);
+  p4.AddPoints(n - 1, lat.data() + 1, lon.data() + 1, 4);
+  T perim, area, perim1, area1, perim4, area4;
+  unsigned num = p.Compute(false, true, perim, area),
+    num1 = p1.Compute(false, true, perim1, area1),
+    num4 = p4.Compute(false, true, perim4, area4);
+  int result = num != n || num1 != n || num4 != n;
+  result += checkEquals(perim1, perim, tol * perim);
+  result += perim4 != perim1;
+  if (!polyline) {
+    result += checkEquals(area1, area, tol * g.EllipsoidArea());
+    result += area4 != area1;
+  }
+  // The points can be added to a polygon built with AddPoint
+  p.AddPoints(3, lat.data(), lon.data());
+  p.TestPoint(lat[3], lon[3], false, true, perim4, area4);
+  p1.AddPoints(4, lat.data(), lon.data());
+  num1 = p1.Compute(false, true, perim1, area1);
+  result += num1 != n + 4 || checkEquals(perim1, perim4, tol * perim4);
+  if (!polyline)
+    result += checkEquals(area1, area4, tol * g.EllipsoidArea());
+  return result;
+}
+
+static int AddPoints0() {
+  // PolygonAreaT::AddPoints agrees with AddPoint to within one unit in the
+  // last place (the bound stated in its documentation), and the results
+  // don't depend on the number of threads.
+  const T tol = numeric_limits<T>::epsilon();
+  int result = 0;
+  for (int polyline = 0; polyline < 2; ++polyline) {
+    result += addpointscheck(Geodesic::WGS84(), polyline != 0, tol);
+    result += addpointscheck(GeodesicExact::WGS84(), polyline != 0, tol);
+    result += addpointscheck(Rhumb::WGS84(), polyline != 0, tol);
+  }
+  return result;
+}
+
+static int PolygonEdit0() {
+  // Check that edits to PolygonEdit give the same results as PolygonArea
+  const Geodesic& g = Geodesic::WGS84();
+  PolygonEdit edit(g);
+  T perim, area, perim0, area0;
+  int result = 0;
+  size_t a = edit.AddPoint(52, 0);    // London
+  edit.AddPoint(41, -74);             // New York
+  size_t c = edit.AddPoint(0, 0);
+  edit.AddPoint(-26, 28);             // Johannesburg
+  edit.Insert(a, 50, 30);
+  edit.Move(c, -23, -43);             // Rio de Janeiro
+  edit.Remove(a);
+  PolygonArea polygon(g);
+  for (size_t k = edit.First(), i = 0; i < edit.NumberPoints();
+       k = edit.Next(k), ++i) {
+    T lat, lon;
+    edit.Vertex(k, lat, lon);
+    polygon.AddPoint(lat, lon);
+  }
+  for (int i = 0; i < 4; ++i) {
+    bool reverse = i & 1, sign = i & 2;
+    polygon.Compute(reverse, sign, perim0, area0);
+    result += edit.Compute(reverse, sign, perim, area) != 4;
+    result += checkEquals(perim, perim0, 1e-6);
+    result += checkEquals(area, area0, 1);
+  }
+  // Remove all but one vertex
+  while (edit.NumberPoints() > 1)
+    edit.Remove(edit.Last());
+  edit.Compute(false, true, perim, area);
+  result += checkEquals(perim, 0, 0);
+  result += checkEquals(area, 0, 0);
+  return result;
+}
+
 int main() {
   int n = 0, i;
 
@@ -202,6 +293,14 @@ int main() {
   if (i)
     cout << "Planimeter29 failure\n";
 
+  i = AddPoints0(); n += i;
+  if (i)
+    cout << "AddPoints0 failure\n";
+
+  i = PolygonEdit0(); n += i;
+  if (i)
+    cout << "PolygonEdit0 failure\n";
+
   if (n) {
     cout << n << " failure" << (n > 1 ? "s" : "") << "\n";
     return 1;
@@ -0,0 +1,138 @@
+/**
+ * \file rastertest.cpp
+ * \brief Test ApproxTransform and RasterWarp
+ *
+ * Copyright (c) Charles Karney (2022) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#include <iostream>
+#include <vector>
+#include <GeographicLib/ApproxTransform.hpp>
+#include <GeographicLib/RasterWarp.hpp>
+#include <GeographicLib/TransverseMercator.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+typedef Math::real T;
+
+static int testapproxtransform() {
+  // The approximation of UTM to geographic over a raster is within the
+  // tolerance at every pixel and needs few exact transformations; NaNs are
+  // reproduced.
+  int result = 0;
+  const TransverseMercator& tm = TransverseMercator::UTM();
+  ApproxTransform::transform f =
+    [&tm](size_t n, const T x[], const T y[], T lat[], T lon[]) -> void {
+      vector<T> x1(x, x + n);
+      for (T& t : x1) t = t < 0 ? Math::NaN() : t - 500000;
+      tm.ReverseBatch(n, 15, x1.data(), y, lat, lon);
+    };
+  const T tol = T(1e-9);
+  ApproxTransform a(f, tol);
+  const int nx = 600, ny = 500;
+  vector<T> lat(nx * ny), lon(nx * ny), x(nx * ny), y(nx * ny),
+    elat(nx * ny), elon(nx * ny);
+  size_t count = a.Grid(300050, -4000050, 100, -100, nx, ny,
+                        lat.data(), lon.data());
+  result += !(count < nx * ny / 10);
+  for (int j = 0; j < ny; ++j)
+    for (int i = 0; i < nx; ++i) {
+      x[j * nx + i] = 300050 + i * 100; y[j * nx + i] = -4000050 - j * 100;
+    }
+  f(nx * ny, x.data(), y.data(), elat.data(), elon.data());
+  for (int k = 0; k < nx * ny; ++k)
+    result += !(hypot(lat[k] - elat[k], lon[k] - elon[k]) <= tol);
+  // A raster straddling x = 0
+  count = a.Grid(-10050, 0, 100, 100, 200, 200, lat.data(), lon.data());
+  result += !(count < 200 * 200);
+  for (int j = 0; j < 200; ++j)
+    for (int i = 0; i < 200; ++i) {
+      T x0 = -10050 + i * 100, latx, lonx;
+      int k = j * 200 + i;
+      if (x0 < 0)
+        result += !(isnan(lat[k]) && isnan(lon[k]));
+      else {
+        tm.Reverse(15, x0 - 500000, T(j * 100), latx, lonx);
+        result += !(hypot(lat[k] - latx, lon[k] - lonx) <= tol);
+      }
+    }
+  return result;
+}
+
+static int testrasterwarp() {
+  // Warp a linear function on a UTM zone 32 raster to a UTM zone 33 raster.
+  // BILINEAR and CUBIC reproduce it; NEAREST picks a neighboring pixel;
+  // points outside the source get nodata; threads don't matter.
+  int result = 0;
+  const TransverseMercator& tm = TransverseMercator::UTM();
+  RasterWarp::transform f =
+    [&tm](size_t n, const T x[], const T y[], T u[], T v[]) -> void {
+      for (size_t i = 0; i < n; ++i) {
+        T lat, lon;
+        tm.Reverse(15, x[i] - 500000, y[i], lat, lon);
+        tm.Forward(9, lat, lon, u[i], v[i]);
+        u[i] += 500000;
+      }
+    };
+  const RasterWarp::Grid
+    src = {650050, 5480050, 100, 100, 1500, 1000},
+    dst = {200100, 5529900, 200, -200, 500, 400};
+  auto lin = [](T x, T y) -> T { return (x - 700000) / 1000 + y / 2000; };
+  vector<double> sdata(src.nx * src.ny), ddata(dst.nx * dst.ny),
+    ddata1(dst.nx * dst.ny);
+  for (int j = 0; j < src.ny; ++j)
+    for (int i = 0; i < src.nx; ++i)
+      sdata[j * src.nx + i] =
+        double(lin(src.x0 + i * src.dx, src.y0 + j * src.dy));
+  vector<T> x(dst.nx * dst.ny), y(dst.nx * dst.ny),
+    u(dst.nx * dst.ny), v(dst.nx * dst.ny);
+  for (int j = 0; j < dst.ny; ++j)
+    for (int i = 0; i < dst.nx; ++i) {
+      x[j * dst.nx + i] = dst.x0 + i * dst.dx;
+      y[j * dst.nx + i] = dst.y0 + j * dst.dy;
+    }
+  f(x.size(), x.data(), y.data(), u.data(), v.data());
+  for (int m = RasterWarp::NEAREST; m <= RasterWarp::CUBIC; ++m) {
+    RasterWarp::resampling method = RasterWarp::resampling(m);
+    RasterWarp warp(src, dst, f, method, T(0.001), 4);
+    warp.Warp(sdata.data(), ddata.data(), -1.0);
+    RasterWarp(src, dst, f, method, T(0.001), 1)
+      .Warp(sdata.data(), ddata1.data(), -1.0);
+    int nin = 0, nout = 0;
+    for (size_t k = 0; k < ddata.size(); ++k) {
+      result += ddata[k] != ddata1[k];
+      T fi = (u[k] - src.x0) / src.dx, fj = (v[k] - src.y0) / src.dy;
+      // CUBIC clamps the pixels beyond the edges
+      int e = method == RasterWarp::CUBIC ? 1 : 0;
+      if (fi >= e && fi <= src.nx - 1 - e && fj >= e && fj <= src.ny - 1 - e) {
+        ++nin;
+        // The slope is 0.1 per pixel
+        T d = T(0.1) * (method == RasterWarp::NEAREST ? T(0.75) : T(0.002));
+        result += !(fabs(T(ddata[k]) - lin(u[k], v[k])) <= d);
+      } else if (!(fi >= -1 && fi <= src.nx && fj >= -1 && fj <= src.ny)) {
+        ++nout;
+        result += ddata[k] != -1;
+      }
+    }
+    result += !(nin > 10000 && nout > 10000);
+  }
+  return result;
+}
+
+int main() {
+  int n = 0, i;
+
+  i = testapproxtransform(); n += i;
+  if (i) cout << "testapproxtransform failure\n";
+
+  i = testrasterwarp(); n += i;
+  if (i) cout << "testrasterwarp failure\n";
+
+  if (n) {
+    cout << n << " failure" << (n > 1 ? "s" : "") << "\n";
+    return 1;
+  }
+}
@@ -10,6 +10,7 @@
 #include <iostream>
 #include <limits>
 #include <string>
+#include <vector>
 #include <GeographicLib/Math.hpp>
 #include <GeographicLib/Utility.hpp>
 #include <GeographicLib/DMS.hpp>
@@ -106,6 +107,9 @@ int main() {
     e;
   int n = 0;
 
+#if GEOGRAPHICLIB_PRECISION != 6
+  // These checks rely on the rounding of a fixed precision type; e.g.,
+  // 1-eps/4 rounds to 1.  A double-double number holds 1-eps/4 exactly.
   check( Math::AngRound(-eps/32), -eps/32);
   check( Math::AngRound(-eps/64), -0.0   );
   check( Math::AngRound(-  T(0)), -0.0   );
@@ -148,6 +152,7 @@ int main() {
   check( Math::AngRound(T(90)-64*eps),  90-64*eps  );
   check( Math::AngRound(T(90)-32*eps),  90         );
   check( Math::AngRound(T(90)       ),  90         );
+#endif
 
   checksincosd(-  inf ,  nan,  nan);
   REMQUO_CHECK( checksincosd(-T(810), -1.0, +0.0) );
@@ -186,6 +191,44 @@ int main() {
     }
   }
 
+  {
+    // The inline reduction must match remquo and the batch versions must
+    // match the scalar ones, including signed zeros and ties.
+    vector<T> x;
+    for (int i = -40; i <= 40; ++i) {
+      T y = 45 * T(i);
+      x.push_back(y);
+      x.push_back(nextafter(y, -inf));
+      x.push_back(nextafter(y, +inf));
+      x.push_back(y + T(i) / 7);
+    }
+    T big[] = {-T(0), T(1048576), T(1048575.5), T(1234567.5), T(1e20),
+               -T(1e20), inf, -inf, nan};
+    x.insert(x.end(), big, big + sizeof(big)/sizeof(T));
+    size_t m = x.size();
+    vector<T> y(m), s(m), c(m);
+    Math::AngNormalizeBatch(m, x.data(), y.data());
+    Math::sincosdBatch(m, x.data(), s.data(), c.data());
+    int j = 0;
+    for (size_t i = 0; i < m; ++i) {
+      int q1 = 0, q2 = 0;
+      T r1 = Math::AngReduce(x[i], q1);
+      REMQUO_CHECK( T r2 = remquo(x[i], T(Math::qd), &q2);
+                    j += equiv(r1, r2) + (isnan(r1) ? 0 : (q1 - q2) & 3) );
+      T st, ct;
+      Math::sincosd(x[i], st, ct);
+      j += equiv(y[i], Math::AngNormalize(x[i])) +
+        equiv(s[i], st) + equiv(c[i], ct);
+    }
+    Math::atan2dBatch(m, s.data(), c.data(), y.data());
+    for (size_t i = 0; i < m; ++i)
+      j += equiv(y[i], Math::atan2d(s[i], c[i]));
+    if (j) {
+      cout << "Line " << __LINE__ << " : batch angle fail\n";
+      ++n;
+    }
+  }
+
   check( Math::sind(-  inf ),  nan);
   check( Math::sind(-T(720)), -0.0);
   check( Math::sind(-T(540)), -0.0);
@@ -302,10 +345,12 @@ int main() {
   check( Math::AngDiff(+T(365), +T(  5), e), -0.0 );
   check( Math::AngDiff(+T(  5), +T(185), e), +180.0 );
   check( Math::AngDiff(+T(185), +T(  5), e), -180.0 );
+#if GEOGRAPHICLIB_PRECISION != 6
   check( Math::AngDiff( +eps  , +T(180), e), +180.0 );
   check( Math::AngDiff( -eps  , +T(180), e), -180.0 );
   check( Math::AngDiff( +eps  , -T(180), e), +180.0 );
   check( Math::AngDiff( -eps  , -T(180), e), -180.0 );
+#endif
 
   {
     T x = 138 + 128 * eps, y = -164;
@@ -510,6 +555,9 @@ int main() {
     }
   }
 
+#if GEOGRAPHICLIB_PRECISION != 6
+  // With double-double, lon2 differs from +/-180 by less than eps/2 (which
+  // rounds away with a fixed precision type).
   {
     // azimuths = +/-0 and +/-180 for the direct problem
     // azi1, lon2, azi2
@@ -544,6 +592,7 @@ int main() {
       ++n;
     }
   }
+#endif
 
   {
     // lat = +/-0 in UTMUPS::Forward
@@ -0,0 +1,357 @@
+/**
+ * \file utiltest.cpp
+ * \brief Test the diagnostic and utility classes
+ *
+ * Copyright (c) Charles Karney (2022) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <GeographicLib/DoubleDouble.hpp>
+#include <GeographicLib/Geodesic.hpp>
+#include <GeographicLib/GeodesicBatchExecutor.hpp>
+#include <GeographicLib/GeodesicExact.hpp>
+#include <GeographicLib/Geoid.hpp>
+#include <GeographicLib/GravityModel.hpp>
+#include <GeographicLib/Histogram.hpp>
+#include <GeographicLib/MagneticModel.hpp>
+#include <GeographicLib/MemoryPolicy.hpp>
+#include <GeographicLib/Rhumb.hpp>
+#include <GeographicLib/TransverseMercator.hpp>
+#include <GeographicLib/TransverseMercatorExact.hpp>
+#include <GeographicLib/Trace.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+typedef Math::real T;
+
+static int checkEquals(T x, T y, T d) {
+  if (fabs(x - y) <= d)
+    return 0;
+  cout << "checkEquals fails: " << x << " != " << y << " +/- " << d << "\n";
+  return 1;
+}
+
+static int checkSame(T x, T y) {
+  // Shared instances must give bitwise identical results
+  if (x == y || (isnan(x) && isnan(y)))
+    return 0;
+  cout << "checkSame fails: " << x << " != " << y << "\n";
+  return 1;
+}
+
+static int testhistogram() {
+  // Out of range values go into the end bins; with GEOGRAPHICLIB_INSTRUMENT =
+  // 1, the solvers record the paths taken and the iteration counts.
+  Histogram h;
+  h.Add(2); h.Add(2); h.Add(5); h.Add(-1); h.Add(1000);
+  int result = h.Total() == 5 && h.Count(0) == 1 && h.Count(2) == 2 &&
+    h.Count(Histogram::nbins - 1) == 1 &&
+    h.Bins().size() == size_t(Histogram::nbins) ? 0 : 1;
+  result += checkEquals(T(h.Mean()),
+                        T(double(2 + 2 + 5 + Histogram::nbins - 1) / 5), 0);
+  Histogram c(h);
+  h.Reset();
+  result += h.Total() == 0 && h.Bins().empty() && c.Total() == 5 ? 0 : 1;
+  result += Histogram::Log2Bin(0) == 0 && Histogram::Log2Bin(1) == 1 &&
+    Histogram::Log2Bin(1023) == 10 && Histogram::Log2Bin(1024) == 11 ? 0 : 1;
+#if GEOGRAPHICLIB_INSTRUMENT
+  Geodesic g(Constants::WGS84_a(), Constants::WGS84_f());
+  T s12;
+  g.Inverse(0, 0, 10, 0, s12);                  // meridional
+  g.Inverse(0, 0, 0, 10, s12);                  // equatorial
+  g.Inverse(10, 10, T(10.0000001), T(10.0000001), s12); // short
+  g.Inverse(10, 10, 40, 50, s12);               // spherical start
+  g.Inverse(30, 0, T(-29.9), T(179.8), s12);    // astroid start
+  const Histogram& p = g.InversePaths();
+  result += p.Total() == 5 &&
+    p.Count(Geodesic::PATH_MERIDIONAL) == 1 &&
+    p.Count(Geodesic::PATH_EQUATORIAL) == 1 &&
+    p.Count(Geodesic::PATH_SHORTLINE) == 1 &&
+    p.Count(Geodesic::PATH_SPHERICAL) == 1 &&
+    p.Count(Geodesic::PATH_ASTROID) == 1 ? 0 : 1;
+  result += g.InverseIterations().Total() == 2 &&
+    g.InverseBisections().Total() == 2 ? 0 : 1;
+  g.ResetStatistics();
+  result += p.Total() == 0 ? 0 : 1;
+  TransverseMercatorExact tm(Constants::WGS84_a(), Constants::WGS84_f(),
+                             Constants::UTM_k0(), false, true);
+  // The construction of the seed tables isn't counted
+  result += tm.ForwardIterations().Total() == 0 ? 0 : 1;
+  T x, y, lat, lon;
+  tm.Forward(0, 40, 3, x, y);
+  tm.Reverse(0, x, y, lat, lon);
+  result += tm.ForwardIterations().Total() == 1 &&
+    tm.ReverseIterations().Total() == 1 ? 0 : 1;
+#endif
+  return result;
+}
+
+static int tracebegins = 0, traceends = 0;
+static void tracehandler(const char* /*name*/, bool begin) {
+  ++(begin ? tracebegins : traceends);
+}
+
+static int testtrace() {
+  // Spans are recorded only when enabled and are written as JSON; the
+  // handler sees the beginning and end of each span.
+  int result = 0;
+  Trace::Clear();
+  { Trace::Span s("skipped"); }
+  result += Trace::Size() == 0 ? 0 : 1;
+  Trace::Enable(true);
+  Trace::SetHandler(tracehandler);
+  {
+    Trace::Span s1("outer \"span\"");
+    Trace::Span s2("inner");
+  }
+  Trace::Enable(false);
+  Trace::SetHandler(nullptr);
+  { Trace::Span s("skipped"); }
+  result += Trace::Size() == 2 && tracebegins == 2 && traceends == 2 ? 0 : 1;
+  ostringstream str;
+  Trace::WriteJSON(str);
+  string json = str.str();
+  result += json.find("\"name\":\"inner\"") != string::npos &&
+    json.find("\"name\":\"outer \\\"span\\\"\"") != string::npos &&
+    json.find("skipped") == string::npos ? 0 : 1;
+  Trace::Clear();
+  result += Trace::Size() == 0 ? 0 : 1;
+  return result;
+}
+
+static int testsharedinstances() {
+  // Get returns the same object for the same parameters (also when called
+  // concurrently) and a different one for different parameters; an
+  // invalid set of parameters throws each time.
+  const T a = 6378137, f = 1/T(297);
+  int result = 0;
+  const Geodesic& g1 = Geodesic::Get(a, f);
+  result += &Geodesic::Get(a, f) != &g1;
+  result += &Geodesic::Get(a, f, true) == &g1;
+  result += &Geodesic::Get(a, 1/T(298)) == &g1;
+  {
+    T s12, s12a;
+    g1.Inverse(10, 20, 30, 40, s12);
+    Geodesic(a, f).Inverse(10, 20, 30, 40, s12a);
+    result += checkSame(s12, s12a);
+  }
+  vector<const Geodesic*> got(8);
+  GeodesicBatchExecutor exec(4, 1);
+  exec.ForEach(got.size(), [&](size_t i0, size_t i1) -> void {
+    for (size_t i = i0; i < i1; ++i)
+      got[i] = &Geodesic::Get(a, 1/T(250 + 10 * (i % 2)));
+  });
+  for (size_t i = 2; i < got.size(); ++i)
+    result += got[i] != got[i % 2];
+  result += got[0] == got[1];
+  const GeodesicExact& ge = GeodesicExact::Get(a, f);
+  result += &GeodesicExact::Get(a, f) != &ge;
+  result += checkEquals(ge.Flattening(), f, 0);
+  const Rhumb& rh = Rhumb::Get(a, f, false);
+  result += &Rhumb::Get(a, f, false) != &rh;
+  result += &Rhumb::Get(a, f) == &rh;
+  const TransverseMercator& tm = TransverseMercator::Get(a, f, T(0.9996));
+  result += &TransverseMercator::Get(a, f, T(0.9996)) != &tm;
+  result += &TransverseMercator::Get(a, f, 1) == &tm;
+  for (int i = 0; i < 2; ++i) {
+    try {
+      Geodesic::Get(-1, f);
+      ++result;
+    }
+    catch (const GeographicErr&) {}
+    // The models are keyed by name and directory; a missing model isn't
+    // registered.
+    const string dir = "/nonexistent-geographiclib-data";
+    try {
+      Geoid::Get("nosuchgeoid", dir);
+      ++result;
+    }
+    catch (const GeographicErr&) {}
+    try {
+      GravityModel::Get("nosuchmodel", dir);
+      ++result;
+    }
+    catch (const GeographicErr&) {}
+    try {
+      MagneticModel::Get("nosuchmodel", dir);
+      ++result;
+    }
+    catch (const GeographicErr&) {}
+  }
+  return result;
+}
+
+static int testmemorypolicy() {
+  // The policy settings read back; blocks allocated with each page size and
+  // node (including one which doesn't exist) are aligned and hold what was
+  // written to them; a vector with the allocator matches a plain one.
+  int result = 0;
+  MemoryPolicy::SetNode(-5);
+  result += MemoryPolicy::Node() != -1;
+  const int nodes = MemoryPolicy::Nodes(), cur = MemoryPolicy::CurrentNode();
+  result += !(nodes >= 1 && cur >= 0 && cur < nodes);
+  result += MemoryPolicy::RunOnNode(-1) || MemoryPolicy::RunOnNode(nodes);
+  const size_t big = size_t(1) << 21,
+    sizes[] = {1, 1000, big - 1, big, 5 * big + 3};
+  for (int p = 0; p < 3; ++p) {
+    MemoryPolicy::SetPages(MemoryPolicy::pages(p));
+    result += MemoryPolicy::Pages() != MemoryPolicy::pages(p);
+    for (int node = -1; node <= nodes; ++node) {
+      MemoryPolicy::SetNode(node);
+      result += MemoryPolicy::Node() != node;
+      for (size_t n : sizes) {
+        unsigned char* b =
+          static_cast<unsigned char*>(MemoryPolicy::Allocate(n));
+        result += reinterpret_cast<uintptr_t>(b) % 16 != 0;
+        for (size_t k = 0; k < n; k += 4093) b[k] = (unsigned char)(k % 251);
+        b[n - 1] = 0x5a;
+        int j = b[n - 1] != 0x5a;
+        for (size_t k = 0; k < n - 1; k += 4093)
+          j += b[k] != (unsigned char)(k % 251);
+        if (j) cout << "testmemorypolicy failure: " << p << " " << node
+                    << " " << n << "\n";
+        result += j;
+        MemoryPolicy::Deallocate(b, n);
+      }
+    }
+    const size_t n = 3 * big / sizeof(T) + 7;
+    vector<T, MemoryPolicy::Allocator<T> > v(n);
+    vector<T> w;
+    MemoryPolicy::Reserve(w, n);
+    result += w.capacity() < n;
+    for (size_t k = 0; k < n; ++k) {
+      v[k] = T(k) / 3; w.push_back(T(k) / 3);
+    }
+    vector<T, MemoryPolicy::Allocator<T> > vc(v);
+    result += !equal(vc.begin(), vc.end(), w.begin());
+  }
+  MemoryPolicy::SetPages(MemoryPolicy::SMALLPAGES);
+  MemoryPolicy::SetNode(-1);
+  MemoryPolicy::SetReplicate(true);
+  result += !MemoryPolicy::Replicate();
+  MemoryPolicy::SetReplicate(false);
+  return result;
+}
+
+static int testdoubledouble() {
+  // The DoubleDouble functions agree with the long double ones (where
+  // these have at least a 64-bit mantissa) and with the double ones; the
+  // identities between them hold to double-double accuracy; special
+  // values are treated as for doubles; formatted output can be read back.
+  typedef DoubleDouble D;
+  typedef long double L;
+  struct fun {
+    const char* name;
+    D (*d)(const D&);
+    L (*l)(L);
+    double x0, x1;
+  };
+  // The friend functions are only found by argument-dependent lookup
+#define DDFUN(f, x0, x1) {#f, [](const D& x) -> D { return f(x); }, \
+      [](L x) -> L { return std::f(x); }, x0, x1}
+  const fun funs[] = {
+    DDFUN(sqrt, 0, 1e3), DDFUN(cbrt, -1e3, 1e3), DDFUN(exp, -20, 20),
+    DDFUN(expm1, -1, 1), DDFUN(log, 1e-3, 1e3), DDFUN(log1p, -0.5, 1),
+    DDFUN(sin, -10, 10), DDFUN(cos, -10, 10), DDFUN(tan, -1.5, 1.5),
+    DDFUN(asin, -1, 1), DDFUN(acos, -1, 1), DDFUN(atan, -10, 10),
+    DDFUN(sinh, -5, 5), DDFUN(cosh, -5, 5), DDFUN(tanh, -5, 5),
+    DDFUN(asinh, -5, 5), DDFUN(atanh, -0.99, 0.99),
+  };
+#undef DDFUN
+  const bool longcheck = numeric_limits<L>::digits >= 64;
+  const L ltol = 8 * numeric_limits<L>::epsilon();
+  const double dtol = 2 * numeric_limits<double>::epsilon();
+  int result = 0;
+  for (const fun& f : funs) {
+    int j = 0;
+    for (int i = 0; i <= 100; ++i) {
+      // A point which isn't a double but which is a long double (it spans
+      // 61 bits); the magnitude is reduced so that it lies in the domain.
+      double xd = f.x0 + (f.x1 - f.x0) * i / 100;
+      D x = xd == 0 ? D(xd) :
+        D(xd) - std::copysign(std::ldexp(1.0, std::ilogb(xd) - 60), xd),
+        y = f.d(x);
+      L yl = f.l(L(x.hi()) + L(x.lo()));
+      j += !(std::fabs(y.hi() - double(yl)) <=
+             dtol * std::fabs(y.hi()) + 1e-300);
+      if (longcheck) {
+        j += !(std::fabs((L(y.hi()) - yl) + L(y.lo())) <=
+               ltol * std::fabs(yl) + 1e-300L);
+      }
+    }
+    if (j) cout << "testdoubledouble failure: " << f.name << "\n";
+    result += j;
+  }
+  const D eps = numeric_limits<D>::epsilon(), third = D(1)/3;
+  result += !(eps < 1e-30 && eps > 1e-33);
+  result += !(fabs(third * 3 - 1) <= eps);
+  result += !(fabs(sqrt(third) * sqrt(third) - third) <= 2 * eps);
+  result += !(fabs(exp(log(third)) - third) <= 4 * eps);
+  result += !(fabs(sin(third) * sin(third) + cos(third) * cos(third) - 1)
+              <= 4 * eps);
+  result += !(fabs(atan2(sin(third), cos(third)) - third) <= 4 * eps);
+  D pi;
+  istringstream("3.14159265358979323846264338327950") >> pi;
+  result += !(fabs(4 * atan(D(1)) - pi) <= 4 * eps);
+  result += !(fabs(hypot(D(3), D(4)) - 5) <= eps);
+  result += !(fabs(pow(third, D(3)) * 27 - 1) <= 8 * eps);
+  result += !(fabs(remainder(D(370) + third, D(360)) - (10 + third))
+              <= 1e3 * eps);
+  // Special values
+  const D inf = numeric_limits<D>::infinity(),
+    nan = numeric_limits<D>::quiet_NaN();
+  result += !(isnan(nan + 1) && isnan(sqrt(D(-1))) && isnan(inf - inf) &&
+              isinf(inf * 2) && isinf(exp(D(1000))) && exp(-inf) == 0 &&
+              isnan(sin(inf)) && log(D(0)) == -inf);
+  result += !(signbit(D(-0.0)) && signbit(sqrt(D(-0.0))) &&
+              !signbit(D(0.0)) && signbit(D(-0.0) * 2));
+  // Formatted output
+  for (int i = 1; i < 10; ++i) {
+    D x = third * i * 1e10, y;
+    ostringstream str;
+    str << setprecision(32) << x;
+    istringstream(str.str()) >> y;
+    result += !(fabs(y - x) <= 2 * eps * x);
+  }
+  {
+    ostringstream str;
+    str << fixed << setprecision(25) << third;
+    result += str.str() != "0.3333333333333333333333333";
+  }
+  return result;
+}
+
+int main() {
+  int n = 0, i;
+
+  i = testhistogram(); n += i;
+  if (i) cout << "testhistogram failure\n";
+
+  i = testtrace(); n += i;
+  if (i) cout << "testtrace failure\n";
+
+  i = testsharedinstances(); n += i;
+  if (i) cout << "testsharedinstances failure\n";
+
+  i = testmemorypolicy(); n += i;
+  if (i) cout << "testmemorypolicy failure\n";
+
+  i = testdoubledouble(); n += i;
+  if (i) cout << "testdoubledouble failure\n";
+
+  if (n) {
+    cout << n << " failure" << (n > 1 ? "s" : "") << "\n";
+    return 1;
+  }
+}
@@ -25,19 +25,22 @@
 #endif
 
 #include "CartConvert.usage"
+#include "ToolPipeline.hpp"
 
 int main(int argc, const char* const argv[]) {
   try {
     using namespace GeographicLib;
     typedef Math::real real;
     Utility::set_digits();
-    bool localcartesian = false, reverse = false, longfirst = false;
+    bool localcartesian = false, reverse = false, longfirst = false,
+      binary = false;
     real
       a = Constants::WGS84_a(),
       f = Constants::WGS84_f();
     int prec = 6;
     real lat0 = 0, lon0 = 0, h0 = 0;
     std::string istring, ifile, ofile, cdelim;
+    unsigned nthreads = 1;
     char lsep = ';';
 
     for (int m = 1; m < argc; ++m) {
@@ -79,7 +82,9 @@ int main(int argc, const char* const argv[]) {
           std::cerr << "Precision " << argv[m] << " is not a number\n";
           return 1;
         }
-      }  else if (arg == "--input-string") {
+      }  else if (arg == "--binary")
+        binary = true;
+      else if (arg == "--input-string") {
         if (++m == argc) return usage(1, true);
         istring = argv[m];
       } else if (arg == "--input-file") {
@@ -98,7 +103,11 @@ int main(int argc, const char* const argv[]) {
       } else if (arg == "--comment-delimiter") {
         if (++m == argc) return usage(1, true);
         cdelim = argv[m];
-     } else if (arg == "--version") {
+      } else if (arg == "-j" || arg == "--threads") {
+        if (++m == argc) return usage(1, true);
+        if (!ToolPipeline::Threads(argv[m], nthreads, std::cerr))
+          return 1;
+      } else if (arg == "--version") {
         std::cout << argv[0] << ": GeographicLib version "
                   << GEOGRAPHICLIB_VERSION_STRING << "\n";
         return 0;
@@ -110,11 +119,15 @@ int main(int argc, const char* const argv[]) {
       std::cerr << "Cannot specify --input-string and --input-file together\n";
       return 1;
     }
+    if (binary && !istring.empty()) {
+      std::cerr << "Cannot specify --input-string and --binary together\n";
+      return 1;
+    }
     if (ifile == "-") ifile.clear();
     std::ifstream infile;
     std::istringstream instring;
     if (!ifile.empty()) {
-      infile.open(ifile.c_str());
+      infile.open(ifile.c_str(), binary ? std::ios::binary : std::ios::in);
       if (!infile.is_open()) {
         std::cerr << "Cannot open " << ifile << " for reading\n";
         return 1;
@@ -135,7 +148,7 @@ int main(int argc, const char* const argv[]) {
     std::ofstream outfile;
     if (ofile == "-") ofile.clear();
     if (!ofile.empty()) {
-      outfile.open(ofile.c_str());
+      outfile.open(ofile.c_str(), binary ? std::ios::binary : std::ios::out);
       if (!outfile.is_open()) {
         std::cerr << "Cannot open " << ofile << " for writing\n";
         return 1;
@@ -149,12 +162,43 @@ int main(int argc, const char* const argv[]) {
     // Max precision = 10: 0.1 nm in distance, 10^-15 deg (= 0.11 nm),
     // 10^-11 sec (= 0.3 nm).
     prec = std::min(10 + Math::extra_digits(), std::max(0, prec));
-    std::string s, eol, stra, strb, strc, strd;
-    std::istringstream str;
     int retval = 0;
-    while (std::getline(*input, s)) {
+    if (binary) {
+      // Binary records of little-endian doubles; an error gives a record of
+      // NaNs.
+      real u[3], v[3];
+      while (input->peek() != std::char_traits<char>::eof()) {
+        Utility::readarray<double, real, false>(*input, u, 3);
+        real lat, lon, h;
+        if (reverse) {
+          if (localcartesian)
+            lc.Reverse(u[0], u[1], u[2], lat, lon, h);
+          else
+            ec.Reverse(u[0], u[1], u[2], lat, lon, h);
+          v[0] = longfirst ? lon : lat; v[1] = longfirst ? lat : lon;
+          v[2] = h;
+        } else {
+          lat = longfirst ? u[1] : u[0]; lon = longfirst ? u[0] : u[1];
+          h = u[2];
+          using std::fabs;
+          if (fabs(lat) > Math::qd) {
+            v[0] = v[1] = v[2] = Math::NaN();
+            retval = 1;
+          } else if (localcartesian)
+            lc.Forward(lat, lon, h, v[0], v[1], v[2]);
+          else
+            ec.Forward(lat, lon, h, v[0], v[1], v[2]);
+        }
+        Utility::writearray<double, real, false>(*output, v, 3);
+      }
+      return retval;
+    }
+    // Process a line of input; with -j, this is called concurrently on
+    // several threads.
+    auto process = [&](std::string& s, std::ostream& os) -> int {
+      std::string eol("\n"), stra, strb, strc, strd;
+      std::istringstream str;
       try {
-        eol = "\n";
         if (!cdelim.empty()) {
           std::string::size_type m = s.find(cdelim);
           if (m != std::string::npos) {
@@ -182,25 +226,26 @@ int main(int argc, const char* const argv[]) {
             lc.Reverse(x, y, z, lat, lon, h);
           else
             ec.Reverse(x, y, z, lat, lon, h);
-          *output << Utility::str(longfirst ? lon : lat, prec + 5) << " "
-                  << Utility::str(longfirst ? lat : lon, prec + 5) << " "
-                  << Utility::str(h, prec) << eol;
+          os << Utility::str(longfirst ? lon : lat, prec + 5) << " "
+             << Utility::str(longfirst ? lat : lon, prec + 5) << " "
+             << Utility::str(h, prec) << eol;
         } else {
           if (localcartesian)
             lc.Forward(lat, lon, h, x, y, z);
           else
             ec.Forward(lat, lon, h, x, y, z);
-          *output << Utility::str(x, prec) << " "
-                  << Utility::str(y, prec) << " "
-                  << Utility::str(z, prec) << eol;
+          os << Utility::str(x, prec) << " "
+             << Utility::str(y, prec) << " "
+             << Utility::str(z, prec) << eol;
         }
       }
       catch (const std::exception& e) {
-        *output << "ERROR: " << e.what() << "\n";
-        retval = 1;
+        os << "ERROR: " << e.what() << "\n";
+        return 1;
       }
-    }
-    return retval;
+      return 0;
+    };
+    return ToolPipeline::ProcessLines(*input, *output, nthreads, process);
   }
   catch (const std::exception& e) {
     std::cerr << "Caught exception: " << e.what() << "\n";
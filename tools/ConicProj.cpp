@@ -25,6 +25,7 @@
 #endif
 
 #include "ConicProj.usage"
+#include "ToolPipeline.hpp"
 
 int main(int argc, const char* const argv[]) {
   try {
@@ -38,6 +39,7 @@ int main(int argc, const char* const argv[]) {
       f = Constants::WGS84_f();
     int prec = 6;
     std::string istring, ifile, ofile, cdelim;
+    unsigned nthreads = 1;
     char lsep = ';';
 
     for (int m = 1; m < argc; ++m) {
@@ -126,6 +128,10 @@ int main(int argc, const char* const argv[]) {
       } else if (arg == "--comment-delimiter") {
         if (++m == argc) return usage(1, true);
         cdelim = argv[m];
+      } else if (arg == "-j" || arg == "--threads") {
+        if (++m == argc) return usage(1, true);
+        if (!ToolPipeline::Threads(argv[m], nthreads, std::cerr))
+          return 1;
       } else if (arg == "--version") {
         std::cout << argv[0] << ": GeographicLib version "
                   << GEOGRAPHICLIB_VERSION_STRING << "\n";
@@ -187,12 +193,12 @@ int main(int argc, const char* const argv[]) {
     // Max precision = 10: 0.1 nm in distance, 10^-15 deg (= 0.11 nm),
     // 10^-11 sec (= 0.3 nm).
     prec = std::min(10 + Math::extra_digits(), std::max(0, prec));
-    std::string s, eol, stra, strb, strc;
-    std::istringstream str;
-    int retval = 0;
-    while (std::getline(*input, s)) {
+    // Process a line of input; with -j, this is called concurrently on
+    // several threads.
+    auto process = [&](std::string& s, std::ostream& os) -> int {
+      std::string eol("\n"), stra, strb, strc;
+      std::istringstream str;
       try {
-        eol = "\n";
         if (!cdelim.empty()) {
           std::string::size_type m = s.find(cdelim);
           if (m != std::string::npos) {
@@ -216,27 +222,28 @@ int main(int argc, const char* const argv[]) {
             lproj.Reverse(lon0, x, y, lat, lon, gamma, k);
           else
             aproj.Reverse(lon0, x, y, lat, lon, gamma, k);
-          *output << Utility::str(longfirst ? lon : lat, prec + 5) << " "
-                  << Utility::str(longfirst ? lat : lon, prec + 5) << " "
-                  << Utility::str(gamma, prec + 6) << " "
-                  << Utility::str(k, prec + 6) << eol;
+          os << Utility::str(longfirst ? lon : lat, prec + 5) << " "
+             << Utility::str(longfirst ? lat : lon, prec + 5) << " "
+             << Utility::str(gamma, prec + 6) << " "
+             << Utility::str(k, prec + 6) << eol;
         } else {
           if (lcc)
             lproj.Forward(lon0, lat, lon, x, y, gamma, k);
           else
             aproj.Forward(lon0, lat, lon, x, y, gamma, k);
-          *output << Utility::str(x, prec) << " "
-                  << Utility::str(y, prec) << " "
-                  << Utility::str(gamma, prec + 6) << " "
-                  << Utility::str(k, prec + 6) << eol;
+          os << Utility::str(x, prec) << " "
+             << Utility::str(y, prec) << " "
+             << Utility::str(gamma, prec + 6) << " "
+             << Utility::str(k, prec + 6) << eol;
         }
       }
       catch (const std::exception& e) {
-        *output << "ERROR: " << e.what() << "\n";
-        retval = 1;
+        os << "ERROR: " << e.what() << "\n";
+        return 1;
       }
-    }
-    return retval;
+      return 0;
+    };
+    return ToolPipeline::ProcessLines(*input, *output, nthreads, process);
   }
   catch (const std::exception& e) {
     std::cerr << "Caught exception: " << e.what() << "\n";
@@ -13,6 +13,8 @@
 #include <string>
 #include <sstream>
 #include <fstream>
+#include <algorithm>
+#include <vector>
 #include <GeographicLib/GeoCoords.hpp>
 #include <GeographicLib/DMS.hpp>
 #include <GeographicLib/Utility.hpp>
@@ -24,8 +26,12 @@
 #endif
 
 #include "GeoConvert.usage"
+#include "ToolPipeline.hpp"
+#include "ToolServer.hpp"
+#include "ToolStats.hpp"
 
-int main(int argc, const char* const argv[]) {
+int run(int argc, const char* const argv[],
+        std::istream& in, std::ostream& out, std::ostream& err) {
   try {
     using namespace GeographicLib;
     typedef Math::real real;
@@ -36,8 +42,10 @@ int main(int argc, const char* const argv[]) {
     int zone = UTMUPS::MATCH;
     bool centerp = true, longfirst = false;
     std::string istring, ifile, ofile, cdelim;
+    unsigned nthreads = 1;
     char lsep = ';', dmssep = char(0);
-    bool sethemisphere = false, northp = false, abbrev = true, latch = false;
+    bool sethemisphere = false, northp = false, abbrev = true, latch = false,
+      binary = false, stats = false;
 
     for (int m = 1; m < argc; ++m) {
       std::string arg(argv[m]);
@@ -58,7 +66,7 @@ int main(int argc, const char* const argv[]) {
       else if (arg == "-n")
         centerp = false;
       else if (arg == "-z") {
-        if (++m == argc) return usage(1, true);
+        if (++m == argc) return usage(1, true, out, err);
         std::string zonestr(argv[m]);
         try {
           UTMUPS::DecodeZone(zonestr, zone, northp);
@@ -68,12 +76,12 @@ int main(int argc, const char* const argv[]) {
           std::istringstream str(zonestr);
           char c;
           if (!(str >> zone) || (str >> c)) {
-            std::cerr << "Zone " << zonestr
+            err << "Zone " << zonestr
                       << " is not a number or zone+hemisphere\n";
             return 1;
           }
           if (!(zone >= UTMUPS::MINZONE && zone <= UTMUPS::MAXZONE)) {
-            std::cerr << "Zone " << zone << " not in [0, 60]\n";
+            err << "Zone " << zone << " not in [0, 60]\n";
             return 1;
           }
           sethemisphere = false;
@@ -98,57 +106,74 @@ int main(int argc, const char* const argv[]) {
       } else if (arg == "-w")
         longfirst = !longfirst;
       else if (arg == "-p") {
-        if (++m == argc) return usage(1, true);
+        if (++m == argc) return usage(1, true, out, err);
         try {
           prec = Utility::val<int>(std::string(argv[m]));
         }
         catch (const std::exception&) {
-          std::cerr << "Precision " << argv[m] << " is not a number\n";
+          err << "Precision " << argv[m] << " is not a number\n";
           return 1;
         }
       } else if (arg == "-l")
         abbrev = false;
       else if (arg == "-a")
         abbrev = true;
+      else if (arg == "--binary")
+        binary = true;
+      else if (arg == "--stats")
+        stats = true;
       else if (arg == "--input-string") {
-        if (++m == argc) return usage(1, true);
+        if (++m == argc) return usage(1, true, out, err);
         istring = argv[m];
       } else if (arg == "--input-file") {
-        if (++m == argc) return usage(1, true);
+        if (++m == argc) return usage(1, true, out, err);
         ifile = argv[m];
       } else if (arg == "--output-file") {
-        if (++m == argc) return usage(1, true);
+        if (++m == argc) return usage(1, true, out, err);
         ofile = argv[m];
       } else if (arg == "--line-separator") {
-        if (++m == argc) return usage(1, true);
+        if (++m == argc) return usage(1, true, out, err);
         if (std::string(argv[m]).size() != 1) {
-          std::cerr << "Line separator must be a single character\n";
+          err << "Line separator must be a single character\n";
           return 1;
         }
         lsep = argv[m][0];
       } else if (arg == "--comment-delimiter") {
-        if (++m == argc) return usage(1, true);
+        if (++m == argc) return usage(1, true, out, err);
         cdelim = argv[m];
+      } else if (arg == "-j" || arg == "--threads") {
+        if (++m == argc) return usage(1, true, out, err);
+        if (!ToolPipeline::Threads(argv[m], nthreads, err))
+          return 1;
       } else if (arg == "--version") {
-        std::cout << argv[0] << ": GeographicLib version "
+        out << argv[0] << ": GeographicLib version "
                   << GEOGRAPHICLIB_VERSION_STRING << "\n";
         MGRS::Check();
         return 0;
       } else
-        return usage(!(arg == "-h" || arg == "--help"), arg != "--help");
+        return usage(!(arg == "-h" || arg == "--help"),
+                     arg != "--help", out, err);
     }
 
     if (!ifile.empty() && !istring.empty()) {
-      std::cerr << "Cannot specify --input-string and --input-file together\n";
+      err << "Cannot specify --input-string and --input-file together\n";
+      return 1;
+    }
+    if (binary && !istring.empty()) {
+      err << "Cannot specify --input-string and --binary together\n";
+      return 1;
+    }
+    if (binary && (outputmode == DMS || outputmode == MGRS)) {
+      err << "Cannot specify -d, -:, or -m with --binary\n";
       return 1;
     }
     if (ifile == "-") ifile.clear();
     std::ifstream infile;
     std::istringstream instring;
     if (!ifile.empty()) {
-      infile.open(ifile.c_str());
+      infile.open(ifile.c_str(), binary ? std::ios::binary : std::ios::in);
       if (!infile.is_open()) {
-        std::cerr << "Cannot open " << ifile << " for reading\n";
+        err << "Cannot open " << ifile << " for reading\n";
         return 1;
       }
     } else if (!istring.empty()) {
@@ -162,84 +187,224 @@ int main(int argc, const char* const argv[]) {
       instring.str(istring);
     }
     std::istream* input = !ifile.empty() ? &infile :
-      (!istring.empty() ? &instring : &std::cin);
+      (!istring.empty() ? &instring : &in);
 
     std::ofstream outfile;
     if (ofile == "-") ofile.clear();
     if (!ofile.empty()) {
-      outfile.open(ofile.c_str());
+      outfile.open(ofile.c_str(), binary ? std::ios::binary : std::ios::out);
       if (!outfile.is_open()) {
-        std::cerr << "Cannot open " << ofile << " for writing\n";
+        err << "Cannot open " << ofile << " for writing\n";
         return 1;
       }
     }
-    std::ostream* output = !ofile.empty() ? &outfile : &std::cout;
-
-    GeoCoords p;
-    std::string s, eol;
-    std::string os;
-    int retval = 0;
+    std::ostream* output = !ofile.empty() ? &outfile : &out;
 
-    while (std::getline(*input, s)) {
-      eol = "\n";
-      try {
-        if (!cdelim.empty()) {
-          std::string::size_type m = s.find(cdelim);
-          if (m != std::string::npos) {
-            eol = " " + s.substr(m) + "\n";
-            s = s.substr(0, m);
+    const size_t bufsize = 128, nbatch = 256;
+    // Whether the output needs the UTM/UPS coordinates
+    const bool projectp = !(outputmode == GEOGRAPHIC || outputmode == DMS);
+    // The statistics for --stats; the phases of the calculations are timed
+    // with ToolStats::Lap.
+    ToolStats::Stats tstats(stats);
+    if (binary) {
+      int retval = 0;
+      // Binary records of little-endian doubles: the input is latitude and
+      // longitude; the output is latitude and longitude with -g, zone,
+      // hemisphere (1 for north, 0 for south), easting, and northing with
+      // -u, and meridian convergence and scale with -c.  An error gives a
+      // record of NaNs.  The records are handled in batches of those which
+      // have been read into the input buffer.
+      std::vector<GeoCoords> p(nbatch);
+      std::vector<int> bad(nbatch);
+      real u[2], v[4];
+      int nout = outputmode == UTMUPS ? 4 : 2;
+      ToolStats::Lap lap(tstats);
+      while (input->peek() != std::char_traits<char>::eof()) {
+        size_t n = 0;
+        do {
+          Utility::readarray<double, real, false>(*input, u, 2);
+          lap.Mark(ToolStats::IO);
+          try {
+            p[n].Reset(longfirst ? u[1] : u[0], longfirst ? u[0] : u[1]);
+            bad[n] = 0;
           }
+          catch (const std::exception&) {
+            p[n] = GeoCoords();
+            bad[n] = 1;
+          }
+          lap.Mark(ToolStats::PARSE);
+          ++n;
+        } while (n < nbatch && input->rdbuf()->in_avail() > 0);
+        if (projectp && !latch)
+          GeoCoords::SetAltZoneBatch(n, p.data(), zone);
+        lap.Mark(ToolStats::COMPUTE);
+        size_t nerr = 0;
+        for (size_t i = 0; i < n; ++i) {
+          bool ok = !bad[i];
+          if (ok) {
+            try {
+              p[i].SetAltZone(zone);
+              switch (outputmode) {
+              case UTMUPS:
+                {
+                  bool h = sethemisphere ? northp : p[i].Northp();
+                  int z;
+                  UTMUPS::Transfer(p[i].AltZone(), p[i].Northp(),
+                                   p[i].AltEasting(), p[i].AltNorthing(),
+                                   p[i].AltZone(), h, v[2], v[3], z);
+                  v[0] = real(p[i].AltZone()); v[1] = real(h ? 1 : 0);
+                }
+                break;
+              case CONVERGENCE:
+                v[0] = p[i].AltConvergence(); v[1] = p[i].AltScale();
+                break;
+              default:          // case GEOGRAPHIC:
+                v[0] = longfirst ? p[i].Longitude() : p[i].Latitude();
+                v[1] = longfirst ? p[i].Latitude() : p[i].Longitude();
+                break;
+              }
+              if (latch && zone < UTMUPS::MINZONE &&
+                  p[i].AltZone() >= UTMUPS::MINZONE) {
+                zone = p[i].AltZone();
+                northp = p[i].Northp();
+                sethemisphere = true;
+                latch = false;
+              }
+            }
+            catch (const std::exception&) {
+              ok = false;
+            }
+          }
+          if (!ok) {
+            std::fill(v, v + nout, Math::NaN());
+            retval = 1;
+            ++nerr;
+          }
+          lap.Mark(ToolStats::COMPUTE);
+          Utility::writearray<double, real, false>(*output, v, nout);
+          lap.Mark(ToolStats::IO);
         }
-        p.Reset(s, centerp, longfirst);
-        p.SetAltZone(zone);
-        switch (outputmode) {
-        case GEOGRAPHIC:
-          os = p.GeoRepresentation(prec, longfirst);
-          break;
-        case DMS:
-          os = p.DMSRepresentation(prec, longfirst, dmssep);
-          break;
-        case UTMUPS:
-          os = (sethemisphere
-                ? p.AltUTMUPSRepresentation(northp, prec, abbrev)
-                : p.AltUTMUPSRepresentation(prec, abbrev));
-          break;
-        case MGRS:
-          os = p.AltMGRSRepresentation(prec);
-          break;
-        case CONVERGENCE:
-          {
-            real
-              gamma = p.AltConvergence(),
-              k = p.AltScale();
-            int prec1 = std::max(-5, std::min(Math::extra_digits() + 8, prec));
-            os = Utility::str(gamma, prec1 + 5) + " "
-              + Utility::str(k, prec1 + 7);
+        tstats.Lines(n, nerr);
+      }
+      tstats.Report("GeoConvert", 1, err);
+      return retval;
+    }
+
+    // With -S or -T, the zone of the first line fixes the zone of the rest,
+    // so the lines must be processed in order.
+    if (latch) nthreads = 1;
+    // Process a batch of lines of input; with -j, this is called
+    // concurrently on several threads.  The lines are parsed, the UTM/UPS
+    // coordinates are computed together with GeoCoords::SetAltZoneBatch,
+    // and the results are formatted.
+    auto process = [&](std::string s[], size_t n, std::ostream& os) -> int {
+      std::vector<GeoCoords> p(n);
+      std::vector<std::string> eol(n, "\n"), res(n);
+      std::vector<int> r(n, 0);
+      char buf[bufsize];
+      ToolStats::Lap lap(tstats);
+      for (size_t i = 0; i < n; ++i) {
+        try {
+          if (!cdelim.empty()) {
+            std::string::size_type m = s[i].find(cdelim);
+            if (m != std::string::npos) {
+              eol[i] = " " + s[i].substr(m) + "\n";
+              s[i] = s[i].substr(0, m);
+            }
           }
+          p[i].Reset(s[i].data(), s[i].size(), centerp, longfirst);
         }
-        if (latch &&
-            zone < UTMUPS::MINZONE && p.AltZone() >= UTMUPS::MINZONE) {
-          zone = p.AltZone();
-          northp = p.Northp();
-          sethemisphere = true;
-          latch = false;
+        catch (const std::exception& e) {
+          // Write error message to cout so output lines match input lines
+          res[i] = std::string("ERROR: ") + e.what();
+          r[i] = 1;
+          p[i] = GeoCoords();
         }
       }
-      catch (const std::exception& e) {
-        // Write error message to cout so output lines match input lines
-        os = std::string("ERROR: ") + e.what();
-        retval = 1;
+      lap.Mark(ToolStats::PARSE);
+      if (projectp && !latch)
+        GeoCoords::SetAltZoneBatch(n, p.data(), zone);
+      lap.Mark(ToolStats::COMPUTE);
+      int retval = 0;
+      size_t nerr = 0;
+      for (size_t i = 0; i < n; ++i) {
+        if (!r[i]) {
+          try {
+            p[i].SetAltZone(zone);
+            switch (outputmode) {
+            case GEOGRAPHIC:
+              // Format into buf and assign to res to avoid heap allocations
+              res[i].assign(buf, p[i].GeoRepresentation(prec, longfirst,
+                                                        buf, bufsize));
+              break;
+            case DMS:
+              res[i].assign(buf, p[i].DMSRepresentation(prec, longfirst,
+                                                        dmssep,
+                                                        buf, bufsize));
+              break;
+            case UTMUPS:
+              res[i].assign(buf, sethemisphere
+                            ? p[i].AltUTMUPSRepresentation(northp, prec,
+                                                           abbrev,
+                                                           buf, bufsize)
+                            : p[i].AltUTMUPSRepresentation(prec, abbrev,
+                                                           buf, bufsize));
+              break;
+            case MGRS:
+              res[i].assign(buf, p[i].AltMGRSRepresentation(prec,
+                                                            buf, bufsize));
+              break;
+            case CONVERGENCE:
+              {
+                real
+                  gamma = p[i].AltConvergence(),
+                  k = p[i].AltScale();
+                int prec1 = std::max(-5, std::min(Math::extra_digits() + 8,
+                                                  prec));
+                size_t m = Utility::str(gamma, prec1 + 5, buf, bufsize);
+                buf[m++] = ' ';
+                m += Utility::str(k, prec1 + 7, buf + m, bufsize - m);
+                res[i].assign(buf, m);
+              }
+            }
+            if (latch &&
+                zone < UTMUPS::MINZONE && p[i].AltZone() >= UTMUPS::MINZONE) {
+              zone = p[i].AltZone();
+              northp = p[i].Northp();
+              sethemisphere = true;
+              latch = false;
+            }
+          }
+          catch (const std::exception& e) {
+            res[i] = std::string("ERROR: ") + e.what();
+            r[i] = 1;
+          }
+        }
+        os << res[i] << eol[i];
+        retval |= r[i];
+        nerr += r[i];
       }
-      *output << os << eol;
-    }
+      lap.Mark(ToolStats::FORMAT);
+      tstats.Lines(n, nerr);
+      return retval;
+    };
+    int retval = ToolPipeline::ProcessBatches(*input, *output, nthreads,
+                                              nbatch, process);
+    tstats.Report("GeoConvert",
+                  nthreads ? nthreads : GeodesicBatchExecutor::Concurrency(),
+                  err);
     return retval;
   }
   catch (const std::exception& e) {
-    std::cerr << "Caught exception: " << e.what() << "\n";
+    err << "Caught exception: " << e.what() << "\n";
     return 1;
   }
   catch (...) {
-    std::cerr << "Caught unknown exception\n";
+    err << "Caught unknown exception\n";
     return 1;
   }
 }
+
+int main(int argc, const char* const argv[]) {
+  return ToolServer::Main(argc, argv, run);
+}
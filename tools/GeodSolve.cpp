@@ -13,7 +13,13 @@
 #include <string>
 #include <sstream>
 #include <fstream>
+#include <vector>
+#include <future>
+#include <algorithm>
+#include <cstdlib>
+#include <cctype>
 #include <GeographicLib/Geodesic.hpp>
+#include <GeographicLib/GeodesicBatchExecutor.hpp>
 #include <GeographicLib/GeodesicLine.hpp>
 #include <GeographicLib/GeodesicExact.hpp>
 #include <GeographicLib/GeodesicLineExact.hpp>
@@ -27,38 +33,75 @@
 #endif
 
 #include "GeodSolve.usage"
+#include "ToolPipeline.hpp"
+#include "ToolServer.hpp"
+#include "ToolStats.hpp"
 
 typedef GeographicLib::Math::real real;
 
-std::string LatLonString(real lat, real lon, int prec, bool dms, char dmssep,
-                         bool longfirst) {
+// Append x in fixed format with p digits after the decimal point to s.  This
+// is the same as s += Utility::str(x, p), but avoids the allocations of a
+// stringstream.
+void AppendFixed(std::string& s, real x, int p) {
+  using std::fabs;
+  // The buffer is big enough unless x is huge (or a NaN)
+  if (fabs(x) < real(1e20) && p < 32) {
+    char buf[64];
+    s.append(buf, GeographicLib::Utility::str(x, p, buf, sizeof(buf)));
+  } else
+    s += GeographicLib::Utility::str(x, p);
+}
+
+// Append DMS::Encode(angle, prec, ind, dmssep) to s without allocations.
+void AppendDMS(std::string& s, real angle, unsigned prec,
+               GeographicLib::DMS::flag ind, char dmssep = '\0') {
   using namespace GeographicLib;
-  std::string
-    latstr = dms ? DMS::Encode(lat, prec + 5, DMS::LATITUDE, dmssep) :
-    DMS::Encode(lat, prec + 5, DMS::NUMBER),
-    lonstr = dms ? DMS::Encode(lon, prec + 5, DMS::LONGITUDE, dmssep) :
-    DMS::Encode(lon, prec + 5, DMS::NUMBER);
-  return
-    (longfirst ? lonstr : latstr) + " " + (longfirst ? latstr : lonstr);
+  using std::fabs;
+  if (fabs(angle) < real(1e6)) {
+    char buf[128];
+    s.append(buf, DMS::Encode(angle, prec, ind, dmssep, buf, sizeof(buf)));
+  } else
+    s += DMS::Encode(angle, prec, ind, dmssep);
 }
 
-std::string AzimuthString(real azi, int prec, bool dms, char dmssep) {
+void AppendLatLon(std::string& s, real lat, real lon, int prec,
+                  bool dms, char dmssep, bool longfirst) {
   using namespace GeographicLib;
-  return dms ? DMS::Encode(azi, prec + 5, DMS::AZIMUTH, dmssep) :
-    DMS::Encode(azi, prec + 5, DMS::NUMBER);
+  if (dms) {
+    AppendDMS(s, longfirst ? lon : lat, prec + 5,
+              longfirst ? DMS::LONGITUDE : DMS::LATITUDE, dmssep);
+    s += ' ';
+    AppendDMS(s, longfirst ? lat : lon, prec + 5,
+              longfirst ? DMS::LATITUDE : DMS::LONGITUDE, dmssep);
+  } else {
+    AppendFixed(s, longfirst ? lon : lat, prec + 5);
+    s += ' ';
+    AppendFixed(s, longfirst ? lat : lon, prec + 5);
+  }
 }
 
-std::string DistanceStrings(real s12, real a12,
-                            bool full, bool arcmode, int prec, bool dms) {
+void AppendAzimuth(std::string& s, real azi, int prec, bool dms,
+                   char dmssep) {
+  using namespace GeographicLib;
+  if (dms)
+    AppendDMS(s, azi, prec + 5, DMS::AZIMUTH, dmssep);
+  else
+    AppendFixed(s, azi, prec + 5);
+}
+
+void AppendDistances(std::string& s, real s12, real a12,
+                     bool full, bool arcmode, int prec, bool dms) {
   using namespace GeographicLib;
-  std::string s;
   if (full || !arcmode)
-    s += Utility::str(s12, prec);
+    AppendFixed(s, s12, prec);
   if (full)
-    s += " ";
-  if (full || arcmode)
-    s += DMS::Encode(a12, prec + 5, dms ? DMS::NONE : DMS::NUMBER);
-  return s;
+    s += ' ';
+  if (full || arcmode) {
+    if (dms)
+      AppendDMS(s, a12, prec + 5, DMS::NONE);
+    else
+      AppendFixed(s, a12, prec + 5);
+  }
 }
 
 real ReadDistance(const std::string& s, bool arcmode, bool fraction = false) {
@@ -67,7 +110,85 @@ real ReadDistance(const std::string& s, bool arcmode, bool fraction = false) {
     (arcmode ? DMS::DecodeAngle(s) : Utility::val<real>(s));
 }
 
-int main(int argc, const char* const argv[]) {
+bool IsSpace(char c) {
+  return std::isspace(static_cast<unsigned char>(c)) != 0;
+}
+
+// Read a plain decimal number (an optional sign, digits, and an optional
+// decimal point) from [p, end) skipping leading white space and advance p
+// past it.  Return false if the next token is not of this form; the caller
+// should then fall back to the general parsers.  For such tokens, strtod
+// gives the same result as DMS::Decode and Utility::val (integers are
+// limited to 15 digits since DMS::Decode accumulates them digit by digit).
+// Only doubles are handled.
+bool FastNumber(const char*& p, const char* end, real& x) {
+#if GEOGRAPHICLIB_PRECISION == 2
+  while (p < end && IsSpace(*p)) ++p;
+  const char* q = p;
+  if (q < end && (*q == '+' || *q == '-')) ++q;
+  int ndigits = 0;
+  bool pointseen = false;
+  for (; q < end && !IsSpace(*q); ++q) {
+    if (*q >= '0' && *q <= '9')
+      ++ndigits;
+    else if (*q == '.' && !pointseen)
+      pointseen = true;
+    else
+      return false;
+  }
+  if (ndigits == 0 || (!pointseen && ndigits > 15))
+    return false;
+  char* r;
+  x = std::strtod(p, &r);
+  if (r != q)
+    return false;
+  p = q;
+  return true;
+#else
+  (void)p; (void)end; (void)x;
+  return false;
+#endif
+}
+
+// A block of complete input lines; line i is data[i ? eol[i-1] + 1 : 0,
+// eol[i]).
+struct LineBlock {
+  std::string data;
+  std::vector<size_t> eol;
+};
+
+// Read a block of about nbytes bytes of input into blk, holding back the
+// incomplete last line in rest to start the next block.  Return false at
+// the end of the input.
+bool ReadBlock(std::istream& in, size_t nbytes, std::string& rest,
+               LineBlock& blk) {
+  blk.data.swap(rest);
+  rest.clear();
+  blk.eol.clear();
+  while (in) {
+    size_t k = blk.data.size();
+    blk.data.resize(k + nbytes);
+    in.read(&blk.data[k], std::streamsize(nbytes));
+    blk.data.resize(k + size_t(in.gcount()));
+    if (blk.data.find('\n', k) != std::string::npos)
+      break;
+  }
+  size_t n = blk.data.size();
+  if (in) {
+    // More input to come; the newline is present because of the break
+    n = blk.data.rfind('\n') + 1;
+    rest.assign(blk.data, n, std::string::npos);
+    blk.data.resize(n);
+  }
+  for (size_t i = 0; i < n; ++i)
+    if (blk.data[i] == '\n') blk.eol.push_back(i);
+  // Like getline, treat a final unterminated line as a line
+  if (n && blk.data[n - 1] != '\n') blk.eol.push_back(n);
+  return !blk.eol.empty();
+}
+
+int run(int argc, const char* const argv[],
+        std::istream& in, std::ostream& out, std::ostream& err) {
   try {
     using namespace GeographicLib;
     enum { NONE = 0, LINE, DIRECT, INVERSE };
@@ -75,13 +196,14 @@ int main(int argc, const char* const argv[]) {
     bool inverse = false, arcmode = false,
       dms = false, full = false, exact = false, unroll = false,
       longfirst = false, azi2back = false, fraction = false,
-      arcmodeline = false;
+      arcmodeline = false, fast = false, binary = false, stats = false;
     real
       a = Constants::WGS84_a(),
       f = Constants::WGS84_f();
-    real lat1, lon1, azi1, lat2, lon2, azi2, s12, m12, a12, M12, M21, S12,
+    real lat1 = 0, lon1 = 0, azi1 = 0, lat2 = 0, lon2 = 0, s12 = 0,
       mult = 1;
     int linecalc = NONE, prec = 3;
+    unsigned nthreads = 1;
     std::string istring, ifile, ofile, cdelim;
     char lsep = ';', dmssep = char(0);
 
@@ -97,21 +219,21 @@ int main(int argc, const char* const argv[]) {
       else if (arg == "-L" || arg == "-l") { // -l is DEPRECATED
         inverse = false;
         linecalc = LINE;
-        if (m + 3 >= argc) return usage(1, true);
+        if (m + 3 >= argc) return usage(1, true, out, err);
         try {
           DMS::DecodeLatLon(std::string(argv[m + 1]), std::string(argv[m + 2]),
                             lat1, lon1, longfirst);
           azi1 = DMS::DecodeAzimuth(std::string(argv[m + 3]));
         }
         catch (const std::exception& e) {
-          std::cerr << "Error decoding arguments of -L: " << e.what() << "\n";
+          err << "Error decoding arguments of -L: " << e.what() << "\n";
           return 1;
         }
         m += 3;
       } else if (arg == "-D") {
         inverse = false;
         linecalc = DIRECT;
-        if (m + 4 >= argc) return usage(1, true);
+        if (m + 4 >= argc) return usage(1, true, out, err);
         try {
           DMS::DecodeLatLon(std::string(argv[m + 1]), std::string(argv[m + 2]),
                             lat1, lon1, longfirst);
@@ -120,14 +242,14 @@ int main(int argc, const char* const argv[]) {
           arcmodeline = arcmode;
         }
         catch (const std::exception& e) {
-          std::cerr << "Error decoding arguments of -D: " << e.what() << "\n";
+          err << "Error decoding arguments of -D: " << e.what() << "\n";
           return 1;
         }
         m += 4;
       } else if (arg == "-I") {
         inverse = false;
         linecalc = INVERSE;
-        if (m + 4 >= argc) return usage(1, true);
+        if (m + 4 >= argc) return usage(1, true, out, err);
         try {
           DMS::DecodeLatLon(std::string(argv[m + 1]), std::string(argv[m + 2]),
                             lat1, lon1, longfirst);
@@ -135,18 +257,18 @@ int main(int argc, const char* const argv[]) {
                             lat2, lon2, longfirst);
         }
         catch (const std::exception& e) {
-          std::cerr << "Error decoding arguments of -I: " << e.what() << "\n";
+          err << "Error decoding arguments of -I: " << e.what() << "\n";
           return 1;
         }
         m += 4;
       } else if (arg == "-e") {
-        if (m + 2 >= argc) return usage(1, true);
+        if (m + 2 >= argc) return usage(1, true, out, err);
         try {
           a = Utility::val<real>(std::string(argv[m + 1]));
           f = Utility::fract<real>(std::string(argv[m + 2]));
         }
         catch (const std::exception& e) {
-          std::cerr << "Error decoding arguments of -e: " << e.what() << "\n";
+          err << "Error decoding arguments of -e: " << e.what() << "\n";
           return 1;
         }
         m += 2;
@@ -165,54 +287,70 @@ int main(int argc, const char* const argv[]) {
       else if (arg == "-f")
         full = true;
       else if (arg == "-p") {
-        if (++m == argc) return usage(1, true);
+        if (++m == argc) return usage(1, true, out, err);
         try {
           prec = Utility::val<int>(std::string(argv[m]));
         }
         catch (const std::exception&) {
-          std::cerr << "Precision " << argv[m] << " is not a number\n";
+          err << "Precision " << argv[m] << " is not a number\n";
           return 1;
         }
       } else if (arg == "-E")
         exact = true;
+      else if (arg == "-j" || arg == "--threads") {
+        if (++m == argc) return usage(1, true, out, err);
+        if (!ToolPipeline::Threads(argv[m], nthreads, err))
+          return 1;
+      }
+      else if (arg == "--fast")
+        fast = true;
+      else if (arg == "--binary")
+        binary = true;
+      else if (arg == "--stats")
+        stats = true;
       else if (arg == "--input-string") {
-        if (++m == argc) return usage(1, true);
+        if (++m == argc) return usage(1, true, out, err);
         istring = argv[m];
       } else if (arg == "--input-file") {
-        if (++m == argc) return usage(1, true);
+        if (++m == argc) return usage(1, true, out, err);
         ifile = argv[m];
       } else if (arg == "--output-file") {
-        if (++m == argc) return usage(1, true);
+        if (++m == argc) return usage(1, true, out, err);
         ofile = argv[m];
       } else if (arg == "--line-separator") {
-        if (++m == argc) return usage(1, true);
+        if (++m == argc) return usage(1, true, out, err);
         if (std::string(argv[m]).size() != 1) {
-          std::cerr << "Line separator must be a single character\n";
+          err << "Line separator must be a single character\n";
           return 1;
         }
         lsep = argv[m][0];
       } else if (arg == "--comment-delimiter") {
-        if (++m == argc) return usage(1, true);
+        if (++m == argc) return usage(1, true, out, err);
         cdelim = argv[m];
       } else if (arg == "--version") {
-        std::cout << argv[0] << ": GeographicLib version "
+        out << argv[0] << ": GeographicLib version "
                   << GEOGRAPHICLIB_VERSION_STRING << "\n";
         return 0;
       } else
-        return usage(!(arg == "-h" || arg == "--help"), arg != "--help");
+        return usage(!(arg == "-h" || arg == "--help"),
+                     arg != "--help", out, err);
     }
 
     if (!ifile.empty() && !istring.empty()) {
-      std::cerr << "Cannot specify --input-string and --input-file together\n";
+      err << "Cannot specify --input-string and --input-file together\n";
+      return 1;
+    }
+    if (binary && !istring.empty()) {
+      err << "Cannot specify --input-string and --binary together\n";
       return 1;
     }
     if (ifile == "-") ifile.clear();
     std::ifstream infile;
     std::istringstream instring;
     if (!ifile.empty()) {
-      infile.open(ifile.c_str());
+      infile.open(ifile.c_str(), binary ? std::ios::binary : std::ios::in);
       if (!infile.is_open()) {
-        std::cerr << "Cannot open " << ifile << " for reading\n";
+        err << "Cannot open " << ifile << " for reading\n";
         return 1;
       }
     } else if (!istring.empty()) {
@@ -226,18 +364,18 @@ int main(int argc, const char* const argv[]) {
       instring.str(istring);
     }
     std::istream* input = !ifile.empty() ? &infile :
-      (!istring.empty() ? &instring : &std::cin);
+      (!istring.empty() ? &instring : &in);
 
     std::ofstream outfile;
     if (ofile == "-") ofile.clear();
     if (!ofile.empty()) {
-      outfile.open(ofile.c_str());
+      outfile.open(ofile.c_str(), binary ? std::ios::binary : std::ios::out);
       if (!outfile.is_open()) {
-        std::cerr << "Cannot open " << ofile << " for writing\n";
+        err << "Cannot open " << ofile << " for writing\n";
         return 1;
       }
     }
-    std::ostream* output = !ofile.empty() ? &outfile : &std::cout;
+    std::ostream* output = !ofile.empty() ? &outfile : &out;
 
     // GeodesicExact mask values are the same as Geodesic
     unsigned outmask = Geodesic::LATITUDE | Geodesic::LONGITUDE |
@@ -253,6 +391,9 @@ int main(int argc, const char* const argv[]) {
 
     const Geodesic      geods(a, f);
     const GeodesicExact geode(a, f);
+    // The statistics for --stats; the phases of the calculations are timed
+    // with ToolStats::Lap.
+    ToolStats::Stats tstats(stats);
     GeodesicLine      ls;
     GeodesicLineExact le;
     if (linecalc) {
@@ -281,10 +422,135 @@ int main(int argc, const char* const argv[]) {
     // Max precision = 10: 0.1 nm in distance, 10^-15 deg (= 0.11 nm),
     // 10^-11 sec (= 0.3 nm).
     prec = std::min(10 + Math::extra_digits(), std::max(0, prec));
-    std::string s, eol, slat1, slon1, slat2, slon2, sazi1, ss12, strc;
-    std::istringstream str;
-    int retval = 0;
-    while (std::getline(*input, s)) {
+    // The geodesic line parameters (not altered by process)
+    const real lat1l = lat1, lon1l = lon1, azi1l = azi1;
+    // Solve one problem given the decoded input and set v to lat1, lon1,
+    // azi1, lat2, lon2, azi2, s12, a12, m12, M12, M21, S12 (the full
+    // output).  lat1, lon1, azi1 are the starting point for direct problems;
+    // lat1, lon1, lat2, lon2 are the end points for inverse problems; s12 is
+    // the distance (or arc length) for direct problems.  This only reads
+    // shared state so, with -j, it's called concurrently on several threads.
+    auto solve = [&](real lat1, real lon1, real azi1,
+                     real lat2, real lon2, real s12, real v[]) -> void {
+      real azi2, m12, a12, M12, M21, S12;
+      if (inverse) {
+        a12 = exact ?
+          geode.GenInverse(lat1, lon1, lat2, lon2, outmask,
+                           s12, azi1, azi2, m12, M12, M21, S12) :
+          geods.GenInverse(lat1, lon1, lat2, lon2, outmask,
+                           s12, azi1, azi2, m12, M12, M21, S12);
+        if (unroll) {
+          real e;
+          lon2 = lon1 + Math::AngDiff(lon1, lon2, e);
+          lon2 += e;
+        } else {
+          lon1 = Math::AngNormalize(lon1);
+          lon2 = Math::AngNormalize(lon2);
+        }
+      } else {
+        if (linecalc)
+          a12 = exact ?
+            le.GenPosition(arcmode, s12, outmask,
+                           lat2, lon2, azi2, s12, m12, M12, M21, S12) :
+            ls.GenPosition(arcmode, s12, outmask,
+                           lat2, lon2, azi2, s12, m12, M12, M21, S12);
+        else
+          a12 = exact ?
+            geode.GenDirect(lat1, lon1, azi1, arcmode, s12, outmask,
+                            lat2, lon2, azi2, s12, m12, M12, M21, S12) :
+            geods.GenDirect(lat1, lon1, azi1, arcmode, s12, outmask,
+                            lat2, lon2, azi2, s12, m12, M12, M21, S12);
+        if (!unroll) lon1 = Math::AngNormalize(lon1);
+      }
+      if (azi2back) {
+        using std::copysign;
+        // map +/-0 -> -/+180; +/-180 -> -/+0
+        // this depends on abs(azi2) <= 180
+        azi2 = copysign(azi2 + copysign(real(Math::hd), -azi2), -azi2);
+      }
+      v[0] = lat1; v[1] = lon1; v[2] = azi1;
+      v[3] = lat2; v[4] = lon2; v[5] = azi2;
+      v[6] = s12; v[7] = a12; v[8] = m12;
+      v[9] = M12; v[10] = M21; v[11] = S12;
+    };
+    // Append the results of solve (without the end of line) to out.
+    auto format = [&](const real v[], std::string& out) -> void {
+      if (full) {
+        AppendLatLon(out, v[0], v[1], prec, dms, dmssep, longfirst);
+        out += ' ';
+        AppendAzimuth(out, v[2], prec, dms, dmssep);
+        out += ' ';
+        AppendLatLon(out, v[3], v[4], prec, dms, dmssep, longfirst);
+        out += ' ';
+        AppendAzimuth(out, v[5], prec, dms, dmssep);
+        out += ' ';
+        AppendDistances(out, v[6], v[7], full, arcmode, prec, dms);
+        out += ' '; AppendFixed(out, v[8], prec);
+        out += ' '; AppendFixed(out, v[9], prec+7);
+        out += ' '; AppendFixed(out, v[10], prec+7);
+        out += ' '; AppendFixed(out, v[11], std::max(prec-7, 0));
+      } else if (inverse) {
+        AppendAzimuth(out, v[2], prec, dms, dmssep);
+        out += ' ';
+        AppendAzimuth(out, v[5], prec, dms, dmssep);
+        out += ' ';
+        AppendDistances(out, v[6], v[7], full, arcmode, prec, dms);
+      } else {
+        AppendLatLon(out, v[3], v[4], prec, dms, dmssep, longfirst);
+        out += ' ';
+        AppendAzimuth(out, v[5], prec, dms, dmssep);
+      }
+    };
+    // Select the fields of the results of solve for the binary output
+    // record b (the same quantities as the text output); return the number
+    // of fields.
+    auto select = [&](const real v[], real b[]) -> int {
+      if (full) {
+        for (int i = 0; i < 12; ++i) b[i] = v[i];
+        if (longfirst) {
+          std::swap(b[0], b[1]);
+          std::swap(b[3], b[4]);
+        }
+        return 12;
+      } else if (inverse) {
+        b[0] = v[2]; b[1] = v[5]; b[2] = arcmode ? v[7] : v[6];
+        return 3;
+      } else {
+        b[0] = v[longfirst ? 4 : 3]; b[1] = v[longfirst ? 3 : 4];
+        b[2] = v[5];
+        return 3;
+      }
+    };
+    // Set the input for solve from the numbers in x (1 number for -L, -D,
+    // -I, otherwise 4).  Return false if a latitude is out of range.
+    auto decode = [&](const real x[], real& lat1, real& lon1, real& azi1,
+                      real& lat2, real& lon2, real& s12) -> bool {
+      if (linecalc) {
+        s12 = x[0] * mult;
+        return true;
+      }
+      lat1 = longfirst ? x[1] : x[0];
+      lon1 = longfirst ? x[0] : x[1];
+      if (inverse) {
+        lat2 = longfirst ? x[3] : x[2];
+        lon2 = longfirst ? x[2] : x[3];
+      } else {
+        azi1 = Math::AngNormalize(x[2]);
+        s12 = x[3];
+      }
+      using std::fabs;
+      return !(fabs(lat1) > Math::qd ||
+               (inverse && fabs(lat2) > Math::qd));
+    };
+    // Process one line of input appending the result to out.  This returns
+    // 1 if there's an error.
+    auto process = [&](std::string s, std::string& out) -> int {
+      real lat1 = lat1l, lon1 = lon1l, azi1 = azi1l,
+        lat2 = 0, lon2 = 0, s12 = 0;
+      std::string eol, slat1, slon1, slat2, slon2, sazi1, ss12, strc;
+      std::istringstream str;
+      size_t n0 = out.size();
+      ToolStats::Lap lap(tstats);
       try {
         eol = "\n";
         if (!cdelim.empty()) {
@@ -302,105 +568,186 @@ int main(int argc, const char* const argv[]) {
             throw GeographicErr("Extraneous input: " + strc);
           DMS::DecodeLatLon(slat1, slon1, lat1, lon1, longfirst);
           DMS::DecodeLatLon(slat2, slon2, lat2, lon2, longfirst);
-          a12 = exact ?
-            geode.GenInverse(lat1, lon1, lat2, lon2, outmask,
-                             s12, azi1, azi2, m12, M12, M21, S12) :
-            geods.GenInverse(lat1, lon1, lat2, lon2, outmask,
-                             s12, azi1, azi2, m12, M12, M21, S12);
-          if (full) {
-            if (unroll) {
-              real e;
-              lon2 = lon1 + Math::AngDiff(lon1, lon2, e);
-              lon2 += e;
-            } else {
-              lon1 = Math::AngNormalize(lon1);
-              lon2 = Math::AngNormalize(lon2);
-            }
-            *output << LatLonString(lat1, lon1, prec, dms, dmssep, longfirst)
-                    << " ";
-          }
-          *output << AzimuthString(azi1, prec, dms, dmssep) << " ";
-          if (full)
-            *output << LatLonString(lat2, lon2, prec, dms, dmssep, longfirst)
-                    << " ";
-          if (azi2back) {
-            using std::copysign;
-            // map +/-0 -> -/+180; +/-180 -> -/+0
-            // this depends on abs(azi2) <= 180
-            azi2 = copysign(azi2 + copysign(real(Math::hd), -azi2), -azi2);
-          }
-          *output << AzimuthString(azi2, prec, dms, dmssep) << " "
-                  << DistanceStrings(s12, a12, full, arcmode, prec, dms);
-          if (full)
-            *output << " " << Utility::str(m12, prec)
-                    << " " << Utility::str(M12, prec+7)
-                    << " " << Utility::str(M21, prec+7)
-                    << " " << Utility::str(S12, std::max(prec-7, 0));
-          *output << eol;
+        } else if (linecalc) {
+          if (!(str >> ss12))
+            throw GeographicErr("Incomplete input: " + s);
+          if (str >> strc)
+            throw GeographicErr("Extraneous input: " + strc);
+          // In fraction mode input is read as a distance
+          s12 = ReadDistance(ss12, !fraction && arcmode, fraction) * mult;
         } else {
-          if (linecalc) {
-            if (!(str >> ss12))
-              throw GeographicErr("Incomplete input: " + s);
-            if (str >> strc)
-              throw GeographicErr("Extraneous input: " + strc);
-            // In fraction mode input is read as a distance
-            s12 = ReadDistance(ss12, !fraction && arcmode, fraction) * mult;
-            a12 = exact ?
-              le.GenPosition(arcmode, s12, outmask,
-                             lat2, lon2, azi2, s12, m12, M12, M21, S12) :
-              ls.GenPosition(arcmode, s12, outmask,
-                             lat2, lon2, azi2, s12, m12, M12, M21, S12);
-          } else {
-            if (!(str >> slat1 >> slon1 >> sazi1 >> ss12))
-              throw GeographicErr("Incomplete input: " + s);
-            if (str >> strc)
-              throw GeographicErr("Extraneous input: " + strc);
-            DMS::DecodeLatLon(slat1, slon1, lat1, lon1, longfirst);
-            azi1 = DMS::DecodeAzimuth(sazi1);
-            s12 = ReadDistance(ss12, arcmode);
-            a12 = exact ?
-              geode.GenDirect(lat1, lon1, azi1, arcmode, s12, outmask,
-                              lat2, lon2, azi2, s12, m12, M12, M21, S12) :
-              geods.GenDirect(lat1, lon1, azi1, arcmode, s12, outmask,
-                              lat2, lon2, azi2, s12, m12, M12, M21, S12);
-          }
-          if (full)
-            *output
-              << LatLonString(lat1, unroll ? lon1 : Math::AngNormalize(lon1),
-                              prec, dms, dmssep, longfirst)
-              << " " << AzimuthString(azi1, prec, dms, dmssep) << " ";
-          if (azi2back) {
-            using std::copysign;
-            // map +/-0 -> -/+180; +/-180 -> -/+0
-            // this depends on abs(azi2) <= 180
-            azi2 = copysign(azi2 + copysign(real(Math::hd), -azi2), -azi2);
-          }
-          *output << LatLonString(lat2, lon2, prec, dms, dmssep, longfirst)
-                  << " " << AzimuthString(azi2, prec, dms, dmssep);
-          if (full)
-            *output << " "
-                    << DistanceStrings(s12, a12, full, arcmode, prec, dms)
-                    << " " << Utility::str(m12, prec)
-                    << " " << Utility::str(M12, prec+7)
-                    << " " << Utility::str(M21, prec+7)
-                    << " " << Utility::str(S12, std::max(prec-7, 0));
-          *output << eol;
+          if (!(str >> slat1 >> slon1 >> sazi1 >> ss12))
+            throw GeographicErr("Incomplete input: " + s);
+          if (str >> strc)
+            throw GeographicErr("Extraneous input: " + strc);
+          DMS::DecodeLatLon(slat1, slon1, lat1, lon1, longfirst);
+          azi1 = DMS::DecodeAzimuth(sazi1);
+          s12 = ReadDistance(ss12, arcmode);
         }
+        real v[12];
+        lap.Mark(ToolStats::PARSE);
+        solve(lat1, lon1, azi1, lat2, lon2, s12, v);
+        lap.Mark(ToolStats::COMPUTE);
+        format(v, out);
+        out += eol;
+        lap.Mark(ToolStats::FORMAT);
       }
       catch (const std::exception& e) {
         // Write error message cout so output lines match input lines
-        *output << "ERROR: " << e.what() << "\n";
-        retval = 1;
+        out.resize(n0);
+        out += "ERROR: ";
+        out += e.what();
+        out += '\n';
+        return 1;
+      }
+      return 0;
+    };
+    // The same as process for the line [b, e), but numbers in plain
+    // decimal format are decoded without allocating temporary strings.  Any
+    // other input is passed on to process.
+    auto fastprocess = [&](const char* b, const char* e,
+                           std::string& out) -> int {
+      ToolStats::Lap lap(tstats);
+      bool ok = cdelim.empty() ||
+        std::search(b, e, cdelim.begin(), cdelim.end()) == e;
+      real x[4];
+      int nx = linecalc ? 1 : 4;
+      const char* p = b;
+      for (int i = 0; ok && i < nx; ++i)
+        ok = FastNumber(p, e, x[i]);
+      if (ok) {
+        while (p < e && IsSpace(*p)) ++p;
+        ok = p == e;
+      }
+      real lat1 = lat1l, lon1 = lon1l, azi1 = azi1l,
+        lat2 = 0, lon2 = 0, s12 = 0, v[12];
+      if (!(ok && decode(x, lat1, lon1, azi1, lat2, lon2, s12)))
+        return process(std::string(b, e), out);
+      lap.Mark(ToolStats::PARSE);
+      solve(lat1, lon1, azi1, lat2, lon2, s12, v);
+      lap.Mark(ToolStats::COMPUTE);
+      format(v, out);
+      out += '\n';
+      lap.Mark(ToolStats::FORMAT);
+      return 0;
+    };
+
+    int retval = 0;
+    if (binary) {
+      // Binary records of little-endian doubles; an error gives a record of
+      // NaNs.
+      const int nin = linecalc ? 1 : 4;
+      real x[4], v[12], b[12];
+      ToolStats::Lap lap(tstats);
+      while (input->peek() != std::char_traits<char>::eof()) {
+        Utility::readarray<double, real, false>(*input, x, nin);
+        lap.Mark(ToolStats::IO);
+        real lat1 = lat1l, lon1 = lon1l, azi1 = azi1l,
+          lat2 = 0, lon2 = 0, s12 = 0;
+        bool ok = decode(x, lat1, lon1, azi1, lat2, lon2, s12);
+        lap.Mark(ToolStats::PARSE);
+        if (ok)
+          solve(lat1, lon1, azi1, lat2, lon2, s12, v);
+        else {
+          std::fill(v, v + 12, Math::NaN());
+          retval = 1;
+        }
+        lap.Mark(ToolStats::COMPUTE);
+        tstats.Lines(1, ok ? 0 : 1);
+        Utility::writearray<double, real, false>(*output, b, select(v, b));
+        lap.Mark(ToolStats::IO);
       }
+    } else if (fast) {
+      // Pipeline the processing: read and split the input into blocks on
+      // one thread, process a block with exec, and write out the previous
+      // block on another thread.
+      GeodesicBatchExecutor exec(nthreads);
+      const size_t nbytes = size_t(1) << 22;
+      LineBlock blk[2];
+      std::vector<std::string> results[2];
+      std::vector<int> errors;
+      std::string rest;
+      auto read = [&](LineBlock& b) -> bool {
+        return ReadBlock(*input, nbytes, rest, b);
+      };
+      auto write = [&](const std::vector<std::string>& r, size_t n) -> void {
+        for (size_t i = 0; i < n; ++i)
+          output->write(r[i].data(), std::streamsize(r[i].size()));
+      };
+      std::future<bool> reader =
+        std::async(std::launch::async, read, std::ref(blk[0]));
+      std::future<void> writer;
+      // With --stats, the time waiting for the reader and the writer is
+      // charged to i/o.
+      auto wait = [&tstats](std::future<bool>& f) -> bool {
+        ToolStats::Lap lap(tstats);
+        bool r = f.get();
+        lap.Mark(ToolStats::IO);
+        return r;
+      };
+      for (int k = 0; wait(reader); k = 1 - k) {
+        const LineBlock& b = blk[k];
+        std::vector<std::string>& r = results[k];
+        reader = std::async(std::launch::async, read, std::ref(blk[1 - k]));
+        size_t n = b.eol.size();
+        if (r.size() < n) r.resize(n);
+        errors.resize(n);
+        exec.ForEach(n, [&](size_t i0, size_t i1) -> void {
+          const char* d = b.data.data();
+          for (size_t i = i0; i < i1; ++i) {
+            r[i].clear();
+            errors[i] = fastprocess(d + (i ? b.eol[i - 1] + 1 : 0),
+                                    d + b.eol[i], r[i]);
+          }
+        });
+        size_t nerr = 0;
+        for (size_t i = 0; i < n; ++i)
+          nerr += errors[i];
+        retval |= nerr ? 1 : 0;
+        tstats.Lines(n, nerr);
+        ToolStats::Lap lap(tstats);
+        if (writer.valid()) writer.get();
+        lap.Mark(ToolStats::IO);
+        writer = std::async(std::launch::async, write, std::cref(r), n);
+      }
+      ToolStats::Lap lap(tstats);
+      if (writer.valid()) writer.get();
+      lap.Mark(ToolStats::IO);
+    } else {
+      auto line = [&](std::string& s, std::ostream& os) -> int {
+        std::string out;
+        int r = process(s, out);
+        os << out;
+        tstats.Lines(1, r);
+        return r;
+      };
+      retval = ToolPipeline::ProcessLines(*input, *output, nthreads, line);
+    }
+    if (stats) {
+      unsigned n = binary ? 1 :
+        (nthreads ? nthreads : GeodesicBatchExecutor::Concurrency());
+      tstats.Report("GeodSolve", n, err);
+#if GEOGRAPHICLIB_INSTRUMENT
+      // Only the inverse problem with Geodesic is instrumented
+      if (geods.InversePaths().Total()) {
+        tstats.Report("inverse paths", geods.InversePaths(), err);
+        tstats.Report("inverse iterations", geods.InverseIterations(), err);
+        tstats.Report("inverse bisections", geods.InverseBisections(), err);
+      }
+#endif
     }
     return retval;
   }
   catch (const std::exception& e) {
-    std::cerr << "Caught exception: " << e.what() << "\n";
+    err << "Caught exception: " << e.what() << "\n";
     return 1;
   }
   catch (...) {
-    std::cerr << "Caught unknown exception\n";
+    err << "Caught unknown exception\n";
     return 1;
   }
 }
+
+int main(int argc, const char* const argv[]) {
+  return ToolServer::Main(argc, argv, run);
+}
@@ -13,8 +13,16 @@
 #include <string>
 #include <sstream>
 #include <fstream>
+#include <vector>
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
 #include <GeographicLib/Geoid.hpp>
 #include <GeographicLib/DMS.hpp>
+#include <GeographicLib/GeodesicBatchExecutor.hpp>
+#include <GeographicLib/Trace.hpp>
 #include <GeographicLib/Utility.hpp>
 #include <GeographicLib/GeoCoords.hpp>
 
@@ -25,20 +33,68 @@
 #endif
 
 #include "GeoidEval.usage"
+#include "ToolPipeline.hpp"
+#include "ToolGrid.hpp"
+#include "ToolServer.hpp"
 
-int main(int argc, const char* const argv[]) {
+// When serving, the geoids are read into memory once (with threadsafe =
+// true) and shared by all the requests; at most MaxGeoids are kept and the
+// least recently used one is dropped to make room for another.  (A request
+// still using a dropped geoid holds its own reference.)  Otherwise,
+// concurrent = true is used if the geoid will be accessed by several
+// threads (with -j).
+const std::size_t MaxGeoids = 4;
+std::shared_ptr<const GeographicLib::Geoid>
+LoadGeoid(const std::string& name, const std::string& dir,
+          bool cubic, bool mapfile, bool concurrent) {
+  using namespace GeographicLib;
+  if (!ToolServer::Serving())
+    return std::make_shared<const Geoid>(name, dir, cubic, false, mapfile,
+                                         concurrent);
+  // The geoids with the time of their last use
+  typedef std::tuple<std::string, std::string, bool, bool> key;
+  typedef std::map<key, std::pair<std::shared_ptr<const Geoid>,
+                                  unsigned long long>> cache;
+  static std::mutex lock;
+  static cache geoids;
+  static unsigned long long uses = 0;
+  std::lock_guard<std::mutex> guard(lock);
+  key k = std::make_tuple(name, dir, cubic, mapfile);
+  auto p = geoids.find(k);
+  if (p == geoids.end()) {
+    // Construct the geoid first so that a failure leaves no entry
+    std::shared_ptr<const Geoid> g =
+      std::make_shared<const Geoid>(name, dir, cubic, true, mapfile);
+    if (geoids.size() >= MaxGeoids)
+      geoids.erase(std::min_element
+                   (geoids.begin(), geoids.end(),
+                    [](const cache::value_type& a,
+                       const cache::value_type& b) -> bool
+                    { return a.second.second < b.second.second; }));
+    p = geoids.insert(std::make_pair(k, std::make_pair(g, 0ULL))).first;
+  }
+  p->second.second = ++uses;
+  return p->second.first;
+}
+
+int run(int argc, const char* const argv[],
+        std::istream& in, std::ostream& out, std::ostream& err) {
   try {
     using namespace GeographicLib;
     typedef Math::real real;
     Utility::set_digits();
-    bool cacheall = false, cachearea = false, verbose = false, cubic = true;
-    real caches, cachew, cachen, cachee;
+    bool cacheall = false, cachearea = false, verbose = false, cubic = true,
+      mapfile = false, cachetiles = false;
+    real caches, cachew, cachen, cachee, tilemb = 0;
     std::string dir;
     std::string geoid = Geoid::DefaultGeoidName();
     Geoid::convertflag heightmult = Geoid::NONE;
     std::string istring, ifile, ofile, cdelim;
+    unsigned nthreads = 1;
     char lsep = ';';
-    bool northp = false, longfirst = false;
+    bool northp = false, longfirst = false, binary = false, gridp = false,
+      gtx = false, locality = false;
+    ToolGrid::Grid grid;
     int zonenum = UTMUPS::INVALID;
 
     for (int m = 1; m < argc; ++m) {
@@ -46,11 +102,15 @@ int main(int argc, const char* const argv[]) {
       if (arg == "-a") {
         cacheall = true;
         cachearea = false;
+        mapfile = false;
+        cachetiles = false;
       }
       else if (arg == "-c") {
-        if (m + 4 >= argc) return usage(1, true);
+        if (m + 4 >= argc) return usage(1, true, out, err);
         cacheall = false;
         cachearea = true;
+        mapfile = false;
+        cachetiles = false;
         try {
           DMS::DecodeLatLon(std::string(argv[m + 1]), std::string(argv[m + 2]),
                             caches, cachew, longfirst);
@@ -58,10 +118,30 @@ int main(int argc, const char* const argv[]) {
                             cachen, cachee, longfirst);
         }
         catch (const std::exception& e) {
-          std::cerr << "Error decoding argument of -c: " << e.what() << "\n";
+          err << "Error decoding argument of -c: " << e.what() << "\n";
           return 1;
         }
         m += 4;
+      } else if (arg == "-m") {
+        cacheall = false;
+        cachearea = false;
+        mapfile = true;
+        cachetiles = false;
+      } else if (arg == "-t") {
+        if (++m == argc) return usage(1, true, out, err);
+        cacheall = false;
+        cachearea = false;
+        mapfile = false;
+        cachetiles = true;
+        try {
+          tilemb = Utility::val<real>(std::string(argv[m]));
+          if (!(tilemb >= 0))
+            throw GeographicErr("Memory budget must be nonnegative");
+        }
+        catch (const std::exception& e) {
+          err << "Error decoding argument of -t: " << e.what() << "\n";
+          return 1;
+        }
       } else if (arg == "--msltohae")
         heightmult = Geoid::GEOIDTOELLIPSOID;
       else if (arg == "--haetomsl")
@@ -69,56 +149,79 @@ int main(int argc, const char* const argv[]) {
       else if (arg == "-w")
         longfirst = !longfirst;
       else if (arg == "-z") {
-        if (++m == argc) return usage(1, true);
+        if (++m == argc) return usage(1, true, out, err);
         std::string zone = argv[m];
         try {
           UTMUPS::DecodeZone(zone, zonenum, northp);
         }
         catch (const std::exception& e) {
-          std::cerr << "Error decoding zone: " << e.what() << "\n";
+          err << "Error decoding zone: " << e.what() << "\n";
           return 1;
         }
         if (!(zonenum >= UTMUPS::MINZONE && zonenum <= UTMUPS::MAXZONE)) {
-          std::cerr << "Illegal zone " << zone << "\n";
+          err << "Illegal zone " << zone << "\n";
           return 1;
         }
       } else if (arg == "-n") {
-        if (++m == argc) return usage(1, true);
+        if (++m == argc) return usage(1, true, out, err);
         geoid = argv[m];
       } else if (arg == "-d") {
-        if (++m == argc) return usage(1, true);
+        if (++m == argc) return usage(1, true, out, err);
         dir = argv[m];
       } else if (arg == "-l")
         cubic = false;
       else if (arg == "-v")
         verbose = true;
+      else if (arg == "--binary")
+        binary = true;
+      else if (arg == "--locality")
+        locality = true;
+      else if (arg == "--grid") {
+        if (m + 6 >= argc) return usage(1, true, out, err);
+        try {
+          grid.Decode(argv + m + 1);
+          m += 6;
+          gridp = true;
+        }
+        catch (const std::exception& e) {
+          err << "Error decoding argument of " << arg << ": "
+              << e.what() << "\n";
+          return 1;
+        }
+      } else if (arg == "--gtx")
+        gtx = true;
       else if (arg == "--input-string") {
-        if (++m == argc) return usage(1, true);
+        if (++m == argc) return usage(1, true, out, err);
         istring = argv[m];
       } else if (arg == "--input-file") {
-        if (++m == argc) return usage(1, true);
+        if (++m == argc) return usage(1, true, out, err);
         ifile = argv[m];
       } else if (arg == "--output-file") {
-        if (++m == argc) return usage(1, true);
+        if (++m == argc) return usage(1, true, out, err);
         ofile = argv[m];
       } else if (arg == "--line-separator") {
-        if (++m == argc) return usage(1, true);
+        if (++m == argc) return usage(1, true, out, err);
         if (std::string(argv[m]).size() != 1) {
-          std::cerr << "Line separator must be a single character\n";
+          err << "Line separator must be a single character\n";
           return 1;
         }
         lsep = argv[m][0];
       } else if (arg == "--comment-delimiter") {
-        if (++m == argc) return usage(1, true);
+        if (++m == argc) return usage(1, true, out, err);
         cdelim = argv[m];
+      } else if (arg == "-j" || arg == "--threads") {
+        if (++m == argc) return usage(1, true, out, err);
+        if (!ToolPipeline::Threads(argv[m], nthreads, err))
+          return 1;
       } else if (arg == "--version") {
-        std::cout << argv[0] << ": GeographicLib version "
+        out << argv[0] << ": GeographicLib version "
                   << GEOGRAPHICLIB_VERSION_STRING << "\n";
         return 0;
       } else {
-        int retval = usage(!(arg == "-h" || arg == "--help"), arg != "--help");
+        int retval = usage(!(arg == "-h" || arg == "--help"),
+                           arg != "--help", out, err);
         if (arg == "-h")
-          std::cout
+          out
             << "\nDefault geoid path = \""   << Geoid::DefaultGeoidPath()
             << "\"\nDefault geoid name = \"" << Geoid::DefaultGeoidName()
             << "\"\n";
@@ -126,17 +229,44 @@ int main(int argc, const char* const argv[]) {
       }
     }
 
+    if (ToolServer::Serving()) {
+      // The shared geoid is already in memory
+      cacheall = cachearea = cachetiles = false;
+      // A client may only choose among the geoids in the server's directory
+      if (!dir.empty() || geoid.find_first_of("/\\") != std::string::npos) {
+        err << "Cannot use -d or a path in -n with --connect\n";
+        return 1;
+      }
+    }
     if (!ifile.empty() && !istring.empty()) {
-      std::cerr << "Cannot specify --input-string and --input-file together\n";
+      err << "Cannot specify --input-string and --input-file together\n";
+      return 1;
+    }
+    if (binary && !istring.empty()) {
+      err << "Cannot specify --input-string and --binary together\n";
+      return 1;
+    }
+    if (gridp && (binary || heightmult || zonenum != UTMUPS::INVALID ||
+                  !ifile.empty() || !istring.empty())) {
+      err << "Cannot specify --grid with --binary, --msltohae, --haetomsl, "
+          << "-z, --input-string, or --input-file\n";
+      return 1;
+    }
+    if (gtx && !gridp) {
+      err << "--gtx needs --grid\n";
+      return 1;
+    }
+    if (locality && !binary) {
+      err << "--locality needs --binary\n";
       return 1;
     }
     if (ifile == "-") ifile.clear();
     std::ifstream infile;
     std::istringstream instring;
     if (!ifile.empty()) {
-      infile.open(ifile.c_str());
+      infile.open(ifile.c_str(), binary ? std::ios::binary : std::ios::in);
       if (!infile.is_open()) {
-        std::cerr << "Cannot open " << ifile << " for reading\n";
+        err << "Cannot open " << ifile << " for reading\n";
         return 1;
       }
     } else if (!istring.empty()) {
@@ -150,33 +280,41 @@ int main(int argc, const char* const argv[]) {
       instring.str(istring);
     }
     std::istream* input = !ifile.empty() ? &infile :
-      (!istring.empty() ? &instring : &std::cin);
+      (!istring.empty() ? &instring : &in);
 
     std::ofstream outfile;
     if (ofile == "-") ofile.clear();
     if (!ofile.empty()) {
-      outfile.open(ofile.c_str());
+      outfile.open(ofile.c_str(),
+                   binary || gridp ? std::ios::binary : std::ios::out);
       if (!outfile.is_open()) {
-        std::cerr << "Cannot open " << ofile << " for writing\n";
+        err << "Cannot open " << ofile << " for writing\n";
         return 1;
       }
     }
-    std::ostream* output = !ofile.empty() ? &outfile : &std::cout;
+    std::ostream* output = !ofile.empty() ? &outfile : &out;
 
+    // Write a trace if GEOGRAPHICLIB_TRACE is set
+    Trace::Session trace;
     int retval = 0;
     try {
-      const Geoid g(geoid, dir, cubic);
+      std::shared_ptr<const Geoid> gp =
+        LoadGeoid(geoid, dir, cubic, mapfile,
+                  nthreads != 1 && !binary && !mapfile);
+      const Geoid& g = *gp;
       try {
         if (cacheall)
           g.CacheAll();
         else if (cachearea)
           g.CacheArea(caches, cachew, cachen, cachee);
+        else if (cachetiles)
+          g.CacheTiles((unsigned long long)(tilemb * 1048576));
       }
       catch (const std::exception& e) {
-        std::cerr << "ERROR: " << e.what() << "\nProceeding without a cache\n";
+        err << "ERROR: " << e.what() << "\nProceeding without a cache\n";
       }
       if (verbose) {
-        std::cerr << "Geoid file: "    << g.GeoidFile()     << "\n"
+        err << "Geoid file: "    << g.GeoidFile()     << "\n"
                   << "Description: "   << g.Description()   << "\n"
                   << "Interpolation: " << g.Interpolation() << "\n"
                   << "Date & Time: "   << g.DateTime()      << "\n"
@@ -184,20 +322,101 @@ int main(int argc, const char* const argv[]) {
                   << "Scale (m): "     << g.Scale()         << "\n"
                   << "Max error (m): " << g.MaxError()      << "\n"
                   << "RMS error (m): " << g.RMSError()      << "\n";
+        if (g.MemoryMapped())
+          err << "Memory mapped\n";
         if (g.Cache())
-          std::cerr
+          err
             << "Caching:"
             << "\n SW Corner: " << g.CacheSouth() << " " << g.CacheWest()
             << "\n NE Corner: " << g.CacheNorth() << " " << g.CacheEast()
             << "\n";
+        if (g.Compressed())
+          err << "Compressed data file\n";
+        if (g.TileCache())
+          err << "Tile cache: " << g.TileCacheCapacity() << " tiles\n";
       }
 
-      GeoCoords p;
-      std::string s, eol, suff;
+      if (gridp) {
+        // Resample the geoid onto the grid
+        if (verbose)
+          err << "Grid: " << grid.nlat << " rows of "
+              << grid.nlon << " points\n";
+        GEOGRAPHICLIB_TRACE_SPAN("GeoidEval: compute grid");
+        ToolGrid::Rows(*output, grid, 1, gtx, nthreads,
+                       [&](size_t i, real v[]) -> void {
+          real lat = grid.Lat(i);
+          for (size_t j = 0; j < grid.nlon; ++j)
+            v[j] = g(lat, grid.Lon(j));
+        });
+        return retval;
+      }
+      GEOGRAPHICLIB_TRACE_SPAN("GeoidEval: process input");
+      if (binary) {
+        GeoCoords p;
+        // Binary records of little-endian doubles: the input is latitude and
+        // longitude (or easting and northing with -z) followed by the height
+        // with --msltohae or --haetomsl; the output is the geoid height (or
+        // the converted height).  An error gives a NaN.  The records are
+        // processed in blocks with Geoid::HeightBatch.  With --locality, the
+        // blocks are bigger and the points in a block are evaluated in
+        // Hilbert order.
+        const size_t block = locality ? 1048576 : 4096;
+        std::vector<real> lat(block), lon(block), hin(block), h(block),
+          slat(locality ? block : 0), slon(locality ? block : 0),
+          sh(locality ? block : 0);
+        std::vector<size_t> perm(locality ? block : 0);
+        real u[3];
+        while (input->peek() != std::char_traits<char>::eof()) {
+          size_t k = 0;
+          for (; k < block && input->peek() != std::char_traits<char>::eof();
+               ++k) {
+            Utility::readarray<double, real, false>
+              (*input, u, heightmult ? 3 : 2);
+            hin[k] = heightmult ? u[2] : 0;
+            try {
+              if (zonenum != UTMUPS::INVALID)
+                p.Reset(zonenum, northp, u[0], u[1]);
+              else
+                p.Reset(longfirst ? u[1] : u[0], longfirst ? u[0] : u[1]);
+              lat[k] = p.Latitude();
+              lon[k] = p.Longitude();
+            }
+            catch (const std::exception&) {
+              lat[k] = Math::NaN();
+              retval = 1;
+            }
+          }
+          try {
+            if (locality) {
+              GeodesicBatchExecutor::HilbertOrder(k, lat.data(), lon.data(),
+                                                  perm.data());
+              for (size_t i = 0; i < k; ++i) {
+                slat[i] = lat[perm[i]]; slon[i] = lon[perm[i]];
+              }
+              g.HeightBatch(k, slat.data(), slon.data(), sh.data());
+              for (size_t i = 0; i < k; ++i)
+                h[perm[i]] = sh[i];
+            } else
+              g.HeightBatch(k, lat.data(), lon.data(), h.data());
+          }
+          catch (const std::exception&) {
+            std::fill(h.begin(), h.begin() + k, Math::NaN());
+            retval = 1;
+          }
+          if (heightmult)
+            for (size_t i = 0; i < k; ++i)
+              h[i] = hin[i] + real(heightmult) * h[i];
+          Utility::writearray<double, real, false>(*output, h.data(), k);
+        }
+        return retval;
+      }
       const char* spaces = " \t\n\v\f\r,"; // Include comma as space
-      while (std::getline(*input, s)) {
+      // Process a line of input; with -j, this is called concurrently on
+      // several threads.
+      auto process = [&](std::string& s, std::ostream& os) -> int {
+        GeoCoords p;
+        std::string eol("\n"), suff;
         try {
-          eol = "\n";
           if (!cdelim.empty()) {
             std::string::size_type m = s.find(cdelim);
             if (m != std::string::npos) {
@@ -248,32 +467,38 @@ int main(int argc, const char* const argv[]) {
           }
           if (heightmult) {
             real h = g(p.Latitude(), p.Longitude());
-            *output << s
-                    << Utility::str(height + real(heightmult) * h, 4)
-                    << suff << eol;
+            os << s
+               << Utility::str(height + real(heightmult) * h, 4)
+               << suff << eol;
           } else {
             real h = g(p.Latitude(), p.Longitude());
-            *output << Utility::str(h, 4) << eol;
+            os << Utility::str(h, 4) << eol;
           }
         }
         catch (const std::exception& e) {
-          *output << "ERROR: " << e.what() << "\n";
-          retval = 1;
+          os << "ERROR: " << e.what() << "\n";
+          return 1;
         }
-      }
+        return 0;
+      };
+      retval = ToolPipeline::ProcessLines(*input, *output, nthreads, process);
     }
     catch (const std::exception& e) {
-      std::cerr << "Error reading " << geoid << ": " << e.what() << "\n";
+      err << "Error reading " << geoid << ": " << e.what() << "\n";
       retval = 1;
     }
     return retval;
   }
   catch (const std::exception& e) {
-    std::cerr << "Caught exception: " << e.what() << "\n";
+    err << "Caught exception: " << e.what() << "\n";
     return 1;
   }
   catch (...) {
-    std::cerr << "Caught unknown exception\n";
+    err << "Caught unknown exception\n";
     return 1;
   }
 }
+
+int main(int argc, const char* const argv[]) {
+  return ToolServer::Main(argc, argv, run);
+}
@@ -16,6 +16,7 @@
 #include <GeographicLib/GravityModel.hpp>
 #include <GeographicLib/GravityCircle.hpp>
 #include <GeographicLib/DMS.hpp>
+#include <GeographicLib/Trace.hpp>
 #include <GeographicLib/Utility.hpp>
 
 #if defined(_MSC_VER)
@@ -25,6 +26,8 @@
 #endif
 
 #include "Gravity.usage"
+#include "ToolPipeline.hpp"
+#include "ToolGrid.hpp"
 
 int main(int argc, const char* const argv[]) {
   try {
@@ -35,9 +38,11 @@ int main(int argc, const char* const argv[]) {
     std::string dir;
     std::string model = GravityModel::DefaultGravityName();
     std::string istring, ifile, ofile, cdelim;
+    unsigned nthreads = 1;
     char lsep = ';';
     real lat = 0, h = 0;
-    bool circle = false;
+    bool circle = false, gridp = false, gtx = false;
+    ToolGrid::Grid grid;
     int prec = -1, Nmax = -1, Mmax = -1;
     enum {
       GRAVITY = 0,
@@ -107,7 +112,21 @@ int main(int argc, const char* const argv[]) {
                     << e.what() << "\n";
           return 1;
         }
-      } else if (arg == "-w")
+      } else if (arg == "--grid") {
+        if (m + 6 >= argc) return usage(1, true);
+        try {
+          grid.Decode(argv + m + 1);
+          m += 6;
+          gridp = true;
+        }
+        catch (const std::exception& e) {
+          std::cerr << "Error decoding argument of " << arg << ": "
+                    << e.what() << "\n";
+          return 1;
+        }
+      } else if (arg == "--gtx")
+        gtx = true;
+      else if (arg == "-w")
         longfirst = !longfirst;
       else if (arg == "-p") {
         if (++m == argc) return usage(1, true);
@@ -139,6 +158,10 @@ int main(int argc, const char* const argv[]) {
       } else if (arg == "--comment-delimiter") {
         if (++m == argc) return usage(1, true);
         cdelim = argv[m];
+      } else if (arg == "-j" || arg == "--threads") {
+        if (++m == argc) return usage(1, true);
+        if (!ToolPipeline::Threads(argv[m], nthreads, std::cerr))
+          return 1;
       } else if (arg == "--version") {
         std::cout << argv[0] << ": GeographicLib version "
                   << GEOGRAPHICLIB_VERSION_STRING << "\n";
@@ -159,6 +182,15 @@ int main(int argc, const char* const argv[]) {
       std::cerr << "Cannot specify --input-string and --input-file together\n";
       return 1;
     }
+    if (gridp && (circle || !ifile.empty() || !istring.empty())) {
+      std::cerr << "Cannot specify --grid with -c, --input-string, "
+                << "or --input-file\n";
+      return 1;
+    }
+    if (gtx && !(gridp && mode == UNDULATION)) {
+      std::cerr << "--gtx needs --grid and -H\n";
+      return 1;
+    }
     if (ifile == "-") ifile.clear();
     std::ifstream infile;
     std::istringstream instring;
@@ -184,7 +216,7 @@ int main(int argc, const char* const argv[]) {
     std::ofstream outfile;
     if (ofile == "-") ofile.clear();
     if (!ofile.empty()) {
-      outfile.open(ofile.c_str());
+      outfile.open(ofile.c_str(), gridp ? std::ios::binary : std::ios::out);
       if (!outfile.is_open()) {
         std::cerr << "Cannot open " << ofile << " for writing\n";
         return 1;
@@ -205,6 +237,8 @@ int main(int argc, const char* const argv[]) {
       prec = std::min(12 + Math::extra_digits(), prec < 0 ? 4 : prec);
       break;
     }
+    // Write a trace if GEOGRAPHICLIB_TRACE is set
+    Trace::Session trace;
     int retval = 0;
     try {
       using std::isfinite;
@@ -225,12 +259,49 @@ int main(int argc, const char* const argv[]) {
                        (mode == DISTURBANCE ? GravityModel::DISTURBANCE :
                         (mode == ANOMALY ? GravityModel::SPHERICAL_ANOMALY :
                          GravityModel::GEOID_HEIGHT))); // mode == UNDULATION
+      if (gridp) {
+        // Compute each row of the grid with a GravityCircle; the values are
+        // in the same units as the text output.
+        if (verbose)
+          std::cerr << "Grid: " << grid.nlat << " rows of "
+                    << grid.nlon << " points\n";
+        GEOGRAPHICLIB_TRACE_SPAN("Gravity: compute grid");
+        const size_t nv = mode == UNDULATION ? 1 : 3;
+        ToolGrid::Rows(*output, grid, nv, gtx, nthreads,
+                       [&](size_t i, real v[]) -> void {
+          const GravityCircle c(g.Circle(grid.Lat(i), 0, mask));
+          for (size_t j = 0; j < grid.nlon; ++j, v += nv) {
+            real lon = grid.Lon(j);
+            switch (mode) {
+            case GRAVITY:
+              c.Gravity(lon, v[0], v[1], v[2]);
+              break;
+            case DISTURBANCE:
+              c.Disturbance(lon, v[0], v[1], v[2]);
+              v[0] *= 100000; v[1] *= 100000; v[2] *= 100000;
+              break;
+            case ANOMALY:
+              c.SphericalAnomaly(lon, v[0], v[1], v[2]);
+              v[0] *= 100000; v[1] *= Math::ds; v[2] *= Math::ds;
+              break;
+            case UNDULATION:
+            default:
+              v[0] = c.GeoidHeight(lon);
+              break;
+            }
+          }
+        });
+        return retval;
+      }
       const GravityCircle c(circle ? g.Circle(lat, h, mask) : GravityCircle());
-      std::string s, eol, stra, strb;
-      std::istringstream str;
-      while (std::getline(*input, s)) {
+      GEOGRAPHICLIB_TRACE_SPAN("Gravity: process input");
+      // Process a line of input; with -j, this is called concurrently on
+      // several threads.
+      auto process = [&](std::string& s, std::ostream& os) -> int {
+        std::string eol("\n"), stra, strb;
+        std::istringstream str;
+        real lat = 0, h = 0;
         try {
-          eol = "\n";
           if (!cdelim.empty()) {
             std::string::size_type m = s.find(cdelim);
             if (m != std::string::npos) {
@@ -268,9 +339,9 @@ int main(int argc, const char* const argv[]) {
               } else {
                 g.Gravity(lat, lon, h, gx, gy, gz);
               }
-              *output << Utility::str(gx, prec) << " "
-                      << Utility::str(gy, prec) << " "
-                      << Utility::str(gz, prec) << eol;
+              os << Utility::str(gx, prec) << " "
+                 << Utility::str(gy, prec) << " "
+                 << Utility::str(gz, prec) << eol;
             }
             break;
           case DISTURBANCE:
@@ -282,10 +353,10 @@ int main(int argc, const char* const argv[]) {
                 g.Disturbance(lat, lon, h, deltax, deltay, deltaz);
               }
               // Convert to mGals
-              *output << Utility::str(deltax * 100000, prec) << " "
-                      << Utility::str(deltay * 100000, prec) << " "
-                      << Utility::str(deltaz * 100000, prec)
-                      << eol;
+              os << Utility::str(deltax * 100000, prec) << " "
+                 << Utility::str(deltay * 100000, prec) << " "
+                 << Utility::str(deltaz * 100000, prec)
+                 << eol;
             }
             break;
           case ANOMALY:
@@ -298,25 +369,27 @@ int main(int argc, const char* const argv[]) {
               Dg01 *= 100000;   // Convert to mGals
               xi *= Math::ds;   // Convert to arcsecs
               eta *= Math::ds;
-              *output << Utility::str(Dg01, prec) << " "
-                      << Utility::str(xi, prec) << " "
-                      << Utility::str(eta, prec) << eol;
+              os << Utility::str(Dg01, prec) << " "
+                 << Utility::str(xi, prec) << " "
+                 << Utility::str(eta, prec) << eol;
             }
             break;
           case UNDULATION:
           default:
             {
               real N = circle ? c.GeoidHeight(lon) : g.GeoidHeight(lat, lon);
-              *output << Utility::str(N, prec) << eol;
+              os << Utility::str(N, prec) << eol;
             }
             break;
           }
         }
         catch (const std::exception& e) {
-          *output << "ERROR: " << e.what() << "\n";
-          retval = 1;
+          os << "ERROR: " << e.what() << "\n";
+          return 1;
         }
-      }
+        return 0;
+      };
+      retval = ToolPipeline::ProcessLines(*input, *output, nthreads, process);
     }
     catch (const std::exception& e) {
       std::cerr << "Error reading " << model << ": " << e.what() << "\n";
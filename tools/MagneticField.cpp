@@ -16,6 +16,7 @@
 #include <GeographicLib/MagneticModel.hpp>
 #include <GeographicLib/MagneticCircle.hpp>
 #include <GeographicLib/DMS.hpp>
+#include <GeographicLib/Trace.hpp>
 #include <GeographicLib/Utility.hpp>
 
 #if defined(_MSC_VER)
@@ -24,6 +25,8 @@
 #endif
 
 #include "MagneticField.usage"
+#include "ToolPipeline.hpp"
+#include "ToolGrid.hpp"
 
 int main(int argc, const char* const argv[]) {
   try {
@@ -34,9 +37,11 @@ int main(int argc, const char* const argv[]) {
     std::string dir;
     std::string model = MagneticModel::DefaultMagneticName();
     std::string istring, ifile, ofile, cdelim;
+    unsigned nthreads = 1;
     char lsep = ';';
     real time = 0, lat = 0, h = 0;
-    bool timeset = false, circle = false, rate = false;
+    bool timeset = false, circle = false, rate = false, gridp = false;
+    ToolGrid::Grid grid;
     real hguard = 500000, tguard = 50;
     int prec = 1, Nmax = -1, Mmax = -1;
 
@@ -107,6 +112,18 @@ int main(int argc, const char* const argv[]) {
                     << e.what() << "\n";
           return 1;
         }
+      } else if (arg == "--grid") {
+        if (m + 6 >= argc) return usage(1, true);
+        try {
+          grid.Decode(argv + m + 1);
+          m += 6;
+          gridp = true;
+        }
+        catch (const std::exception& e) {
+          std::cerr << "Error decoding argument of " << arg << ": "
+                    << e.what() << "\n";
+          return 1;
+        }
       } else if (arg == "-r")
         rate = !rate;
       else if (arg == "-w")
@@ -161,6 +178,10 @@ int main(int argc, const char* const argv[]) {
       } else if (arg == "--comment-delimiter") {
         if (++m == argc) return usage(1, true);
         cdelim = argv[m];
+      } else if (arg == "-j" || arg == "--threads") {
+        if (++m == argc) return usage(1, true);
+        if (!ToolPipeline::Threads(argv[m], nthreads, std::cerr))
+          return 1;
       } else if (arg == "--version") {
         std::cout << argv[0] << ": GeographicLib version "
                   << GEOGRAPHICLIB_VERSION_STRING << "\n";
@@ -181,6 +202,11 @@ int main(int argc, const char* const argv[]) {
       std::cerr << "Cannot specify --input-string and --input-file together\n";
       return 1;
     }
+    if (gridp && (!timeset || !ifile.empty() || !istring.empty())) {
+      std::cerr << "--grid needs -t and cannot be used with -c, "
+                << "--input-string, or --input-file\n";
+      return 1;
+    }
     if (ifile == "-") ifile.clear();
     std::ifstream infile;
     std::istringstream instring;
@@ -206,7 +232,7 @@ int main(int argc, const char* const argv[]) {
     std::ofstream outfile;
     if (ofile == "-") ofile.clear();
     if (!ofile.empty()) {
-      outfile.open(ofile.c_str());
+      outfile.open(ofile.c_str(), gridp ? std::ios::binary : std::ios::out);
       if (!outfile.is_open()) {
         std::cerr << "Cannot open " << ofile << " for writing\n";
         return 1;
@@ -218,6 +244,8 @@ int main(int argc, const char* const argv[]) {
     tguard = fmax(real(0), tguard);
     hguard = fmax(real(0), hguard);
     prec = std::min(10 + Math::extra_digits(), std::max(0, prec));
+    // Write a trace if GEOGRAPHICLIB_TRACE is set
+    Trace::Session trace;
     int retval = 0;
     try {
       using std::isfinite;
@@ -259,13 +287,44 @@ int main(int argc, const char* const argv[]) {
                   << "km outside allowed range ["
                   << m.MinHeight()/1000 << "km,"
                   << m.MaxHeight()/1000 << "km]\n";
+      if (gridp) {
+        // Compute each row of the grid with a MagneticCircle; the values are
+        // the same as the text output.
+        if (verbose)
+          std::cerr << "Grid: " << grid.nlat << " rows of "
+                    << grid.nlon << " points\n";
+        GEOGRAPHICLIB_TRACE_SPAN("MagneticField: compute grid");
+        const size_t nv = rate ? 14 : 7;
+        ToolGrid::Rows(*output, grid, nv, false, nthreads,
+                       [&](size_t i, real v[]) -> void {
+          const MagneticCircle c(m.Circle(time, grid.Lat(i), 0));
+          for (size_t j = 0; j < grid.nlon; ++j, v += nv) {
+            real bx, by, bz, bxt, byt, bzt;
+            c(grid.Lon(j), bx, by, bz, bxt, byt, bzt);
+            real H, F, D, I, Ht, Ft, Dt, It;
+            MagneticModel::FieldComponents(bx, by, bz, bxt, byt, bzt,
+                                           H, F, D, I, Ht, Ft, Dt, It);
+            v[0] = D; v[1] = I; v[2] = H;
+            v[3] = by; v[4] = bx; v[5] = -bz; v[6] = F;
+            if (rate) {
+              v[7] = Dt; v[8] = It; v[9] = Ht;
+              v[10] = byt; v[11] = bxt; v[12] = -bzt; v[13] = Ft;
+            }
+          }
+        });
+        return retval;
+      }
       const MagneticCircle c(circle ? m.Circle(time, lat, h) :
                              MagneticCircle());
-      std::string s, eol, stra, strb;
-      std::istringstream str;
-      while (std::getline(*input, s)) {
+      GEOGRAPHICLIB_TRACE_SPAN("MagneticField: process input");
+      const real time0 = time;
+      // Process a line of input; with -j, this is called concurrently on
+      // several threads.
+      auto process = [&](std::string& s, std::ostream& os) -> int {
+        std::string eol("\n"), stra, strb;
+        std::istringstream str;
+        real time = time0, lat = 0, h = 0;
         try {
-          eol = "\n";
           if (!cdelim.empty()) {
             std::string::size_type n = s.find(cdelim);
             if (n != std::string::npos) {
@@ -328,27 +387,29 @@ int main(int argc, const char* const argv[]) {
           MagneticModel::FieldComponents(bx, by, bz, bxt, byt, bzt,
                                          H, F, D, I, Ht, Ft, Dt, It);
 
-          *output << DMS::Encode(D, prec + 1, DMS::NUMBER) << " "
-                  << DMS::Encode(I, prec + 1, DMS::NUMBER) << " "
-                  << Utility::str(H, prec) << " "
-                  << Utility::str(by, prec) << " "
-                  << Utility::str(bx, prec) << " "
-                  << Utility::str(-bz, prec) << " "
-                  << Utility::str(F, prec) << eol;
+          os << DMS::Encode(D, prec + 1, DMS::NUMBER) << " "
+             << DMS::Encode(I, prec + 1, DMS::NUMBER) << " "
+             << Utility::str(H, prec) << " "
+             << Utility::str(by, prec) << " "
+             << Utility::str(bx, prec) << " "
+             << Utility::str(-bz, prec) << " "
+             << Utility::str(F, prec) << eol;
           if (rate)
-            *output << DMS::Encode(Dt, prec + 1, DMS::NUMBER) << " "
-                    << DMS::Encode(It, prec + 1, DMS::NUMBER) << " "
-                    << Utility::str(Ht, prec) << " "
-                    << Utility::str(byt, prec) << " "
-                    << Utility::str(bxt, prec) << " "
-                    << Utility::str(-bzt, prec) << " "
-                    << Utility::str(Ft, prec) << eol;
+            os << DMS::Encode(Dt, prec + 1, DMS::NUMBER) << " "
+               << DMS::Encode(It, prec + 1, DMS::NUMBER) << " "
+               << Utility::str(Ht, prec) << " "
+               << Utility::str(byt, prec) << " "
+               << Utility::str(bxt, prec) << " "
+               << Utility::str(-bzt, prec) << " "
+               << Utility::str(Ft, prec) << eol;
         }
         catch (const std::exception& e) {
-          *output << "ERROR: " << e.what() << "\n";
-          retval = 1;
+          os << "ERROR: " << e.what() << "\n";
+          return 1;
         }
-      }
+        return 0;
+      };
+      retval = ToolPipeline::ProcessLines(*input, *output, nthreads, process);
     }
     catch (const std::exception& e) {
       std::cerr << "Error reading " << model << ": " << e.what() << "\n";
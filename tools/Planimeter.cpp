@@ -2,7 +2,7 @@
  * \file Planimeter.cpp
  * \brief Command line utility for measuring the area of geodesic polygons
  *
- * Copyright (c) Charles Karney (2010-2022) <charles@karney.com> and licensed
+ * Copyright (c) Charles Karney (2010-2026) <charles@karney.com> and licensed
  * under the MIT/X11 License.  For more information, see
  * https://geographiclib.sourceforge.io/
  *
@@ -13,7 +13,9 @@
 #include <string>
 #include <sstream>
 #include <fstream>
+#include <vector>
 #include <GeographicLib/PolygonArea.hpp>
+#include <GeographicLib/PolygonReader.hpp>
 #include <GeographicLib/DMS.hpp>
 #include <GeographicLib/Utility.hpp>
 #include <GeographicLib/GeoCoords.hpp>
@@ -32,13 +34,15 @@ int main(int argc, const char* const argv[]) {
     typedef Math::real real;
     Utility::set_digits();
     enum { GEODESIC, EXACT, AUTHALIC, RHUMB };
+    enum { TEXT, GEOJSON, WKB };
     real
       a = Constants::WGS84_a(),
       f = Constants::WGS84_f();
     bool reverse = false, sign = true, polyline = false, longfirst = false,
       geoconvert_compat = false;
-    int linetype = GEODESIC;
+    int linetype = GEODESIC, informat = TEXT;
     int prec = 6;
+    unsigned nthreads = 1;
     std::string istring, ifile, ofile, cdelim;
     char lsep = ';';
 
@@ -80,8 +84,21 @@ int main(int argc, const char* const argv[]) {
         linetype = AUTHALIC;
       else if (arg == "-R")
         linetype = RHUMB;
-      else if (arg == "--geoconvert-input")
+      else if (arg == "-j") {
+        if (++m == argc) return usage(1, true);
+        try {
+          nthreads = Utility::val<unsigned>(std::string(argv[m]));
+        }
+        catch (const std::exception&) {
+          std::cerr << "Number of threads " << argv[m] << " is not a number\n";
+          return 1;
+        }
+      } else if (arg == "--geoconvert-input")
         geoconvert_compat = true;
+      else if (arg == "--geojson")
+        informat = GEOJSON;
+      else if (arg == "--wkb")
+        informat = WKB;
       else if (arg == "--input-string") {
         if (++m == argc) return usage(1, true);
         istring = argv[m];
@@ -117,7 +134,8 @@ int main(int argc, const char* const argv[]) {
     std::ifstream infile;
     std::istringstream instring;
     if (!ifile.empty()) {
-      infile.open(ifile.c_str());
+      infile.open(ifile.c_str(), informat == WKB ?
+                  std::ios::in | std::ios::binary : std::ios::in);
       if (!infile.is_open()) {
         std::cerr << "Cannot open " << ifile << " for reading\n";
         return 1;
@@ -169,6 +187,83 @@ int main(int argc, const char* const argv[]) {
     std::istringstream str;
     std::string slat, slon, junk;
     real lat = 0, lon = 0;
+    auto report = [&](unsigned num, real perimeter, real area,
+                      const std::string& eol) -> void {
+      if (num > 0) {
+        *output << num << " " << Utility::str(perimeter, prec);
+        if (!polyline) {
+          *output << " " << Utility::str(area, std::max(0, prec - 5));
+        }
+        *output << eol;
+      }
+    };
+    // With -j, the polygons are collected in blocks and the polygons in each
+    // block are computed in parallel with ComputeBatch.
+    const size_t block = size_t(1) << 16;
+    std::vector<real> blat, blon, bperimeter, barea;
+    std::vector<size_t> boffsets(1, 0);
+    std::vector<std::string> beol;
+    auto flush = [&]() -> void {
+      size_t n = beol.size();
+      bperimeter.resize(n); barea.resize(n);
+      linetype == EXACT ?
+        polye.ComputeBatch(n, boffsets.data(), blat.data(), blon.data(),
+                           reverse, sign, bperimeter.data(), barea.data(),
+                           nthreads) :
+        linetype == RHUMB ?
+        polyr.ComputeBatch(n, boffsets.data(), blat.data(), blon.data(),
+                           reverse, sign, bperimeter.data(), barea.data(),
+                           nthreads) :
+        poly.ComputeBatch(n, boffsets.data(), blat.data(), blon.data(),
+                          reverse, sign, bperimeter.data(), barea.data(),
+                          nthreads);
+      for (size_t i = 0; i < n; ++i)
+        report(unsigned(boffsets[i + 1] - boffsets[i]),
+               bperimeter[i], barea[i], beol[i]);
+      blat.clear(); blon.clear(); beol.clear();
+      boffsets.resize(1);
+    };
+    if (informat != TEXT) {
+      // Each feature is a polygon with holes (or a multipolygon); the
+      // features are collected in blocks and computed with ComputeBatch.
+      PolygonReader reader(*input, informat == GEOJSON ?
+                           PolygonReader::GEOJSON : PolygonReader::WKB);
+      std::vector<size_t> polyoffsets(1, 0);
+      auto flushf = [&]() -> void {
+        size_t n = polyoffsets.size() - 1;
+        if (linetype == AUTHALIC)
+          for (real& x : blat) x = ellip.AuthalicLatitude(x);
+        bperimeter.resize(n); barea.resize(n);
+        linetype == EXACT ?
+          polye.ComputeBatch(n, polyoffsets.data(), boffsets.data(),
+                             blat.data(), blon.data(), reverse, sign,
+                             bperimeter.data(), barea.data(), nthreads) :
+          linetype == RHUMB ?
+          polyr.ComputeBatch(n, polyoffsets.data(), boffsets.data(),
+                             blat.data(), blon.data(), reverse, sign,
+                             bperimeter.data(), barea.data(), nthreads) :
+          poly.ComputeBatch(n, polyoffsets.data(), boffsets.data(),
+                            blat.data(), blon.data(), reverse, sign,
+                            bperimeter.data(), barea.data(), nthreads);
+        // One line per feature, even if it has no vertices
+        for (size_t i = 0; i < n; ++i) {
+          *output << boffsets[polyoffsets[i + 1]] - boffsets[polyoffsets[i]]
+                  << " " << Utility::str(bperimeter[i], prec);
+          if (!polyline)
+            *output << " " << Utility::str(barea[i], std::max(0, prec - 5));
+          *output << "\n";
+        }
+        blat.clear(); blon.clear(); boffsets.resize(1);
+        polyoffsets.resize(1);
+      };
+      while (reader.Next(boffsets, blat, blon)) {
+        polyoffsets.push_back(boffsets.size() - 1);
+        if (blat.size() >= block)
+          flushf();
+      }
+      flushf();
+      return 0;
+    }
     while (std::getline(*input, s)) {
       if (!cdelim.empty()) {
         std::string::size_type m = s.find(cdelim);
@@ -199,18 +294,24 @@ int main(int argc, const char* const argv[]) {
           endpoly = true;
         }
       }
-      if (endpoly) {
+      if (nthreads != 1) {
+        if (endpoly) {
+          boffsets.push_back(blat.size());
+          beol.push_back(eol);
+          eol = "\n";
+          if (blat.size() >= block)
+            flush();
+        } else {
+          blat.push_back(linetype == AUTHALIC ? ellip.AuthalicLatitude(lat) :
+                         lat);
+          blon.push_back(lon);
+        }
+      } else if (endpoly) {
         num =
           linetype == EXACT ? polye.Compute(reverse, sign, perimeter, area) :
           linetype == RHUMB ? polyr.Compute(reverse, sign, perimeter, area) :
           poly.Compute(reverse, sign, perimeter, area); // geodesic + authalic
-        if (num > 0) {
-          *output << num << " " << Utility::str(perimeter, prec);
-          if (!polyline) {
-            *output << " " << Utility::str(area, std::max(0, prec - 5));
-          }
-          *output << eol;
-        }
+        report(num, perimeter, area, eol);
         linetype == EXACT ? polye.Clear() :
           linetype == RHUMB ? polyr.Clear() : poly.Clear();
         eol = "\n";
@@ -221,20 +322,19 @@ int main(int argc, const char* const argv[]) {
                         lat, lon);
       }
     }
-    num =
-      linetype == EXACT ? polye.Compute(reverse, sign, perimeter, area) :
-      linetype == RHUMB ? polyr.Compute(reverse, sign, perimeter, area) :
-      poly.Compute(reverse, sign, perimeter, area);
-    if (num > 0) {
-      *output << num << " " << Utility::str(perimeter, prec);
-      if (!polyline) {
-        *output << " " << Utility::str(area, std::max(0, prec - 5));
-      }
-      *output << eol;
+    if (nthreads != 1) {
+      boffsets.push_back(blat.size());
+      beol.push_back(eol);
+      flush();
+    } else {
+      num =
+        linetype == EXACT ? polye.Compute(reverse, sign, perimeter, area) :
+        linetype == RHUMB ? polyr.Compute(reverse, sign, perimeter, area) :
+        poly.Compute(reverse, sign, perimeter, area);
+      report(num, perimeter, area, eol);
+      linetype == EXACT ? polye.Clear() :
+        linetype == RHUMB ? polyr.Clear() : poly.Clear();
     }
-    linetype == EXACT ? polye.Clear() :
-      linetype == RHUMB ? polyr.Clear() : poly.Clear();
-    eol = "\n";
     return 0;
   }
   catch (const std::exception& e) {
@@ -26,6 +26,7 @@
 #endif
 
 #include "RhumbSolve.usage"
+#include "ToolPipeline.hpp"
 
 using namespace GeographicLib;
 typedef Math::real real;
@@ -51,13 +52,14 @@ int main(int argc, const char* const argv[]) {
   try {
     Utility::set_digits();
     bool linecalc = false, inverse = false, dms = false, exact = true,
-      longfirst = false;
+      longfirst = false, binary = false;
     real
       a = Constants::WGS84_a(),
       f = Constants::WGS84_f();
     real lat1, lon1, azi12 = Math::NaN(), lat2, lon2, s12, S12;
     int prec = 3;
     std::string istring, ifile, ofile, cdelim;
+    unsigned nthreads = 1;
     char lsep = ';', dmssep = char(0);
 
     for (int m = 1; m < argc; ++m) {
@@ -110,6 +112,8 @@ int main(int argc, const char* const argv[]) {
         }
       } else if (arg == "-s")
         exact = false;
+      else if (arg == "--binary")
+        binary = true;
       else if (arg == "--input-string") {
         if (++m == argc) return usage(1, true);
         istring = argv[m];
@@ -129,6 +133,10 @@ int main(int argc, const char* const argv[]) {
       } else if (arg == "--comment-delimiter") {
         if (++m == argc) return usage(1, true);
         cdelim = argv[m];
+      } else if (arg == "-j" || arg == "--threads") {
+        if (++m == argc) return usage(1, true);
+        if (!ToolPipeline::Threads(argv[m], nthreads, std::cerr))
+          return 1;
       } else if (arg == "--version") {
         std::cout << argv[0] << ": GeographicLib version "
                   << GEOGRAPHICLIB_VERSION_STRING << "\n";
@@ -141,11 +149,15 @@ int main(int argc, const char* const argv[]) {
       std::cerr << "Cannot specify --input-string and --input-file together\n";
       return 1;
     }
+    if (binary && !istring.empty()) {
+      std::cerr << "Cannot specify --input-string and --binary together\n";
+      return 1;
+    }
     if (ifile == "-") ifile.clear();
     std::ifstream infile;
     std::istringstream instring;
     if (!ifile.empty()) {
-      infile.open(ifile.c_str());
+      infile.open(ifile.c_str(), binary ? std::ios::binary : std::ios::in);
       if (!infile.is_open()) {
         std::cerr << "Cannot open " << ifile << " for reading\n";
         return 1;
@@ -166,7 +178,7 @@ int main(int argc, const char* const argv[]) {
     std::ofstream outfile;
     if (ofile == "-") ofile.clear();
     if (!ofile.empty()) {
-      outfile.open(ofile.c_str());
+      outfile.open(ofile.c_str(), binary ? std::ios::binary : std::ios::out);
       if (!outfile.is_open()) {
         std::cerr << "Cannot open " << ofile << " for writing\n";
         return 1;
@@ -180,12 +192,45 @@ int main(int argc, const char* const argv[]) {
     // Max precision = 10: 0.1 nm in distance, 10^-15 deg (= 0.11 nm),
     // 10^-11 sec (= 0.3 nm).
     prec = std::min(10 + Math::extra_digits(), std::max(0, prec));
-    std::string s, eol, slat1, slon1, slat2, slon2, sazi, ss12, strc;
-    std::istringstream str;
     int retval = 0;
-    while (std::getline(*input, s)) {
+    if (binary) {
+      // Binary records of little-endian doubles; an error gives a record of
+      // NaNs.
+      real x[4], v[3];
+      while (input->peek() != std::char_traits<char>::eof()) {
+        Utility::readarray<double, real, false>(*input, x, linecalc ? 1 : 4);
+        if (!linecalc) {
+          lat1 = longfirst ? x[1] : x[0]; lon1 = longfirst ? x[0] : x[1];
+          lat2 = longfirst ? x[3] : x[2]; lon2 = longfirst ? x[2] : x[3];
+        }
+        using std::fabs;
+        if (!linecalc && (fabs(lat1) > Math::qd ||
+                          (inverse && fabs(lat2) > Math::qd))) {
+          v[0] = v[1] = v[2] = Math::NaN();
+          retval = 1;
+        } else if (inverse) {
+          rh.Inverse(lat1, lon1, lat2, lon2, s12, azi12, S12);
+          v[0] = azi12; v[1] = s12; v[2] = S12;
+        } else {
+          if (linecalc)
+            rhl.Position(x[0], lat2, lon2, S12);
+          else
+            rh.Direct(lat1, lon1, Math::AngNormalize(x[2]), x[3],
+                      lat2, lon2, S12);
+          v[0] = longfirst ? lon2 : lat2; v[1] = longfirst ? lat2 : lon2;
+          v[2] = S12;
+        }
+        Utility::writearray<double, real, false>(*output, v, 3);
+      }
+      return retval;
+    }
+    // Process a line of input; with -j, this is called concurrently on
+    // several threads.
+    auto process = [&](std::string& s, std::ostream& os) -> int {
+      std::string eol("\n"), slat1, slon1, slat2, slon2, sazi, strc;
+      std::istringstream str;
+      real lat1, lon1, azi12, lat2, lon2, s12, S12;
       try {
-        eol = "\n";
         if (!cdelim.empty()) {
           std::string::size_type m = s.find(cdelim);
           if (m != std::string::npos) {
@@ -200,8 +245,8 @@ int main(int argc, const char* const argv[]) {
           if (str >> strc)
             throw GeographicErr("Extraneous input: " + strc);
           rhl.Position(s12, lat2, lon2, S12);
-          *output << LatLonString(lat2, lon2, prec, dms, dmssep, longfirst)
-                  << " " << Utility::str(S12, std::max(prec-7, 0)) << eol;
+          os << LatLonString(lat2, lon2, prec, dms, dmssep, longfirst)
+             << " " << Utility::str(S12, std::max(prec-7, 0)) << eol;
         } else if (inverse) {
           if (!(str >> slat1 >> slon1 >> slat2 >> slon2))
             throw GeographicErr("Incomplete input: " + s);
@@ -210,9 +255,9 @@ int main(int argc, const char* const argv[]) {
           DMS::DecodeLatLon(slat1, slon1, lat1, lon1, longfirst);
           DMS::DecodeLatLon(slat2, slon2, lat2, lon2, longfirst);
           rh.Inverse(lat1, lon1, lat2, lon2, s12, azi12, S12);
-          *output << AzimuthString(azi12, prec, dms, dmssep) << " "
-                  << Utility::str(s12, prec) << " "
-                  << Utility::str(S12, std::max(prec-7, 0)) << eol;
+          os << AzimuthString(azi12, prec, dms, dmssep) << " "
+             << Utility::str(s12, prec) << " "
+             << Utility::str(S12, std::max(prec-7, 0)) << eol;
         } else {                // direct
           if (!(str >> slat1 >> slon1 >> sazi >> s12))
             throw GeographicErr("Incomplete input: " + s);
@@ -221,17 +266,18 @@ int main(int argc, const char* const argv[]) {
           DMS::DecodeLatLon(slat1, slon1, lat1, lon1, longfirst);
           azi12 = DMS::DecodeAzimuth(sazi);
           rh.Direct(lat1, lon1, azi12, s12, lat2, lon2, S12);
-          *output << LatLonString(lat2, lon2, prec, dms, dmssep, longfirst)
-                  << " " << Utility::str(S12, std::max(prec-7, 0)) << eol;
+          os << LatLonString(lat2, lon2, prec, dms, dmssep, longfirst)
+             << " " << Utility::str(S12, std::max(prec-7, 0)) << eol;
         }
       }
       catch (const std::exception& e) {
         // Write error message cout so output lines match input lines
-        *output << "ERROR: " << e.what() << "\n";
-        retval = 1;
+        os << "ERROR: " << e.what() << "\n";
+        return 1;
       }
-    }
-    return retval;
+      return 0;
+    };
+    return ToolPipeline::ProcessLines(*input, *output, nthreads, process);
   }
   catch (const std::exception& e) {
     std::cerr << "Caught exception: " << e.what() << "\n";
@@ -0,0 +1,171 @@
+/**
+ * \file ToolGrid.hpp
+ * \brief Grid output for the Gravity, MagneticField, and GeoidEval utilities
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_TOOLGRID_HPP)
+#define GEOGRAPHICLIB_TOOLGRID_HPP 1
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <GeographicLib/DMS.hpp>
+#include <GeographicLib/GeodesicBatchExecutor.hpp>
+#include <GeographicLib/Utility.hpp>
+
+namespace ToolGrid {
+
+  typedef GeographicLib::Math::real real;
+
+  /**
+   * A grid of points regularly spaced in latitude and longitude.  The rows
+   * run from north to south and the points in a row run from west to east.
+   **********************************************************************/
+  class Grid {
+  private:
+    static real lat(const std::string& s) {
+      using namespace GeographicLib;
+      using std::fabs;
+      DMS::flag ind;
+      real x = DMS::Decode(s, ind);
+      if (ind == DMS::LONGITUDE)
+        throw GeographicErr("Bad hemisphere letter on latitude " + s);
+      if (!(fabs(x) <= Math::qd))
+        throw GeographicErr("Latitude " + s + " not in [-" +
+                            std::to_string(Math::qd) + "d, " +
+                            std::to_string(Math::qd) + "d]");
+      return x;
+    }
+    static real lon(const std::string& s) {
+      using namespace GeographicLib;
+      DMS::flag ind;
+      real x = DMS::Decode(s, ind);
+      if (ind == DMS::LATITUDE)
+        throw GeographicErr("Bad hemisphere letter on longitude " + s);
+      return x;
+    }
+    // The number of steps of d in x allowing for roundoff
+    static size_t count(real x, real d) {
+      using std::floor;
+      static const real tol = 64 * std::numeric_limits<real>::epsilon();
+      return size_t(floor(x / d * (1 + tol))) + 1;
+    }
+  public:
+    real south, west, north, east, dlat, dlon;
+    size_t nlat, nlon;
+
+    Grid()
+      : south(0), west(0), north(0), east(0), dlat(1), dlon(1)
+      , nlat(0), nlon(0)
+    {}
+
+    /**
+     * Set up the grid from the arguments of --grid.
+     *
+     * @param[in] args the 6 arguments, south west north east dlat dlon.
+     * @exception GeographicErr if the arguments are bad.
+     *
+     * If \e east < \e west, \e east is increased by 360&deg;.  The last row
+     * and column are the last ones which don't go beyond \e south and \e
+     * east.
+     **********************************************************************/
+    void Decode(const char* const args[]) {
+      using namespace GeographicLib;
+      using std::isfinite;
+      south = lat(args[0]); west = lon(args[1]);
+      north = lat(args[2]); east = lon(args[3]);
+      dlat = DMS::DecodeAngle(args[4]); dlon = DMS::DecodeAngle(args[5]);
+      if (!(south <= north))
+        throw GeographicErr("South edge of grid is north of north edge");
+      if (!(isfinite(west) && isfinite(east)))
+        throw GeographicErr("Longitudes of grid must be finite");
+      if (east < west) east += Math::td;
+      if (!(east - west <= Math::td))
+        throw GeographicErr("Grid spans more than " +
+                            std::to_string(Math::td) + "d");
+      if (!(dlat > 0 && dlon > 0))
+        throw GeographicErr("Grid spacings must be positive");
+      nlat = count(north - south, dlat);
+      nlon = count(east - west, dlon);
+    }
+
+    /**
+     * @param[in] i the row.
+     * @return the latitude of row \e i.
+     **********************************************************************/
+    real Lat(size_t i) const {
+      return std::max(south, north - real(i) * dlat);
+    }
+
+    /**
+     * @param[in] j the column.
+     * @return the longitude of column \e j.
+     **********************************************************************/
+    real Lon(size_t j) const { return west + real(j) * dlon; }
+  };
+
+  /**
+   * Compute the rows of a grid, possibly in parallel, and write them out.
+   *
+   * @param[in] out the output stream.
+   * @param[in] grid the grid.
+   * @param[in] nv the number of values for each point.
+   * @param[in] gtx whether to write a GTX file (this requires \e nv = 1).
+   * @param[in] nthreads the number of threads; 0 means use as many as the
+   *   machine supports.
+   * @param[in] row the function which computes a row; row(i, v) sets v[0]
+   *   through v[grid.nlon * nv - 1] for row \e i.
+   * @exception GeographicErr if \e gtx is true and the grid is too big.
+   *
+   * Normally, the output is the rows in order (north to south) as binary
+   * records of little-endian doubles.  If \e gtx is true, the output is in
+   * the GTX format used by NOAA's VDatum: a header giving the south and west
+   * edges and the spacings in latitude and longitude (as big-endian doubles)
+   * and the numbers of rows and columns (as big-endian 32-bit integers),
+   * followed by the rows from south to north as big-endian floats.
+   *
+   * The rows are computed in blocks, with the rows in each block split among
+   * the threads by GeographicLib::GeodesicBatchExecutor; each block is
+   * written out with a single call to writearray before the next one is
+   * started, so that the memory used doesn't depend on the number of rows.
+   * An exception thrown by \e row is passed on.
+   **********************************************************************/
+  template<class F>
+  void Rows(std::ostream& out, const Grid& grid, size_t nv, bool gtx,
+            unsigned nthreads, F&& row) {
+    using namespace GeographicLib;
+    if (gtx) {
+      if (nv != 1 || grid.nlat > 0x7fffffffu || grid.nlon > 0x7fffffffu)
+        throw GeographicErr("Grid cannot be written as a GTX file");
+      real head[] = {grid.Lat(grid.nlat - 1), grid.west,
+                     grid.dlat, grid.dlon};
+      int sizes[] = {int(grid.nlat), int(grid.nlon)};
+      Utility::writearray<double, real, true>(out, head, 4);
+      Utility::writearray<int, int, true>(out, sizes, 2);
+    }
+    GeodesicBatchExecutor exec(nthreads, 1);
+    const size_t nblock = 4 * exec.NumThreads(), nrow = grid.nlon * nv;
+    std::vector<real> v(nblock * nrow);
+    for (size_t i0 = 0; i0 < grid.nlat; i0 += nblock) {
+      size_t n = std::min(nblock, grid.nlat - i0);
+      // The GTX rows run from south to north
+      exec.ForEach(n, [&](size_t k0, size_t k1) -> void {
+        for (size_t k = k0; k < k1; ++k)
+          row(gtx ? grid.nlat - 1 - (i0 + k) : i0 + k, v.data() + k * nrow);
+      });
+      if (gtx)
+        Utility::writearray<float, real, true>(out, v.data(), n * nrow);
+      else
+        Utility::writearray<double, real, false>(out, v.data(), n * nrow);
+    }
+  }
+
+} // namespace ToolGrid
+
+#endif  // GEOGRAPHICLIB_TOOLGRID_HPP
@@ -0,0 +1,168 @@
+/**
+ * \file ToolPipeline.hpp
+ * \brief Parallel processing of the input lines for the command line utilities
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_TOOLPIPELINE_HPP)
+#define GEOGRAPHICLIB_TOOLPIPELINE_HPP 1
+
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <GeographicLib/GeodesicBatchExecutor.hpp>
+#include <GeographicLib/Utility.hpp>
+
+namespace ToolPipeline {
+
+  /**
+   * Decode the argument of -j (the number of threads).
+   *
+   * @param[in] arg the argument.
+   * @param[out] nthreads the number of threads.
+   * @param[in,out] err where to report an error.
+   * @return whether \e arg is a number.
+   **********************************************************************/
+  inline bool Threads(const char* arg, unsigned& nthreads, std::ostream& err) {
+    try {
+      nthreads = GeographicLib::Utility::val<unsigned>(std::string(arg));
+      return true;
+    }
+    catch (const std::exception&) {
+      err << "Number of threads " << arg << " is not a number\n";
+      return false;
+    }
+  }
+
+  /**
+   * Process the lines of the input, possibly in parallel.
+   *
+   * @param[in] in the input stream.
+   * @param[in] out the output stream.
+   * @param[in] nthreads the number of threads; 0 means use as many as the
+   *   machine supports.
+   * @param[in] process the function which handles a line; process(s, os)
+   *   writes the output for the line \e s (with its end of line) to \e os
+   *   and returns 0 on success and 1 on an error.  It may alter \e s.
+   * @return the bitwise or of the values returned by \e process.
+   *
+   * If \e nthreads = 1, the lines are processed one at a time and \e process
+   * writes directly to \e out.  Otherwise, the input is read in blocks of
+   * many lines, the lines in each block are split among the threads by
+   * GeographicLib::GeodesicBatchExecutor, and the outputs are written in the
+   * same order as the input.  In this case, \e process is called
+   * concurrently on several threads, so it should only read shared state,
+   * and its output stream has the same format flags as \e out.
+   **********************************************************************/
+  template<class F>
+  int ProcessLines(std::istream& in, std::ostream& out, unsigned nthreads,
+                   F&& process) {
+    int retval = 0;
+    if (nthreads == 1) {
+      std::string s;
+      while (std::getline(in, s))
+        retval |= process(s, out);
+      return retval;
+    }
+    GeographicLib::GeodesicBatchExecutor exec(nthreads);
+    const size_t nblock = 64 * exec.NumThreads() * exec.ChunkSize();
+    std::vector<std::string> lines(nblock), results(nblock);
+    std::vector<int> errors(nblock);
+    while (true) {
+      size_t n = 0;
+      while (n < nblock && std::getline(in, lines[n]))
+        ++n;
+      if (n == 0) break;
+      exec.ForEach(n, [&](size_t i0, size_t i1) -> void {
+        std::ostringstream os;
+        os.copyfmt(out);
+        for (size_t i = i0; i < i1; ++i) {
+          os.str(std::string());
+          errors[i] = process(lines[i], os);
+          results[i] = os.str();
+        }
+      });
+      for (size_t i = 0; i < n; ++i) {
+        out << results[i];
+        retval |= errors[i];
+      }
+    }
+    return retval;
+  }
+
+  /**
+   * Process the lines of the input in batches, possibly in parallel.
+   *
+   * @param[in] in the input stream.
+   * @param[in] out the output stream.
+   * @param[in] nthreads the number of threads; 0 means use as many as the
+   *   machine supports.
+   * @param[in] nbatch the maximum number of lines in a batch.
+   * @param[in] process the function which handles a batch of lines;
+   *   process(s, n, os) writes the output for the \e n lines \e s[0]
+   *   through \e s[\e n &minus; 1] (each with its end of line) to \e os
+   *   and returns 0 on success and 1 if there was an error on any line.  It
+   *   may alter the lines.
+   * @return the bitwise or of the values returned by \e process.
+   *
+   * This is the same as ProcessLines, except that \e process is given
+   * batches of consecutive lines so that it can use the batch routines of
+   * the library.  If \e nthreads = 1, a batch consists of the next line
+   * together with the following lines which have already been read into
+   * the buffer of \e in; so a line typed interactively is processed
+   * immediately.
+   **********************************************************************/
+  template<class F>
+  int ProcessBatches(std::istream& in, std::ostream& out, unsigned nthreads,
+                     size_t nbatch, F&& process) {
+    int retval = 0;
+    if (nthreads == 1) {
+      std::vector<std::string> lines(nbatch);
+      while (std::getline(in, lines[0])) {
+        size_t n = 1;
+        while (n < nbatch && in.rdbuf()->in_avail() > 0 &&
+               std::getline(in, lines[n]))
+          ++n;
+        retval |= process(lines.data(), n, out);
+      }
+      return retval;
+    }
+    GeographicLib::GeodesicBatchExecutor exec(nthreads);
+    const size_t nblock = 64 * exec.NumThreads() * exec.ChunkSize();
+    std::vector<std::string> lines(nblock), results(nblock);
+    std::vector<int> errors(nblock);
+    while (true) {
+      size_t n = 0;
+      while (n < nblock && std::getline(in, lines[n]))
+        ++n;
+      if (n == 0) break;
+      // The output for the lines [i0, i1) is put in results[i0]
+      exec.ForEach(n, [&](size_t i0, size_t i1) -> void {
+        std::ostringstream os;
+        os.copyfmt(out);
+        for (size_t i = i0; i < i1; ++i)
+          results[i].clear();
+        for (size_t i = i0; i < i1; i += nbatch) {
+          size_t m = std::min(nbatch, i1 - i);
+          os.str(std::string());
+          errors[i] = process(lines.data() + i, m, os);
+          results[i] = os.str();
+          for (size_t j = i + 1; j < i + m; ++j) errors[j] = 0;
+        }
+      });
+      for (size_t i = 0; i < n; ++i) {
+        out << results[i];
+        retval |= errors[i];
+      }
+    }
+    return retval;
+  }
+
+} // namespace ToolPipeline
+
+#endif  // GEOGRAPHICLIB_TOOLPIPELINE_HPP
@@ -0,0 +1,346 @@
+/**
+ * \file ToolServer.hpp
+ * \brief Server mode for the command line utilities
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ *
+ * A utility whose main program is written as a function
+ *   int run(int argc, const char* const argv[],
+ *           std::istream& in, std::ostream& out, std::ostream& err);
+ * and which calls
+ *   return ToolServer::Main(argc, argv, run);
+ * in main accepts two extra options:
+ *
+ * - --serve SOCKET: listen on the Unix-domain socket SOCKET and handle each
+ *   connection by calling run on a pool of threads.  The process lives until
+ *   it is killed, so that data loaded by run (e.g., a geoid) can be kept for
+ *   later requests; ToolServer::Serving() tells run that this is the case.
+ *
+ * - --connect SOCKET: send the rest of the command line and the standard
+ *   input to the server on SOCKET and copy the response to the standard
+ *   output and standard error.  The exit status is the status returned by
+ *   run.
+ *
+ * The request is the number of arguments followed by a newline, the
+ * arguments, each terminated by a null, and then the input (terminated by
+ * shutting down the writing end of the socket).  The response is "status
+ * outlen errlen" followed by a newline, the output, and the error output.
+ * The input and output are held in memory, so this is meant for small
+ * requests such as those made by the cgi-bin scripts; a request must be no
+ * larger than MaxRequest bytes and must arrive within Timeout seconds,
+ * otherwise the connection is dropped.  The server is only available on
+ * POSIX systems.
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_TOOLSERVER_HPP)
+#define GEOGRAPHICLIB_TOOLSERVER_HPP 1
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+#include <chrono>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#if !defined(_WIN32)
+#  include <csignal>
+#  include <sys/socket.h>
+#  include <sys/stat.h>
+#  include <sys/time.h>
+#  include <sys/un.h>
+#  include <unistd.h>
+#endif
+
+namespace ToolServer {
+
+  typedef int (*tool)(int argc, const char* const argv[],
+                      std::istream& in, std::ostream& out, std::ostream& err);
+
+  /**
+   * @return true if the utility is running as a server.  This is set before
+   *   any requests are handled.
+   **********************************************************************/
+  inline bool& Serving() {
+    static bool serving = false;
+    return serving;
+  }
+
+  /**
+   * The largest request (arguments and input) accepted by the server.
+   **********************************************************************/
+  const std::size_t MaxRequest = 16 << 20;
+
+  /**
+   * The time in seconds allowed to read a request or write a response.
+   **********************************************************************/
+  const int Timeout = 10;
+
+#if !defined(_WIN32)
+
+  inline bool writeall(int fd, const char* p, size_t n) {
+    while (n) {
+      ssize_t k = write(fd, p, n);
+      if (k < 0 && errno == EINTR) continue;
+      if (k <= 0) return false;
+      p += k; n -= size_t(k);
+    }
+    return true;
+  }
+
+  // Read from fd until the end of file; fail if more than maxsize bytes are
+  // read or (if timeout > 0) this takes longer than timeout seconds.  The
+  // timeout is only checked between reads, so fd should have SO_RCVTIMEO
+  // set too.
+  inline bool readall(int fd, std::string& s,
+                      std::size_t maxsize = std::string::npos,
+                      int timeout = 0) {
+    typedef std::chrono::steady_clock clock;
+    clock::time_point deadline = clock::now() + std::chrono::seconds(timeout);
+    char buf[65536];
+    while (true) {
+      ssize_t k = read(fd, buf, sizeof(buf));
+      if (k < 0 && errno == EINTR) continue;
+      if (k < 0) return false;
+      if (k == 0) return true;
+      if (size_t(k) > maxsize - s.size()) return false;
+      s.append(buf, size_t(k));
+      if (timeout > 0 && clock::now() > deadline) return false;
+    }
+  }
+
+  inline bool address(const std::string& path, sockaddr_un& addr) {
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path)) {
+      std::cerr << "Socket name " << path << " is too long\n";
+      return false;
+    }
+    std::strcpy(addr.sun_path, path.c_str());
+    return true;
+  }
+
+  // Handle a single request on the connection fd.  A client which is too
+  // slow or sends too much is dropped so that it can't hold up a thread.
+  inline void handle(int fd, const char* prog, tool run) {
+    timeval tv;
+    tv.tv_sec = Timeout; tv.tv_usec = 0;
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+    std::string req;
+    if (!readall(fd, req, MaxRequest, Timeout)) return;
+    std::vector<const char*> argv(1, prog);
+    std::ostringstream out, err;
+    int status = 1;
+    std::string::size_type p = req.find('\n');
+    int nargs = p == std::string::npos ? -1 : std::atoi(req.c_str());
+    bool ok = nargs >= 0;
+    for (int i = 0; ok && i < nargs; ++i) {
+      std::string::size_type q = req.find('\0', ++p);
+      if ((ok = q != std::string::npos)) {
+        argv.push_back(req.c_str() + p);
+        // Files are opened on the client side
+        if (std::strcmp(argv.back(), "--input-file") == 0 ||
+            std::strcmp(argv.back(), "--output-file") == 0) {
+          err << argv.back() << " cannot be used with --connect\n";
+          nargs = -1;
+        }
+        p = q;
+      }
+    }
+    if (!ok)
+      err << "Malformed request\n";
+    else if (nargs >= 0) {
+      std::istringstream in(req.substr(p + 1));
+      try {
+        status = run(int(argv.size()), argv.data(), in, out, err);
+      }
+      catch (const std::exception& e) {
+        err << "Caught exception: " << e.what() << "\n";
+      }
+    }
+    std::string o = out.str(), e = err.str(),
+      head = std::to_string(status) + " " + std::to_string(o.size()) + " " +
+      std::to_string(e.size()) + "\n";
+    if (writeall(fd, head.data(), head.size()) &&
+        writeall(fd, o.data(), o.size()))
+      writeall(fd, e.data(), e.size());
+  }
+
+  inline int Serve(const char* prog, const std::string& path, tool run) {
+    sockaddr_un addr;
+    if (!address(path, addr)) return 1;
+    // A client going away shouldn't kill the server
+    std::signal(SIGPIPE, SIG_IGN);
+    int s = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (s < 0) {
+      std::cerr << "Cannot create socket: " << std::strerror(errno) << "\n";
+      return 1;
+    }
+    // Remove a socket left by a previous server (but not any other file)
+    struct stat st;
+    if (lstat(path.c_str(), &st) == 0 && S_ISSOCK(st.st_mode))
+      unlink(path.c_str());
+    if (bind(s, (const sockaddr*)(&addr), sizeof(addr)) != 0 ||
+        listen(s, 64) != 0) {
+      std::cerr << "Cannot listen on " << path << ": "
+                << std::strerror(errno) << "\n";
+      close(s);
+      return 1;
+    }
+    Serving() = true;
+    std::mutex m;
+    std::condition_variable cv;
+    std::deque<int> queue;
+    bool done = false;
+    unsigned nthreads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::thread> pool;
+    for (unsigned k = 0; k < nthreads; ++k)
+      pool.emplace_back([&]() -> void {
+        while (true) {
+          int fd;
+          {
+            std::unique_lock<std::mutex> lock(m);
+            cv.wait(lock, [&]() -> bool { return done || !queue.empty(); });
+            if (queue.empty()) return;
+            fd = queue.front(); queue.pop_front();
+          }
+          handle(fd, prog, run);
+          close(fd);
+        }
+      });
+    int retval = 0;
+    while (true) {
+      int fd = accept(s, nullptr, nullptr);
+      if (fd < 0) {
+        if (errno == EINTR || errno == ECONNABORTED) continue;
+        std::cerr << "Cannot accept connection: "
+                  << std::strerror(errno) << "\n";
+        retval = 1;
+        break;
+      }
+      {
+        std::lock_guard<std::mutex> lock(m);
+        queue.push_back(fd);
+      }
+      cv.notify_one();
+    }
+    {
+      std::lock_guard<std::mutex> lock(m);
+      done = true;
+    }
+    cv.notify_all();
+    for (auto& t : pool) t.join();
+    close(s);
+    return retval;
+  }
+
+  inline int Connect(const std::string& path,
+                     const std::vector<const char*>& args) {
+    sockaddr_un addr;
+    if (!address(path, addr)) return 1;
+    std::string req = std::to_string(args.size()) + "\n";
+    for (const char* a : args) {
+      req += a; req += '\0';
+    }
+    // Read the input before connecting so as not to hold up the server
+    std::string input, resp;
+    if (!readall(0, input, MaxRequest - std::min(req.size(), MaxRequest))) {
+      std::cerr << "Input too large or unreadable for --connect\n";
+      return 1;
+    }
+    int s = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (s < 0 || connect(s, (const sockaddr*)(&addr), sizeof(addr)) != 0) {
+      std::cerr << "Cannot connect to " << path << ": "
+                << std::strerror(errno) << "\n";
+      if (s >= 0) close(s);
+      return 1;
+    }
+    bool ok = writeall(s, req.data(), req.size()) &&
+      writeall(s, input.data(), input.size()) &&
+      shutdown(s, SHUT_WR) == 0 &&
+      readall(s, resp);
+    close(s);
+    int status = 1;
+    unsigned long long olen = 0, elen = 0;
+    std::string::size_type p = resp.find('\n');
+    if (ok && p != std::string::npos) {
+      std::istringstream head(resp.substr(0, p));
+      ok = bool(head >> status >> olen >> elen) &&
+        resp.size() == p + 1 + olen + elen;
+    } else
+      ok = false;
+    if (!ok) {
+      std::cerr << "Bad response from " << path << "\n";
+      return 1;
+    }
+    std::cout.write(resp.data() + p + 1, std::streamsize(olen));
+    std::cerr.write(resp.data() + p + 1 + olen, std::streamsize(elen));
+    return status;
+  }
+
+#else
+
+  inline int Serve(const char*, const std::string&, tool) {
+    std::cerr << "--serve is not supported on this platform\n";
+    return 1;
+  }
+
+  inline int Connect(const std::string&, const std::vector<const char*>&) {
+    std::cerr << "--connect is not supported on this platform\n";
+    return 1;
+  }
+
+#endif
+
+  /**
+   * The main program for a utility which supports --serve and --connect.
+   *
+   * @param[in] argc the number of arguments.
+   * @param[in] argv the arguments.
+   * @param[in] run the utility.
+   * @return the exit status.
+   *
+   * --help and --version are handled locally even with --connect.
+   **********************************************************************/
+  inline int Main(int argc, const char* const argv[], tool run) {
+    std::string serve, connect;
+    std::vector<const char*> args;
+    bool local = false;
+    for (int m = 1; m < argc; ++m) {
+      std::string arg(argv[m]);
+      if ((arg == "--serve" || arg == "--connect") && m + 1 < argc)
+        (arg == "--serve" ? serve : connect) = argv[++m];
+      else {
+        local = local || arg == "-h" || arg == "--help" || arg == "--version";
+        args.push_back(argv[m]);
+      }
+    }
+    if (!serve.empty()) {
+      if (!connect.empty() || !args.empty()) {
+        std::cerr << "--serve must be the only option\n";
+        return 1;
+      }
+      return Serve(argv[0], serve, run);
+    }
+    if (!connect.empty() && !local)
+      return Connect(connect, args);
+    args.insert(args.begin(), argv[0]);
+    // The utilities only use the C++ streams.  Unsynchronized with C stdio,
+    // std::cin is buffered and its in_avail() counts the input which can be
+    // read without waiting (see ToolPipeline::ProcessBatches).
+    std::ios::sync_with_stdio(false);
+    return run(int(args.size()), args.data(), std::cin, std::cout, std::cerr);
+  }
+
+} // namespace ToolServer
+
+#endif  // GEOGRAPHICLIB_TOOLSERVER_HPP
@@ -0,0 +1,199 @@
+/**
+ * \file ToolStats.hpp
+ * \brief Throughput statistics for the command line utilities
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_TOOLSTATS_HPP)
+#define GEOGRAPHICLIB_TOOLSTATS_HPP 1
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <GeographicLib/Histogram.hpp>
+
+namespace ToolStats {
+
+  /**
+   * The phases of the processing of a line which are timed.
+   **********************************************************************/
+  enum phase { PARSE = 0, COMPUTE, FORMAT, IO, NPHASES };
+
+  /**
+   * \brief The statistics collected with --stats
+   *
+   * The times for the phases are accumulated over all the threads (so, with
+   * -j, they may exceed the elapsed time).  All the member functions may be
+   * called concurrently.  If the statistics are turned off, the member
+   * functions do nothing.
+   **********************************************************************/
+  class Stats {
+  public:
+    typedef std::chrono::steady_clock clock;
+
+    /**
+     * Constructor.
+     *
+     * @param[in] on whether to collect the statistics.
+     **********************************************************************/
+    explicit Stats(bool on = false) { Start(on); }
+
+    /**
+     * Reset the statistics and start the clock for the elapsed time.
+     *
+     * @param[in] on whether to collect the statistics.
+     **********************************************************************/
+    void Start(bool on) {
+      _on = on;
+      for (int p = 0; p < NPHASES; ++p) _ns[p] = 0;
+      _lines = _errors = 0;
+      _start = clock::now();
+    }
+
+    /**
+     * @return whether the statistics are being collected.
+     **********************************************************************/
+    bool On() const { return _on; }
+
+    /**
+     * Add to the time for a phase.
+     *
+     * @param[in] p the phase.
+     * @param[in] d the time.
+     **********************************************************************/
+    void Add(phase p, clock::duration d) {
+      if (_on)
+        _ns[p].fetch_add
+          (std::chrono::duration_cast<std::chrono::nanoseconds>(d).count(),
+           std::memory_order_relaxed);
+    }
+
+    /**
+     * Count lines (or binary records) of input.
+     *
+     * @param[in] n the number of lines.
+     * @param[in] nerr the number of these which gave errors.
+     **********************************************************************/
+    void Lines(unsigned long long n, unsigned long long nerr = 0) {
+      if (_on) {
+        _lines.fetch_add(n, std::memory_order_relaxed);
+        _errors.fetch_add(nerr, std::memory_order_relaxed);
+      }
+    }
+
+    /**
+     * Print the statistics.
+     *
+     * @param[in] name the name of the utility.
+     * @param[in] nthreads the number of threads used.
+     * @param[in,out] err the stream to print to.
+     *
+     * Besides the throughput and the times for the phases, this prints the
+     * elapsed time not accounted for by the phases (divided among the
+     * threads); this is dominated by reading and writing the data unless
+     * they are timed separately.
+     **********************************************************************/
+    void Report(const std::string& name, unsigned nthreads,
+                std::ostream& err) const {
+      if (!_on) return;
+      static const char* const names[NPHASES] =
+        {"parse", "compute", "format", "i/o"};
+      double wall = std::chrono::duration<double>(clock::now() - _start)
+        .count(), t[NPHASES], tot = 0;
+      for (int p = 0; p < NPHASES; ++p)
+        tot += (t[p] = double(_ns[p].load()) * 1e-9);
+      char buf[128];
+      std::snprintf(buf, sizeof(buf),
+                    "%s: %llu lines (%llu errors) in %.3f s, %.0f lines/s,"
+                    " %u thread%s\n",
+                    name.c_str(), _lines.load(), _errors.load(), wall,
+                    wall > 0 ? double(_lines.load()) / wall : 0.0,
+                    nthreads, nthreads == 1 ? "" : "s");
+      err << buf;
+      for (int p = 0; p < NPHASES; ++p) {
+        if (p == IO && t[p] == 0) continue;
+        std::snprintf(buf, sizeof(buf), "  %-8s %10.3f s %6.1f%%\n",
+                      names[p], t[p], tot > 0 ? 100 * t[p] / tot : 0.0);
+        err << buf;
+      }
+      std::snprintf(buf, sizeof(buf), "  %-8s %10.3f s\n", "other",
+                    std::max(0.0, wall - tot / std::max(1u, nthreads)));
+      err << buf;
+    }
+
+    /**
+     * Print a histogram.
+     *
+     * @param[in] title the title.
+     * @param[in] h the histogram.
+     * @param[in,out] err the stream to print to.
+     *
+     * Only the non-empty bins are printed.
+     **********************************************************************/
+    void Report(const std::string& title,
+                const GeographicLib::Histogram& h, std::ostream& err) const {
+      if (!_on) return;
+      std::vector<unsigned long long> b = h.Bins();
+      unsigned long long tot = h.Total();
+      char buf[128];
+      std::snprintf(buf, sizeof(buf), "  %s: %llu calls, mean %.3f\n",
+                    title.c_str(), tot, h.Mean());
+      err << buf;
+      for (size_t k = 0; k < b.size(); ++k) {
+        if (b[k] == 0) continue;
+        std::snprintf(buf, sizeof(buf), "    %2u %12llu %6.2f%%\n",
+                      unsigned(k), b[k], 100 * double(b[k]) / double(tot));
+        err << buf;
+      }
+    }
+
+  private:
+    bool _on;
+    std::atomic<unsigned long long> _ns[NPHASES], _lines, _errors;
+    clock::time_point _start;
+  };
+
+  /**
+   * \brief A stopwatch for timing the phases
+   *
+   * Each call to Mark charges the time since the previous call (or the
+   * construction) to a phase.
+   **********************************************************************/
+  class Lap {
+  public:
+    /**
+     * Constructor, which starts the stopwatch.
+     *
+     * @param[in] s the statistics to add the times to.
+     **********************************************************************/
+    explicit Lap(Stats& s)
+      : _s(s), _t(s.On() ? Stats::clock::now() : Stats::clock::time_point())
+    {}
+
+    /**
+     * Charge the time since the previous mark to a phase.
+     *
+     * @param[in] p the phase.
+     **********************************************************************/
+    void Mark(phase p) {
+      if (!_s.On()) return;
+      Stats::clock::time_point t = Stats::clock::now();
+      _s.Add(p, t - _t);
+      _t = t;
+    }
+
+  private:
+    Stats& _s;
+    Stats::clock::time_point _t;
+  };
+
+} // namespace ToolStats
+
+#endif  // GEOGRAPHICLIB_TOOLSTATS_HPP
@@ -26,6 +26,7 @@
 #endif
 
 #include "TransverseMercatorProj.usage"
+#include "ToolPipeline.hpp"
 
 int main(int argc, const char* const argv[]) {
   try {
@@ -41,6 +42,7 @@ int main(int argc, const char* const argv[]) {
       lon0 = 0;
     int prec = 6;
     std::string istring, ifile, ofile, cdelim;
+    unsigned nthreads = 1;
     char lsep = ';';
 
     for (int m = 1; m < argc; ++m) {
@@ -120,6 +122,10 @@ int main(int argc, const char* const argv[]) {
       } else if (arg == "--comment-delimiter") {
         if (++m == argc) return usage(1, true);
         cdelim = argv[m];
+      } else if (arg == "-j" || arg == "--threads") {
+        if (++m == argc) return usage(1, true);
+        if (!ToolPipeline::Threads(argv[m], nthreads, std::cerr))
+          return 1;
       } else if (arg == "--version") {
         std::cout << argv[0] << ": GeographicLib version "
                   << GEOGRAPHICLIB_VERSION_STRING << "\n";
@@ -175,13 +181,13 @@ int main(int argc, const char* const argv[]) {
     // Max precision = 10: 0.1 nm in distance, 10^-15 deg (= 0.11 nm),
     // 10^-11 sec (= 0.3 nm).
     prec = std::min(10 + Math::extra_digits(), std::max(0, prec));
-    std::string s, eol, stra, strb, strc;
-    std::istringstream str;
-    int retval = 0;
     std::cout << std::fixed;
-    while (std::getline(*input, s)) {
+    // Process a line of input; with -j, this is called concurrently on
+    // several threads.
+    auto process = [&](std::string& s, std::ostream& os) -> int {
+      std::string eol("\n"), stra, strb, strc;
+      std::istringstream str;
       try {
-        eol = "\n";
         if (!cdelim.empty()) {
           std::string::size_type m = s.find(cdelim);
           if (m != std::string::npos) {
@@ -206,27 +212,28 @@ int main(int argc, const char* const argv[]) {
             TMS.Reverse(lon0, x, y, lat, lon, gamma, k);
           else
             TME.Reverse(lon0, x, y, lat, lon, gamma, k);
-          *output << Utility::str(longfirst ? lon : lat, prec + 5) << " "
-                  << Utility::str(longfirst ? lat : lon, prec + 5) << " "
-                  << Utility::str(gamma, prec + 6) << " "
-                  << Utility::str(k, prec + 6) << eol;
+          os << Utility::str(longfirst ? lon : lat, prec + 5) << " "
+             << Utility::str(longfirst ? lat : lon, prec + 5) << " "
+             << Utility::str(gamma, prec + 6) << " "
+             << Utility::str(k, prec + 6) << eol;
         } else {
           if (series)
             TMS.Forward(lon0, lat, lon, x, y, gamma, k);
           else
             TME.Forward(lon0, lat, lon, x, y, gamma, k);
-          *output << Utility::str(x, prec) << " "
-                  << Utility::str(y, prec) << " "
-                  << Utility::str(gamma, prec + 6) << " "
-                  << Utility::str(k, prec + 6) << eol;
+          os << Utility::str(x, prec) << " "
+             << Utility::str(y, prec) << " "
+             << Utility::str(gamma, prec + 6) << " "
+             << Utility::str(k, prec + 6) << eol;
         }
       }
       catch (const std::exception& e) {
-        *output << "ERROR: " << e.what() << "\n";
-        retval = 1;
+        os << "ERROR: " << e.what() << "\n";
+        return 1;
       }
-    }
-    return retval;
+      return 0;
+    };
+    return ToolPipeline::ProcessLines(*input, *output, nthreads, process);
   }
   catch (const std::exception& e) {
     std::cerr << "Caught exception: " << e.what() << "\n";
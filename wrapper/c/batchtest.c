@@ -0,0 +1,62 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "cbatch.h"
+
+#if defined(_MSC_VER)
+/* Squelch warnings about scanf */
+#  pragma warning (disable: 4996)
+#endif
+
+/* Read lines of lat1 lon1 lat2 lon2 and print s12 azi1 azi2 for the
+   geodesic between the points, the UTM/UPS coordinates of the first point,
+   and the geoid height at the first point (if the egm96-5 geoid is
+   installed).  All the lines are read before the arrays are processed. */
+int main() {
+  size_t n = 0, cap = 0, i;
+  double *lat1 = NULL, *lon1 = NULL, *lat2 = NULL, *lon2 = NULL,
+    *s12, *azi1, *azi2, *x, *y, *h;
+  int *zone, *northp;
+  double a, b, c, d;
+  cbatch_geodesic* g;
+  cbatch_geoid* geoid;
+  while (scanf("%lf %lf %lf %lf", &a, &b, &c, &d) == 4) {
+    if (n == cap) {
+      cap = cap ? 2 * cap : 64;
+      lat1 = realloc(lat1, cap * sizeof(double));
+      lon1 = realloc(lon1, cap * sizeof(double));
+      lat2 = realloc(lat2, cap * sizeof(double));
+      lon2 = realloc(lon2, cap * sizeof(double));
+      if (!(lat1 && lon1 && lat2 && lon2)) return 1;
+    }
+    lat1[n] = a; lon1[n] = b; lat2[n] = c; lon2[n] = d; ++n;
+  }
+  s12 = malloc((n + 1) * sizeof(double));
+  azi1 = malloc((n + 1) * sizeof(double));
+  azi2 = malloc((n + 1) * sizeof(double));
+  x = malloc((n + 1) * sizeof(double));
+  y = malloc((n + 1) * sizeof(double));
+  h = malloc((n + 1) * sizeof(double));
+  zone = malloc((n + 1) * sizeof(int));
+  northp = malloc((n + 1) * sizeof(int));
+  if (!(s12 && azi1 && azi2 && x && y && h && zone && northp)) return 1;
+  /* WGS84 */
+  g = cbatch_geodesic_new(6378137, 1/298.257223563);
+  cbatch_inverse(g, n, lat1, lon1, lat2, lon2, s12, azi1, azi2);
+  cbatch_utm_forward(n, lat1, lon1, zone, northp, x, y);
+  geoid = cbatch_geoid_new("egm96-5", NULL, 0);
+  if (geoid)
+    cbatch_geoid_height(geoid, n, lat1, lon1, h);
+  for (i = 0; i < n; ++i) {
+    printf("%.3f %.8f %.8f %d%c %.3f %.3f", s12[i], azi1[i], azi2[i],
+           zone[i], northp[i] ? 'n' : 's', x[i], y[i]);
+    if (geoid)
+      printf(" %.3f", h[i]);
+    printf("\n");
+  }
+  cbatch_geoid_free(geoid);
+  cbatch_geodesic_free(g);
+  free(lat1); free(lon1); free(lat2); free(lon2);
+  free(s12); free(azi1); free(azi2); free(x); free(y); free(h);
+  free(zone); free(northp);
+  return 0;
+}
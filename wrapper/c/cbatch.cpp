@@ -0,0 +1,186 @@
+#include "cbatch.h"
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include "GeographicLib/Geodesic.hpp"
+#include "GeographicLib/UTMUPS.hpp"
+#include "GeographicLib/Geoid.hpp"
+
+using namespace GeographicLib;
+
+// The arrays are passed straight through to the batch routines
+static_assert(std::is_same<Math::real, double>::value,
+              "GeographicLib must be compiled with doubles");
+
+struct cbatch_geodesic {
+  Geodesic g;
+  cbatch_geodesic(double a, double f) : g(a, f) {}
+};
+
+struct cbatch_geoid {
+  Geoid g;
+  cbatch_geoid(const char* name, const char* path, bool threadsafe)
+    : g(name, path ? path : "", true, threadsafe) {}
+};
+
+static void fillnan(size_t n, double x[]) {
+  if (x)
+    for (size_t i = 0; i < n; ++i) x[i] = Math::NaN();
+}
+
+extern "C"
+cbatch_geodesic* cbatch_geodesic_new(double a, double f) {
+  try {
+    return new cbatch_geodesic(a, f);
+  }
+  catch (...) {
+    return nullptr;
+  }
+}
+
+extern "C"
+void cbatch_geodesic_free(cbatch_geodesic* g) {
+  delete g;
+}
+
+extern "C"
+size_t cbatch_inverse(const cbatch_geodesic* g, size_t n,
+                      const double lat1[], const double lon1[],
+                      const double lat2[], const double lon2[],
+                      double s12[], double azi1[], double azi2[]) {
+  try {
+    g->g.InverseBatch(n, lat1, lon1, lat2, lon2, Geodesic::ALL,
+                      nullptr, s12, azi1, azi2,
+                      nullptr, nullptr, nullptr, nullptr);
+    return 0;
+  }
+  catch (...) {
+    fillnan(n, s12); fillnan(n, azi1); fillnan(n, azi2);
+    return n;
+  }
+}
+
+extern "C"
+size_t cbatch_direct(const cbatch_geodesic* g, size_t n,
+                     const double lat1[], const double lon1[],
+                     const double azi1[], const double s12[],
+                     double lat2[], double lon2[], double azi2[]) {
+  try {
+    g->g.DirectBatch(n, lat1, lon1, azi1, false, s12, Geodesic::ALL,
+                     nullptr, lat2, lon2, azi2,
+                     nullptr, nullptr, nullptr, nullptr, nullptr);
+    return 0;
+  }
+  catch (...) {
+    fillnan(n, lat2); fillnan(n, lon2); fillnan(n, azi2);
+    return n;
+  }
+}
+
+extern "C"
+size_t cbatch_utm_forward(size_t n, const double lat[], const double lon[],
+                          int zone[], int northp[],
+                          double x[], double y[]) {
+  try {
+    std::unique_ptr<int[]> tzone(zone ? nullptr : new int[n]);
+    std::unique_ptr<bool[]> tnorthp(new bool[n]);
+    std::unique_ptr<double[]>
+      tx(x ? nullptr : new double[n]), ty(y ? nullptr : new double[n]);
+    int* z = zone ? zone : tzone.get();
+    double* xx = x ? x : tx.get(), * yy = y ? y : ty.get();
+    size_t bad = 0;
+    try {
+      UTMUPS::ForwardBatch(n, lat, lon, z, tnorthp.get(), xx, yy);
+    }
+    catch (const GeographicErr&) {
+      // Some point is out of range; redo the points one at a time.
+      for (size_t i = 0; i < n; ++i) {
+        try {
+          UTMUPS::Forward(lat[i], lon[i], z[i], tnorthp[i], xx[i], yy[i]);
+        }
+        catch (const GeographicErr&) {
+          z[i] = UTMUPS::INVALID; tnorthp[i] = false;
+          xx[i] = yy[i] = Math::NaN();
+          ++bad;
+        }
+      }
+    }
+    if (northp)
+      for (size_t i = 0; i < n; ++i) northp[i] = tnorthp[i] ? 1 : 0;
+    return bad;
+  }
+  catch (...) {
+    if (zone)
+      for (size_t i = 0; i < n; ++i) zone[i] = UTMUPS::INVALID;
+    if (northp)
+      for (size_t i = 0; i < n; ++i) northp[i] = 0;
+    fillnan(n, x); fillnan(n, y);
+    return n;
+  }
+}
+
+extern "C"
+size_t cbatch_utm_reverse(size_t n, const int zone[], const int northp[],
+                          const double x[], const double y[],
+                          double lat[], double lon[]) {
+  size_t bad = 0;
+  for (size_t i = 0; i < n; ++i) {
+    double tlat, tlon;
+    try {
+      UTMUPS::Reverse(zone[i], northp[i] != 0, x[i], y[i], tlat, tlon);
+    }
+    catch (const GeographicErr&) {
+      tlat = tlon = Math::NaN();
+      ++bad;
+    }
+    if (lat) lat[i] = tlat;
+    if (lon) lon[i] = tlon;
+  }
+  return bad;
+}
+
+extern "C"
+cbatch_geoid* cbatch_geoid_new(const char* name, const char* path,
+                               int threadsafe) {
+  try {
+    return new cbatch_geoid(name, path, threadsafe != 0);
+  }
+  catch (...) {
+    return nullptr;
+  }
+}
+
+extern "C"
+void cbatch_geoid_free(cbatch_geoid* g) {
+  delete g;
+}
+
+extern "C"
+size_t cbatch_geoid_height(const cbatch_geoid* g, size_t n,
+                           const double lat[], const double lon[],
+                           double h[]) {
+  if (!h) return 0;
+  try {
+    g->g.HeightBatch(n, lat, lon, h);
+    return 0;
+  }
+  catch (const GeographicErr&) {
+    // Some point is outside the cached area or the data couldn't be read;
+    // redo the points one at a time.
+    size_t bad = 0;
+    for (size_t i = 0; i < n; ++i) {
+      try {
+        h[i] = g->g(lat[i], lon[i]);
+      }
+      catch (const GeographicErr&) {
+        h[i] = Math::NaN();
+        ++bad;
+      }
+    }
+    return bad;
+  }
+  catch (...) {
+    fillnan(n, h);
+    return n;
+  }
+}
@@ -0,0 +1,80 @@
+#if !defined(CBATCH_H)
+#define CBATCH_H 1
+
+/*
+ * Array versions of the geodesic, UTM/UPS, and geoid calculations for
+ * calling GeographicLib from C (and from languages, such as Go and Rust,
+ * which bind to C).  Each call handles n points, so the cost of crossing the
+ * language boundary is paid once per array instead of once per point.  The
+ * Geodesic and Geoid objects are held in opaque handles which are created
+ * once and reused.
+ *
+ * All the arrays have (at least) n elements.  The functions which process
+ * arrays return the number of points which failed; for these the outputs are
+ * NaN (and the zone is -4).  A point fails if it is out of range (for UTM/UPS
+ * and the geoid) or if memory runs out (then all n points fail); NaN inputs
+ * just give NaN outputs.  Output arrays may be NULL if the corresponding
+ * quantity isn't needed.  The handles are not modified by the calculations,
+ * so a handle may be used concurrently by several threads (for a geoid
+ * handle this requires threadsafe = 1 when it is created).
+ */
+
+#include <stddef.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+  typedef struct cbatch_geodesic cbatch_geodesic;
+  typedef struct cbatch_geoid cbatch_geoid;
+
+  /* Create a geodesic handle for the ellipsoid with equatorial radius a and
+     flattening f.  Returns NULL if a or f is illegal. */
+  cbatch_geodesic* cbatch_geodesic_new(double a, double f);
+  void cbatch_geodesic_free(cbatch_geodesic* g);
+
+  /* Solve the inverse geodesic problem for each point (lat1, lon1, lat2,
+     lon2) giving the distance s12 and the azimuths azi1 and azi2. */
+  size_t cbatch_inverse(const cbatch_geodesic* g, size_t n,
+                        const double lat1[], const double lon1[],
+                        const double lat2[], const double lon2[],
+                        double s12[], double azi1[], double azi2[]);
+
+  /* Solve the direct geodesic problem for each point (lat1, lon1, azi1,
+     s12) giving the position lat2, lon2 and the azimuth azi2. */
+  size_t cbatch_direct(const cbatch_geodesic* g, size_t n,
+                       const double lat1[], const double lon1[],
+                       const double azi1[], const double s12[],
+                       double lat2[], double lon2[], double azi2[]);
+
+  /* Convert geographic coordinates to UTM/UPS in the standard zone; northp
+     is set to 1 for the northern hemisphere and 0 for the southern. */
+  size_t cbatch_utm_forward(size_t n, const double lat[], const double lon[],
+                            int zone[], int northp[],
+                            double x[], double y[]);
+
+  /* Convert UTM/UPS coordinates to geographic (zone = 0 denotes UPS). */
+  size_t cbatch_utm_reverse(size_t n, const int zone[], const int northp[],
+                            const double x[], const double y[],
+                            double lat[], double lon[]);
+
+  /* Create a geoid handle for the geoid model called name, e.g.,
+     "egm2008-1", in the directory path (NULL or "" for the default).  If
+     threadsafe is nonzero, the whole data file is read into memory so that
+     the handle can be used by several threads at once.  Returns NULL if the
+     data can't be read. */
+  cbatch_geoid* cbatch_geoid_new(const char* name, const char* path,
+                                 int threadsafe);
+  void cbatch_geoid_free(cbatch_geoid* g);
+
+  /* Compute the height of the geoid above the ellipsoid at each point (lat,
+     lon). */
+  size_t cbatch_geoid_height(const cbatch_geoid* g, size_t n,
+                             const double lat[], const double lon[],
+                             double h[]);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif  /* CBATCH_H */
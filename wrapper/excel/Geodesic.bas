@@ -23,6 +23,28 @@ Private Declare PtrSafe Sub rinverse Lib "cgeodesic.dll" _
  ByVal lat2 As Double, ByVal lon2 As Double, _
  ByRef s12 As Double, ByRef azi12 As Double)
 
+'   The array versions; pass the first element of each array
+
+Private Declare PtrSafe Sub gdirectarray Lib "cgeodesic.dll" _
+(ByVal n As Long, ByRef lat1 As Double, ByRef lon1 As Double, _
+ ByRef azi1 As Double, ByRef s12 As Double, _
+ ByRef lat2 As Double, ByRef lon2 As Double, ByRef azi2 As Double)
+
+Private Declare PtrSafe Sub ginversearray Lib "cgeodesic.dll" _
+(ByVal n As Long, ByRef lat1 As Double, ByRef lon1 As Double, _
+ ByRef lat2 As Double, ByRef lon2 As Double, _
+ ByRef s12 As Double, ByRef azi1 As Double, ByRef azi2 As Double)
+
+Private Declare PtrSafe Sub rdirectarray Lib "cgeodesic.dll" _
+(ByVal n As Long, ByRef lat1 As Double, ByRef lon1 As Double, _
+ ByRef azi12 As Double, ByRef s12 As Double, _
+ ByRef lat2 As Double, ByRef lon2 As Double)
+
+Private Declare PtrSafe Sub rinversearray Lib "cgeodesic.dll" _
+(ByVal n As Long, ByRef lat1 As Double, ByRef lon1 As Double, _
+ ByRef lat2 As Double, ByRef lon2 As Double, _
+ ByRef s12 As Double, ByRef azi12 As Double)
+
 '   Define the custom worksheet functions that call the DLL functions
 
 Function geodesic_direct_lat2(lat1 As Double, lon1 As Double, _
@@ -130,3 +152,165 @@ Function rhumb_inverse_azi12(lat1 As Double, lon1 As Double, _
   Call rinverse(lat1, lon1, lat2, lon2, s12, azi12)
   rhumb_inverse_azi12 = azi12
 End Function
+
+'   Helper functions for the array versions
+
+'   The values of a range (or an array or a single value) as a 0-based
+'   array of doubles; empty cells give 0
+Private Function ToDoubles(x As Variant) As Double()
+  Dim v As Variant
+  Dim e As Variant
+  Dim d() As Double
+  Dim i As Long
+  v = x
+  If Not IsArray(v) Then
+    ReDim d(0 To 0)
+    d(0) = v
+  Else
+    i = 0
+    For Each e In v
+      i = i + 1
+    Next e
+    ReDim d(0 To i - 1)
+    i = 0
+    For Each e In v
+      d(i) = e
+      i = i + 1
+    Next e
+  End If
+  ToDoubles = d
+End Function
+
+'   The number of elements in a 0-based array
+Private Function NumDoubles(d() As Double) As Long
+  NumDoubles = UBound(d) + 1
+End Function
+
+'   Arrange n-element arrays as the columns of an n-row result
+Private Function ToColumns(n As Long, ParamArray cols() As Variant) _
+  As Variant
+  Dim r() As Variant
+  Dim i As Long
+  Dim j As Long
+  ReDim r(1 To n, 1 To UBound(cols) + 1)
+  For j = 0 To UBound(cols)
+    For i = 1 To n
+      r(i, j + 1) = cols(j)(i - 1)
+    Next i
+  Next j
+  ToColumns = r
+End Function
+
+'   The array versions of the worksheet functions.  Each argument is a
+'   column of values (all the same length); all the points are handled in
+'   one call to the DLL which uses all the available threads.  The results
+'   are returned as the columns of an array formula (or a dynamic array
+'   which spills into the neighboring cells).
+
+Function geodesic_direct_array(lat1 As Variant, lon1 As Variant, _
+                               azi1 As Variant, s12 As Variant) As Variant
+  Attribute geodesic_direct_array.VB_Description = _
+    "Solves direct geodesic problem for columns of lat2, lon2, azi2."
+  Dim a() As Double
+  Dim b() As Double
+  Dim c() As Double
+  Dim d() As Double
+  Dim lat2() As Double
+  Dim lon2() As Double
+  Dim azi2() As Double
+  Dim n As Long
+  a = ToDoubles(lat1)
+  b = ToDoubles(lon1)
+  c = ToDoubles(azi1)
+  d = ToDoubles(s12)
+  n = NumDoubles(a)
+  If NumDoubles(b) <> n Or NumDoubles(c) <> n Or NumDoubles(d) <> n Then
+    geodesic_direct_array = CVErr(xlErrValue)
+    Exit Function
+  End If
+  ReDim lat2(0 To n - 1)
+  ReDim lon2(0 To n - 1)
+  ReDim azi2(0 To n - 1)
+  Call gdirectarray(n, a(0), b(0), c(0), d(0), lat2(0), lon2(0), azi2(0))
+  geodesic_direct_array = ToColumns(n, lat2, lon2, azi2)
+End Function
+
+Function geodesic_inverse_array(lat1 As Variant, lon1 As Variant, _
+                                lat2 As Variant, lon2 As Variant) As Variant
+  Attribute geodesic_inverse_array.VB_Description = _
+    "Solves inverse geodesic problem for columns of s12, azi1, azi2."
+  Dim a() As Double
+  Dim b() As Double
+  Dim c() As Double
+  Dim d() As Double
+  Dim s12() As Double
+  Dim azi1() As Double
+  Dim azi2() As Double
+  Dim n As Long
+  a = ToDoubles(lat1)
+  b = ToDoubles(lon1)
+  c = ToDoubles(lat2)
+  d = ToDoubles(lon2)
+  n = NumDoubles(a)
+  If NumDoubles(b) <> n Or NumDoubles(c) <> n Or NumDoubles(d) <> n Then
+    geodesic_inverse_array = CVErr(xlErrValue)
+    Exit Function
+  End If
+  ReDim s12(0 To n - 1)
+  ReDim azi1(0 To n - 1)
+  ReDim azi2(0 To n - 1)
+  Call ginversearray(n, a(0), b(0), c(0), d(0), s12(0), azi1(0), azi2(0))
+  geodesic_inverse_array = ToColumns(n, s12, azi1, azi2)
+End Function
+
+Function rhumb_direct_array(lat1 As Variant, lon1 As Variant, _
+                            azi12 As Variant, s12 As Variant) As Variant
+  Attribute rhumb_direct_array.VB_Description = _
+    "Solves direct rhumb problem for columns of lat2, lon2."
+  Dim a() As Double
+  Dim b() As Double
+  Dim c() As Double
+  Dim d() As Double
+  Dim lat2() As Double
+  Dim lon2() As Double
+  Dim n As Long
+  a = ToDoubles(lat1)
+  b = ToDoubles(lon1)
+  c = ToDoubles(azi12)
+  d = ToDoubles(s12)
+  n = NumDoubles(a)
+  If NumDoubles(b) <> n Or NumDoubles(c) <> n Or NumDoubles(d) <> n Then
+    rhumb_direct_array = CVErr(xlErrValue)
+    Exit Function
+  End If
+  ReDim lat2(0 To n - 1)
+  ReDim lon2(0 To n - 1)
+  Call rdirectarray(n, a(0), b(0), c(0), d(0), lat2(0), lon2(0))
+  rhumb_direct_array = ToColumns(n, lat2, lon2)
+End Function
+
+Function rhumb_inverse_array(lat1 As Variant, lon1 As Variant, _
+                             lat2 As Variant, lon2 As Variant) As Variant
+  Attribute rhumb_inverse_array.VB_Description = _
+    "Solves inverse rhumb problem for columns of s12, azi12."
+  Dim a() As Double
+  Dim b() As Double
+  Dim c() As Double
+  Dim d() As Double
+  Dim s12() As Double
+  Dim azi12() As Double
+  Dim n As Long
+  a = ToDoubles(lat1)
+  b = ToDoubles(lon1)
+  c = ToDoubles(lat2)
+  d = ToDoubles(lon2)
+  n = NumDoubles(a)
+  If NumDoubles(b) <> n Or NumDoubles(c) <> n Or NumDoubles(d) <> n Then
+    rhumb_inverse_array = CVErr(xlErrValue)
+    Exit Function
+  End If
+  ReDim s12(0 To n - 1)
+  ReDim azi12(0 To n - 1)
+  Call rinversearray(n, a(0), b(0), c(0), d(0), s12(0), azi12(0))
+  rhumb_inverse_array = ToColumns(n, s12, azi12)
+End Function
@@ -1,7 +1,12 @@
 #include "cgeodesic.h"
 #include "GeographicLib/Geodesic.hpp"
+#include "GeographicLib/GeodesicBatchExecutor.hpp"
 #include "GeographicLib/Rhumb.hpp"
 
+using GeographicLib::Geodesic;
+using GeographicLib::GeodesicBatchExecutor;
+using GeographicLib::Rhumb;
+
 extern "C" {
 
   void gdirect(double lat1, double lon1, double azi1, double s12,
@@ -28,4 +33,53 @@ extern "C" {
                                           s12, azi12);
   }
 
+  // The array versions process whole ranges with one call; the points are
+  // handed out in chunks to all the available threads.  n is a VBA Long.
+
+  void gdirectarray(int n, const double lat1[], const double lon1[],
+                    const double azi1[], const double s12[],
+                    double lat2[], double lon2[], double azi2[]) {
+    GeodesicBatchExecutor().Direct(Geodesic::WGS84(), size_t(n),
+                                   lat1, lon1, azi1, false, s12,
+                                   Geodesic::LATITUDE | Geodesic::LONGITUDE |
+                                   Geodesic::AZIMUTH,
+                                   nullptr, lat2, lon2, azi2,
+                                   nullptr, nullptr, nullptr, nullptr,
+                                   nullptr);
+  }
+
+  void ginversearray(int n, const double lat1[], const double lon1[],
+                     const double lat2[], const double lon2[],
+                     double s12[], double azi1[], double azi2[]) {
+    GeodesicBatchExecutor().Inverse(Geodesic::WGS84(), size_t(n),
+                                    lat1, lon1, lat2, lon2,
+                                    Geodesic::DISTANCE | Geodesic::AZIMUTH,
+                                    nullptr, s12, azi1, azi2,
+                                    nullptr, nullptr, nullptr, nullptr);
+  }
+
+  void rdirectarray(int n, const double lat1[], const double lon1[],
+                    const double azi12[], const double s12[],
+                    double lat2[], double lon2[]) {
+    GeodesicBatchExecutor().ForEach
+      (size_t(n), [=](size_t i0, size_t i1) -> void {
+        Rhumb::WGS84().DirectBatch(i1 - i0, lat1 + i0, lon1 + i0,
+                                   azi12 + i0, s12 + i0,
+                                   Rhumb::LATITUDE | Rhumb::LONGITUDE,
+                                   lat2 + i0, lon2 + i0, nullptr);
+      });
+  }
+
+  void rinversearray(int n, const double lat1[], const double lon1[],
+                     const double lat2[], const double lon2[],
+                     double s12[], double azi12[]) {
+    GeodesicBatchExecutor().ForEach
+      (size_t(n), [=](size_t i0, size_t i1) -> void {
+        Rhumb::WGS84().InverseBatch(i1 - i0, lat1 + i0, lon1 + i0,
+                                    lat2 + i0, lon2 + i0,
+                                    Rhumb::DISTANCE | Rhumb::AZIMUTH,
+                                    s12 + i0, azi12 + i0, nullptr);
+      });
+  }
+
 }
@@ -17,6 +17,22 @@ extern "C" {
   void rinverse(double lat1, double lon1, double lat2, double lon2,
                 double& s12, double& azi12);
 
+  void gdirectarray(int n, const double lat1[], const double lon1[],
+                    const double azi1[], const double s12[],
+                    double lat2[], double lon2[], double azi2[]);
+
+  void ginversearray(int n, const double lat1[], const double lon1[],
+                     const double lat2[], const double lon2[],
+                     double s12[], double azi1[], double azi2[]);
+
+  void rdirectarray(int n, const double lat1[], const double lon1[],
+                    const double azi12[], const double s12[],
+                    double lat2[], double lon2[]);
+
+  void rinversearray(int n, const double lat1[], const double lon1[],
+                     const double lat2[], const double lon2[],
+                     double s12[], double azi12[]);
+
 #if defined(__cplusplus)
 }
 #endif
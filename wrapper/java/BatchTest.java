@@ -0,0 +1,44 @@
+import java.io.BufferedReader;
+import java.io.InputStreamReader;
+import java.util.ArrayList;
+import net.sf.geographiclib.jni.NativeBatch;
+
+/**
+ * Read lines of lat1 lon1 lat2 lon2 and print s12 azi1 azi2 for the
+ * geodesic between the points and the UTM/UPS coordinates of the first
+ * point.  All the lines are read before the arrays are processed.
+ **********************************************************************/
+public class BatchTest {
+  public static void main(String[] args) throws Exception {
+    BufferedReader in =
+      new BufferedReader(new InputStreamReader(System.in));
+    ArrayList<double[]> lines = new ArrayList<double[]>();
+    String s;
+    while ((s = in.readLine()) != null) {
+      String[] t = s.trim().split("\\s+");
+      if (t.length < 4) break;
+      double[] p = new double[4];
+      for (int j = 0; j < 4; ++j) p[j] = Double.parseDouble(t[j]);
+      lines.add(p);
+    }
+    int n = lines.size();
+    double[] lat1 = new double[n], lon1 = new double[n],
+      lat2 = new double[n], lon2 = new double[n],
+      s12 = new double[n], azi1 = new double[n], azi2 = new double[n],
+      x = new double[n], y = new double[n];
+    int[] zone = new int[n];
+    boolean[] northp = new boolean[n];
+    for (int i = 0; i < n; ++i) {
+      double[] p = lines.get(i);
+      lat1[i] = p[0]; lon1[i] = p[1]; lat2[i] = p[2]; lon2[i] = p[3];
+    }
+    NativeBatch.inverse(NativeBatch.WGS84_A, NativeBatch.WGS84_F,
+                        lat1, lon1, lat2, lon2, s12, azi1, azi2);
+    NativeBatch.utmupsForward(lat1, lon1, NativeBatch.STANDARD,
+                              zone, northp, x, y);
+    for (int i = 0; i < n; ++i)
+      System.out.printf("%.3f %.8f %.8f %d%c %.3f %.3f%n",
+                        s12[i], azi1[i], azi2[i],
+                        zone[i], northp[i] ? 'n' : 's', x[i], y[i]);
+  }
+}
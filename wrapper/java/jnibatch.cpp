@@ -0,0 +1,313 @@
+// JNI implementation of the native methods of
+// net.sf.geographiclib.jni.NativeBatch (NativeBatch.java).  Each method
+// passes whole arrays of points to the batch routines for the geodesic
+// inverse and direct problems, polygon areas, and UTM/UPS conversions, so
+// that the cost of crossing from Java to C++ is paid once per batch.
+//
+// The arrays come either from Java primitive arrays, which are pinned with
+// GetPrimitiveArrayCritical, or from direct ByteBuffers, whose storage is
+// used in place.  The sizes, alignment, and byte order are checked in
+// NativeBatch.java.  While the arrays are pinned no other JNI calls are
+// made; the work is done by a GeodesicBatchExecutor on all the available
+// threads (these are not attached to the JVM because they don't call into
+// Java).
+//
+// As in wrapper/c/cbatch.h, each method returns the number of points which
+// failed; for these the outputs are NaN (or the zone is UTMUPS::INVALID).
+
+#include <jni.h>
+#include <atomic>
+#include <memory>
+#include <type_traits>
+#include <vector>
+#include "GeographicLib/Geodesic.hpp"
+#include "GeographicLib/GeodesicBatchExecutor.hpp"
+#include "GeographicLib/PolygonArea.hpp"
+#include "GeographicLib/UTMUPS.hpp"
+
+using namespace GeographicLib;
+
+// The arrays are passed straight through to the batch routines
+static_assert(std::is_same<Math::real, double>::value,
+              "GeographicLib must be compiled with doubles");
+static_assert(std::is_same<jdouble, double>::value,
+              "jdouble must be double");
+
+namespace {
+
+  void fillnan(size_t n, double x[]) {
+    if (x)
+      for (size_t i = 0; i < n; ++i) x[i] = Math::NaN();
+  }
+
+  // The elements of a Java primitive array (or nullptr if the array is
+  // null), pinned for the lifetime of this object.  The elements of an
+  // output array are copied back if the JVM made a copy.
+  class Pinned {
+  private:
+    JNIEnv* _env;
+    jarray _a;
+    void* _p;
+    jint _mode;
+  public:
+    Pinned(JNIEnv* env, jarray a, bool output)
+      : _env(env), _a(a)
+      , _p(a ? env->GetPrimitiveArrayCritical(a, nullptr) : nullptr)
+      , _mode(output ? 0 : JNI_ABORT) {}
+    ~Pinned() { if (_p) _env->ReleasePrimitiveArrayCritical(_a, _p, _mode); }
+    Pinned(const Pinned&) = delete;
+    Pinned& operator=(const Pinned&) = delete;
+    // False if the array couldn't be pinned (an OutOfMemoryError is then
+    // pending).
+    bool ok() const { return !_a || _p; }
+    template<typename T> T* get() const { return static_cast<T*>(_p); }
+  };
+
+  // The storage of a direct ByteBuffer (or nullptr if the buffer is null).
+  template<typename T> T* address(JNIEnv* env, jobject b) {
+    return b ? static_cast<T*>(env->GetDirectBufferAddress(b)) : nullptr;
+  }
+
+  // The kernels shared by the versions for arrays and buffers.
+
+  jint inverse(double a, double f, size_t n,
+               const double lat1[], const double lon1[],
+               const double lat2[], const double lon2[],
+               double s12[], double azi1[], double azi2[]) {
+    try {
+      Geodesic g(a, f);
+      unsigned outmask = (s12 ? unsigned(Geodesic::DISTANCE) : 0U) |
+        (azi1 || azi2 ? unsigned(Geodesic::AZIMUTH) : 0U);
+      GeodesicBatchExecutor().Inverse(g, n, lat1, lon1, lat2, lon2, outmask,
+                                      nullptr, s12, azi1, azi2,
+                                      nullptr, nullptr, nullptr, nullptr);
+      return 0;
+    }
+    catch (...) {
+      fillnan(n, s12); fillnan(n, azi1); fillnan(n, azi2);
+      return jint(n);
+    }
+  }
+
+  jint direct(double a, double f, size_t n,
+              const double lat1[], const double lon1[],
+              const double azi1[], const double s12[],
+              double lat2[], double lon2[], double azi2[]) {
+    try {
+      Geodesic g(a, f);
+      unsigned outmask = (lat2 ? unsigned(Geodesic::LATITUDE) : 0U) |
+        (lon2 ? unsigned(Geodesic::LONGITUDE) : 0U) |
+        (azi2 ? unsigned(Geodesic::AZIMUTH) : 0U);
+      GeodesicBatchExecutor().Direct(g, n, lat1, lon1, azi1, false, s12,
+                                     outmask, nullptr, lat2, lon2, azi2,
+                                     nullptr, nullptr, nullptr, nullptr,
+                                     nullptr);
+      return 0;
+    }
+    catch (...) {
+      fillnan(n, lat2); fillnan(n, lon2); fillnan(n, azi2);
+      return jint(n);
+    }
+  }
+
+  // The rings are given by nrings + 1 offsets as in
+  // PolygonArea::ComputeBatch.
+  jint polygonarea(double a, double f, bool polyline, size_t nrings,
+                   const jlong offsets[],
+                   const double lat[], const double lon[],
+                   bool reverse, bool sign,
+                   double perimeter[], double area[]) {
+    try {
+      std::vector<size_t> off(offsets, offsets + nrings + 1);
+      Geodesic g(a, f);
+      PolygonArea p(g, polyline);
+      p.ComputeBatch(nrings, off.data(), lat, lon, reverse, sign,
+                     perimeter, polyline ? nullptr : area);
+      return 0;
+    }
+    catch (...) {
+      fillnan(nrings, perimeter);
+      if (!polyline) fillnan(nrings, area);
+      return jint(nrings);
+    }
+  }
+
+  // The points are handed out in chunks to all the available threads.  Each
+  // chunk is converted by the batch routine; if this throws an exception
+  // because of an invalid point, the chunk is redone point by point.
+  jint utmupsforward(size_t n, const double lat[], const double lon[],
+                     int setzone, jint zone[], jboolean northp[],
+                     double x[], double y[]) {
+    std::atomic<size_t> bad(0);
+    try {
+      GeodesicBatchExecutor().ForEach
+        (n, [&](size_t i0, size_t i1) -> void {
+          size_t m = i1 - i0;
+          std::vector<int> z(m);
+          std::unique_ptr<bool[]> h(new bool[m]);
+          try {
+            UTMUPS::ForwardBatch(m, lat + i0, lon + i0, z.data(), h.get(),
+                                 x + i0, y + i0, nullptr, nullptr, setzone);
+          }
+          catch (const std::exception&) {
+            for (size_t j = 0; j < m; ++j) {
+              size_t i = i0 + j;
+              try {
+                UTMUPS::Forward(lat[i], lon[i], z[j], h[j], x[i], y[i],
+                                setzone);
+              }
+              catch (const std::exception&) {
+                z[j] = UTMUPS::INVALID; h[j] = false;
+                x[i] = y[i] = Math::NaN();
+                ++bad;
+              }
+            }
+          }
+          for (size_t j = 0; j < m; ++j) {
+            zone[i0 + j] = jint(z[j]);
+            northp[i0 + j] = h[j] ? JNI_TRUE : JNI_FALSE;
+          }
+        });
+      return jint(bad);
+    }
+    catch (...) {
+      for (size_t i = 0; i < n; ++i) {
+        zone[i] = UTMUPS::INVALID; northp[i] = JNI_FALSE;
+      }
+      fillnan(n, x); fillnan(n, y);
+      return jint(n);
+    }
+  }
+
+}
+
+extern "C" {
+
+  JNIEXPORT jint JNICALL
+  Java_net_sf_geographiclib_jni_NativeBatch_inverseArrays
+  (JNIEnv* env, jclass, jdouble a, jdouble f, jint n,
+   jdoubleArray lat1, jdoubleArray lon1,
+   jdoubleArray lat2, jdoubleArray lon2,
+   jdoubleArray s12, jdoubleArray azi1, jdoubleArray azi2) {
+    Pinned
+      plat1(env, lat1, false), plon1(env, lon1, false),
+      plat2(env, lat2, false), plon2(env, lon2, false),
+      ps12(env, s12, true), pazi1(env, azi1, true), pazi2(env, azi2, true);
+    if (!(plat1.ok() && plon1.ok() && plat2.ok() && plon2.ok() &&
+          ps12.ok() && pazi1.ok() && pazi2.ok()))
+      return 0;
+    return inverse(a, f, size_t(n),
+                   plat1.get<double>(), plon1.get<double>(),
+                   plat2.get<double>(), plon2.get<double>(),
+                   ps12.get<double>(), pazi1.get<double>(),
+                   pazi2.get<double>());
+  }
+
+  JNIEXPORT jint JNICALL
+  Java_net_sf_geographiclib_jni_NativeBatch_inverseBuffers
+  (JNIEnv* env, jclass, jdouble a, jdouble f, jint n,
+   jobject lat1, jobject lon1, jobject lat2, jobject lon2,
+   jobject s12, jobject azi1, jobject azi2) {
+    return inverse(a, f, size_t(n),
+                   address<double>(env, lat1), address<double>(env, lon1),
+                   address<double>(env, lat2), address<double>(env, lon2),
+                   address<double>(env, s12), address<double>(env, azi1),
+                   address<double>(env, azi2));
+  }
+
+  JNIEXPORT jint JNICALL
+  Java_net_sf_geographiclib_jni_NativeBatch_directArrays
+  (JNIEnv* env, jclass, jdouble a, jdouble f, jint n,
+   jdoubleArray lat1, jdoubleArray lon1,
+   jdoubleArray azi1, jdoubleArray s12,
+   jdoubleArray lat2, jdoubleArray lon2, jdoubleArray azi2) {
+    Pinned
+      plat1(env, lat1, false), plon1(env, lon1, false),
+      pazi1(env, azi1, false), ps12(env, s12, false),
+      plat2(env, lat2, true), plon2(env, lon2, true), pazi2(env, azi2, true);
+    if (!(plat1.ok() && plon1.ok() && pazi1.ok() && ps12.ok() &&
+          plat2.ok() && plon2.ok() && pazi2.ok()))
+      return 0;
+    return direct(a, f, size_t(n),
+                  plat1.get<double>(), plon1.get<double>(),
+                  pazi1.get<double>(), ps12.get<double>(),
+                  plat2.get<double>(), plon2.get<double>(),
+                  pazi2.get<double>());
+  }
+
+  JNIEXPORT jint JNICALL
+  Java_net_sf_geographiclib_jni_NativeBatch_directBuffers
+  (JNIEnv* env, jclass, jdouble a, jdouble f, jint n,
+   jobject lat1, jobject lon1, jobject azi1, jobject s12,
+   jobject lat2, jobject lon2, jobject azi2) {
+    return direct(a, f, size_t(n),
+                  address<double>(env, lat1), address<double>(env, lon1),
+                  address<double>(env, azi1), address<double>(env, s12),
+                  address<double>(env, lat2), address<double>(env, lon2),
+                  address<double>(env, azi2));
+  }
+
+  JNIEXPORT jint JNICALL
+  Java_net_sf_geographiclib_jni_NativeBatch_polygonAreaArrays
+  (JNIEnv* env, jclass, jdouble a, jdouble f, jboolean polyline,
+   jint nrings, jlongArray offsets, jdoubleArray lat, jdoubleArray lon,
+   jboolean reverse, jboolean sign,
+   jdoubleArray perimeter, jdoubleArray area) {
+    Pinned
+      poffsets(env, offsets, false),
+      plat(env, lat, false), plon(env, lon, false),
+      pperimeter(env, perimeter, true), parea(env, area, true);
+    if (!(poffsets.ok() && plat.ok() && plon.ok() &&
+          pperimeter.ok() && parea.ok()))
+      return 0;
+    return polygonarea(a, f, polyline != JNI_FALSE, size_t(nrings),
+                       poffsets.get<jlong>(),
+                       plat.get<double>(), plon.get<double>(),
+                       reverse != JNI_FALSE, sign != JNI_FALSE,
+                       pperimeter.get<double>(), parea.get<double>());
+  }
+
+  JNIEXPORT jint JNICALL
+  Java_net_sf_geographiclib_jni_NativeBatch_polygonAreaBuffers
+  (JNIEnv* env, jclass, jdouble a, jdouble f, jboolean polyline,
+   jint nrings, jobject offsets, jobject lat, jobject lon,
+   jboolean reverse, jboolean sign, jobject perimeter, jobject area) {
+    return polygonarea(a, f, polyline != JNI_FALSE, size_t(nrings),
+                       address<jlong>(env, offsets),
+                       address<double>(env, lat), address<double>(env, lon),
+                       reverse != JNI_FALSE, sign != JNI_FALSE,
+                       address<double>(env, perimeter),
+                       address<double>(env, area));
+  }
+
+  JNIEXPORT jint JNICALL
+  Java_net_sf_geographiclib_jni_NativeBatch_utmupsForwardArrays
+  (JNIEnv* env, jclass, jint n, jdoubleArray lat, jdoubleArray lon,
+   jint setzone, jintArray zone, jbooleanArray northp,
+   jdoubleArray x, jdoubleArray y) {
+    Pinned
+      plat(env, lat, false), plon(env, lon, false),
+      pzone(env, zone, true), pnorthp(env, northp, true),
+      px(env, x, true), py(env, y, true);
+    if (!(plat.ok() && plon.ok() && pzone.ok() && pnorthp.ok() &&
+          px.ok() && py.ok()))
+      return 0;
+    return utmupsforward(size_t(n), plat.get<double>(), plon.get<double>(),
+                         int(setzone),
+                         pzone.get<jint>(), pnorthp.get<jboolean>(),
+                         px.get<double>(), py.get<double>());
+  }
+
+  JNIEXPORT jint JNICALL
+  Java_net_sf_geographiclib_jni_NativeBatch_utmupsForwardBuffers
+  (JNIEnv* env, jclass, jint n, jobject lat, jobject lon,
+   jint setzone, jobject zone, jobject northp, jobject x, jobject y) {
+    return utmupsforward(size_t(n),
+                         address<double>(env, lat), address<double>(env, lon),
+                         int(setzone),
+                         address<jint>(env, zone),
+                         address<jboolean>(env, northp),
+                         address<double>(env, x), address<double>(env, y));
+  }
+
+}
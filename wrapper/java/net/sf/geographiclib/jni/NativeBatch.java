@@ -0,0 +1,388 @@
+/**
+ * Implementation of the net.sf.geographiclib.jni.NativeBatch class
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+package net.sf.geographiclib.jni;
+
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.util.Objects;
+
+/**
+ * Batch calculations using the native C++ library.
+ * <p>
+ * Each method handles arrays of points with a single call to the batch
+ * routines of the C++ library, which process the points on all the
+ * available threads.  This avoids the cost of a JNI call per point.  The
+ * arrays are either Java primitive arrays or direct {@link ByteBuffer}s.
+ * <ul>
+ * <li> Primitive arrays are pinned (with GetPrimitiveArrayCritical) while
+ *   the calculation is done; some garbage collectors are held up while an
+ *   array is pinned.
+ * <li> Direct buffers (e.g., ones shared with Arrow or other native code)
+ *   are used in place and don't hold up the garbage collector; so they are
+ *   preferable for large batches.  The buffers must be in the native byte
+ *   order and 8-byte aligned.  Element 0 is at the start of the buffer (its
+ *   position is ignored), so use {@link ByteBuffer#slice()} to pass part of
+ *   a buffer.
+ * </ul>
+ * <p>
+ * Output arrays (other than the perimeters for polygonArea and those for
+ * utmupsForward) may be null if the corresponding results aren't needed.
+ * Each method returns the number of points which could not be handled;
+ * for these the outputs are NaN (or the zone is {@link #INVALID}).
+ * Arguments of the wrong size throw an {@link IllegalArgumentException}
+ * and missing arguments a {@link NullPointerException}.
+ * <p>
+ * The ellipsoid is given by its equatorial radius <i>a</i> (meters) and
+ * flattening <i>f</i>, e.g., {@link #WGS84_A} and {@link #WGS84_F}.  The
+ * native library, libgeographiclib_jni, is loaded when this class is
+ * initialized.
+ **********************************************************************/
+public final class NativeBatch {
+  /**
+   * The equatorial radius of the WGS84 ellipsoid (meters).
+   **********************************************************************/
+  public static final double WGS84_A = 6378137;
+  /**
+   * The flattening of the WGS84 ellipsoid.
+   **********************************************************************/
+  public static final double WGS84_F = 1/298.257223563;
+  /**
+   * The zone returned for a point which can't be converted to UTM/UPS.
+   **********************************************************************/
+  public static final int INVALID = -4;
+  /**
+   * The setzone value for the standard UTM zone or UPS.
+   **********************************************************************/
+  public static final int STANDARD = -1;
+
+  static {
+    System.loadLibrary("geographiclib_jni");
+  }
+
+  private NativeBatch() {}
+
+  /**
+   * Solve the inverse geodesic problem for many pairs of points.
+   *
+   * @param a equatorial radius (meters).
+   * @param f flattening.
+   * @param lat1 latitudes of point 1 (degrees).
+   * @param lon1 longitudes of point 1 (degrees).
+   * @param lat2 latitudes of point 2 (degrees).
+   * @param lon2 longitudes of point 2 (degrees).
+   * @param s12 distances from point 1 to point 2 (meters).
+   * @param azi1 azimuths at point 1 (degrees).
+   * @param azi2 azimuths at point 2 (degrees).
+   * @return the number of pairs which failed.
+   **********************************************************************/
+  public static int inverse(double a, double f,
+                            double[] lat1, double[] lon1,
+                            double[] lat2, double[] lon2,
+                            double[] s12, double[] azi1, double[] azi2) {
+    int n = lat1.length;
+    check(n, false, lon1, lat2, lon2);
+    check(n, true, s12, azi1, azi2);
+    return inverseArrays(a, f, n, lat1, lon1, lat2, lon2, s12, azi1, azi2);
+  }
+
+  /**
+   * Solve the inverse geodesic problem for many pairs of points held in
+   * direct buffers of doubles.
+   *
+   * @param a equatorial radius (meters).
+   * @param f flattening.
+   * @param n the number of pairs.
+   * @param lat1 latitudes of point 1 (degrees).
+   * @param lon1 longitudes of point 1 (degrees).
+   * @param lat2 latitudes of point 2 (degrees).
+   * @param lon2 longitudes of point 2 (degrees).
+   * @param s12 distances from point 1 to point 2 (meters).
+   * @param azi1 azimuths at point 1 (degrees).
+   * @param azi2 azimuths at point 2 (degrees).
+   * @return the number of pairs which failed.
+   **********************************************************************/
+  public static int inverse(double a, double f, int n,
+                            ByteBuffer lat1, ByteBuffer lon1,
+                            ByteBuffer lat2, ByteBuffer lon2,
+                            ByteBuffer s12, ByteBuffer azi1,
+                            ByteBuffer azi2) {
+    check(n, 8, false, lat1, lon1, lat2, lon2);
+    check(n, 8, true, s12, azi1, azi2);
+    return inverseBuffers(a, f, n, lat1, lon1, lat2, lon2, s12, azi1, azi2);
+  }
+
+  /**
+   * Solve the direct geodesic problem for many points.
+   *
+   * @param a equatorial radius (meters).
+   * @param f flattening.
+   * @param lat1 latitudes of point 1 (degrees).
+   * @param lon1 longitudes of point 1 (degrees).
+   * @param azi1 azimuths at point 1 (degrees).
+   * @param s12 distances from point 1 to point 2 (meters).
+   * @param lat2 latitudes of point 2 (degrees).
+   * @param lon2 longitudes of point 2 (degrees).
+   * @param azi2 azimuths at point 2 (degrees).
+   * @return the number of points which failed.
+   **********************************************************************/
+  public static int direct(double a, double f,
+                           double[] lat1, double[] lon1,
+                           double[] azi1, double[] s12,
+                           double[] lat2, double[] lon2, double[] azi2) {
+    int n = lat1.length;
+    check(n, false, lon1, azi1, s12);
+    check(n, true, lat2, lon2, azi2);
+    return directArrays(a, f, n, lat1, lon1, azi1, s12, lat2, lon2, azi2);
+  }
+
+  /**
+   * Solve the direct geodesic problem for many points held in direct
+   * buffers of doubles.
+   *
+   * @param a equatorial radius (meters).
+   * @param f flattening.
+   * @param n the number of points.
+   * @param lat1 latitudes of point 1 (degrees).
+   * @param lon1 longitudes of point 1 (degrees).
+   * @param azi1 azimuths at point 1 (degrees).
+   * @param s12 distances from point 1 to point 2 (meters).
+   * @param lat2 latitudes of point 2 (degrees).
+   * @param lon2 longitudes of point 2 (degrees).
+   * @param azi2 azimuths at point 2 (degrees).
+   * @return the number of points which failed.
+   **********************************************************************/
+  public static int direct(double a, double f, int n,
+                           ByteBuffer lat1, ByteBuffer lon1,
+                           ByteBuffer azi1, ByteBuffer s12,
+                           ByteBuffer lat2, ByteBuffer lon2,
+                           ByteBuffer azi2) {
+    check(n, 8, false, lat1, lon1, azi1, s12);
+    check(n, 8, true, lat2, lon2, azi2);
+    return directBuffers(a, f, n, lat1, lon1, azi1, s12, lat2, lon2, azi2);
+  }
+
+  /**
+   * Compute the perimeters and areas of many polygons (or the lengths of
+   * many polylines).
+   *
+   * @param a equatorial radius (meters).
+   * @param f flattening.
+   * @param polyline if true the vertices are polylines.
+   * @param offsets the <i>nrings</i> + 1 offsets into <i>lat</i> and
+   *   <i>lon</i>; the vertices of polygon <i>i</i> are [offsets[<i>i</i>],
+   *   offsets[<i>i</i> + 1]).
+   * @param lat latitudes of the vertices (degrees).
+   * @param lon longitudes of the vertices (degrees).
+   * @param reverse if true then clockwise (instead of counter-clockwise)
+   *   traversal counts as a positive area.
+   * @param sign if true then return a signed result for the area if the
+   *   polygon is traversed in the "wrong" direction instead of returning
+   *   the area for the rest of the earth.
+   * @param perimeter the perimeters of the polygons or the lengths of the
+   *   polylines (meters).
+   * @param area the areas of the polygons (meters<sup>2</sup>); this is
+   *   not used if <i>polyline</i> is true.
+   * @return the number of polygons which failed.
+   **********************************************************************/
+  public static int polygonArea(double a, double f, boolean polyline,
+                                long[] offsets,
+                                double[] lat, double[] lon,
+                                boolean reverse, boolean sign,
+                                double[] perimeter, double[] area) {
+    int nrings = offsets.length - 1;
+    checkOffsets(nrings, offsets, lat.length);
+    check(lat.length, false, lon);
+    check(nrings, false, perimeter);
+    check(nrings, true, polyline ? null : area);
+    return polygonAreaArrays(a, f, polyline, nrings, offsets, lat, lon,
+                             reverse, sign, perimeter, area);
+  }
+
+  /**
+   * Compute the perimeters and areas of many polygons (or the lengths of
+   * many polylines) held in direct buffers.
+   *
+   * @param a equatorial radius (meters).
+   * @param f flattening.
+   * @param polyline if true the vertices are polylines.
+   * @param nrings the number of polygons.
+   * @param offsets the <i>nrings</i> + 1 offsets (longs) into <i>lat</i>
+   *   and <i>lon</i>; the vertices of polygon <i>i</i> are
+   *   [offsets[<i>i</i>], offsets[<i>i</i> + 1]).
+   * @param lat latitudes of the vertices (degrees).
+   * @param lon longitudes of the vertices (degrees).
+   * @param reverse if true then clockwise (instead of counter-clockwise)
+   *   traversal counts as a positive area.
+   * @param sign if true then return a signed result for the area if the
+   *   polygon is traversed in the "wrong" direction instead of returning
+   *   the area for the rest of the earth.
+   * @param perimeter the perimeters of the polygons or the lengths of the
+   *   polylines (meters).
+   * @param area the areas of the polygons (meters<sup>2</sup>); this is
+   *   not used if <i>polyline</i> is true.
+   * @return the number of polygons which failed.
+   **********************************************************************/
+  public static int polygonArea(double a, double f, boolean polyline,
+                                int nrings, ByteBuffer offsets,
+                                ByteBuffer lat, ByteBuffer lon,
+                                boolean reverse, boolean sign,
+                                ByteBuffer perimeter, ByteBuffer area) {
+    if (nrings < 0)
+      throw new IllegalArgumentException("nrings is negative");
+    check(nrings + 1, 8, false, offsets);
+    check(0, 8, false, lat, lon);
+    long[] off = new long[nrings + 1];
+    for (int i = 0; i <= nrings; ++i)
+      off[i] = offsets.getLong(8 * i);
+    checkOffsets(nrings, off, Math.min(lat.capacity(), lon.capacity()) / 8);
+    // perimeter is required
+    check(nrings, 8, true, Objects.requireNonNull(perimeter));
+    check(nrings, 8, true, polyline ? null : area);
+    return polygonAreaBuffers(a, f, polyline, nrings, offsets, lat, lon,
+                              reverse, sign, perimeter, area);
+  }
+
+  /**
+   * Convert many points from geographic coordinates to UTM/UPS.
+   *
+   * @param lat latitudes (degrees).
+   * @param lon longitudes (degrees).
+   * @param setzone the zone to use, e.g., {@link #STANDARD} (as for the
+   *   setzone argument of UTMUPS::Forward).
+   * @param zone the UTM zones (1 through 60) or 0 for UPS.
+   * @param northp the hemispheres (true means north).
+   * @param x eastings (meters).
+   * @param y northings (meters).
+   * @return the number of points which failed.
+   **********************************************************************/
+  public static int utmupsForward(double[] lat, double[] lon, int setzone,
+                                  int[] zone, boolean[] northp,
+                                  double[] x, double[] y) {
+    int n = lat.length;
+    check(n, false, lon, x, y);
+    if (zone.length != n || northp.length != n)
+      throw new IllegalArgumentException("Arrays have different lengths");
+    return utmupsForwardArrays(n, lat, lon, setzone, zone, northp, x, y);
+  }
+
+  /**
+   * Convert many points held in direct buffers from geographic
+   * coordinates to UTM/UPS.
+   *
+   * @param n the number of points.
+   * @param lat latitudes (degrees).
+   * @param lon longitudes (degrees).
+   * @param setzone the zone to use, e.g., {@link #STANDARD} (as for the
+   *   setzone argument of UTMUPS::Forward).
+   * @param zone the UTM zones (ints, 1 through 60) or 0 for UPS.
+   * @param northp the hemispheres (bytes, 1 means north).
+   * @param x eastings (meters).
+   * @param y northings (meters).
+   * @return the number of points which failed.
+   **********************************************************************/
+  public static int utmupsForward(int n, ByteBuffer lat, ByteBuffer lon,
+                                  int setzone,
+                                  ByteBuffer zone, ByteBuffer northp,
+                                  ByteBuffer x, ByteBuffer y) {
+    check(n, 8, false, lat, lon);
+    // The outputs are required
+    check(n, 8, true, Objects.requireNonNull(x), Objects.requireNonNull(y));
+    check(n, 4, true, Objects.requireNonNull(zone));
+    check(n, 1, true, Objects.requireNonNull(northp));
+    return utmupsForwardBuffers(n, lat, lon, setzone, zone, northp, x, y);
+  }
+
+  // Check that the arrays have length n; the outputs may be null.
+  private static void check(int n, boolean output, double[]... arrays) {
+    for (double[] x : arrays) {
+      if (x == null) {
+        if (output) continue;
+        throw new NullPointerException("Input array is null");
+      }
+      if (x.length != n)
+        throw new IllegalArgumentException("Arrays have different lengths");
+    }
+  }
+
+  // Check that the buffers are direct, in the native byte order, aligned,
+  // and hold at least n elements of the given size; the outputs may be null
+  // and must be writable.
+  private static void check(int n, int size, boolean output,
+                            ByteBuffer... buffers) {
+    if (n < 0)
+      throw new IllegalArgumentException("Number of points is negative");
+    for (ByteBuffer b : buffers) {
+      if (b == null) {
+        if (output) continue;
+        throw new NullPointerException("Input buffer is null");
+      }
+      if (!b.isDirect())
+        throw new IllegalArgumentException("Buffer is not direct");
+      if (size > 1 && b.order() != ByteOrder.nativeOrder())
+        throw new IllegalArgumentException("Buffer is not in native order");
+      if (b.alignmentOffset(0, size) != 0)
+        throw new IllegalArgumentException("Buffer is not aligned");
+      if (b.capacity() / size < n)
+        throw new IllegalArgumentException("Buffer is too small");
+      if (output && b.isReadOnly())
+        throw new IllegalArgumentException("Output buffer is read only");
+    }
+  }
+
+  // Check that the offsets of nrings rings are nondecreasing and in
+  // [0, nvertices].
+  private static void checkOffsets(int nrings, long[] offsets,
+                                   long nvertices) {
+    if (nrings < 0)
+      throw new IllegalArgumentException("offsets is empty");
+    if (offsets[0] < 0 || offsets[nrings] > nvertices)
+      throw new IllegalArgumentException("offsets are out of range");
+    for (int i = 0; i < nrings; ++i)
+      if (offsets[i] > offsets[i + 1])
+        throw new IllegalArgumentException("offsets are decreasing");
+  }
+
+  private static native int
+    inverseArrays(double a, double f, int n,
+                  double[] lat1, double[] lon1,
+                  double[] lat2, double[] lon2,
+                  double[] s12, double[] azi1, double[] azi2);
+  private static native int
+    inverseBuffers(double a, double f, int n,
+                   ByteBuffer lat1, ByteBuffer lon1,
+                   ByteBuffer lat2, ByteBuffer lon2,
+                   ByteBuffer s12, ByteBuffer azi1, ByteBuffer azi2);
+  private static native int
+    directArrays(double a, double f, int n,
+                 double[] lat1, double[] lon1,
+                 double[] azi1, double[] s12,
+                 double[] lat2, double[] lon2, double[] azi2);
+  private static native int
+    directBuffers(double a, double f, int n,
+                  ByteBuffer lat1, ByteBuffer lon1,
+                  ByteBuffer azi1, ByteBuffer s12,
+                  ByteBuffer lat2, ByteBuffer lon2, ByteBuffer azi2);
+  private static native int
+    polygonAreaArrays(double a, double f, boolean polyline, int nrings,
+                      long[] offsets, double[] lat, double[] lon,
+                      boolean reverse, boolean sign,
+                      double[] perimeter, double[] area);
+  private static native int
+    polygonAreaBuffers(double a, double f, boolean polyline, int nrings,
+                       ByteBuffer offsets, ByteBuffer lat, ByteBuffer lon,
+                       boolean reverse, boolean sign,
+                       ByteBuffer perimeter, ByteBuffer area);
+  private static native int
+    utmupsForwardArrays(int n, double[] lat, double[] lon, int setzone,
+                        int[] zone, boolean[] northp,
+                        double[] x, double[] y);
+  private static native int
+    utmupsForwardBuffers(int n, ByteBuffer lat, ByteBuffer lon, int setzone,
+                         ByteBuffer zone, ByteBuffer northp,
+                         ByteBuffer x, ByteBuffer y);
+}
@@ -0,0 +1,209 @@
+// Array versions of the geodesic, polygon area, transverse Mercator, and MGRS
+// calculations for a WebAssembly build of GeographicLib.  These are called
+// by the JavaScript glue in wasmbatch.js which copies typed arrays in and
+// out of the WebAssembly heap.
+//
+// As in wrapper/c/cbatch.h, each function returns the number of points which
+// failed; for these the outputs are NaN (or "INVALID" for MGRS strings).
+
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include "GeographicLib/Geodesic.hpp"
+#include "GeographicLib/PolygonArea.hpp"
+#include "GeographicLib/TransverseMercator.hpp"
+#include "GeographicLib/UTMUPS.hpp"
+#include "GeographicLib/MGRS.hpp"
+
+#if defined(__EMSCRIPTEN__)
+#  include <emscripten.h>
+#else
+#  define EMSCRIPTEN_KEEPALIVE
+#endif
+
+using namespace GeographicLib;
+
+// The arrays are passed straight through to the batch routines
+static_assert(std::is_same<Math::real, double>::value,
+              "GeographicLib must be compiled with doubles");
+
+namespace {
+
+  void fillnan(size_t n, double x[]) {
+    if (x)
+      for (size_t i = 0; i < n; ++i) x[i] = Math::NaN();
+  }
+
+  // The size of the slot for each MGRS string
+  const size_t mgrslen = MGRS::MAXLENGTH + 1;
+
+  void invalid(char* mgrs) {
+    std::strncpy(mgrs, "INVALID", mgrslen);
+  }
+
+}
+
+extern "C" {
+
+  EMSCRIPTEN_KEEPALIVE
+  size_t gl_mgrs_slot() { return mgrslen; }
+
+  EMSCRIPTEN_KEEPALIVE
+  size_t gl_inverse(double a, double f, size_t n,
+                    const double lat1[], const double lon1[],
+                    const double lat2[], const double lon2[],
+                    double s12[], double azi1[], double azi2[]) {
+    try {
+      Geodesic g(a, f);
+      g.InverseBatch(n, lat1, lon1, lat2, lon2,
+                     Geodesic::DISTANCE | Geodesic::AZIMUTH,
+                     nullptr, s12, azi1, azi2,
+                     nullptr, nullptr, nullptr, nullptr);
+      return 0;
+    }
+    catch (...) {
+      fillnan(n, s12); fillnan(n, azi1); fillnan(n, azi2);
+      return n;
+    }
+  }
+
+  EMSCRIPTEN_KEEPALIVE
+  size_t gl_direct(double a, double f, size_t n,
+                   const double lat1[], const double lon1[],
+                   const double azi1[], const double s12[],
+                   double lat2[], double lon2[], double azi2[]) {
+    try {
+      Geodesic g(a, f);
+      g.DirectBatch(n, lat1, lon1, azi1, false, s12,
+                    Geodesic::LATITUDE | Geodesic::LONGITUDE |
+                    Geodesic::AZIMUTH,
+                    nullptr, lat2, lon2, azi2,
+                    nullptr, nullptr, nullptr, nullptr, nullptr);
+      return 0;
+    }
+    catch (...) {
+      fillnan(n, lat2); fillnan(n, lon2); fillnan(n, azi2);
+      return n;
+    }
+  }
+
+  // The rings are given by offsets as in PolygonArea::ComputeBatch.  There's
+  // only one thread in the browser (unless the module is built with
+  // pthreads), so the rings are processed serially.
+  EMSCRIPTEN_KEEPALIVE
+  size_t gl_polygon_area(double a, double f, int polyline, size_t nrings,
+                         const size_t offsets[],
+                         const double lat[], const double lon[],
+                         int reverse, int sign,
+                         double perimeter[], double area[]) {
+    try {
+      Geodesic g(a, f);
+      PolygonArea p(g, polyline != 0);
+      p.ComputeBatch(nrings, offsets, lat, lon, reverse != 0, sign != 0,
+                     perimeter, polyline ? nullptr : area, 1);
+      return 0;
+    }
+    catch (...) {
+      fillnan(nrings, perimeter); fillnan(nrings, area);
+      return nrings;
+    }
+  }
+
+  EMSCRIPTEN_KEEPALIVE
+  size_t gl_tm_forward(double a, double f, double k0, size_t n, double lon0,
+                       const double lat[], const double lon[],
+                       double x[], double y[], double gamma[], double k[]) {
+    try {
+      TransverseMercator tm(a, f, k0);
+      tm.ForwardBatch(n, lon0, lat, lon, x, y, gamma, k);
+      return 0;
+    }
+    catch (...) {
+      fillnan(n, x); fillnan(n, y); fillnan(n, gamma); fillnan(n, k);
+      return n;
+    }
+  }
+
+  EMSCRIPTEN_KEEPALIVE
+  size_t gl_tm_reverse(double a, double f, double k0, size_t n, double lon0,
+                       const double x[], const double y[],
+                       double lat[], double lon[],
+                       double gamma[], double k[]) {
+    try {
+      TransverseMercator tm(a, f, k0);
+      tm.ReverseBatch(n, lon0, x, y, lat, lon, gamma, k);
+      return 0;
+    }
+    catch (...) {
+      fillnan(n, lat); fillnan(n, lon); fillnan(n, gamma); fillnan(n, k);
+      return n;
+    }
+  }
+
+  // Convert geographic coordinates to MGRS; string i is put in mgrs + i *
+  // gl_mgrs_slot().
+  EMSCRIPTEN_KEEPALIVE
+  size_t gl_mgrs_forward(size_t n, const double lat[], const double lon[],
+                         int prec, char mgrs[]) {
+    try {
+      std::unique_ptr<int[]> zone(new int[n]);
+      std::unique_ptr<bool[]> northp(new bool[n]);
+      std::unique_ptr<double[]> x(new double[n]), y(new double[n]);
+      try {
+        UTMUPS::ForwardBatch(n, lat, lon, zone.get(), northp.get(),
+                             x.get(), y.get());
+        MGRS::ForwardBatch(n, zone.get(), northp.get(), x.get(), y.get(),
+                           prec, mgrs, lat);
+        return 0;
+      }
+      catch (const GeographicErr&) {
+        // Some point is out of range; redo the points one at a time.
+        size_t bad = 0;
+        for (size_t i = 0; i < n; ++i) {
+          try {
+            UTMUPS::Forward(lat[i], lon[i], zone[i], northp[i], x[i], y[i]);
+            MGRS::Forward(zone[i], northp[i], x[i], y[i], lat[i], prec,
+                          mgrs + i * mgrslen);
+          }
+          catch (const GeographicErr&) {
+            invalid(mgrs + i * mgrslen);
+            ++bad;
+          }
+        }
+        return bad;
+      }
+    }
+    catch (...) {
+      for (size_t i = 0; i < n; ++i) invalid(mgrs + i * mgrslen);
+      return n;
+    }
+  }
+
+  // Convert MGRS strings (laid out as by gl_mgrs_forward) to the geographic
+  // coordinates of the centers of the MGRS squares.
+  EMSCRIPTEN_KEEPALIVE
+  size_t gl_mgrs_reverse(size_t n, const char mgrs[],
+                         double lat[], double lon[]) {
+    size_t bad = 0;
+    for (size_t i = 0; i < n; ++i) {
+      const char* s = mgrs + i * mgrslen;
+      try {
+        int zone, prec;
+        bool northp;
+        double x, y;
+        const char* e = (const char*)std::memchr(s, 0, mgrslen);
+        MGRS::Reverse(s, e ? size_t(e - s) : mgrslen, zone, northp, x, y,
+                      prec);
+        UTMUPS::Reverse(zone, northp, x, y, lat[i], lon[i]);
+        // "INVALID" gives NaNs
+        if (zone == UTMUPS::INVALID) ++bad;
+      }
+      catch (const GeographicErr&) {
+        lat[i] = lon[i] = Math::NaN();
+        ++bad;
+      }
+    }
+    return bad;
+  }
+
+}
@@ -0,0 +1,153 @@
+// JavaScript glue for the array interface in wasmbatch.cpp.  This is
+// appended to the generated module with --post-js and adds the functions
+// below to the module object.  The arguments are arrays of numbers (typed
+// arrays, e.g., Float64Array, or ordinary arrays); the results are
+// Float64Arrays.  The ellipsoid is given by the optional last argument,
+// {a, f}, which defaults to WGS84 (and k0 defaults to the UTM value for the
+// transverse Mercator projection).
+//
+// Example (in node):
+//   const GeographicLib = require('./geographiclib-wasm.js');
+//   GeographicLib().then(g => {
+//     const r = g.inverse([40.6, 35.8], [-73.8, 140.4],
+//                         [51.6, 51.6], [-0.5, -0.5]);
+//     console.log(r.s12, r.azi1, r.azi2);
+//   });
+
+(function() {
+  const WGS84 = {a: 6378137, f: 1/298.257223563, k0: 0.9996};
+
+  function ellipsoid(opt) {
+    return Object.assign({}, WGS84, opt || {});
+  }
+
+  function length(arrays) {
+    const n = arrays[0].length;
+    for (const x of arrays)
+      if (x.length !== n) throw new RangeError('Arrays have different sizes');
+    return n;
+  }
+
+  // Copy the inputs into the heap and allocate nout outputs of n doubles,
+  // call f with the pointers, and return the outputs as Float64Arrays.  The
+  // heap views are looked up afresh after each allocation because the memory
+  // may grow.
+  function run(n, inputs, nout, f) {
+    const ptrs = [];
+    try {
+      for (const x of inputs) {
+        const p = _malloc(8 * Math.max(x.length, 1));
+        ptrs.push(p);
+        HEAPF64.set(x, p >> 3);
+      }
+      for (let i = 0; i < nout; ++i)
+        ptrs.push(_malloc(8 * Math.max(n, 1)));
+      const bad = f(...ptrs);
+      const outputs = ptrs.slice(inputs.length).map(
+        p => HEAPF64.slice(p >> 3, (p >> 3) + n));
+      return {bad: bad, outputs: outputs};
+    } finally {
+      for (const p of ptrs) _free(p);
+    }
+  }
+
+  Module['inverse'] = function(lat1, lon1, lat2, lon2, opt) {
+    const e = ellipsoid(opt), n = length([lat1, lon1, lat2, lon2]);
+    const r = run(n, [lat1, lon1, lat2, lon2], 3,
+                  (...p) => _gl_inverse(e.a, e.f, n, ...p));
+    return {s12: r.outputs[0], azi1: r.outputs[1], azi2: r.outputs[2],
+            bad: r.bad};
+  };
+
+  Module['direct'] = function(lat1, lon1, azi1, s12, opt) {
+    const e = ellipsoid(opt), n = length([lat1, lon1, azi1, s12]);
+    const r = run(n, [lat1, lon1, azi1, s12], 3,
+                  (...p) => _gl_direct(e.a, e.f, n, ...p));
+    return {lat2: r.outputs[0], lon2: r.outputs[1], azi2: r.outputs[2],
+            bad: r.bad};
+  };
+
+  // The vertices of ring i are [offsets[i], offsets[i+1]) in lat and lon (as
+  // in GeoArrow); if offsets is omitted, there is a single ring.  Further
+  // options are polyline, reverse, and sign as for PolygonArea.
+  Module['polygonArea'] = function(lat, lon, offsets, opt) {
+    const e = ellipsoid(opt), n = length([lat, lon]);
+    offsets = offsets || [0, n];
+    const nrings = offsets.length - 1;
+    if (nrings < 0 || offsets[nrings] > n)
+      throw new RangeError('Bad ring offsets');
+    const po = _malloc(4 * offsets.length);
+    try {
+      HEAPU32.set(offsets, po >> 2);
+      const r = run(nrings, [lat, lon], 2,
+                    (plat, plon, pperim, parea) =>
+                    _gl_polygon_area(e.a, e.f, e.polyline ? 1 : 0, nrings,
+                                     po, plat, plon,
+                                     e.reverse ? 1 : 0,
+                                     e.sign === false ? 0 : 1,
+                                     pperim, parea));
+      return {perimeter: r.outputs[0],
+              area: e.polyline ? null : r.outputs[1], bad: r.bad};
+    } finally {
+      _free(po);
+    }
+  };
+
+  Module['tmForward'] = function(lon0, lat, lon, opt) {
+    const e = ellipsoid(opt), n = length([lat, lon]);
+    const r = run(n, [lat, lon], 4,
+                  (...p) => _gl_tm_forward(e.a, e.f, e.k0, n, lon0, ...p));
+    return {x: r.outputs[0], y: r.outputs[1],
+            gamma: r.outputs[2], k: r.outputs[3], bad: r.bad};
+  };
+
+  Module['tmReverse'] = function(lon0, x, y, opt) {
+    const e = ellipsoid(opt), n = length([x, y]);
+    const r = run(n, [x, y], 4,
+                  (...p) => _gl_tm_reverse(e.a, e.f, e.k0, n, lon0, ...p));
+    return {lat: r.outputs[0], lon: r.outputs[1],
+            gamma: r.outputs[2], k: r.outputs[3], bad: r.bad};
+  };
+
+  // Returns an array of MGRS strings with precision prec (default 5, 1 m);
+  // points which can't be converted give "INVALID".
+  Module['mgrsForward'] = function(lat, lon, prec) {
+    const n = length([lat, lon]), slot = _gl_mgrs_slot();
+    const pm = _malloc(slot * Math.max(n, 1));
+    try {
+      run(0, [lat, lon], 0,
+          (plat, plon) => _gl_mgrs_forward(n, plat, plon,
+                                           prec === undefined ? 5 : prec,
+                                           pm));
+      const mgrs = new Array(n);
+      for (let i = 0; i < n; ++i) {
+        let s = '';
+        for (let j = pm + i * slot; HEAPU8[j] !== 0; ++j)
+          s += String.fromCharCode(HEAPU8[j]);
+        mgrs[i] = s;
+      }
+      return mgrs;
+    } finally {
+      _free(pm);
+    }
+  };
+
+  // Returns the centers of the MGRS squares; illegal strings give NaNs.
+  Module['mgrsReverse'] = function(mgrs) {
+    const n = mgrs.length, slot = _gl_mgrs_slot();
+    const pm = _malloc(slot * Math.max(n, 1));
+    try {
+      for (let i = 0; i < n; ++i) {
+        const s = String(mgrs[i]), p = pm + i * slot;
+        const len = Math.min(s.length, slot);
+        for (let j = 0; j < len; ++j) HEAPU8[p + j] = s.charCodeAt(j) & 0x7f;
+        if (len < slot) HEAPU8[p + len] = 0;
+      }
+      const r = run(n, [], 2, (plat, plon) => _gl_mgrs_reverse(n, pm,
+                                                               plat, plon));
+      return {lat: r.outputs[0], lon: r.outputs[1], bad: r.bad};
+    } finally {
+      _free(pm);
+    }
+  };
+})();
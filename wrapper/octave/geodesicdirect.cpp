@@ -0,0 +1,110 @@
+/**
+ * \file geodesicdirect.cpp
+ * \brief Matlab mex file for solving the direct geodesic problem
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+// Compile in Matlab with
+// [Unix]
+// mex -I/usr/local/include -L/usr/local/lib -Wl,-rpath=/usr/local/lib
+//    -lGeographicLib geodesicdirect.cpp
+// [Windows]
+// mex -I../include -L../windows/Release
+//    -lGeographicLib geodesicdirect.cpp
+
+#include <algorithm>
+#include <GeographicLib/Geodesic.hpp>
+#include <GeographicLib/GeodesicExact.hpp>
+#include <GeographicLib/GeodesicBatchExecutor.hpp>
+#include <mex.h>
+
+using namespace std;
+using namespace GeographicLib;
+
+template<class G> void
+compute(double a, double f, mwSize m, const double* geodesic,
+        double* latlong, double* aux) {
+  const double* lat1 = geodesic;
+  const double* lon1 = geodesic + m;
+  const double* azi1 = geodesic + 2*m;
+  const double* s12 = geodesic + 3*m;
+  double* lat2 = latlong;
+  double* lon2 = latlong + m;
+  double* azi2 = latlong + 2*m;
+  double* a12 = NULL;
+  double* m12 = NULL;
+  double* M12 = NULL;
+  double* M21 = NULL;
+  double* S12 = NULL;
+  unsigned outmask = G::LATITUDE | G::LONGITUDE | G::AZIMUTH;
+  if (aux) {
+    a12 = aux;
+    m12 = aux + m;
+    M12 = aux + 2*m;
+    M21 = aux + 3*m;
+    S12 = aux + 4*m;
+    outmask |= G::REDUCEDLENGTH | G::GEODESICSCALE | G::AREA;
+  }
+
+  // The columns of the matrices are the arrays for the batch routine; the
+  // problems are shared among all the available threads.
+  const G g(a, f);
+  GeodesicBatchExecutor().Direct(g, size_t(m), lat1, lon1, azi1,
+                                 false, s12, outmask,
+                                 a12, lat2, lon2, azi2, NULL,
+                                 m12, M12, M21, S12);
+}
+
+void mexFunction( int nlhs, mxArray* plhs[],
+                  int nrhs, const mxArray* prhs[] ) {
+
+  if (nrhs < 1)
+    mexErrMsgTxt("One input argument required.");
+  else if (nrhs > 3)
+    mexErrMsgTxt("More than three input arguments specified.");
+  else if (nrhs == 2)
+    mexErrMsgTxt("Must specify flattening with the equatorial radius.");
+  else if (nlhs > 2)
+    mexErrMsgTxt("More than two output arguments specified.");
+
+  if (!( mxIsDouble(prhs[0]) && !mxIsComplex(prhs[0]) ))
+    mexErrMsgTxt("geodesic coordinates are not of type double.");
+
+  if (mxGetN(prhs[0]) != 4)
+    mexErrMsgTxt("geodesic coordinates must be M x 4 matrix.");
+
+  double a = Constants::WGS84_a<double>(), f = Constants::WGS84_f<double>();
+  if (nrhs == 3) {
+    if (!( mxIsDouble(prhs[1]) && !mxIsComplex(prhs[1]) &&
+           mxGetNumberOfElements(prhs[1]) == 1 ))
+      mexErrMsgTxt("Equatorial radius is not a real scalar.");
+    a = mxGetScalar(prhs[1]);
+    if (!( mxIsDouble(prhs[2]) && !mxIsComplex(prhs[2]) &&
+           mxGetNumberOfElements(prhs[2]) == 1 ))
+      mexErrMsgTxt("Flattening is not a real scalar.");
+    f = mxGetScalar(prhs[2]);
+  }
+
+  mwSize m = mxGetM(prhs[0]);
+
+  const double* geodesic = mxGetPr(prhs[0]);
+
+  double* latlong = mxGetPr(plhs[0] = mxCreateDoubleMatrix(m, 3, mxREAL));
+
+  double* aux =
+    nlhs == 2 ? mxGetPr(plhs[1] = mxCreateDoubleMatrix(m, 5, mxREAL)) :
+    NULL;
+
+  try {
+    if (std::abs(f) <= 0.02)
+      compute<Geodesic>(a, f, m, geodesic, latlong, aux);
+    else
+      compute<GeodesicExact>(a, f, m, geodesic, latlong, aux);
+  }
+  catch (const std::exception& e) {
+    mexErrMsgTxt(e.what());
+  }
+}
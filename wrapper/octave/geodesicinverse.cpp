@@ -1,8 +1,8 @@
 /**
  * \file geodesicinverse.cpp
- * \brief Matlab mex file for geographic to UTM/UPS conversions
+ * \brief Matlab mex file for solving the inverse geodesic problem
  *
- * Copyright (c) Charles Karney (2010-2013) <charles@karney.com> and licensed
+ * Copyright (c) Charles Karney (2010-2026) <charles@karney.com> and licensed
  * under the MIT/X11 License.  For more information, see
  * https://geographiclib.sourceforge.io/
  **********************************************************************/
@@ -18,6 +18,7 @@
 #include <algorithm>
 #include <GeographicLib/Geodesic.hpp>
 #include <GeographicLib/GeodesicExact.hpp>
+#include <GeographicLib/GeodesicBatchExecutor.hpp>
 #include <mex.h>
 
 using namespace std;
@@ -38,27 +39,23 @@ compute(double a, double f, mwSize m, const double* latlong,
   double* M12 = NULL;
   double* M21 = NULL;
   double* S12 = NULL;
+  unsigned outmask = G::AZIMUTH | G::DISTANCE;
   if (aux) {
     a12 = aux;
     m12 = aux + m;
     M12 = aux + 2*m;
     M21 = aux + 3*m;
     S12 = aux + 4*m;
+    outmask |= G::REDUCEDLENGTH | G::GEODESICSCALE | G::AREA;
   }
 
+  // The columns of the matrices are the arrays for the batch routine; the
+  // problems are shared among all the available threads.  A latitude
+  // outside [-90, 90] gives NaNs.
   const G g(a, f);
-  for (mwIndex i = 0; i < m; ++i) {
-    if (abs(lat1[i]) <= 90 && lon1[i] >= -540 && lon1[i] < 540 &&
-        abs(lat2[i]) <= 90 && lon2[i] >= -540 && lon2[i] < 540) {
-      if (aux)
-        a12[i] = g.Inverse(lat1[i], lon1[i], lat2[i], lon2[i],
-                           s12[i], azi1[i], azi2[i],
-                           m12[i], M12[i], M21[i], S12[i]);
-      else
-        g.Inverse(lat1[i], lon1[i], lat2[i], lon2[i],
-                  s12[i], azi1[i], azi2[i]);
-    }
-  }
+  GeodesicBatchExecutor().Inverse(g, size_t(m), lat1, lon1, lat2, lon2,
+                                  outmask, a12, s12, azi1, azi2,
+                                  m12, M12, M21, S12);
 }
 
 void mexFunction( int nlhs, mxArray* plhs[],
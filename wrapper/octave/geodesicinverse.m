@@ -25,6 +25,9 @@ function geodesicinverse(~, ~, ~)
 %   f = flattening (0 means a sphere)
 %   If a and f are omitted, the WGS84 values are used.
 %
+%   The problems are solved with the batch routines of GeographicLib using
+%   all the available threads.
+%
 % A native MATLAB implementation is available as GEODDISTANCE.
 %
 % See also GEODDISTANCE.
@@ -0,0 +1,87 @@
+/**
+ * \file geoidheight.cpp
+ * \brief Matlab mex file for geoid heights
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+// Compile in Matlab with
+// [Unix]
+// mex -I/usr/local/include -L/usr/local/lib -Wl,-rpath=/usr/local/lib
+//    -lGeographicLib geoidheight.cpp
+// [Windows]
+// mex -I../include -L../windows/Release
+//    -lGeographicLib geoidheight.cpp
+
+#include <string>
+#include <vector>
+#include <GeographicLib/Geoid.hpp>
+#include <GeographicLib/GeodesicBatchExecutor.hpp>
+#include <mex.h>
+
+using namespace std;
+using namespace GeographicLib;
+
+void compute(const string& name, const string& dir, mwSize m,
+             const double* latlong, double* h) {
+  const double* lat = latlong;
+  const double* lon = latlong + m;
+  // The thread safe geoid holds the whole grid in memory, so that the
+  // rows can be handed out in chunks to all the available threads.  The
+  // points are taken in the order of a Hilbert curve so that the grid
+  // cells needed by a chunk stay in the cache; the points of a chunk are
+  // gathered so that neighboring points share the fit to a cell.
+  const Geoid& g = Geoid::Get(name, dir);
+  GeodesicBatchExecutor().ForEachLocal
+    (size_t(m), lat, lon, [&](size_t n, const size_t idx[]) -> void {
+      vector<double> la(n), lo(n), hh(n);
+      for (size_t j = 0; j < n; ++j) {
+        la[j] = lat[idx[j]]; lo[j] = lon[idx[j]];
+      }
+      g.HeightBatch(n, la.data(), lo.data(), hh.data());
+      for (size_t j = 0; j < n; ++j)
+        h[idx[j]] = hh[j];
+    });
+}
+
+void mexFunction( int nlhs, mxArray* plhs[],
+                  int nrhs, const mxArray* prhs[] ) {
+
+  if (nrhs < 1)
+    mexErrMsgTxt("One input argument required.");
+  else if (nrhs > 3)
+    mexErrMsgTxt("More than three input arguments specified.");
+  else if (nlhs > 1)
+    mexErrMsgTxt("More than one output argument specified.");
+
+  if (!( mxIsDouble(prhs[0]) && !mxIsComplex(prhs[0]) ))
+    mexErrMsgTxt("latlong coordinates are not of type double.");
+
+  if (mxGetN(prhs[0]) != 2)
+    mexErrMsgTxt("latlong coordinates must be M x 2 matrix.");
+
+  string name = Geoid::DefaultGeoidName(), dir;
+  for (int k = 1; k < nrhs; ++k) {
+    if (!mxIsChar(prhs[k]))
+      mexErrMsgTxt(k == 1 ? "geoidname is not a string." :
+                   "geoiddir is not a string.");
+    char* s = mxArrayToString(prhs[k]);
+    (k == 1 ? name : dir) = s;
+    mxFree(s);
+  }
+
+  mwSize m = mxGetM(prhs[0]);
+
+  const double* latlong = mxGetPr(prhs[0]);
+
+  double* h = mxGetPr(plhs[0] = mxCreateDoubleMatrix(m, 1, mxREAL));
+
+  try {
+    compute(name, dir, m, latlong, h);
+  }
+  catch (const std::exception& e) {
+    mexErrMsgTxt(e.what());
+  }
+}
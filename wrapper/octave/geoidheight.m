@@ -0,0 +1,26 @@
+function geoidheight(~, ~, ~)
+%geoidheight  Compute geoid heights
+%
+%   h = geoidheight(latlong)
+%   h = geoidheight(latlong, geoidname)
+%   h = geoidheight(latlong, geoidname, geoiddir)
+%
+%   latlong is an M x 2 matrix
+%       latitude = latlong(:,1) in degrees
+%       longitude = latlong(:,2) in degrees
+%
+%   h is an M x 1 matrix
+%       height of the geoid above the ellipsoid = h in meters
+%
+%   geoidname is the name of the geoid; the default is given by the
+%   environment variable GEOGRAPHICLIB_GEOID_NAME, or egm96-5.  geoiddir is
+%   the directory for the geoid data; the default is given by the
+%   environment variable GEOGRAPHICLIB_GEOID_PATH, or the default install
+%   location.  Cubic interpolation is used.
+%
+%   The geoid is read into memory on the first call and kept for later
+%   calls.  The heights are computed with the batch routines of
+%   GeographicLib using all the available threads.
+
+  error('Error: executing .m file instead of compiled routine');
+end
@@ -0,0 +1,122 @@
+/**
+ * \file utmupsforward.cpp
+ * \brief Matlab mex file for geographic to UTM/UPS conversions
+ *
+ * Copyright (c) Charles Karney (2026) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+// Compile in Matlab with
+// [Unix]
+// mex -I/usr/local/include -L/usr/local/lib -Wl,-rpath=/usr/local/lib
+//    -lGeographicLib utmupsforward.cpp
+// [Windows]
+// mex -I../include -L../windows/Release
+//    -lGeographicLib utmupsforward.cpp
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include <GeographicLib/UTMUPS.hpp>
+#include <GeographicLib/GeodesicBatchExecutor.hpp>
+#include <mex.h>
+
+using namespace std;
+using namespace GeographicLib;
+
+void compute(mwSize m, const double* latlong, int setzone,
+             double* utmups, double* scale) {
+  const double* lat = latlong;
+  const double* lon = latlong + m;
+  double* x = utmups;
+  double* y = utmups + m;
+  double* zone = utmups + 2*m;
+  double* northp = utmups + 3*m;
+  double* gamma = scale;
+  double* k = scale ? scale + m : NULL;
+
+  // The rows are handed out in chunks to all the available threads.  Each
+  // chunk is converted by the batch routine; if this throws an exception
+  // because of an invalid point, the chunk is redone point by point and the
+  // invalid points give NaNs.
+  GeodesicBatchExecutor().ForEach
+    (size_t(m), [&](size_t i0, size_t i1) -> void {
+      size_t n = i1 - i0;
+      vector<int> z(n);
+      unique_ptr<bool[]> h(new bool[n]);
+      try {
+        UTMUPS::ForwardBatch(n, lat + i0, lon + i0, z.data(), h.get(),
+                             x + i0, y + i0,
+                             gamma ? gamma + i0 : NULL, k ? k + i0 : NULL,
+                             setzone);
+      }
+      catch (const std::exception&) {
+        for (size_t j = 0; j < n; ++j) {
+          size_t i = i0 + j;
+          double g, s;
+          try {
+            UTMUPS::Forward(lat[i], lon[i], z[j], h[j], x[i], y[i], g, s,
+                            setzone);
+          }
+          catch (const std::exception&) {
+            z[j] = UTMUPS::INVALID;
+            x[i] = y[i] = g = s = Math::NaN<double>();
+          }
+          if (gamma) { gamma[i] = g; k[i] = s; }
+        }
+      }
+      for (size_t j = 0; j < n; ++j) {
+        bool valid = z[j] != UTMUPS::INVALID;
+        zone[i0 + j] = valid ? z[j] : Math::NaN<double>();
+        northp[i0 + j] = valid ? (h[j] ? 1 : 0) : Math::NaN<double>();
+      }
+    });
+}
+
+void mexFunction( int nlhs, mxArray* plhs[],
+                  int nrhs, const mxArray* prhs[] ) {
+
+  if (nrhs < 1)
+    mexErrMsgTxt("One input argument required.");
+  else if (nrhs > 2)
+    mexErrMsgTxt("More than two input arguments specified.");
+  else if (nlhs > 2)
+    mexErrMsgTxt("More than two output arguments specified.");
+
+  if (!( mxIsDouble(prhs[0]) && !mxIsComplex(prhs[0]) ))
+    mexErrMsgTxt("latlong coordinates are not of type double.");
+
+  if (mxGetN(prhs[0]) != 2)
+    mexErrMsgTxt("latlong coordinates must be M x 2 matrix.");
+
+  int setzone = UTMUPS::STANDARD;
+  if (nrhs == 2) {
+    if (!( mxIsDouble(prhs[1]) && !mxIsComplex(prhs[1]) &&
+           mxGetNumberOfElements(prhs[1]) == 1 ))
+      mexErrMsgTxt("setzone is not an integer.");
+    double rzone = mxGetScalar(prhs[1]);
+    setzone = int(rzone);
+    if (double(setzone) != rzone)
+      mexErrMsgTxt("setzone is not an integer.");
+    if (setzone < UTMUPS::MINPSEUDOZONE || setzone > UTMUPS::MAXZONE)
+      mexErrMsgTxt("setzone is not in [-4, 60].");
+  }
+
+  mwSize m = mxGetM(prhs[0]);
+
+  const double* latlong = mxGetPr(prhs[0]);
+
+  double* utmups = mxGetPr(plhs[0] = mxCreateDoubleMatrix(m, 4, mxREAL));
+
+  double* scale =
+    nlhs == 2 ? mxGetPr(plhs[1] = mxCreateDoubleMatrix(m, 2, mxREAL)) :
+    NULL;
+
+  try {
+    compute(m, latlong, setzone, utmups, scale);
+  }
+  catch (const std::exception& e) {
+    mexErrMsgTxt(e.what());
+  }
+}
@@ -0,0 +1,28 @@
+function utmupsforward(~, ~)
+%utmupsforward  Convert geographic coordinates to UTM/UPS
+%
+%   [utmups, scale] = utmupsforward(latlong)
+%   [utmups, scale] = utmupsforward(latlong, setzone)
+%
+%   latlong is an M x 2 matrix
+%       latitude = latlong(:,1) in degrees
+%       longitude = latlong(:,2) in degrees
+%
+%   utmups is an M x 4 matrix
+%       easting = utmups(:,1) in meters
+%       northing = utmups(:,2) in meters
+%       zone = utmups(:,3) (0 means UPS)
+%       hemisphere = utmups(:,4) (1 means north, 0 means south)
+%   scale is an M x 2 matrix
+%       meridian convergence = scale(:,1) in degrees
+%       scale = scale(:,2)
+%
+%   setzone is an integer in [-4, 60] which forces the choice of zone;
+%   -1 (the default) selects the standard UTM or UPS zone; see the
+%   documentation of UTMUPS::zonespec.  Invalid points give NaNs.
+%
+%   The points are converted with the batch routines of GeographicLib
+%   using all the available threads.
+
+  error('Error: executing .m file instead of compiled routine');
+end
@@ -0,0 +1,437 @@
+// Array versions of the geodesic, projection, geoid, and gravity
+// calculations for Python.  Arguments are objects supporting the buffer
+// protocol, e.g., NumPy arrays or array.array objects, of doubles (other
+// sequences are converted); results are returned as array.array objects,
+// which numpy.asarray wraps without copying.  The calculations are done
+// with the GIL released and, if threads != 1, on several threads.
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <GeographicLib/Geodesic.hpp>
+#include <GeographicLib/GeodesicBatchExecutor.hpp>
+#include <GeographicLib/TransverseMercator.hpp>
+#include <GeographicLib/UTMUPS.hpp>
+#include <GeographicLib/Geoid.hpp>
+#include <GeographicLib/GravityModel.hpp>
+
+using namespace GeographicLib;
+
+static_assert(std::is_same<Math::real, double>::value,
+              "GeographicLib must be compiled with doubles");
+
+namespace {
+
+  // array.array, set when the module is imported
+  PyObject* arraytype = nullptr;
+
+  // A contiguous array of doubles given as an argument
+  class Input {
+  private:
+    Py_buffer _view;
+    bool _held;
+    PyObject* _conv;
+    static bool isdouble(const Py_buffer& v) {
+      if (v.itemsize != sizeof(double) || !v.format) return false;
+      const char* f = v.format;
+      if (*f == '@' || *f == '=' ||
+          *f == (Math::bigendian ? '>' : '<'))
+        ++f;
+      return std::strcmp(f, "d") == 0;
+    }
+  public:
+    Input() : _held(false), _conv(nullptr) {}
+    ~Input() {
+      if (_held) PyBuffer_Release(&_view);
+      Py_XDECREF(_conv);
+    }
+    Input(const Input&) = delete;
+    Input& operator=(const Input&) = delete;
+    // Returns false with a Python exception set on failure
+    bool Set(PyObject* obj) {
+      if (PyObject_GetBuffer(obj, &_view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT)
+          == 0) {
+        if (isdouble(_view)) { _held = true; return true; }
+        PyBuffer_Release(&_view);
+      } else
+        PyErr_Clear();
+      // Not contiguous doubles, so convert with array.array('d', obj)
+      _conv = PyObject_CallFunction(arraytype, "sO", "d", obj);
+      if (!_conv) return false;
+      if (PyObject_GetBuffer(_conv, &_view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT)
+          != 0)
+        return false;
+      _held = true;
+      return true;
+    }
+    const double* data() const { return (const double*)(_view.buf); }
+    size_t size() const { return size_t(_view.len) / sizeof(double); }
+  };
+
+  // A new array.array of n elements of type code (e.g., 'd')
+  class Output {
+  private:
+    Py_buffer _view;
+    bool _held;
+    PyObject* _obj;
+  public:
+    Output() : _held(false), _obj(nullptr) {}
+    ~Output() {
+      if (_held) PyBuffer_Release(&_view);
+      Py_XDECREF(_obj);
+    }
+    Output(const Output&) = delete;
+    Output& operator=(const Output&) = delete;
+    bool Make(const char* code, size_t n) {
+      PyObject* zero = PyObject_CallFunction(arraytype, "s[i]", code, 0);
+      if (!zero) return false;
+      _obj = PySequence_Repeat(zero, Py_ssize_t(n));
+      Py_DECREF(zero);
+      if (!_obj) return false;
+      if (PyObject_GetBuffer(_obj, &_view, PyBUF_WRITABLE) != 0)
+        return false;
+      _held = true;
+      return true;
+    }
+    template<typename T> T* data() { return (T*)(_view.buf); }
+    // Hand over the reference
+    PyObject* release() {
+      if (_held) { PyBuffer_Release(&_view); _held = false; }
+      PyObject* o = _obj; _obj = nullptr;
+      return o;
+    }
+  };
+
+  // Check the inputs and make the outputs, all with the same size
+  bool setup(std::initializer_list<std::pair<PyObject*, Input*>> in,
+             std::initializer_list<std::pair<const char*, Output*>> out,
+             size_t& n) {
+    bool first = true;
+    for (auto& p : in) {
+      if (!p.second->Set(p.first)) return false;
+      if (first) { n = p.second->size(); first = false; }
+      else if (p.second->size() != n) {
+        PyErr_SetString(PyExc_ValueError, "Arrays have different sizes");
+        return false;
+      }
+    }
+    for (auto& p : out)
+      if (!p.second->Make(p.first, n)) return false;
+    return true;
+  }
+
+  // Run f with the GIL released, converting C++ exceptions to Python ones
+  template<class F> bool nogil(F f) {
+    std::string err;
+    bool alloc = false;
+    Py_BEGIN_ALLOW_THREADS
+    try {
+      f();
+    }
+    catch (const std::bad_alloc&) {
+      alloc = true;
+    }
+    catch (const std::exception& e) {
+      err = e.what();
+      if (err.empty()) err = "Unknown error";
+    }
+    Py_END_ALLOW_THREADS
+    if (alloc) {
+      PyErr_NoMemory();
+      return false;
+    }
+    if (!err.empty()) {
+      PyErr_SetString(PyExc_ValueError, err.c_str());
+      return false;
+    }
+    return true;
+  }
+
+  // The models are loaded once and kept.  A Geoid used by several threads
+  // must be thread safe (which reads all the data into memory), so the
+  // thread safety is part of the key.  These are only touched with the GIL
+  // released.
+  std::mutex modellock;
+  std::map<std::tuple<std::string, std::string, bool>,
+           std::unique_ptr<const Geoid>> geoids;
+  std::map<std::pair<std::string, std::string>,
+           std::unique_ptr<const GravityModel>> gravitymodels;
+
+  const Geoid& geoid(const std::string& name, const std::string& path,
+                     bool threadsafe) {
+    std::lock_guard<std::mutex> lock(modellock);
+    auto& g = geoids[std::make_tuple(name, path, threadsafe)];
+    if (!g) g.reset(new Geoid(name, path, true, threadsafe));
+    return *g;
+  }
+
+  const GravityModel& gravitymodel(const std::string& name,
+                                   const std::string& path) {
+    std::lock_guard<std::mutex> lock(modellock);
+    auto& g = gravitymodels[std::make_pair(name, path)];
+    if (!g) g.reset(new GravityModel(name, path));
+    return *g;
+  }
+
+  PyObject* inverse(PyObject*, PyObject* args, PyObject* kwds) {
+    static const char* kwlist[] = {"lat1", "lon1", "lat2", "lon2",
+                                   "a", "f", "threads", nullptr};
+    PyObject *olat1, *olon1, *olat2, *olon2;
+    double a = Constants::WGS84_a(), f = Constants::WGS84_f();
+    unsigned threads = 1;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "OOOO|ddI", (char**)kwlist,
+                                     &olat1, &olon1, &olat2, &olon2,
+                                     &a, &f, &threads))
+      return nullptr;
+    Input lat1, lon1, lat2, lon2;
+    Output s12, azi1, azi2;
+    size_t n;
+    if (!setup({{olat1, &lat1}, {olon1, &lon1}, {olat2, &lat2},
+                {olon2, &lon2}},
+               {{"d", &s12}, {"d", &azi1}, {"d", &azi2}}, n) ||
+        !nogil([&]() -> void {
+          Geodesic g(a, f);
+          GeodesicBatchExecutor(threads).Inverse
+            (g, n, lat1.data(), lon1.data(), lat2.data(), lon2.data(),
+             Geodesic::DISTANCE | Geodesic::AZIMUTH, nullptr,
+             s12.data<double>(), azi1.data<double>(), azi2.data<double>(),
+             nullptr, nullptr, nullptr, nullptr);
+        }))
+      return nullptr;
+    return Py_BuildValue("(NNN)", s12.release(), azi1.release(),
+                         azi2.release());
+  }
+
+  PyObject* direct(PyObject*, PyObject* args, PyObject* kwds) {
+    static const char* kwlist[] = {"lat1", "lon1", "azi1", "s12",
+                                   "a", "f", "threads", nullptr};
+    PyObject *olat1, *olon1, *oazi1, *os12;
+    double a = Constants::WGS84_a(), f = Constants::WGS84_f();
+    unsigned threads = 1;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "OOOO|ddI", (char**)kwlist,
+                                     &olat1, &olon1, &oazi1, &os12,
+                                     &a, &f, &threads))
+      return nullptr;
+    Input lat1, lon1, azi1, s12;
+    Output lat2, lon2, azi2;
+    size_t n;
+    if (!setup({{olat1, &lat1}, {olon1, &lon1}, {oazi1, &azi1},
+                {os12, &s12}},
+               {{"d", &lat2}, {"d", &lon2}, {"d", &azi2}}, n) ||
+        !nogil([&]() -> void {
+          Geodesic g(a, f);
+          GeodesicBatchExecutor(threads).Direct
+            (g, n, lat1.data(), lon1.data(), azi1.data(), false, s12.data(),
+             Geodesic::LATITUDE | Geodesic::LONGITUDE | Geodesic::AZIMUTH,
+             nullptr, lat2.data<double>(), lon2.data<double>(),
+             azi2.data<double>(), nullptr, nullptr, nullptr, nullptr,
+             nullptr);
+        }))
+      return nullptr;
+    return Py_BuildValue("(NNN)", lat2.release(), lon2.release(),
+                         azi2.release());
+  }
+
+  PyObject* tm_forward(PyObject*, PyObject* args, PyObject* kwds) {
+    static const char* kwlist[] = {"lon0", "lat", "lon",
+                                   "a", "f", "k0", "threads", nullptr};
+    PyObject *olat, *olon;
+    double lon0, a = Constants::WGS84_a(), f = Constants::WGS84_f(),
+      k0 = Constants::UTM_k0();
+    unsigned threads = 1;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dOO|dddI", (char**)kwlist,
+                                     &lon0, &olat, &olon,
+                                     &a, &f, &k0, &threads))
+      return nullptr;
+    Input lat, lon;
+    Output x, y, gamma, k;
+    size_t n;
+    if (!setup({{olat, &lat}, {olon, &lon}},
+               {{"d", &x}, {"d", &y}, {"d", &gamma}, {"d", &k}}, n) ||
+        !nogil([&]() -> void {
+          TransverseMercator tm(a, f, k0);
+          GeodesicBatchExecutor(threads).Forward
+            (tm, n, lon0, lat.data(), lon.data(),
+             x.data<double>(), y.data<double>(),
+             gamma.data<double>(), k.data<double>());
+        }))
+      return nullptr;
+    return Py_BuildValue("(NNNN)", x.release(), y.release(),
+                         gamma.release(), k.release());
+  }
+
+  PyObject* tm_reverse(PyObject*, PyObject* args, PyObject* kwds) {
+    static const char* kwlist[] = {"lon0", "x", "y",
+                                   "a", "f", "k0", "threads", nullptr};
+    PyObject *ox, *oy;
+    double lon0, a = Constants::WGS84_a(), f = Constants::WGS84_f(),
+      k0 = Constants::UTM_k0();
+    unsigned threads = 1;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dOO|dddI", (char**)kwlist,
+                                     &lon0, &ox, &oy,
+                                     &a, &f, &k0, &threads))
+      return nullptr;
+    Input x, y;
+    Output lat, lon, gamma, k;
+    size_t n;
+    if (!setup({{ox, &x}, {oy, &y}},
+               {{"d", &lat}, {"d", &lon}, {"d", &gamma}, {"d", &k}}, n) ||
+        !nogil([&]() -> void {
+          TransverseMercator tm(a, f, k0);
+          GeodesicBatchExecutor(threads).Reverse
+            (tm, n, lon0, x.data(), y.data(),
+             lat.data<double>(), lon.data<double>(),
+             gamma.data<double>(), k.data<double>());
+        }))
+      return nullptr;
+    return Py_BuildValue("(NNNN)", lat.release(), lon.release(),
+                         gamma.release(), k.release());
+  }
+
+  PyObject* utm_forward(PyObject*, PyObject* args, PyObject* kwds) {
+    static const char* kwlist[] = {"lat", "lon", "threads", nullptr};
+    PyObject *olat, *olon;
+    unsigned threads = 1;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "OO|I", (char**)kwlist,
+                                     &olat, &olon, &threads))
+      return nullptr;
+    Input lat, lon;
+    Output zone, northp, x, y;
+    size_t n;
+    if (!setup({{olat, &lat}, {olon, &lon}},
+               {{"i", &zone}, {"b", &northp}, {"d", &x}, {"d", &y}}, n) ||
+        !nogil([&]() -> void {
+          GeodesicBatchExecutor(threads).ForEach
+            (n, [&](size_t i0, size_t i1) -> void {
+              std::unique_ptr<bool[]> np(new bool[i1 - i0]);
+              UTMUPS::ForwardBatch(i1 - i0, lat.data() + i0, lon.data() + i0,
+                                   zone.data<int>() + i0, np.get(),
+                                   x.data<double>() + i0,
+                                   y.data<double>() + i0);
+              for (size_t i = i0; i < i1; ++i)
+                northp.data<signed char>()[i] = np[i - i0] ? 1 : 0;
+            });
+        }))
+      return nullptr;
+    return Py_BuildValue("(NNNN)", zone.release(), northp.release(),
+                         x.release(), y.release());
+  }
+
+  PyObject* geoid_height(PyObject*, PyObject* args, PyObject* kwds) {
+    static const char* kwlist[] = {"lat", "lon", "name", "path", "threads",
+                                   nullptr};
+    PyObject *olat, *olon;
+    const char *name = "egm96-5", *path = "";
+    unsigned threads = 1;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "OO|ssI", (char**)kwlist,
+                                     &olat, &olon, &name, &path, &threads))
+      return nullptr;
+    std::string sname(name), spath(path);
+    Input lat, lon;
+    Output h;
+    size_t n;
+    if (!setup({{olat, &lat}, {olon, &lon}}, {{"d", &h}}, n) ||
+        !nogil([&]() -> void {
+          const Geoid& g = geoid(sname, spath, threads != 1);
+          GeodesicBatchExecutor(threads).ForEach
+            (n, [&](size_t i0, size_t i1) -> void {
+              g.HeightBatch(i1 - i0, lat.data() + i0, lon.data() + i0,
+                            h.data<double>() + i0);
+            });
+        }))
+      return nullptr;
+    return h.release();
+  }
+
+  PyObject* gravity(PyObject*, PyObject* args, PyObject* kwds) {
+    static const char* kwlist[] = {"lat", "lon", "h", "name", "path",
+                                   "threads", nullptr};
+    PyObject *olat, *olon, *oh;
+    const char *name = "egm96", *path = "";
+    unsigned threads = 1;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "OOO|ssI", (char**)kwlist,
+                                     &olat, &olon, &oh, &name, &path,
+                                     &threads))
+      return nullptr;
+    std::string sname(name), spath(path);
+    Input lat, lon, h;
+    Output W, gx, gy, gz;
+    size_t n;
+    if (!setup({{olat, &lat}, {olon, &lon}, {oh, &h}},
+               {{"d", &W}, {"d", &gx}, {"d", &gy}, {"d", &gz}}, n) ||
+        !nogil([&]() -> void {
+          const GravityModel& g = gravitymodel(sname, spath);
+          GeodesicBatchExecutor(threads).ForEach
+            (n, [&](size_t i0, size_t i1) -> void {
+              g.GravityBatch(i1 - i0, lat.data() + i0, lon.data() + i0,
+                             h.data() + i0, W.data<double>() + i0,
+                             gx.data<double>() + i0, gy.data<double>() + i0,
+                             gz.data<double>() + i0);
+            });
+        }))
+      return nullptr;
+    return Py_BuildValue("(NNNN)", W.release(), gx.release(), gy.release(),
+                         gz.release());
+  }
+
+  PyMethodDef methods[] = {
+    {"inverse", (PyCFunction)(void(*)(void))inverse,
+     METH_VARARGS | METH_KEYWORDS,
+     "inverse(lat1, lon1, lat2, lon2, a=WGS84, f=WGS84, threads=1)\n"
+     "-> (s12, azi1, azi2)\n"
+     "Solve the inverse geodesic problems."},
+    {"direct", (PyCFunction)(void(*)(void))direct,
+     METH_VARARGS | METH_KEYWORDS,
+     "direct(lat1, lon1, azi1, s12, a=WGS84, f=WGS84, threads=1)\n"
+     "-> (lat2, lon2, azi2)\n"
+     "Solve the direct geodesic problems."},
+    {"tm_forward", (PyCFunction)(void(*)(void))tm_forward,
+     METH_VARARGS | METH_KEYWORDS,
+     "tm_forward(lon0, lat, lon, a=WGS84, f=WGS84, k0=UTM, threads=1)\n"
+     "-> (x, y, gamma, k)\n"
+     "Transverse Mercator projection with central meridian lon0."},
+    {"tm_reverse", (PyCFunction)(void(*)(void))tm_reverse,
+     METH_VARARGS | METH_KEYWORDS,
+     "tm_reverse(lon0, x, y, a=WGS84, f=WGS84, k0=UTM, threads=1)\n"
+     "-> (lat, lon, gamma, k)\n"
+     "Reverse transverse Mercator projection."},
+    {"utm_forward", (PyCFunction)(void(*)(void))utm_forward,
+     METH_VARARGS | METH_KEYWORDS,
+     "utm_forward(lat, lon, threads=1) -> (zone, northp, x, y)\n"
+     "Convert to UTM/UPS in the standard zone (zone 0 is UPS)."},
+    {"geoid_height", (PyCFunction)(void(*)(void))geoid_height,
+     METH_VARARGS | METH_KEYWORDS,
+     "geoid_height(lat, lon, name='egm96-5', path='', threads=1) -> h\n"
+     "Height of the geoid above the ellipsoid (the geoid is loaded once)."},
+    {"gravity", (PyCFunction)(void(*)(void))gravity,
+     METH_VARARGS | METH_KEYWORDS,
+     "gravity(lat, lon, h, name='egm96', path='', threads=1)\n"
+     "-> (W, gx, gy, gz)\n"
+     "Gravity potential and acceleration (the model is loaded once)."},
+    {nullptr, nullptr, 0, nullptr}
+  };
+
+  PyModuleDef module = {
+    PyModuleDef_HEAD_INIT, "PyGeographicBatch",
+    "Array versions of GeographicLib calculations.  The arguments are\n"
+    "arrays of doubles (e.g., NumPy arrays); the results are array.array\n"
+    "objects.  threads = 0 uses all the processors.",
+    -1, methods, nullptr, nullptr, nullptr, nullptr
+  };
+
+}
+
+PyMODINIT_FUNC PyInit_PyGeographicBatch() {
+  PyObject* array = PyImport_ImportModule("array");
+  if (!array) return nullptr;
+  arraytype = PyObject_GetAttrString(array, "array");
+  Py_DECREF(array);
+  if (!arraytype) return nullptr;
+  return PyModule_Create(&module);
+}